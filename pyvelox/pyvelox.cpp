@@ -49,12 +49,19 @@ static VectorPtr evaluateExpression(
   RowVectorPtr rowVector = std::make_shared<RowVector>(
       pool, rowType, BufferPtr{nullptr}, numRows, inputs);
   core::TypedExprPtr typed = core::Expressions::inferTypes(expr, rowType, pool);
-  exec::ExprSet set({typed}, PyVeloxContext::getInstance().execCtx());
-  exec::EvalCtx evalCtx(
-      PyVeloxContext::getInstance().execCtx(), &set, rowVector.get());
-  SelectivityVector rows(numRows);
+
+  // Compiles and evaluates without the GIL so that other Python threads run
+  // meanwhile, e.g. to evaluate expressions over other batches. Each call
+  // has its own ExecCtx since the ExecCtx is not thread-safe.
   std::vector<VectorPtr> result;
-  set.eval(rows, evalCtx, result);
+  {
+    py::gil_scoped_release noGil;
+    core::ExecCtx execCtx(pool, PyVeloxContext::getInstance().queryCtx());
+    exec::ExprSet set({typed}, &execCtx);
+    exec::EvalCtx evalCtx(&execCtx, &set, rowVector.get());
+    SelectivityVector rows(numRows);
+    set.eval(rows, evalCtx, result);
+  }
   return result[0];
 }
 
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
@@ -28,6 +29,8 @@
 #include <velox/type/Type.h>
 #include <velox/type/Variant.h>
 #include <velox/vector/FlatVector.h>
+#include <velox/vector/arrow/Abi.h>
+#include <velox/vector/arrow/Bridge.h>
 #include "folly/json.h"
 
 namespace facebook::velox::py {
@@ -362,6 +365,261 @@ inline void addDataTypeBindings(
   rowType.def("names", &RowType::names, "Return the names of the columns");
 }
 
+/// Keeps a Python object, e.g. the NumPy array whose memory a BufferView
+/// wraps, alive while the buffer is referenced. The buffer may be released by
+/// a thread that does not hold the GIL.
+struct PyObjectReleaser {
+  PyObject* object;
+
+  void addRef() const {
+    py::gil_scoped_acquire gil;
+    Py_INCREF(object);
+  }
+
+  void release() const {
+    py::gil_scoped_acquire gil;
+    Py_DECREF(object);
+  }
+};
+
+/// Imports an ArrowSchema and ArrowArray pair as a vector that owns them.
+/// 'arrowSchema' and 'arrowArray' are marked as released also if importing
+/// fails, in which case their release callbacks have been called.
+inline VectorPtr importArrowStructs(
+    ArrowSchema& arrowSchema,
+    ArrowArray& arrowArray,
+    memory::MemoryPool* pool) {
+  try {
+    return arrow::importFromArrowAsOwner(arrowSchema, arrowArray, pool);
+  } catch (const std::exception&) {
+    // The vector under construction has called the release callbacks.
+    arrowSchema.release = nullptr;
+    arrowArray.release = nullptr;
+    throw;
+  }
+}
+
+/// Makes a vector over the buffers of 'obj' without copying them, except for
+/// the types that Velox lays out differently than Arrow, e.g. strings. 'obj'
+/// is an object that implements the Arrow PyCapsule interface, e.g. a
+/// pyarrow.Array or pyarrow.RecordBatch, or a pyarrow object with
+/// _export_to_c(). Record batches become ROW vectors.
+inline VectorPtr arrowToVector(
+    const py::object& obj,
+    memory::MemoryPool* pool) {
+  ArrowSchema arrowSchema;
+  ArrowArray arrowArray;
+  if (py::hasattr(obj, "__arrow_c_array__")) {
+    py::tuple capsules = obj.attr("__arrow_c_array__")();
+    auto* schemaPtr = static_cast<ArrowSchema*>(
+        PyCapsule_GetPointer(capsules[0].ptr(), "arrow_schema"));
+    if (schemaPtr == nullptr) {
+      throw py::error_already_set();
+    }
+    auto* arrayPtr = static_cast<ArrowArray*>(
+        PyCapsule_GetPointer(capsules[1].ptr(), "arrow_array"));
+    if (arrayPtr == nullptr) {
+      throw py::error_already_set();
+    }
+    // Moves the structs out of the capsules, which only release what they
+    // still own.
+    arrowSchema = *schemaPtr;
+    schemaPtr->release = nullptr;
+    arrowArray = *arrayPtr;
+    arrayPtr->release = nullptr;
+  } else if (py::hasattr(obj, "_export_to_c")) {
+    arrowSchema.release = nullptr;
+    arrowArray.release = nullptr;
+    obj.attr("_export_to_c")(
+        reinterpret_cast<uintptr_t>(&arrowArray),
+        reinterpret_cast<uintptr_t>(&arrowSchema));
+  } else {
+    throw py::type_error(
+        "Expected an object that supports the Arrow C data interface");
+  }
+  return importArrowStructs(arrowSchema, arrowArray, pool);
+}
+
+/// Returns a pyarrow.Array over the buffers of 'vector'. The buffers are
+/// shared with 'vector' without copying, except for the types that Velox lays
+/// out differently than Arrow, e.g. strings.
+inline py::object vectorToArrow(
+    const VectorPtr& vector,
+    memory::MemoryPool* pool) {
+  auto pyarrow = py::module_::import("pyarrow");
+  ArrowArray arrowArray;
+  ArrowSchema arrowSchema;
+  arrow::exportToArrow(vector, arrowArray, pool);
+  try {
+    arrow::exportToArrow(vector, arrowSchema);
+  } catch (const std::exception&) {
+    arrowArray.release(&arrowArray);
+    throw;
+  }
+  try {
+    return pyarrow.attr("Array").attr("_import_from_c")(
+        reinterpret_cast<uintptr_t>(&arrowArray),
+        reinterpret_cast<uintptr_t>(&arrowSchema));
+  } catch (const std::exception&) {
+    // pyarrow marks the structs it took over as released.
+    if (arrowArray.release != nullptr) {
+      arrowArray.release(&arrowArray);
+    }
+    if (arrowSchema.release != nullptr) {
+      arrowSchema.release(&arrowSchema);
+    }
+    throw;
+  }
+}
+
+/// Implements the __arrow_c_array__() method of the Arrow PyCapsule interface.
+/// Returns a tuple of an 'arrow_schema' and an 'arrow_array' capsule over the
+/// exported 'vector'. The consumer moves the structs out of the capsules.
+inline py::tuple vectorToArrowCapsules(
+    const VectorPtr& vector,
+    memory::MemoryPool* pool) {
+  auto arrowSchema = std::make_unique<ArrowSchema>();
+  auto arrowArray = std::make_unique<ArrowArray>();
+  arrow::exportToArrow(vector, *arrowSchema);
+  try {
+    arrow::exportToArrow(vector, *arrowArray, pool);
+  } catch (const std::exception&) {
+    arrowSchema->release(arrowSchema.get());
+    throw;
+  }
+  py::capsule schemaCapsule(
+      arrowSchema.get(), "arrow_schema", [](PyObject* capsule) {
+        auto* schema = static_cast<ArrowSchema*>(
+            PyCapsule_GetPointer(capsule, "arrow_schema"));
+        if (schema->release != nullptr) {
+          schema->release(schema);
+        }
+        delete schema;
+      });
+  arrowSchema.release();
+  py::capsule arrayCapsule(
+      arrowArray.get(), "arrow_array", [](PyObject* capsule) {
+        auto* array = static_cast<ArrowArray*>(
+            PyCapsule_GetPointer(capsule, "arrow_array"));
+        if (array->release != nullptr) {
+          array->release(array);
+        }
+        delete array;
+      });
+  arrowArray.release();
+  return py::make_tuple(schemaCapsule, arrayCapsule);
+}
+
+template <typename T>
+inline VectorPtr wrapNumpyArray(
+    const py::array& array,
+    const TypePtr& type,
+    memory::MemoryPool* pool) {
+  auto values = BufferView<PyObjectReleaser>::create(
+      static_cast<const uint8_t*>(array.data()),
+      array.nbytes(),
+      PyObjectReleaser{array.ptr()});
+  return std::make_shared<FlatVector<T>>(
+      pool,
+      type,
+      BufferPtr(nullptr),
+      array.size(),
+      std::move(values),
+      std::vector<BufferPtr>{});
+}
+
+/// Makes a flat vector without nulls over the memory of a one dimensional
+/// NumPy array of signed integers or floating point numbers, which the vector
+/// keeps alive. The array is copied if it is not contiguous or is of booleans,
+/// which Velox packs into bits.
+inline VectorPtr numpyToVector(py::array array, memory::MemoryPool* pool) {
+  if (array.ndim() != 1) {
+    throw py::value_error("Expected a one dimensional array");
+  }
+  if (!array.dtype().attr("isnative").cast<bool>()) {
+    throw py::value_error("Expected an array in native byte order");
+  }
+  const auto kind = array.dtype().kind();
+  const auto itemSize = array.itemsize();
+  if (kind == 'b') {
+    auto vector = BaseVector::create(BOOLEAN(), array.size(), pool);
+    auto* flat = vector->asFlatVector<bool>();
+    auto values = array.unchecked<bool, 1>();
+    for (py::ssize_t i = 0; i < array.size(); ++i) {
+      flat->set(i, values(i));
+    }
+    return vector;
+  }
+
+  array = py::array::ensure(array, py::array::c_style);
+  if (kind == 'i') {
+    switch (itemSize) {
+      case 1:
+        return wrapNumpyArray<int8_t>(array, TINYINT(), pool);
+      case 2:
+        return wrapNumpyArray<int16_t>(array, SMALLINT(), pool);
+      case 4:
+        return wrapNumpyArray<int32_t>(array, INTEGER(), pool);
+      case 8:
+        return wrapNumpyArray<int64_t>(array, BIGINT(), pool);
+    }
+  } else if (kind == 'f') {
+    switch (itemSize) {
+      case 4:
+        return wrapNumpyArray<float>(array, REAL(), pool);
+      case 8:
+        return wrapNumpyArray<double>(array, DOUBLE(), pool);
+    }
+  }
+  throw py::type_error(
+      "Unsupported array type: " + py::str(array.dtype()).cast<std::string>());
+}
+
+inline py::dtype numpyDtype(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return py::dtype::of<int8_t>();
+    case TypeKind::SMALLINT:
+      return py::dtype::of<int16_t>();
+    case TypeKind::INTEGER:
+      return py::dtype::of<int32_t>();
+    case TypeKind::BIGINT:
+      return py::dtype::of<int64_t>();
+    case TypeKind::REAL:
+      return py::dtype::of<float>();
+    case TypeKind::DOUBLE:
+      return py::dtype::of<double>();
+    default:
+      throw py::value_error(
+          "Cannot view a vector of type " + mapTypeKindToName(kind) +
+          " as a NumPy array, use to_arrow() instead");
+  }
+}
+
+/// Returns a read-only NumPy array over the values of 'vector', which the
+/// array keeps alive. 'vector' must be a flat vector of integers or floating
+/// point numbers without nulls.
+inline py::array vectorToNumpy(const VectorPtr& vector) {
+  auto dtype = numpyDtype(vector->typeKind());
+  if (vector->encoding() != VectorEncoding::Simple::FLAT ||
+      BaseVector::countNulls(vector->nulls(), vector->size()) > 0) {
+    throw py::value_error(
+        "Only flat vectors without nulls can be viewed as NumPy arrays, use "
+        "to_arrow() instead");
+  }
+  auto* holder = new VectorPtr(vector);
+  py::capsule base(
+      holder, [](void* ptr) { delete static_cast<VectorPtr*>(ptr); });
+  py::array result(
+      dtype,
+      {static_cast<py::ssize_t>(vector->size())},
+      {static_cast<py::ssize_t>(dtype.itemsize())},
+      vector->valuesAsVoid(),
+      base);
+  result.attr("setflags")(py::arg("write") = false);
+  return result;
+}
+
 inline void addVectorBindings(
     py::module& m,
     bool asModuleLocalDefinitions = true) {
@@ -412,10 +670,41 @@ inline void addVectorBindings(
             return v->hashValueAt(idx);
           })
       .def("encoding", &BaseVector::encoding)
-      .def("append", [](VectorPtr& u, VectorPtr& v) { appendVectors(u, v); });
+      .def("append", [](VectorPtr& u, VectorPtr& v) { appendVectors(u, v); })
+      .def(
+          "__arrow_c_array__",
+          [](VectorPtr& v, py::object /*requestedSchema*/) {
+            return vectorToArrowCapsules(
+                v, PyVeloxContext::getInstance().pool());
+          },
+          py::arg("requested_schema") = py::none(),
+          "Exports the vector through the Arrow PyCapsule interface");
   m.def("from_list", [](const py::list& list) mutable {
     return pyListToVector(list, PyVeloxContext::getInstance().pool());
   });
+  m.def(
+      "from_arrow",
+      [](const py::object& obj) {
+        return arrowToVector(obj, PyVeloxContext::getInstance().pool());
+      },
+      "Makes a vector over the buffers of an Arrow array or record batch");
+  m.def(
+      "to_arrow",
+      [](VectorPtr& v) {
+        return vectorToArrow(v, PyVeloxContext::getInstance().pool());
+      },
+      "Returns a pyarrow.Array over the buffers of the vector");
+  m.def(
+      "from_numpy",
+      [](py::array array) {
+        return numpyToVector(
+            std::move(array), PyVeloxContext::getInstance().pool());
+      },
+      "Makes a vector over the memory of a one dimensional NumPy array");
+  m.def(
+      "to_numpy",
+      [](VectorPtr& v) { return vectorToNumpy(v); },
+      "Returns a read-only NumPy array over the values of a flat vector");
 }
 
 static void addExpressionBindings(
@@ -0,0 +1,150 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import threading
+import unittest
+
+import pyvelox.pyvelox as pv
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+try:
+    import pyarrow as pa
+except ImportError:
+    pa = None
+
+
+@unittest.skipIf(pa is None, "pyarrow is not installed")
+class TestArrow(unittest.TestCase):
+    def test_from_arrow(self):
+        vector = pv.from_arrow(pa.array([1, None, 3]))
+        self.assertEqual(vector.dtype(), pv.BigintType())
+        self.assertEqual(len(vector), 3)
+        self.assertEqual(vector[0], 1)
+        self.assertTrue(vector.isNullAt(1))
+        self.assertEqual(vector[2], 3)
+
+        strings = pv.from_arrow(pa.array(["hello", "world"]))
+        self.assertEqual(strings.dtype(), pv.VarcharType())
+        self.assertEqual(strings[1], "world")
+
+        with self.assertRaises(TypeError):
+            pv.from_arrow([1, 2, 3])
+
+    def test_from_record_batch(self):
+        batch = pa.RecordBatch.from_arrays(
+            [pa.array([1, 2]), pa.array(["a", "b"])], names=["x", "y"]
+        )
+        vector = pv.from_arrow(batch)
+        self.assertEqual(vector.typeKind(), pv.TypeKind.ROW)
+        self.assertEqual(len(vector), 2)
+
+    def test_to_arrow(self):
+        array = pv.to_arrow(pv.from_list([1, None, 3]))
+        self.assertEqual(array.type, pa.int64())
+        self.assertEqual(array.to_pylist(), [1, None, 3])
+
+        strings = pv.to_arrow(pv.from_list(["hello", "world"]))
+        self.assertEqual(strings.to_pylist(), ["hello", "world"])
+
+    def test_round_trip(self):
+        array = pa.array([1.5, 2.5, None])
+        self.assertEqual(pv.to_arrow(pv.from_arrow(array)), array)
+        # The Arrow PyCapsule interface.
+        self.assertEqual(pa.array(pv.from_arrow(array)), array)
+
+    def test_evaluate(self):
+        expr = pv.Expression.from_string("a + b")
+        result = expr.evaluate(
+            ["a", "b"],
+            [pv.from_arrow(pa.array([1, 2, 3])), pv.from_arrow(pa.array([10, 20, 30]))],
+        )
+        self.assertEqual(pv.to_arrow(result).to_pylist(), [11, 22, 33])
+
+    def test_evaluate_in_threads(self):
+        expr = pv.Expression.from_string("a * 2")
+        inputs = [pv.from_arrow(pa.array(list(range(i, i + 1000)))) for i in range(8)]
+        results = [None] * len(inputs)
+
+        def evaluate(i):
+            results[i] = expr.evaluate(["a"], [inputs[i]])
+
+        threads = [
+            threading.Thread(target=evaluate, args=(i,)) for i in range(len(inputs))
+        ]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        for i, result in enumerate(results):
+            self.assertEqual(
+                pv.to_arrow(result).to_pylist(), [2 * j for j in range(i, i + 1000)]
+            )
+
+
+@unittest.skipIf(np is None, "numpy is not installed")
+class TestNumpy(unittest.TestCase):
+    def test_from_numpy(self):
+        vector = pv.from_numpy(np.array([1, 2, 3], dtype=np.int32))
+        self.assertEqual(vector.dtype(), pv.IntegerType())
+        self.assertEqual(vector[2], 3)
+        self.assertFalse(vector.mayHaveNulls())
+
+        doubles = pv.from_numpy(np.array([0.5, 1.5]))
+        self.assertEqual(doubles.dtype(), pv.DoubleType())
+        self.assertEqual(doubles[1], 1.5)
+
+        booleans = pv.from_numpy(np.array([True, False, True]))
+        self.assertEqual(booleans.dtype(), pv.BooleanType())
+        self.assertEqual([booleans[i] for i in range(3)], [True, False, True])
+
+        strided = pv.from_numpy(np.arange(10, dtype=np.int64)[::2])
+        self.assertEqual([strided[i] for i in range(5)], [0, 2, 4, 6, 8])
+
+        with self.assertRaises(TypeError):
+            pv.from_numpy(np.array([1, 2], dtype=np.uint32))
+        with self.assertRaises(ValueError):
+            pv.from_numpy(np.zeros((2, 2)))
+
+    def test_shares_memory(self):
+        array = np.array([1, 2, 3], dtype=np.int64)
+        vector = pv.from_numpy(array)
+        array[0] = 10
+        self.assertEqual(vector[0], 10)
+        # The vector keeps the array alive.
+        del array
+        self.assertEqual(vector[0], 10)
+
+    def test_to_numpy(self):
+        vector = pv.from_list([1, 2, 3])
+        array = pv.to_numpy(vector)
+        self.assertEqual(array.dtype, np.int64)
+        self.assertEqual(array.tolist(), [1, 2, 3])
+        self.assertFalse(array.flags.writeable)
+        # The array keeps the vector alive.
+        del vector
+        self.assertEqual(array.tolist(), [1, 2, 3])
+
+        with self.assertRaises(ValueError):
+            pv.to_numpy(pv.from_list([1, None, 3]))
+        with self.assertRaises(ValueError):
+            pv.to_numpy(pv.from_list(["hello"]))
+
+    def test_evaluate(self):
+        expr = pv.Expression.from_string("a + 1.0")
+        result = expr.evaluate(["a"], [pv.from_numpy(np.array([0.5, 1.5]))])
+        self.assertEqual(pv.to_numpy(result).tolist(), [1.5, 2.5])
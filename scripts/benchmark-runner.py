@@ -64,6 +64,13 @@ def get_benchmark_handle(file_path, name):
     return "{}/{}".format(os.path.basename(file_path), name)
 
 
+def fmt_value(name, value):
+    # User counters are compared under "<benchmark>[<counter>]".
+    if name.endswith("]"):
+        return "{:,}".format(value)
+    return fmt_runtime(value)
+
+
 def fmt_runtime(time_ns):
     if time_ns < 1000:
         return "{:.2f}ns".format(time_ns)
@@ -99,6 +106,19 @@ def compare_file(args, target_data, baseline_data):
                 if row[1] == "-":
                     continue
                 output_map[(row[0], row[1])][retry] = row[2]
+
+                # Folly benchmark exports the user counters of a benchmark as
+                # a fourth entry. Compare the selected ones like the time.
+                if len(row) < 4:
+                    continue
+                for counter in args.counters:
+                    if counter not in row[3]:
+                        continue
+                    value = row[3][counter]
+                    if isinstance(value, dict):
+                        value = value["value"]
+                    name = "{}[{}]".format(row[1], counter)
+                    output_map[(row[0], name)][retry] = value
         return output_map
 
     baseline_map = preprocess_data(baseline_data)
@@ -151,7 +171,9 @@ def compare_file(args, target_data, baseline_data):
                 passes.append((handle[0], handle[1], delta))
 
             suffix = "({} vs {}) {:+.2f}%".format(
-                fmt_runtime(baseline_result), fmt_runtime(target_result), delta * 100
+                fmt_value(handle[1], baseline_result),
+                fmt_value(handle[1], target_result),
+                delta * 100,
             )
             bm_handle = get_benchmark_handle(*handle)
 
@@ -421,7 +443,9 @@ def run(args):
             return "^{}$".format(json_file_name.rstrip(".json"))
 
         def gen_bm_filter(bm_list):
-            return "^{}$".format("|".join([x[1] for x in bm_list]))
+            # Strip the counter names from the compared user counters.
+            names = {x[1].split("[")[0] for x in bm_list}
+            return "^{}$".format("|".join(sorted(names)))
 
         for file_name, bm_list in json_input.items():
             kwargs["binary_filter"] = gen_binary_filter(file_name)
@@ -516,6 +540,14 @@ def parse_args():
         "Variations larger than this threshold will be reported as failures. "
         "Default 0.05 (5%%).",
     )
+    parser_compare.add_argument(
+        "--counters",
+        default=[],
+        type=lambda value: value.split(","),
+        help="Comma-separated names of user counters, e.g. "
+        "'cpu_nanos,peak_memory_bytes', to compare in addition to the time. "
+        "The same threshold applies; larger values are regressions.",
+    )
     parser_compare.add_argument(
         "--rerun_json_output",
         default=None,
@@ -118,6 +118,23 @@ class DecodedVectorBenchmark : public functions::test::FunctionBenchmarkBase {
     DecodedVector decodedVector(*dictionaryNestedVector_, rows_);
   }
 
+  // Measure time to decode a 5-way nested dictionary vector for 3 functions
+  // that take it as input, each decoding it separately.
+  void decodeDictionary5NestedThreeTimes() {
+    for (auto i = 0; i < 3; ++i) {
+      DecodedVector decodedVector(*dictionaryNestedVector_, rows_);
+    }
+  }
+
+  // Same as above with the decoded vector cached in EvalCtx.
+  void decodeDictionary5NestedThreeTimesCached() {
+    EvalCtx context(&execCtx_);
+    for (auto i = 0; i < 3; ++i) {
+      folly::doNotOptimizeAway(
+          context.decodeNestedDictionary(dictionaryNestedVector_, rows_));
+    }
+  }
+
  private:
   void decodedRun(const DecodedVector& decodedVector) {
     size_t sum = 0;
@@ -185,6 +202,14 @@ BENCHMARK(decodeDictionary5Nested) {
   run([&] { benchmark->decodeDictionary5Nested(); });
 }
 
+BENCHMARK(decodeDictionary5NestedThreeTimes) {
+  run([&] { benchmark->decodeDictionary5NestedThreeTimes(); });
+}
+
+BENCHMARK_RELATIVE(decodeDictionary5NestedThreeTimesCached) {
+  run([&] { benchmark->decodeDictionary5NestedThreeTimesCached(); });
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -91,6 +91,13 @@ class LikeFunctionsBenchmark : public FunctionBaseTest,
         auto fixedPatternString = inputString.substr(fixedPatternStartIdx, 10);
         return generateRandomString(kAnyWildcardCharacter) + fixedPatternString;
       }
+      case PatternKind::kSubstring: {
+        auto fixedPatternStartIdx =
+            std::min(vector_size_t(inputString.size()) / 2, 10);
+        auto fixedPatternString = inputString.substr(fixedPatternStartIdx, 10);
+        return generateRandomString(kAnyWildcardCharacter) +
+            fixedPatternString + generateRandomString(kAnyWildcardCharacter);
+      }
       default:
         return inputString;
     }
@@ -123,11 +130,19 @@ class LikeFunctionsBenchmark : public FunctionBaseTest,
     }
   }
 
-  size_t run(const TpchBenchmarkCase tpchCase, const StringView patternString) {
+  // Evaluates like with 'patternString' over the column of 'tpchCase'. If
+  // 'withEscape' is true, an escape character is given, so that the pattern
+  // is matched with RE2 instead of a specialized implementation.
+  size_t run(
+      const TpchBenchmarkCase tpchCase,
+      const StringView patternString,
+      bool withEscape = false) {
     folly::BenchmarkSuspender kSuspender;
     const auto input = getTpchData(tpchCase);
     const auto data = makeRowVector({input});
-    auto likeExpression = fmt::format("like(c0, '{}')", patternString);
+    auto likeExpression = withEscape
+        ? fmt::format("like(c0, '{}', '#')", patternString)
+        : fmt::format("like(c0, '{}')", patternString);
     auto rowType = std::dynamic_pointer_cast<const RowType>(data->type());
     exec::ExprSet exprSet =
         FunctionBenchmarkBase::compileExpression(likeExpression, rowType);
@@ -199,17 +214,29 @@ BENCHMARK(suffixPattern) {
   benchmark->run(PatternKind::kSuffix);
 }
 
+BENCHMARK(substringPattern) {
+  benchmark->run(PatternKind::kSubstring);
+}
+
 BENCHMARK_DRAW_LINE();
 
 BENCHMARK(tpchQuery2) {
   benchmark->run(TpchBenchmarkCase::TpchQuery2, "%BRASS");
 }
 
-BENCHMARK(tpchQuery9) {
+BENCHMARK(tpchQuery9Re2) {
+  benchmark->run(TpchBenchmarkCase::TpchQuery9, "%green%", true);
+}
+
+BENCHMARK_RELATIVE(tpchQuery9) {
   benchmark->run(TpchBenchmarkCase::TpchQuery9, "%green%");
 }
 
-BENCHMARK(tpchQuery13) {
+BENCHMARK(tpchQuery13Re2) {
+  benchmark->run(TpchBenchmarkCase::TpchQuery13, "%special%requests%", true);
+}
+
+BENCHMARK_RELATIVE(tpchQuery13) {
   benchmark->run(TpchBenchmarkCase::TpchQuery13, "%special%requests%");
 }
 
@@ -221,7 +248,12 @@ BENCHMARK(tpchQuery16Part) {
   benchmark->run(TpchBenchmarkCase::TpchQuery16Part, "MEDIUM POLISHED%");
 }
 
-BENCHMARK(tpchQuery16Supplier) {
+BENCHMARK(tpchQuery16SupplierRe2) {
+  benchmark->run(
+      TpchBenchmarkCase::TpchQuery16Supplier, "%Customer%Complaints%", true);
+}
+
+BENCHMARK_RELATIVE(tpchQuery16Supplier) {
   benchmark->run(
       TpchBenchmarkCase::TpchQuery16Supplier, "%Customer%Complaints%");
 }
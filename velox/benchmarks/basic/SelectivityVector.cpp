@@ -41,7 +41,8 @@ class SelectivityVectorBenchmark
         rows99PerCent_(vectorSize),
         rows50PerCent_(vectorSize),
         rows10PerCent_(vectorSize),
-        rows1PerCent_(vectorSize) {
+        rows1PerCent_(vectorSize),
+        rows001PerCent_(vectorSize, false) {
     VectorFuzzer::Options opts;
     opts.vectorSize = vectorSize_;
     opts.nullRatio = 0;
@@ -75,6 +76,12 @@ class SelectivityVectorBenchmark
     rows50PerCent_.updateBounds();
     rows10PerCent_.updateBounds();
     rows1PerCent_.updateBounds();
+
+    // Select 1 in 10'000, as after a very selective filter.
+    for (size_t i = 3'617; i < vectorSize_; i += 10'000) {
+      rows001PerCent_.setValid(i, true);
+    }
+    rows001PerCent_.updateBounds();
   }
 
   size_t runBaseline() {
@@ -108,6 +115,19 @@ class SelectivityVectorBenchmark
     return run(rows99PerCent_);
   }
 
+  size_t runSelectivity001PerCent() {
+    return run(rows001PerCent_);
+  }
+
+  // Calls countSelected() on a copy of 'rows1PerCent_' and intersects it with
+  // 'rows50PerCent_', as filters do for each conjunct.
+  size_t runIntersectAndCount() {
+    SelectivityVector rows = rows1PerCent_;
+    rows.intersect(rows50PerCent_);
+    folly::doNotOptimizeAway(rows.countSelected());
+    return vectorSize_;
+  }
+
  private:
   size_t run(const SelectivityVector& rows) {
     const int64_t* flatBuffer = flatVector_->values()->as<int64_t>();
@@ -126,6 +146,7 @@ class SelectivityVectorBenchmark
   SelectivityVector rows50PerCent_;
   SelectivityVector rows10PerCent_;
   SelectivityVector rows1PerCent_;
+  SelectivityVector rows001PerCent_;
 };
 
 std::unique_ptr<SelectivityVectorBenchmark> benchmark;
@@ -161,6 +182,16 @@ BENCHMARK(sumSelectivity1PerCent) {
   run([] { benchmark->runSelectivity1PerCent(); });
 }
 
+BENCHMARK(sumSelectivity001PerCent) {
+  run([] { benchmark->runSelectivity001PerCent(); });
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(intersectAndCount) {
+  run([] { benchmark->runIntersectAndCount(); });
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -21,6 +21,7 @@
 
 #include "velox/functions/Registerer.h"
 #include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/Arithmetic.h"
 #include "velox/functions/prestosql/ArithmeticImpl.h"
 #include "velox/functions/prestosql/CheckedArithmeticImpl.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
@@ -91,6 +92,9 @@ class SimpleArithmeticBenchmark
         {"multiply_nullable_output"});
     registerFunction<MultiplyNullOutputFunction, double, double, double>(
         {"multiply_null_output"});
+    // Presto's multiply, which provides callBatch().
+    registerFunction<functions::MultiplyFunction, double, double, double>(
+        {"multiply_batch"});
 
     registerFunction<PlusFunction, int64_t, int64_t, int64_t>({"plus"});
     registerFunction<CheckedPlusFunction, int64_t, int64_t, int64_t>(
@@ -218,6 +222,16 @@ BENCHMARK(multiplyOutputAlwaysNullSmall) {
 
 BENCHMARK_DRAW_LINE();
 
+BENCHMARK(multiplyBatchSmall) {
+  benchmark->runSmall("multiply_batch(a, b)");
+}
+
+BENCHMARK(multiplyBatchHalfNullSmall) {
+  benchmark->runSmall("multiply_batch(a, half_null)");
+}
+
+BENCHMARK_DRAW_LINE();
+
 BENCHMARK(plusUncheckedSmall) {
   benchmark->runSmall("plus(c, d)");
 }
@@ -275,6 +289,16 @@ BENCHMARK(multiplyOutputAlwaysNullMedium) {
 
 BENCHMARK_DRAW_LINE();
 
+BENCHMARK(multiplyBatchMedium) {
+  benchmark->runMedium("multiply_batch(a, b)");
+}
+
+BENCHMARK(multiplyBatchHalfNullMedium) {
+  benchmark->runMedium("multiply_batch(a, half_null)");
+}
+
+BENCHMARK_DRAW_LINE();
+
 BENCHMARK(plusUncheckedMedium) {
   benchmark->runMedium("plus(c, d)");
 }
@@ -332,6 +356,16 @@ BENCHMARK(multiplyOutputAlwaysNullLarge) {
 
 BENCHMARK_DRAW_LINE();
 
+BENCHMARK(multiplyBatchLarge) {
+  benchmark->runLarge("multiply_batch(a, b)");
+}
+
+BENCHMARK(multiplyBatchHalfNullLarge) {
+  benchmark->runLarge("multiply_batch(a, half_null)");
+}
+
+BENCHMARK_DRAW_LINE();
+
 BENCHMARK(plusUncheckedLarge) {
   benchmark->runLarge("plus(c, d)");
 }
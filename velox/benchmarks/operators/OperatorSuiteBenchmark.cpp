@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/memory/ByteStream.h"
+#include "velox/connectors/hive/HiveConnector.h"
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_int32(num_batches, 100, "Number of input batches of each query");
+DEFINE_int32(num_groups, 100'000, "Number of distinct grouping and join keys");
+DEFINE_int32(num_drivers, 4, "Number of drivers per pipeline");
+DEFINE_int64(
+    spill_memory_threshold,
+    8 << 20,
+    "Memory threshold of the spilling operators in the spill benchmarks");
+
+/// Standard suite of end-to-end benchmarks to run on each release: scans of
+/// DWRF files with direct and dictionary encoded strings, hash aggregation,
+/// order by and hash join with and without spilling, exchange serde and
+/// filter and project expressions.
+///
+/// Next to the wall time, each benchmark reports the CPU time, the peak memory
+/// and the I/O bytes of its query as user counters. Dump the results with
+/// --bm_json_verbose and compare them with a stored baseline using
+/// 'scripts/benchmark-runner.py compare', which takes the counters to compare
+/// in --counters.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+namespace {
+
+constexpr vector_size_t kBatchSize = 10'000;
+
+class OperatorSuiteBenchmark : public VectorTestBase {
+ public:
+  OperatorSuiteBenchmark() {
+    functions::prestosql::registerAllScalarFunctions();
+    aggregate::prestosql::registerAllAggregateFunctions();
+    parse::registerTypeResolver();
+    filesystems::registerLocalFileSystem();
+    dwrf::registerDwrfReaderFactory();
+    auto hiveConnector =
+        connector::getConnectorFactory(
+            connector::hive::HiveConnectorFactory::kHiveConnectorName)
+            ->newConnector(kHiveConnectorId, nullptr);
+    connector::registerConnector(hiveConnector);
+
+    for (auto i = 0; i < 100; ++i) {
+      strings_.push_back(fmt::format("string value number {}", i));
+    }
+    for (auto i = 0; i < FLAGS_num_batches; ++i) {
+      data_.push_back(makeRowVector(
+          {"c0", "c1", "c2", "c3"},
+          {
+              makeFlatVector<int64_t>(
+                  kBatchSize,
+                  [&](auto row) {
+                    return (i * kBatchSize + row) * 7'919L % FLAGS_num_groups;
+                  }),
+              makeFlatVector<int64_t>(
+                  kBatchSize, [&](auto row) { return i * kBatchSize + row; }),
+              makeFlatVector<double>(
+                  kBatchSize, [](auto row) { return row * 0.1; }),
+              makeFlatVector<StringView>(
+                  kBatchSize,
+                  [&](auto row) {
+                    return StringView(strings_[row % strings_.size()]);
+                  }),
+          }));
+    }
+    buildData_ = makeRowVector(
+        {"k0", "k1"},
+        {
+            makeFlatVector<int64_t>(
+                FLAGS_num_groups, [](auto row) { return row; }),
+            makeFlatVector<int64_t>(
+                FLAGS_num_groups, [](auto row) { return row * 3; }),
+        });
+
+    directory_ = TempDirectoryPath::create();
+    directFile_ = directory_->path + "/direct.dwrf";
+    dictionaryFile_ = directory_->path + "/dictionary.dwrf";
+    auto config = std::make_shared<dwrf::Config>();
+    config->set(dwrf::Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD, 0.0f);
+    writeToFile(directFile_, config);
+    config = std::make_shared<dwrf::Config>();
+    config->set(dwrf::Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD, 1.0f);
+    writeToFile(dictionaryFile_, config);
+  }
+
+  ~OperatorSuiteBenchmark() override {
+    connector::unregisterConnector(kHiveConnectorId);
+  }
+
+  void scan(bool dictionary, folly::UserCounters& counters) {
+    folly::BenchmarkSuspender suspender;
+    auto plan = PlanBuilder()
+                    .tableScan(asRowType(data_[0]->type()))
+                    .singleAggregation({}, {"sum(c1)", "max(c3)"})
+                    .planNode();
+    suspender.dismiss();
+
+    AssertQueryBuilder builder(plan);
+    builder.split(HiveConnectorTestBase::makeHiveConnectorSplit(
+        dictionary ? dictionaryFile_ : directFile_));
+    run(builder, counters);
+  }
+
+  void aggregation(bool spill, folly::UserCounters& counters) {
+    folly::BenchmarkSuspender suspender;
+    auto plan = PlanBuilder()
+                    .values(data_, true)
+                    .partialAggregation({"c0"}, {"sum(c1)", "count(1)"})
+                    .localPartitionedFinalAggregation()
+                    .planNode();
+    suspender.dismiss();
+
+    AssertQueryBuilder builder(plan);
+    run(spill ? enableSpill(builder) : builder, counters);
+  }
+
+  void orderBy(bool spill, folly::UserCounters& counters) {
+    folly::BenchmarkSuspender suspender;
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .localMerge(
+                        {"c0", "c1 DESC"},
+                        {PlanBuilder(planNodeIdGenerator)
+                             .values(data_, true)
+                             .orderBy({"c0", "c1 DESC"}, true)
+                             .planNode()})
+                    .planNode();
+    suspender.dismiss();
+
+    AssertQueryBuilder builder(plan);
+    run(spill ? enableSpill(builder) : builder, counters);
+  }
+
+  void hashJoin(bool spill, folly::UserCounters& counters) {
+    folly::BenchmarkSuspender suspender;
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(data_, true)
+                    .hashJoin(
+                        {"c0"},
+                        {"k0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values({buildData_})
+                            .planNode(),
+                        "",
+                        {"c1", "k1"})
+                    .partialAggregation({}, {"sum(c1)", "sum(k1)"})
+                    .localPartition({})
+                    .finalAggregation()
+                    .planNode();
+    suspender.dismiss();
+
+    AssertQueryBuilder builder(plan);
+    run(spill ? enableSpill(builder) : builder, counters);
+  }
+
+  void filterProject(folly::UserCounters& counters) {
+    folly::BenchmarkSuspender suspender;
+    auto plan = PlanBuilder()
+                    .values(data_, true)
+                    .filter("c0 % 3 = 1 AND c2 < 500.0")
+                    .project(
+                        {"c0 * 2 + c1 AS a",
+                         "c2 * c2 AS b",
+                         "substr(c3, 1, 6) AS c"})
+                    .partialAggregation({}, {"sum(a)", "sum(b)", "max(c)"})
+                    .localPartition({})
+                    .finalAggregation()
+                    .planNode();
+    suspender.dismiss();
+
+    AssertQueryBuilder builder(plan);
+    run(builder, counters);
+  }
+
+  // Serializes all the input batches in the Presto wire format as
+  // PartitionedOutput does, then deserializes them as Exchange does.
+  void serde(folly::UserCounters& counters) {
+    serializer::presto::PrestoVectorSerde serde;
+    auto rowType = asRowType(data_[0]->type());
+    uint64_t serializedBytes = 0;
+    for (const auto& batch : data_) {
+      std::ostringstream output;
+      auto arena = std::make_unique<StreamArena>(pool());
+      auto serializer =
+          serde.createSerializer(rowType, batch->size(), arena.get());
+      IndexRange range{0, batch->size()};
+      serializer->append(batch, folly::Range(&range, 1));
+      serializer::presto::PrestoOutputStreamListener listener;
+      OStreamOutputStream out(&output, &listener);
+      serializer->flush(&out);
+
+      auto serialized = output.str();
+      serializedBytes += serialized.size();
+      ByteStream input;
+      ByteRange byteRange{
+          reinterpret_cast<uint8_t*>(serialized.data()),
+          static_cast<int32_t>(serialized.size()),
+          0};
+      input.resetInput({byteRange});
+      RowVectorPtr result;
+      serde.deserialize(&input, pool(), rowType, &result);
+      folly::doNotOptimizeAway(result->size());
+    }
+    counters["serialized_bytes"] = serializedBytes;
+  }
+
+ private:
+  void writeToFile(
+      const std::string& path,
+      const std::shared_ptr<dwrf::Config>& config) {
+    dwrf::WriterOptions options;
+    options.config = config;
+    options.schema = data_[0]->type();
+    auto sink = std::make_unique<dwio::common::LocalFileSink>(path);
+    auto writerPool = rootPool_->addAggregateChild("OperatorSuite.Writer");
+    dwrf::Writer writer{options, std::move(sink), *writerPool};
+    for (const auto& batch : data_) {
+      writer.write(batch);
+    }
+    writer.close();
+  }
+
+  // Makes the spilling operators spill when their memory exceeds
+  // --spill_memory_threshold.
+  AssertQueryBuilder& enableSpill(AssertQueryBuilder& builder) {
+    const auto threshold = std::to_string(FLAGS_spill_memory_threshold);
+    spillDirectory_ = TempDirectoryPath::create();
+    return builder.spillDirectory(spillDirectory_->path)
+        .config(core::QueryConfig::kSpillEnabled, "true")
+        .config(core::QueryConfig::kAggregationSpillMemoryThreshold, threshold)
+        .config(core::QueryConfig::kOrderBySpillMemoryThreshold, threshold)
+        .config(core::QueryConfig::kJoinSpillMemoryThreshold, threshold);
+  }
+
+  // Runs the query of 'builder' and sets 'counters' from the stats of the
+  // task.
+  void run(AssertQueryBuilder& builder, folly::UserCounters& counters) {
+    std::shared_ptr<Task> task;
+    auto result =
+        builder.maxDrivers(FLAGS_num_drivers).copyResults(pool(), task);
+    folly::doNotOptimizeAway(result->size());
+
+    folly::BenchmarkSuspender suspender;
+    waitForTaskCompletion(task.get());
+    uint64_t cpuNanos = 0;
+    uint64_t inputBytes = 0;
+    uint64_t spilledBytes = 0;
+    for (const auto& [_, stats] : toPlanStats(task->taskStats())) {
+      cpuNanos += stats.cpuWallTiming.cpuNanos;
+      inputBytes += stats.rawInputBytes;
+      spilledBytes += stats.spilledBytes;
+    }
+    counters["cpu_nanos"] = cpuNanos;
+    counters["peak_memory_bytes"] = task->pool()->getMaxBytes();
+    counters["input_bytes"] = inputBytes;
+    counters["spilled_bytes"] = spilledBytes;
+    task.reset();
+    spillDirectory_.reset();
+  }
+
+  std::vector<std::string> strings_;
+  std::vector<RowVectorPtr> data_;
+  RowVectorPtr buildData_;
+  std::shared_ptr<TempDirectoryPath> directory_;
+  std::string directFile_;
+  std::string dictionaryFile_;
+  std::shared_ptr<TempDirectoryPath> spillDirectory_;
+};
+
+std::unique_ptr<OperatorSuiteBenchmark> benchmark;
+
+BENCHMARK_COUNTERS(scanDirect, counters) {
+  benchmark->scan(false, counters);
+}
+
+BENCHMARK_COUNTERS(scanDictionary, counters) {
+  benchmark->scan(true, counters);
+}
+
+BENCHMARK_COUNTERS(aggregation, counters) {
+  benchmark->aggregation(false, counters);
+}
+
+BENCHMARK_COUNTERS(aggregationSpill, counters) {
+  benchmark->aggregation(true, counters);
+}
+
+BENCHMARK_COUNTERS(orderBy, counters) {
+  benchmark->orderBy(false, counters);
+}
+
+BENCHMARK_COUNTERS(orderBySpill, counters) {
+  benchmark->orderBy(true, counters);
+}
+
+BENCHMARK_COUNTERS(hashJoin, counters) {
+  benchmark->hashJoin(false, counters);
+}
+
+BENCHMARK_COUNTERS(hashJoinSpill, counters) {
+  benchmark->hashJoin(true, counters);
+}
+
+BENCHMARK_COUNTERS(filterProject, counters) {
+  benchmark->filterProject(counters);
+}
+
+BENCHMARK_COUNTERS(serde, counters) {
+  benchmark->serde(counters);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<OperatorSuiteBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
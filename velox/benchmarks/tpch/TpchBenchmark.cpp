@@ -109,6 +109,11 @@ DEFINE_int32(
     0,
     "GB of process memory for cache and query.. if "
     "non-0, uses mmap to allocator and in-process data cache.");
+DEFINE_bool(
+    use_huge_pages,
+    false,
+    "Back the larger size classes of the mmap allocator with transparent huge "
+    "pages. Applies if cache_gb is non-0.");
 DEFINE_int32(num_repeats, 1, "Number of times to run each query");
 
 DEFINE_validator(data_path, &notEmpty);
@@ -123,6 +128,7 @@ class TpchBenchmark {
       options.capacity = memoryBytes;
       options.useMmapArena = true;
       options.mmapArenaCapacityRatio = 1;
+      options.useHugePages = FLAGS_use_huge_pages;
 
       auto allocator = std::make_shared<memory::MmapAllocator>(options);
       allocator_ = std::make_shared<cache::AsyncDataCache>(
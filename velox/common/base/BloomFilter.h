@@ -22,6 +22,7 @@
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/IOUtils.h"
+#include "velox/common/base/SimdUtil.h"
 
 namespace facebook::velox {
 // BloomFilter filter with groups of 64 bits, of which 4 are set. The hash
@@ -61,6 +62,42 @@ class BloomFilter {
     return test(bits_.data(), bits_.size(), value);
   }
 
+  // Tests a batch of hashed values. The words of the values are loaded with
+  // one gather so that their cache misses overlap.
+  xsimd::batch_bool<int64_t> mayContain(xsimd::batch<int64_t> values) const {
+    using Batch = xsimd::batch<uint64_t>;
+    const auto hashes = xsimd::bitwise_cast<uint64_t>(values);
+    const auto one = Batch::broadcast(1);
+    const auto fieldMask = Batch::broadcast(63);
+    const auto mask = xsimd::bitwise_cast<int64_t>(
+        (one << (hashes & fieldMask)) | (one << ((hashes >> 6) & fieldMask)) |
+        (one << ((hashes >> 12) & fieldMask)) |
+        (one << ((hashes >> 18) & fieldMask)));
+    const auto index = xsimd::bitwise_cast<int64_t>(
+        (hashes >> 24) & Batch::broadcast(bits_.size() - 1));
+    const auto words =
+        simd::gather(reinterpret_cast<const int64_t*>(bits_.data()), index);
+    return (words & mask) == mask;
+  }
+
+  // Tests 'numValues' hashed values and sets the bit of each in 'result' if
+  // it may be contained.
+  void mayContain(const uint64_t* values, int32_t numValues, uint64_t* result)
+      const {
+    constexpr int32_t kBatchSize = xsimd::batch<int64_t>::size;
+    int32_t i = 0;
+    for (; i + kBatchSize <= numValues; i += kBatchSize) {
+      const auto contained = simd::toBitMask(mayContain(
+          xsimd::load_unaligned(reinterpret_cast<const int64_t*>(values + i))));
+      for (auto j = 0; j < kBatchSize; ++j) {
+        bits::setBit(result, i + j, contained & (1 << j));
+      }
+    }
+    for (; i < numValues; ++i) {
+      bits::setBit(result, i, mayContain(values[i]));
+    }
+  }
+
   void merge(const char* serialized) {
     common::InputByteStream stream(serialized);
     auto version = stream.read<int8_t>();
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
 #include <vector>
 namespace facebook::velox {
 // Utility for combining IOs to nearby location into fewer coalesced
@@ -46,7 +47,9 @@ static constexpr int32_t kNoCoalesce = -1;
 // that correspond to an Element, skipRange adds a gap between
 // neighboring items, ioFunc takes the items, the first item to
 // process, the first item not to process, the offset of the first
-// item and a vector of Ranges.
+// item and a vector of Ranges. An IO spans at most 'maxIoBytes' from the start
+// of its first item to the end of its last item unless a single item is
+// larger.
 template <
     typename Item,
     typename Range,
@@ -65,7 +68,8 @@ CoalesceIoStats coalesceIo(
     ItemNumRanges numRanges,
     AddRanges addRanges,
     SkipRange skipRange,
-    IoFunc ioFunc) {
+    IoFunc ioFunc,
+    int64_t maxIoBytes = std::numeric_limits<int64_t>::max()) {
   std::vector<Range> buffers;
   auto start = offsetFunc(0);
   auto lastOffset = start;
@@ -79,7 +83,8 @@ CoalesceIoStats coalesceIo(
     result.payloadBytes += size;
     int32_t rangesForItem = numRanges(i);
     bool enoughRanges = (rangesForItem == kNoCoalesce ||
-                         ranges.size() + rangesForItem >= rangesPerIo) &&
+                         ranges.size() + rangesForItem >= rangesPerIo ||
+                         startOffset + size - start > maxIoBytes) &&
         !ranges.empty();
     if (lastOffset != startOffset || enoughRanges) {
       int64_t gap = startOffset - lastOffset;
@@ -15,6 +15,11 @@
  */
 
 #include "velox/common/base/Counters.h"
+
+#include <fmt/format.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Set.h>
+
 #include "velox/common/base/StatsReporter.h"
 
 namespace facebook::velox {
@@ -24,6 +29,33 @@ void registerVeloxCounters() {
   // P50, P90, P99, and P100.
   REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
       kCounterHiveFileHandleGenerateLatencyMs, 10, 0, 100000, 50, 90, 99, 100);
+
+  // Track exchange request latency in range of [0, 100s] and reports P50, P90,
+  // P99, and P100.
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+      kCounterExchangeRequestLatencyMs, 10, 0, 100000, 50, 90, 99, 100);
+
+  // Track the latency of reading a batch in table scan in range of [0, 10s]
+  // and reports P50, P90, P99, and P100.
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+      kCounterTableScanBatchLatencyMs, 1, 0, 10000, 50, 90, 99, 100);
+
+  // Track spill file size in range of [0, 10GB] and reports P50, P90, P99, and
+  // P100.
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+      kCounterSpillFileSizeMb, 10, 0, 10000, 50, 90, 99, 100);
+}
+
+std::string priorityCounterKey(folly::StringPiece counter, int32_t priority) {
+  static folly::Synchronized<folly::F14FastSet<std::string>> registeredKeys;
+  auto key = fmt::format("{}.priority_{}", counter, priority);
+  if (registeredKeys.rlock()->count(key) > 0) {
+    return key;
+  }
+  if (registeredKeys.wlock()->insert(key).second) {
+    REPORT_ADD_STAT_EXPORT_TYPE(key, StatType::AVG);
+  }
+  return key;
 }
 
 } // namespace facebook::velox
@@ -18,11 +18,42 @@
 
 #include <folly/Range.h>
 
+#include <string>
+
 namespace facebook::velox {
 
 // Velox Counter Registration
 void registerVeloxCounters();
 
+/// Returns the key of 'counter' for the queries of 'priority', e.g.
+/// 'velox.driver_queue_time_us.priority_1'. Registers the key as an average
+/// stat on first use, since the priorities are not known upfront.
+std::string priorityCounterKey(folly::StringPiece counter, int32_t priority);
+
 constexpr folly::StringPiece kCounterHiveFileHandleGenerateLatencyMs{
     "velox.hive_file_handle_generate_latency_ms"};
+
+constexpr folly::StringPiece kCounterExchangeRequestLatencyMs{
+    "velox.exchange_request_latency_ms"};
+
+constexpr folly::StringPiece kCounterTableScanBatchLatencyMs{
+    "velox.table_scan_batch_latency_ms"};
+
+constexpr folly::StringPiece kCounterSpillFileSizeMb{
+    "velox.spill_file_size_mb"};
+
+/// The time a driver waits in the executor queue before running, reported per
+/// query priority through priorityCounterKey().
+constexpr folly::StringPiece kCounterDriverQueueTimeUs{
+    "velox.driver_queue_time_us"};
+
+/// The time a memory arbitration request waits for the running one, reported
+/// per query priority through priorityCounterKey().
+constexpr folly::StringPiece kCounterMemoryArbitrationQueueTimeUs{
+    "velox.memory_arbitration_queue_time_us"};
+
+/// The memory usage of the queries at each memory arbitration request,
+/// reported per query priority through priorityCounterKey().
+constexpr folly::StringPiece kCounterQueryMemoryBytes{
+    "velox.query_memory_bytes"};
 } // namespace facebook::velox
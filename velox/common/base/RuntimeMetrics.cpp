@@ -16,22 +16,54 @@
 
 #include <folly/ThreadLocal.h>
 
+#include <cmath>
+
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/base/SuccinctPrinter.h"
 
 namespace facebook::velox {
 
+int64_t RuntimeHistogram::percentile(double percentile) const {
+  int64_t total = 0;
+  for (auto count : counts) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  // The rank of the value at 'percentile', 1 based.
+  const auto rank = std::max<int64_t>(1, std::ceil(total * percentile / 100));
+  int64_t numValues = 0;
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    numValues += counts[i];
+    if (numValues >= rank) {
+      if (i == 0) {
+        return 0;
+      }
+      if (i == kNumBuckets - 1) {
+        return std::numeric_limits<int64_t>::max();
+      }
+      return (int64_t{1} << i) - 1;
+    }
+  }
+  VELOX_UNREACHABLE();
+}
+
 void RuntimeMetric::addValue(int64_t value) {
   sum += value;
   count++;
   min = std::min(min, value);
   max = std::max(max, value);
+  if (histogram.has_value()) {
+    histogram->addValue(value);
+  }
 }
 
 void RuntimeMetric::aggregate() {
   count = std::min(count, static_cast<int64_t>(1));
   min = max = sum;
+  histogram.reset();
 }
 
 void RuntimeMetric::merge(const RuntimeMetric& other) {
@@ -40,6 +72,18 @@ void RuntimeMetric::merge(const RuntimeMetric& other) {
   count += other.count;
   min = std::min(min, other.min);
   max = std::max(max, other.max);
+  if (other.histogram.has_value()) {
+    enableHistogram();
+    histogram->merge(*other.histogram);
+  }
+}
+
+int64_t RuntimeMetric::percentile(double percentile) const {
+  VELOX_CHECK(histogram.has_value());
+  if (count == 0) {
+    return 0;
+  }
+  return std::clamp(histogram->percentile(percentile), min, max);
 }
 
 void RuntimeMetric::printMetric(std::stringstream& stream) const {
@@ -59,6 +103,24 @@ void RuntimeMetric::printMetric(std::stringstream& stream) const {
       stream << " sum: " << sum << ", count: " << count << ", min: " << min
              << ", max: " << max;
   }
+  if (!histogram.has_value()) {
+    return;
+  }
+  for (auto p : {50, 90, 99}) {
+    const auto value = percentile(p);
+    stream << ", p" << p << ": ";
+    switch (unit) {
+      case RuntimeCounter::Unit::kNanos:
+        stream << succinctNanos(value);
+        break;
+      case RuntimeCounter::Unit::kBytes:
+        stream << succinctBytes(value);
+        break;
+      case RuntimeCounter::Unit::kNone:
+      default:
+        stream << value;
+    }
+  }
 }
 
 // Thread local runtime stat writers.
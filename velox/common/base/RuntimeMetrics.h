@@ -18,7 +18,9 @@
 
 #include <fmt/format.h>
 #include <folly/CppAttributes.h>
+#include <array>
 #include <limits>
+#include <optional>
 #include <sstream>
 
 namespace facebook::velox {
@@ -27,9 +29,41 @@ struct RuntimeCounter {
   enum class Unit { kNone, kNanos, kBytes };
   int64_t value;
   Unit unit{Unit::kNone};
+  // If true, the metric this is added to keeps a histogram of the values.
+  bool histogram{false};
+
+  explicit RuntimeCounter(
+      int64_t _value,
+      Unit _unit = Unit::kNone,
+      bool _histogram = false)
+      : value(_value), unit(_unit), histogram(_histogram) {}
+};
+
+/// Counts values in fixed power of two buckets. Bucket 0 counts the values
+/// <= 0 and bucket i > 0 the values in [2^(i-1), 2^i). Adding a value is a
+/// single increment, so it is cheap enough for the hot paths of the operators.
+struct RuntimeHistogram {
+  static constexpr int32_t kNumBuckets = 64;
+
+  std::array<int64_t, kNumBuckets> counts{};
+
+  void addValue(int64_t value) {
+    ++counts[bucket(value)];
+  }
+
+  void merge(const RuntimeHistogram& other) {
+    for (auto i = 0; i < kNumBuckets; ++i) {
+      counts[i] += other.counts[i];
+    }
+  }
+
+  /// Returns the upper bound of the bucket that contains the value at
+  /// 'percentile', e.g. 99 for p99. Returns 0 if there are no values.
+  int64_t percentile(double percentile) const;
 
-  explicit RuntimeCounter(int64_t _value, Unit _unit = Unit::kNone)
-      : value(_value), unit(_unit) {}
+  static int32_t bucket(int64_t value) {
+    return value <= 0 ? 0 : 64 - __builtin_clzll(value);
+  }
 };
 
 struct RuntimeMetric {
@@ -39,6 +73,8 @@ struct RuntimeMetric {
   int64_t count{0};
   int64_t min{std::numeric_limits<int64_t>::max()};
   int64_t max{std::numeric_limits<int64_t>::min()};
+  // The distribution of the values if enabled by enableHistogram().
+  std::optional<RuntimeHistogram> histogram;
 
   explicit RuntimeMetric(
       RuntimeCounter::Unit _unit = RuntimeCounter::Unit::kNone)
@@ -51,8 +87,15 @@ struct RuntimeMetric {
 
   void addValue(int64_t value);
 
+  /// Starts keeping a histogram of the values added after this call.
+  void enableHistogram() {
+    if (!histogram.has_value()) {
+      histogram.emplace();
+    }
+  }
+
   /// Aggregate sets 'min' and 'max' to 'sum', also sets 'count' to 1 if
-  /// positive.
+  /// positive. Drops the histogram.
   void aggregate();
 
   void printMetric(std::stringstream& stream) const;
@@ -60,9 +103,24 @@ struct RuntimeMetric {
   void merge(const RuntimeMetric& other);
 
   std::string toString() const {
+    if (histogram.has_value()) {
+      return fmt::format(
+          "sum:{}, count:{}, min:{}, max:{}, p50:{}, p90:{}, p99:{}",
+          sum,
+          count,
+          min,
+          max,
+          percentile(50),
+          percentile(90),
+          percentile(99));
+    }
     return fmt::format(
         "sum:{}, count:{}, min:{}, max:{}", sum, count, min, max);
   }
+
+  /// Returns the value at 'percentile' estimated from the histogram, limited
+  /// to [min, max]. Requires the histogram.
+  int64_t percentile(double percentile) const;
 };
 
 /// Simple interface to implement writing of runtime stats to Velox Operator
@@ -107,6 +107,16 @@ struct BitMask<T, A, 2> {
   }
 #endif
 
+#if XSIMD_WITH_NEON64
+  static int toBitMask(xsimd::batch_bool<T, A> mask, const xsimd::neon64&) {
+    // Moves the high bit of each lane to its position in the result and
+    // adds up the lanes.
+    alignas(A::alignment()) static const int16_t kShift[] = {
+        0, 1, 2, 3, 4, 5, 6, 7};
+    return vaddvq_u16(vshlq_u16(vshrq_n_u16(mask, 15), vld1q_s16(kShift)));
+  }
+#endif
+
   static int toBitMask(xsimd::batch_bool<T, A> mask, const xsimd::generic&) {
     return genericToBitMask(mask);
   }
@@ -128,6 +138,13 @@ struct BitMask<T, A, 4> {
   }
 #endif
 
+#if XSIMD_WITH_NEON64
+  static int toBitMask(xsimd::batch_bool<T, A> mask, const xsimd::neon64&) {
+    alignas(A::alignment()) static const int32_t kShift[] = {0, 1, 2, 3};
+    return vaddvq_u32(vshlq_u32(vshrq_n_u32(mask, 31), vld1q_s32(kShift)));
+  }
+#endif
+
   static int toBitMask(xsimd::batch_bool<T, A> mask, const xsimd::generic&) {
     return genericToBitMask(mask);
   }
@@ -154,6 +171,13 @@ struct BitMask<T, A, 8> {
   }
 #endif
 
+#if XSIMD_WITH_NEON64
+  static int toBitMask(xsimd::batch_bool<T, A> mask, const xsimd::neon64&) {
+    uint64x2_t highBits = vshrq_n_u64(mask, 63);
+    return vgetq_lane_u64(highBits, 0) | (vgetq_lane_u64(highBits, 1) << 1);
+  }
+#endif
+
   static int toBitMask(xsimd::batch_bool<T, A> mask, const xsimd::generic&) {
     return genericToBitMask(mask);
   }
@@ -768,6 +792,20 @@ struct Permute<T, A, 4> {
   }
 #endif
 
+#if XSIMD_WITH_NEON64
+  static xsimd::batch<T, A> apply(
+      xsimd::batch<T, A> data,
+      xsimd::batch<int32_t, A> idx,
+      const xsimd::neon64&) {
+    // Turns each lane index i into the byte indices {4i, 4i + 1, 4i + 2, 4i +
+    // 3} for a byte table lookup.
+    auto byteIdx = vreinterpretq_u8_s32(
+        vmlaq_n_s32(vdupq_n_s32(0x03020100), idx, 0x04040404));
+    return reinterpret_cast<typename xsimd::batch<T, A>::register_type>(
+        vqtbl1q_u8(reinterpret_cast<uint8x16_t>(data.data), byteIdx));
+  }
+#endif
+
 #if XSIMD_WITH_AVX
   static HalfBatch<T, A>
   apply(HalfBatch<T, A> data, HalfBatch<int32_t, A> idx, const xsimd::avx&) {
@@ -978,6 +1016,21 @@ struct Filter<T, A, 2> {
     return ans;
   }
 #endif
+
+#if XSIMD_WITH_NEON64
+  static xsimd::batch<T, A>
+  apply(xsimd::batch<T, A> data, int mask, const xsimd::neon64&) {
+    // Narrows the lane indices to 16 bits and turns each lane index i into
+    // the byte indices {2i, 2i + 1} for a byte table lookup.
+    const int32_t* indices = byteSetBits[mask];
+    auto idx = vreinterpretq_u16_s16(vcombine_s16(
+        vmovn_s32(vld1q_s32(indices)), vmovn_s32(vld1q_s32(indices + 4))));
+    auto byteIdx =
+        vreinterpretq_u8_u16(vmlaq_n_u16(vdupq_n_u16(0x0100), idx, 0x0202));
+    return reinterpret_cast<typename xsimd::batch<T, A>::register_type>(
+        vqtbl1q_u8(reinterpret_cast<uint8x16_t>(data.data), byteIdx));
+  }
+#endif
 };
 
 template <typename T, typename A>
@@ -1011,6 +1064,18 @@ struct Filter<T, A, 8> {
             reinterpret_cast<__m256i>(data.data), vindex));
   }
 #endif
+
+#if XSIMD_WITH_NEON64
+  static xsimd::batch<T, A>
+  apply(xsimd::batch<T, A> data, int mask, const xsimd::neon64&) {
+    // With 2 lanes only mask 2 moves a lane, the high one to the low one.
+    if (mask != 2) {
+      return data;
+    }
+    return reinterpret_cast<typename xsimd::batch<T, A>::register_type>(
+        vdupq_laneq_u64(reinterpret_cast<uint64x2_t>(data.data), 1));
+  }
+#endif
 };
 
 template <typename A>
@@ -1253,4 +1318,47 @@ xsimd::batch<T, A> reinterpretBatch(xsimd::batch<U, A> data, const A& arch) {
   return detail::ReinterpretBatch<T, U, A>::apply(data, arch);
 }
 
+template <typename A>
+size_t findSubstring(
+    const char* text,
+    size_t textSize,
+    const char* needle,
+    size_t needleSize,
+    const A& arch) {
+  if (needleSize == 0) {
+    return 0;
+  }
+  if (textSize < needleSize) {
+    return std::string_view::npos;
+  }
+  using Batch = xsimd::batch<uint8_t, A>;
+  const auto first = Batch::broadcast(needle[0]);
+  const auto last = Batch::broadcast(needle[needleSize - 1]);
+  // The bytes between the first and the last are compared with memcmp.
+  const auto middleSize = needleSize < 2 ? 0 : needleSize - 2;
+  size_t i = 0;
+  for (; i + needleSize - 1 + Batch::size <= textSize; i += Batch::size) {
+    auto firstBlock =
+        Batch::load_unaligned(reinterpret_cast<const uint8_t*>(text + i));
+    auto lastBlock = Batch::load_unaligned(
+        reinterpret_cast<const uint8_t*>(text + i + needleSize - 1));
+    uint32_t mask =
+        toBitMask((firstBlock == first) & (lastBlock == last), arch);
+    while (mask) {
+      const auto offset = i + __builtin_ctz(mask);
+      if (std::memcmp(text + offset + 1, needle + 1, middleSize) == 0) {
+        return offset;
+      }
+      mask &= mask - 1;
+    }
+  }
+  for (; i + needleSize <= textSize; ++i) {
+    if (text[i] == needle[0] &&
+        std::memcmp(text + i + 1, needle + 1, needleSize - 1) == 0) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
 } // namespace facebook::velox::simd
@@ -17,6 +17,8 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <string_view>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
 
@@ -414,6 +416,19 @@ inline bool isDense(const T* values, int32_t size) {
 template <typename T, typename U, typename A = xsimd::default_arch>
 xsimd::batch<T, A> reinterpretBatch(xsimd::batch<U, A>, const A& = {});
 
+// Returns the offset of the first occurrence of 'needle' of 'needleSize'
+// bytes in 'text' of 'textSize' bytes, or std::string_view::npos if there is
+// none. Compares the first and the last byte of 'needle' with a batch of
+// consecutive positions of 'text' at a time and checks the rest of 'needle'
+// only at the positions where both match.
+template <typename A = xsimd::default_arch>
+size_t findSubstring(
+    const char* text,
+    size_t textSize,
+    const char* needle,
+    size_t needleSize,
+    const A& = {});
+
 } // namespace facebook::velox::simd
 
 #include "velox/common/base/SimdUtil-inl.h"
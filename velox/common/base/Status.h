@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "velox/common/base/VeloxException.h"
+
+namespace facebook::velox {
+
+/// The outcome of an operation that reports errors without throwing. Simple
+/// functions return a Status from call() to report per-row errors cheaply,
+/// e.g. for TRY over data where many rows fail. An OK Status is a null
+/// pointer, so returning one does not allocate.
+class Status {
+ public:
+  Status() = default;
+
+  static Status OK() {
+    return Status();
+  }
+
+  /// A user error with 'message' and 'errorCode', e.g.
+  /// error_code::kArithmeticError. The error is reported as a VeloxUserError
+  /// with the same message and code.
+  static Status UserError(
+      std::string message,
+      const char* errorCode = error_code::kInvalidArgument.c_str()) {
+    return Status(
+        std::make_unique<State>(State{std::move(message), errorCode}));
+  }
+
+  bool ok() const {
+    return state_ == nullptr;
+  }
+
+  /// The message of an error. Must not be called on an OK Status.
+  const std::string& message() const {
+    return state_->message;
+  }
+
+  /// The error code of an error. Must not be called on an OK Status.
+  const char* errorCode() const {
+    return state_->errorCode;
+  }
+
+ private:
+  struct State {
+    std::string message;
+    const char* errorCode;
+  };
+
+  explicit Status(std::unique_ptr<State> state) : state_(std::move(state)) {}
+
+  std::unique_ptr<State> state_;
+};
+
+} // namespace facebook::velox
@@ -15,11 +15,13 @@
  */
 
 #include <folly/Benchmark.h>
+#include <folly/Random.h>
 #include <folly/init/Init.h>
 
 #include <optional>
 
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SimdUtil.h"
 DECLARE_bool(bmi2); // NOLINT
 
 namespace facebook {
@@ -186,12 +188,99 @@ BENCHMARK_RELATIVE_MULTI(forEachBitFirstBitFalse) {
   return kNumRuns;
 }
 
+// Compares the architecture specific simd::filter with the permute through
+// memory that is used when there is no specific implementation.
+template <typename T>
+void runFilter(uint32_t n, bool isGeneric) {
+  constexpr int kLanes = xsimd::batch<T>::size;
+  std::vector<T> data;
+  std::vector<int> masks;
+  std::vector<T> result;
+  BENCHMARK_SUSPEND {
+    data.resize(1024);
+    std::iota(data.begin(), data.end(), 0);
+    folly::Random::DefaultGenerator rng(1);
+    for (auto i = 0; i < data.size() / kLanes; ++i) {
+      masks.push_back(folly::Random::rand32(rng) & bits::lowMask(kLanes));
+    }
+    result.resize(data.size() + kLanes);
+  }
+  for (auto i = 0; i < n; ++i) {
+    auto out = result.data();
+    for (auto j = 0; j < masks.size(); ++j) {
+      auto batch = xsimd::load_unaligned(data.data() + j * kLanes);
+      auto selected = isGeneric
+          ? simd::detail::genericPermute(batch, simd::byteSetBits(masks[j]))
+          : simd::filter(batch, masks[j]);
+      selected.store_unaligned(out);
+      out += __builtin_popcount(masks[j]);
+    }
+    folly::doNotOptimizeAway(out);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(filter32Generic, n) {
+  runFilter<int32_t>(n, true);
+}
+
+BENCHMARK_RELATIVE(filter32, n) {
+  runFilter<int32_t>(n, false);
+}
+
+BENCHMARK(filter64Generic, n) {
+  runFilter<int64_t>(n, true);
+}
+
+BENCHMARK_RELATIVE(filter64, n) {
+  runFilter<int64_t>(n, false);
+}
+
+void runIndicesOfSetBits(uint32_t n, bool isSimple) {
+  std::vector<uint64_t> bits;
+  std::vector<int32_t> indices;
+  BENCHMARK_SUSPEND {
+    // Set about half of the bits.
+    folly::Random::DefaultGenerator rng(1);
+    for (auto i = 0; i < 1000; ++i) {
+      bits.push_back(folly::Random::rand64(rng));
+    }
+    indices.resize(bits.size() * 64);
+  }
+  for (auto i = 0; i < n; ++i) {
+    if (isSimple) {
+      auto result = indices.data();
+      bits::forEachSetBit(bits.data(), 0, bits.size() * 64, [&](auto row) {
+        *result++ = row;
+      });
+      folly::doNotOptimizeAway(result);
+    } else {
+      folly::doNotOptimizeAway(simd::indicesOfSetBits(
+          bits.data(), 0, bits.size() * 64, indices.data()));
+    }
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(indicesOfSetBitsSimple, n) {
+  runIndicesOfSetBits(n, true);
+}
+
+BENCHMARK_RELATIVE(indicesOfSetBits, n) {
+  runIndicesOfSetBits(n, false);
+}
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
 
 int main(int argc, char** argv) {
   folly::init(&argc, &argv);
+  // The SIMD benchmarks are compared across x86 and ARM, so tell which one
+  // this is.
+  LOG(INFO) << "Architecture: " << xsimd::default_arch::name();
   folly::runBenchmarks();
   return 0;
 }
@@ -90,3 +90,27 @@ TEST_F(BloomFilterTest, merge) {
 
   EXPECT_EQ(bloom.serializedSize(), merge.serializedSize());
 }
+
+TEST_F(BloomFilterTest, batch) {
+  constexpr int32_t kSize = 1000;
+  BloomFilter bloom;
+  bloom.reset(kSize);
+  for (auto i = 0; i < kSize; ++i) {
+    bloom.insert(folly::hasher<int64_t>()(i));
+  }
+
+  // Probes the inserted values and as many others, with a tail that is not a
+  // full batch.
+  constexpr int32_t kNumValues = 2 * kSize + 3;
+  std::vector<uint64_t> values(kNumValues);
+  for (auto i = 0; i < kNumValues; ++i) {
+    values[i] = folly::hasher<int64_t>()(i);
+  }
+  std::vector<uint64_t> result(bits::nwords(kNumValues));
+  bloom.mayContain(values.data(), kNumValues, result.data());
+  for (auto i = 0; i < kNumValues; ++i) {
+    EXPECT_EQ(bloom.mayContain(values[i]), bits::isBitSet(result.data(), i))
+        << i;
+  }
+  EXPECT_EQ(kSize, bits::countBits(result.data(), 0, kSize));
+}
@@ -113,3 +113,39 @@ TEST(CoalesceIoTest, basic) {
   EXPECT_EQ(1, ioGroups[2].size());
   EXPECT_EQ(1, ioGroups[3].size());
 }
+
+TEST(CoalesceIoTest, maxIoBytes) {
+  // Ten adjacent 1MB units. With a limit of 3MB per IO, the units go in IOs
+  // of 3, 3, 3 and 1.
+  std::vector<IoUnit> data;
+  for (auto i = 0; i < 10; ++i) {
+    data.emplace_back(i << 20, 1 << 20, 1);
+  }
+  std::vector<int32_t> ioSizes;
+  auto stats = coalesceIo<IoUnit, Range>(
+      data,
+      1000,
+      100,
+      [&](int32_t index) { return data[index].offset; },
+      [&](int32_t index) { return data[index].size; },
+      [&](int32_t index) { return data[index].numBuffers; },
+      [&](const IoUnit& item, std::vector<Range>& ranges) {
+        ranges.emplace_back(item.size, item.numBuffers);
+      },
+      [&](int32_t skip, std::vector<Range>& ranges) {
+        ranges.emplace_back(skip, 0);
+      },
+      [&](const std::vector<IoUnit>& /*items*/,
+          int32_t begin,
+          int32_t end,
+          uint64_t /*offset*/,
+          const std::vector<Range>& /*ranges*/) {
+        ioSizes.push_back(end - begin);
+      },
+      3 << 20);
+  EXPECT_EQ(4, stats.numIos);
+  EXPECT_EQ(10 << 20, stats.payloadBytes);
+  EXPECT_EQ(0, stats.extraBytes);
+  std::vector<int32_t> expectedSizes{3, 3, 3, 1};
+  EXPECT_EQ(expectedSizes, ioSizes);
+}
@@ -73,4 +73,47 @@ TEST_F(RuntimeMetricsTest, basic) {
   testMetric(rm3, 0, 0, 0, 0);
 };
 
+TEST_F(RuntimeMetricsTest, histogram) {
+  EXPECT_EQ(RuntimeHistogram::bucket(-1), 0);
+  EXPECT_EQ(RuntimeHistogram::bucket(0), 0);
+  EXPECT_EQ(RuntimeHistogram::bucket(1), 1);
+  EXPECT_EQ(RuntimeHistogram::bucket(2), 2);
+  EXPECT_EQ(RuntimeHistogram::bucket(3), 2);
+  EXPECT_EQ(RuntimeHistogram::bucket(1'000), 10);
+  EXPECT_EQ(
+      RuntimeHistogram::bucket(std::numeric_limits<int64_t>::max()),
+      RuntimeHistogram::kNumBuckets - 1);
+
+  RuntimeMetric rm1(RuntimeCounter::Unit::kNanos);
+  rm1.enableHistogram();
+  EXPECT_EQ(rm1.percentile(50), 0);
+  // 98 fast values and 2 slow ones.
+  for (auto i = 0; i < 98; ++i) {
+    rm1.addValue(100 + i);
+  }
+  rm1.addValue(1'000'000);
+  rm1.addValue(2'000'000);
+  testMetric(rm1, 3'000'000 + 98 * 100 + 97 * 49, 100, 100, 2'000'000);
+  // The percentiles are the upper bounds of the power of two buckets.
+  EXPECT_EQ(rm1.percentile(10), 127);
+  EXPECT_EQ(rm1.percentile(50), 255);
+  EXPECT_EQ(rm1.percentile(90), 255);
+  EXPECT_EQ(rm1.percentile(99), 1'048'575);
+  EXPECT_EQ(rm1.percentile(100), 2'000'000);
+  EXPECT_EQ(
+      "sum:3014553, count:100, min:100, max:2000000, p50:255, p90:255, "
+      "p99:1048575",
+      rm1.toString());
+
+  // Merging into a metric without a histogram adds the histogram.
+  RuntimeMetric rm2(RuntimeCounter::Unit::kNanos);
+  rm2.addValue(5);
+  rm2.merge(rm1);
+  ASSERT_TRUE(rm2.histogram.has_value());
+  EXPECT_EQ(rm2.percentile(99), 1'048'575);
+
+  rm2.aggregate();
+  EXPECT_FALSE(rm2.histogram.has_value());
+}
+
 } // namespace facebook::velox
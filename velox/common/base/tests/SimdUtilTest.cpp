@@ -264,6 +264,41 @@ TEST_F(SimdUtilTest, filterDouble) {
   testFilter<double>({std::nan("nan"), 23456, 111, 32000});
 }
 
+namespace {
+
+// Checks 'toBitMask' and 'filter' with every mask of the lanes of a batch of T.
+template <typename T>
+void testAllMasks() {
+  constexpr int N = xsimd::batch<T>::size;
+  T data[N];
+  std::iota(data, data + N, 1);
+  auto batch = xsimd::load_unaligned(data);
+  for (int mask = 0; mask < (1 << N); ++mask) {
+    T selected[N];
+    for (int i = 0; i < N; ++i) {
+      selected[i] = (mask & (1 << i)) ? data[i] : 0;
+    }
+    auto selectedBatch = xsimd::load_unaligned(selected);
+    ASSERT_EQ(simd::toBitMask(selectedBatch != T(0)), mask);
+    auto result = simd::filter(batch, mask);
+    for (int i = 0, j = 0; i < N; ++i) {
+      if (mask & (1 << i)) {
+        ASSERT_EQ(result.get(j++), data[i]) << "mask " << mask;
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST_F(SimdUtilTest, allMasks) {
+  testAllMasks<int16_t>();
+  testAllMasks<int32_t>();
+  testAllMasks<int64_t>();
+  testAllMasks<float>();
+  testAllMasks<double>();
+}
+
 TEST_F(SimdUtilTest, misc) {
   // Widen to int64 from 4 uints
   uint32_t uints4[4] = {10000, 0, 0, 4000000000};
@@ -376,4 +411,36 @@ TEST_F(SimdUtilTest, reinterpretBatch) {
   validateReinterpretBatch<int64_t>();
 }
 
+TEST_F(SimdUtilTest, findSubstring) {
+  // Random text over a small alphabet so that there are many partial
+  // matches. The needles are taken from the text or are random.
+  std::string text;
+  for (auto i = 0; i < 1'000; ++i) {
+    text.push_back('a' + folly::Random::rand32(rng_) % 3);
+  }
+  for (auto i = 0; i < 1'000; ++i) {
+    // Starts at varying offsets to cover unaligned loads.
+    auto start = folly::Random::rand32(rng_) % 64;
+    auto size = folly::Random::rand32(rng_) % 100;
+    std::string_view haystack(text.data() + start, size);
+    auto needleSize = folly::Random::rand32(rng_) % 20;
+    std::string needle;
+    if (i % 2 == 0 && needleSize <= size) {
+      auto offset = folly::Random::rand32(rng_) % (size - needleSize + 1);
+      needle = haystack.substr(offset, needleSize);
+    } else {
+      for (auto j = 0; j < needleSize; ++j) {
+        needle.push_back('a' + folly::Random::rand32(rng_) % 3);
+      }
+    }
+    EXPECT_EQ(
+        haystack.find(needle),
+        simd::findSubstring(
+            haystack.data(), haystack.size(), needle.data(), needle.size()))
+        << "text: " << haystack << ", needle: " << needle;
+  }
+  EXPECT_EQ(std::string_view::npos, simd::findSubstring("abc", 3, "abcd", 4));
+  EXPECT_EQ(0, simd::findSubstring("", 0, "", 0));
+}
+
 } // namespace
@@ -22,6 +22,13 @@
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include "velox/common/caching/FileIds.h"
 
+#include <thread>
+
+DEFINE_string(
+    cache_eviction_policy,
+    "clock",
+    "Eviction policy of the AsyncDataCache RAM tier: 'clock' or 'tinylfu'");
+
 namespace facebook::velox::cache {
 
 using memory::MachinePageCount;
@@ -56,7 +63,8 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
     hook(*this);
   }
 
-  if (!ssdFile_ && shard_->cache()->ssdCache()) {
+  if (!ssdFile_ && admission_ != CacheAdmission::kNone &&
+      shard_->cache()->ssdCache()) {
     auto ssdCache = shard_->cache()->ssdCache();
     assert(ssdCache); // for lint only.
     if (ssdCache->groupStats().shouldSaveToSsd(groupId_, trackingId_)) {
@@ -99,6 +107,7 @@ memory::MachinePageCount AsyncDataCacheEntry::setPrefetch(bool flag) {
 void AsyncDataCacheEntry::initialize(FileCacheKey key) {
   VELOX_CHECK(isExclusive());
   setSsdFile(nullptr, 0);
+  admission_ = CacheAdmission::kRam;
   key_ = std::move(key);
   auto cache = shard_->cache();
   ClockTimer t(shard_->allocClocks());
@@ -138,6 +147,29 @@ std::string AsyncDataCacheEntry::toString() const {
       numPins_);
 }
 
+CacheEvictionPolicy evictionPolicyFromName(const std::string& name) {
+  if (name == "clock") {
+    return CacheEvictionPolicy::kClock;
+  }
+  if (name == "tinylfu") {
+    return CacheEvictionPolicy::kTinyLfu;
+  }
+  VELOX_USER_FAIL("Unknown cache eviction policy: {}", name);
+}
+
+std::string evictionPolicyName(CacheEvictionPolicy policy) {
+  switch (policy) {
+    case CacheEvictionPolicy::kClock:
+      return "clock";
+    case CacheEvictionPolicy::kTinyLfu:
+      return "tinylfu";
+  }
+  VELOX_UNREACHABLE();
+}
+
+CacheShard::CacheShard(AsyncDataCache* cache)
+    : cache_(cache), sketch_(cache->makeSketch()) {}
+
 std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntryWithSize(
     uint64_t /*sizeHint*/) {
   std::unique_ptr<AsyncDataCacheEntry> newEntry;
@@ -154,6 +186,13 @@ CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
     folly::SemiFuture<bool>* wait) {
+  if (sketch_) {
+    sketch_->increment(std::hash<RawFileCacheKey>()(key));
+  }
+  auto resident = findResident(key, size);
+  if (!resident.empty()) {
+    return resident;
+  }
   AsyncDataCacheEntry* entryToInit = nullptr;
   {
     std::lock_guard<std::mutex> l(mutex_);
@@ -176,8 +215,7 @@ CachePin CacheShard::findOrCreate(
           found->isFirstUse_ = true;
           found->setPrefetch(false);
         } else {
-          ++numHit_;
-          hitBytes_ += found->size();
+          recordHit(found);
         }
         ++found->numPins_;
         CachePin pin;
@@ -197,8 +235,12 @@ CachePin CacheShard::findOrCreate(
     // Initialize the members that must be set inside 'mutex_'.
     newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
     newEntry->promise_ = nullptr;
+    newEntry->isProbation_ = isProbation(key);
+    if (newEntry->isProbation_) {
+      ++numProbationNew_;
+    }
     entryToInit = newEntry.get();
-    entryMap_[key] = newEntry.get();
+    entryMap_.insert_or_assign(key, newEntry.get());
     if (emptySlots_.empty()) {
       entries_.push_back(std::move(newEntry));
     } else {
@@ -215,10 +257,67 @@ CachePin CacheShard::findOrCreate(
   return initEntry(key, entryToInit);
 }
 
+CachePin CacheShard::findResident(RawFileCacheKey key, uint64_t size) {
+  AsyncDataCacheEntry* entry;
+  {
+    auto it = entryMap_.find(key);
+    if (it == entryMap_.cend()) {
+      return CachePin();
+    }
+    entry = it->second;
+  }
+  if (!entry->tryAddPin()) {
+    return CachePin();
+  }
+  CachePin pin;
+  pin.entry_ = entry;
+  // 'entry' may have been evicted and reused for another key between the
+  // lookup and the pin. The pin keeps 'entry' from being evicted, so 'entry'
+  // belongs to 'key' if 'key' still maps to it.
+  auto it = entryMap_.find(key);
+  if (it == entryMap_.cend() || it->second != entry || entry->isPrefetch_ ||
+      entry->size() < size) {
+    return CachePin();
+  }
+  entry->touch();
+  recordHit(entry);
+  return pin;
+}
+
+void CacheShard::recordHit(AsyncDataCacheEntry* entry) {
+  ++numHit_;
+  hitBytes_ += entry->size();
+  // A reuse shows that the entry is worth retaining.
+  entry->admission_ = CacheAdmission::kRam;
+  if (entry->isProbation_) {
+    entry->isProbation_ = false;
+    ++numPromoted_;
+  }
+}
+
+bool CacheShard::isProbation(RawFileCacheKey key) const {
+  if (!sketch_) {
+    return false;
+  }
+  // TinyLFU admits the new entry if it is accessed more often than the entry
+  // it would replace. The key has been counted for this access, so a count
+  // of 1 means that this is the first recent access.
+  const auto frequency = sketch_->estimate(std::hash<RawFileCacheKey>()(key));
+  return frequency <= std::max(1, victimFrequency_ / 8);
+}
+
+void CacheShard::recordVictim(const AsyncDataCacheEntry& entry) {
+  if (!sketch_ || entry.isProbation_) {
+    return;
+  }
+  const auto frequency = sketch_->estimate(std::hash<RawFileCacheKey>()(
+      RawFileCacheKey{entry.key_.fileNum.id(), entry.key_.offset}));
+  victimFrequency_ += frequency - victimFrequency_ / 8;
+}
+
 bool CacheShard::exists(RawFileCacheKey key) const {
-  std::lock_guard<std::mutex> l(mutex_);
   auto it = entryMap_.find(key);
-  if (it != entryMap_.end()) {
+  if (it != entryMap_.cend()) {
     it->second->touch();
     return true;
   }
@@ -308,10 +407,9 @@ std::unique_ptr<folly::SharedPromise<bool>> CacheShard::removeEntry(
 
 void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
   if (entry->key_.fileNum.hasValue()) {
-    auto removeIter = entryMap_.find(
+    auto numErased = entryMap_.erase(
         RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
-    VELOX_CHECK(removeIter != entryMap_.end());
-    entryMap_.erase(removeIter);
+    VELOX_CHECK_EQ(1, numErased);
     entry->key_.fileNum.clear();
     entry->setSsdFile(nullptr, 0);
     if (entry->isPrefetch()) {
@@ -377,6 +475,15 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
           ++evictSaveableSkipped;
           continue;
         }
+        // A hit outside of 'mutex_' may have pinned 'candidate' after the
+        // check above. The evicted entry stays exclusive until reused, so
+        // that such hits fail to pin it.
+        if (!candidate->trySetExclusive()) {
+          continue;
+        }
+        if (candidate->key_.fileNum.hasValue()) {
+          recordVictim(*candidate);
+        }
         largeFreed += candidate->data_.byteSize();
         toFree.push_back(std::move(candidate->data()));
         removeEntryLocked(candidate);
@@ -455,6 +562,9 @@ void CacheShard::updateStats(CacheStats& stats) {
       ++stats.numPrefetch;
       stats.prefetchBytes += entry->size();
     }
+    if (entry->isProbation_) {
+      ++stats.numProbation;
+    }
     ++stats.numEntries;
     stats.tinySize += entry->tinyData_.size();
     stats.tinyPadding += entry->tinyData_.capacity() - entry->tinyData_.size();
@@ -469,6 +579,8 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
   stats.allocClocks += allocClocks_;
+  stats.numProbationNew += numProbationNew_;
+  stats.numPromoted += numPromoted_;
 }
 
 void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
@@ -500,24 +612,44 @@ AsyncDataCache::AsyncDataCache(
     std::unique_ptr<SsdCache> ssdCache)
     : allocator_(allocator),
       ssdCache_(std::move(ssdCache)),
+      evictionPolicy_(evictionPolicyFromName(FLAGS_cache_eviction_policy)),
+      numShards_(defaultNumShards()),
+      shardMask_(numShards_ - 1),
       cachedPages_(0),
       maxBytes_(maxBytes) {
-  for (auto i = 0; i < kNumShards; ++i) {
+  for (auto i = 0; i < numShards_; ++i) {
     shards_.push_back(std::make_unique<CacheShard>(this));
   }
 }
 
+// static
+int32_t AsyncDataCache::defaultNumShards() {
+  const int32_t numCores = std::thread::hardware_concurrency();
+  return std::clamp<int32_t>(
+      bits::nextPowerOfTwo(std::max(1, numCores / kCoresPerShard)),
+      kMinShards,
+      kMaxShards);
+}
+
+std::unique_ptr<FrequencySketch> AsyncDataCache::makeSketch() const {
+  if (evictionPolicy_ != CacheEvictionPolicy::kTinyLfu) {
+    return nullptr;
+  }
+  return std::make_unique<FrequencySketch>(std::clamp<int64_t>(
+      maxBytes_ / numShards_ / kSketchBytesPerEntry,
+      kMinSketchWidth,
+      kMaxSketchWidth));
+}
+
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
     folly::SemiFuture<bool>* wait) {
-  int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+  return shard(key).findOrCreate(key, size, wait);
 }
 
 bool AsyncDataCache::exists(RawFileCacheKey key) const {
-  int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->exists(key);
+  return shard(key).exists(key);
 }
 
 bool AsyncDataCache::makeSpace(
@@ -535,7 +667,7 @@ bool AsyncDataCache::makeSpace(
   // serialize with a mutex because memory arbitration must not be
   // called from inside a global mutex.
 
-  constexpr int32_t kMaxAttempts = kNumShards * 4;
+  const int32_t maxAttempts = numShards_ * 4;
   // If requesting less than kSmallSizePages try up to 4x more if
   // first try failed.
   constexpr int32_t kSmallSizePages = 2048; // 8MB
@@ -553,7 +685,7 @@ bool AsyncDataCache::makeSpace(
     rank = ++numThreadsInAllocate_;
     isCounted = true;
   }
-  for (auto nthAttempt = 0; nthAttempt < kMaxAttempts; ++nthAttempt) {
+  for (auto nthAttempt = 0; nthAttempt < maxAttempts; ++nthAttempt) {
     if (allocator_->numAllocated() + numPages <
         maxBytes_ / memory::AllocationTraits::kPageSize) {
       try {
@@ -575,7 +707,7 @@ bool AsyncDataCache::makeSpace(
                 << "cach write to unpin memory";
       std::this_thread::sleep_for(std::chrono::milliseconds(500)); // NOLINT
     }
-    if (nthAttempt > kMaxAttempts / 2) {
+    if (nthAttempt > maxAttempts / 2) {
       if (!isCounted) {
         rank = ++numThreadsInAllocate_;
         isCounted = true;
@@ -588,9 +720,9 @@ bool AsyncDataCache::makeSpace(
     // Evict from next shard. If we have gone through all shards once
     // and still have not made the allocation, we go to desperate mode
     // with 'evictAllUnpinned' set to true.
-    shards_[shardCounter_ & (kShardMask)]->evict(
+    shards_[shardCounter_ & shardMask_]->evict(
         numPages * sizeMultiplier * memory::AllocationTraits::kPageSize,
-        nthAttempt >= kNumShards);
+        nthAttempt >= numShards_);
     if (numPages < kSmallSizePages && sizeMultiplier < 4) {
       sizeMultiplier *= 2;
     }
@@ -685,6 +817,7 @@ void AsyncDataCache::saveToSsd() {
 
 CacheStats AsyncDataCache::refreshStats() const {
   CacheStats stats;
+  stats.evictionPolicy = evictionPolicy_;
   for (auto& shard : shards_) {
     shard->updateStats(stats);
   }
@@ -708,7 +841,10 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
+      << stats.numEvict << " hit ratio " << stats.hitRatio() << "\n"
+      << " eviction policy " << evictionPolicyName(stats.evictionPolicy)
+      << " probation " << stats.numProbation << " probation new "
+      << stats.numProbationNew << " promoted " << stats.numPromoted << "\n"
       << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
@@ -731,7 +867,8 @@ CoalesceIoStats readPins(
         int32_t begin,
         int32_t end,
         uint64_t offset,
-        const std::vector<folly::Range<char*>>& buffers)> readFunc) {
+        const std::vector<folly::Range<char*>>& buffers)> readFunc,
+    int64_t maxIoBytes) {
   return coalesceIo<CachePin, folly::Range<char*>>(
       pins,
       maxGap,
@@ -767,7 +904,8 @@ CoalesceIoStats readPins(
         // without actually allocating a buffer for it.
         ranges.push_back(folly::Range<char*>(nullptr, (char*)(uint64_t)size));
       },
-      readFunc);
+      readFunc,
+      maxIoBytes);
 }
 
 } // namespace facebook::velox::cache
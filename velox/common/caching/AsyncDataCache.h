@@ -20,17 +20,22 @@
 
 #include <fmt/format.h>
 #include <folly/chrono/Hardware.h>
+#include <folly/concurrency/ConcurrentHashMap.h>
 #include <folly/futures/SharedPromise.h>
+#include <gflags/gflags.h>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CoalesceIo.h"
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/common/caching/FileGroupStats.h"
+#include "velox/common/caching/FrequencySketch.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/StringIdMap.h"
 #include "velox/common/file/File.h"
 #include "velox/common/memory/MemoryAllocator.h"
 
+DECLARE_string(cache_eviction_policy);
+
 namespace facebook::velox::cache {
 
 class AsyncDataCache;
@@ -54,8 +59,10 @@ inline AccessTime accessTime() {
 }
 
 struct AccessStats {
-  AccessTime lastUse{0};
-  int32_t numUses{0};
+  // Updated without synchronization on cache hits. Lost updates only affect
+  // the eviction order.
+  tsan_atomic<AccessTime> lastUse{0};
+  tsan_atomic<int32_t> numUses{0};
 
   // Retention score. A higher number means less worth retaining. This
   // works well with a typical formula of time over use count going to
@@ -135,7 +142,10 @@ namespace facebook::velox::cache {
 // time. The CacheShard serializes the mapping from a key to the
 // entry and the setting entries to exclusive mode. An unpinned
 // entry is evictable. CacheShard decides the eviction policy and
-// serializes eviction with other access.
+// serializes eviction with other access. A hit on an entry in shared
+// or unpinned state pins it without the shard mutex by incrementing
+// 'numPins_' with compare-and-swap, which fails if the entry is
+// exclusive, e.g. being evicted.
 class AsyncDataCacheEntry {
  public:
   static constexpr int32_t kExclusive = -10000;
@@ -181,7 +191,12 @@ class AsyncDataCacheEntry {
     accessStats_.touch();
   }
 
+  // Entries not admitted to RAM or on probation are evicted first until they
+  // are hit again.
   int32_t score(AccessTime now) const {
+    if (admission_ != CacheAdmission::kRam || isProbation_) {
+      return std::numeric_limits<int32_t>::max();
+    }
     return accessStats_.score(now, size_);
   }
 
@@ -205,6 +220,13 @@ class AsyncDataCacheEntry {
     return isPrefetch_;
   }
 
+  /// True if 'this' is in the probation segment of the TinyLFU eviction
+  /// policy, i.e. has not been hit since being loaded and was not frequent
+  /// enough to be protected when loaded. Always false for the clock policy.
+  bool isProbation() const {
+    return isProbation_;
+  }
+
   // Distinguishes between a reuse of a cached entry from first
   // retrieval of a prefetched entry. If this is false, we have an
   // actual reuse of cached data.
@@ -238,6 +260,16 @@ class AsyncDataCacheEntry {
     groupId_ = groupId;
   }
 
+  /// Sets where 'this' is retained after loading. Must be set before
+  /// setExclusiveToShared(). A hit after the first use admits 'this' to RAM.
+  void setAdmission(CacheAdmission admission) {
+    admission_ = admission;
+  }
+
+  CacheAdmission admission() const {
+    return admission_;
+  }
+
   /// Sets access stats so that this is immediately evictable.
   void makeEvictable();
 
@@ -254,6 +286,25 @@ class AsyncDataCacheEntry {
   void release();
   void addReference();
 
+  // Adds a shared pin unless 'this' is exclusive. Does not require the shard
+  // mutex. Returns true if the pin was added.
+  bool tryAddPin() {
+    auto pins = numPins_.load();
+    while (pins >= 0) {
+      if (numPins_.compare_exchange_weak(pins, pins + 1)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Sets an unpinned 'this' to exclusive mode. Must be called inside the
+  // mutex of 'shard_'. Returns false if 'this' is pinned.
+  bool trySetExclusive() {
+    int32_t expected = 0;
+    return numPins_.compare_exchange_strong(expected, kExclusive);
+  }
+
   // Returns a future that will be realized when a caller can retry
   // getting 'this'. Must be called inside the mutex of 'shard_'.
   folly::SemiFuture<bool> getFuture() {
@@ -278,7 +329,9 @@ class AsyncDataCacheEntry {
   std::unique_ptr<folly::SharedPromise<bool>> promise_;
   int32_t size_{0};
 
-  // Setting this from 0 to 1 or to kExclusive requires owning shard_->mutex_.
+  // Setting this to kExclusive requires owning shard_->mutex_ and is done
+  // with compare-and-swap from 0, so that it does not race with a pin added
+  // outside of the mutex. See tryAddPin().
   std::atomic<int32_t> numPins_{0};
 
   AccessStats accessStats_;
@@ -286,7 +339,11 @@ class AsyncDataCacheEntry {
   // True if 'this' is speculatively loaded. This is reset on first
   // hit. Allows catching a situation where prefetched entries get
   // evicted before they are hit.
-  bool isPrefetch_{false};
+  tsan_atomic<bool> isPrefetch_{false};
+
+  // See isProbation(). Set inside the shard mutex when 'this' is created and
+  // cleared by a hit, also outside of the mutex.
+  tsan_atomic<bool> isProbation_{false};
 
   // Set after first use of a prefetched entry. Cleared by
   // getAndClearFirstUseFlag(). Does not require synchronization since used for
@@ -299,6 +356,10 @@ class AsyncDataCacheEntry {
   // Tracking id. Used for deciding if this should be written to SSD.
   TrackingId trackingId_;
 
+  // Decides if 'this' is retained in RAM and written to SSD. Set from the
+  // access history of the stream when loading.
+  tsan_atomic<CacheAdmission> admission_{CacheAdmission::kRam};
+
   // SSD file from which this was loaded or nullptr if not backed by
   // SsdFile. Used to avoid re-adding items that already come from
   // SSD. The exact file and offset are needed to include uses in RAM
@@ -456,6 +517,26 @@ class CoalescedLoad {
   std::vector<int32_t> sizes_;
 };
 
+// Selects how the RAM tier of AsyncDataCache chooses the entries to
+// evict. Set by --cache_eviction_policy.
+enum class CacheEvictionPolicy {
+  // Clock scan that evicts the entries with the highest score(), which
+  // grows with the time since last use and falls with the number of uses.
+  kClock,
+  // The clock scan with TinyLFU admission. A new entry is put on
+  // probation unless its recent access frequency, estimated by a
+  // FrequencySketch, exceeds that of the recently evicted protected
+  // entries. Entries on probation are evicted first, until they are hit,
+  // so that scans of cold data do not evict frequently used entries.
+  kTinyLfu,
+};
+
+// Returns the policy named by --cache_eviction_policy, i.e. "clock" or
+// "tinylfu".
+CacheEvictionPolicy evictionPolicyFromName(const std::string& name);
+
+std::string evictionPolicyName(CacheEvictionPolicy policy);
+
 // Struct for CacheShard stats. Stats from all shards are added into
 // this struct to provide a snapshot of state.
 struct CacheStats {
@@ -500,6 +581,23 @@ struct CacheStats {
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // The eviction policy. The counters below compare the policies on the
+  // same traffic together with hitRatio().
+  CacheEvictionPolicy evictionPolicy{CacheEvictionPolicy::kClock};
+  // Number of entries on probation.
+  int32_t numProbation{};
+  // Number of new entries put on probation.
+  int64_t numProbationNew{};
+  // Number of hits that moved an entry from probation to protected.
+  int64_t numPromoted{};
+
+  // Returns the fraction of lookups that hit. The first hit to a prefetched
+  // entry counts as neither hit nor miss.
+  double hitRatio() const {
+    return numHit + numNew == 0
+        ? 0
+        : static_cast<double>(numHit) / (numHit + numNew);
+  }
 
   std::shared_ptr<SsdCacheStats> ssdStats = nullptr;
 };
@@ -509,7 +607,7 @@ struct CacheStats {
 // and other housekeeping.
 class CacheShard {
  public:
-  explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache) : cache_(cache) {}
+  explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache);
 
   // See AsyncDataCache::findOrCreate.
   CachePin findOrCreate(
@@ -559,6 +657,23 @@ class CacheShard {
 
   void calibrateThreshold();
 
+  // Returns a shared pin on the entry for 'key' if the entry is readable,
+  // holds at least 'size' bytes and does not need the bookkeeping of a first
+  // hit on a prefetched entry. Returns an empty pin otherwise, in which case
+  // the caller retries inside 'mutex_'. Does not take 'mutex_'.
+  CachePin findResident(RawFileCacheKey key, uint64_t size);
+
+  // Updates the stats and the eviction state of 'entry' for a hit.
+  void recordHit(AsyncDataCacheEntry* entry);
+
+  // True if a new entry for 'key' should be put on probation. Must be called
+  // inside 'mutex_'.
+  bool isProbation(RawFileCacheKey key) const;
+
+  // Updates 'victimFrequency_' for the eviction of 'entry', which has a key.
+  // Must be called inside 'mutex_'.
+  void recordVictim(const AsyncDataCacheEntry& entry);
+
   void removeEntryLocked(AsyncDataCacheEntry* entry);
 
   // Returns an unused entry if found. 'size' is a hint for selecting an entry
@@ -570,7 +685,10 @@ class CacheShard {
   void freeAllocations(std::vector<memory::Allocation>& allocations);
 
   mutable std::mutex mutex_;
-  folly::F14FastMap<RawFileCacheKey, AsyncDataCacheEntry*> entryMap_;
+  // Modified inside 'mutex_'. Read without 'mutex_' by findResident() and
+  // exists(). The entries are not freed before 'this', so that a reader may
+  // dereference an entry that is evicted after the lookup.
+  folly::ConcurrentHashMap<RawFileCacheKey, AsyncDataCacheEntry*> entryMap_;
   // Entries associated to a key.
   std::deque<std::unique_ptr<AsyncDataCacheEntry>> entries_;
   // Unused indices in 'entries_'.
@@ -586,9 +704,9 @@ class CacheShard {
   // Maximum retainable entry score(). Anything above this is evictable.
   int32_t evictionThreshold_{kNoThreshold};
   // Cumulative count of cache hits.
-  uint64_t numHit_{};
+  std::atomic<uint64_t> numHit_{};
   // Sum of bytes in cache hits.
-  uint64_t hitBytes_{};
+  std::atomic<uint64_t> hitBytes_{};
   // Cumulative count of hits on entries held in exclusive mode.
   uint64_t numWaitExclusive_{};
   // Cumulative count of new entry creation.
@@ -604,6 +722,17 @@ class CacheShard {
   // Tracker of time spent in allocating/freeing MemoryAllocator space
   // for backing cached data.
   std::atomic<uint64_t> allocClocks_;
+  // Access frequencies by key for the TinyLFU policy. nullptr for the
+  // clock policy.
+  std::unique_ptr<FrequencySketch> sketch_;
+  // Moving average of the estimated frequency of the evicted protected
+  // entries times 8.
+  int32_t victimFrequency_{0};
+  // Count of new entries put on probation.
+  uint64_t numProbationNew_{};
+  // Count of hits that promoted entries from probation. Updated outside of
+  // 'mutex_'.
+  std::atomic<uint64_t> numPromoted_{};
 };
 
 class AsyncDataCache : public memory::MemoryAllocator {
@@ -754,9 +883,36 @@ class AsyncDataCache : public memory::MemoryAllocator {
     return allocator_->stats();
   }
 
+  int32_t numShards() const {
+    return numShards_;
+  }
+
+  CacheEvictionPolicy evictionPolicy() const {
+    return evictionPolicy_;
+  }
+
  private:
-  static constexpr int32_t kNumShards = 4; // Must be power of 2.
-  static constexpr int32_t kShardMask = kNumShards - 1;
+  // Bounds for the number of shards, which is one per kCoresPerShard cores
+  // rounded up to a power of 2.
+  static constexpr int32_t kMinShards = 4;
+  static constexpr int32_t kMaxShards = 32;
+  static constexpr int32_t kCoresPerShard = 4;
+
+  // Bounds for the width of the FrequencySketch of a shard, which is one per
+  // kSketchBytesPerEntry bytes of capacity.
+  static constexpr int32_t kMinSketchWidth = 1024;
+  static constexpr int32_t kMaxSketchWidth = 1 << 18;
+  static constexpr int64_t kSketchBytesPerEntry = 8 << 10;
+
+  static int32_t defaultNumShards();
+
+  // Returns a new FrequencySketch for a shard or nullptr if the eviction
+  // policy does not use one.
+  std::unique_ptr<FrequencySketch> makeSketch() const;
+
+  CacheShard& shard(RawFileCacheKey key) const {
+    return *shards_[std::hash<RawFileCacheKey>()(key) & shardMask_];
+  }
 
   // Waits a pseudorandom delay times 'counter'.
   void backoff(int32_t counter);
@@ -774,6 +930,10 @@ class AsyncDataCache : public memory::MemoryAllocator {
 
   std::shared_ptr<memory::MemoryAllocator> allocator_;
   std::unique_ptr<SsdCache> ssdCache_;
+  const CacheEvictionPolicy evictionPolicy_;
+  // Power of 2.
+  const int32_t numShards_;
+  const int32_t shardMask_;
   std::vector<std::unique_ptr<CacheShard>> shards_;
   std::atomic<int32_t> shardCounter_{0};
   std::atomic<memory::MachinePageCount> cachedPages_{0};
@@ -839,6 +999,8 @@ T percentile(Next next, int32_t numSamples, int percent) {
 // The caller is responsible for calling setValid on the pins after a successful
 // read.
 //
+// 'maxIoBytes' limits the span of one read.
+//
 // Returns the number of distinct IOs, the number of bytes loaded into pins and
 // the number of extra bytes read.
 CoalesceIoStats readPins(
@@ -851,7 +1013,8 @@ CoalesceIoStats readPins(
         int32_t begin,
         int32_t end,
         uint64_t offset,
-        const std::vector<folly::Range<char*>>& buffers)> readFunc);
+        const std::vector<folly::Range<char*>>& buffers)> readFunc,
+    int64_t maxIoBytes = std::numeric_limits<int64_t>::max());
 
 } // namespace facebook::velox::cache
 
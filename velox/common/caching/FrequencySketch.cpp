@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <folly/hash/Hash.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::cache {
+
+FrequencySketch::FrequencySketch(int32_t width)
+    : mask_(bits::nextPowerOfTwo(std::max(1, width)) - 1),
+      sampleSize_(10L * (mask_ + 1)),
+      counters_(new tsan_atomic<uint8_t>[kNumRows * (mask_ + 1)]()) {
+  VELOX_CHECK_GT(width, 0);
+}
+
+int32_t FrequencySketch::index(uint64_t hash, int32_t row) const {
+  // Each row uses a different mix of the hash.
+  return (row * (mask_ + 1)) +
+      (folly::hash::twang_mix64(hash + row * 0x9E3779B97F4A7C15ULL) & mask_);
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  for (auto row = 0; row < kNumRows; ++row) {
+    auto& counter = counters_[index(hash, row)];
+    if (counter < kMaxCount) {
+      counter = static_cast<uint8_t>(counter + 1);
+    }
+  }
+  if (++numIncrements_ % sampleSize_ == 0) {
+    age();
+  }
+}
+
+int32_t FrequencySketch::estimate(uint64_t hash) const {
+  int32_t count = kMaxCount;
+  for (auto row = 0; row < kNumRows; ++row) {
+    count = std::min<int32_t>(count, counters_[index(hash, row)]);
+  }
+  return count;
+}
+
+void FrequencySketch::age() {
+  for (auto i = 0; i < kNumRows * (mask_ + 1); ++i) {
+    counters_[i] = static_cast<uint8_t>(counters_[i] / 2);
+  }
+}
+
+} // namespace facebook::velox::cache
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "velox/common/base/Portability.h"
+
+namespace facebook::velox::cache {
+
+/// Count-min sketch of access frequencies by hash, as in the TinyLFU
+/// admission filter. Each access increments one saturating counter in each of
+/// kNumRows rows and the estimate is the smallest of these. All counters are
+/// halved after a number of increments proportional to the width, so that
+/// the estimates reflect recent accesses.
+///
+/// Counters are updated without synchronization. Concurrent increments may
+/// be lost, which only makes the estimates less accurate.
+class FrequencySketch {
+ public:
+  static constexpr int32_t kNumRows = 4;
+  static constexpr uint8_t kMaxCount = 15;
+
+  /// 'width' is rounded up to a power of 2. It should be about the number of
+  /// distinct hashes to tell apart, e.g. the number of cached entries.
+  explicit FrequencySketch(int32_t width);
+
+  /// Records an access to 'hash'.
+  void increment(uint64_t hash);
+
+  /// Returns the estimated number of accesses to 'hash' since the last
+  /// halving, up to kMaxCount.
+  int32_t estimate(uint64_t hash) const;
+
+  int32_t width() const {
+    return mask_ + 1;
+  }
+
+ private:
+  // Halves all counters.
+  void age();
+
+  int32_t index(uint64_t hash, int32_t row) const;
+
+  const int32_t mask_;
+  // Number of increments between halvings.
+  const int64_t sampleSize_;
+  std::unique_ptr<tsan_atomic<uint8_t>[]> counters_;
+  std::atomic<int64_t> numIncrements_{0};
+};
+
+} // namespace facebook::velox::cache
@@ -97,6 +97,56 @@ struct TrackingData {
     readBytes += bytes;
     ++numReads;
   }
+
+  // Returns the percentage of referenced bytes that have been read. 100 if
+  // nothing is referenced.
+  int32_t readDensityPct() const {
+    if (!referencedBytes) {
+      return 100;
+    }
+    return (100 * readBytes) / referencedBytes;
+  }
+};
+
+// Decides where newly loaded data of a stream is retained.
+enum class CacheAdmission {
+  // Retained in RAM and written to SSD if there is an SSD cache.
+  kRam,
+  // Written to SSD if there is an SSD cache but evicted from RAM ahead of
+  // other data unless it is hit again.
+  kSsdOnly,
+  // Neither retained in RAM nor written to SSD unless it is hit again.
+  kNone,
+};
+
+// Admission thresholds on the read density (see
+// TrackingData::readDensityPct()) of a stream. A scan that references a
+// column but reads little of it, e.g. because a filter on another column
+// rarely passes, should not evict data that is densely read by other queries.
+struct CacheAdmissionPolicy {
+  // Number of references a stream must have before its history is used.
+  // Streams with less history are admitted to RAM.
+  int32_t minReferences{4};
+
+  // Minimum read density for admitting to RAM.
+  int32_t minRamDensityPct{20};
+
+  // Minimum read density for writing to SSD.
+  int32_t minSsdDensityPct{5};
+
+  CacheAdmission admission(const TrackingData& data) const {
+    if (data.numReferences < minReferences) {
+      return CacheAdmission::kRam;
+    }
+    const auto density = data.readDensityPct();
+    if (density >= minRamDensityPct) {
+      return CacheAdmission::kRam;
+    }
+    if (density >= minSsdDensityPct) {
+      return CacheAdmission::kSsdOnly;
+    }
+    return CacheAdmission::kNone;
+  }
 };
 
 // Tracks column access frequency during execution of a query. A
@@ -168,6 +218,23 @@ class ScanTracker {
     return data_[id];
   }
 
+  // Returns where data of the stream given by 'id' should be
+  // retained after loading. Untracked streams go to RAM.
+  CacheAdmission admission(TrackingId id) {
+    if (id.empty()) {
+      return CacheAdmission::kRam;
+    }
+    return admissionPolicy_.admission(trackingData(id));
+  }
+
+  const CacheAdmissionPolicy& admissionPolicy() const {
+    return admissionPolicy_;
+  }
+
+  void setAdmissionPolicy(const CacheAdmissionPolicy& policy) {
+    admissionPolicy_ = policy;
+  }
+
   std::string_view id() const {
     return id_;
   }
@@ -191,6 +258,7 @@ class ScanTracker {
   // size is unlimited.
   const int32_t loadQuantum_;
   FileGroupStats* FOLLY_NULLABLE fileGroupStats_;
+  CacheAdmissionPolicy admissionPolicy_;
 };
 
 } // namespace facebook::velox::cache
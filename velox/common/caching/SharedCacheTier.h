@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+
+#include "velox/common/caching/AsyncDataCache.h"
+
+namespace facebook::velox::cache {
+
+// A cache tier behind SsdCache that is shared between hosts, e.g. a blob
+// service in the local cluster. Unlike RAM and SSD, its contents survive the
+// rescheduling of a worker. Lookups go RAM -> SSD -> shared tier -> storage.
+// The tier is populated with the entries that are saved to SSD. Data is keyed
+// on file name and offset since file ids are local to a process. All methods
+// may be called concurrently from multiple threads.
+class SharedCacheTier {
+ public:
+  virtual ~SharedCacheTier() = default;
+
+  // Reads 'size' bytes at 'offset' in 'fileName' into 'buffers'. Returns false
+  // if the tier does not have the data. A tier that can fail should return
+  // false rather than throw, since a miss is served from storage.
+  virtual bool read(
+      std::string_view fileName,
+      uint64_t offset,
+      uint64_t size,
+      const std::vector<folly::Range<char*>>& buffers) = 0;
+
+  // Offers the entries of 'pins' for storing. The pins are in shared mode. This
+  // is called on the thread that saves entries to SSD and should not block on
+  // IO. An implementation may keep copies of the pins until it has stored the
+  // data and may drop entries it has no space for.
+  virtual void write(const std::vector<CachePin>& pins) = 0;
+
+  virtual std::string toString() const = 0;
+};
+
+} // namespace facebook::velox::cache
@@ -17,6 +17,7 @@
 #include <folly/Executor.h>
 #include <folly/portability/SysUio.h>
 #include <numeric>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/time/Timer.h"
 
@@ -37,12 +38,26 @@ SsdCache::SsdCache(
   // size.
   uint64_t sizeQuantum = numShards_ * SsdFile::kRegionSize;
   int32_t fileMaxRegions = bits::roundUp(maxBytes, sizeQuantum) / sizeQuantum;
+  // Opening a shard reads its checkpoint, so the shards are opened in
+  // parallel on 'executor_'. A shard that is not started by the time it is
+  // needed is opened on this thread.
+  std::vector<std::shared_ptr<AsyncSource<SsdFile>>> shards;
+  shards.reserve(numShards_);
   for (auto i = 0; i < numShards_; ++i) {
-    files_.push_back(std::make_unique<SsdFile>(
-        fmt::format("{}{}", filePrefix_, i),
-        i,
-        fileMaxRegions,
-        checkpointIntervalBytes / numShards));
+    shards.push_back(std::make_shared<AsyncSource<SsdFile>>(
+        [this, i, fileMaxRegions, checkpointIntervalBytes]() {
+          return std::make_unique<SsdFile>(
+              fmt::format("{}{}", filePrefix_, i),
+              i,
+              fileMaxRegions,
+              checkpointIntervalBytes / numShards_);
+        }));
+    if (executor_ && checkpointIntervalBytes) {
+      executor_->add([shard = shards.back()]() { shard->prepare(); });
+    }
+  }
+  for (auto& shard : shards) {
+    files_.push_back(shard->move());
   }
 }
 
@@ -61,11 +76,15 @@ bool SsdCache::startWrite() {
   }
   // There were writes in progress, so compensate for the increment.
   writesInProgress_.fetch_sub(numShards_);
+  ++writesSkipped_;
   return false;
 }
 
 void SsdCache::write(std::vector<CachePin> pins) {
   VELOX_CHECK_LE(numShards_, writesInProgress_);
+  if (sharedTier_) {
+    sharedTier_->write(pins);
+  }
   uint64_t bytes = 0;
   auto start = getCurrentTimeMicro();
   std::vector<std::vector<CachePin>> shards(numShards_);
@@ -90,6 +109,7 @@ void SsdCache::write(std::vector<CachePin> pins) {
     // We move the mutable vector of pins to the executor. These must
     // be wrapped in a shared struct to be passed via lambda capture.
     auto pinHolder = std::make_shared<PinHolder>(std::move(shards[i]));
+    writeQueueEntries_ += pinHolder->pins.size();
     executor_->add([this, i, pinHolder, bytes, start]() {
       try {
         files_[i]->write(pinHolder->pins);
@@ -98,6 +118,7 @@ void SsdCache::write(std::vector<CachePin> pins) {
         // theoretically happen for std::bad_alloc or such.
         LOG(INFO) << "Ignoring error in SsdFile::write: " << e.what();
       }
+      writeQueueEntries_ -= pinHolder->pins.size();
       if (--writesInProgress_ == 0) {
         // Typically occurs every few GB. Allows detecting unusually slow rates
         // from failing devices.
@@ -116,6 +137,8 @@ SsdCacheStats SsdCache::stats() const {
   for (auto& file : files_) {
     file->updateStats(stats);
   }
+  stats.writeQueueEntries = writeQueueEntries_;
+  stats.writesSkipped = writesSkipped_;
   return stats;
 }
 
@@ -133,6 +156,9 @@ std::string SsdCache::toString() const {
       << (data.bytesRead >> 20) << "MB Size " << (capacity >> 30)
       << "GB Occupied " << (data.bytesCached >> 30) << "GB";
   out << (data.entriesCached >> 10) << "K entries.";
+  out << " Write queue " << data.writeQueueEntries << " entries, skipped "
+      << data.writesSkipped << " writes, dropped " << data.entriesDropped
+      << " entries, " << data.writeErrors << " errors.";
   out << "\nGroupStats: " << groupStats_->toString(capacity);
   return out.str();
 }
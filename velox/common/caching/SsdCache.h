@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "velox/common/caching/SharedCacheTier.h"
 #include "velox/common/caching/SsdFile.h"
 
 namespace facebook::velox::cache {
@@ -64,6 +65,16 @@ class SsdCache {
   // it must have returned true.
   void write(std::vector<CachePin> pins);
 
+  // Sets the tier that is looked up after a miss in SSD. Entries written to SSD
+  // are also offered to 'tier'. Must be set before the cache is used.
+  void setSharedTier(std::shared_ptr<SharedCacheTier> tier) {
+    sharedTier_ = std::move(tier);
+  }
+
+  SharedCacheTier* FOLLY_NULLABLE sharedTier() const {
+    return sharedTier_.get();
+  }
+
   // Returns  stats aggregated from all shards.
   SsdCacheStats stats() const;
 
@@ -93,10 +104,19 @@ class SsdCache {
   // Count of shards with unfinished writes.
   std::atomic<int32_t> writesInProgress_{0};
 
+  // Number of entries passed to write() and not yet processed by their shard.
+  std::atomic<uint64_t> writeQueueEntries_{0};
+
+  // Number of startWrite() calls refused because a write was in progress.
+  std::atomic<uint64_t> writesSkipped_{0};
+
   // Stats for selecting entries to save from AsyncDataCache.
   std::unique_ptr<FileGroupStats> groupStats_;
   folly::Executor* executor_;
   std::atomic<bool> isShutdown_{false};
+
+  // Optional tier behind 'this'.
+  std::shared_ptr<SharedCacheTier> sharedTier_;
 };
 
 } // namespace facebook::velox::cache
@@ -23,6 +23,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <climits>
 #include <numeric>
 
 #include <fstream>
@@ -332,28 +333,26 @@ void SsdFile::write(std::vector<CachePin>& pins) {
 
     if (!space.has_value()) {
       // No space can be reclaimed. The pins are freed when the caller is freed.
+      stats_.entriesDropped += pins.size() - storeIndex;
       return;
     }
     auto [offset, available] = space.value();
     int32_t numWritten = 0;
     int32_t bytes = 0;
-    std::vector<iovec> iovecs;
     for (auto i = storeIndex; i < pins.size(); ++i) {
-      auto entry = pins[i].checkedEntry();
-      auto entrySize = entry->size();
+      auto entrySize = pins[i].checkedEntry()->size();
       if (bytes + entrySize > available) {
         break;
       }
-      addEntryToIovecs(*entry, iovecs);
       bytes += entrySize;
       ++numWritten;
     }
     VELOX_CHECK_GE(fileSize_, offset + bytes);
-    auto rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
-    if (rc != bytes) {
-      LOG(ERROR) << "Failed to write to SSD " << errno;
+    if (!writeBatch(pins, storeIndex, storeIndex + numWritten, offset)) {
       // If the write fails we return without adding the pins to the cache. The
       // entries are unchanged.
+      ++stats_.writeErrors;
+      stats_.entriesDropped += pins.size() - storeIndex;
       return;
     }
     {
@@ -373,6 +372,9 @@ void SsdFile::write(std::vector<CachePin>& pins) {
         stats_.bytesWritten += size;
         bytesAfterCheckpoint_ += size;
       }
+      if (checkpointIntervalBytes_) {
+        logEntriesLocked(pins, storeIndex, storeIndex + numWritten);
+      }
     }
     storeIndex += numWritten;
   }
@@ -383,6 +385,42 @@ void SsdFile::write(std::vector<CachePin>& pins) {
   }
 }
 
+bool SsdFile::writeBatch(
+    const std::vector<CachePin>& pins,
+    int32_t begin,
+    int32_t end,
+    uint64_t offset) {
+  std::vector<iovec> iovecs;
+  int64_t bytes = 0;
+  auto flush = [&]() {
+    if (iovecs.empty()) {
+      return true;
+    }
+    ++stats_.numWriteBatches;
+    auto rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
+    if (rc != bytes) {
+      LOG(ERROR) << "Failed to write to SSD " << errno;
+      return false;
+    }
+    offset += bytes;
+    bytes = 0;
+    iovecs.clear();
+    return true;
+  };
+  for (auto i = begin; i < end; ++i) {
+    auto entry = pins[i].checkedEntry();
+    const int32_t numRuns = entry->tinyData() ? 1 : entry->data().numRuns();
+    // pwritev fails for more than IOV_MAX iovecs, so a long run of entries
+    // goes in several calls.
+    if (iovecs.size() + numRuns > IOV_MAX && !flush()) {
+      return false;
+    }
+    addEntryToIovecs(*entry, iovecs);
+    bytes += entry->size();
+  }
+  return flush();
+}
+
 namespace {
 int32_t indexOfFirstMismatch(char* x, char* y, int n) {
   for (auto i = 0; i < n; ++i) {
@@ -431,6 +469,9 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   stats.bytesWritten += stats_.bytesWritten;
   stats.entriesRead += stats_.entriesRead;
   stats.bytesRead += stats_.bytesRead;
+  stats.entriesDropped += stats_.entriesDropped;
+  stats.writeErrors += stats_.writeErrors;
+  stats.numWriteBatches += stats_.numWriteBatches;
   stats.entriesCached += entries_.size();
   for (auto& regionSize : regionSize_) {
     stats.bytesCached += regionSize;
@@ -469,6 +510,37 @@ void SsdFile::logEviction(const std::vector<int32_t>& regions) {
   }
 }
 
+void SsdFile::logEntriesLocked(
+    const std::vector<CachePin>& pins,
+    int32_t begin,
+    int32_t end) {
+  std::string records;
+  auto append = [&](const auto& value) {
+    records.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  for (auto i = begin; i < end; ++i) {
+    auto entry = pins[i].checkedEntry();
+    const auto& fileNum = entry->key().fileNum;
+    const uint64_t id = fileNum.id();
+    if (loggedFileIds_.find(id) == loggedFileIds_.end()) {
+      loggedFileIds_[id] = fileNum;
+      const auto name = fileIds().string(id);
+      append(kLogFileMarker);
+      append(id);
+      append(static_cast<int32_t>(name.size()));
+      records.append(name);
+    }
+    append(kLogEntryMarker);
+    append(id);
+    append(static_cast<uint64_t>(entry->offset()));
+    append(SsdRun(entry->ssdOffset(), entry->size()).bits());
+  }
+  int32_t rc = ::write(evictLogFd_, records.data(), records.size());
+  if (rc != records.size()) {
+    checkpointError(rc, "Failed to log new entries");
+  }
+}
+
 void SsdFile::deleteCheckpoint(bool keepLog) {
   if (checkpointDeleted_) {
     return;
@@ -484,6 +556,7 @@ void SsdFile::deleteCheckpoint(bool keepLog) {
     }
   }
   checkpointDeleted_ = true;
+  loggedFileIds_.clear();
   auto logPath = fileName_ + kLogExtension;
   int32_t logRc = 0;
   if (!keepLog) {
@@ -585,6 +658,7 @@ void SsdFile::checkpoint(bool force) {
     }
     state.close();
     ftruncate(evictLogFd_, 0);
+    loggedFileIds_.clear();
     checkRc(fsync(evictLogFd_), "Sync of evict log");
     auto syncRc = sync->move();
     checkRc(*syncRc, fmt::format("Error in cache file fsync {}", *syncRc));
@@ -619,7 +693,10 @@ void SsdFile::initializeCheckpoint() {
     LOG(INFO) << "Starting shard " << shardId_ << " without checkpoint";
   }
   auto logPath = fileName_ + kLogExtension;
-  evictLogFd_ = open(logPath.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  // The log is truncated at each checkpoint. O_APPEND makes the next record go
+  // to the new end.
+  evictLogFd_ = open(
+      logPath.c_str(), O_CREAT | O_RDWR | O_APPEND, S_IRUSR | S_IWUSR);
   if (evictLogFd_ < 0) {
     // Failure to open the log at startup is a process terminating error.
     LOG(ERROR) << "Could not open evict log " << logPath << " rc "
@@ -627,6 +704,11 @@ void SsdFile::initializeCheckpoint() {
     exit(1);
   }
 
+  if (!hasCheckpoint) {
+    // Records in the log refer to a checkpoint that no longer exists.
+    ftruncate(evictLogFd_, 0);
+  }
+
   try {
     if (hasCheckpoint) {
       state.exceptions(std::ifstream::failbit);
@@ -676,14 +758,76 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     auto lease = StringIdLease(fileIds(), name);
     idMap[id] = std::move(lease);
   }
+  const int64_t entriesStart = state.tellg();
+  // The log has evicted regions and entries written since the checkpoint in
+  // the order they happened. An entry is valid unless its region was evicted
+  // after it was written. Checkpoint entries precede all records.
   auto logSize = lseek(evictLogFd_, 0, SEEK_END);
-  std::vector<uint32_t> evicted(logSize / sizeof(uint32_t));
-  auto rc = ::pread(evictLogFd_, evicted.data(), logSize, 0);
+  std::string log(logSize, '\0');
+  auto rc = ::pread(evictLogFd_, log.data(), logSize, 0);
   VELOX_CHECK_EQ(logSize, rc, "Failed to read eviction log");
-  std::unordered_set<uint32_t> evictedMap;
-  for (auto region : evicted) {
-    evictedMap.insert(region);
+  struct LogEntry {
+    FileCacheKey key;
+    SsdRun run;
+    // Position of the record in the log.
+    int64_t position;
+  };
+  std::vector<LogEntry> logEntries;
+  // Position of the last eviction of each evicted region.
+  folly::F14FastMap<int32_t, int64_t> lastEviction;
+  std::unordered_map<uint64_t, StringIdLease> logIdMap = idMap;
+  int64_t position = 0;
+  auto hasBytes = [&](int64_t bytes) {
+    return position + bytes <= log.size();
+  };
+  auto readLog = [&](auto& value) {
+    memcpy(&value, log.data() + position, sizeof(value));
+    position += sizeof(value);
+  };
+  while (hasBytes(sizeof(uint32_t))) {
+    // A record cut short by a crash ends the log.
+    const auto recordPosition = position;
+    uint32_t tag;
+    readLog(tag);
+    if (tag == kLogFileMarker) {
+      uint64_t id;
+      int32_t length;
+      if (!hasBytes(sizeof(id) + sizeof(length))) {
+        break;
+      }
+      readLog(id);
+      readLog(length);
+      if (!hasBytes(length)) {
+        break;
+      }
+      logIdMap[id] = StringIdLease(
+          fileIds(), std::string_view(log.data() + position, length));
+      position += length;
+    } else if (tag == kLogEntryMarker) {
+      uint64_t id;
+      uint64_t offset;
+      uint64_t bits;
+      if (!hasBytes(sizeof(id) + sizeof(offset) + sizeof(bits))) {
+        break;
+      }
+      readLog(id);
+      readLog(offset);
+      readLog(bits);
+      auto it = logIdMap.find(id);
+      VELOX_CHECK(it != logIdMap.end());
+      logEntries.push_back(LogEntry{
+          FileCacheKey{it->second, offset}, SsdRun(bits), recordPosition});
+    } else {
+      lastEviction[tag] = recordPosition;
+    }
   }
+  // Reserve for the entries of the checkpoint. Each takes 24 bytes.
+  state.seekg(0, std::ios_base::end);
+  const int64_t checkpointSize = state.tellg();
+  state.seekg(entriesStart);
+  entries_.reserve(
+      (checkpointSize - entriesStart) / (3 * sizeof(uint64_t)) +
+      logEntries.size());
   for (;;) {
     uint64_t fileNum = readNumber<uint64_t>(state);
     if (fileNum == kCheckpointEndMarker) {
@@ -692,7 +836,7 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     uint64_t offset = readNumber<uint64_t>(state);
     auto run = SsdRun(readNumber<uint64_t>(state));
     // Check that the recovered entry does not fall in an evicted region.
-    if (evictedMap.find(regionIndex(run.offset())) == evictedMap.end()) {
+    if (lastEviction.find(regionIndex(run.offset())) == lastEviction.end()) {
       // The file may have a different id on restore.
       auto it = idMap.find(fileNum);
       VELOX_CHECK(it != idMap.end());
@@ -700,12 +844,30 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
       entries_[std::move(key)] = run;
     }
   }
+  for (auto& entry : logEntries) {
+    const auto region = regionIndex(entry.run.offset());
+    auto it = lastEviction.find(region);
+    if (it != lastEviction.end() && it->second > entry.position) {
+      continue;
+    }
+    if (region >= maxRegions_) {
+      continue;
+    }
+    // The file grew after the checkpoint. The regions it grew by hold logged
+    // entries and must not be handed out as new regions.
+    numRegions_ = std::max(numRegions_, region + 1);
+    // Space after the recovered entries of a region stays writable.
+    regionSize_[region] = std::max<uint32_t>(
+        regionSize_[region],
+        entry.run.offset() + entry.run.size() - region * kRegionSize);
+    entries_[std::move(entry.key)] = entry.run;
+  }
   // The state is successfully read. Install the access frequency scores and
   // evicted regions.
   VELOX_CHECK_EQ(scores.size(), tracker_.regionScores().size());
   // Set the writable regions by deduplicated evicted regions.
   writableRegions_.clear();
-  for (auto region : evictedMap) {
+  for (auto& [region, unused] : lastEviction) {
     writableRegions_.push_back(region);
   }
   tracker_.setRegionScores(scores);
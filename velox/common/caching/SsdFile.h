@@ -134,6 +134,11 @@ struct SsdCacheStats {
     entriesCached = tsanAtomicValue(other.entriesCached);
     bytesCached = tsanAtomicValue(other.bytesCached);
     numPins = tsanAtomicValue(other.numPins);
+    entriesDropped = tsanAtomicValue(other.entriesDropped);
+    writeErrors = tsanAtomicValue(other.writeErrors);
+    numWriteBatches = tsanAtomicValue(other.numWriteBatches);
+    writeQueueEntries = tsanAtomicValue(other.writeQueueEntries);
+    writesSkipped = tsanAtomicValue(other.writesSkipped);
   }
 
   tsan_atomic<uint64_t> entriesWritten{0};
@@ -143,6 +148,17 @@ struct SsdCacheStats {
   tsan_atomic<uint64_t> entriesCached{0};
   tsan_atomic<uint64_t> bytesCached{0};
   tsan_atomic<int32_t> numPins{0};
+  // Entries passed to SsdFile::write() that were not stored for lack of space
+  // or an IO error.
+  tsan_atomic<uint64_t> entriesDropped{0};
+  tsan_atomic<uint64_t> writeErrors{0};
+  // Number of pwritev calls. Each covers many entries.
+  tsan_atomic<uint64_t> numWriteBatches{0};
+  // Entries queued for writing but not yet written. Set by SsdCache.
+  tsan_atomic<uint64_t> writeQueueEntries{0};
+  // Number of SsdCache::startWrite() calls that returned false because a
+  // write was in progress. Set by SsdCache.
+  tsan_atomic<uint64_t> writesSkipped{0};
 };
 
 // A shard of SsdCache. Corresponds to one file on SSD.  The data
@@ -239,6 +255,12 @@ class SsdFile {
   static constexpr int64_t kCheckpointMapMarker = 0xfffffffffffffffe;
   // Magic number at end of completed checkpoint file.
   static constexpr int64_t kCheckpointEndMarker = 0xcbedf11e;
+  // Tags of the records in the log that are not evicted region numbers. A
+  // file record is followed by a file id, name length and name. An entry
+  // record is followed by a file id, offset and SsdRun bits. The file id of an
+  // entry record is defined by a preceding file record.
+  static constexpr uint32_t kLogFileMarker = 0xffffffff;
+  static constexpr uint32_t kLogEntryMarker = 0xfffffffe;
 
   // Increments the pin count of the region of 'offset'. Caller must hold
   // 'mutex_'.
@@ -266,6 +288,15 @@ class SsdFile {
   // Reads the backing file with ReadFile::preadv().
   void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
 
+  // Writes the entries of 'pins' in [begin, end) consecutively at 'offset'.
+  // The entries are written with as few pwritev calls as the limit on iovecs
+  // allows. Returns false on error.
+  bool writeBatch(
+      const std::vector<CachePin>& pins,
+      int32_t begin,
+      int32_t end,
+      uint64_t offset);
+
   // Verifies that 'entry' has the data at 'run'.
   void verifyWrite(AsyncDataCacheEntry& entry, SsdRun run);
 
@@ -293,6 +324,15 @@ class SsdFile {
   // checkpoint.
   void logEviction(const std::vector<int32_t>& regions);
 
+  // Appends records for the entries of 'pins' in [begin, end), which were
+  // just written, to the log. Together with the evictions in the log, these
+  // bring the last checkpoint up to date on recovery without writing a full
+  // checkpoint. Caller must hold 'mutex_'.
+  void logEntriesLocked(
+      const std::vector<CachePin>& pins,
+      int32_t begin,
+      int32_t end);
+
   // Serializes access to all private data members.
   mutable std::mutex mutex_;
   // Name of cache file, used as prefix for checkpoint files.
@@ -358,9 +398,14 @@ class SsdFile {
   // Count of bytes written after last checkpoint.
   std::atomic<uint64_t> bytesAfterCheckpoint_{0};
 
-  // fd for logging evictions.
+  // fd for logging evictions and entries written since the last checkpoint.
   int32_t evictLogFd_{0};
 
+  // File ids that have a file record in the log since the last checkpoint.
+  // The leases keep the ids from being reused for a different file name while
+  // the log refers to them.
+  folly::F14FastMap<uint64_t, StringIdLease> loggedFileIds_;
+
   // True if there was an error with checkpoint and the checkpoint was deleted.
   bool checkpointDeleted_{false};
 };
@@ -19,6 +19,7 @@
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
+#include <folly/Random.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <glog/logging.h>
@@ -533,6 +534,154 @@ TEST_F(AsyncDataCacheTest, pin) {
   EXPECT_EQ(0, cache_->incrementPrefetchPages(0));
 }
 
+TEST_F(AsyncDataCacheTest, hitsDuringEviction) {
+  constexpr int32_t kNumEntries = 200;
+  constexpr int32_t kSize = 16 << 10;
+  initializeCache(64 << 20);
+  EXPECT_LE(4, cache_->numShards());
+  EXPECT_EQ(0, cache_->numShards() & (cache_->numShards() - 1));
+
+  StringIdLease file(fileIds(), std::string_view("hitsDuringEviction"));
+  auto loadAll = [&]() {
+    for (auto i = 0; i < kNumEntries; ++i) {
+      RawFileCacheKey key{file.id(), static_cast<uint64_t>(i) * kSize};
+      auto pin = cache_->findOrCreate(key, kSize);
+      if (!pin.empty() && pin.checkedEntry()->isExclusive()) {
+        initializeContents(key.fileNum + key.offset, pin.entry()->data());
+        pin.entry()->setExclusiveToShared();
+      }
+    }
+  };
+  loadAll();
+
+  // Pins taken without the shard mutex race with the eviction of all
+  // unpinned entries. A pin must be on the entry of its key.
+  std::atomic<bool> stop{false};
+  std::thread evictor([&]() {
+    while (!stop) {
+      cache_->clear();
+      loadAll();
+    }
+  });
+  runThreads(8, [&](int32_t i) {
+    folly::Random::DefaultGenerator rng(i);
+    for (auto n = 0; n < 20'000; ++n) {
+      RawFileCacheKey key{
+          file.id(),
+          static_cast<uint64_t>(folly::Random::rand32(kNumEntries, rng)) *
+              kSize};
+      auto pin = cache_->findOrCreate(key, kSize);
+      if (pin.empty()) {
+        continue;
+      }
+      auto entry = pin.checkedEntry();
+      if (entry->isExclusive()) {
+        initializeContents(key.fileNum + key.offset, entry->data());
+        entry->setExclusiveToShared();
+      }
+      EXPECT_EQ(key.offset, entry->offset());
+      checkContents(*entry);
+    }
+  });
+  stop = true;
+  evictor.join();
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(0, stats.numShared);
+  EXPECT_EQ(0, stats.numExclusive);
+  EXPECT_LT(0, stats.numHit);
+}
+
+TEST_F(AsyncDataCacheTest, tinyLfuScanResistance) {
+  constexpr int32_t kSize = 64 << 10;
+  constexpr int32_t kNumHot = 16;
+  constexpr int32_t kNumCold = 2'000;
+  gflags::FlagSaver flagSaver;
+  FLAGS_cache_eviction_policy = "tinylfu";
+  initializeCache(32 << 20);
+  ASSERT_EQ(CacheEvictionPolicy::kTinyLfu, cache_->evictionPolicy());
+
+  StringIdLease file(fileIds(), std::string_view("tinyLfuScanResistance"));
+  auto load = [&](uint64_t offset) {
+    RawFileCacheKey key{file.id(), offset};
+    auto pin = cache_->findOrCreate(key, kSize);
+    ASSERT_FALSE(pin.empty());
+    if (pin.checkedEntry()->isExclusive()) {
+      initializeContents(key.fileNum + key.offset, pin.entry()->data());
+      pin.entry()->setExclusiveToShared();
+    }
+  };
+  // The hot entries are loaded and hit, which protects them.
+  for (auto i = 0; i < 3; ++i) {
+    for (auto j = 0; j < kNumHot; ++j) {
+      load(j * kSize);
+    }
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(kNumHot, stats.numProbationNew);
+  EXPECT_EQ(kNumHot, stats.numPromoted);
+  EXPECT_EQ(0, stats.numProbation);
+
+  // A scan of cold data much larger than the cache is put on probation and
+  // evicts itself.
+  for (auto i = 0; i < kNumCold; ++i) {
+    load((kNumHot + i) * kSize);
+  }
+  for (auto i = 0; i < kNumHot; ++i) {
+    EXPECT_TRUE(cache_->exists(RawFileCacheKey{file.id(), i * kSize})) << i;
+  }
+  stats = cache_->refreshStats();
+  EXPECT_EQ(CacheEvictionPolicy::kTinyLfu, stats.evictionPolicy);
+  // A cold key may share its counters in the sketch with other keys and be
+  // protected.
+  EXPECT_LE(kNumHot + kNumCold * 9 / 10, stats.numProbationNew);
+  EXPECT_EQ(kNumHot * 2, stats.numHit);
+  EXPECT_EQ(kNumHot + kNumCold, stats.numNew);
+  EXPECT_LT(0, stats.numEvict);
+  EXPECT_LT(0, stats.numProbation);
+  EXPECT_NE(std::string::npos, cache_->toString().find("tinylfu"));
+}
+
+TEST_F(AsyncDataCacheTest, admission) {
+  CacheAdmissionPolicy policy;
+  TrackingData data;
+  data.incrementReference(1000, 0);
+  // Too little history for a decision.
+  EXPECT_EQ(CacheAdmission::kRam, policy.admission(data));
+  for (auto i = 0; i < 9; ++i) {
+    data.incrementReference(1000, 0);
+  }
+  data.incrementRead(100);
+  EXPECT_EQ(CacheAdmission::kNone, policy.admission(data));
+  data.incrementRead(900);
+  EXPECT_EQ(CacheAdmission::kSsdOnly, policy.admission(data));
+  data.incrementRead(5000);
+  EXPECT_EQ(CacheAdmission::kRam, policy.admission(data));
+
+  initializeCache(1 << 20);
+  StringIdLease file(fileIds(), std::string_view("admissionfile"));
+  RawFileCacheKey key{file.id(), 0};
+  auto pin = cache_->findOrCreate(key, 25000, nullptr);
+  ASSERT_TRUE(pin.checkedEntry()->isExclusive());
+  pin.checkedEntry()->setPrefetch();
+  pin.checkedEntry()->setAdmission(CacheAdmission::kNone);
+  pin.checkedEntry()->setExclusiveToShared();
+  pin.clear();
+  // The first use of a prefetched entry is not a reuse. The entry stays first
+  // in line for eviction.
+  pin = cache_->findOrCreate(key, 25000, nullptr);
+  EXPECT_EQ(CacheAdmission::kNone, pin.checkedEntry()->admission());
+  EXPECT_EQ(
+      std::numeric_limits<int32_t>::max(),
+      pin.checkedEntry()->score(accessTime()));
+  pin.clear();
+  // A hit shows reuse and admits the entry to RAM.
+  pin = cache_->findOrCreate(key, 25000, nullptr);
+  EXPECT_EQ(CacheAdmission::kRam, pin.checkedEntry()->admission());
+  EXPECT_GT(
+      std::numeric_limits<int32_t>::max(),
+      pin.checkedEntry()->score(accessTime()));
+}
+
 TEST_F(AsyncDataCacheTest, replace) {
   constexpr int64_t kMaxBytes = 64 << 20;
   FLAGS_velox_exception_user_stacktrace_enabled = false;
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include <thread>
+
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/memory/MmapAllocator.h"
+
+// Measures concurrent hits on entries that are resident in
+// AsyncDataCache, as when many scan drivers read the same hot columns.
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+namespace {
+
+constexpr int32_t kNumFiles = 16;
+constexpr int32_t kEntriesPerFile = 256;
+constexpr int32_t kEntrySize = 1024;
+
+class CacheLookupBenchmark {
+ public:
+  CacheLookupBenchmark() {
+    constexpr uint64_t kCapacity = 256 << 20;
+    memory::MmapAllocator::Options options;
+    options.capacity = kCapacity;
+    cache_ = std::make_shared<AsyncDataCache>(
+        std::make_shared<memory::MmapAllocator>(options), kCapacity);
+    for (auto i = 0; i < kNumFiles; ++i) {
+      files_.emplace_back(fileIds(), fmt::format("lookup_file_{}", i));
+      for (auto j = 0; j < kEntriesPerFile; ++j) {
+        auto pin = cache_->findOrCreate(key(i, j), kEntrySize);
+        VELOX_CHECK(pin.checkedEntry()->isExclusive());
+        pin.checkedEntry()->setExclusiveToShared();
+      }
+    }
+  }
+
+  // Looks up 'numLookups' resident entries on each of 'numThreads' threads.
+  void run(int32_t numThreads, int32_t numLookups) {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for (auto i = 0; i < numThreads; ++i) {
+      threads.emplace_back([&, i]() {
+        folly::Random::DefaultGenerator rng(i);
+        for (auto n = 0; n < numLookups; ++n) {
+          auto pin = cache_->findOrCreate(
+              key(folly::Random::rand32(kNumFiles, rng),
+                  folly::Random::rand32(kEntriesPerFile, rng)),
+              kEntrySize);
+          VELOX_CHECK(pin.checkedEntry()->isShared());
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+ private:
+  RawFileCacheKey key(int32_t file, int32_t entry) const {
+    return RawFileCacheKey{files_[file].id(), entry * kEntrySize};
+  }
+
+  std::shared_ptr<AsyncDataCache> cache_;
+  std::vector<StringIdLease> files_;
+};
+
+std::unique_ptr<CacheLookupBenchmark> benchmark;
+
+void lookup(uint32_t iterations, int32_t numThreads) {
+  constexpr int32_t kLookupsPerIteration = 1'000'000;
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run(numThreads, kLookupsPerIteration / numThreads);
+  }
+}
+
+BENCHMARK_NAMED_PARAM(lookup, 1_thread, 1);
+BENCHMARK_NAMED_PARAM(lookup, 8_threads, 8);
+BENCHMARK_NAMED_PARAM(lookup, 32_threads, 32);
+BENCHMARK_NAMED_PARAM(lookup, 128_threads, 128);
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<CacheLookupBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
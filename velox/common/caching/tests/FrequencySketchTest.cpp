@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include "gtest/gtest.h"
+
+using namespace facebook::velox::cache;
+
+TEST(FrequencySketchTest, estimate) {
+  FrequencySketch sketch(1000);
+  EXPECT_EQ(1024, sketch.width());
+  EXPECT_EQ(0, sketch.estimate(1));
+
+  for (auto i = 0; i < 5; ++i) {
+    sketch.increment(1);
+  }
+  sketch.increment(2);
+  // Count-min never underestimates.
+  EXPECT_LE(5, sketch.estimate(1));
+  EXPECT_LE(1, sketch.estimate(2));
+  EXPECT_GT(sketch.estimate(1), sketch.estimate(2));
+
+  for (auto i = 0; i < 100; ++i) {
+    sketch.increment(3);
+  }
+  EXPECT_EQ(FrequencySketch::kMaxCount, sketch.estimate(3));
+}
+
+TEST(FrequencySketchTest, aging) {
+  FrequencySketch sketch(16);
+  for (auto i = 0; i < 8; ++i) {
+    sketch.increment(1);
+  }
+  EXPECT_LE(8, sketch.estimate(1));
+  // Counters are halved every 10 * width increments. The last of these
+  // halves all counters, which are at most kMaxCount before.
+  for (auto i = 0; i < 10 * 16 - 8; ++i) {
+    sketch.increment(1'000 + i);
+  }
+  EXPECT_GT(8, sketch.estimate(1));
+}
@@ -47,7 +47,10 @@ class SsdFileTest : public testing::Test {
     }
   }
 
-  void initializeCache(int64_t maxBytes, int64_t ssdBytes = 0) {
+  void initializeCache(
+      int64_t maxBytes,
+      int64_t ssdBytes = 0,
+      int64_t checkpointIntervalBytes = 0) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_ssd_odirect = false;
     cache_ = std::make_shared<AsyncDataCache>(
@@ -56,10 +59,18 @@ class SsdFileTest : public testing::Test {
     fileName_ = StringIdLease(fileIds(), "fileInStorage");
 
     tempDirectory_ = exec::test::TempDirectoryPath::create();
+    ssdBytes_ = ssdBytes;
+    checkpointIntervalBytes_ = checkpointIntervalBytes;
+    openFile();
+  }
+
+  // Opens the SsdFile, recovering from a checkpoint if there is one.
+  void openFile() {
     ssdFile_ = std::make_unique<SsdFile>(
         fmt::format("{}/ssdtest", tempDirectory_->path),
         0,
-        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize);
+        bits::roundUp(ssdBytes_, SsdFile::kRegionSize) / SsdFile::kRegionSize,
+        checkpointIntervalBytes_);
   }
 
   static void initializeContents(int64_t sequence, memory::Allocation& alloc) {
@@ -189,6 +200,9 @@ class SsdFileTest : public testing::Test {
       }
     }
     EXPECT_LT(numWritten, pins.size());
+    SsdCacheStats stats;
+    ssdFile_->updateStats(stats);
+    EXPECT_LE(pins.size() - numWritten, stats.entriesDropped);
     // vector::clear() does not guarantee the release order; we need to clear
     // the pins in the correct order explicitly.
     for (auto& pin : ssdPins) {
@@ -223,6 +237,8 @@ class SsdFileTest : public testing::Test {
   StringIdLease fileName_;
 
   std::unique_ptr<SsdFile> ssdFile_;
+  int64_t ssdBytes_{0};
+  int64_t checkpointIntervalBytes_{0};
 };
 
 TEST_F(SsdFileTest, writeAndRead) {
@@ -291,3 +307,74 @@ TEST_F(SsdFileTest, writeAndRead) {
     }
   }
 }
+
+TEST_F(SsdFileTest, manySmallEntries) {
+  initializeCache(128 * kMB, 4 * SsdFile::kRegionSize);
+  // More entries than fit in the iovecs of one pwritev.
+  constexpr int32_t kNumEntries = 3000;
+  auto pins = makePins(fileName_.id(), 0, 4096, 4096, kNumEntries * 4096);
+  ASSERT_EQ(kNumEntries, pins.size());
+  ssdFile_->write(pins);
+  for (auto& pin : pins) {
+    EXPECT_EQ(ssdFile_.get(), pin.entry()->ssdFile());
+  }
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(kNumEntries, stats.entriesWritten);
+  EXPECT_LT(1, stats.numWriteBatches);
+  EXPECT_EQ(0, stats.entriesDropped);
+  EXPECT_EQ(0, stats.writeErrors);
+  pins.clear();
+  cache_->clear();
+  pins = makePins(fileName_.id(), 0, 4096, 4096, kNumEntries * 4096);
+  readAndCheckPins(pins);
+}
+
+TEST_F(SsdFileTest, recoverFromLog) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  // The interval is never reached, so only explicit checkpoints are made.
+  initializeCache(128 * kMB, kSsdSize, 1L << 40);
+  auto pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 20 * kMB);
+  ssdFile_->write(pins);
+  ssdFile_->checkpoint(true);
+  // The logged entries fill up region 0 and continue in region 1, which the
+  // checkpoint doesn't know.
+  const uint64_t loggedStart = 100 * kMB;
+  constexpr int64_t kLoggedSize = 60 * kMB;
+  auto loggedPins =
+      makePins(fileName_.id(), loggedStart, 4096, 2048 * 1025, kLoggedSize);
+  ssdFile_->write(loggedPins);
+  ASSERT_GE(loggedPins.back().entry()->ssdOffset(), SsdFile::kRegionSize);
+  std::vector<uint64_t> offsets;
+  for (auto& pin : pins) {
+    offsets.push_back(pin.entry()->offset());
+  }
+  for (auto& pin : loggedPins) {
+    offsets.push_back(pin.entry()->offset());
+  }
+  pins.clear();
+  loggedPins.clear();
+  cache_->clear();
+
+  // Restart from the checkpoint and the entries written after it.
+  openFile();
+  for (auto offset : offsets) {
+    EXPECT_FALSE(
+        ssdFile_->find(RawFileCacheKey{fileName_.id(), offset}).empty());
+  }
+  loggedPins =
+      makePins(fileName_.id(), loggedStart, 4096, 2048 * 1025, kLoggedSize);
+  readAndCheckPins(loggedPins);
+
+  // New entries do not overwrite the recovered ones, also not in the region
+  // that was added after the checkpoint.
+  loggedPins.clear();
+  cache_->clear();
+  pins = makePins(fileName_.id(), 200 * kMB, 4096, 2048 * 1025, 20 * kMB);
+  ssdFile_->write(pins);
+  pins.clear();
+  cache_->clear();
+  loggedPins =
+      makePins(fileName_.id(), loggedStart, 4096, 2048 * 1025, kLoggedSize);
+  readAndCheckPins(loggedPins);
+}
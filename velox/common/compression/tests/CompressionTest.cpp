@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/compression/Compression.h"
+
+namespace facebook::velox::common {
+
+class CompressionTest : public testing::Test {};
+
+TEST_F(CompressionTest, compressionKindToString) {
+  EXPECT_EQ(compressionKindToString(CompressionKind_NONE), "none");
+  EXPECT_EQ(compressionKindToString(CompressionKind_ZLIB), "zlib");
+  EXPECT_EQ(compressionKindToString(CompressionKind_SNAPPY), "snappy");
+  EXPECT_EQ(compressionKindToString(CompressionKind_LZO), "lzo");
+  EXPECT_EQ(compressionKindToString(CompressionKind_LZ4), "lz4");
+  EXPECT_EQ(compressionKindToString(CompressionKind_ZSTD), "zstd");
+  EXPECT_EQ(
+      compressionKindToString(static_cast<CompressionKind>(999)),
+      "unknown - 999");
+}
+
+TEST_F(CompressionTest, stringToCompressionKind) {
+  EXPECT_EQ(stringToCompressionKind("none"), CompressionKind_NONE);
+  EXPECT_EQ(stringToCompressionKind("zlib"), CompressionKind_ZLIB);
+  EXPECT_EQ(stringToCompressionKind("snappy"), CompressionKind_SNAPPY);
+  EXPECT_EQ(stringToCompressionKind("LZO"), CompressionKind_LZO);
+  EXPECT_EQ(stringToCompressionKind("lz4"), CompressionKind_LZ4);
+  EXPECT_EQ(stringToCompressionKind("Zstd"), CompressionKind_ZSTD);
+  VELOX_ASSERT_THROW(
+      stringToCompressionKind("bz2"), "Not support compression kind bz2");
+}
+
+TEST_F(CompressionTest, compressionKindToCodec) {
+  for (const auto kind :
+       {CompressionKind_NONE,
+        CompressionKind_ZLIB,
+        CompressionKind_SNAPPY,
+        CompressionKind_ZSTD,
+        CompressionKind_LZ4}) {
+    SCOPED_TRACE(compressionKindToString(kind));
+    auto codec = compressionKindToCodec(kind);
+    ASSERT_NE(codec, nullptr);
+    const std::string data(4096, 'a');
+    auto compressed = codec->compress(folly::StringPiece(data));
+    auto uncompressed = codec->uncompress(folly::StringPiece(compressed));
+    ASSERT_EQ(uncompressed, data);
+  }
+  VELOX_ASSERT_THROW(
+      compressionKindToCodec(CompressionKind_LZO), "Not support lzo in folly");
+}
+
+} // namespace facebook::velox::common
@@ -15,8 +15,12 @@
  */
 
 #include "velox/common/file/File.h"
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/file/IoUring.h"
+#include "velox/common/memory/MemoryPool.h"
 
 #include <fmt/format.h>
+#include <folly/ScopeGuard.h>
 #include <glog/logging.h>
 #include <memory>
 #include <stdexcept>
@@ -26,6 +30,15 @@
 
 namespace facebook::velox {
 
+namespace {
+// Byte size of the buffer of a LocalWriteFile written with O_DIRECT.
+constexpr uint64_t kDirectWriteBufferSize = 1 << 20;
+
+bool isDirectIoAligned(uint64_t value) {
+  return value % IoUring::kDirectIoAlignment == 0;
+}
+} // namespace
+
 std::string ReadFile::pread(uint64_t offset, uint64_t length) const {
   std::string buf;
   buf.resize(length);
@@ -73,7 +86,8 @@ uint64_t InMemoryWriteFile::size() const {
   return file_->size();
 }
 
-LocalReadFile::LocalReadFile(std::string_view path) : path_(path) {
+LocalReadFile::LocalReadFile(std::string_view path, bool directIo)
+    : path_(path) {
   fd_ = open(path_.c_str(), O_RDONLY);
   VELOX_CHECK_GE(
       fd_,
@@ -91,11 +105,23 @@ LocalReadFile::LocalReadFile(std::string_view path) : path_(path) {
       path,
       folly::errnoStr(errno));
   size_ = rc;
+#ifdef O_DIRECT
+  if (directIo) {
+    directFd_ = open(path_.c_str(), O_RDONLY | O_DIRECT);
+    if (directFd_ < 0) {
+      LOG(WARNING) << "O_DIRECT open failure in LocalReadFile constructor, "
+                   << path << " " << folly::errnoStr(errno);
+    }
+  }
+#endif
 }
 
 LocalReadFile::LocalReadFile(int32_t fd) : fd_(fd) {}
 
 LocalReadFile::~LocalReadFile() {
+  if (directFd_ >= 0) {
+    close(directFd_);
+  }
   const int ret = close(fd_);
   if (ret < 0) {
     LOG(WARNING) << "close failure in LocalReadFile destructor: " << ret << ", "
@@ -106,6 +132,28 @@ LocalReadFile::~LocalReadFile() {
 void LocalReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   bytesRead_ += length;
+  if (directFd_ >= 0 && isDirectIoAligned(offset) &&
+      isDirectIoAligned(reinterpret_cast<uintptr_t>(pos))) {
+    // The whole blocks bypass the page cache. The rest of a block at the end
+    // of the read is read through the page cache.
+    const uint64_t directLength =
+        length / IoUring::kDirectIoAlignment * IoUring::kDirectIoAlignment;
+    if (directLength > 0) {
+      const auto bytesRead = ::pread(directFd_, pos, directLength, offset);
+      VELOX_CHECK_EQ(
+          bytesRead,
+          directLength,
+          "O_DIRECT fread failure in LocalReadFile::PReadInternal, {} vs {}.",
+          bytesRead,
+          directLength);
+      offset += directLength;
+      pos += directLength;
+      length -= directLength;
+    }
+    if (length == 0) {
+      return;
+    }
+  }
   auto bytesRead = ::pread(fd_, pos, length, offset);
   VELOX_CHECK_EQ(
       bytesRead,
@@ -144,6 +192,20 @@ uint64_t LocalReadFile::preadv(
   return folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
 }
 
+folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  auto* ioUring = IoUring::instance();
+  if (ioUring == nullptr) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  return ioUring->preadv(fd_, directFd_, offset, buffers);
+}
+
+bool LocalReadFile::hasPreadvAsync() const {
+  return IoUring::instance() != nullptr;
+}
+
 uint64_t LocalReadFile::size() const {
   return size_;
 }
@@ -156,7 +218,9 @@ uint64_t LocalReadFile::memoryUsage() const {
   return sizeof(FILE);
 }
 
-LocalWriteFile::LocalWriteFile(std::string_view path) {
+LocalWriteFile::LocalWriteFile(
+    std::string_view path,
+    memory::MemoryPool* directIoPool) {
   std::unique_ptr<char[]> buf(new char[path.size() + 1]);
   buf[path.size()] = 0;
   memcpy(buf.get(), path.data(), path.size());
@@ -165,6 +229,22 @@ LocalWriteFile::LocalWriteFile(std::string_view path) {
     VELOX_CHECK(
         !exists, "Failure in LocalWriteFile: path '{}' already exists.", path);
   }
+#ifdef O_DIRECT
+  if (directIoPool != nullptr) {
+    // The buffer is allocated first so that a failed allocation leaves no
+    // file behind.
+    auto buffer = std::make_unique<memory::ContiguousAllocation>();
+    directIoPool->allocateContiguous(
+        memory::AllocationTraits::numPages(kDirectWriteBufferSize), *buffer);
+    directFd_ = open(buf.get(), O_WRONLY | O_CREAT | O_EXCL | O_DIRECT, 0644);
+    if (directFd_ >= 0) {
+      directBuffer_ = std::move(buffer);
+      return;
+    }
+    LOG(WARNING) << "O_DIRECT open failure in LocalWriteFile constructor, "
+                 << path << " " << folly::errnoStr(errno);
+  }
+#endif
   auto file = fopen(buf.get(), "ab");
   VELOX_CHECK(
       file,
@@ -186,6 +266,23 @@ LocalWriteFile::~LocalWriteFile() {
 
 void LocalWriteFile::append(std::string_view data) {
   VELOX_CHECK(!closed_, "file is closed");
+  if (directFd_ >= 0) {
+    const auto capacity = directBuffer_->size();
+    while (!data.empty()) {
+      const auto bytes =
+          std::min<uint64_t>(data.size(), capacity - directBufferUsed_);
+      memcpy(
+          directBuffer_->data<char>() + directBufferUsed_, data.data(), bytes);
+      directBufferUsed_ += bytes;
+      data.remove_prefix(bytes);
+      if (directBufferUsed_ == capacity) {
+        writeDirectBuffer();
+        directOffset_ += capacity;
+        directBufferUsed_ = 0;
+      }
+    }
+    return;
+  }
   const uint64_t bytes_written = fwrite(data.data(), 1, data.size(), file_);
   VELOX_CHECK_EQ(
       bytes_written,
@@ -195,8 +292,37 @@ void LocalWriteFile::append(std::string_view data) {
       data.size());
 }
 
+void LocalWriteFile::writeDirectBuffer() {
+  const auto size =
+      bits::roundUp(directBufferUsed_, IoUring::kDirectIoAlignment);
+  auto* data = directBuffer_->data<char>();
+  memset(data + directBufferUsed_, 0, size - directBufferUsed_);
+  const auto written = ::pwrite(directFd_, data, size, directOffset_);
+  VELOX_CHECK_EQ(
+      written,
+      size,
+      "O_DIRECT write failure in LocalWriteFile: {}.",
+      folly::errnoStr(errno));
+}
+
+void LocalWriteFile::flushDirect() {
+  if (directBufferUsed_ > 0) {
+    writeDirectBuffer();
+  }
+  const auto ret = ftruncate(directFd_, size());
+  VELOX_CHECK_EQ(
+      ret,
+      0,
+      "ftruncate failure in LocalWriteFile: {}.",
+      folly::errnoStr(errno));
+}
+
 void LocalWriteFile::flush() {
   VELOX_CHECK(!closed_, "file is closed");
+  if (directFd_ >= 0) {
+    flushDirect();
+    return;
+  }
   auto ret = fflush(file_);
   VELOX_CHECK_EQ(
       ret,
@@ -206,6 +332,15 @@ void LocalWriteFile::flush() {
 }
 
 void LocalWriteFile::close() {
+  if (!closed_ && directFd_ >= 0) {
+    closed_ = true;
+    SCOPE_EXIT {
+      ::close(directFd_);
+      directBuffer_.reset();
+    };
+    flushDirect();
+    return;
+  }
   if (!closed_) {
     auto ret = fclose(file_);
     VELOX_CHECK_EQ(
@@ -218,6 +353,9 @@ void LocalWriteFile::close() {
 }
 
 uint64_t LocalWriteFile::size() const {
+  if (directFd_ >= 0) {
+    return directOffset_ + directBufferUsed_;
+  }
   return ftell(file_);
 }
 } // namespace facebook::velox
@@ -38,6 +38,11 @@
 
 #include "velox/common/base/Exceptions.h"
 
+namespace facebook::velox::memory {
+class ContiguousAllocation;
+class MemoryPool;
+} // namespace facebook::velox::memory
+
 namespace facebook::velox {
 
 // A read-only file.
@@ -203,7 +208,10 @@ class InMemoryWriteFile final : public WriteFile {
 
 class LocalReadFile final : public ReadFile {
  public:
-  explicit LocalReadFile(std::string_view path);
+  // If 'directIo' is true, the file is also opened with O_DIRECT for
+  // preadvAsync() and for the reads of pread() that start at an aligned offset
+  // into an aligned buffer, so that these bypass the page cache.
+  explicit LocalReadFile(std::string_view path, bool directIo = false);
 
   explicit LocalReadFile(int32_t fd);
 
@@ -218,6 +226,13 @@ class LocalReadFile final : public ReadFile {
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  // Reads through io_uring if available. See IoUring.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final;
+
   uint64_t memoryUsage() const final;
 
   bool shouldCoalesce() const final {
@@ -241,13 +256,22 @@ class LocalReadFile final : public ReadFile {
 
   std::string path_;
   int32_t fd_;
+  // Descriptor of the file opened with O_DIRECT. -1 if not opened with
+  // 'directIo' or if the file system does not support O_DIRECT.
+  int32_t directFd_{-1};
   long size_;
 };
 
 class LocalWriteFile final : public WriteFile {
  public:
-  // An error is thrown is a file already exists at |path|.
-  explicit LocalWriteFile(std::string_view path);
+  // An error is thrown is a file already exists at |path|. If 'directIoPool'
+  // is set, the file is written with O_DIRECT from a page aligned buffer
+  // allocated from 'directIoPool', so that the writes bypass the page cache.
+  // The file is written through the page cache if the file system does not
+  // support O_DIRECT.
+  explicit LocalWriteFile(
+      std::string_view path,
+      memory::MemoryPool* FOLLY_NULLABLE directIoPool = nullptr);
   ~LocalWriteFile();
 
   void append(std::string_view data) final;
@@ -255,10 +279,33 @@ class LocalWriteFile final : public WriteFile {
   void close() final;
   uint64_t size() const final;
 
+  // True if the file is written with O_DIRECT.
+  bool directIo() const {
+    return directFd_ >= 0;
+  }
+
  private:
-  FILE* FOLLY_NONNULL file_;
+  // Writes the used part of 'directBuffer_' at 'directOffset_', padded to the
+  // alignment of O_DIRECT.
+  void writeDirectBuffer();
+
+  // Writes the partially filled block of 'directBuffer_' and cuts the padding
+  // off the file. The next appends write the block again.
+  void flushDirect();
+
+  FILE* FOLLY_NULLABLE file_{nullptr};
   mutable long size_;
   bool closed_{false};
+
+  // Descriptor of the file opened with O_DIRECT. -1 if written through
+  // 'file_'.
+  int32_t directFd_{-1};
+  // Buffers the appends for O_DIRECT writes of whole blocks.
+  std::unique_ptr<memory::ContiguousAllocation> directBuffer_;
+  // File offset of the start of 'directBuffer_'.
+  uint64_t directOffset_{0};
+  // Bytes appended to 'directBuffer_'.
+  uint64_t directBufferUsed_{0};
 };
 
 } // namespace facebook::velox
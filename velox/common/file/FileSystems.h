@@ -25,6 +25,9 @@ namespace facebook::velox {
 class Config;
 class ReadFile;
 class WriteFile;
+namespace memory {
+class MemoryPool;
+}
 } // namespace facebook::velox
 
 namespace facebook::velox::filesystems {
@@ -33,6 +36,16 @@ namespace facebook::velox::filesystems {
 /// which can be easily extended to different storage systems.
 struct FileOptions {
   std::unordered_map<std::string, std::string> values;
+
+  /// Pool for the buffers of a file, e.g. the parts of an object store
+  /// upload. A file system that needs one uses an internal pool if null.
+  memory::MemoryPool* pool{nullptr};
+
+  /// If true, a local file is read and written with O_DIRECT where the file
+  /// system supports it, so that the I/O bypasses the page cache. The write
+  /// buffer is allocated from 'pool', without which writes use the page
+  /// cache.
+  bool directIo{false};
 };
 
 /// An abstract FileSystem
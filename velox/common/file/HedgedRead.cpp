@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/HedgedRead.h"
+
+#include <folly/futures/Future.h>
+
+#include <stdexcept>
+
+namespace facebook::velox {
+
+folly::SemiFuture<std::string> hedgedReadAsync(
+    folly::Executor* executor,
+    std::chrono::milliseconds hedgeDelay,
+    std::function<std::string()> read,
+    HedgedReadCounters* counters) {
+  auto keepAlive = folly::getKeepAliveToken(executor);
+  if (hedgeDelay.count() == 0) {
+    return folly::via(keepAlive, std::move(read)).semi();
+  }
+  // Set by the first run to succeed.
+  auto done = std::make_shared<std::atomic<bool>>(false);
+  std::vector<folly::Future<std::string>> attempts;
+  attempts.push_back(folly::via(keepAlive, [read, done]() {
+    auto data = read();
+    *done = true;
+    return data;
+  }));
+  // The hedge is skipped if the first run succeeded within the delay. 'done'
+  // is set before the first run's future is fulfilled, so a skipped hedge
+  // must fail rather than return a value, or collectAnyWithoutException()
+  // could pick it over the first run.
+  attempts.push_back(
+      folly::futures::sleep(hedgeDelay)
+          .via(keepAlive)
+          .thenValue([read, done, counters](auto&& /*unused*/) {
+            if (*done) {
+              return folly::makeFuture<std::string>(
+                  std::runtime_error("Hedged read skipped"));
+            }
+            if (counters) {
+              ++counters->numHedges;
+            }
+            auto data = read();
+            if (!done->exchange(true) && counters) {
+              ++counters->numHedgeWins;
+            }
+            return folly::makeFuture(std::move(data));
+          }));
+  return folly::collectAnyWithoutException(std::move(attempts))
+      .via(keepAlive)
+      .thenValue([](auto indexAndData) {
+        return std::move(indexAndData.second);
+      })
+      .semi();
+}
+
+} // namespace facebook::velox
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/futures/Future.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace facebook::velox {
+
+/// Counts the reads duplicated by hedgedReadAsync() and the number of these
+/// that completed before the original read.
+struct HedgedReadCounters {
+  std::atomic<uint64_t> numHedges{0};
+  std::atomic<uint64_t> numHedgeWins{0};
+};
+
+/// Runs 'read' on 'executor'. If 'hedgeDelay' is non-zero and 'read' has not
+/// completed after 'hedgeDelay', runs 'read' a second time and returns the
+/// result of the first run to succeed. If the first run failed, the second
+/// doubles as a retry. The losing run completes after the result is consumed,
+/// so 'read' must not reference the caller's state. 'counters', if not null,
+/// must outlive both runs.
+folly::SemiFuture<std::string> hedgedReadAsync(
+    folly::Executor* executor,
+    std::chrono::milliseconds hedgeDelay,
+    std::function<std::string()> read,
+    HedgedReadCounters* counters = nullptr);
+
+} // namespace facebook::velox
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/IoUring.h"
+
+#ifdef VELOX_ENABLE_IO_URING
+
+#include <folly/portability/SysUio.h>
+#include <glog/logging.h>
+#include <liburing.h>
+
+#include <mutex>
+#include <thread>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox {
+namespace {
+
+// Destination of the bytes of skipped ranges. Shared by all reads since the
+// content is never looked at.
+char droppedBytes[64 << 10];
+
+// Appends iovecs for 'buffers' to 'iovecs'. Returns the total size.
+uint64_t makeIovecs(
+    const std::vector<folly::Range<char*>>& buffers,
+    std::vector<struct iovec>& iovecs) {
+  uint64_t size = 0;
+  for (auto& range : buffers) {
+    size += range.size();
+    if (range.data()) {
+      iovecs.push_back({range.data(), range.size()});
+      continue;
+    }
+    auto skipSize = range.size();
+    while (skipSize) {
+      auto bytes = std::min<size_t>(sizeof(droppedBytes), skipSize);
+      iovecs.push_back({droppedBytes, bytes});
+      skipSize -= bytes;
+    }
+  }
+  return size;
+}
+
+// Skips the first 'bytes' of 'iovecs'.
+void advanceIovecs(std::vector<struct iovec>& iovecs, uint64_t bytes) {
+  size_t i = 0;
+  for (; i < iovecs.size() && bytes >= iovecs[i].iov_len; ++i) {
+    bytes -= iovecs[i].iov_len;
+  }
+  iovecs.erase(iovecs.begin(), iovecs.begin() + i);
+  if (bytes > 0) {
+    iovecs[0].iov_base = reinterpret_cast<char*>(iovecs[0].iov_base) + bytes;
+    iovecs[0].iov_len -= bytes;
+  }
+}
+
+struct Request {
+  folly::Promise<uint64_t> promise;
+  int32_t fd;
+  uint64_t offset;
+  uint64_t size;
+
+  // The destination if reading with readv.
+  std::vector<struct iovec> iovecs;
+
+  // The destination ranges as given to preadv().
+  std::vector<folly::Range<char*>> buffers;
+
+  // The registered buffer and its index if reading with O_DIRECT. The read
+  // starts at 'directOffset' and the data is copied to 'buffers'.
+  char* fixedBuffer{nullptr};
+  int32_t fixedBufferIndex{-1};
+  uint64_t directOffset{0};
+};
+
+class IoUringImpl : public IoUring {
+ public:
+  IoUringImpl() {
+    auto rc = io_uring_queue_init(kQueueDepth, &ring_, 0);
+    VELOX_CHECK_EQ(rc, 0, "io_uring_queue_init failed: {}", strerror(-rc));
+    fixedBuffers_.resize(kNumFixedBuffers);
+    std::vector<struct iovec> iovecs(kNumFixedBuffers);
+    for (auto i = 0; i < kNumFixedBuffers; ++i) {
+      fixedBuffers_[i] = reinterpret_cast<char*>(
+          std::aligned_alloc(kDirectIoAlignment, kFixedBufferSize));
+      iovecs[i] = {fixedBuffers_[i], kFixedBufferSize};
+      freeFixedBuffers_.push_back(i);
+    }
+    rc = io_uring_register_buffers(&ring_, iovecs.data(), iovecs.size());
+    if (rc != 0) {
+      LOG(WARNING) << "io_uring_register_buffers failed, O_DIRECT reads are "
+                   << "not used: " << strerror(-rc);
+      freeFixedBuffers_.clear();
+    }
+    reaper_ = std::thread([this]() { reap(); });
+  }
+
+  ~IoUringImpl() override {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      // A NOP without a request stops the reaper.
+      auto* sqe = io_uring_get_sqe(&ring_);
+      VELOX_CHECK_NOT_NULL(sqe);
+      io_uring_prep_nop(sqe);
+      io_uring_sqe_set_data(sqe, nullptr);
+      io_uring_submit(&ring_);
+    }
+    reaper_.join();
+    io_uring_queue_exit(&ring_);
+    for (auto* buffer : fixedBuffers_) {
+      std::free(buffer);
+    }
+  }
+
+  folly::SemiFuture<uint64_t> preadv(
+      int32_t fd,
+      int32_t directFd,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) override {
+    auto request = std::make_unique<Request>();
+    request->fd = fd;
+    request->offset = offset;
+    request->size = makeIovecs(buffers, request->iovecs);
+    request->buffers = buffers;
+    auto future = request->promise.getSemiFuture();
+    if (!submit(directFd, request)) {
+      // The ring is full. Reads synchronously to bound the queue.
+      readRemaining(*request, 0);
+    }
+    return future;
+  }
+
+  int32_t numInFlight() const override {
+    std::lock_guard<std::mutex> l(mutex_);
+    return numInFlight_;
+  }
+
+ private:
+  // Submits 'request' and takes ownership of it. Returns false and leaves
+  // 'request' to the caller if 'kQueueDepth' reads are in flight.
+  bool submit(int32_t directFd, std::unique_ptr<Request>& request) {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (numInFlight_ >= kQueueDepth) {
+      return false;
+    }
+    auto* sqe = io_uring_get_sqe(&ring_);
+    VELOX_CHECK_NOT_NULL(sqe);
+    const auto offset = request->offset;
+    if (directFd >= 0 && !freeFixedBuffers_.empty()) {
+      request->directOffset = offset / kDirectIoAlignment * kDirectIoAlignment;
+      const auto directSize = bits::roundUp(
+          offset + request->size - request->directOffset, kDirectIoAlignment);
+      if (directSize <= kFixedBufferSize) {
+        request->fixedBufferIndex = freeFixedBuffers_.back();
+        freeFixedBuffers_.pop_back();
+        request->fixedBuffer = fixedBuffers_[request->fixedBufferIndex];
+        io_uring_prep_read_fixed(
+            sqe,
+            directFd,
+            request->fixedBuffer,
+            directSize,
+            request->directOffset,
+            request->fixedBufferIndex);
+      }
+    }
+    if (request->fixedBuffer == nullptr) {
+      io_uring_prep_readv(
+          sqe,
+          request->fd,
+          request->iovecs.data(),
+          request->iovecs.size(),
+          offset);
+    }
+    io_uring_sqe_set_data(sqe, request.release());
+    const auto rc = io_uring_submit(&ring_);
+    VELOX_CHECK_GE(rc, 0, "io_uring_submit failed: {}", strerror(-rc));
+    ++numInFlight_;
+    return true;
+  }
+
+  void reap() {
+    for (;;) {
+      struct io_uring_cqe* cqe;
+      const auto rc = io_uring_wait_cqe(&ring_, &cqe);
+      if (rc == -EINTR) {
+        continue;
+      }
+      VELOX_CHECK_EQ(rc, 0, "io_uring_wait_cqe failed: {}", strerror(-rc));
+      std::unique_ptr<Request> request(
+          reinterpret_cast<Request*>(io_uring_cqe_get_data(cqe)));
+      const auto result = cqe->res;
+      io_uring_cqe_seen(&ring_, cqe);
+      if (request == nullptr) {
+        return;
+      }
+      complete(*request, result);
+    }
+  }
+
+  void complete(Request& request, int32_t result) {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      --numInFlight_;
+    }
+    if (request.fixedBuffer != nullptr) {
+      const auto start = request.offset - request.directOffset;
+      const bool complete = result >= 0 && start + request.size <= result;
+      if (complete) {
+        auto* source = request.fixedBuffer + start;
+        for (auto& range : request.buffers) {
+          if (range.data()) {
+            ::memcpy(range.data(), source, range.size());
+          }
+          source += range.size();
+        }
+      }
+      {
+        std::lock_guard<std::mutex> l(mutex_);
+        freeFixedBuffers_.push_back(request.fixedBufferIndex);
+      }
+      if (complete) {
+        request.promise.setValue(request.size);
+      } else {
+        // Errors and short reads are retried from the buffered descriptor.
+        readRemaining(request, 0);
+      }
+      return;
+    }
+    if (result < 0) {
+      try {
+        VELOX_FAIL("io_uring read failed: {}", strerror(-result));
+      } catch (const std::exception&) {
+        request.promise.setException(
+            folly::exception_wrapper(std::current_exception()));
+      }
+      return;
+    }
+    readRemaining(request, result);
+  }
+
+  // Reads the bytes of 'request' after the first 'bytesRead' synchronously
+  // and completes its promise.
+  void readRemaining(Request& request, uint64_t bytesRead) {
+    if (bytesRead < request.size) {
+      advanceIovecs(request.iovecs, bytesRead);
+      const auto rc = folly::preadv(
+          request.fd,
+          request.iovecs.data(),
+          request.iovecs.size(),
+          request.offset + bytesRead);
+      if (rc < 0) {
+        try {
+          VELOX_FAIL("preadv failed: {}", folly::errnoStr(errno));
+        } catch (const std::exception&) {
+          request.promise.setException(
+              folly::exception_wrapper(std::current_exception()));
+        }
+        return;
+      }
+      bytesRead += rc;
+    }
+    request.promise.setValue(bytesRead);
+  }
+
+  struct io_uring ring_;
+
+  // Serializes submissions and guards 'numInFlight_' and
+  // 'freeFixedBuffers_'.
+  mutable std::mutex mutex_;
+  int32_t numInFlight_{0};
+
+  std::vector<char*> fixedBuffers_;
+  std::vector<int32_t> freeFixedBuffers_;
+
+  std::thread reaper_;
+};
+
+std::unique_ptr<IoUring> makeIoUring() {
+  try {
+    return std::make_unique<IoUringImpl>();
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "io_uring is not available: " << e.what();
+    return nullptr;
+  }
+}
+} // namespace
+
+// static
+IoUring* IoUring::instance() {
+  static std::unique_ptr<IoUring> instance = makeIoUring();
+  return instance.get();
+}
+
+} // namespace facebook::velox
+
+#else
+
+namespace facebook::velox {
+
+// static
+IoUring* IoUring::instance() {
+  return nullptr;
+}
+
+} // namespace facebook::velox
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/futures/Future.h>
+
+#include <sys/uio.h>
+
+namespace facebook::velox {
+
+/// Process-wide io_uring instance for asynchronous reads of local files.
+/// Reads are submitted from any thread and completed by a single reaper
+/// thread, which fulfills the returned futures. A deep queue of reads thus
+/// needs no executor threads blocked on I/O.
+///
+/// Reads of files opened with O_DIRECT go through a pool of aligned buffers
+/// registered with the ring, from which the requested ranges are copied.
+///
+/// Available only if Velox is built with VELOX_ENABLE_IO_URING and the kernel
+/// supports io_uring. instance() returns nullptr otherwise.
+class IoUring {
+ public:
+  /// Number of submission queue entries. Reads beyond this many in flight
+  /// are done synchronously by the caller.
+  static constexpr int32_t kQueueDepth = 256;
+
+  /// Number and size of the registered buffers for O_DIRECT reads. Larger
+  /// reads or reads when all buffers are in use go to the buffered file
+  /// descriptor.
+  static constexpr int32_t kNumFixedBuffers = 32;
+  static constexpr int32_t kFixedBufferSize = 4 << 20;
+
+  /// Alignment of offsets and sizes of O_DIRECT reads.
+  static constexpr int32_t kDirectIoAlignment = 4096;
+
+  /// Returns the process-wide instance, or nullptr if io_uring is not
+  /// available.
+  static IoUring* instance();
+
+  virtual ~IoUring() = default;
+
+  /// Reads from 'fd' at 'offset' into 'buffers' like ReadFile::preadv(). A
+  /// buffer with nullptr data skips its size worth of bytes. If 'directFd' is
+  /// not -1, it is a descriptor of the same file opened with O_DIRECT, which
+  /// is used if the read fits a registered buffer. 'fd' is used for the rest
+  /// and to complete short reads. The caller keeps the descriptors open and
+  /// 'buffers' alive until the future is complete.
+  virtual folly::SemiFuture<uint64_t> preadv(
+      int32_t fd,
+      int32_t directFd,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) = 0;
+
+  /// Returns the number of reads that are in flight.
+  virtual int32_t numInFlight() const = 0;
+};
+
+} // namespace facebook::velox
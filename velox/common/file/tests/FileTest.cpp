@@ -18,6 +18,8 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/IoUring.h"
+#include "velox/common/memory/Memory.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
@@ -98,6 +100,84 @@ TEST(LocalFile, writeAndRead) {
   readData(&readFile);
 }
 
+TEST(LocalFile, directIo) {
+  auto pool = memory::addDefaultLeafMemoryPool();
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    // Falls back to the page cache if the file system has no O_DIRECT. The
+    // content is the same either way.
+    LocalWriteFile writeFile(filename, pool.get());
+    if (writeFile.directIo()) {
+      ASSERT_LT(0, pool->getCurrentBytes());
+    }
+    writeData(&writeFile);
+    ASSERT_EQ(15 + kOneMB, writeFile.size());
+    writeFile.flush();
+    writeFile.append("e");
+  }
+  ASSERT_EQ(0, pool->getCurrentBytes());
+  LocalReadFile readFile(filename, true);
+  ASSERT_EQ(16 + kOneMB, readFile.size());
+  readData(&readFile, false);
+
+  // An aligned read of whole blocks and a partial block.
+  constexpr int32_t kAlignment = IoUring::kDirectIoAlignment;
+  auto* buffer =
+      static_cast<char*>(std::aligned_alloc(kAlignment, 2 * kAlignment));
+  ASSERT_EQ(
+      readFile.pread(kAlignment, kAlignment + 100, buffer),
+      std::string(kAlignment + 100, 'c'));
+  ASSERT_EQ(readFile.pread(10 + kOneMB, 6, buffer), "ddddde");
+  std::free(buffer);
+}
+
+TEST(LocalFile, preadvAsync) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  for (auto directIo : {false, true}) {
+    SCOPED_TRACE(fmt::format("directIo: {}", directIo));
+    LocalReadFile readFile(filename, directIo);
+    constexpr int32_t kNumReads = 1'000;
+    std::vector<std::string> heads(kNumReads, std::string(12, 0));
+    std::vector<std::string> tails(kNumReads, std::string(7, 0));
+    std::vector<std::vector<folly::Range<char*>>> buffers(kNumReads);
+    std::vector<folly::SemiFuture<uint64_t>> futures;
+    for (auto i = 0; i < kNumReads; ++i) {
+      // Unaligned reads of varying size, skipping the middle.
+      const auto offset = i * 7;
+      buffers[i] = {
+          folly::Range<char*>(heads[i].data(), heads[i].size()),
+          folly::Range<char*>(nullptr, (char*)(uint64_t)(i * 100)),
+          folly::Range<char*>(tails[i].data(), tails[i].size())};
+      futures.push_back(readFile.preadvAsync(offset, buffers[i]));
+    }
+    for (auto i = 0; i < kNumReads; ++i) {
+      const auto offset = i * 7;
+      ASSERT_EQ(std::move(futures[i]).get(), 19 + i * 100);
+      ASSERT_EQ(heads[i], readFile.pread(offset, 12));
+      ASSERT_EQ(tails[i], readFile.pread(offset + 12 + i * 100, 7));
+    }
+
+    // A read to the end of the file.
+    std::string tail(10, 0);
+    ASSERT_EQ(
+        readFile
+            .preadvAsync(
+                5 + kOneMB,
+                {folly::Range<char*>(tail.data(), tail.size())})
+            .get(),
+        10);
+    ASSERT_EQ(tail, "cccccddddd");
+  }
+}
+
 TEST(LocalFile, viaRegistry) {
   filesystems::registerLocalFileSystem();
   auto tempFile = ::exec::test::TempFilePath::create();
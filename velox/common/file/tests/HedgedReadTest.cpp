@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/HedgedRead.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace facebook::velox;
+
+namespace {
+
+constexpr uint64_t kLength = 1000;
+constexpr std::chrono::milliseconds kHedgeDelay{1};
+
+class HedgedReadTest : public testing::Test {
+ protected:
+  folly::CPUThreadPoolExecutor executor_{4};
+};
+
+} // namespace
+
+TEST_F(HedgedReadTest, noHedge) {
+  HedgedReadCounters counters;
+  auto data = hedgedReadAsync(
+                  &executor_,
+                  std::chrono::milliseconds(0),
+                  []() {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    return std::string(kLength, 'a');
+                  },
+                  &counters)
+                  .get();
+  ASSERT_EQ(data, std::string(kLength, 'a'));
+  ASSERT_EQ(counters.numHedges, 0);
+}
+
+TEST_F(HedgedReadTest, hedgeWins) {
+  HedgedReadCounters counters;
+  std::atomic<int32_t> numReads{0};
+  auto data = hedgedReadAsync(
+                  &executor_,
+                  kHedgeDelay,
+                  [&]() {
+                    if (numReads++ == 0) {
+                      std::this_thread::sleep_for(std::chrono::seconds(1));
+                      return std::string(kLength, 'a');
+                    }
+                    return std::string(kLength, 'b');
+                  },
+                  &counters)
+                  .get();
+  ASSERT_EQ(data, std::string(kLength, 'b'));
+  ASSERT_EQ(counters.numHedges, 1);
+  ASSERT_EQ(counters.numHedgeWins, 1);
+  // Waits for the losing read, which references 'numReads'.
+  executor_.join();
+}
+
+TEST_F(HedgedReadTest, hedgeRetriesFailure) {
+  HedgedReadCounters counters;
+  std::atomic<int32_t> numReads{0};
+  auto data = hedgedReadAsync(
+                  &executor_,
+                  kHedgeDelay,
+                  [&]() {
+                    if (numReads++ == 0) {
+                      throw std::runtime_error("read failed");
+                    }
+                    return std::string(kLength, 'b');
+                  },
+                  &counters)
+                  .get();
+  ASSERT_EQ(data, std::string(kLength, 'b'));
+  ASSERT_EQ(counters.numHedges, 1);
+}
+
+TEST_F(HedgedReadTest, bothFail) {
+  auto future = hedgedReadAsync(
+      &executor_, kHedgeDelay, []() -> std::string {
+        throw std::runtime_error("read failed");
+      });
+  EXPECT_THROW(std::move(future).get(), std::runtime_error);
+}
+
+// The first read completes at about the time the hedge is due. The hedge
+// then finds the first read done and is skipped, which must not supply the
+// result.
+TEST_F(HedgedReadTest, primaryCompletesAtHedgeDelay) {
+  HedgedReadCounters counters;
+  for (auto i = 0; i < 200; ++i) {
+    auto data = hedgedReadAsync(
+                    &executor_,
+                    kHedgeDelay,
+                    []() {
+                      std::this_thread::sleep_for(kHedgeDelay);
+                      return std::string(kLength, 'a');
+                    },
+                    &counters)
+                    .get();
+    ASSERT_EQ(data, std::string(kLength, 'a'));
+  }
+  ASSERT_LE(counters.numHedgeWins, counters.numHedges);
+}
@@ -17,7 +17,9 @@
 
 #include <exception>
 #include <sstream>
+#include <xsimd/xsimd.hpp>
 #include "velox/common/base/IOUtils.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/hyperloglog/BiasCorrection.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -569,6 +571,10 @@ void DenseHll::mergeWith(
     const uint16_t* otherOverflowBuckets,
     const int8_t* otherOverflowValues) {
   int8_t newBaseline = std::max(baseline_, otherBaseline);
+  if (overflows_ == 0 && otherOverflows == 0) {
+    mergeDeltas(otherBaseline, otherDeltas, newBaseline);
+    return;
+  }
   int32_t baselineCount = 0;
 
   int bucket = 0;
@@ -655,4 +661,69 @@ void DenseHll::removeOverflow(int overflowEntry) {
   overflowValues_[overflowEntry] = overflowValues_[overflows_ - 1];
   overflows_--;
 }
+void DenseHll::mergeDeltas(
+    int8_t otherBaseline,
+    const int8_t* otherDeltas,
+    int8_t newBaseline) {
+  // Without overflows the value of a bucket is baseline + delta. The new delta
+  // is the max of the deltas of both sides, each reduced by the increase of
+  // its baseline. This is at most kMaxDelta, so no overflows are created. The
+  // side with the larger baseline is not reduced, so the saturating
+  // subtraction on the other side gives the same max as a signed one.
+  const uint8_t shift = newBaseline - baseline_;
+  const uint8_t otherShift = newBaseline - otherBaseline;
+  auto* deltas = reinterpret_cast<uint8_t*>(deltas_.data());
+  auto* other = reinterpret_cast<const uint8_t*>(otherDeltas);
+  const int32_t size = deltas_.size();
+  int32_t baselineCount = 0;
+  int32_t i = 0;
+
+  using Batch = xsimd::batch<uint8_t>;
+  const auto mask = Batch::broadcast(kBucketMask);
+  const auto shifts = Batch::broadcast(shift);
+  const auto otherShifts = Batch::broadcast(otherShift);
+  const auto zero = Batch::broadcast(0);
+  auto highBuckets = [&](Batch slots) {
+    return xsimd::bitwise_cast<uint8_t>(
+               xsimd::bitwise_cast<uint16_t>(slots) >> kBitsPerBucket) &
+        mask;
+  };
+  for (; i + Batch::size <= size; i += Batch::size) {
+    auto slots = Batch::load_unaligned(deltas + i);
+    auto otherSlots = Batch::load_unaligned(other + i);
+    auto low = xsimd::max(
+        xsimd::ssub(slots & mask, shifts),
+        xsimd::ssub(otherSlots & mask, otherShifts));
+    auto high = xsimd::max(
+        xsimd::ssub(highBuckets(slots), shifts),
+        xsimd::ssub(highBuckets(otherSlots), otherShifts));
+    baselineCount += __builtin_popcount(simd::toBitMask(low == zero)) +
+        __builtin_popcount(simd::toBitMask(high == zero));
+    // Each byte of 'high' is at most kMaxDelta, so the 16 bit shift does not
+    // carry into the next byte.
+    auto merged = xsimd::bitwise_cast<uint8_t>(
+                      xsimd::bitwise_cast<uint16_t>(high) << kBitsPerBucket) |
+        low;
+    merged.store_unaligned(deltas + i);
+  }
+
+  auto mergeBucket = [&](uint8_t delta, uint8_t otherDelta) -> uint8_t {
+    uint8_t newDelta = std::max(
+        delta > shift ? delta - shift : 0,
+        otherDelta > otherShift ? otherDelta - otherShift : 0);
+    baselineCount += newDelta == 0;
+    return newDelta;
+  };
+  for (; i < size; ++i) {
+    auto low = mergeBucket(deltas[i] & kBucketMask, other[i] & kBucketMask);
+    auto high =
+        mergeBucket(deltas[i] >> kBitsPerBucket, other[i] >> kBitsPerBucket);
+    deltas[i] = (high << kBitsPerBucket) | low;
+  }
+
+  baseline_ = newBaseline;
+  baselineCount_ = baselineCount;
+  adjustBaselineIfNeeded();
+}
+
 } // namespace facebook::velox::common::hll
@@ -116,6 +116,13 @@ class DenseHll {
       const uint16_t* otherOverflowBuckets,
       const int8_t* otherOverflowValues);
 
+  /// mergeWith() for the case where neither HLL has overflows. Merges the
+  /// deltas a SIMD batch at a time.
+  void mergeDeltas(
+      int8_t otherBaseline,
+      const int8_t* otherDeltas,
+      int8_t newBaseline);
+
   /// Number of first bits of the hash to calculate buckets from.
   int8_t indexBitLength_;
 
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/common/hyperloglog/DenseHll.h"
+
+/// Measures merging of dense HLLs, as done by the final aggregation of
+/// approx_distinct and by merge(hyperloglog), with in-memory and serialized
+/// inputs.
+
+using namespace facebook::velox;
+using namespace facebook::velox::common::hll;
+
+namespace {
+
+class DenseHllBenchmark {
+ public:
+  explicit DenseHllBenchmark(int8_t indexBitLength)
+      : indexBitLength_{indexBitLength} {
+    folly::Random::DefaultGenerator rng(1);
+    for (auto i = 0; i < kNumHlls; ++i) {
+      hlls_.emplace_back(indexBitLength_, &allocator_);
+      for (auto j = 0; j < kNumHashes; ++j) {
+        hlls_.back().insertHash(folly::Random::rand64(rng));
+      }
+      serialized_.emplace_back(hlls_.back().serializedSize(), '\0');
+      hlls_.back().serialize(serialized_.back().data());
+    }
+  }
+
+  int64_t merge() {
+    DenseHll result(indexBitLength_, &allocator_);
+    for (const auto& hll : hlls_) {
+      result.mergeWith(hll);
+    }
+    return result.cardinality();
+  }
+
+  int64_t mergeSerialized() {
+    DenseHll result(indexBitLength_, &allocator_);
+    for (const auto& serialized : serialized_) {
+      result.mergeWith(serialized.data());
+    }
+    return result.cardinality();
+  }
+
+ private:
+  static constexpr int32_t kNumHlls = 100;
+  static constexpr int32_t kNumHashes = 20'000;
+
+  const int8_t indexBitLength_;
+  std::shared_ptr<memory::MemoryPool> pool_{memory::addDefaultLeafMemoryPool()};
+  HashStringAllocator allocator_{pool_.get()};
+  std::vector<DenseHll> hlls_;
+  std::vector<std::string> serialized_;
+};
+
+std::unique_ptr<DenseHllBenchmark> bm12;
+std::unique_ptr<DenseHllBenchmark> bm16;
+
+BENCHMARK(merge12) {
+  folly::doNotOptimizeAway(bm12->merge());
+}
+
+BENCHMARK_RELATIVE(mergeSerialized12) {
+  folly::doNotOptimizeAway(bm12->mergeSerialized());
+}
+
+BENCHMARK(merge16) {
+  folly::doNotOptimizeAway(bm16->merge());
+}
+
+BENCHMARK_RELATIVE(mergeSerialized16) {
+  folly::doNotOptimizeAway(bm16->mergeSerialized());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  bm12 = std::make_unique<DenseHllBenchmark>(12);
+  bm16 = std::make_unique<DenseHllBenchmark>(16);
+  folly::runBenchmarks();
+  bm12.reset();
+  bm16.reset();
+  return 0;
+}
@@ -32,6 +32,9 @@ struct AllocationTraits {
   /// Defines a machine page size in bytes.
   static constexpr uint64_t kPageSize = 4096;
 
+  /// Defines a transparent huge page size in bytes.
+  static constexpr uint64_t kHugePageSize = 2 << 20;
+
   /// Returns the bytes of the given number pages.
   FOLLY_ALWAYS_INLINE static uint64_t pageBytes(MachinePageCount numPages) {
     return numPages * kPageSize;
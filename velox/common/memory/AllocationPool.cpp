@@ -73,6 +73,14 @@ char* AllocationPool::allocateFixed(uint64_t bytes, int32_t alignment) {
   return result;
 }
 
+void AllocationPool::freeSmallAllocations(std::vector<int32_t> indices) {
+  std::sort(indices.begin(), indices.end(), std::greater<int32_t>());
+  for (auto index : indices) {
+    VELOX_CHECK_LT(index, allocations_.size());
+    allocations_.erase(allocations_.begin() + index);
+  }
+}
+
 void AllocationPool::newRunImpl(memory::MachinePageCount numPages) {
   ++currentRun_;
   if (currentRun_ >= allocation_.numRuns()) {
@@ -60,6 +60,11 @@ class AllocationPool {
                                         : allocations_[index].get();
   }
 
+  // Frees the small allocations at 'indices'. These must be below
+  // numSmallAllocations() - 1, i.e. not the allocation the current run is
+  // in. The allocations after a freed one move down in index.
+  void freeSmallAllocations(std::vector<int32_t> indices);
+
   const memory::ContiguousAllocation* largeAllocationAt(int32_t index) const {
     return largeAllocations_[index].get();
   }
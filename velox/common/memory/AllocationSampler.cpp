@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/AllocationSampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <fmt/format.h>
+#include <folly/FileUtil.h>
+#include <folly/Random.h>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/process/StackTrace.h"
+
+namespace facebook::velox::memory {
+
+thread_local AllocationSampler::Countdown AllocationSampler::countdown_;
+
+AllocationSampler::AllocationSampler(uint64_t sampleBytes)
+    : sampleBytes_(sampleBytes) {
+  VELOX_CHECK_GT(sampleBytes_, 0);
+}
+
+uint64_t AllocationSampler::nextSampleBytes() const {
+  if (sampleBytes_ == 1) {
+    return 0;
+  }
+  // 1 - randDouble01() is in (0, 1].
+  const double uniform = 1 - folly::Random::randDouble01();
+  return static_cast<uint64_t>(-std::log(uniform) * sampleBytes_);
+}
+
+void AllocationSampler::recordAllocation(
+    const std::string& poolName,
+    const void* p,
+    int64_t bytes) {
+  // Skips the frame of this function.
+  process::StackTrace trace(1);
+  const auto& frames = trace.getStack();
+  const auto numFrames =
+      std::min<size_t>(frames.size(), AllocationSampler::kMaxFrames);
+
+  std::string key = poolName;
+  key.push_back('\0');
+  key.append(
+      reinterpret_cast<const char*>(frames.data()),
+      numFrames * sizeof(void*));
+
+  Site* site;
+  {
+    std::lock_guard<std::mutex> l(sitesMutex_);
+    auto it = sites_.find(key);
+    if (it == sites_.end()) {
+      it = sites_.emplace(std::move(key), Site{}).first;
+      it->second.poolName = poolName;
+      it->second.stack.assign(frames.begin(), frames.begin() + numFrames);
+    }
+    site = &it->second;
+    ++site->allocCount;
+    site->allocBytes += bytes;
+    ++site->liveCount;
+    site->liveBytes += bytes;
+  }
+
+  auto& shard = liveShard(p);
+  std::lock_guard<std::mutex> l(shard.mutex);
+  shard.allocations[p] = Live{site, bytes};
+}
+
+void AllocationSampler::recordFree(const void* p) {
+  Live live;
+  {
+    auto& shard = liveShard(p);
+    std::lock_guard<std::mutex> l(shard.mutex);
+    auto it = shard.allocations.find(p);
+    if (it == shard.allocations.end()) {
+      return;
+    }
+    live = it->second;
+    shard.allocations.erase(it);
+  }
+  std::lock_guard<std::mutex> l(sitesMutex_);
+  --live.site->liveCount;
+  live.site->liveBytes -= live.bytes;
+}
+
+std::vector<AllocationSampler::Site> AllocationSampler::sites() const {
+  std::vector<Site> result;
+  std::lock_guard<std::mutex> l(sitesMutex_);
+  result.reserve(sites_.size());
+  for (const auto& [key, site] : sites_) {
+    result.push_back(site);
+  }
+  return result;
+}
+
+std::string AllocationSampler::pprofProfile() const {
+  const auto allSites = sites();
+  Site total;
+  for (const auto& site : allSites) {
+    total.allocCount += site.allocCount;
+    total.allocBytes += site.allocBytes;
+    total.liveCount += site.liveCount;
+    total.liveBytes += site.liveBytes;
+  }
+  std::string profile = fmt::format(
+      "heap profile: {}: {} [{}: {}] @ heap_v2/{}\n",
+      total.liveCount,
+      total.liveBytes,
+      total.allocCount,
+      total.allocBytes,
+      sampleBytes_);
+  for (const auto& site : allSites) {
+    profile += fmt::format(
+        "{}: {} [{}: {}] @",
+        site.liveCount,
+        site.liveBytes,
+        site.allocCount,
+        site.allocBytes);
+    for (auto* frame : site.stack) {
+      profile += fmt::format(" {}", frame);
+    }
+    profile += '\n';
+  }
+  std::string maps;
+  if (folly::readFile("/proc/self/maps", maps)) {
+    profile += "\nMAPPED_LIBRARIES:\n";
+    profile += maps;
+  }
+  return profile;
+}
+
+std::string AllocationSampler::toString(int32_t maxSites) const {
+  auto allSites = sites();
+  std::sort(
+      allSites.begin(), allSites.end(), [](const Site& a, const Site& b) {
+        return a.liveBytes > b.liveBytes;
+      });
+  std::string result = fmt::format(
+      "AllocationSampler[sampleBytes {}, {} sites]\n",
+      sampleBytes_,
+      allSites.size());
+  const auto numSites =
+      std::min<size_t>(allSites.size(), std::max<int32_t>(maxSites, 0));
+  for (auto i = 0; i < numSites; ++i) {
+    const auto& site = allSites[i];
+    result += fmt::format(
+        "{}: {} bytes in use in {} sampled allocations, {} bytes allocated "
+        "in {}\n",
+        site.poolName,
+        site.liveBytes,
+        site.liveCount,
+        site.allocBytes,
+        site.allocCount);
+    for (auto* frame : site.stack) {
+      result += fmt::format(
+          "    {}\n", process::StackTrace::translateFrame(frame, false));
+    }
+  }
+  return result;
+}
+
+} // namespace facebook::velox::memory
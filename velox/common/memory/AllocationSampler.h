@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <folly/Likely.h>
+#include <folly/container/F14Map.h>
+
+namespace facebook::velox::memory {
+
+/// Samples the allocations of the memory pools that share it and records the
+/// pool and the call stack of each sampled allocation, aggregated by
+/// allocation site. On average one allocation per 'sampleBytes' allocated
+/// bytes is sampled, as in tcmalloc, so that a site is sampled in proportion
+/// to the bytes it allocates. A sampled allocation is tracked until it is
+/// freed, so that the bytes in use can be told apart from the bytes
+/// allocated.
+///
+/// A task's memory pool tree shares one sampler if the
+/// 'memory_profile_sample_bytes' query config is set. The unsampled
+/// allocations take a thread local countdown and the frees of unsampled
+/// allocations take a lookup in a sharded map.
+///
+/// Thread-safe.
+class AllocationSampler {
+ public:
+  /// The maximum number of frames of the call stack of a sampled allocation.
+  static constexpr int32_t kMaxFrames = 32;
+
+  /// The samples of the allocations of a pool from one call stack.
+  struct Site {
+    std::string poolName;
+    std::vector<void*> stack;
+
+    uint64_t allocCount{0};
+    uint64_t allocBytes{0};
+
+    /// The sampled allocations that are not freed yet.
+    uint64_t liveCount{0};
+    uint64_t liveBytes{0};
+  };
+
+  explicit AllocationSampler(uint64_t sampleBytes);
+
+  uint64_t sampleBytes() const {
+    return sampleBytes_;
+  }
+
+  /// Returns true if an allocation of 'bytes' is to be sampled. Called for
+  /// each allocation.
+  bool shouldSample(uint64_t bytes) {
+    auto& countdown = countdown_;
+    if (FOLLY_UNLIKELY(countdown.sampler != this)) {
+      countdown.sampler = this;
+      countdown.bytes = nextSampleBytes();
+    }
+    if (countdown.bytes > bytes) {
+      countdown.bytes -= bytes;
+      return false;
+    }
+    countdown.bytes = nextSampleBytes();
+    return true;
+  }
+
+  /// Records a sampled allocation of 'bytes' at 'p' from the pool named
+  /// 'poolName' with the call stack of the caller.
+  void
+  recordAllocation(const std::string& poolName, const void* p, int64_t bytes);
+
+  /// Records the free of the allocation at 'p'. No-op if it is not sampled.
+  void recordFree(const void* p);
+
+  /// Returns the sites with sampled allocations.
+  std::vector<Site> sites() const;
+
+  /// Returns the sampled allocations as a heap profile in the legacy text
+  /// format of gperftools, which 'pprof' reads. The profile has the sampled
+  /// counts and bytes in use and allocated of each call stack, followed by
+  /// the mappings of the process to symbolize the addresses.
+  std::string pprofProfile() const;
+
+  /// Returns the 'maxSites' sites with the most bytes in use with their pool
+  /// names and symbolized call stacks.
+  std::string toString(int32_t maxSites = 10) const;
+
+ private:
+  static constexpr int32_t kNumLiveShards = 16;
+
+  struct Countdown {
+    const AllocationSampler* sampler{nullptr};
+    uint64_t bytes{0};
+  };
+
+  struct Live {
+    Site* site;
+    int64_t bytes;
+  };
+
+  struct LiveShard {
+    std::mutex mutex;
+    folly::F14FastMap<const void*, Live> allocations;
+  };
+
+  // Returns the bytes to allocate before the next sample, which are
+  // exponentially distributed with a mean of 'sampleBytes_'. Returns 0 if
+  // 'sampleBytes_' is 1 so that all the allocations are sampled.
+  uint64_t nextSampleBytes() const;
+
+  LiveShard& liveShard(const void* p) {
+    return liveShards_[(reinterpret_cast<uintptr_t>(p) >> 4) % kNumLiveShards];
+  }
+
+  // The countdown of the calling thread to its next sample.
+  static thread_local Countdown countdown_;
+
+  const uint64_t sampleBytes_;
+
+  std::array<LiveShard, kNumLiveShards> liveShards_;
+
+  // Protects 'sites_' and the counters of its sites.
+  mutable std::mutex sitesMutex_;
+  // The sites keyed on the pool name followed by the frame addresses.
+  folly::F14NodeMap<std::string, Site> sites_;
+};
+
+} // namespace facebook::velox::memory
@@ -254,6 +254,21 @@ class ByteStream {
         reinterpret_cast<char*>(current_->buffer) + position, viewSize);
   }
 
+  // Returns a pointer to the next 'size' bytes of input if they are in a
+  // single range, otherwise nullptr. Does not change the read position.
+  const uint8_t* peekContiguous(int32_t size) const {
+    const ByteRange* range = current_;
+    auto position = range->position;
+    if (position == range->size && range != &ranges_.back()) {
+      ++range;
+      position = 0;
+    }
+    if (range->size - position < size) {
+      return nullptr;
+    }
+    return range->buffer + position;
+  }
+
   void skip(int32_t size) {
     for (;;) {
       int32_t available = current_->size - current_->position;
@@ -290,13 +290,20 @@ void HashStringAllocator::free(Header* _header) {
       header->clearContinued();
     }
     VELOX_CHECK(!header->isFree());
-    freeBytes_ += header->size() + sizeof(Header);
+    // The free blocks in slabs being evacuated are kept apart until the end
+    // of the compaction.
+    const bool evacuated =
+        !evacuatedSlabs_.empty() && evacuatedSlab(header) != nullptr;
+    auto& freeList = evacuated ? evacuatedFree_ : free_;
+    auto& numFree = evacuated ? numEvacuatedFree_ : numFree_;
+    auto& freeBytes = evacuated ? evacuatedFreeBytes_ : freeBytes_;
+    freeBytes += header->size() + sizeof(Header);
     cumulativeBytes_ -= header->size();
     Header* next = header->next();
     if (next) {
       VELOX_CHECK(!next->isPreviousFree());
       if (next->isFree()) {
-        --numFree_;
+        --numFree;
         removeFromFreeList(next);
         header->setSize(header->size() + next->size() + sizeof(Header));
         next = reinterpret_cast<Header*>(header->end());
@@ -309,14 +316,118 @@ void HashStringAllocator::free(Header* _header) {
           previousFree->size() + header->size() + sizeof(Header));
       header = previousFree;
     } else {
-      ++numFree_;
-      free_.insert(reinterpret_cast<CompactDoubleList*>(header->begin()));
+      ++numFree;
+      freeList.insert(reinterpret_cast<CompactDoubleList*>(header->begin()));
     }
     markAsFree(header);
     header = continued;
   } while (header);
 }
 
+int32_t HashStringAllocator::startCompaction(double minSlabFreeRatio) {
+  VELOX_CHECK(
+      !currentHeader_, "Do not call startCompaction() during a write");
+  VELOX_CHECK(evacuatedSlabs_.empty(), "Compaction is already in progress");
+  // The last slab is the current run of 'pool_' which cannot be released.
+  for (auto i = 0; i < pool_.numSmallAllocations() - 1; ++i) {
+    auto allocation = pool_.allocationAt(i);
+    if (allocation->numRuns() != 1) {
+      continue;
+    }
+    auto run = allocation->runAt(0);
+    uint64_t slabFreeBytes = 0;
+    for (auto header = run.data<Header>(); header != nullptr;
+         header = header->next()) {
+      if (header->isFree()) {
+        slabFreeBytes += header->size() + sizeof(Header);
+      }
+    }
+    if (slabFreeBytes >= minSlabFreeRatio * run.numBytes()) {
+      evacuatedSlabs_.push_back(
+          {i, run.data<char>(), run.data<char>() + run.numBytes()});
+    }
+  }
+  if (evacuatedSlabs_.empty()) {
+    return 0;
+  }
+
+  for (auto* item = free_.next(); item != &free_;) {
+    auto* next = item->next();
+    auto header = headerOf(item);
+    if (evacuatedSlab(header) != nullptr) {
+      const auto bytes = header->size() + sizeof(Header);
+      item->remove();
+      --numFree_;
+      freeBytes_ -= bytes;
+      evacuatedFree_.insert(item);
+      ++numEvacuatedFree_;
+      evacuatedFreeBytes_ += bytes;
+    }
+    item = next;
+  }
+  return evacuatedSlabs_.size();
+}
+
+HashStringAllocator::Header* HashStringAllocator::relocate(Header* header) {
+  if (evacuatedSlabs_.empty()) {
+    return header;
+  }
+  VELOX_CHECK(!currentHeader_, "Do not call relocate() during a write");
+  int64_t size = 0;
+  bool evacuated = false;
+  for (auto part = header;; part = getNextContinued(part)) {
+    evacuated |= evacuatedSlab(part) != nullptr;
+    if (!part->isContinued()) {
+      size += part->size();
+      break;
+    }
+    size += part->size() - sizeof(void*);
+  }
+  if (!evacuated) {
+    return header;
+  }
+
+  auto newHeader = allocate(std::max<int32_t>(size, kMinAlloc), true);
+  auto copy = newHeader->begin();
+  for (auto part = header;; part = getNextContinued(part)) {
+    const bool continued = part->isContinued();
+    const auto bytes = part->size() - (continued ? sizeof(void*) : 0);
+    memcpy(copy, part->begin(), bytes);
+    copy += bytes;
+    if (!continued) {
+      break;
+    }
+  }
+  free(header);
+  return newHeader;
+}
+
+int64_t HashStringAllocator::finishCompaction() {
+  std::vector<int32_t> emptySlabs;
+  while (!evacuatedFree_.empty()) {
+    auto* item = evacuatedFree_.next();
+    auto header = headerOf(item);
+    item->remove();
+    auto slab = evacuatedSlab(header);
+    VELOX_CHECK_NOT_NULL(slab);
+    if (reinterpret_cast<char*>(header) == slab->begin && !header->next()) {
+      // The free block covers the whole slab.
+      emptySlabs.push_back(slab->index);
+    } else {
+      free_.insert(item);
+      ++numFree_;
+      freeBytes_ += header->size() + sizeof(Header);
+    }
+  }
+  numEvacuatedFree_ = 0;
+  evacuatedFreeBytes_ = 0;
+  evacuatedSlabs_.clear();
+
+  const auto retained = pool_.allocatedBytes();
+  pool_.freeSmallAllocations(emptySlabs);
+  return retained - pool_.allocatedBytes();
+}
+
 //  static
 int64_t HashStringAllocator::offset(
     Header* FOLLY_NONNULL header,
@@ -437,8 +548,8 @@ void HashStringAllocator::checkConsistency() const {
       header = reinterpret_cast<Header*>(header->end());
     }
   }
-  VELOX_CHECK_EQ(numFree, numFree_);
-  VELOX_CHECK_EQ(freeBytes, freeBytes_);
+  VELOX_CHECK_EQ(numFree, numFree_ + numEvacuatedFree_);
+  VELOX_CHECK_EQ(freeBytes, freeBytes_ + evacuatedFreeBytes_);
   uint64_t numInFreeList = 0;
   uint64_t bytesInFreeList = 0;
   for (auto free = free_.next(); free != &free_; free = free->next()) {
@@ -447,6 +558,15 @@ void HashStringAllocator::checkConsistency() const {
   }
   VELOX_CHECK_EQ(numInFreeList, numFree_);
   VELOX_CHECK_EQ(bytesInFreeList, freeBytes_);
+  uint64_t numInEvacuatedList = 0;
+  uint64_t bytesInEvacuatedList = 0;
+  for (auto free = evacuatedFree_.next(); free != &evacuatedFree_;
+       free = free->next()) {
+    ++numInEvacuatedList;
+    bytesInEvacuatedList += headerOf(free)->size() + sizeof(Header);
+  }
+  VELOX_CHECK_EQ(numInEvacuatedList, numEvacuatedFree_);
+  VELOX_CHECK_EQ(bytesInEvacuatedList, evacuatedFreeBytes_);
 }
 
 } // namespace facebook::velox
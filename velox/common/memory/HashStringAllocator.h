@@ -262,11 +262,45 @@ class HashStringAllocator : public StreamArena {
     return minFree;
   }
 
+  // Returns the fraction of retainedSize() which is in free blocks.
+  double freeRatio() const {
+    const auto retained = retainedSize();
+    return retained == 0 ? 0 : static_cast<double>(freeBytes_) / retained;
+  }
+
+  // Starts a compaction pass. Marks the slabs which have at least
+  // 'minSlabFreeRatio' of their bytes in free blocks for evacuation and
+  // takes their free blocks off the free list, so that no allocation is
+  // placed in them until finishCompaction(). The owners of the live
+  // allocations then move these with relocate(). Returns the number of
+  // slabs marked for evacuation.
+  int32_t startCompaction(double minSlabFreeRatio);
+
+  // Moves the allocation starting at 'header', including its continuation
+  // blocks, to a single contiguous block outside of the slabs being
+  // evacuated if any of its blocks is in one of these. The new block has the
+  // same number of payload bytes, so that positions keep their offset from
+  // the beginning, see offset() and seek(). Frees the old blocks. Returns the
+  // header of the new block or 'header' if the allocation was not moved.
+  // 'header' must be the start of an allocation, e.g. from allocate() or
+  // newWrite().
+  Header* FOLLY_NONNULL relocate(Header* FOLLY_NONNULL header);
+
+  // Ends a compaction pass started by startCompaction(). Returns the
+  // evacuated slabs which have become entirely free to the memory pool and
+  // makes the free blocks of the others available for allocation again.
+  // Returns the number of bytes returned to the memory pool.
+  int64_t finishCompaction();
+
   // Frees all memory associated with 'this' and leaves 'this' ready for reuse.
   void clear() {
     numFree_ = 0;
     freeBytes_ = 0;
     new (&free_) CompactDoubleList();
+    numEvacuatedFree_ = 0;
+    evacuatedFreeBytes_ = 0;
+    new (&evacuatedFree_) CompactDoubleList();
+    evacuatedSlabs_.clear();
     pool_.clear();
   }
 
@@ -321,6 +355,27 @@ class HashStringAllocator : public StreamArena {
   // blocks would be below minimum size.
   void freeRestOfBlock(Header* FOLLY_NONNULL header, int32_t keepBytes);
 
+  // A slab being evacuated by a compaction pass.
+  struct EvacuatedSlab {
+    // Index of the slab's allocation in 'pool_'.
+    int32_t index;
+    const char* FOLLY_NONNULL begin;
+    const char* FOLLY_NONNULL end;
+  };
+
+  // Returns the slab being evacuated which contains 'header' or nullptr if
+  // 'header' is not in such a slab.
+  const EvacuatedSlab* FOLLY_NULLABLE
+  evacuatedSlab(const Header* FOLLY_NONNULL header) const {
+    const auto* address = reinterpret_cast<const char*>(header);
+    for (const auto& slab : evacuatedSlabs_) {
+      if (address >= slab.begin && address < slab.end) {
+        return &slab;
+      }
+    }
+    return nullptr;
+  }
+
   // Circular list of free blocks.
   CompactDoubleList free_;
 
@@ -336,6 +391,16 @@ class HashStringAllocator : public StreamArena {
   // the row by row space usage in a RowContainer.
   uint64_t cumulativeBytes_{0};
 
+  // The slabs being evacuated by a compaction pass. Empty if no compaction is
+  // in progress.
+  std::vector<EvacuatedSlab> evacuatedSlabs_;
+
+  // Circular list of the free blocks in 'evacuatedSlabs_'. These are not
+  // counted in 'numFree_' and 'freeBytes_' and are not used for allocation.
+  CompactDoubleList evacuatedFree_;
+  uint64_t numEvacuatedFree_ = 0;
+  uint64_t evacuatedFreeBytes_ = 0;
+
   // Pointer to Header for the range being written. nullptr if a write is not in
   // progress.
   Header* FOLLY_NULLABLE currentHeader_ = nullptr;
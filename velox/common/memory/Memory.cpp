@@ -36,6 +36,14 @@ constexpr folly::StringPiece kDefaultLeafName("__default_leaf__");
 MemoryManager::MemoryManager(const Options& options)
     : allocator_{options.allocator->shared_from_this()},
       memoryQuota_{options.capacity},
+      arbitrator_(
+          options.arbitratorKind == MemoryArbitrator::Kind::kFixed
+              ? nullptr
+              : MemoryArbitrator::create(
+                    {.kind = options.arbitratorKind,
+                     .capacity = options.capacity,
+                     .memoryPoolInitCapacity =
+                         options.memoryPoolInitCapacity})),
       alignment_(std::max(MemoryAllocator::kMinAlignment, options.alignment)),
       checkUsageLeak_(options.checkUsageLeak),
       poolDestructionCb_([&](MemoryPool* pool) { dropPool(pool); }),
@@ -96,9 +104,11 @@ std::shared_ptr<MemoryPool> MemoryManager::addRootPool(
     poolName = fmt::format("default_root_{}", poolId++);
   }
 
+  const bool arbitrated = (arbitrator_ != nullptr) && trackUsage;
   MemoryPool::Options options;
   options.alignment = alignment_;
-  options.capacity = maxBytes;
+  options.capacity =
+      arbitrated ? arbitrator_->reserveMemory(maxBytes) : maxBytes;
   options.trackUsage = trackUsage;
   options.reclaimer = std::move(reclaimer);
   auto pool = std::make_shared<MemoryPoolImpl>(
@@ -108,11 +118,39 @@ std::shared_ptr<MemoryPool> MemoryManager::addRootPool(
       nullptr,
       poolDestructionCb_,
       options);
+  if (arbitrated) {
+    pool->getMemoryUsageTracker()->setGrowCallback(
+        [this, poolPtr = pool.get(), maxBytes](
+            int64_t size, MemoryUsageTracker& /*unused*/) {
+          return growPool(poolPtr, maxBytes, size);
+        });
+  }
   folly::SharedMutex::WriteHolder guard{mutex_};
   pools_.push_back(pool.get());
   return pool;
 }
 
+bool MemoryManager::growPool(
+    MemoryPool* pool,
+    int64_t maxBytes,
+    int64_t incrementBytes) {
+  VELOX_CHECK_NOT_NULL(arbitrator_);
+  VELOX_CHECK_GT(incrementBytes, 0);
+  if (incrementBytes > maxBytes - pool->getMemoryUsageTracker()->maxMemory()) {
+    return false;
+  }
+  try {
+    // NOTE: the read lock keeps the candidate pools alive during the memory
+    // arbitration.
+    folly::SharedMutex::ReadHolder guard{mutex_};
+    return arbitrator_->growMemory(pool, pools_, incrementBytes);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Memory arbitration for " << pool->name()
+               << " failed: " << e.what();
+    return false;
+  }
+}
+
 std::shared_ptr<MemoryPool> MemoryManager::addLeafPool(
     const std::string& name,
     bool threadSafe,
@@ -127,6 +165,9 @@ std::shared_ptr<MemoryPool> MemoryManager::addLeafPool(
 
 void MemoryManager::dropPool(MemoryPool* pool) {
   VELOX_CHECK_NOT_NULL(pool);
+  if (arbitrator_ != nullptr) {
+    arbitrator_->releaseMemory(pool);
+  }
   folly::SharedMutex::WriteHolder guard{mutex_};
   auto it = pools_.begin();
   while (it != pools_.end()) {
@@ -184,6 +225,9 @@ std::string MemoryManager::toString() const {
   for (const auto* pool : pools_) {
     out << "\t" << pool->name() << "\n";
   }
+  if (arbitrator_ != nullptr) {
+    out << arbitrator_->toString() << "\n";
+  }
   out << "]";
   return out.str();
 }
@@ -80,6 +80,17 @@ class IMemoryManager {
 
     /// Specifies the backing memory allocator.
     MemoryAllocator* allocator{MemoryAllocator::getInstance()};
+
+    /// Specifies the kind of memory arbitrator used to arbitrate 'capacity'
+    /// among the root memory pools. With kFixed, each root memory pool keeps
+    /// the fixed capacity set on creation and fails an allocation beyond it.
+    /// With kShared, a root memory pool starts with 'memoryPoolInitCapacity'
+    /// and grows on demand by reclaiming memory from the other root pools.
+    MemoryArbitrator::Kind arbitratorKind{MemoryArbitrator::Kind::kFixed};
+
+    /// The initial memory capacity in bytes reserved for a newly created root
+    /// memory pool if 'arbitratorKind' is kShared.
+    int64_t memoryPoolInitCapacity{256 << 20};
   };
 
   virtual ~IMemoryManager() = default;
@@ -200,6 +211,12 @@ class MemoryManager final : public IMemoryManager {
 
   MemoryAllocator& getAllocator();
 
+  /// Returns the memory arbitrator of this memory manager, or null if the root
+  /// memory pools have fixed capacity.
+  MemoryArbitrator* arbitrator() const {
+    return arbitrator_.get();
+  }
+
   /// Returns the memory manger's internal default root memory pool for testing
   /// purpose.
   MemoryPool& testingDefaultRoot() const {
@@ -209,8 +226,15 @@ class MemoryManager final : public IMemoryManager {
  private:
   void dropPool(MemoryPool* pool);
 
+  // Invoked by the root memory 'pool' to grow its capacity by 'incrementBytes'
+  // through memory arbitration. 'maxBytes' is the max capacity of 'pool'.
+  // Returns true on success.
+  bool growPool(MemoryPool* pool, int64_t maxBytes, int64_t incrementBytes);
+
   const std::shared_ptr<MemoryAllocator> allocator_;
   const int64_t memoryQuota_;
+  // Null if the root memory pools have fixed capacity.
+  const std::unique_ptr<MemoryArbitrator> arbitrator_;
   const uint16_t alignment_;
   const bool checkUsageLeak_;
   // The destruction callback set for the allocated  root memory pools which are
@@ -468,6 +468,7 @@ Stats Stats::operator-(const Stats& other) const {
     result.sizes[i] = sizes[i] - other.sizes[i];
   }
   result.numAdvise = numAdvise - other.numAdvise;
+  result.numHugePageMapped = numHugePageMapped;
   return result;
 }
 
@@ -480,10 +481,11 @@ std::string Stats::toString() const {
     totalBytes += sizes[i].totalBytes;
   }
   out << fmt::format(
-      "Alloc: {}MB {} Gigaclocks, {}MB advised\n",
+      "Alloc: {}MB {} Gigaclocks, {}MB advised, {}MB huge page mapped\n",
       totalBytes >> 20,
       totalClocks >> 30,
-      numAdvise >> 8);
+      numAdvise >> 8,
+      numHugePageMapped >> 8);
 
   // Sort the size classes by decreasing clocks.
   std::vector<int32_t> indices(sizes.size());
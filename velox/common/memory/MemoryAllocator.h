@@ -138,6 +138,10 @@ struct Stats {
 
   /// Cumulative count of pages advised away, if the allocator exposes this.
   int64_t numAdvise{0};
+
+  /// Number of mapped pages in address ranges that are advised to be backed by
+  /// huge pages, if the allocator exposes this.
+  int64_t numHugePageMapped{0};
 };
 
 /// This class provides interface for the actual memory allocations from memory
@@ -17,6 +17,7 @@
 #include "velox/common/memory/MemoryArbitrator.h"
 
 #include "velox/common/memory/Memory.h"
+#include "velox/common/memory/SharedArbitrator.h"
 
 namespace facebook::velox::memory {
 std::string MemoryArbitrator::kindString(Kind kind) {
@@ -40,9 +41,9 @@ std::ostream& operator<<(
 std::unique_ptr<MemoryArbitrator> MemoryArbitrator::create(
     const Config& config) {
   switch (config.kind) {
-    case Kind::kFixed:
-      FOLLY_FALLTHROUGH;
     case Kind::kShared:
+      return std::make_unique<SharedArbitrator>(config);
+    case Kind::kFixed:
       VELOX_UNSUPPORTED(
           "{} arbitrator type not supported yet", kindString(config.kind));
     default:
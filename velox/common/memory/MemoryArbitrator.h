@@ -67,6 +67,10 @@ class MemoryArbitrator {
     /// NOTE: this should be same capacity as we set in the associated memory
     /// manager.
     int64_t capacity;
+    /// The initial memory capacity in bytes reserved for a newly created query
+    /// memory pool. The query memory pool grows its capacity beyond this
+    /// through memory arbitration on demand.
+    int64_t memoryPoolInitCapacity{256 << 20};
   };
   static std::unique_ptr<MemoryArbitrator> create(const Config& config);
 
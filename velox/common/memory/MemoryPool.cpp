@@ -58,7 +58,8 @@ MemoryPool::MemoryPool(
       alignment_{options.alignment},
       parent_(std::move(parent)),
       reclaimer_(options.reclaimer),
-      checkUsageLeak_(options.checkUsageLeak) {
+      checkUsageLeak_(options.checkUsageLeak),
+      allocationSampler_(options.allocationSampler) {
   MemoryAllocator::alignmentCheck(0, alignment_);
   VELOX_CHECK(parent_ != nullptr || kind_ == Kind::kAggregate);
 }
@@ -70,6 +71,22 @@ MemoryPool::~MemoryPool() {
   }
 }
 
+void MemoryPool::setAllocationSampler(
+    std::shared_ptr<AllocationSampler> sampler) {
+  VELOX_CHECK_EQ(
+      getChildCount(),
+      0,
+      "The allocation sampler must be set before adding children to {}",
+      name_);
+  allocationSampler_ = std::move(sampler);
+}
+
+void MemoryPool::setPriority(int32_t priority) {
+  VELOX_CHECK_NULL(
+      parent_, "Only a root memory pool has a priority: {}", name_);
+  priority_ = priority;
+}
+
 std::string MemoryPool::kindString(Kind kind) {
   switch (kind) {
     case Kind::kLeaf:
@@ -238,6 +255,7 @@ MemoryPoolImpl::MemoryPoolImpl(
       memoryManager_{memoryManager},
       allocator_{&memoryManager_->getAllocator()},
       destructionCb_(std::move(destructionCb)),
+      threadSafe_(options.threadSafe),
       localMemoryUsage_{} {
   VELOX_CHECK(options.threadSafe || kind_ == MemoryPool::Kind::kLeaf);
 }
@@ -254,6 +272,8 @@ MemoryPoolImpl::~MemoryPoolImpl() {
         memoryUsageTracker_->cumulativeBytes(),
         memoryUsageTracker_->numAllocs());
   }
+  // Keeps the leaked bytes, if any, charged to 'memoryManager_'.
+  memoryManager_->release(managerReservedBytes_ - managerUsedBytes_);
   if (destructionCb_ != nullptr) {
     destructionCb_(this);
   }
@@ -276,6 +296,7 @@ void* MemoryPoolImpl::allocate(int64_t size) {
     VELOX_MEM_ALLOC_ERROR(fmt::format(
         "{} failed with {} bytes from {}", __FUNCTION__, size, toString()));
   }
+  sampleAllocation(buffer, alignedSize);
   return buffer;
 }
 
@@ -294,6 +315,7 @@ void* MemoryPoolImpl::allocateZeroFilled(int64_t numEntries, int64_t sizeEach) {
         sizeEach,
         toString()));
   }
+  sampleAllocation(buffer, alignedSize);
   return buffer;
 }
 
@@ -318,6 +340,7 @@ void* MemoryPoolImpl::reallocate(
         toString()));
   }
   VELOX_CHECK_NOT_NULL(newP);
+  sampleAllocation(newP, alignedNewSize);
   if (p == nullptr) {
     return newP;
   }
@@ -330,6 +353,7 @@ void MemoryPoolImpl::free(void* p, int64_t size) {
   checkMemoryAllocation();
 
   const auto alignedSize = sizeAlign(size);
+  sampleFree(p);
   allocator_->freeBytes(p, alignedSize);
   release(alignedSize);
 }
@@ -341,6 +365,10 @@ void MemoryPoolImpl::allocateNonContiguous(
   checkMemoryAllocation();
   VELOX_CHECK_GT(numPages, 0);
 
+  if (!out.empty()) {
+    // The allocator frees 'out' first.
+    sampleFree(out.runAt(0).data());
+  }
   if (!allocator_->allocateNonContiguous(
           numPages,
           out,
@@ -359,11 +387,15 @@ void MemoryPoolImpl::allocateNonContiguous(
   VELOX_CHECK(!out.empty());
   VELOX_CHECK_NULL(out.pool());
   out.setPool(this);
+  sampleAllocation(out.runAt(0).data(), out.byteSize());
 }
 
 void MemoryPoolImpl::freeNonContiguous(Allocation& allocation) {
   checkMemoryAllocation();
 
+  if (!allocation.empty()) {
+    sampleFree(allocation.runAt(0).data());
+  }
   const int64_t freedBytes = allocator_->freeNonContiguous(allocation);
   VELOX_CHECK(allocation.empty());
   release(freedBytes);
@@ -383,6 +415,10 @@ void MemoryPoolImpl::allocateContiguous(
   checkMemoryAllocation();
   VELOX_CHECK_GT(numPages, 0);
 
+  if (!out.empty()) {
+    // The allocator frees or reuses 'out' first.
+    sampleFree(out.data());
+  }
   if (!allocator_->allocateContiguous(
           numPages, nullptr, out, [this](int64_t allocBytes, bool preAlloc) {
             if (preAlloc) {
@@ -398,11 +434,15 @@ void MemoryPoolImpl::allocateContiguous(
   VELOX_CHECK(!out.empty());
   VELOX_CHECK_NULL(out.pool());
   out.setPool(this);
+  sampleAllocation(out.data(), out.size());
 }
 
 void MemoryPoolImpl::freeContiguous(ContiguousAllocation& allocation) {
   checkMemoryAllocation();
 
+  if (!allocation.empty()) {
+    sampleFree(allocation.data());
+  }
   const int64_t bytesToFree = allocation.size();
   allocator_->freeContiguous(allocation);
   VELOX_CHECK(allocation.empty());
@@ -458,7 +498,8 @@ std::shared_ptr<MemoryPool> MemoryPoolImpl::genChild(
       Options{
           .alignment = alignment_,
           .reclaimer = std::move(reclaimer),
-          .threadSafe = threadSafe});
+          .threadSafe = threadSafe,
+          .allocationSampler = allocationSampler_});
 }
 
 const MemoryUsage& MemoryPoolImpl::getLocalMemoryUsage() const {
@@ -501,21 +542,88 @@ void MemoryPoolImpl::reserve(int64_t size) {
   }
   localMemoryUsage_.incrementCurrentBytes(size);
 
-  bool success = memoryManager_->reserve(size);
-  if (UNLIKELY(!success)) {
+  if (UNLIKELY(!reserveFromManager(size))) {
     // NOTE: If we can make the reserve and release a single transaction we
     // would have more accurate aggregates in intermediate states. However, this
     // is low-pri because we can only have inflated aggregates, and be on the
     // more conservative side.
-    release(size);
+    localMemoryUsage_.incrementCurrentBytes(-size);
+    if (memoryUsageTracker_ != nullptr) {
+      memoryUsageTracker_->update(-size);
+    }
     VELOX_MEM_MANAGER_CAP_EXCEEDED(memoryManager_->getMemoryQuota());
   }
 }
 
+bool MemoryPoolImpl::reserveFromManager(int64_t size) {
+  std::unique_lock<std::mutex> guard(managerMutex_, std::defer_lock);
+  if (threadSafe_) {
+    guard.lock();
+  }
+  const int64_t newUsedBytes = managerUsedBytes_ + size;
+  if (newUsedBytes > managerReservedBytes_) {
+    int64_t increment =
+        bits::roundUp(newUsedBytes, kManagerReservationQuantum) -
+        managerReservedBytes_;
+    if (!memoryManager_->reserve(increment)) {
+      memoryManager_->release(increment);
+      // Falls back to the exact size to not fail an allocation which fits
+      // into the memory manager's capacity.
+      increment = newUsedBytes - managerReservedBytes_;
+      if (!memoryManager_->reserve(increment)) {
+        memoryManager_->release(increment);
+        return false;
+      }
+    }
+    managerReservedBytes_ += increment;
+  }
+  managerUsedBytes_ = newUsedBytes;
+  return true;
+}
+
+void MemoryPoolImpl::releaseToManager(int64_t size) {
+  std::unique_lock<std::mutex> guard(managerMutex_, std::defer_lock);
+  if (threadSafe_) {
+    guard.lock();
+  }
+  managerUsedBytes_ -= size;
+  VELOX_DCHECK_GE(managerUsedBytes_, 0);
+  // Keeps up to one unused quantum to not go back to 'memoryManager_' when
+  // the usage goes up and down around a quantum boundary.
+  const int64_t targetBytes =
+      bits::roundUp(managerUsedBytes_, kManagerReservationQuantum);
+  if (managerReservedBytes_ > targetBytes + kManagerReservationQuantum) {
+    memoryManager_->release(managerReservedBytes_ - targetBytes);
+    managerReservedBytes_ = targetBytes;
+  }
+}
+
+uint64_t MemoryPoolImpl::freeBytes() const {
+  if (memoryUsageTracker_ == nullptr) {
+    return 0;
+  }
+  return memoryUsageTracker_->freeBytes();
+}
+
+uint64_t MemoryPoolImpl::shrink(uint64_t targetBytes) {
+  if (memoryUsageTracker_ == nullptr) {
+    return 0;
+  }
+  return memoryUsageTracker_->shrink(targetBytes);
+}
+
+uint64_t MemoryPoolImpl::grow(uint64_t bytes) {
+  VELOX_CHECK_NOT_NULL(
+      memoryUsageTracker_,
+      "Can't grow memory pool without memory usage tracking: {}",
+      name_);
+  return memoryUsageTracker_->grow(bytes);
+}
+
 void MemoryPoolImpl::release(int64_t size) {
   checkMemoryAllocation();
 
-  memoryManager_->release(size);
+  releaseToManager(size);
   localMemoryUsage_.incrementCurrentBytes(-size);
   if (memoryUsageTracker_ != nullptr) {
     memoryUsageTracker_->update(-size);
@@ -21,6 +21,7 @@
 #include <limits>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <fmt/format.h>
@@ -30,6 +31,7 @@
 
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/memory/Allocation.h"
+#include "velox/common/memory/AllocationSampler.h"
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/common/memory/MemoryArbitrator.h"
 #include "velox/common/memory/MemoryUsage.h"
@@ -130,6 +132,9 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
     /// TODO: deprecate this flag after all the existing memory leak use cases
     /// have been fixed.
     bool checkUsageLeak{FLAGS_velox_memory_leak_check_enabled};
+    /// If set, samples the allocations from this memory pool. The child pools
+    /// share the sampler of their parent.
+    std::shared_ptr<AllocationSampler> allocationSampler{nullptr};
   };
 
   /// Constructs a named memory pool with specified 'name', 'parent' and 'kind'.
@@ -295,6 +300,26 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   /// Returns the memory reclaimer of this memory pool if not null.
   MemoryReclaimer* reclaimer() const;
 
+  /// Returns the sampler of the allocations from this memory pool and its
+  /// children if set.
+  const std::shared_ptr<AllocationSampler>& allocationSampler() const {
+    return allocationSampler_;
+  }
+
+  /// Sets the sampler of the allocations from the children of this memory
+  /// pool. Must be called before any child pool is added, e.g. by a task on
+  /// its root pool.
+  void setAllocationSampler(std::shared_ptr<AllocationSampler> sampler);
+
+  /// Returns the priority of the query of this root memory pool. The memory
+  /// arbitrator reclaims the used memory of the lower priority queries first.
+  int32_t priority() const {
+    return priority_;
+  }
+
+  /// Sets the priority of this root memory pool, e.g. from the query config.
+  void setPriority(int32_t priority);
+
   /// Invoked by the memory arbitrator to enter memory arbitration processing.
   /// It is a noop if 'reclaimer_' is not set, otherwise invoke the reclaimer's
   /// corresponding method.
@@ -360,6 +385,10 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   const std::shared_ptr<MemoryPool> parent_;
   const std::shared_ptr<MemoryReclaimer> reclaimer_;
   const bool checkUsageLeak_;
+  // Set before 'children_' is populated, so that it is not changed while the
+  // children read it.
+  std::shared_ptr<AllocationSampler> allocationSampler_;
+  std::atomic<int32_t> priority_{0};
 
   /// Protects 'children_'.
   mutable folly::SharedMutex childrenMutex_;
@@ -378,6 +407,12 @@ class MemoryPoolImpl : public MemoryPool {
  public:
   using DestructionCallback = std::function<void(MemoryPool*)>;
 
+  /// The quantum in which a leaf memory pool reserves memory from its memory
+  /// manager. Small allocations are charged against the pool's local
+  /// reservation and only the allocations which exhaust it update the
+  /// memory manager's counter which is shared by all the pools.
+  static constexpr int64_t kManagerReservationQuantum = 1 << 20;
+
   // Should perhaps make this method private so that we only create node through
   // parent.
   MemoryPoolImpl(
@@ -454,17 +489,11 @@ class MemoryPoolImpl : public MemoryPool {
 
   void release(int64_t size) override;
 
-  uint64_t freeBytes() const override {
-    VELOX_NYI("{} unsupported", __FUNCTION__);
-  }
+  uint64_t freeBytes() const override;
 
-  uint64_t shrink(uint64_t targetBytes = 0) override {
-    VELOX_NYI("{} unsupported", __FUNCTION__);
-  }
+  uint64_t shrink(uint64_t targetBytes = 0) override;
 
-  uint64_t grow(uint64_t bytes) override {
-    VELOX_NYI("{} unsupported", __FUNCTION__);
-  }
+  uint64_t grow(uint64_t bytes) override;
 
   std::string toString() const override;
 
@@ -475,14 +504,49 @@ class MemoryPoolImpl : public MemoryPool {
  private:
   int64_t sizeAlign(int64_t size);
 
+  // Records the allocation of 'bytes' at 'p' if it is sampled.
+  void sampleAllocation(const void* p, int64_t bytes) {
+    if (FOLLY_UNLIKELY(allocationSampler_ != nullptr) &&
+        allocationSampler_->shouldSample(bytes)) {
+      allocationSampler_->recordAllocation(name_, p, bytes);
+    }
+  }
+
+  // Records the free of the allocation at 'p' if it is sampled. Called
+  // before the memory is freed, so that it is not reused meanwhile.
+  void sampleFree(const void* p) {
+    if (FOLLY_UNLIKELY(allocationSampler_ != nullptr)) {
+      allocationSampler_->recordFree(p);
+    }
+  }
+
   void accessSubtreeMemoryUsage(
       std::function<void(const MemoryUsage&)> visitor) const;
   void updateSubtreeMemoryUsage(std::function<void(MemoryUsage&)> visitor);
 
+  // Charges 'size' bytes against 'managerReservedBytes_' and reserves more
+  // from 'memoryManager_' in kManagerReservationQuantum steps if it is
+  // exhausted. Returns false without any change if 'memoryManager_' is out of
+  // capacity.
+  bool reserveFromManager(int64_t size);
+
+  // Returns 'size' bytes to 'managerReservedBytes_' and releases the unused
+  // reservation beyond a quantum back to 'memoryManager_'.
+  void releaseToManager(int64_t size);
+
   const std::shared_ptr<MemoryUsageTracker> memoryUsageTracker_;
   MemoryManager* const memoryManager_;
   MemoryAllocator* const allocator_;
   const DestructionCallback destructionCb_;
+  const bool threadSafe_;
+
+  // Protects 'managerReservedBytes_' and 'managerUsedBytes_' if 'threadSafe_'
+  // is set.
+  std::mutex managerMutex_;
+  // The bytes reserved from 'memoryManager_' by this pool, and the bytes of
+  // them in use.
+  int64_t managerReservedBytes_{0};
+  int64_t managerUsedBytes_{0};
 
   // Memory allocated attributed to the memory node.
   MemoryUsage localMemoryUsage_;
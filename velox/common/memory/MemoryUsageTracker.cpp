@@ -268,6 +268,55 @@ bool MemoryUsageTracker::maybeReserve(uint64_t increment) {
   return true;
 }
 
+bool MemoryUsageTracker::reservePredictedPeak(int64_t peakBytes) {
+  reservationCheck();
+  VELOX_CHECK_GE(peakBytes, 0);
+  int64_t increment;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    predictedPeakBytes_ = std::max(predictedPeakBytes_, peakBytes);
+    if (peakBytes <= reservationBytes_) {
+      return true;
+    }
+    // reserve() makes the reservation cover the current usage plus its size.
+    increment = peakBytes - currentBytesLocked();
+  }
+  return maybeReserve(increment);
+}
+
+int64_t MemoryUsageTracker::freeBytes() const {
+  if (parent_ != nullptr) {
+    return parent_->freeBytes();
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  return std::max<int64_t>(0, maxMemory_ - reservationBytes_);
+}
+
+int64_t MemoryUsageTracker::shrink(int64_t targetBytes) {
+  VELOX_CHECK_GE(targetBytes, 0);
+  if (parent_ != nullptr) {
+    return parent_->shrink(targetBytes);
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  int64_t freedBytes = std::max<int64_t>(0, maxMemory_ - reservationBytes_);
+  if (targetBytes != 0) {
+    freedBytes = std::min(targetBytes, freedBytes);
+  }
+  maxMemory_ -= freedBytes;
+  return freedBytes;
+}
+
+int64_t MemoryUsageTracker::grow(int64_t bytes) {
+  VELOX_CHECK_GE(bytes, 0);
+  if (parent_ != nullptr) {
+    return parent_->grow(bytes);
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK_LE(bytes, kMaxMemory - maxMemory_, "Memory capacity overflow");
+  maxMemory_ += bytes;
+  return maxMemory_;
+}
+
 std::string MemoryUsageTracker::toString() const {
   std::lock_guard<std::mutex> l(mutex_);
   return toStringNoLock();
@@ -283,7 +332,7 @@ int64_t MemoryUsageTracker::reservationSizeNoLock(int64_t size) {
 
 std::string MemoryUsageTracker::Stats::toString() const {
   return fmt::format(
-      "peakBytes:{} cumulativeBytes:{} numAllocs:{} numFrees:{} numReserves:{} numReleases:{} numCollisions:{} numChildren:{}",
+      "peakBytes:{} cumulativeBytes:{} numAllocs:{} numFrees:{} numReserves:{} numReleases:{} numCollisions:{} numChildren:{} predictedPeakBytes:{}",
       peakBytes,
       cumulativeBytes,
       numAllocs,
@@ -291,7 +340,8 @@ std::string MemoryUsageTracker::Stats::toString() const {
       numReserves,
       numReleases,
       numCollisions,
-      numChildren);
+      numChildren,
+      predictedPeakBytes);
 }
 
 MemoryUsageTracker::Stats MemoryUsageTracker::stats() const {
@@ -305,6 +355,7 @@ MemoryUsageTracker::Stats MemoryUsageTracker::stats() const {
   stats.numReleases = numReleases_;
   stats.numCollisions = numCollisions_;
   stats.numChildren = numChildren_;
+  stats.predictedPeakBytes = predictedPeakBytes_;
   return stats;
 }
 
@@ -318,7 +369,8 @@ bool MemoryUsageTracker::Stats::operator==(
              numReserves,
              numReleases,
              numCollisions,
-             numChildren) ==
+             numChildren,
+             predictedPeakBytes) ==
       std::tie(
              other.peakBytes,
              other.cumulativeBytes,
@@ -327,7 +379,8 @@ bool MemoryUsageTracker::Stats::operator==(
              other.numReserves,
              other.numReleases,
              other.numCollisions,
-             other.numChildren);
+             other.numChildren,
+             other.predictedPeakBytes);
 }
 
 std::ostream& operator<<(
@@ -75,6 +75,9 @@ class MemoryUsageTracker
     uint64_t numCollisions{0};
     /// The number of created child memory trackers.
     uint64_t numChildren{0};
+    /// The largest peak declared with reservePredictedPeak(), to compare with
+    /// 'peakBytes'.
+    uint64_t predictedPeakBytes{0};
 
     bool operator==(const Stats& rhs) const;
 
@@ -136,6 +139,16 @@ class MemoryUsageTracker
   /// the reservation increment and returns true if succeeded.
   bool maybeReserve(uint64_t increment);
 
+  /// Declares that the usage of 'this' is predicted to grow to 'peakBytes',
+  /// e.g. from the input size estimates of an operator. Reserves what is not
+  /// yet reserved of 'peakBytes' with maybeReserve(), so that the capacity is
+  /// obtained, possibly through the grow callback of the root tracker, before
+  /// the growth starts instead of in the middle of it. Returns false if the
+  /// reservation fails. The caller should then reduce its memory usage, e.g.
+  /// by spilling, before growing. The largest predicted peak is reported in
+  /// stats().
+  bool reservePredictedPeak(int64_t peakBytes);
+
   /// If a minimum reservation has been set with reserve(), resets the minimum
   /// reservation. If the current usage is below the minimum reservation,
   /// decreases reservation and usage down to the rounded actual usage.
@@ -210,6 +223,21 @@ class MemoryUsageTracker
     return parent_ != nullptr ? parent_->maxMemory() : maxMemory_;
   }
 
+  /// Returns the memory capacity in bytes of the root tracker which hasn't
+  /// been reserved, and can be freed by shrink() without freeing any used
+  /// memory.
+  int64_t freeBytes() const;
+
+  /// Reduces the memory capacity of the root tracker by up to 'targetBytes' of
+  /// its unreserved capacity. If 'targetBytes' is zero, the function frees all
+  /// the unreserved capacity. The function returns the actually freed capacity
+  /// in bytes.
+  int64_t shrink(int64_t targetBytes = 0);
+
+  /// Increases the memory capacity of the root tracker by 'bytes'. The
+  /// function returns the capacity after the growth.
+  int64_t grow(int64_t bytes);
+
   /// Create a child memory usage tracker. 'leafTracker' indicates if the child
   /// is a leaf tracker for memory reservation use. If it is false, then the
   /// child is used for memory reservation aggregation and it is associated with
@@ -489,6 +517,7 @@ class MemoryUsageTracker
 
   int64_t peakBytes_{0};
   int64_t cumulativeBytes_{0};
+  int64_t predictedPeakBytes_{0};
 
   // The number of reservation bytes propagated up to the parent for memory
   // limit check at the root tracker.
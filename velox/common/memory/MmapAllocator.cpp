@@ -24,6 +24,7 @@
 namespace facebook::velox::memory {
 MmapAllocator::MmapAllocator(const Options& options)
     : kind_(MemoryAllocator::Kind::kMmap),
+      useHugePages_(options.useHugePages),
       useMmapArena_(options.useMmapArena),
       maxMallocBytes_(options.maxMallocBytes),
       mallocReservedBytes_(
@@ -33,8 +34,14 @@ MmapAllocator::MmapAllocator(const Options& options)
       capacity_(bits::roundUp(
           AllocationTraits::numPages(options.capacity - mallocReservedBytes_),
           64 * sizeClassSizes_.back())) {
+  if (useHugePages_) {
+    VELOX_CHECK_GE(options.hugePageMinSizeClass, 8);
+  }
   for (const auto& size : sizeClassSizes_) {
-    sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
+    sizeClasses_.push_back(std::make_unique<SizeClass>(
+        capacity_ / size,
+        size,
+        useHugePages_ && size >= options.hugePageMinSizeClass));
   }
 
   if (useMmapArena_) {
@@ -42,7 +49,8 @@ MmapAllocator::MmapAllocator(const Options& options)
         AllocationTraits::pageBytes(capacity_) / options.mmapArenaCapacityRatio,
         AllocationTraits::kPageSize);
     managedArenas_ = std::make_unique<ManagedMmapArenas>(
-        std::max<uint64_t>(arenaSizeBytes, MmapArena::kMinCapacityBytes));
+        std::max<uint64_t>(arenaSizeBytes, MmapArena::kMinCapacityBytes),
+        useHugePages_);
   }
 }
 
@@ -327,16 +335,10 @@ bool MmapAllocator::allocateContiguousImpl(
       std::lock_guard<std::mutex> l(arenaMutex_);
       data = managedArenas_->allocate(AllocationTraits::pageBytes(numPages));
     } else {
-      data = ::mmap(
-          nullptr,
-          AllocationTraits::pageBytes(numPages),
-          PROT_READ | PROT_WRITE,
-          MAP_PRIVATE | MAP_ANONYMOUS,
-          -1,
-          0);
+      data =
+          mmapAnonymous(AllocationTraits::pageBytes(numPages), useHugePages_);
     }
   }
-  // TODO: add handling of MAP_FAILED.
   if (data == nullptr) {
     VELOX_MEM_LOG(ERROR) << "Mmap failed with " << numPages
                          << " pages, use MmapArena "
@@ -448,11 +450,20 @@ MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   return numAway;
 }
 
-MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
+MmapAllocator::SizeClass::SizeClass(
+    size_t capacity,
+    MachinePageCount unitSize,
+    bool useHugePages)
     : capacity_(capacity),
       unitSize_(unitSize),
       byteSize_(AllocationTraits::pageBytes(capacity_ * unitSize_)),
       pageBitmapSize_(capacity_ / 64),
+      pagesPerHugePage_(
+          useHugePages ? std::max<int32_t>(
+                             1,
+                             AllocationTraits::kHugePageSize /
+                                 AllocationTraits::pageBytes(unitSize_))
+                       : 0),
       // Min 8 words + 1 bit for every 512 bits in 'pageAllocated_'.
       mappedFreeLookup_((capacity_ / kPagesPerLookupBit / 64) + kSimdTail),
       pageAllocated_(pageBitmapSize_ + kSimdTail),
@@ -462,14 +473,8 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
       0,
       "Sizeclass {} must have a multiple of 64 capacity",
       unitSize_);
-  void* ptr = mmap(
-      nullptr,
-      AllocationTraits::pageBytes(capacity_ * unitSize_),
-      PROT_READ | PROT_WRITE,
-      MAP_PRIVATE | MAP_ANONYMOUS,
-      -1,
-      0);
-  if (ptr == MAP_FAILED || ptr == nullptr) {
+  void* ptr = mmapAnonymous(byteSize_, useHugePages);
+  if (ptr == nullptr) {
     VELOX_FAIL(
         "Could not allocate working memory "
         "mmap failed with {} for sizeClass {}",
@@ -721,7 +726,14 @@ MachinePageCount MmapAllocator::SizeClass::adviseAway(
       return 0;
     }
     target = std::min(target, numMappedFreePages_);
-    allocateLocked(target, nullptr, allocation);
+    // Prefers whole free huge pages. The last one may exceed 'target'.
+    const auto numHugePageAllocated = pagesPerHugePage_ > 1
+        ? allocateFreeHugePagesLocked(target, allocation)
+        : 0;
+    if (numHugePageAllocated < target) {
+      allocateLocked(target - numHugePageAllocated, nullptr, allocation);
+    }
+    target = std::max(target, numHugePageAllocated);
     VELOX_CHECK_EQ(allocation.numPages(), target * unitSize_);
     numAllocatedMapped_ -= target;
     numAdvisedAway_ += target;
@@ -733,6 +745,61 @@ MachinePageCount MmapAllocator::SizeClass::adviseAway(
   return unitSize_ * target;
 }
 
+ClassPageCount MmapAllocator::SizeClass::allocateFreeHugePagesLocked(
+    ClassPageCount numPages,
+    Allocation& allocation) {
+  constexpr int32_t kWordsPerLookupBit = kPagesPerLookupBit / 64;
+  const uint64_t hugePageMask = pagesPerHugePage_ == 64
+      ? kAllSet
+      : bits::lowMask(pagesPerHugePage_);
+  ClassPageCount numAllocated = 0;
+  const auto numLookupBits =
+      bits::roundUp(pageBitmapSize_, kWordsPerLookupBit) / kWordsPerLookupBit;
+  for (auto group = 0; group < numLookupBits && numAllocated < numPages;
+       ++group) {
+    if (!bits::isBitSet(mappedFreeLookup_.data(), group)) {
+      continue;
+    }
+    const auto startWord = group * kWordsPerLookupBit;
+    const auto endWord =
+        std::min<int32_t>(pageBitmapSize_, startWord + kWordsPerLookupBit);
+    bool anyMappedFree = false;
+    for (auto word = startWord; word < endWord; ++word) {
+      const uint64_t mappedFree = pageMapped_[word] & ~pageAllocated_[word];
+      for (auto bit = 0; bit < 64 && numAllocated < numPages;
+           bit += pagesPerHugePage_) {
+        if (((mappedFree >> bit) & hugePageMask) != hugePageMask) {
+          continue;
+        }
+        pageAllocated_[word] |= hugePageMask << bit;
+        allocation.append(
+            address_ +
+                AllocationTraits::pageBytes((word * 64 + bit) * unitSize_),
+            pagesPerHugePage_ * unitSize_);
+        numAllocated += pagesPerHugePage_;
+      }
+      anyMappedFree |= (pageMapped_[word] & ~pageAllocated_[word]) != 0;
+    }
+    if (!anyMappedFree) {
+      bits::clearBit(mappedFreeLookup_.data(), group);
+    }
+  }
+  numMappedFreePages_ -= numAllocated;
+  return numAllocated;
+}
+
+MachinePageCount MmapAllocator::SizeClass::numHugePageMapped() {
+  if (pagesPerHugePage_ == 0) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  MachinePageCount numMapped = 0;
+  for (int i = 0; i < pageBitmapSize_; ++i) {
+    numMapped += __builtin_popcountll(pageMapped_[i]);
+  }
+  return numMapped * unitSize_;
+}
+
 bool MmapAllocator::SizeClass::isInRange(uint8_t* ptr) const {
   if (ptr >= address_ && ptr < address_ + byteSize_) {
     // See that ptr falls on a page boundary.
@@ -887,6 +954,18 @@ bool MmapAllocator::checkConsistency() const {
   return numErrors == 0;
 }
 
+Stats MmapAllocator::stats() const {
+  auto stats = stats_;
+  stats.numAdvise = numAdvisedPages_;
+  if (useHugePages_) {
+    for (const auto& sizeClass : sizeClasses_) {
+      stats.numHugePageMapped += sizeClass->numHugePageMapped();
+    }
+    stats.numHugePageMapped += numExternalMapped_;
+  }
+  return stats;
+}
+
 bool MmapAllocator::useMalloc(uint64_t bytes) {
   return (maxMallocBytes_ != 0) && (bytes <= maxMallocBytes_);
 }
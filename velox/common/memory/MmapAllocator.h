@@ -75,6 +75,18 @@ class MmapAllocator : public MemoryAllocator {
     /// and 'smallAllocationReservePct' will be automatically set to 0
     /// disregarding any passed in value.
     int32_t maxMallocBytes = 3072;
+
+    /// If true, the address ranges of the size classes of at least
+    /// 'hugePageMinSizeClass' machine pages, of the MmapArenas and of the
+    /// other contiguous allocations are aligned to huge pages and advised to be
+    /// backed by transparent huge pages. This reduces TLB misses on large hash
+    /// tables and cache entries.
+    bool useHugePages = false;
+
+    /// The smallest size class in machine pages that is backed by huge pages
+    /// if 'useHugePages' is true. Must be at least 8, so that the class pages
+    /// in a huge page are in one word of the size class bitmaps.
+    MachinePageCount hugePageMinSizeClass = 64;
   };
 
   explicit MmapAllocator(const Options& options);
@@ -165,11 +177,7 @@ class MmapAllocator : public MemoryAllocator {
     return numMallocBytes_;
   }
 
-  Stats stats() const override {
-    auto stats = stats_;
-    stats.numAdvise = numAdvisedPages_;
-    return stats;
-  }
+  Stats stats() const override;
 
   std::string toString() const override;
 
@@ -180,7 +188,9 @@ class MmapAllocator : public MemoryAllocator {
   // 'unitSize_' machine pages.
   class SizeClass {
    public:
-    SizeClass(size_t capacity, MachinePageCount unitSize);
+    // If 'useHugePages' is true, the address range is backed by transparent
+    // huge pages.
+    SizeClass(size_t capacity, MachinePageCount unitSize, bool useHugePages);
 
     ~SizeClass();
 
@@ -188,6 +198,10 @@ class MmapAllocator : public MemoryAllocator {
       return unitSize_;
     }
 
+    // Returns the number of mapped machine pages if 'this' is backed by huge
+    // pages, otherwise 0.
+    MachinePageCount numHugePageMapped();
+
     // Allocates 'numPages' from 'this' and appends these to *out.
     // '*numUnmapped' is incremented by the number of pages that are not backed
     // by memory.
@@ -268,6 +282,15 @@ class MmapAllocator : public MemoryAllocator {
     // 'allocation'.
     void adviseAway(const Allocation& allocation);
 
+    // Adds the mapped free class pages of huge pages that have all their class
+    // pages mapped and free to 'allocation' until at least 'numPages' class
+    // pages are added. Returns the number of added class pages. Advising these
+    // away does not split the huge pages that back allocated memory. Must be
+    // called inside 'mutex_'.
+    ClassPageCount allocateFreeHugePagesLocked(
+        ClassPageCount numPages,
+        Allocation& allocation);
+
     // Allocates up to 'numPages' of mapped or unmapped pages from the
     // free/mapped word at 'wordIndex'. 'numPages' is decremented by the number
     // of allocated class pages, numUnmapped is incremented by the count of
@@ -292,6 +315,10 @@ class MmapAllocator : public MemoryAllocator {
     // themselves are padded with extra zeros for SIMD access.
     const int32_t pageBitmapSize_;
 
+    // Number of class pages in a huge page if the address range is backed by
+    // huge pages, otherwise 0.
+    const int32_t pagesPerHugePage_;
+
     // Serializes access to all data members and private methods.
     std::mutex mutex_;
 
@@ -361,6 +388,10 @@ class MmapAllocator : public MemoryAllocator {
 
   const Kind kind_;
 
+  // If true, the larger size classes and the contiguous allocations are backed
+  // by transparent huge pages.
+  const bool useHugePages_;
+
   // If set true, allocations larger than the largest size class size will be
   // delegated to ManagedMmapArena. Otherwise, a system mmap call will be
   // issued for each such allocation.
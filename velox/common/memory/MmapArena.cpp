@@ -21,24 +21,55 @@
 #include "velox/common/memory/Memory.h"
 
 namespace facebook::velox::memory {
+
+void* mmapAnonymous(uint64_t bytes, bool useHugePages) {
+  // Maps an extra huge page to align the range.
+  const uint64_t padding = useHugePages ? AllocationTraits::kHugePageSize : 0;
+  void* ptr = ::mmap(
+      nullptr,
+      bytes + padding,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (ptr == MAP_FAILED || ptr == nullptr) {
+    return nullptr;
+  }
+  if (!useHugePages) {
+    return ptr;
+  }
+  auto* address = reinterpret_cast<uint8_t*>(ptr);
+  auto* aligned = reinterpret_cast<uint8_t*>(bits::roundUp(
+      reinterpret_cast<uint64_t>(address), AllocationTraits::kHugePageSize));
+  const uint64_t head = aligned - address;
+  if (head > 0) {
+    ::munmap(address, head);
+  }
+  if (padding > head) {
+    ::munmap(aligned + bytes, padding - head);
+  }
+#ifdef MADV_HUGEPAGE
+  if (::madvise(aligned, bytes, MADV_HUGEPAGE) < 0) {
+    VELOX_MEM_LOG(WARNING) << "madvise(MADV_HUGEPAGE) got errno "
+                           << folly::errnoStr(errno);
+  }
+#endif
+  return aligned;
+}
+
 uint64_t MmapArena::roundBytes(uint64_t bytes) {
   return bits::nextPowerOfTwo(bytes);
 }
 
-MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
+MmapArena::MmapArena(size_t capacityBytes, bool useHugePages)
+    : byteSize_(capacityBytes) {
   VELOX_CHECK_EQ(
       byteSize_ % kMinGrainSizeBytes,
       0,
       "Arena must have a multiple of {} bytes capacity.",
       kMinGrainSizeBytes);
-  void* ptr = mmap(
-      nullptr,
-      capacityBytes,
-      PROT_READ | PROT_WRITE,
-      MAP_PRIVATE | MAP_ANONYMOUS,
-      -1,
-      0);
-  if (ptr == MAP_FAILED || ptr == nullptr) {
+  void* ptr = mmapAnonymous(capacityBytes, useHugePages);
+  if (ptr == nullptr) {
     VELOX_FAIL(
         "Could not allocate working memory"
         "mmap failed with errno {} with capacity bytes {}",
@@ -267,9 +298,11 @@ bool MmapArena::checkConsistency() const {
   return numErrors == 0;
 }
 
-ManagedMmapArenas::ManagedMmapArenas(uint64_t singleArenaCapacity)
-    : singleArenaCapacity_(singleArenaCapacity) {
-  auto arena = std::make_shared<MmapArena>(singleArenaCapacity);
+ManagedMmapArenas::ManagedMmapArenas(
+    uint64_t singleArenaCapacity,
+    bool useHugePages)
+    : singleArenaCapacity_(singleArenaCapacity), useHugePages_(useHugePages) {
+  auto arena = std::make_shared<MmapArena>(singleArenaCapacity, useHugePages_);
   arenas_.emplace(reinterpret_cast<uint64_t>(arena->address()), arena);
   currentArena_ = arena;
 }
@@ -283,7 +316,8 @@ void* FOLLY_NULLABLE ManagedMmapArenas::allocate(uint64_t bytes) {
   // If first allocation fails we create a new MmapArena for another attempt. If
   // it ever fails again then it means requested bytes is larger than a single
   // MmapArena's capacity. No further attempts will happen.
-  auto newArena = std::make_shared<MmapArena>(singleArenaCapacity_);
+  auto newArena =
+      std::make_shared<MmapArena>(singleArenaCapacity_, useHugePages_);
   arenas_.emplace(reinterpret_cast<uint64_t>(newArena->address()), newArena);
   currentArena_ = newArena;
   return currentArena_->allocate(bytes);
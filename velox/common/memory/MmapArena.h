@@ -26,6 +26,12 @@
 
 namespace facebook::velox::memory {
 
+/// Maps 'bytes' of anonymous memory. If 'useHugePages' is true, the mapping is
+/// aligned to AllocationTraits::kHugePageSize and advised with MADV_HUGEPAGE,
+/// so that the kernel can back it with transparent huge pages. Returns nullptr
+/// if the mapping fails.
+void* FOLLY_NULLABLE mmapAnonymous(uint64_t bytes, bool useHugePages);
+
 class MmapArena {
  public:
   /// Single MmapArena capacity is determined by mmap_arena_capacity_ratio ratio
@@ -36,7 +42,9 @@ class MmapArena {
   /// MmapArena capacity should be multiple of kMinGrainSizeBytes.
   static constexpr uint64_t kMinGrainSizeBytes = 1024 * 1024; // 1M
 
-  MmapArena(size_t capacityBytes);
+  /// If 'useHugePages' is true, the arena is backed by transparent huge pages,
+  /// see mmapAnonymous().
+  MmapArena(size_t capacityBytes, bool useHugePages = false);
   ~MmapArena();
 
   void* FOLLY_NULLABLE allocate(uint64_t bytes);
@@ -121,7 +129,7 @@ class MmapArena {
 /// fragmentation happens.
 class ManagedMmapArenas {
  public:
-  ManagedMmapArenas(uint64_t singleArenaCapacity);
+  ManagedMmapArenas(uint64_t singleArenaCapacity, bool useHugePages = false);
 
   void* FOLLY_NULLABLE allocate(uint64_t bytes);
 
@@ -141,6 +149,9 @@ class ManagedMmapArenas {
 
   /// Capacity in bytes for a single MmapArena managed by this.
   const uint64_t singleArenaCapacity_;
+
+  /// True if the MmapArenas are backed by transparent huge pages.
+  const bool useHugePages_;
 };
 
 } // namespace facebook::velox::memory
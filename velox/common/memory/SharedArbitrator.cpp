@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/SharedArbitrator.h"
+
+#include <folly/ScopeGuard.h>
+#include <folly/container/F14Map.h>
+
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::memory {
+namespace {
+uint64_t elapsedMicros(
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+      .count();
+}
+
+// Indicates if the current thread is running a memory arbitration.
+thread_local bool inArbitration{false};
+} // namespace
+
+SharedArbitrator::SharedArbitrator(const Config& config)
+    : MemoryArbitrator(config),
+      memoryPoolInitCapacity_(config.memoryPoolInitCapacity),
+      freeCapacity_(capacity_) {
+  VELOX_CHECK_EQ(kind_, Kind::kShared);
+  VELOX_CHECK_GE(config.memoryPoolInitCapacity, 0);
+}
+
+int64_t SharedArbitrator::reserveMemory(int64_t bytes) {
+  VELOX_CHECK_GE(bytes, 0);
+  return decrementFreeCapacity(
+      std::min<uint64_t>(bytes, memoryPoolInitCapacity_));
+}
+
+void SharedArbitrator::releaseMemory(MemoryPool* releasor) {
+  incrementFreeCapacity(releasor->shrink(0));
+}
+
+bool SharedArbitrator::growMemory(
+    MemoryPool* requestor,
+    const std::vector<MemoryPool*>& candidates,
+    uint64_t targetBytes) {
+  // NOTE: a memory allocation made during memory reclamation, e.g. a partial
+  // aggregation output flush, can't grow memory through the arbitration as it
+  // runs on the thread which holds the arbitration lock.
+  if (inArbitration) {
+    LOG(WARNING) << "Can't grow memory pool " << requestor->name()
+                 << " from a running memory arbitration";
+    return false;
+  }
+  const auto queueStartTime = std::chrono::steady_clock::now();
+  // NOTE: the requestor enters the arbitration before waiting for the running
+  // one to finish so that its task can be paused if it is chosen for memory
+  // reclamation by the running arbitration.
+  requestor->enterArbitration();
+  auto leaveGuard =
+      folly::makeGuard([&]() { requestor->leaveArbitration(); });
+
+  std::unique_lock<std::mutex> arbitrationLock(
+      arbitrationMutex_, std::try_to_lock);
+  const bool queued = !arbitrationLock.owns_lock();
+  if (queued) {
+    arbitrationLock.lock();
+  }
+  const auto arbitrationStartTime = std::chrono::steady_clock::now();
+  inArbitration = true;
+  auto arbitrationGuard = folly::makeGuard([&]() { inArbitration = false; });
+  const bool success = growMemoryLocked(requestor, candidates, targetBytes);
+  const auto arbitrationEndTime = std::chrono::steady_clock::now();
+  REPORT_ADD_STAT_VALUE(
+      priorityCounterKey(
+          kCounterMemoryArbitrationQueueTimeUs, requestor->priority()),
+      elapsedMicros(queueStartTime, arbitrationStartTime));
+  reportUsageByPriority(candidates);
+
+  std::lock_guard<std::mutex> l(mutex_);
+  ++stats_.numRequests;
+  if (queued) {
+    ++stats_.numQueuedRequests;
+  }
+  if (!success) {
+    ++stats_.numFailures;
+  }
+  stats_.queueTimeUs += elapsedMicros(queueStartTime, arbitrationStartTime);
+  stats_.arbitrationTimeUs +=
+      elapsedMicros(arbitrationStartTime, arbitrationEndTime);
+  return success;
+}
+
+bool SharedArbitrator::growMemoryLocked(
+    MemoryPool* requestor,
+    const std::vector<MemoryPool*>& candidates,
+    uint64_t targetBytes) {
+  uint64_t freedBytes = decrementFreeCapacity(targetBytes);
+  if (freedBytes < targetBytes) {
+    auto candidateStats = getCandidateStats(candidates);
+    freedBytes += reclaimFreeMemoryFromCandidates(
+        candidateStats, targetBytes - freedBytes);
+    if (freedBytes < targetBytes) {
+      freedBytes += reclaimUsedMemoryFromCandidates(
+          candidateStats, targetBytes - freedBytes);
+    }
+  }
+  if (freedBytes < targetBytes) {
+    LOG(WARNING) << "Failed to arbitrate " << succinctBytes(targetBytes)
+                 << " for memory pool " << requestor->name()
+                 << ", only freed " << succinctBytes(freedBytes);
+    incrementFreeCapacity(freedBytes);
+    return false;
+  }
+  requestor->grow(targetBytes);
+  incrementFreeCapacity(freedBytes - targetBytes);
+  return true;
+}
+
+// static
+std::vector<SharedArbitrator::Candidate> SharedArbitrator::getCandidateStats(
+    const std::vector<MemoryPool*>& pools) {
+  std::vector<Candidate> candidates;
+  candidates.reserve(pools.size());
+  for (auto* pool : pools) {
+    const bool reclaimable = pool->canReclaim();
+    candidates.push_back(
+        {pool,
+         pool->priority(),
+         reclaimable,
+         reclaimable ? static_cast<int64_t>(pool->reclaimableBytes()) : 0,
+         static_cast<int64_t>(pool->freeBytes())});
+  }
+  return candidates;
+}
+
+uint64_t SharedArbitrator::reclaimFreeMemoryFromCandidates(
+    std::vector<Candidate>& candidates,
+    uint64_t targetBytes) {
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs.freeBytes > rhs.freeBytes;
+      });
+  uint64_t freedBytes{0};
+  for (auto& candidate : candidates) {
+    if (candidate.freeBytes == 0 || freedBytes >= targetBytes) {
+      break;
+    }
+    const auto shrunkBytes = candidate.pool->shrink(targetBytes - freedBytes);
+    candidate.freeBytes -= std::min<int64_t>(shrunkBytes, candidate.freeBytes);
+    freedBytes += shrunkBytes;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  stats_.numShrunkBytes += freedBytes;
+  return freedBytes;
+}
+
+uint64_t SharedArbitrator::reclaimUsedMemoryFromCandidates(
+    std::vector<Candidate>& candidates,
+    uint64_t targetBytes) {
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const Candidate& lhs, const Candidate& rhs) {
+        if (lhs.priority != rhs.priority) {
+          return lhs.priority < rhs.priority;
+        }
+        return lhs.reclaimableBytes > rhs.reclaimableBytes;
+      });
+  uint64_t freedBytes{0};
+  for (const auto& candidate : candidates) {
+    if (freedBytes >= targetBytes) {
+      break;
+    }
+    if (!candidate.reclaimable || candidate.reclaimableBytes == 0) {
+      continue;
+    }
+    try {
+      candidate.pool->reclaim(targetBytes - freedBytes);
+    } catch (const std::exception& e) {
+      // NOTE: we still try to shrink the memory freed before the failure.
+      LOG(ERROR) << "Failed to reclaim memory from memory pool "
+                 << candidate.pool->name() << ": " << e.what();
+    }
+    freedBytes += candidate.pool->shrink(targetBytes - freedBytes);
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  stats_.numReclaimedBytes += freedBytes;
+  return freedBytes;
+}
+
+uint64_t SharedArbitrator::decrementFreeCapacity(uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  const uint64_t decrementedBytes = std::min(bytes, freeCapacity_);
+  freeCapacity_ -= decrementedBytes;
+  return decrementedBytes;
+}
+
+void SharedArbitrator::incrementFreeCapacity(uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  freeCapacity_ += bytes;
+  VELOX_CHECK_LE(
+      freeCapacity_,
+      capacity_,
+      "The free capacity {} is larger than the max capacity {}, {}",
+      succinctBytes(freeCapacity_),
+      succinctBytes(capacity_),
+      toStringLocked());
+}
+
+// static
+void SharedArbitrator::reportUsageByPriority(
+    const std::vector<MemoryPool*>& candidates) {
+  if (!BaseStatsReporter::registered) {
+    return;
+  }
+  folly::F14FastMap<int32_t, int64_t> bytesByPriority;
+  for (auto* pool : candidates) {
+    bytesByPriority[pool->priority()] += pool->getCurrentBytes();
+  }
+  for (const auto& [priority, bytes] : bytesByPriority) {
+    REPORT_ADD_STAT_VALUE(
+        priorityCounterKey(kCounterQueryMemoryBytes, priority), bytes);
+  }
+}
+
+uint64_t SharedArbitrator::freeCapacity() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return freeCapacity_;
+}
+
+MemoryArbitrator::Stats SharedArbitrator::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+std::string SharedArbitrator::toString() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return toStringLocked();
+}
+
+std::string SharedArbitrator::toStringLocked() const {
+  return fmt::format(
+      "ARBITRATOR[{} CAPACITY {} FREE {} {}]",
+      kindString(kind_),
+      succinctBytes(capacity_),
+      succinctBytes(freeCapacity_),
+      stats_.toString());
+}
+} // namespace facebook::velox::memory
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+namespace facebook::velox::memory {
+
+/// Used to achieve dynamic memory sharing among running queries. When a
+/// memory pool exceeds its current memory capacity, the arbitrator tries to
+/// grow its capacity by first using the arbitrator's free capacity, then
+/// shrinking the unused capacity from the other query memory pools, and
+/// finally reclaiming the used memory from the candidate query memory pools
+/// with the most reclaimable memory through techniques such as disk spilling.
+/// The used memory is reclaimed from the pools of the lowest priority queries
+/// first, see MemoryPool::priority(). The memory arbitration requests are
+/// processed one at a time.
+class SharedArbitrator : public MemoryArbitrator {
+ public:
+  explicit SharedArbitrator(const Config& config);
+
+  bool canGrow() final {
+    return true;
+  }
+
+  int64_t reserveMemory(int64_t bytes) final;
+
+  bool growMemory(
+      MemoryPool* requestor,
+      const std::vector<MemoryPool*>& candidates,
+      uint64_t targetBytes) final;
+
+  void releaseMemory(MemoryPool* releasor) final;
+
+  Stats stats() const final;
+
+  std::string toString() const final;
+
+  /// Returns the free memory capacity in bytes which hasn't been assigned to
+  /// any memory pool.
+  uint64_t freeCapacity() const;
+
+ private:
+  // Contains the candidate memory pool's stats collected at the start of a
+  // memory arbitration run.
+  struct Candidate {
+    MemoryPool* pool;
+    int32_t priority;
+    bool reclaimable;
+    int64_t reclaimableBytes;
+    int64_t freeBytes;
+  };
+
+  static std::vector<Candidate> getCandidateStats(
+      const std::vector<MemoryPool*>& pools);
+
+  bool growMemoryLocked(
+      MemoryPool* requestor,
+      const std::vector<MemoryPool*>& candidates,
+      uint64_t targetBytes);
+
+  // Tries to free up 'targetBytes' of unused memory capacity from
+  // 'candidates' by shrinking the pools with the most free capacity first.
+  // Returns the freed capacity in bytes.
+  uint64_t reclaimFreeMemoryFromCandidates(
+      std::vector<Candidate>& candidates,
+      uint64_t targetBytes);
+
+  // Tries to free up 'targetBytes' of used memory from 'candidates' by
+  // reclaiming memory from the pools of the lowest priority queries first, and
+  // from the pools with the most reclaimable memory first among the pools of
+  // the same priority. Returns the freed capacity in bytes.
+  uint64_t reclaimUsedMemoryFromCandidates(
+      std::vector<Candidate>& candidates,
+      uint64_t targetBytes);
+
+  // Decrements the free capacity by up to 'bytes'. Returns the actually
+  // decremented capacity in bytes.
+  uint64_t decrementFreeCapacity(uint64_t bytes);
+
+  void incrementFreeCapacity(uint64_t bytes);
+
+  // Reports the memory usage of 'candidates' per query priority.
+  static void reportUsageByPriority(
+      const std::vector<MemoryPool*>& candidates);
+
+  std::string toStringLocked() const;
+
+  const uint64_t memoryPoolInitCapacity_;
+
+  // Serializes the memory arbitration runs.
+  std::mutex arbitrationMutex_;
+
+  // Protects 'freeCapacity_' and 'stats_'.
+  mutable std::mutex mutex_;
+  uint64_t freeCapacity_{0};
+};
+} // namespace facebook::velox::memory
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/memory/Memory.h"
+
+using namespace ::facebook::velox::memory;
+
+TEST(AllocationSamplerTest, sampleAll) {
+  MemoryManager manager{};
+  auto root = manager.addRootPool("root");
+  auto sampler = std::make_shared<AllocationSampler>(1);
+  root->setAllocationSampler(sampler);
+  auto first = root->addLeafChild("first");
+  auto second = root->addLeafChild("second");
+  EXPECT_EQ(sampler, first->allocationSampler());
+
+  constexpr int32_t kNumAllocations = 10;
+  std::vector<void*> buffers;
+  for (auto i = 0; i < kNumAllocations; ++i) {
+    buffers.push_back(first->allocate(1024));
+  }
+  auto* secondBuffer = second->allocate(2048);
+  for (auto i = 0; i < kNumAllocations / 2; ++i) {
+    first->free(buffers[i], 1024);
+  }
+
+  uint64_t firstAllocs = 0;
+  uint64_t firstLive = 0;
+  uint64_t secondLiveBytes = 0;
+  for (const auto& site : sampler->sites()) {
+    EXPECT_FALSE(site.stack.empty());
+    EXPECT_LE(site.stack.size(), AllocationSampler::kMaxFrames);
+    if (site.poolName == "first") {
+      firstAllocs += site.allocCount;
+      firstLive += site.liveCount;
+      EXPECT_EQ(site.liveCount * 1024, site.liveBytes);
+    } else {
+      EXPECT_EQ("second", site.poolName);
+      secondLiveBytes += site.liveBytes;
+    }
+  }
+  EXPECT_EQ(kNumAllocations, firstAllocs);
+  EXPECT_EQ(kNumAllocations / 2, firstLive);
+  EXPECT_EQ(2048, secondLiveBytes);
+
+  const auto profile = sampler->pprofProfile();
+  EXPECT_EQ(
+      0, profile.find("heap profile: 6: 7168 [11: 12288] @ heap_v2/1\n"))
+      << profile;
+  EXPECT_NE(std::string::npos, profile.find("MAPPED_LIBRARIES:"));
+  EXPECT_NE(std::string::npos, sampler->toString().find("second: 2048 bytes"));
+
+  for (auto i = kNumAllocations / 2; i < kNumAllocations; ++i) {
+    first->free(buffers[i], 1024);
+  }
+  second->free(secondBuffer, 2048);
+  for (const auto& site : sampler->sites()) {
+    EXPECT_EQ(0, site.liveCount);
+    EXPECT_EQ(0, site.liveBytes);
+  }
+}
+
+TEST(AllocationSamplerTest, sampleBytes) {
+  MemoryManager manager{};
+  auto root = manager.addRootPool("root");
+  constexpr uint64_t kSampleBytes = 64 << 10;
+  auto sampler = std::make_shared<AllocationSampler>(kSampleBytes);
+  root->setAllocationSampler(sampler);
+  auto leaf = root->addLeafChild("leaf");
+
+  // 64MB in 1KB allocations are sampled about 1000 times.
+  constexpr int32_t kNumAllocations = 64 << 10;
+  std::vector<void*> buffers;
+  for (auto i = 0; i < kNumAllocations; ++i) {
+    buffers.push_back(leaf->allocate(1024));
+  }
+  uint64_t numSamples = 0;
+  for (const auto& site : sampler->sites()) {
+    numSamples += site.allocCount;
+  }
+  EXPECT_GT(numSamples, 800);
+  EXPECT_LT(numSamples, 1200);
+  for (auto* buffer : buffers) {
+    leaf->free(buffer, 1024);
+  }
+
+  // The sampler is set before any child is added.
+  EXPECT_ANY_THROW(root->setAllocationSampler(nullptr));
+}
@@ -323,3 +323,57 @@ TEST_F(HashStringAllocatorTest, stlAllocatorOverflow) {
   AlignedStlAllocator<int64_t, 16> alignedAlloc(instance_.get());
   EXPECT_THROW(alignedAlloc.allocate(1ULL << 62), VeloxException);
 }
+
+TEST_F(HashStringAllocatorTest, compaction) {
+  constexpr int32_t kNumBlocks = 20'000;
+  constexpr int32_t kBlockSize = 100;
+  auto fill = [](HashStringAllocator::Header* header, int32_t value) {
+    memset(header->begin(), value % 256, kBlockSize);
+  };
+  auto check = [](HashStringAllocator::Header* header, int32_t value) {
+    for (auto i = 0; i < kBlockSize; ++i) {
+      ASSERT_EQ(static_cast<uint8_t>(value % 256), header->begin()[i]);
+    }
+  };
+
+  std::vector<HashStringAllocator::Header*> headers;
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    headers.push_back(instance_->allocate(kBlockSize));
+    fill(headers.back(), i);
+  }
+  // Keeps every 10th block.
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    if (i % 10 != 0) {
+      instance_->free(headers[i]);
+      headers[i] = nullptr;
+    }
+  }
+  instance_->checkConsistency();
+  EXPECT_GT(instance_->freeRatio(), 0.8);
+  const auto retainedBefore = instance_->retainedSize();
+
+  EXPECT_GT(instance_->startCompaction(0.5), 0);
+  for (auto i = 0; i < kNumBlocks; i += 10) {
+    headers[i] = instance_->relocate(headers[i]);
+    check(headers[i], i);
+  }
+  // Relocating a block again is a no-op.
+  EXPECT_EQ(headers[0], instance_->relocate(headers[0]));
+  instance_->checkConsistency();
+
+  const auto freedBytes = instance_->finishCompaction();
+  EXPECT_GT(freedBytes, 0);
+  EXPECT_EQ(retainedBefore - freedBytes, instance_->retainedSize());
+  EXPECT_LT(instance_->freeRatio(), 0.8);
+  instance_->checkConsistency();
+  for (auto i = 0; i < kNumBlocks; i += 10) {
+    check(headers[i], i);
+  }
+
+  // Without a compaction in progress, relocate() does not move anything.
+  EXPECT_EQ(headers[10], instance_->relocate(headers[10]));
+  for (auto i = 0; i < kNumBlocks; i += 10) {
+    instance_->free(headers[i]);
+  }
+  instance_->checkConsistency();
+}
@@ -657,6 +657,68 @@ TEST_P(MemoryAllocatorTest, externalAdvise) {
   EXPECT_TRUE(instance->checkConsistency());
 }
 
+TEST_P(MemoryAllocatorTest, hugePages) {
+  if (!useMmap_) {
+    return;
+  }
+  constexpr MachinePageCount kUnitSize = 128;
+  const int32_t kUnitsPerHugePage =
+      AllocationTraits::kHugePageSize / AllocationTraits::pageBytes(kUnitSize);
+  MmapAllocator::Options options;
+  options.capacity = 64 << 20;
+  options.useHugePages = true;
+  options.hugePageMinSizeClass = kUnitSize;
+  auto allocator = std::make_shared<MmapAllocator>(options);
+  const auto capacity = allocator->capacity();
+
+  // Fills the size class of 'kUnitSize' pages.
+  const int32_t numUnits = capacity / kUnitSize;
+  std::vector<std::unique_ptr<Allocation>> allocations;
+  for (auto i = 0; i < numUnits; ++i) {
+    allocations.push_back(std::make_unique<Allocation>());
+    ASSERT_TRUE(allocator->allocateNonContiguous(
+        kUnitSize, *allocations.back(), nullptr, kUnitSize));
+    ASSERT_EQ(allocations.back()->numRuns(), 1);
+  }
+  ASSERT_EQ(allocator->stats().numHugePageMapped, capacity);
+
+  // The size class is aligned to huge pages.
+  std::sort(allocations.begin(), allocations.end(), [](auto& a, auto& b) {
+    return a->runAt(0).data() < b->runAt(0).data();
+  });
+  for (auto i = 0; i < numUnits; i += kUnitsPerHugePage) {
+    ASSERT_EQ(
+        reinterpret_cast<uint64_t>(allocations[i]->runAt(0).data()) %
+            AllocationTraits::kHugePageSize,
+        0);
+  }
+
+  // Frees every other huge page and one unit of each of the others.
+  for (auto i = 0; i < numUnits; ++i) {
+    if ((i / kUnitsPerHugePage) % 2 == 0 || i % kUnitsPerHugePage == 0) {
+      allocator->freeNonContiguous(*allocations[i]);
+    }
+  }
+  ASSERT_TRUE(allocator->checkConsistency());
+
+  // Advising away to back a contiguous allocation takes the whole free huge
+  // pages, not the free units of the huge pages that back allocated memory.
+  const MachinePageCount kLargeSize = 2 * kUnitsPerHugePage * kUnitSize;
+  ContiguousAllocation large;
+  ASSERT_TRUE(allocator->allocateContiguous(kLargeSize, nullptr, large));
+  ASSERT_EQ(allocator->stats().numAdvise, kLargeSize);
+  ASSERT_TRUE(allocator->checkConsistency());
+  // The contiguous allocation is counted as huge page backed as well.
+  ASSERT_EQ(allocator->stats().numHugePageMapped, capacity);
+
+  allocator->freeContiguous(large);
+  for (auto& allocation : allocations) {
+    allocator->freeNonContiguous(*allocation);
+  }
+  ASSERT_TRUE(allocator->checkConsistency());
+  ASSERT_EQ(allocator->numAllocated(), 0);
+}
+
 TEST_P(MemoryAllocatorTest, nonContiguousFailure) {
   struct {
     MachinePageCount numOldPages;
@@ -70,7 +70,6 @@ TEST_F(MemoryArbitrationTest, kind) {
 TEST_F(MemoryArbitrationTest, create) {
   std::vector<MemoryArbitrator::Kind> kinds;
   kinds.push_back(MemoryArbitrator::Kind::kFixed);
-  kinds.push_back(MemoryArbitrator::Kind::kShared);
   kinds.push_back(static_cast<MemoryArbitrator::Kind>(100));
   for (const auto& kind : kinds) {
     MemoryArbitrator::Config config;
@@ -78,6 +77,12 @@ TEST_F(MemoryArbitrationTest, create) {
     config.kind = kind;
     VELOX_ASSERT_THROW(MemoryArbitrator::create(config), "");
   }
+  MemoryArbitrator::Config config;
+  config.capacity = 1 * GB;
+  config.kind = MemoryArbitrator::Kind::kShared;
+  auto arbitrator = MemoryArbitrator::create(config);
+  ASSERT_EQ(arbitrator->kind(), MemoryArbitrator::Kind::kShared);
+  ASSERT_TRUE(arbitrator->canGrow());
 }
 
 class MemoryReclaimerTest : public testing::Test {
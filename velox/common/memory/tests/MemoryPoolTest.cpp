@@ -557,6 +557,49 @@ TEST_P(MemoryPoolTest, MemoryManagerGlobalCap) {
   child->free(oneChunk, 32L * MB);
 }
 
+TEST_P(MemoryPoolTest, managerReservationQuantum) {
+  constexpr int64_t kQuantum = MemoryPoolImpl::kManagerReservationQuantum;
+  MemoryManager manager{{.capacity = 8 * kQuantum + 100}};
+  auto root = manager.addRootPool();
+  auto pool = root->addLeafChild("quantum", isLeafThreadSafe_);
+  auto otherPool = root->addLeafChild("otherQuantum", isLeafThreadSafe_);
+
+  // Small allocations are served from the pool's first quantum.
+  std::vector<void*> buffers;
+  for (int i = 0; i < 100; ++i) {
+    buffers.push_back(pool->allocate(1'000));
+  }
+  ASSERT_EQ(kQuantum, manager.getTotalBytes());
+  void* otherBuffer = otherPool->allocate(64);
+  ASSERT_EQ(2 * kQuantum, manager.getTotalBytes());
+
+  // A large allocation reserves whole quanta.
+  void* largeBuffer = pool->allocate(3 * kQuantum);
+  ASSERT_EQ(5 * kQuantum, manager.getTotalBytes());
+
+  // An allocation which fits only without rounding up to a quantum succeeds.
+  void* fittingBuffer = otherPool->allocate(4 * kQuantum);
+  ASSERT_EQ(8 * kQuantum + 64, manager.getTotalBytes());
+  ASSERT_THROW(otherPool->allocate(kQuantum), VeloxRuntimeError);
+  ASSERT_EQ(8 * kQuantum + 64, manager.getTotalBytes());
+
+  // The pool keeps at most one unused quantum on free.
+  pool->free(largeBuffer, 3 * kQuantum);
+  ASSERT_EQ(5 * kQuantum + 64, manager.getTotalBytes());
+  otherPool->free(fittingBuffer, 4 * kQuantum);
+  ASSERT_EQ(2 * kQuantum, manager.getTotalBytes());
+  for (auto* buffer : buffers) {
+    pool->free(buffer, 1'000);
+  }
+  otherPool->free(otherBuffer, 64);
+  ASSERT_EQ(2 * kQuantum, manager.getTotalBytes());
+
+  // The remaining reservation is returned on pool destruction.
+  pool.reset();
+  otherPool.reset();
+  ASSERT_EQ(0, manager.getTotalBytes());
+}
+
 // Tests how child updates itself and its parent's memory usage
 // and what it returns for getCurrentBytes()/getMaxBytes and
 // with memoryUsageTracker.
@@ -1929,18 +1972,35 @@ TEST(MemoryPoolTest, visitChildren) {
   }
 }
 
-TEST_P(MemoryPoolTest, shrinkAPIs) {
+TEST_P(MemoryPoolTest, shrinkAndGrowAPIs) {
   MemoryManager manager;
-  std::vector<bool> isLeafs = {true, false};
-  for (const auto isLeaf : isLeafs) {
-    SCOPED_TRACE(fmt::format("is leaf {}", isLeaf));
-    auto pool = isLeaf ? manager.addLeafPool("shrinkAPIs")
-                       : manager.addRootPool("shrinkAPIs");
-    auto* poolPtr = dynamic_cast<MemoryPoolImpl*>(pool.get());
-    VELOX_ASSERT_THROW(poolPtr->freeBytes(), "");
-    VELOX_ASSERT_THROW(poolPtr->shrink(0), "");
-    VELOX_ASSERT_THROW(poolPtr->shrink(100), "");
-  }
+  const int64_t capacity = 32 * MB;
+  auto root = manager.addRootPool("shrinkAndGrowAPIs", capacity);
+  auto leaf = root->addLeafChild("leaf");
+  ASSERT_EQ(root->freeBytes(), capacity);
+  ASSERT_EQ(leaf->freeBytes(), capacity);
+
+  const int64_t allocBytes = 1 * MB;
+  void* buffer = leaf->allocate(allocBytes);
+  const int64_t reservedBytes =
+      root->getMemoryUsageTracker()->reservedBytes();
+  ASSERT_GE(reservedBytes, allocBytes);
+  ASSERT_EQ(root->freeBytes(), capacity - reservedBytes);
+  ASSERT_EQ(leaf->freeBytes(), capacity - reservedBytes);
+
+  // Shrink from a leaf pool reduces the root pool's capacity.
+  ASSERT_EQ(leaf->shrink(MB), MB);
+  ASSERT_EQ(root->freeBytes(), capacity - reservedBytes - MB);
+  ASSERT_EQ(root->shrink(0), capacity - reservedBytes - MB);
+  ASSERT_EQ(root->freeBytes(), 0);
+  ASSERT_EQ(root->shrink(0), 0);
+  ASSERT_EQ(root->getMemoryUsageTracker()->maxMemory(), reservedBytes);
+  VELOX_ASSERT_THROW(leaf->allocate(capacity), "Exceeded memory cap");
+
+  ASSERT_EQ(root->grow(capacity), reservedBytes + capacity);
+  ASSERT_EQ(root->freeBytes(), capacity);
+  leaf->free(buffer, allocBytes);
+  ASSERT_EQ(root->freeBytes(), reservedBytes + capacity);
 }
 
 TEST_P(MemoryPoolTest, reclaimAPIsWithDefaultReclaimer) {
@@ -78,10 +78,10 @@ TEST_P(MemoryUsageTrackerTest, stats) {
   child->update(-(8 * kMB));
   ASSERT_EQ(
       parent->stats().toString(),
-      "peakBytes:9437184 cumulativeBytes:9437184 numAllocs:0 numFrees:0 numReserves:0 numReleases:0 numCollisions:0 numChildren:1");
+      "peakBytes:9437184 cumulativeBytes:9437184 numAllocs:0 numFrees:0 numReserves:0 numReleases:0 numCollisions:0 numChildren:1 predictedPeakBytes:0");
   ASSERT_EQ(
       child->stats().toString(),
-      "peakBytes:9437184 cumulativeBytes:9437184 numAllocs:2 numFrees:1 numReserves:0 numReleases:0 numCollisions:0 numChildren:0");
+      "peakBytes:9437184 cumulativeBytes:9437184 numAllocs:2 numFrees:1 numReserves:0 numReleases:0 numCollisions:0 numChildren:0 predictedPeakBytes:0");
   ASSERT_EQ(
       child->toString(),
       "<tracker used 1000B available 1023.02KB limit 1.00GB reservation [used 1000B, reserved 1.00MB, min 0B] counters [allocs 2, frees 1, reserves 0, releases 0, collisions 0, children 0])>");
@@ -509,6 +509,31 @@ TEST_P(MemoryUsageTrackerTest, maybeReserve) {
   ASSERT_EQ(stats.numCollisions, 0);
 }
 
+TEST_P(MemoryUsageTrackerTest, reservePredictedPeak) {
+  constexpr int64_t kMB = 1 << 20;
+  auto parent = memory::MemoryUsageTracker::create(20 * kMB);
+  auto child = parent->addChild(true, isLeafTrackerThreadSafe_);
+  child->update(kMB);
+  // Reserves up to the predicted peak in 8MB quanta.
+  ASSERT_TRUE(child->reservePredictedPeak(5 * kMB));
+  ASSERT_EQ(kMB, child->currentBytes());
+  ASSERT_EQ(9 * kMB, child->reservedBytes());
+  ASSERT_EQ(5 * kMB, child->stats().predictedPeakBytes);
+  // A peak within the reservation does not change it.
+  ASSERT_TRUE(child->reservePredictedPeak(9 * kMB));
+  ASSERT_EQ(9 * kMB, child->reservedBytes());
+  ASSERT_EQ(9 * kMB, child->stats().predictedPeakBytes);
+  // A peak above the limit fails without changing the reservation.
+  ASSERT_FALSE(child->reservePredictedPeak(30 * kMB));
+  ASSERT_EQ(9 * kMB, child->reservedBytes());
+  ASSERT_EQ(30 * kMB, child->stats().predictedPeakBytes);
+  // A smaller prediction keeps the largest one in the stats.
+  ASSERT_TRUE(child->reservePredictedPeak(2 * kMB));
+  ASSERT_EQ(30 * kMB, child->stats().predictedPeakBytes);
+  child->update(-kMB);
+  child->release();
+}
+
 TEST_P(MemoryUsageTrackerTest, validCheck) {
   constexpr int64_t kMB = 1 << 20;
   auto parent = memory::MemoryUsageTracker::create(10 * kMB);
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <deque>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/common/memory/SharedArbitrator.h"
+
+using namespace ::testing;
+
+constexpr int64_t KB = 1024L;
+constexpr int64_t MB = 1024L * KB;
+
+namespace facebook::velox::memory {
+namespace {
+// Reclaims memory from a leaf memory pool by freeing all the recorded
+// allocations.
+class MockLeafMemoryReclaimer : public MemoryReclaimer {
+ public:
+  ~MockLeafMemoryReclaimer() override {
+    VELOX_CHECK(allocations_.empty());
+  }
+
+  bool canReclaim(const MemoryPool& /*unused*/) const override {
+    return true;
+  }
+
+  uint64_t reclaimableBytes(const MemoryPool& /*unused*/) const override {
+    std::lock_guard<std::mutex> l(mu_);
+    uint64_t sumBytes{0};
+    for (const auto& allocation : allocations_) {
+      sumBytes += allocation.size;
+    }
+    return sumBytes;
+  }
+
+  uint64_t reclaim(MemoryPool* pool, uint64_t /*unused*/) override {
+    ++numReclaims_;
+    std::lock_guard<std::mutex> l(mu_);
+    uint64_t reclaimedBytes{0};
+    for (const auto& allocation : allocations_) {
+      pool->free(allocation.buffer, allocation.size);
+      reclaimedBytes += allocation.size;
+    }
+    allocations_.clear();
+    pool->getMemoryUsageTracker()->release();
+    return reclaimedBytes;
+  }
+
+  void addAllocation(void* buffer, size_t size) {
+    std::lock_guard<std::mutex> l(mu_);
+    allocations_.push_back({buffer, size});
+  }
+
+  void freeAll(MemoryPool* pool) {
+    reclaim(pool, 0);
+  }
+
+  int numReclaims() const {
+    return numReclaims_;
+  }
+
+ private:
+  struct Allocation {
+    void* buffer;
+    size_t size;
+  };
+
+  mutable std::mutex mu_;
+  std::deque<Allocation> allocations_;
+  std::atomic<int> numReclaims_{0};
+};
+} // namespace
+
+class SharedArbitratorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    setupMemory();
+  }
+
+  void setupMemory(
+      int64_t capacity = 512 * MB,
+      int64_t memoryPoolInitCapacity = 128 * MB) {
+    IMemoryManager::Options options;
+    options.capacity = capacity;
+    options.arbitratorKind = MemoryArbitrator::Kind::kShared;
+    options.memoryPoolInitCapacity = memoryPoolInitCapacity;
+    manager_ = std::make_unique<MemoryManager>(options);
+    arbitrator_ = dynamic_cast<SharedArbitrator*>(manager_->arbitrator());
+    ASSERT_NE(arbitrator_, nullptr);
+  }
+
+  static int64_t capacity(const std::shared_ptr<MemoryPool>& root) {
+    return root->getMemoryUsageTracker()->maxMemory();
+  }
+
+  std::unique_ptr<MemoryManager> manager_;
+  SharedArbitrator* arbitrator_;
+};
+
+TEST_F(SharedArbitratorTest, reserveAndRelease) {
+  ASSERT_EQ(arbitrator_->kind(), MemoryArbitrator::Kind::kShared);
+  ASSERT_EQ(arbitrator_->freeCapacity(), 512 * MB);
+
+  std::vector<std::shared_ptr<MemoryPool>> roots;
+  for (int i = 0; i < 4; ++i) {
+    roots.push_back(manager_->addRootPool(fmt::format("root{}", i)));
+    ASSERT_EQ(capacity(roots.back()), 128 * MB);
+    ASSERT_EQ(arbitrator_->freeCapacity(), (3 - i) * 128 * MB);
+  }
+  // The arbitrator has no more free capacity to reserve for a new pool.
+  roots.push_back(manager_->addRootPool("root4"));
+  ASSERT_EQ(capacity(roots.back()), 0);
+
+  // The reserved capacity is capped by the max capacity of a root pool.
+  roots.clear();
+  ASSERT_EQ(arbitrator_->freeCapacity(), 512 * MB);
+  auto root = manager_->addRootPool("smallRoot", 64 * MB);
+  ASSERT_EQ(capacity(root), 64 * MB);
+  ASSERT_EQ(arbitrator_->freeCapacity(), 448 * MB);
+  root.reset();
+  ASSERT_EQ(arbitrator_->freeCapacity(), 512 * MB);
+  ASSERT_EQ(arbitrator_->stats().numRequests, 0);
+}
+
+TEST_F(SharedArbitratorTest, growFromFreeCapacity) {
+  auto root = manager_->addRootPool("growFromFreeCapacity");
+  auto leaf = root->addLeafChild("leaf");
+  ASSERT_EQ(capacity(root), 128 * MB);
+
+  void* buffer = leaf->allocate(200 * MB);
+  ASSERT_GE(capacity(root), 200 * MB);
+  ASSERT_EQ(arbitrator_->freeCapacity(), 512 * MB - capacity(root));
+  auto stats = arbitrator_->stats();
+  ASSERT_EQ(stats.numRequests, 1);
+  ASSERT_EQ(stats.numFailures, 0);
+  ASSERT_EQ(stats.numShrunkBytes, 0);
+  ASSERT_EQ(stats.numReclaimedBytes, 0);
+
+  leaf->free(buffer, 200 * MB);
+  leaf.reset();
+  root.reset();
+  ASSERT_EQ(arbitrator_->freeCapacity(), 512 * MB);
+}
+
+TEST_F(SharedArbitratorTest, growByShrinkingOtherPools) {
+  setupMemory(512 * MB, 256 * MB);
+  auto root1 = manager_->addRootPool("root1");
+  auto leaf1 = root1->addLeafChild("leaf1");
+  auto root2 = manager_->addRootPool("root2");
+  auto leaf2 = root2->addLeafChild("leaf2");
+  ASSERT_EQ(arbitrator_->freeCapacity(), 0);
+
+  void* buffer1 = leaf1->allocate(16 * MB);
+  // 'root2' grows by shrinking the unused capacity of 'root1'.
+  void* buffer2 = leaf2->allocate(384 * MB);
+  ASSERT_GE(capacity(root2), 384 * MB);
+  ASSERT_GE(capacity(root1), 16 * MB);
+  ASSERT_LE(capacity(root1) + capacity(root2), 512 * MB);
+  auto stats = arbitrator_->stats();
+  ASSERT_EQ(stats.numRequests, 1);
+  ASSERT_EQ(stats.numFailures, 0);
+  ASSERT_GT(stats.numShrunkBytes, 0);
+  ASSERT_EQ(stats.numReclaimedBytes, 0);
+
+  leaf1->free(buffer1, 16 * MB);
+  leaf2->free(buffer2, 384 * MB);
+}
+
+TEST_F(SharedArbitratorTest, growByReclaimingUsedMemory) {
+  setupMemory(512 * MB, 256 * MB);
+  auto reclaimer = std::make_shared<MockLeafMemoryReclaimer>();
+  auto root1 = manager_->addRootPool(
+      "root1", kMaxMemory, true, MemoryReclaimer::create());
+  auto leaf1 = root1->addLeafChild("leaf1", true, reclaimer);
+  auto root2 = manager_->addRootPool("root2");
+  auto leaf2 = root2->addLeafChild("leaf2");
+
+  for (int i = 0; i < 4; ++i) {
+    reclaimer->addAllocation(leaf1->allocate(64 * MB), 64 * MB);
+  }
+  ASSERT_TRUE(root1->canReclaim());
+  ASSERT_EQ(root1->reclaimableBytes(), 256 * MB);
+
+  // 'root2' grows by reclaiming the used memory from 'root1'.
+  void* buffer2 = leaf2->allocate(384 * MB);
+  ASSERT_EQ(reclaimer->numReclaims(), 1);
+  ASSERT_EQ(leaf1->getCurrentBytes(), 0);
+  ASSERT_GE(capacity(root2), 384 * MB);
+  ASSERT_LE(capacity(root1) + capacity(root2), 512 * MB);
+  auto stats = arbitrator_->stats();
+  ASSERT_EQ(stats.numRequests, 1);
+  ASSERT_EQ(stats.numFailures, 0);
+  ASSERT_GT(stats.numReclaimedBytes, 0);
+
+  leaf2->free(buffer2, 384 * MB);
+}
+
+TEST_F(SharedArbitratorTest, reclaimLowerPriorityFirst) {
+  setupMemory(512 * MB, 256 * MB);
+  auto highReclaimer = std::make_shared<MockLeafMemoryReclaimer>();
+  auto highRoot = manager_->addRootPool(
+      "highRoot", kMaxMemory, true, MemoryReclaimer::create());
+  highRoot->setPriority(1);
+  auto highLeaf = highRoot->addLeafChild("highLeaf", true, highReclaimer);
+  auto lowReclaimer = std::make_shared<MockLeafMemoryReclaimer>();
+  auto lowRoot = manager_->addRootPool(
+      "lowRoot", kMaxMemory, true, MemoryReclaimer::create());
+  auto lowLeaf = lowRoot->addLeafChild("lowLeaf", true, lowReclaimer);
+  ASSERT_EQ(lowRoot->priority(), 0);
+  VELOX_ASSERT_THROW(
+      lowLeaf->setPriority(1), "Only a root memory pool has a priority");
+
+  for (int i = 0; i < 4; ++i) {
+    highReclaimer->addAllocation(highLeaf->allocate(64 * MB), 64 * MB);
+  }
+  for (int i = 0; i < 3; ++i) {
+    lowReclaimer->addAllocation(lowLeaf->allocate(64 * MB), 64 * MB);
+  }
+  ASSERT_GT(highRoot->reclaimableBytes(), lowRoot->reclaimableBytes());
+
+  // The used memory is reclaimed from the lower priority pool although the
+  // higher priority one has more reclaimable memory.
+  auto root = manager_->addRootPool("root");
+  auto leaf = root->addLeafChild("leaf");
+  void* buffer = leaf->allocate(128 * MB);
+  ASSERT_EQ(lowReclaimer->numReclaims(), 1);
+  ASSERT_EQ(lowLeaf->getCurrentBytes(), 0);
+  ASSERT_EQ(highReclaimer->numReclaims(), 0);
+  ASSERT_EQ(highLeaf->getCurrentBytes(), 256 * MB);
+
+  leaf->free(buffer, 128 * MB);
+  highReclaimer->freeAll(highLeaf.get());
+}
+
+TEST_F(SharedArbitratorTest, growFailure) {
+  setupMemory(512 * MB, 256 * MB);
+  auto root1 = manager_->addRootPool("root1");
+  auto leaf1 = root1->addLeafChild("leaf1");
+  auto root2 = manager_->addRootPool("root2");
+  auto leaf2 = root2->addLeafChild("leaf2");
+
+  void* buffer1 = leaf1->allocate(240 * MB);
+  // 'root1' is not reclaimable so there is not enough memory to grow 'root2'.
+  VELOX_ASSERT_THROW(leaf2->allocate(384 * MB), "Exceeded memory cap");
+  auto stats = arbitrator_->stats();
+  ASSERT_EQ(stats.numRequests, 1);
+  ASSERT_EQ(stats.numFailures, 1);
+  // The shrunk memory is returned to the arbitrator on failure.
+  ASSERT_EQ(
+      arbitrator_->freeCapacity() + capacity(root1) + capacity(root2),
+      512 * MB);
+
+  // 'root2' can't grow beyond its max capacity.
+  auto root3 = manager_->addRootPool("root3", 64 * MB);
+  auto leaf3 = root3->addLeafChild("leaf3");
+  VELOX_ASSERT_THROW(leaf3->allocate(128 * MB), "Exceeded memory cap");
+  ASSERT_EQ(arbitrator_->stats().numRequests, 1);
+
+  leaf1->free(buffer1, 240 * MB);
+}
+
+TEST_F(SharedArbitratorTest, reclaimFailure) {
+  class FailedReclaimer : public MemoryReclaimer {
+   public:
+    bool canReclaim(const MemoryPool& /*unused*/) const override {
+      return true;
+    }
+
+    uint64_t reclaimableBytes(const MemoryPool& pool) const override {
+      return pool.getCurrentBytes();
+    }
+
+    uint64_t reclaim(MemoryPool* /*unused*/, uint64_t /*unused*/) override {
+      VELOX_FAIL("Injected reclaim failure");
+    }
+  };
+  setupMemory(512 * MB, 256 * MB);
+  auto root1 = manager_->addRootPool(
+      "root1", kMaxMemory, true, MemoryReclaimer::create());
+  auto leaf1 =
+      root1->addLeafChild("leaf1", true, std::make_shared<FailedReclaimer>());
+  auto root2 = manager_->addRootPool("root2");
+  auto leaf2 = root2->addLeafChild("leaf2");
+
+  void* buffer1 = leaf1->allocate(240 * MB);
+  VELOX_ASSERT_THROW(leaf2->allocate(384 * MB), "Exceeded memory cap");
+  ASSERT_EQ(arbitrator_->stats().numFailures, 1);
+  ASSERT_EQ(leaf1->getCurrentBytes(), 240 * MB);
+
+  leaf1->free(buffer1, 240 * MB);
+}
+
+TEST_F(SharedArbitratorTest, toString) {
+  ASSERT_EQ(
+      arbitrator_->toString(),
+      "ARBITRATOR[SHARED CAPACITY 512.00MB FREE 512.00MB STATS[numRequests 0 numFailures 0 numQueuedRequests 0 queueTime 0us arbitrationTime 0us shrunkMemory 0B reclaimedMemory 0B]]");
+}
+} // namespace facebook::velox::memory
@@ -20,7 +20,11 @@
 #include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
 
+#include <folly/Conv.h>
 #include <folly/CpuId.h>
 #include <folly/FileUtil.h>
 #include <folly/String.h>
@@ -103,6 +107,63 @@ uint64_t threadCpuNanos() {
   return ts.tv_sec * 1'000'000'000 + ts.tv_nsec;
 }
 
+namespace {
+// Upper bound on the NUMA node ids probed in sysfs.
+constexpr int32_t kMaxNumaNodes = 64;
+
+// Returns the NUMA node of each CPU as listed in sysfs, indexed by CPU. CPUs
+// that no node lists map to 0.
+std::vector<int32_t> readCpuNumaNodes() {
+  std::vector<int32_t> cpuNodes;
+#ifdef __linux__
+  for (int32_t node = 0; node < kMaxNumaNodes; ++node) {
+    std::string cpuList;
+    const auto path = "/sys/devices/system/node/node" +
+        std::to_string(node) + "/cpulist";
+    if (!folly::readFile(path.c_str(), cpuList)) {
+      continue;
+    }
+    // The list looks like "0-3,8-11".
+    std::vector<folly::StringPiece> ranges;
+    folly::split(',', folly::trimWhitespace(cpuList), ranges);
+    for (auto range : ranges) {
+      if (range.empty()) {
+        continue;
+      }
+      folly::StringPiece first;
+      folly::StringPiece last;
+      if (!folly::split('-', range, first, last)) {
+        first = range;
+        last = range;
+      }
+      const auto begin = folly::to<int32_t>(first);
+      const auto end = folly::to<int32_t>(last);
+      if (cpuNodes.size() <= static_cast<size_t>(end)) {
+        cpuNodes.resize(end + 1, 0);
+      }
+      for (auto cpu = begin; cpu <= end; ++cpu) {
+        cpuNodes[cpu] = node;
+      }
+    }
+  }
+#endif
+  return cpuNodes;
+}
+} // namespace
+
+int32_t getNumaNode() {
+#ifdef __linux__
+  // sched_getcpu() goes through the vDSO and does not enter the kernel, so
+  // this is cheap enough to call once per batch or quantum.
+  static const std::vector<int32_t> cpuNodes = readCpuNumaNodes();
+  const auto cpu = sched_getcpu();
+  if (cpu >= 0 && static_cast<size_t>(cpu) < cpuNodes.size()) {
+    return cpuNodes[cpu];
+  }
+#endif
+  return 0;
+}
+
 namespace {
 bool bmi2CpuFlag = folly::CpuId().bmi2();
 bool avx2CpuFlag = folly::CpuId().avx2();
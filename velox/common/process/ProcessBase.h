@@ -55,6 +55,12 @@ std::string getCurrentDirectory();
  */
 uint64_t threadCpuNanos();
 
+/**
+ * Returns the NUMA node of the CPU that the calling thread runs on, or 0 if
+ * the platform doesn't tell.
+ */
+int32_t getNumaNode();
+
 // True if the machine has Intel AVX2 instructions and these are not disabled by
 // flag.
 bool hasAvx2();
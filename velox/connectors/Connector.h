@@ -55,6 +55,27 @@ struct ConnectorSplit {
   virtual std::string toString() const {
     return fmt::format("[split: {}]", connectorId);
   }
+
+  /// Returns the number of bytes to read for this split, or 0 if not known.
+  virtual uint64_t size() const {
+    return 0;
+  }
+
+  /// Divides this split into splits which read consecutive byte ranges of at
+  /// most 'maxBytes' and together read the same rows as this. Returns an empty
+  /// list if this split can't be divided or is not larger than 'maxBytes'.
+  virtual std::vector<std::shared_ptr<ConnectorSplit>> splitIntoMorsels(
+      uint64_t /*maxBytes*/) const {
+    return {};
+  }
+
+  /// Returns a string that identifies the data of this split if the data is
+  /// known not to change, e.g. a file with a known modification time, or
+  /// std::nullopt otherwise. Used to cache the results of scanning the split,
+  /// see Connector::resultCacheKey().
+  virtual std::optional<std::string> resultCacheKey() const {
+    return std::nullopt;
+  }
 };
 
 class ColumnHandle {
@@ -116,6 +137,19 @@ class DataSink {
   virtual std::vector<std::string> finish() const = 0;
 
   virtual void close() = 0;
+
+  /// Returns true if the sink can free memory by flushing its buffered data,
+  /// see reclaim().
+  virtual bool canReclaim() const {
+    return false;
+  }
+
+  /// Frees at least 'targetBytes' of buffered memory if possible, e.g. by
+  /// flushing buffered data to storage. If 'targetBytes' is zero, frees as
+  /// much as possible. Returns the number of bytes freed.
+  virtual uint64_t reclaim(uint64_t /*targetBytes*/) {
+    return 0;
+  }
 };
 
 class DataSource {
@@ -220,7 +254,9 @@ class ConnectorQueryCtx {
       memory::MemoryAllocator* FOLLY_NONNULL allocator,
       const std::string& taskId,
       const std::string& planNodeId,
-      int driverId)
+      int driverId,
+      std::string spillPath = "",
+      folly::Executor* spillExecutor = nullptr)
       : operatorPool_(operatorPool),
         connectorPool_(connectorPool),
         config_(connectorConfig),
@@ -228,7 +264,9 @@ class ConnectorQueryCtx {
         allocator_(allocator),
         scanId_(fmt::format("{}.{}", taskId, planNodeId)),
         taskId_(taskId),
-        driverId_(driverId) {}
+        driverId_(driverId),
+        spillPath_(std::move(spillPath)),
+        spillExecutor_(spillExecutor) {}
 
   /// Returns the associated operator's memory pool which is a leaf kind of
   /// memory pool, used for direct memory allocation use.
@@ -273,6 +311,19 @@ class ConnectorQueryCtx {
     return driverId_;
   }
 
+  /// Returns the file path prefix for the spill files of the associated
+  /// operator, or an empty string if spilling is disabled. A connector may
+  /// spill to it, e.g. the sort buffers of a sorted table write.
+  const std::string& spillPath() const {
+    return spillPath_;
+  }
+
+  /// Executor for writing spill files. If nullptr spilling writes on the
+  /// calling thread.
+  folly::Executor* FOLLY_NULLABLE spillExecutor() const {
+    return spillExecutor_;
+  }
+
  private:
   memory::MemoryPool* operatorPool_;
   memory::MemoryPool* connectorPool_;
@@ -282,6 +333,8 @@ class ConnectorQueryCtx {
   const std::string scanId_;
   const std::string taskId_;
   const int driverId_;
+  const std::string spillPath_;
+  folly::Executor* const FOLLY_NULLABLE spillExecutor_;
 };
 
 class Connector {
@@ -315,6 +368,21 @@ class Connector {
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
       ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx) = 0;
 
+  /// Returns a string that identifies the rows a DataSource created with the
+  /// same arguments produces for a given split, or std::nullopt if the rows
+  /// can't be identified, e.g. because a filter is not deterministic. The rows
+  /// of splits with the same ConnectorSplit::resultCacheKey() that are read
+  /// by DataSources with the same key are the same, so that they can be
+  /// cached.
+  virtual std::optional<std::string> resultCacheKey(
+      const RowTypePtr& /*outputType*/,
+      const std::shared_ptr<connector::ConnectorTableHandle>& /*tableHandle*/,
+      const std::unordered_map<
+          std::string,
+          std::shared_ptr<connector::ColumnHandle>>& /*columnHandles*/) const {
+    return std::nullopt;
+  }
+
   // Returns true if addSplit of DataSource can use 'dataSource' from
   // ConnectorSplit in addSplit(). If so, TableScan can preload splits
   // so that file opening and metadata operations are off the Driver'
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/HiveBucketUtil.h"
+
+#include <numeric>
+
+#include "velox/connectors/hive/HivePartitionFunction.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::connector::hive {
+namespace {
+
+// Appends the values in [lower, upper] to 'values'. Returns false if this
+// makes more than 'maxValues' values.
+bool addRange(
+    int64_t lower,
+    int64_t upper,
+    int32_t maxValues,
+    std::vector<int64_t>& values) {
+  if (lower > upper) {
+    return true;
+  }
+  // The difference does not overflow as unsigned.
+  const auto numValues =
+      static_cast<uint64_t>(upper) - static_cast<uint64_t>(lower) + 1;
+  if (numValues == 0 || values.size() + numValues > maxValues) {
+    return false;
+  }
+  for (auto value = lower;; ++value) {
+    values.push_back(value);
+    if (value == upper) {
+      return true;
+    }
+  }
+}
+
+// Returns the values of an integer column that pass 'filter', not counting
+// null, or std::nullopt if these are not known or more than 'maxValues'.
+std::optional<std::vector<int64_t>> integerValues(
+    const common::Filter& filter,
+    int32_t maxValues) {
+  std::vector<int64_t> values;
+  switch (filter.kind()) {
+    case common::FilterKind::kAlwaysFalse:
+    case common::FilterKind::kIsNull:
+      return values;
+    case common::FilterKind::kBigintRange: {
+      const auto& range = static_cast<const common::BigintRange&>(filter);
+      if (!addRange(range.lower(), range.upper(), maxValues, values)) {
+        return std::nullopt;
+      }
+      return values;
+    }
+    case common::FilterKind::kBigintMultiRange:
+      for (const auto& range :
+           static_cast<const common::BigintMultiRange&>(filter).ranges()) {
+        if (!addRange(range->lower(), range->upper(), maxValues, values)) {
+          return std::nullopt;
+        }
+      }
+      return values;
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      values =
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values();
+      break;
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      values =
+          static_cast<const common::BigintValuesUsingBitmask&>(filter).values();
+      break;
+    default:
+      return std::nullopt;
+  }
+  if (values.size() > maxValues) {
+    return std::nullopt;
+  }
+  return values;
+}
+
+std::optional<std::vector<std::string>> stringValues(
+    const common::Filter& filter,
+    int32_t maxValues) {
+  std::vector<std::string> values;
+  switch (filter.kind()) {
+    case common::FilterKind::kAlwaysFalse:
+    case common::FilterKind::kIsNull:
+      return values;
+    case common::FilterKind::kBytesRange: {
+      const auto& range = static_cast<const common::BytesRange&>(filter);
+      if (!range.isSingleValue()) {
+        return std::nullopt;
+      }
+      values.push_back(range.lower());
+      return values;
+    }
+    case common::FilterKind::kBytesValues: {
+      const auto& set =
+          static_cast<const common::BytesValues&>(filter).values();
+      if (set.size() > maxValues) {
+        return std::nullopt;
+      }
+      values.assign(set.begin(), set.end());
+      return values;
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<std::vector<bool>> booleanValues(const common::Filter& filter) {
+  std::vector<bool> values;
+  switch (filter.kind()) {
+    case common::FilterKind::kAlwaysFalse:
+    case common::FilterKind::kIsNull:
+      return values;
+    case common::FilterKind::kBoolValue:
+      for (auto value : {false, true}) {
+        if (filter.testBool(value)) {
+          values.push_back(value);
+        }
+      }
+      return values;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Returns a vector of 'values' and a trailing null if 'withNull'.
+template <typename T, typename U>
+VectorPtr makeValues(
+    const TypePtr& type,
+    const std::vector<U>& values,
+    bool withNull,
+    memory::MemoryPool* pool) {
+  auto vector = BaseVector::create<FlatVector<T>>(
+      type, values.size() + (withNull ? 1 : 0), pool);
+  for (auto i = 0; i < values.size(); ++i) {
+    vector->set(i, T(values[i]));
+  }
+  if (withNull) {
+    vector->setNull(values.size(), true);
+  }
+  return vector;
+}
+
+// Returns the values of an integer column of type T that pass 'filter'.
+// Drops the values that are outside of the range of T, which match no row.
+template <typename T>
+std::optional<VectorPtr> integerColumnValues(
+    const TypePtr& type,
+    const common::Filter& filter,
+    int32_t maxValues,
+    memory::MemoryPool* pool) {
+  auto values = integerValues(filter, maxValues);
+  if (!values.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<int64_t> inRange;
+  for (auto value : values.value()) {
+    if (value >= std::numeric_limits<T>::min() &&
+        value <= std::numeric_limits<T>::max()) {
+      inRange.push_back(value);
+    }
+  }
+  return makeValues<T>(type, inRange, filter.testNull(), pool);
+}
+
+// Returns a vector of the values of a bucketing column that pass 'filter',
+// including a null if the filter passes nulls.
+std::optional<VectorPtr> columnValues(
+    const TypePtr& type,
+    const common::Filter& filter,
+    int32_t maxValues,
+    memory::MemoryPool* pool) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN: {
+      auto values = booleanValues(filter);
+      if (!values.has_value()) {
+        return std::nullopt;
+      }
+      return makeValues<bool>(type, values.value(), filter.testNull(), pool);
+    }
+    case TypeKind::TINYINT:
+      return integerColumnValues<int8_t>(type, filter, maxValues, pool);
+    case TypeKind::SMALLINT:
+      return integerColumnValues<int16_t>(type, filter, maxValues, pool);
+    case TypeKind::INTEGER:
+      return integerColumnValues<int32_t>(type, filter, maxValues, pool);
+    case TypeKind::BIGINT:
+      return integerColumnValues<int64_t>(type, filter, maxValues, pool);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY: {
+      auto values = stringValues(filter, maxValues);
+      if (!values.has_value()) {
+        return std::nullopt;
+      }
+      return makeValues<StringView>(
+          type, values.value(), filter.testNull(), pool);
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+} // namespace
+
+std::optional<std::vector<int32_t>> bucketsForFilters(
+    const HiveBucketProperty& bucketProperty,
+    const common::ScanSpec& scanSpec,
+    memory::MemoryPool* pool,
+    int32_t maxValues) {
+  const auto numColumns = bucketProperty.columnNames.size();
+  VELOX_CHECK_EQ(numColumns, bucketProperty.columnTypes.size());
+  VELOX_CHECK_GT(bucketProperty.numBuckets, 0);
+  if (numColumns == 0) {
+    return std::nullopt;
+  }
+
+  // The values of each column that pass its filter. Each combination of one
+  // value per column is a row of the bucketing columns that may pass.
+  std::vector<VectorPtr> columnCandidates;
+  uint64_t numCombinations = 1;
+  for (auto i = 0; i < numColumns; ++i) {
+    const auto* spec = scanSpec.childByName(bucketProperty.columnNames[i]);
+    if (!spec || !spec->filter()) {
+      return std::nullopt;
+    }
+    auto values = columnValues(
+        bucketProperty.columnTypes[i], *spec->filter(), maxValues, pool);
+    if (!values.has_value()) {
+      return std::nullopt;
+    }
+    numCombinations *= values.value()->size();
+    if (numCombinations > maxValues) {
+      return std::nullopt;
+    }
+    columnCandidates.push_back(std::move(values.value()));
+  }
+  if (numCombinations == 0) {
+    return std::vector<int32_t>{};
+  }
+
+  // Makes the combinations by wrapping the candidates of each column in
+  // indices that cycle through them.
+  std::vector<VectorPtr> columns;
+  vector_size_t stride = 1;
+  for (auto& candidates : columnCandidates) {
+    const auto numCandidates = candidates->size();
+    auto indices = allocateIndices(numCombinations, pool);
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto row = 0; row < numCombinations; ++row) {
+      rawIndices[row] = (row / stride) % numCandidates;
+    }
+    stride *= numCandidates;
+    columns.push_back(BaseVector::wrapInDictionary(
+        nullptr, indices, numCombinations, std::move(candidates)));
+  }
+  auto input = std::make_shared<RowVector>(
+      pool,
+      ROW(std::vector<std::string>(bucketProperty.columnNames),
+          std::vector<TypePtr>(bucketProperty.columnTypes)),
+      nullptr,
+      numCombinations,
+      std::move(columns));
+
+  std::vector<int> bucketToPartition(bucketProperty.numBuckets);
+  std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+  std::vector<column_index_t> keyChannels(numColumns);
+  std::iota(keyChannels.begin(), keyChannels.end(), 0);
+  HivePartitionFunction function(
+      bucketProperty.numBuckets,
+      std::move(bucketToPartition),
+      std::move(keyChannels));
+  std::vector<uint32_t> buckets;
+  function.partition(*input, buckets);
+
+  std::sort(buckets.begin(), buckets.end());
+  buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+  return std::vector<int32_t>(buckets.begin(), buckets.end());
+}
+
+int32_t bucketSplitGroup(
+    const HiveConnectorSplit& split,
+    int32_t numSplitGroups) {
+  VELOX_CHECK_GT(numSplitGroups, 0);
+  VELOX_CHECK(
+      split.tableBucketNumber.has_value(),
+      "Split has no bucket number: {}",
+      split.toString());
+  return split.tableBucketNumber.value() % numSplitGroups;
+}
+
+std::vector<exec::Split> makeBucketedSplits(
+    const std::vector<std::shared_ptr<HiveConnectorSplit>>& splits,
+    int32_t numSplitGroups) {
+  std::vector<exec::Split> result;
+  result.reserve(splits.size());
+  for (const auto& split : splits) {
+    const auto groupId = bucketSplitGroup(*split, numSplitGroups);
+    result.emplace_back(
+        std::shared_ptr<connector::ConnectorSplit>(split), groupId);
+  }
+  return result;
+}
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/exec/Split.h"
+
+namespace facebook::velox::connector::hive {
+
+/// The bucketing of a table. The rows of a file of bucket 'b' have
+/// (hash & INT32_MAX) % 'numBuckets' == b for the Hive hash of 'columns', as
+/// HivePartitionFunction computes it.
+struct HiveBucketProperty {
+  int32_t numBuckets;
+  std::vector<std::string> columnNames;
+  std::vector<TypePtr> columnTypes;
+};
+
+/// Returns the buckets that may have rows that pass the filters of
+/// 'scanSpec' on the bucketing columns, in ascending order. Returns
+/// std::nullopt if a bucketing column has no filter or a filter that passes
+/// more than 'maxValues' values, or if the combinations of the values of all
+/// the columns are more than 'maxValues'. Supports boolean, integer and
+/// varchar bucketing columns.
+std::optional<std::vector<int32_t>> bucketsForFilters(
+    const HiveBucketProperty& bucketProperty,
+    const common::ScanSpec& scanSpec,
+    memory::MemoryPool* pool,
+    int32_t maxValues = 1'024);
+
+/// Returns the split group of 'split' for grouped execution with
+/// 'numSplitGroups' groups. The splits of the same bucket are in the same
+/// group, and so are the splits of the matching buckets of tables that are
+/// bucketed on the join keys, so that the join of the tables runs per group
+/// without a shuffle. 'numSplitGroups' must divide the number of buckets of
+/// all the tables. Throws if 'split' has no bucket number.
+int32_t bucketSplitGroup(
+    const HiveConnectorSplit& split,
+    int32_t numSplitGroups);
+
+/// Returns 'splits' with their split group set by bucketSplitGroup().
+std::vector<exec::Split> makeBucketedSplits(
+    const std::vector<std::shared_ptr<HiveConnectorSplit>>& splits,
+    int32_t numSplitGroups);
+
+} // namespace facebook::velox::connector::hive
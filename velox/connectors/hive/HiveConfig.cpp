@@ -57,6 +57,16 @@ bool HiveConfig::immutablePartitions(const Config* config) {
   return config->get<bool>(kImmutablePartitions, false);
 }
 
+// static
+uint64_t HiveConfig::sortedWriteSpillMemoryThreshold(const Config* config) {
+  return config->get<uint64_t>(kSortedWriteSpillMemoryThreshold, 128 << 20);
+}
+
+// static
+uint64_t HiveConfig::writersMemoryBudget(const Config* config) {
+  return config->get<uint64_t>(kWritersMemoryBudget, 0);
+}
+
 bool HiveConfig::isCaseSensitive(const Config* config) {
   return config->get<bool>(kCaseSensitive, true);
 }
@@ -39,6 +39,16 @@ class HiveConfig {
   /// Velox currently does not support appending data to existing partitions.
   static constexpr const char* kImmutablePartitions = "immutable_partitions";
 
+  /// The memory in bytes that all the open file writers of a single table
+  /// writer may buffer. When it is exceeded, the writers with the most
+  /// buffered data flush their stripes. If it is zero, there is no such limit.
+  static constexpr const char* kWritersMemoryBudget = "writers_memory_budget";
+
+  /// The memory in bytes that the sort buffer of a file of a sorted table may
+  /// use before it is spilled, if spilling is enabled.
+  static constexpr const char* kSortedWriteSpillMemoryThreshold =
+      "sorted_write_spill_memory_threshold";
+
   static InsertExistingPartitionsBehavior insertExistingPartitionsBehavior(
       const Config* config);
 
@@ -46,6 +56,10 @@ class HiveConfig {
 
   static bool immutablePartitions(const Config* config);
 
+  static uint64_t sortedWriteSpillMemoryThreshold(const Config* config);
+
+  static uint64_t writersMemoryBudget(const Config* config);
+
   static constexpr const char* kCaseSensitive = "case_sensitive";
 
   static bool isCaseSensitive(const Config* config);
@@ -28,6 +28,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include <memory>
+#include <numeric>
 
 using namespace facebook::velox::exec;
 using namespace facebook::velox::dwrf;
@@ -37,10 +38,68 @@ DEFINE_int32(
     16,
     "Amount of space for the file handle cache in mb.");
 
+DEFINE_int32(
+    file_metadata_cache_mb,
+    128,
+    "Amount of space for the parsed file footers shared across queries in mb. "
+    "0 disables the cache.");
+
 namespace facebook::velox::connector::hive {
 namespace {
 static const char* kPath = "$path";
 static const char* kBucket = "$bucket";
+
+// Evaluates the remaining filter of a HiveTableHandle in the struct reader of
+// the file, after the pushed down subfield filters and before reading the
+// columns that have no filter.
+class RemainingFilter : public common::MultiColumnFilter {
+ public:
+  RemainingFilter(
+      std::unique_ptr<exec::ExprSet> exprSet,
+      ExpressionEvaluator* evaluator,
+      memory::MemoryPool* pool)
+      : exprSet_(std::move(exprSet)), evaluator_(evaluator), pool_(pool) {
+    for (auto& field : exprSet_->expr(0)->distinctFields()) {
+      inputNames_.push_back(field->field());
+      inputTypes_.push_back(field->type());
+    }
+  }
+
+  const std::vector<std::string>& inputNames() const override {
+    return inputNames_;
+  }
+
+  const std::vector<TypePtr>& inputTypes() const {
+    return inputTypes_;
+  }
+
+  void filter(const RowVectorPtr& input, raw_vector<vector_size_t>& passing)
+      override {
+    filterRows_.resize(input->size());
+    evaluator_->evaluate(exprSet_.get(), filterRows_, input, &filterResult_);
+    auto numPassed = exec::processFilterResults(
+        filterResult_, filterRows_, filterEvalCtx_, pool_);
+    passing.resize(numPassed);
+    if (numPassed == input->size()) {
+      std::iota(passing.begin(), passing.end(), 0);
+    } else if (numPassed > 0) {
+      auto* indices = filterEvalCtx_.selectedIndices->as<vector_size_t>();
+      std::copy(indices, indices + numPassed, passing.begin());
+    }
+  }
+
+ private:
+  const std::unique_ptr<exec::ExprSet> exprSet_;
+  ExpressionEvaluator* const evaluator_;
+  memory::MemoryPool* const pool_;
+  std::vector<std::string> inputNames_;
+  std::vector<TypePtr> inputTypes_;
+
+  // Reusable memory for the filter evaluation.
+  VectorPtr filterResult_;
+  SelectivityVector filterRows_;
+  exec::FilterEvalCtx filterEvalCtx_;
+};
 } // namespace
 
 HiveTableHandle::HiveTableHandle(
@@ -48,12 +107,14 @@ HiveTableHandle::HiveTableHandle(
     const std::string& tableName,
     bool filterPushdownEnabled,
     SubfieldFilters subfieldFilters,
-    const core::TypedExprPtr& remainingFilter)
+    const core::TypedExprPtr& remainingFilter,
+    std::optional<HiveBucketProperty> bucketProperty)
     : ConnectorTableHandle(std::move(connectorId)),
       tableName_(tableName),
       filterPushdownEnabled_(filterPushdownEnabled),
       subfieldFilters_(std::move(subfieldFilters)),
-      remainingFilter_(remainingFilter) {}
+      remainingFilter_(remainingFilter),
+      bucketProperty_(std::move(bucketProperty)) {}
 
 HiveTableHandle::~HiveTableHandle() {}
 
@@ -201,6 +262,78 @@ void addSubfields(
   }
 }
 
+// Returns the map subscript path element for a constant key, or nullptr if
+// the keys of this type are not supported for pruning.
+std::unique_ptr<common::Subfield::PathElement> makeMapSubscript(
+    const core::ConstantTypedExpr& key) {
+  if (key.hasValueVector() || key.value().isNull()) {
+    return nullptr;
+  }
+  const auto& value = key.value();
+  switch (key.type()->kind()) {
+    case TypeKind::TINYINT:
+      return std::make_unique<common::Subfield::LongSubscript>(
+          value.value<int8_t>());
+    case TypeKind::SMALLINT:
+      return std::make_unique<common::Subfield::LongSubscript>(
+          value.value<int16_t>());
+    case TypeKind::INTEGER:
+      return std::make_unique<common::Subfield::LongSubscript>(
+          value.value<int32_t>());
+    case TypeKind::BIGINT:
+      return std::make_unique<common::Subfield::LongSubscript>(
+          value.value<int64_t>());
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<common::Subfield::StringSubscript>(
+          value.value<std::string>());
+    default:
+      return nullptr;
+  }
+}
+
+// Collects into 'subfields' the keys of the map column 'name' that 'expr'
+// accesses with subscript or element_at and a constant key. Returns false if
+// 'name' is used in any other way, in which case all the keys are needed.
+bool collectMapSubscripts(
+    const core::TypedExprPtr& expr,
+    const std::string& name,
+    std::vector<common::Subfield>& subfields) {
+  auto isColumn = [&](const core::TypedExprPtr& input) {
+    auto* field =
+        dynamic_cast<const core::FieldAccessTypedExpr*>(input.get());
+    return field && field->isInputColumn() && field->name() == name;
+  };
+  if (isColumn(expr)) {
+    return false;
+  }
+  auto* call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (call && (call->name() == "subscript" || call->name() == "element_at") &&
+      call->inputs().size() == 2 && isColumn(call->inputs()[0])) {
+    auto* key =
+        dynamic_cast<const core::ConstantTypedExpr*>(call->inputs()[1].get());
+    auto subscript = key ? makeMapSubscript(*key) : nullptr;
+    if (!subscript) {
+      return false;
+    }
+    std::vector<std::unique_ptr<common::Subfield::PathElement>> path;
+    path.push_back(std::make_unique<common::Subfield::NestedField>(name));
+    path.push_back(std::move(subscript));
+    common::Subfield subfield(std::move(path));
+    if (std::find(subfields.begin(), subfields.end(), subfield) ==
+        subfields.end()) {
+      subfields.push_back(std::move(subfield));
+    }
+    return true;
+  }
+  for (auto& input : expr->inputs()) {
+    if (!collectMapSubscripts(input, name, subfields)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 std::shared_ptr<common::ScanSpec> HiveDataSource::makeScanSpec(
@@ -253,6 +386,7 @@ HiveDataSource::HiveDataSource(
         std::string,
         std::shared_ptr<connector::ColumnHandle>>& columnHandles,
     FileHandleFactory* fileHandleFactory,
+    std::shared_ptr<dwio::common::FileMetadataCache> fileMetadataCache,
     velox::memory::MemoryPool* pool,
     ExpressionEvaluator* expressionEvaluator,
     memory::MemoryAllocator* allocator,
@@ -261,6 +395,7 @@ HiveDataSource::HiveDataSource(
     folly::Executor* executor)
     : outputType_(outputType),
       fileHandleFactory_(fileHandleFactory),
+      fileMetadataCache_(std::move(fileMetadataCache)),
       pool_(pool),
       readerOpts_(pool),
       expressionEvaluator_(expressionEvaluator),
@@ -317,29 +452,49 @@ HiveDataSource::HiveDataSource(
   if (remainingFilter) {
     metadataFilter_ =
         std::make_shared<common::MetadataFilter>(*scanSpec_, *remainingFilter);
-    remainingFilterExprSet_ = expressionEvaluator_->compile(remainingFilter);
+    auto filter = std::make_shared<RemainingFilter>(
+        expressionEvaluator_->compile(remainingFilter),
+        expressionEvaluator_,
+        pool_);
 
     // Remaining filter may reference columns that are not used otherwise,
     // e.g. are not being projected out and are not used in range filters.
-    // Make sure to add these columns to scanSpec_.
-
-    auto filterInputs = remainingFilterExprSet_->expr(0)->distinctFields();
+    // Make sure to add these columns to scanSpec_. The filter is evaluated by
+    // the reader, so that the columns that are not filter inputs are read
+    // only for the rows that pass.
     column_index_t channel = outputType_->size();
     auto names = readerOutputType_->names();
     auto types = readerOutputType_->children();
-    for (auto& input : filterInputs) {
-      if (readerOutputType_->containsChild(input->field())) {
+    for (auto i = 0; i < filter->inputNames().size(); ++i) {
+      const auto& name = filter->inputNames()[i];
+      const auto& type = filter->inputTypes()[i];
+      const bool isNewField = scanSpec_->childByName(name) == nullptr;
+      common::Subfield subfield(name);
+      auto fieldSpec = scanSpec_->getOrCreateChild(subfield);
+      fieldSpec->setIsMultiColumnFilterInput(true);
+      if (readerOutputType_->containsChild(name)) {
         continue;
       }
-      names.emplace_back(input->field());
-      types.emplace_back(input->type());
-
-      common::Subfield subfield(input->field());
-      auto fieldSpec = scanSpec_->getOrCreateChild(subfield);
+      // A map that is only accessed with constant subscripts in the filter
+      // needs only these keys. The reader skips the other keys, e.g. does not
+      // read the streams of the other keys of a flat map.
+      std::vector<common::Subfield> subscripts;
+      if (isNewField && type->kind() == TypeKind::MAP &&
+          collectMapSubscripts(remainingFilter, name, subscripts) &&
+          !subscripts.empty()) {
+        std::vector<const common::Subfield*> subscriptPtrs;
+        for (auto& subscript : subscripts) {
+          subscriptPtrs.push_back(&subscript);
+        }
+        addSubfields(*type, subscriptPtrs, 1, pool_, *fieldSpec);
+      }
+      names.emplace_back(name);
+      types.emplace_back(type);
       fieldSpec->setProjectOut(true);
       fieldSpec->setChannel(channel++);
     }
     readerOutputType_ = ROW(std::move(names), std::move(types));
+    scanSpec_->setMultiColumnFilter(std::move(filter));
   }
 
   readerOpts_.setCaseSensitive(caseSensitive);
@@ -348,6 +503,14 @@ HiveDataSource::HiveDataSource(
   rowReaderOpts_.setMetadataFilter(metadataFilter_);
 
   ioStats_ = std::make_shared<dwio::common::IoStatistics>();
+
+  bucketProperty_ = hiveTableHandle->bucketProperty();
+  for (const auto& [subfield, filter] : hiveTableHandle->subfieldFilters()) {
+    if (subfield.toString() == kBucket) {
+      bucketFilter_ = filter->clone();
+    }
+  }
+  updateBucketsToRead();
 }
 
 namespace {
@@ -482,6 +645,22 @@ void HiveDataSource::addDynamicFilter(
   auto& fieldSpec = scanSpec_->getChildByChannel(outputChannel);
   fieldSpec.addFilter(*filter);
   scanSpec_->resetCachedValues(true);
+  updateBucketsToRead();
+}
+
+void HiveDataSource::updateBucketsToRead() {
+  if (bucketProperty_.has_value()) {
+    bucketsToRead_ = bucketsForFilters(*bucketProperty_, *scanSpec_, pool_);
+  }
+}
+
+bool HiveDataSource::testBucket(int32_t bucket) const {
+  if (bucketFilter_ && !bucketFilter_->testInt64(bucket)) {
+    return false;
+  }
+  return !bucketsToRead_.has_value() ||
+      std::binary_search(
+             bucketsToRead_->begin(), bucketsToRead_->end(), bucket);
 }
 
 void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
@@ -493,6 +672,16 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 
   VLOG(1) << "Adding split " << split_->toString();
 
+  // The split is skipped before opening the file if its bucket cannot have
+  // rows that pass the filters.
+  if (split_->tableBucketNumber.has_value() &&
+      !testBucket(split_->tableBucketNumber.value())) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    return;
+  }
+
   fileHandle_ = fileHandleFactory_->generate(split_->filePath);
   std::unique_ptr<dwio::common::BufferedInput> input;
   if (auto* asyncCache = dynamic_cast<cache::AsyncDataCache*>(allocator_)) {
@@ -526,6 +715,19 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
     readerOpts_.setFileFormat(split_->fileFormat);
   }
 
+  // A file with a modification time is not modified in place, so its footer
+  // can be shared with other queries.
+  if (fileMetadataCache_ != nullptr && split_->fileModifiedTime.has_value()) {
+    readerOpts_.setFileMetadataCache(
+        fileMetadataCache_,
+        dwio::common::FileMetadataKey{
+            split_->filePath,
+            split_->fileSize.value_or(fileHandle_->file->size()),
+            split_->fileModifiedTime.value()});
+  } else {
+    readerOpts_.setFileMetadataCache(nullptr, std::nullopt);
+  }
+
   reader_ = dwio::common::getReaderFactory(readerOpts_.getFileFormat())
                 ->createReader(std::move(input), readerOpts_);
 
@@ -615,6 +817,7 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
         fileType, columnNames, nullptr, readerOpts_.isCaseSensitive());
   }
 
+  rowReaderOpts_.setIoStatistics(ioStats_);
   rowReader_ = reader_->createRowReader(
       rowReaderOpts_.select(cs).range(split_->start, split_->length));
 }
@@ -669,34 +872,15 @@ std::optional<RowVectorPtr> HiveDataSource::next(
 
     auto rowVector = std::dynamic_pointer_cast<RowVector>(output_);
 
-    // In case there is a remaining filter that excludes some but not all rows,
-    // collect the indices of the passing rows. If there is no filter, or it
-    // passes on all rows, leave this as null and let exec::wrap skip wrapping
-    // the results.
-    BufferPtr remainingIndices;
-    if (remainingFilterExprSet_) {
-      rowsRemaining = evaluateRemainingFilter(rowVector);
-      VELOX_CHECK_LE(rowsRemaining, rowsScanned);
-      if (rowsRemaining == 0) {
-        // No rows passed the remaining filter.
-        return RowVector::createEmpty(outputType_, pool_);
-      }
-
-      if (rowsRemaining < rowVector->size()) {
-        // Some, but not all rows passed the remaining filter.
-        remainingIndices = filterEvalCtx_.selectedIndices;
-      }
-    }
-
+    // The remaining filter, if any, was evaluated by the reader.
     if (outputType_->size() == 0) {
-      return exec::wrap(rowsRemaining, remainingIndices, rowVector);
+      return exec::wrap(rowsRemaining, nullptr, rowVector);
     }
 
     std::vector<VectorPtr> outputColumns;
     outputColumns.reserve(outputType_->size());
     for (int i = 0; i < outputType_->size(); i++) {
-      outputColumns.emplace_back(exec::wrapChild(
-          rowsRemaining, remainingIndices, rowVector->childAt(i)));
+      outputColumns.emplace_back(rowVector->childAt(i));
     }
 
     return std::make_shared<RowVector>(
@@ -714,15 +898,6 @@ void HiveDataSource::resetSplit() {
   // Keep readers around to hold adaptation.
 }
 
-vector_size_t HiveDataSource::evaluateRemainingFilter(RowVectorPtr& rowVector) {
-  filterRows_.resize(output_->size());
-
-  expressionEvaluator_->evaluate(
-      remainingFilterExprSet_.get(), filterRows_, rowVector, &filterResult_);
-  return exec::processFilterResults(
-      filterResult_, filterRows_, filterEvalCtx_, pool_);
-}
-
 void HiveDataSource::setConstantValue(
     common::ScanSpec* spec,
     const TypePtr& type,
@@ -770,6 +945,17 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
        {"localReadBytes",
         RuntimeCounter(
             ioStats_->ssdRead().sum(), RuntimeCounter::Unit::kBytes)},
+       {"numSharedTierRead",
+        RuntimeCounter(ioStats_->sharedTierRead().count())},
+       {"sharedTierReadBytes",
+        RuntimeCounter(
+            ioStats_->sharedTierRead().sum(), RuntimeCounter::Unit::kBytes)},
+       {"numSharedTierMiss",
+        RuntimeCounter(ioStats_->sharedTierMiss().count())},
+       {"sharedTierWaitNanos",
+        RuntimeCounter(
+            ioStats_->sharedTierLatency().sum() * 1000,
+            RuntimeCounter::Unit::kNanos)},
        {"numRamRead", RuntimeCounter(ioStats_->ramHit().count())},
        {"ramReadBytes",
         RuntimeCounter(ioStats_->ramHit().sum(), RuntimeCounter::Unit::kBytes)},
@@ -782,6 +968,26 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
             RuntimeCounter::Unit::kNanos)},
        {"queryThreadIoLatency",
         RuntimeCounter(ioStats_->queryThreadIoLatency().count())}});
+  if (ioStats_->decompression().count() > 0) {
+    res.insert(
+        {"decompressionCpuNanos",
+         RuntimeCounter(
+             ioStats_->decompression().sum(), RuntimeCounter::Unit::kNanos)});
+  }
+  if (ioStats_->decryption().count() > 0) {
+    res.insert(
+        {"decryptionCpuNanos",
+         RuntimeCounter(
+             ioStats_->decryption().sum(), RuntimeCounter::Unit::kNanos)});
+  }
+  if (auto numCoalesced = ioStats_->coalesceDistance().count()) {
+    // Average of the coalescing distances chosen for storage reads.
+    res.insert(
+        {"coalesceDistance",
+         RuntimeCounter(
+             ioStats_->coalesceDistance().sum() / numCoalesced,
+             RuntimeCounter::Unit::kBytes)});
+  }
   return res;
 }
 
@@ -796,6 +1002,142 @@ int64_t HiveDataSource::estimatedRowSize() {
   return kUnknownRowSize;
 }
 
+namespace {
+
+template <typename T>
+void appendSortedValues(std::vector<T> values, std::ostream& out) {
+  std::sort(values.begin(), values.end());
+  for (const auto& value : values) {
+    out << " " << value;
+  }
+}
+
+// Appends a description of 'filter' to 'out'. Returns false if 'filter' can't
+// be described exactly. The toString() of the filters on lists of values does
+// not show all the values, so the values are appended separately.
+bool appendFilterKey(const common::Filter& filter, std::ostream& out) {
+  out << filter.toString();
+  switch (filter.kind()) {
+    case common::FilterKind::kBoolValue:
+    case common::FilterKind::kBigintValuesUsingBloomFilter:
+      return false;
+    case common::FilterKind::kDoubleRange: {
+      // toString() rounds the bounds.
+      const auto& range =
+          static_cast<const common::FloatingPointRange<double>&>(filter);
+      out << fmt::format(" {} {}", range.lower(), range.upper());
+      return true;
+    }
+    case common::FilterKind::kFloatRange: {
+      const auto& range =
+          static_cast<const common::FloatingPointRange<float>&>(filter);
+      out << fmt::format(" {} {}", range.lower(), range.upper());
+      return true;
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      appendSortedValues(
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values(),
+          out);
+      return true;
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      appendSortedValues(
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values(),
+          out);
+      return true;
+    case common::FilterKind::kNegatedBigintValuesUsingHashTable:
+      appendSortedValues(
+          static_cast<const common::NegatedBigintValuesUsingHashTable&>(filter)
+              .values(),
+          out);
+      return true;
+    case common::FilterKind::kNegatedBigintValuesUsingBitmask:
+      appendSortedValues(
+          static_cast<const common::NegatedBigintValuesUsingBitmask&>(filter)
+              .values(),
+          out);
+      return true;
+    case common::FilterKind::kBytesValues: {
+      const auto& values =
+          static_cast<const common::BytesValues&>(filter).values();
+      appendSortedValues(
+          std::vector<std::string>(values.begin(), values.end()), out);
+      return true;
+    }
+    case common::FilterKind::kNegatedBytesValues: {
+      const auto& values =
+          static_cast<const common::NegatedBytesValues&>(filter).values();
+      appendSortedValues(
+          std::vector<std::string>(values.begin(), values.end()), out);
+      return true;
+    }
+    case common::FilterKind::kMultiRange: {
+      const auto& multiRange = static_cast<const common::MultiRange&>(filter);
+      out << (multiRange.nanAllowed() ? " with NaN" : " no NaN");
+      for (const auto& child : multiRange.filters()) {
+        out << " (";
+        if (!appendFilterKey(*child, out)) {
+          return false;
+        }
+        out << ")";
+      }
+      return true;
+    }
+    default:
+      return true;
+  }
+}
+
+} // namespace
+
+std::optional<std::string> HiveConnector::resultCacheKey(
+    const RowTypePtr& outputType,
+    const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
+    const std::unordered_map<
+        std::string,
+        std::shared_ptr<connector::ColumnHandle>>& columnHandles) const {
+  auto hiveTableHandle =
+      std::dynamic_pointer_cast<HiveTableHandle>(tableHandle);
+  if (!hiveTableHandle || hiveTableHandle->remainingFilter()) {
+    return std::nullopt;
+  }
+  std::stringstream out;
+  out << "table: " << hiveTableHandle->toString()
+      << ", output: " << outputType->toString() << ", filters: [";
+  // Sort filters and columns by name for a deterministic key.
+  std::map<std::string, const common::Filter*> orderedFilters;
+  for (const auto& [field, filter] : hiveTableHandle->subfieldFilters()) {
+    orderedFilters[field.toString()] = filter.get();
+  }
+  for (const auto& [field, filter] : orderedFilters) {
+    out << "(" << field << ", ";
+    if (!appendFilterKey(*filter, out)) {
+      return std::nullopt;
+    }
+    out << ")";
+  }
+  out << "], columns: [";
+  std::map<std::string, const HiveColumnHandle*> orderedColumns;
+  for (const auto& [name, handle] : columnHandles) {
+    orderedColumns[name] = dynamic_cast<const HiveColumnHandle*>(handle.get());
+    if (!orderedColumns[name]) {
+      return std::nullopt;
+    }
+  }
+  for (const auto& [name, handle] : orderedColumns) {
+    out << "(" << name << ", " << handle->name() << ", "
+        << static_cast<int>(handle->columnType()) << ", "
+        << handle->dataType()->toString();
+    for (const auto& subfield : handle->requiredSubfields()) {
+      out << ", " << subfield.toString();
+    }
+    out << ")";
+  }
+  out << "]";
+  return out.str();
+}
+
 HiveConnector::HiveConnector(
     const std::string& id,
     std::shared_ptr<const Config> properties,
@@ -805,6 +1147,11 @@ HiveConnector::HiveConnector(
           std::make_unique<SimpleLRUCache<std::string, FileHandle>>(
               FLAGS_file_handle_cache_mb << 20),
           std::make_unique<FileHandleGenerator>(std::move(properties))),
+      fileMetadataCache_(
+          FLAGS_file_metadata_cache_mb > 0
+              ? std::make_shared<dwio::common::FileMetadataCache>(
+                    static_cast<uint64_t>(FLAGS_file_metadata_cache_mb) << 20)
+              : nullptr),
       executor_(executor) {}
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<HiveConnectorFactory>())
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/connectors/hive/FileHandle.h"
+#include "velox/connectors/hive/HiveBucketUtil.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/connectors/hive/HiveDataSink.h"
@@ -96,7 +97,8 @@ class HiveTableHandle : public ConnectorTableHandle {
       const std::string& tableName,
       bool filterPushdownEnabled,
       SubfieldFilters subfieldFilters,
-      const core::TypedExprPtr& remainingFilter);
+      const core::TypedExprPtr& remainingFilter,
+      std::optional<HiveBucketProperty> bucketProperty = std::nullopt);
 
   ~HiveTableHandle() override;
 
@@ -112,6 +114,13 @@ class HiveTableHandle : public ConnectorTableHandle {
     return remainingFilter_;
   }
 
+  /// The bucketing of the table if the table is bucketed. The data sources
+  /// skip the splits of the buckets that cannot have rows that pass the
+  /// filters on the bucketing columns.
+  const std::optional<HiveBucketProperty>& bucketProperty() const {
+    return bucketProperty_;
+  }
+
   std::string toString() const override;
 
  private:
@@ -119,6 +128,7 @@ class HiveTableHandle : public ConnectorTableHandle {
   const bool filterPushdownEnabled_;
   const SubfieldFilters subfieldFilters_;
   const core::TypedExprPtr remainingFilter_;
+  const std::optional<HiveBucketProperty> bucketProperty_;
 };
 
 class HiveConnector;
@@ -132,6 +142,7 @@ class HiveDataSource : public DataSource {
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
       FileHandleFactory* FOLLY_NONNULL fileHandleFactory,
+      std::shared_ptr<dwio::common::FileMetadataCache> fileMetadataCache,
       velox::memory::MemoryPool* FOLLY_NONNULL pool,
       ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator,
       memory::MemoryAllocator* FOLLY_NONNULL allocator,
@@ -175,12 +186,6 @@ class HiveDataSource : public DataSource {
       memory::MemoryPool* pool);
 
  private:
-  // Evaluates remainingFilter_ on the specified vector. Returns number of rows
-  // passed. Populates filterEvalCtx_.selectedIndices and selectedBits if only
-  // some rows passed the filter. If none or all rows passed
-  // filterEvalCtx_.selectedIndices and selectedBits are not updated.
-  vector_size_t evaluateRemainingFilter(RowVectorPtr& rowVector);
-
   void setConstantValue(
       common::ScanSpec* FOLLY_NONNULL spec,
       const TypePtr& type,
@@ -198,22 +203,35 @@ class HiveDataSource : public DataSource {
   /// Clear split_, reader_ and rowReader_ after split has been fully processed.
   void resetSplit();
 
+  // Sets 'bucketsToRead_' from the filters on the bucketing columns.
+  void updateBucketsToRead();
+
+  // Returns false if the rows of 'bucket' cannot pass the filters.
+  bool testBucket(int32_t bucket) const;
+
   const RowTypePtr outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
   std::unordered_map<std::string, std::shared_ptr<HiveColumnHandle>>
       partitionKeys_;
   FileHandleFactory* FOLLY_NONNULL fileHandleFactory_;
+  // Null if the cache is disabled.
+  std::shared_ptr<dwio::common::FileMetadataCache> fileMetadataCache_;
   velox::memory::MemoryPool* FOLLY_NONNULL pool_;
   std::shared_ptr<dwio::common::IoStatistics> ioStats_;
   std::shared_ptr<common::ScanSpec> scanSpec_;
   std::shared_ptr<common::MetadataFilter> metadataFilter_;
+  std::optional<HiveBucketProperty> bucketProperty_;
+  // The buckets that may have rows that pass the filters, in ascending order.
+  // std::nullopt if the filters do not restrict the buckets.
+  std::optional<std::vector<int32_t>> bucketsToRead_;
+  // The filter on $bucket. The scan spec has no filters on $bucket.
+  std::unique_ptr<common::Filter> bucketFilter_;
   std::shared_ptr<HiveConnectorSplit> split_;
   dwio::common::ReaderOptions readerOpts_;
   dwio::common::RowReaderOptions rowReaderOpts_;
   std::unique_ptr<dwio::common::Reader> reader_;
   std::unique_ptr<dwio::common::RowReader> rowReader_;
-  std::unique_ptr<exec::ExprSet> remainingFilterExprSet_;
   RowTypePtr readerOutputType_;
   bool emptySplit_;
 
@@ -224,11 +242,6 @@ class HiveDataSource : public DataSource {
   ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator_;
   uint64_t completedRows_ = 0;
 
-  // Reusable memory for remaining filter evaluation.
-  VectorPtr filterResult_;
-  SelectivityVector filterRows_;
-  exec::FilterEvalCtx filterEvalCtx_;
-
   memory::MemoryAllocator* const FOLLY_NONNULL allocator_;
   const std::string& scanId_;
   folly::Executor* FOLLY_NULLABLE executor_;
@@ -257,6 +270,7 @@ class HiveConnector final : public Connector {
         tableHandle,
         columnHandles,
         &fileHandleFactory_,
+        fileMetadataCache_,
         connectorQueryCtx->memoryPool(),
         connectorQueryCtx->expressionEvaluator(),
         connectorQueryCtx->allocator(),
@@ -265,6 +279,16 @@ class HiveConnector final : public Connector {
         executor_);
   }
 
+  /// Returns std::nullopt if there is a remaining filter, since it may not be
+  /// deterministic, or a subfield filter that can't be described exactly.
+  std::optional<std::string> resultCacheKey(
+      const RowTypePtr& outputType,
+      const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
+      const std::unordered_map<
+          std::string,
+          std::shared_ptr<connector::ColumnHandle>>& columnHandles)
+      const override;
+
   bool supportsSplitPreload() override {
     return true;
   }
@@ -296,8 +320,27 @@ class HiveConnector final : public Connector {
     return fileHandleFactory_.clearCache();
   }
 
+  /// Returns empty stats if the file metadata cache is disabled.
+  dwio::common::FileMetadataCacheStats fileMetadataCacheStats() const {
+    if (fileMetadataCache_ == nullptr) {
+      return {};
+    }
+    return fileMetadataCache_->stats();
+  }
+
+  // NOTE: this is to clear the file metadata cache which might affect
+  // performance, and is only used for operational purposes.
+  void clearFileMetadataCache() {
+    if (fileMetadataCache_ != nullptr) {
+      fileMetadataCache_->clear();
+    }
+  }
+
  private:
   FileHandleFactory fileHandleFactory_;
+  // Parsed file footers shared by the queries of this connector. Null if
+  // disabled.
+  std::shared_ptr<dwio::common::FileMetadataCache> fileMetadataCache_;
   folly::Executor* FOLLY_NULLABLE executor_;
 };
 
@@ -15,7 +15,9 @@
  */
 #pragma once
 
+#include <map>
 #include <optional>
+#include <sstream>
 #include <unordered_map>
 #include "velox/connectors/Connector.h"
 #include "velox/dwio/common/Options.h"
@@ -30,6 +32,11 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
   const std::unordered_map<std::string, std::optional<std::string>>
       partitionKeys;
   std::optional<int32_t> tableBucketNumber;
+  // The size and the last modification time of the file if known. Set the
+  // modification time only if the file is not modified in place, so that the
+  // results of reading the split can be cached.
+  std::optional<uint64_t> fileSize;
+  std::optional<int64_t> fileModifiedTime;
 
   HiveConnectorSplit(
       const std::string& connectorId,
@@ -39,14 +46,18 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
       uint64_t _length = std::numeric_limits<uint64_t>::max(),
       const std::unordered_map<std::string, std::optional<std::string>>&
           _partitionKeys = {},
-      std::optional<int32_t> _tableBucketNumber = std::nullopt)
+      std::optional<int32_t> _tableBucketNumber = std::nullopt,
+      std::optional<uint64_t> _fileSize = std::nullopt,
+      std::optional<int64_t> _fileModifiedTime = std::nullopt)
       : ConnectorSplit(connectorId),
         filePath(_filePath),
         fileFormat(_fileFormat),
         start(_start),
         length(_length),
         partitionKeys(_partitionKeys),
-        tableBucketNumber(_tableBucketNumber) {}
+        tableBucketNumber(_tableBucketNumber),
+        fileSize(_fileSize),
+        fileModifiedTime(_fileModifiedTime) {}
 
   std::string toString() const override {
     if (tableBucketNumber.has_value()) {
@@ -59,6 +70,56 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
     }
     return fmt::format("[file {} {} - {}]", filePath, start, length);
   }
+
+  uint64_t size() const override {
+    return length == std::numeric_limits<uint64_t>::max() ? 0 : length;
+  }
+
+  /// The file readers read the row groups or stripes which start in the byte
+  /// range of a split, so the morsels read the same rows as this split.
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splitIntoMorsels(
+      uint64_t maxBytes) const override {
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> morsels;
+    const auto splitSize = size();
+    if (maxBytes == 0 || splitSize <= maxBytes) {
+      return morsels;
+    }
+    for (uint64_t offset = 0; offset < splitSize; offset += maxBytes) {
+      morsels.push_back(std::make_shared<HiveConnectorSplit>(
+          connectorId,
+          filePath,
+          fileFormat,
+          start + offset,
+          std::min(maxBytes, splitSize - offset),
+          partitionKeys,
+          tableBucketNumber,
+          fileSize,
+          fileModifiedTime));
+    }
+    return morsels;
+  }
+
+  std::optional<std::string> resultCacheKey() const override {
+    if (!fileModifiedTime.has_value()) {
+      return std::nullopt;
+    }
+    // Sort the partition keys for a deterministic key.
+    std::map<std::string, std::optional<std::string>> orderedKeys(
+        partitionKeys.begin(), partitionKeys.end());
+    std::stringstream out;
+    out << connectorId << " " << filePath << " " << fileSize.value_or(0) << " "
+        << fileModifiedTime.value() << " " << start << " " << length << " "
+        << tableBucketNumber.value_or(-1);
+    for (const auto& [name, value] : orderedKeys) {
+      out << " " << name;
+      if (value.has_value()) {
+        out << "=" << value.value();
+      } else {
+        out << " is null";
+      }
+    }
+    return out.str();
+  }
 };
 
 } // namespace facebook::velox::connector::hive
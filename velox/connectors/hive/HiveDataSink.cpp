@@ -19,8 +19,10 @@
 #include "velox/common/base/Fs.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/connectors/hive/HivePartitionUtil.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/exec/SortBuffer.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
@@ -48,6 +50,43 @@ std::vector<column_index_t> getPartitionChannels(
   return channels;
 }
 
+// Returns the index of the input column named 'name'.
+column_index_t getColumnChannel(
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle,
+    const std::string& name) {
+  const auto& inputColumns = insertTableHandle->inputColumns();
+  for (column_index_t i = 0; i < inputColumns.size(); ++i) {
+    if (inputColumns[i]->name() == name) {
+      return i;
+    }
+  }
+  VELOX_USER_FAIL("Bucketing or sorting column not found: {}", name);
+}
+
+std::unique_ptr<core::PartitionFunction> makeBucketFunction(
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle) {
+  const auto& bucketProperty = insertTableHandle->bucketProperty();
+  if (bucketProperty == nullptr) {
+    return nullptr;
+  }
+  std::vector<column_index_t> bucketChannels;
+  for (const auto& name : bucketProperty->bucketedBy()) {
+    const auto channel = getColumnChannel(insertTableHandle, name);
+    VELOX_USER_CHECK(
+        !insertTableHandle->inputColumns()[channel]->isPartitionKey(),
+        "Partition key cannot be a bucketing column: {}",
+        name);
+    bucketChannels.push_back(channel);
+  }
+  // Each bucket is its own partition of the partition function.
+  std::vector<int> bucketToPartition(bucketProperty->bucketCount());
+  std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+  return std::make_unique<HivePartitionFunction>(
+      bucketProperty->bucketCount(),
+      std::move(bucketToPartition),
+      std::move(bucketChannels));
+}
+
 std::string makePartitionDirectory(
     const std::string& tableDirectory,
     const std::optional<std::string>& partitionSubdirectory) {
@@ -57,6 +96,8 @@ std::string makePartitionDirectory(
   return tableDirectory;
 }
 
+constexpr uint32_t kSortBufferOutputBatchRows = 1'024;
+
 std::string makeUuid() {
   return boost::lexical_cast<std::string>(boost::uuids::random_generator()());
 }
@@ -80,39 +121,62 @@ HiveDataSink::HiveDataSink(
                                             HiveConfig::maxPartitionsPerWriters(
                                                 connectorQueryCtx_->config()),
                                             connectorQueryCtx_->memoryPool())
-                                      : nullptr) {}
+                                      : nullptr),
+      writersMemoryBudget_(
+          HiveConfig::writersMemoryBudget(connectorQueryCtx_->config())),
+      bucketFunction_(makeBucketFunction(insertTableHandle_)) {
+  if (insertTableHandle_->isBucketed()) {
+    for (const auto& sortingColumn :
+         insertTableHandle_->bucketProperty()->sortedBy()) {
+      sortChannels_.push_back(
+          getColumnChannel(insertTableHandle_, sortingColumn.sortColumn()));
+      sortCompareFlags_.push_back(
+          {sortingColumn.sortOrder().isNullsFirst(),
+           sortingColumn.sortOrder().isAscending(),
+           false,
+           false});
+    }
+  }
+}
+
+HiveDataSink::~HiveDataSink() = default;
 
 void HiveDataSink::appendData(RowVectorPtr input) {
-  // Write to unpartitioned table.
-  if (partitionChannels_.empty()) {
+  appendToWriters(input);
+  ensureWritersMemoryBudget();
+}
+
+void HiveDataSink::appendToWriters(const RowVectorPtr& input) {
+  // Write to unpartitioned and unbucketed table.
+  if (partitionChannels_.empty() && bucketFunction_ == nullptr) {
     ensureSingleWriter();
 
-    writers_[0]->write(input);
-    writerInfo_[0]->numWrittenRows += input->size();
+    write(0, input);
     return;
   }
 
-  // Write to partitioned table.
-  partitionIdGenerator_->run(input, partitionIds_);
-
-  ensurePartitionWriters();
-
   for (column_index_t i = 0; i < input->childrenSize(); i++) {
     input->childAt(i)->loadedVector();
   }
 
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
+  if (bucketFunction_ != nullptr) {
+    computeBucketedWriterIds(input);
+  } else {
+    // Write to partitioned table.
+    partitionIdGenerator_->run(input, partitionIds_);
 
-  // All inputs belong to a single partition.
-  if (numPartitions == 1) {
-    writers_[0]->write(input);
-    writerInfo_[0]->numWrittenRows += input->size();
-    return;
+    ensurePartitionWriters();
+
+    // All inputs belong to a single partition.
+    if (partitionIdGenerator_->numPartitions() == 1) {
+      write(0, input);
+      return;
+    }
   }
 
   computePartitionRowCountsAndIndices();
 
-  for (auto id = 0; id < numPartitions; id++) {
+  for (auto id = 0; id < writers_.size(); id++) {
     vector_size_t partitionSize = partitionSizes_[id];
     if (partitionSize == 0) {
       continue;
@@ -121,8 +185,81 @@ void HiveDataSink::appendData(RowVectorPtr input) {
     RowVectorPtr writerInput = partitionSize == input->size()
         ? input
         : exec::wrap(partitionSize, partitionRows_[id], input);
-    writers_[id]->write(writerInput);
-    writerInfo_[id]->numWrittenRows += partitionSize;
+    write(id, writerInput);
+  }
+}
+
+void HiveDataSink::write(size_t index, const RowVectorPtr& input) {
+  if (sortBuffers_[index] != nullptr) {
+    sortBuffers_[index]->addInput(input);
+  } else {
+    writers_[index]->write(input);
+  }
+  writerInfo_[index]->numWrittenRows += input->size();
+}
+
+void HiveDataSink::ensureWritersMemoryBudget() {
+  if (writersMemoryBudget_ == 0) {
+    return;
+  }
+  uint64_t bufferedBytes = 0;
+  for (const auto& writer : writers_) {
+    bufferedBytes += writer->getContext().getTotalMemoryUsage();
+  }
+  if (bufferedBytes > writersMemoryBudget_) {
+    flushLargestWriters(bufferedBytes - writersMemoryBudget_);
+  }
+}
+
+uint64_t HiveDataSink::flushLargestWriters(uint64_t targetBytes) {
+  std::vector<std::pair<int64_t, size_t>> writerBytes;
+  writerBytes.reserve(writers_.size());
+  for (auto i = 0; i < writers_.size(); ++i) {
+    const auto bytes = writers_[i]->getContext().getTotalMemoryUsage();
+    if (bytes > 0) {
+      writerBytes.emplace_back(bytes, i);
+    }
+  }
+  std::sort(writerBytes.begin(), writerBytes.end(), std::greater<>());
+
+  uint64_t freedBytes = 0;
+  for (const auto& [bytes, index] : writerBytes) {
+    if (targetBytes != 0 && freedBytes >= targetBytes) {
+      break;
+    }
+    writers_[index]->flush();
+    freedBytes += std::max<int64_t>(
+        0, bytes - writers_[index]->getContext().getTotalMemoryUsage());
+  }
+  return freedBytes;
+}
+
+void HiveDataSink::computeBucketedWriterIds(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  if (!partitionChannels_.empty()) {
+    partitionIdGenerator_->run(input, partitionIds_);
+  } else {
+    partitionIds_.resize(numRows);
+    std::fill(partitionIds_.begin(), partitionIds_.end(), 0);
+  }
+  bucketFunction_->partition(*input, bucketIds_);
+
+  const auto bucketCount = insertTableHandle_->bucketProperty()->bucketCount();
+  for (auto row = 0; row < numRows; ++row) {
+    const uint64_t partitionId = partitionIds_[row];
+    const auto bucketId = bucketIds_[row];
+    const auto key = partitionId * bucketCount + bucketId;
+    auto it = bucketedWriterIndices_.find(key);
+    if (it == bucketedWriterIndices_.end()) {
+      it = bucketedWriterIndices_.emplace(key, writers_.size()).first;
+      appendWriter(
+          partitionChannels_.empty()
+              ? std::nullopt
+              : std::make_optional(
+                    partitionIdGenerator_->partitionName(partitionId)),
+          bucketId);
+    }
+    partitionIds_[row] = it->second;
   }
 }
 
@@ -160,8 +297,15 @@ std::vector<std::string> HiveDataSink::finish() const {
 }
 
 void HiveDataSink::close() {
-  for (const auto& writer : writers_) {
-    writer->close();
+  for (auto i = 0; i < writers_.size(); ++i) {
+    if (auto& sortBuffer = sortBuffers_[i]) {
+      sortBuffer->noMoreInput();
+      while (auto output = sortBuffer->getOutput()) {
+        writers_[i]->write(output);
+      }
+      sortBuffer.reset();
+    }
+    writers_[i]->close();
   }
 }
 
@@ -187,7 +331,8 @@ void HiveDataSink::ensurePartitionWriters() {
 }
 
 void HiveDataSink::appendWriter(
-    const std::optional<std::string>& partitionName) {
+    const std::optional<std::string>& partitionName,
+    std::optional<uint32_t> bucketId) {
   auto config = std::make_shared<WriterConfig>();
   // TODO: Wire up serde properties to writer configs.
 
@@ -196,7 +341,7 @@ void HiveDataSink::appendWriter(
   options.schema = inputType_;
   // Without explicitly setting flush policy, the default memory based flush
   // policy is used.
-  auto writerParameters = getWriterParameters(partitionName);
+  auto writerParameters = getWriterParameters(partitionName, bucketId);
   auto writePath = fs::path(writerParameters->writeDirectory()) /
       writerParameters->writeFileName();
 
@@ -204,47 +349,88 @@ void HiveDataSink::appendWriter(
   writers_.push_back(std::make_unique<Writer>(
       options, std::move(sink), *connectorQueryCtx_->connectorMemoryPool()));
   writerInfo_.push_back(std::make_shared<HiveWriterInfo>(*writerParameters));
+  sortBuffers_.push_back(sortChannels_.empty() ? nullptr : makeSortBuffer());
+}
+
+std::unique_ptr<exec::SortBuffer> HiveDataSink::makeSortBuffer() const {
+  // The rows of each file are sorted by its own buffer, which spills to its own
+  // files if spilling is enabled.
+  std::optional<exec::Spiller::Config> spillConfig;
+  if (!connectorQueryCtx_->spillPath().empty()) {
+    spillConfig.emplace(
+        fmt::format(
+            "{}-sort-{}", connectorQueryCtx_->spillPath(), writers_.size()),
+        0,
+        0,
+        connectorQueryCtx_->spillExecutor(),
+        25,
+        exec::HashBitRange{},
+        0,
+        0);
+  }
+  return std::make_unique<exec::SortBuffer>(
+      inputType_,
+      sortChannels_,
+      sortCompareFlags_,
+      kSortBufferOutputBatchRows,
+      connectorQueryCtx_->memoryPool(),
+      std::move(spillConfig),
+      HiveConfig::sortedWriteSpillMemoryThreshold(
+          connectorQueryCtx_->config()));
 }
 
 void HiveDataSink::computePartitionRowCountsAndIndices() {
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
+  const auto numPartitions = writers_.size();
   const auto numRows = partitionIds_.size();
 
+  // Counting sort of the rows by partition: the first pass counts the rows of
+  // each partition so that the second pass scatters the rows into index
+  // buffers of the exact size.
   partitionSizes_.resize(numPartitions);
   std::fill(partitionSizes_.begin(), partitionSizes_.end(), 0);
+  for (auto row = 0; row < numRows; row++) {
+    ++partitionSizes_[partitionIds_[row]];
+  }
 
   partitionRows_.resize(numPartitions, nullptr);
   rawPartitionRows_.resize(numPartitions);
   for (auto id = 0; id < numPartitions; id++) {
+    const auto partitionSize = partitionSizes_[id];
+    if (partitionSize == 0) {
+      continue;
+    }
     if (partitionRows_[id] == nullptr ||
-        partitionRows_[id]->capacity() < numRows * sizeof(vector_size_t)) {
+        partitionRows_[id]->capacity() <
+            partitionSize * sizeof(vector_size_t)) {
       partitionRows_[id] =
-          allocateIndices(numRows, connectorQueryCtx_->memoryPool());
-      rawPartitionRows_[id] = partitionRows_[id]->asMutable<vector_size_t>();
+          allocateIndices(partitionSize, connectorQueryCtx_->memoryPool());
     }
+    rawPartitionRows_[id] = partitionRows_[id]->asMutable<vector_size_t>();
+    partitionRows_[id]->setSize(partitionSize * sizeof(vector_size_t));
   }
 
+  std::fill(partitionSizes_.begin(), partitionSizes_.end(), 0);
   for (auto row = 0; row < numRows; row++) {
-    uint64_t id = partitionIds_[row];
-    rawPartitionRows_[id][partitionSizes_[id]] = row;
-    partitionSizes_[id]++;
-  }
-
-  for (auto id = 0; id < numPartitions; id++) {
-    partitionRows_[id]->setSize(partitionSizes_[id] * sizeof(vector_size_t));
+    const uint64_t id = partitionIds_[row];
+    rawPartitionRows_[id][partitionSizes_[id]++] = row;
   }
 }
 
 std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
-    const std::optional<std::string>& partition) const {
+    const std::optional<std::string>& partition,
+    std::optional<uint32_t> bucketId) const {
   auto updateMode = getUpdateMode();
 
+  // The files of a bucket start with the zero padded bucket number as in Hive.
+  const auto bucketPrefix =
+      bucketId.has_value() ? fmt::format("{:06}_0_", bucketId.value()) : "";
   std::string targetFileName;
   std::string writeFileName;
   switch (commitStrategy_) {
     case CommitStrategy::kNoCommit: {
       targetFileName = fmt::format(
-          "{}_{}_{}",
+          "{}{}_{}_{}",
+          bucketPrefix,
           connectorQueryCtx_->taskId(),
           connectorQueryCtx_->driverId(),
           makeUuid());
@@ -253,7 +439,8 @@ std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
     }
     case CommitStrategy::kTaskCommit: {
       targetFileName = fmt::format(
-          "{}_{}_{}",
+          "{}{}_{}_{}",
+          bucketPrefix,
           connectorQueryCtx_->taskId(),
           connectorQueryCtx_->driverId(),
           0);
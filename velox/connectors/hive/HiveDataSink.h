@@ -15,13 +15,20 @@
  */
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/connectors/Connector.h"
 #include "velox/connectors/hive/PartitionIdGenerator.h"
+#include "velox/core/PlanNode.h"
 
 namespace facebook::velox::dwrf {
 class Writer;
 }
 
+namespace facebook::velox::exec {
+class SortBuffer;
+}
+
 namespace facebook::velox::connector::hive {
 class HiveColumnHandle;
 
@@ -62,6 +69,61 @@ class LocationHandle {
   const TableType tableType_;
 };
 
+/// A column the files of a bucketed Hive table are sorted on.
+class HiveSortingColumn {
+ public:
+  HiveSortingColumn(std::string sortColumn, core::SortOrder sortOrder)
+      : sortColumn_(std::move(sortColumn)), sortOrder_(sortOrder) {}
+
+  const std::string& sortColumn() const {
+    return sortColumn_;
+  }
+
+  const core::SortOrder& sortOrder() const {
+    return sortOrder_;
+  }
+
+ private:
+  const std::string sortColumn_;
+  const core::SortOrder sortOrder_;
+};
+
+/// Bucketing properties of the Hive table to be written. The rows are
+/// assigned to 'bucketCount' buckets by the Hive hash of the 'bucketedBy'
+/// columns and each bucket of each partition is written to its own files. If
+/// 'sortedBy' is not empty, the rows of each file are sorted on it.
+class HiveBucketProperty {
+ public:
+  HiveBucketProperty(
+      int32_t bucketCount,
+      std::vector<std::string> bucketedBy,
+      std::vector<HiveSortingColumn> sortedBy = {})
+      : bucketCount_(bucketCount),
+        bucketedBy_(std::move(bucketedBy)),
+        sortedBy_(std::move(sortedBy)) {
+    VELOX_USER_CHECK_GT(bucketCount_, 0, "Bucket count must be positive");
+    VELOX_USER_CHECK(
+        !bucketedBy_.empty(), "Bucketed table needs bucketing columns");
+  }
+
+  int32_t bucketCount() const {
+    return bucketCount_;
+  }
+
+  const std::vector<std::string>& bucketedBy() const {
+    return bucketedBy_;
+  }
+
+  const std::vector<HiveSortingColumn>& sortedBy() const {
+    return sortedBy_;
+  }
+
+ private:
+  const int32_t bucketCount_;
+  const std::vector<std::string> bucketedBy_;
+  const std::vector<HiveSortingColumn> sortedBy_;
+};
+
 /**
  * Represents a request for Hive write.
  */
@@ -69,9 +131,11 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
  public:
   HiveInsertTableHandle(
       std::vector<std::shared_ptr<const HiveColumnHandle>> inputColumns,
-      std::shared_ptr<const LocationHandle> locationHandle)
+      std::shared_ptr<const LocationHandle> locationHandle,
+      std::shared_ptr<const HiveBucketProperty> bucketProperty = nullptr)
       : inputColumns_(std::move(inputColumns)),
-        locationHandle_(std::move(locationHandle)) {}
+        locationHandle_(std::move(locationHandle)),
+        bucketProperty_(std::move(bucketProperty)) {}
 
   virtual ~HiveInsertTableHandle() = default;
 
@@ -84,13 +148,24 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
     return locationHandle_;
   }
 
+  /// Returns the bucketing properties, or nullptr if the table is not
+  /// bucketed.
+  const std::shared_ptr<const HiveBucketProperty>& bucketProperty() const {
+    return bucketProperty_;
+  }
+
   bool isPartitioned() const;
 
+  bool isBucketed() const {
+    return bucketProperty_ != nullptr;
+  }
+
   bool isInsertTable() const;
 
  private:
   const std::vector<std::shared_ptr<const HiveColumnHandle>> inputColumns_;
   const std::shared_ptr<const LocationHandle> locationHandle_;
+  const std::shared_ptr<const HiveBucketProperty> bucketProperty_;
 };
 
 /// Parameters for Hive writers.
@@ -192,16 +267,54 @@ class HiveDataSink : public DataSink {
       const ConnectorQueryCtx* connectorQueryCtx,
       CommitStrategy commitStrategy);
 
+  ~HiveDataSink() override;
+
   void appendData(RowVectorPtr input) override;
 
   std::vector<std::string> finish() const override;
 
+  /// Writes out the sorted rows of a sorted table and closes the writers.
   void close() override;
 
+  bool canReclaim() const override {
+    return !writers_.empty();
+  }
+
+  /// Flushes the stripes of the writers with the most buffered data until
+  /// 'targetBytes' are freed, or of all the writers if 'targetBytes' is zero.
+  uint64_t reclaim(uint64_t targetBytes) override {
+    return flushLargestWriters(targetBytes);
+  }
+
  private:
-  // Pass 0 as partitionId when creating the single writer for an
-  // unpartitioned table.
-  void appendWriter(const std::optional<std::string>& partitionName);
+  // Writes the rows of 'input' to the writers of their partitions and buckets.
+  void appendToWriters(const RowVectorPtr& input);
+
+  // Appends a writer for 'partitionName' and, if the table is bucketed,
+  // 'bucketId'. Creates a sort buffer for the writer if the table is sorted.
+  void appendWriter(
+      const std::optional<std::string>& partitionName,
+      std::optional<uint32_t> bucketId = std::nullopt);
+
+  // Writes 'input' to the writer at 'index', or adds it to the sort buffer of
+  // the writer if the table is sorted.
+  void write(size_t index, const RowVectorPtr& input);
+
+  // Sets partitionIds_ to the writer index of each row of 'input' for a
+  // bucketed table, creating the writers for new (partition, bucket) pairs.
+  void computeBucketedWriterIds(const RowVectorPtr& input);
+
+  // Flushes the largest writers if the memory buffered by all the writers
+  // exceeds 'writersMemoryBudget_'.
+  void ensureWritersMemoryBudget();
+
+  // Flushes the stripes of the writers in descending order of buffered memory
+  // until 'targetBytes' are freed. Flushes all the writers if 'targetBytes'
+  // is zero. Returns the number of bytes freed.
+  uint64_t flushLargestWriters(uint64_t targetBytes);
+
+  // Creates the sort buffer for a writer of a sorted table.
+  std::unique_ptr<exec::SortBuffer> makeSortBuffer() const;
 
   // Make sure to create the one writer for unpartitioned table.
   void ensureSingleWriter();
@@ -210,11 +323,12 @@ class HiveDataSink : public DataSink {
   void ensurePartitionWriters();
 
   // Compute the number of rows as well as the actual row indices corresponding
-  // to every partition ID, based on the ID labeling of partitionIds_.
+  // to every writer, based on the ID labeling of partitionIds_.
   void computePartitionRowCountsAndIndices();
 
   std::shared_ptr<const HiveWriterParameters> getWriterParameters(
-      const std::optional<std::string>& partition) const;
+      const std::optional<std::string>& partition,
+      std::optional<uint32_t> bucketId) const;
 
   HiveWriterParameters::UpdateMode getUpdateMode() const;
 
@@ -224,15 +338,33 @@ class HiveDataSink : public DataSink {
   const CommitStrategy commitStrategy_;
   const std::vector<column_index_t> partitionChannels_;
   const std::unique_ptr<PartitionIdGenerator> partitionIdGenerator_;
-
-  // Below are structures for partitions from all inputs. writerInfo_ and
-  // writers_ are both indexed by partitionId.
+  // The memory that all the writers may buffer, or zero if unlimited.
+  const uint64_t writersMemoryBudget_;
+  // Computes the bucket of each row of a bucketed table. Null if the table is
+  // not bucketed.
+  const std::unique_ptr<core::PartitionFunction> bucketFunction_;
+  // The input channels and the compare flags of the sorting columns. Empty if
+  // the table is not sorted.
+  std::vector<column_index_t> sortChannels_;
+  std::vector<CompareFlags> sortCompareFlags_;
+
+  // Below are structures for partitions from all inputs. writerInfo_,
+  // writers_ and sortBuffers_ are indexed by partitionId for an unbucketed
+  // table, and in creation order for a bucketed table.
   std::vector<std::shared_ptr<HiveWriterInfo>> writerInfo_;
   std::vector<std::unique_ptr<dwrf::Writer>> writers_;
+  std::vector<std::unique_ptr<exec::SortBuffer>> sortBuffers_;
+
+  // The writer index of each (partitionId, bucket) pair of a bucketed table,
+  // keyed on partitionId * bucketCount + bucket.
+  folly::F14FastMap<uint64_t, uint32_t> bucketedWriterIndices_;
 
   // Below are structures updated when processing current input. partitionIds_
-  // are indexed by the row of input_. partitionRows_, rawPartitionRows_ and
-  // partitionSizes_ are indexed by partitionId.
+  // are indexed by the row of input_ and hold the writer index of a bucketed
+  // table. bucketIds_ holds the bucket of each row of a bucketed table.
+  // partitionRows_, rawPartitionRows_ and partitionSizes_ are indexed by the
+  // writer index.
+  std::vector<uint32_t> bucketIds_;
   raw_vector<uint64_t> partitionIds_;
   std::vector<BufferPtr> partitionRows_;
   std::vector<vector_size_t*> rawPartitionRows_;
@@ -36,6 +36,23 @@ void abstractHashTyped(
     bool mix,
     Func&& hashOne,
     std::vector<uint32_t>& hashes) {
+  // Flat columns without nulls are hashed in a tight loop over their values,
+  // which the compiler can unroll and vectorize for fixed-width types.
+  if constexpr (!std::is_same_v<T, bool>) {
+    if (values.isIdentityMapping() && !values.mayHaveNulls()) {
+      auto* rawValues = values.data<T>();
+      if (mix) {
+        for (auto i = 0; i < size; ++i) {
+          hashes[i] = hashes[i] * 31 + hashOne(rawValues[i]);
+        }
+      } else {
+        for (auto i = 0; i < size; ++i) {
+          hashes[i] = hashOne(rawValues[i]);
+        }
+      }
+      return;
+    }
+  }
   for (auto i = 0; i < size; ++i) {
     const uint32_t hash =
         (values.isNullAt(i)) ? 0 : hashOne(values.valueAt<T>(i));
@@ -62,32 +62,33 @@ void PartitionIdGenerator::run(
   computeValueIds(input, result);
 
   // Convert value IDs in 'result' into partition IDs using partitionIds
-  // mapping. Update 'result' in place.
-
-  // TODO Optimize common use case where all records belong to the same
-  // partition. VectorHashers keep track of the number of unique values, hence,
-  // we can find out if there is only one unique value for each partition key.
+  // mapping. Update 'result' in place. The rows of a partition often come in
+  // runs, so a row with the value ID of the previous row takes its partition
+  // ID without a lookup.
+  uint64_t lastValueId = 0;
+  uint64_t lastPartitionId = 0;
   for (auto i = 0; i < numRows; ++i) {
-    auto valueId = result[i];
-    auto it = partitionIds_.find(valueId);
-    if (it != partitionIds_.end()) {
-      result[i] = it->second;
-    } else {
-      uint64_t nextPartitionId = partitionIds_.size();
-      VELOX_USER_CHECK_LT(
-          nextPartitionId,
-          maxPartitions_,
-          "Exceeded limit of {} distinct partitions.",
-          maxPartitions_);
-
-      partitionIds_.emplace(valueId, nextPartitionId);
-      savePartitionValues(nextPartitionId, input, i);
-
-      result[i] = nextPartitionId;
+    const auto valueId = result[i];
+    if (i == 0 || valueId != lastValueId) {
+      lastValueId = valueId;
+      lastPartitionId = partitionId(valueId, input, i);
     }
+    result[i] = lastPartitionId;
   }
 }
 
+uint32_t PartitionIdGenerator::addPartition(
+    const RowVectorPtr& input,
+    vector_size_t row) {
+  VELOX_USER_CHECK_LT(
+      numPartitions_,
+      maxPartitions_,
+      "Exceeded limit of {} distinct partitions.",
+      maxPartitions_);
+  savePartitionValues(numPartitions_, input, row);
+  return numPartitions_++;
+}
+
 std::string PartitionIdGenerator::partitionName(uint64_t partitionId) const {
   return makePartitionName(partitionValues_, partitionId);
 }
@@ -111,33 +112,51 @@ void PartitionIdGenerator::computeValueIds(
     return;
   }
 
+  const auto numValueIds = enableValueIds();
+
+  for (auto& hasher : hashers_) {
+    const bool ok = hasher->computeValueIds(allRows_, valueIds);
+    VELOX_CHECK(ok);
+  }
+
+  updateValueToPartitionIdMapping(numValueIds);
+}
+
+uint64_t PartitionIdGenerator::enableValueIds() {
   uint64_t multiplier = 1;
   for (auto& hasher : hashers_) {
-    multiplier = hasher->enableValueIds(multiplier, 50);
+    uint64_t asRange;
+    uint64_t asDistincts;
+    hasher->cardinality(kHasherReservePct, asRange, asDistincts);
+    // Range mode computes the ids arithmetically, without a lookup of each
+    // value in the distinct values.
+    if (asRange != exec::VectorHasher::kRangeTooLarge &&
+        asRange <= std::max<uint64_t>(asDistincts, kMaxArrayValueIds)) {
+      multiplier = hasher->enableValueRange(multiplier, kHasherReservePct);
+    } else {
+      multiplier = hasher->enableValueIds(multiplier, 50);
+    }
 
     VELOX_CHECK_NE(
         multiplier,
         exec::VectorHasher::kRangeTooLarge,
         "Number of requested IDs is out of range.");
   }
-
-  for (auto& hasher : hashers_) {
-    const bool ok = hasher->computeValueIds(allRows_, valueIds);
-    VELOX_CHECK(ok);
-  }
-
-  updateValueToPartitionIdMapping();
+  return multiplier;
 }
 
-void PartitionIdGenerator::updateValueToPartitionIdMapping() {
-  if (partitionIds_.empty()) {
+void PartitionIdGenerator::updateValueToPartitionIdMapping(
+    uint64_t numValueIds) {
+  partitionIds_.clear();
+  arrayPartitionIds_.clear();
+  if (numValueIds <= kMaxArrayValueIds) {
+    arrayPartitionIds_.resize(numValueIds, kNoPartition);
+  }
+  if (numPartitions_ == 0) {
     return;
   }
 
-  auto numPartitions = partitionIds_.size();
-
-  partitionIds_.clear();
-
+  const auto numPartitions = numPartitions_;
   raw_vector<uint64_t> newValueIds(numPartitions);
   SelectivityVector rows(numPartitions);
   for (auto i = 0; i < hashers_.size(); ++i) {
@@ -148,7 +167,11 @@ void PartitionIdGenerator::updateValueToPartitionIdMapping() {
   }
 
   for (auto i = 0; i < numPartitions; ++i) {
-    partitionIds_.emplace(newValueIds[i], i);
+    if (!arrayPartitionIds_.empty()) {
+      arrayPartitionIds_[newValueIds[i]] = i;
+    } else {
+      partitionIds_.emplace(newValueIds[i], i);
+    }
   }
 }
 
@@ -16,12 +16,17 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/exec/VectorHasher.h"
 
 namespace facebook::velox::connector::hive {
 /// Generate sequential integer IDs for distinct partition values, which could
-/// be used as vector index. Only single partition key is supported at the
-/// moment.
+/// be used as vector index. The partition keys are mapped to value IDs by
+/// VectorHashers, in range mode for keys with a narrow range of values and in
+/// distinct values mode otherwise. If the value IDs of all the keys combined
+/// fit in kMaxArrayValueIds, the partition IDs are looked up in an array
+/// indexed by value ID, otherwise in a hash map.
 class PartitionIdGenerator {
  public:
   /// @param inputType RowType of the input.
@@ -43,7 +48,7 @@ class PartitionIdGenerator {
 
   /// Return the total number of distinct partitions processed so far.
   uint64_t numPartitions() const {
-    return partitionIds_.size();
+    return numPartitions_;
   }
 
   /// Return partition name for the given partition id in the typical Hive
@@ -55,16 +60,53 @@ class PartitionIdGenerator {
  private:
   static constexpr const int32_t kHasherReservePct = 20;
 
+  // Max number of combined value IDs for which the partition IDs are kept in
+  // 'arrayPartitionIds_'.
+  static constexpr uint64_t kMaxArrayValueIds = 1 << 16;
+
+  // Marks the value IDs without a partition in 'arrayPartitionIds_'.
+  static constexpr uint32_t kNoPartition = ~0U;
+
   // Computes value IDs using VectorHashers for all rows in 'input'.
   void computeValueIds(
       const RowVectorPtr& input,
       raw_vector<uint64_t>& valueIds);
 
+  // Sets each hasher to range or distinct values mode, whichever gives fewer
+  // value IDs. Returns the number of combined value IDs.
+  uint64_t enableValueIds();
+
   // In case of rehash (when value IDs produced by VectorHashers change), we
   // update value id for pre-existing partitions while keeping partition ids.
-  // This method rebuilds 'partitionIds_' by re-calculating the value ids using
-  // updated 'hashers_'.
-  void updateValueToPartitionIdMapping();
+  // This method rebuilds the value ID to partition ID mapping by
+  // re-calculating the value ids using updated 'hashers_'. 'numValueIds' is
+  // the number of combined value IDs.
+  void updateValueToPartitionIdMapping(uint64_t numValueIds);
+
+  // Returns the partition ID of 'valueId'. Adds a partition for the values of
+  // 'row' in 'input' if 'valueId' has none.
+  uint64_t partitionId(
+      uint64_t valueId,
+      const RowVectorPtr& input,
+      vector_size_t row) {
+    if (!arrayPartitionIds_.empty()) {
+      auto& id = arrayPartitionIds_[valueId];
+      if (id == kNoPartition) {
+        id = addPartition(input, row);
+      }
+      return id;
+    }
+    auto it = partitionIds_.find(valueId);
+    if (it != partitionIds_.end()) {
+      return it->second;
+    }
+    const auto id = addPartition(input, row);
+    partitionIds_.emplace(valueId, id);
+    return id;
+  }
+
+  // Returns the ID of a new partition for the values of 'row' in 'input'.
+  uint32_t addPartition(const RowVectorPtr& input, vector_size_t row);
 
   // Copies partition values of 'row' from 'input' into 'partitionId' row in
   // 'partitionValues_'.
@@ -79,8 +121,16 @@ class PartitionIdGenerator {
 
   std::vector<std::unique_ptr<exec::VectorHasher>> hashers_;
 
-  // A mapping from value ID produced by VectorHashers to a partition ID.
-  std::unordered_map<uint64_t, uint64_t> partitionIds_;
+  uint32_t numPartitions_{0};
+
+  // A mapping from value ID produced by VectorHashers to a partition ID if
+  // there are at most kMaxArrayValueIds value IDs. kNoPartition for the value
+  // IDs that have not been seen.
+  std::vector<uint32_t> arrayPartitionIds_;
+
+  // A mapping from value ID produced by VectorHashers to a partition ID if
+  // there are too many value IDs for 'arrayPartitionIds_'.
+  folly::F14FastMap<uint64_t, uint32_t> partitionIds_;
 
   // A vector holding unique partition key values. One row per partition. Row
   // numbers match partition IDs.
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsFileSystem.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <hdfs/hdfs.h>
 #include <mutex>
 #include "folly/concurrency/ConcurrentHashMap.h"
@@ -33,6 +35,7 @@ class HdfsFileSystem::Impl {
     auto builder = hdfsNewBuilder();
     hdfsBuilderSetNameNode(builder, endpointInfo.host.c_str());
     hdfsBuilderSetNameNodePort(builder, endpointInfo.port);
+    configure(config, builder);
     hdfsClient_ = hdfsBuilderConnect(builder);
     VELOX_CHECK_NOT_NULL(
         hdfsClient_,
@@ -44,6 +47,7 @@ class HdfsFileSystem::Impl {
     auto builder = hdfsNewBuilder();
     hdfsBuilderSetNameNode(builder, endpoint.host.c_str());
     hdfsBuilderSetNameNodePort(builder, endpoint.port);
+    configure(config, builder);
     hdfsClient_ = hdfsBuilderConnect(builder);
     VELOX_CHECK_NOT_NULL(
         hdfsClient_,
@@ -53,6 +57,9 @@ class HdfsFileSystem::Impl {
   }
 
   ~Impl() {
+    if (executor_) {
+      executor_->join();
+    }
     LOG(INFO) << "Disconnecting HDFS file system";
     int disconnectResult = hdfsDisconnect(hdfsClient_);
     if (disconnectResult != 0) {
@@ -65,8 +72,47 @@ class HdfsFileSystem::Impl {
     return hdfsClient_;
   }
 
+  folly::Executor* executor() const {
+    return executor_.get();
+  }
+
+  std::chrono::milliseconds hedgeDelay() const {
+    return hedgeDelay_;
+  }
+
  private:
+  // Applies the Velox HDFS settings in 'config' to 'builder' and creates the
+  // executor for asynchronous reads.
+  void configure(const Config* config, hdfsBuilder* builder) {
+    if (config == nullptr) {
+      return;
+    }
+    // Short-circuit reads bypass the datanode and read local block replicas
+    // directly from disk. The datanode passes the block file descriptors over
+    // a Unix domain socket.
+    if (config->get<bool>("hive.hdfs.short-circuit-read.enabled", false)) {
+      auto socketPath = config->get("hive.hdfs.domain-socket-path");
+      VELOX_USER_CHECK(
+          socketPath.hasValue(),
+          "hive.hdfs.domain-socket-path is required for short-circuit reads");
+      hdfsBuilderConfSetStr(builder, "dfs.client.read.shortcircuit", "true");
+      hdfsBuilderConfSetStr(
+          builder, "dfs.domain.socket.path", socketPath->c_str());
+    }
+    const auto ioThreads = config->get<uint32_t>("hive.hdfs.io-threads", 8);
+    if (ioThreads > 0) {
+      executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          ioThreads, std::make_shared<folly::NamedThreadFactory>("HdfsIO"));
+    }
+    hedgeDelay_ = std::chrono::milliseconds(
+        config->get<uint32_t>("hive.hdfs.hedge-delay-ms", 0));
+  }
+
   hdfsFS hdfsClient_;
+  // Runs the asynchronous reads of the files of 'this'. Null if
+  // asynchronous reads are disabled.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+  std::chrono::milliseconds hedgeDelay_{0};
 };
 
 HdfsFileSystem::HdfsFileSystem(const std::shared_ptr<const Config>& config)
@@ -95,7 +141,8 @@ std::unique_ptr<ReadFile> HdfsFileSystem::openFileForRead(
     path.remove_prefix(index);
   }
 
-  return std::make_unique<HdfsReadFile>(impl_->hdfsClient(), path);
+  return std::make_unique<HdfsReadFile>(
+      impl_->hdfsClient(), path, impl_->executor(), impl_->hedgeDelay());
 }
 
 std::unique_ptr<WriteFile> HdfsFileSystem::openFileForWrite(
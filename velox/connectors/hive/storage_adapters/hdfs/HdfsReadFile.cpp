@@ -15,13 +15,23 @@
  */
 
 #include "HdfsReadFile.h"
+#include "velox/common/file/HedgedRead.h"
+#include <folly/ScopeGuard.h>
+#include <folly/futures/Future.h>
 #include <folly/synchronization/CallOnce.h>
 #include <hdfs/hdfs.h>
 
 namespace facebook::velox {
 
-HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
-    : hdfsClient_(hdfs), filePath_(path) {
+HdfsReadFile::HdfsReadFile(
+    hdfsFS hdfs,
+    const std::string_view path,
+    folly::Executor* executor,
+    std::chrono::milliseconds hedgeDelay)
+    : hdfsClient_(hdfs),
+      filePath_(path),
+      executor_(executor),
+      hedgeDelay_(hedgeDelay) {
   fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
   VELOX_CHECK_NOT_NULL(
       fileInfo_,
@@ -33,34 +43,83 @@ HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
 void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   checkFileReadParameters(offset, length);
-  auto file = hdfsOpenFile(hdfsClient_, filePath_.data(), O_RDONLY, 0, 0, 0);
+  readRange(hdfsClient_, filePath_, offset, length, pos);
+}
+
+// static
+void HdfsReadFile::readRange(
+    hdfsFS hdfs,
+    const std::string& path,
+    uint64_t offset,
+    uint64_t length,
+    char* pos) {
+  auto file = hdfsOpenFile(hdfs, path.data(), O_RDONLY, 0, 0, 0);
   VELOX_CHECK_NOT_NULL(
-      file,
-      "Unable to open file {}. got error: {}",
-      filePath_,
-      hdfsGetLastError());
-  seekToPosition(file, offset);
+      file, "Unable to open file {}. got error: {}", path, hdfsGetLastError());
+  auto closeFile = folly::makeGuard([&]() {
+    if (hdfsCloseFile(hdfs, file) == -1) {
+      LOG(ERROR) << "Unable to close file, errno: " << errno;
+    }
+  });
+  auto seekStatus = hdfsSeek(hdfs, file, offset);
+  VELOX_CHECK_EQ(
+      seekStatus,
+      0,
+      "Cannot seek through HDFS file: {}, error: {}",
+      path,
+      std::string(hdfsGetLastError()));
   uint64_t totalBytesRead = 0;
   while (totalBytesRead < length) {
-    auto bytesRead = hdfsRead(hdfsClient_, file, pos, length - totalBytesRead);
+    auto bytesRead = hdfsRead(hdfs, file, pos, length - totalBytesRead);
     VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
     totalBytesRead += bytesRead;
     pos += bytesRead;
   }
+}
 
-  if (hdfsCloseFile(hdfsClient_, file) == -1) {
-    LOG(ERROR) << "Unable to close file, errno: " << errno;
-  }
+folly::SemiFuture<std::string> HdfsReadFile::readAsync(
+    uint64_t offset,
+    uint64_t length) const {
+  auto read = [hdfs = hdfsClient_, path = filePath_, offset, length]() {
+    std::string data(length, 0);
+    readRange(hdfs, path, offset, length, data.data());
+    return data;
+  };
+  // The hedged read opens its own handle, which gets the block locations
+  // from the name node again. The name node shuffles replicas at the same
+  // distance, so the hedged read usually goes to a different datanode than
+  // the slow one.
+  return hedgedReadAsync(executor_, hedgeDelay_, std::move(read));
 }
 
-void HdfsReadFile::seekToPosition(hdfsFile file, uint64_t offset) const {
-  auto seekStatus = hdfsSeek(hdfsClient_, file, offset);
-  VELOX_CHECK_EQ(
-      seekStatus,
-      0,
-      "Cannot seek through HDFS file: {}, error: {}",
-      filePath_,
-      std::string(hdfsGetLastError()));
+folly::SemiFuture<uint64_t> HdfsReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (!hasPreadvAsync()) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  // Like S3, HDFS reads one range per request, so read the range spanning
+  // 'buffers' and copy out the non-gap ranges.
+  uint64_t length = 0;
+  for (const auto range : buffers) {
+    length += range.size();
+  }
+  try {
+    checkFileReadParameters(offset, length);
+  } catch (const std::exception&) {
+    return folly::makeSemiFuture<uint64_t>(
+        folly::exception_wrapper(std::current_exception()));
+  }
+  return readAsync(offset, length).deferValue([buffers](std::string data) {
+    uint64_t dataOffset = 0;
+    for (const auto range : buffers) {
+      if (range.data()) {
+        memcpy(range.data(), data.data() + dataOffset, range.size());
+      }
+      dataOffset += range.size();
+    }
+    return dataOffset;
+  });
 }
 
 std::string_view
@@ -14,20 +14,38 @@
  * limitations under the License.
  */
 
+#include <folly/Executor.h>
 #include <hdfs/hdfs.h>
+#include <chrono>
 #include "velox/common/file/File.h"
 
 namespace facebook::velox {
 
 class HdfsReadFile final : public ReadFile {
  public:
-  explicit HdfsReadFile(hdfsFS hdfs, std::string_view path);
+  /// If 'executor' is set, preadvAsync() reads on 'executor'. If
+  /// 'hedgeDelay' is also non-zero, a read that has not completed after
+  /// 'hedgeDelay' is duplicated and the first read to complete supplies the
+  /// data.
+  explicit HdfsReadFile(
+      hdfsFS hdfs,
+      std::string_view path,
+      folly::Executor* executor = nullptr,
+      std::chrono::milliseconds hedgeDelay = std::chrono::milliseconds(0));
 
   std::string_view pread(uint64_t offset, uint64_t length, void* buf)
       const final;
 
   std::string pread(uint64_t offset, uint64_t length) const final;
 
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final {
+    return executor_ != nullptr;
+  }
+
   uint64_t size() const final;
 
   uint64_t memoryUsage() const final;
@@ -44,10 +62,27 @@ class HdfsReadFile final : public ReadFile {
 
  private:
   void preadInternal(uint64_t offset, uint64_t length, char* pos) const;
-  void seekToPosition(hdfsFile file, uint64_t offset) const;
+
+  // Opens 'path' with its own handle and reads 'length' bytes at 'offset'
+  // into 'pos'. Does not reference the file, so that a losing hedged read can
+  // complete after the file is gone.
+  static void readRange(
+      hdfsFS hdfs,
+      const std::string& path,
+      uint64_t offset,
+      uint64_t length,
+      char* pos);
+
+  // Reads 'length' bytes at 'offset' on 'executor_' with hedgedReadAsync(),
+  // hedged if 'hedgeDelay_' is non-zero.
+  folly::SemiFuture<std::string> readAsync(uint64_t offset, uint64_t length)
+      const;
+
   void checkFileReadParameters(uint64_t offset, uint64_t length) const;
   hdfsFS hdfsClient_;
   hdfsFileInfo* fileInfo_;
   std::string filePath_;
+  folly::Executor* const executor_;
+  const std::chrono::milliseconds hedgeDelay_;
 };
 } // namespace facebook::velox
@@ -17,6 +17,7 @@
 #include <boost/format.hpp>
 #include <connectors/hive/storage_adapters/hdfs/HdfsReadFile.h>
 #include <connectors/hive/storage_adapters/hdfs/HdfsWriteFile.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gmock/gmock-matchers.h>
 #include <hdfs/hdfs.h>
 #include <atomic>
@@ -175,6 +176,46 @@ TEST_F(HdfsFileSystemTest, read) {
   readData(&readFile);
 }
 
+TEST_F(HdfsFileSystemTest, preadvAsync) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, 7878);
+  auto hdfs = hdfsBuilderConnect(builder);
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto hedgeDelayMs : {0, 1}) {
+    SCOPED_TRACE(fmt::format("hedgeDelayMs: {}", hedgeDelayMs));
+    HdfsReadFile readFile(
+        hdfs,
+        destinationPath,
+        &executor,
+        std::chrono::milliseconds(hedgeDelayMs));
+    ASSERT_TRUE(readFile.hasPreadvAsync());
+    char head[12];
+    char middle[4];
+    char tail[7];
+    std::vector<folly::Range<char*>> buffers = {
+        folly::Range<char*>(head, sizeof(head)),
+        folly::Range<char*>(nullptr, 500000),
+        folly::Range<char*>(middle, sizeof(middle)),
+        folly::Range<char*>(
+            nullptr,
+            15 + kOneMB - 500000 - sizeof(head) - sizeof(middle) -
+                sizeof(tail)),
+        folly::Range<char*>(tail, sizeof(tail))};
+    ASSERT_EQ(15 + kOneMB, readFile.preadvAsync(0, buffers).get());
+    ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+    ASSERT_EQ(std::string_view(middle, sizeof(middle)), "cccc");
+    ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+
+    // Reads past the end fail through the future.
+    VELOX_ASSERT_THROW(
+        readFile.preadvAsync(10, buffers).get(),
+        "Cannot read HDFS file beyond its size");
+  }
+  HdfsReadFile syncFile(hdfs, destinationPath);
+  ASSERT_FALSE(syncFile.hasPreadvAsync());
+}
+
 TEST_F(HdfsFileSystemTest, viaFileSystem) {
   facebook::velox::filesystems::registerHdfsFileSystem();
   auto memConfig = std::make_shared<const core::MemConfig>(configurationValues);
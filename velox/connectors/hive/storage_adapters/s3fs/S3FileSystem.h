@@ -20,6 +20,20 @@
 
 namespace facebook::velox::filesystems {
 
+// Cumulative statistics of the ranged GETs issued by the files of an
+// S3FileSystem.
+struct S3ReadStats {
+  uint64_t numGets{0};
+  uint64_t getBytes{0};
+  // Sum and maximum of the wall time of the GETs.
+  uint64_t getLatencyUs{0};
+  uint64_t maxGetLatencyUs{0};
+  // Number of duplicate GETs issued for slow parts of asynchronous reads and
+  // the number of these that completed before the original GET.
+  uint64_t numHedgedGets{0};
+  uint64_t numHedgeWins{0};
+};
+
 // Implementation of S3 filesystem and file interface.
 // We provide a registration method for read and write files so the appropriate
 // type of file can be constructed based on a filename. See the
@@ -70,6 +84,8 @@ class S3FileSystem : public FileSystem {
 
   std::string getLogLevelName() const;
 
+  S3ReadStats readStats() const;
+
  protected:
   class Impl;
   std::shared_ptr<Impl> impl_;
@@ -17,13 +17,19 @@
 #include "connectors/hive/storage_adapters/s3fs/S3FileSystem.h"
 #include "connectors/hive/storage_adapters/s3fs/S3Util.h"
 #include "connectors/hive/storage_adapters/s3fs/tests/MinioServer.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/File.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/common/testutil/TestValue.h"
 #include "velox/connectors/hive/FileHandle.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
 #include "gtest/gtest.h"
 
+#include <thread>
+
 using namespace facebook::velox;
+using facebook::velox::common::testutil::TestValue;
 
 constexpr int kOneMB = 1 << 20;
 
@@ -35,6 +41,7 @@ class S3FileSystemTest : public testing::Test {
       minioServer_->start();
     }
     filesystems::registerS3FileSystem();
+    TestValue::enable();
   }
 
   static void TearDownTestSuite() {
@@ -118,6 +125,166 @@ TEST_F(S3FileSystemTest, writeAndRead) {
   readData(readFile.get());
 }
 
+TEST_F(S3FileSystemTest, preadvAsync) {
+  const char* bucketName = "data-async";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  for (const auto* hedgeDelay : {"0", "1"}) {
+    SCOPED_TRACE(fmt::format("hedgeDelay: {}", hedgeDelay));
+    auto hiveConfig = minioServer_->hiveConfig(
+        {{"hive.s3.read-part-size", "100000"},
+         {"hive.s3.hedge-delay-ms", hedgeDelay}});
+    filesystems::S3FileSystem s3fs(hiveConfig);
+    s3fs.initializeClient();
+    auto readFile = s3fs.openFileForRead(s3File);
+    ASSERT_TRUE(readFile->hasPreadvAsync());
+
+    char head[12];
+    char middle[4];
+    char tail[7];
+    std::vector<folly::Range<char*>> buffers = {
+        folly::Range<char*>(head, sizeof(head)),
+        folly::Range<char*>(nullptr, (char*)(uint64_t)500000),
+        folly::Range<char*>(middle, sizeof(middle)),
+        folly::Range<char*>(
+            nullptr,
+            (char*)(uint64_t)(15 + kOneMB - 500000 - sizeof(head) - sizeof(middle) - sizeof(tail))),
+        folly::Range<char*>(tail, sizeof(tail))};
+    ASSERT_EQ(15 + kOneMB, readFile->preadvAsync(0, buffers).get());
+    ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+    ASSERT_EQ(std::string_view(middle, sizeof(middle)), "cccc");
+    ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+
+    // The range is read in parts of 100000 bytes. Losing hedged GETs may
+    // still be in flight, so the counts are lower bounds.
+    const auto stats = s3fs.readStats();
+    ASSERT_GE(stats.numGets, (15 + kOneMB + 99999) / 100000);
+    ASSERT_GE(stats.getBytes, 15 + kOneMB);
+    ASSERT_LE(stats.numHedgeWins, stats.numHedgedGets);
+    ASSERT_GE(stats.getLatencyUs, stats.maxGetLatencyUs);
+    if (std::string(hedgeDelay) == "0") {
+      ASSERT_EQ(stats.numHedgedGets, 0);
+    }
+
+    // Synchronous reads issue a single GET each.
+    readData(readFile.get());
+    ASSERT_GE(s3fs.readStats().numGets, stats.numGets + 7);
+  }
+}
+
+TEST_F(S3FileSystemTest, write) {
+  const char* bucketName = "data-write";
+  addBucket(bucketName);
+  auto pool = memory::addDefaultLeafMemoryPool();
+  for (const auto* ioThreads : {"0", "4"}) {
+    SCOPED_TRACE(fmt::format("ioThreads: {}", ioThreads));
+    auto hiveConfig = minioServer_->hiveConfig(
+        {{"hive.s3.write-part-size", std::to_string(5 * kOneMB)},
+         {"hive.s3.max-upload-parts-in-flight", "2"},
+         {"hive.s3.io-threads", ioThreads}});
+    filesystems::S3FileSystem s3fs(hiveConfig);
+    s3fs.initializeClient();
+
+    // A file smaller than a part is uploaded in one request.
+    const auto smallFile = s3URI(bucketName, fmt::format("small{}", ioThreads));
+    {
+      filesystems::FileOptions options;
+      options.pool = pool.get();
+      auto writeFile = s3fs.openFileForWrite(smallFile, options);
+      writeData(writeFile.get());
+      ASSERT_GT(pool->getCurrentBytes(), 0);
+      writeFile->close();
+      ASSERT_EQ(pool->getCurrentBytes(), 0);
+    }
+    readData(s3fs.openFileForRead(smallFile).get());
+
+    // A multipart upload of 4 full parts and a partial last part.
+    const auto largeFile = s3URI(bucketName, fmt::format("large{}", ioThreads));
+    std::string data(21 * kOneMB + 123, 0);
+    for (auto i = 0; i < data.size(); ++i) {
+      data[i] = 'a' + i % 23;
+    }
+    {
+      filesystems::FileOptions options;
+      options.pool = pool.get();
+      auto writeFile = s3fs.openFileForWrite(largeFile, options);
+      for (auto offset = 0; offset < data.size(); offset += kOneMB / 3) {
+        writeFile->append(std::string_view(data).substr(offset, kOneMB / 3));
+      }
+      ASSERT_EQ(writeFile->size(), data.size());
+      // At most 2 parts in flight and the one being filled.
+      ASSERT_LE(pool->getCurrentBytes(), 3 * 5 * kOneMB);
+      writeFile->close();
+      ASSERT_EQ(pool->getCurrentBytes(), 0);
+    }
+    auto readFile = s3fs.openFileForRead(largeFile);
+    ASSERT_EQ(readFile->size(), data.size());
+    ASSERT_EQ(readFile->pread(0, data.size()), data);
+  }
+
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.write-part-size", std::to_string(kOneMB)}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  VELOX_ASSERT_THROW(
+      s3fs.openFileForWrite(s3URI(bucketName, "tooSmallParts")),
+      "hive.s3.write-part-size must be at least 5MB");
+}
+
+DEBUG_ONLY_TEST_F(S3FileSystemTest, failedUploadPart) {
+  const char* bucketName = "data-failed-upload";
+  addBucket(bucketName);
+  auto pool = memory::addDefaultLeafMemoryPool();
+  // Part 2 fails while part 3 is slow, so that part 3 is still in flight when
+  // the failure is found and the upload is aborted.
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::S3WriteFile::uploadPart",
+      std::function<void(int32_t*)>([](int32_t* partNumber) {
+        if (*partNumber == 2) {
+          VELOX_FAIL("Injected upload failure");
+        }
+        if (*partNumber == 3) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+      }));
+  const std::string data(21 * kOneMB, 'a');
+  for (const auto* ioThreads : {"0", "4"}) {
+    SCOPED_TRACE(fmt::format("ioThreads: {}", ioThreads));
+    auto hiveConfig = minioServer_->hiveConfig(
+        {{"hive.s3.write-part-size", std::to_string(5 * kOneMB)},
+         {"hive.s3.max-upload-parts-in-flight", "2"},
+         {"hive.s3.io-threads", ioThreads}});
+    filesystems::S3FileSystem s3fs(hiveConfig);
+    s3fs.initializeClient();
+    const auto file = s3URI(bucketName, fmt::format("failed{}", ioThreads));
+    {
+      filesystems::FileOptions options;
+      options.pool = pool.get();
+      auto writeFile = s3fs.openFileForWrite(file, options);
+      // The failure surfaces from append() or close(), whichever finds it.
+      VELOX_ASSERT_THROW(
+          [&]() {
+            for (auto offset = 0; offset < data.size(); offset += kOneMB) {
+              writeFile->append(std::string_view(data).substr(offset, kOneMB));
+            }
+            writeFile->close();
+          }(),
+          "Injected upload failure");
+      // The aborted file waited for the uploads in flight and freed all the
+      // parts.
+      ASSERT_EQ(pool->getCurrentBytes(), 0);
+    }
+    ASSERT_EQ(pool->getCurrentBytes(), 0);
+    VELOX_ASSERT_THROW(s3fs.openFileForRead(file), "Resource not found");
+  }
+}
+
 TEST_F(S3FileSystemTest, viaRegistry) {
   const char* bucketName = "data2";
   const char* file = "test.txt";
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/connectors/hive/HiveBucketUtil.h"
+#include "gtest/gtest.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
+#include "velox/expression/ExprToSubfieldFilter.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::connector::hive;
+using namespace facebook::velox::exec;
+
+class HiveBucketUtilTest : public ::testing::Test,
+                           public test::VectorTestBase {
+ protected:
+  static constexpr int32_t kNumBuckets = 32;
+
+  // Returns the buckets of the rows of 'keys', in ascending order.
+  std::vector<int32_t> bucketsOf(const RowVectorPtr& keys) {
+    std::vector<int> bucketToPartition(kNumBuckets);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    std::vector<column_index_t> keyChannels(keys->childrenSize());
+    std::iota(keyChannels.begin(), keyChannels.end(), 0);
+    HivePartitionFunction function(
+        kNumBuckets, bucketToPartition, keyChannels);
+    std::vector<uint32_t> partitions;
+    function.partition(*keys, partitions);
+    std::set<int32_t> buckets(partitions.begin(), partitions.end());
+    return std::vector<int32_t>(buckets.begin(), buckets.end());
+  }
+
+  std::optional<std::vector<int32_t>> bucketsForFilters(
+      const std::vector<std::string>& names,
+      const std::vector<TypePtr>& types,
+      std::vector<std::unique_ptr<common::Filter>> filters) {
+    common::ScanSpec scanSpec("root");
+    for (auto i = 0; i < filters.size(); ++i) {
+      scanSpec.getOrCreateChild(common::Subfield(names[i]))
+          ->addFilter(*filters[i]);
+    }
+    return connector::hive::bucketsForFilters(
+        HiveBucketProperty{kNumBuckets, names, types}, scanSpec, pool());
+  }
+
+  std::optional<std::vector<int32_t>> bucketsForFilter(
+      const TypePtr& type,
+      std::unique_ptr<common::Filter> filter) {
+    std::vector<std::unique_ptr<common::Filter>> filters;
+    filters.push_back(std::move(filter));
+    return bucketsForFilters({"c0"}, {type}, std::move(filters));
+  }
+};
+
+TEST_F(HiveBucketUtilTest, singleColumn) {
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  EXPECT_EQ(
+      bucketsOf(makeRowVector({makeFlatVector<int64_t>({77})})),
+      bucketsForFilter(BIGINT(), exec::equal(77)));
+  EXPECT_EQ(
+      bucketsOf(makeRowVector(
+          {makeFlatVector<int64_t>({-1, 3, 1'000'000'000'000, kMax})})),
+      bucketsForFilter(
+          BIGINT(),
+          exec::in({-1, 3, 1'000'000'000'000, kMax})));
+  EXPECT_EQ(
+      bucketsOf(makeRowVector({makeFlatVector<int32_t>({10, 11, 12, 13})})),
+      bucketsForFilter(INTEGER(), exec::between(10, 13)));
+  EXPECT_EQ(
+      bucketsOf(makeRowVector({makeFlatVector<StringView>({"a", "bcd"})})),
+      bucketsForFilter(
+          VARCHAR(), exec::in(std::vector<std::string>{"a", "bcd"})));
+  EXPECT_EQ(
+      bucketsOf(makeRowVector({makeFlatVector<bool>({true})})),
+      bucketsForFilter(BOOLEAN(), exec::boolEqual(true)));
+
+  // A value out of the range of the column matches no row.
+  EXPECT_EQ(
+      bucketsOf(makeRowVector({makeFlatVector<int16_t>({7})})),
+      bucketsForFilter(SMALLINT(), exec::in({7, 100'000})));
+
+  // Nulls are in bucket 0.
+  EXPECT_EQ(
+      bucketsOf(makeRowVector(
+          {makeNullableFlatVector<int64_t>({5, 70, std::nullopt})})),
+      bucketsForFilter(BIGINT(), exec::in({5, 70}, true)));
+  EXPECT_EQ(
+      std::vector<int32_t>{0},
+      bucketsForFilter(BIGINT(), std::make_unique<common::IsNull>()));
+  EXPECT_EQ(
+      std::vector<int32_t>{},
+      bucketsForFilter(BIGINT(), std::make_unique<common::AlwaysFalse>()));
+}
+
+TEST_F(HiveBucketUtilTest, multipleColumns) {
+  std::vector<std::unique_ptr<common::Filter>> filters;
+  filters.push_back(exec::in({1, 5, 1000}));
+  filters.push_back(exec::in(std::vector<std::string>{"a", "bc"}));
+  EXPECT_EQ(
+      bucketsOf(makeRowVector({
+          makeFlatVector<int64_t>({1, 5, 1000, 1, 5, 1000}),
+          makeFlatVector<StringView>({"a", "a", "a", "bc", "bc", "bc"}),
+      })),
+      bucketsForFilters(
+          {"c0", "c1"}, {BIGINT(), VARCHAR()}, std::move(filters)));
+}
+
+TEST_F(HiveBucketUtilTest, unknownBuckets) {
+  // A range of too many values.
+  EXPECT_EQ(
+      std::nullopt, bucketsForFilter(BIGINT(), exec::greaterThanOrEqual(10)));
+  EXPECT_EQ(std::nullopt, bucketsForFilter(BIGINT(), exec::between(0, 5'000)));
+  // A type that is not supported.
+  EXPECT_EQ(std::nullopt, bucketsForFilter(DATE(), exec::equal(1)));
+  // A bucketing column without a filter.
+  std::vector<std::unique_ptr<common::Filter>> filters;
+  filters.push_back(exec::equal(1));
+  EXPECT_EQ(
+      std::nullopt,
+      bucketsForFilters(
+          {"c0", "c1"}, {BIGINT(), BIGINT()}, std::move(filters)));
+  // Too many combinations of values.
+  std::vector<int64_t> values(100);
+  std::iota(values.begin(), values.end(), 0);
+  filters.clear();
+  filters.push_back(exec::in(values));
+  filters.push_back(exec::in(values));
+  EXPECT_EQ(
+      std::nullopt,
+      bucketsForFilters(
+          {"c0", "c1"}, {BIGINT(), BIGINT()}, std::move(filters)));
+}
+
+TEST_F(HiveBucketUtilTest, makeBucketedSplits) {
+  std::vector<std::shared_ptr<HiveConnectorSplit>> splits;
+  for (auto bucket = 0; bucket < 16; ++bucket) {
+    splits.push_back(std::make_shared<HiveConnectorSplit>(
+        "test",
+        fmt::format("file{}", bucket),
+        dwio::common::FileFormat::DWRF,
+        0,
+        100,
+        std::unordered_map<std::string, std::optional<std::string>>{},
+        bucket));
+  }
+  auto bucketedSplits = makeBucketedSplits(splits, 4);
+  ASSERT_EQ(splits.size(), bucketedSplits.size());
+  for (auto i = 0; i < splits.size(); ++i) {
+    EXPECT_EQ(splits[i], bucketedSplits[i].connectorSplit);
+    EXPECT_EQ(i % 4, bucketedSplits[i].groupId);
+  }
+
+  auto notBucketed = std::make_shared<HiveConnectorSplit>(
+      "test", "file", dwio::common::FileFormat::DWRF);
+  VELOX_ASSERT_THROW(
+      bucketSplitGroup(*notBucketed, 4), "Split has no bucket number");
+}
@@ -115,6 +115,24 @@ TEST_F(HivePartitionFunctionTest, bigint) {
   assertPartitionsWithConstChannel(values, 997);
 }
 
+TEST_F(HivePartitionFunctionTest, noNulls) {
+  // Flat vectors without nulls are hashed in a separate loop. The results
+  // must match the same values in the tests with nulls.
+  auto bigints = makeFlatVector<int64_t>(
+      {300'000'000'000,
+       std::numeric_limits<int64_t>::min(),
+       std::numeric_limits<int64_t>::max()});
+  assertPartitions(bigints, 500, {497, 0, 0});
+  assertPartitions(bigints, 997, {852, 0, 0});
+  assertPartitionsWithConstChannel(bigints, 997);
+
+  auto varchars = makeFlatVector<std::string>(
+      {"", "test string", "\u5f3a\u5927\u7684Presto\u5f15\u64ce"});
+  assertPartitions(varchars, 500, {0, 211, 454});
+  assertPartitions(varchars, 997, {0, 894, 831});
+  assertPartitionsWithConstChannel(varchars, 997);
+}
+
 TEST_F(HivePartitionFunctionTest, varchar) {
   auto values = makeNullableFlatVector<std::string>(
       {std::nullopt,
@@ -172,6 +172,47 @@ TEST_F(PartitionIdGeneratorTest, numPartitions) {
   EXPECT_EQ(idGenerator.numPartitions(), 20);
 }
 
+TEST_F(PartitionIdGeneratorTest, arrayAndHashMapping) {
+  PartitionIdGenerator idGenerator(
+      ROW({INTEGER(), BIGINT()}), {0, 1}, 1'000, pool());
+
+  // Runs of rows with a few distinct values in a narrow range. The value IDs
+  // fit in the array mapping.
+  auto narrowInput = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row / 100; }),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row / 500; }),
+  });
+  raw_vector<uint64_t> narrowIds;
+  idGenerator.run(narrowInput, narrowIds);
+  EXPECT_EQ(idGenerator.numPartitions(), 10);
+  for (auto i = 0; i < narrowInput->size(); ++i) {
+    EXPECT_EQ(narrowIds[i], i / 100) << "at " << i;
+  }
+
+  // Values far apart need the hash map mapping. The partitions seen so far
+  // keep their IDs.
+  auto wideInput = makeRowVector({
+      makeFlatVector<int32_t>(
+          500, [](auto row) { return (row % 50) * 1'000'000; }),
+      makeFlatVector<int64_t>(
+          500, [](auto row) { return (row % 10) * 1'000'000'000'000; }),
+  });
+  raw_vector<uint64_t> wideIds;
+  idGenerator.run(wideInput, wideIds);
+  EXPECT_EQ(idGenerator.numPartitions(), 10 + 49);
+  for (auto i = 0; i < wideInput->size(); ++i) {
+    EXPECT_EQ(wideIds[i], wideIds[i % 50]) << "at " << i;
+  }
+
+  raw_vector<uint64_t> secondTimeIds;
+  idGenerator.run(narrowInput, secondTimeIds);
+  EXPECT_EQ(idGenerator.numPartitions(), 10 + 49);
+  for (auto i = 0; i < narrowInput->size(); ++i) {
+    EXPECT_EQ(narrowIds[i], secondTimeIds[i]) << "at " << i;
+  }
+  EXPECT_EQ(idGenerator.partitionName(narrowIds[999]), "c0=9/c1=1");
+}
+
 TEST_F(PartitionIdGeneratorTest, limitOfPartitionNumber) {
   auto maxPartitions = 100;
 
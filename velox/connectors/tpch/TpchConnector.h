@@ -106,6 +106,8 @@ class TpchDataSource : public DataSource {
 
   velox::tpch::Table tpchTable_;
   double scaleFactor_{1.0};
+  // The number of rows to divide between the splits. This is the number of
+  // orders for lineitem.
   size_t tpchTableRowCount_{0};
   RowTypePtr outputType_;
 
@@ -230,6 +230,29 @@ TEST_F(TpchConnectorTest, multipleSplits) {
   }
 }
 
+// Lineitem splits divide the orders. Ensures that each split of lineitem
+// generates a share of the rows.
+TEST_F(TpchConnectorTest, lineitemMultipleSplits) {
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      ROW({"l_orderkey"}, {BIGINT()}),
+                      std::make_shared<TpchTableHandle>(
+                          kTpchConnectorId, Table::TBL_LINEITEM, 0.01),
+                      {{"l_orderkey",
+                        std::make_shared<TpchColumnHandle>("l_orderkey")}})
+                  .planNode();
+  auto fullResult = getResults(plan, {makeTpchSplit()});
+
+  constexpr size_t kTotalParts = 4;
+  std::vector<exec::Split> splits;
+  for (size_t i = 0; i < kTotalParts; ++i) {
+    auto output = getResults(plan, {makeTpchSplit(kTotalParts, i)});
+    EXPECT_GT(output->size(), fullResult->size() / kTotalParts / 2);
+    splits.emplace_back(makeTpchSplit(kTotalParts, i));
+  }
+  test::assertEqualVectors(fullResult, getResults(plan, std::move(splits)));
+}
+
 // Join nation and region.
 TEST_F(TpchConnectorTest, join) {
   auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
@@ -60,6 +60,38 @@ SortOrder SortOrder::deserialize(const folly::dynamic& obj) {
   return SortOrder(obj["ascending"].asBool(), obj["nullsFirst"].asBool());
 }
 
+namespace {
+folly::dynamic serializeSortingOrders(
+    const std::vector<SortOrder>& sortingOrders) {
+  auto array = folly::dynamic::array();
+  for (const auto& order : sortingOrders) {
+    array.push_back(order.serialize());
+  }
+
+  return array;
+}
+
+std::vector<SortOrder> deserializeSortingOrders(const folly::dynamic& array) {
+  std::vector<SortOrder> sortingOrders;
+  for (const auto& order : array) {
+    sortingOrders.push_back(SortOrder::deserialize(order));
+  }
+  return sortingOrders;
+}
+
+void addSortingKeys(
+    std::stringstream& stream,
+    const std::vector<FieldAccessTypedExprPtr>& sortingKeys,
+    const std::vector<SortOrder>& sortingOrders) {
+  for (auto i = 0; i < sortingKeys.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << sortingKeys[i]->name() << " " << sortingOrders[i].toString();
+  }
+}
+} // namespace
+
 namespace {
 const std::vector<PlanNodePtr> kEmptySources;
 
@@ -102,6 +134,34 @@ AggregationNode::AggregationNode(
     const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
     bool ignoreNullKeys,
     PlanNodePtr source)
+    : AggregationNode(
+          id,
+          step,
+          groupingKeys,
+          preGroupedKeys,
+          aggregateNames,
+          aggregates,
+          aggregateMasks,
+          {},
+          {},
+          {},
+          ignoreNullKeys,
+          std::move(source)) {}
+
+AggregationNode::AggregationNode(
+    const PlanNodeId& id,
+    Step step,
+    const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+    const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+    const std::vector<std::string>& aggregateNames,
+    const std::vector<CallTypedExprPtr>& aggregates,
+    const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+    const std::vector<std::vector<FieldAccessTypedExprPtr>>&
+        aggregateSortingKeys,
+    const std::vector<std::vector<SortOrder>>& aggregateSortingOrders,
+    const std::vector<bool>& aggregateDistincts,
+    bool ignoreNullKeys,
+    PlanNodePtr source)
     : PlanNode(id),
       step_(step),
       groupingKeys_(groupingKeys),
@@ -109,6 +169,9 @@ AggregationNode::AggregationNode(
       aggregateNames_(aggregateNames),
       aggregates_(aggregates),
       aggregateMasks_(aggregateMasks),
+      aggregateSortingKeys_(aggregateSortingKeys),
+      aggregateSortingOrders_(aggregateSortingOrders),
+      aggregateDistincts_(aggregateDistincts),
       ignoreNullKeys_(ignoreNullKeys),
       sources_{source},
       outputType_(getAggregationOutputType(
@@ -136,6 +199,51 @@ AggregationNode::AggregationNode(
         "Pre-grouped key must be one of the grouping keys: {}.",
         key->name());
   }
+
+  VELOX_CHECK(
+      aggregateSortingKeys_.empty() ||
+          aggregateSortingKeys_.size() == aggregates_.size(),
+      "Sorting keys must be specified for all aggregates or for none");
+  VELOX_CHECK_EQ(
+      aggregateSortingKeys_.size(),
+      aggregateSortingOrders_.size(),
+      "Number of sorting key lists must be equal to number of sorting order lists");
+  for (auto i = 0; i < aggregateSortingKeys_.size(); ++i) {
+    VELOX_CHECK_EQ(
+        aggregateSortingKeys_[i].size(),
+        aggregateSortingOrders_[i].size(),
+        "Number of sorting keys must be equal to number of sorting orders");
+  }
+  VELOX_CHECK(
+      aggregateDistincts_.empty() ||
+          aggregateDistincts_.size() == aggregates_.size(),
+      "Distinct flags must be specified for all aggregates or for none");
+  // Deduplication compares only the arguments, so rows with equal arguments
+  // must sort next to each other. As in Presto, a distinct aggregate may
+  // then only be ordered by its arguments.
+  for (auto i = 0; i < aggregateDistincts_.size(); ++i) {
+    if (!aggregateDistincts_[i] || aggregateSortingKeys_.empty()) {
+      continue;
+    }
+    std::unordered_set<std::string> argNames;
+    for (const auto& arg : aggregates_[i]->inputs()) {
+      if (auto field =
+              std::dynamic_pointer_cast<const FieldAccessTypedExpr>(arg)) {
+        argNames.insert(field->name());
+      }
+    }
+    for (const auto& key : aggregateSortingKeys_[i]) {
+      VELOX_USER_CHECK(
+          argNames.count(key->name()),
+          "For aggregate function with DISTINCT, ORDER BY expressions must appear in arguments: {}",
+          key->name());
+    }
+  }
+  if (hasSortedOrDistinctInputs()) {
+    VELOX_USER_CHECK(
+        step_ == Step::kSingle,
+        "Aggregations over sorted or distinct inputs support only single aggregation");
+  }
 }
 
 namespace {
@@ -184,6 +292,15 @@ void AggregationNode::addDetails(std::stringstream& stream) const {
       stream << ", ";
     }
     stream << aggregateNames_[i] << " := " << aggregates_[i]->toString();
+    if (aggregateDistincts_.size() > i && aggregateDistincts_[i]) {
+      stream << " distinct";
+    }
+    if (aggregateSortingKeys_.size() > i &&
+        !aggregateSortingKeys_[i].empty()) {
+      stream << " order by: ";
+      addSortingKeys(
+          stream, aggregateSortingKeys_[i], aggregateSortingOrders_[i]);
+    }
     if (aggregateMasks_.size() > i && aggregateMasks_[i]) {
       stream << " mask: " << aggregateMasks_[i]->name();
     }
@@ -239,6 +356,23 @@ folly::dynamic AggregationNode::serialize() const {
     }
   }
 
+  if (!aggregateSortingKeys_.empty()) {
+    obj["sortingKeys"] = folly::dynamic::array;
+    obj["sortingOrders"] = folly::dynamic::array;
+    for (auto i = 0; i < aggregateSortingKeys_.size(); ++i) {
+      obj["sortingKeys"].push_back(
+          ISerializable::serialize(aggregateSortingKeys_[i]));
+      obj["sortingOrders"].push_back(
+          serializeSortingOrders(aggregateSortingOrders_[i]));
+    }
+  }
+  if (!aggregateDistincts_.empty()) {
+    obj["distincts"] = folly::dynamic::array;
+    for (bool distinct : aggregateDistincts_) {
+      obj["distincts"].push_back(distinct);
+    }
+  }
+
   obj["ignoreNullKeys"] = ignoreNullKeys_;
   return obj;
 }
@@ -280,6 +414,24 @@ PlanNodePtr AggregationNode::create(const folly::dynamic& obj, void* context) {
     }
   }
 
+  std::vector<std::vector<FieldAccessTypedExprPtr>> sortingKeys;
+  std::vector<std::vector<SortOrder>> sortingOrders;
+  if (obj.count("sortingKeys")) {
+    for (const auto& keys : obj["sortingKeys"]) {
+      sortingKeys.push_back(deserializeFields(keys, context));
+    }
+    for (const auto& orders : obj["sortingOrders"]) {
+      sortingOrders.push_back(deserializeSortingOrders(orders));
+    }
+  }
+
+  std::vector<bool> distincts;
+  if (obj.count("distincts")) {
+    for (const auto& distinct : obj["distincts"]) {
+      distincts.push_back(distinct.asBool());
+    }
+  }
+
   return std::make_shared<AggregationNode>(
       deserializePlanNodeId(obj),
       stepFromName(obj["step"].asString()),
@@ -288,6 +440,9 @@ PlanNodePtr AggregationNode::create(const folly::dynamic& obj, void* context) {
       aggregateNames,
       aggregates,
       masks,
+      sortingKeys,
+      sortingOrders,
+      distincts,
       obj["ignoreNullKeys"].asBool(),
       deserializeSingleSource(obj, context));
 }
@@ -581,6 +736,10 @@ void ArrowStreamNode::addDetails(std::stringstream& stream) const {
   // Nothing to add.
 }
 
+void ArrowStreamSinkNode::addDetails(std::stringstream& stream) const {
+  // Nothing to add.
+}
+
 const std::vector<PlanNodePtr>& ValueStreamNode::sources() const {
   return kEmptySources;
 }
@@ -850,11 +1009,17 @@ void HashJoinNode::addDetails(std::stringstream& stream) const {
   if (nullAware_) {
     stream << ", null aware";
   }
+  if (buildCacheKey_.has_value()) {
+    stream << ", build cache key: " << buildCacheKey_.value();
+  }
 }
 
 folly::dynamic HashJoinNode::serialize() const {
   auto obj = serializeBase();
   obj["nullAware"] = nullAware_;
+  if (buildCacheKey_.has_value()) {
+    obj["buildCacheKey"] = buildCacheKey_.value();
+  }
   return obj;
 }
 
@@ -874,6 +1039,11 @@ PlanNodePtr HashJoinNode::create(const folly::dynamic& obj, void* context) {
 
   auto outputType = deserializeRowType(obj["outputType"]);
 
+  std::optional<std::string> buildCacheKey;
+  if (obj.count("buildCacheKey")) {
+    buildCacheKey = obj["buildCacheKey"].asString();
+  }
+
   return std::make_shared<HashJoinNode>(
       deserializePlanNodeId(obj),
       joinTypeFromName(obj["joinType"].asString()),
@@ -883,7 +1053,8 @@ PlanNodePtr HashJoinNode::create(const folly::dynamic& obj, void* context) {
       filter,
       sources[0],
       sources[1],
-      outputType);
+      outputType,
+      std::move(buildCacheKey));
 }
 
 folly::dynamic MergeJoinNode::serialize() const {
@@ -934,7 +1105,10 @@ NestedLoopJoinNode::NestedLoopJoinNode(
       "{} unsupported, NestedLoopJoin only supports inner and outer join",
       joinTypeName(joinType_));
   if (joinCondition_ != nullptr) {
-    VELOX_NYI("NestedLoopJoin does not support join condition.");
+    VELOX_USER_CHECK(
+        joinCondition_->type()->kind() == TypeKind::BOOLEAN,
+        "NestedLoopJoin condition must be a boolean expression: {}",
+        joinCondition_->toString());
   }
 
   auto leftType = sources_[0]->outputType();
@@ -1099,12 +1273,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
+    bool inputsSorted,
     PlanNodePtr source)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -1216,26 +1392,6 @@ WindowNode::Function WindowNode::Function::deserialize(
       obj["ignoreNulls"].asBool()};
 }
 
-namespace {
-folly::dynamic serializeSortingOrders(
-    const std::vector<SortOrder>& sortingOrders) {
-  auto array = folly::dynamic::array();
-  for (const auto& order : sortingOrders) {
-    array.push_back(order.serialize());
-  }
-
-  return array;
-}
-
-std::vector<SortOrder> deserializeSortingOrders(const folly::dynamic& array) {
-  std::vector<SortOrder> sortingOrders;
-  for (const auto& order : array) {
-    sortingOrders.push_back(SortOrder::deserialize(order));
-  }
-  return sortingOrders;
-}
-} // namespace
-
 folly::dynamic WindowNode::serialize() const {
   auto obj = PlanNode::serialize();
   obj["partitionKeys"] = ISerializable::serialize(partitionKeys_);
@@ -1254,6 +1410,7 @@ folly::dynamic WindowNode::serialize() const {
     windowNames.push_back(outputType_->nameOf(i));
   }
   obj["names"] = ISerializable::serialize(windowNames);
+  obj["inputsSorted"] = inputsSorted_;
 
   return obj;
 }
@@ -1280,23 +1437,103 @@ PlanNodePtr WindowNode::create(const folly::dynamic& obj, void* context) {
       sortingOrders,
       windowNames,
       functions,
+      obj["inputsSorted"].asBool(),
       source);
 }
 
 namespace {
-void addSortingKeys(
-    std::stringstream& stream,
-    const std::vector<FieldAccessTypedExprPtr>& sortingKeys,
-    const std::vector<SortOrder>& sortingOrders) {
-  for (auto i = 0; i < sortingKeys.size(); ++i) {
-    if (i > 0) {
-      stream << ", ";
-    }
-    stream << sortingKeys[i]->name() << " " << sortingOrders[i].toString();
+RowTypePtr getTopNRowNumberOutputType(
+    const RowTypePtr& inputType,
+    const std::optional<std::string>& rowNumberColumnName) {
+  if (!rowNumberColumnName.has_value()) {
+    return inputType;
   }
+
+  auto names = inputType->names();
+  auto types = inputType->children();
+  names.push_back(rowNumberColumnName.value());
+  types.push_back(BIGINT());
+  return ROW(std::move(names), std::move(types));
 }
 } // namespace
 
+TopNRowNumberNode::TopNRowNumberNode(
+    PlanNodeId id,
+    std::vector<FieldAccessTypedExprPtr> partitionKeys,
+    std::vector<FieldAccessTypedExprPtr> sortingKeys,
+    std::vector<SortOrder> sortingOrders,
+    const std::optional<std::string>& rowNumberColumnName,
+    int32_t limit,
+    PlanNodePtr source)
+    : PlanNode(std::move(id)),
+      partitionKeys_(std::move(partitionKeys)),
+      sortingKeys_(std::move(sortingKeys)),
+      sortingOrders_(std::move(sortingOrders)),
+      limit_(limit),
+      sources_{std::move(source)},
+      outputType_(getTopNRowNumberOutputType(
+          sources_[0]->outputType(),
+          rowNumberColumnName)) {
+  VELOX_CHECK(
+      !sortingKeys_.empty(), "TopNRowNumber must specify sorting keys");
+  VELOX_CHECK_EQ(
+      sortingKeys_.size(),
+      sortingOrders_.size(),
+      "Number of sorting keys must be equal to the number of sorting orders");
+  VELOX_CHECK_GT(
+      limit_, 0, "TopNRowNumber must specify a limit greater than zero");
+}
+
+void TopNRowNumberNode::addDetails(std::stringstream& stream) const {
+  stream << "partition by [";
+  if (!partitionKeys_.empty()) {
+    addFields(stream, partitionKeys_);
+  }
+  stream << "] ";
+
+  stream << "order by [";
+  addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  stream << "] ";
+
+  stream << "limit " << limit_;
+}
+
+folly::dynamic TopNRowNumberNode::serialize() const {
+  auto obj = PlanNode::serialize();
+  obj["partitionKeys"] = ISerializable::serialize(partitionKeys_);
+  obj["sortingKeys"] = ISerializable::serialize(sortingKeys_);
+  obj["sortingOrders"] = serializeSortingOrders(sortingOrders_);
+  if (generateRowNumber()) {
+    obj["rowNumberColumnName"] = outputType_->names().back();
+  }
+  obj["limit"] = limit_;
+  return obj;
+}
+
+// static
+PlanNodePtr TopNRowNumberNode::create(
+    const folly::dynamic& obj,
+    void* context) {
+  auto source = deserializeSingleSource(obj, context);
+  auto partitionKeys = deserializeFields(obj["partitionKeys"], context);
+  auto sortingKeys = deserializeFields(obj["sortingKeys"], context);
+  auto sortingOrders = deserializeSortingOrders(obj["sortingOrders"]);
+
+  std::optional<std::string> rowNumberColumnName;
+  if (obj.count("rowNumberColumnName")) {
+    rowNumberColumnName = obj["rowNumberColumnName"].asString();
+  }
+
+  return std::make_shared<TopNRowNumberNode>(
+      deserializePlanNodeId(obj),
+      partitionKeys,
+      sortingKeys,
+      sortingOrders,
+      rowNumberColumnName,
+      obj["limit"].asInt(),
+      source);
+}
+
 void LocalMergeNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
@@ -1473,6 +1710,38 @@ PlanNodePtr PartitionedOutputNode::create(
       deserializeSingleSource(obj, context));
 }
 
+void ShuffleWriteNode::addDetails(std::stringstream& stream) const {
+  if (numPartitions_ == 1) {
+    stream << "SINGLE";
+  } else {
+    stream << "HASH(";
+    addKeys(stream, keys_);
+    stream << ") " << numPartitions_;
+  }
+  stream << " " << shuffleDirectory_;
+}
+
+folly::dynamic ShuffleWriteNode::serialize() const {
+  auto obj = PlanNode::serialize();
+  obj["numPartitions"] = numPartitions_;
+  obj["keys"] = ISerializable::serialize(keys_);
+  obj["partitionFunctionSpec"] = partitionFunctionSpec_->serialize();
+  obj["shuffleDirectory"] = shuffleDirectory_;
+  return obj;
+}
+
+// static
+PlanNodePtr ShuffleWriteNode::create(const folly::dynamic& obj, void* context) {
+  return std::make_shared<ShuffleWriteNode>(
+      deserializePlanNodeId(obj),
+      ISerializable::deserialize<std::vector<ITypedExpr>>(obj["keys"], context),
+      obj["numPartitions"].asInt(),
+      ISerializable::deserialize<PartitionFunctionSpec>(
+          obj["partitionFunctionSpec"], context),
+      obj["shuffleDirectory"].asString(),
+      deserializeSingleSource(obj, context));
+}
+
 void TopNNode::addDetails(std::stringstream& stream) const {
   if (isPartial_) {
     stream << "PARTIAL ";
@@ -1566,6 +1835,10 @@ PlanNodePtr OrderByNode::create(const folly::dynamic& obj, void* context) {
 }
 
 void WindowNode::addDetails(std::stringstream& stream) const {
+  if (inputsSorted_) {
+    stream << "STREAMING ";
+  }
+
   stream << "partition by [";
   if (!partitionKeys_.empty()) {
     addFields(stream, partitionKeys_);
@@ -1664,9 +1937,11 @@ void PlanNode::registerSerDe() {
   registry.Register("OrderByNode", OrderByNode::create);
   registry.Register("PartitionedOutputNode", PartitionedOutputNode::create);
   registry.Register("ProjectNode", ProjectNode::create);
+  registry.Register("ShuffleWriteNode", ShuffleWriteNode::create);
   registry.Register("TableScanNode", TableScanNode::create);
   registry.Register("TableWriteNode", TableWriteNode::create);
   registry.Register("TopNNode", TopNNode::create);
+  registry.Register("TopNRowNumberNode", TopNRowNumberNode::create);
   registry.Register("UnnestNode", UnnestNode::create);
   registry.Register("ValuesNode", ValuesNode::create);
   registry.Register("WindowNode", WindowNode::create);
@@ -263,6 +263,13 @@ class ValuesNode : public PlanNode {
 
 class ValueStreamNode : public PlanNode {
  public:
+  /// Creates the stream for one driver given the driver id and the memory
+  /// pool of the operator.
+  using StreamFactory = std::function<std::shared_ptr<RowVectorStream>(
+      int32_t driverId,
+      memory::MemoryPool* pool)>;
+
+  /// Reads 'valueStream' in a single driver.
   ValueStreamNode(
       const PlanNodeId& id,
       const RowTypePtr& outputType,
@@ -273,16 +280,41 @@ class ValueStreamNode : public PlanNode {
     VELOX_CHECK_NOT_NULL(valueStream_);
   }
 
+  /// Each driver reads its own stream made by 'streamFactory'. Used to
+  /// generate data on the fly in each driver, e.g. for benchmarks with more
+  /// data than fits in memory.
+  ValueStreamNode(
+      const PlanNodeId& id,
+      const RowTypePtr& outputType,
+      StreamFactory streamFactory)
+      : PlanNode(id),
+        outputType_(outputType),
+        streamFactory_(std::move(streamFactory)) {
+    VELOX_CHECK(streamFactory_ != nullptr);
+  }
+
   const RowTypePtr& outputType() const override {
     return outputType_;
   }
 
   const std::vector<PlanNodePtr>& sources() const override;
 
+  /// Returns the stream shared by all drivers, or nullptr if each driver
+  /// makes its own with streamFactory().
   const std::shared_ptr<RowVectorStream>& rowVectorStream() const {
     return valueStream_;
   }
 
+  const StreamFactory& streamFactory() const {
+    return streamFactory_;
+  }
+
+  /// Returns true if the node can run in multiple drivers, i.e. each driver
+  /// makes its own stream.
+  bool isParallelizable() const {
+    return streamFactory_ != nullptr;
+  }
+
   std::string_view name() const override {
     return "ValueStream";
   }
@@ -296,6 +328,7 @@ class ValueStreamNode : public PlanNode {
 
   const RowTypePtr outputType_;
   std::shared_ptr<RowVectorStream> valueStream_;
+  const StreamFactory streamFactory_;
 };
 
 class ArrowStreamNode : public PlanNode {
@@ -335,6 +368,53 @@ class ArrowStreamNode : public PlanNode {
   std::shared_ptr<ArrowArrayStream> arrowStream_;
 };
 
+/// Exports each batch of its input through the Arrow C data interface to an
+/// Arrow consumer. The batches are exported without copying the values, except
+/// for strings, and dictionary and constant encodings are preserved, see
+/// exportToArrow(). The consumer takes ownership of the schema and array and
+/// must release them. It is called by a single driver. Produces no output.
+class ArrowStreamSinkNode : public PlanNode {
+ public:
+  using ArrowConsumer = std::function<void(ArrowSchema&, ArrowArray&)>;
+
+  ArrowStreamSinkNode(
+      const PlanNodeId& id,
+      ArrowConsumer consumer,
+      PlanNodePtr source)
+      : PlanNode(id),
+        sources_{{std::move(source)}},
+        consumer_(std::move(consumer)) {
+    VELOX_CHECK_NOT_NULL(consumer_);
+  }
+
+  /// The exported columns, which are all the columns of the input.
+  const RowTypePtr& outputType() const override {
+    return sources_[0]->outputType();
+  }
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const ArrowConsumer& consumer() const {
+    return consumer_;
+  }
+
+  std::string_view name() const override {
+    return "ArrowStreamSink";
+  }
+
+  folly::dynamic serialize() const override {
+    VELOX_UNSUPPORTED("ArrowStreamSink plan node is not serializable");
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<PlanNodePtr> sources_;
+  const ArrowConsumer consumer_;
+};
+
 class FilterNode : public PlanNode {
  public:
   FilterNode(const PlanNodeId& id, TypedExprPtr filter, PlanNodePtr source)
@@ -604,6 +684,31 @@ class AggregationNode : public PlanNode {
       bool ignoreNullKeys,
       PlanNodePtr source);
 
+  /**
+   * @param aggregateSortingKeys Keys to sort the input of each group by
+   * before it is added to the aggregate, e.g. for array_agg(x ORDER BY y).
+   * Either empty or one list per aggregate. Empty lists mean no sorting.
+   * @param aggregateSortingOrders Sort orders of 'aggregateSortingKeys'.
+   * @param aggregateDistincts True for aggregates over distinct values of
+   * their arguments, e.g. count(DISTINCT x). Either empty or one flag per
+   * aggregate. A distinct aggregate may only be sorted by its arguments.
+   * Sorted and distinct inputs are supported only for single aggregation.
+   */
+  AggregationNode(
+      const PlanNodeId& id,
+      Step step,
+      const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+      const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+      const std::vector<std::string>& aggregateNames,
+      const std::vector<CallTypedExprPtr>& aggregates,
+      const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+      const std::vector<std::vector<FieldAccessTypedExprPtr>>&
+          aggregateSortingKeys,
+      const std::vector<std::vector<SortOrder>>& aggregateSortingOrders,
+      const std::vector<bool>& aggregateDistincts,
+      bool ignoreNullKeys,
+      PlanNodePtr source);
+
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
   }
@@ -636,6 +741,36 @@ class AggregationNode : public PlanNode {
     return aggregateMasks_;
   }
 
+  const std::vector<std::vector<FieldAccessTypedExprPtr>>&
+  aggregateSortingKeys() const {
+    return aggregateSortingKeys_;
+  }
+
+  const std::vector<std::vector<SortOrder>>& aggregateSortingOrders() const {
+    return aggregateSortingOrders_;
+  }
+
+  const std::vector<bool>& aggregateDistincts() const {
+    return aggregateDistincts_;
+  }
+
+  /// True if the input of the aggregate at 'index' must be sorted or
+  /// deduplicated for each group.
+  bool hasSortedOrDistinctInput(size_t index) const {
+    return (index < aggregateDistincts_.size() && aggregateDistincts_[index]) ||
+        (index < aggregateSortingKeys_.size() &&
+         !aggregateSortingKeys_[index].empty());
+  }
+
+  bool hasSortedOrDistinctInputs() const {
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      if (hasSortedOrDistinctInput(i)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   bool ignoreNullKeys() const {
     return ignoreNullKeys_;
   }
@@ -645,12 +780,14 @@ class AggregationNode : public PlanNode {
   }
 
   bool canSpill(const QueryConfig& queryConfig) const override {
-    // NOTE: as for now, we don't allow spilling for distinct aggregation
-    // (https://github.com/facebookincubator/velox/issues/3263) and pre-grouped
-    // aggregation (https://github.com/facebookincubator/velox/issues/3264). We
-    // will add support later to re-enable.
-    return (isFinal() || isSingle()) && !(aggregates().empty()) &&
-        preGroupedKeys().empty() && queryConfig.aggregationSpillEnabled();
+    // NOTE: as for now, we don't allow spilling for pre-grouped aggregation
+    // (https://github.com/facebookincubator/velox/issues/3264). We will add
+    // support later to re-enable. Aggregates over sorted or distinct inputs
+    // keep their input outside of the accumulators and cannot be spilled
+    // either.
+    return (isFinal() || isSingle()) && preGroupedKeys().empty() &&
+        !hasSortedOrDistinctInputs() &&
+        queryConfig.aggregationSpillEnabled();
   }
 
   bool isFinal() const {
@@ -676,6 +813,12 @@ class AggregationNode : public PlanNode {
   // Keeps mask/'no mask' for every aggregation. Mask, if given, is a reference
   // to a boolean projection column, used to mask out rows for the aggregation.
   const std::vector<FieldAccessTypedExprPtr> aggregateMasks_;
+  // Keeps sorting keys and orders for every aggregation, or is empty. Empty
+  // keys mean the input of the aggregation is not sorted.
+  const std::vector<std::vector<FieldAccessTypedExprPtr>> aggregateSortingKeys_;
+  const std::vector<std::vector<SortOrder>> aggregateSortingOrders_;
+  // Keeps the DISTINCT flag for every aggregation, or is empty.
+  const std::vector<bool> aggregateDistincts_;
   const bool ignoreNullKeys_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
@@ -809,7 +952,7 @@ class GroupIdNode : public PlanNode {
     return aggregationInputs_;
   }
 
-  const std::string& groupIdName() {
+  const std::string& groupIdName() const {
     return groupIdName_;
   }
 
@@ -1203,6 +1346,81 @@ class PartitionedOutputNode : public PlanNode {
   const RowTypePtr outputType_;
 };
 
+/// Persists the input partitioned by 'keys' into files so that the output of
+/// a task survives the task and can be read back by partition, e.g. when a
+/// consumer task is retried. The files of task 'taskId' are under
+/// '<shuffleDirectory>/<taskId>'. Each driver writes a data file in which the
+/// pages are grouped by partition and the last driver to finish writes an
+/// index of the ranges of each partition. The data is read back by exchange
+/// sources for remote task ids of the form
+/// 'shuffle://<shuffleDirectory>/<taskId>'.
+class ShuffleWriteNode : public PlanNode {
+ public:
+  ShuffleWriteNode(
+      const PlanNodeId& id,
+      const std::vector<TypedExprPtr>& keys,
+      int numPartitions,
+      PartitionFunctionSpecPtr partitionFunctionSpec,
+      std::string shuffleDirectory,
+      PlanNodePtr source)
+      : PlanNode(id),
+        sources_{{std::move(source)}},
+        keys_(keys),
+        numPartitions_(numPartitions),
+        partitionFunctionSpec_(std::move(partitionFunctionSpec)),
+        shuffleDirectory_(std::move(shuffleDirectory)) {
+    VELOX_CHECK(numPartitions > 0, "numPartitions must be greater than zero");
+    if (numPartitions == 1) {
+      VELOX_CHECK(
+          keys_.empty(),
+          "Non-empty partitioning keys require more than one partition");
+    }
+    VELOX_CHECK(!shuffleDirectory_.empty(), "Shuffle directory must be set");
+  }
+
+  /// The written columns, which are all the columns of the input.
+  const RowTypePtr& outputType() const override {
+    return sources_[0]->outputType();
+  }
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const std::vector<TypedExprPtr>& keys() const {
+    return keys_;
+  }
+
+  int numPartitions() const {
+    return numPartitions_;
+  }
+
+  const PartitionFunctionSpec& partitionFunctionSpec() const {
+    return *partitionFunctionSpec_;
+  }
+
+  const std::string& shuffleDirectory() const {
+    return shuffleDirectory_;
+  }
+
+  std::string_view name() const override {
+    return "ShuffleWrite";
+  }
+
+  folly::dynamic serialize() const override;
+
+  static PlanNodePtr create(const folly::dynamic& obj, void* context);
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<PlanNodePtr> sources_;
+  const std::vector<TypedExprPtr> keys_;
+  const int numPartitions_;
+  const PartitionFunctionSpecPtr partitionFunctionSpec_;
+  const std::string shuffleDirectory_;
+};
+
 enum class JoinType {
   // For each row on the left, find all matching rows on the right and return
   // all combinations.
@@ -1422,7 +1640,8 @@ class HashJoinNode : public AbstractJoinNode {
       TypedExprPtr filter,
       PlanNodePtr left,
       PlanNodePtr right,
-      const RowTypePtr outputType)
+      const RowTypePtr outputType,
+      std::optional<std::string> buildCacheKey = std::nullopt)
       : AbstractJoinNode(
             id,
             joinType,
@@ -1432,7 +1651,8 @@ class HashJoinNode : public AbstractJoinNode {
             left,
             right,
             outputType),
-        nullAware_{nullAware} {
+        nullAware_{nullAware},
+        buildCacheKey_{std::move(buildCacheKey)} {
     if (nullAware) {
       VELOX_USER_CHECK(
           isNullAwareSupported(joinType),
@@ -1465,6 +1685,14 @@ class HashJoinNode : public AbstractJoinNode {
     return nullAware_;
   }
 
+  /// If set, the hash table built from the right side is cached in the
+  /// process-wide HashBuildCache under this key, or taken from the cache
+  /// instead of built if it is there. The key must identify the build plan,
+  /// the splits it reads and the snapshot of the data they are read from.
+  const std::optional<std::string>& buildCacheKey() const {
+    return buildCacheKey_;
+  }
+
   folly::dynamic serialize() const override;
 
   static PlanNodePtr create(const folly::dynamic& obj, void* context);
@@ -1473,6 +1701,7 @@ class HashJoinNode : public AbstractJoinNode {
   void addDetails(std::stringstream& stream) const override;
 
   const bool nullAware_;
+  const std::optional<std::string> buildCacheKey_;
 };
 
 /// Represents inner/outer/semi/anti merge joins. Translates to an
@@ -1505,6 +1734,10 @@ class MergeJoinNode : public AbstractJoinNode {
     return "MergeJoin";
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.mergeJoinSpillEnabled();
+  }
+
   folly::dynamic serialize() const override;
 
   static PlanNodePtr create(const folly::dynamic& obj, void* context);
@@ -1516,7 +1749,8 @@ class MergeJoinNode : public AbstractJoinNode {
 /// side when generating exec::Operators.
 /// Nested loop join supports both equal and non-equal joins. Expressions
 /// specified in joinCondition are evaluated on every combination of left/right
-/// tuple, to emit result.
+/// tuple, to emit result. Left, right and full joins also emit the rows with no
+/// match with nulls for the other side's columns.
 /// This also replaces CrossJoinNode, as cross join is equivalent to inner join
 /// on TRUE. To create a plan node for cross join, use the constructor without
 /// `joinType` and `joinCondition` parameter.
@@ -1687,6 +1921,10 @@ class TopNNode : public PlanNode {
     return isPartial_;
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return !isPartial_ && queryConfig.topNSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "TopN";
   }
@@ -1971,6 +2209,10 @@ class WindowNode : public PlanNode {
   /// @param windowColumnNames specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @param inputsSorted Specifies that the input is already clustered on the
+  /// partition keys and sorted on the sorting keys within each partition, e.g.
+  /// by a LocalMerge or an ordered scan. The window functions are then
+  /// computed one partition at a time as the input arrives without sorting.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -1978,6 +2220,7 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
+      bool inputsSorted,
       PlanNodePtr source);
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -2006,6 +2249,18 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
+  /// Spilling is only supported with partition keys as the spilled rows are
+  /// restored one partition at a time. Sorted inputs are not spilled as only
+  /// one partition is buffered at a time.
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return !partitionKeys_.empty() && !inputsSorted_ &&
+        queryConfig.windowSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "Window";
   }
@@ -2024,6 +2279,86 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
+  const std::vector<PlanNodePtr> sources_;
+
+  const RowTypePtr outputType_;
+};
+
+/// Optimized version of a WindowNode for a single row_number function with a
+/// limit over sorted partitions, e.g. row_number() over (partition by k order
+/// by ts desc) <= 10. Keeps only the top 'limit' rows of each partition.
+/// Optionally adds a BIGINT column with the row numbers at the end of the
+/// input columns.
+class TopNRowNumberNode : public PlanNode {
+ public:
+  /// @param partitionKeys Partition by columns. Can be empty, then all rows
+  /// are in one partition.
+  /// @param sortingKeys Order by columns within a partition.
+  /// @param sortingOrders Sorting order of each sorting key.
+  /// @param rowNumberColumnName Name of the output row number column. No row
+  /// number column is produced if not set.
+  /// @param limit Number of rows to keep for each partition.
+  TopNRowNumberNode(
+      PlanNodeId id,
+      std::vector<FieldAccessTypedExprPtr> partitionKeys,
+      std::vector<FieldAccessTypedExprPtr> sortingKeys,
+      std::vector<SortOrder> sortingOrders,
+      const std::optional<std::string>& rowNumberColumnName,
+      int32_t limit,
+      PlanNodePtr source);
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& partitionKeys() const {
+    return partitionKeys_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& sortingKeys() const {
+    return sortingKeys_;
+  }
+
+  const std::vector<SortOrder>& sortingOrders() const {
+    return sortingOrders_;
+  }
+
+  int32_t limit() const {
+    return limit_;
+  }
+
+  bool generateRowNumber() const {
+    return outputType_->size() > sources_[0]->outputType()->size();
+  }
+
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.topNRowNumberSpillEnabled();
+  }
+
+  std::string_view name() const override {
+    return "TopNRowNumber";
+  }
+
+  folly::dynamic serialize() const override;
+
+  static PlanNodePtr create(const folly::dynamic& obj, void* context);
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<FieldAccessTypedExprPtr> partitionKeys_;
+
+  const std::vector<FieldAccessTypedExprPtr> sortingKeys_;
+  const std::vector<SortOrder> sortingOrders_;
+
+  const int32_t limit_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <limits>
+
 #include "velox/core/Context.h"
 
 namespace facebook::velox::core {
@@ -55,6 +57,19 @@ class QueryConfig {
   static constexpr const char* kExprEvalSimplified =
       "expression.eval_simplified";
 
+  // Number of rows FilterProject evaluates all projections for at a time
+  // when the projections are trees of simple fixed width functions. Keeps
+  // the intermediate results of a block in cache. 0 evaluates each
+  // projection for all rows at once.
+  static constexpr const char* kProjectionBlockSize =
+      "expression.projection_block_size";
+
+  // If non-zero, FilterProject and LocalPartition copy the surviving strings
+  // of a string column to a compact buffer when the referenced strings take
+  // less than this fraction of the string buffers the column keeps alive.
+  static constexpr const char* kStringCompactionMinUsedRatio =
+      "string_compaction_min_used_ratio";
+
   // Whether to track CPU usage for individual expressions (supported by call
   // and cast expressions). False by default. Can be expensive when processing
   // small batches, e.g. < 10K rows.
@@ -66,6 +81,29 @@ class QueryConfig {
   static constexpr const char* kOperatorTrackCpuUsage =
       "driver.track_operator_cpu_usage";
 
+  // The max time in milliseconds a Driver runs on an executor thread before it
+  // yields and goes to the end of the executor queue, so that long running
+  // Drivers don't starve the Drivers of other queries. 0 means no limit.
+  static constexpr const char* kDriverCpuTimeSliceLimitMs =
+      "driver.cpu_time_slice_limit_ms";
+
+  // The max time in microseconds a Driver waits on thread for the future of a
+  // blocked operator before it goes off thread. A Driver whose operator is
+  // blocked on a future that is already fulfilled always continues on thread.
+  static constexpr const char* kDriverMaxInlineWaitMicros =
+      "driver.max_inline_wait_micros";
+
+  // The number of the most recent operator calls and blocked intervals each
+  // Driver records in its timeline. The timelines are exported by
+  // Task::timelineToChromeTrace(). 0 means the timeline is disabled.
+  static constexpr const char* kDriverTimelineMaxEvents =
+      "driver.timeline_max_events";
+
+  // If true, table scans cache the results of the splits over immutable data
+  // in the process-wide exec::FragmentResultCache.
+  static constexpr const char* kFragmentResultCacheEnabled =
+      "fragment_result_cache_enabled";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -93,9 +131,51 @@ class QueryConfig {
   static constexpr const char* kMaxExtendedPartialAggregationMemory =
       "max_extended_partial_aggregation_memory";
 
+  /// Partial aggregation stops using its hash table and outputs the
+  /// intermediate results of each input row on its own once it has received
+  /// at least this many rows and the number of groups is at least
+  /// 'kAbandonPartialAggregationMinPct' percent of the number of rows.
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
+  /// If non-zero, a hash aggregation compacts the memory of its variable width
+  /// keys and accumulators once at least this fraction of it is in free
+  /// blocks. The compaction moves the live data out of the slabs which have at
+  /// least this fraction free and releases the slabs which become empty.
+  static constexpr const char* kAggregationCompactionFreeRatio =
+      "aggregation_compaction_free_ratio";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
+  /// The compression codec used for the pages sent by PartitionedOutput and
+  /// received by Exchange. The supported codecs are "none", "zlib", "snappy",
+  /// "zstd" and "lz4". "none" by default. Producer and consumer tasks of a
+  /// query must use the same codec.
+  static constexpr const char* kExchangeCompressionKind =
+      "exchange_compression_codec";
+
+  /// If true, PartitionedOutput keeps the constant and dictionary encodings of
+  /// the columns of a page made of a single input vector. The pages are then
+  /// received as constant and dictionary vectors.
+  static constexpr const char* kExchangePreserveEncodings =
+      "exchange_preserve_encodings";
+
+  /// If true, Exchange makes the flat vectors of fixed width columns without
+  /// nulls directly over the memory of the received pages instead of copying
+  /// the values. A page then stays in memory as long as any vector made from
+  /// it.
+  static constexpr const char* kExchangeZeroCopyDeserialize =
+      "exchange_zero_copy_deserialize";
+
+  /// Maximum number of concurrent requests of an Exchange to its producer
+  /// tasks. The queue byte budget is divided between the requests.
+  static constexpr const char* kExchangeMaxRequestsInFlight =
+      "exchange_max_requests_in_flight";
+
   /// Preferred size of batches in bytes to be returned by operators from
   /// Operator::getOutput. It is used when an estimate of average row size is
   /// known. Otherwise kPreferredOutputBatchRows is used.
@@ -124,6 +204,89 @@ class QueryConfig {
   static constexpr const char* kAdaptiveFilterReorderingEnabled =
       "driver.adaptive_filter_reordering_enabled";
 
+  /// The number of hash bits used to radix partition a large hash join table
+  /// into independent cache sized sub-tables. The hash probe processes probe
+  /// rows partition by partition to improve the cache locality of the table
+  /// lookups. Zero disables the radix partitioned join table.
+  static constexpr const char* kHashJoinRadixPartitionBits =
+      "hash_join_radix_partition_bits";
+
+  /// If true, a local hash partition that feeds the probe side of a hash join
+  /// sends the rows of the keys that are too frequent for a single partition
+  /// to all the partitions round-robin. This is safe for the join since all
+  /// the hash probe drivers share the hash table, but the operators after the
+  /// join must not rely on the rows being partitioned on the join keys.
+  static constexpr const char* kHashJoinSkewedKeyRoutingEnabled =
+      "hash_join_skewed_key_routing_enabled";
+
+  /// If true, a local round-robin partition that feeds a table writer starts
+  /// sending its input to a single writer driver and adds writer drivers only
+  /// while the writers cannot keep up with the input. This writes few large
+  /// files for small inputs and scales out the writing of large inputs.
+  static constexpr const char* kScaledWriterEnabled = "scaled_writer_enabled";
+
+  /// The bytes each of the active writers must have received before a scaled
+  /// writer partition adds or removes a writer. This is about the smallest
+  /// file a scaled writer writes.
+  static constexpr const char* kScaledWriterMinDataProcessedBytes =
+      "scaled_writer_min_data_processed_bytes";
+
+  /// If true, a hash aggregation table that grows moves its entries to the
+  /// larger table a few at a time during the following inserts instead of all
+  /// at once. This avoids the pause of rehashing a large table at the cost of
+  /// keeping both tables until all the entries are moved.
+  static constexpr const char* kHashAggregationIncrementalRehashEnabled =
+      "hash_aggregation_incremental_rehash_enabled";
+
+  /// The max size in bytes of a Bloom filter built over the join keys of a
+  /// hash join build side to push down into the probe side table scan. The
+  /// Bloom filter is only built for the integral join keys which can't be
+  /// pushed down as an exact IN-list filter. Zero disables the Bloom filter
+  /// pushdown.
+  static constexpr const char* kHashProbeBloomFilterPushdownMaxSize =
+      "hash_probe_bloom_filter_pushdown_max_size";
+
+  /// If true, the build side columns of the hash join output are lazy and
+  /// are only extracted from the hash table for the rows and columns that
+  /// the downstream operators access, e.g. after a filter.
+  static constexpr const char* kHashProbeLazyBuildOutput =
+      "hash_probe_lazy_build_output";
+
+  /// The max number of threads of the query executor used by an OrderBy to
+  /// sort its rows in memory. Zero derives it from the number of cores and
+  /// the number of drivers running the OrderBy.
+  static constexpr const char* kOrderBySortParallelism =
+      "order_by_sort_parallelism";
+
+  /// If true, OrderBy and Window store their rows in column-major blocks,
+  /// which makes extracting the output columns faster. See
+  /// RowContainer::isColumnar().
+  static constexpr const char* kColumnarRowContainerEnabled =
+      "columnar_row_container_enabled";
+
+  /// The max total size in bytes of the splits of a table scan which are
+  /// preloaded in the background and not yet read. Limits the memory used by
+  /// the preloads of large splits, while small splits can have more preloads
+  /// in flight, up to the count limit given by split_preload_per_driver. Only
+  /// applies to the splits of a known size. Zero means no limit.
+  static constexpr const char* kMaxSplitPreloadBytes =
+      "max_split_preload_bytes";
+
+  /// The max size in bytes of the byte ranges, or morsels, that a Task divides
+  /// the table scan splits into when they are added. The morsels of a split
+  /// are queued like separate splits, so that idle TableScan drivers pick up
+  /// the rest of a large split instead of one driver reading all of it. Only
+  /// applies to the splits of a known size. Zero means no limit.
+  static constexpr const char* kMaxSplitMorselBytes = "max_split_morsel_bytes";
+
+  /// The max number of Drivers that a table scan pipeline can grow to while
+  /// the Task runs. A Task adds a Driver to such a pipeline when its queued
+  /// splits outnumber its Drivers and retires the added Drivers when they find
+  /// no split to read. Only applies to the pipelines for which
+  /// DriverFactory::supportsAddingDrivers() is true. Zero means the pipelines
+  /// keep the number of Drivers they start with.
+  static constexpr const char* kAdaptiveMaxDrivers = "adaptive_max_drivers";
+
   static constexpr const char* kCreateEmptyFiles = "driver.create_empty_files";
 
   /// Global enable spilling flag.
@@ -142,6 +305,26 @@ class QueryConfig {
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// Window spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
+
+  /// Final TopN spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNSpillEnabled = "topn_spill_enabled";
+
+  /// TopNRowNumber spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNRowNumberSpillEnabled =
+      "topn_row_number_spill_enabled";
+
+  /// Merge join spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kMergeJoinSpillEnabled =
+      "merge_join_spill_enabled";
+
+  /// PartitionedOutput spilling flag, only applies if "spill_enabled" flag is
+  /// set. If true, the pages that do not fit in the output buffer are written
+  /// to disk instead of blocking the producers.
+  static constexpr const char* kPartitionedOutputSpillEnabled =
+      "partitioned_output_spill_enabled";
+
   /// The max memory that a final aggregation can use before spilling. If it 0,
   /// then there is no limit.
   static constexpr const char* kAggregationSpillMemoryThreshold =
@@ -157,6 +340,26 @@ class QueryConfig {
   static constexpr const char* kOrderBySpillMemoryThreshold =
       "order_by_spill_memory_threshold";
 
+  /// The max memory that a window can use before spilling. If it 0, then there
+  /// is no limit.
+  static constexpr const char* kWindowSpillMemoryThreshold =
+      "window_spill_memory_threshold";
+
+  /// The max memory that a final TopN can use before spilling. If it 0, then
+  /// there is no limit.
+  static constexpr const char* kTopNSpillMemoryThreshold =
+      "topn_spill_memory_threshold";
+
+  /// The max memory that a TopNRowNumber can use before spilling. If it 0,
+  /// then there is no limit.
+  static constexpr const char* kTopNRowNumberSpillMemoryThreshold =
+      "topn_row_number_spill_memory_threshold";
+
+  /// The max memory that the rows with the same join keys on one side of a
+  /// merge join can use before spilling. If it 0, then there is no limit.
+  static constexpr const char* kMergeJoinSpillMemoryThreshold =
+      "merge_join_spill_memory_threshold";
+
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
   /// The max allowed spilling level with zero being the initial spilling level.
@@ -188,6 +391,40 @@ class QueryConfig {
   static constexpr const char* kSpillableReservationGrowthPct =
       "spillable-reservation-growth-pct";
 
+  /// The compression codec used to compress the spill files. The supported
+  /// codecs are "none", "zlib", "snappy", "zstd" and "lz4". "none" by default.
+  static constexpr const char* kSpillCompressionKind =
+      "spill_compression_codec";
+
+  /// The max number of spill partitions written in parallel on the spill
+  /// executor by a single spilling operator. If it is zero, then all the
+  /// partitions being spilled are written in parallel.
+  static constexpr const char* kMaxSpillWriteParallelism =
+      "max-spill-write-parallelism";
+
+  /// If true, the spill files are written and read with O_DIRECT where the
+  /// file system supports it, so that spilling does not evict the page cache.
+  static constexpr const char* kSpillDirectIo = "spill-direct-io";
+
+  /// The max bytes of the spill files of a task in its spill directory if the
+  /// task has a spill overflow directory. The spill files past this go to the
+  /// overflow directory. If it is zero, there is no limit and the overflow
+  /// directory is not used.
+  static constexpr const char* kSpillLocalQuotaBytes =
+      "spill-local-quota-bytes";
+
+  /// If non-zero, the allocations from the memory pools of a task are
+  /// sampled about once per this many bytes with their pool and call stack,
+  /// see Task::allocationProfile().
+  static constexpr const char* kMemoryProfileSampleBytes =
+      "memory_profile_sample_bytes";
+
+  /// The priority of the query in [-128, 127]. The memory arbitrator reclaims
+  /// the used memory, e.g. by spilling, of the lower priority queries first,
+  /// and the drivers of the higher priority queries are run first if the
+  /// executor of the query supports priorities.
+  static constexpr const char* kQueryPriority = "query_priority";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
@@ -198,6 +435,18 @@ class QueryConfig {
     return get<uint64_t>(kMaxExtendedPartialAggregationMemory, kDefault);
   }
 
+  int32_t abandonPartialAggregationMinRows() const {
+    return get<int32_t>(kAbandonPartialAggregationMinRows, 100'000);
+  }
+
+  int32_t abandonPartialAggregationMinPct() const {
+    return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
+  }
+
+  double aggregationCompactionFreeRatio() const {
+    return get<double>(kAggregationCompactionFreeRatio, 0);
+  }
+
   uint64_t aggregationSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kAggregationSpillMemoryThreshold, kDefault);
@@ -213,6 +462,26 @@ class QueryConfig {
     return get<uint64_t>(kOrderBySpillMemoryThreshold, kDefault);
   }
 
+  uint64_t windowSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kWindowSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t topNSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kTopNSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t topNRowNumberSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kTopNRowNumberSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t mergeJoinSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kMergeJoinSpillMemoryThreshold, kDefault);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -222,6 +491,22 @@ class QueryConfig {
     return get<uint64_t>(kMaxPartitionedOutputBufferSize, kDefault);
   }
 
+  std::string exchangeCompressionKind() const {
+    return get<std::string>(kExchangeCompressionKind, "none");
+  }
+
+  bool exchangePreserveEncodings() const {
+    return get<bool>(kExchangePreserveEncodings, false);
+  }
+
+  bool exchangeZeroCopyDeserialize() const {
+    return get<bool>(kExchangeZeroCopyDeserialize, false);
+  }
+
+  int32_t exchangeMaxRequestsInFlight() const {
+    return get<int32_t>(kExchangeMaxRequestsInFlight, 64);
+  }
+
   uint64_t maxLocalExchangeBufferSize() const {
     static constexpr uint64_t kDefault = 32UL << 20;
     return get<uint64_t>(kMaxLocalExchangeBufferSize, kDefault);
@@ -248,6 +533,52 @@ class QueryConfig {
     return get<bool>(kHashAdaptivityEnabled, true);
   }
 
+  uint8_t hashJoinRadixPartitionBits() const {
+    constexpr uint8_t kMaxBits = 10;
+    const auto numBits = get<int32_t>(kHashJoinRadixPartitionBits, 0);
+    VELOX_USER_CHECK_GE(numBits, 0);
+    VELOX_USER_CHECK_LE(numBits, kMaxBits);
+    return numBits;
+  }
+
+  bool hashJoinSkewedKeyRoutingEnabled() const {
+    return get<bool>(kHashJoinSkewedKeyRoutingEnabled, false);
+  }
+
+  bool scaledWriterEnabled() const {
+    return get<bool>(kScaledWriterEnabled, false);
+  }
+
+  uint64_t scaledWriterMinDataProcessedBytes() const {
+    static constexpr uint64_t kDefault = 128UL << 20;
+    return get<uint64_t>(kScaledWriterMinDataProcessedBytes, kDefault);
+  }
+
+  bool hashAggregationIncrementalRehashEnabled() const {
+    return get<bool>(kHashAggregationIncrementalRehashEnabled, false);
+  }
+
+  uint64_t hashProbeBloomFilterPushdownMaxSize() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kHashProbeBloomFilterPushdownMaxSize, kDefault);
+  }
+
+  bool hashProbeLazyBuildOutput() const {
+    return get<bool>(kHashProbeLazyBuildOutput, false);
+  }
+
+  uint64_t maxSplitPreloadBytes() const {
+    return get<uint64_t>(kMaxSplitPreloadBytes, 0);
+  }
+
+  uint64_t maxSplitMorselBytes() const {
+    return get<uint64_t>(kMaxSplitMorselBytes, 0);
+  }
+
+  uint32_t adaptiveMaxDrivers() const {
+    return get<uint32_t>(kAdaptiveMaxDrivers, 0);
+  }
+
   uint32_t writeStrideSize() const {
     static constexpr uint32_t kDefault = 100'000;
     return kDefault;
@@ -336,6 +667,36 @@ class QueryConfig {
     return get<bool>(kOrderBySpillEnabled, true);
   }
 
+  /// Returns 'is window spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool windowSpillEnabled() const {
+    return get<bool>(kWindowSpillEnabled, true);
+  }
+
+  /// Returns 'is final topN spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool topNSpillEnabled() const {
+    return get<bool>(kTopNSpillEnabled, true);
+  }
+
+  /// Returns 'is TopNRowNumber spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool topNRowNumberSpillEnabled() const {
+    return get<bool>(kTopNRowNumberSpillEnabled, true);
+  }
+
+  /// Returns 'is merge join spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool mergeJoinSpillEnabled() const {
+    return get<bool>(kMergeJoinSpillEnabled, true);
+  }
+
+  /// Returns 'is partitioned output spilling enabled' flag. Must also check
+  /// the spillEnabled()!
+  bool partitionedOutputSpillEnabled() const {
+    return get<bool>(kPartitionedOutputSpillEnabled, false);
+  }
+
   // Returns a percentage of aggregation or join input batches that
   // will be forced to spill for testing. 0 means no extra spilling.
   int32_t testingSpillPct() const {
@@ -382,6 +743,55 @@ class QueryConfig {
     return get<double>(kSpillableReservationGrowthPct, kDefaultPct);
   }
 
+  std::string spillCompressionKind() const {
+    return get<std::string>(kSpillCompressionKind, "none");
+  }
+
+  int32_t maxSpillWriteParallelism() const {
+    return get<int32_t>(kMaxSpillWriteParallelism, 0);
+  }
+
+  bool spillDirectIo() const {
+    return get<bool>(kSpillDirectIo, false);
+  }
+
+  uint64_t spillLocalQuotaBytes() const {
+    return get<uint64_t>(kSpillLocalQuotaBytes, 0);
+  }
+
+  uint64_t memoryProfileSampleBytes() const {
+    return get<uint64_t>(kMemoryProfileSampleBytes, 0);
+  }
+
+  int32_t queryPriority() const {
+    const auto priority = get<int32_t>(kQueryPriority, 0);
+    VELOX_USER_CHECK(
+        priority >= std::numeric_limits<int8_t>::min() &&
+            priority <= std::numeric_limits<int8_t>::max(),
+        "{} must be in [-128, 127]: {}",
+        kQueryPriority,
+        priority);
+    return priority;
+  }
+
+  int32_t orderBySortParallelism() const {
+    const auto parallelism = get<int32_t>(kOrderBySortParallelism, 0);
+    VELOX_USER_CHECK_GE(parallelism, 0);
+    return parallelism;
+  }
+
+  bool columnarRowContainerEnabled() const {
+    return get<bool>(kColumnarRowContainerEnabled, false);
+  }
+
+  int32_t projectionBlockSize() const {
+    return get<int32_t>(kProjectionBlockSize, 0);
+  }
+
+  double stringCompactionMinUsedRatio() const {
+    return get<double>(kStringCompactionMinUsedRatio, 0);
+  }
+
   bool exprTrackCpuUsage() const {
     return get<bool>(kExprTrackCpuUsage, false);
   }
@@ -390,6 +800,22 @@ class QueryConfig {
     return get<bool>(kOperatorTrackCpuUsage, true);
   }
 
+  uint32_t driverCpuTimeSliceLimitMs() const {
+    return get<uint32_t>(kDriverCpuTimeSliceLimitMs, 0);
+  }
+
+  uint32_t driverMaxInlineWaitMicros() const {
+    return get<uint32_t>(kDriverMaxInlineWaitMicros, 0);
+  }
+
+  uint32_t driverTimelineMaxEvents() const {
+    return get<uint32_t>(kDriverTimelineMaxEvents, 0);
+  }
+
+  bool fragmentResultCacheEnabled() const {
+    return get<bool>(kFragmentResultCacheEnabled, false);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return configManager_->get<T>(key, defaultValue);
@@ -17,6 +17,8 @@
 
 #include <folly/Executor.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
+#include <mutex>
+#include <typeindex>
 #include "velox/common/memory/Memory.h"
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/core/Context.h"
@@ -147,6 +149,19 @@ class QueryCtx : public Context {
     pool_ = std::move(pool);
   }
 
+  /// Returns the instance of 'T' shared by the tasks and drivers of the
+  /// query, making it on first use. Lets the layers above core keep state per
+  /// query, e.g. the function resolutions of the expression compiler.
+  template <typename T>
+  std::shared_ptr<T> sharedState() {
+    std::lock_guard<std::mutex> l(sharedStateMutex_);
+    auto& state = sharedState_[std::type_index(typeid(T))];
+    if (state == nullptr) {
+      state = std::make_shared<T>();
+    }
+    return std::static_pointer_cast<T>(state);
+  }
+
  private:
   static Config* FOLLY_NONNULL getEmptyConfig() {
     static const std::unique_ptr<Config> kEmptyConfig =
@@ -159,6 +174,9 @@ class QueryCtx : public Context {
       pool_ = memory::defaultMemoryManager().addRootPool(
           QueryCtx::generatePoolName(queryId));
     }
+    if (pool_->parent() == nullptr) {
+      pool_->setPriority(queryConfig_.queryPriority());
+    }
   }
 
   std::unordered_map<std::string, std::shared_ptr<Config>> connectorConfigs_;
@@ -169,6 +187,8 @@ class QueryCtx : public Context {
   QueryConfig queryConfig_;
   const std::string queryId_;
   std::shared_ptr<folly::Executor> spillExecutor_;
+  std::mutex sharedStateMutex_;
+  std::unordered_map<std::type_index, std::shared_ptr<void>> sharedState_;
 };
 
 // Represents the state of one thread of query execution.
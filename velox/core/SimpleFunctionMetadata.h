@@ -19,6 +19,7 @@
 #include <folly/Likely.h>
 
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/Status.h"
 #include "velox/core/CoreTypeSystem.h"
 #include "velox/core/Metaprogramming.h"
 #include "velox/core/QueryConfig.h"
@@ -475,6 +476,9 @@ class UDFHolder final
     : public core::SimpleFunctionMetadata<Fun, TReturn, TArgs...> {
   Fun instance_;
 
+  // The error reported by the last call() that returned a non-OK Status.
+  Status error_;
+
  public:
   using udf_struct_t = Fun;
   using Metadata = core::SimpleFunctionMetadata<Fun, TReturn, TArgs...>;
@@ -505,21 +509,26 @@ class UDFHolder final
   DECLARE_METHOD_RESOLVER(callNullable_method_resolver, callNullable);
   DECLARE_METHOD_RESOLVER(callNullFree_method_resolver, callNullFree);
   DECLARE_METHOD_RESOLVER(callAscii_method_resolver, callAscii);
+  DECLARE_METHOD_RESOLVER(callBatch_method_resolver, callBatch);
   DECLARE_METHOD_RESOLVER(initialize_method_resolver, initialize);
 
   // Check which flavor of the call() method is provided by the UDF object. UDFs
   // are required to provide at least one of the following methods:
   //
-  // - bool|void call(...)
+  // - bool|void|Status call(...)
   // - bool|void callNullable(...)
   // - bool|void callNullFree(...)
   //
   // Each of these methods can return either bool or void. Returning void means
-  // that the UDF is assumed never to return null values.
+  // that the UDF is assumed never to return null values. call() can also
+  // return a Status to report a per-row error without throwing. A non-OK
+  // Status is recorded as the error of the row, as if call() had thrown a
+  // VeloxUserError.
   //
   // Optionally, UDFs can also provide the following methods:
   //
   // - bool|void callAscii(...)
+  // - void callBatch(...)
   // - void initialize(...)
 
   // call():
@@ -535,11 +544,19 @@ class UDFHolder final
       void,
       exec_return_type,
       const exec_arg_type<TArgs>&...>::value;
-  static constexpr bool udf_has_call =
-      udf_has_call_return_bool | udf_has_call_return_void;
+  static constexpr bool udf_has_call_return_status = util::has_method<
+      Fun,
+      call_method_resolver,
+      Status,
+      exec_return_type,
+      const exec_arg_type<TArgs>&...>::value;
+  static constexpr bool udf_has_call = udf_has_call_return_bool |
+      udf_has_call_return_void | udf_has_call_return_status;
   static_assert(
-      !(udf_has_call_return_bool && udf_has_call_return_void),
-      "Provided call() methods need to return either void OR bool.");
+      udf_has_call_return_bool + udf_has_call_return_void +
+              udf_has_call_return_status <=
+          1,
+      "Provided call() methods need to return either void, bool OR Status.");
 
   // callNullable():
   static constexpr bool udf_has_callNullable_return_bool = util::has_method<
@@ -604,6 +621,18 @@ class UDFHolder final
         (udf_has_callAscii_return_void && udf_has_call_return_bool)),
       "The return type for callAscii() must match the return type for call().");
 
+  // callBatch(): a vectorized variant of call() that is given pointers to
+  // 'size' contiguous values of each argument and of the result. It is only
+  // used for fixed width primitive types, for functions with default null
+  // behavior that never return null.
+  static constexpr bool udf_has_callBatch_return_void = util::has_method<
+      Fun,
+      callBatch_method_resolver,
+      void,
+      exec_return_type*,
+      const exec_arg_type<TArgs>*...,
+      int32_t>::value;
+
   // initialize():
   static constexpr bool udf_has_initialize = util::has_method<
       Fun,
@@ -633,8 +662,10 @@ class UDFHolder final
 
   // If any of the the provided "call" flavors can produce null (in case any of
   // them return bool). This is only false if all the call methods provided for
-  // a function return void.
+  // a function return void. A call() returning Status produces a null for the
+  // rows it reports an error for.
   static constexpr bool can_produce_null_output = udf_has_call_return_bool |
+      udf_has_call_return_status |
       udf_has_callNullable_return_bool | udf_has_callNullFree_return_bool |
       udf_has_callAscii_return_bool;
 
@@ -645,6 +676,8 @@ class UDFHolder final
   static constexpr bool is_default_contains_nulls_behavior =
       !udf_has_call && !udf_has_callNullable;
   static constexpr bool has_ascii = udf_has_callAscii;
+  static constexpr bool udf_has_callBatch = udf_has_callBatch_return_void &&
+      is_default_null_behavior && !can_produce_null_output;
   static constexpr bool is_default_ascii_behavior =
       udf_is_default_ascii_behavior<Fun>();
 
@@ -730,6 +763,28 @@ class UDFHolder final
     }
   }
 
+  FOLLY_ALWAYS_INLINE void callBatch(
+      exec_return_type* out,
+      const typename exec_resolver<TArgs>::in_type*... args,
+      int32_t size) {
+    if constexpr (udf_has_callBatch) {
+      instance_.callBatch(out, args..., size);
+    } else {
+      VELOX_UNREACHABLE(
+          "callBatch should never be called if the UDF does not implement callBatch.");
+    }
+  }
+
+  // True if the last call() returned a non-OK Status that has not been taken
+  // with takeError(). Only a call() that returns Status reports errors.
+  FOLLY_ALWAYS_INLINE bool hasError() const {
+    return !error_.ok();
+  }
+
+  FOLLY_ALWAYS_INLINE Status takeError() {
+    return std::move(error_);
+  }
+
   // Helper functions to handle void vs bool return type.
 
   FOLLY_ALWAYS_INLINE bool callImpl(
@@ -738,6 +793,13 @@ class UDFHolder final
     static_assert(udf_has_call);
     if constexpr (udf_has_call_return_bool) {
       return instance_.call(out, args...);
+    } else if constexpr (udf_has_call_return_status) {
+      auto status = instance_.call(out, args...);
+      if (UNLIKELY(!status.ok())) {
+        error_ = std::move(status);
+        return false;
+      }
+      return true;
     } else {
       instance_.call(out, args...);
       return true;
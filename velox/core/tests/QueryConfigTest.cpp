@@ -47,3 +47,21 @@ TEST(TestQueryConfig, setConfig) {
   ASSERT_EQ(config.codegenConfigurationFilePath(), path);
   ASSERT_FALSE(config.isCastIntByTruncate());
 }
+
+TEST(TestQueryConfig, queryPriority) {
+  auto queryCtx = std::make_shared<QueryCtx>(
+      nullptr,
+      std::make_shared<MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {QueryConfig::kQueryPriority, "-3"}}));
+  ASSERT_EQ(queryCtx->queryConfig().queryPriority(), -3);
+  // The memory arbitrator reads the priority from the query memory pool.
+  ASSERT_EQ(queryCtx->pool()->priority(), -3);
+
+  ASSERT_EQ(std::make_shared<QueryCtx>()->pool()->priority(), 0);
+  ASSERT_ANY_THROW(std::make_shared<QueryCtx>(
+      nullptr,
+      std::make_shared<MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {QueryConfig::kQueryPriority, "128"}})));
+}
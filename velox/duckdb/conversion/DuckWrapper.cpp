@@ -142,14 +142,17 @@ inline bool isZeroCopyEligible(const ::duckdb::LogicalType& duckType) {
 
   if (duckType.id() == LogicalTypeId::HUGEINT ||
       duckType.id() == LogicalTypeId::TIMESTAMP ||
-      duckType.id() == LogicalTypeId::BOOLEAN ||
-      duckType.id() == LogicalTypeId::BLOB ||
-      duckType.id() == LogicalTypeId::VARCHAR) {
+      duckType.id() == LogicalTypeId::BOOLEAN) {
     return false;
   }
   return true;
 }
 
+// A DuckDB string_t has the layout of a StringView. The strings that are not
+// inlined are kept alive by the auxiliary buffer of the DuckDB vector, which
+// references the buffers the strings were added to.
+static_assert(sizeof(::duckdb::string_t) == sizeof(StringView));
+
 template <class OP>
 VectorPtr convert(
     ::duckdb::Vector& duckVector,
@@ -166,8 +169,9 @@ VectorPtr convert(
           ::duckdb::FlatVector::GetData<typename OP::DUCK_TYPE>(duckVector);
 
       // Some DuckDB vectors have different internal layout and cannot be
-      // trivially copied.
-      if (!isZeroCopyEligible(duckVector.GetType())) {
+      // trivially copied. The vectors with 'validity' are dictionaries whose
+      // unused entries may be uninitialized.
+      if (validity || !isZeroCopyEligible(duckVector.GetType())) {
         // TODO Figure out how to perform a zero-copy conversion.
         result = BaseVector::create(veloxType, size, pool);
         auto flatResult = result->as<FlatVector<typename OP::VELOX_TYPE>>();
@@ -197,13 +201,33 @@ VectorPtr convert(
               DuckDBValidityReleaser(duckValidity));
         }
 
+        std::vector<BufferPtr> stringBuffers;
+        if constexpr (std::is_same_v<
+                          typename OP::DUCK_TYPE,
+                          ::duckdb::string_t>) {
+          // Null rows may hold any bytes, which Velox would take for strings.
+          if (!duckValidity.AllValid()) {
+            for (auto i = 0; i < size; i++) {
+              if (!duckValidity.RowIsValid(i)) {
+                duckData[i] = ::duckdb::string_t(nullptr, 0);
+              }
+            }
+          }
+          if (auto auxiliary = duckVector.GetAuxiliary()) {
+            stringBuffers.push_back(BufferView<DuckDBBufferReleaser>::create(
+                reinterpret_cast<const uint8_t*>(duckData),
+                0,
+                DuckDBBufferReleaser(std::move(auxiliary))));
+          }
+        }
+
         result = std::make_shared<FlatVector<typename OP::VELOX_TYPE>>(
             pool,
             veloxType,
             nullsView,
             size,
             valuesView,
-            std::vector<BufferPtr>());
+            std::move(stringBuffers));
       }
 
       return result;
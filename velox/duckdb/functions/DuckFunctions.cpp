@@ -117,28 +117,26 @@ static void veloxFlatVectorToDuckTemplated(
   ::duckdb::FlatVector::SetData(result, valuePtr + sizeof(T) * offset);
 }
 
+// A StringView and a DuckDB string_t have the same layout: the size, a 4 byte
+// prefix and either the rest of a string of up to 12 bytes, zero padded, or a
+// pointer to the string. The DuckDB vectors thus reference the StringViews of
+// flat Velox vectors without copying. The strings stay alive while the
+// function runs since the arguments hold their buffers.
+static_assert(sizeof(StringView) == sizeof(string_t));
+static_assert(StringView::kPrefixSize == string_t::PREFIX_LENGTH);
+static_assert(StringView::kInlineSize == string_t::INLINE_LENGTH);
+
 template <>
-void veloxFlatVectorToDuckTemplated<StringView>(
+void veloxFlatVectorToDuckTemplated<bool>(
     VectorPtr arg,
     size_t offset,
     size_t count,
     Vector& result) {
-  // string type needs to be converted
-  // it is almost the same, but because DuckDB is null-terminated the length of
-  // inlined strings is off-by-one we can almost do zero copy but this breaks on
-  // strings of length exactly 12, because velox considers these inlined, but
-  // DuckDB considers them not inlined
-  // this can be fixed in the future (see DuckDB issue #1036)
-  auto resultVarchar = ::duckdb::FlatVector::GetData<string_t>(result);
-  auto veloxVarchar = (StringView*)arg->as<FlatVector<StringView>>()
-                          ->values()
-                          ->as<StringView>();
-  auto& duckdbValidity = ::duckdb::FlatVector::Validity(result);
+  // Velox packs booleans into bits, DuckDB uses a byte per boolean.
+  auto resultBool = ::duckdb::FlatVector::GetData<bool>(result);
+  auto veloxBool = arg->as<FlatVector<bool>>()->rawValues<uint64_t>();
   for (size_t i = 0; i < count; i++) {
-    if (duckdbValidity.RowIsValid(i)) {
-      resultVarchar[i] =
-          DuckStringConversion::toDuck(veloxVarchar[offset + i], result);
-    }
+    resultBool[i] = bits::isBitSet(veloxBool, offset + i);
   }
 }
 
@@ -161,41 +159,62 @@ void veloxFlatVectorToDuckTemplated<Timestamp>(
   }
 }
 
+// Sets 'result' to the validity of rows [offset, offset + count) of 'arg',
+// with the rows that are not in 'rows' invalid. Velox nulls and DuckDB
+// validity masks both have a set bit for each non-null row, so the nulls of
+// 'arg' are referenced without copying if all rows are selected, and are
+// otherwise combined with 'rows' a word at a time. 'offset' is a multiple of
+// STANDARD_VECTOR_SIZE, hence of 64.
 static void veloxConvertValidity(
     const SelectivityVector& rows,
-    VectorPtr arg,
+    const BaseVector& arg,
     size_t offset,
     size_t count,
     ValidityMask& result) {
-  if (!arg->mayHaveNulls()) {
-    // no nulls
+  VELOX_DCHECK_EQ(offset % 64, 0);
+  VELOX_DCHECK_GE(rows.size(), count + offset);
+  auto nulls = arg.rawNulls();
+  if (rows.isAllSelected()) {
+    if (nulls) {
+      result.Initialize(const_cast<uint64_t*>(nulls) + offset / 64);
+    }
     return;
   }
 
-  assert(rows.size() >= (count + offset));
-
-  for (size_t i = 0; i < count; i++) {
-    if (rows.isValid(offset + i)) {
-      result.SetValid(i);
-    } else {
-      result.SetInvalid(i);
-    }
+  result.EnsureWritable();
+  auto validity = result.GetData();
+  auto selected = rows.asRange().bits();
+  const auto firstWord = offset / 64;
+  for (auto i = 0; i < bits::nwords(count); i++) {
+    validity[i] = selected[firstWord + i] &
+        (nulls ? nulls[firstWord + i] : bits::kNotNull64);
   }
 }
 
-static void veloxConvertSelectionVector(
+// Sets the nulls of the rows of 'result' that are in 'rows' and in [offset,
+// offset + count) from 'validity', the validity of the DuckDB result vector
+// for these rows.
+static void duckValidityToVelox(
     const SelectivityVector& rows,
+    const ValidityMask& validity,
     size_t offset,
     size_t count,
-    ValidityMask& result) {
-  if (rows.isAllSelected()) {
-    // nothing selected
+    BaseVector& result) {
+  if (validity.AllValid() && !result.rawNulls()) {
     return;
   }
-  for (size_t i = 0; i < count; i++) {
-    if (!rows.isValid(offset + i)) {
-      result.SetInvalid(i);
+  auto nulls = result.mutableRawNulls();
+  auto selected = rows.asRange().bits();
+  auto source = validity.GetData();
+  const auto firstWord = offset / 64;
+  const auto numWords = bits::nwords(count);
+  for (auto i = 0; i < numWords; i++) {
+    auto mask = selected[firstWord + i];
+    if (i == numWords - 1 && count % 64 != 0) {
+      mask &= bits::lowMask(count % 64);
     }
+    const auto word = source ? source[i] : bits::kNotNull64;
+    nulls[firstWord + i] = (nulls[firstWord + i] & ~mask) | (word & mask);
   }
 }
 
@@ -303,6 +322,23 @@ void veloxDecodedVectorConversion(
   }
 }
 
+template <>
+void veloxDecodedVectorToDuckTemplated<bool>(
+    DecodedVector& arg,
+    size_t offset,
+    size_t count,
+    Vector& result) {
+  auto resultData = ::duckdb::FlatVector::GetData<bool>(result);
+  auto& resultValidity = ::duckdb::FlatVector::Validity(result);
+  for (size_t i = 0; i < count; i++) {
+    if (arg.isNullAt(offset + i)) {
+      resultValidity.SetInvalid(i);
+    } else {
+      resultData[i] = arg.valueAt<bool>(offset + i);
+    }
+  }
+}
+
 template <>
 void veloxDecodedVectorToDuckTemplated<StringView>(
     DecodedVector& arg,
@@ -351,9 +387,6 @@ static void toDuck(
   auto cardinality = std::min<size_t>(numRows - offset, STANDARD_VECTOR_SIZE);
   result.SetCardinality(cardinality);
 
-  ValidityMask selMask(cardinality);
-  veloxConvertSelectionVector(rows, offset, cardinality, selMask);
-
   assert(!castChunk.data.empty());
   assert(!result.data.empty());
   for (idx_t i = 0; i < args.size(); i++) {
@@ -368,14 +401,7 @@ static void toDuck(
     switch (arg->encoding()) {
       case VectorEncoding::Simple::FLAT: {
         auto& nullMask = ::duckdb::FlatVector::Validity(target->data[i]);
-        veloxConvertValidity(rows, arg, offset, cardinality, nullMask);
-
-        for (size_t i = 0; i < cardinality; i++) {
-          if (!selMask.RowIsValid(i)) {
-            nullMask.SetInvalid(i);
-          }
-        }
-
+        veloxConvertValidity(rows, *arg, offset, cardinality, nullMask);
         veloxFlatVectorToDuck(rows, arg, offset, cardinality, target->data[i]);
         break;
       }
@@ -464,7 +490,7 @@ class DuckDBFunction : public exec::VectorFunction {
       // convert arguments to duck arguments
       toDuck(rows, args, offset, *state->castChunk, *state->input);
       // run the function
-      callFunction(function, *state, offset, result);
+      callFunction(function, *state, rows, offset, result);
     }
   }
 
@@ -472,6 +498,7 @@ class DuckDBFunction : public exec::VectorFunction {
   void callFunctionNumeric(
       ScalarFunction& function,
       DuckDBFunctionData& state,
+      const SelectivityVector& rows,
       size_t offset,
       VectorPtr result) const {
     // all other supported types (numerics) have the same representation between
@@ -485,6 +512,12 @@ class DuckDBFunction : public exec::VectorFunction {
     switch (resultVector.GetVectorType()) {
       case VectorType::FLAT_VECTOR:
         // result was already written to the velox vector
+        duckValidityToVelox(
+            rows,
+            ::duckdb::FlatVector::Validity(resultVector),
+            offset,
+            state.input->size(),
+            *result);
         break;
       case VectorType::CONSTANT_VECTOR: {
         if (::duckdb::ConstantVector::IsNull(resultVector)) {
@@ -511,6 +544,7 @@ class DuckDBFunction : public exec::VectorFunction {
   void callFunctionConversion(
       ScalarFunction& function,
       DuckDBFunctionData& state,
+      const SelectivityVector& rows,
       size_t offset,
       VectorPtr result) const {
     Vector resultVector(function.return_type);
@@ -526,6 +560,8 @@ class DuckDBFunction : public exec::VectorFunction {
             flatResult->set(veloxIndex, OP::toVelox(resultData[i]));
           }
         }
+        duckValidityToVelox(
+            rows, resultMask, offset, state.input->size(), *result);
         break;
       }
       case VectorType::CONSTANT_VECTOR: {
@@ -553,37 +589,40 @@ class DuckDBFunction : public exec::VectorFunction {
   void callFunction(
       ScalarFunction& function,
       DuckDBFunctionData& state,
+      const SelectivityVector& rows,
       size_t offset,
       VectorPtr result) const {
     switch (function.return_type.id()) {
       case LogicalTypeId::BOOLEAN:
-        callFunctionNumeric<bool>(function, state, offset, result);
+        // Velox packs booleans into bits, DuckDB uses a byte per boolean.
+        callFunctionConversion<bool, bool, DuckNumericConversion<bool>>(
+            function, state, rows, offset, result);
         break;
       case LogicalTypeId::TINYINT:
-        callFunctionNumeric<int8_t>(function, state, offset, result);
+        callFunctionNumeric<int8_t>(function, state, rows, offset, result);
         break;
       case LogicalTypeId::SMALLINT:
-        callFunctionNumeric<int16_t>(function, state, offset, result);
+        callFunctionNumeric<int16_t>(function, state, rows, offset, result);
         break;
       case LogicalTypeId::INTEGER:
-        callFunctionNumeric<int32_t>(function, state, offset, result);
+        callFunctionNumeric<int32_t>(function, state, rows, offset, result);
         break;
       case LogicalTypeId::BIGINT:
-        callFunctionNumeric<int64_t>(function, state, offset, result);
+        callFunctionNumeric<int64_t>(function, state, rows, offset, result);
         break;
       case LogicalTypeId::FLOAT:
-        callFunctionNumeric<float>(function, state, offset, result);
+        callFunctionNumeric<float>(function, state, rows, offset, result);
         break;
       case LogicalTypeId::DOUBLE:
-        callFunctionNumeric<double>(function, state, offset, result);
+        callFunctionNumeric<double>(function, state, rows, offset, result);
         break;
       case LogicalTypeId::TIMESTAMP:
         callFunctionConversion<timestamp_t, Timestamp, DuckTimestampConversion>(
-            function, state, offset, result);
+            function, state, rows, offset, result);
         break;
       case LogicalTypeId::VARCHAR:
         callFunctionConversion<string_t, StringView, DuckStringConversion>(
-            function, state, offset, result);
+            function, state, rows, offset, result);
         break;
       default:
         break;
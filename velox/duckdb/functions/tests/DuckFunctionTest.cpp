@@ -637,3 +637,51 @@ TEST_F(BaseDuckTest, epochMs) {
       {0, 1574802684123},
       {Timestamp(0, 0), Timestamp(1574802684, 123000000)});
 }
+
+TEST_F(BaseDuckTest, sharedBuffers) {
+  // Strings up to and beyond the inline size with nulls, over more rows than
+  // a DuckDB vector holds.
+  static constexpr vector_size_t kSize = 3000;
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 20; i++) {
+    strings.push_back(std::string(i, 'a' + i));
+  }
+  auto input = makeFlatVector<StringView>(
+      kSize,
+      [&](auto row) { return StringView(strings[row % 20]); },
+      nullEvery(7));
+  auto result = evaluate("duckdb_length(c0)", makeRowVector({input}));
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          kSize, [](auto row) { return row % 20; }, nullEvery(7)),
+      result);
+
+  result = evaluate("duckdb_reverse(c0)", makeRowVector({input}));
+  assertEqualVectors(input, result);
+
+  // Only some of the rows are selected.
+  auto condition =
+      makeFlatVector<bool>(kSize, [](auto row) { return row % 3 == 0; });
+  result = evaluate(
+      "if(c1, duckdb_length(c0), cast(-1 as bigint))",
+      makeRowVector({input, condition}));
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          kSize,
+          [](auto row) { return row % 3 == 0 ? row % 20 : -1; },
+          [](auto row) { return row % 3 == 0 && row % 7 == 0; }),
+      result);
+
+  // Boolean results, which DuckDB does not pack into bits.
+  auto doubles = makeFlatVector<double>(
+      kSize,
+      [](auto row) {
+        return row % 5 == 0 ? std::numeric_limits<double>::infinity() : row;
+      },
+      nullEvery(11));
+  result = evaluate("duckdb_isinf(c0)", makeRowVector({doubles}));
+  assertEqualVectors(
+      makeFlatVector<bool>(
+          kSize, [](auto row) { return row % 5 == 0; }, nullEvery(11)),
+      result);
+}
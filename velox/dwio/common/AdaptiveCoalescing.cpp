@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/AdaptiveCoalescing.h"
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <typeinfo>
+
+namespace facebook::velox::dwio::common {
+
+// static
+std::shared_ptr<AdaptiveCoalescing> AdaptiveCoalescing::forFile(
+    const ReadFile& file) {
+  static folly::Synchronized<
+      folly::F14FastMap<std::string, std::shared_ptr<AdaptiveCoalescing>>>
+      instances;
+  const std::string name = typeid(file).name();
+  return instances.withWLock([&](auto& map) {
+    auto& instance = map[name];
+    if (!instance) {
+      instance = std::make_shared<AdaptiveCoalescing>();
+    }
+    return instance;
+  });
+}
+
+void AdaptiveCoalescing::recordRead(uint64_t bytes, uint64_t usec) {
+  if (bytes == 0) {
+    return;
+  }
+  const double x = bytes;
+  const double y = usec;
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numSamples_;
+  weight_ = weight_ * kDecay + 1;
+  sumBytes_ = sumBytes_ * kDecay + x;
+  sumUsec_ = sumUsec_ * kDecay + y;
+  sumBytes2_ = sumBytes2_ * kDecay + x * x;
+  sumBytesUsec_ = sumBytesUsec_ * kDecay + x * y;
+}
+
+bool AdaptiveCoalescing::fitLocked(double& latency, double& perByte) const {
+  if (numSamples_ < kMinSamples) {
+    return false;
+  }
+  const double meanBytes = sumBytes_ / weight_;
+  const double meanUsec = sumUsec_ / weight_;
+  const double varBytes = sumBytes2_ / weight_ - meanBytes * meanBytes;
+  // Needs reads of different sizes to separate latency from transfer.
+  if (varBytes <= meanBytes * meanBytes * 0.01) {
+    return false;
+  }
+  perByte = (sumBytesUsec_ / weight_ - meanBytes * meanUsec) / varBytes;
+  latency = meanUsec - perByte * meanBytes;
+  return perByte > 0 && latency > 0;
+}
+
+int32_t AdaptiveCoalescing::maxCoalesceDistance(int32_t defaultDistance) const {
+  double latency;
+  double perByte;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!fitLocked(latency, perByte)) {
+      return defaultDistance;
+    }
+  }
+  return std::clamp<double>(latency / perByte, kMinDistance, kMaxDistance);
+}
+
+int64_t AdaptiveCoalescing::maxCoalesceBytes(int64_t defaultBytes) const {
+  double latency;
+  double perByte;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!fitLocked(latency, perByte)) {
+      return defaultBytes;
+    }
+  }
+  // At 8x the break even distance, latency is about 10% of the read time.
+  return std::clamp<double>(8 * latency / perByte, kMinIoBytes, kMaxIoBytes);
+}
+
+double AdaptiveCoalescing::latencyUsec() const {
+  double latency = 0;
+  double perByte = 0;
+  std::lock_guard<std::mutex> l(mutex_);
+  return fitLocked(latency, perByte) ? latency : 0;
+}
+
+double AdaptiveCoalescing::usecPerByte() const {
+  double latency = 0;
+  double perByte = 0;
+  std::lock_guard<std::mutex> l(mutex_);
+  return fitLocked(latency, perByte) ? perByte : 0;
+}
+
+std::string AdaptiveCoalescing::toString() const {
+  return fmt::format(
+      "<AdaptiveCoalescing samples {} latency {}us {}us/MB distance {} max IO {}>",
+      numSamples(),
+      latencyUsec(),
+      usecPerByte() * (1 << 20),
+      maxCoalesceDistance(0),
+      maxCoalesceBytes(0));
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "velox/common/file/File.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Learns the coalescing parameters for reads from one kind of storage. Each
+/// read is modeled as a fixed latency plus a per byte transfer time, fitted by
+/// a linear regression over the recent reads. Reading a gap between two ranges
+/// costs as much as a separate read when the gap is latency / transfer time
+/// bytes, so this is the largest gap worth coalescing. Until enough reads have
+/// been seen, the configured defaults are returned. Thread safe.
+class AdaptiveCoalescing {
+ public:
+  /// Number of reads recorded before the learned values are used.
+  static constexpr int32_t kMinSamples = 20;
+
+  /// Bounds of the learned coalescing distance.
+  static constexpr int32_t kMinDistance = 4 << 10;
+  static constexpr int32_t kMaxDistance = 16 << 20;
+
+  /// Bounds of the learned maximum size of a coalesced read.
+  static constexpr int64_t kMinIoBytes = 8 << 20;
+  static constexpr int64_t kMaxIoBytes = 128 << 20;
+
+  /// Weight of the previous samples when a new read is recorded.
+  static constexpr double kDecay = 0.99;
+
+  /// Returns the instance shared by all files with the same ReadFile
+  /// implementation as 'file'.
+  static std::shared_ptr<AdaptiveCoalescing> forFile(const ReadFile& file);
+
+  /// Records a read of 'bytes' that took 'usec' microseconds.
+  void recordRead(uint64_t bytes, uint64_t usec);
+
+  /// Returns the largest gap between ranges that are read in one IO, or
+  /// 'defaultDistance' if there are not enough samples.
+  int32_t maxCoalesceDistance(int32_t defaultDistance) const;
+
+  /// Returns the largest size of a coalesced read, or 'defaultBytes' if there
+  /// are not enough samples. This is a multiple of the coalescing distance, so
+  /// that a read is dominated by transfer and not latency.
+  int64_t maxCoalesceBytes(int64_t defaultBytes) const;
+
+  /// Returns the fitted per read latency in microseconds.
+  double latencyUsec() const;
+
+  /// Returns the fitted transfer time in microseconds per byte.
+  double usecPerByte() const;
+
+  int64_t numSamples() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return numSamples_;
+  }
+
+  std::string toString() const;
+
+ private:
+  // Fits latency + perByte * bytes to the samples. Returns false if the fit is
+  // not usable, e.g. all reads were of the same size.
+  bool fitLocked(double& latency, double& perByte) const;
+
+  mutable std::mutex mutex_;
+  int64_t numSamples_{0};
+
+  // Decayed sums of weight, bytes, usec, bytes^2 and bytes * usec.
+  double weight_{0};
+  double sumBytes_{0};
+  double sumUsec_{0};
+  double sumBytes2_{0};
+  double sumBytesUsec_{0};
+};
+
+} // namespace facebook::velox::dwio::common
@@ -23,6 +23,12 @@
 #include <folly/Range.h>
 #include <xsimd/config/xsimd_config.hpp>
 
+#include <type_traits>
+
+#if XSIMD_WITH_NEON64
+#include <arm_neon.h>
+#endif
+
 namespace facebook::velox::dwio::common {
 
 using RowSet = folly::Range<const facebook::velox::vector_size_t*>;
@@ -632,6 +638,248 @@ static inline void unpack32(
   outputBuffer += numValues;
 }
 
+#elif XSIMD_WITH_NEON64
+
+// Fills 'shuffle' and 'shifts' for moving 16 / sizeof(T) consecutive bit
+// fields of 'bitWidth' bits, the first one starting at bit 'bitOffset' of a
+// 16 byte window, into lanes of T. Each lane gets the sizeof(T) bytes starting
+// at the first byte of its field and is then shifted right by the offset of
+// the field in that byte. The caller makes sure that the bytes are in the
+// window and that each field fits in its lane after the shift.
+template <typename T>
+static inline void neonUnpackMasks(
+    uint8_t bitWidth,
+    int32_t bitOffset,
+    uint8_t* FOLLY_NONNULL shuffle,
+    std::make_signed_t<T>* FOLLY_NONNULL shifts) {
+  for (auto i = 0; i < 16 / sizeof(T); ++i) {
+    auto bit = bitOffset + i * bitWidth;
+    for (auto j = 0; j < sizeof(T); ++j) {
+      shuffle[i * sizeof(T) + j] = bit / 8 + j;
+    }
+    shifts[i] = -(bit % 8);
+  }
+}
+
+// Extracts the bit fields selected by 'shuffle' and 'shifts' from the 16 bytes
+// at 'input' into the lanes of the result.
+static inline uint16x8_t neonUnpackFields(
+    const uint8_t* FOLLY_NONNULL input,
+    uint8x16_t shuffle,
+    int16x8_t shifts,
+    uint16x8_t mask) {
+  auto fields = vreinterpretq_u16_u8(vqtbl1q_u8(vld1q_u8(input), shuffle));
+  return vandq_u16(vshlq_u16(fields, shifts), mask);
+}
+
+static inline uint32x4_t neonUnpackFields(
+    const uint8_t* FOLLY_NONNULL input,
+    uint8x16_t shuffle,
+    int32x4_t shifts,
+    uint32x4_t mask) {
+  auto fields = vreinterpretq_u32_u8(vqtbl1q_u8(vld1q_u8(input), shuffle));
+  return vandq_u32(vshlq_u32(fields, shifts), mask);
+}
+
+static inline uint64x2_t neonUnpackFields(
+    const uint8_t* FOLLY_NONNULL input,
+    uint8x16_t shuffle,
+    int64x2_t shifts,
+    uint64x2_t mask) {
+  auto fields = vreinterpretq_u64_u8(vqtbl1q_u8(vld1q_u8(input), shuffle));
+  return vandq_u64(vshlq_u64(fields, shifts), mask);
+}
+
+// Unpack numValues number of uint8_t values with bitWidth in [1, 8] range.
+// The values are extracted into 16-bit lanes, as a field may span 2 bytes, and
+// then narrowed to 8 bits.
+static inline void unpackNeon8(
+    uint8_t bitWidth,
+    const uint8_t* FOLLY_NONNULL& inputBuffer,
+    uint64_t inputBufferLen,
+    uint64_t numValues,
+    uint8_t* FOLLY_NONNULL& outputBuffer) {
+  alignas(16) uint8_t shuffleBytes[16];
+  alignas(16) int16_t shiftCounts[8];
+  // 8 values take bitWidth bytes, so every 8 values start at bit 0 of a byte.
+  neonUnpackMasks<uint16_t>(bitWidth, 0, shuffleBytes, shiftCounts);
+  auto shuffle = vld1q_u8(shuffleBytes);
+  auto shifts = vld1q_s16(shiftCounts);
+  auto mask = vdupq_n_u16(BITPACK_MASKS[bitWidth]);
+
+  auto inputEnd = inputBuffer + inputBufferLen;
+  auto writeEndOffset = outputBuffer + numValues;
+
+  // Process 2 * bitWidth bytes (16 values) a time as long as the 16 byte
+  // windows are inside the input buffer.
+  while (outputBuffer + 16 <= writeEndOffset &&
+         inputBuffer + bitWidth + 16 <= inputEnd) {
+    auto low = neonUnpackFields(inputBuffer, shuffle, shifts, mask);
+    auto high = neonUnpackFields(inputBuffer + bitWidth, shuffle, shifts, mask);
+    vst1q_u8(outputBuffer, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+
+    inputBuffer += 2 * bitWidth;
+    outputBuffer += 16;
+  }
+
+  numValues = writeEndOffset - outputBuffer;
+  unpackNaive(
+      inputBuffer,
+      (bitWidth * numValues + 7) / 8,
+      numValues,
+      bitWidth,
+      outputBuffer);
+}
+
+// Unpack numValues number of uint16_t values with bitWidth in [1, 16] range.
+// The values are extracted into 32-bit lanes, as a field may span 3 bytes, and
+// then narrowed to 16 bits.
+static inline void unpackNeon16(
+    uint8_t bitWidth,
+    const uint8_t* FOLLY_NONNULL& inputBuffer,
+    uint64_t inputBufferLen,
+    uint64_t numValues,
+    uint16_t* FOLLY_NONNULL& outputBuffer) {
+  // The second 4 of every 8 values start at bit 4 * bitWidth.
+  auto highOffset = bitWidth / 2;
+  alignas(16) uint8_t shuffleBytes[2][16];
+  alignas(16) int32_t shiftCounts[2][4];
+  neonUnpackMasks<uint32_t>(bitWidth, 0, shuffleBytes[0], shiftCounts[0]);
+  neonUnpackMasks<uint32_t>(
+      bitWidth, 4 * bitWidth % 8, shuffleBytes[1], shiftCounts[1]);
+  auto lowShuffle = vld1q_u8(shuffleBytes[0]);
+  auto highShuffle = vld1q_u8(shuffleBytes[1]);
+  auto lowShifts = vld1q_s32(shiftCounts[0]);
+  auto highShifts = vld1q_s32(shiftCounts[1]);
+  auto mask = vdupq_n_u32(BITPACK_MASKS[bitWidth]);
+
+  auto inputEnd = inputBuffer + inputBufferLen;
+  auto writeEndOffset = outputBuffer + numValues;
+
+  // Process bitWidth bytes (8 values) a time.
+  while (outputBuffer + 8 <= writeEndOffset &&
+         inputBuffer + highOffset + 16 <= inputEnd) {
+    auto low = neonUnpackFields(inputBuffer, lowShuffle, lowShifts, mask);
+    auto high = neonUnpackFields(
+        inputBuffer + highOffset, highShuffle, highShifts, mask);
+    vst1q_u16(outputBuffer, vcombine_u16(vmovn_u32(low), vmovn_u32(high)));
+
+    inputBuffer += bitWidth;
+    outputBuffer += 8;
+  }
+
+  numValues = writeEndOffset - outputBuffer;
+  unpackNaive(
+      inputBuffer,
+      (bitWidth * numValues + 7) / 8,
+      numValues,
+      bitWidth,
+      outputBuffer);
+}
+
+// Unpack numValues number of uint32_t values with bitWidth in [1, 25] range.
+// A field with up to 7 bits of offset in its first byte fits in a 32-bit lane.
+static inline void unpackNeon1to25(
+    uint8_t bitWidth,
+    const uint8_t* FOLLY_NONNULL& inputBuffer,
+    uint64_t inputBufferLen,
+    uint64_t numValues,
+    uint32_t* FOLLY_NONNULL& outputBuffer) {
+  // The second 4 of every 8 values start at bit 4 * bitWidth.
+  auto highOffset = bitWidth / 2;
+  alignas(16) uint8_t shuffleBytes[2][16];
+  alignas(16) int32_t shiftCounts[2][4];
+  neonUnpackMasks<uint32_t>(bitWidth, 0, shuffleBytes[0], shiftCounts[0]);
+  neonUnpackMasks<uint32_t>(
+      bitWidth, 4 * bitWidth % 8, shuffleBytes[1], shiftCounts[1]);
+  auto lowShuffle = vld1q_u8(shuffleBytes[0]);
+  auto highShuffle = vld1q_u8(shuffleBytes[1]);
+  auto lowShifts = vld1q_s32(shiftCounts[0]);
+  auto highShifts = vld1q_s32(shiftCounts[1]);
+  auto mask = vdupq_n_u32(BITPACK_MASKS[bitWidth]);
+
+  auto inputEnd = inputBuffer + inputBufferLen;
+  auto writeEndOffset = outputBuffer + numValues;
+
+  // Process bitWidth bytes (8 values) a time.
+  while (outputBuffer + 8 <= writeEndOffset &&
+         inputBuffer + highOffset + 16 <= inputEnd) {
+    vst1q_u32(
+        outputBuffer,
+        neonUnpackFields(inputBuffer, lowShuffle, lowShifts, mask));
+    vst1q_u32(
+        outputBuffer + 4,
+        neonUnpackFields(
+            inputBuffer + highOffset, highShuffle, highShifts, mask));
+
+    inputBuffer += bitWidth;
+    outputBuffer += 8;
+  }
+
+  numValues = writeEndOffset - outputBuffer;
+  unpackNaive(
+      inputBuffer,
+      (bitWidth * numValues + 7) / 8,
+      numValues,
+      bitWidth,
+      outputBuffer);
+}
+
+// Unpack numValues number of uint32_t values with bitWidth in [26, 32] range.
+// The values are extracted 2 at a time into 64-bit lanes and then narrowed to
+// 32 bits.
+static inline void unpackNeon26to32(
+    uint8_t bitWidth,
+    const uint8_t* FOLLY_NONNULL& inputBuffer,
+    uint64_t inputBufferLen,
+    uint64_t numValues,
+    uint32_t* FOLLY_NONNULL& outputBuffer) {
+  // Every 2 of 8 values start at bit 2 * i * bitWidth.
+  int32_t byteOffsets[4];
+  alignas(16) uint8_t shuffleBytes[4][16];
+  alignas(16) int64_t shiftCounts[4][2];
+  uint8x16_t shuffles[4];
+  int64x2_t shifts[4];
+  for (auto i = 0; i < 4; ++i) {
+    byteOffsets[i] = 2 * i * bitWidth / 8;
+    neonUnpackMasks<uint64_t>(
+        bitWidth, 2 * i * bitWidth % 8, shuffleBytes[i], shiftCounts[i]);
+    shuffles[i] = vld1q_u8(shuffleBytes[i]);
+    shifts[i] = vld1q_s64(shiftCounts[i]);
+  }
+  auto mask = vdupq_n_u64(BITPACK_MASKS[bitWidth]);
+
+  auto inputEnd = inputBuffer + inputBufferLen;
+  auto writeEndOffset = outputBuffer + numValues;
+
+  // Process bitWidth bytes (8 values) a time.
+  while (outputBuffer + 8 <= writeEndOffset &&
+         inputBuffer + byteOffsets[3] + 16 <= inputEnd) {
+    for (auto i = 0; i < 4; i += 2) {
+      auto low = neonUnpackFields(
+          inputBuffer + byteOffsets[i], shuffles[i], shifts[i], mask);
+      auto high = neonUnpackFields(
+          inputBuffer + byteOffsets[i + 1],
+          shuffles[i + 1],
+          shifts[i + 1],
+          mask);
+      vst1q_u32(
+          outputBuffer + 2 * i, vcombine_u32(vmovn_u64(low), vmovn_u64(high)));
+    }
+
+    inputBuffer += bitWidth;
+    outputBuffer += 8;
+  }
+
+  numValues = writeEndOffset - outputBuffer;
+  unpackNaive(
+      inputBuffer,
+      (bitWidth * numValues + 7) / 8,
+      numValues,
+      bitWidth,
+      outputBuffer);
+}
+
 #endif
 
 template <>
@@ -663,6 +911,10 @@ inline void unpack<uint8_t>(
   unpackNaive(
       inputBits, (bitWidth * numValues + 7) / 8, numValues, bitWidth, result);
 
+#elif XSIMD_WITH_NEON64
+
+  unpackNeon8(bitWidth, inputBits, inputBufferLen, numValues, result);
+
 #else
 
   unpackNaive<uint8_t>(inputBits, inputBufferLen, numValues, bitWidth, result);
@@ -712,6 +964,11 @@ inline void unpack<uint16_t>(
     default:
       VELOX_UNREACHABLE("invalid bitWidth");
   }
+
+#elif XSIMD_WITH_NEON64
+
+  unpackNeon16(bitWidth, inputBits, inputBufferLen, numValues, result);
+
 #else
 
   unpackNaive<uint16_t>(inputBits, inputBufferLen, numValues, bitWidth, result);
@@ -782,6 +1039,14 @@ inline void unpack<uint32_t>(
       VELOX_UNREACHABLE("invalid bitWidth");
   }
 
+#elif XSIMD_WITH_NEON64
+
+  if (bitWidth <= 25) {
+    unpackNeon1to25(bitWidth, inputBits, inputBufferLen, numValues, result);
+  } else {
+    unpackNeon26to32(bitWidth, inputBits, inputBufferLen, numValues, result);
+  }
+
 #else
 
   unpackNaive<uint32_t>(inputBits, inputBufferLen, numValues, bitWidth, result);
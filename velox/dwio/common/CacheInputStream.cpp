@@ -195,7 +195,10 @@ void CacheInputStream::loadSync(Region region) {
       // missed, fall back to remote fetching.
       entry->setGroupId(groupId_);
       entry->setTrackingId(trackingId_);
-      if (loadFromSsd(region, *entry)) {
+      if (tracker_) {
+        entry->setAdmission(tracker_->admission(trackingId_));
+      }
+      if (loadFromSsd(region, *entry) || loadFromSharedTier(region, *entry)) {
         return;
       }
       auto ranges = makeRanges(entry, region.length);
@@ -204,6 +207,9 @@ void CacheInputStream::loadSync(Region region) {
         MicrosecondTimer timer(&usec);
         input_->read(ranges, region.offset, LogType::FILE);
       }
+      if (auto* coalescing = bufferedInput_->coalescing()) {
+        coalescing->recordRead(region.length, usec);
+      }
       ioStats_->read().increment(region.length);
       ioStats_->queryThreadIoLatency().increment(usec);
       entry->setExclusiveToShared();
@@ -273,6 +279,35 @@ bool CacheInputStream::loadFromSsd(
   return true;
 }
 
+bool CacheInputStream::loadFromSharedTier(
+    Region region,
+    cache::AsyncDataCacheEntry& entry) {
+  auto ssdCache = cache_->ssdCache();
+  auto* tier = ssdCache ? ssdCache->sharedTier() : nullptr;
+  if (!tier) {
+    return false;
+  }
+  uint64_t usec = 0;
+  bool found;
+  {
+    MicrosecondTimer timer(&usec);
+    found = tier->read(
+        fileIds().string(fileNum_),
+        region.offset,
+        entry.size(),
+        makeRanges(&entry, entry.size()));
+  }
+  ioStats_->sharedTierLatency().increment(usec);
+  ioStats_->queryThreadIoLatency().increment(usec);
+  if (!found) {
+    ioStats_->sharedTierMiss().increment(entry.size());
+    return false;
+  }
+  ioStats_->sharedTierRead().increment(entry.size());
+  entry.setExclusiveToShared();
+  return true;
+}
+
 void CacheInputStream::loadPosition() {
   auto offset = region_.offset;
   if (pin_.empty()) {
@@ -107,6 +107,10 @@ class CacheInputStream : public SeekableInputStream {
   // successfully loaded.
   bool loadFromSsd(Region region, cache::AsyncDataCacheEntry& entry);
 
+  // Returns true if there is a shared cache tier behind the SSD cache and
+  // 'entry' is present there and successfully loaded.
+  bool loadFromSharedTier(Region region, cache::AsyncDataCacheEntry& entry);
+
   CachedBufferedInput* const bufferedInput_;
   cache::AsyncDataCache* const cache_;
   IoStatistics* ioStats_;
@@ -16,7 +16,9 @@
 
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/common/memory/Allocation.h"
+#include "velox/common/caching/FileIds.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DEFINE_int32(
@@ -24,6 +26,11 @@ DEFINE_int32(
     80,
     "Minimum percentage of actual uses over references to a column for prefetching. No prefetch if > 100");
 
+DEFINE_bool(
+    cache_adaptive_coalesce,
+    true,
+    "Learn the coalescing distance and maximum read size from the latency of reads from each kind of storage");
+
 namespace facebook::velox::dwio::common {
 
 using cache::CachePin;
@@ -180,9 +187,13 @@ void CachedBufferedInput::load(const LogType) {
       }
       if (prefetchAnyway || adjustedReadPct(trackingData) >= readPct) {
         request.processed = true;
+        const auto admission = prefetchAnyway || !tracker_
+            ? cache::CacheAdmission::kRam
+            : tracker_->admissionPolicy().admission(trackingData);
         auto parts = makeRequestParts(
             request, trackingData, loadQuantum_, extraRequests);
         for (auto part : parts) {
+          part->admission = admission;
           if (cache_->exists(part->key)) {
             continue;
           }
@@ -208,6 +219,60 @@ void CachedBufferedInput::load(const LogType) {
   }
 }
 
+std::vector<std::shared_ptr<cache::CoalescedLoad>>
+CachedBufferedInput::prewarm() {
+  VELOX_CHECK_NOT_NULL(executor_, "Cache prewarm requires an executor");
+  auto requests = std::move(requests_);
+  cache::SsdFile* FOLLY_NULLABLE ssdFile = nullptr;
+  auto ssdCache = cache_->ssdCache();
+  if (ssdCache) {
+    ssdFile = &ssdCache->file(fileNum_);
+  }
+  // Requests are split into load quanta that all coalesce, since every part
+  // is wanted.
+  std::vector<std::unique_ptr<CacheRequest>> parts;
+  std::vector<CacheRequest*> storageLoad;
+  std::vector<CacheRequest*> ssdLoad;
+  for (auto& request : requests) {
+    for (uint64_t offset = 0; offset < request.size; offset += loadQuantum_) {
+      parts.push_back(std::make_unique<CacheRequest>(
+          RawFileCacheKey{request.key.fileNum, request.key.offset + offset},
+          std::min<uint64_t>(loadQuantum_, request.size - offset),
+          request.trackingId));
+      auto part = parts.back().get();
+      part->stream = request.stream;
+      if (cache_->exists(part->key)) {
+        continue;
+      }
+      if (ssdFile) {
+        part->ssdPin = ssdFile->find(part->key);
+        if (!part->ssdPin.empty() && part->ssdPin.run().size() < part->size) {
+          part->ssdPin.clear();
+        }
+        if (!part->ssdPin.empty()) {
+          ssdLoad.push_back(part);
+          continue;
+        }
+      }
+      storageLoad.push_back(part);
+    }
+  }
+  auto previousLoads = std::move(allCoalescedLoads_);
+  allCoalescedLoads_.clear();
+  makeLoads(std::move(storageLoad), true);
+  makeLoads(std::move(ssdLoad), true);
+  auto loads = allCoalescedLoads_;
+  allCoalescedLoads_.insert(
+      allCoalescedLoads_.end(), previousLoads.begin(), previousLoads.end());
+  // The loads are not triggered by the streams.
+  coalescedLoads_.withWLock([&](auto& streamLoads) {
+    for (auto& request : requests) {
+      streamLoads.erase(request.stream);
+    }
+  });
+  return loads;
+}
+
 void CachedBufferedInput::makeLoads(
     std::vector<CacheRequest*> requests,
     bool prefetch) {
@@ -215,7 +280,9 @@ void CachedBufferedInput::makeLoads(
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance_;
+  const int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance();
+  const int64_t maxIoBytes =
+      isSsd ? std::numeric_limits<int64_t>::max() : maxCoalesceBytes();
   std::sort(
       requests.begin(),
       requests.end(),
@@ -254,7 +321,8 @@ void CachedBufferedInput::makeLoads(
           const std::vector<CacheRequest*>& ranges) {
         ++numNewLoads;
         readRegion(ranges, prefetch);
-      });
+      },
+      maxIoBytes);
   if (prefetch && executor_) {
     std::vector<int32_t> doneIndices;
     for (auto i = 0; i < allCoalescedLoads_.size(); ++i) {
@@ -315,6 +383,15 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   }
 
  protected:
+  // Sets the group, tracking id and admission of the new entry for the request
+  // at 'index'.
+  void setEntryState(int32_t index, cache::AsyncDataCacheEntry& entry) {
+    auto& request = requests_[index];
+    entry.setGroupId(groupId_);
+    entry.setTrackingId(request.trackingId);
+    entry.setAdmission(request.admission);
+  }
+
   void updateStats(const CoalesceIoStats& stats, bool isPrefetch, bool isSsd) {
     if (ioStats_) {
       ioStats_->incRawOverreadBytes(stats.extraBytes);
@@ -363,10 +440,14 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
       std::vector<CacheRequest*> requests,
-      int32_t maxCoalesceDistance)
+      int32_t maxCoalesceDistance,
+      int64_t maxCoalesceBytes,
+      AdaptiveCoalescing* FOLLY_NULLABLE coalescing)
       : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)),
         input_(std::move(input)),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        maxCoalesceBytes_(maxCoalesceBytes),
+        coalescing_(coalescing) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<CachePin> pins;
@@ -374,15 +455,20 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
     cache_.makePins(
         keys_,
         [&](int32_t index) { return sizes_[index]; },
-        [&](int32_t /*index*/, CachePin pin) {
+        [&](int32_t index, CachePin pin) {
           if (isPrefetch) {
             pin.checkedEntry()->setPrefetch(true);
           }
+          setEntryState(index, *pin.checkedEntry());
           pins.push_back(std::move(pin));
         });
     if (pins.empty()) {
       return pins;
     }
+    auto tierPins = loadFromSharedTier(pins, isPrefetch);
+    if (pins.empty()) {
+      return tierPins;
+    }
     auto stats = cache::readPins(
         pins,
         maxCoalesceDistance_,
@@ -393,14 +479,95 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
-          input_->read(buffers, offset, LogType::FILE);
-        });
+          uint64_t usec = 0;
+          {
+            MicrosecondTimer timer(&usec);
+            input_->read(buffers, offset, LogType::FILE);
+          }
+          if (coalescing_) {
+            uint64_t bytes = 0;
+            for (auto& buffer : buffers) {
+              bytes += buffer.size();
+            }
+            coalescing_->recordRead(bytes, usec);
+          }
+        },
+        maxCoalesceBytes_);
     updateStats(stats, isPrefetch, false);
+    if (ioStats_) {
+      ioStats_->coalesceDistance().increment(maxCoalesceDistance_);
+    }
+    for (auto& pin : tierPins) {
+      pins.push_back(std::move(pin));
+    }
     return pins;
   }
 
+ private:
+  // Loads the entries of 'pins' that are found in the shared cache tier, if
+  // any, and removes them from 'pins'. Returns the loaded pins.
+  std::vector<CachePin> loadFromSharedTier(
+      std::vector<CachePin>& pins,
+      bool isPrefetch) {
+    std::vector<CachePin> loaded;
+    auto ssdCache = cache_.ssdCache();
+    auto* tier = ssdCache ? ssdCache->sharedTier() : nullptr;
+    if (!tier) {
+      return loaded;
+    }
+    const auto fileName = fileIds().string(keys_[0].fileNum);
+    std::vector<CachePin> missed;
+    for (auto& pin : pins) {
+      auto entry = pin.checkedEntry();
+      uint64_t usec = 0;
+      bool found;
+      {
+        MicrosecondTimer timer(&usec);
+        found = tier->read(
+            fileName, entry->offset(), entry->size(), entryRanges(*entry));
+      }
+      if (ioStats_) {
+        ioStats_->sharedTierLatency().increment(usec);
+        if (found) {
+          ioStats_->sharedTierRead().increment(entry->size());
+          if (isPrefetch) {
+            ioStats_->prefetch().increment(entry->size());
+          }
+        } else {
+          ioStats_->sharedTierMiss().increment(entry->size());
+        }
+      }
+      if (found) {
+        loaded.push_back(std::move(pin));
+      } else {
+        missed.push_back(std::move(pin));
+      }
+    }
+    pins = std::move(missed);
+    return loaded;
+  }
+
+  // Returns the buffers of 'entry' covering its size.
+  static std::vector<folly::Range<char*>> entryRanges(
+      cache::AsyncDataCacheEntry& entry) {
+    if (entry.tinyData()) {
+      return {folly::Range<char*>(entry.tinyData(), entry.size())};
+    }
+    std::vector<folly::Range<char*>> ranges;
+    int64_t bytesLeft = entry.size();
+    for (auto i = 0; i < entry.data().numRuns() && bytesLeft > 0; ++i) {
+      auto run = entry.data().runAt(i);
+      const auto bytes = std::min<int64_t>(bytesLeft, run.numBytes());
+      ranges.emplace_back(run.data<char>(), bytes);
+      bytesLeft -= bytes;
+    }
+    return ranges;
+  }
+
   std::shared_ptr<ReadFileInputStream> input_;
   const int32_t maxCoalesceDistance_;
+  const int64_t maxCoalesceBytes_;
+  AdaptiveCoalescing* const FOLLY_NULLABLE coalescing_;
 };
 
 // Represents a CoalescedLoad from local SSD cache.
@@ -423,6 +590,7 @@ class SsdLoad : public DwioCoalescedLoadBase {
           if (isPrefetch) {
             pin.checkedEntry()->setPrefetch(true);
           }
+          setEntryState(index, *pin.checkedEntry());
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
         });
@@ -449,7 +617,14 @@ void CachedBufferedInput::readRegion(
     load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
-        *cache_, input_, ioStats_, groupId_, requests, maxCoalesceDistance_);
+        *cache_,
+        input_,
+        ioStats_,
+        groupId_,
+        requests,
+        maxCoalesceDistance(),
+        maxCoalesceBytes(),
+        coalescing_.get());
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
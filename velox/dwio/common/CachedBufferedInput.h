@@ -21,6 +21,7 @@
 #include "velox/common/caching/FileGroupStats.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/SsdCache.h"
+#include "velox/dwio/common/AdaptiveCoalescing.h"
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/CacheInputStream.h"
 #include "velox/dwio/common/InputStream.h"
@@ -28,6 +29,7 @@
 #include "velox/dwio/common/Options.h"
 
 DECLARE_int32(cache_load_quantum);
+DECLARE_bool(cache_adaptive_coalesce);
 
 namespace facebook::velox::dwio::common {
 
@@ -51,6 +53,10 @@ struct CacheRequest {
   // for sparsely accessed large columns where hitting one piece
   // should not load the adjacent pieces.
   bool coalesces{true};
+
+  // Where the loaded data is retained. Decided by the access history of
+  // 'trackingId'.
+  cache::CacheAdmission admission{cache::CacheAdmission::kRam};
   const SeekableInputStream* FOLLY_NONNULL stream;
 };
 
@@ -77,7 +83,8 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input_->getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        coalescing_(makeCoalescing()) {}
 
   CachedBufferedInput(
       std::shared_ptr<ReadFileInputStream> input,
@@ -99,7 +106,8 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input_->getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        coalescing_(makeCoalescing()) {}
 
   ~CachedBufferedInput() override {
     for (auto& load : allCoalescedLoads_) {
@@ -122,6 +130,15 @@ class CachedBufferedInput : public BufferedInput {
   /// if shouldPreload() is false.
   bool prefetch(Region region);
 
+  /// Schedules the regions enqueued since the last load() for loading into
+  /// the cache on 'executor_' regardless of their access history. Used for
+  /// warming the cache with known hot columns or file groups, e.g. at worker
+  /// startup. The streams returned by enqueue() do not have to be read. The
+  /// loads are cancelled if 'this' is destroyed before they start. Returns the
+  /// scheduled loads so that the caller can wait for them with
+  /// CoalescedLoad::loadOrFuture().
+  std::vector<std::shared_ptr<cache::CoalescedLoad>> prewarm();
+
   bool shouldPreload(int32_t numPages = 0) override;
 
   bool shouldPrefetchStripes() const override {
@@ -164,7 +181,34 @@ class CachedBufferedInput : public BufferedInput {
     return executor_;
   }
 
+  /// Returns the coalescing parameters learned for the storage of 'input_' or
+  /// nullptr if adaptive coalescing is off.
+  AdaptiveCoalescing* FOLLY_NULLABLE coalescing() const {
+    return coalescing_.get();
+  }
+
+  /// Returns the largest gap between coalesced reads from storage.
+  int32_t maxCoalesceDistance() const {
+    return coalescing_ ? coalescing_->maxCoalesceDistance(maxCoalesceDistance_)
+                       : maxCoalesceDistance_;
+  }
+
+  /// Returns the largest size of a coalesced read from storage.
+  int64_t maxCoalesceBytes() const {
+    return coalescing_ ? coalescing_->maxCoalesceBytes(kDefaultMaxCoalesceBytes)
+                       : kDefaultMaxCoalesceBytes;
+  }
+
  private:
+  // Maximum size of a coalesced read before enough reads have been timed.
+  static constexpr int64_t kDefaultMaxCoalesceBytes = 64 << 20;
+
+  std::shared_ptr<AdaptiveCoalescing> makeCoalescing() const {
+    return FLAGS_cache_adaptive_coalesce
+        ? AdaptiveCoalescing::forFile(*input_->getReadFile())
+        : nullptr;
+  }
+
   // Sorts requests and makes CoalescedLoads for nearby requests. If 'prefetch'
   // is true, starts background loading.
   void makeLoads(std::vector<CacheRequest*> requests, bool prefetch);
@@ -198,6 +242,10 @@ class CachedBufferedInput : public BufferedInput {
   const uint64_t fileSize_;
   const int32_t loadQuantum_;
   const int32_t maxCoalesceDistance_;
+
+  // Coalescing parameters learned from the latency of reads from the same
+  // kind of storage. nullptr if FLAGS_cache_adaptive_coalesce is off.
+  const std::shared_ptr<AdaptiveCoalescing> coalescing_;
 };
 
 } // namespace facebook::velox::dwio::common
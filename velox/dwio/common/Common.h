@@ -18,22 +18,19 @@
 
 #include <string>
 
-namespace facebook::velox::dwio::common {
+#include "velox/common/compression/Compression.h"
 
-enum CompressionKind {
-  CompressionKind_NONE = 0,
-  CompressionKind_ZLIB = 1,
-  CompressionKind_SNAPPY = 2,
-  CompressionKind_LZO = 3,
-  CompressionKind_ZSTD = 4,
-  CompressionKind_LZ4 = 5,
-  CompressionKind_MAX = INT64_MAX
-};
+namespace facebook::velox::dwio::common {
 
-/**
- * Get the name of the CompressionKind.
- */
-std::string compressionKindToString(CompressionKind kind);
+using CompressionKind = ::facebook::velox::common::CompressionKind;
+using ::facebook::velox::common::CompressionKind_LZ4;
+using ::facebook::velox::common::CompressionKind_LZO;
+using ::facebook::velox::common::CompressionKind_MAX;
+using ::facebook::velox::common::CompressionKind_NONE;
+using ::facebook::velox::common::CompressionKind_SNAPPY;
+using ::facebook::velox::common::CompressionKind_ZLIB;
+using ::facebook::velox::common::CompressionKind_ZSTD;
+using ::facebook::velox::common::compressionKindToString;
 
 constexpr uint64_t DEFAULT_COMPRESSION_BLOCK_SIZE = 256 * 1024;
 
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+namespace facebook::velox::dwio::common {
+
+FileMetadataCache::FileMetadataCache(
+    uint64_t maxBytes,
+    std::shared_ptr<memory::MemoryPool> pool)
+    : maxBytes_(maxBytes),
+      pool_(
+          pool != nullptr ? std::move(pool)
+                          : memory::addDefaultLeafMemoryPool(
+                                "FileMetadataCache")) {}
+
+FileMetadataCache::~FileMetadataCache() {
+  clear();
+}
+
+std::shared_ptr<const FileMetadata> FileMetadataCache::get(
+    const FileMetadataKey& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numLookups_;
+  auto it = keys_.find(key);
+  if (it == keys_.end()) {
+    return nullptr;
+  }
+  ++numHits_;
+  entries_.splice(entries_.end(), entries_, it->second);
+  return it->second->metadata;
+}
+
+void FileMetadataCache::put(
+    const FileMetadataKey& key,
+    std::shared_ptr<const FileMetadata> metadata) {
+  const auto size = metadata->sizeInBytes();
+  if (size > maxBytes_) {
+    return;
+  }
+  pool_->reserve(metadata->unpooledBytes());
+  std::lock_guard<std::mutex> l(mutex_);
+  auto existing = keys_.find(key);
+  if (existing != keys_.end()) {
+    removeLocked(existing->second);
+  }
+  while (numBytes_ + size > maxBytes_) {
+    removeLocked(entries_.begin());
+  }
+  numBytes_ += size;
+  auto it = entries_.insert(entries_.end(), {key, std::move(metadata)});
+  keys_[key] = it;
+}
+
+void FileMetadataCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  while (!entries_.empty()) {
+    removeLocked(entries_.begin());
+  }
+}
+
+FileMetadataCacheStats FileMetadataCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  FileMetadataCacheStats stats;
+  stats.maxBytes = maxBytes_;
+  stats.numBytes = numBytes_;
+  stats.numEntries = entries_.size();
+  stats.numHits = numHits_;
+  stats.numLookups = numLookups_;
+  return stats;
+}
+
+void FileMetadataCache::removeLocked(EntryList::iterator it) {
+  numBytes_ -= it->metadata->sizeInBytes();
+  pool_->release(it->metadata->unpooledBytes());
+  keys_.erase(it->key);
+  entries_.erase(it);
+}
+
+} // namespace facebook::velox::dwio::common
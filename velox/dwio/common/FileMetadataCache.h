@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
+
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Identifies a version of a file. A file that is rewritten in place must
+/// get a new modification time, else readers may see stale metadata.
+struct FileMetadataKey {
+  std::string path;
+  uint64_t size;
+  int64_t modificationTime;
+
+  bool operator==(const FileMetadataKey& other) const {
+    return size == other.size && modificationTime == other.modificationTime &&
+        path == other.path;
+  }
+};
+
+struct FileMetadataKeyHasher {
+  size_t operator()(const FileMetadataKey& key) const {
+    return folly::hash::hash_combine(key.path, key.size, key.modificationTime);
+  }
+};
+
+/// The parsed metadata of a file, e.g. the footer of a DWRF or Parquet file,
+/// that readers of the same file can share instead of reading and parsing it
+/// again. Immutable once cached.
+class FileMetadata {
+ public:
+  virtual ~FileMetadata() = default;
+
+  /// Returns the memory held by 'this'. Bounds the total size of the cache.
+  virtual uint64_t sizeInBytes() const = 0;
+
+  /// Returns the part of sizeInBytes() that is not allocated from
+  /// FileMetadataCache::pool(), e.g. parsed protobuf or thrift objects. The
+  /// cache reserves this much in its pool while 'this' is cached, so that all
+  /// the memory of the cache is accounted in the pool.
+  virtual uint64_t unpooledBytes() const = 0;
+};
+
+struct FileMetadataCacheStats {
+  uint64_t maxBytes{0};
+  uint64_t numBytes{0};
+  uint64_t numEntries{0};
+  uint64_t numHits{0};
+  uint64_t numLookups{0};
+};
+
+/// A size bounded LRU cache of FileMetadata shared by all the queries of a
+/// process. Thread safe. An entry evicted while a reader uses it stays valid
+/// until the reader drops it.
+class FileMetadataCache {
+ public:
+  /// If 'pool' is null, creates a leaf pool of the default memory manager.
+  explicit FileMetadataCache(
+      uint64_t maxBytes,
+      std::shared_ptr<memory::MemoryPool> pool = nullptr);
+
+  ~FileMetadataCache();
+
+  /// Returns the metadata for 'key' or null if not cached.
+  std::shared_ptr<const FileMetadata> get(const FileMetadataKey& key);
+
+  /// Adds 'metadata' for 'key', evicting the least recently used entries to
+  /// make space. 'metadata' replaces an existing entry for 'key'. Does
+  /// nothing if 'metadata' is larger than the cache.
+  void put(
+      const FileMetadataKey& key,
+      std::shared_ptr<const FileMetadata> metadata);
+
+  /// Removes all entries.
+  void clear();
+
+  /// The pool for buffers of the cached metadata. These outlive the readers
+  /// that create them, so they may not come from a query pool.
+  const std::shared_ptr<memory::MemoryPool>& pool() const {
+    return pool_;
+  }
+
+  FileMetadataCacheStats stats() const;
+
+ private:
+  struct Entry {
+    FileMetadataKey key;
+    std::shared_ptr<const FileMetadata> metadata;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  // Removes 'it' from 'entries_' and 'keys_'. Called with 'mutex_' held.
+  void removeLocked(EntryList::iterator it);
+
+  const uint64_t maxBytes_;
+  const std::shared_ptr<memory::MemoryPool> pool_;
+
+  mutable std::mutex mutex_;
+  // Least recently used first.
+  EntryList entries_;
+  folly::F14FastMap<FileMetadataKey, EntryList::iterator, FileMetadataKeyHasher>
+      keys_;
+  uint64_t numBytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numLookups_{0};
+};
+
+} // namespace facebook::velox::dwio::common
@@ -18,6 +18,8 @@
 #include "velox/common/base/SimdUtil.h"
 #include "velox/dwio/common/DirectDecoder.h"
 
+#include <map>
+
 namespace facebook::velox::dwio::common {
 
 template <bool isSigned>
@@ -298,6 +300,178 @@ inline void clipTrailingStores(
   }
 }
 
+namespace {
+
+// Shuffle patterns for decoding varints with SIMD as in masked VByte
+// decoding (Plaisance, Kurz and Lemire, "Vectorized VByte Decoding"). The
+// patterns are indexed by the continuation bits of the first 12 bytes of a 16
+// byte window.
+struct VarintSimdPatterns {
+  struct Entry {
+    // Number of bytes taken by the varints decoded with the pattern, 0 if the
+    // varints at the start of the window are too long for SIMD decoding.
+    uint8_t numBytes;
+    // 2 if the pattern decodes 6 varints of at most 2 bytes into 16-bit lanes,
+    // 4 if it decodes 4 varints of at most 3 bytes into 32-bit lanes.
+    uint8_t laneBytes;
+    uint8_t shuffleIndex;
+  };
+
+  VarintSimdPatterns();
+
+  Entry entries[1 << 12];
+
+  // Byte shuffles that move the bytes of each varint to the low bytes of its
+  // lane and zero the rest of the lane.
+  std::vector<std::array<uint8_t, 16>> shuffles;
+};
+
+VarintSimdPatterns::VarintSimdPatterns() {
+  std::map<std::array<uint8_t, 16>, uint8_t> shuffleIndices;
+  for (int32_t mask = 0; mask < (1 << 12); ++mask) {
+    std::vector<int32_t> starts;
+    std::vector<int32_t> lengths;
+    for (int32_t start = 0, byte = 0; byte < 12; ++byte) {
+      if ((mask & (1 << byte)) == 0) {
+        starts.push_back(start);
+        lengths.push_back(byte - start + 1);
+        start = byte + 1;
+      }
+    }
+    auto fitsLanes = [&](int32_t numValues, int32_t maxLength) {
+      return lengths.size() >= numValues &&
+          *std::max_element(lengths.begin(), lengths.begin() + numValues) <=
+          maxLength;
+    };
+    auto& entry = entries[mask];
+    if (fitsLanes(6, 2)) {
+      entry.laneBytes = 2;
+    } else if (fitsLanes(4, 3)) {
+      entry.laneBytes = 4;
+    } else {
+      entry = {0, 0, 0};
+      continue;
+    }
+    std::array<uint8_t, 16> shuffle;
+    // Bytes with the high bit set are zeroed by the shuffle.
+    shuffle.fill(0x80);
+    auto numValues = entry.laneBytes == 2 ? 6 : 4;
+    for (auto i = 0; i < numValues; ++i) {
+      for (auto j = 0; j < lengths[i]; ++j) {
+        shuffle[i * entry.laneBytes + j] = starts[i] + j;
+      }
+    }
+    entry.numBytes = starts[numValues - 1] + lengths[numValues - 1];
+    auto it = shuffleIndices.find(shuffle);
+    if (it == shuffleIndices.end()) {
+      it = shuffleIndices.emplace(shuffle, shuffles.size()).first;
+      shuffles.push_back(shuffle);
+    }
+    entry.shuffleIndex = it->second;
+  }
+}
+
+const VarintSimdPatterns kVarintSimdPatterns;
+
+} // namespace
+
+// Decodes the varints at the start of the 16 bytes at 'pos' with SIMD. Writes
+// 16 values if all the 16 bytes are single byte varints. Else writes 6 values
+// if the first 6 varints take at most 2 bytes each or 4 if the first 4 take at
+// most 3 bytes each. Advances 'output' by the number of values written, which
+// can be up to 16. Returns the number of bytes decoded, or 0 if the varints are
+// too long for SIMD decoding.
+template <typename T>
+FOLLY_ALWAYS_INLINE int32_t decodeVarintsSimd(const char* pos, T*& output) {
+#if XSIMD_WITH_SSSE3 || XSIMD_WITH_NEON64
+#if XSIMD_WITH_SSSE3
+  auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+  int32_t continuationBits = _mm_movemask_epi8(data);
+#else
+  auto data = vld1q_u8(reinterpret_cast<const uint8_t*>(pos));
+  int32_t continuationBits = simd::toBitMask(
+      xsimd::batch<int8_t, xsimd::neon64>(vreinterpretq_s8_u8(data)) < 0);
+#endif
+  if (continuationBits == 0) {
+    for (auto i = 0; i < 16; ++i) {
+      output[i] = static_cast<uint8_t>(pos[i]);
+    }
+    output += 16;
+    return 16;
+  }
+  const auto& entry = kVarintSimdPatterns.entries[continuationBits & 0xfff];
+  if (entry.numBytes == 0) {
+    return 0;
+  }
+  const auto* shuffle = kVarintSimdPatterns.shuffles[entry.shuffleIndex].data();
+  // Each lane has up to 3 bytes of 7 bit groups. Drops the continuation bits
+  // and moves the groups next to each other.
+#if XSIMD_WITH_SSSE3
+  auto lanes = _mm_shuffle_epi8(
+      data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle)));
+  if (entry.laneBytes == 2) {
+    alignas(16) uint16_t values[8];
+    _mm_store_si128(
+        reinterpret_cast<__m128i*>(values),
+        _mm_or_si128(
+            _mm_and_si128(lanes, _mm_set1_epi16(0x7f)),
+            _mm_and_si128(_mm_srli_epi16(lanes, 1), _mm_set1_epi16(0x3f80))));
+    for (auto i = 0; i < 6; ++i) {
+      output[i] = values[i];
+    }
+    output += 6;
+  } else {
+    alignas(16) uint32_t values[4];
+    _mm_store_si128(
+        reinterpret_cast<__m128i*>(values),
+        _mm_or_si128(
+            _mm_or_si128(
+                _mm_and_si128(lanes, _mm_set1_epi32(0x7f)),
+                _mm_and_si128(
+                    _mm_srli_epi32(lanes, 1), _mm_set1_epi32(0x3f80))),
+            _mm_and_si128(
+                _mm_srli_epi32(lanes, 2), _mm_set1_epi32(0x1fc000))));
+    for (auto i = 0; i < 4; ++i) {
+      output[i] = values[i];
+    }
+    output += 4;
+  }
+#else
+  auto lanes = vqtbl1q_u8(data, vld1q_u8(shuffle));
+  if (entry.laneBytes == 2) {
+    auto lanes16 = vreinterpretq_u16_u8(lanes);
+    alignas(16) uint16_t values[8];
+    vst1q_u16(
+        values,
+        vorrq_u16(
+            vandq_u16(lanes16, vdupq_n_u16(0x7f)),
+            vandq_u16(vshrq_n_u16(lanes16, 1), vdupq_n_u16(0x3f80))));
+    for (auto i = 0; i < 6; ++i) {
+      output[i] = values[i];
+    }
+    output += 6;
+  } else {
+    auto lanes32 = vreinterpretq_u32_u8(lanes);
+    alignas(16) uint32_t values[4];
+    vst1q_u32(
+        values,
+        vorrq_u32(
+            vorrq_u32(
+                vandq_u32(lanes32, vdupq_n_u32(0x7f)),
+                vandq_u32(vshrq_n_u32(lanes32, 1), vdupq_n_u32(0x3f80))),
+            vandq_u32(vshrq_n_u32(lanes32, 2), vdupq_n_u32(0x1fc000))));
+    for (auto i = 0; i < 4; ++i) {
+      output[i] = values[i];
+    }
+    output += 4;
+  }
+#endif
+  return entry.numBytes;
+#else
+  return 0;
+#endif
+}
+
 template <typename T>
 FOLLY_ALWAYS_INLINE void varintSwitch(
     uint64_t word,
@@ -952,6 +1126,14 @@ void IntDecoder<isSigned>::bulkRead(uint64_t size, T* result) {
   }
   while (output < end) {
     while (end >= output + 8 && bufferEnd - pos >= 8 + maskSize) {
+      if (carryoverBits == 0 && end >= output + 16 &&
+          bufferEnd - pos >= 16 + maskSize) {
+        auto numBytes = decodeVarintsSimd(pos + maskSize, output);
+        if (numBytes) {
+          pos += numBytes;
+          continue;
+        }
+      }
       pos += maskSize;
       const auto word = folly::loadUnaligned<uint64_t>(pos);
       const uint64_t controlBits = bits::extractBits<uint64_t>(word, mask);
@@ -1007,6 +1189,23 @@ void IntDecoder<isSigned>::bulkReadRows(
   }
   while (nextRowIndex < rows.size()) {
     while (row + 8 <= endRow && bufferEnd - pos >= 8 + maskSize) {
+      if (row == nextRow && carryoverBits == 0 &&
+          nextRowIndex + 16 <= endRowIndex &&
+          rows[nextRowIndex + 15] == row + 15 &&
+          bufferEnd - pos >= 16 + maskSize) {
+        // The next 16 rows are all in 'rows'.
+        auto orgOutput = output;
+        auto numBytes = decodeVarintsSimd(pos + maskSize, output);
+        if (numBytes) {
+          int numDone = output - orgOutput;
+          pos += numBytes;
+          row += numDone;
+          nextRowIndex += numDone;
+          nextRow =
+              nextRowIndex < endRowIndex ? rows[nextRowIndex] : endRow;
+          continue;
+        }
+      }
       pos += maskSize;
       const auto word = folly::loadUnaligned<uint64_t>(pos);
       if (nextRow >= row + 8) {
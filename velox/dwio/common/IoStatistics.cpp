@@ -88,6 +88,30 @@ void IoStatistics::incOperationCounters(
   operationStats_[operation].delayInjectedInSecs += delayInjectedInSecs;
 }
 
+void IoStatistics::incDecompression(uint32_t nodeId, uint64_t cpuNanos) {
+  decompression_.increment(cpuNanos);
+  std::lock_guard<std::mutex> l(decompressionMutex_);
+  decompressionCpuNanos_[nodeId] += cpuNanos;
+}
+
+std::unordered_map<uint32_t, uint64_t> IoStatistics::decompressionCpuNanos()
+    const {
+  std::lock_guard<std::mutex> l(decompressionMutex_);
+  return decompressionCpuNanos_;
+}
+
+void IoStatistics::incDecryption(uint32_t nodeId, uint64_t cpuNanos) {
+  decryption_.increment(cpuNanos);
+  std::lock_guard<std::mutex> l(decryptionMutex_);
+  decryptionCpuNanos_[nodeId] += cpuNanos;
+}
+
+std::unordered_map<uint32_t, uint64_t> IoStatistics::decryptionCpuNanos()
+    const {
+  std::lock_guard<std::mutex> l(decryptionMutex_);
+  return decryptionCpuNanos_;
+}
+
 std::unordered_map<std::string, OperationCounters>
 IoStatistics::operationStats() const {
   std::lock_guard<std::mutex> lock{operationStatsMutex_};
@@ -104,7 +128,27 @@ void IoStatistics::merge(const IoStatistics& other) {
   read_.merge(other.read_);
   ramHit_.merge(other.ramHit_);
   ssdRead_.merge(other.ssdRead_);
+  sharedTierRead_.merge(other.sharedTierRead_);
+  sharedTierMiss_.merge(other.sharedTierMiss_);
+  sharedTierLatency_.merge(other.sharedTierLatency_);
   queryThreadIoLatency_.merge(other.queryThreadIoLatency_);
+  coalesceDistance_.merge(other.coalesceDistance_);
+  decompression_.merge(other.decompression_);
+  {
+    const auto otherCpuNanos = other.decompressionCpuNanos();
+    std::lock_guard<std::mutex> l(decompressionMutex_);
+    for (const auto& [nodeId, cpuNanos] : otherCpuNanos) {
+      decompressionCpuNanos_[nodeId] += cpuNanos;
+    }
+  }
+  decryption_.merge(other.decryption_);
+  {
+    const auto otherCpuNanos = other.decryptionCpuNanos();
+    std::lock_guard<std::mutex> l(decryptionMutex_);
+    for (const auto& [nodeId, cpuNanos] : otherCpuNanos) {
+      decryptionCpuNanos_[nodeId] += cpuNanos;
+    }
+  }
   std::lock_guard<std::mutex> l(operationStatsMutex_);
   for (auto& item : other.operationStats_) {
     operationStats_[item.first].merge(item.second);
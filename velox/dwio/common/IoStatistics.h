@@ -95,10 +95,52 @@ class IoStatistics {
     return ramHit_;
   }
 
+  IoCounter& sharedTierRead() {
+    return sharedTierRead_;
+  }
+
+  IoCounter& sharedTierMiss() {
+    return sharedTierMiss_;
+  }
+
+  IoCounter& sharedTierLatency() {
+    return sharedTierLatency_;
+  }
+
+  IoCounter& coalesceDistance() {
+    return coalesceDistance_;
+  }
+
   IoCounter& queryThreadIoLatency() {
     return queryThreadIoLatency_;
   }
 
+  // Decompressions of compression chunks. The sum is the CPU time in
+  // nanoseconds.
+  IoCounter& decompression() {
+    return decompression_;
+  }
+
+  // Adds 'cpuNanos' of decompression to the column with 'nodeId'.
+  void incDecompression(uint32_t nodeId, uint64_t cpuNanos);
+
+  // Returns the CPU time in nanoseconds spent decompressing each column by
+  // node id.
+  std::unordered_map<uint32_t, uint64_t> decompressionCpuNanos() const;
+
+  // Calls to decrypt stream data. A call decrypts one chunk or a batch of
+  // chunks. The sum is the CPU time in nanoseconds.
+  IoCounter& decryption() {
+    return decryption_;
+  }
+
+  // Adds 'cpuNanos' of decryption to the column with 'nodeId'.
+  void incDecryption(uint32_t nodeId, uint64_t cpuNanos);
+
+  // Returns the CPU time in nanoseconds spent decrypting each column by node
+  // id.
+  std::unordered_map<uint32_t, uint64_t> decryptionCpuNanos() const;
+
   void incOperationCounters(
       const std::string& operation,
       const uint64_t resourceThrottleCount,
@@ -135,10 +177,33 @@ class IoStatistics {
   // reads.
   IoCounter ssdRead_;
 
+  // Read from the shared cache tier behind SSD instead of storage.
+  IoCounter sharedTierRead_;
+
+  // Lookups in the shared cache tier that missed. The sum is in bytes.
+  IoCounter sharedTierMiss_;
+
+  // Time in microseconds spent in lookups in the shared cache tier, hit or
+  // miss.
+  IoCounter sharedTierLatency_;
+
   // Time spent by a query processing thread waiting for synchronously
   // issued IO or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
 
+  // Coalescing distance used by each coalesced read from storage.
+  IoCounter coalesceDistance_;
+
+  IoCounter decompression_;
+
+  std::unordered_map<uint32_t, uint64_t> decompressionCpuNanos_;
+  mutable std::mutex decompressionMutex_;
+
+  IoCounter decryption_;
+
+  std::unordered_map<uint32_t, uint64_t> decryptionCpuNanos_;
+  mutable std::mutex decryptionMutex_;
+
   std::unordered_map<std::string, OperationCounters> operationStats_;
   mutable std::mutex operationStatsMutex_;
 };
@@ -23,6 +23,7 @@
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/ColumnSelector.h"
 #include "velox/dwio/common/ErrorTolerance.h"
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/ScanSpec.h"
 #include "velox/dwio/common/encryption/Encryption.h"
@@ -101,6 +102,13 @@ class RowReaderOptions {
   // operations.
   std::shared_ptr<folly::Executor> decodingExecutor_;
   std::shared_ptr<folly::Executor> ioExecutor_;
+  // Number of stripes or row groups to load and prepare ahead of the one
+  // being read. The stripes are prepared on 'decodingExecutor_' if set.
+  int32_t stripeParallelism_ = 0;
+  // Decompresses the streams of a stripe on 'decodingExecutor_' if set.
+  bool parallelDecompression_ = false;
+  // Receives the decompression time of each column if set.
+  std::shared_ptr<IoStatistics> ioStatistics_;
   bool appendRowNumberColumn_ = false;
 
  public:
@@ -115,6 +123,11 @@ class RowReaderOptions {
     metadataFilter_ = other.metadataFilter_;
     returnFlatVector_ = other.returnFlatVector_;
     flatmapNodeIdAsStruct_ = other.flatmapNodeIdAsStruct_;
+    decodingExecutor_ = other.decodingExecutor_;
+    ioExecutor_ = other.ioExecutor_;
+    stripeParallelism_ = other.stripeParallelism_;
+    parallelDecompression_ = other.parallelDecompression_;
+    ioStatistics_ = other.ioStatistics_;
     appendRowNumberColumn_ = other.appendRowNumberColumn_;
   }
 
@@ -277,6 +290,43 @@ class RowReaderOptions {
     ioExecutor_ = executor;
   }
 
+  // Sets the number of stripes (row groups for Parquet) that are loaded ahead
+  // of the one being read. If 'decodingExecutor' is set, the DWRF reader loads
+  // these stripes and builds their column readers on it while the current
+  // stripe is being read. The stripes are still returned in order. 0 reads
+  // one stripe at a time on the calling thread.
+  void setStripeParallelism(int32_t parallelism) {
+    VELOX_CHECK_GE(parallelism, 0);
+    stripeParallelism_ = parallelism;
+  }
+
+  int32_t getStripeParallelism() const {
+    return stripeParallelism_;
+  }
+
+  // If true and 'decodingExecutor' is set, the DWRF reader decompresses all
+  // the compression chunks of each data stream of a stripe in parallel on the
+  // executor when the stream is first read, instead of one chunk at a time as
+  // the stream is decoded. The chunks of an encrypted stream are decrypted
+  // in one batch before.
+  void setParallelDecompression(bool parallel) {
+    parallelDecompression_ = parallel;
+  }
+
+  bool getParallelDecompression() const {
+    return parallelDecompression_;
+  }
+
+  // Sets the statistics that receive the decompression CPU time of each
+  // column.
+  void setIoStatistics(std::shared_ptr<IoStatistics> ioStatistics) {
+    ioStatistics_ = std::move(ioStatistics);
+  }
+
+  const std::shared_ptr<IoStatistics>& getIoStatistics() const {
+    return ioStatistics_;
+  }
+
   /*
    * Set to true, if you want to add a new column to the results containing the
    * row numbers.
@@ -349,6 +399,8 @@ class ReaderOptions {
   uint64_t directorySizeGuess{kDefaultDirectorySizeGuess};
   uint64_t filePreloadThreshold{kDefaultFilePreloadThreshold};
   bool caseSensitive;
+  std::shared_ptr<FileMetadataCache> fileMetadataCache_;
+  std::optional<FileMetadataKey> fileMetadataKey_;
 
  public:
   static constexpr int32_t kDefaultLoadQuantum = 8 << 20; // 8MB
@@ -383,6 +435,8 @@ class ReaderOptions {
     decrypterFactory_ = other.decrypterFactory_;
     directorySizeGuess = other.directorySizeGuess;
     filePreloadThreshold = other.filePreloadThreshold;
+    fileMetadataCache_ = other.fileMetadataCache_;
+    fileMetadataKey_ = other.fileMetadataKey_;
     return *this;
   }
 
@@ -486,6 +540,17 @@ class ReaderOptions {
     return *this;
   }
 
+  /// Sets the cache for the parsed footer of the file and the key of the
+  /// file in it. The reader takes the footer from 'cache' if found and adds
+  /// it otherwise. A null 'cache' disables caching.
+  ReaderOptions& setFileMetadataCache(
+      std::shared_ptr<FileMetadataCache> cache,
+      std::optional<FileMetadataKey> key) {
+    fileMetadataCache_ = std::move(cache);
+    fileMetadataKey_ = std::move(key);
+    return *this;
+  }
+
   ReaderOptions& setCaseSensitive(bool caseSensitiveMode) {
     caseSensitive = caseSensitiveMode;
 
@@ -561,6 +626,15 @@ class ReaderOptions {
   const bool isCaseSensitive() const {
     return caseSensitive;
   }
+
+  /// Returns the metadata cache if the metadata of the file may be cached.
+  FileMetadataCache* fileMetadataCache() const {
+    return fileMetadataKey_.has_value() ? fileMetadataCache_.get() : nullptr;
+  }
+
+  const std::optional<FileMetadataKey>& fileMetadataKey() const {
+    return fileMetadataKey_;
+  }
 };
 
 } // namespace common
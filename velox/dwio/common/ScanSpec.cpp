@@ -30,6 +30,8 @@ ScanSpec& ScanSpec::operator=(const ScanSpec& other) {
     extractValues_ = other.extractValues_;
     makeFlat_ = other.makeFlat_;
     filter_ = other.filter_;
+    multiColumnFilter_ = other.multiColumnFilter_;
+    isMultiColumnFilterInput_ = other.isMultiColumnFilterInput_;
     metadataFilters_ = other.metadataFilters_;
     selectivity_ = other.selectivity_;
     enableFilterReorder_ = other.enableFilterReorder_;
@@ -139,7 +141,7 @@ bool ScanSpec::hasFilter() const {
   if (hasFilter_.has_value()) {
     return hasFilter_.value();
   }
-  if (!isConstant() && filter_) {
+  if (!isConstant() && (filter_ || multiColumnFilter_)) {
     hasFilter_ = true;
     return true;
   }
@@ -155,6 +157,9 @@ bool ScanSpec::hasFilter() const {
 
 void ScanSpec::moveAdaptationFrom(ScanSpec& other) {
   // moves the filters and filter order from 'other'.
+  if (other.multiColumnFilter_) {
+    multiColumnFilter_ = std::move(other.multiColumnFilter_);
+  }
   std::vector<std::shared_ptr<ScanSpec>> newChildren;
   for (auto& otherChild : other.children_) {
     bool found = false;
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "velox/common/base/RawVector.h"
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/dwio/common/MetadataFilter.h"
 #include "velox/type/Filter.h"
@@ -33,6 +34,26 @@ class ColumnStatistics;
 }
 namespace common {
 
+/// A filter on more than one child of a struct, e.g. 'a + b > 10' or 'a = 1
+/// or b = 2', that cannot be expressed as a common::Filter on a single
+/// child. The struct reader evaluates this after the children with single
+/// column filters and before reading the children without filters, so that
+/// these are read only for the rows that pass.
+class MultiColumnFilter {
+ public:
+  virtual ~MultiColumnFilter() = default;
+
+  /// Names of the children of the struct that the filter depends on.
+  virtual const std::vector<std::string>& inputNames() const = 0;
+
+  /// Evaluates the filter on 'input', whose children are the values of
+  /// inputNames() in the same order. Sets 'passing' to the positions in
+  /// 'input' of the rows that pass, in ascending order.
+  virtual void filter(
+      const RowVectorPtr& input,
+      raw_vector<vector_size_t>& passing) = 0;
+};
+
 // Describes the filtering and value extraction for a
 // SelectiveColumnReader. This is owned by the TableScan Operator and
 // is passed to SelectiveColumnReaders at construction.  This is
@@ -77,6 +98,26 @@ class ScanSpec {
 
   void addFilter(const Filter&);
 
+  // Filter on more than one child of 'this'. See MultiColumnFilter.
+  MultiColumnFilter* multiColumnFilter() const {
+    return multiColumnFilter_.get();
+  }
+
+  void setMultiColumnFilter(std::shared_ptr<MultiColumnFilter> filter) {
+    multiColumnFilter_ = std::move(filter);
+    hasFilter_.reset();
+  }
+
+  // Returns true if the value of 'this' is an input of the multi column
+  // filter of its parent. These are not read as LazyVectors.
+  bool isMultiColumnFilterInput() const {
+    return isMultiColumnFilterInput_;
+  }
+
+  void setIsMultiColumnFilterInput(bool value) {
+    isMultiColumnFilterInput_ = value;
+  }
+
   void setMaxArrayElementsCount(vector_size_t count) {
     maxArrayElementsCount_ = count;
   }
@@ -377,6 +418,9 @@ class ScanSpec {
   bool makeFlat_ = false;
   std::shared_ptr<common::Filter> filter_;
 
+  std::shared_ptr<MultiColumnFilter> multiColumnFilter_;
+  bool isMultiColumnFilterInput_ = false;
+
   // Filters that will be only used for row group filtering based on metadata.
   // The conjunctions among these filters are tracked in MetadataFilter, with
   // the pointers to LeafNodes are stored here.  We need to keep these pointers
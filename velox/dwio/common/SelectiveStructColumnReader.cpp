@@ -31,6 +31,7 @@ void SelectiveStructColumnReaderBase::filterRowGroups(
 }
 
 uint64_t SelectiveStructColumnReaderBase::skip(uint64_t numValues) {
+  catchUpLazyChildren();
   auto numNonNulls = formatData_->skipNulls(numValues);
   // 'readOffset_' of struct child readers is aligned with
   // 'readOffset_' of the struct. The child readers may have fewer
@@ -87,6 +88,7 @@ void SelectiveStructColumnReaderBase::read(
     vector_size_t offset,
     RowSet rows,
     const uint64_t* incomingNulls) {
+  catchUpLazyChildren();
   numReads_ = scanSpec_->newRead();
   prepareRead<char>(offset, rows, incomingNulls);
   RowSet activeRows = rows;
@@ -111,16 +113,36 @@ void SelectiveStructColumnReaderBase::read(
   }
 
   assert(!children_.empty());
+  auto* multiColumnFilter = scanSpec_->multiColumnFilter();
+  bool multiColumnFilterDone = multiColumnFilter == nullptr;
   for (size_t i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
+    if (!multiColumnFilterDone && !childSpec->hasFilter()) {
+      // The children with filters are first. Apply the multi column filter
+      // after these and before reading the rest.
+      multiColumnFilterDone = true;
+      hasFilter = true;
+      activeRows = applyMultiColumnFilter(offset, activeRows, structNulls);
+      if (activeRows.empty()) {
+        break;
+      }
+    }
     if (childSpec->isConstant()) {
       continue;
     }
     auto fieldIndex = childSpec->subscript();
     auto reader = children_.at(fieldIndex);
-    if (reader->isTopLevel() && childSpec->projectOut() &&
+    if (multiColumnFilter && childSpec->isMultiColumnFilterInput() &&
+        !childSpec->hasFilter()) {
+      // Read by applyMultiColumnFilter().
+      continue;
+    }
+    if (isLazyLoadable(*reader) && childSpec->projectOut() &&
         !childSpec->hasFilter() && !childSpec->extractValues()) {
       // Will make a LazyVector.
+      if (!reader->isTopLevel()) {
+        lazyChildrenWithParentNulls_.push_back(reader);
+      }
       continue;
     }
     advanceFieldReader(reader, offset);
@@ -145,6 +167,11 @@ void SelectiveStructColumnReaderBase::read(
       reader->read(offset, activeRows, structNulls);
     }
   }
+  if (!multiColumnFilterDone && !activeRows.empty()) {
+    // All the children have filters.
+    hasFilter = true;
+    activeRows = applyMultiColumnFilter(offset, activeRows, structNulls);
+  }
   // If this adds nulls, the field readers will miss a value for each null added
   // here.
   recordParentNullsInChildren(offset, rows);
@@ -156,6 +183,81 @@ void SelectiveStructColumnReaderBase::read(
   readOffset_ = offset + rows.back() + 1;
 }
 
+RowSet SelectiveStructColumnReaderBase::applyMultiColumnFilter(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* structNulls) {
+  auto* filter = scanSpec_->multiColumnFilter();
+  auto& names = filter->inputNames();
+  multiColumnFilterInputs_.resize(names.size());
+  std::vector<TypePtr> types;
+  types.reserve(names.size());
+  for (auto i = 0; i < names.size(); ++i) {
+    auto* childSpec = scanSpec_->childByName(names[i]);
+    VELOX_CHECK_NOT_NULL(
+        childSpec, "Input of multi column filter is not read: {}", names[i]);
+    auto& input = multiColumnFilterInputs_[i];
+    if (childSpec->isConstant()) {
+      input = BaseVector::wrapInConstant(
+          rows.size(), 0, childSpec->constantValue());
+      types.push_back(input->type());
+      continue;
+    }
+    auto* reader = children_.at(childSpec->subscript());
+    if (!childSpec->hasFilter()) {
+      advanceFieldReader(reader, offset);
+      reader->read(offset, rows, structNulls);
+    }
+    const auto& type = reader->nodeType().type;
+    if (!input || !input->type()->equivalent(*type)) {
+      input = BaseVector::create(type, 0, &memoryPool_);
+    }
+    reader->getValues(rows, &input);
+    types.push_back(type);
+  }
+  auto inputRow = std::make_shared<RowVector>(
+      &memoryPool_,
+      ROW(std::vector<std::string>(names), std::move(types)),
+      nullptr,
+      rows.size(),
+      multiColumnFilterInputs_);
+  filter->filter(inputRow, multiColumnFilterPassing_);
+  multiColumnFilterRows_.resize(rows.size());
+  std::copy(rows.begin(), rows.end(), multiColumnFilterRows_.begin());
+  passingRows_.resize(multiColumnFilterPassing_.size());
+  for (auto i = 0; i < multiColumnFilterPassing_.size(); ++i) {
+    passingRows_[i] = rows[multiColumnFilterPassing_[i]];
+  }
+  return passingRows_;
+}
+
+VectorPtr SelectiveStructColumnReaderBase::multiColumnFilterInput(
+    const std::string& name,
+    RowSet rows,
+    BufferPtr& indices) {
+  auto& names = scanSpec_->multiColumnFilter()->inputNames();
+  auto it = std::find(names.begin(), names.end(), name);
+  VELOX_CHECK(it != names.end());
+  auto& input = multiColumnFilterInputs_[it - names.begin()];
+  if (rows.size() == multiColumnFilterRows_.size()) {
+    return input;
+  }
+  if (!indices) {
+    // 'rows' is a subset of the rows the filter was evaluated on.
+    indices = allocateIndices(rows.size(), &memoryPool_);
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    vector_size_t j = 0;
+    for (auto i = 0; i < rows.size(); ++i) {
+      while (multiColumnFilterRows_[j] < rows[i]) {
+        ++j;
+      }
+      VELOX_DCHECK_EQ(multiColumnFilterRows_[j], rows[i]);
+      rawIndices[i] = j;
+    }
+  }
+  return BaseVector::wrapInDictionary(nullptr, indices, rows.size(), input);
+}
+
 void SelectiveStructColumnReaderBase::recordParentNullsInChildren(
     vector_size_t offset,
     RowSet rows) {
@@ -170,6 +272,14 @@ void SelectiveStructColumnReaderBase::recordParentNullsInChildren(
     }
     auto fieldIndex = childSpec->subscript();
     auto reader = children_.at(fieldIndex);
+    if (std::find(
+            lazyChildrenWithParentNulls_.begin(),
+            lazyChildrenWithParentNulls_.end(),
+            reader) != lazyChildrenWithParentNulls_.end()) {
+      // Recorded by catchUpLazyChildren() since 'reader' may still read
+      // from 'offset'.
+      continue;
+    }
     reader->addParentNulls(
         offset,
         nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr,
@@ -177,6 +287,24 @@ void SelectiveStructColumnReaderBase::recordParentNullsInChildren(
   }
 }
 
+void SelectiveStructColumnReaderBase::catchUpLazyChildren() {
+  if (lazyChildrenWithParentNulls_.empty()) {
+    return;
+  }
+  // The last read() covered the rows from 'lazyVectorReadOffset_' to
+  // 'readOffset_'. A child that is still before 'readOffset_' was loaded for
+  // only a part of these or not at all.
+  const vector_size_t lastRow = readOffset_ - lazyVectorReadOffset_ - 1;
+  for (auto* child : lazyChildrenWithParentNulls_) {
+    if (child->readOffset() < readOffset_) {
+      child->addParentNulls(
+          lazyVectorReadOffset_, nulls(), RowSet(&lastRow, 1));
+      child->seekTo(readOffset_, false);
+    }
+  }
+  lazyChildrenWithParentNulls_.clear();
+}
+
 namespace {
 //   Recursively makes empty RowVectors for positions in 'children'
 //   where the corresponding child type in 'rowType' is a row. The
@@ -236,6 +364,9 @@ void SelectiveStructColumnReaderBase::getValues(
     resultRow->clearNulls(0, rows.size());
   }
   bool lazyPrepared = false;
+  // Indices of 'rows' in the rows on which the multi column filter was
+  // evaluated. Made on first use.
+  BufferPtr filterInputIndices;
   auto& childSpecs = scanSpec_->children();
   for (auto i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
@@ -247,9 +378,15 @@ void SelectiveStructColumnReaderBase::getValues(
     if (childSpec->isConstant()) {
       resultRow->childAt(channel) = BaseVector::wrapInConstant(
           rows.size(), 0, childSpec->constantValue());
+    } else if (
+        scanSpec_->multiColumnFilter() &&
+        childSpec->isMultiColumnFilterInput()) {
+      // The values were read for the multi column filter.
+      resultRow->childAt(channel) = multiColumnFilterInput(
+          childSpec->fieldName(), rows, filterInputIndices);
     } else {
       if (!childSpec->extractValues() && !childSpec->hasFilter() &&
-          children_[index]->isTopLevel()) {
+          isLazyLoadable(*children_[index])) {
         // LazyVector result.
         if (!lazyPrepared) {
           if (rows.size() != outputRows_.size()) {
@@ -115,6 +115,36 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // know how much to skip when seeking forward within the row group.
   void recordParentNullsInChildren(vector_size_t offset, RowSet rows);
 
+  // Returns true if 'child' can be read into a LazyVector. Top level children
+  // are positioned independently of 'this'. The children of a top level struct
+  // with nulls are read at the position of 'this' and are brought up to it by
+  // catchUpLazyChildren() before 'this' moves.
+  bool isLazyLoadable(const SelectiveColumnReader& child) const {
+    return child.isTopLevel() || (isTopLevel_ && formatData_->hasNulls());
+  }
+
+  // Records the nulls of the last read() in the children in
+  // 'lazyChildrenWithParentNulls_' and advances the ones that were not loaded
+  // for all of its rows to 'readOffset_'. Must be called before 'this' moves
+  // past the rows of the last read().
+  void catchUpLazyChildren();
+
+  // Reads the inputs of the multi column filter of 'scanSpec_' for 'rows'
+  // and evaluates the filter. The inputs without a single column filter are
+  // read here. Returns the passing subset of 'rows'.
+  RowSet applyMultiColumnFilter(
+      vector_size_t offset,
+      RowSet rows,
+      const uint64_t* structNulls);
+
+  // Returns the values of the multi column filter input 'name' for 'rows',
+  // which is a subset of the rows the filter was evaluated on. 'indices'
+  // caches the positions of 'rows' in these between calls.
+  VectorPtr multiColumnFilterInput(
+      const std::string& name,
+      RowSet rows,
+      BufferPtr& indices);
+
   const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
 
   std::vector<SelectiveColumnReader*> children_;
@@ -125,6 +155,21 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
 
   vector_size_t lazyVectorReadOffset_;
 
+  // The children that are not top level and were left to be loaded as
+  // LazyVectors by the last read(). The nulls of 'this' are recorded in them
+  // by catchUpLazyChildren() instead of read().
+  std::vector<SelectiveColumnReader*> lazyChildrenWithParentNulls_;
+
+  // The values of the inputs of the multi column filter from the last
+  // read(), for the rows in 'multiColumnFilterRows_'.
+  std::vector<VectorPtr> multiColumnFilterInputs_;
+  raw_vector<vector_size_t> multiColumnFilterRows_;
+
+  // Positions in 'multiColumnFilterRows_' of the rows that passed the multi
+  // column filter and the corresponding rows.
+  raw_vector<vector_size_t> multiColumnFilterPassing_;
+  raw_vector<vector_size_t> passingRows_;
+
   // Dense set of rows to read in next().
   raw_vector<vector_size_t> rows_;
 
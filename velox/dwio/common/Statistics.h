@@ -529,14 +529,41 @@ struct RuntimeStatistics {
   // Number of strides (row groups) processed based on statistics.
   int64_t processedStrides{0};
 
+  // Number of strides (row groups) skipped based on Bloom filters. Included in
+  // 'skippedStrides'.
+  int64_t skippedStridesByBloomFilter{0};
+
+  // Number of strides (row groups) skipped because no value in their
+  // dictionaries passes the filter. Included in 'skippedStrides'.
+  int64_t skippedStridesByDictionary{0};
+
+  // Number of stripes whose data was not loaded because their row index
+  // statistics showed that all of their strides are skipped. Their strides
+  // are included in 'skippedStrides'.
+  int64_t skippedStripeLoads{0};
+
   std::unordered_map<std::string, RuntimeCounter> toMap() {
-    return {
+    std::unordered_map<std::string, RuntimeCounter> result = {
         {"skippedSplits", RuntimeCounter(skippedSplits)},
         {"processedSplits", RuntimeCounter(processedSplits)},
         {"skippedSplitBytes",
          RuntimeCounter(skippedSplitBytes, RuntimeCounter::Unit::kBytes)},
         {"skippedStrides", RuntimeCounter(skippedStrides)},
         {"processedStrides", RuntimeCounter(processedStrides)}};
+    if (skippedStridesByBloomFilter > 0) {
+      result.emplace(
+          "skippedStridesByBloomFilter",
+          RuntimeCounter(skippedStridesByBloomFilter));
+    }
+    if (skippedStridesByDictionary > 0) {
+      result.emplace(
+          "skippedStridesByDictionary",
+          RuntimeCounter(skippedStridesByDictionary));
+    }
+    if (skippedStripeLoads > 0) {
+      result.emplace("skippedStripeLoads", RuntimeCounter(skippedStripeLoads));
+    }
+    return result;
   }
 };
 
@@ -17,6 +17,7 @@
 #include "folly/String.h"
 #include "velox/dwio/common/exception/Exceptions.h"
 
+#include <cstring>
 #include <ios>
 #include <sstream>
 #include <string>
@@ -34,6 +35,25 @@ static const int32_t SIZE_OF_SHORT = 2;
 static const int32_t SIZE_OF_INT = 4;
 static const int32_t SIZE_OF_LONG = 8;
 
+// The width of the copies of literal runs. The compiler makes a 16 byte
+// memcpy into one unaligned vector load and store. The matches keep copying
+// a long at a time: most are short and the extra branch for a wide copy
+// costs more than it saves.
+static const int32_t SIZE_OF_WIDE = 16;
+
+// Copies 'kBytes' bytes. The ranges may not overlap.
+template <int32_t kBytes>
+inline void copyBytes(char* output, const char* input) {
+  std::memcpy(output, input, kBytes);
+}
+
+// Reads the unaligned little endian 16 bit trailer of a command.
+inline uint32_t readTrailer(const char* input) {
+  uint16_t trailer;
+  std::memcpy(&trailer, input, SIZE_OF_SHORT);
+  return trailer;
+}
+
 static std::string toHex(uint64_t val) {
   std::ostringstream out;
   out << "0x" << std::hex << val;
@@ -73,6 +93,10 @@ uint64_t lzoDecompress(
 
   // maximum offset in buffers to which it's safe to write long-at-a-time
   char* const fastOutputLimit = outputLimit - SIZE_OF_LONG;
+  // maximum offsets in buffers to which it's safe to read and write
+  // SIZE_OF_WIDE bytes at a time
+  const char* const wideInputLimit = inputLimit - SIZE_OF_WIDE;
+  char* const wideOutputLimit = outputLimit - SIZE_OF_WIDE;
 
   // LZO can concat two blocks together so, decode until the input data is
   // consumed
@@ -201,7 +225,7 @@ uint64_t lzoDecompress(
         if (input + SIZE_OF_SHORT > inputLimit) {
           throw MalformedInputException(input - inputAddress);
         }
-        uint32_t trailer = *reinterpret_cast<const uint16_t*>(input) & 0xFFFF;
+        uint32_t trailer = readTrailer(input);
         input += SIZE_OF_SHORT;
 
         // copy offset :: 16 bits :: valid range [32767..49151]
@@ -240,7 +264,7 @@ uint64_t lzoDecompress(
         if (input + SIZE_OF_SHORT > inputLimit) {
           throw MalformedInputException(input - inputAddress);
         }
-        int32_t trailer = *reinterpret_cast<const int16_t*>(input) & 0xFFFF;
+        int32_t trailer = readTrailer(input);
         input += SIZE_OF_SHORT;
 
         // copy offset :: 14 bits :: valid range [0..16383]
@@ -308,13 +332,11 @@ uint64_t lzoDecompress(
             output += SIZE_OF_INT;
             matchAddress += increment32;
 
-            *reinterpret_cast<int32_t*>(output) =
-                *reinterpret_cast<int32_t*>(matchAddress);
+            copyBytes<SIZE_OF_INT>(output, matchAddress);
             output += SIZE_OF_INT;
             matchAddress -= decrement64;
           } else {
-            *reinterpret_cast<int64_t*>(output) =
-                *reinterpret_cast<int64_t*>(matchAddress);
+            copyBytes<SIZE_OF_LONG>(output, matchAddress);
             matchAddress += SIZE_OF_LONG;
             output += SIZE_OF_LONG;
           }
@@ -325,8 +347,7 @@ uint64_t lzoDecompress(
             }
 
             while (output < fastOutputLimit) {
-              *reinterpret_cast<int64_t*>(output) =
-                  *reinterpret_cast<int64_t*>(matchAddress);
+              copyBytes<SIZE_OF_LONG>(output, matchAddress);
               matchAddress += SIZE_OF_LONG;
               output += SIZE_OF_LONG;
             }
@@ -336,8 +357,7 @@ uint64_t lzoDecompress(
             }
           } else {
             while (output < matchOutputLimit) {
-              *reinterpret_cast<int64_t*>(output) =
-                  *reinterpret_cast<int64_t*>(matchAddress);
+              copyBytes<SIZE_OF_LONG>(output, matchAddress);
               matchAddress += SIZE_OF_LONG;
               output += SIZE_OF_LONG;
             }
@@ -348,7 +368,21 @@ uint64_t lzoDecompress(
 
       // copy literal
       char* literalOutputLimit = output + literalLength;
-      if (literalOutputLimit > fastOutputLimit ||
+      if (literalOutputLimit <= wideOutputLimit &&
+          input + literalLength <= wideInputLimit) {
+        // wide copy. Most runs are shorter than SIZE_OF_WIDE and take one
+        // copy. We may over-copy but there's enough room in input and output
+        // to not overrun them
+        do {
+          copyBytes<SIZE_OF_WIDE>(output, input);
+          input += SIZE_OF_WIDE;
+          output += SIZE_OF_WIDE;
+        } while (output < literalOutputLimit);
+        // adjust index if we over-copied
+        input -= (output - literalOutputLimit);
+        output = literalOutputLimit;
+      } else if (
+          literalOutputLimit > fastOutputLimit ||
           input + literalLength > inputLimit - SIZE_OF_LONG) {
         if (literalOutputLimit > outputLimit) {
           throw MalformedInputException(input - inputAddress);
@@ -362,8 +396,7 @@ uint64_t lzoDecompress(
         // fast copy. We may over-copy but there's enough room in input
         // and output to not overrun them
         do {
-          *reinterpret_cast<int64_t*>(output) =
-              *reinterpret_cast<const int64_t*>(input);
+          copyBytes<SIZE_OF_LONG>(output, input);
           input += SIZE_OF_LONG;
           output += SIZE_OF_LONG;
         } while (output < literalOutputLimit);
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "folly/Range.h"
 #include "folly/io/IOBuf.h"
 #include "velox/dwio/common/exception/Exception.h"
@@ -89,6 +91,21 @@ class Decrypter {
   virtual std::unique_ptr<folly::IOBuf> decrypt(
       folly::StringPiece input) const = 0;
 
+  // Decrypts each of 'inputs' and returns the results in the same order. The
+  // DWRF reader passes all the chunks of a stream of a loaded stripe in one
+  // call, so that a provider with a hardware accelerated cipher, e.g. AES-CTR
+  // or AES-GCM with AES-NI or VAES, can interleave the chunks in its pipeline
+  // and set up the key schedule once. The default calls decrypt() on each.
+  virtual std::vector<std::unique_ptr<folly::IOBuf>> decryptBatch(
+      const std::vector<folly::StringPiece>& inputs) const {
+    std::vector<std::unique_ptr<folly::IOBuf>> results;
+    results.reserve(inputs.size());
+    for (const auto& input : inputs) {
+      results.push_back(decrypt(input));
+    }
+    return results;
+  }
+
   virtual std::unique_ptr<Decrypter> clone() const = 0;
 };
 
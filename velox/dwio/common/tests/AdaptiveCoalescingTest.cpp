@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/AdaptiveCoalescing.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+TEST(AdaptiveCoalescingTest, defaultsWithoutSamples) {
+  AdaptiveCoalescing coalescing;
+  EXPECT_EQ(512 << 10, coalescing.maxCoalesceDistance(512 << 10));
+  EXPECT_EQ(64 << 20, coalescing.maxCoalesceBytes(64 << 20));
+  for (auto i = 0; i < AdaptiveCoalescing::kMinSamples; ++i) {
+    // Reads of the same size do not tell latency from transfer time.
+    coalescing.recordRead(1 << 20, 2000);
+  }
+  EXPECT_EQ(512 << 10, coalescing.maxCoalesceDistance(512 << 10));
+}
+
+TEST(AdaptiveCoalescingTest, learnsFromLatency) {
+  // Storage with 5ms latency and 1GB/s, i.e. 1us per KB.
+  AdaptiveCoalescing slow;
+  // Storage with 100us latency and the same throughput.
+  AdaptiveCoalescing fast;
+  for (auto i = 0; i < 100; ++i) {
+    const uint64_t bytes = (1 + i % 10) << 20;
+    slow.recordRead(bytes, 5000 + bytes / 1024);
+    fast.recordRead(bytes, 100 + bytes / 1024);
+  }
+  EXPECT_NEAR(5000, slow.latencyUsec(), 1);
+  EXPECT_NEAR(1.0 / 1024, slow.usecPerByte(), 1e-6);
+  EXPECT_NEAR(5000 * 1024, slow.maxCoalesceDistance(0), 1000);
+  EXPECT_NEAR(8 * 5000 * 1024, slow.maxCoalesceBytes(0), 8000);
+
+  EXPECT_NEAR(100 * 1024, fast.maxCoalesceDistance(0), 1000);
+  // The IO size does not go below the minimum.
+  EXPECT_EQ(AdaptiveCoalescing::kMinIoBytes, fast.maxCoalesceBytes(0));
+}
+
+TEST(AdaptiveCoalescingTest, sharedByFileType) {
+  InMemoryReadFile file1("abc");
+  InMemoryReadFile file2("defg");
+  auto coalescing = AdaptiveCoalescing::forFile(file1);
+  EXPECT_EQ(coalescing, AdaptiveCoalescing::forFile(file2));
+}
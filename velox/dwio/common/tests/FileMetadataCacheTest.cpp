@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace {
+
+class TestMetadata : public FileMetadata {
+ public:
+  TestMetadata(uint64_t size, uint64_t unpooledBytes)
+      : size_(size), unpooledBytes_(unpooledBytes) {}
+
+  uint64_t sizeInBytes() const override {
+    return size_;
+  }
+
+  uint64_t unpooledBytes() const override {
+    return unpooledBytes_;
+  }
+
+ private:
+  const uint64_t size_;
+  const uint64_t unpooledBytes_;
+};
+
+FileMetadataKey key(const std::string& path, int64_t modificationTime = 1) {
+  return {path, 1'000, modificationTime};
+}
+
+} // namespace
+
+TEST(FileMetadataCacheTest, basic) {
+  FileMetadataCache cache(1'000);
+  ASSERT_EQ(cache.get(key("a")), nullptr);
+
+  auto a = std::make_shared<TestMetadata>(400, 100);
+  cache.put(key("a"), a);
+  ASSERT_EQ(cache.get(key("a")), a);
+  // A different version of the same file.
+  ASSERT_EQ(cache.get(key("a", 2)), nullptr);
+  ASSERT_EQ(cache.pool()->getCurrentBytes(), 100);
+
+  auto b = std::make_shared<TestMetadata>(400, 400);
+  cache.put(key("b"), b);
+  auto stats = cache.stats();
+  ASSERT_EQ(stats.numEntries, 2);
+  ASSERT_EQ(stats.numBytes, 800);
+  ASSERT_EQ(stats.numLookups, 3);
+  ASSERT_EQ(stats.numHits, 1);
+  ASSERT_EQ(cache.pool()->getCurrentBytes(), 500);
+
+  // 'a' is more recently used than 'b', so 'b' is evicted for 'c'.
+  ASSERT_EQ(cache.get(key("a")), a);
+  cache.put(key("c"), std::make_shared<TestMetadata>(300, 0));
+  ASSERT_EQ(cache.get(key("b")), nullptr);
+  ASSERT_NE(cache.get(key("c")), nullptr);
+  ASSERT_EQ(cache.stats().numBytes, 700);
+  ASSERT_EQ(cache.pool()->getCurrentBytes(), 100);
+
+  // Replacing an entry.
+  auto newA = std::make_shared<TestMetadata>(100, 50);
+  cache.put(key("a"), newA);
+  ASSERT_EQ(cache.get(key("a")), newA);
+  ASSERT_EQ(cache.stats().numBytes, 400);
+  ASSERT_EQ(cache.pool()->getCurrentBytes(), 50);
+
+  // Larger than the cache.
+  cache.put(key("d"), std::make_shared<TestMetadata>(2'000, 2'000));
+  ASSERT_EQ(cache.get(key("d")), nullptr);
+  ASSERT_EQ(cache.stats().numEntries, 2);
+
+  cache.clear();
+  ASSERT_EQ(cache.stats().numEntries, 0);
+  ASSERT_EQ(cache.stats().numBytes, 0);
+  ASSERT_EQ(cache.pool()->getCurrentBytes(), 0);
+  // Evicted entries stay valid while referenced.
+  ASSERT_EQ(a->sizeInBytes(), 400);
+}
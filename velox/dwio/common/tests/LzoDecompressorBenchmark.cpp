@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/FileUtil.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <random>
+
+#include "velox/dwio/common/compression/LzoDecompressor.h"
+#include "velox/dwio/common/exception/Exception.h"
+#include "velox/dwio/common/tests/utils/CompressionCorpus.h"
+#include "velox/dwio/common/tests/utils/LzoCompressor.h"
+
+DEFINE_string(
+    lzo_corpus,
+    "",
+    "File to benchmark in addition to the generated data, e.g. the "
+    "uncompressed bytes of a stream of a table");
+
+DEFINE_int32(
+    lzo_chunk_size,
+    256 << 10,
+    "Size of the compressed chunks, as the compression block size of a "
+    "writer");
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common::compression;
+using namespace facebook::velox::test;
+
+namespace {
+
+// The data in chunks of --lzo_chunk_size, compressed one by one.
+struct Corpus {
+  std::vector<std::string> compressed;
+  uint64_t uncompressedSize{0};
+};
+
+Corpus makeCorpus(const std::string& data) {
+  Corpus corpus;
+  for (uint64_t offset = 0; offset < data.size();
+       offset += FLAGS_lzo_chunk_size) {
+    corpus.compressed.push_back(test::lzoCompress(
+        std::string_view(data).substr(offset, FLAGS_lzo_chunk_size)));
+  }
+  corpus.uncompressedSize = data.size();
+  return corpus;
+}
+
+// Adds a benchmark that decompresses 'data' in chunks, as a reader does.
+void addBenchmark(const std::string& name, const std::string& data) {
+  auto corpus = std::make_shared<Corpus>(makeCorpus(data));
+  LOG(INFO) << name << ": " << corpus->uncompressedSize << " bytes in "
+            << corpus->compressed.size() << " chunks";
+  folly::addBenchmark(__FILE__, name, [corpus]() {
+    std::vector<char> output(FLAGS_lzo_chunk_size);
+    uint64_t size = 0;
+    for (const auto& chunk : corpus->compressed) {
+      size += lzoDecompress(
+          chunk.data(),
+          chunk.data() + chunk.size(),
+          output.data(),
+          output.data() + output.size());
+      folly::doNotOptimizeAway(output.data());
+    }
+    DWIO_ENSURE_EQ(size, corpus->uncompressedSize);
+    return 1;
+  });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  constexpr size_t kSize = 16 << 20;
+  std::mt19937 rng(1);
+  addBenchmark("text", makeText(kSize, rng));
+  addBenchmark("integers", makeIntegers(kSize, rng));
+  addBenchmark("runs", makeRuns(kSize, rng));
+  addBenchmark("random", makeRandom(kSize, rng));
+  if (!FLAGS_lzo_corpus.empty()) {
+    std::string data;
+    DWIO_ENSURE(
+        folly::readFile(FLAGS_lzo_corpus.c_str(), data),
+        "Cannot read ",
+        FLAGS_lzo_corpus);
+    addBenchmark(FLAGS_lzo_corpus, data);
+  }
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/compression/LzoDecompressor.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "velox/dwio/common/exception/Exceptions.h"
+#include "velox/dwio/common/tests/utils/CompressionCorpus.h"
+#include "velox/dwio/common/tests/utils/LzoCompressor.h"
+
+using namespace facebook::velox::dwio::common::compression;
+using namespace facebook::velox::test;
+
+namespace {
+
+void testRoundTrip(const std::string& data) {
+  SCOPED_TRACE(fmt::format("size {}", data.size()));
+  const auto compressed = lzoCompress(data);
+  // The decoder copies a long or more at a time when there is room at the end
+  // of the output.
+  for (auto slack : {0, 1, 7, 16, 100}) {
+    std::string output(data.size() + slack, 'x');
+    ASSERT_EQ(
+        data.size(),
+        lzoDecompress(
+            compressed.data(),
+            compressed.data() + compressed.size(),
+            output.data(),
+            output.data() + output.size()));
+    ASSERT_EQ(data, output.substr(0, data.size())) << "slack " << slack;
+  }
+}
+
+} // namespace
+
+TEST(LzoDecompressorTest, roundTrip) {
+  std::mt19937 rng(1);
+  for (auto size : {0, 1, 3, 4, 15, 16, 17, 31, 64, 1000, 70'000, 256'000}) {
+    testRoundTrip(makeText(size, rng));
+    testRoundTrip(makeRuns(size, rng));
+    testRoundTrip(makeRandom(size, rng));
+  }
+  for (auto i = 0; i < 300; ++i) {
+    const auto size = rng() % 300;
+    testRoundTrip(makeText(size, rng));
+    testRoundTrip(makeRuns(size, rng));
+  }
+}
+
+TEST(LzoDecompressorTest, outputTooSmall) {
+  std::mt19937 rng(1);
+  for (const auto& data : {makeText(10'000, rng), makeRandom(10'000, rng)}) {
+    const auto compressed = lzoCompress(data);
+    std::string output(data.size() - 1, 0);
+    EXPECT_THROW(
+        lzoDecompress(
+            compressed.data(),
+            compressed.data() + compressed.size(),
+            output.data(),
+            output.data() + output.size()),
+        facebook::velox::dwio::common::ParseError);
+  }
+}
+
+TEST(LzoDecompressorTest, missingEndOfStream) {
+  std::mt19937 rng(1);
+  const auto data = makeText(10'000, rng);
+  const auto compressed = lzoCompress(data);
+  std::string output(data.size(), 0);
+  // Drops the 3 byte end of stream command.
+  EXPECT_THROW(
+      lzoDecompress(
+          compressed.data(),
+          compressed.data() + compressed.size() - 3,
+          output.data(),
+          output.data() + output.size()),
+      facebook::velox::dwio::common::ParseError);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/tests/utils/CompressionCorpus.h"
+
+#include <vector>
+
+namespace facebook::velox::test {
+
+std::string makeText(size_t size, std::mt19937& rng) {
+  static const std::vector<std::string> kWords = {
+      "select", "from", "where", "customer", "lineitem", "2023-01-01",
+      "the", "of", "and", "null", "12345", "shipment"};
+  std::string text;
+  while (text.size() < size) {
+    text += kWords[rng() % kWords.size()];
+    text += rng() % 5 == 0 ? '\n' : ' ';
+  }
+  text.resize(size);
+  return text;
+}
+
+std::string makeIntegers(size_t size, std::mt19937& rng) {
+  std::string data;
+  int64_t value = 1'000'000;
+  while (data.size() < size) {
+    value += rng() % 100;
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  data.resize(size);
+  return data;
+}
+
+std::string makeRuns(size_t size, std::mt19937& rng) {
+  std::string data;
+  while (data.size() < size) {
+    std::string pattern(1 + rng() % 12, 0);
+    for (auto& c : pattern) {
+      c = 'a' + rng() % 26;
+    }
+    const auto length = 4 + rng() % 200;
+    for (auto i = 0; i < length; ++i) {
+      data.push_back(pattern[i % pattern.size()]);
+    }
+  }
+  data.resize(size);
+  return data;
+}
+
+std::string makeRandom(size_t size, std::mt19937& rng) {
+  std::string data(size, 0);
+  for (auto& c : data) {
+    c = rng();
+  }
+  return data;
+}
+
+} // namespace facebook::velox::test
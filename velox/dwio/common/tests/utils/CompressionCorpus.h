@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <random>
+#include <string>
+
+namespace facebook::velox::test {
+
+/// Generators of data with the match patterns of column streams, for the
+/// tests and benchmarks of compression codecs. Each returns 'size' bytes.
+
+/// Words of a text column, so that most matches are short and far back.
+std::string makeText(size_t size, std::mt19937& rng);
+
+/// Slowly increasing 64 bit integers, as the plain values of a sorted column.
+std::string makeIntegers(size_t size, std::mt19937& rng);
+
+/// Repeats of short patterns, so that the matches overlap their output.
+std::string makeRuns(size_t size, std::mt19937& rng);
+
+/// Incompressible bytes, so that the data is in long literal runs.
+std::string makeRandom(size_t size, std::mt19937& rng);
+
+} // namespace facebook::velox::test
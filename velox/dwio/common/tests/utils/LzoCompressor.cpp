@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/tests/utils/LzoCompressor.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace facebook::velox::test {
+namespace {
+
+constexpr int32_t kHashBits = 14;
+constexpr int32_t kMinMatch = 4;
+
+// The largest match offset of the 2 byte (M2) and 3 byte (M3) commands.
+constexpr uint64_t kMaxM2Offset = 2048;
+constexpr uint64_t kMaxM3Offset = 16384;
+constexpr uint64_t kMaxM2Length = 8;
+
+// The longest literal run that the first command encodes in one byte.
+constexpr uint64_t kMaxFirstLiteral = 238;
+
+uint32_t load32(const char* data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint32_t hash(uint32_t value) {
+  return (value * 2654435761U) >> (32 - kHashBits);
+}
+
+// Appends the variable length part of a length that does not fit the bits of
+// its command: a zero byte per 255 and a non-zero remainder.
+void appendLength(uint64_t extra, std::string& out) {
+  while (extra > 255) {
+    out.push_back(0);
+    extra -= 255;
+  }
+  out.push_back(static_cast<char>(extra));
+}
+
+class Compressor {
+ public:
+  explicit Compressor(std::string_view input) : input_(input) {}
+
+  std::string compress() {
+    std::vector<int64_t> table(1 << kHashBits, -1);
+    uint64_t literalStart = 0;
+    uint64_t pos = 0;
+    while (pos + kMinMatch <= input_.size()) {
+      const auto value = load32(input_.data() + pos);
+      auto& entry = table[hash(value)];
+      const auto candidate = entry;
+      entry = pos;
+      if (candidate < 0 || pos - candidate > kMaxM3Offset ||
+          load32(input_.data() + candidate) != value) {
+        ++pos;
+        continue;
+      }
+      uint64_t length = kMinMatch;
+      while (pos + length < input_.size() &&
+             input_[candidate + length] == input_[pos + length]) {
+        ++length;
+      }
+      appendLiterals(literalStart, pos);
+      appendMatch(pos - candidate, length);
+      pos += length;
+      literalStart = pos;
+    }
+    appendLiterals(literalStart, input_.size());
+    // The end of stream command.
+    out_.append("\x11\x00\x00", 3);
+    return std::move(out_);
+  }
+
+ private:
+  void appendLiterals(uint64_t begin, uint64_t end) {
+    const auto length = end - begin;
+    if (length == 0) {
+      return;
+    }
+    if (out_.empty() && length <= kMaxFirstLiteral) {
+      out_.push_back(static_cast<char>(17 + length));
+    } else if (!out_.empty() && length <= 3) {
+      // Up to 3 literals go in the low bits of the preceding match.
+      out_[literalBitsIndex_] |= static_cast<char>(length);
+    } else if (length - 3 <= 15) {
+      out_.push_back(static_cast<char>(length - 3));
+    } else {
+      out_.push_back(0);
+      appendLength(length - 3 - 15, out_);
+    }
+    out_.append(input_.data() + begin, length);
+  }
+
+  void appendMatch(uint64_t offset, uint64_t length) {
+    if (offset <= kMaxM2Offset && length <= kMaxM2Length) {
+      // 0bMMMP_PPLL 0bPPPP_PPPP
+      literalBitsIndex_ = out_.size();
+      out_.push_back(static_cast<char>(
+          ((length - 1) << 5) | (((offset - 1) & 7) << 2)));
+      out_.push_back(static_cast<char>((offset - 1) >> 3));
+      return;
+    }
+    // 0b001M_MMMM (0bMMMM_MMMM)* 0bPPPP_PPPP_PPPP_PPLL
+    if (length - 2 <= 31) {
+      out_.push_back(static_cast<char>(0x20 | (length - 2)));
+    } else {
+      out_.push_back(0x20);
+      appendLength(length - 2 - 31, out_);
+    }
+    const auto trailer = (offset - 1) << 2;
+    literalBitsIndex_ = out_.size();
+    out_.push_back(static_cast<char>(trailer & 0xff));
+    out_.push_back(static_cast<char>(trailer >> 8));
+  }
+
+  const std::string_view input_;
+  std::string out_;
+
+  // The byte of the last match that has the number of literals after it.
+  uint64_t literalBitsIndex_{0};
+};
+
+} // namespace
+
+std::string lzoCompress(std::string_view input) {
+  return Compressor(input).compress();
+}
+
+} // namespace facebook::velox::test
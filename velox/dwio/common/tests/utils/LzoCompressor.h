@@ -13,28 +13,18 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#pragma once
 
-#include "velox/dwio/common/Common.h"
+#include <string>
+#include <string_view>
 
-#include <folly/Conv.h>
+namespace facebook::velox::test {
 
-namespace facebook::velox::dwio::common {
+/// Compresses 'input' into one LZO1X block that lzoDecompress() decodes.
+/// Greedy matching over a hash of 4 byte prefixes, with the short and
+/// medium distance match commands. The ratio is below liblzo but the output
+/// has the literal runs and the short and overlapping matches that the
+/// decoder sees in files, so that tests and benchmarks do not need liblzo.
+std::string lzoCompress(std::string_view input);
 
-std::string compressionKindToString(CompressionKind kind) {
-  switch (static_cast<int32_t>(kind)) {
-    case CompressionKind_NONE:
-      return "none";
-    case CompressionKind_ZLIB:
-      return "zlib";
-    case CompressionKind_SNAPPY:
-      return "snappy";
-    case CompressionKind_LZO:
-      return "lzo";
-    case CompressionKind_ZSTD:
-      return "zstd";
-    case CompressionKind_LZ4:
-      return "lz4";
-  }
-  return folly::to<std::string>("unknown - ", kind);
-}
-} // namespace facebook::velox::dwio::common
+} // namespace facebook::velox::test
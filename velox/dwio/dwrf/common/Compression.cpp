@@ -16,11 +16,13 @@
 
 #include "velox/dwio/dwrf/common/Compression.h"
 
+#include "velox/common/process/ProcessBase.h"
 #include "velox/dwio/common/Common.h"
 #include "velox/dwio/common/compression/LzoDecompressor.h"
 #include "velox/dwio/common/exception/Exception.h"
 #include "velox/dwio/dwrf/common/PagedInputStream.h"
 #include "velox/dwio/dwrf/common/PagedOutputStream.h"
+#include "velox/dwio/dwrf/common/ParallelDecompressionStream.h"
 
 #include <folly/logging/xlog.h>
 #include <lz4.h>
@@ -338,8 +340,9 @@ class ZlibDecompressionStream : public PagedInputStream,
       std::unique_ptr<dwio::common::SeekableInputStream> inStream,
       uint64_t blockSize,
       MemoryPool& pool,
-      const std::string& streamDebugInfo)
-      : PagedInputStream{std::move(inStream), pool, streamDebugInfo},
+      const std::string& streamDebugInfo,
+      const DecompressionOptions& options)
+      : PagedInputStream{std::move(inStream), pool, streamDebugInfo, options},
         ZlibDecompressor{blockSize, streamDebugInfo} {}
   ~ZlibDecompressionStream() override = default;
 
@@ -383,6 +386,7 @@ bool ZlibDecompressionStream::Next(const void** data, int32_t* size) {
         ZlibDecompressor::streamDebugInfo_);
     prepareOutputBuffer(getUncompressedLength(inputBufferPtr_, availSize));
 
+    DecompressionTimer timer(decompressionOptions_);
     reset();
     zstream_.next_in =
         reinterpret_cast<Bytef*>(const_cast<char*>(inputBufferPtr_));
@@ -431,8 +435,50 @@ bool ZlibDecompressionStream::Next(const void** data, int32_t* size) {
   return true;
 }
 
+std::unique_ptr<Decompressor> makeDecompressor(
+    dwio::common::CompressionKind kind,
+    uint64_t blockSize,
+    const std::string& streamDebugInfo) {
+  switch (static_cast<int64_t>(kind)) {
+    case dwio::common::CompressionKind_ZLIB:
+      return std::make_unique<ZlibDecompressor>(blockSize, streamDebugInfo);
+    case dwio::common::CompressionKind_SNAPPY:
+      return std::make_unique<SnappyDecompressor>(blockSize, streamDebugInfo);
+    case dwio::common::CompressionKind_LZO:
+      return std::make_unique<LzoDecompressor>(blockSize, streamDebugInfo);
+    case dwio::common::CompressionKind_LZ4:
+      return std::make_unique<Lz4Decompressor>(blockSize, streamDebugInfo);
+    case dwio::common::CompressionKind_ZSTD:
+      return std::make_unique<ZstdDecompressor>(blockSize, streamDebugInfo);
+    default:
+      DWIO_RAISE("Unknown compression codec ", kind);
+  }
+}
+
 } // namespace
 
+DecompressionTimer::DecompressionTimer(const DecompressionOptions& options)
+    : stats_(options.stats),
+      nodeId_(options.nodeId),
+      startNanos_(stats_ ? process::threadCpuNanos() : 0) {}
+
+DecompressionTimer::~DecompressionTimer() {
+  if (stats_) {
+    stats_->incDecompression(nodeId_, process::threadCpuNanos() - startNanos_);
+  }
+}
+
+DecryptionTimer::DecryptionTimer(const DecompressionOptions& options)
+    : stats_(options.stats),
+      nodeId_(options.nodeId),
+      startNanos_(stats_ ? process::threadCpuNanos() : 0) {}
+
+DecryptionTimer::~DecryptionTimer() {
+  if (stats_) {
+    stats_->incDecryption(nodeId_, process::threadCpuNanos() - startNanos_);
+  }
+}
+
 std::unique_ptr<BufferedOutputStream> createCompressor(
     dwio::common::CompressionKind kind,
     CompressionBufferPool& bufferPool,
@@ -479,50 +525,40 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     uint64_t blockSize,
     MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const Decrypter* decrypter) {
+    const Decrypter* decrypter,
+    const DecompressionOptions& options) {
   std::unique_ptr<Decompressor> decompressor;
-  switch (static_cast<int64_t>(kind)) {
-    case dwio::common::CompressionKind_NONE:
-      if (!decrypter) {
-        return input;
-      }
-      // decompressor remain as nullptr
-      break;
-    case dwio::common::CompressionKind_ZLIB:
-      if (!decrypter) {
-        // When file is not encrypted, we can use zlib streaming codec to avoid
-        // copying data
-        return std::make_unique<ZlibDecompressionStream>(
-            std::move(input), blockSize, pool, streamDebugInfo);
-      }
-      decompressor =
-          std::make_unique<ZlibDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case dwio::common::CompressionKind_SNAPPY:
-      decompressor =
-          std::make_unique<SnappyDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case dwio::common::CompressionKind_LZO:
-      decompressor =
-          std::make_unique<LzoDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case dwio::common::CompressionKind_LZ4:
-      decompressor =
-          std::make_unique<Lz4Decompressor>(blockSize, streamDebugInfo);
-      break;
-    case dwio::common::CompressionKind_ZSTD:
-      decompressor =
-          std::make_unique<ZstdDecompressor>(blockSize, streamDebugInfo);
-      break;
-    default:
-      DWIO_RAISE("Unknown compression codec ", kind);
+  if (kind == dwio::common::CompressionKind_NONE && !decrypter) {
+    return input;
+  } else if (options.executor) {
+    // With no compression all the chunks are original and 'makeDecompressor'
+    // is not called.
+    return std::make_unique<ParallelDecompressionStream>(
+        std::move(input),
+        pool,
+        [kind, blockSize, streamDebugInfo]() {
+          return makeDecompressor(kind, blockSize, streamDebugInfo);
+        },
+        decrypter,
+        options,
+        streamDebugInfo);
+  } else if (kind == dwio::common::CompressionKind_NONE) {
+    // decompressor remain as nullptr
+  } else if (!decrypter && kind == dwio::common::CompressionKind_ZLIB) {
+    // When file is not encrypted, we can use zlib streaming codec to avoid
+    // copying data
+    return std::make_unique<ZlibDecompressionStream>(
+        std::move(input), blockSize, pool, streamDebugInfo, options);
+  } else {
+    decompressor = makeDecompressor(kind, blockSize, streamDebugInfo);
   }
   return std::make_unique<PagedInputStream>(
       std::move(input),
       pool,
       std::move(decompressor),
       decrypter,
-      streamDebugInfo);
+      streamDebugInfo,
+      options);
 }
 
 } // namespace facebook::velox::dwrf
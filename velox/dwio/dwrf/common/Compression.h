@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+
 #include "velox/dwio/common/Common.h"
+#include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/CompressionBufferPool.h"
@@ -65,12 +68,55 @@ class Decompressor {
   const std::string streamDebugInfo_;
 };
 
+/// Options for the decompression of a stream.
+struct DecompressionOptions {
+  /// If set, the stream reads all its compression chunks at its first read
+  /// and decompresses them in parallel on this executor. The chunks are
+  /// returned in order as they are ready. The chunks of an encrypted stream
+  /// are decrypted in one Decrypter::decryptBatch() call before.
+  folly::Executor* executor{nullptr};
+
+  /// If set, the CPU time of decompressing and decrypting the stream is added
+  /// to this for the column with 'nodeId'.
+  dwio::common::IoStatistics* stats{nullptr};
+
+  uint32_t nodeId{0};
+};
+
+/// Adds the CPU time of the calling thread between construction and
+/// destruction to the decompression time in 'options' if 'options' has stats.
+class DecompressionTimer {
+ public:
+  explicit DecompressionTimer(const DecompressionOptions& options);
+
+  ~DecompressionTimer();
+
+ private:
+  dwio::common::IoStatistics* const stats_;
+  const uint32_t nodeId_;
+  const uint64_t startNanos_;
+};
+
+/// Like DecompressionTimer for the decryption time in 'options'.
+class DecryptionTimer {
+ public:
+  explicit DecryptionTimer(const DecompressionOptions& options);
+
+  ~DecryptionTimer();
+
+ private:
+  dwio::common::IoStatistics* const stats_;
+  const uint32_t nodeId_;
+  const uint64_t startNanos_;
+};
+
 /**
  * Create a decompressor for the given compression kind.
  * @param kind the compression type to implement
  * @param input the input stream that is the underlying source
  * @param bufferSize the maximum size of the buffer
  * @param pool the memory pool
+ * @param options the executor for parallel decompression and the stats
  */
 std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     dwio::common::CompressionKind kind,
@@ -78,7 +124,8 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     uint64_t bufferSize,
     memory::MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const dwio::common::encryption::Decrypter* decryptr = nullptr);
+    const dwio::common::encryption::Decrypter* decryptr = nullptr,
+    const DecompressionOptions& options = {});
 
 /**
  * Create a compressor for the given compression kind.
@@ -105,6 +105,19 @@ Config::Entry<uint32_t> Config::ENTROPY_STRING_THRESHOLD{
     "hive.exec.orc.entropy.string.threshold",
     20};
 
+// If not 0, the string dictionary encoding is re-evaluated at every stripe
+// instead of only at the first one. After the dictionary is abandoned, it is
+// retried after this many stripes, doubling the interval on each failed retry.
+Config::Entry<uint32_t> Config::STRING_DICTIONARY_REEVALUATION_STRIPES{
+    "orc.dictionary.string.reevaluation.stripes",
+    0};
+
+// The max number of the most frequent keys of a stripe's string dictionary
+// that are kept to seed the dictionary of the next stripe.
+Config::Entry<uint32_t> Config::STRING_DICTIONARY_SEED_KEYS{
+    "orc.dictionary.string.seed.keys",
+    0};
+
 Config::Entry<uint32_t> Config::STRING_STATS_LIMIT(
     "hive.orc.string.stats.limit",
     64);
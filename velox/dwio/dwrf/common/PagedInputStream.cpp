@@ -152,6 +152,7 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
 
   // perform decryption
   if (decrypter_) {
+    DecryptionTimer timer(decompressionOptions_);
     decryptionBuffer_ =
         decrypter_->decrypt(folly::StringPiece{input, remainingLength_});
     input = reinterpret_cast<const char*>(decryptionBuffer_->data());
@@ -166,6 +167,7 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
     DWIO_ENSURE_NOT_NULL(decompressor_.get(), "invalid stream state");
     prepareOutputBuffer(
         decompressor_->getUncompressedLength(input, remainingLength_));
+    DecompressionTimer timer(decompressionOptions_);
     outputBufferLength_ = decompressor_->decompress(
         input,
         remainingLength_,
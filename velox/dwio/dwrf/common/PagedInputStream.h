@@ -28,12 +28,14 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
       memory::MemoryPool& memPool,
       std::unique_ptr<Decompressor> decompressor,
       const dwio::common::encryption::Decrypter* decrypter,
-      const std::string& streamDebugInfo)
+      const std::string& streamDebugInfo,
+      const DecompressionOptions& decompressionOptions = {})
       : input_(std::move(inStream)),
         pool_(memPool),
         inputBuffer_(pool_),
         decompressor_{std::move(decompressor)},
         decrypter_{decrypter},
+        decompressionOptions_{decompressionOptions},
         streamDebugInfo_{streamDebugInfo} {
     DWIO_ENSURE(
         decompressor_ || decrypter_,
@@ -71,12 +73,14 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
   PagedInputStream(
       std::unique_ptr<SeekableInputStream> inStream,
       memory::MemoryPool& memPool,
-      const std::string& streamDebugInfo)
+      const std::string& streamDebugInfo,
+      const DecompressionOptions& decompressionOptions)
       : input_(std::move(inStream)),
         pool_(memPool),
         inputBuffer_(pool_),
         decompressor_{nullptr},
         decrypter_{nullptr},
+        decompressionOptions_{decompressionOptions},
         streamDebugInfo_{streamDebugInfo} {}
 
   void prepareOutputBuffer(uint64_t uncompressedLength);
@@ -148,6 +152,9 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
   // decrypter
   const dwio::common::encryption::Decrypter* decrypter_;
 
+  // The stats of the decompression. The executor is not used.
+  const DecompressionOptions decompressionOptions_;
+
  private:
   // Stream Debug Info
   const std::string streamDebugInfo_;
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/ParallelDecompressionStream.h"
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+ParallelDecompressionStream::ParallelDecompressionStream(
+    std::unique_ptr<SeekableInputStream> input,
+    memory::MemoryPool& pool,
+    std::function<std::unique_ptr<Decompressor>()> makeDecompressor,
+    const dwio::common::encryption::Decrypter* decrypter,
+    const DecompressionOptions& options,
+    const std::string& streamDebugInfo)
+    : input_(std::move(input)),
+      pool_(pool),
+      makeDecompressor_(std::move(makeDecompressor)),
+      decrypter_(decrypter),
+      options_(options),
+      streamDebugInfo_(streamDebugInfo),
+      compressed_(pool_) {
+  VELOX_CHECK_NOT_NULL(options_.executor);
+}
+
+ParallelDecompressionStream::~ParallelDecompressionStream() {
+  cancelled_ = true;
+  for (auto& chunk : chunks_) {
+    if (chunk.source) {
+      try {
+        chunk.source->move();
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Error decompressing in " << getName() << ": "
+                     << e.what();
+      }
+    }
+  }
+}
+
+void ParallelDecompressionStream::start() {
+  started_ = true;
+  const uint64_t startOffset = input_->ByteCount();
+  uint64_t size = 0;
+  const void* data;
+  int32_t length;
+  while (input_->Next(&data, &length)) {
+    compressed_.append(size, static_cast<const char*>(data), length, 2);
+    size += length;
+  }
+
+  for (uint64_t offset = 0; offset < size;) {
+    DWIO_ENSURE_LE(
+        offset + PAGE_HEADER_SIZE, size, getName(), ", read past EOF");
+    const auto* header =
+        reinterpret_cast<const uint8_t*>(compressed_.data() + offset);
+    const uint32_t value = header[0] | (header[1] << 8) | (header[2] << 16);
+    Chunk chunk;
+    chunk.offset = startOffset + offset;
+    chunk.input = compressed_.data() + offset + PAGE_HEADER_SIZE;
+    chunk.inputSize = value >> 1;
+    // An empty chunk has no bytes to decompress.
+    chunk.original = (value & 1) || chunk.inputSize == 0;
+    offset += PAGE_HEADER_SIZE + chunk.inputSize;
+    DWIO_ENSURE_LE(offset, size, getName(), ", read past EOF");
+    chunks_.push_back(std::move(chunk));
+  }
+
+  if (decrypter_) {
+    decryptChunks();
+  }
+
+  for (auto i = 0; i < chunks_.size(); ++i) {
+    if (chunks_[i].original) {
+      continue;
+    }
+    chunks_[i].source = std::make_shared<AsyncSource<Decompressed>>(
+        [this, i]() { return decompress(i, nullptr); });
+    options_.executor->add(
+        [source = chunks_[i].source]() { source->prepare(); });
+  }
+}
+
+void ParallelDecompressionStream::decryptChunks() {
+  std::vector<int32_t> indices;
+  std::vector<folly::StringPiece> inputs;
+  for (auto i = 0; i < chunks_.size(); ++i) {
+    if (chunks_[i].inputSize > 0) {
+      indices.push_back(i);
+      inputs.emplace_back(chunks_[i].input, chunks_[i].inputSize);
+    }
+  }
+  if (inputs.empty()) {
+    return;
+  }
+  std::vector<std::unique_ptr<folly::IOBuf>> decrypted;
+  {
+    DecryptionTimer timer(options_);
+    decrypted = decrypter_->decryptBatch(inputs);
+  }
+  DWIO_ENSURE_EQ(
+      decrypted.size(), inputs.size(), "Decrypted chunks in ", getName());
+  for (auto i = 0; i < indices.size(); ++i) {
+    auto& chunk = chunks_[indices[i]];
+    chunk.decrypted = std::move(decrypted[i]);
+    chunk.input = reinterpret_cast<const char*>(chunk.decrypted->data());
+    chunk.inputSize = chunk.decrypted->length();
+  }
+}
+
+std::unique_ptr<ParallelDecompressionStream::Decompressed>
+ParallelDecompressionStream::decompress(
+    int32_t index,
+    Decompressor* decompressor) {
+  if (cancelled_) {
+    return nullptr;
+  }
+  const auto& chunk = chunks_[index];
+  DecompressionTimer timer(options_);
+  std::unique_ptr<Decompressor> ownDecompressor;
+  if (!decompressor) {
+    ownDecompressor = makeDecompressor_();
+    decompressor = ownDecompressor.get();
+  }
+  auto result = std::make_unique<Decompressed>(
+      pool_,
+      decompressor->getUncompressedLength(chunk.input, chunk.inputSize));
+  result->size = decompressor->decompress(
+      chunk.input,
+      chunk.inputSize,
+      result->data.data(),
+      result->data.capacity());
+  return result;
+}
+
+void ParallelDecompressionStream::setChunk(int32_t index) {
+  if (index == chunkIndex_) {
+    position_ = 0;
+    return;
+  }
+  if (chunkIndex_ >= 0 && chunkIndex_ < chunks_.size()) {
+    chunks_[chunkIndex_].decompressed.reset();
+  }
+  chunkIndex_ = index;
+  position_ = 0;
+  if (index == chunks_.size()) {
+    window_ = nullptr;
+    windowSize_ = 0;
+    return;
+  }
+  auto& chunk = chunks_[index];
+  if (chunk.original) {
+    window_ = chunk.input;
+    windowSize_ = chunk.inputSize;
+    return;
+  }
+  if (chunk.source) {
+    // Waits for the executor or decompresses here if not started.
+    chunk.decompressed = chunk.source->move();
+    chunk.source.reset();
+    DWIO_ENSURE_NOT_NULL(
+        chunk.decompressed.get(), "Missing chunk in ", getName());
+  } else {
+    if (!decompressor_) {
+      decompressor_ = makeDecompressor_();
+    }
+    chunk.decompressed = decompress(index, decompressor_.get());
+  }
+  window_ = chunk.decompressed->data.data();
+  windowSize_ = chunk.decompressed->size;
+}
+
+bool ParallelDecompressionStream::Next(const void** data, int32_t* size) {
+  if (UNLIKELY(!started_)) {
+    start();
+  }
+  while (chunkIndex_ < 0 || position_ == windowSize_) {
+    if (chunkIndex_ + 1 >= static_cast<int32_t>(chunks_.size())) {
+      return false;
+    }
+    setChunk(chunkIndex_ + 1);
+  }
+  *data = window_ + position_;
+  *size = static_cast<int32_t>(windowSize_ - position_);
+  position_ = windowSize_;
+  bytesReturned_ += *size;
+  return true;
+}
+
+void ParallelDecompressionStream::BackUp(int32_t count) {
+  DWIO_ENSURE(
+      count >= 0 && static_cast<uint64_t>(count) <= position_,
+      "Backup past start of chunk in ",
+      getName());
+  position_ -= count;
+  bytesReturned_ -= count;
+}
+
+bool ParallelDecompressionStream::Skip(int32_t count) {
+  while (count > 0) {
+    const void* data;
+    int32_t size;
+    if (!Next(&data, &size)) {
+      return false;
+    }
+    if (size > count) {
+      BackUp(size - count);
+      count = 0;
+    } else {
+      count -= size;
+    }
+  }
+  return true;
+}
+
+void ParallelDecompressionStream::seekToPosition(
+    dwio::common::PositionProvider& positionProvider) {
+  const auto compressedOffset = positionProvider.next();
+  const auto uncompressedOffset = positionProvider.next();
+  if (!started_) {
+    start();
+  }
+  auto it = std::lower_bound(
+      chunks_.begin(),
+      chunks_.end(),
+      compressedOffset,
+      [](const Chunk& chunk, uint64_t offset) {
+        return chunk.offset < offset;
+      });
+  DWIO_ENSURE(
+      it == chunks_.end() || it->offset == compressedOffset,
+      "Seek to ",
+      compressedOffset,
+      " is not at a chunk in ",
+      getName());
+  setChunk(it - chunks_.begin());
+  DWIO_ENSURE(
+      Skip(uncompressedOffset), "Seek past end of chunk in ", getName());
+}
+
+std::string ParallelDecompressionStream::getName() const {
+  return folly::to<std::string>(
+      "ParallelDecompressionStream StreamInfo (",
+      streamDebugInfo_,
+      ") input stream (",
+      input_->getName(),
+      ") chunk (",
+      chunkIndex_,
+      " of ",
+      chunks_.size(),
+      ")");
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "velox/common/base/AsyncSource.h"
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/common/encryption/Encryption.h"
+#include "velox/dwio/dwrf/common/Compression.h"
+
+namespace facebook::velox::dwrf {
+
+// Stream over the compression chunks of a compressed stream that
+// decompresses all the chunks ahead of their use. At the first read, the
+// input is read to its end, which is in memory after the stripe is loaded,
+// and each compressed chunk is decompressed on the executor of the
+// DecompressionOptions. The chunks are returned in order. A chunk that is not
+// ready when it is reached is decompressed on the calling thread or waited
+// for. The buffer of a chunk is freed when the stream moves past it. Seeking
+// back to a freed chunk decompresses it again on the calling thread.
+//
+// If the stream is encrypted, all its chunks are decrypted in one
+// Decrypter::decryptBatch() call at the first read, before their
+// decompression starts. The decrypted chunks are kept for the life of the
+// stream.
+class ParallelDecompressionStream : public dwio::common::SeekableInputStream {
+ public:
+  ParallelDecompressionStream(
+      std::unique_ptr<SeekableInputStream> input,
+      memory::MemoryPool& pool,
+      std::function<std::unique_ptr<Decompressor>()> makeDecompressor,
+      const dwio::common::encryption::Decrypter* decrypter,
+      const DecompressionOptions& options,
+      const std::string& streamDebugInfo);
+
+  // Waits for the chunks that are being decompressed on the executor.
+  ~ParallelDecompressionStream() override;
+
+  bool Next(const void** data, int32_t* size) override;
+
+  void BackUp(int32_t count) override;
+
+  bool Skip(int32_t count) override;
+
+  google::protobuf::int64 ByteCount() const override {
+    return bytesReturned_;
+  }
+
+  void seekToPosition(dwio::common::PositionProvider& position) override;
+
+  std::string getName() const override;
+
+  size_t positionSize() override {
+    // Compressed position of the chunk + uncompressed position in the chunk.
+    return 2;
+  }
+
+ private:
+  struct Decompressed {
+    Decompressed(memory::MemoryPool& pool, uint64_t capacity)
+        : data(pool, capacity) {}
+
+    dwio::common::DataBuffer<char> data;
+    uint64_t size{0};
+  };
+
+  struct Chunk {
+    // Offset of the header of the chunk in 'input_'.
+    uint64_t offset;
+
+    // The bytes of the chunk after the header in 'compressed_' or in
+    // 'decrypted' if the stream is encrypted.
+    const char* input;
+    uint32_t inputSize;
+
+    // The decrypted bytes of the chunk if the stream is encrypted.
+    std::unique_ptr<folly::IOBuf> decrypted;
+
+    // True if the chunk is stored uncompressed.
+    bool original;
+
+    // Decompresses the chunk on the executor. Set for compressed chunks until
+    // its result is taken.
+    std::shared_ptr<AsyncSource<Decompressed>> source;
+
+    // The decompressed bytes while the chunk is current.
+    std::unique_ptr<Decompressed> decompressed;
+  };
+
+  // Reads the input and starts the decompression of its chunks.
+  void start();
+
+  // Decrypts all the non-empty chunks in one call.
+  void decryptChunks();
+
+  // Returns the decompressed bytes of the chunk at 'index' or nullptr if the
+  // stream is being destroyed. Decompresses with 'decompressor' or with a new
+  // decompressor if nullptr. The decompressors keep state and cannot be
+  // shared between threads.
+  std::unique_ptr<Decompressed> decompress(
+      int32_t index,
+      Decompressor* decompressor);
+
+  // Makes the chunk at 'index' current and positions at its start. 'index'
+  // is the number of chunks at the end of the stream.
+  void setChunk(int32_t index);
+
+  const std::unique_ptr<SeekableInputStream> input_;
+  memory::MemoryPool& pool_;
+  const std::function<std::unique_ptr<Decompressor>()> makeDecompressor_;
+  const dwio::common::encryption::Decrypter* const decrypter_;
+  const DecompressionOptions options_;
+  const std::string streamDebugInfo_;
+
+  // Decompresses the chunks that are seeked back to on the calling thread.
+  // Made at first use, since a stream with no compressed chunks has no
+  // decompressor.
+  std::unique_ptr<Decompressor> decompressor_;
+
+  bool started_{false};
+
+  // Set on destruction so that the pending chunks are not decompressed.
+  std::atomic<bool> cancelled_{false};
+
+  // The input read to its end.
+  dwio::common::DataBuffer<char> compressed_;
+
+  std::vector<Chunk> chunks_;
+
+  // The current chunk. -1 before the first read.
+  int32_t chunkIndex_{-1};
+
+  // The bytes of the current chunk.
+  const char* window_{nullptr};
+  uint64_t windowSize_{0};
+
+  // The position of the next byte to return in 'window_'.
+  uint64_t position_{0};
+
+  uint64_t bytesReturned_{0};
+};
+
+} // namespace facebook::velox::dwrf
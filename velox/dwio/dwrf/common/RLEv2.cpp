@@ -923,7 +923,8 @@ RleDecoderV2<isSigned>::RleDecoderV2(
       patchMask(0),
       actualGap(0),
       unpacked(pool, 0),
-      unpackedPatch(pool, 0) {
+      unpackedPatch(pool, 0),
+      decodedValues(pool, 0) {
   // PASS
 }
 
@@ -1301,7 +1302,20 @@ uint64_t RleDecoderV2<isSigned>::nextDelta(
     ++runRead;
   }
 
-  if (bitSize == 0) {
+  if (bitSize == 0 && !nulls) {
+    // Without nulls, the values of a fixed delta run do not depend on each
+    // other.
+    const uint64_t begin = pos;
+    const uint64_t end = offset + nRead;
+    for (; pos < end; ++pos) {
+      data[pos] =
+          prevValue + static_cast<int64_t>(pos - begin + 1) * deltaBase;
+    }
+    if (end > begin) {
+      prevValue = data[end - 1];
+      runRead += end - begin;
+    }
+  } else if (bitSize == 0) {
     // add fixed deltas to adjacent values
     for (; pos < offset + nRead; ++pos) {
       // skip null positions
@@ -16,10 +16,13 @@
 
 #pragma once
 
+#include <folly/lang/Bits.h>
+
 #include "velox/common/base/Nulls.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/Adaptor.h"
 #include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/common/DecoderUtil.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/exception/Exception.h"
 #include "velox/dwio/dwrf/common/IntEncoder.h"
@@ -416,6 +419,12 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
 
   template <bool hasNulls, typename Visitor>
   void readWithVisitor(const uint64_t* nulls, Visitor visitor) {
+    // The reader prepares its nulls for the fast path only if it has one.
+    if (dwio::common::useFastPath<Visitor, hasNulls>(visitor) &&
+        visitor.reader().hasBulkPath()) {
+      fastPath<hasNulls>(nulls, visitor);
+      return;
+    }
     int32_t current = visitor.start();
     skip<hasNulls>(current, 0, nulls);
 
@@ -454,6 +463,112 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
   }
 
  private:
+  template <bool hasNulls, typename Visitor>
+  void fastPath(const uint64_t* nulls, Visitor& visitor) {
+    constexpr bool hasFilter =
+        !std::is_same_v<typename Visitor::FilterType, common::AlwaysTrue>;
+    constexpr bool hasHook =
+        !std::is_same_v<typename Visitor::HookType, dwio::common::NoHook>;
+    auto rows = visitor.rows();
+    auto numRows = visitor.numRows();
+    auto rowsAsRange = folly::Range<const int32_t*>(rows, numRows);
+    if (hasNulls) {
+      raw_vector<int32_t>* innerVector = nullptr;
+      auto outerVector = &visitor.outerNonNullRows();
+      if (Visitor::dense) {
+        dwio::common::nonNullRowsFromDense(nulls, numRows, *outerVector);
+        if (outerVector->empty()) {
+          visitor.setAllNull(hasFilter ? 0 : numRows);
+          return;
+        }
+        bulkScan<hasFilter, hasHook, true>(
+            folly::Range<const int32_t*>(rows, outerVector->size()),
+            outerVector->data(),
+            visitor);
+      } else {
+        innerVector = &visitor.innerNonNullRows();
+        int32_t tailSkip = -1;
+        auto anyNulls = dwio::common::nonNullRowsFromSparse < hasFilter,
+             !hasFilter &&
+            !hasHook >
+                (nulls,
+                 rowsAsRange,
+                 *innerVector,
+                 *outerVector,
+                 (hasFilter || hasHook) ? nullptr : visitor.rawNulls(numRows),
+                 tailSkip);
+        if (anyNulls) {
+          visitor.setHasNulls();
+        }
+        if (innerVector->empty()) {
+          skip<false>(tailSkip, 0, nullptr);
+          visitor.setAllNull(hasFilter ? 0 : numRows);
+          return;
+        }
+        bulkScan<hasFilter, hasHook, true>(
+            *innerVector, outerVector->data(), visitor);
+        skip<false>(tailSkip, 0, nullptr);
+      }
+    } else {
+      bulkScan<hasFilter, hasHook, false>(rowsAsRange, nullptr, visitor);
+    }
+  }
+
+  // Decodes the values at 'nonNullRows' in blocks of up to kBulkSize
+  // consecutive values and passes each block to the visitor, which tests the
+  // filter on the whole block at a time.
+  template <bool hasFilter, bool hasHook, bool scatter, typename Visitor>
+  void bulkScan(
+      folly::Range<const int32_t*> nonNullRows,
+      const int32_t* scatterRows,
+      Visitor& visitor) {
+    constexpr int32_t kBulkSize = 1024;
+    auto numAllRows = visitor.numRows();
+    visitor.setRows(nonNullRows);
+    auto rows = visitor.rows();
+    auto numRows = visitor.numRows();
+    auto values = visitor.rawValues(numRows);
+    auto filterHits = hasFilter ? visitor.outputRows(numRows) : nullptr;
+    int32_t numValues = 0;
+    int32_t rowIndex = 0;
+    int32_t currentRow = 0;
+    decodedValues.reserve(kBulkSize);
+    while (rowIndex < numRows) {
+      skip(rows[rowIndex] - currentRow);
+      currentRow = rows[rowIndex];
+      int32_t numDecoded =
+          std::min<int32_t>(kBulkSize, rows[numRows - 1] - currentRow + 1);
+      next(decodedValues.data(), numDecoded, nullptr);
+      int32_t numInBlock = 0;
+      if (Visitor::dense) {
+        numInBlock = numDecoded;
+        for (auto i = 0; i < numDecoded; ++i) {
+          values[numValues + i] =
+              static_cast<typename Visitor::DataType>(decodedValues[i]);
+        }
+      } else {
+        const int32_t endRow = currentRow + numDecoded;
+        for (; rowIndex + numInBlock < numRows &&
+             rows[rowIndex + numInBlock] < endRow;
+             ++numInBlock) {
+          values[numValues + numInBlock] =
+              static_cast<typename Visitor::DataType>(
+                  decodedValues[rows[rowIndex + numInBlock] - currentRow]);
+        }
+      }
+      currentRow += numDecoded;
+      visitor.template processRun<hasFilter, hasHook, scatter>(
+          values + numValues,
+          numInBlock,
+          scatterRows,
+          filterHits,
+          values,
+          numValues);
+      rowIndex += numInBlock;
+    }
+    visitor.setNumValues(hasFilter ? numValues : numAllRows);
+  }
+
   // Used by PATCHED_BASE
   void adjustGapAndPatch() {
     curGap = static_cast<uint64_t>(unpackedPatch[patchIdx]) >> patchBitSize;
@@ -504,6 +619,37 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
   }
 
   int64_t readLongBE(uint64_t bsz);
+
+  // Unpacks the big endian bit packed values of 'fb' bits that start at a
+  // byte boundary and lie entirely in the current buffer, one unaligned 64
+  // bit load per value. Returns the number of values unpacked. Leaves the
+  // partially read last byte in 'curByte'.
+  uint64_t unpackFromBuffer(int64_t* data, uint64_t len, uint64_t fb) {
+    auto& bufferStart = dwio::common::IntDecoder<isSigned>::bufferStart;
+    const uint64_t available =
+        dwio::common::IntDecoder<isSigned>::bufferEnd - bufferStart;
+    if (available < sizeof(uint64_t)) {
+      return 0;
+    }
+    const uint64_t numValues =
+        std::min(len, (available - sizeof(uint64_t)) * 8 / fb + 1);
+    const auto* input = reinterpret_cast<const uint8_t*>(bufferStart);
+    const auto shift = 64 - fb;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      const auto bit = i * fb;
+      const auto word = folly::Endian::big(
+          folly::loadUnaligned<uint64_t>(input + (bit >> 3)));
+      data[i] = static_cast<int64_t>((word << (bit & 7)) >> shift);
+    }
+    const auto numBits = numValues * fb;
+    bufferStart += numBits >> 3;
+    if (numBits & 7) {
+      curByte = static_cast<unsigned char>(*bufferStart++);
+      bitsLeft = 8 - (numBits & 7);
+    }
+    return numValues;
+  }
+
   uint64_t readLongs(
       int64_t* data,
       uint64_t offset,
@@ -511,8 +657,14 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
       uint64_t fb,
       const uint64_t* nulls = nullptr) {
     uint64_t ret = 0;
+    // The bit widths of RLEv2 are at most 56 bits or exactly 64, so that a
+    // value starting at any bit of a byte fits in a 64 bit word.
+    if (!nulls && bitsLeft == 0 && fb != 0 && (fb <= 56 || fb == 64)) {
+      ret = unpackFromBuffer(data + offset, len, fb);
+      offset += ret;
+      len -= ret;
+    }
 
-    // TODO: unroll to improve performance
     for (uint64_t i = offset; i < (offset + len); i++) {
       // skip null positions
       if (nulls && bits::isBitNull(nulls, i)) {
@@ -582,6 +734,7 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
   int64_t actualGap; // Used by PATCHED_BASE
   dwio::common::DataBuffer<int64_t> unpacked; // Used by PATCHED_BASE
   dwio::common::DataBuffer<int64_t> unpackedPatch; // Used by PATCHED_BASE
+  dwio::common::DataBuffer<int64_t> decodedValues; // Used by readWithVisitor
 };
 
 } // namespace facebook::velox::dwrf
@@ -84,6 +84,10 @@ DwrfRowReader::DwrfRowReader(
       *getReader().getSchema(), *columnSelector_, createExceptionContext);
 }
 
+DwrfRowReader::~DwrfRowReader() {
+  clearPreparedStripes();
+}
+
 uint64_t DwrfRowReader::seekToRow(uint64_t rowNumber) {
   // Empty file
   if (isEmptyFile()) {
@@ -131,7 +135,10 @@ uint64_t DwrfRowReader::seekToRow(uint64_t rowNumber) {
   newStripeLoaded = false;
   startNextStripe();
 
-  if (selectiveColumnReader_) {
+  if (stripeDataSkipped_) {
+    // No row of the stripe passes the filters and its data is not loaded.
+    currentRowInStripe = rowsInCurrentStripe;
+  } else if (selectiveColumnReader_) {
     selectiveColumnReader_->skip(currentRowInStripe);
   } else {
     columnReader_->skip(currentRowInStripe);
@@ -303,48 +310,158 @@ void DwrfRowReader::startNextStripe() {
     return;
   }
 
+  if (prepareStripesAhead()) {
+    startPreparedStripe();
+    return;
+  }
+
+  // The readers of the previous stripe reference the stripe footer and input
+  // of 'this', which are replaced by loading the next stripe.
+  columnReader_.reset();
+  selectiveColumnReader_.reset();
+  setPreparedStripe(prepareStripe(*this, currentStripe));
+}
+
+void DwrfRowReader::setPreparedStripe(
+    std::unique_ptr<PreparedStripe> prepared) {
+  columnReader_ = std::move(prepared->columnReader);
+  selectiveColumnReader_ = std::move(prepared->selectiveColumnReader);
+  if (prepared->stripeReader) {
+    currentStripeReader_ = std::move(prepared->stripeReader);
+  }
+  rowsInCurrentStripe = prepared->numRows;
+  stripeDictionaryCache_ = std::move(prepared->dictionaryCache);
+  stripeDataSkipped_ = prepared->dataSkipped;
+  if (stripeDataSkipped_) {
+    ++skippedStripeLoads_;
+  }
+  newStripeLoaded = true;
+}
+
+std::unique_ptr<DwrfRowReader::PreparedStripe> DwrfRowReader::prepareStripe(
+    StripeReaderBase& stripeReader,
+    uint32_t stripe) const {
+  auto prepared = std::make_unique<PreparedStripe>();
   bool preload = options_.getPreloadStripe();
-  auto currentStripeInfo = loadStripe(currentStripe, preload);
-  rowsInCurrentStripe = currentStripeInfo.numberOfRows();
+  auto stripeInfo = stripeReader.loadStripe(stripe, preload);
+  prepared->numRows = stripeInfo.numberOfRows();
 
   StripeStreamsImpl stripeStreams(
-      *this,
+      stripeReader,
       getColumnSelector(),
       options_,
-      currentStripeInfo.offset(),
+      stripeInfo.offset(),
       *this,
-      currentStripe);
+      stripe);
 
   // Create column reader
-  columnReader_.reset();
-  selectiveColumnReader_.reset();
   auto scanSpec = options_.getScanSpec().get();
   auto requestedType = getColumnSelector().getSchemaWithId();
   auto dataType = getReader().getSchemaWithId();
   auto flatMapContext = FlatMapContext::nonFlatMapContext();
 
   if (scanSpec) {
-    selectiveColumnReader_ = SelectiveDwrfReader::build(
+    prepared->selectiveColumnReader = SelectiveDwrfReader::build(
         requestedType, dataType, stripeStreams, scanSpec, flatMapContext);
-    selectiveColumnReader_->setIsTopLevel();
+    prepared->selectiveColumnReader->setIsTopLevel();
   } else {
-    columnReader_ = ColumnReader::build(
+    prepared->columnReader = ColumnReader::build(
         requestedType, dataType, stripeStreams, flatMapContext);
   }
   DWIO_ENSURE(
-      (columnReader_ != nullptr) != (selectiveColumnReader_ != nullptr),
+      (prepared->columnReader != nullptr) !=
+          (prepared->selectiveColumnReader != nullptr),
       "ColumnReader was not created");
 
   // load data plan according to its updated selector
   // during column reader construction
   // if planReads is off which means stripe data loaded as whole
-  if (!preload) {
-    VLOG(1) << "[DWRF] Load read plan for stripe " << currentStripe;
+  if (!preload && prepared->selectiveColumnReader &&
+      allRowGroupsFiltered(
+          stripeReader,
+          stripe,
+          prepared->numRows,
+          *prepared->selectiveColumnReader)) {
+    // All the row groups are skipped before reading any data, so only the
+    // index streams from the stripe metadata cache are needed.
+    VLOG(1) << "[DWRF] Skip loading the data of stripe " << stripe;
+    prepared->dataSkipped = true;
+  } else if (!preload) {
+    VLOG(1) << "[DWRF] Load read plan for stripe " << stripe;
     stripeStreams.loadReadPlan();
   }
 
-  stripeDictionaryCache_ = stripeStreams.getStripeDictionaryCache();
-  newStripeLoaded = true;
+  prepared->dictionaryCache = stripeStreams.getStripeDictionaryCache();
+  return prepared;
+}
+
+void DwrfRowReader::startPreparedStripe() {
+  // After a seek the stripes prepared ahead may not be the ones needed.
+  if (!preparedStripes_.empty() &&
+      preparedStripes_.front().first != currentStripe) {
+    clearPreparedStripes();
+  }
+  const auto lastScheduled = preparedStripes_.empty()
+      ? currentStripe
+      : preparedStripes_.back().first + 1;
+  // Schedule the current stripe and 'stripeParallelism' stripes after it.
+  const auto endStripe = std::min<uint64_t>(
+      lastStripe,
+      static_cast<uint64_t>(currentStripe) + 1 +
+          options_.getStripeParallelism());
+  auto* executor = options_.getDecodingExecutor().get();
+  auto readerBase = readerBaseShared();
+  for (auto stripe = lastScheduled; stripe < endStripe; ++stripe) {
+    preparedStripes_.emplace_back(
+        stripe, folly::via(executor, [this, readerBase, stripe]() {
+          auto stripeReader = std::make_unique<StripeReaderBase>(readerBase);
+          auto prepared = prepareStripe(*stripeReader, stripe);
+          prepared->stripeReader = std::move(stripeReader);
+          return prepared;
+        }));
+  }
+
+  auto future = std::move(preparedStripes_.front().second);
+  preparedStripes_.pop_front();
+  // The readers of the previous stripe reference the previous stripe reader.
+  setPreparedStripe(std::move(future).get());
+}
+
+bool DwrfRowReader::allRowGroupsFiltered(
+    StripeReaderBase& stripeReader,
+    uint32_t stripe,
+    uint64_t numRows,
+    dwio::common::SelectiveColumnReader& reader) const {
+  auto& readerBase = stripeReader.getReader();
+  const auto strideSize = readerBase.getFooter().rowIndexStride();
+  auto& metadataFilter = options_.getMetadataFilter();
+  if (strideSize == 0 || numRows == 0 ||
+      (!options_.getScanSpec()->hasFilter() && !metadataFilter)) {
+    return false;
+  }
+  // Reading the row index from the stripe input would need a load of its own.
+  auto& metadataCache = readerBase.getMetadataCache();
+  if (!metadataCache || !metadataCache->has(StripeCacheMode::INDEX, stripe)) {
+    return false;
+  }
+  StatsContext context(
+      readerBase.getWriterName(), readerBase.getWriterVersion());
+  DwrfData::FilterRowGroupsResult res;
+  reader.filterRowGroups(strideSize, context, res);
+  if (metadataFilter) {
+    metadataFilter->eval(res.metadataFilterResults, res.filterResult);
+  }
+  const auto numStrides = bits::roundUp(numRows, strideSize) / strideSize;
+  return res.totalCount >= numStrides &&
+      bits::isAllSet(res.filterResult.data(), 0, numStrides);
+}
+
+void DwrfRowReader::clearPreparedStripes() {
+  // The preparation references 'this', so wait for it to finish.
+  for (auto& [stripe, future] : preparedStripes_) {
+    future.wait();
+  }
+  preparedStripes_.clear();
 }
 
 size_t DwrfRowReader::estimatedReaderMemory() const {
@@ -480,7 +597,9 @@ DwrfReader::DwrfReader(
           options.getDirectorySizeGuess(),
           options.getFilePreloadThreshold(),
           options.getFileFormat() == FileFormat::ORC ? FileFormat::ORC
-                                                     : FileFormat::DWRF)),
+                                                     : FileFormat::DWRF,
+          options.fileMetadataCache(),
+          options.fileMetadataKey())),
       options_(options) {}
 
 std::unique_ptr<StripeInformation> DwrfReader::getStripe(
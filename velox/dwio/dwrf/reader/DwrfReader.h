@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <deque>
+
+#include <folly/futures/Future.h>
+
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/dwrf/reader/ColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveDwrfReader.h"
@@ -35,6 +39,8 @@ class DwrfRowReader : public StrideIndexProvider,
       const std::shared_ptr<ReaderBase>& reader,
       const dwio::common::RowReaderOptions& options);
 
+  ~DwrfRowReader() override;
+
   ~DwrfRowReader() override = default;
 
   // Select the columns from the options object
@@ -87,6 +93,7 @@ class DwrfRowReader : public StrideIndexProvider,
   void updateRuntimeStats(
       dwio::common::RuntimeStatistics& stats) const override {
     stats.skippedStrides += skippedStrides_;
+    stats.skippedStripeLoads += skippedStripeLoads_;
   }
 
   void resetFilterCaches() override;
@@ -109,6 +116,53 @@ class DwrfRowReader : public StrideIndexProvider,
   void startNextStripe();
 
  private:
+  // A stripe whose footer is read and whose column readers are created,
+  // possibly on the decoding executor ahead of use.
+  struct PreparedStripe {
+    // Owns the stripe footer and the input the column readers read from.
+    std::unique_ptr<StripeReaderBase> stripeReader;
+    uint64_t numRows{0};
+    std::unique_ptr<ColumnReader> columnReader;
+    std::unique_ptr<dwio::common::SelectiveColumnReader> selectiveColumnReader;
+    std::shared_ptr<StripeDictionaryCache> dictionaryCache;
+    // True if the data streams are not loaded because no row group can pass
+    // the filters.
+    bool dataSkipped{false};
+  };
+
+  // True if stripes are prepared ahead of use on the decoding executor.
+  bool prepareStripesAhead() const {
+    return options_.getStripeParallelism() > 0 &&
+        options_.getDecodingExecutor() != nullptr;
+  }
+
+  // Loads 'stripe' with 'stripeReader' and creates its column readers. Called
+  // on the decoding executor for stripes prepared ahead, so this must not
+  // modify 'this'.
+  std::unique_ptr<PreparedStripe> prepareStripe(
+      StripeReaderBase& stripeReader,
+      uint32_t stripe) const;
+
+  // Returns true if the row index of 'stripe' is in the stripe metadata cache
+  // and its statistics show that none of the 'numRows' rows can pass the
+  // filters of 'reader'. The data streams of such a stripe need not be loaded,
+  // since all of its row groups are skipped.
+  bool allRowGroupsFiltered(
+      StripeReaderBase& stripeReader,
+      uint32_t stripe,
+      uint64_t numRows,
+      dwio::common::SelectiveColumnReader& reader) const;
+
+  // Takes the readers of 'prepared' for 'currentStripe'.
+  void setPreparedStripe(std::unique_ptr<PreparedStripe> prepared);
+
+  // Takes the readers of 'currentStripe' from 'preparedStripes_' and
+  // schedules the preparation of the following stripes.
+  void startPreparedStripe();
+
+  // Waits for and drops the stripes being prepared.
+  void clearPreparedStripes();
+
   // footer
   std::vector<uint64_t> firstRowOfStripe;
   mutable std::shared_ptr<const dwio::common::TypeWithId> selectedSchema;
@@ -130,12 +184,23 @@ class DwrfRowReader : public StrideIndexProvider,
 
   std::unique_ptr<ColumnReader> columnReader_;
   std::unique_ptr<dwio::common::SelectiveColumnReader> selectiveColumnReader_;
+  // The stripe reader of 'currentStripe' if it was prepared ahead. Its
+  // footer and input are referenced by the column readers.
+  std::unique_ptr<StripeReaderBase> currentStripeReader_;
+  // Stripes being prepared on the decoding executor, in stripe order.
+  std::deque<
+      std::pair<uint32_t, folly::Future<std::unique_ptr<PreparedStripe>>>>
+      preparedStripes_;
   const uint64_t* stridesToSkip_;
   int stridesToSkipSize_;
   // Record of strides to skip in each visited stripe. Used for diagnostics.
   std::unordered_map<uint32_t, std::vector<uint64_t>> stripeStridesToSkip_;
   // Number of skipped strides.
   int64_t skippedStrides_{0};
+  // True if the data streams of 'currentStripe' are not loaded.
+  bool stripeDataSkipped_{false};
+  // Number of stripes whose data streams were not loaded.
+  int64_t skippedStripeLoads_{0};
 
   // Set to true after clearing filter caches, i.e.  adding a dynamic
   // filter. Causes filters to be re-evaluated against stride stats on
@@ -92,19 +92,63 @@ ReaderBase::ReaderBase(
     std::shared_ptr<DecrypterFactory> decryptorFactory,
     uint64_t directorySizeGuess,
     uint64_t filePreloadThreshold,
-    FileFormat fileFormat)
+    FileFormat fileFormat,
+    dwio::common::FileMetadataCache* metadataCache,
+    const std::optional<dwio::common::FileMetadataKey>& metadataKey)
     : pool_{pool},
       arena_(std::make_unique<google::protobuf::Arena>()),
       decryptorFactory_(decryptorFactory),
       directorySizeGuess_(directorySizeGuess),
       filePreloadThreshold_(filePreloadThreshold),
       input_(std::move(input)) {
-  // read last bytes into buffer to get PostScript
-  // If file is small, load the entire file.
-  // TODO: make a config
   fileLength_ = input_->getReadFile()->size();
   DWIO_ENSURE(fileLength_ > 0, "ORC file is empty");
 
+  std::shared_ptr<const DwrfFileMetadata> cached;
+  if (metadataCache != nullptr) {
+    VELOX_CHECK(metadataKey.has_value());
+    cached = std::dynamic_pointer_cast<const DwrfFileMetadata>(
+        metadataCache->get(*metadataKey));
+  }
+  if (cached != nullptr) {
+    postScript_ = cached->postScript;
+    footer_ = cached->footer;
+    schema_ = cached->schema;
+    psLength_ = cached->psLength;
+    if (cached->stripeCache != nullptr) {
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(), *footer_, cached->stripeCache);
+    }
+    metadata_ = std::move(cached);
+  } else {
+    readTail(
+        fileFormat, metadataCache, metadataCache ? &*metadataKey : nullptr);
+  }
+
+  if (!cache_ && input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripesSize();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
+           stripe.footerLength()});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+void ReaderBase::readTail(
+    FileFormat fileFormat,
+    dwio::common::FileMetadataCache* metadataCache,
+    const dwio::common::FileMetadataKey* metadataKey) {
+  // read last bytes into buffer to get PostScript
+  // If file is small, load the entire file.
+  // TODO: make a config
   auto preloadFile = fileLength_ <= filePreloadThreshold_;
   uint64_t readSize =
       preloadFile ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
@@ -163,18 +207,25 @@ ReaderBase::ReaderBase(
     input_->load(LogType::FOOTER);
   }
 
+  // A cached footer outlives 'this', so it may not be in 'arena_'.
+  std::shared_ptr<google::protobuf::Arena> footerArena;
+  auto* arena = arena_.get();
+  if (metadataCache != nullptr) {
+    footerArena = std::make_shared<google::protobuf::Arena>();
+    arena = footerArena.get();
+  }
   auto footerStream = input_->read(
       fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
   if (fileFormat == FileFormat::DWRF) {
     auto footer =
-        google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+        google::protobuf::Arena::CreateMessage<proto::Footer>(arena);
     ProtoUtils::readProtoInto<proto::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
     footer_ = std::make_unique<FooterWrapper>(footer);
   } else {
-    auto footer = google::protobuf::Arena::CreateMessage<proto::orc::Footer>(
-        arena_.get());
+    auto footer =
+        google::protobuf::Arena::CreateMessage<proto::orc::Footer>(arena);
     ProtoUtils::readProtoInto<proto::orc::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
@@ -185,39 +236,41 @@ ReaderBase::ReaderBase(
   DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
 
   // load stripe index/footer cache
+  std::shared_ptr<dwio::common::DataBuffer<char>> cacheBuffer;
   if (cacheSize > 0) {
     DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
-    if (input_->shouldPrefetchStripes()) {
+    if (input_->shouldPrefetchStripes() && metadataCache == nullptr) {
       cache_ = std::make_unique<StripeMetadataCache>(
           postScript_->cacheMode(),
           *footer_,
           input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
       input_->load(LogType::FOOTER);
     } else {
-      auto cacheBuffer =
-          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+      cacheBuffer = std::make_shared<dwio::common::DataBuffer<char>>(
+          metadataCache != nullptr ? *metadataCache->pool() : pool_,
+          cacheSize);
       input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
           ->readFully(cacheBuffer->data(), cacheSize);
       cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
+          postScript_->cacheMode(), *footer_, cacheBuffer);
     }
   }
 
-  if (!cache_ && input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripesSize();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
-           stripe.footerLength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
+  if (metadataCache != nullptr) {
+    auto metadata = std::make_shared<DwrfFileMetadata>();
+    metadata->arena = std::move(footerArena);
+    metadata->postScript = postScript_;
+    metadata->footer = footer_;
+    metadata->schema = schema_;
+    metadata->psLength = psLength_;
+    if (cacheBuffer != nullptr) {
+      metadata->pool = metadataCache->pool();
+      metadata->stripeCache = std::move(cacheBuffer);
     }
+    metadataCache->put(*metadataKey, metadata);
+    metadata_ = std::move(metadata);
   }
 
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
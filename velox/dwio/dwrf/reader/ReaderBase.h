@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/common/TypeWithId.h"
@@ -56,6 +57,31 @@ class FooterStatisticsImpl : public dwio::common::Statistics {
   }
 };
 
+/// The parsed tail of a DWRF or ORC file, shared by the readers of the file
+/// through a dwio::common::FileMetadataCache.
+struct DwrfFileMetadata : public dwio::common::FileMetadata {
+  // Holds 'footer'.
+  std::shared_ptr<google::protobuf::Arena> arena;
+  std::shared_ptr<PostScript> postScript;
+  std::shared_ptr<FooterWrapper> footer;
+  RowTypePtr schema;
+  uint64_t psLength{0};
+  // The pool of 'stripeCache'. Declared before it to be destroyed after it.
+  std::shared_ptr<memory::MemoryPool> pool;
+  // The stripe index and footer cache of the file, allocated from the pool
+  // of the metadata cache. Null if the file has none.
+  std::shared_ptr<dwio::common::DataBuffer<char>> stripeCache;
+
+  uint64_t sizeInBytes() const override {
+    return unpooledBytes() +
+        (stripeCache != nullptr ? stripeCache->capacity() : 0);
+  }
+
+  uint64_t unpooledBytes() const override {
+    return arena->SpaceAllocated() + psLength;
+  }
+};
+
 class ReaderBase {
  public:
   // create reader base from buffered input
@@ -68,7 +94,10 @@ class ReaderBase {
           dwio::common::ReaderOptions::kDefaultDirectorySizeGuess,
       uint64_t filePreloadThreshold =
           dwio::common::ReaderOptions::kDefaultFilePreloadThreshold,
-      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF);
+      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF,
+      dwio::common::FileMetadataCache* metadataCache = nullptr,
+      const std::optional<dwio::common::FileMetadataKey>& metadataKey =
+          std::nullopt);
 
   ReaderBase(
       memory::MemoryPool& pool,
@@ -196,14 +225,16 @@ class ReaderBase {
   std::unique_ptr<dwio::common::SeekableInputStream> createDecompressedStream(
       std::unique_ptr<dwio::common::SeekableInputStream> compressed,
       const std::string& streamDebugInfo,
-      const dwio::common::encryption::Decrypter* decrypter = nullptr) const {
+      const dwio::common::encryption::Decrypter* decrypter = nullptr,
+      const DecompressionOptions& decompressionOptions = {}) const {
     return createDecompressor(
         getCompressionKind(),
         std::move(compressed),
         getCompressionBlockSize(),
         pool_,
         streamDebugInfo,
-        decrypter);
+        decrypter,
+        decompressionOptions);
   }
 
   template <typename T>
@@ -225,14 +256,24 @@ class ReaderBase {
   }
 
  private:
+  // Reads and parses the post script, the footer and the stripe metadata
+  // cache of the file. Adds them to 'metadataCache' if not null.
+  void readTail(
+      dwio::common::FileFormat fileFormat,
+      dwio::common::FileMetadataCache* metadataCache,
+      const dwio::common::FileMetadataKey* metadataKey);
+
   static std::shared_ptr<const Type> convertType(
       const FooterWrapper& footer,
       uint32_t index = 0);
 
   memory::MemoryPool& pool_;
   std::unique_ptr<google::protobuf::Arena> arena_;
-  std::unique_ptr<PostScript> postScript_;
-  std::unique_ptr<FooterWrapper> footer_ = nullptr;
+  std::shared_ptr<PostScript> postScript_;
+  std::shared_ptr<FooterWrapper> footer_ = nullptr;
+  // Set if the post script and footer are shared through a metadata cache.
+  // Keeps their arena alive.
+  std::shared_ptr<const DwrfFileMetadata> metadata_;
   std::unique_ptr<StripeMetadataCache> cache_;
   // Keeps factory alive for possibly async prefetch.
   std::shared_ptr<dwio::common::encryption::DecrypterFactory> decryptorFactory_;
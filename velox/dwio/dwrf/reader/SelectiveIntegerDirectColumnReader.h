@@ -97,8 +97,8 @@ class SelectiveIntegerDirectColumnReader
     if (format_ == velox::dwrf::DwrfFormat::kDwrf) {
       return true;
     } else {
-      // TODO: zuochunwei, need support useBulkPath() for kOrc
-      return false;
+      // TODO: zuochunwei, need support useBulkPath() for kOrc with RLEv1
+      return rleVersion_ == velox::dwrf::RleVersion_2;
     }
   }
 
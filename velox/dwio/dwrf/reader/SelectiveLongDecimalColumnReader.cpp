@@ -18,6 +18,7 @@
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/dwrf/common/DecoderUtil.h"
 #include "velox/dwio/dwrf/reader/SelectiveShortDecimalColumnReader.h"
+#include "velox/type/DecimalUtil.h"
 
 namespace facebook::velox::dwrf {
 
@@ -88,27 +89,27 @@ void SelectiveLongDecimalColumnReader::getValues(
                             : rawResultNulls_)
       : nullptr;
 
-  auto decimalValues =
-      AlignedBuffer::allocate<UnscaledLongDecimal>(numValues_, &memoryPool_);
-  auto rawDecimalValues = decimalValues->asMutable<UnscaledLongDecimal>();
-
   auto scales = scaleBuffer_->as<int64_t>();
-  auto values = values_->as<int128_t>();
-
-  // transfer to UnscaledLongDecimal
+  // UnscaledLongDecimal has the layout of int128_t, so the values are rescaled
+  // in place. Values that are already at the scale of the type, which is the
+  // common case, are left as is.
+  static_assert(sizeof(UnscaledLongDecimal) == sizeof(int128_t));
+  auto values = values_->asMutable<int128_t>();
   for (vector_size_t i = 0; i < numValues_; i++) {
-    if (!nullsPtr || !bits::isBitNull(nullsPtr, i)) {
-      int32_t currentScale = scales[i];
-      int128_t value = values[i];
-
-      scaleInt128(value, scale_, currentScale);
-
-      rawDecimalValues[i] = UnscaledLongDecimal(value);
+    const int32_t currentScale = scales[i];
+    if (currentScale == scale_ ||
+        (nullsPtr && bits::isBitNull(nullsPtr, i))) {
+      continue;
+    }
+    const auto scaleDifference = std::abs(currentScale - scale_);
+    if (scaleDifference > LongDecimalType::kMaxPrecision) {
+      scaleInt128(values[i], scale_, currentScale);
+    } else if (currentScale < scale_) {
+      values[i] *= DecimalUtil::kPowersOfTen[scaleDifference];
+    } else {
+      values[i] /= DecimalUtil::kPowersOfTen[scaleDifference];
     }
   }
-
-  values_ = decimalValues;
-  rawValues_ = values_->asMutable<char>();
   getFlatValues<UnscaledLongDecimal, UnscaledLongDecimal>(
       rows, result, type_, true);
 }
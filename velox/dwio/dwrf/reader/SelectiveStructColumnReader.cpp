@@ -65,6 +65,7 @@ void SelectiveStructColumnReaderBase::seekTo(
   if (offset == readOffset_) {
     return;
   }
+  catchUpLazyChildren();
   if (readOffset_ < offset) {
     if (numParentNulls_) {
       VELOX_CHECK_LE(
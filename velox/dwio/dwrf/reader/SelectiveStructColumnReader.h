@@ -42,6 +42,8 @@ class SelectiveStructColumnReaderBase
 
   void seekToRowGroup(uint32_t index) override {
     SelectiveColumnReader::seekToRowGroup(index);
+    // The children are repositioned below.
+    lazyChildrenWithParentNulls_.clear();
     if (isTopLevel_ && !formatData_->hasNulls()) {
       readOffset_ = index * rowsPerRowGroup_;
       return;
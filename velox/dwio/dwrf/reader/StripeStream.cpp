@@ -331,10 +331,17 @@ std::unique_ptr<dwio::common::SeekableInputStream> StripeStreamsImpl::getStream(
 
   auto streamDebugInfo =
       fmt::format("Stripe {} Stream {}", stripeIndex_, si.toString());
+  DecompressionOptions decompressionOptions;
+  if (opts_.getParallelDecompression() && !isIndexStream(si.kind())) {
+    decompressionOptions.executor = opts_.getDecodingExecutor().get();
+  }
+  decompressionOptions.stats = opts_.getIoStatistics().get();
+  decompressionOptions.nodeId = si.encodingKey().node;
   return reader_.getReader().createDecompressedStream(
       std::move(streamRead),
       streamDebugInfo,
-      getDecrypter(si.encodingKey().node));
+      getDecrypter(si.encodingKey().node),
+      decompressionOptions);
 }
 
 uint32_t StripeStreamsImpl::visitStreamsOfNode(
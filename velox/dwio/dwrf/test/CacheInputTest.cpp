@@ -18,12 +18,14 @@
 #include <folly/container/F14Map.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include "velox/common/caching/FileIds.h"
+#include "velox/common/caching/SharedCacheTier.h"
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 #include <gtest/gtest.h>
+#include <map>
 
 using namespace facebook::velox;
 using namespace facebook::velox::dwio;
@@ -87,6 +89,57 @@ class TestReadFile : public ReadFile {
   IoStatisticsPtr ioStats_;
 };
 
+// In-memory SharedCacheTier that stores the entries offered to it.
+class TestSharedTier : public SharedCacheTier {
+ public:
+  bool read(
+      std::string_view fileName,
+      uint64_t offset,
+      uint64_t size,
+      const std::vector<folly::Range<char*>>& buffers) override {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = data_.find(std::make_pair(std::string(fileName), offset));
+    if (it == data_.end() || it->second.size() < size) {
+      return false;
+    }
+    uint64_t copied = 0;
+    for (auto& buffer : buffers) {
+      memcpy(buffer.data(), it->second.data() + copied, buffer.size());
+      copied += buffer.size();
+    }
+    return true;
+  }
+
+  void write(const std::vector<CachePin>& pins) override {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& pin : pins) {
+      auto* entry = pin.checkedEntry();
+      std::string bytes;
+      if (entry->tinyData()) {
+        bytes.assign(entry->tinyData(), entry->size());
+      } else {
+        for (auto i = 0; i < entry->data().numRuns(); ++i) {
+          auto run = entry->data().runAt(i);
+          bytes.append(
+              run.data<char>(),
+              std::min<uint64_t>(run.numBytes(), entry->size() - bytes.size()));
+        }
+      }
+      data_[std::make_pair(
+          fileIds().string(entry->key().fileNum.id()), entry->offset())] =
+          std::move(bytes);
+    }
+  }
+
+  std::string toString() const override {
+    return fmt::format("<TestSharedTier {} entries>", data_.size());
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::pair<std::string, uint64_t>, std::string> data_;
+};
+
 class CacheTest : public testing::Test {
  protected:
   static constexpr int32_t kMaxStreams = 50;
@@ -513,6 +566,54 @@ TEST_F(CacheTest, bufferedInput) {
   readLoop("testfile2", 30, 70, 70, 20, 4, ioStats_);
 }
 
+TEST_F(CacheTest, prewarm) {
+  initializeCache(64 << 20);
+  uint64_t fileId;
+  uint64_t groupId;
+  auto file = inputByPath("test_for_prewarm", fileId, groupId);
+  auto stripe = makeStripeData(file, 10, nullptr, fileId, groupId, 0, ioStats_);
+  auto loads = stripe->input->prewarm();
+  EXPECT_FALSE(loads.empty());
+  for (auto& load : loads) {
+    folly::SemiFuture<bool> wait(false);
+    if (!load->loadOrFuture(&wait)) {
+      std::move(wait).wait();
+    }
+  }
+  uint64_t totalBytes = 0;
+  for (auto& region : stripe->regions) {
+    EXPECT_TRUE(cache_->exists(RawFileCacheKey{fileId, region.offset}));
+    totalBytes += region.length;
+  }
+  EXPECT_EQ(totalBytes, ioStats_->read().sum());
+
+  // Reading the prewarmed streams does no IO.
+  for (auto i = 0; i < stripe->streams.size(); ++i) {
+    readStream(*stripe, i);
+  }
+  EXPECT_EQ(totalBytes, ioStats_->read().sum());
+  EXPECT_LT(0, ioStats_->ramHit().sum());
+}
+
+TEST_F(CacheTest, sharedTier) {
+  initializeCache(64 << 20, 256 << 20);
+  cache_->ssdCache()->setSharedTier(std::make_shared<TestSharedTier>());
+  testRandomSeek_ = false;
+  deterministic_ = true;
+  readLoop("testfile", 30, 100, 1, 10, 1, ioStats_);
+  waitForWrite();
+  EXPECT_EQ(0, ioStats_->sharedTierRead().sum());
+
+  // Simulates a new host with cold RAM and SSD.
+  cache_->clear();
+  cache_->ssdCache()->clear();
+  auto stats = std::make_shared<IoStatistics>();
+  readLoop("testfile", 30, 100, 1, 10, 1, stats);
+  EXPECT_LT(0, stats->sharedTierRead().sum());
+  EXPECT_EQ(0, stats->ssdRead().sum());
+  EXPECT_LT(0, stats->sharedTierLatency().count());
+}
+
 // Calibrates the data read for a densely and sparsely read stripe of
 // test data. Fills the SSD cache with test data. Reads 2x cache size
 // worth of data and checks that the cache population settles to a
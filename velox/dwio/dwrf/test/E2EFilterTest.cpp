@@ -19,6 +19,7 @@
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
 #include "velox/dwio/dwrf/writer/FlushPolicy.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
 
 #include <folly/init/Init.h>
 
@@ -332,6 +333,21 @@ TEST_F(E2EFilterTest, lazyStruct) {
       false);
 }
 
+TEST_F(E2EFilterTest, lazyChildrenOfNullableStruct) {
+  // 'outer_struct' has nulls and a filter on 'nested1', so it is read
+  // eagerly. Its unfiltered children 'data1' and 'data2' are LazyVectors
+  // loaded for the rows that pass the filters.
+  testWithTypes(
+      "long_val:bigint,"
+      "outer_struct: struct<nested1:bigint, data1: string, data2: bigint>",
+      [&]() {},
+      true,
+      {"long_val", "outer_struct.nested1"},
+      20,
+      true,
+      false);
+}
+
 TEST_F(E2EFilterTest, filterStruct) {
 #ifdef TSAN_BUILD
   // The test is running slow under TSAN; reduce the number of combinations to
@@ -397,6 +413,71 @@ TEST_F(E2EFilterTest, subfieldsPruning) {
   testSubfieldsPruning();
 }
 
+TEST_F(E2EFilterTest, skipStripeLoads) {
+  // One stripe per batch. The row index in the stripe metadata cache shows
+  // that only one stripe has rows that pass, so the data of the other
+  // stripes is not loaded.
+  rowType_ = ROW({"c0", "c1"}, {BIGINT(), DOUBLE()});
+  test::VectorMaker vectorMaker(leafPool_.get());
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    batches.push_back(vectorMaker.rowVector(
+        {"c0", "c1"},
+        {vectorMaker.flatVector<int64_t>(
+             10'000, [&](auto row) { return i * 10'000 + row; }),
+         vectorMaker.flatVector<double>(
+             10'000, [](auto row) { return row * 0.5; })}));
+  }
+  flushEveryNBatches_ = 1;
+  writeToMemory(rowType_, batches, false);
+
+  auto countRows = [&](std::unique_ptr<common::Filter> filter,
+                       RuntimeStatistics& stats) {
+    auto spec = std::make_shared<common::ScanSpec>("<root>");
+    spec->addAllChildFields(*rowType_);
+    spec->childByName("c0")->setFilter(std::move(filter));
+    ReaderOptions readerOpts{leafPool_.get()};
+    RowReaderOptions rowReaderOpts;
+    std::string_view data(sinkPtr_->getData(), sinkPtr_->size());
+    auto input = std::make_unique<BufferedInput>(
+        std::make_shared<InMemoryReadFile>(data), readerOpts.getMemoryPool());
+    auto reader = makeReader(readerOpts, std::move(input));
+    setUpRowReaderOptions(rowReaderOpts, spec);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto result = BaseVector::create(rowType_, 1, leafPool_.get());
+    int64_t numRows = 0;
+    while (rowReader->next(1'000, result)) {
+      numRows += result->size();
+    }
+    rowReader->updateRuntimeStats(stats);
+    return numRows;
+  };
+
+  RuntimeStatistics stats;
+  EXPECT_EQ(
+      1'000,
+      countRows(
+          std::make_unique<common::BigintRange>(25'000, 25'999, false),
+          stats));
+  EXPECT_EQ(4, stats.skippedStripeLoads);
+  EXPECT_EQ(4, stats.skippedStrides);
+
+  stats = RuntimeStatistics();
+  EXPECT_EQ(
+      0,
+      countRows(
+          std::make_unique<common::BigintRange>(60'000, 70'000, false),
+          stats));
+  EXPECT_EQ(5, stats.skippedStripeLoads);
+
+  stats = RuntimeStatistics();
+  EXPECT_EQ(
+      50'000,
+      countRows(
+          std::make_unique<common::BigintRange>(0, 50'000, false), stats));
+  EXPECT_EQ(0, stats.skippedStripeLoads);
+}
+
 // Define main so that gflags get processed.
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/Statistics.h"
@@ -333,6 +334,140 @@ TEST_F(E2EWriterTests, E2E) {
   E2EWriterTestUtil::testWriter(*leafPool_, type, batches, 1, 1, config);
 }
 
+TEST_F(E2EWriterTests, parallelEncoding) {
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "bool_val:boolean,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>,"
+      "flat_map_val:map<bigint,map<string, int>>,"
+      "struct_val:struct<a:float,b:double>"
+      ">");
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {7});
+
+  std::vector<VectorPtr> batches;
+  for (size_t i = 0; i < 6; ++i) {
+    batches.push_back(
+        BatchMaker::createBatch(type, 1'500, *leafPool_, nullptr, i));
+  }
+
+  auto writeFile = [&](std::shared_ptr<folly::Executor> executor) {
+    auto sink = std::make_unique<MemorySink>(*leafPool_, 200 * 1024 * 1024);
+    auto sinkPtr = sink.get();
+    // Starts a new stripe on every other write.
+    auto numWrites = std::make_shared<int32_t>(0);
+    E2EWriterTestUtil::writeData(
+        std::move(sink),
+        type,
+        batches,
+        config,
+        [numWrites]() {
+          return std::make_unique<LambdaFlushPolicy>(
+              [numWrites]() { return ++*numWrites % 2 == 0; });
+        },
+        nullptr,
+        std::numeric_limits<int64_t>::max(),
+        std::move(executor));
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  };
+
+  const auto expected = writeFile(nullptr);
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  for (auto i = 0; i < 3; ++i) {
+    // The columns are laid out in the same order regardless of the timing.
+    ASSERT_EQ(expected, writeFile(executor));
+  }
+  ReaderOptions readerOpts{leafPool_.get()};
+  DwrfReader reader(
+      readerOpts,
+      std::make_unique<BufferedInput>(
+          std::make_shared<InMemoryReadFile>(expected), *leafPool_));
+  ASSERT_GT(reader.getNumberOfStripes(), 1);
+}
+
+TEST_F(E2EWriterTests, stringDictionaryReevaluation) {
+  auto type = ROW({"s"}, {VARCHAR()});
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(300));
+  config->set(
+      Config::STRING_DICTIONARY_REEVALUATION_STRIPES, static_cast<uint32_t>(1));
+  config->set(Config::STRING_DICTIONARY_SEED_KEYS, static_cast<uint32_t>(16));
+
+  // Low cardinality stripes, then unique values, then low cardinality again.
+  const std::vector<bool> lowCardinality{true, true, false, false, true, true};
+  VectorMaker maker{leafPool_.get()};
+  std::vector<VectorPtr> batches;
+  for (auto i = 0; i < lowCardinality.size(); ++i) {
+    std::vector<std::string> values;
+    for (auto row = 0; row < 1'000; ++row) {
+      values.push_back(
+          lowCardinality[i] ? fmt::format("key_{}", (row + i) % 10)
+                            : fmt::format("unique_value_{}_{}", i, row));
+    }
+    batches.push_back(maker.rowVector(
+        {"s"},
+        {maker.flatVector<StringView>(values.size(), [&](auto row) {
+          return StringView(values[row]);
+        })}));
+  }
+
+  auto sink = std::make_unique<MemorySink>(*leafPool_, 200 * 1024 * 1024);
+  auto sinkPtr = sink.get();
+  // Writes a stripe per batch.
+  auto writer = E2EWriterTestUtil::writeData(
+      std::move(sink),
+      type,
+      batches,
+      config,
+      E2EWriterTestUtil::simpleFlushPolicyFactory(true));
+
+  ReaderOptions readerOpts{leafPool_.get()};
+  auto reader = createReader(*sinkPtr, readerOpts);
+  ASSERT_EQ(batches.size(), reader->getNumberOfStripes());
+  auto rowReader = reader->createRowReader(RowReaderOptions{});
+  auto dwrfRowReader = dynamic_cast<DwrfRowReader*>(rowReader.get());
+  // The dictionary is abandoned at the first unique stripe, retried and
+  // abandoned again at the next one, and then only retried after 2 stripes.
+  const std::vector<bool> expectedDictionary{
+      true, true, false, false, false, true};
+  for (auto i = 0; i < batches.size(); ++i) {
+    dwrfRowReader->loadStripe(i, true);
+    const auto& footer = dwrfRowReader->getStripeFooter();
+    bool found = false;
+    for (const auto& encoding : footer.encoding()) {
+      if (encoding.node() == 1) {
+        found = true;
+        EXPECT_EQ(
+            expectedDictionary[i],
+            encoding.kind() ==
+                proto::ColumnEncoding_Kind::ColumnEncoding_Kind_DICTIONARY)
+            << "stripe " << i;
+      }
+    }
+    ASSERT_TRUE(found);
+  }
+
+  rowReader = reader->createRowReader(RowReaderOptions{});
+  VectorPtr batch;
+  for (const auto& expected : batches) {
+    ASSERT_TRUE(rowReader->next(expected->size(), batch));
+    ASSERT_EQ(expected->size(), batch->size());
+    for (auto row = 0; row < batch->size(); ++row) {
+      ASSERT_TRUE(expected->equalValueAt(batch.get(), row, row))
+          << expected->toString(row) << " vs " << batch->toString(row);
+    }
+  }
+  ASSERT_FALSE(rowReader->next(1, batch));
+}
+
 TEST_F(E2EWriterTests, FlatMapDictionaryEncoding) {
   const size_t batchCount = 4;
   // Start with a size larger than stride to cover splitting into
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <random>
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/common/Range.h"
+#include "velox/dwio/dwrf/common/DecoderUtil.h"
+#include "velox/dwio/dwrf/common/EncoderUtil.h"
+
+/// Measures the decoding of RLEv2 streams with DIRECT, PATCHED_BASE and
+/// DELTA runs of various bit widths.
+
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+
+namespace {
+
+constexpr size_t kNumValues = 1'000'000;
+
+auto pool = memory::addDefaultLeafMemoryPool();
+
+std::string encode(const std::vector<int64_t>& values) {
+  const size_t capacity = values.size() * sizeof(int64_t) * 2;
+  MemorySink sink{*pool, capacity};
+  DataBufferHolder holder{*pool, capacity, 0, DEFAULT_PAGE_GROW_RATIO, &sink};
+  auto encoder = createRleEncoder<false>(
+      RleVersion_2,
+      std::make_unique<BufferedOutputStream>(holder),
+      true,
+      sizeof(int64_t));
+  encoder->add(values.data(), common::Ranges::of(0, values.size()), nullptr);
+  encoder->flush();
+  return std::string(sink.getData(), sink.size());
+}
+
+std::string direct(int32_t bitWidth) {
+  std::mt19937_64 rng{1};
+  std::vector<int64_t> values(kNumValues);
+  for (auto& value : values) {
+    value = rng() & ((1UL << bitWidth) - 1);
+  }
+  return encode(values);
+}
+
+std::string patched(int32_t bitWidth) {
+  std::mt19937_64 rng{1};
+  std::vector<int64_t> values(kNumValues);
+  for (size_t i = 0; i < kNumValues; ++i) {
+    values[i] = rng() & ((1UL << bitWidth) - 1);
+    if (i % 97 == 0) {
+      values[i] |= 1UL << (bitWidth + 20);
+    }
+  }
+  return encode(values);
+}
+
+std::string delta(int32_t bitWidth) {
+  std::mt19937_64 rng{1};
+  std::vector<int64_t> values(kNumValues);
+  for (size_t i = 1; i < kNumValues; ++i) {
+    values[i] = values[i - 1] + (rng() & ((1UL << bitWidth) - 1));
+  }
+  return encode(values);
+}
+
+void decode(uint32_t iterations, const std::string& data) {
+  std::vector<int64_t> result(1'000);
+  for (auto i = 0; i < iterations; ++i) {
+    auto decoder = createRleDecoder<false>(
+        std::make_unique<SeekableArrayInputStream>(data.data(), data.size()),
+        RleVersion_2,
+        *pool,
+        true,
+        sizeof(int64_t));
+    for (size_t row = 0; row < kNumValues; row += result.size()) {
+      decoder->next(result.data(), result.size(), nullptr);
+    }
+    folly::doNotOptimizeAway(result);
+  }
+}
+
+#define DECODE_BENCHMARK(kind, bitWidth)           \
+  BENCHMARK_MULTI(kind##_##bitWidth, iterations) { \
+    folly::BenchmarkSuspender suspender;           \
+    static const auto data = kind(bitWidth);       \
+    suspender.dismiss();                           \
+    decode(iterations, data);                      \
+    return iterations * kNumValues;                \
+  }
+
+DECODE_BENCHMARK(direct, 3)
+DECODE_BENCHMARK(direct, 11)
+DECODE_BENCHMARK(direct, 24)
+DECODE_BENCHMARK(direct, 40)
+BENCHMARK_DRAW_LINE();
+DECODE_BENCHMARK(patched, 3)
+DECODE_BENCHMARK(patched, 11)
+DECODE_BENCHMARK(patched, 24)
+BENCHMARK_DRAW_LINE();
+DECODE_BENCHMARK(delta, 3)
+DECODE_BENCHMARK(delta, 11)
+DECODE_BENCHMARK(delta, 24)
+
+} // namespace
+
+int32_t main(int32_t argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
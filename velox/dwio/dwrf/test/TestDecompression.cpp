@@ -18,9 +18,11 @@
 #include <folly/String.h>
 #include <folly/compression/Compression.h>
 #include <folly/compression/Zlib.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include "velox/common/base/BitUtil.h"
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/encryption/TestProvider.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
@@ -796,7 +798,10 @@ compress(char* buf, size_t size, char* output, size_t offset, Codec& codec) {
 class TestSeek : public ::testing::Test {
  public:
   ~TestSeek() override {}
-  static void runTest(Codec& codec, CompressionKind kind) {
+  static void runTest(
+      Codec& codec,
+      CompressionKind kind,
+      folly::Executor* executor = nullptr) {
     constexpr size_t inputSize = 1024;
     constexpr size_t outputSize = 4096;
     char output[outputSize];
@@ -807,6 +812,8 @@ class TestSeek : public ::testing::Test {
     prepareTestData(codec, input1, input2, inputSize, output, offset1, offset2);
     auto pool = addDefaultLeafMemoryPool();
 
+    DecompressionOptions options;
+    options.executor = executor;
     std::unique_ptr<SeekableInputStream> stream = createDecompressor(
         kind,
         std::unique_ptr<SeekableInputStream>(
@@ -814,7 +821,8 @@ class TestSeek : public ::testing::Test {
         outputSize,
         *pool,
         "TestSeek Decompressor",
-        nullptr);
+        nullptr,
+        options);
 
     const void* data;
     int32_t size;
@@ -868,6 +876,149 @@ TEST_F(TestSeek, Snappy) {
   runTest(*codec, CompressionKind_SNAPPY);
 }
 
+TEST_F(TestSeek, parallel) {
+  folly::CPUThreadPoolExecutor executor(4);
+  auto zlibCodec = zlib::getCodec(
+      zlib::Options(zlib::Options::Format::RAW), COMPRESSION_LEVEL_DEFAULT);
+  runTest(*zlibCodec, CompressionKind_ZLIB, &executor);
+  runTest(*getCodec(CodecType::ZSTD), CompressionKind_ZSTD, &executor);
+  runTest(*getCodec(CodecType::SNAPPY), CompressionKind_SNAPPY, &executor);
+}
+
+TEST(TestDecompression, parallelManyChunks) {
+  // Compressed chunks with an uncompressed and an empty chunk in between.
+  constexpr int32_t kChunkSize = 1024;
+  constexpr int32_t kNumChunks = 50;
+  auto codec = getCodec(CodecType::ZSTD);
+  std::vector<char> expected(kChunkSize * kNumChunks);
+  std::vector<char> compressed(2 * expected.size());
+  std::vector<uint64_t> chunkOffsets;
+  size_t offset = 0;
+  for (auto i = 0; i < kNumChunks; ++i) {
+    chunkOffsets.push_back(offset);
+    auto* chunk = expected.data() + i * kChunkSize;
+    fillInput(chunk, kChunkSize);
+    if (i == 10) {
+      writeHeader(compressed.data() + offset, kChunkSize, true);
+      memcpy(compressed.data() + offset + 3, chunk, kChunkSize);
+      offset += kChunkSize + 3;
+    } else {
+      offset = compress(chunk, kChunkSize, compressed.data(), offset, *codec);
+    }
+    if (i == 20) {
+      writeHeader(compressed.data() + offset, 0, false);
+      offset += 3;
+    }
+  }
+
+  folly::CPUThreadPoolExecutor executor(4);
+  IoStatistics stats;
+  DecompressionOptions options;
+  options.executor = &executor;
+  options.stats = &stats;
+  options.nodeId = 7;
+  auto stream = createDecompressor(
+      CompressionKind_ZSTD,
+      std::make_unique<SeekableArrayInputStream>(
+          compressed.data(), offset, 1000),
+      kChunkSize,
+      *pool,
+      "Test Decompression",
+      nullptr,
+      options);
+
+  std::string result;
+  const void* data;
+  int32_t size;
+  while (stream->Next(&data, &size)) {
+    result.append(static_cast<const char*>(data), size);
+  }
+  EXPECT_EQ(std::string(expected.data(), expected.size()), result);
+
+  // Back to a chunk that has been freed and to the uncompressed chunk.
+  for (auto chunk : {3, 10, 0, kNumChunks - 1}) {
+    std::vector<uint64_t> positions{chunkOffsets[chunk], 100};
+    PositionProvider position(positions);
+    stream->seekToPosition(position);
+    ASSERT_TRUE(stream->Next(&data, &size));
+    ASSERT_EQ(kChunkSize - 100, size);
+    EXPECT_EQ(
+        0, memcmp(data, expected.data() + chunk * kChunkSize + 100, size));
+  }
+
+  // Seeking into the middle of a chunk is an error.
+  std::vector<uint64_t> positions{chunkOffsets[5] + 1, 0};
+  PositionProvider position(positions);
+  EXPECT_THROW(stream->seekToPosition(position), std::exception);
+
+  // Each compressed chunk and the chunks decompressed again after seeking.
+  EXPECT_EQ(kNumChunks - 1 + 3, stats.decompression().count());
+  auto cpuNanos = stats.decompressionCpuNanos();
+  EXPECT_EQ(1, cpuNanos.size());
+  EXPECT_EQ(stats.decompression().sum(), cpuNanos[7]);
+}
+
+TEST(TestDecompression, parallelEncrypted) {
+  // Encrypted compressed chunks with an uncompressed chunk in between.
+  constexpr int32_t kChunkSize = 1024;
+  constexpr int32_t kNumChunks = 20;
+  auto codec = getCodec(CodecType::ZSTD);
+  encryption::test::TestEncrypter encrypter;
+  encrypter.setKey("key");
+  encryption::test::TestDecrypter decrypter;
+  decrypter.setKey("key");
+  std::vector<char> expected(kChunkSize * kNumChunks);
+  std::string encrypted;
+  for (auto i = 0; i < kNumChunks; ++i) {
+    auto* chunk = expected.data() + i * kChunkSize;
+    fillInput(chunk, kChunkSize);
+    std::string payload;
+    if (i == 5) {
+      payload.assign(chunk, kChunkSize);
+    } else {
+      auto ioBuf = folly::IOBuf::wrapBuffer(chunk, kChunkSize);
+      payload = codec->compress(ioBuf.get())->moveToFbString().toStdString();
+    }
+    auto encryptedPayload =
+        encrypter.encrypt(payload)->moveToFbString().toStdString();
+    char header[3];
+    writeHeader(header, encryptedPayload.size(), i == 5);
+    encrypted.append(header, 3);
+    encrypted.append(encryptedPayload);
+  }
+
+  folly::CPUThreadPoolExecutor executor(4);
+  IoStatistics stats;
+  DecompressionOptions options;
+  options.executor = &executor;
+  options.stats = &stats;
+  options.nodeId = 3;
+  auto stream = createDecompressor(
+      CompressionKind_ZSTD,
+      std::make_unique<SeekableArrayInputStream>(
+          encrypted.data(), encrypted.size(), 1000),
+      kChunkSize,
+      *pool,
+      "Test Decompression",
+      &decrypter,
+      options);
+
+  std::string result;
+  const void* data;
+  int32_t size;
+  while (stream->Next(&data, &size)) {
+    result.append(static_cast<const char*>(data), size);
+  }
+  EXPECT_EQ(std::string(expected.data(), expected.size()), result);
+
+  // All the chunks are decrypted in one call.
+  EXPECT_EQ(1, stats.decryption().count());
+  auto cpuNanos = stats.decryptionCpuNanos();
+  EXPECT_EQ(1, cpuNanos.size());
+  EXPECT_EQ(stats.decryption().sum(), cpuNanos[3]);
+  EXPECT_EQ(kNumChunks - 1, stats.decompression().count());
+}
+
 TEST_F(TestSeek, uncompressed) {
   constexpr int32_t kSize = 1000;
   constexpr int32_t kHeaderSize = 3;
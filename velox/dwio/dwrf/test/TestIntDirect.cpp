@@ -191,6 +191,28 @@ TEST(TestDirect, vIntUnsignedLong) {
   });
 }
 
+TEST(TestDirect, vIntShortRuns) {
+  folly::Random::DefaultGenerator rng;
+  rng.seed(3);
+  int32_t count = 0;
+  // Generates runs of values of at most 1, 2 and 3 bytes and mixes of these to
+  // test the SIMD bulk decode.
+  auto generate = [&]() -> int64_t {
+    auto run = ++count / 100 % 4;
+    auto maxBytes = run == 3 ? 3 : run + 1;
+    if (run == 3 && count % 7 == 0) {
+      maxBytes = 5;
+    }
+    auto numBytes = 1 + folly::Random::rand32(rng) % maxBytes;
+    return folly::Random::rand64(rng) & ((1UL << (7 * numBytes)) - 1);
+  };
+  testInts<int64_t, false, true>(generate);
+  testInts<int64_t, true, true>([&]() -> int64_t {
+    auto value = generate() / 2;
+    return folly::Random::rand32(rng) & 1 ? -value : value;
+  });
+}
+
 template <bool isSigned>
 void testCorruptedVarInts() {
   std::vector<uint8_t> invalidInt{
@@ -18,6 +18,7 @@
 #include <gtest/gtest.h>
 #include <velox/buffer/Buffer.h>
 #include "folly/Random.h"
+#include "folly/executors/CPUThreadPoolExecutor.h"
 #include "folly/lang/Assume.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/DataSink.h"
@@ -26,6 +27,7 @@
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 #include "velox/dwio/dwrf/test/utils/E2EWriterTestUtil.h"
+#include "velox/dwio/dwrf/writer/FlushPolicy.h"
 #include "velox/dwio/type/fbhive/HiveTypeParser.h"
 #include "velox/type/Type.h"
 #include "velox/vector/ComplexVector.h"
@@ -1432,6 +1434,75 @@ TEST(TestReader, testFlatmapAsMapFieldLifeCycle) {
   testFlatmapAsMapFieldLifeCycle(schema, config, rng, batchSize, true);
 }
 
+TEST(TestReader, stripeParallelism) {
+  auto pool = memory::addDefaultLeafMemoryPool();
+  auto schema = ROW({BIGINT(), VARCHAR(), ARRAY(INTEGER())});
+  std::mt19937 rng{1};
+  std::vector<VectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    batches.push_back(BatchMaker::createBatch(schema, 1'000, *pool, rng));
+  }
+  // Each batch is written in its own stripe.
+  auto sink = std::make_unique<MemorySink>(*pool, 10 * 1024 * 1024);
+  auto sinkPtr = sink.get();
+  auto writer = E2EWriterTestUtil::writeData(
+      std::move(sink), schema, batches, std::make_shared<Config>(), []() {
+        return std::make_unique<LambdaFlushPolicy>(
+            [numWrites = 0]() mutable { return numWrites++ > 0; });
+      });
+  std::string_view data(sinkPtr->getData(), sinkPtr->size());
+
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  auto readFile = std::make_shared<InMemoryReadFile>(data);
+  ReaderOptions readerOpts{pool.get()};
+  auto test = [&](bool selective,
+                  int32_t parallelism,
+                  std::optional<uint64_t> seekRow = std::nullopt) {
+    SCOPED_TRACE(fmt::format(
+        "selective: {}, parallelism: {}, seekRow: {}",
+        selective,
+        parallelism,
+        seekRow.value_or(0)));
+    auto reader = std::make_unique<DwrfReader>(
+        readerOpts, std::make_unique<BufferedInput>(readFile, *pool));
+    ASSERT_EQ(reader->getNumberOfStripes(), batches.size());
+    RowReaderOptions rowReaderOpts;
+    if (selective) {
+      auto spec = std::make_shared<common::ScanSpec>("root");
+      spec->addAllChildFields(*schema);
+      rowReaderOpts.setScanSpec(spec);
+    }
+    rowReaderOpts.setDecodingExecutor(executor);
+    rowReaderOpts.setStripeParallelism(parallelism);
+    auto rowReader = reader->createDwrfRowReader(rowReaderOpts);
+    VectorPtr result = BaseVector::create(schema, 0, pool.get());
+    uint64_t row = 0;
+    if (seekRow.has_value()) {
+      // Starts preparing the stripes after the first one.
+      ASSERT_EQ(rowReader->next(300, result), 300);
+      row = rowReader->seekToRow(seekRow.value());
+      ASSERT_EQ(row, seekRow.value());
+    }
+    while (rowReader->next(300, result)) {
+      for (auto i = 0; i < result->size(); ++i, ++row) {
+        auto& batch = batches[row / 1'000];
+        ASSERT_TRUE(batch->equalValueAt(result.get(), row % 1'000, i))
+            << "row " << row;
+      }
+    }
+    ASSERT_EQ(row, batches.size() * 1'000);
+  };
+
+  for (auto selective : {false, true}) {
+    for (auto parallelism : {0, 1, 3, 20}) {
+      test(selective, parallelism);
+    }
+  }
+  // The seek drops the stripes prepared ahead.
+  test(false, 3, 4'500);
+  test(false, 3, 500);
+}
+
 TEST(TestReader, testOrcReaderSimple) {
   const std::string simpleTest(
       getExampleFilePath("TestStringDictionary.testRowIndex.orc"));
@@ -1523,6 +1594,51 @@ TEST(TestReader, testOrcReaderVarchar) {
   EXPECT_EQ(counter, 6000);
 }
 
+TEST(TestReader, testOrcSelectiveReaderWithFilter) {
+  const std::string varcharOrc(getExampleFilePath("orc_index_int_string.orc"));
+  ReaderOptions readerOpts{defaultPool.get()};
+  readerOpts.setFileFormat(dwio::common::FileFormat::ORC);
+  auto reader = DwrfReader::create(
+      createFileBufferedInput(varcharOrc, readerOpts.getMemoryPool()),
+      readerOpts);
+  auto rowType = reader->rowType();
+
+  auto test = [&](int64_t lower, int64_t upper) {
+    SCOPED_TRACE(fmt::format("{} <= c0 <= {}", lower, upper));
+    auto spec = std::make_shared<common::ScanSpec>("root");
+    spec->addAllChildFields(*rowType);
+    spec->childByName(rowType->nameOf(0))
+        ->setFilter(std::make_unique<common::BigintRange>(lower, upper, false));
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.setScanSpec(spec);
+    auto rowReader = reader->createRowReader(rowReaderOptions);
+
+    VectorPtr batch = BaseVector::create(rowType, 0, defaultPool.get());
+    int64_t expected = std::max<int64_t>(lower, 1);
+    while (rowReader->next(500, batch)) {
+      auto rowVector = batch->as<RowVector>();
+      auto ints =
+          rowVector->childAt(0)->loadedVector()->as<SimpleVector<int32_t>>();
+      auto strings = rowVector->childAt(1)
+                         ->loadedVector()
+                         ->as<SimpleVector<StringView>>();
+      for (size_t i = 0; i < rowVector->size(); ++i, ++expected) {
+        ASSERT_EQ(expected, ints->valueAt(i));
+        auto expectedString = expected < 1000
+            ? fmt::format("{}a", expected)
+            : fmt::format("{}", expected);
+        ASSERT_EQ(expectedString, strings->valueAt(i).str());
+      }
+    }
+    EXPECT_EQ(expected, std::min<int64_t>(upper, 6000) + 1);
+  };
+
+  test(
+      std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
+  test(990, 2'500);
+  test(5'999, 7'000);
+}
+
 TEST(TestReader, testOrcReaderDate) {
   const std::string dateOrc(getExampleFilePath("TestOrcFile.testDate1900.orc"));
   ReaderOptions readerOpts{defaultPool.get()};
@@ -14,12 +14,16 @@
  * limitations under the License.
  */
 
+#include <fmt/format.h>
 #include <gtest/gtest.h>
+#include <random>
 
 #include "velox/common/base/Nulls.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/common/DataSink.h"
 #include "velox/dwio/dwrf/common/DecoderUtil.h"
+#include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
 using namespace facebook::velox;
@@ -666,6 +670,65 @@ TEST(RLEv2, bitsLeftByPreviousStream) {
   }
 };
 
+TEST(RLEv2, roundTripBitWidths) {
+  auto pool = memory::addDefaultLeafMemoryPool();
+  constexpr size_t kCount = 5'000;
+  std::mt19937_64 rng{1};
+  auto test = [&](const std::vector<int64_t>& values) {
+    constexpr size_t kCapacity = kCount * sizeof(int64_t) * 2;
+    dwio::common::MemorySink sink{*pool, kCapacity};
+    DataBufferHolder holder{
+        *pool, kCapacity, 0, DEFAULT_PAGE_GROW_RATIO, &sink};
+    auto encoder = createRleEncoder<false>(
+        RleVersion_2,
+        std::make_unique<BufferedOutputStream>(holder),
+        true,
+        sizeof(int64_t));
+    encoder->add(values.data(), common::Ranges::of(0, values.size()), nullptr);
+    encoder->flush();
+
+    // Reading from small blocks makes the bit packed runs straddle buffers.
+    for (auto blockSize : {sink.size(), 7UL, 61UL}) {
+      SCOPED_TRACE(fmt::format("blockSize {}", blockSize));
+      auto decoder = createRleDecoder<false>(
+          std::make_unique<dwio::common::SeekableArrayInputStream>(
+              sink.getData(), sink.size(), blockSize),
+          RleVersion_2,
+          *pool,
+          true,
+          sizeof(int64_t));
+      std::vector<int64_t> result(values.size());
+      for (size_t i = 0; i < values.size(); i += 333) {
+        decoder->next(
+            result.data() + i,
+            std::min<size_t>(333, values.size() - i),
+            nullptr);
+      }
+      ASSERT_EQ(values, result);
+    }
+  };
+
+  for (auto bitWidth : {1, 3, 7, 8, 11, 17, 24, 31, 40, 55, 56, 63}) {
+    SCOPED_TRACE(fmt::format("bitWidth {}", bitWidth));
+    const uint64_t mask = (1UL << bitWidth) - 1;
+    std::vector<int64_t> values(kCount);
+    for (auto i = 0; i < kCount; ++i) {
+      values[i] = rng() & mask;
+      // Occasional outliers make patched base runs.
+      if (i % 97 == 0 && bitWidth < 40) {
+        values[i] |= 1UL << (bitWidth + 20);
+      }
+    }
+    test(values);
+    // Increasing values make delta runs with bit packed deltas.
+    values[0] = 0;
+    for (auto i = 1; i < kCount; ++i) {
+      values[i] = values[i - 1] + (rng() & (mask >> 16));
+    }
+    test(values);
+  }
+}
+
 TEST(RLEv1, simpleTest) {
   auto pool = memory::addDefaultLeafMemoryPool();
   const unsigned char buffer[] = {
@@ -231,6 +231,36 @@ TEST(TestStringDictionaryEncoder, Clear) {
   EXPECT_LT(pool->getCurrentBytes(), peakMemory);
 }
 
+TEST(TestStringDictionaryEncoder, clearRetainingHotKeys) {
+  auto pool = addDefaultLeafMemoryPool();
+  StringDictionaryEncoder stringDictEncoder{*pool, *pool};
+  stringDictEncoder.addKey("cold", 0);
+  stringDictEncoder.addKey("warm", 0, 2);
+  stringDictEncoder.addKey("hot", 1, 5);
+  stringDictEncoder.addKey("hotter", 1, 9);
+  EXPECT_EQ(4, stringDictEncoder.numUsedKeys());
+
+  stringDictEncoder.clearRetainingHotKeys(2);
+  // The 2 most frequent keys are kept in their original order.
+  ASSERT_EQ(2, stringDictEncoder.size());
+  EXPECT_EQ(0, stringDictEncoder.numUsedKeys());
+  EXPECT_EQ("hot", stringDictEncoder.getKey(0));
+  EXPECT_EQ("hotter", stringDictEncoder.getKey(1));
+  EXPECT_EQ(0, stringDictEncoder.getCount(0));
+  EXPECT_EQ(0, stringDictEncoder.getCount(1));
+
+  // A seeded key takes the stride of its first use.
+  EXPECT_EQ(1, stringDictEncoder.addKey("hotter", 3));
+  EXPECT_EQ(3, stringDictEncoder.getStride(1));
+  EXPECT_EQ(2, stringDictEncoder.addKey("cold", 4));
+  EXPECT_EQ(2, stringDictEncoder.numUsedKeys());
+  EXPECT_EQ(1, stringDictEncoder.getCount(1));
+
+  stringDictEncoder.clear();
+  EXPECT_EQ(0, stringDictEncoder.size());
+  EXPECT_EQ(0, stringDictEncoder.numUsedKeys());
+}
+
 TEST(TestStringDictionaryEncoder, MemBenchmark) {
   auto pool = addDefaultLeafMemoryPool();
   StringDictionaryEncoder stringDictEncoder{*pool, *pool};
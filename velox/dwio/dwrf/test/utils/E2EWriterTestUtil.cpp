@@ -38,7 +38,8 @@ namespace facebook::velox::dwrf {
     std::function<
         std::unique_ptr<LayoutPlanner>(StreamList, const EncodingContainer&)>
         layoutPlannerFactory,
-    const int64_t writerMemoryCap) {
+    const int64_t writerMemoryCap,
+    std::shared_ptr<folly::Executor> encodingExecutor) {
   // write file to memory
   WriterOptions options;
   options.config = config;
@@ -46,6 +47,7 @@ namespace facebook::velox::dwrf {
   options.memoryBudget = writerMemoryCap;
   options.flushPolicyFactory = flushPolicyFactory;
   options.layoutPlannerFactory = layoutPlannerFactory;
+  options.encodingExecutor = std::move(encodingExecutor);
 
   auto writer = std::make_unique<Writer>(
       options,
@@ -37,6 +37,7 @@ class E2EWriterTestUtil {
    *    layoutPlannerFactory    supplies the layout planner and determine how
    *                            order of the data streams prior to flush
    *    writerMemoryCap         total memory budget for the writer
+   *    encodingExecutor        encodes the columns in parallel if set
    */
   static std::unique_ptr<Writer> writeData(
       std::unique_ptr<dwio::common::DataSink> sink,
@@ -48,7 +49,8 @@ class E2EWriterTestUtil {
       std::function<
           std::unique_ptr<LayoutPlanner>(StreamList, const EncodingContainer&)>
           layoutPlannerFactory = nullptr,
-      const int64_t writerMemoryCap = std::numeric_limits<int64_t>::max());
+      const int64_t writerMemoryCap = std::numeric_limits<int64_t>::max(),
+      std::shared_ptr<folly::Executor> encodingExecutor = nullptr);
 
   /**
    * Creates a writer with the supplied configuration and check the IO
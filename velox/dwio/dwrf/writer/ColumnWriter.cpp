@@ -15,7 +15,9 @@
  */
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
+#include <folly/futures/Future.h>
 #include <velox/dwio/common/exception/Exception.h>
+#include <deque>
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
@@ -35,7 +37,10 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const common::Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
+  // Only used while decoding. Thread local since the column writers of
+  // different columns may run in parallel.
+  static thread_local SelectivityVector selected;
+  selected.resize(slice->size());
   // initialize
   selected.clearAll();
   for (auto& range : ranges.getRanges()) {
@@ -837,7 +842,11 @@ class StringColumnWriter : public BaseColumnWriter {
             getConfig(Config::ENTROPY_STRING_DICT_SAMPLE_FRACTION),
             getConfig(Config::ENTROPY_STRING_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
+        reevaluationStripes_{
+            getConfig(Config::STRING_DICTIONARY_REEVALUATION_STRIPES)},
+        seedKeys_{getConfig(Config::STRING_DICTIONARY_SEED_KEYS)},
         useDictionaryEncoding_{useDictionaryEncoding()},
+        directStripesBeforeRetry_{reevaluationStripes_},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE(firstStripe_);
     if (!useDictionaryEncoding_) {
@@ -849,6 +858,12 @@ class StringColumnWriter : public BaseColumnWriter {
   uint64_t write(const VectorPtr& slice, const common::Ranges& ranges) override;
 
   void reset() override {
+    // The streams are empty at the start of a stripe, so this is where the
+    // direct encoded column can switch back to dictionary encoding.
+    if (!firstStripe_ && !useDictionaryEncoding_ && reevaluationStripes_ > 0 &&
+        ++directStripeCount_ >= directStripesBeforeRetry_) {
+      retryDictionaryEncoding();
+    }
     // Lots of decisions regarding the presence of streams are made at flush
     // time. We would defer recording all stream positions till then, and
     // only record position for PRESENT stream upon construction.
@@ -870,11 +885,19 @@ class StringColumnWriter : public BaseColumnWriter {
       std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
     tryAbandonDictionaries(false);
     initStreamWriters(useDictionaryEncoding_);
+    if (useDictionaryEncoding_ && retryingDictionary_) {
+      retryingDictionary_ = false;
+      directStripesBeforeRetry_ = reevaluationStripes_;
+    }
 
-    size_t dictEncoderSize = dictEncoder_.size();
+    size_t dictEncoderSize = dictEncoder_.numUsedKeys();
     if (useDictionaryEncoding_) {
       populateDictionaryEncodingStreams();
-      dictEncoder_.clear();
+      if (seedKeys_ > 0) {
+        dictEncoder_.clearRetainingHotKeys(seedKeys_);
+      } else {
+        dictEncoder_.clear();
+      }
       rows_.clear();
     }
 
@@ -971,9 +994,10 @@ class StringColumnWriter : public BaseColumnWriter {
   }
 
   bool tryAbandonDictionaries(bool force) override {
-    // TODO: hopefully not required in the future, but need to solve the problem
-    // of replacing/deleting streams.
-    if (!useDictionaryEncoding_ || !firstStripe_) {
+    // The encoding is only decided at the first stripe unless re-evaluation
+    // is enabled.
+    if (!useDictionaryEncoding_ ||
+        (!firstStripe_ && reevaluationStripes_ == 0)) {
       return false;
     }
 
@@ -982,6 +1006,17 @@ class StringColumnWriter : public BaseColumnWriter {
       return false;
     }
 
+    // The dictionary streams of the previous stripes have no data for this
+    // stripe yet, since they are populated at flush.
+    removeStreamWriters();
+    directStripeCount_ = 0;
+    if (retryingDictionary_) {
+      retryingDictionary_ = false;
+      directStripesBeforeRetry_ = directStripesBeforeRetry_ >
+              std::numeric_limits<uint32_t>::max() / 2
+          ? std::numeric_limits<uint32_t>::max()
+          : directStripesBeforeRetry_ * 2;
+    }
     initStreamWriters(useDictionaryEncoding_);
     // Record direct encoding stream starting position.
     recordDirectEncodingStreamPositions(0);
@@ -1025,6 +1060,48 @@ class StringColumnWriter : public BaseColumnWriter {
          dataDirectLength_));
   }
 
+  // Drops the data stream writers and their streams to switch the encoding.
+  // Must only be called when the streams have no data for the stripe.
+  void removeStreamWriters() {
+    data_.reset();
+    dataDirect_.reset();
+    dataDirectLength_.reset();
+    dictionaryData_.reset();
+    dictionaryDataLength_.reset();
+    inDictionary_.reset();
+    strideDictionaryData_.reset();
+    strideDictionaryDataLength_.reset();
+    context_.removeStreams([this](const DwrfStreamIdentifier& identifier) {
+      if (identifier.encodingKey().node != id_ ||
+          identifier.encodingKey().sequence != sequence_) {
+        return false;
+      }
+      switch (identifier.kind()) {
+        case StreamKind::StreamKind_DATA:
+        case StreamKind::StreamKind_LENGTH:
+        case StreamKind::StreamKind_DICTIONARY_DATA:
+        case StreamKind::StreamKind_IN_DICTIONARY:
+        case StreamKind::StreamKind_STRIDE_DICTIONARY:
+        case StreamKind::StreamKind_STRIDE_DICTIONARY_LENGTH:
+          return true;
+        default:
+          return false;
+      }
+    });
+  }
+
+  // Switches a direct encoded column back to dictionary encoding at the start
+  // of a stripe. The dictionary streams are created at flush.
+  void retryDictionaryEncoding() {
+    if (!useDictionaryEncoding()) {
+      return;
+    }
+    removeStreamWriters();
+    useDictionaryEncoding_ = true;
+    retryingDictionary_ = true;
+    directStripeCount_ = 0;
+  }
+
   void initStreamWriters(bool dictEncoding) {
     if (!data_ && !dataDirect_) {
       if (dictEncoding) {
@@ -1123,11 +1200,22 @@ class StringColumnWriter : public BaseColumnWriter {
   size_t finalDictionarySize_;
   EntropyEncodingSelector encodingSelector_;
   const bool sort_;
+  // If not 0, the dictionary encoding is re-evaluated at every stripe and is
+  // retried after this many direct encoded stripes.
+  const uint32_t reevaluationStripes_;
+  // The max number of hot keys kept to seed the next stripe's dictionary.
+  const uint32_t seedKeys_;
   // This value could change if we are writing with low memory mode or if we
   // determine with the first stripe that the data is not fit for dictionary
   // encoding.
   bool useDictionaryEncoding_;
   bool firstStripe_{true};
+  // The number of direct encoded stripes after which the dictionary encoding
+  // is retried. Doubled each time a retry ends up abandoning the dictionary.
+  uint32_t directStripesBeforeRetry_;
+  uint32_t directStripeCount_{0};
+  // True if the dictionary encoding of the current stripe is a retry.
+  bool retryingDictionary_{false};
   DataBuffer<size_t> strideOffsets_;
 };
 
@@ -1264,7 +1352,8 @@ void StringColumnWriter::populateDictionaryEncodingStreams() {
       });
 
   // When all the Keys are in Dictionary, inDictionaryStream is omitted.
-  bool writeInDictionaryStream = finalDictionarySize_ != dictEncoder_.size();
+  bool writeInDictionaryStream =
+      finalDictionarySize_ != dictEncoder_.numUsedKeys();
 
   // Record starting positions of the dictionary encoding streams.
   recordDictionaryEncodingStreamPositions(
@@ -1646,12 +1735,27 @@ class StructColumnWriter : public BaseColumnWriter {
       std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
       std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
     BaseColumnWriter::flush(encodingFactory, encodingOverride);
+    if (isRoot() && context_.encodingExecutor() && children_.size() > 1) {
+      flushChildrenInParallel(encodingFactory);
+      return;
+    }
     for (auto& c : children_) {
       c->flush(encodingFactory);
     }
   }
 
  private:
+  // Writes the top level columns in parallel on the encoding executor.
+  uint64_t writeChildrenInParallel(
+      const RowVector* rowSlice,
+      const common::Ranges& ranges);
+
+  // Flushes the top level columns in parallel on the encoding executor. The
+  // encodings are added with 'encodingFactory' in the same order as when
+  // flushing serially, so that the output does not depend on the timing.
+  void flushChildrenInParallel(
+      const std::function<proto::ColumnEncoding&(uint32_t)>& encodingFactory);
+
   uint64_t writeChildrenAndStats(
       const RowVector* rowSlice,
       const common::Ranges& ranges,
@@ -1664,8 +1768,12 @@ uint64_t StructColumnWriter::writeChildrenAndStats(
     uint64_t nullCount) {
   uint64_t rawSize = 0;
   if (ranges.size() > 0) {
-    for (size_t i = 0; i < children_.size(); ++i) {
-      rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+    if (isRoot() && context_.encodingExecutor() && children_.size() > 1) {
+      rawSize = writeChildrenInParallel(rowSlice, ranges);
+    } else {
+      for (size_t i = 0; i < children_.size(); ++i) {
+        rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+      }
     }
   }
   if (nullCount) {
@@ -1677,6 +1785,56 @@ uint64_t StructColumnWriter::writeChildrenAndStats(
   return rawSize;
 }
 
+uint64_t StructColumnWriter::writeChildrenInParallel(
+    const RowVector* rowSlice,
+    const common::Ranges& ranges) {
+  std::vector<folly::Future<uint64_t>> futures;
+  futures.reserve(children_.size());
+  for (size_t i = 0; i < children_.size(); ++i) {
+    futures.push_back(
+        folly::via(context_.encodingExecutor(), [this, rowSlice, &ranges, i]() {
+          return children_[i]->write(rowSlice->childAt(i), ranges);
+        }));
+  }
+  // Waits for all the columns before rethrowing an error.
+  auto results = folly::collectAll(std::move(futures)).get();
+  uint64_t rawSize = 0;
+  for (auto& result : results) {
+    rawSize += result.value();
+  }
+  return rawSize;
+}
+
+void StructColumnWriter::flushChildrenInParallel(
+    const std::function<proto::ColumnEncoding&(uint32_t)>& encodingFactory) {
+  // The encodings of each column in the order they are added.
+  std::vector<std::deque<std::pair<uint32_t, proto::ColumnEncoding>>>
+      encodings(children_.size());
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(children_.size());
+  for (size_t i = 0; i < children_.size(); ++i) {
+    futures.push_back(
+        folly::via(context_.encodingExecutor(), [this, &encodings, i]() {
+          children_[i]->flush(
+              [&columnEncodings = encodings[i]](
+                  uint32_t nodeId) -> proto::ColumnEncoding& {
+                return columnEncodings
+                    .emplace_back(nodeId, proto::ColumnEncoding{})
+                    .second;
+              });
+        }));
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (auto& result : results) {
+    result.throwUnlessValue();
+  }
+  for (auto& columnEncodings : encodings) {
+    for (auto& [nodeId, encoding] : columnEncodings) {
+      encodingFactory(nodeId) = std::move(encoding);
+    }
+  }
+}
+
 uint64_t StructColumnWriter::write(
     const VectorPtr& slice,
     const common::Ranges& ranges) {
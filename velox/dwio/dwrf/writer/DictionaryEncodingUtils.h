@@ -83,6 +83,11 @@ class DictionaryEncodingUtils {
 
     for (uint32_t i = 0; i != numKeys; ++i) {
       auto origIndex = (sort ? sortedIndex[i] : i);
+      if (dictEncoder.getCount(origIndex) == 0) {
+        // A seeded key that is not used in this stripe.
+        inDict[origIndex] = false;
+        continue;
+      }
       if (!dropInfrequentKeys || shouldWriteKey(dictEncoder, origIndex)) {
         lookupTable[origIndex] = newIndex++;
         inDict[origIndex] = true;
@@ -57,7 +57,7 @@ class EntropyEncodingSelector {
     // The fraction of non-null values in this column that are repeats of values
     // in the dictionary
     float repeatedValuesFraction =
-        static_cast<float>(valueCount - dictEncoder.size()) / valueCount;
+        static_cast<float>(valueCount - dictEncoder.numUsedKeys()) / valueCount;
 
     // dictionaryKeySizeThreshold is the fraction of keys that are distinct
     // beyond which dictionary encoding is turned off so 1 -
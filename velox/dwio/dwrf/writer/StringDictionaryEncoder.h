@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include <folly/container/F14Set.h>
 #include <folly/hash/Checksum.h>
 
@@ -116,6 +118,13 @@ class StringDictionaryEncoder {
     return counts_.size();
   }
 
+  // Returns the number of keys added since the last clear. This is less than
+  // size() if the dictionary was seeded with keys that have not been added
+  // since, see clearRetainingHotKeys().
+  uint32_t numUsedKeys() const {
+    return numUsedKeys_;
+  }
+
   uint32_t
   addKey(folly::StringPiece sp, uint32_t strideIndex, uint32_t count = 1) {
     auto newIndex = size();
@@ -123,6 +132,11 @@ class StringDictionaryEncoder {
     auto result = keyIndex_.insert(key);
     if (!result.second) {
       auto index = result.first->getIndex();
+      if (UNLIKELY(counts_[index] == 0 && count > 0)) {
+        // First use of a seeded key.
+        firstSeenStrideIndex_[index] = strideIndex;
+        ++numUsedKeys_;
+      }
       counts_[index] += count;
       return index;
     }
@@ -140,6 +154,9 @@ class StringDictionaryEncoder {
     hash_.append(key.hash);
     counts_.append(count);
     firstSeenStrideIndex_.append(strideIndex);
+    if (count > 0) {
+      ++numUsedKeys_;
+    }
     return newIndex;
   }
 
@@ -169,6 +186,39 @@ class StringDictionaryEncoder {
     counts_.clear();
     firstSeenStrideIndex_.clear();
     hash_.clear();
+    numUsedKeys_ = 0;
+  }
+
+  // Clears the dictionary but keeps up to 'maxKeys' of the most frequent keys
+  // that were added more than once, in their original order and with zero
+  // counts. Seeds the dictionary of the next stripe with the hot keys of the
+  // previous one, which saves inserting them again for slowly changing data.
+  // The keys that are not added again have a zero count and are not written.
+  void clearRetainingHotKeys(uint32_t maxKeys) {
+    std::vector<uint32_t> hotKeys;
+    for (uint32_t i = 0; i < size(); ++i) {
+      if (counts_[i] > 1) {
+        hotKeys.push_back(i);
+      }
+    }
+    if (hotKeys.size() > maxKeys) {
+      std::nth_element(
+          hotKeys.begin(),
+          hotKeys.begin() + maxKeys,
+          hotKeys.end(),
+          [&](auto lhs, auto rhs) { return counts_[lhs] > counts_[rhs]; });
+      hotKeys.resize(maxKeys);
+      std::sort(hotKeys.begin(), hotKeys.end());
+    }
+    std::vector<std::string> keys;
+    keys.reserve(hotKeys.size());
+    for (auto index : hotKeys) {
+      keys.push_back(getKey(index).str());
+    }
+    clear();
+    for (const auto& key : keys) {
+      addKey(key, 0, 0);
+    }
   }
 
  private:
@@ -208,6 +258,8 @@ class StringDictionaryEncoder {
   dwio::common::DataBuffer<uint32_t> firstSeenStrideIndex_;
   // key index -> cached hash
   dwio::common::DataBuffer<uint32_t> hash_;
+  // The number of keys with non-zero counts.
+  uint32_t numUsedKeys_{0};
 
   friend struct DictStringIdHash;
 };
@@ -124,6 +124,9 @@ struct WriterOptions {
       WriterContext& context,
       const velox::dwio::common::TypeWithId& type)>
       columnWriterFactory;
+  // If set, the top level columns are encoded and compressed in parallel on
+  // this executor. The output is the same as without it.
+  std::shared_ptr<folly::Executor> encodingExecutor;
 };
 
 class Writer : public WriterBase {
@@ -144,6 +147,7 @@ class Writer : public WriterBase {
     initContext(options.config, std::move(pool), std::move(handler));
     auto& context = getContext();
     context.buildPhysicalSizeAggregators(*schema_);
+    context.setEncodingExecutor(options.encodingExecutor);
     if (!options.flushPolicyFactory) {
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
           context.stripeSizeFlushThreshold,
@@ -206,10 +206,13 @@ std::optional<common::Filter*> findFilter(
 } // anonymous namespace
 
 ParquetRowReader::ParquetRowReader(
+    std::shared_ptr<duckdb::VeloxPoolAllocator> allocator,
     std::shared_ptr<::duckdb::ParquetReader> reader,
     const dwio::common::RowReaderOptions& options,
     memory::MemoryPool& pool)
-    : reader_(std::move(reader)),
+    : options_(options),
+      allocator_(std::move(allocator)),
+      reader_(std::move(reader)),
       pool_(pool),
       scanSpec_{options.getScanSpec()} {
   auto& selector = *options.getSelector();
@@ -219,8 +222,7 @@ ParquetRowReader::ParquetRowReader(
   auto& projection = selector.getProjection();
   VELOX_CHECK_EQ(rowType_->size(), projection.size());
 
-  std::vector<::duckdb::column_t> columnIds;
-  columnIds.reserve(rowType_->size());
+  columnIds_.reserve(rowType_->size());
   for (uint64_t i = 0; i < projection.size(); i++) {
     uint64_t columnId = projection[i].column;
     VELOX_CHECK_LT(
@@ -228,7 +230,7 @@ ParquetRowReader::ParquetRowReader(
         reader_->names.size(),
         "Unexpected column name: {}",
         projection[i].name);
-    columnIds.push_back(columnId);
+    columnIds_.push_back(columnId);
 
     // DuckDB ParquetReader::return_types contains all columns present in the
     // file.
@@ -244,58 +246,125 @@ ParquetRowReader::ParquetRowReader(
     }
   }
 
-  std::vector<idx_t> groups;
   for (idx_t i = 0; i < reader_->NumRowGroups(); i++) {
     auto groupOffset = reader_->GetFileMetadata()->row_groups[i].file_offset;
     if (groupOffset >= options.getOffset() &&
         groupOffset < (options.getLength() + options.getOffset())) {
-      groups.push_back(i);
+      groups_.push_back(i);
     }
   }
 
+  if (!scanRowGroupsAhead()) {
+    reader_->InitializeScan(state_, columnIds_, groups_, &filters_);
+  }
+}
+
+ParquetRowReader::~ParquetRowReader() {
+  // The scans reference 'this', so wait for them to finish.
+  for (auto& future : scannedGroups_) {
+    future.wait();
+  }
+}
+
+std::unique_ptr<ParquetRowReader::ScannedRowGroup>
+ParquetRowReader::scanRowGroup(::duckdb::idx_t group) const {
+  // Each scan state reads through a file handle of its own.
+  ::duckdb::ParquetReaderScanState state;
   reader_->InitializeScan(
-      state_, std::move(columnIds), std::move(groups), &filters_);
+      state,
+      columnIds_,
+      {group},
+      const_cast<::duckdb::TableFilterSet*>(&filters_));
+  auto scanned = std::make_unique<ScannedRowGroup>();
+  for (;;) {
+    auto chunk = std::make_unique<::duckdb::DataChunk>();
+    if (!duckdbRowType_.empty()) {
+      chunk->Initialize(*allocator_, duckdbRowType_);
+    }
+    reader_->Scan(state, *chunk);
+    if (chunk->size() == 0) {
+      break;
+    }
+    scanned->chunks.push_back(std::move(chunk));
+  }
+  return scanned;
+}
+
+std::unique_ptr<::duckdb::DataChunk> ParquetRowReader::nextScannedChunk() {
+  while (!currentGroup_ || nextChunk_ == currentGroup_->chunks.size()) {
+    currentGroup_.reset();
+    const auto endGroup = std::min<size_t>(
+        groups_.size(),
+        nextGroup_ - scannedGroups_.size() + 1 +
+            options_.getStripeParallelism());
+    auto* executor = options_.getDecodingExecutor().get();
+    for (; nextGroup_ < endGroup; ++nextGroup_) {
+      scannedGroups_.push_back(
+          folly::via(executor, [this, group = groups_[nextGroup_]]() {
+            return scanRowGroup(group);
+          }));
+    }
+    if (scannedGroups_.empty()) {
+      return nullptr;
+    }
+    auto future = std::move(scannedGroups_.front());
+    scannedGroups_.pop_front();
+    currentGroup_ = std::move(future).get();
+    nextChunk_ = 0;
+  }
+  // The vectors made from the chunk keep its buffers alive.
+  return std::move(currentGroup_->chunks[nextChunk_++]);
 }
 
 uint64_t ParquetRowReader::next(uint64_t /*size*/, velox::VectorPtr& result) {
+  if (scanRowGroupsAhead()) {
+    auto chunk = nextScannedChunk();
+    if (!chunk) {
+      return 0;
+    }
+    toRowVector(*chunk, result);
+    return chunk->size();
+  }
+
   ::duckdb::DataChunk output;
-  // TODO: We are using the default duckdb allocator which uses Velox's default
-  // memory manager, not the one specified in the ReaderOptions.
   if (!duckdbRowType_.empty()) {
-    output.Initialize(duckdb::getDefaultAllocator(), duckdbRowType_);
+    output.Initialize(*allocator_, duckdbRowType_);
   }
 
   reader_->Scan(state_, output);
 
   if (output.size() > 0) {
-    std::vector<VectorPtr> columns;
-    columns.resize(output.data.size());
-    for (auto& spec : scanSpec_->children()) {
-      if (spec->isConstant()) {
-        columns[spec->channel()] =
-            BaseVector::wrapInConstant(output.size(), 0, spec->constantValue());
-      } else if (spec->projectOut()) {
-        auto index = rowType_->getChildIdx(spec->fieldName());
-        columns[spec->channel()] = duckdb::toVeloxVector(
-            output.size(),
-            output.data[index],
-            rowType_->childAt(index),
-            &pool_);
-      }
-    }
-
-    result = std::make_shared<RowVector>(
-        &pool_,
-        rowType_,
-        BufferPtr(nullptr),
-        output.size(),
-        columns,
-        std::nullopt);
+    toRowVector(output, result);
   }
 
   return output.size();
 }
 
+void ParquetRowReader::toRowVector(
+    ::duckdb::DataChunk& chunk,
+    VectorPtr& result) {
+  std::vector<VectorPtr> columns;
+  columns.resize(chunk.data.size());
+  for (auto& spec : scanSpec_->children()) {
+    if (spec->isConstant()) {
+      columns[spec->channel()] =
+          BaseVector::wrapInConstant(chunk.size(), 0, spec->constantValue());
+    } else if (spec->projectOut()) {
+      auto index = rowType_->getChildIdx(spec->fieldName());
+      columns[spec->channel()] = duckdb::toVeloxVector(
+          chunk.size(), chunk.data[index], rowType_->childAt(index), &pool_);
+    }
+  }
+
+  result = std::make_shared<RowVector>(
+      &pool_,
+      rowType_,
+      BufferPtr(nullptr),
+      chunk.size(),
+      columns,
+      std::nullopt);
+}
+
 void ParquetRowReader::updateRuntimeStats(
     dwio::common::RuntimeStatistics& /*stats*/) const {}
 
@@ -313,8 +382,10 @@ ParquetReader::ParquetReader(
     const dwio::common::ReaderOptions& options)
     : fileSystem_(
           std::make_unique<duckdb::InputStreamFileSystem>(std::move(stream))),
+      allocator_(std::make_shared<duckdb::VeloxPoolAllocator>(
+          options.getMemoryPool())),
       reader_(std::make_shared<::duckdb::ParquetReader>(
-          duckdb::getDefaultAllocator(),
+          *allocator_,
           fileSystem_->OpenFile())),
       pool_(options.getMemoryPool()) {
   auto names = reader_->names;
@@ -350,7 +421,8 @@ ParquetReader::typeWithId() const {
 
 std::unique_ptr<dwio::common::RowReader> ParquetReader::createRowReader(
     const dwio::common::RowReaderOptions& options) const {
-  return std::make_unique<ParquetRowReader>(reader_, options, pool_);
+  return std::make_unique<ParquetRowReader>(
+      allocator_, reader_, options, pool_);
 }
 
 } // namespace facebook::velox::parquet::duckdb_reader
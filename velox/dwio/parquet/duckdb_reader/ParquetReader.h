@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <deque>
+
+#include <folly/futures/Future.h>
+
 #include "velox/common/base/Macros.h"
 #include "velox/duckdb/memory/Allocator.h"
 #include "velox/dwio/common/Reader.h"
@@ -30,10 +34,11 @@ namespace facebook::velox::parquet::duckdb_reader {
 class ParquetRowReader : public dwio::common::RowReader {
  public:
   ParquetRowReader(
+      std::shared_ptr<duckdb::VeloxPoolAllocator> allocator,
       std::shared_ptr<::duckdb::ParquetReader> reader,
       const dwio::common::RowReaderOptions& options,
       memory::MemoryPool& pool);
-  ~ParquetRowReader() override = default;
+  ~ParquetRowReader() override;
 
   uint64_t next(uint64_t size, velox::VectorPtr& result) override;
 
@@ -45,13 +50,54 @@ class ParquetRowReader : public dwio::common::RowReader {
   std::optional<size_t> estimatedRowSize() const override;
 
  private:
+  // The chunks of a row group scanned ahead of use.
+  struct ScannedRowGroup {
+    std::vector<std::unique_ptr<::duckdb::DataChunk>> chunks;
+  };
+
+  // True if the row groups are scanned ahead of use on the decoding executor
+  // of the options.
+  bool scanRowGroupsAhead() const {
+    return options_.getStripeParallelism() > 0 &&
+        options_.getDecodingExecutor() != nullptr && groups_.size() > 1;
+  }
+
+  // Scans the row group 'group' of the file into chunks. Called on the
+  // decoding executor, so this must not modify 'this'.
+  std::unique_ptr<ScannedRowGroup> scanRowGroup(::duckdb::idx_t group) const;
+
+  // Returns the next chunk of the row groups scanned ahead, or nullptr at the
+  // end. Schedules the scans of the next row group and of
+  // 'stripeParallelism' row groups after it.
+  std::unique_ptr<::duckdb::DataChunk> nextScannedChunk();
+
+  // Makes 'result' from the columns of 'chunk'.
+  void toRowVector(::duckdb::DataChunk& chunk, VectorPtr& result);
+
+  const dwio::common::RowReaderOptions options_;
   ::duckdb::TableFilterSet filters_;
+  // Allocates the DuckDB buffers of 'reader_' from the memory pool of the
+  // reader options. Shared with the ParquetReader and declared before
+  // 'reader_', so it outlives the buffers.
+  std::shared_ptr<duckdb::VeloxPoolAllocator> allocator_;
   std::shared_ptr<::duckdb::ParquetReader> reader_;
   ::duckdb::ParquetReaderScanState state_;
   memory::MemoryPool& pool_;
   RowTypePtr rowType_;
   std::vector<::duckdb::LogicalType> duckdbRowType_;
   std::shared_ptr<velox::common::ScanSpec> scanSpec_;
+  // The file column of each column of 'rowType_'.
+  std::vector<::duckdb::column_t> columnIds_;
+  // The row groups in the range of the options.
+  std::vector<::duckdb::idx_t> groups_;
+
+  // The index in 'groups_' of the next row group to schedule a scan for.
+  size_t nextGroup_{0};
+  // The scans of the row groups after the current one, in order.
+  std::deque<folly::Future<std::unique_ptr<ScannedRowGroup>>> scannedGroups_;
+  // The row group the chunks are returned from.
+  std::unique_ptr<ScannedRowGroup> currentGroup_;
+  size_t nextChunk_{0};
 };
 
 class ParquetReader : public dwio::common::Reader {
@@ -76,6 +122,9 @@ class ParquetReader : public dwio::common::Reader {
 
  private:
   std::unique_ptr<duckdb::InputStreamFileSystem> fileSystem_;
+  // Routes the DuckDB allocations of 'reader_' and its row readers to the
+  // memory pool of the reader options.
+  std::shared_ptr<duckdb::VeloxPoolAllocator> allocator_;
   std::shared_ptr<::duckdb::ParquetReader> reader_;
   memory::MemoryPool& pool_;
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+namespace facebook::velox::parquet {
+namespace {
+// The salts for the bits set in the eight words of a block.
+constexpr uint32_t kSalt[8] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+
+template <typename T>
+bool mayContainAnyInt(
+    const SplitBlockBloomFilter& bloomFilter,
+    const std::vector<int64_t>& values) {
+  for (auto value : values) {
+    if (bloomFilter.mayContain<T>(value)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool mayContainAnyInt(
+    const SplitBlockBloomFilter& bloomFilter,
+    const std::vector<int64_t>& values,
+    thrift::Type::type physicalType) {
+  switch (physicalType) {
+    case thrift::Type::INT32:
+      return mayContainAnyInt<int32_t>(bloomFilter, values);
+    case thrift::Type::INT64:
+      return mayContainAnyInt<int64_t>(bloomFilter, values);
+    default:
+      return true;
+  }
+}
+} // namespace
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(std::string bitset)
+    : bitset_(std::move(bitset)),
+      blocks_(reinterpret_cast<const uint32_t*>(bitset_.data())),
+      numBlocks_(bitset_.size() / kBytesPerBlock) {
+  VELOX_CHECK_GT(numBlocks_, 0);
+  VELOX_CHECK_EQ(bitset_.size() % kBytesPerBlock, 0);
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hash(const void* data, int32_t size) {
+  return XXH64(data, size, 0);
+}
+
+bool SplitBlockBloomFilter::mayContainHash(uint64_t hash) const {
+  const auto blockIndex = ((hash >> 32) * numBlocks_) >> 32;
+  const auto* block = blocks_ + blockIndex * 8;
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < 8; ++i) {
+    if ((block[i] & (1U << ((key * kSalt[i]) >> 27))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SplitBlockBloomFilter::mayContainAny(
+    const common::Filter& filter,
+    thrift::Type::type physicalType) const {
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto range = static_cast<const common::BigintRange*>(&filter);
+      if (!range->isSingleValue()) {
+        return true;
+      }
+      return mayContainAnyInt(*this, {range->lower()}, physicalType);
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      return mayContainAnyInt(
+          *this,
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values(),
+          physicalType);
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return mayContainAnyInt(
+          *this,
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values(),
+          physicalType);
+    case common::FilterKind::kBytesValues: {
+      if (physicalType != thrift::Type::BYTE_ARRAY) {
+        return true;
+      }
+      for (const auto& value :
+           static_cast<const common::BytesValues&>(filter).values()) {
+        if (mayContain(std::string_view(value))) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      return true;
+  }
+}
+
+} // namespace facebook::velox::parquet
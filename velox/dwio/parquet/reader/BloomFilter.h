@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::parquet {
+
+/// Split block Bloom filter of a Parquet column chunk. The bitset is made of
+/// 32 byte blocks of eight 32 bit words. A value hashes with XXH64 to one block
+/// and sets one bit in each word of the block. See
+/// https://github.com/apache/parquet-format/blob/master/BloomFilter.md.
+class SplitBlockBloomFilter {
+ public:
+  static constexpr int32_t kBytesPerBlock = 32;
+
+  /// 'bitset' is the bitset of the filter as stored in the file. Its size must
+  /// be a non-zero multiple of kBytesPerBlock.
+  explicit SplitBlockBloomFilter(std::string bitset);
+
+  /// Returns the hash of the plain encoded bytes of a value.
+  static uint64_t hash(const void* FOLLY_NONNULL data, int32_t size);
+
+  /// Returns false if no value with 'hash' was inserted into the filter.
+  bool mayContainHash(uint64_t hash) const;
+
+  template <typename T>
+  bool mayContain(T value) const {
+    static_assert(std::is_arithmetic_v<T>);
+    return mayContainHash(hash(&value, sizeof(T)));
+  }
+
+  bool mayContain(std::string_view value) const {
+    return mayContainHash(hash(value.data(), value.size()));
+  }
+
+  /// Returns false if none of the values passing 'filter' may occur in a
+  /// column of 'physicalType' with this Bloom filter. Returns true if 'filter'
+  /// is not a list of values or is not comparable with the column values.
+  bool mayContainAny(
+      const common::Filter& filter,
+      thrift::Type::type physicalType) const;
+
+ private:
+  const std::string bitset_;
+  const uint32_t* const blocks_;
+  const uint64_t numBlocks_;
+};
+
+} // namespace facebook::velox::parquet
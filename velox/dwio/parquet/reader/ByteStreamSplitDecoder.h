@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "velox/common/base/SimdUtil.h"
+
+namespace facebook::velox::parquet {
+
+namespace detail {
+#if XSIMD_WITH_AVX2
+using ByteBatch = xsimd::batch<uint8_t>;
+
+// Interleaves elements of type T of pairs of adjacent streams in 'in' into
+// 'out'. Each stream is kWidth / sizeof(T) batches of elements of type T.
+template <typename T, int32_t kWidth>
+inline void zipStreams(
+    const std::array<ByteBatch, kWidth>& in,
+    std::array<ByteBatch, kWidth>& out) {
+  constexpr int32_t kBatches = sizeof(T);
+  for (auto pair = 0; pair < kWidth / (2 * kBatches); ++pair) {
+    const auto* left = &in[2 * pair * kBatches];
+    const auto* right = left + kBatches;
+    auto* result = &out[2 * pair * kBatches];
+    for (auto i = 0; i < kBatches; ++i) {
+      auto leftBatch = simd::reinterpretBatch<T>(left[i]);
+      auto rightBatch = simd::reinterpretBatch<T>(right[i]);
+      result[2 * i] =
+          simd::reinterpretBatch<uint8_t>(xsimd::zip_lo(leftBatch, rightBatch));
+      result[2 * i + 1] =
+          simd::reinterpretBatch<uint8_t>(xsimd::zip_hi(leftBatch, rightBatch));
+    }
+  }
+}
+#endif
+
+template <int32_t kWidth>
+void decodeByteStreamSplit(
+    const char* FOLLY_NONNULL data,
+    int64_t numValues,
+    char* FOLLY_NONNULL values) {
+  int64_t row = 0;
+#if XSIMD_WITH_AVX2
+  // Transposes a batch of bytes from each stream at a time by interleaving
+  // bytes, then pairs of bytes and then quads.
+  std::array<ByteBatch, kWidth> streams;
+  std::array<ByteBatch, kWidth> zipped;
+  for (; row + ByteBatch::size <= numValues; row += ByteBatch::size) {
+    for (auto i = 0; i < kWidth; ++i) {
+      streams[i] = ByteBatch::load_unaligned(
+          reinterpret_cast<const uint8_t*>(data + i * numValues + row));
+    }
+    zipStreams<uint8_t, kWidth>(streams, zipped);
+    zipStreams<uint16_t, kWidth>(zipped, streams);
+    if constexpr (kWidth == 8) {
+      zipStreams<uint32_t, kWidth>(streams, zipped);
+      std::swap(streams, zipped);
+    }
+    auto* result = reinterpret_cast<uint8_t*>(values + row * kWidth);
+    for (auto i = 0; i < kWidth; ++i) {
+      streams[i].store_unaligned(result + i * ByteBatch::size);
+    }
+  }
+#endif
+  for (; row < numValues; ++row) {
+    for (auto i = 0; i < kWidth; ++i) {
+      values[row * kWidth + i] = data[i * numValues + row];
+    }
+  }
+}
+} // namespace detail
+
+/// Decodes the BYTE_STREAM_SPLIT encoding of 'numValues' values of 'width'
+/// bytes at 'data' into plain encoded values at 'values'. The encoding has
+/// the first bytes of all values followed by the second bytes and so on.
+inline void decodeByteStreamSplit(
+    const char* FOLLY_NONNULL data,
+    int64_t numValues,
+    int32_t width,
+    char* FOLLY_NONNULL values) {
+  switch (width) {
+    case 4:
+      detail::decodeByteStreamSplit<4>(data, numValues, values);
+      break;
+    case 8:
+      detail::decodeByteStreamSplit<8>(data, numValues, values);
+      break;
+    default:
+      VELOX_UNSUPPORTED("BYTE_STREAM_SPLIT of {} byte values", width);
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/util/bit_stream_utils.h> // @manual
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::parquet {
+
+/// Decodes the DELTA_BINARY_PACKED encoding. The values are in blocks of
+/// miniblocks of bit packed deltas from the previous value. Each block has a
+/// minimum delta that is added to all its deltas. The values are decoded a
+/// miniblock at a time, so reading a value is an add to the previous one.
+class DeltaBpDecoder {
+ public:
+  DeltaBpDecoder(const char* FOLLY_NONNULL start, const char* FOLLY_NONNULL end)
+      : bufferEnd_(end),
+        reader_(reinterpret_cast<const uint8_t*>(start), end - start) {
+    uint32_t numValues;
+    int64_t firstValue;
+    VELOX_CHECK(
+        reader_.GetVlqInt(&valuesPerBlock_) &&
+            reader_.GetVlqInt(&miniblocksPerBlock_) &&
+            reader_.GetVlqInt(&numValues) &&
+            reader_.GetZigZagVlqInt(&firstValue),
+        "Truncated DELTA_BINARY_PACKED header");
+    VELOX_CHECK_GT(miniblocksPerBlock_, 0);
+    VELOX_CHECK_EQ(valuesPerBlock_ % 128, 0);
+    valuesPerMiniblock_ = valuesPerBlock_ / miniblocksPerBlock_;
+    VELOX_CHECK_EQ(valuesPerMiniblock_ % 32, 0);
+    numValues_ = numValues;
+    numRemaining_ = numValues;
+    lastValue_ = firstValue;
+    bitWidths_.resize(miniblocksPerBlock_);
+    deltas_.resize(valuesPerMiniblock_);
+    miniblockIndex_ = miniblocksPerBlock_;
+  }
+
+  /// Returns the number of values in the encoded data.
+  int64_t numValues() const {
+    return numValues_;
+  }
+
+  /// Decodes the next 'numValues' values into 'values'. The arithmetic wraps
+  /// around, so 32 bit values are the low words of the 64 bit sums.
+  template <typename T>
+  void readValues(T* FOLLY_NONNULL values, int64_t numValues) {
+    VELOX_CHECK_LE(numValues, numRemaining_);
+    int64_t numRead = 0;
+    if (numValues > 0 && !firstValueRead_) {
+      values[numRead++] = static_cast<T>(lastValue_);
+      firstValueRead_ = true;
+      --numRemaining_;
+    }
+    while (numRead < numValues) {
+      if (numInMiniblock_ == 0) {
+        nextMiniblock();
+      }
+      const auto numDeltas =
+          std::min<int64_t>(numValues - numRead, numInMiniblock_);
+      VELOX_CHECK_EQ(
+          reader_.GetBatch(bitWidth_, deltas_.data(), numDeltas),
+          numDeltas,
+          "Truncated DELTA_BINARY_PACKED miniblock");
+      // Adding the minimum delta vectorizes. The prefix sum is a chain of
+      // dependent adds.
+      for (auto i = 0; i < numDeltas; ++i) {
+        deltas_[i] += minDelta_;
+      }
+      auto value = lastValue_;
+      for (auto i = 0; i < numDeltas; ++i) {
+        value += deltas_[i];
+        values[numRead + i] = static_cast<T>(value);
+      }
+      lastValue_ = value;
+      numRead += numDeltas;
+      numInMiniblock_ -= numDeltas;
+      numRemaining_ -= numDeltas;
+    }
+    if (numRemaining_ == 0 && numInMiniblock_ > 0) {
+      // Skips the padding of the last miniblock so that bufferStart() is at
+      // the end of the encoded data.
+      VELOX_CHECK(reader_.Advance(numInMiniblock_ * bitWidth_));
+      numInMiniblock_ = 0;
+    }
+  }
+
+  /// Returns the first byte after the values read so far. This is the end of
+  /// the encoded data after all values are read.
+  const char* FOLLY_NONNULL bufferStart() const {
+    return bufferEnd_ - reader_.bytes_left();
+  }
+
+ private:
+  // Moves to the next miniblock, reading the header of the next block if
+  // needed.
+  void nextMiniblock() {
+    if (miniblockIndex_ == miniblocksPerBlock_) {
+      int64_t minDelta;
+      VELOX_CHECK(
+          reader_.GetZigZagVlqInt(&minDelta),
+          "Truncated DELTA_BINARY_PACKED block header");
+      minDelta_ = minDelta;
+      for (auto i = 0; i < miniblocksPerBlock_; ++i) {
+        VELOX_CHECK(
+            reader_.GetAligned<uint8_t>(1, &bitWidths_[i]),
+            "Truncated DELTA_BINARY_PACKED block header");
+        VELOX_CHECK_LE(bitWidths_[i], 64);
+      }
+      miniblockIndex_ = 0;
+    }
+    bitWidth_ = bitWidths_[miniblockIndex_++];
+    numInMiniblock_ = valuesPerMiniblock_;
+  }
+
+  const char* FOLLY_NONNULL const bufferEnd_;
+  arrow::bit_util::BitReader reader_;
+
+  uint32_t valuesPerBlock_;
+  uint32_t miniblocksPerBlock_;
+  uint32_t valuesPerMiniblock_;
+  int64_t numValues_;
+  int64_t numRemaining_;
+
+  // The last value read. Starts at the first value.
+  uint64_t lastValue_;
+  bool firstValueRead_{false};
+
+  // Minimum delta and bit widths of the miniblocks of the current block.
+  uint64_t minDelta_{0};
+  std::vector<uint8_t> bitWidths_;
+
+  // Index of the next miniblock in the current block.
+  uint32_t miniblockIndex_;
+  uint8_t bitWidth_{0};
+  int64_t numInMiniblock_{0};
+
+  // Deltas of the current miniblock.
+  std::vector<uint64_t> deltas_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/Nulls.h"
+#include "velox/dwio/common/DecoderUtil.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+
+namespace facebook::velox::parquet {
+
+/// Decodes the DELTA_LENGTH_BYTE_ARRAY and DELTA_BYTE_ARRAY encodings of
+/// strings. DELTA_LENGTH_BYTE_ARRAY has the DELTA_BINARY_PACKED lengths
+/// followed by the concatenated strings. DELTA_BYTE_ARRAY has the
+/// DELTA_BINARY_PACKED lengths of the prefixes shared with the previous
+/// string followed by the suffixes in DELTA_LENGTH_BYTE_ARRAY. All the strings
+/// of the page are located when the decoder is made, so that the strings of
+/// DELTA_LENGTH_BYTE_ARRAY are not copied and the strings of DELTA_BYTE_ARRAY
+/// are assembled once.
+class DeltaByteArrayDecoder {
+ public:
+  DeltaByteArrayDecoder(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end,
+      thrift::Encoding::type encoding) {
+    if (encoding == thrift::Encoding::DELTA_LENGTH_BYTE_ARRAY) {
+      readLengthsAndStrings(start, end);
+      return;
+    }
+    VELOX_CHECK_EQ(encoding, thrift::Encoding::DELTA_BYTE_ARRAY);
+    DeltaBpDecoder prefixDecoder(start, end);
+    std::vector<int32_t> prefixLengths(prefixDecoder.numValues());
+    prefixDecoder.readValues(prefixLengths.data(), prefixLengths.size());
+    readLengthsAndStrings(prefixDecoder.bufferStart(), end);
+    VELOX_CHECK_EQ(
+        prefixLengths.size(),
+        values_.size(),
+        "Different number of prefixes and suffixes in DELTA_BYTE_ARRAY");
+
+    int64_t totalLength = 0;
+    for (auto i = 0; i < values_.size(); ++i) {
+      totalLength += prefixLengths[i] + values_[i].size();
+    }
+    buffer_.resize(totalLength);
+    char* previous = nullptr;
+    int32_t previousLength = 0;
+    char* next = buffer_.data();
+    for (auto i = 0; i < values_.size(); ++i) {
+      const auto prefixLength = prefixLengths[i];
+      VELOX_CHECK(
+          prefixLength >= 0 && prefixLength <= previousLength,
+          "Invalid DELTA_BYTE_ARRAY prefix length {}",
+          prefixLength);
+      if (prefixLength > 0) {
+        std::memcpy(next, previous, prefixLength);
+      }
+      std::memcpy(next + prefixLength, values_[i].data(), values_[i].size());
+      previous = next;
+      previousLength = prefixLength + values_[i].size();
+      values_[i] = folly::StringPiece(next, previousLength);
+      next += previousLength;
+    }
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    index_ += numValues;
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        VELOX_DCHECK_LT(index_, values_.size());
+        toSkip = visitor.process(values_[index_++], atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
+ private:
+  // Sets 'values_' to the strings of the DELTA_LENGTH_BYTE_ARRAY encoded data
+  // between 'start' and 'end'.
+  void readLengthsAndStrings(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end) {
+    DeltaBpDecoder lengthDecoder(start, end);
+    std::vector<int32_t> lengths(lengthDecoder.numValues());
+    lengthDecoder.readValues(lengths.data(), lengths.size());
+    const char* data = lengthDecoder.bufferStart();
+    values_.resize(lengths.size());
+    for (auto i = 0; i < lengths.size(); ++i) {
+      VELOX_CHECK(
+          lengths[i] >= 0 && data + lengths[i] <= end,
+          "Invalid DELTA_LENGTH_BYTE_ARRAY length {}",
+          lengths[i]);
+      values_[i] = folly::StringPiece(data, lengths[i]);
+      data += lengths[i];
+    }
+  }
+
+  // The strings of the page. Points to the page data or to 'buffer_'.
+  std::vector<folly::StringPiece> values_;
+
+  // The assembled strings for DELTA_BYTE_ARRAY.
+  std::string buffer_;
+
+  // Index of the next string in 'values_'.
+  int32_t index_{0};
+};
+
+} // namespace facebook::velox::parquet
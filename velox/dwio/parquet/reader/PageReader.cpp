@@ -17,6 +17,8 @@
 #include "velox/dwio/parquet/reader/PageReader.h"
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/common/ColumnVisitors.h"
+#include "velox/dwio/parquet/reader/ByteStreamSplitDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
 #include "velox/dwio/parquet/reader/NestedStructureDecoder.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 #include "velox/vector/FlatVector.h"
@@ -31,9 +33,10 @@ namespace facebook::velox::parquet {
 using thrift::Encoding;
 using thrift::PageHeader;
 
-void PageReader::seekToPage(int64_t row) {
+void PageReader::seekToPage(int64_t row, bool skipFilteredOut) {
   defineDecoder_.reset();
   repeatDecoder_.reset();
+  pageFilteredOut_ = false;
   // 'rowOfPage_' is the row number of the first row of the next page.
   rowOfPage_ += numRowsInPage_;
   for (;;) {
@@ -42,6 +45,7 @@ void PageReader::seekToPage(int64_t row) {
       // This may happen if seeking to exactly end of row group.
       numRepDefsInPage_ = 0;
       numRowsInPage_ = 0;
+      pageFilteredOut_ = false;
       break;
     }
     PageHeader pageHeader = readPageHeader();
@@ -49,10 +53,14 @@ void PageReader::seekToPage(int64_t row) {
 
     switch (pageHeader.type) {
       case thrift::PageType::DATA_PAGE:
-        prepareDataPageV1(pageHeader, row);
+        if (!skipFilteredOutPage(pageHeader, skipFilteredOut)) {
+          prepareDataPageV1(pageHeader, row);
+        }
         break;
       case thrift::PageType::DATA_PAGE_V2:
-        prepareDataPageV2(pageHeader, row);
+        if (!skipFilteredOutPage(pageHeader, skipFilteredOut)) {
+          prepareDataPageV2(pageHeader, row);
+        }
         break;
       case thrift::PageType::DICTIONARY_PAGE:
         if (row == kRepDefOnly) {
@@ -75,6 +83,40 @@ void PageReader::seekToPage(int64_t row) {
   }
 }
 
+bool PageReader::skipFilteredOutPage(
+    const PageHeader& pageHeader,
+    bool skipFilteredOut) {
+  ++dataPageIndex_;
+  pageFilteredOut_ = skipFilteredOut &&
+      dataPageIndex_ < filteredOutPages_.size() &&
+      filteredOutPages_[dataPageIndex_];
+  if (!pageFilteredOut_) {
+    return false;
+  }
+  numRepDefsInPage_ = pageHeader.type == thrift::PageType::DATA_PAGE
+      ? pageHeader.data_page_header.num_values
+      : pageHeader.data_page_header_v2.num_values;
+  setPageRowInfo(false);
+  dwio::common::skipBytes(
+      pageHeader.compressed_page_size,
+      inputStream_.get(),
+      bufferStart_,
+      bufferEnd_);
+  return true;
+}
+
+const dwio::common::DictionaryValues& PageReader::readDictionaryPage() {
+  VELOX_CHECK_EQ(pageStart_, 0);
+  if (chunkSize_ > 0) {
+    PageHeader pageHeader = readPageHeader();
+    pageStart_ = pageDataStart_ + pageHeader.compressed_page_size;
+    if (pageHeader.type == thrift::PageType::DICTIONARY_PAGE) {
+      prepareDictionary(pageHeader);
+    }
+  }
+  return dictionary_;
+}
+
 PageHeader PageReader::readPageHeader() {
   if (bufferEnd_ == bufferStart_) {
     const void* buffer;
@@ -704,6 +746,7 @@ void PageReader::makeDecoder() {
               pageData_, pageData_ + encodedDataSize_);
           break;
         case thrift::Type::BYTE_ARRAY:
+          deltaByteArrayDecoder_.reset();
           stringDecoder_ = std::make_unique<StringDecoder>(
               pageData_, pageData_ + encodedDataSize_);
           break;
@@ -725,11 +768,61 @@ void PageReader::makeDecoder() {
       }
       break;
     case Encoding::DELTA_BINARY_PACKED:
+    case Encoding::BYTE_STREAM_SPLIT:
+      makeDecodedValuesDecoder();
+      break;
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY:
+    case Encoding::DELTA_BYTE_ARRAY:
+      VELOX_CHECK_EQ(
+          parquetType,
+          thrift::Type::BYTE_ARRAY,
+          "Encoding {} is only supported for BYTE_ARRAY",
+          encoding_);
+      stringDecoder_.reset();
+      deltaByteArrayDecoder_ = std::make_unique<DeltaByteArrayDecoder>(
+          pageData_, pageData_ + encodedDataSize_, encoding_);
+      break;
     default:
       VELOX_UNSUPPORTED("Encoding not supported yet");
   }
 }
 
+void PageReader::makeDecodedValuesDecoder() {
+  const auto parquetType = type_->parquetType_.value();
+  VELOX_CHECK(
+      parquetType == thrift::Type::INT32 || parquetType == thrift::Type::INT64 ||
+          (encoding_ == Encoding::BYTE_STREAM_SPLIT &&
+           (parquetType == thrift::Type::FLOAT ||
+            parquetType == thrift::Type::DOUBLE)),
+      "Encoding {} is not supported for type {}",
+      encoding_,
+      parquetType);
+  const auto width = parquetTypeBytes(parquetType);
+  int64_t numValues;
+  if (encoding_ == Encoding::DELTA_BINARY_PACKED) {
+    DeltaBpDecoder decoder(pageData_, pageData_ + encodedDataSize_);
+    numValues = decoder.numValues();
+    dwio::common::ensureCapacity<char>(
+        decodedValues_, numValues * width, &pool_);
+    if (parquetType == thrift::Type::INT32) {
+      decoder.readValues(decodedValues_->asMutable<int32_t>(), numValues);
+    } else {
+      decoder.readValues(decodedValues_->asMutable<int64_t>(), numValues);
+    }
+  } else {
+    numValues = encodedDataSize_ / width;
+    dwio::common::ensureCapacity<char>(
+        decodedValues_, numValues * width, &pool_);
+    decodeByteStreamSplit(
+        pageData_, numValues, width, decodedValues_->asMutable<char>());
+  }
+  directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
+      std::make_unique<dwio::common::SeekableArrayInputStream>(
+          decodedValues_->as<char>(), numValues * width),
+      false,
+      width);
+}
+
 void PageReader::skip(int64_t numRows) {
   if (!numRows && firstUnvisited_ != rowOfPage_ + numRowsInPage_) {
     // Return if no skip and position not at end of page or before first page.
@@ -744,6 +837,10 @@ void PageReader::skip(int64_t numRows) {
     toSkip -= rowOfPage_ - firstUnvisited_;
   }
   firstUnvisited_ += numRows;
+  if (pageFilteredOut_) {
+    // There is no decoder for a page skipped by the page index.
+    return;
+  }
 
   // Skip nulls
   toSkip = skipNulls(toSkip);
@@ -755,6 +852,8 @@ void PageReader::skip(int64_t numRows) {
     directDecoder_->skip(toSkip);
   } else if (stringDecoder_) {
     stringDecoder_->skip(toSkip);
+  } else if (deltaByteArrayDecoder_) {
+    deltaByteArrayDecoder_->skip(toSkip);
   } else if (booleanDecoder_) {
     booleanDecoder_->skip(toSkip);
   } else {
@@ -861,18 +960,28 @@ bool PageReader::rowsForPage(
     bool mayProduceNulls,
     folly::Range<const vector_size_t*>& rows,
     const uint64_t* FOLLY_NULLABLE& nulls) {
-  if (currentVisitorRow_ == numVisitorRows_) {
-    return false;
-  }
-  int32_t numToVisit;
-  // Check if the first row to go to is in the current page. If not, seek to the
-  // page that contains the row.
-  auto rowZero = visitBase_ + visitorRows_[currentVisitorRow_];
-  if (rowZero >= rowOfPage_ + numRowsInPage_) {
-    seekToPage(rowZero);
-    if (hasChunkRepDefs_) {
-      numLeafNullsConsumed_ = rowOfPage_;
+  for (;;) {
+    if (currentVisitorRow_ == numVisitorRows_) {
+      return false;
+    }
+    // Check if the first row to go to is in the current page. If not, seek to
+    // the page that contains the row.
+    auto rowZero = visitBase_ + visitorRows_[currentVisitorRow_];
+    if (rowZero >= rowOfPage_ + numRowsInPage_) {
+      seekToPage(rowZero, hasFilter);
+      if (hasChunkRepDefs_) {
+        numLeafNullsConsumed_ = rowOfPage_;
+      }
+    }
+    if (!pageFilteredOut_) {
+      break;
     }
+    VELOX_CHECK(
+        hasFilter, "Page skipped by the page index read without a filter");
+    // No row on the page passes the filter. The rows to visit on the page are
+    // consumed without decoding.
+    currentVisitorRow_ += numVisitorRowsOnPage();
+    firstUnvisited_ = visitBase_ + visitorRows_[currentVisitorRow_ - 1] + 1;
   }
   auto& scanState = reader.scanState();
   if (isDictionary()) {
@@ -903,21 +1012,7 @@ bool PageReader::rowsForPage(
 
   // Then check how many of the rows to visit are on the same page as the
   // current one.
-  int32_t firstOnNextPage = rowOfPage_ + numRowsInPage_ - visitBase_;
-  if (firstOnNextPage > visitorRows_[numVisitorRows_ - 1]) {
-    // All the remaining rows are on this page.
-    numToVisit = numVisitorRows_ - currentVisitorRow_;
-  } else {
-    // Find the last row in the rows to visit that is on this page.
-    auto rangeLeft = folly::Range<const int32_t*>(
-        visitorRows_ + currentVisitorRow_,
-        numVisitorRows_ - currentVisitorRow_);
-    auto it =
-        std::lower_bound(rangeLeft.begin(), rangeLeft.end(), firstOnNextPage);
-    assert(it != rangeLeft.end());
-    assert(it != rangeLeft.begin());
-    numToVisit = it - (visitorRows_ + currentVisitorRow_);
-  }
+  const int32_t numToVisit = numVisitorRowsOnPage();
   // If the page did not change and this is the first call, we can return a view
   // on the original visitor rows.
   if (rowOfPage_ == initialRowOfPage_ && currentVisitorRow_ == 0) {
@@ -955,6 +1050,22 @@ bool PageReader::rowsForPage(
   return true;
 }
 
+int32_t PageReader::numVisitorRowsOnPage() const {
+  int32_t firstOnNextPage = rowOfPage_ + numRowsInPage_ - visitBase_;
+  if (firstOnNextPage > visitorRows_[numVisitorRows_ - 1]) {
+    // All the remaining rows are on this page.
+    return numVisitorRows_ - currentVisitorRow_;
+  }
+  // Find the last row in the rows to visit that is on this page.
+  auto rangeLeft = folly::Range<const int32_t*>(
+      visitorRows_ + currentVisitorRow_, numVisitorRows_ - currentVisitorRow_);
+  auto it =
+      std::lower_bound(rangeLeft.begin(), rangeLeft.end(), firstOnNextPage);
+  assert(it != rangeLeft.end());
+  assert(it != rangeLeft.begin());
+  return it - (visitorRows_ + currentVisitorRow_);
+}
+
 const VectorPtr& PageReader::dictionaryValues(const TypePtr& type) {
   if (!dictionaryValues_) {
     dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
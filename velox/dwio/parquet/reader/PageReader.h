@@ -21,6 +21,7 @@
 #include "velox/dwio/common/DirectDecoder.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
 #include "velox/dwio/parquet/reader/BooleanDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaByteArrayDecoder.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/reader/RleBpDataDecoder.h"
 #include "velox/dwio/parquet/reader/StringDecoder.h"
@@ -106,6 +107,12 @@ class PageReader {
   /// are no nulls, buffer may be set to nullptr.
   void readNullsOnly(int64_t numValues, BufferPtr& buffer);
 
+  /// Reads the dictionary page at the start of the column chunk without
+  /// reading the data pages. Returns an empty dictionary if the chunk does not
+  /// start with a dictionary page. Used for skipping row groups where no
+  /// dictionary value passes the filter.
+  const dwio::common::DictionaryValues& readDictionaryPage();
+
   // Returns the current string dictionary as a FlatVector<StringView>.
   const VectorPtr& dictionaryValues(const TypePtr& type);
 
@@ -130,6 +137,16 @@ class PageReader {
   // bufferEnd_ to the corresponding positions.
   thrift::PageHeader readPageHeader();
 
+  /// Sets the data pages of the column chunk that have no value passing the
+  /// filter of the column according to the page index. 'filteredOutPages[i]'
+  /// is true if the i-th data page is skipped without decompressing or
+  /// decoding it when reading with a filter. Only top level columns are
+  /// supported.
+  void setFilteredOutPages(std::vector<bool> filteredOutPages) {
+    VELOX_CHECK(isTopLevel_);
+    filteredOutPages_ = std::move(filteredOutPages);
+  }
+
  private:
   // Indicates that we only want the repdefs for the next page. Used when
   // prereading repdefs with seekToPage.
@@ -161,8 +178,17 @@ class PageReader {
   // getting repdefs for the next page. If non-top level column, 'row'
   // is interpreted in terms of leaf rows, including leaf
   // nulls. Seeking ahead of pages covered by decodeRepDefs is not
-  // allowed for non-top level columns.
-  void seekToPage(int64_t row);
+  // allowed for non-top level columns. If 'skipFilteredOut' is true, a
+  // found page in 'filteredOutPages_' is skipped without decoding and
+  // 'pageFilteredOut_' is set.
+  void seekToPage(int64_t row, bool skipFilteredOut = false);
+
+  // Skips the data page of 'pageHeader' if 'skipFilteredOut' is true and the
+  // page is in 'filteredOutPages_'. Sets the row info of the page and returns
+  // true if the page is skipped.
+  bool skipFilteredOutPage(
+      const thrift::PageHeader& pageHeader,
+      bool skipFilteredOut);
 
   // Preloads the repdefs for the column chunk. To avoid preloading,
   // would need a way too clone the input stream so that one stream
@@ -186,6 +212,10 @@ class PageReader {
   void prepareDictionary(const thrift::PageHeader& pageHeader);
   void makeDecoder();
 
+  // Sets 'directDecoder_' to read the plain encoded values decoded from the
+  // DELTA_BINARY_PACKED or BYTE_STREAM_SPLIT encoded page.
+  void makeDecodedValuesDecoder();
+
   // For a non-top level leaf, reads the defs and sets 'leafNulls_' and
   // 'numRowsInPage_' accordingly. This is used for non-top level leaves when
   // 'hasChunkRepDefs_' is false.
@@ -240,6 +270,10 @@ class PageReader {
       folly::Range<const vector_size_t*>& rows,
       const uint64_t* FOLLY_NULLABLE& nulls);
 
+  // Returns the number of rows to visit starting at 'currentVisitorRow_' that
+  // are on the current page.
+  int32_t numVisitorRowsOnPage() const;
+
   // Calls the visitor, specialized on the data type since not all visitors
   // apply to all types.
   template <
@@ -289,6 +323,9 @@ class PageReader {
         nullsFromFastPath = dwio::common::useFastPath<Visitor, true>(visitor);
         auto dictVisitor = visitor.toStringDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<true>(nulls, dictVisitor);
+      } else if (deltaByteArrayDecoder_) {
+        nullsFromFastPath = false;
+        deltaByteArrayDecoder_->readWithVisitor<true>(nulls, visitor);
       } else {
         nullsFromFastPath = false;
         stringDecoder_->readWithVisitor<true>(nulls, visitor);
@@ -297,6 +334,8 @@ class PageReader {
       if (isDictionary()) {
         auto dictVisitor = visitor.toStringDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<false>(nullptr, dictVisitor);
+      } else if (deltaByteArrayDecoder_) {
+        deltaByteArrayDecoder_->readWithVisitor<false>(nulls, visitor);
       } else {
         stringDecoder_->readWithVisitor<false>(nulls, visitor);
       }
@@ -367,6 +406,19 @@ class PageReader {
   // Number of leaf values in each data page of column chunk.
   std::vector<int32_t> numLeavesInPage_;
 
+  // True for the data pages that have no value passing the filter according
+  // to the page index. Indexed by the ordinal of the data page in the column
+  // chunk.
+  std::vector<bool> filteredOutPages_;
+
+  // Ordinal of the current data page in the column chunk. -1 means before the
+  // first data page.
+  int32_t dataPageIndex_{-1};
+
+  // True if the current page is skipped without decoding because none of its
+  // values passes the filter. There is no decoder for the page.
+  bool pageFilteredOut_{false};
+
   // First position in '*levels_' for the range of last decodeRepDefs().
   int32_t repDefBegin_{0};
 
@@ -408,6 +460,9 @@ class PageReader {
   // Uncompressed data for the page. Rep-def-data in V1, data alone in V2.
   BufferPtr uncompressedData_;
 
+  // Plain encoded values of a DELTA_BINARY_PACKED or BYTE_STREAM_SPLIT page.
+  BufferPtr decodedValues_;
+
   // First byte of uncompressed encoded data. Contains the encoded data as a
   // contiguous run of bytes.
   const char* FOLLY_NULLABLE pageData_{nullptr};
@@ -472,6 +527,7 @@ class PageReader {
   std::unique_ptr<RleBpDataDecoder> dictionaryIdDecoder_;
   std::unique_ptr<StringDecoder> stringDecoder_;
   std::unique_ptr<BooleanDecoder> booleanDecoder_;
+  std::unique_ptr<DeltaByteArrayDecoder> deltaByteArrayDecoder_;
   // Add decoders for other encodings here.
 };
 
@@ -21,10 +21,31 @@ namespace facebook::velox::parquet {
 
 using thrift::RowGroup;
 
+namespace {
+// Reads a thrift struct of type T from 'stream'.
+template <typename T>
+T readThriftStruct(dwio::common::SeekableInputStream& stream) {
+  const void* buffer;
+  int32_t size;
+  VELOX_CHECK(stream.Next(&buffer, &size), "Reading past end of page index");
+  auto bufferStart = reinterpret_cast<const char*>(buffer);
+  auto bufferEnd = bufferStart + size;
+  std::shared_ptr<thrift::ThriftTransport> transport =
+      std::make_shared<thrift::ThriftStreamingTransport>(
+          &stream, bufferStart, bufferEnd);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport> protocol(
+      transport);
+  T result;
+  result.read(&protocol);
+  return result;
+}
+} // namespace
+
 std::unique_ptr<dwio::common::FormatData> ParquetParams::toFormatData(
     const std::shared_ptr<const dwio::common::TypeWithId>& type,
-    const common::ScanSpec& /*scanSpec*/) {
-  return std::make_unique<ParquetData>(type, metaData_.row_groups, pool());
+    const common::ScanSpec& scanSpec) {
+  return std::make_unique<ParquetData>(
+      type, metaData_.row_groups, scanSpec, pool());
 }
 
 void ParquetData::filterRowGroups(
@@ -107,6 +128,79 @@ void ParquetData::enqueueRowGroup(
 
   auto id = dwio::common::StreamIdentifier(type_->column);
   streams_[index] = input.enqueue({chunkReadOffset, readSize}, &id);
+
+  if (canSkipPages(chunk)) {
+    columnIndexStreams_.resize(rowGroups_.size());
+    offsetIndexStreams_.resize(rowGroups_.size());
+    columnIndexStreams_[index] = input.enqueue(
+        {static_cast<uint64_t>(chunk.column_index_offset),
+         static_cast<uint64_t>(chunk.column_index_length)},
+        &id);
+    offsetIndexStreams_[index] = input.enqueue(
+        {static_cast<uint64_t>(chunk.offset_index_offset),
+         static_cast<uint64_t>(chunk.offset_index_length)},
+        &id);
+  }
+}
+
+bool ParquetData::canSkipPages(const thrift::ColumnChunk& chunk) const {
+  auto* filter = scanSpec_.filter();
+  // A filter that passes nulls may read the column with nulls only, which
+  // needs every page. Nested columns have page boundaries that are not on top
+  // level row boundaries.
+  if (!filter || filter->testNull() ||
+      filter->kind() == common::FilterKind::kIsNotNull || maxRepeat_ > 0 ||
+      maxDefine_ > 1) {
+    return false;
+  }
+  return chunk.__isset.column_index_offset &&
+      chunk.__isset.column_index_length && chunk.column_index_length > 0 &&
+      chunk.__isset.offset_index_offset && chunk.__isset.offset_index_length &&
+      chunk.offset_index_length > 0;
+}
+
+std::vector<bool> ParquetData::filteredOutPages(uint32_t index) {
+  auto columnIndex =
+      readThriftStruct<thrift::ColumnIndex>(*columnIndexStreams_[index]);
+  auto offsetIndex =
+      readThriftStruct<thrift::OffsetIndex>(*offsetIndexStreams_[index]);
+  columnIndexStreams_[index].reset();
+  offsetIndexStreams_[index].reset();
+
+  const auto& pages = offsetIndex.page_locations;
+  const auto numPages = pages.size();
+  const bool hasNullCounts = columnIndex.__isset.null_counts &&
+      columnIndex.null_counts.size() == numPages;
+  if (columnIndex.null_pages.size() != numPages ||
+      columnIndex.min_values.size() != numPages ||
+      columnIndex.max_values.size() != numPages) {
+    return {};
+  }
+  auto* filter = scanSpec_.filter();
+  const int64_t numRowsInRowGroup = rowGroups_[index].num_rows;
+  std::vector<bool> result(numPages);
+  for (auto i = 0; i < numPages; ++i) {
+    const int64_t numRowsInPage =
+        (i + 1 < numPages ? pages[i + 1].first_row_index : numRowsInRowGroup) -
+        pages[i].first_row_index;
+    // Makes column chunk statistics for the page so that the page is filtered
+    // the same way as row groups.
+    thrift::Statistics pageStats;
+    if (hasNullCounts) {
+      pageStats.__set_null_count(columnIndex.null_counts[i]);
+    } else if (columnIndex.null_pages[i]) {
+      pageStats.__set_null_count(numRowsInPage);
+    }
+    if (!columnIndex.null_pages[i]) {
+      pageStats.__set_min_value(columnIndex.min_values[i]);
+      pageStats.__set_max_value(columnIndex.max_values[i]);
+    }
+    auto columnStats =
+        buildColumnStatisticsFromThrift(pageStats, *type_->type, numRowsInPage);
+    result[i] = !testFilter(
+        filter, columnStats.get(), numRowsInPage, type_->type);
+  }
+  return result;
 }
 
 dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
@@ -120,6 +214,9 @@ dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
       type_,
       metadata.codec,
       metadata.total_compressed_size);
+  if (index < offsetIndexStreams_.size() && offsetIndexStreams_[index]) {
+    reader_->setFilteredOutPages(filteredOutPages(index));
+  }
   return dwio::common::PositionProvider(empty);
 }
 
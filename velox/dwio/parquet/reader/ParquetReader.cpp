@@ -18,12 +18,37 @@
 #include <thrift/protocol/TCompactProtocol.h> //@manual
 #include "velox/dwio/common/MetricsLog.h"
 #include "velox/dwio/common/TypeUtils.h"
+#include "velox/dwio/parquet/reader/PageReader.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 
 #include <folly/String.h>
 
 namespace facebook::velox::parquet {
+namespace {
+// The size to read for a Bloom filter header. The header has no fixed size but
+// is much smaller than this.
+constexpr uint64_t kBloomFilterHeaderSizeGuess = 256;
+
+// The parsed footer of a Parquet file, shared by the readers of the file
+// through a dwio::common::FileMetadataCache.
+struct ParquetFileMetadata : public dwio::common::FileMetadata {
+  // Thrift objects do not report their size. Estimated as a multiple of the
+  // size of the serialized footer.
+  static constexpr uint64_t kFooterExpansion = 4;
+
+  std::shared_ptr<thrift::FileMetaData> fileMetaData;
+  uint64_t footerLength{0};
+
+  uint64_t sizeInBytes() const override {
+    return footerLength * kFooterExpansion;
+  }
+
+  uint64_t unpooledBytes() const override {
+    return sizeInBytes();
+  }
+};
+} // namespace
 
 ReaderBase::ReaderBase(
     std::unique_ptr<dwio::common::BufferedInput> input,
@@ -42,6 +67,16 @@ ReaderBase::ReaderBase(
 }
 
 void ReaderBase::loadFileMetaData() {
+  auto* metadataCache = options_.fileMetadataCache();
+  if (metadataCache != nullptr) {
+    auto cached = std::dynamic_pointer_cast<const ParquetFileMetadata>(
+        metadataCache->get(*options_.fileMetadataKey()));
+    if (cached != nullptr) {
+      fileMetaData_ = cached->fileMetaData;
+      return;
+    }
+  }
+
   bool preloadFile_ = fileLength_ <= filePreloadThreshold_;
   uint64_t readSize =
       preloadFile_ ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
@@ -83,8 +118,198 @@ void ReaderBase::loadFileMetaData() {
   auto thriftProtocol = std::make_unique<
       apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>>(
       thriftTransport);
-  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
+  fileMetaData_ = std::make_shared<thrift::FileMetaData>();
   fileMetaData_->read(thriftProtocol.get());
+  if (metadataCache != nullptr) {
+    auto metadata = std::make_shared<ParquetFileMetadata>();
+    metadata->fileMetaData = fileMetaData_;
+    metadata->footerLength = footerLength;
+    metadataCache->put(*options_.fileMetadataKey(), std::move(metadata));
+  }
+
+  // The Bloom filters are usually written right before the footer, so they are
+  // often in the bytes read for the footer.
+  if (footerOffsetInBuffer == 0) {
+    return;
+  }
+  const uint64_t tailOffset = fileLength_ - readSize;
+  for (const auto& rowGroup : fileMetaData_->row_groups) {
+    for (const auto& column : rowGroup.columns) {
+      if (column.meta_data.__isset.bloom_filter_offset &&
+          column.meta_data.bloom_filter_offset >= 0 &&
+          static_cast<uint64_t>(column.meta_data.bloom_filter_offset) >=
+              tailOffset) {
+        footerTail_ = std::move(copy);
+        footerTailOffset_ = tailOffset;
+        return;
+      }
+    }
+  }
+}
+
+std::string ReaderBase::readFileBytes(uint64_t offset, uint64_t length) const {
+  VELOX_CHECK_LE(offset + length, fileLength_);
+  std::string result(length, '\0');
+  if (!footerTail_.empty() && offset >= footerTailOffset_) {
+    std::memcpy(
+        result.data(),
+        footerTail_.data() + (offset - footerTailOffset_),
+        length);
+    return result;
+  }
+  auto stream =
+      input_->read(offset, length, dwio::common::LogType::STRIPE_INDEX);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(
+      length, stream.get(), result.data(), bufferStart, bufferEnd);
+  return result;
+}
+
+std::unique_ptr<SplitBlockBloomFilter> ReaderBase::readBloomFilter(
+    const thrift::ColumnMetaData& columnMetaData) const {
+  if (!columnMetaData.__isset.bloom_filter_offset ||
+      columnMetaData.bloom_filter_offset <= 0) {
+    return nullptr;
+  }
+  const uint64_t offset = columnMetaData.bloom_filter_offset;
+  if (offset >= fileLength_) {
+    return nullptr;
+  }
+  auto header = readFileBytes(
+      offset, std::min(kBloomFilterHeaderSizeGuess, fileLength_ - offset));
+  std::shared_ptr<thrift::ThriftTransport> thriftTransport =
+      std::make_shared<thrift::ThriftBufferedTransport>(
+          header.data(), header.size());
+  auto thriftProtocol = std::make_unique<
+      apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>>(
+      thriftTransport);
+  thrift::BloomFilterHeader bloomFilterHeader;
+  const uint64_t headerSize = bloomFilterHeader.read(thriftProtocol.get());
+  if (!bloomFilterHeader.algorithm.__isset.BLOCK ||
+      !bloomFilterHeader.hash.__isset.XXHASH ||
+      !bloomFilterHeader.compression.__isset.UNCOMPRESSED ||
+      bloomFilterHeader.numBytes <= 0 ||
+      bloomFilterHeader.numBytes % SplitBlockBloomFilter::kBytesPerBlock != 0 ||
+      offset + headerSize + bloomFilterHeader.numBytes > fileLength_) {
+    return nullptr;
+  }
+  return std::make_unique<SplitBlockBloomFilter>(
+      readFileBytes(offset + headerSize, bloomFilterHeader.numBytes));
+}
+
+namespace {
+// Returns true if all the data pages of the column chunk of 'metaData' are
+// dictionary encoded. Without encoding stats, a chunk is taken to have no plain
+// encoded data pages if PLAIN_DICTIONARY is its only value encoding, as in
+// parquet-mr.
+bool isDictionaryEncodedOnly(const thrift::ColumnMetaData& metaData) {
+  if (metaData.__isset.encoding_stats) {
+    for (const auto& stats : metaData.encoding_stats) {
+      if ((stats.page_type == thrift::PageType::DATA_PAGE ||
+           stats.page_type == thrift::PageType::DATA_PAGE_V2) &&
+          stats.count > 0 &&
+          stats.encoding != thrift::Encoding::PLAIN_DICTIONARY &&
+          stats.encoding != thrift::Encoding::RLE_DICTIONARY) {
+        return false;
+      }
+    }
+    return true;
+  }
+  bool hasDictionary = false;
+  for (auto encoding : metaData.encodings) {
+    switch (encoding) {
+      case thrift::Encoding::PLAIN_DICTIONARY:
+        hasDictionary = true;
+        break;
+      case thrift::Encoding::RLE:
+      case thrift::Encoding::BIT_PACKED:
+        break;
+      default:
+        return false;
+    }
+  }
+  return hasDictionary;
+}
+
+template <typename T, typename Test>
+bool anyDictionaryValuePasses(
+    const dwio::common::DictionaryValues& dictionary,
+    Test test) {
+  auto* values = dictionary.values->as<T>();
+  for (auto i = 0; i < dictionary.numValues; ++i) {
+    if (test(values[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns false if no value in 'dictionary' passes 'filter'. Returns true if
+// some value passes or the type is not supported.
+bool dictionaryMayPass(
+    const dwio::common::DictionaryValues& dictionary,
+    const ParquetTypeWithId& type,
+    const common::Filter& filter) {
+  if (!dictionary.values) {
+    return true;
+  }
+  auto testInt64 = [&](auto value) { return filter.testInt64(value); };
+  switch (type.parquetType_.value()) {
+    case thrift::Type::INT32:
+      // Short decimals are widened to 64 bits in the dictionary.
+      return type.type->isShortDecimal()
+          ? anyDictionaryValuePasses<int64_t>(dictionary, testInt64)
+          : anyDictionaryValuePasses<int32_t>(dictionary, testInt64);
+    case thrift::Type::INT64:
+      return anyDictionaryValuePasses<int64_t>(dictionary, testInt64);
+    case thrift::Type::FIXED_LEN_BYTE_ARRAY:
+      return !type.type->isShortDecimal() ||
+          anyDictionaryValuePasses<int64_t>(dictionary, testInt64);
+    case thrift::Type::FLOAT:
+      return anyDictionaryValuePasses<float>(
+          dictionary, [&](float value) { return filter.testFloat(value); });
+    case thrift::Type::DOUBLE:
+      return anyDictionaryValuePasses<double>(
+          dictionary, [&](double value) { return filter.testDouble(value); });
+    case thrift::Type::BYTE_ARRAY:
+      if (type.type->kind() != TypeKind::VARCHAR &&
+          type.type->kind() != TypeKind::VARBINARY) {
+        return true;
+      }
+      return anyDictionaryValuePasses<StringView>(
+          dictionary, [&](StringView value) {
+            return filter.testBytes(value.data(), value.size());
+          });
+    default:
+      return true;
+  }
+}
+} // namespace
+
+dwio::common::DictionaryValues ReaderBase::readDictionary(
+    const ParquetTypeWithIdPtr& type,
+    const thrift::ColumnChunk& chunk) const {
+  const auto& metaData = chunk.meta_data;
+  if (!chunk.__isset.meta_data || !metaData.__isset.dictionary_page_offset ||
+      metaData.dictionary_page_offset < 4 ||
+      metaData.data_page_offset <= metaData.dictionary_page_offset ||
+      !isDictionaryEncodedOnly(metaData)) {
+    return {};
+  }
+  // The dictionary page is right before the first data page.
+  const uint64_t offset = metaData.dictionary_page_offset;
+  const uint64_t length = metaData.data_page_offset - offset;
+  if (offset + length > fileLength_) {
+    return {};
+  }
+  PageReader reader(
+      input_->read(offset, length, dwio::common::LogType::STRIPE_INDEX),
+      pool_,
+      type,
+      metaData.codec,
+      length);
+  return reader.readDictionaryPage();
 }
 
 void ReaderBase::initializeSchema() {
@@ -452,22 +677,17 @@ std::shared_ptr<const RowType> ReaderBase::createRowType(
 void ReaderBase::scheduleRowGroups(
     const std::vector<uint32_t>& rowGroupIds,
     int32_t currentGroup,
+    int32_t numGroupsAhead,
     StructColumnReader& reader) {
-  auto thisGroup = rowGroupIds[currentGroup];
-  auto nextGroup =
-      currentGroup + 1 < rowGroupIds.size() ? rowGroupIds[currentGroup + 1] : 0;
-  auto input = inputs_[thisGroup].get();
-  if (!input) {
-    auto newInput = input_->clone();
-    reader.enqueueRowGroup(thisGroup, *newInput);
-    newInput->load(dwio::common::LogType::STRIPE);
-    inputs_[thisGroup] = std::move(newInput);
-  }
-  if (nextGroup) {
-    auto newInput = input_->clone();
-    reader.enqueueRowGroup(nextGroup, *newInput);
-    newInput->load(dwio::common::LogType::STRIPE);
-    inputs_[nextGroup] = std::move(newInput);
+  const auto endGroup = std::min<size_t>(
+      rowGroupIds.size(), currentGroup + 1 + std::max(1, numGroupsAhead));
+  for (auto i = currentGroup; i < endGroup; ++i) {
+    auto& input = inputs_[rowGroupIds[i]];
+    if (!input) {
+      input = input_->clone();
+      reader.enqueueRowGroup(rowGroupIds[i], *input);
+      input->load(dwio::common::LogType::STRIPE);
+    }
   }
   if (currentGroup > 1) {
     inputs_.erase(rowGroupIds[currentGroup - 1]);
@@ -565,6 +785,12 @@ void ParquetRowReader::filterRowGroups() {
     if (rowGroupInRange) {
       if (i < res.totalCount && bits::isBitSet(res.filterResult.data(), i)) {
         ++skippedRowGroups_;
+      } else if (filteredOutByBloomFilters(rowGroups_[i])) {
+        ++skippedRowGroups_;
+        ++skippedRowGroupsByBloomFilter_;
+      } else if (filteredOutByDictionaries(rowGroups_[i])) {
+        ++skippedRowGroups_;
+        ++skippedRowGroupsByDictionary_;
       } else {
         rowGroupIds_.push_back(i);
       }
@@ -572,6 +798,59 @@ void ParquetRowReader::filterRowGroups() {
   }
 }
 
+bool ParquetRowReader::filteredOutByBloomFilters(
+    const thrift::RowGroup& rowGroup) const {
+  const auto& scanSpec = *options_.getScanSpec();
+  const auto& schema = readerBase_->schema();
+  const auto& schemaWithId = readerBase_->schemaWithId();
+  for (auto i = 0; i < schema->size(); ++i) {
+    auto* childSpec = scanSpec.childByName(schema->nameOf(i));
+    if (!childSpec || !childSpec->filter() || childSpec->filter()->testNull()) {
+      continue;
+    }
+    auto& type =
+        static_cast<const ParquetTypeWithId&>(*schemaWithId->childAt(i));
+    if (!type.isLeaf() || !type.parquetType_.has_value() ||
+        type.column >= rowGroup.columns.size()) {
+      continue;
+    }
+    auto bloomFilter =
+        readerBase_->readBloomFilter(rowGroup.columns[type.column].meta_data);
+    if (bloomFilter &&
+        !bloomFilter->mayContainAny(
+            *childSpec->filter(), type.parquetType_.value())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ParquetRowReader::filteredOutByDictionaries(
+    const thrift::RowGroup& rowGroup) const {
+  const auto& scanSpec = *options_.getScanSpec();
+  const auto& schema = readerBase_->schema();
+  const auto& schemaWithId = readerBase_->schemaWithId();
+  for (auto i = 0; i < schema->size(); ++i) {
+    auto* childSpec = scanSpec.childByName(schema->nameOf(i));
+    if (!childSpec || !childSpec->filter() || childSpec->filter()->testNull() ||
+        childSpec->filter()->kind() == common::FilterKind::kIsNotNull) {
+      continue;
+    }
+    auto type = std::static_pointer_cast<const ParquetTypeWithId>(
+        schemaWithId->childAt(i));
+    if (!type->isLeaf() || !type->parquetType_.has_value() ||
+        type->column >= rowGroup.columns.size()) {
+      continue;
+    }
+    auto dictionary =
+        readerBase_->readDictionary(type, rowGroup.columns[type->column]);
+    if (!dictionaryMayPass(dictionary, *type, *childSpec->filter())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
   VELOX_CHECK_GT(size, 0);
 
@@ -602,6 +881,7 @@ bool ParquetRowReader::advanceToNextRowGroup() {
   readerBase_->scheduleRowGroups(
       rowGroupIds_,
       currentRowGroupIdsIdx_,
+      options_.getStripeParallelism(),
       dynamic_cast<StructColumnReader&>(*columnReader_));
   currentRowGroupPtr_ = &rowGroups_[rowGroupIds_[currentRowGroupIdsIdx_]];
   rowsInCurrentRowGroup_ = currentRowGroupPtr_->num_rows;
@@ -614,6 +894,8 @@ bool ParquetRowReader::advanceToNextRowGroup() {
 void ParquetRowReader::updateRuntimeStats(
     dwio::common::RuntimeStatistics& stats) const {
   stats.skippedStrides += skippedRowGroups_;
+  stats.skippedStridesByBloomFilter += skippedRowGroupsByBloomFilter_;
+  stats.skippedStridesByDictionary += skippedRowGroupsByDictionary_;
   stats.processedStrides += rowGroupIds_.size();
 }
 
@@ -20,6 +20,7 @@
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
+#include "velox/dwio/parquet/reader/BloomFilter.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 
@@ -71,10 +72,12 @@ class ReaderBase {
   }
 
   /// Ensures that streams are enqueued and loading for the row group at
-  /// 'currentGroup'. May start loading one or more subsequent groups.
+  /// 'currentGroup'. Starts loading the next 'numGroupsAhead' groups, at least
+  /// one, if they are not already loading.
   void scheduleRowGroups(
       const std::vector<uint32_t>& groups,
       int32_t currentGroup,
+      int32_t numGroupsAhead,
       StructColumnReader& reader);
 
   /// Returns the uncompressed size for columns in 'type' and its children in
@@ -84,10 +87,27 @@ class ReaderBase {
       int32_t rowGroupIndex,
       const dwio::common::TypeWithId& type) const;
 
+  /// Returns the split block Bloom filter of the column chunk described by
+  /// 'columnMetaData' or nullptr if the chunk has no Bloom filter or its Bloom
+  /// filter is not supported.
+  std::unique_ptr<SplitBlockBloomFilter> readBloomFilter(
+      const thrift::ColumnMetaData& columnMetaData) const;
+
+  /// Returns the dictionary of the column chunk 'chunk' of 'type' if all of
+  /// its data pages are dictionary encoded. Returns an empty dictionary
+  /// otherwise. Reads only the dictionary page.
+  dwio::common::DictionaryValues readDictionary(
+      const ParquetTypeWithIdPtr& type,
+      const thrift::ColumnChunk& chunk) const;
+
  private:
   // Reads and parses file footer.
   void loadFileMetaData();
 
+  // Returns 'length' bytes at 'offset' in the file. The bytes come from
+  // 'footerTail_' if they are in it.
+  std::string readFileBytes(uint64_t offset, uint64_t length) const;
+
   void initializeSchema();
 
   std::shared_ptr<const ParquetTypeWithId> getParquetColumnInfo(
@@ -110,7 +130,16 @@ class ReaderBase {
   const dwio::common::ReaderOptions& options_;
   std::unique_ptr<velox::dwio::common::BufferedInput> input_;
   uint64_t fileLength_;
-  std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  // Shared with the readers of the same file if the file metadata cache is
+  // enabled.
+  std::shared_ptr<thrift::FileMetaData> fileMetaData_;
+
+  // The bytes read with the footer at 'footerTailOffset_' in the file. Kept
+  // only if some column chunk has its Bloom filter in them so that reading the
+  // Bloom filters takes no extra IO.
+  std::vector<char> footerTail_;
+  uint64_t footerTailOffset_{0};
+
   RowTypePtr schema_;
   std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
 
@@ -153,6 +182,15 @@ class ParquetRowReader : public dwio::common::RowReader {
   // ReaderBase and determines the set of row groups to scan.
   void filterRowGroups();
 
+  // Returns true if the Bloom filters of the column chunks in 'rowGroup' show
+  // that no row passes the filters in ScanSpec.
+  bool filteredOutByBloomFilters(const thrift::RowGroup& rowGroup) const;
+
+  // Returns true if no value in the dictionary of a filtered column chunk of
+  // 'rowGroup' passes the filter of the column. Only chunks where all the data
+  // pages are dictionary encoded are considered.
+  bool filteredOutByDictionaries(const thrift::RowGroup& rowGroup) const;
+
   // Positions the reader tre at the start of the next row group, as determined
   // by filterRowGroups().
   bool advanceToNextRowGroup();
@@ -171,9 +209,16 @@ class ParquetRowReader : public dwio::common::RowReader {
   uint64_t rowsInCurrentRowGroup_;
   uint64_t currentRowInGroup_;
 
-  // Number of row groups skipped based on stats.
+  // Number of row groups skipped based on stats, Bloom filters or
+  // dictionaries.
   int32_t skippedRowGroups_{0};
 
+  // Number of row groups skipped based on Bloom filters.
+  int32_t skippedRowGroupsByBloomFilter_{0};
+
+  // Number of row groups skipped based on dictionaries.
+  int32_t skippedRowGroupsByDictionary_{0};
+
   std::unique_ptr<dwio::common::SelectiveColumnReader> columnReader_;
 
   RowTypePtr requestedType_;
@@ -91,6 +91,7 @@ void StringColumnReader::read(
     RowSet rows,
     const uint64_t* incomingNulls) {
   prepareRead<folly::StringPiece>(offset, rows, incomingNulls);
+  dictionaryStrings_ = nullptr;
   bool isDense = rows.back() == rows.size() - 1;
   if (scanSpec_->keepValues()) {
     if (scanSpec_->valueHook()) {
@@ -145,6 +146,10 @@ void StringColumnReader::getValues(RowSet rows, VectorPtr* result) {
   rawStringSize_ = 0;
   rawStringUsed_ = 0;
   getFlatValues<StringView, StringView>(rows, result, type_);
+  if (dictionaryStrings_ && (*result)->isFlatEncoding()) {
+    (*result)->asFlatVector<StringView>()->addStringBuffer(dictionaryStrings_);
+  }
+  dictionaryStrings_ = nullptr;
 }
 
 void StringColumnReader::dedictionarize() {
@@ -157,23 +162,20 @@ void StringColumnReader::dedictionarize() {
     // 'values_' is sized for the batch worth of StringViews. It is filled with
     // 32 bit indices by dictionary scan.
     VELOX_CHECK_GE(valuesCapacity, numValues_ * sizeof(StringView));
-    stringBuffers_.clear();
-    rawStringBuffer_ = nullptr;
-    rawStringSize_ = 0;
-    rawStringUsed_ = 0;
-    auto numValues = numValues_;
+    // The StringViews point to the dictionary strings, which are added to the
+    // result in getValues() instead of being copied.
+    VELOX_CHECK_EQ(dict->stringBuffers().size(), 1);
+    dictionaryStrings_ = dict->stringBuffers()[0];
+    auto values = reinterpret_cast<StringView*>(rawValues_);
     // Convert indices to values in place. Loop from end to beginning
     // so as not to overwrite integer indices with longer StringViews.
-    for (auto i = numValues - 1; i >= 0; --i) {
+    for (auto i = numValues_ - 1; i >= 0; --i) {
       if (anyNulls_ && bits::isBitNull(rawResultNulls_, i)) {
-        reinterpret_cast<StringView*>(rawValues_)[i] = StringView();
+        values[i] = StringView();
         continue;
       }
-      auto& view = dict->valueAt(indices[i]);
-      numValues_ = i;
-      addStringValue(folly::StringPiece(view.data(), view.size()));
+      values[i] = dict->valueAt(indices[i]);
     }
-    numValues_ = numValues;
   }
   scanState_.clear();
   formatData_->as<ParquetData>().clearDictionary();
@@ -70,6 +70,10 @@ class StringColumnReader : public dwio::common::SelectiveColumnReader {
       common::Filter* filter,
       RowSet rows,
       ExtractValues extractValues);
+
+  // Strings of the dictionary of the pages before a switch to direct pages in
+  // the current read. The values from the dictionary pages point to these.
+  BufferPtr dictionaryStrings_;
 };
 
 } // namespace facebook::velox::parquet
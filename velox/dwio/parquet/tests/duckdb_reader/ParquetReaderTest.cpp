@@ -21,6 +21,7 @@
 #include "velox/type/Type.h"
 #include "velox/vector/ComplexVector.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <array>
 
@@ -96,6 +97,38 @@ TEST_F(ParquetReaderTest, readSampleFull) {
   assertReadExpected(*rowReader, expected);
 }
 
+TEST_F(ParquetReaderTest, readSampleScanRowGroupsAhead) {
+  const std::string sample(getExampleFilePath("sample.parquet"));
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(2);
+  auto expected = vectorMaker_->rowVector(
+      {rangeVector<int64_t>(20, 1), rangeVector<double>(20, 1)});
+
+  for (auto parallelism : {1, 2}) {
+    SCOPED_TRACE(fmt::format("parallelism: {}", parallelism));
+    ReaderOptions readerOptions{defaultPool.get()};
+    auto reader = createFileInput(sample, readerOptions);
+    auto rowReaderOpts = getReaderOpts(sampleSchema());
+    rowReaderOpts.setScanSpec(makeScanSpec(sampleSchema()));
+    rowReaderOpts.setDecodingExecutor(executor);
+    rowReaderOpts.setStripeParallelism(parallelism);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    assertReadExpected(*rowReader, expected);
+  }
+
+  // Destroying the reader while row groups are scanned ahead waits for the
+  // scans.
+  ReaderOptions readerOptions{defaultPool.get()};
+  auto reader = createFileInput(sample, readerOptions);
+  auto rowReaderOpts = getReaderOpts(sampleSchema());
+  rowReaderOpts.setScanSpec(makeScanSpec(sampleSchema()));
+  rowReaderOpts.setDecodingExecutor(executor);
+  rowReaderOpts.setStripeParallelism(1);
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+  VectorPtr result;
+  ASSERT_EQ(rowReader->next(10, result), 10);
+  rowReader.reset();
+}
+
 TEST_F(ParquetReaderTest, readSampleRange1) {
   const std::string sample(getExampleFilePath("sample.parquet"));
 
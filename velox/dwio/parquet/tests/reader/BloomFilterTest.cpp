@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#include <arrow/io/memory.h> // @manual
+#include <gtest/gtest.h>
+#include <parquet/bloom_filter.h> // @manual
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::common;
+using namespace facebook::velox::parquet;
+
+class BloomFilterTest : public testing::Test {
+ protected:
+  // Returns the bitset of 'filter' as written by Arrow.
+  static std::string bitset(const ::parquet::BlockSplitBloomFilter& filter) {
+    auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+    filter.WriteTo(sink.get());
+    auto buffer = sink->Finish().ValueOrDie();
+    std::shared_ptr<thrift::ThriftTransport> transport =
+        std::make_shared<thrift::ThriftBufferedTransport>(
+            buffer->data(), buffer->size());
+    apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>
+        protocol(transport);
+    thrift::BloomFilterHeader header;
+    const auto headerSize = header.read(&protocol);
+    EXPECT_EQ(headerSize + header.numBytes, buffer->size());
+    return std::string(
+        reinterpret_cast<const char*>(buffer->data()) + headerSize,
+        header.numBytes);
+  }
+};
+
+TEST_F(BloomFilterTest, integers) {
+  ::parquet::BlockSplitBloomFilter int32Filter;
+  ::parquet::BlockSplitBloomFilter int64Filter;
+  int32Filter.Init(1024);
+  int64Filter.Init(1024);
+  for (int32_t i = 0; i < 100; ++i) {
+    int32Filter.InsertHash(int32Filter.Hash(i * 1000));
+    int64Filter.InsertHash(int64Filter.Hash(static_cast<int64_t>(i * 1000)));
+  }
+  SplitBlockBloomFilter int32Bloom(bitset(int32Filter));
+  SplitBlockBloomFilter int64Bloom(bitset(int64Filter));
+  for (int32_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(int32Bloom.mayContain<int32_t>(i * 1000));
+    EXPECT_TRUE(int64Bloom.mayContain<int64_t>(i * 1000));
+  }
+
+  // 100 values in 1KB make false positives very unlikely.
+  auto present = createBigintValues({-7, 5000, 1234567}, false);
+  auto absent = createBigintValues({-7, 1234567, 7654321}, false);
+  EXPECT_TRUE(int32Bloom.mayContainAny(*present, thrift::Type::INT32));
+  EXPECT_TRUE(int64Bloom.mayContainAny(*present, thrift::Type::INT64));
+  EXPECT_FALSE(int32Bloom.mayContainAny(*absent, thrift::Type::INT32));
+  EXPECT_FALSE(int64Bloom.mayContainAny(*absent, thrift::Type::INT64));
+
+  EXPECT_TRUE(int64Bloom.mayContainAny(
+      BigintRange(3000, 3000, false), thrift::Type::INT64));
+  EXPECT_FALSE(int64Bloom.mayContainAny(
+      BigintRange(3001, 3001, false), thrift::Type::INT64));
+  // Ranges are not checked against the Bloom filter.
+  EXPECT_TRUE(int64Bloom.mayContainAny(
+      BigintRange(3001, 3002, false), thrift::Type::INT64));
+  // Values of a different physical type are not checked.
+  EXPECT_TRUE(int64Bloom.mayContainAny(*absent, thrift::Type::DOUBLE));
+}
+
+TEST_F(BloomFilterTest, strings) {
+  ::parquet::BlockSplitBloomFilter filter;
+  filter.Init(1024);
+  std::vector<std::string> values;
+  for (auto i = 0; i < 100; ++i) {
+    values.push_back(fmt::format("value{}", i));
+    ::parquet::ByteArray byteArray(
+        values.back().size(),
+        reinterpret_cast<const uint8_t*>(values.back().data()));
+    filter.InsertHash(filter.Hash(&byteArray));
+  }
+  SplitBlockBloomFilter bloom(bitset(filter));
+  for (const auto& value : values) {
+    EXPECT_TRUE(bloom.mayContain(std::string_view(value)));
+  }
+  EXPECT_TRUE(bloom.mayContainAny(
+      BytesValues({"other", "value12"}, false), thrift::Type::BYTE_ARRAY));
+  EXPECT_FALSE(bloom.mayContainAny(
+      BytesValues({"other", "value1000"}, false), thrift::Type::BYTE_ARRAY));
+  EXPECT_TRUE(bloom.mayContainAny(
+      BytesValues({"other", "value1000"}, false),
+      thrift::Type::FIXED_LEN_BYTE_ARRAY));
+}
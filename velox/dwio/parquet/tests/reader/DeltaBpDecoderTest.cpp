@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/common/base/BitUtil.h"
+#include "velox/dwio/parquet/reader/ByteStreamSplitDecoder.h"
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+class DeltaBpDecoderTest : public testing::Test {
+ protected:
+  static constexpr uint32_t kValuesPerBlock = 128;
+  static constexpr uint32_t kMiniblocksPerBlock = 4;
+  static constexpr uint32_t kValuesPerMiniblock =
+      kValuesPerBlock / kMiniblocksPerBlock;
+
+  // Returns 'values' in DELTA_BINARY_PACKED followed by 'trailer'.
+  static std::string encode(
+      const std::vector<int64_t>& values,
+      const std::string& trailer = "") {
+    std::vector<uint8_t> buffer(values.size() * 10 + 100);
+    arrow::bit_util::BitWriter writer(buffer.data(), buffer.size());
+    writer.PutVlqInt(kValuesPerBlock);
+    writer.PutVlqInt(kMiniblocksPerBlock);
+    writer.PutVlqInt(static_cast<uint32_t>(values.size()));
+    writer.PutZigZagVlqInt(values.empty() ? 0 : values[0]);
+    for (auto start = 1; start < values.size(); start += kValuesPerBlock) {
+      const auto end = std::min<size_t>(start + kValuesPerBlock, values.size());
+      std::vector<uint64_t> deltas;
+      for (auto i = start; i < end; ++i) {
+        deltas.push_back(
+            static_cast<uint64_t>(values[i]) -
+            static_cast<uint64_t>(values[i - 1]));
+      }
+      const auto minDelta = static_cast<uint64_t>(*std::min_element(
+          deltas.begin(), deltas.end(), [](uint64_t left, uint64_t right) {
+            return static_cast<int64_t>(left) < static_cast<int64_t>(right);
+          }));
+      writer.PutZigZagVlqInt(static_cast<int64_t>(minDelta));
+      uint8_t bitWidths[kMiniblocksPerBlock] = {};
+      for (auto i = 0; i < deltas.size(); ++i) {
+        deltas[i] -= minDelta;
+        auto& bitWidth = bitWidths[i / kValuesPerMiniblock];
+        bitWidth = std::max<uint8_t>(
+            bitWidth, deltas[i] == 0 ? 0 : 64 - __builtin_clzll(deltas[i]));
+      }
+      for (auto bitWidth : bitWidths) {
+        writer.PutAligned<uint8_t>(bitWidth, 1);
+      }
+      deltas.resize(bits::roundUp(deltas.size(), kValuesPerMiniblock));
+      for (auto i = 0; i < deltas.size(); ++i) {
+        writer.PutValue(deltas[i], bitWidths[i / kValuesPerMiniblock]);
+      }
+    }
+    writer.Flush();
+    std::string result(
+        reinterpret_cast<const char*>(buffer.data()), writer.bytes_written());
+    return result + trailer;
+  }
+
+  // Decodes 'encoded' as 'T' in batches of 'batchSize' and expects 'values'.
+  template <typename T>
+  static void testDecode(
+      const std::vector<int64_t>& values,
+      int32_t batchSize,
+      const std::string& trailer = "x") {
+    auto encoded = encode(values, trailer);
+    DeltaBpDecoder decoder(encoded.data(), encoded.data() + encoded.size());
+    ASSERT_EQ(decoder.numValues(), values.size());
+    std::vector<T> result(values.size());
+    for (auto i = 0; i < values.size(); i += batchSize) {
+      decoder.readValues(
+          result.data() + i,
+          std::min<int64_t>(batchSize, values.size() - i));
+    }
+    for (auto i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(result[i], static_cast<T>(values[i])) << "at " << i;
+    }
+    EXPECT_EQ(
+        decoder.bufferStart(), encoded.data() + encoded.size() - trailer.size());
+  }
+};
+
+TEST_F(DeltaBpDecoderTest, smallDeltas) {
+  folly::Random::DefaultGenerator rng(1);
+  std::vector<int64_t> values;
+  int64_t value = 1000;
+  for (auto i = 0; i < 1000; ++i) {
+    value += folly::Random::rand32(rng) % 100 - 30;
+    values.push_back(value);
+  }
+  for (auto batchSize : {1, 17, 32, 1000}) {
+    testDecode<int64_t>(values, batchSize);
+    testDecode<int32_t>(values, batchSize);
+  }
+}
+
+TEST_F(DeltaBpDecoderTest, wideDeltas) {
+  folly::Random::DefaultGenerator rng(1);
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 300; ++i) {
+    values.push_back(folly::Random::rand64(rng));
+  }
+  testDecode<int64_t>(values, 300);
+  testDecode<int64_t>(values, 7);
+
+  std::vector<int64_t> int32Values;
+  for (auto i = 0; i < 300; ++i) {
+    int32Values.push_back(static_cast<int32_t>(folly::Random::rand32(rng)));
+  }
+  testDecode<int32_t>(int32Values, 300);
+}
+
+TEST_F(DeltaBpDecoderTest, fewValues) {
+  testDecode<int64_t>({}, 1);
+  testDecode<int64_t>({5}, 1);
+  testDecode<int64_t>({5, 5, 5}, 3);
+  testDecode<int32_t>({-1, 10, 3, 3, 1 << 30}, 2);
+  std::vector<int64_t> values(kValuesPerBlock + 1);
+  std::iota(values.begin(), values.end(), -10);
+  testDecode<int64_t>(values, values.size());
+}
+
+TEST(ByteStreamSplitTest, decode) {
+  for (auto numValues : {0, 1, 31, 32, 33, 100, 1000}) {
+    std::vector<int64_t> values(numValues);
+    std::vector<int32_t> values32(numValues);
+    folly::Random::DefaultGenerator rng(numValues);
+    for (auto i = 0; i < numValues; ++i) {
+      values[i] = folly::Random::rand64(rng);
+      values32[i] = folly::Random::rand32(rng);
+    }
+    std::string encoded(numValues * sizeof(int64_t), 0);
+    std::string encoded32(numValues * sizeof(int32_t), 0);
+    for (auto i = 0; i < numValues; ++i) {
+      for (auto byte = 0; byte < sizeof(int64_t); ++byte) {
+        encoded[byte * numValues + i] =
+            reinterpret_cast<const char*>(&values[i])[byte];
+      }
+      for (auto byte = 0; byte < sizeof(int32_t); ++byte) {
+        encoded32[byte * numValues + i] =
+            reinterpret_cast<const char*>(&values32[i])[byte];
+      }
+    }
+    std::vector<int64_t> result(numValues);
+    std::vector<int32_t> result32(numValues);
+    decodeByteStreamSplit(
+        encoded.data(),
+        numValues,
+        sizeof(int64_t),
+        reinterpret_cast<char*>(result.data()));
+    decodeByteStreamSplit(
+        encoded32.data(),
+        numValues,
+        sizeof(int32_t),
+        reinterpret_cast<char*>(result32.data()));
+    EXPECT_EQ(result, values);
+    EXPECT_EQ(result32, values32);
+  }
+}
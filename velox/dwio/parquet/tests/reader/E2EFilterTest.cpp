@@ -17,9 +17,12 @@
 #include "velox/dwio/common/tests/E2EFilterTestBase.h"
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include "velox/dwio/parquet/writer/Writer.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
 
 #include <folly/init/Init.h>
 
+#include <numeric>
+
 using namespace facebook::velox;
 using namespace facebook::velox::common;
 using namespace facebook::velox::dwio::common;
@@ -116,6 +119,48 @@ TEST_F(E2EFilterTest, integerDirect) {
       {"short_val", "int_val", "long_val"},
       20);
 }
+TEST_F(E2EFilterTest, integerDeltaBinaryPacked) {
+  writerProperties_ = ::parquet::WriterProperties::Builder()
+                          .disable_dictionary()
+                          ->encoding(::parquet::Encoding::DELTA_BINARY_PACKED)
+                          ->data_pagesize(4 * 1024)
+                          ->build();
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "long_null:bigint",
+      [&]() { makeAllNulls("long_null"); },
+      true,
+      {"short_val", "int_val", "long_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, pageIndex) {
+  // Small pages with a page index. 'long_val' is ascending so that range
+  // filters on it skip most pages. The columns are top level so that the page
+  // index is used.
+  writerProperties_ = ::parquet::WriterProperties::Builder()
+                          .disable_dictionary()
+                          ->data_pagesize(1024)
+                          ->enable_write_page_index()
+                          ->build();
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint",
+      [&]() {
+        for (auto i = 0; i < batchCount_; ++i) {
+          std::vector<int64_t> values(batchSize_);
+          std::iota(values.begin(), values.end(), i * batchSize_);
+          useSuppliedValues<int64_t>("long_val", i, values);
+        }
+      },
+      false,
+      {"short_val", "int_val", "long_val"},
+      20);
+}
+
 TEST_F(E2EFilterTest, compression) {
   for (const auto compression :
        {::parquet::Compression::SNAPPY,
@@ -239,6 +284,27 @@ TEST_F(E2EFilterTest, floatAndDoubleDirect) {
       20);
 }
 
+TEST_F(E2EFilterTest, floatAndDoubleByteStreamSplit) {
+  writerProperties_ =
+      ::parquet::WriterProperties::Builder()
+          .disable_dictionary()
+          ->encoding("float_val", ::parquet::Encoding::BYTE_STREAM_SPLIT)
+          ->encoding("double_val", ::parquet::Encoding::BYTE_STREAM_SPLIT)
+          ->encoding("float_null", ::parquet::Encoding::BYTE_STREAM_SPLIT)
+          ->data_pagesize(4 * 1024)
+          ->build();
+
+  testWithTypes(
+      "float_val:float,"
+      "double_val:double,"
+      "long_val:bigint,"
+      "float_null:float",
+      [&]() { makeAllNulls("float_null"); },
+      false,
+      {"float_val", "double_val", "float_null"},
+      20);
+}
+
 TEST_F(E2EFilterTest, floatAndDouble) {
   // float_val and double_val may be direct since the
   // values are random.float_val2 and double_val2 are expected to be
@@ -419,6 +485,26 @@ TEST_F(E2EFilterTest, stringDirect) {
       20);
 }
 
+TEST_F(E2EFilterTest, stringDeltaLengthByteArray) {
+  writerProperties_ =
+      ::parquet::WriterProperties::Builder()
+          .disable_dictionary()
+          ->encoding(::parquet::Encoding::DELTA_LENGTH_BYTE_ARRAY)
+          ->data_pagesize(4 * 1024)
+          ->build();
+
+  testWithTypes(
+      "string_val:string,"
+      "string_val_2:string",
+      [&]() {
+        makeStringUnique("string_val");
+        makeStringUnique("string_val_2");
+      },
+      true,
+      {"string_val", "string_val_2"},
+      20);
+}
+
 TEST_F(E2EFilterTest, stringDictionary) {
   testWithTypes(
       "string_val:string,"
@@ -434,6 +520,59 @@ TEST_F(E2EFilterTest, stringDictionary) {
       20);
 }
 
+TEST_F(E2EFilterTest, stringDictionaryOutput) {
+  // Batches read from dictionary encoded pages are dictionary vectors over the
+  // dictionary of the column chunk.
+  rowType_ = ROW({"string_val"}, {VARCHAR()});
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 7; ++i) {
+    strings.push_back(fmt::format("a string that is not inlined {}", i));
+  }
+  test::VectorMaker vectorMaker(leafPool_.get());
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    batches.push_back(vectorMaker.rowVector(
+        {"string_val"},
+        {vectorMaker.flatVector<StringView>(
+            1'000,
+            [&](auto row) { return StringView(strings[(row + i) % 7]); },
+            [](auto row) { return row % 11 == 0; })}));
+  }
+  writeToMemory(rowType_, batches, false);
+
+  dwio::common::ReaderOptions readerOpts{leafPool_.get()};
+  auto input = std::make_unique<BufferedInput>(
+      std::make_shared<InMemoryReadFile>(
+          std::string_view(sinkPtr_->getData(), sinkPtr_->size())),
+      readerOpts.getMemoryPool());
+  auto reader = makeReader(readerOpts, std::move(input));
+  auto spec = std::make_shared<ScanSpec>("root");
+  spec->addAllChildFields(*rowType_);
+  dwio::common::RowReaderOptions rowReaderOpts;
+  setUpRowReaderOptions(rowReaderOpts, spec);
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+
+  VectorPtr result = BaseVector::create(rowType_, 1, leafPool_.get());
+  VectorPtr dictionary;
+  auto batchIndex = 0;
+  while (rowReader->next(1'000, result)) {
+    auto values = BaseVector::loadedVectorShared(
+        result->as<RowVector>()->childAt(0));
+    ASSERT_EQ(values->encoding(), VectorEncoding::Simple::DICTIONARY);
+    if (!dictionary) {
+      dictionary = values->valueVector();
+    }
+    // All batches of the row group share the same dictionary.
+    ASSERT_EQ(values->valueVector().get(), dictionary.get());
+    for (auto i = 0; i < values->size(); ++i) {
+      ASSERT_TRUE(values->equalValueAt(
+          batches[batchIndex]->childAt(0).get(), i, i));
+    }
+    ++batchIndex;
+  }
+  EXPECT_EQ(batchIndex, batches.size());
+}
+
 TEST_F(E2EFilterTest, dedictionarize) {
   writerProperties_ = ::parquet::WriterProperties::Builder()
                           .max_row_group_length(10000000)
@@ -563,6 +702,81 @@ TEST_F(E2EFilterTest, largeMetadata) {
   EXPECT_EQ(1000, reader->numberOfRows());
 }
 
+TEST_F(E2EFilterTest, dictionaryRowGroupSkip) {
+  // Two row groups that have two distinct values in each column. The min and
+  // max of the row groups cover the filter values, so only the dictionaries
+  // show that no row passes.
+  rowType_ = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  test::VectorMaker vectorMaker(leafPool_.get());
+  std::vector<RowVectorPtr> batches;
+  batches.push_back(vectorMaker.rowVector(
+      {"c0", "c1"},
+      {vectorMaker.flatVector<int64_t>(
+           20'000, [](auto row) { return row % 2 == 0 ? 0 : 100; }),
+       vectorMaker.flatVector<StringView>(20'000, [](auto row) {
+         return row % 2 == 0 ? "apple"_sv : "banana"_sv;
+       })}));
+  writeToMemory(rowType_, batches, false);
+
+  auto countRows = [&](const std::string& column,
+                       std::unique_ptr<common::Filter> filter,
+                       RuntimeStatistics& stats) {
+    auto spec = std::make_shared<common::ScanSpec>("<root>");
+    spec->addAllChildFields(*rowType_);
+    spec->childByName(column)->setFilter(std::move(filter));
+    ReaderOptions readerOpts{leafPool_.get()};
+    RowReaderOptions rowReaderOpts;
+    std::string_view data(sinkPtr_->getData(), sinkPtr_->size());
+    auto input = std::make_unique<BufferedInput>(
+        std::make_shared<InMemoryReadFile>(data), readerOpts.getMemoryPool());
+    auto reader = makeReader(readerOpts, std::move(input));
+    setUpRowReaderOptions(rowReaderOpts, spec);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto result = BaseVector::create(rowType_, 1, leafPool_.get());
+    int64_t numRows = 0;
+    while (rowReader->next(1'000, result)) {
+      numRows += result->size();
+    }
+    rowReader->updateRuntimeStats(stats);
+    return numRows;
+  };
+
+  RuntimeStatistics stats;
+  EXPECT_EQ(
+      0,
+      countRows(
+          "c0", std::make_unique<common::BigintRange>(50, 50, false), stats));
+  EXPECT_EQ(2, stats.skippedStridesByDictionary);
+  EXPECT_EQ(2, stats.skippedStrides);
+
+  stats = RuntimeStatistics();
+  EXPECT_EQ(
+      10'000,
+      countRows(
+          "c0", std::make_unique<common::BigintRange>(100, 100, false), stats));
+  EXPECT_EQ(0, stats.skippedStridesByDictionary);
+
+  stats = RuntimeStatistics();
+  EXPECT_EQ(
+      0,
+      countRows(
+          "c1",
+          std::make_unique<common::BytesValues>(
+              std::vector<std::string>{"avocado"}, false),
+          stats));
+  EXPECT_EQ(2, stats.skippedStridesByDictionary);
+
+  stats = RuntimeStatistics();
+  EXPECT_EQ(
+      10'000,
+      countRows(
+          "c1",
+          std::make_unique<common::BytesValues>(
+              std::vector<std::string>{"apple", "avocado"}, false),
+          stats));
+  EXPECT_EQ(0, stats.skippedStridesByDictionary);
+}
+
 // Define main so that gflags get processed.
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
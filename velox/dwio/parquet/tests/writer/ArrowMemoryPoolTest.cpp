@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/ArrowMemoryPool.h"
+
+#include <arrow/buffer.h> // @manual
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+class ArrowMemoryPoolTest : public testing::Test {
+ protected:
+  std::shared_ptr<memory::MemoryPool> pool_ =
+      memory::addDefaultLeafMemoryPool();
+};
+
+TEST_F(ArrowMemoryPoolTest, allocations) {
+  ArrowMemoryPool arrowPool(*pool_);
+  EXPECT_EQ(pool_->getCurrentBytes(), 0);
+
+  uint8_t* data;
+  ASSERT_TRUE(arrowPool.Allocate(1000, 64, &data).ok());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % 64, 0);
+  EXPECT_EQ(arrowPool.bytes_allocated(), 1000);
+  EXPECT_GE(pool_->getCurrentBytes(), 1000);
+
+  ASSERT_TRUE(arrowPool.Reallocate(1000, 100'000, 64, &data).ok());
+  EXPECT_EQ(arrowPool.bytes_allocated(), 100'000);
+  EXPECT_GE(pool_->getCurrentBytes(), 100'000);
+
+  ASSERT_TRUE(arrowPool.Reallocate(100'000, 10, 64, &data).ok());
+  EXPECT_EQ(arrowPool.bytes_allocated(), 10);
+  arrowPool.Free(data, 10, 64);
+  EXPECT_EQ(arrowPool.bytes_allocated(), 0);
+  EXPECT_EQ(arrowPool.max_memory(), 100'000);
+  EXPECT_EQ(pool_->getCurrentBytes(), 0);
+
+  // Zero size allocations do not take memory from the Velox pool.
+  ASSERT_TRUE(arrowPool.Allocate(0, 64, &data).ok());
+  EXPECT_NE(data, nullptr);
+  EXPECT_EQ(pool_->getCurrentBytes(), 0);
+  ASSERT_TRUE(arrowPool.Reallocate(0, 500, 64, &data).ok());
+  EXPECT_EQ(arrowPool.bytes_allocated(), 500);
+  ASSERT_TRUE(arrowPool.Reallocate(500, 0, 64, &data).ok());
+  arrowPool.Free(data, 0, 64);
+  EXPECT_EQ(arrowPool.bytes_allocated(), 0);
+  EXPECT_EQ(pool_->getCurrentBytes(), 0);
+
+  // Arrow buffers allocated from the pool.
+  {
+    auto buffer = arrow::AllocateResizableBuffer(10'000, &arrowPool);
+    ASSERT_TRUE(buffer.ok());
+    EXPECT_GE(pool_->getCurrentBytes(), 10'000);
+    ASSERT_TRUE((*buffer)->Resize(50'000).ok());
+    EXPECT_GE(pool_->getCurrentBytes(), 50'000);
+  }
+  EXPECT_EQ(arrowPool.bytes_allocated(), 0);
+  EXPECT_EQ(pool_->getCurrentBytes(), 0);
+}
+
+TEST_F(ArrowMemoryPoolTest, outOfMemory) {
+  auto root =
+      memory::defaultMemoryManager().addRootPool("outOfMemory", 1 << 20);
+  auto leaf = root->addLeafChild("leaf");
+  ArrowMemoryPool arrowPool(*leaf);
+  uint8_t* data;
+  auto status = arrowPool.Allocate(2 << 20, 64, &data);
+  EXPECT_TRUE(status.IsOutOfMemory());
+  EXPECT_EQ(arrowPool.bytes_allocated(), 0);
+
+  ASSERT_TRUE(arrowPool.Allocate(1000, 64, &data).ok());
+  status = arrowPool.Reallocate(1000, 2 << 20, 64, &data);
+  EXPECT_TRUE(status.IsOutOfMemory());
+  EXPECT_EQ(arrowPool.bytes_allocated(), 1000);
+  arrowPool.Free(data, 1000, 64);
+  EXPECT_EQ(leaf->getCurrentBytes(), 0);
+}
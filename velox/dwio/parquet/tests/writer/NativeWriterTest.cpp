@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/dwio/common/tests/E2EFilterTestBase.h"
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::common;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::parquet;
+
+using dwio::common::MemorySink;
+
+// Writes with NativeWriter and reads back with the native Parquet reader.
+class NativeWriterTest : public E2EFilterTestBase {
+ protected:
+  void testWithTypes(
+      const std::string& columns,
+      std::function<void()> customize,
+      const std::vector<std::string>& filterable,
+      int32_t numCombinations) {
+    // The native writer supports only top level columns.
+    testScenario(columns, customize, false, filterable, numCombinations);
+
+    // Always test no null case.
+    auto newCustomize = [&]() {
+      if (customize) {
+        customize();
+      }
+      makeNotNull(0);
+    };
+    testScenario(columns, newCustomize, false, filterable, numCombinations);
+  }
+
+  void writeToMemory(
+      const TypePtr&,
+      const std::vector<RowVectorPtr>& batches,
+      bool /*forRowGroupSkip*/) override {
+    auto sink = std::make_unique<MemorySink>(*leafPool_, 200 * 1024 * 1024);
+    sinkPtr_ = sink.get();
+
+    NativeWriter writer(std::move(sink), *leafPool_, rowGroupSize_, options_);
+    for (auto& batch : batches) {
+      writer.write(batch);
+    }
+    writer.close();
+  }
+
+  std::unique_ptr<dwio::common::Reader> makeReader(
+      const dwio::common::ReaderOptions& opts,
+      std::unique_ptr<dwio::common::BufferedInput> input) override {
+    return std::make_unique<ParquetReader>(std::move(input), opts);
+  }
+
+  // Writes 'batches' and checks that they read back unchanged.
+  void writeAndRead(const std::vector<RowVectorPtr>& batches) {
+    rowType_ = asRowType(batches[0]->type());
+    filterGenerator_ = std::make_unique<FilterGenerator>(rowType_, 1);
+    writeToMemory(rowType_, batches, false);
+    uint64_t time = 0;
+    readWithoutFilter(
+        filterGenerator_->makeScanSpec(SubfieldFilters{}), batches, time);
+  }
+
+  BufferPtr makeIndices(
+      vector_size_t size,
+      std::function<vector_size_t(vector_size_t)> indexAt) {
+    auto indices = allocateIndices(size, leafPool_.get());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < size; ++i) {
+      rawIndices[i] = indexAt(i);
+    }
+    return indices;
+  }
+
+  NativeWriterOptions options_;
+  int32_t rowGroupSize_{10000};
+};
+
+TEST_F(NativeWriterTest, writerMagic) {
+  rowType_ = ROW({INTEGER()});
+  std::vector<RowVectorPtr> batches;
+  batches.push_back(std::static_pointer_cast<RowVector>(
+      test::BatchMaker::createBatch(rowType_, 20000, *leafPool_, nullptr, 0)));
+  writeToMemory(rowType_, batches, false);
+  auto data = sinkPtr_->getData();
+  auto size = sinkPtr_->size();
+  EXPECT_EQ("PAR1", std::string(data, 4));
+  EXPECT_EQ("PAR1", std::string(data + size - 4, 4));
+}
+
+TEST_F(NativeWriterTest, boolean) {
+  testWithTypes(
+      "boolean_val:boolean,"
+      "boolean_null:boolean",
+      [&]() { makeAllNulls("boolean_null"); },
+      {"boolean_val"},
+      20);
+}
+
+TEST_F(NativeWriterTest, integerDirect) {
+  options_.enableDictionary = false;
+  options_.dataPageSize = 4 * 1024;
+  testWithTypes(
+      "tiny_val:tinyint,"
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "long_null:bigint",
+      [&]() { makeAllNulls("long_null"); },
+      {"tiny_val", "short_val", "int_val", "long_val"},
+      20);
+}
+
+TEST_F(NativeWriterTest, integerDictionary) {
+  options_.dataPageSize = 4 * 1024;
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            "long_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true); // keepNulls
+
+        makeIntDistribution<int32_t>(
+            "int_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            100000000, // rareMax
+            false); // keepNulls
+
+        makeIntDistribution<int16_t>(
+            "short_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -999, // rareMin
+            30000, // rareMax
+            true); // keepNulls
+      },
+      {"short_val", "int_val", "long_val"},
+      20);
+}
+
+TEST_F(NativeWriterTest, dictionaryFallback) {
+  // The dictionary of 'long_val' exceeds the limit in the middle of each row
+  // group and the chunk falls back to plain encoding.
+  options_.dictionaryPageSizeLimit = 8 * 1024;
+  testWithTypes(
+      "int_val:int,"
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() {
+        makeIntDistribution<int32_t>(
+            "int_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            100000000, // rareMax
+            false); // keepNulls
+      },
+      {"int_val", "long_val", "string_val"},
+      10);
+}
+
+TEST_F(NativeWriterTest, floatAndDouble) {
+  testWithTypes(
+      "float_val:float,"
+      "double_val:double,"
+      "float_val2:float,"
+      "double_val2:double,"
+      "long_val:bigint,"
+      "float_null:float",
+      [&]() {
+        makeAllNulls("float_null");
+        makeQuantizedFloat<float>("float_val2", 200, true);
+        makeQuantizedFloat<double>("double_val2", 522, true);
+        makeReapeatingValues<float>("float_val2", 0, 100, 200, 10.1);
+        makeReapeatingValues<double>("double_val2", 0, 100, 200, 100.8);
+      },
+      {"float_val", "double_val", "float_val2", "double_val2", "float_null"},
+      20);
+}
+
+TEST_F(NativeWriterTest, string) {
+  testWithTypes(
+      "string_val:string,"
+      "string_val_2:string",
+      [&]() {
+        makeStringUnique("string_val");
+        makeStringDistribution("string_val_2", 100, true, false);
+      },
+      {"string_val", "string_val_2"},
+      20);
+}
+
+TEST_F(NativeWriterTest, stringDirect) {
+  options_.enableDictionary = false;
+  options_.dataPageSize = 4 * 1024;
+  testWithTypes(
+      "string_val:string,"
+      "string_null:string",
+      [&]() {
+        makeStringUnique("string_val");
+        makeAllNulls("string_null");
+      },
+      {"string_val"},
+      20);
+}
+
+TEST_F(NativeWriterTest, compression) {
+  for (const auto compression :
+       {thrift::CompressionCodec::SNAPPY, thrift::CompressionCodec::ZSTD}) {
+    options_.compression = compression;
+    options_.dataPageSize = 4 * 1024;
+    testWithTypes(
+        "int_val:int,"
+        "long_val:bigint,"
+        "string_val:string",
+        nullptr,
+        {"int_val", "long_val", "string_val"},
+        3);
+  }
+}
+
+TEST_F(NativeWriterTest, parallelColumns) {
+  folly::CPUThreadPoolExecutor executor(4);
+  options_.executor = &executor;
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string",
+      nullptr,
+      {"short_val", "int_val", "long_val", "double_val", "string_val"},
+      10);
+}
+
+TEST_F(NativeWriterTest, encodedInput) {
+  test::VectorMaker vectorMaker(leafPool_.get());
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    auto base = vectorMaker.flatVectorNullable<int64_t>(
+        {1, std::nullopt, 3, 100 + i});
+    auto strings = vectorMaker.flatVector<StringView>(
+        {"apple", "banana", "a longer string that is not inlined"});
+    batches.push_back(vectorMaker.rowVector(
+        {"c0", "c1", "c2", "c3"},
+        {BaseVector::wrapInDictionary(
+             nullptr,
+             makeIndices(1'000, [](auto row) { return row % 4; }),
+             1'000,
+             base),
+         BaseVector::wrapInDictionary(
+             nullptr,
+             makeIndices(1'000, [](auto row) { return (row * 7) % 3; }),
+             1'000,
+             strings),
+         BaseVector::wrapInConstant(1'000, i % 3, strings),
+         BaseVector::createNullConstant(BIGINT(), 1'000, leafPool_.get())}));
+  }
+  rowGroupSize_ = 1'500;
+  writeAndRead(batches);
+}
+
+TEST_F(NativeWriterTest, unsupportedType) {
+  test::VectorMaker vectorMaker(leafPool_.get());
+  auto batch = vectorMaker.rowVector(
+      {vectorMaker.arrayVector<int32_t>({{1, 2}, {3}})});
+  auto sink = std::make_unique<MemorySink>(*leafPool_, 1024);
+  NativeWriter writer(std::move(sink), *leafPool_, 100);
+  VELOX_ASSERT_THROW(
+      writer.write(batch), "Unsupported type in native Parquet writer");
+}
+
+// Define main so that gflags get processed.
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, false);
+  return RUN_ALL_TESTS();
+}
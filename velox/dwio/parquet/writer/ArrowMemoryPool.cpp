@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/ArrowMemoryPool.h"
+
+#include <cstring>
+
+namespace facebook::velox::parquet {
+namespace {
+// Arrow expects a valid, aligned pointer for zero size allocations. These do
+// not take memory from the Velox pool.
+alignas(memory::MemoryAllocator::kMaxAlignment) uint8_t kZeroSizeArea[1];
+} // namespace
+
+void ArrowMemoryPool::checkAlignment(int64_t alignment) const {
+  VELOX_CHECK_LE(
+      alignment,
+      pool_.getAlignment(),
+      "Arrow allocation alignment exceeds that of memory pool {}",
+      pool_.name());
+}
+
+void ArrowMemoryPool::updateBytesAllocated(int64_t delta) {
+  const auto allocated = bytesAllocated_ += delta;
+  auto max = maxMemory_.load();
+  while (allocated > max && !maxMemory_.compare_exchange_weak(max, allocated)) {
+  }
+}
+
+arrow::Status
+ArrowMemoryPool::Allocate(int64_t size, int64_t alignment, uint8_t** out) {
+  checkAlignment(alignment);
+  if (size == 0) {
+    *out = kZeroSizeArea;
+    return arrow::Status::OK();
+  }
+  try {
+    *out = reinterpret_cast<uint8_t*>(pool_.allocate(size));
+  } catch (const VeloxException& e) {
+    return arrow::Status::OutOfMemory(e.message());
+  }
+  updateBytesAllocated(size);
+  return arrow::Status::OK();
+}
+
+arrow::Status ArrowMemoryPool::Reallocate(
+    int64_t oldSize,
+    int64_t newSize,
+    int64_t alignment,
+    uint8_t** ptr) {
+  checkAlignment(alignment);
+  if (oldSize == 0) {
+    return Allocate(newSize, alignment, ptr);
+  }
+  if (newSize == 0) {
+    Free(*ptr, oldSize, alignment);
+    *ptr = kZeroSizeArea;
+    return arrow::Status::OK();
+  }
+  // Arrow expects '*ptr' to stay valid if the reallocation fails, so the new
+  // buffer is allocated before the old one is freed.
+  uint8_t* newPtr;
+  ARROW_RETURN_NOT_OK(Allocate(newSize, alignment, &newPtr));
+  ::memcpy(newPtr, *ptr, std::min(oldSize, newSize));
+  Free(*ptr, oldSize, alignment);
+  *ptr = newPtr;
+  return arrow::Status::OK();
+}
+
+void ArrowMemoryPool::Free(
+    uint8_t* buffer,
+    int64_t size,
+    int64_t /*alignment*/) {
+  if (size == 0) {
+    VELOX_DCHECK_EQ(buffer, kZeroSizeArea);
+    return;
+  }
+  pool_.free(buffer, size);
+  updateBytesAllocated(-size);
+}
+
+} // namespace facebook::velox::parquet
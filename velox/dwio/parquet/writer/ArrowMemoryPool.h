@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h> // @manual
+
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::parquet {
+
+/// Adapts a Velox leaf memory pool to the Arrow MemoryPool interface, so that
+/// the buffers allocated by Arrow, e.g. by the Arrow Parquet writer, are
+/// counted against the query memory and are subject to its limits and to
+/// memory arbitration. A failed Velox allocation is returned to Arrow as an
+/// OutOfMemory status.
+class ArrowMemoryPool : public arrow::MemoryPool {
+ public:
+  explicit ArrowMemoryPool(memory::MemoryPool& pool) : pool_(pool) {}
+
+  arrow::Status Allocate(int64_t size, int64_t alignment, uint8_t** out)
+      override;
+
+  arrow::Status Reallocate(
+      int64_t oldSize,
+      int64_t newSize,
+      int64_t alignment,
+      uint8_t** ptr) override;
+
+  void Free(uint8_t* buffer, int64_t size, int64_t alignment) override;
+
+  int64_t bytes_allocated() const override {
+    return bytesAllocated_;
+  }
+
+  int64_t max_memory() const override {
+    return maxMemory_;
+  }
+
+  std::string backend_name() const override {
+    return "velox";
+  }
+
+  memory::MemoryPool& pool() const {
+    return pool_;
+  }
+
+ private:
+  void checkAlignment(int64_t alignment) const;
+
+  void updateBytesAllocated(int64_t delta);
+
+  memory::MemoryPool& pool_;
+
+  std::atomic<int64_t> bytesAllocated_{0};
+  std::atomic<int64_t> maxMemory_{0};
+};
+
+} // namespace facebook::velox::parquet
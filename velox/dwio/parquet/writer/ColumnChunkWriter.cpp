@@ -0,0 +1,722 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/ColumnChunkWriter.h"
+
+#include <folly/container/F14Map.h>
+#include <snappy.h>
+#include <zstd.h>
+
+#include "velox/common/memory/AllocationPool.h"
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+#include "velox/dwio/parquet/writer/RleBpEncoder.h"
+
+namespace facebook::velox::parquet {
+
+using dwio::common::DataBuffer;
+
+namespace {
+
+// Maximum number of rows in a data page.
+constexpr int64_t kMaxRowsPerPage = 20'000;
+
+// Sets the size of 'buffer' to 0 while keeping its memory for reuse.
+template <typename T>
+void resetBuffer(DataBuffer<T>& buffer) {
+  if (buffer.capacity() > 0) {
+    buffer.resize(0);
+  }
+}
+
+void compress(
+    thrift::CompressionCodec::type codec,
+    const DataBuffer<char>& input,
+    DataBuffer<char>& output) {
+  switch (codec) {
+    case thrift::CompressionCodec::SNAPPY: {
+      output.resize(snappy::MaxCompressedLength(input.size()));
+      size_t size;
+      snappy::RawCompress(input.data(), input.size(), output.data(), &size);
+      output.resize(size);
+      break;
+    }
+    case thrift::CompressionCodec::ZSTD: {
+      output.resize(ZSTD_compressBound(input.size()));
+      const auto size = ZSTD_compress(
+          output.data(),
+          output.size(),
+          input.data(),
+          input.size(),
+          ZSTD_CLEVEL_DEFAULT);
+      VELOX_CHECK(
+          !ZSTD_isError(size),
+          "ZSTD returned an error: ",
+          ZSTD_getErrorName(size));
+      output.resize(size);
+      break;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported Parquet compression: {}", static_cast<int>(codec));
+  }
+}
+
+// Returns the key of 'value' in the dictionary hash table. Floating point
+// values are keyed by their bits so that NaNs and -0.0 get their own entries.
+template <typename P>
+auto dictionaryKey(P value) {
+  if constexpr (std::is_same_v<P, float>) {
+    return *reinterpret_cast<const uint32_t*>(&value);
+  } else if constexpr (std::is_same_v<P, double>) {
+    return *reinterpret_cast<const uint64_t*>(&value);
+  } else {
+    return value;
+  }
+}
+
+template <typename T, typename P>
+P toPhysical(const T& value) {
+  if constexpr (std::is_same_v<T, Date>) {
+    return value.days();
+  } else if constexpr (std::is_same_v<T, StringView>) {
+    return std::string_view(value.data(), value.size());
+  } else {
+    return value;
+  }
+}
+
+// Column chunk writer for a Velox type T stored as the Parquet physical type
+// P. The values are kept as dictionary indices while the dictionary is
+// enabled and otherwise as their PLAIN encoding.
+template <typename T, typename P>
+class TypedChunkWriter : public ColumnChunkWriter {
+ public:
+  TypedChunkWriter(
+      const std::string& name,
+      const TypePtr& type,
+      thrift::Type::type parquetType,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool)
+      : ColumnChunkWriter(name, type, parquetType, options, pool),
+        dictionary_(options.enableDictionary),
+        dictionaryIndex_(memory::StlAllocator<std::pair<const Key, int32_t>>(
+            pool)),
+        dictionaryValues_(memory::StlAllocator<P>(pool)),
+        indices_(pool),
+        values_(pool),
+        offsets_(pool),
+        stringPool_(&pool) {}
+
+ protected:
+  void appendValues(const DecodedVector& decoded, const SelectivityVector& rows)
+      override {
+    if (decoded.isConstantMapping()) {
+      appendRepeated(
+          toPhysical<T, P>(decoded.valueAt<T>(rows.begin())),
+          rows.countSelected());
+      return;
+    }
+    if (dictionary_ && !decoded.isIdentityMapping() &&
+        decoded.base()->size() <= rows.end() - rows.begin()) {
+      // Looks up each distinct entry of the base vector once.
+      baseIndices_.assign(decoded.base()->size(), -1);
+      rows.applyToSelected([&](auto row) {
+        const auto value = toPhysical<T, P>(decoded.valueAt<T>(row));
+        auto& index = baseIndices_[decoded.index(row)];
+        if (index < 0) {
+          updateMinMax(value);
+          index = dictionary_ ? dictionaryIndex(value) : 0;
+        }
+        if (dictionary_) {
+          indices_.append(index);
+        } else {
+          appendPlain(value);
+        }
+      });
+      return;
+    }
+    rows.applyToSelected([&](auto row) {
+      appendValue(toPhysical<T, P>(decoded.valueAt<T>(row)));
+    });
+  }
+
+  bool isDictionaryEncoded() const override {
+    return dictionary_;
+  }
+
+  int32_t dictionarySize() const override {
+    return dictionaryValues_.size();
+  }
+
+  void writeDictionary(DataBuffer<char>& out) const override {
+    for (auto i = 0; i < dictionaryValues_.size(); ++i) {
+      writePlain(dictionaryValues_[i], out);
+    }
+  }
+
+  int64_t valueBytes(int64_t index) const override {
+    if constexpr (kIsString) {
+      return valueOffset(index + 1) - valueOffset(index);
+    } else {
+      return sizeof(P);
+    }
+  }
+
+  void writePlainValues(int64_t begin, int64_t end, DataBuffer<char>& out)
+      const override {
+    const auto offset = valueOffset(begin);
+    out.extendAppend(
+        out.size(), values_.data() + offset, valueOffset(end) - offset);
+  }
+
+  const int32_t* dictionaryIndices() const override {
+    return indices_.data();
+  }
+
+  void setMinMax(thrift::Statistics& statistics) const override {
+    if (!hasMinMax_) {
+      return;
+    }
+    if constexpr (kIsString) {
+      statistics.__set_min_value(min_);
+      statistics.__set_max_value(max_);
+    } else {
+      statistics.__set_min_value(std::string(
+          reinterpret_cast<const char*>(&minValue_), sizeof(P)));
+      statistics.__set_max_value(std::string(
+          reinterpret_cast<const char*>(&maxValue_), sizeof(P)));
+    }
+  }
+
+  void resetValues() override {
+    dictionary_ = options_.enableDictionary;
+    dictionaryIndex_.clear();
+    dictionaryValues_.clear();
+    dictionaryBytes_ = 0;
+    resetBuffer(indices_);
+    resetBuffer(values_);
+    resetBuffer(offsets_);
+    stringPool_.clear();
+    hasMinMax_ = false;
+  }
+
+ private:
+  static constexpr bool kIsString = std::is_same_v<P, std::string_view>;
+
+  using Key = decltype(dictionaryKey(std::declval<P>()));
+
+  void appendValue(P value) {
+    updateMinMax(value);
+    if (dictionary_) {
+      const auto index = dictionaryIndex(value);
+      if (dictionary_) {
+        indices_.append(index);
+        return;
+      }
+    }
+    appendPlain(value);
+  }
+
+  void appendRepeated(P value, vector_size_t count) {
+    updateMinMax(value);
+    if (dictionary_) {
+      const auto index = dictionaryIndex(value);
+      if (dictionary_) {
+        for (auto i = 0; i < count; ++i) {
+          indices_.append(index);
+        }
+        return;
+      }
+    }
+    for (auto i = 0; i < count; ++i) {
+      appendPlain(value);
+    }
+  }
+
+  // Returns the dictionary index of 'value', adding it to the dictionary if
+  // needed. Switches the chunk to plain encoding if the dictionary exceeds its
+  // size limit.
+  int32_t dictionaryIndex(P value) {
+    auto it = dictionaryIndex_.find(dictionaryKey(value));
+    if (it != dictionaryIndex_.end()) {
+      return it->second;
+    }
+    if constexpr (kIsString) {
+      // Copies the string so that the dictionary does not refer to the input.
+      if (!value.empty()) {
+        auto* copy = stringPool_.allocateFixed(value.size());
+        memcpy(copy, value.data(), value.size());
+        value = std::string_view(copy, value.size());
+      }
+      dictionaryBytes_ += sizeof(int32_t) + value.size();
+    } else {
+      dictionaryBytes_ += sizeof(P);
+    }
+    const int32_t index = dictionaryValues_.size();
+    dictionaryValues_.push_back(value);
+    dictionaryIndex_.emplace(dictionaryKey(value), index);
+    if (dictionaryBytes_ > options_.dictionaryPageSizeLimit) {
+      fallbackToPlain();
+    }
+    return index;
+  }
+
+  // Replaces the dictionary indices with the plain encoded values.
+  void fallbackToPlain() {
+    dictionary_ = false;
+    for (auto i = 0; i < indices_.size(); ++i) {
+      appendPlain(dictionaryValues_[indices_[i]]);
+    }
+    dictionaryIndex_.clear();
+    dictionaryValues_.clear();
+    dictionaryBytes_ = 0;
+    resetBuffer(indices_);
+    stringPool_.clear();
+  }
+
+  void appendPlain(P value) {
+    if constexpr (kIsString) {
+      offsets_.append(values_.size());
+    }
+    writePlain(value, values_);
+  }
+
+  static void writePlain(P value, DataBuffer<char>& out) {
+    if constexpr (kIsString) {
+      const uint32_t length = value.size();
+      out.extendAppend(
+          out.size(), reinterpret_cast<const char*>(&length), sizeof(length));
+      out.extendAppend(out.size(), value.data(), value.size());
+    } else {
+      out.extendAppend(
+          out.size(), reinterpret_cast<const char*>(&value), sizeof(P));
+    }
+  }
+
+  // Returns the offset of the plain encoded value at 'index' in 'values_'.
+  int64_t valueOffset(int64_t index) const {
+    if constexpr (kIsString) {
+      return index < offsets_.size() ? offsets_[index] : values_.size();
+    } else {
+      return index * sizeof(P);
+    }
+  }
+
+  void updateMinMax(P value) {
+    if constexpr (std::is_floating_point_v<P>) {
+      if (std::isnan(value)) {
+        return;
+      }
+    }
+    if constexpr (kIsString) {
+      if (!hasMinMax_ || value < min_) {
+        min_ = value;
+      }
+      if (!hasMinMax_ || value > max_) {
+        max_ = value;
+      }
+    } else {
+      if (!hasMinMax_ || value < minValue_) {
+        minValue_ = value;
+      }
+      if (!hasMinMax_ || value > maxValue_) {
+        maxValue_ = value;
+      }
+    }
+    hasMinMax_ = true;
+  }
+
+  // True while the values are dictionary encoded.
+  bool dictionary_;
+
+  folly::F14FastMap<
+      Key,
+      int32_t,
+      folly::f14::DefaultHasher<Key>,
+      folly::f14::DefaultKeyEqual<Key>,
+      memory::StlAllocator<std::pair<const Key, int32_t>>>
+      dictionaryIndex_;
+
+  // Dictionary values in the order of their indices. Strings point to
+  // 'stringPool_'.
+  std::vector<P, memory::StlAllocator<P>> dictionaryValues_;
+
+  // Size of the plain encoded dictionary.
+  int64_t dictionaryBytes_{0};
+
+  // Dictionary index of each value while 'dictionary_' is true.
+  DataBuffer<int32_t> indices_;
+
+  // Plain encoded values after falling back to plain encoding.
+  DataBuffer<char> values_;
+
+  // Start of each string in 'values_'.
+  DataBuffer<int64_t> offsets_;
+
+  memory::AllocationPool stringPool_;
+
+  // Dictionary index of each base vector entry of the appended dictionary
+  // vector, -1 if not looked up yet.
+  std::vector<int32_t> baseIndices_;
+
+  bool hasMinMax_{false};
+  P minValue_{};
+  P maxValue_{};
+  std::string min_;
+  std::string max_;
+};
+
+// Column chunk writer for booleans, which are always plain encoded.
+class BoolChunkWriter : public ColumnChunkWriter {
+ public:
+  BoolChunkWriter(
+      const std::string& name,
+      const TypePtr& type,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool)
+      : ColumnChunkWriter(name, type, thrift::Type::BOOLEAN, options, pool),
+        values_(pool) {}
+
+ protected:
+  void appendValues(const DecodedVector& decoded, const SelectivityVector& rows)
+      override {
+    rows.applyToSelected([&](auto row) {
+      const bool value = decoded.valueAt<bool>(row);
+      hasValues_ = true;
+      hasTrue_ |= value;
+      hasFalse_ |= !value;
+      values_.append(value);
+    });
+  }
+
+  bool isDictionaryEncoded() const override {
+    return false;
+  }
+
+  int32_t dictionarySize() const override {
+    return 0;
+  }
+
+  void writeDictionary(DataBuffer<char>& /*out*/) const override {
+    VELOX_UNREACHABLE();
+  }
+
+  int64_t valueBytes(int64_t /*index*/) const override {
+    return 1;
+  }
+
+  void writePlainValues(int64_t begin, int64_t end, DataBuffer<char>& out)
+      const override {
+    // PLAIN booleans are bit packed starting from the least significant bit.
+    for (auto i = begin; i < end; i += 8) {
+      uint8_t byte = 0;
+      for (auto j = i; j < std::min(i + 8, end); ++j) {
+        byte |= values_[j] << (j - i);
+      }
+      out.append(static_cast<char>(byte));
+    }
+  }
+
+  const int32_t* dictionaryIndices() const override {
+    VELOX_UNREACHABLE();
+  }
+
+  void setMinMax(thrift::Statistics& statistics) const override {
+    if (hasValues_) {
+      statistics.__set_min_value(std::string(1, hasFalse_ ? 0 : 1));
+      statistics.__set_max_value(std::string(1, hasTrue_ ? 1 : 0));
+    }
+  }
+
+  void resetValues() override {
+    resetBuffer(values_);
+    hasValues_ = false;
+    hasTrue_ = false;
+    hasFalse_ = false;
+  }
+
+ private:
+  DataBuffer<uint8_t> values_;
+  bool hasValues_{false};
+  bool hasTrue_{false};
+  bool hasFalse_{false};
+};
+
+template <typename T, typename P>
+std::unique_ptr<ColumnChunkWriter> makeTypedWriter(
+    const std::string& name,
+    const TypePtr& type,
+    thrift::Type::type parquetType,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool) {
+  return std::make_unique<TypedChunkWriter<T, P>>(
+      name, type, parquetType, options, pool);
+}
+
+} // namespace
+
+// static
+std::unique_ptr<ColumnChunkWriter> ColumnChunkWriter::create(
+    const std::string& name,
+    const TypePtr& type,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<BoolChunkWriter>(name, type, options, pool);
+    case TypeKind::TINYINT:
+      return makeTypedWriter<int8_t, int32_t>(
+          name, type, thrift::Type::INT32, options, pool);
+    case TypeKind::SMALLINT:
+      return makeTypedWriter<int16_t, int32_t>(
+          name, type, thrift::Type::INT32, options, pool);
+    case TypeKind::INTEGER:
+      return makeTypedWriter<int32_t, int32_t>(
+          name, type, thrift::Type::INT32, options, pool);
+    case TypeKind::BIGINT:
+      return makeTypedWriter<int64_t, int64_t>(
+          name, type, thrift::Type::INT64, options, pool);
+    case TypeKind::REAL:
+      return makeTypedWriter<float, float>(
+          name, type, thrift::Type::FLOAT, options, pool);
+    case TypeKind::DOUBLE:
+      return makeTypedWriter<double, double>(
+          name, type, thrift::Type::DOUBLE, options, pool);
+    case TypeKind::DATE:
+      return makeTypedWriter<Date, int32_t>(
+          name, type, thrift::Type::INT32, options, pool);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return makeTypedWriter<StringView, std::string_view>(
+          name, type, thrift::Type::BYTE_ARRAY, options, pool);
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported type in native Parquet writer: {}", type->toString());
+  }
+}
+
+ColumnChunkWriter::ColumnChunkWriter(
+    const std::string& name,
+    const TypePtr& type,
+    thrift::Type::type parquetType,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool)
+    : name_(name),
+      type_(type),
+      parquetType_(parquetType),
+      options_(options),
+      pool_(pool),
+      definitionLevels_(pool),
+      page_(pool),
+      compressedPage_(pool) {}
+
+thrift::SchemaElement ColumnChunkWriter::schemaElement() const {
+  thrift::SchemaElement element;
+  element.__set_name(name_);
+  element.__set_type(parquetType_);
+  element.__set_repetition_type(thrift::FieldRepetitionType::OPTIONAL);
+  switch (type_->kind()) {
+    case TypeKind::TINYINT:
+      element.__set_converted_type(thrift::ConvertedType::INT_8);
+      break;
+    case TypeKind::SMALLINT:
+      element.__set_converted_type(thrift::ConvertedType::INT_16);
+      break;
+    case TypeKind::DATE:
+      element.__set_converted_type(thrift::ConvertedType::DATE);
+      break;
+    case TypeKind::VARCHAR:
+      element.__set_converted_type(thrift::ConvertedType::UTF8);
+      break;
+    default:
+      break;
+  }
+  return element;
+}
+
+void ColumnChunkWriter::append(
+    const BaseVector& vector,
+    vector_size_t begin,
+    vector_size_t end) {
+  if (begin == end) {
+    return;
+  }
+  SelectivityVector rows(end, false);
+  rows.setValidRange(begin, end, true);
+  rows.updateBounds();
+  DecodedVector decoded(vector, rows);
+  const auto numNullsBefore = numNulls_;
+  definitionLevels_.extend(end - begin);
+  for (auto row = begin; row < end; ++row) {
+    const bool isNull = decoded.isNullAt(row);
+    definitionLevels_.unsafeAppend(!isNull);
+    numNulls_ += isNull;
+  }
+  numRows_ += end - begin;
+  if (numNulls_ > numNullsBefore) {
+    rows.setValidRange(begin, end, false);
+    for (auto row = begin; row < end; ++row) {
+      if (!decoded.isNullAt(row)) {
+        rows.setValid(row, true);
+      }
+    }
+    rows.updateBounds();
+    if (!rows.hasSelections()) {
+      return;
+    }
+  }
+  appendValues(decoded, rows);
+}
+
+std::unique_ptr<EncodedColumnChunk> ColumnChunkWriter::finish() {
+  auto chunk = std::make_unique<EncodedColumnChunk>(pool_);
+  auto& metaData = chunk->metaData;
+  metaData.__set_total_uncompressed_size(0);
+  metaData.__set_total_compressed_size(0);
+
+  const bool dictionary = isDictionaryEncoded() && dictionarySize() > 0;
+  uint8_t bitWidth = 0;
+  if (dictionary) {
+    bitWidth = dictionarySize() == 1
+        ? 1
+        : 64 - bits::countLeadingZeros(dictionarySize() - 1);
+    resetBuffer(page_);
+    writeDictionary(page_);
+    thrift::DictionaryPageHeader dictionaryHeader;
+    dictionaryHeader.__set_num_values(dictionarySize());
+    dictionaryHeader.__set_encoding(thrift::Encoding::PLAIN);
+    thrift::PageHeader header;
+    header.__set_type(thrift::PageType::DICTIONARY_PAGE);
+    header.__set_dictionary_page_header(dictionaryHeader);
+    metaData.__set_dictionary_page_offset(0);
+    writePage(header, *chunk);
+  }
+  metaData.__set_data_page_offset(chunk->data.size());
+
+  int64_t rowBegin = 0;
+  int64_t valueBegin = 0;
+  do {
+    auto rowEnd = rowBegin;
+    auto valueEnd = valueBegin;
+    int64_t valueBytes = 0;
+    int64_t indexBits = 0;
+    while (rowEnd < numRows_ && rowEnd - rowBegin < kMaxRowsPerPage &&
+           valueBytes + indexBits / 8 < options_.dataPageSize) {
+      if (definitionLevels_[rowEnd]) {
+        if (dictionary) {
+          indexBits += bitWidth;
+        } else {
+          valueBytes += this->valueBytes(valueEnd);
+        }
+        ++valueEnd;
+      }
+      ++rowEnd;
+    }
+    writeDataPage(
+        rowBegin, rowEnd, valueBegin, valueEnd, dictionary, bitWidth, *chunk);
+    rowBegin = rowEnd;
+    valueBegin = valueEnd;
+  } while (rowBegin < numRows_);
+
+  if (dictionary) {
+    metaData.__set_encodings(
+        {thrift::Encoding::PLAIN,
+         thrift::Encoding::RLE,
+         thrift::Encoding::RLE_DICTIONARY});
+  } else {
+    metaData.__set_encodings({thrift::Encoding::PLAIN, thrift::Encoding::RLE});
+  }
+  metaData.__set_type(parquetType_);
+  metaData.__set_path_in_schema({name_});
+  metaData.__set_codec(options_.compression);
+  metaData.__set_num_values(numRows_);
+  thrift::Statistics statistics;
+  statistics.__set_null_count(numNulls_);
+  setMinMax(statistics);
+  metaData.__set_statistics(statistics);
+
+  resetBuffer(definitionLevels_);
+  numRows_ = 0;
+  numNulls_ = 0;
+  resetValues();
+  return chunk;
+}
+
+void ColumnChunkWriter::writeDataPage(
+    int64_t rowBegin,
+    int64_t rowEnd,
+    int64_t valueBegin,
+    int64_t valueEnd,
+    bool dictionary,
+    uint8_t bitWidth,
+    EncodedColumnChunk& chunk) {
+  resetBuffer(page_);
+  // Data page V1 starts with the length of the definition levels.
+  const uint32_t kPlaceholder = 0;
+  page_.extendAppend(
+      0, reinterpret_cast<const char*>(&kPlaceholder), sizeof(uint32_t));
+  RleBpEncoder::encode(
+      definitionLevels_.data() + rowBegin, rowEnd - rowBegin, 1, page_);
+  const uint32_t levelsSize = page_.size() - sizeof(uint32_t);
+  memcpy(page_.data(), &levelsSize, sizeof(uint32_t));
+
+  thrift::DataPageHeader dataHeader;
+  dataHeader.__set_num_values(rowEnd - rowBegin);
+  dataHeader.__set_definition_level_encoding(thrift::Encoding::RLE);
+  dataHeader.__set_repetition_level_encoding(thrift::Encoding::RLE);
+  if (dictionary) {
+    page_.append(static_cast<char>(bitWidth));
+    RleBpEncoder::encode(
+        dictionaryIndices() + valueBegin,
+        valueEnd - valueBegin,
+        bitWidth,
+        page_);
+    dataHeader.__set_encoding(thrift::Encoding::RLE_DICTIONARY);
+  } else {
+    writePlainValues(valueBegin, valueEnd, page_);
+    dataHeader.__set_encoding(thrift::Encoding::PLAIN);
+  }
+  thrift::PageHeader header;
+  header.__set_type(thrift::PageType::DATA_PAGE);
+  header.__set_data_page_header(dataHeader);
+  writePage(header, chunk);
+}
+
+void ColumnChunkWriter::writePage(
+    thrift::PageHeader& header,
+    EncodedColumnChunk& chunk) {
+  const char* data = page_.data();
+  int64_t size = page_.size();
+  if (options_.compression != thrift::CompressionCodec::UNCOMPRESSED) {
+    compress(options_.compression, page_, compressedPage_);
+    data = compressedPage_.data();
+    size = compressedPage_.size();
+  }
+  header.__set_uncompressed_page_size(page_.size());
+  header.__set_compressed_page_size(size);
+  const auto headerStart = chunk.data.size();
+  writeThriftObject(header, chunk.data);
+  const auto headerSize = chunk.data.size() - headerStart;
+  chunk.data.extendAppend(chunk.data.size(), data, size);
+
+  auto& metaData = chunk.metaData;
+  metaData.__set_total_uncompressed_size(
+      metaData.total_uncompressed_size + headerSize + page_.size());
+  metaData.__set_total_compressed_size(
+      metaData.total_compressed_size + headerSize + size);
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <thrift/transport/TBufferTransports.h> //@manual
+
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::parquet {
+
+struct NativeWriterOptions;
+
+/// Appends the compact protocol serialization of the thrift struct 'object' to
+/// 'out'.
+template <typename T>
+void writeThriftObject(const T& object, dwio::common::DataBuffer<char>& out) {
+  auto transport =
+      std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+  apache::thrift::protocol::TCompactProtocolT<
+      apache::thrift::transport::TMemoryBuffer>
+      protocol(transport);
+  object.write(&protocol);
+  uint8_t* data;
+  uint32_t size;
+  transport->getBuffer(&data, &size);
+  out.extendAppend(out.size(), reinterpret_cast<const char*>(data), size);
+}
+
+/// The encoded pages of a column chunk. The offsets in 'metaData' are relative
+/// to the start of 'data'.
+struct EncodedColumnChunk {
+  explicit EncodedColumnChunk(memory::MemoryPool& pool) : data(pool) {}
+
+  dwio::common::DataBuffer<char> data;
+  thrift::ColumnMetaData metaData;
+};
+
+/// Buffers the values of a top level column for a row group and encodes them
+/// into a column chunk. Values are dictionary encoded until the dictionary
+/// exceeds NativeWriterOptions::dictionaryPageSizeLimit, after which the chunk
+/// is plain encoded. All memory is allocated from 'pool'. Different instances
+/// can be used from different threads.
+class ColumnChunkWriter {
+ public:
+  static std::unique_ptr<ColumnChunkWriter> create(
+      const std::string& name,
+      const TypePtr& type,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool);
+
+  virtual ~ColumnChunkWriter() = default;
+
+  /// Returns the schema element of the column.
+  thrift::SchemaElement schemaElement() const;
+
+  /// Appends rows [begin, end) of 'vector'. Dictionary and constant vectors
+  /// are read through DecodedVector without flattening them.
+  void append(const BaseVector& vector, vector_size_t begin, vector_size_t end);
+
+  /// Returns the number of rows appended since the last finish().
+  int64_t numRows() const {
+    return numRows_;
+  }
+
+  /// Encodes the rows appended since the last finish() into a column chunk and
+  /// resets 'this' for the next row group.
+  std::unique_ptr<EncodedColumnChunk> finish();
+
+ protected:
+  ColumnChunkWriter(
+      const std::string& name,
+      const TypePtr& type,
+      thrift::Type::type parquetType,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool);
+
+  // Appends the non-null values of 'rows' in 'decoded'.
+  virtual void appendValues(
+      const DecodedVector& decoded,
+      const SelectivityVector& rows) = 0;
+
+  // Returns true if the buffered values are dictionary encoded.
+  virtual bool isDictionaryEncoded() const = 0;
+
+  // Returns the number of entries in the dictionary.
+  virtual int32_t dictionarySize() const = 0;
+
+  // Appends the plain encoded dictionary to 'out'.
+  virtual void writeDictionary(dwio::common::DataBuffer<char>& out) const = 0;
+
+  // Returns the approximate encoded size of the value at 'index'.
+  virtual int64_t valueBytes(int64_t index) const = 0;
+
+  // Appends the plain encoded values [begin, end) to 'out'.
+  virtual void writePlainValues(
+      int64_t begin,
+      int64_t end,
+      dwio::common::DataBuffer<char>& out) const = 0;
+
+  // Returns the dictionary indices of the values.
+  virtual const int32_t* FOLLY_NONNULL dictionaryIndices() const = 0;
+
+  // Sets the min and max of the values in 'statistics'.
+  virtual void setMinMax(thrift::Statistics& statistics) const = 0;
+
+  // Clears the values for the next row group.
+  virtual void resetValues() = 0;
+
+  const std::string name_;
+  const TypePtr type_;
+  const thrift::Type::type parquetType_;
+  const NativeWriterOptions& options_;
+  memory::MemoryPool& pool_;
+
+ private:
+  // Appends a data page of rows [rowBegin, rowEnd) with values [valueBegin,
+  // valueEnd) to 'chunk'. The values are written as dictionary indices of
+  // 'bitWidth' bits if 'dictionary' is true.
+  void writeDataPage(
+      int64_t rowBegin,
+      int64_t rowEnd,
+      int64_t valueBegin,
+      int64_t valueEnd,
+      bool dictionary,
+      uint8_t bitWidth,
+      EncodedColumnChunk& chunk);
+
+  // Compresses the page in 'page_' and appends it with 'header' to 'chunk'.
+  void writePage(thrift::PageHeader& header, EncodedColumnChunk& chunk);
+
+  // Definition level of each row appended since the last finish().
+  dwio::common::DataBuffer<uint8_t> definitionLevels_;
+  int64_t numRows_{0};
+  int64_t numNulls_{0};
+
+  // Reused buffers for the uncompressed and compressed page.
+  dwio::common::DataBuffer<char> page_;
+  dwio::common::DataBuffer<char> compressedPage_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+#include <folly/futures/Future.h>
+
+namespace facebook::velox::parquet {
+
+using dwio::common::DataBuffer;
+
+namespace {
+constexpr std::string_view kMagic{"PAR1"};
+
+void writeMagic(DataBuffer<char>& out) {
+  out.extendAppend(out.size(), kMagic.data(), kMagic.size());
+}
+} // namespace
+
+NativeWriter::NativeWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    memory::MemoryPool& pool,
+    int32_t rowsInRowGroup,
+    NativeWriterOptions options)
+    : rowsInRowGroup_(rowsInRowGroup),
+      options_(options),
+      pool_(pool),
+      sink_(std::move(sink)) {
+  VELOX_CHECK_GT(rowsInRowGroup_, 0);
+  VELOX_CHECK(
+      options_.compression == thrift::CompressionCodec::UNCOMPRESSED ||
+          options_.compression == thrift::CompressionCodec::SNAPPY ||
+          options_.compression == thrift::CompressionCodec::ZSTD,
+      "Unsupported Parquet compression: {}",
+      static_cast<int>(options_.compression));
+}
+
+void NativeWriter::initialize(const RowTypePtr& type) {
+  type_ = type;
+  for (auto i = 0; i < type_->size(); ++i) {
+    columns_.push_back(ColumnChunkWriter::create(
+        type_->nameOf(i), type_->childAt(i), options_, pool_));
+  }
+  DataBuffer<char> magic(pool_);
+  writeMagic(magic);
+  bytesWritten_ += magic.size();
+  sink_->write(std::move(magic));
+}
+
+void NativeWriter::write(const RowVectorPtr& data) {
+  VELOX_CHECK(!closed_, "Parquet writer is closed");
+  if (!type_) {
+    initialize(asRowType(data->type()));
+  } else {
+    VELOX_CHECK(
+        type_->equivalent(*data->type()),
+        "Parquet writer input type changed from {} to {}",
+        type_->toString(),
+        data->type()->toString());
+  }
+  vector_size_t begin = 0;
+  while (begin < data->size()) {
+    const auto end = std::min<int64_t>(
+        data->size(), begin + rowsInRowGroup_ - numBufferedRows_);
+    append(data, begin, end);
+    if (numBufferedRows_ == rowsInRowGroup_) {
+      flush();
+    }
+    begin = end;
+  }
+}
+
+void NativeWriter::append(
+    const RowVectorPtr& data,
+    vector_size_t begin,
+    vector_size_t end) {
+  forEachColumn(
+      [&](int32_t i) { columns_[i]->append(*data->childAt(i), begin, end); });
+  numBufferedRows_ += end - begin;
+}
+
+void NativeWriter::forEachColumn(const std::function<void(int32_t)>& func) {
+  if (!options_.executor || columns_.size() < 2) {
+    for (auto i = 0; i < columns_.size(); ++i) {
+      func(i);
+    }
+    return;
+  }
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
+  futures.reserve(columns_.size());
+  for (auto i = 0; i < columns_.size(); ++i) {
+    futures.push_back(
+        folly::via(options_.executor, [&func, i]() { func(i); }).semi());
+  }
+  for (auto& result : folly::collectAll(std::move(futures)).get()) {
+    result.throwIfFailed();
+  }
+}
+
+void NativeWriter::flush() {
+  if (numBufferedRows_ == 0) {
+    return;
+  }
+  std::vector<std::unique_ptr<EncodedColumnChunk>> chunks(columns_.size());
+  forEachColumn([&](int32_t i) { chunks[i] = columns_[i]->finish(); });
+
+  thrift::RowGroup rowGroup;
+  rowGroup.__set_file_offset(bytesWritten_);
+  int64_t totalByteSize = 0;
+  int64_t totalCompressedSize = 0;
+  std::vector<thrift::ColumnChunk> columnChunks;
+  std::vector<DataBuffer<char>> buffers;
+  for (auto& chunk : chunks) {
+    auto& metaData = chunk->metaData;
+    metaData.__set_data_page_offset(metaData.data_page_offset + bytesWritten_);
+    if (metaData.__isset.dictionary_page_offset) {
+      metaData.__set_dictionary_page_offset(
+          metaData.dictionary_page_offset + bytesWritten_);
+    }
+    thrift::ColumnChunk columnChunk;
+    columnChunk.__set_file_offset(bytesWritten_);
+    columnChunk.__set_meta_data(metaData);
+    columnChunks.push_back(std::move(columnChunk));
+    totalByteSize += metaData.total_uncompressed_size;
+    totalCompressedSize += metaData.total_compressed_size;
+    bytesWritten_ += chunk->data.size();
+    buffers.push_back(std::move(chunk->data));
+  }
+  rowGroup.__set_columns(columnChunks);
+  rowGroup.__set_total_byte_size(totalByteSize);
+  rowGroup.__set_total_compressed_size(totalCompressedSize);
+  rowGroup.__set_num_rows(numBufferedRows_);
+  rowGroups_.push_back(std::move(rowGroup));
+  numRows_ += numBufferedRows_;
+  numBufferedRows_ = 0;
+  sink_->writeWithLogging(buffers);
+}
+
+void NativeWriter::writeFooter() {
+  std::vector<thrift::SchemaElement> schema;
+  thrift::SchemaElement root;
+  root.__set_name("schema");
+  root.__set_num_children(columns_.size());
+  schema.push_back(std::move(root));
+  for (const auto& column : columns_) {
+    schema.push_back(column->schemaElement());
+  }
+  thrift::FileMetaData fileMetaData;
+  fileMetaData.__set_version(1);
+  fileMetaData.__set_schema(schema);
+  fileMetaData.__set_num_rows(numRows_);
+  fileMetaData.__set_row_groups(rowGroups_);
+  fileMetaData.__set_created_by("velox");
+
+  DataBuffer<char> footer(pool_);
+  writeThriftObject(fileMetaData, footer);
+  const uint32_t footerSize = footer.size();
+  footer.extendAppend(
+      footer.size(),
+      reinterpret_cast<const char*>(&footerSize),
+      sizeof(footerSize));
+  writeMagic(footer);
+  bytesWritten_ += footer.size();
+  sink_->write(std::move(footer));
+}
+
+void NativeWriter::close() {
+  if (closed_) {
+    return;
+  }
+  VELOX_CHECK_NOT_NULL(type_, "Cannot close a Parquet writer without data");
+  flush();
+  writeFooter();
+  sink_->close();
+  closed_ = true;
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/parquet/writer/ColumnChunkWriter.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet {
+
+struct NativeWriterOptions {
+  // Compression of the data and dictionary pages. UNCOMPRESSED, SNAPPY and
+  // ZSTD are supported.
+  thrift::CompressionCodec::type compression{
+      thrift::CompressionCodec::UNCOMPRESSED};
+
+  // Dictionary encodes the columns of a row group until their dictionary
+  // exceeds 'dictionaryPageSizeLimit' bytes.
+  bool enableDictionary{true};
+  int64_t dictionaryPageSizeLimit{1 << 20};
+
+  // Target size of the values in a data page.
+  int64_t dataPageSize{1 << 20};
+
+  // If set, the columns are encoded in parallel on 'executor'.
+  folly::Executor* FOLLY_NULLABLE executor{nullptr};
+};
+
+// Writes Velox vectors into a DataSink as Parquet without converting them to
+// Arrow. Supports top level columns of primitive types, which are written
+// with PLAIN or dictionary encoding and optional definition levels.
+class NativeWriter {
+ public:
+  // Constructs a writer with output to 'sink'. A new row group is started
+  // every 'rowsInRowGroup' top level rows. 'pool' is used for the buffered
+  // row group.
+  NativeWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      memory::MemoryPool& pool,
+      int32_t rowsInRowGroup,
+      NativeWriterOptions options = {});
+
+  // Appends 'data' into the writer. All calls must have the same type.
+  void write(const RowVectorPtr& data);
+
+  // Writes the buffered rows as a row group.
+  void flush();
+
+  // Writes the buffered rows and the footer and closes 'sink'. Data can no
+  // longer be added after close().
+  void close();
+
+ private:
+  void initialize(const RowTypePtr& type);
+
+  // Appends rows [begin, end) of 'data' to the current row group.
+  void append(const RowVectorPtr& data, vector_size_t begin, vector_size_t end);
+
+  // Calls 'func' with the index of each column, in parallel if there is an
+  // executor.
+  void forEachColumn(const std::function<void(int32_t)>& func);
+
+  void writeFooter();
+
+  const int32_t rowsInRowGroup_;
+  const NativeWriterOptions options_;
+  memory::MemoryPool& pool_;
+  std::unique_ptr<dwio::common::DataSink> sink_;
+
+  RowTypePtr type_;
+  std::vector<std::unique_ptr<ColumnChunkWriter>> columns_;
+
+  // Number of rows buffered for the current row group.
+  int64_t numBufferedRows_{0};
+
+  // Number of bytes written to 'sink_'.
+  int64_t bytesWritten_{0};
+
+  std::vector<thrift::RowGroup> rowGroups_;
+  int64_t numRows_{0};
+  bool closed_{false};
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/dwio/common/DataBuffer.h"
+
+namespace facebook::velox::parquet {
+
+/// Encodes values in the RLE/bit packing hybrid encoding used for repetition
+/// and definition levels and dictionary indices. Runs of at least 8 equal
+/// values are run length encoded and the rest is bit packed in groups of 8
+/// values.
+class RleBpEncoder {
+ public:
+  /// Appends the encoding of 'numValues' values of 'bitWidth' bits to 'out'.
+  template <typename T>
+  static void encode(
+      const T* FOLLY_NONNULL values,
+      int64_t numValues,
+      uint8_t bitWidth,
+      dwio::common::DataBuffer<char>& out) {
+    VELOX_CHECK_LE(bitWidth, 32);
+    int64_t i = 0;
+    while (i < numValues) {
+      auto runLength = repeatCount(values, i, numValues, numValues - i);
+      if (runLength >= kGroupSize) {
+        writeRun(values[i], runLength, bitWidth, out);
+        i += runLength;
+        continue;
+      }
+      // Takes groups of 8 values until a run of 8 starts at a group boundary.
+      const auto start = i;
+      do {
+        i += kGroupSize;
+      } while (i < numValues &&
+               repeatCount(values, i, numValues, kGroupSize) < kGroupSize);
+      i = std::min(i, numValues);
+      writeBitPacked(values + start, i - start, bitWidth, out);
+    }
+  }
+
+ private:
+  static constexpr int32_t kGroupSize = 8;
+
+  // Returns the number of values equal to values[start] from 'start', up to
+  // 'maxCount'.
+  template <typename T>
+  static int64_t repeatCount(
+      const T* FOLLY_NONNULL values,
+      int64_t start,
+      int64_t numValues,
+      int64_t maxCount) {
+    const auto end = std::min(numValues, start + maxCount);
+    auto i = start + 1;
+    while (i < end && values[i] == values[start]) {
+      ++i;
+    }
+    return i - start;
+  }
+
+  static void writeVarint(uint64_t value, dwio::common::DataBuffer<char>& out) {
+    while (value >= 0x80) {
+      out.append(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+  }
+
+  template <typename T>
+  static void writeRun(
+      T value,
+      int64_t count,
+      uint8_t bitWidth,
+      dwio::common::DataBuffer<char>& out) {
+    writeVarint(count << 1, out);
+    const uint64_t word = value;
+    for (auto i = 0; i < bits::roundUp(bitWidth, 8) / 8; ++i) {
+      out.append(static_cast<char>(word >> (i * 8)));
+    }
+  }
+
+  // Writes 'count' values padded with zeros to a multiple of 8.
+  template <typename T>
+  static void writeBitPacked(
+      const T* FOLLY_NONNULL values,
+      int64_t count,
+      uint8_t bitWidth,
+      dwio::common::DataBuffer<char>& out) {
+    const auto numGroups = bits::roundUp(count, kGroupSize) / kGroupSize;
+    writeVarint((numGroups << 1) | 1, out);
+    uint64_t word = 0;
+    int32_t numBits = 0;
+    for (auto i = 0; i < numGroups * kGroupSize; ++i) {
+      const uint64_t value = i < count ? values[i] : 0;
+      word |= value << numBits;
+      numBits += bitWidth;
+      while (numBits >= 8) {
+        out.append(static_cast<char>(word));
+        word >>= 8;
+        numBits -= 8;
+      }
+    }
+  }
+};
+
+} // namespace facebook::velox::parquet
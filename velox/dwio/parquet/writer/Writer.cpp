@@ -38,7 +38,7 @@ void Writer::write(const RowVectorPtr& data) {
         arrowWriter_,
         ::parquet::arrow::FileWriter::Open(
             *recordBatch->schema(),
-            arrow::default_memory_pool(),
+            &arrowPool_,
             stream_,
             properties_,
             arrowProperties));
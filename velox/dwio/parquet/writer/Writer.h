@@ -18,6 +18,7 @@
 
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/parquet/writer/ArrowMemoryPool.h"
 
 #include "velox/core/Context.h"
 #include "velox/core/QueryConfig.h"
@@ -82,8 +83,8 @@ class Writer {
  public:
   // Constructts a writer with output to 'sink'. A new row group is
   // started every 'rowsInRowGroup' top level rows. 'pool' is used for
-  // temporary memory. 'properties' specifies Parquet-specific
-  // options.
+  // temporary memory, including the buffers allocated by the Arrow writer.
+  // 'properties' specifies Parquet-specific options.
   Writer(
       std::unique_ptr<dwio::common::DataSink> sink,
       memory::MemoryPool& pool,
@@ -94,6 +95,7 @@ class Writer {
           std::make_shared<velox::core::QueryCtx>(nullptr))
       : rowsInRowGroup_(rowsInRowGroup),
         pool_(pool),
+        arrowPool_(pool),
         finalSink_(std::move(sink)),
         properties_(std::move(properties)),
         queryCtx_(std::move(queryCtx)) {}
@@ -117,6 +119,10 @@ class Writer {
   // Pool for 'stream_'.
   memory::MemoryPool& pool_;
 
+  // Routes the allocations of 'arrowWriter_' to 'pool_'. Declared before
+  // 'arrowWriter_' so that it outlives the Arrow buffers.
+  ArrowMemoryPool arrowPool_;
+
   // Final destination of output.
   std::unique_ptr<dwio::common::DataSink> finalSink_;
 
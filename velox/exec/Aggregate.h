@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <array>
+
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/core/PlanNode.h"
 #include "velox/vector/BaseVector.h"
@@ -75,7 +77,7 @@ class Aggregate {
     return true;
   }
 
-  void setAllocator(HashStringAllocator* allocator) {
+  virtual void setAllocator(HashStringAllocator* allocator) {
     allocator_ = allocator;
   }
 
@@ -165,6 +167,13 @@ class Aggregate {
     VELOX_NYI();
   }
 
+  // Returns true if retractRawInput() exactly undoes addRawInput() for the
+  // same input. Window frames that slide over a partition then update the
+  // previous frame's accumulator instead of aggregating each frame anew.
+  virtual bool supportsRetract() const {
+    return false;
+  }
+
   // Updates the single partial accumulator from raw input data for global
   // aggregation.
   // @param group Pointer to the start of the group row.
@@ -221,6 +230,13 @@ class Aggregate {
   // 'groups'. No-op for fixed length accumulators.
   virtual void destroy(folly::Range<char**> /*groups*/) {}
 
+  // Moves the out of line storage for the accumulator in 'groups' out of
+  // the slabs being evacuated by a compaction of 'allocator_', see
+  // HashStringAllocator::relocate(). The storage of accumulators which do
+  // not implement this stays in place and keeps its slabs from being
+  // released.
+  virtual void relocate(folly::Range<char**> /*groups*/) {}
+
   // Clears state between reuses, e.g. this is called before reusing
   // the aggregation operator's state after flushing a partial
   // aggregation.
@@ -291,6 +307,85 @@ class Aggregate {
     return reinterpret_cast<T*>(group + offset_);
   }
 
+  // Maximum number of distinct groups that updateFewGroups() pre-aggregates.
+  static constexpr int32_t kMaxFewGroups = 64;
+
+  // Updates the accumulators of 'groups' for 'rows' with one update per
+  // distinct group instead of one per row when the rows hit a small number of
+  // distinct groups, such as with few or low-cardinality grouping keys. The
+  // rows of each group are folded into a TPartial in a small, cache-resident
+  // buffer with 'updatePartial(partial, row)', starting from
+  // 'initialPartial', and 'updateGroup(group, partial)' is then called once
+  // per group. Rows for which 'isNull(row)' is true are skipped. When the rows
+  // hit more than kMaxFewGroups groups, the rows from the first one that does
+  // not fit on are applied one at a time. The update must be commutative and
+  // associative.
+  template <
+      typename TPartial,
+      typename IsNull,
+      typename UpdatePartial,
+      typename UpdateGroup>
+  void updateFewGroups(
+      char** groups,
+      const SelectivityVector& rows,
+      TPartial initialPartial,
+      IsNull isNull,
+      UpdatePartial updatePartial,
+      UpdateGroup updateGroup) {
+    // Open addressing table from group to index in 'partials', at most half
+    // full.
+    constexpr int32_t kTableBits = 7;
+    constexpr int32_t kTableSize = 1 << kTableBits;
+    static_assert(kTableSize >= 2 * kMaxFewGroups);
+    std::array<char*, kTableSize> table{};
+    std::array<int8_t, kTableSize> tableIndices;
+    std::array<char*, kMaxFewGroups> distinctGroups;
+    std::array<TPartial, kMaxFewGroups> partials;
+    int32_t numDistinct = 0;
+    vector_size_t firstUnfit = rows.end();
+    rows.testSelected([&](vector_size_t row) {
+      if (isNull(row)) {
+        return true;
+      }
+      char* group = groups[row];
+      auto slot =
+          (reinterpret_cast<uintptr_t>(group) * 0x9E3779B97F4A7C15ULL) >>
+          (64 - kTableBits);
+      while (table[slot] != group) {
+        if (table[slot] == nullptr) {
+          if (numDistinct == kMaxFewGroups) {
+            firstUnfit = row;
+            return false;
+          }
+          table[slot] = group;
+          tableIndices[slot] = numDistinct;
+          distinctGroups[numDistinct] = group;
+          partials[numDistinct] = initialPartial;
+          ++numDistinct;
+          break;
+        }
+        slot = (slot + 1) & (kTableSize - 1);
+      }
+      updatePartial(partials[tableIndices[slot]], row);
+      return true;
+    });
+
+    for (auto i = 0; i < numDistinct; ++i) {
+      updateGroup(distinctGroups[i], partials[i]);
+    }
+    if (firstUnfit < rows.end()) {
+      bits::forEachSetBit(
+          rows.asRange().bits(), firstUnfit, rows.end(), [&](auto row) {
+            if (isNull(row)) {
+              return;
+            }
+            TPartial partial = initialPartial;
+            updatePartial(partial, row);
+            updateGroup(groups[row], partial);
+          });
+    }
+  }
+
   template <typename T>
   static uint64_t* getRawNulls(T* vector) {
     if (vector->mayHaveNulls()) {
@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/AggregateWindow.h"
+#include <folly/ScopeGuard.h>
 #include "velox/common/base/Exceptions.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/WindowFunction.h"
@@ -29,6 +30,14 @@ namespace {
 // Creates an Aggregate function object for the window function invocation.
 // At each row, computes the aggregation across all rows from the frameStart
 // to frameEnd boundaries at that row using singleGroup.
+//
+// Frames with a fixed start and growing ends are aggregated incrementally.
+// Other frames of an aggregate that supports retracting input slide the
+// previous frame's accumulator: the rows that left the frame are retracted
+// and the rows that entered it are added. For the remaining aggregates,
+// large frames are aggregated from a segment tree of intermediate results
+// over the partition, so that each frame combines O(log(partition size))
+// nodes instead of all its rows.
 class AggregateWindowFunction : public exec::WindowFunction {
  public:
   AggregateWindowFunction(
@@ -37,7 +46,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
       const TypePtr& resultType,
       velox::memory::MemoryPool* pool,
       HashStringAllocator* stringAllocator)
-      : WindowFunction(resultType, pool, stringAllocator) {
+      : WindowFunction(resultType, pool, stringAllocator), name_(name) {
     argTypes_.reserve(args.size());
     argIndices_.reserve(args.size());
     argVectors_.reserve(args.size());
@@ -58,6 +67,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
     aggregate_ = exec::Aggregate::create(
         name, core::AggregationNode::Step::kSingle, argTypes_, resultType);
     aggregate_->setAllocator(stringAllocator_);
+    supportsRetract_ = aggregate_->supportsRetract();
 
     // Aggregate initialization.
     // Row layout is:
@@ -104,6 +114,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
     partition_ = partition;
 
     previousFrameMetadata_.reset();
+    slidingFrame_.reset();
+    partitionArgVectors_.clear();
+    segmentTree_.clear();
   }
 
   void apply(
@@ -124,6 +137,15 @@ class AggregateWindowFunction : public exec::WindowFunction {
     FrameMetadata frameMetadata =
         analyzeFrameValues(validRows, rawFrameStarts, rawFrameEnds);
 
+    if (!frameMetadata.incrementalAggregation && supportsRetract_) {
+      slidingAggregation(
+          validRows, rawFrameStarts, rawFrameEnds, resultOffset, result);
+      previousFrameMetadata_ = frameMetadata;
+      return;
+    }
+    // The other ways of aggregating reinitialize the single group.
+    slidingFrame_.reset();
+
     if (frameMetadata.incrementalAggregation) {
       vector_size_t startRow;
       if (frameMetadata.usePreviousAggregate) {
@@ -151,6 +173,11 @@ class AggregateWindowFunction : public exec::WindowFunction {
           rawFrameEnds,
           resultOffset,
           result);
+    } else if (
+        frameMetadata.numFrameRows >=
+        kMinSegmentTreeFrameSize * validRows.countSelected()) {
+      segmentTreeAggregation(
+          validRows, rawFrameStarts, rawFrameEnds, resultOffset, result);
     } else {
       fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
       simpleAggregation(
@@ -181,8 +208,27 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
     // Resume incremental aggregation from the prior block.
     bool usePreviousAggregate;
+
+    // Total number of rows in the valid frames of the block.
+    int64_t numFrameRows;
+  };
+
+  // A range of rows of the partition, or of nodes of a level of
+  // 'segmentTree_', that is added to the single group.
+  struct Segment {
+    // Level in 'segmentTree_' or -1 for rows of the partition.
+    int32_t level;
+    vector_size_t begin;
+    vector_size_t end;
   };
 
+  // Number of rows or nodes aggregated into each node of 'segmentTree_'.
+  static constexpr vector_size_t kSegmentTreeFanout = 16;
+
+  // Min average number of rows in a frame for aggregating the frames from
+  // 'segmentTree_'. Smaller frames are aggregated row by row.
+  static constexpr int64_t kMinSegmentTreeFrameSize = 2 * kSegmentTreeFanout;
+
   bool handleAllEmptyFrames(
       const SelectivityVector& validRows,
       vector_size_t resultOffset,
@@ -216,9 +262,11 @@ class AggregateWindowFunction : public exec::WindowFunction {
     vector_size_t prevFrameEnds = lastRow;
 
     bool incrementalAggregation = true;
+    int64_t numFrameRows = 0;
     validRows.applyToSelected([&](auto i) {
       firstRow = std::min(firstRow, rawFrameStarts[i]);
       lastRow = std::max(lastRow, rawFrameEnds[i]);
+      numFrameRows += rawFrameEnds[i] + 1 - rawFrameStarts[i];
 
       // Incremental aggregation can be done if :
       // i) All rows have the same frameStart value.
@@ -242,7 +290,12 @@ class AggregateWindowFunction : public exec::WindowFunction {
       }
     }
 
-    return {firstRow, lastRow, incrementalAggregation, usePreviousAggregate};
+    return {
+        firstRow,
+        lastRow,
+        incrementalAggregation,
+        usePreviousAggregate,
+        numFrameRows};
   }
 
   void fillArgVectors(vector_size_t firstRow, vector_size_t lastRow) {
@@ -318,10 +371,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
     validRows.applyToSelected([&](auto i) {
       // This is a very naive algorithm.
       // It evaluates the entire aggregation for each row by iterating over
-      // input rows from frameStart to frameEnd in the SelectivityVector.
-      // TODO : Try to re-use previous computations by advancing and retracting
-      // the aggregation based on the frame changes with each row. This would
-      // require adding new APIs to the Aggregate framework.
+      // input rows from frameStart to frameEnd in the SelectivityVector. It
+      // is only used for small frames, larger ones are aggregated from the
+      // segment tree.
       aggregate_->clear();
       aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
       aggregateInitialized_ = true;
@@ -336,6 +388,211 @@ class AggregateWindowFunction : public exec::WindowFunction {
     setNullEmptyFramesResults(validRows, resultOffset, result);
   }
 
+  // Aggregates each frame by updating the accumulator of the previous frame
+  // if the frame starts and ends at or after the previous frame and overlaps
+  // it. Otherwise aggregates the frame anew. The previous frame can be from
+  // the previous block of the partition.
+  void slidingAggregation(
+      const SelectivityVector& validRows,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    loadPartitionArgs();
+    validRows.applyToSelected([&](auto i) {
+      const auto frameStart = rawFrameStarts[i];
+      const auto frameEnd = rawFrameEnds[i] + 1;
+      if (!slidingFrame_.has_value() || frameStart < slidingFrame_->first ||
+          frameEnd < slidingFrame_->second ||
+          frameStart >= slidingFrame_->second) {
+        initializeSingleGroup();
+        addRows(frameStart, frameEnd, false);
+      } else {
+        if (frameStart > slidingFrame_->first) {
+          addRows(slidingFrame_->first, frameStart, true);
+        }
+        if (frameEnd > slidingFrame_->second) {
+          addRows(slidingFrame_->second, frameEnd, false);
+        }
+      }
+      slidingFrame_ = std::make_pair(frameStart, frameEnd);
+
+      BaseVector::prepareForReuse(aggregateResultVector_, 1);
+      aggregate_->extractValues(
+          &rawSingleGroupRow_, 1, &aggregateResultVector_);
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setNullEmptyFramesResults(validRows, resultOffset, result);
+  }
+
+  // Aggregates each frame from the fewest nodes of 'segmentTree_' and rows of
+  // the partition that cover it.
+  void segmentTreeAggregation(
+      const SelectivityVector& validRows,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    loadPartitionArgs();
+    if (segmentTree_.empty()) {
+      buildSegmentTree();
+    }
+    validRows.applyToSelected([&](auto i) {
+      initializeSingleGroup();
+      addSegments(rawFrameStarts[i], rawFrameEnds[i] + 1);
+
+      BaseVector::prepareForReuse(aggregateResultVector_, 1);
+      aggregate_->extractValues(
+          &rawSingleGroupRow_, 1, &aggregateResultVector_);
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setNullEmptyFramesResults(validRows, resultOffset, result);
+  }
+
+  void initializeSingleGroup() {
+    static const std::vector<vector_size_t> kSingleGroup{0};
+    aggregate_->clear();
+    aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
+    aggregateInitialized_ = true;
+  }
+
+  // Extracts the arguments for all rows of the partition into
+  // 'partitionArgVectors_' if not already done.
+  void loadPartitionArgs() {
+    if (!partitionArgVectors_.empty()) {
+      return;
+    }
+    const auto numRows = partition_->numRows();
+    for (int i = 0; i < argIndices_.size(); i++) {
+      if (argIndices_[i] == kConstantChannel) {
+        partitionArgVectors_.push_back(argVectors_[i]);
+      } else {
+        partitionArgVectors_.push_back(
+            BaseVector::create(argTypes_[i], numRows, pool_));
+        partition_->extractColumn(
+            argIndices_[i], 0, numRows, 0, partitionArgVectors_.back());
+      }
+    }
+  }
+
+  // Adds or retracts the rows in [begin, end) of the partition to or from the
+  // single group.
+  void addRows(vector_size_t begin, vector_size_t end, bool retract) {
+    const auto numRows = end - begin;
+    segmentRows_.resizeFill(numRows, true);
+    std::vector<VectorPtr> args;
+    args.reserve(partitionArgVectors_.size());
+    for (const auto& arg : partitionArgVectors_) {
+      args.push_back(arg->slice(begin, numRows));
+    }
+    if (retract) {
+      singleGroups_.resize(numRows, rawSingleGroupRow_);
+      aggregate_->retractRawInput(
+          singleGroups_.data(), segmentRows_, args, false);
+    } else {
+      aggregate_->addSingleGroupRawInput(
+          rawSingleGroupRow_, segmentRows_, args, false);
+    }
+  }
+
+  // Builds the levels of 'segmentTree_' over 'partitionArgVectors_'. Node i of
+  // level 0 holds the intermediate result for rows [i * kSegmentTreeFanout,
+  // (i + 1) * kSegmentTreeFanout) of the partition and node i of level l + 1
+  // the one for the nodes of level l in the same range. Levels are added
+  // until a level has at most kSegmentTreeFanout nodes.
+  void buildSegmentTree() {
+    const auto intermediateType =
+        exec::Aggregate::intermediateType(name_, argTypes_);
+    const auto groupSize = bits::roundUp(
+        singleGroupRowSize_, aggregate_->accumulatorAlignmentSize());
+    std::vector<VectorPtr> input = partitionArgVectors_;
+    vector_size_t numInputs = partition_->numRows();
+    while (numInputs > kSegmentTreeFanout) {
+      const auto numNodes =
+          bits::roundUp(numInputs, kSegmentTreeFanout) / kSegmentTreeFanout;
+      auto nodesBuffer =
+          AlignedBuffer::allocate<char>(numNodes * groupSize, pool_, 0);
+      std::vector<char*> nodes(numNodes);
+      std::vector<vector_size_t> indices(numNodes);
+      for (auto i = 0; i < numNodes; ++i) {
+        nodes[i] = nodesBuffer->asMutable<char>() + i * groupSize;
+        indices[i] = i;
+      }
+      aggregate_->clear();
+      aggregate_->initializeNewGroups(nodes.data(), indices);
+      SCOPE_EXIT {
+        aggregate_->destroy(folly::Range(nodes.data(), numNodes));
+      };
+
+      std::vector<char*> groups(numInputs);
+      for (auto i = 0; i < numInputs; ++i) {
+        groups[i] = nodes[i / kSegmentTreeFanout];
+      }
+      SelectivityVector rows(numInputs);
+      if (segmentTree_.empty()) {
+        aggregate_->addRawInput(groups.data(), rows, input, false);
+      } else {
+        aggregate_->addIntermediateResults(groups.data(), rows, input, false);
+      }
+      auto level = BaseVector::create(intermediateType, numNodes, pool_);
+      aggregate_->extractAccumulators(nodes.data(), numNodes, &level);
+      segmentTree_.push_back(level);
+      input = {level};
+      numInputs = numNodes;
+    }
+  }
+
+  // Adds the rows in [begin, end) of the partition to the single group. Uses
+  // the nodes of the highest levels of 'segmentTree_' that fit in the range
+  // and the rows or lower level nodes at its edges. The segments are added in
+  // the order of their rows for aggregates that depend on the input order.
+  void addSegments(vector_size_t begin, vector_size_t end) {
+    leadingSegments_.clear();
+    trailingSegments_.clear();
+    for (int32_t level = -1; begin < end; ++level) {
+      const auto parentBegin = bits::roundUp(begin, kSegmentTreeFanout);
+      const auto parentEnd = end / kSegmentTreeFanout * kSegmentTreeFanout;
+      if (level + 1 == static_cast<int32_t>(segmentTree_.size()) ||
+          parentBegin >= parentEnd) {
+        leadingSegments_.push_back({level, begin, end});
+        break;
+      }
+      if (begin < parentBegin) {
+        leadingSegments_.push_back({level, begin, parentBegin});
+      }
+      if (parentEnd < end) {
+        trailingSegments_.push_back({level, parentEnd, end});
+      }
+      begin = parentBegin / kSegmentTreeFanout;
+      end = parentEnd / kSegmentTreeFanout;
+    }
+    for (const auto& segment : leadingSegments_) {
+      addSegment(segment);
+    }
+    for (auto it = trailingSegments_.rbegin(); it != trailingSegments_.rend();
+         ++it) {
+      addSegment(*it);
+    }
+  }
+
+  void addSegment(const Segment& segment) {
+    if (segment.level < 0) {
+      addRows(segment.begin, segment.end, false);
+      return;
+    }
+    const auto numNodes = segment.end - segment.begin;
+    segmentRows_.resizeFill(numNodes, true);
+    aggregate_->addSingleGroupIntermediateResults(
+        rawSingleGroupRow_,
+        segmentRows_,
+        {segmentTree_[segment.level]->slice(segment.begin, numNodes)},
+        false);
+  }
+
   // Aggregate function object required for this window function evaluation.
   std::unique_ptr<exec::Aggregate> aggregate_;
 
@@ -366,6 +623,31 @@ class AggregateWindowFunction : public exec::WindowFunction {
   // Stores metadata about the previous output block of the partition
   // to optimize aggregate computation and reading argument vectors.
   std::optional<FrameMetadata> previousFrameMetadata_;
+
+  // Name of the aggregate function.
+  const std::string name_;
+
+  // True if 'aggregate_' supports retracting raw input.
+  bool supportsRetract_;
+
+  // The [start, end) rows of the last frame aggregated by
+  // slidingAggregation() if the single group still holds its result.
+  std::optional<std::pair<vector_size_t, vector_size_t>> slidingFrame_;
+
+  // The arguments for all rows of the partition. Filled for sliding and
+  // segment tree aggregation.
+  std::vector<VectorPtr> partitionArgVectors_;
+
+  // The intermediate results of the nodes of each level of the segment tree
+  // over the partition. Built by the first segment tree aggregation in a
+  // partition.
+  std::vector<VectorPtr> segmentTree_;
+
+  // Reusable state for adding ranges of rows and segments.
+  SelectivityVector segmentRows_;
+  std::vector<char*> singleGroups_;
+  std::vector<Segment> leadingSegments_;
+  std::vector<Segment> trailingSegments_;
 };
 
 } // namespace
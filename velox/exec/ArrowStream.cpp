@@ -87,4 +87,29 @@ void ArrowStream::close() {
   SourceOperator::close();
 }
 
+ArrowStreamSink::ArrowStreamSink(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::ArrowStreamSinkNode>& planNode)
+    : Operator(
+          driverCtx,
+          planNode->outputType(),
+          operatorId,
+          planNode->id(),
+          "ArrowStreamSink"),
+      consumer_(planNode->consumer()) {}
+
+void ArrowStreamSink::addInput(RowVectorPtr input) {
+  struct ArrowArray arrowArray;
+  exportToArrow(input, arrowArray, pool());
+  struct ArrowSchema arrowSchema;
+  try {
+    exportToArrow(input, arrowSchema);
+  } catch (const std::exception&) {
+    arrowArray.release(&arrowArray);
+    throw;
+  }
+  consumer_(arrowSchema, arrowArray);
+}
+
 } // namespace facebook::velox::exec
@@ -46,4 +46,34 @@ class ArrowStream : public SourceOperator {
   std::shared_ptr<ArrowArrayStream> arrowStream_;
 };
 
+/// Exports each input batch to the consumer of a core::ArrowStreamSinkNode.
+class ArrowStreamSink : public Operator {
+ public:
+  ArrowStreamSink(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::ArrowStreamSinkNode>& planNode);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override {
+    return nullptr;
+  }
+
+  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return noMoreInput_;
+  }
+
+ private:
+  const core::ArrowStreamSinkNode::ArrowConsumer consumer_;
+};
+
 } // namespace facebook::velox::exec
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/BufferedInputAggregate.h"
+
+namespace facebook::velox::exec {
+
+BufferedInputAggregate::BufferedInputAggregate(
+    std::unique_ptr<Aggregate> aggregate,
+    const std::vector<TypePtr>& argTypes,
+    std::vector<VectorPtr> constants,
+    const std::vector<TypePtr>& sortingKeyTypes,
+    std::vector<core::SortOrder> sortingOrders,
+    bool distinct,
+    memory::MemoryPool* pool)
+    : Aggregate(aggregate->resultType()),
+      aggregate_(std::move(aggregate)),
+      argTypes_(argTypes),
+      constants_(std::move(constants)),
+      distinct_(distinct),
+      pool_(pool),
+      aggregateOffset_(bits::roundUp(
+          sizeof(RowList),
+          aggregate_->accumulatorAlignmentSize())) {
+  VELOX_CHECK_EQ(argTypes_.size(), constants_.size());
+  VELOX_CHECK_EQ(sortingKeyTypes.size(), sortingOrders.size());
+  VELOX_CHECK(distinct_ || !sortingOrders.empty());
+
+  std::vector<TypePtr> columnTypes;
+  for (auto i = 0; i < argTypes_.size(); ++i) {
+    if (constants_[i]) {
+      argColumns_.push_back(-1);
+    } else {
+      argColumns_.push_back(columnTypes.size());
+      columnTypes.push_back(argTypes_[i]);
+    }
+  }
+  numArgColumns_ = columnTypes.size();
+  for (auto i = 0; i < sortingKeyTypes.size(); ++i) {
+    columnTypes.push_back(sortingKeyTypes[i]);
+    sortingFlags_.push_back(
+        {sortingOrders[i].isNullsFirst(), sortingOrders[i].isAscending()});
+  }
+
+  inputs_ = std::make_unique<RowContainer>(
+      columnTypes,
+      true, // nullableKeys
+      std::vector<std::unique_ptr<Aggregate>>{},
+      std::vector<TypePtr>{},
+      true, // hasNext
+      false, // isJoinBuild
+      false, // hasProbedFlag
+      false, // hasNormalizedKey
+      pool_,
+      ContainerRowSerde::instance());
+  decodedInputs_.resize(argTypes_.size() + sortingKeyTypes.size());
+}
+
+// static
+void BufferedInputAggregate::unsupportedStep() {
+  VELOX_UNSUPPORTED(
+      "Aggregations over sorted or distinct inputs support only single aggregation");
+}
+
+void BufferedInputAggregate::setAllocator(HashStringAllocator* allocator) {
+  Aggregate::setAllocator(allocator);
+  aggregate_->setAllocator(allocator);
+}
+
+void BufferedInputAggregate::setOffsets(
+    int32_t offset,
+    int32_t nullByte,
+    uint8_t nullMask,
+    int32_t rowSizeOffset) {
+  Aggregate::setOffsets(offset, nullByte, nullMask, rowSizeOffset);
+  // 'aggregate_' shares the null flag. Its accumulator follows the row list.
+  aggregate_->setOffsets(
+      offset + aggregateOffset_, nullByte, nullMask, rowSizeOffset);
+}
+
+void BufferedInputAggregate::initializeNewGroups(
+    char** groups,
+    folly::Range<const vector_size_t*> indices) {
+  for (auto index : indices) {
+    rowList(groups[index]) = RowList{nullptr, nullptr, 0};
+  }
+  aggregate_->initializeNewGroups(groups, indices);
+}
+
+template <typename GroupAt>
+void BufferedInputAggregate::addInput(
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args,
+    GroupAt groupAt) {
+  VELOX_CHECK_EQ(args.size(), decodedInputs_.size());
+  // The decoded vectors and their columns in 'inputs_'. Constant arguments
+  // are not stored.
+  std::vector<std::pair<const DecodedVector*, int32_t>> columns;
+  for (auto i = 0; i < args.size(); ++i) {
+    const int32_t column = i < argColumns_.size()
+        ? argColumns_[i]
+        : numArgColumns_ + static_cast<int32_t>(i - argColumns_.size());
+    if (column < 0) {
+      continue;
+    }
+    decodedInputs_[i].decode(*args[i], rows);
+    columns.emplace_back(&decodedInputs_[i], column);
+  }
+
+  rows.applyToSelected([&](auto row) {
+    auto* newRow = inputs_->newRow();
+    for (const auto& [decoded, column] : columns) {
+      inputs_->store(*decoded, row, newRow, column);
+    }
+    nextRow(newRow) = nullptr;
+
+    auto& list = rowList(groupAt(row));
+    if (list.last) {
+      nextRow(list.last) = newRow;
+    } else {
+      list.first = newRow;
+    }
+    list.last = newRow;
+    ++list.size;
+  });
+  numPendingRows_ += rows.countSelected();
+}
+
+void BufferedInputAggregate::addRawInput(
+    char** groups,
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args,
+    bool /*mayPushdown*/) {
+  addInput(rows, args, [&](auto row) { return groups[row]; });
+}
+
+void BufferedInputAggregate::addSingleGroupRawInput(
+    char* group,
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args,
+    bool /*mayPushdown*/) {
+  addInput(rows, args, [&](auto /*row*/) { return group; });
+}
+
+int32_t BufferedInputAggregate::compare(const char* left, const char* right)
+    const {
+  for (auto i = 0; i < sortingFlags_.size(); ++i) {
+    if (auto result = inputs_->compare(
+            left, right, numArgColumns_ + i, sortingFlags_[i])) {
+      return result;
+    }
+  }
+  if (distinct_) {
+    for (auto i = 0; i < numArgColumns_; ++i) {
+      if (auto result = inputs_->compare(left, right, i)) {
+        return result;
+      }
+    }
+  }
+  return 0;
+}
+
+bool BufferedInputAggregate::equalArgs(const char* left, const char* right)
+    const {
+  for (auto i = 0; i < numArgColumns_; ++i) {
+    if (inputs_->compare(left, right, i, CompareFlags{true, true, true}) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BufferedInputAggregate::sortAndDeduplicate(
+    std::vector<char*>& rows,
+    size_t begin) const {
+  const auto first = rows.begin() + begin;
+  if (rows.end() - first < 2) {
+    return;
+  }
+  // A stable sort keeps the rows with equal sorting keys in input order.
+  std::stable_sort(first, rows.end(), [&](const char* left, const char* right) {
+    return compare(left, right) < 0;
+  });
+  // AggregationNode allows only arguments as the sorting keys of a distinct
+  // aggregate, so rows with equal arguments are adjacent.
+  if (distinct_) {
+    rows.erase(
+        std::unique(
+            first,
+            rows.end(),
+            [&](const char* left, const char* right) {
+              return equalArgs(left, right);
+            }),
+        rows.end());
+  }
+}
+
+void BufferedInputAggregate::extractValues(
+    char** groups,
+    int32_t numGroups,
+    VectorPtr* result) {
+  rows_.clear();
+  rowGroups_.clear();
+  for (auto i = 0; i < numGroups; ++i) {
+    auto* group = groups[i];
+    auto& list = rowList(group);
+    const auto begin = rows_.size();
+    for (auto* row = list.first; row != nullptr; row = nextRow(row)) {
+      rows_.push_back(row);
+    }
+    numPendingRows_ -= list.size;
+    list = RowList{nullptr, nullptr, 0};
+
+    sortAndDeduplicate(rows_, begin);
+    rowGroups_.resize(rows_.size(), group);
+  }
+
+  if (!rows_.empty()) {
+    const vector_size_t numRows = rows_.size();
+    std::vector<VectorPtr> args(argTypes_.size());
+    for (auto i = 0; i < argTypes_.size(); ++i) {
+      if (constants_[i]) {
+        args[i] = BaseVector::wrapInConstant(numRows, 0, constants_[i]);
+      } else {
+        args[i] = BaseVector::create(argTypes_[i], numRows, pool_);
+        inputs_->extractColumn(rows_.data(), numRows, argColumns_[i], args[i]);
+      }
+    }
+    SelectivityVector allRows(numRows);
+    aggregate_->addRawInput(rowGroups_.data(), allRows, args, false);
+  }
+
+  // Frees the buffered input once all of it has been added to 'aggregate_'.
+  if (numPendingRows_ == 0) {
+    inputs_->clear();
+  }
+
+  aggregate_->extractValues(groups, numGroups, result);
+}
+
+} // namespace facebook::velox::exec
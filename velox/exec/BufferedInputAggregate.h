@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/Aggregate.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Runs an aggregate over raw input whose input must be sorted or
+/// deduplicated for each group, e.g. array_agg(x ORDER BY y) or
+/// count(DISTINCT x). The input rows are kept in a RowContainer and each group
+/// keeps a list of its rows in its accumulator. When the results are
+/// extracted, the rows of each group are sorted and, for DISTINCT, rows with
+/// equal arguments are dropped. Then the rows of all the groups are added to
+/// the wrapped aggregate with one addRawInput() call. Supports only single
+/// aggregation, i.e. raw input in and final results out.
+class BufferedInputAggregate : public Aggregate {
+ public:
+  /// @param aggregate The aggregate to add the input to.
+  /// @param argTypes The types of the arguments of 'aggregate'.
+  /// @param constants The values of the constant arguments of 'aggregate'.
+  /// nullptr for the arguments that are not constant.
+  /// @param sortingKeyTypes The types of the keys to sort the input of each
+  /// group by. addRawInput() takes these after the arguments of 'aggregate'.
+  /// @param sortingOrders The orders of the sorting keys.
+  /// @param distinct True if the input of each group is deduplicated on the
+  /// arguments. The sorting keys must then be a subset of the arguments.
+  BufferedInputAggregate(
+      std::unique_ptr<Aggregate> aggregate,
+      const std::vector<TypePtr>& argTypes,
+      std::vector<VectorPtr> constants,
+      const std::vector<TypePtr>& sortingKeyTypes,
+      std::vector<core::SortOrder> sortingOrders,
+      bool distinct,
+      memory::MemoryPool* FOLLY_NONNULL pool);
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return aggregateOffset_ + aggregate_->accumulatorFixedWidthSize();
+  }
+
+  int32_t accumulatorAlignmentSize() const override {
+    return std::max<int32_t>(
+        alignof(RowList), aggregate_->accumulatorAlignmentSize());
+  }
+
+  bool accumulatorUsesExternalMemory() const override {
+    return aggregate_->accumulatorUsesExternalMemory();
+  }
+
+  bool isFixedSize() const override {
+    return aggregate_->isFixedSize();
+  }
+
+  void setAllocator(HashStringAllocator* FOLLY_NONNULL allocator) override;
+
+  void setOffsets(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      int32_t rowSizeOffset) override;
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override;
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override;
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override;
+
+  void addIntermediateResults(
+      char** /*groups*/,
+      const SelectivityVector& /*rows*/,
+      const std::vector<VectorPtr>& /*args*/,
+      bool /*mayPushdown*/) override {
+    unsupportedStep();
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* /*group*/,
+      const SelectivityVector& /*rows*/,
+      const std::vector<VectorPtr>& /*args*/,
+      bool /*mayPushdown*/) override {
+    unsupportedStep();
+  }
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override;
+
+  void extractAccumulators(
+      char** /*groups*/,
+      int32_t /*numGroups*/,
+      VectorPtr* /*result*/) override {
+    unsupportedStep();
+  }
+
+  void destroy(folly::Range<char**> groups) override {
+    aggregate_->destroy(groups);
+  }
+
+ private:
+  [[noreturn]] static void unsupportedStep();
+
+  // The rows of a group in 'inputs_' in the order they were added, linked
+  // through the next row pointers of 'inputs_'.
+  struct RowList {
+    char* FOLLY_NULLABLE first;
+    char* FOLLY_NULLABLE last;
+    int64_t size;
+  };
+
+  RowList& rowList(char* FOLLY_NONNULL group) const {
+    return *reinterpret_cast<RowList*>(group + offset_);
+  }
+
+  char* FOLLY_NULLABLE& nextRow(char* FOLLY_NONNULL row) const {
+    return *reinterpret_cast<char**>(row + inputs_->nextOffset());
+  }
+
+  // Stores the selected rows of 'args' in 'inputs_' and adds them to the list
+  // of groupAt(row).
+  template <typename GroupAt>
+  void addInput(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      GroupAt groupAt);
+
+  // Compares 'left' and 'right' on the sorting keys and, for DISTINCT, then
+  // on the arguments.
+  int32_t compare(
+      const char* FOLLY_NONNULL left,
+      const char* FOLLY_NONNULL right) const;
+
+  // True if 'left' and 'right' have the same arguments.
+  bool equalArgs(
+      const char* FOLLY_NONNULL left,
+      const char* FOLLY_NONNULL right) const;
+
+  // Sorts 'rows' from 'begin' and, for DISTINCT, removes the rows with the
+  // same arguments as the previous row.
+  void sortAndDeduplicate(std::vector<char*>& rows, size_t begin) const;
+
+  const std::unique_ptr<Aggregate> aggregate_;
+  const std::vector<TypePtr> argTypes_;
+  const std::vector<VectorPtr> constants_;
+  const bool distinct_;
+  memory::MemoryPool* const FOLLY_NONNULL pool_;
+
+  // The offset of the accumulator of 'aggregate_' from 'offset_'.
+  const int32_t aggregateOffset_;
+
+  // For each argument of 'aggregate_', its column in 'inputs_' or -1 if the
+  // argument is constant.
+  std::vector<int32_t> argColumns_;
+
+  // The number of columns of 'inputs_' that are arguments. The sorting keys
+  // follow.
+  int32_t numArgColumns_{0};
+
+  // Compare flags for the sorting keys.
+  std::vector<CompareFlags> sortingFlags_;
+
+  // The buffered input rows. Cleared once the rows of all groups have been
+  // added to 'aggregate_'.
+  std::unique_ptr<RowContainer> inputs_;
+
+  // The number of rows in 'inputs_' not yet added to 'aggregate_'.
+  int64_t numPendingRows_{0};
+
+  std::vector<DecodedVector> decodedInputs_;
+
+  // Reusable buffers for extractValues().
+  std::vector<char*> rows_;
+  std::vector<char*> rowGroups_;
+};
+
+} // namespace facebook::velox::exec
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/CrossJoinProbe.h"
 #include "velox/exec/Task.h"
+#include "velox/expression/FieldReference.h"
 
 namespace facebook::velox::exec {
 
@@ -28,6 +29,7 @@ CrossJoinProbe::CrossJoinProbe(
           operatorId,
           joinNode->id(),
           "CrossJoinProbe"),
+      joinType_{joinNode->joinType()},
       outputBatchSize_{outputBatchRows()} {
   auto probeType = joinNode->sources()[0]->outputType();
   for (auto i = 0; i < probeType->size(); ++i) {
@@ -45,9 +47,58 @@ CrossJoinProbe::CrossJoinProbe(
       buildProjections_.emplace_back(tableChannel.value(), i);
     }
   }
+
+  if (joinNode->joinCondition()) {
+    initializeJoinCondition(joinNode->joinCondition(), probeType, buildType);
+  }
+}
+
+void CrossJoinProbe::initializeJoinCondition(
+    const core::TypedExprPtr& joinCondition,
+    const RowTypePtr& probeType,
+    const RowTypePtr& buildType) {
+  std::vector<core::TypedExprPtr> conditions = {joinCondition};
+  joinCondition_ =
+      std::make_unique<ExprSet>(std::move(conditions), operatorCtx_->execCtx());
+
+  column_index_t conditionChannel = 0;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  auto numFields = joinCondition_->expr(0)->distinctFields().size();
+  names.reserve(numFields);
+  types.reserve(numFields);
+  for (const auto& field : joinCondition_->expr(0)->distinctFields()) {
+    const auto& name = field->field();
+    auto channel = probeType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      auto channelValue = channel.value();
+      conditionProbeInputs_.emplace_back(channelValue, conditionChannel++);
+      names.emplace_back(probeType->nameOf(channelValue));
+      types.emplace_back(probeType->childAt(channelValue));
+      continue;
+    }
+    channel = buildType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      auto channelValue = channel.value();
+      conditionBuildInputs_.emplace_back(channelValue, conditionChannel++);
+      names.emplace_back(buildType->nameOf(channelValue));
+      types.emplace_back(buildType->childAt(channelValue));
+      continue;
+    }
+    VELOX_FAIL(
+        "Nested loop join condition field not found in either probe or build input: {}",
+        field->toString());
+  }
+
+  conditionInputType_ = ROW(std::move(names), std::move(types));
 }
 
 BlockingReason CrossJoinProbe::isBlocked(ContinueFuture* future) {
+  if (future_.valid()) {
+    *future = std::move(future_);
+    return BlockingReason::kWaitForJoinProbe;
+  }
+
   if (buildData_.has_value()) {
     return BlockingReason::kNotBlocked;
   }
@@ -63,7 +114,14 @@ BlockingReason CrossJoinProbe::isBlocked(ContinueFuture* future) {
 
   buildData_ = std::move(buildData);
 
-  if (buildData_->empty()) {
+  if (producesBuildMisses()) {
+    buildMatched_.resize(buildData_->size());
+    for (auto i = 0; i < buildData_->size(); ++i) {
+      buildMatched_[i].assign(buildData_.value()[i]->size(), false);
+    }
+  }
+
+  if (buildData_->empty() && !producesProbeMisses()) {
     // Build side is empty. Return empty set of rows and  terminate the pipeline
     // early.
     buildSideEmpty_ = true;
@@ -80,73 +138,302 @@ void CrossJoinProbe::addInput(RowVectorPtr input) {
     child->loadedVector();
   }
   input_ = std::move(input);
+  if (producesProbeMisses()) {
+    probeMatched_.assign(input_->size(), false);
+  }
 }
 
 RowVectorPtr CrossJoinProbe::getOutput() {
+  if (finished_) {
+    return nullptr;
+  }
+
   if (!input_) {
+    if (noMoreInput_ && producesBuildMisses()) {
+      return getBuildMissOutput();
+    }
     return nullptr;
   }
 
+  outputBatchSize_ = adaptiveOutputBatchRows();
+  while (buildIndex_ < buildData_->size()) {
+    auto output = getBlockOutput();
+    if (output != nullptr) {
+      return output;
+    }
+  }
+
+  // 'input_' has been joined with all the build side vectors.
+  auto output = getProbeMissOutput();
+  buildIndex_ = 0;
+  input_.reset();
+  return output;
+}
+
+RowVectorPtr CrossJoinProbe::getBlockOutput() {
   const auto inputSize = input_->size();
+  const auto* build = buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
+  const vector_size_t buildSize = build->size();
 
-  auto buildSize = buildData_.value()[buildIndex_]->size();
-  vector_size_t probeCnt;
-  if (buildSize > outputBatchSize_) {
-    probeCnt = 1;
-  } else {
+  // Without a join condition, the output of a block is the block itself, so
+  // a large build vector may be returned as is. With a join condition, the
+  // block is limited to 'outputBatchSize_' pairs of rows to evaluate the
+  // condition on.
+  const vector_size_t buildCnt = joinCondition_
+      ? std::min<vector_size_t>(buildSize - buildRow_, outputBatchSize_)
+      : buildSize;
+  vector_size_t probeCnt = 1;
+  if (buildCnt == buildSize && buildSize < outputBatchSize_) {
     probeCnt = std::min(
         (vector_size_t)outputBatchSize_ / buildSize, inputSize - probeRow_);
   }
 
-  auto size = probeCnt * buildSize;
-  BufferPtr indices = allocateIndices(size, pool());
-  auto* rawIndices = indices->asMutable<vector_size_t>();
+  const auto size = probeCnt * buildCnt;
+  BufferPtr probeIndices = allocateIndices(size, pool());
+  auto* rawProbeIndices = probeIndices->asMutable<vector_size_t>();
   for (auto i = 0; i < probeCnt; ++i) {
     std::fill(
-        rawIndices + i * buildSize,
-        rawIndices + (i + 1) * buildSize,
+        rawProbeIndices + i * buildCnt,
+        rawProbeIndices + (i + 1) * buildCnt,
         probeRow_ + i);
   }
-  auto output = fillOutput(size, indices);
 
   BufferPtr buildIndices = nullptr;
-  if (probeCnt > 1) {
+  if (probeCnt > 1 || buildCnt < buildSize || joinCondition_) {
     buildIndices = allocateIndices(size, pool());
     auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
     for (auto i = 0; i < probeCnt; ++i) {
       std::iota(
-          rawBuildIndices + i * buildSize,
-          rawBuildIndices + (i + 1) * buildSize,
-          0);
+          rawBuildIndices + i * buildCnt,
+          rawBuildIndices + (i + 1) * buildCnt,
+          buildRow_);
     }
   }
 
-  auto buildRowVector =
-      buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
+  vector_size_t numOutput = size;
+  if (joinCondition_) {
+    numOutput = evalJoinCondition(*build, size, probeIndices, buildIndices);
+  } else {
+    // All the pairs of rows in the block match.
+    if (producesProbeMisses()) {
+      std::fill(
+          probeMatched_.begin() + probeRow_,
+          probeMatched_.begin() + probeRow_ + probeCnt,
+          true);
+    }
+    if (producesBuildMisses()) {
+      auto& matched = buildMatched_[buildIndex_];
+      std::fill(
+          matched.begin() + buildRow_,
+          matched.begin() + buildRow_ + buildCnt,
+          true);
+    }
+  }
+
+  buildRow_ += buildCnt;
+  if (buildRow_ == buildSize) {
+    buildRow_ = 0;
+    probeRow_ += probeCnt;
+    if (probeRow_ == inputSize) {
+      probeRow_ = 0;
+      ++buildIndex_;
+    }
+  }
+
+  if (numOutput == 0) {
+    return nullptr;
+  }
+
+  auto output = fillOutput(numOutput, probeIndices);
   for (const auto& projection : buildProjections_) {
-    VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
+    VectorPtr buildVector = build->childAt(projection.inputChannel);
 
     if (buildIndices) {
       buildVector = BaseVector::wrapInDictionary(
-          BufferPtr(nullptr), buildIndices, size, buildVector);
+          BufferPtr(nullptr), buildIndices, numOutput, buildVector);
     }
     output->childAt(projection.outputChannel) = buildVector;
   }
+  return output;
+}
 
-  probeRow_ += probeCnt;
-  if (probeRow_ == inputSize) {
-    probeRow_ = 0;
-    ++buildIndex_;
-    if (buildIndex_ == buildData_->size()) {
-      buildIndex_ = 0;
-      input_.reset();
+vector_size_t CrossJoinProbe::evalJoinCondition(
+    const RowVector& build,
+    vector_size_t size,
+    const BufferPtr& probeIndices,
+    const BufferPtr& buildIndices) {
+  std::vector<VectorPtr> conditionInputs(conditionInputType_->size());
+  for (const auto& projection : conditionProbeInputs_) {
+    conditionInputs[projection.outputChannel] = BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        probeIndices,
+        size,
+        input_->childAt(projection.inputChannel));
+  }
+  for (const auto& projection : conditionBuildInputs_) {
+    conditionInputs[projection.outputChannel] = BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        buildIndices,
+        size,
+        build.childAt(projection.inputChannel));
+  }
+  auto conditionInput = std::make_shared<RowVector>(
+      pool(),
+      conditionInputType_,
+      BufferPtr(nullptr),
+      size,
+      std::move(conditionInputs));
+
+  conditionRows_.resizeFill(size, true);
+  EvalCtx evalCtx(
+      operatorCtx_->execCtx(), joinCondition_.get(), conditionInput.get());
+  joinCondition_->eval(conditionRows_, evalCtx, conditionResult_);
+  decodedConditionResult_.decode(*conditionResult_[0], conditionRows_);
+
+  // Move the pairs that pass the condition to the front of the indices.
+  auto* rawProbeIndices = probeIndices->asMutable<vector_size_t>();
+  auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+  vector_size_t numPassed = 0;
+  for (auto i = 0; i < size; ++i) {
+    if (decodedConditionResult_.isNullAt(i) ||
+        !decodedConditionResult_.valueAt<bool>(i)) {
+      continue;
+    }
+    if (producesProbeMisses()) {
+      probeMatched_[rawProbeIndices[i]] = true;
+    }
+    if (producesBuildMisses()) {
+      buildMatched_[buildIndex_][rawBuildIndices[i]] = true;
+    }
+    rawProbeIndices[numPassed] = rawProbeIndices[i];
+    rawBuildIndices[numPassed] = rawBuildIndices[i];
+    ++numPassed;
+  }
+  return numPassed;
+}
+
+RowVectorPtr CrossJoinProbe::getProbeMissOutput() {
+  if (!producesProbeMisses()) {
+    return nullptr;
+  }
+
+  const auto inputSize = input_->size();
+  BufferPtr indices = allocateIndices(inputSize, pool());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  vector_size_t numMisses = 0;
+  for (auto i = 0; i < inputSize; ++i) {
+    if (!probeMatched_[i]) {
+      rawIndices[numMisses++] = i;
     }
   }
+  if (numMisses == 0) {
+    return nullptr;
+  }
+
+  auto output = fillOutput(numMisses, indices);
+  for (const auto& projection : buildProjections_) {
+    output->childAt(projection.outputChannel) = BaseVector::createNullConstant(
+        outputType_->childAt(projection.outputChannel), numMisses, pool());
+  }
   return output;
 }
 
+bool CrossJoinProbe::finishProbeInput() {
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last Driver to finish its input combines the build rows that matched
+  // in all the probe Drivers. The other Drivers wait in 'future_' so that
+  // their state stays valid until then.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return false;
+  }
+
+  for (auto& peer : peers) {
+    auto op = peer->findOperator(planNodeId());
+    auto* probe = dynamic_cast<CrossJoinProbe*>(op);
+    VELOX_CHECK(probe);
+    VELOX_CHECK_EQ(buildMatched_.size(), probe->buildMatched_.size());
+    for (auto i = 0; i < buildMatched_.size(); ++i) {
+      auto& matched = buildMatched_[i];
+      const auto& peerMatched = probe->buildMatched_[i];
+      for (auto row = 0; row < matched.size(); ++row) {
+        if (peerMatched[row]) {
+          matched[row] = true;
+        }
+      }
+    }
+  }
+
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+  return true;
+}
+
+RowVectorPtr CrossJoinProbe::getBuildMissOutput() {
+  if (!lastProber_) {
+    if (!finishProbeInput()) {
+      finished_ = true;
+      return nullptr;
+    }
+    lastProber_ = true;
+    buildIndex_ = 0;
+  }
+
+  while (buildIndex_ < buildData_->size()) {
+    const auto* build =
+        buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
+    const auto& matched = buildMatched_[buildIndex_];
+    ++buildIndex_;
+
+    const auto buildSize = build->size();
+    BufferPtr indices = allocateIndices(buildSize, pool());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    vector_size_t numMisses = 0;
+    for (auto i = 0; i < buildSize; ++i) {
+      if (!matched[i]) {
+        rawIndices[numMisses++] = i;
+      }
+    }
+    if (numMisses == 0) {
+      continue;
+    }
+
+    std::vector<VectorPtr> columns(outputType_->size());
+    for (const auto& projection : identityProjections_) {
+      columns[projection.outputChannel] = BaseVector::createNullConstant(
+          outputType_->childAt(projection.outputChannel), numMisses, pool());
+    }
+    for (const auto& projection : buildProjections_) {
+      columns[projection.outputChannel] = BaseVector::wrapInDictionary(
+          BufferPtr(nullptr),
+          indices,
+          numMisses,
+          build->childAt(projection.inputChannel));
+    }
+    return std::make_shared<RowVector>(
+        pool(), outputType_, BufferPtr(nullptr), numMisses, std::move(columns));
+  }
+
+  finished_ = true;
+  return nullptr;
+}
+
 bool CrossJoinProbe::isFinished() {
-  return buildSideEmpty_ || (noMoreInput_ && input_ == nullptr);
+  if (buildSideEmpty_) {
+    return true;
+  }
+  if (!noMoreInput_ || input_ != nullptr) {
+    return false;
+  }
+  if (!producesBuildMisses()) {
+    return true;
+  }
+  // Right and full joins are finished after the build rows with no match are
+  // produced by the last prober.
+  return finished_ && !future_.valid();
 }
 
 void CrossJoinProbe::close() {
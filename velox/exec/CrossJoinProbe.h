@@ -19,6 +19,21 @@
 #include "velox/exec/Operator.h"
 
 namespace facebook::velox::exec {
+
+/// Probe side of a NestedLoopJoinNode. Joins each input vector with all the
+/// build-side vectors one block at a time. A block pairs a few probe rows with
+/// all the rows of a build-side vector, or a single probe row with a range of
+/// the rows of a large build-side vector, and has at most 'outputBatchSize_'
+/// rows. The join condition, if any, is evaluated on each block using
+/// dictionary wrappers over the probe and build vectors, so that only the
+/// pairs that pass the condition are produced.
+///
+/// Supports inner, left, right and full joins. For left and full joins, the
+/// probe rows with no match are produced after the input vector has been
+/// joined with all the build-side vectors. For right and full joins, each
+/// prober tracks the build rows that matched. The last prober to finish
+/// combines the matches of all the probers and produces the build rows with
+/// no match.
 class CrossJoinProbe : public Operator {
  public:
   CrossJoinProbe(
@@ -41,8 +56,71 @@ class CrossJoinProbe : public Operator {
   void close() override;
 
  private:
-  /// Maximum number of rows in the output batch.
-  const uint32_t outputBatchSize_;
+  // Sets up 'joinCondition_' and the inputs of the join condition.
+  void initializeJoinCondition(
+      const core::TypedExprPtr& joinCondition,
+      const RowTypePtr& probeType,
+      const RowTypePtr& buildType);
+
+  // Returns true if the probe rows with no match are included in the output:
+  // left and full joins.
+  bool producesProbeMisses() const {
+    return isLeftJoin(joinType_) || isFullJoin(joinType_);
+  }
+
+  // Returns true if the build rows with no match are included in the output:
+  // right and full joins.
+  bool producesBuildMisses() const {
+    return isRightJoin(joinType_) || isFullJoin(joinType_);
+  }
+
+  // Joins the next block of 'input_' and the build vector at 'buildIndex_'.
+  // Returns null if no pair of rows in the block passes the join condition.
+  RowVectorPtr getBlockOutput();
+
+  // Evaluates the join condition on 'size' pairs of probe and build rows and
+  // moves the pairs that pass to the front of 'probeIndices' and
+  // 'buildIndices'. Returns the number of pairs that pass.
+  vector_size_t evalJoinCondition(
+      const RowVector& build,
+      vector_size_t size,
+      const BufferPtr& probeIndices,
+      const BufferPtr& buildIndices);
+
+  // Returns the rows of 'input_' with no match, with nulls for the build
+  // side columns, or null if all rows matched.
+  RowVectorPtr getProbeMissOutput();
+
+  // Called by each prober after it is done with all its input. Returns true
+  // if this is the last prober. The last prober combines the build rows that
+  // matched in all the probers into 'buildMatched_'. The other probers wait
+  // in 'future_' until then.
+  bool finishProbeInput();
+
+  // Returns the next build vector with rows that had no match, with nulls for
+  // the probe side columns. Returns null when all build vectors are done.
+  RowVectorPtr getBuildMissOutput();
+
+  const core::JoinType joinType_;
+
+  /// Maximum number of rows in the output batch. Adapted to the size of the
+  /// output rows at the start of each getOutput().
+  uint32_t outputBatchSize_;
+
+  // Join condition. Null if there is none.
+  std::unique_ptr<ExprSet> joinCondition_;
+
+  // Type of the RowVector the join condition is evaluated on.
+  RowTypePtr conditionInputType_;
+
+  // Maps the probe and build input channels to the channels of the join
+  // condition input.
+  std::vector<IdentityProjection> conditionProbeInputs_;
+  std::vector<IdentityProjection> conditionBuildInputs_;
+
+  SelectivityVector conditionRows_;
+  std::vector<VectorPtr> conditionResult_;
+  DecodedVector decodedConditionResult_;
 
   std::vector<IdentityProjection> buildProjections_;
 
@@ -55,6 +133,29 @@ class CrossJoinProbe : public Operator {
   // Input row to process on next call to getOutput().
   vector_size_t probeRow_{0};
 
+  // First row of the build side vector to process on next call to
+  // getOutput(). Non-zero only when a build vector is too large to be joined
+  // with a single probe row in one block.
+  vector_size_t buildRow_{0};
+
+  // For left and full joins, the rows of 'input_' that matched any build row.
+  std::vector<bool> probeMatched_;
+
+  // For right and full joins, the rows of each build side vector that matched
+  // any probe row of this prober. Combined across all probers by the last
+  // one.
+  std::vector<std::vector<bool>> buildMatched_;
+
+  // True if this prober is the last one to finish and produces the build rows
+  // with no match.
+  bool lastProber_{false};
+
+  // Used by the probers that are not last to wait until the last one has
+  // combined their 'buildMatched_'.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+
   bool buildSideEmpty_{false};
+
+  bool finished_{false};
 };
 } // namespace facebook::velox::exec
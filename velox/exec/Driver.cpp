@@ -19,10 +19,16 @@
 #include <folly/executors/task_queue/UnboundedBlockingQueue.h>
 #include <folly/executors/thread_factory/InitThreadFactory.h>
 #include <gflags/gflags.h>
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/process/ProcessBase.h"
+#include "velox/common/testutil/TestValue.h"
 #include "velox/common/time/Timer.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Task.h"
 
+using facebook::velox::common::testutil::TestValue;
+
 namespace facebook::velox::exec {
 
 DriverCtx::DriverCtx(
@@ -81,6 +87,12 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
         if (!driver->state().isTerminated) {
           state->operator_->recordBlockingTime(
               state->sinceMicros_, state->reason_);
+          driver->addTimelineEvent(
+              TimelineEvent::Type::kBlocked,
+              state->operator_,
+              state->sinceMicros_,
+              0,
+              state->reason_);
         }
         VELOX_CHECK(!driver->state().isSuspended);
         VELOX_CHECK(driver->state().hasBlockingFuture);
@@ -177,8 +189,15 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto* executor = driver->task()->queryCtx()->executor();
+  // A priority executor, e.g. a CPUThreadPoolExecutor with several priority
+  // queues, runs the queued drivers of the higher priority queries first.
+  if (executor->getNumPriorities() > 1) {
+    const auto priority = driver->priority_;
+    executor->addWithPriority([driver]() { Driver::run(driver); }, priority);
+  } else {
+    executor->add([driver]() { Driver::run(driver); });
+  }
 }
 
 Driver::Driver(
@@ -189,6 +208,17 @@ Driver::Driver(
   // Operators need access to their Driver for adaptation.
   ctx_->driver = this;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  cpuTimeSliceLimitMicros_ =
+      ctx_->queryConfig().driverCpuTimeSliceLimitMs() * 1'000UL;
+  maxInlineWaitMicros_ = ctx_->queryConfig().driverMaxInlineWaitMicros();
+  priority_ = ctx_->queryConfig().queryPriority();
+  if (BaseStatsReporter::registered) {
+    queueTimeCounterKey_ =
+        priorityCounterKey(kCounterDriverQueueTimeUs, priority_);
+  }
+  if (const auto maxEvents = ctx_->queryConfig().driverTimelineMaxEvents()) {
+    timeline_ = std::make_unique<DriverTimeline>(maxEvents);
+  }
 }
 
 namespace {
@@ -206,6 +236,15 @@ std::optional<column_index_t> getIdentityProjection(
 }
 } // namespace
 
+void Driver::noMoreOutputNeeded(int operatorIndex) {
+  for (auto i = numNotNeededOperators_; i < operatorIndex; ++i) {
+    auto op = operators_[i].get();
+    RuntimeStatWriterScopeGuard statsWriterGuard(op);
+    op->noMoreOutputNeeded();
+  }
+  numNotNeededOperators_ = std::max(numNotNeededOperators_, operatorIndex);
+}
+
 void Driver::pushdownFilters(int operatorIndex) {
   auto op = operators_[operatorIndex].get();
   const auto& filters = op->getDynamicFilters();
@@ -259,6 +298,12 @@ RowVectorPtr Driver::next(std::shared_ptr<BlockingState>& blockingState) {
   auto self = shared_from_this();
   RowVectorPtr result;
   auto stop = runInternal(self, blockingState, result);
+  // A yield only gives up the thread when running on an executor. Continue
+  // running on the caller's thread otherwise.
+  while (stop == StopReason::kYield) {
+    enqueueInternal();
+    stop = runInternal(self, blockingState, result);
+  }
 
   // We get kBlock if 'result' was produced; kAtEnd if pipeline has finished
   // processing and no more results will be produced; kAlreadyTerminated on
@@ -270,6 +315,23 @@ RowVectorPtr Driver::next(std::shared_ptr<BlockingState>& blockingState) {
   return result;
 }
 
+BlockingReason Driver::isBlocked(Operator* op, ContinueFuture* future) {
+  for (;;) {
+    const auto reason = op->isBlocked(future);
+    if (reason == BlockingReason::kNotBlocked || !future->valid()) {
+      return reason;
+    }
+    if (!future->isReady() && maxInlineWaitMicros_ != 0) {
+      future->wait(std::chrono::microseconds(maxInlineWaitMicros_));
+    }
+    if (!future->isReady()) {
+      return reason;
+    }
+    op->addRuntimeStat("inlineWakeups", RuntimeCounter(1));
+    *future = ContinueFuture();
+  }
+}
+
 void Driver::enqueueInternal() {
   VELOX_CHECK(!state_.isEnqueued);
   state_.isEnqueued = true;
@@ -283,6 +345,7 @@ StopReason Driver::runInternal(
     RowVectorPtr& result) {
   const auto now = getCurrentTimeMicro();
   const auto queuedTime = (now - queueTimeStartMicros_) * 1'000;
+  REPORT_ADD_STAT_VALUE(queueTimeCounterKey_, now - queueTimeStartMicros_);
   // Update the next operator's queueTime.
   auto stop = closed_ ? StopReason::kTerminate : task()->enter(state_, now);
   if (stop != StopReason::kNone) {
@@ -305,12 +368,25 @@ StopReason Driver::runInternal(
 
   // Update the queued time after entering the Task to ensure the stats have not
   // been deleted.
+  // Also count the times this Driver comes on thread on a different NUMA node
+  // than before, which makes the memory it has touched remote.
+  auto numaNode = process::getNumaNode();
+  TestValue::adjust(
+      "facebook::velox::exec::Driver::runInternal::numaNode", &numaNode);
   if (curOpIndex_ < operators_.size()) {
     operators_[curOpIndex_]->addRuntimeStat(
         "queuedWallNanos",
         RuntimeCounter(queuedTime, RuntimeCounter::Unit::kNanos));
+    if (numaNode_ != -1 && numaNode != numaNode_) {
+      operators_[curOpIndex_]->addRuntimeStat(
+          "numaNodeSwitches", RuntimeCounter(1));
+    }
   }
+  numaNode_ = numaNode;
 
+  // Exposes this driver to the memory arbitration requests initiated from this
+  // thread.
+  ScopedDriverThreadContext scopedDriverThreadContext(this);
   CancelGuard guard(task().get(), &state_, [&](StopReason reason) {
     // This is run on error or cancel exit.
     if (reason == StopReason::kTerminate) {
@@ -345,7 +421,14 @@ StopReason Driver::runInternal(
         curOpIndex_ = i;
         RuntimeStatWriterScopeGuard statsWriterGuard(op);
 
-        blockingReason_ = op->isBlocked(&future);
+        if (cpuTimeSliceLimitMicros_ != 0 &&
+            getCurrentTimeMicro() - now > cpuTimeSliceLimitMicros_) {
+          op->addRuntimeStat("timeSliceYields", RuntimeCounter(1));
+          guard.notThrown();
+          return StopReason::kYield;
+        }
+
+        blockingReason_ = isBlocked(op, &future);
         if (blockingReason_ != BlockingReason::kNotBlocked) {
           blockingState = std::make_shared<BlockingState>(
               self, std::move(future), op, blockingReason_);
@@ -356,7 +439,7 @@ StopReason Driver::runInternal(
         if (i < operators_.size() - 1) {
           nextOp = operators_[i + 1].get();
           RuntimeStatWriterScopeGuard statsWriterGuard(nextOp);
-          blockingReason_ = nextOp->isBlocked(&future);
+          blockingReason_ = isBlocked(nextOp, &future);
           if (blockingReason_ != BlockingReason::kNotBlocked) {
             blockingState = std::make_shared<BlockingState>(
                 self, std::move(future), nextOp, blockingReason_);
@@ -372,7 +455,13 @@ StopReason Driver::runInternal(
                     op->stats().wlock()->getOutputTiming.add(deltaTiming);
                   });
               RuntimeStatWriterScopeGuard statsWriterGuard(op);
+              const auto startMicros = timeline_ ? getCurrentTimeMicro() : 0;
               result = op->getOutput();
+              addTimelineEvent(
+                  TimelineEvent::Type::kGetOutput,
+                  op,
+                  startMicros,
+                  result ? result->size() : 0);
               if (result) {
                 VELOX_CHECK(
                     result->size() > 0,
@@ -397,7 +486,13 @@ StopReason Driver::runInternal(
                 lockedStats->addInputVector(resultBytes, result->size());
               }
               RuntimeStatWriterScopeGuard statsWriterGuard(nextOp);
+              const auto startMicros = timeline_ ? getCurrentTimeMicro() : 0;
               nextOp->addInput(result);
+              addTimelineEvent(
+                  TimelineEvent::Type::kAddInput,
+                  nextOp,
+                  startMicros,
+                  result->size());
               // The next iteration will see if operators_[i + 1] has
               // output now that it got input.
               i += 2;
@@ -414,7 +509,7 @@ StopReason Driver::runInternal(
               // is not blocked and empty, this is finished. If this is
               // not the source, just try to get output from the one
               // before.
-              blockingReason_ = op->isBlocked(&future);
+              blockingReason_ = isBlocked(op, &future);
               if (blockingReason_ != BlockingReason::kNotBlocked) {
                 blockingState = std::make_shared<BlockingState>(
                     self, std::move(future), op, blockingReason_);
@@ -428,7 +523,12 @@ StopReason Driver::runInternal(
                       nextOp->stats().wlock()->finishTiming.add(timing);
                     });
                 RuntimeStatWriterScopeGuard statsWriterGuard(nextOp);
+                const auto startMicros =
+                    timeline_ ? getCurrentTimeMicro() : 0;
                 nextOp->noMoreInput();
+                addTimelineEvent(
+                    TimelineEvent::Type::kNoMoreInput, nextOp, startMicros);
+                noMoreOutputNeeded(i);
                 break;
               }
             }
@@ -443,7 +543,13 @@ StopReason Driver::runInternal(
                 createDeltaCpuWallTimer([op](const CpuWallTiming& timing) {
                   op->stats().wlock()->getOutputTiming.add(timing);
                 });
+            const auto startMicros = timeline_ ? getCurrentTimeMicro() : 0;
             result = op->getOutput();
+            addTimelineEvent(
+                TimelineEvent::Type::kGetOutput,
+                op,
+                startMicros,
+                result ? result->size() : 0);
             if (result) {
               VELOX_CHECK(
                   result->size() > 0,
@@ -551,6 +657,40 @@ void Driver::addStatsToTask() {
   }
 }
 
+void Driver::addTimelineEvent(
+    TimelineEvent::Type type,
+    Operator* op,
+    uint64_t startMicros,
+    vector_size_t numRows,
+    BlockingReason blockingReason) {
+  if (!timeline_) {
+    return;
+  }
+  TimelineEvent event;
+  event.type = type;
+  event.operatorId = op->operatorId();
+  event.startMicros = startMicros;
+  event.durationMicros = getCurrentTimeMicro() - startMicros;
+  event.numRows = numRows;
+  event.memoryBytes = op->pool()->getCurrentBytes();
+  event.blockingReason = blockingReason;
+  timeline_->add(event);
+}
+
+void Driver::addTimelineToTask() {
+  if (!timeline_) {
+    return;
+  }
+  DriverTimelineEvents timeline;
+  timeline.pipelineId = ctx_->pipelineId;
+  timeline.driverId = ctx_->driverId;
+  for (auto& op : operators_) {
+    timeline.operatorTypes.push_back(op->operatorType());
+  }
+  timeline.events = timeline_->events();
+  task()->addTimeline(std::move(timeline));
+}
+
 void Driver::close() {
   if (closed_) {
     // Already closed.
@@ -560,6 +700,7 @@ void Driver::close() {
     LOG(FATAL) << "Driver::close is only allowed from the Driver's thread";
   }
   addStatsToTask();
+  addTimelineToTask();
   for (auto& op : operators_) {
     op->close();
   }
@@ -570,6 +711,7 @@ void Driver::close() {
 void Driver::closeByTask() {
   VELOX_CHECK(isTerminated());
   addStatsToTask();
+  addTimelineToTask();
   for (auto& op : operators_) {
     op->close();
   }
@@ -690,6 +832,24 @@ SuspendedSection::~SuspendedSection() {
   }
 }
 
+namespace {
+thread_local DriverThreadContext* driverThreadCtx{nullptr};
+} // namespace
+
+DriverThreadContext* driverThreadContext() {
+  return driverThreadCtx;
+}
+
+ScopedDriverThreadContext::ScopedDriverThreadContext(
+    Driver* FOLLY_NONNULL driver)
+    : savedContext_(driverThreadCtx), context_{driver} {
+  driverThreadCtx = &context_;
+}
+
+ScopedDriverThreadContext::~ScopedDriverThreadContext() {
+  driverThreadCtx = savedContext_;
+}
+
 std::string Driver::label() const {
   return fmt::format("<Driver {}:{}>", task()->taskId(), ctx_->driverId);
 }
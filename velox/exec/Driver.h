@@ -24,6 +24,7 @@
 #include "velox/connectors/Connector.h"
 #include "velox/core/PlanNode.h"
 #include "velox/core/QueryCtx.h"
+#include "velox/exec/DriverTimeline.h"
 
 namespace facebook::velox::exec {
 
@@ -315,10 +316,31 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   void close();
 
+  // Returns the blocking reason of 'op' and sets 'future' if 'op' is blocked.
+  // If the future is fulfilled already or within 'maxInlineWaitMicros_', asks
+  // 'op' again instead of going off thread.
+  BlockingReason isBlocked(Operator* op, ContinueFuture* future);
+
+  // Adds an event for 'op' to 'timeline_' if the timeline is enabled. The
+  // event lasts from 'startMicros' till now.
+  void addTimelineEvent(
+      TimelineEvent::Type type,
+      Operator* op,
+      uint64_t startMicros,
+      vector_size_t numRows = 0,
+      BlockingReason blockingReason = BlockingReason::kNotBlocked);
+
+  // Passes the events of 'timeline_' to the Task.
+  void addTimelineToTask();
+
   // Push down dynamic filters produced by the operator at the specified
   // position in the pipeline.
   void pushdownFilters(int operatorIndex);
 
+  // Calls noMoreOutputNeeded() on the operators before the one at
+  // 'operatorIndex', which finished, unless called for them already.
+  void noMoreOutputNeeded(int operatorIndex);
+
   /// If 'trackOperatorCpuUsage_' is true, returns initialized timer object to
   /// track cpu and wall time of an operation. Returns null otherwise.
   /// The delta CpuWallTiming object would be passes to 'func' upon destruction
@@ -344,9 +366,35 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   std::vector<std::unique_ptr<Operator>> operators_;
 
+  // The operators before this index have been told by noMoreOutputNeeded()
+  // that their output is not needed.
+  int32_t numNotNeededOperators_{0};
+
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 
   bool trackOperatorCpuUsage_;
+
+  // The max time in microseconds to run on thread before yielding. 0 means no
+  // limit.
+  uint64_t cpuTimeSliceLimitMicros_;
+
+  // The max time in microseconds to wait on thread for a blocked operator.
+  uint32_t maxInlineWaitMicros_;
+
+  // The priority of the query, see QueryConfig::queryPriority().
+  int8_t priority_;
+
+  // The stats key of the queue time of the drivers of 'priority_'.
+  std::string queueTimeCounterKey_;
+
+  // The NUMA node this was last on thread on. -1 if not run yet.
+  int32_t numaNode_{-1};
+
+  // The most recent operator calls and blocked intervals. Null if the timeline
+  // is disabled.
+  std::unique_ptr<DriverTimeline> timeline_;
+
+  friend class BlockingState;
 };
 
 using OperatorSupplier = std::function<std::unique_ptr<Operator>(
@@ -395,6 +443,13 @@ struct DriverFactory {
       std::shared_ptr<ExchangeClient> exchangeClient,
       std::function<int(int pipelineId)> numDrivers);
 
+  /// True if the Task can add Drivers to this pipeline while it runs and
+  /// retire them when they run out of splits. The pipeline reads splits with
+  /// a TableScan, keeps no state across splits other than partial
+  /// aggregations, and writes to a local exchange or to the partitioned output,
+  /// which both accept producers that join late.
+  bool supportsAddingDrivers() const;
+
   bool supportsSingleThreadedExecution() const {
     return !needsPartitionedOutput() && !needsExchangeClient() &&
         !needsLocalExchange();
@@ -472,4 +527,28 @@ class SuspendedSection {
   Driver* FOLLY_NONNULL driver_;
 };
 
+/// Provides the execution context of the driver running on the current thread.
+struct DriverThreadContext {
+  Driver* FOLLY_NONNULL driver;
+  /// True if 'driver' has been put into the suspended state by a memory
+  /// arbitration request initiated from this thread.
+  bool suspendedForArbitration{false};
+};
+
+/// Returns the execution context of the driver running on the current thread,
+/// or null if the current thread is not running a driver.
+DriverThreadContext* FOLLY_NULLABLE driverThreadContext();
+
+/// Sets the driver thread context of the current thread to 'driver' for the
+/// lifetime of this object.
+class ScopedDriverThreadContext {
+ public:
+  explicit ScopedDriverThreadContext(Driver* FOLLY_NONNULL driver);
+  ~ScopedDriverThreadContext();
+
+ private:
+  DriverThreadContext* const savedContext_;
+  DriverThreadContext context_;
+};
+
 } // namespace facebook::velox::exec
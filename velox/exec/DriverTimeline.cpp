@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverTimeline.h"
+
+#include <folly/json.h>
+
+#include "velox/exec/Driver.h"
+
+namespace facebook::velox::exec {
+
+std::vector<TimelineEvent> DriverTimeline::events() const {
+  std::vector<TimelineEvent> result;
+  const auto numKept = numEvents_ - numDropped();
+  result.reserve(numKept);
+  for (auto i = numEvents_ - numKept; i < numEvents_; ++i) {
+    result.push_back(events_[i % events_.size()]);
+  }
+  return result;
+}
+
+namespace {
+const char* eventTypeName(TimelineEvent::Type type) {
+  switch (type) {
+    case TimelineEvent::Type::kGetOutput:
+      return "getOutput";
+    case TimelineEvent::Type::kAddInput:
+      return "addInput";
+    case TimelineEvent::Type::kNoMoreInput:
+      return "noMoreInput";
+    case TimelineEvent::Type::kBlocked:
+      return "blocked";
+  }
+  VELOX_UNREACHABLE();
+}
+} // namespace
+
+std::string timelineToChromeTrace(
+    const std::vector<DriverTimelineEvents>& timelines) {
+  auto traceEvents = folly::dynamic::array();
+  for (const auto& timeline : timelines) {
+    for (const auto& event : timeline.events) {
+      auto args = folly::dynamic::object("memoryBytes", event.memoryBytes);
+      if (event.type == TimelineEvent::Type::kBlocked) {
+        args["reason"] = blockingReasonToString(event.blockingReason);
+      } else {
+        args["rows"] = event.numRows;
+      }
+      const std::string operatorType =
+          event.operatorId < timeline.operatorTypes.size()
+          ? timeline.operatorTypes[event.operatorId]
+          : "";
+      auto traceEvent = folly::dynamic::object(
+          "name",
+          fmt::format("{}.{}", operatorType, eventTypeName(event.type)));
+      traceEvent["cat"] = eventTypeName(event.type);
+      traceEvent["ph"] = "X";
+      traceEvent["ts"] = static_cast<int64_t>(event.startMicros);
+      traceEvent["dur"] = static_cast<int64_t>(event.durationMicros);
+      traceEvent["pid"] = timeline.pipelineId;
+      traceEvent["tid"] = timeline.driverId;
+      traceEvent["args"] = std::move(args);
+      traceEvents.push_back(std::move(traceEvent));
+    }
+  }
+  return folly::toJson(folly::dynamic::object("traceEvents", traceEvents));
+}
+
+} // namespace facebook::velox::exec
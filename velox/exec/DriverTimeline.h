@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "velox/vector/TypeAliases.h"
+
+namespace facebook::velox::exec {
+
+enum class BlockingReason;
+
+/// One operator call or blocked interval of a Driver.
+struct TimelineEvent {
+  enum class Type { kGetOutput, kAddInput, kNoMoreInput, kBlocked };
+
+  Type type;
+
+  /// The position of the operator in its pipeline.
+  int32_t operatorId;
+
+  /// Wall time since epoch.
+  uint64_t startMicros;
+  uint64_t durationMicros;
+
+  /// The number of rows produced by getOutput or received by addInput.
+  vector_size_t numRows{0};
+
+  /// The memory used by the operator at the end of the event.
+  int64_t memoryBytes{0};
+
+  /// Set for kBlocked.
+  BlockingReason blockingReason{};
+};
+
+/// A fixed size ring buffer of the most recent timeline events of a Driver.
+/// The events are added by the thread that has the Driver on thread, or with
+/// the Task mutex held while the Driver is blocked, so adding needs no
+/// locking.
+class DriverTimeline {
+ public:
+  explicit DriverTimeline(uint32_t capacity) : events_(capacity) {}
+
+  void add(const TimelineEvent& event) {
+    events_[numEvents_++ % events_.size()] = event;
+  }
+
+  /// Returns the events in the order they were added, the oldest first. Only
+  /// the last 'capacity' events are kept.
+  std::vector<TimelineEvent> events() const;
+
+  /// The number of events that were overwritten by newer ones.
+  uint64_t numDropped() const {
+    return numEvents_ > events_.size() ? numEvents_ - events_.size() : 0;
+  }
+
+ private:
+  std::vector<TimelineEvent> events_;
+  uint64_t numEvents_{0};
+};
+
+/// The timeline events of a Driver, passed to its Task when the Driver
+/// closes.
+struct DriverTimelineEvents {
+  int32_t pipelineId;
+  uint32_t driverId;
+
+  /// The operator types of the Driver by operator id.
+  std::vector<std::string> operatorTypes;
+
+  std::vector<TimelineEvent> events;
+};
+
+/// Returns 'timelines' in the Chrome trace event JSON format, which can be
+/// loaded in chrome://tracing or Perfetto. Each Driver is a thread in the
+/// process of its pipeline.
+std::string timelineToChromeTrace(
+    const std::vector<DriverTimelineEvents>& timelines);
+
+} // namespace facebook::velox::exec
@@ -93,7 +93,7 @@ class LocalExchangeSource : public ExchangeSource {
     return !requestPending_.exchange(true);
   }
 
-  void request() override {
+  void request(uint64_t maxBytes) override {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
     VELOX_CHECK_NOT_NULL(buffers, "invalid PartitionedOutputBufferManager");
     VELOX_CHECK(requestPending_);
@@ -102,11 +102,11 @@ class LocalExchangeSource : public ExchangeSource {
     buffers->getData(
         taskId_,
         destination_,
-        kMaxBytes,
+        maxBytes,
         sequence_,
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
-        [self, requestedSequence, buffers, this](
+        [self, requestedSequence, maxBytes, buffers, this](
             std::vector<std::unique_ptr<folly::IOBuf>> data, int64_t sequence) {
           if (requestedSequence > sequence) {
             VLOG(2) << "Receives earlier sequence than requested: task "
@@ -120,6 +120,7 @@ class LocalExchangeSource : public ExchangeSource {
           }
           std::vector<std::unique_ptr<SerializedPage>> pages;
           bool atEnd = false;
+          uint64_t bytes = 0;
           for (auto& inputPage : data) {
             if (!inputPage) {
               atEnd = true;
@@ -127,6 +128,7 @@ class LocalExchangeSource : public ExchangeSource {
               continue;
             }
             inputPage->unshare();
+            bytes += inputPage->computeChainDataLength();
             pages.push_back(
                 std::make_unique<SerializedPage>(std::move(inputPage), pool_));
             inputPage = nullptr;
@@ -144,6 +146,10 @@ class LocalExchangeSource : public ExchangeSource {
                 queue_->enqueueLocked(nullptr, promises);
                 atEnd_ = true;
               }
+              // A response that filled the request likely left more data in
+              // the producer's buffer.
+              finishRequestLocked(
+                  bytes, !atEnd && bytes >= maxBytes ? maxBytes : 0);
               ackSequence = sequence_ = sequence + pages.size();
             }
             for (auto& promise : promises) {
@@ -163,9 +169,6 @@ class LocalExchangeSource : public ExchangeSource {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
     buffers->deleteResults(taskId_, destination_);
   }
-
- private:
-  static constexpr uint64_t kMaxBytes = 32 * 1024 * 1024; // 32 MB
 };
 
 std::unique_ptr<ExchangeSource> createLocalExchangeSource(
@@ -183,7 +186,7 @@ std::unique_ptr<ExchangeSource> createLocalExchangeSource(
 } // namespace
 
 void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
-  std::shared_ptr<ExchangeSource> toRequest;
+  std::vector<Request> toRequest;
   std::shared_ptr<ExchangeSource> toClose;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
@@ -201,18 +204,15 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
     } else {
       sources_.push_back(source);
       queue_->addSourceLocked();
-      if (source->shouldRequestLocked()) {
-        toRequest = source;
-      }
+      toRequest = pickSourcesToRequestLocked();
     }
   }
 
   // Outside of lock.
   if (toClose) {
     toClose->close();
-  } else if (toRequest) {
-    toRequest->request();
   }
+  request(toRequest);
 }
 
 void ExchangeClient::noMoreRemoteTasks() {
@@ -240,7 +240,7 @@ void ExchangeClient::close() {
 std::unique_ptr<SerializedPage> ExchangeClient::next(
     bool* atEnd,
     ContinueFuture* future) {
-  std::vector<std::shared_ptr<ExchangeSource>> toRequest;
+  std::vector<Request> toRequest;
   std::unique_ptr<SerializedPage> page;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
@@ -254,32 +254,134 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
     }
     // There is space for more data, send requests to sources with no pending
     // request.
-    for (auto& source : sources_) {
-      if (source->shouldRequestLocked()) {
-        toRequest.push_back(source);
-      }
-    }
+    toRequest = pickSourcesToRequestLocked();
   }
 
   // Outside of lock
-  for (auto& source : toRequest) {
-    source->request();
-  }
+  request(toRequest);
   return page;
 }
 
+std::vector<ExchangeClient::Request>
+ExchangeClient::pickSourcesToRequestLocked() {
+  int32_t numInFlight = 0;
+  uint64_t bytesInFlight = 0;
+  std::vector<std::shared_ptr<ExchangeSource>> candidates;
+  for (auto& source : sources_) {
+    if (source->requestPending_) {
+      ++numInFlight;
+      bytesInFlight += source->statsLocked().bytesInFlight;
+    } else if (!source->atEnd_) {
+      candidates.push_back(source);
+    }
+  }
+  maxBytesInFlight_ = std::max(maxBytesInFlight_, bytesInFlight);
+  if (candidates.empty() || numInFlight >= maxRequestsInFlight_) {
+    return {};
+  }
+  const int64_t minBytes = queue_->minBytes();
+  int64_t budget = minBytes - static_cast<int64_t>(queue_->totalBytes()) -
+      static_cast<int64_t>(bytesInFlight);
+  if (budget < kMinRequestBytes) {
+    if (numInFlight > 0) {
+      return {};
+    }
+    // Nothing is pending. Keep the queue moving with a single request.
+    budget = kMinRequestBytes;
+  }
+
+  // Sources known to have data first, then the ones that waited longest.
+  std::stable_sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const auto& left, const auto& right) {
+        const bool leftHasData = left->availableBytesLocked() > 0;
+        const bool rightHasData = right->availableBytesLocked() > 0;
+        if (leftHasData != rightHasData) {
+          return leftHasData;
+        }
+        return left->requestStartMicrosLocked() <
+            right->requestStartMicrosLocked();
+      });
+
+  // A request gets an equal share of the queue so that sources that have no
+  // data yet do not hold up the budget for the others.
+  const int64_t share =
+      std::max(kMinRequestBytes, minBytes / maxRequestsInFlight_);
+  const int64_t numRequests = std::min<int64_t>(
+      {maxRequestsInFlight_ - numInFlight,
+       static_cast<int64_t>(candidates.size()),
+       std::max<int64_t>(1, budget / share)});
+  const uint64_t maxBytes = std::min(share, budget / numRequests);
+
+  std::vector<Request> requests;
+  for (auto& source : candidates) {
+    if (static_cast<int64_t>(requests.size()) == numRequests) {
+      break;
+    }
+    if (!source->shouldRequestLocked()) {
+      continue;
+    }
+    source->startRequestLocked(maxBytes);
+    requests.push_back({source, maxBytes});
+  }
+  return requests;
+}
+
+// static
+void ExchangeClient::request(std::vector<Request>& requests) {
+  for (auto& request : requests) {
+    request.source->request(request.maxBytes);
+  }
+}
+
+std::unordered_map<std::string, RuntimeMetric> ExchangeClient::stats() const {
+  std::unordered_map<std::string, RuntimeMetric> stats;
+  RuntimeMetric numRequests;
+  RuntimeMetric latency(RuntimeCounter::Unit::kNanos);
+  std::lock_guard<std::mutex> l(queue_->mutex());
+  for (const auto& source : sources_) {
+    const auto& sourceStats = source->statsLocked();
+    numRequests.addValue(sourceStats.numRequests);
+    latency.merge(sourceStats.latencyNanos);
+  }
+  stats["exchangeRequests"] = numRequests;
+  stats["exchangeRequestLatency"] = latency;
+  RuntimeMetric maxBytesInFlight(RuntimeCounter::Unit::kBytes);
+  maxBytesInFlight.addValue(maxBytesInFlight_);
+  stats["exchangeMaxBytesInFlight"] = maxBytesInFlight;
+  return stats;
+}
+
 ExchangeClient::~ExchangeClient() {
   close();
 }
 
 std::string ExchangeClient::toString() {
   std::stringstream out;
+  out << "[ExchangeClient wire bytes " << wireBytes_ << " raw bytes "
+      << rawBytes_ << "]" << std::endl;
   for (auto& source : sources_) {
     out << source->toString() << std::endl;
   }
   return out.str();
 }
 
+void Exchange::recordExchangeClientStats() {
+  if (operatorCtx_->driverCtx()->driverId != 0) {
+    return;
+  }
+  auto lockedStats = stats_.wlock();
+  for (const auto& [name, value] : exchangeClient_->stats()) {
+    auto it = lockedStats->runtimeStats.find(name);
+    if (it == lockedStats->runtimeStats.end()) {
+      lockedStats->runtimeStats.emplace(name, value);
+    } else {
+      it->second.merge(value);
+    }
+  }
+}
+
 bool Exchange::getSplits(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
     // When there are multiple pipelines, a single operator, the one from
@@ -357,6 +459,17 @@ bool Exchange::isFinished() {
   return atEnd_;
 }
 
+void Exchange::noMoreOutputNeeded() {
+  if (atEnd_) {
+    return;
+  }
+  atEnd_ = true;
+  currentPage_ = nullptr;
+  if (exchangeClient_) {
+    exchangeClient_->close();
+  }
+}
+
 RowVectorPtr Exchange::getOutput() {
   if (!currentPage_) {
     return nullptr;
@@ -367,18 +480,52 @@ RowVectorPtr Exchange::getOutput() {
     inputStream_ = std::make_unique<ByteStream>();
     rawInputBytes += currentPage_->size();
     currentPage_->prepareStreamForDeserialize(inputStream_.get());
+    if (zeroCopyDeserialize_) {
+      serdeOptions_.inputOwner = currentPage_;
+    }
   }
 
-  getSerde()->deserialize(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+  // Bytes added to the page by decompression.
+  int64_t decompressedBytes{0};
+  if (serdeOptions_.compressionKind != common::CompressionKind_NONE) {
+    const auto [uncompressedSize, sizeInBytes] =
+        serializer::presto::PrestoVectorSerde::peekPageSizes(
+            inputStream_.get());
+    decompressedBytes = uncompressedSize - sizeInBytes;
+  }
 
+  getSerde()->deserialize(
+      inputStream_.get(),
+      operatorCtx_->pool(),
+      outputType_,
+      &result_,
+      &serdeOptions_);
+
+  exchangeClient_->addReceivedBytes(
+      rawInputBytes, rawInputBytes + decompressedBytes);
   {
     auto lockedStats = stats_.wlock();
     lockedStats->rawInputBytes += rawInputBytes;
+    if (rawInputBytes > 0) {
+      lockedStats->addRuntimeStat(
+          "exchangePageBytes",
+          RuntimeCounter(rawInputBytes, RuntimeCounter::Unit::kBytes, true));
+    }
     lockedStats->addInputVector(result_->estimateFlatSize(), result_->size());
+    if (serdeOptions_.compressionKind != common::CompressionKind_NONE) {
+      lockedStats->addRuntimeStat(
+          "exchangeWireBytes",
+          RuntimeCounter(rawInputBytes, RuntimeCounter::Unit::kBytes));
+      lockedStats->addRuntimeStat(
+          "exchangeRawBytes",
+          RuntimeCounter(
+              rawInputBytes + decompressedBytes,
+              RuntimeCounter::Unit::kBytes));
+    }
   }
 
   if (inputStream_->atEnd()) {
+    serdeOptions_.inputOwner = nullptr;
     currentPage_ = nullptr;
     inputStream_ = nullptr;
   }
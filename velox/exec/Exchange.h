@@ -18,8 +18,12 @@
 #include <velox/common/memory/Memory.h>
 #include <velox/common/memory/MemoryAllocator.h>
 #include <memory>
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/memory/ByteStream.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/Operator.h"
+#include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
 
@@ -203,6 +207,8 @@ class ExchangeQueue {
  private:
   std::vector<ContinuePromise> closeLocked() {
     queue_.clear();
+    // The consumers that are still reading see the end of the data.
+    atEnd_ = true;
     return clearAllPromisesLocked();
   }
 
@@ -286,10 +292,11 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   // threads from issuing the same request.
   virtual bool shouldRequestLocked() = 0;
 
-  // Requests the producer to generate more data. Call only if shouldRequest()
-  // was true. The object handles its own lifetime by acquiring a
-  // shared_from_this() pointer if needed.
-  virtual void request() = 0;
+  // Requests the producer to generate up to about 'maxBytes' more data. A
+  // response may exceed 'maxBytes' by at most one page. Call only if
+  // shouldRequest() was true. The object handles its own lifetime by
+  // acquiring a shared_from_this() pointer if needed.
+  virtual void request(uint64_t maxBytes) = 0;
 
   // Close the exchange source. May be called before all data
   // has been received and proessed. This can happen in case
@@ -300,10 +307,64 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   virtual std::string toString() {
     std::stringstream out;
     out << "[ExchangeSource " << taskId_ << ":" << destination_
-        << (requestPending_ ? " pending " : "") << (atEnd_ ? " at end" : "");
+        << (requestPending_ ? " pending " : "") << (atEnd_ ? " at end" : "")
+        << " requests " << stats_.numRequests << " received "
+        << stats_.bytesReceived << "b in flight " << stats_.bytesInFlight
+        << "b latency " << stats_.latencyNanos.toString() << "]";
     return out.str();
   }
 
+  struct Stats {
+    Stats() {
+      latencyNanos.enableHistogram();
+    }
+
+    int64_t numRequests{0};
+    uint64_t bytesReceived{0};
+    // Byte limit of the pending request. Meaningful only while
+    // 'requestPending_' is true.
+    uint64_t bytesInFlight{0};
+    // Time from request() to receiving the response.
+    RuntimeMetric latencyNanos{RuntimeCounter::Unit::kNanos};
+  };
+
+  // Records the start of a request for 'maxBytes'. Called by ExchangeClient
+  // under queue_->mutex() before request().
+  void startRequestLocked(uint64_t maxBytes) {
+    ++stats_.numRequests;
+    stats_.bytesInFlight = maxBytes;
+    requestStartMicros_ = getCurrentTimeMicro();
+  }
+
+  // Records the response to the last request. 'bytes' is the size of the
+  // received pages. 'availableBytes' is the number of bytes the producer is
+  // known or expected to have ready after this response, 0 if this is not
+  // known. Called by the implementations under queue_->mutex().
+  void finishRequestLocked(uint64_t bytes, uint64_t availableBytes) {
+    stats_.bytesReceived += bytes;
+    stats_.bytesInFlight = 0;
+    const auto latencyMicros = getCurrentTimeMicro() - requestStartMicros_;
+    stats_.latencyNanos.addValue(latencyMicros * 1'000);
+    REPORT_ADD_HISTOGRAM_VALUE(
+        kCounterExchangeRequestLatencyMs, latencyMicros / 1'000);
+    availableBytes_ = availableBytes;
+  }
+
+  // The statistics of the requests. Call under queue_->mutex().
+  const Stats& statsLocked() const {
+    return stats_;
+  }
+
+  // See finishRequestLocked(). Call under queue_->mutex().
+  uint64_t availableBytesLocked() const {
+    return availableBytes_;
+  }
+
+  // Time of the start of the last request. Call under queue_->mutex().
+  uint64_t requestStartMicrosLocked() const {
+    return requestStartMicros_;
+  }
+
   static void registerFactory();
 
   static bool registerFactory(Factory factory) {
@@ -324,6 +385,11 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
 
  protected:
   memory::MemoryPool* pool_;
+
+ private:
+  Stats stats_;
+  uint64_t availableBytes_{0};
+  uint64_t requestStartMicros_{0};
 };
 
 struct RemoteConnectorSplit : public connector::ConnectorSplit {
@@ -335,17 +401,32 @@ struct RemoteConnectorSplit : public connector::ConnectorSplit {
 
 // Handle for a set of producers. This may be shared by multiple Exchanges, one
 // per consumer thread.
+// Fetches pages from the ExchangeSources of the producer tasks into an
+// ExchangeQueue. The byte budget of the queue, minBytes() minus the queued
+// bytes and the limits of the pending requests, is divided between new
+// requests of at most minBytes() / 'maxRequestsInFlight' bytes each. Sources
+// that are expected to have data ready are requested first, then the sources
+// that have waited longest since their last request. At most
+// 'maxRequestsInFlight' requests are pending at a time, so that a consumer of
+// thousands of producers does not overshoot its memory with responses.
 class ExchangeClient {
  public:
   static constexpr int32_t kDefaultMinSize = 32 << 20; // 32 MB.
+  static constexpr int32_t kDefaultMaxRequestsInFlight = 64;
+
+  // Smallest byte limit of a request.
+  static constexpr int64_t kMinRequestBytes = 1 << 20; // 1 MB.
 
   ExchangeClient(
       int destination,
       memory::MemoryPool* pool,
-      int64_t minSize = kDefaultMinSize)
+      int64_t minSize = kDefaultMinSize,
+      int32_t maxRequestsInFlight = kDefaultMaxRequestsInFlight)
       : destination_(destination),
         pool_(pool),
+        maxRequestsInFlight_(maxRequestsInFlight),
         queue_(std::make_shared<ExchangeQueue>(minSize)) {
+    VELOX_CHECK_GT(maxRequestsInFlight_, 0);
     VELOX_CHECK_NOT_NULL(pool_);
     VELOX_CHECK(
         destination >= 0,
@@ -376,15 +457,53 @@ class ExchangeClient {
 
   std::unique_ptr<SerializedPage> next(bool* atEnd, ContinueFuture* future);
 
+  // Records that pages of 'wireBytes' were received and consumed and that
+  // they are 'rawBytes' after decompression.
+  void addReceivedBytes(int64_t wireBytes, int64_t rawBytes) {
+    wireBytes_ += wireBytes;
+    rawBytes_ += rawBytes;
+  }
+
+  // Bytes of the pages consumed from 'this' as received from the producers.
+  int64_t wireBytes() const {
+    return wireBytes_;
+  }
+
+  // Bytes of the pages consumed from 'this' after decompression.
+  int64_t rawBytes() const {
+    return rawBytes_;
+  }
+
+  // Returns the request statistics aggregated over the sources:
+  // "exchangeRequests", "exchangeRequestLatency" and
+  // "exchangeMaxBytesInFlight".
+  std::unordered_map<std::string, RuntimeMetric> stats() const;
+
   std::string toString();
 
  private:
+  struct Request {
+    std::shared_ptr<ExchangeSource> source;
+    uint64_t maxBytes;
+  };
+
+  // Picks the sources to request and their byte limits. See the class
+  // comment.
+  std::vector<Request> pickSourcesToRequestLocked();
+
+  static void request(std::vector<Request>& requests);
+
   const int destination_;
   memory::MemoryPool* const pool_;
+  const int32_t maxRequestsInFlight_;
   std::shared_ptr<ExchangeQueue> queue_;
   std::unordered_set<std::string> taskIds_;
   std::vector<std::shared_ptr<ExchangeSource>> sources_;
   bool closed_{false};
+  std::atomic<int64_t> wireBytes_{0};
+  std::atomic<int64_t> rawBytes_{0};
+  // Largest sum of the byte limits of the pending requests.
+  uint64_t maxBytesInFlight_{0};
 };
 
 class Exchange : public SourceOperator {
@@ -402,6 +521,11 @@ class Exchange : public SourceOperator {
             exchangeNode->id(),
             operatorType),
         planNodeId_(exchangeNode->id()),
+        serdeOptions_(
+            false,
+            common::stringToCompressionKind(
+                ctx->queryConfig().exchangeCompressionKind())),
+        zeroCopyDeserialize_(ctx->queryConfig().exchangeZeroCopyDeserialize()),
         exchangeClient_(std::move(exchangeClient)) {}
 
   ~Exchange() override {
@@ -412,9 +536,11 @@ class Exchange : public SourceOperator {
 
   void close() override {
     SourceOperator::close();
+    serdeOptions_.inputOwner = nullptr;
     currentPage_ = nullptr;
     result_ = nullptr;
     if (exchangeClient_) {
+      recordExchangeClientStats();
       exchangeClient_->close();
     }
     exchangeClient_ = nullptr;
@@ -424,10 +550,19 @@ class Exchange : public SourceOperator {
 
   bool isFinished() override;
 
+  /// Closes the ExchangeClient, which closes the remote sources, so that the
+  /// producers can finish. The ExchangeClient is shared by the drivers of the
+  /// pipeline, which all see the end of the data.
+  void noMoreOutputNeeded() override;
+
  protected:
   virtual VectorSerde* getSerde();
 
  private:
+  /// Adds the request statistics of the shared 'exchangeClient_' to the
+  /// runtime stats of the operator of pipeline 0.
+  void recordExchangeClientStats();
+
   /// Fetches splits from the task until there are no more splits or task
   /// returns a future that will be complete when more splits arrive. Adds
   /// splits to exchangeClient_. Returns true if received a future from the task
@@ -438,6 +573,13 @@ class Exchange : public SourceOperator {
   bool getSplits(ContinueFuture* future);
 
   const core::PlanNodeId planNodeId_;
+
+  // Options for deserializing the pages, e.g. the compression codec.
+  // 'inputOwner' is set to 'currentPage_' while it is deserialized if
+  // 'zeroCopyDeserialize_' is true.
+  serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
+  const bool zeroCopyDeserialize_;
+
   bool noMoreSplits_ = false;
 
   /// A future received from Task::getSplitOrFuture(). It will be complete when
@@ -446,7 +588,9 @@ class Exchange : public SourceOperator {
 
   RowVectorPtr result_;
   std::shared_ptr<ExchangeClient> exchangeClient_;
-  std::unique_ptr<SerializedPage> currentPage_;
+  // Shared with the vectors that reference the page memory when
+  // 'zeroCopyDeserialize_' is true.
+  std::shared_ptr<SerializedPage> currentPage_;
   std::unique_ptr<ByteStream> inputStream_;
   bool atEnd_{false};
 };
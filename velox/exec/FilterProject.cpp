@@ -15,6 +15,7 @@
  */
 #include "velox/exec/FilterProject.h"
 #include "velox/core/Expressions.h"
+#include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/FieldReference.h"
 
@@ -39,6 +40,32 @@ bool checkAddIdentityProjection(
 
   return false;
 }
+
+// Returns true if 'expr' is a tree of simple functions over top level fields
+// and constants for which evaluating a few rows at a time does not add
+// overhead beyond the per call dispatch: all results are fixed width and all
+// functions are deterministic and support the flat no nulls fast path.
+bool isBlockEvaluable(const Expr& expr) {
+  if (!expr.type()->isFixedWidth()) {
+    return false;
+  }
+  if (dynamic_cast<const FieldReference*>(&expr)) {
+    return expr.inputs().empty();
+  }
+  if (dynamic_cast<const ConstantExpr*>(&expr)) {
+    return true;
+  }
+  if (expr.isSpecialForm() || !expr.isDeterministic() ||
+      !expr.supportsFlatNoNullsFastPath()) {
+    return false;
+  }
+  for (const auto& input : expr.inputs()) {
+    if (!isBlockEvaluable(*input)) {
+      return false;
+    }
+  }
+  return true;
+}
 } // namespace
 
 FilterProject::FilterProject(
@@ -52,7 +79,10 @@ FilterProject::FilterProject(
           operatorId,
           project ? project->id() : filter->id(),
           "FilterProject"),
-      hasFilter_(filter != nullptr) {
+      hasFilter_(filter != nullptr),
+      projectionBlockSize_(driverCtx->queryConfig().projectionBlockSize()),
+      stringCompactionMinUsedRatio_(
+          driverCtx->queryConfig().stringCompactionMinUsedRatio()) {
   std::vector<core::TypedExprPtr> allExprs;
   if (hasFilter_) {
     allExprs.push_back(filter->filter());
@@ -76,6 +106,13 @@ FilterProject::FilterProject(
   }
   numExprs_ = allExprs.size();
   exprs_ = makeExprSetFromFlag(std::move(allExprs), operatorCtx_->execCtx());
+  if (projectionBlockSize_ > 0 && !resultProjections_.empty()) {
+    blockEvaluable_ = true;
+    for (const auto& projection : resultProjections_) {
+      blockEvaluable_ &=
+          isBlockEvaluable(*exprs_->expr(projection.inputChannel));
+    }
+  }
 
   if (numExprs_ > 0 && !identityProjections_.empty()) {
     auto inputType = project ? project->sources()[0]->outputType()
@@ -85,10 +122,22 @@ FilterProject::FilterProject(
       auto fieldIndex = inputType->getChildIdx(field->name());
       distinctFieldIndices.insert(fieldIndex);
     }
+    std::unordered_set<uint32_t> filterFieldIndices;
+    if (hasFilter_) {
+      for (auto field : exprs_->expr(0)->distinctFields()) {
+        filterFieldIndices.insert(inputType->getChildIdx(field->name()));
+      }
+    }
     for (auto identityField : identityProjections_) {
-      if (distinctFieldIndices.find(identityField.inputChannel) !=
-          distinctFieldIndices.end()) {
-        multiplyReferencedFieldIndices_.push_back(identityField.inputChannel);
+      const auto channel = identityField.inputChannel;
+      if (distinctFieldIndices.find(channel) == distinctFieldIndices.end()) {
+        continue;
+      }
+      if (!hasFilter_ ||
+          filterFieldIndices.find(channel) != filterFieldIndices.end()) {
+        multiplyReferencedFieldIndices_.push_back(channel);
+      } else {
+        multiplyReferencedProjectionFieldIndices_.push_back(channel);
       }
     }
   }
@@ -102,6 +151,12 @@ void FilterProject::addInput(RowVectorPtr input) {
     for (auto& result : results_) {
       if (result && result.unique() && result->isFlatEncoding()) {
         BaseVector::prepareForReuse(result, 0);
+      } else if (
+          result && result.unique() &&
+          operatorCtx_->execCtx()->releaseVector(result)) {
+        // Complex results are recycled through the vector pool which the
+        // expressions allocate their results from.
+        VELOX_DCHECK_NULL(result);
       } else {
         result.reset();
       }
@@ -176,18 +231,80 @@ RowVectorPtr FilterProject::getOutput() {
     if (!allRowsSelected) {
       rows->setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
     }
+    // The columns that are not filter inputs are loaded only for the rows
+    // that pass the filter.
+    for (auto fieldIdx : multiplyReferencedProjectionFieldIndices_) {
+      evalCtx.ensureFieldLoaded(fieldIdx, *rows);
+    }
     project(*rows, evalCtx);
   }
 
-  return fillOutput(
-      numOut, allRowsSelected ? nullptr : filterEvalCtx_.selectedIndices);
+  if (allRowsSelected) {
+    return fillOutput(numOut, nullptr);
+  }
+  auto output = fillOutput(numOut, filterEvalCtx_.selectedIndices);
+  if (stringCompactionMinUsedRatio_ > 0) {
+    output = std::static_pointer_cast<RowVector>(
+        BaseVector::compactStringBuffers(
+            output, stringCompactionMinUsedRatio_));
+  }
+  return output;
 }
 
 void FilterProject::project(const SelectivityVector& rows, EvalCtx& evalCtx) {
+  if (blockEvaluable_ && rows.end() >= 2 * projectionBlockSize_) {
+    projectInBlocks(rows, evalCtx);
+    return;
+  }
   exprs_->eval(
       hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results_);
 }
 
+void FilterProject::projectInBlocks(
+    const SelectivityVector& rows,
+    EvalCtx& evalCtx) {
+  // The results are allocated for all rows, so that each block writes its
+  // part of them in place.
+  for (const auto& projection : resultProjections_) {
+    auto& result = results_[projection.inputChannel];
+    if (result && result.unique() && result->isFlatEncoding()) {
+      result->resize(rows.end());
+    } else {
+      result = BaseVector::create(
+          exprs_->expr(projection.inputChannel)->type(), rows.end(), pool());
+    }
+  }
+  // Lazy vectors are loaded for all rows. A lazy vector loaded for the rows
+  // of the first block could not be loaded for the others.
+  for (const auto& field : exprs_->distinctFields()) {
+    evalCtx.ensureFieldLoaded(field->index(evalCtx), rows);
+  }
+
+  LocalSelectivityVector blockRowsHolder(evalCtx, rows);
+  auto* blockRows = blockRowsHolder.get();
+  bool initialize = !hasFilter_;
+  for (auto begin = rows.begin(); begin < rows.end();
+       begin += projectionBlockSize_) {
+    const auto end = std::min(begin + projectionBlockSize_, rows.end());
+    *blockRows = rows;
+    blockRows->setValidRange(0, begin, false);
+    blockRows->setValidRange(end, rows.end(), false);
+    blockRows->updateBounds();
+    if (!blockRows->hasSelections()) {
+      continue;
+    }
+    exprs_->eval(
+        hasFilter_ ? 1 : 0,
+        numExprs_,
+        initialize,
+        *blockRows,
+        evalCtx,
+        results_);
+    // Shared subexpressions keep the results of the earlier blocks.
+    initialize = false;
+  }
+}
+
 vector_size_t FilterProject::filter(
     EvalCtx& evalCtx,
     const SelectivityVector& allRows) {
@@ -73,23 +73,45 @@ class FilterProject : public Operator {
   // pre-condition: !isIdentityProjection_
   void project(const SelectivityVector& rows, EvalCtx& evalCtx);
 
+  // Evaluates all projections for one block of 'projectionBlockSize_' rows
+  // at a time. Used for 'blockEvaluable_' projections.
+  void projectInBlocks(const SelectivityVector& rows, EvalCtx& evalCtx);
+
   // If true exprs_[0] is a filter and the other expressions are projections
   const bool hasFilter_{false};
   std::unique_ptr<ExprSet> exprs_;
   int32_t numExprs_;
 
+  // Number of rows of a block for projectInBlocks(). 0 if disabled.
+  const vector_size_t projectionBlockSize_;
+
+  // Min fraction of the string buffers of a column that the filtered rows
+  // must reference for the output to keep the buffers. 0 if disabled.
+  const double stringCompactionMinUsedRatio_;
+
+  // True if all projections are trees of deterministic functions with fixed
+  // width results, which support the fast path for flat inputs without
+  // nulls, over fields and constants.
+  bool blockEvaluable_{false};
+
   FilterEvalCtx filterEvalCtx_;
 
   vector_size_t numProcessedInputRows_{0};
 
   // Indices for fields/input columns that are both an identity projection and
-  // are referenced by either a filter or project expression. This is used to
-  // identify fields that need to be preloaded before evaluating filters or
-  // projections.
+  // are referenced by the filter, or by a project expression if there is no
+  // filter. This is used to identify fields that need to be preloaded before
+  // evaluating filters or projections.
   // Consider projection with 2 expressions: f(c0) AND g(c1), c1
   // If c1 is a LazyVector and f(c0) AND g(c1) expression is evaluated first, it
   // will load c1 only for rows where f(c0) is true. However, c1 identity
   // projection needs all rows.
   std::vector<column_index_t> multiplyReferencedFieldIndices_;
+
+  // The fields that are referenced by both the projections and identity
+  // projections but not by the filter. These are pre-loaded only for the rows
+  // that pass the filter, so that a LazyVector from a selective scan is
+  // decoded only for these.
+  std::vector<column_index_t> multiplyReferencedProjectionFieldIndices_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/FragmentResultCache.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+std::shared_ptr<FragmentResultCache>& instance() {
+  static std::shared_ptr<FragmentResultCache> cache;
+  return cache;
+}
+
+std::mutex& instanceMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::string newPoolName() {
+  static std::atomic<int64_t> id{0};
+  return fmt::format("FragmentResultCache_{}", id++);
+}
+} // namespace
+
+FragmentResultCache::FragmentResultCache(
+    uint64_t maxBytes,
+    uint64_t maxEntryBytes)
+    : maxEntryBytes_(maxEntryBytes),
+      pool_(memory::addDefaultLeafMemoryPool(newPoolName(), true)),
+      cache_(maxBytes) {}
+
+// static
+std::shared_ptr<FragmentResultCache> FragmentResultCache::getInstance() {
+  std::lock_guard<std::mutex> l(instanceMutex());
+  return instance();
+}
+
+// static
+void FragmentResultCache::setInstance(
+    std::shared_ptr<FragmentResultCache> cache) {
+  std::lock_guard<std::mutex> l(instanceMutex());
+  instance() = std::move(cache);
+}
+
+std::optional<FragmentResultCache::Pages> FragmentResultCache::get(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* entry = cache_.get(key);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+  // The pages are shared, so that they stay valid for the caller if the entry
+  // gets evicted.
+  auto pages = entry->pages;
+  cache_.release(key);
+  return pages;
+}
+
+void FragmentResultCache::put(const std::string& key, Pages pages) {
+  uint64_t size = 0;
+  for (const auto& page : pages) {
+    size += page->computeChainDataLength();
+  }
+  if (size > maxEntryBytes_) {
+    return;
+  }
+  // Counts the key, so that empty results take space in the cache too.
+  size += key.size();
+  auto entry = std::make_unique<Entry>();
+  entry->pages = std::move(pages);
+  std::lock_guard<std::mutex> l(mutex_);
+  // The cache takes ownership of 'entry' if it is added.
+  if (cache_.add(key, entry.get(), size)) {
+    entry.release();
+  }
+}
+
+void FragmentResultCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  cache_.free(cache_.maxSize());
+}
+
+SimpleLRUCacheStats FragmentResultCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return cache_.getStats();
+}
+
+} // namespace facebook::velox::exec
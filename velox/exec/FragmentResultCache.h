@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+#include <optional>
+
+#include <folly/io/IOBuf.h>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::exec {
+
+/// Process-wide cache of the serialized results of plan fragments over
+/// immutable inputs. TableScan stores the output of a split under a key that
+/// identifies the scan and the split, see Connector::resultCacheKey() and
+/// ConnectorSplit::resultCacheKey(), and returns the cached pages instead of
+/// reading the split again when the same scan runs over the same split. The
+/// pages are allocated from the memory pool of the cache and the oldest
+/// entries are evicted when the cache is full. Thread-safe.
+class FragmentResultCache {
+ public:
+  using Pages = std::vector<std::shared_ptr<folly::IOBuf>>;
+
+  /// @param maxBytes The max total size of the cached pages.
+  /// @param maxEntryBytes The max size of the pages of one entry. Larger
+  /// results are not cached.
+  FragmentResultCache(uint64_t maxBytes, uint64_t maxEntryBytes);
+
+  /// Returns the process-wide cache or nullptr if none has been set.
+  static std::shared_ptr<FragmentResultCache> getInstance();
+
+  /// Sets the process-wide cache. Clears it if 'cache' is nullptr.
+  static void setInstance(std::shared_ptr<FragmentResultCache> cache);
+
+  /// The pool to allocate the cached pages from.
+  memory::MemoryPool* pool() const {
+    return pool_.get();
+  }
+
+  uint64_t maxEntryBytes() const {
+    return maxEntryBytes_;
+  }
+
+  /// Returns the pages stored for 'key' or std::nullopt if there are none.
+  std::optional<Pages> get(const std::string& key);
+
+  /// Stores 'pages' under 'key', evicting the oldest entries to make room.
+  /// Does nothing if 'key' is already cached or the pages do not fit.
+  void put(const std::string& key, Pages pages);
+
+  /// Removes all entries.
+  void clear();
+
+  SimpleLRUCacheStats stats() const;
+
+ private:
+  struct Entry {
+    Pages pages;
+  };
+
+  const uint64_t maxEntryBytes_;
+  const std::shared_ptr<memory::MemoryPool> pool_;
+
+  mutable std::mutex mutex_;
+  SimpleLRUCache<std::string, Entry> cache_;
+};
+
+} // namespace facebook::velox::exec
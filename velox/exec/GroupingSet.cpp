@@ -64,13 +64,21 @@ GroupingSet::GroupingSet(
       spillMemoryThreshold_(operatorCtx->driverCtx()
                                 ->queryConfig()
                                 .aggregationSpillMemoryThreshold()),
+      compactionFreeRatio_(operatorCtx->driverCtx()
+                               ->queryConfig()
+                               .aggregationCompactionFreeRatio()),
       spillConfig_(spillConfig),
+      isDistinctWithSpill_(
+          aggregates_.empty() && !isPartial_ && spillConfig_ != nullptr),
       stringAllocator_(operatorCtx->pool()),
       rows_(operatorCtx->pool()),
       isAdaptive_(operatorCtx->task()
                       ->queryCtx()
                       ->queryConfig()
                       .hashAdaptivityEnabled()),
+      incrementalRehash_(operatorCtx->driverCtx()
+                             ->queryConfig()
+                             .hashAggregationIncrementalRehashEnabled()),
       pool_(*operatorCtx->pool()) {
   for (auto& hasher : hashers_) {
     keyChannels_.push_back(hasher->channel());
@@ -204,6 +212,9 @@ void GroupingSet::addInputForActiveRows(
   }
 
   table_->groupProbe(*lookup_);
+  if (isDistinctWithSpill_ && !lookup_->newGroups.empty()) {
+    setDistinctOutputFlags();
+  }
   masks_.addInput(input, activeRows_);
 
   for (auto i = 0; i < aggregates_.size(); ++i) {
@@ -233,6 +244,10 @@ void GroupingSet::addInputForActiveRows(
     }
   }
   tempVectors_.clear();
+
+  if (compactionFreeRatio_ > 0) {
+    table_->rows()->compactStringAllocator(compactionFreeRatio_);
+  }
 }
 
 void GroupingSet::addRemainingInput() {
@@ -245,14 +260,37 @@ void GroupingSet::addRemainingInput() {
   remainingInput_.reset();
 }
 
+void GroupingSet::setDistinctOutputFlags() {
+  // The operator returns the new groups unless spilling has started.
+  auto flag =
+      BaseVector::createConstant(BOOLEAN(), spiller_ == nullptr, 1, &pool_);
+  DecodedVector decoded(*flag, SelectivityVector(1));
+  auto rows = table_->rows();
+  const auto column = keyChannels_.size();
+  for (auto newGroup : lookup_->newGroups) {
+    rows->store(decoded, 0, lookup_->hits[newGroup], column);
+  }
+}
+
+bool GroupingSet::isOutputDistinct(const char* group) const {
+  RowContainer& rows = table_ ? *table_->rows() : *rowsWhileReadingSpill_;
+  return *reinterpret_cast<const bool*>(
+      group + rows.columnAt(keyChannels_.size()).offset());
+}
+
 void GroupingSet::createHashTable() {
+  std::vector<TypePtr> dependentTypes;
+  if (isDistinctWithSpill_) {
+    dependentTypes.push_back(BOOLEAN());
+  }
   if (ignoreNullKeys_) {
     table_ = HashTable<true>::createForAggregation(
-        std::move(hashers_), aggregates_, &pool_);
+        std::move(hashers_), aggregates_, &pool_, dependentTypes);
   } else {
     table_ = HashTable<false>::createForAggregation(
-        std::move(hashers_), aggregates_, &pool_);
+        std::move(hashers_), aggregates_, &pool_, dependentTypes);
   }
+  table_->setIncrementalRehash(incrementalRehash_);
   lookup_ = std::make_unique<HashLookup>(table_->hashers());
   if (!isAdaptive_ && table_->hashMode() != BaseHashTable::HashMode::kHash) {
     table_->forceGenericHashMode();
@@ -491,6 +529,95 @@ const HashLookup& GroupingSet::hashLookup() const {
   return *lookup_;
 }
 
+void GroupingSet::preGroupAllKeys() {
+  VELOX_CHECK(isPartial_);
+  VELOX_CHECK(preGroupedKeyChannels_.empty());
+  VELOX_CHECK_NULL(remainingInput_);
+  preGroupedKeyChannels_ = keyChannels_;
+}
+
+void GroupingSet::toIntermediate(
+    const RowVectorPtr& input,
+    RowVectorPtr& result) {
+  VELOX_CHECK(isPartial_ && isRawInput_ && !isGlobal_);
+  VELOX_CHECK_NOT_NULL(table_);
+  VELOX_CHECK_EQ(table_->rows()->numRows(), 0);
+  const auto numRows = input->size();
+  activeRows_.resize(numRows);
+  activeRows_.setAll();
+  if (ignoreNullKeys_) {
+    auto& hashers = table_->hashers();
+    for (auto i = 0; i < hashers.size(); ++i) {
+      auto key = input->childAt(hashers[i]->channel())->loadedVector();
+      hashers[i]->decode(*key, activeRows_);
+    }
+    deselectRowsWithNulls(hashers, activeRows_);
+  }
+  masks_.addInput(input, activeRows_);
+
+  const auto numKeys = keyChannels_.size();
+  for (auto i = 0; i < numKeys; ++i) {
+    result->childAt(i) =
+        BaseVector::loadedVectorShared(input->childAt(keyChannels_[i]));
+  }
+
+  if (!aggregates_.empty()) {
+    if (!intermediateRows_) {
+      intermediateRows_ = std::make_unique<RowContainer>(
+          table_->rows()->keyTypes(),
+          !ignoreNullKeys_,
+          aggregates_,
+          std::vector<TypePtr>{},
+          false, // hasNext
+          false, // isJoinBuild
+          false, // hasProbedFlag
+          false, // hasNormalizedKey
+          &pool_,
+          ContainerRowSerde::instance());
+    }
+    intermediateGroups_.resize(numRows);
+    for (auto i = 0; i < numRows; ++i) {
+      intermediateGroups_[i] = intermediateRows_->newRow();
+    }
+    intermediateRowNumbers_.resize(numRows);
+    std::iota(
+        intermediateRowNumbers_.begin(), intermediateRowNumbers_.end(), 0);
+
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      aggregates_[i]->initializeNewGroups(
+          intermediateGroups_.data(), intermediateRowNumbers_);
+      const auto& rows = getSelectivityVector(i);
+      if (rows.hasSelections()) {
+        populateTempVectors(i, input);
+        aggregates_[i]->addRawInput(
+            intermediateGroups_.data(), rows, tempVectors_, false);
+      }
+      aggregates_[i]->extractAccumulators(
+          intermediateGroups_.data(),
+          numRows,
+          &result->childAt(numKeys + i));
+    }
+    tempVectors_.clear();
+    intermediateRows_->clear();
+  }
+
+  if (!activeRows_.isAllSelected()) {
+    const auto numActive = activeRows_.countSelected();
+    auto indices = allocateIndices(numActive, &pool_);
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    vector_size_t numIndices = 0;
+    activeRows_.applyToSelected(
+        [&](auto row) { rawIndices[numIndices++] = row; });
+    std::vector<VectorPtr> children;
+    for (auto& child : result->children()) {
+      children.push_back(
+          BaseVector::wrapInDictionary(nullptr, indices, numActive, child));
+    }
+    result = std::make_shared<RowVector>(
+        &pool_, result->type(), nullptr, numActive, std::move(children));
+  }
+}
+
 void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
   // Spilling is considered if this is a final or single aggregation and
   // spillPath is set.
@@ -576,7 +703,8 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
 void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
   if (!spiller_) {
     auto rows = table_->rows();
-    auto types = rows->keyTypes();
+    // The keys are followed by the output flag of a distinct aggregation.
+    auto types = rows->columnTypes();
     types.insert(
         types.end(), intermediateTypes_.begin(), intermediateTypes_.end());
     std::vector<std::string> names;
@@ -598,7 +726,11 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->maxFileSize,
         spillConfig_->minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->compressionKind,
+        spillConfig_->maxSpillWriteParallelism,
+        spillConfig_->directIo,
+        spillConfig_->tiers);
   }
   spiller_->spill(targetRows, targetBytes);
 }
@@ -629,6 +761,15 @@ bool GroupingSet::getOutputWithSpill(
     table_.reset();
     outputPartition_ = 0;
     nonSpilledRows_ = spiller_->finishSpill();
+    if (isDistinctWithSpill_) {
+      auto& rows = nonSpilledRows_.value();
+      rows.erase(
+          std::remove_if(
+              rows.begin(),
+              rows.end(),
+              [&](const char* row) { return isOutputDistinct(row); }),
+          rows.end());
+    }
   }
 
   if (nonSpilledIndex_ < nonSpilledRows_.value().size()) {
@@ -670,6 +811,10 @@ bool GroupingSet::mergeNext(int32_t batchSize, const RowVectorPtr& result) {
     updateRow(*next.first, mergeState_);
     nextKeyIsEqual_ = next.second;
     next.first->pop();
+    if (!nextKeyIsEqual_ && mergedDistinctIsOutput_) {
+      // The key was returned before spilling started.
+      mergeRows_->eraseRows(folly::Range<char**>(&mergeState_, 1));
+    }
     if (!nextKeyIsEqual_ && mergeRows_->numRows() >= batchSize) {
       extractSpillResult(result);
       return true;
@@ -683,6 +828,7 @@ void GroupingSet::initializeRow(
   for (auto i = 0; i < keyChannels_.size(); ++i) {
     mergeRows_->store(keys.decoded(i), keys.currentIndex(), mergeState_, i);
   }
+  mergedDistinctIsOutput_ = false;
   vector_size_t zero = 0;
   for (auto& aggregate : aggregates_) {
     aggregate->initializeNewGroups(
@@ -706,6 +852,11 @@ void GroupingSet::updateRow(SpillMergeStream& input, char* FOLLY_NONNULL row) {
     mergeSelection_.resize(bits::roundUp(input.currentIndex() + 1, 64));
     mergeSelection_.clearAll();
   }
+  if (isDistinctWithSpill_) {
+    mergedDistinctIsOutput_ |= input.decoded(keyChannels_.size())
+                                   .valueAt<bool>(input.currentIndex());
+    return;
+  }
   mergeSelection_.setValid(input.currentIndex(), true);
   mergeSelection_.updateBounds();
   for (auto i = 0; i < aggregates_.size(); ++i) {
@@ -76,6 +76,22 @@ class GroupingSet {
 
   const HashLookup& hashLookup() const;
 
+  /// Treats all the grouping keys as pre-grouped from the next input on. The
+  /// groups are then produced as soon as a batch of input starts a new group
+  /// after them. Used by a partial aggregation that has found its input to be
+  /// clustered on the grouping keys. This is correct for any input since a
+  /// partial aggregation may produce a group more than once.
+  void preGroupAllKeys();
+
+  /// Makes a group of each row of 'input' and sets 'result' to the keys and
+  /// the intermediate results of the aggregates over the single row. Rows
+  /// with a null key are dropped if null keys are ignored. Used by a partial
+  /// aggregation that has stopped using the hash table because it does not
+  /// reduce the number of rows. Must not be called before the groups in the
+  /// hash table have been returned and cleared. 'result' must be of the
+  /// output type and have the size of 'input'.
+  void toIntermediate(const RowVectorPtr& input, RowVectorPtr& result);
+
   /// Spills content until under 'targetRows' and under 'targetBytes'
   /// of out of line data are left. If targetRows is 0, spills
   /// everything and physically frees the data in the
@@ -85,6 +101,11 @@ class GroupingSet {
   /// of this will be in a paused state and off thread.
   void spill(int64_t targetRows, int64_t targetBytes);
 
+  /// Returns true if any content has been spilled.
+  bool hasSpilled() const {
+    return spiller_ != nullptr;
+  }
+
   /// Returns the spiller stats including total bytes and rows spilled so far.
   Spiller::Stats spilledStats() const {
     return spiller_ != nullptr ? spiller_->stats() : Spiller::Stats{};
@@ -95,6 +116,12 @@ class GroupingSet {
     return table_ ? table_->stats() : HashTableStats{};
   }
 
+  /// Returns BaseHashTable::hashModeName() of the table or an empty string if
+  /// there is no table.
+  std::string hashModeName() const {
+    return table_ ? table_->hashModeName() : "";
+  }
+
   /// Return the number of rows kept in memory.
   int64_t numRows() const {
     return table_ ? table_->rows()->numRows() : 0;
@@ -171,6 +198,14 @@ class GroupingSet {
   // 'keys'. This is called for each row received from a merge of spilled data.
   void updateRow(SpillMergeStream& keys, char* FOLLY_NONNULL row);
 
+  // Sets the output flag of the new groups in 'lookup_'. See
+  // 'isDistinctWithSpill_'.
+  void setDistinctOutputFlags();
+
+  // Returns true if distinct 'group' was returned by the operator before
+  // spilling started.
+  bool isOutputDistinct(const char* FOLLY_NONNULL group) const;
+
   // Copies the finalized state from 'mergeRows' to 'result' and clears
   // 'mergeRows'. Used for producing a batch of results when aggregating spilled
   // groups.
@@ -179,7 +214,7 @@ class GroupingSet {
   std::vector<column_index_t> keyChannels_;
 
   /// A subset of grouping keys on which the input is clustered.
-  const std::vector<column_index_t> preGroupedKeyChannels_;
+  std::vector<column_index_t> preGroupedKeyChannels_;
 
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
   const bool isGlobal_;
@@ -203,8 +238,20 @@ class GroupingSet {
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
 
+  // The fraction of free variable width memory in the hash table that
+  // triggers a compaction of it. See
+  // QueryConfig::kAggregationCompactionFreeRatio. 0 disables the compaction.
+  const double compactionFreeRatio_;
+
   const Spiller::Config* FOLLY_NULLABLE const spillConfig_; // Not owned.
 
+  // True for a distinct aggregation that may spill. The operator returns the
+  // new keys of each input batch until spilling starts and all the keys that
+  // it has not returned after the end of input. A BOOLEAN dependent column in
+  // 'table_' after the keys records whether each key has already been
+  // returned. The column is spilled and merged with the keys.
+  const bool isDistinctWithSpill_;
+
   // Boolean indicating whether accumulators for a global aggregation (i.e.
   // aggregation with no grouping keys) have been initialized.
   bool globalAggregationInitialized_{false};
@@ -222,6 +269,7 @@ class GroupingSet {
   HashStringAllocator stringAllocator_;
   AllocationPool rows_;
   const bool isAdaptive_;
+  const bool incrementalRehash_;
 
   bool noMoreInput_{false};
 
@@ -237,6 +285,13 @@ class GroupingSet {
   // 'remainingInput_'.
   bool remainingMayPushdown_;
 
+  // Rows for the single row groups of toIntermediate(). These have the
+  // layout of the rows of 'table_', so that the offsets of the accumulators
+  // in both are the same.
+  std::unique_ptr<RowContainer> intermediateRows_;
+  std::vector<char*> intermediateGroups_;
+  std::vector<vector_size_t> intermediateRowNumbers_;
+
   std::unique_ptr<Spiller> spiller_;
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> merge_;
 
@@ -256,6 +311,10 @@ class GroupingSet {
   // to merge.
   SelectivityVector mergeSelection_;
 
+  // True if the key being merged from spilled data has already been returned
+  // by a distinct aggregation.
+  bool mergedDistinctIsOutput_{false};
+
   // True if 'merge_' indicates that the next key is the same as the current
   // one.
   bool nextKeyIsEqual_{false};
@@ -16,6 +16,7 @@
 #include "velox/exec/HashAggregation.h"
 #include <optional>
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/BufferedInputAggregate.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
@@ -24,7 +25,8 @@ namespace facebook::velox::exec {
 HashAggregation::HashAggregation(
     int32_t operatorId,
     DriverCtx* driverCtx,
-    const std::shared_ptr<const core::AggregationNode>& aggregationNode)
+    const std::shared_ptr<const core::AggregationNode>& aggregationNode,
+    const std::shared_ptr<const core::GroupIdNode>& groupIdNode)
     : Operator(
           driverCtx,
           aggregationNode->outputType(),
@@ -39,6 +41,14 @@ HashAggregation::HashAggregation(
           core::AggregationNode::Step::kIntermediate),
       isDistinct_(aggregationNode->aggregates().empty()),
       isGlobal_(aggregationNode->groupingKeys().empty()),
+      canAbandonPartialAggregation_(
+          aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+          !isGlobal_ && aggregationNode->preGroupedKeys().empty() &&
+          groupIdNode == nullptr),
+      abandonPartialAggregationMinRows_(
+          driverCtx->queryConfig().abandonPartialAggregationMinRows()),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
       memoryTracker_(operatorCtx_->pool()->getMemoryUsageTracker()),
       maxExtendedPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxExtendedPartialAggregationMemoryUsage()),
@@ -47,8 +57,15 @@ HashAggregation::HashAggregation(
               ? operatorCtx_->makeSpillConfig(Spiller::Type::kAggregate)
               : std::nullopt),
       maxPartialAggregationMemoryUsage_(
-          driverCtx->queryConfig().maxPartialAggregationMemoryUsage()) {
+          driverCtx->queryConfig().maxPartialAggregationMemoryUsage()),
+      checkClusteredInput_(canAbandonPartialAggregation_ && !isDistinct_) {
   VELOX_CHECK_NOT_NULL(memoryTracker_, "Memory usage tracker is not set");
+  if (groupIdNode != nullptr) {
+    VELOX_CHECK(canRollUp(
+        *groupIdNode, *aggregationNode, driverCtx->queryConfig()));
+    setupRollUp(*aggregationNode, *groupIdNode);
+    return;
+  }
   auto inputType = aggregationNode->sources()[0]->outputType();
 
   auto numHashers = aggregationNode->groupingKeys().size();
@@ -123,6 +140,32 @@ HashAggregation::HashAggregation(
     const auto& resultType = outputType_->childAt(numHashers + i);
     aggregates.push_back(Aggregate::create(
         aggregate->name(), aggregationNode->step(), argTypes, resultType));
+    if (aggregationNode->hasSortedOrDistinctInput(i)) {
+      // The sorting keys follow the arguments in the input of the buffering
+      // aggregate.
+      auto argConstants = constants;
+      std::vector<TypePtr> sortingKeyTypes;
+      std::vector<core::SortOrder> sortingOrders;
+      if (i < aggregationNode->aggregateSortingKeys().size()) {
+        const auto& keys = aggregationNode->aggregateSortingKeys()[i];
+        for (const auto& key : keys) {
+          sortingKeyTypes.push_back(key->type());
+          channels.push_back(exprToChannel(key.get(), inputType));
+          constants.push_back(nullptr);
+        }
+        sortingOrders = aggregationNode->aggregateSortingOrders()[i];
+      }
+      const bool distinct = i < aggregationNode->aggregateDistincts().size() &&
+          aggregationNode->aggregateDistincts()[i];
+      aggregates.back() = std::make_unique<BufferedInputAggregate>(
+          std::move(aggregates.back()),
+          argTypes,
+          std::move(argConstants),
+          sortingKeyTypes,
+          std::move(sortingOrders),
+          distinct,
+          pool());
+    }
     args.push_back(channels);
     constantLists.push_back(constants);
   }
@@ -160,23 +203,331 @@ HashAggregation::HashAggregation(
       operatorCtx_.get());
 }
 
+// static
+bool HashAggregation::canRollUp(
+    const core::GroupIdNode& groupIdNode,
+    const core::AggregationNode& aggregationNode,
+    const core::QueryConfig& queryConfig) {
+  const auto step = aggregationNode.step();
+  if ((step != core::AggregationNode::Step::kPartial &&
+       step != core::AggregationNode::Step::kSingle) ||
+      aggregationNode.aggregates().empty() ||
+      !aggregationNode.preGroupedKeys().empty() ||
+      aggregationNode.hasSortedOrDistinctInputs() ||
+      aggregationNode.ignoreNullKeys() ||
+      aggregationNode.canSpill(queryConfig) ||
+      groupIdNode.numGroupingKeys() == 0) {
+    return false;
+  }
+  for (const auto& mask : aggregationNode.aggregateMasks()) {
+    if (mask != nullptr) {
+      return false;
+    }
+  }
+  const auto& groupIdType = groupIdNode.outputType();
+  const auto numGroupingKeys = groupIdNode.numGroupingKeys();
+  for (const auto& key : aggregationNode.groupingKeys()) {
+    if (key->name() != groupIdNode.groupIdName() &&
+        groupIdType->getChildIdx(key->name()) >= numGroupingKeys) {
+      return false;
+    }
+  }
+  // The aggregates must not read the grouping keys, which are null in the
+  // grouping sets that do not have them.
+  for (const auto& aggregate : aggregationNode.aggregates()) {
+    for (const auto& arg : aggregate->inputs()) {
+      if (dynamic_cast<const core::ConstantTypedExpr*>(arg.get())) {
+        continue;
+      }
+      auto field = dynamic_cast<const core::FieldAccessTypedExpr*>(arg.get());
+      if (field == nullptr || !field->isInputColumn()) {
+        return false;
+      }
+      const auto channel = groupIdType->getChildIdx(field->name());
+      if (channel < numGroupingKeys || channel >= groupIdType->size() - 1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void HashAggregation::setupRollUp(
+    const core::AggregationNode& aggregationNode,
+    const core::GroupIdNode& groupIdNode) {
+  const auto& inputType = groupIdNode.sources()[0]->outputType();
+  const auto& groupIdType = groupIdNode.outputType();
+  const auto numGroupingKeys = groupIdNode.numGroupingKeys();
+
+  // The finest grouping is on the distinct inputs of the grouping keys.
+  std::vector<std::unique_ptr<VectorHasher>> finestHashers;
+  std::vector<std::string> finestNames;
+  std::vector<TypePtr> finestTypes;
+  std::unordered_map<std::string, column_index_t> inputToFinestKey;
+  std::unordered_map<std::string, column_index_t> inputToOutputKey;
+  for (const auto& info : groupIdNode.groupingKeyInfos()) {
+    const auto& name = info.input->name();
+    inputToOutputKey[name] = groupIdType->getChildIdx(info.output);
+    if (inputToFinestKey.count(name) == 0) {
+      inputToFinestKey[name] = finestHashers.size();
+      finestHashers.push_back(VectorHasher::create(
+          info.input->type(), inputType->getChildIdx(name)));
+      finestNames.push_back(name);
+      finestTypes.push_back(info.input->type());
+    }
+  }
+  for (const auto& groupingSet : groupIdNode.groupingSets()) {
+    std::vector<column_index_t> mappings(numGroupingKeys, kMissingGroupingKey);
+    for (const auto& key : groupingSet) {
+      mappings[inputToOutputKey.at(key->name())] =
+          inputToFinestKey.at(key->name());
+    }
+    rollUpKeyMappings_.push_back(std::move(mappings));
+  }
+
+  // The finest grouping produces intermediate results from the raw input.
+  // 'groupingSet_' merges them in the step after that of 'aggregationNode'.
+  const auto mergeStep = isPartialOutput_
+      ? core::AggregationNode::Step::kIntermediate
+      : core::AggregationNode::Step::kFinal;
+  const auto numAggregates = aggregationNode.aggregates().size();
+  const auto numHashers = aggregationNode.groupingKeys().size();
+  std::vector<std::unique_ptr<Aggregate>> finestAggregates;
+  std::vector<std::unique_ptr<Aggregate>> mergeAggregates;
+  std::vector<std::vector<column_index_t>> finestArgs;
+  std::vector<std::vector<column_index_t>> mergeArgs;
+  std::vector<std::vector<VectorPtr>> finestConstants;
+  std::vector<std::vector<VectorPtr>> mergeConstants;
+  std::vector<TypePtr> intermediateTypes;
+  std::vector<std::string> rollUpNames(
+      groupIdType->names().begin(),
+      groupIdType->names().begin() + numGroupingKeys);
+  std::vector<TypePtr> rollUpTypes(
+      groupIdType->children().begin(),
+      groupIdType->children().begin() + numGroupingKeys);
+  for (auto i = 0; i < numAggregates; ++i) {
+    const auto& aggregate = aggregationNode.aggregates()[i];
+    std::vector<column_index_t> channels;
+    std::vector<VectorPtr> constants;
+    std::vector<TypePtr> argTypes;
+    for (const auto& arg : aggregate->inputs()) {
+      argTypes.push_back(arg->type());
+      channels.push_back(exprToChannel(arg.get(), inputType));
+      if (channels.back() == kConstantChannel) {
+        auto constant = dynamic_cast<const core::ConstantTypedExpr*>(arg.get());
+        constants.push_back(constant->toConstantVector(pool()));
+      } else {
+        constants.push_back(nullptr);
+      }
+    }
+    const auto intermediateType =
+        Aggregate::intermediateType(aggregate->name(), argTypes);
+    intermediateTypes.push_back(intermediateType);
+    finestAggregates.push_back(Aggregate::create(
+        aggregate->name(),
+        core::AggregationNode::Step::kPartial,
+        argTypes,
+        intermediateType));
+    mergeAggregates.push_back(Aggregate::create(
+        aggregate->name(),
+        mergeStep,
+        {intermediateType},
+        outputType_->childAt(numHashers + i)));
+    finestArgs.push_back(std::move(channels));
+    finestConstants.push_back(std::move(constants));
+    mergeArgs.push_back({static_cast<column_index_t>(numGroupingKeys + i)});
+    mergeConstants.push_back({nullptr});
+    finestNames.push_back(aggregationNode.aggregateNames()[i]);
+    finestTypes.push_back(intermediateType);
+    rollUpNames.push_back(aggregationNode.aggregateNames()[i]);
+    rollUpTypes.push_back(intermediateType);
+  }
+  rollUpNames.push_back(groupIdNode.groupIdName());
+  rollUpTypes.push_back(BIGINT());
+  finestType_ = ROW(std::move(finestNames), std::move(finestTypes));
+  rollUpInputType_ = ROW(std::move(rollUpNames), std::move(rollUpTypes));
+
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  for (const auto& key : aggregationNode.groupingKeys()) {
+    const auto channel = key->name() == groupIdNode.groupIdName()
+        ? rollUpInputType_->size() - 1
+        : groupIdType->getChildIdx(key->name());
+    hashers.push_back(VectorHasher::create(key->type(), channel));
+  }
+
+  finestSet_ = std::make_unique<GroupingSet>(
+      std::move(finestHashers),
+      std::vector<column_index_t>{},
+      std::move(finestAggregates),
+      std::vector<std::optional<column_index_t>>(numAggregates),
+      std::move(finestArgs),
+      std::move(finestConstants),
+      std::vector<TypePtr>(intermediateTypes),
+      false,
+      true,
+      true,
+      nullptr,
+      operatorCtx_.get());
+  groupingSet_ = std::make_unique<GroupingSet>(
+      std::move(hashers),
+      std::vector<column_index_t>{},
+      std::move(mergeAggregates),
+      std::vector<std::optional<column_index_t>>(numAggregates),
+      std::move(mergeArgs),
+      std::move(mergeConstants),
+      std::move(intermediateTypes),
+      false,
+      isPartialOutput_,
+      false,
+      nullptr,
+      operatorCtx_.get());
+}
+
+void HashAggregation::addRollUpInput(const RowVectorPtr& input) {
+  finestSet_->addInput(input, false);
+  numInputRows_ += input->size();
+  numInputVectors_ += 1;
+  // A partial aggregation rolls up and flushes the groups when 'finestSet_'
+  // is over the memory limit.
+  if (isPartialOutput_ && !isGlobal_ &&
+      finestSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_) {
+    rollUp();
+    partialFull_ = true;
+  }
+}
+
+void HashAggregation::rollUp() {
+  const auto numGroupingKeys = rollUpKeyMappings_.front().size();
+  const auto numAggregates = rollUpInputType_->size() - numGroupingKeys - 1;
+  const auto numFinestKeys = finestType_->size() - numAggregates;
+  const auto batchSize = outputBatchRows(finestSet_->estimateRowSize());
+  RowContainerIterator iterator;
+  int64_t numFinestGroups = 0;
+  for (;;) {
+    auto finest = std::static_pointer_cast<RowVector>(
+        BaseVector::create(finestType_, batchSize, pool()));
+    if (!finestSet_->getOutput(batchSize, iterator, finest)) {
+      break;
+    }
+    const auto numRows = finest->size();
+    numFinestGroups += numRows;
+    // The groups of each grouping set are the finest groups with the keys
+    // not in the set replaced by nulls, as made by GroupId for the input.
+    for (auto i = 0; i < rollUpKeyMappings_.size(); ++i) {
+      const auto& mappings = rollUpKeyMappings_[i];
+      std::vector<VectorPtr> columns;
+      columns.reserve(rollUpInputType_->size());
+      for (auto j = 0; j < mappings.size(); ++j) {
+        if (mappings[j] == kMissingGroupingKey) {
+          columns.push_back(BaseVector::createNullConstant(
+              rollUpInputType_->childAt(j), numRows, pool()));
+        } else {
+          columns.push_back(finest->childAt(mappings[j]));
+        }
+      }
+      for (auto j = 0; j < numAggregates; ++j) {
+        columns.push_back(finest->childAt(numFinestKeys + j));
+      }
+      columns.push_back(std::make_shared<ConstantVector<int64_t>>(
+          pool(), numRows, false, BIGINT(), i));
+      groupingSet_->addInput(
+          std::make_shared<RowVector>(
+              pool(), rollUpInputType_, nullptr, numRows, std::move(columns)),
+          false);
+    }
+  }
+  finestSet_->resetPartial();
+  addRuntimeStat("rollUpFinestGroups", RuntimeCounter(numFinestGroups));
+}
+
+void HashAggregation::updateSpillStats() {
+  const auto spillStats = groupingSet_->spilledStats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  lockedStats->spillWriteTiming = spillStats.spillWriteTiming;
+}
+
+bool HashAggregation::canReclaim() const {
+  if (isPartialOutput_) {
+    return canFlushPartialOutput();
+  }
+  // NOTE: we can't spill after all the input has been received as the output
+  // processing might have started.
+  return spillConfig_.has_value() && !noMoreInput_ &&
+      groupingSet_ != nullptr && groupingSet_->numRows() > 0;
+}
+
+bool HashAggregation::canFlushPartialOutput() const {
+  // NOTE: we don't flush on the global aggregation and intermediate
+  // aggregation in the same way as the partial output flush on memory limit.
+  // We can't flush if there is pending output which depends on the hash table
+  // state.
+  return isPartialOutput_ && !isGlobal_ && !isIntermediate_ &&
+      finestSet_ == nullptr && !noMoreInput_ && !partialFull_ &&
+      !newDistincts_ &&
+      groupingSet_ != nullptr && !groupingSet_->hasOutput() &&
+      groupingSet_->numRows() > 0;
+}
+
+void HashAggregation::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+  if (isPartialOutput_) {
+    flushPartialOutput();
+    return;
+  }
+  groupingSet_->spill(0, 0);
+  updateSpillStats();
+}
+
+void HashAggregation::flushPartialOutput() {
+  VELOX_CHECK(flushedOutputs_.empty());
+  // NOTE: if the flush fails in the middle, the output processing resumes from
+  // 'resultIterator_' in getOutput() as 'partialFull_' is set.
+  partialFull_ = true;
+  // The distinct aggregation has already returned all the new groups as
+  // output, hence there is nothing to flush.
+  if (!isDistinct_) {
+    for (;;) {
+      const auto batchSize = outputBatchRows(groupingSet_->estimateRowSize());
+      auto output = std::static_pointer_cast<RowVector>(
+          BaseVector::create(outputType_, batchSize, pool()));
+      if (!groupingSet_->getOutput(batchSize, resultIterator_, output)) {
+        break;
+      }
+      numOutputRows_ += output->size();
+      flushedOutputs_.push_back(std::move(output));
+    }
+    resultIterator_.reset();
+  }
+  addRuntimeStat("reclaimFlushTimes", RuntimeCounter(1));
+  // NOTE: we don't try to increase the partial aggregation memory limit as it
+  // is under memory pressure.
+  resetPartialOutput();
+}
+
 void HashAggregation::addInput(RowVectorPtr input) {
+  if (finestSet_ != nullptr) {
+    addRollUpInput(input);
+    return;
+  }
   if (!pushdownChecked_) {
     mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
     pushdownChecked_ = true;
   }
+  if (abandonedPartialAggregation_) {
+    input_ = std::move(input);
+    return;
+  }
   groupingSet_->addInput(input, mayPushdown_);
   numInputRows_ += input->size();
   numInputVectors_ += 1;
+  updateSpillStats();
   {
-    const auto spillStats = groupingSet_->spilledStats();
     const auto hashTableStats = groupingSet_->hashTableStats();
     auto lockedStats = stats_.wlock();
-    lockedStats->spilledBytes = spillStats.spilledBytes;
-    lockedStats->spilledRows = spillStats.spilledRows;
-    lockedStats->spilledPartitions = spillStats.spilledPartitions;
-    lockedStats->spilledFiles = spillStats.spilledFiles;
-
     lockedStats->runtimeStats["hashtable.capacity"] =
         RuntimeMetric(hashTableStats.capacity);
     lockedStats->runtimeStats["hashtable.numRehashes"] =
@@ -185,14 +536,33 @@ void HashAggregation::addInput(RowVectorPtr input) {
         RuntimeMetric(hashTableStats.numDistinct);
     lockedStats->runtimeStats["hashtable.numTombstones"] =
         RuntimeMetric(hashTableStats.numTombstones);
+    lockedStats->runtimeStats["hashtable.peakTableBytes"] = RuntimeMetric(
+        hashTableStats.peakTableBytes, RuntimeCounter::Unit::kBytes);
+    // One entry for each mode the table has been in.
+    const auto modeName = groupingSet_->hashModeName();
+    if (!modeName.empty()) {
+      lockedStats->runtimeStats["hashtable.mode." + modeName] =
+          RuntimeMetric(1);
+    }
+  }
+
+  if (checkClusteredInput_) {
+    maybeStreamClusteredInput();
   }
 
   // NOTE: we should not trigger partial output flush in case of global
   // aggregation as the final aggregator will handle it the same way as the
   // partial aggregator. Hence, we have to use more memory anyway.
-  if (isPartialOutput_ && !isGlobal_ && !isIntermediate_) {
+  if (isPartialOutput_ && !isGlobal_ && !isIntermediate_ &&
+      !streamingClusteredInput_) {
     uint64_t kDefaultFlushMemory = 1L << 24;
-    if (groupingSet_->allocatedBytes() > kDefaultFlushMemory &&
+    if (shouldAbandonPartialAggregation()) {
+      // Flushes the groups so far. The following input bypasses the table.
+      abandonedPartialAggregation_ = true;
+      partialFull_ = true;
+      addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
+    } else if (
+        groupingSet_->allocatedBytes() > kDefaultFlushMemory &&
         numInputVectors_ % 15 == 0) {
       double ratio =
           (double)(groupingSet_->numDistincts()) / (double)numInputRows_;
@@ -207,7 +577,10 @@ void HashAggregation::addInput(RowVectorPtr input) {
   }
 
   if (isDistinct_) {
-    newDistincts_ = !groupingSet_->hashLookup().newGroups.empty();
+    // Once spilling has started, the new keys are returned after the end of
+    // input together with the spilled keys.
+    newDistincts_ = !groupingSet_->hasSpilled() &&
+        !groupingSet_->hashLookup().newGroups.empty();
 
     if (newDistincts_) {
       // Save input to use for output in getOutput().
@@ -216,6 +589,50 @@ void HashAggregation::addInput(RowVectorPtr input) {
   }
 }
 
+void HashAggregation::maybeStreamClusteredInput() {
+  // Number of input batches clustered on the grouping keys after which a
+  // partial aggregation streams the groups.
+  constexpr int32_t kMinClusteredInputs = 4;
+
+  const auto& lookup = groupingSet_->hashLookup();
+  size_t numGroupChanges = 0;
+  for (auto row : lookup.rows) {
+    const char* group = lookup.hits[row];
+    if (group != lastGroup_) {
+      ++numGroupChanges;
+      lastGroup_ = group;
+    }
+  }
+  // The input is clustered if each change of group starts a new group.
+  if (numGroupChanges != lookup.newGroups.size()) {
+    checkClusteredInput_ = false;
+    return;
+  }
+  if (++numClusteredInputs_ < kMinClusteredInputs) {
+    return;
+  }
+  checkClusteredInput_ = false;
+  streamingClusteredInput_ = true;
+  groupingSet_->preGroupAllKeys();
+  addRuntimeStat("streamingPartialAggregation", RuntimeCounter(1));
+}
+
+bool HashAggregation::shouldAbandonPartialAggregation() const {
+  return canAbandonPartialAggregation_ &&
+      numInputRows_ >= abandonPartialAggregationMinRows_ &&
+      100 * groupingSet_->numDistincts() >=
+      abandonPartialAggregationMinPct_ * numInputRows_;
+}
+
+RowVectorPtr HashAggregation::getAbandonedPartialOutput() {
+  const auto numRows = input_->size();
+  prepareOutput(numRows);
+  groupingSet_->toIntermediate(input_, output_);
+  input_ = nullptr;
+  addRuntimeStat("abandonedPartialAggregationRows", RuntimeCounter(numRows));
+  return output_;
+}
+
 void HashAggregation::prepareOutput(vector_size_t size) {
   if (output_) {
     VectorPtr output = std::move(output_);
@@ -231,6 +648,14 @@ void HashAggregation::resetPartialOutputIfNeed() {
   if (!partialFull_) {
     return;
   }
+  const double aggregationPct = resetPartialOutput();
+  if (!finished_) {
+    maybeIncreasePartialAggregationMemoryUsage(aggregationPct);
+  }
+}
+
+double HashAggregation::resetPartialOutput() {
+  VELOX_DCHECK(partialFull_);
   VELOX_DCHECK(!isGlobal_);
   const double aggregationPct =
       numOutputRows_ == 0 ? 0 : (numOutputRows_ * 1.0) / numInputRows_ * 100;
@@ -243,13 +668,12 @@ void HashAggregation::resetPartialOutputIfNeed() {
         "partialAggregationPct", RuntimeCounter(aggregationPct));
   }
   groupingSet_->resetPartial();
+  lastGroup_ = nullptr;
   partialFull_ = false;
   numOutputRows_ = 0;
   numInputRows_ = 0;
   numInputVectors_ = 0;
-  if (!finished_) {
-    maybeIncreasePartialAggregationMemoryUsage(aggregationPct);
-  }
+  return aggregationPct;
 }
 
 void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
@@ -283,11 +707,27 @@ void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
 }
 
 RowVectorPtr HashAggregation::getOutput() {
+  if (!flushedOutputs_.empty()) {
+    auto output = std::move(flushedOutputs_.front());
+    flushedOutputs_.pop_front();
+    return output;
+  }
+
   if (finished_) {
     input_ = nullptr;
     return nullptr;
   }
 
+  if (abandonedPartialAggregation_ && !partialFull_ && !newDistincts_) {
+    if (input_ != nullptr) {
+      return getAbandonedPartialOutput();
+    }
+    if (noMoreInput_) {
+      finished_ = true;
+    }
+    return nullptr;
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -299,7 +739,9 @@ RowVectorPtr HashAggregation::getOutput() {
     return nullptr;
   }
 
-  if (isDistinct_) {
+  // A distinct aggregation that has spilled produces the keys it has not
+  // returned yet like a regular aggregation after the end of input.
+  if (isDistinct_ && (newDistincts_ || !groupingSet_->hasSpilled())) {
     if (!newDistincts_) {
       if (noMoreInput_) {
         finished_ = true;
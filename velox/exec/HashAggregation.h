@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <deque>
+
 #include "velox/exec/GroupingSet.h"
 #include "velox/exec/Operator.h"
 
@@ -22,20 +24,40 @@ namespace facebook::velox::exec {
 
 class HashAggregation : public Operator {
  public:
+  /// If 'groupIdNode' is not null, it is the source of 'aggregationNode' and
+  /// the input of this is the input of 'groupIdNode'. The input is then
+  /// aggregated once on the union of the grouping keys of all grouping sets
+  /// and the grouping sets are rolled up from these groups. See canRollUp().
   HashAggregation(
       int32_t operatorId,
       DriverCtx* driverCtx,
-      const std::shared_ptr<const core::AggregationNode>& aggregationNode);
+      const std::shared_ptr<const core::AggregationNode>& aggregationNode,
+      const std::shared_ptr<const core::GroupIdNode>& groupIdNode = nullptr);
+
+  /// Returns true if 'aggregationNode' over the output of 'groupIdNode' can
+  /// be computed without expanding the input once per grouping set. This is
+  /// the case for a partial or single aggregation whose aggregates can be
+  /// merged from intermediate results, i.e. they have no masks and no sorted
+  /// or distinct inputs, and whose inputs are not grouping keys.
+  static bool canRollUp(
+      const core::GroupIdNode& groupIdNode,
+      const core::AggregationNode& aggregationNode,
+      const core::QueryConfig& queryConfig);
 
   void addInput(RowVectorPtr input) override;
 
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ && flushedOutputs_.empty() &&
+        !(abandonedPartialAggregation_ && input_ != nullptr);
   }
 
   void noMoreInput() override {
+    if (finestSet_ != nullptr) {
+      finestSet_->noMoreInput();
+      rollUp();
+    }
     groupingSet_->noMoreInput();
     Operator::noMoreInput();
   }
@@ -49,25 +71,82 @@ class HashAggregation : public Operator {
   void close() override {
     Operator::close();
     groupingSet_.reset();
+    finestSet_.reset();
+  }
+
+  bool canReclaim() const override;
+
+  /// Flushes all the accumulated groups to output if this is a partial
+  /// aggregation. Otherwise, spills all the accumulated groups to disk.
+  void reclaim(uint64_t targetBytes) override;
+
+  bool canReclaimWithoutSpill() const override {
+    return canFlushPartialOutput();
   }
 
  private:
+  // Copies the spill stats from 'groupingSet_' to the operator stats.
+  void updateSpillStats();
+
+  // Returns true if the partial aggregation can flush its accumulated groups
+  // to output for memory reclamation.
+  bool canFlushPartialOutput() const;
+
+  // Invoked by memory reclamation to move all the accumulated groups of the
+  // partial aggregation into 'flushedOutputs_', and reset the hash table to
+  // free memory without disk spilling.
+  void flushPartialOutput();
+
   void prepareOutput(vector_size_t size);
 
   // Invoked to reset partial aggregation state if it was full and has been
   // flushed.
   void resetPartialOutputIfNeed();
 
+  // Resets the partial aggregation state after the accumulated groups have
+  // been flushed to output. Returns the aggregation ratio as a percentage.
+  double resetPartialOutput();
+
   // Invoked on partial output flush to try to bump up the partial aggregation
   // memory usage if it needs. 'aggregationPct' is the ratio between the number
   // of output rows and the number of input rows as a percentage. It is a
   // measure of the effectiveness of the partial aggregation.
   void maybeIncreasePartialAggregationMemoryUsage(double aggregationPct);
 
+  // Returns true if the partial aggregation should stop using the hash table
+  // because the number of groups is close to the number of input rows.
+  bool shouldAbandonPartialAggregation() const;
+
+  // Checks whether the last input batch of a partial aggregation was clustered
+  // on the grouping keys and switches to streaming the groups after enough
+  // clustered batches.
+  void maybeStreamClusteredInput();
+
+  // Returns the intermediate results of each row of 'input_' on its own after
+  // the partial aggregation has stopped using the hash table.
+  RowVectorPtr getAbandonedPartialOutput();
+
+  // Makes 'finestSet_' and a 'groupingSet_' that rolls up the grouping sets
+  // of 'groupIdNode' from the groups of 'finestSet_'.
+  void setupRollUp(
+      const core::AggregationNode& aggregationNode,
+      const core::GroupIdNode& groupIdNode);
+
+  // addInput() when rolling up grouping sets.
+  void addRollUpInput(const RowVectorPtr& input);
+
+  // Adds the groups of 'finestSet_' to 'groupingSet_' once per grouping set
+  // and clears 'finestSet_'.
+  void rollUp();
+
   const bool isPartialOutput_;
   const bool isIntermediate_;
   const bool isDistinct_;
   const bool isGlobal_;
+  // True if this is a partial aggregation that may stop using the hash table.
+  const bool canAbandonPartialAggregation_;
+  const int32_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
   const std::shared_ptr<memory::MemoryUsageTracker> memoryTracker_;
   const int64_t maxExtendedPartialAggregationMemoryUsage_;
   const std::optional<Spiller::Config> spillConfig_;
@@ -75,7 +154,37 @@ class HashAggregation : public Operator {
   int64_t maxPartialAggregationMemoryUsage_;
   std::unique_ptr<GroupingSet> groupingSet_;
 
+  // Set when rolling up grouping sets. Aggregates the input on the union of
+  // the grouping keys of all grouping sets and produces intermediate results.
+  // 'groupingSet_' then merges these per grouping set.
+  std::unique_ptr<GroupingSet> finestSet_;
+  // The output type of 'finestSet_': the grouping keys followed by the
+  // intermediate results.
+  RowTypePtr finestType_;
+  // The input type of 'groupingSet_' when rolling up: the grouping keys of
+  // 'groupIdNode', the intermediate results and the grouping set id.
+  RowTypePtr rollUpInputType_;
+  // For each grouping set, the column of 'finestType_' of each grouping key
+  // in 'rollUpInputType_' or kMissingGroupingKey if the key is not in the set.
+  std::vector<std::vector<column_index_t>> rollUpKeyMappings_;
+  static constexpr column_index_t kMissingGroupingKey =
+      std::numeric_limits<column_index_t>::max();
+
   bool partialFull_ = false;
+  // True while a partial aggregation checks whether its input is clustered on
+  // the grouping keys.
+  bool checkClusteredInput_;
+  // Number of input batches clustered on the grouping keys so far.
+  int32_t numClusteredInputs_ = 0;
+  // The group of the last row of the previous input batch.
+  const char* lastGroup_ = nullptr;
+  // True once a partial aggregation streams the groups of its clustered input.
+  // The hash table then holds only the groups of one input batch and is not
+  // flushed for memory.
+  bool streamingClusteredInput_ = false;
+  // True once the partial aggregation has stopped using the hash table. The
+  // groups in the hash table are flushed and reset first.
+  bool abandonedPartialAggregation_ = false;
   bool newDistincts_ = false;
   bool finished_ = false;
   RowContainerIterator resultIterator_;
@@ -94,6 +203,10 @@ class HashAggregation : public Operator {
 
   /// Possibly reusable output vector.
   RowVectorPtr output_;
+
+  /// The output vectors flushed by memory reclamation of partial aggregation
+  /// which are returned by getOutput() before producing any new output.
+  std::deque<RowVectorPtr> flushedOutputs_;
 };
 
 } // namespace facebook::velox::exec
@@ -41,6 +41,37 @@ BlockingReason fromStateToBlockingReason(HashBuild::State state) {
       VELOX_UNREACHABLE(HashBuild::stateName(state));
   }
 }
+
+// Returns the process-wide cache if 'joinNode' has a build cache key and its
+// table can be shared between queries. The tables of the joins that set the
+// probed flags of the build rows or return the build rows with null keys are
+// not cached.
+std::shared_ptr<HashBuildCache> getBuildCache(
+    const core::HashJoinNode& joinNode) {
+  if (!joinNode.buildCacheKey().has_value() || joinNode.isRightJoin() ||
+      joinNode.isFullJoin() || joinNode.isRightSemiFilterJoin() ||
+      joinNode.isRightSemiProjectJoin()) {
+    return nullptr;
+  }
+  return HashBuildCache::getInstance();
+}
+
+// Returns the key of the table of 'joinNode' in the HashBuildCache. The build
+// cache key of the plan is qualified with the properties of the join that
+// change the table.
+std::string makeBuildCacheKey(
+    const core::HashJoinNode& joinNode,
+    uint32_t splitGroupId,
+    const RowTypePtr& tableType) {
+  return fmt::format(
+      "{}/{}/{}/{}/{}/{}",
+      joinNode.buildCacheKey().value(),
+      splitGroupId,
+      core::joinTypeName(joinNode.joinType()),
+      joinNode.isNullAware(),
+      joinNode.filter() ? joinNode.filter()->toString() : "",
+      tableType->toString());
+}
 } // namespace
 
 HashBuild::HashBuild(
@@ -54,6 +85,7 @@ HashBuild::HashBuild(
       joinBridge_(operatorCtx_->task()->getHashJoinBridgeLocked(
           operatorCtx_->driverCtx()->splitGroupId,
           planNodeId())),
+      buildCache_(getBuildCache(*joinNode_)),
       spillMemoryThreshold_(
           operatorCtx_->driverCtx()
               ->queryConfig()
@@ -101,6 +133,20 @@ HashBuild::HashBuild(
   }
 
   tableType_ = ROW(std::move(names), std::move(types));
+
+  if (buildCache_ != nullptr) {
+    buildCacheKey_ = makeBuildCacheKey(
+        *joinNode_, operatorCtx_->driverCtx()->splitGroupId, tableType_);
+    if (joinBridge_->setCachedHashTable(*buildCache_, buildCacheKey_)) {
+      // The probe side gets the cached table. The driver finishes and closes
+      // the build side pipeline without reading its input.
+      stats_.wlock()->addRuntimeStat("buildCacheHits", RuntimeCounter(1));
+      noMoreInput_ = true;
+      setState(State::kFinish);
+      return;
+    }
+  }
+
   setupTable();
   setupSpiller();
 
@@ -111,7 +157,12 @@ HashBuild::HashBuild(
 
 void HashBuild::setupTable() {
   VELOX_CHECK_NULL(table_);
+  table_ = createTable(pool());
+  analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
+}
 
+std::unique_ptr<BaseHashTable> HashBuild::createTable(
+    memory::MemoryPool* pool) const {
   const auto numKeys = keyChannels_.size();
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
   keyHashers.reserve(numKeys);
@@ -129,12 +180,12 @@ void HashBuild::setupTable() {
   if (joinNode_->isRightJoin() || joinNode_->isFullJoin() ||
       joinNode_->isRightSemiProjectJoin()) {
     // Do not ignore null keys.
-    table_ = HashTable<false>::createForJoin(
+    return HashTable<false>::createForJoin(
         std::move(keyHashers),
         dependentTypes,
         true, // allowDuplicates
         true, // hasProbedFlag
-        pool());
+        pool);
   } else {
     // (Left) semi and anti join with no extra filter only needs to know whether
     // there is a match. Hence, no need to store entries with duplicate keys.
@@ -146,28 +197,86 @@ void HashBuild::setupTable() {
     if (isLeftNullAwareJoinWithFilter(joinNode_)) {
       // We need to check null key rows in build side in case of null-aware anti
       // or left semi project join with filter set.
-      table_ = HashTable<false>::createForJoin(
+      return HashTable<false>::createForJoin(
           std::move(keyHashers),
           dependentTypes,
           !dropDuplicates, // allowDuplicates
           needProbedFlag, // hasProbedFlag
-          pool());
+          pool);
     } else {
       // Ignore null keys
-      table_ = HashTable<true>::createForJoin(
+      return HashTable<true>::createForJoin(
           std::move(keyHashers),
           dependentTypes,
           !dropDuplicates, // allowDuplicates
           needProbedFlag, // hasProbedFlag
-          pool());
+          pool);
     }
   }
-  analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
+}
+
+std::unique_ptr<BaseHashTable> HashBuild::copyTable(
+    BaseHashTable& table,
+    memory::MemoryPool* pool) {
+  constexpr int32_t kBatchSize = 1'024;
+  auto copy = createTable(pool);
+  auto& hashers = copy->hashers();
+  auto* rows = copy->rows();
+  const auto nextOffset = rows->nextOffset();
+  bool analyzeKeys = copy->hashMode() != BaseHashTable::HashMode::kHash;
+  const auto numColumns = tableType_->size();
+  std::vector<VectorPtr> columns(numColumns);
+  std::vector<DecodedVector> decoders(numColumns - hashers.size());
+  std::vector<char*> sourceRows(kBatchSize);
+  SelectivityVector activeRows;
+  raw_vector<uint64_t> hashes;
+  BaseHashTable::RowsIterator iter;
+  int32_t numRows;
+  // The rows of the merged tables have the same layout as the rows of
+  // 'table'. The keys of the copy are analyzed as in addInput().
+  while ((numRows = table.listAllRows(
+              &iter, kBatchSize, RowContainer::kUnlimited, sourceRows.data())) >
+         0) {
+    activeRows.resize(numRows);
+    activeRows.setAll();
+    for (auto i = 0; i < numColumns; ++i) {
+      columns[i] =
+          BaseVector::create(tableType_->childAt(i), numRows, this->pool());
+      RowContainer::extractColumn(
+          sourceRows.data(), numRows, table.rows()->columnAt(i), columns[i]);
+    }
+    hashes.resize(numRows);
+    for (auto i = 0; i < hashers.size(); ++i) {
+      hashers[i]->decode(*columns[i], activeRows);
+      if (analyzeKeys) {
+        hashers[i]->computeValueIds(activeRows, hashes);
+        analyzeKeys = hashers[i]->mayUseValueIds();
+      }
+    }
+    for (auto i = 0; i < decoders.size(); ++i) {
+      decoders[i].decode(*columns[i + hashers.size()], activeRows);
+    }
+    for (auto row = 0; row < numRows; ++row) {
+      char* newRow = rows->newRow();
+      if (nextOffset) {
+        *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+      }
+      for (auto i = 0; i < hashers.size(); ++i) {
+        rows->store(hashers[i]->decodedVector(), row, newRow, i);
+      }
+      for (auto i = 0; i < decoders.size(); ++i) {
+        rows->store(decoders[i], row, newRow, i + hashers.size());
+      }
+    }
+  }
+  copy->prepareJoinTable({}, nullptr);
+  return copy;
 }
 
 void HashBuild::setupSpiller(SpillPartition* spillPartition) {
   VELOX_CHECK_NULL(spiller_);
   VELOX_CHECK_NULL(spillInputReader_);
+  restoringSpill_ = spillPartition != nullptr;
 
   if (!spillEnabled()) {
     return;
@@ -180,15 +289,24 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
         *this,
         [&](const std::vector<Operator*>& operators) { runSpill(operators); });
   } else {
-    spillInputReader_ = spillPartition->createReader();
-
     const auto startBit = spillPartition->id().partitionBitOffset() +
         spillConfig.hashBitRange.numBits();
-    // Disable spilling if exceeding the max spill level and the query might run
-    // out of memory if the restored partition still can't fit in memory.
+    // Disable spilling if exceeding the max spill level. If the join type
+    // allows, restore the partition a few files at a time so that it doesn't
+    // need to fit in memory at once. Otherwise the query might run out of
+    // memory if the restored partition still can't fit in memory.
     if (spillConfig.exceedSpillLevelLimit(startBit)) {
+      if (canRestoreInChunks() && spillPartition->numFiles() > 0) {
+        spillInputPartition_ = std::make_unique<SpillPartition>(
+            spillPartition->id(),
+            spillPartition->removeFiles(spillPartition->numFiles()));
+        spillInputReader_ = nextSpillInputChunkReader();
+      } else {
+        spillInputReader_ = spillPartition->createReader();
+      }
       return;
     }
+    spillInputReader_ = spillPartition->createReader();
     hashBits =
         HashBitRange(startBit, startBit + spillConfig.hashBitRange.numBits());
   }
@@ -205,7 +323,11 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.maxSpillWriteParallelism,
+      spillConfig.directIo,
+      spillConfig.tiers);
 
   const int32_t numPartitions = spiller_->hashBits().numPartitions();
   spillInputIndicesBuffers_.resize(numPartitions);
@@ -214,6 +336,33 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
   spillChildVectors_.resize(tableType_->size());
 }
 
+bool HashBuild::canRestoreInChunks() const {
+  // Each build row must be joined with all the probe rows of its partition at
+  // once, and a probe row might be output without being joined with all the
+  // build rows of its partition otherwise.
+  return isInnerJoin(joinType_) || isRightJoin(joinType_) ||
+      isRightSemiFilterJoin(joinType_) || isRightSemiProjectJoin(joinType_);
+}
+
+std::unique_ptr<UnorderedStreamReader<BatchStream>>
+HashBuild::nextSpillInputChunkReader() {
+  VELOX_CHECK_NOT_NULL(spillInputPartition_);
+  return SpillPartition(
+             spillInputPartition_->id(), spillInputPartition_->removeFiles(1))
+      .createReader();
+}
+
+bool HashBuild::spillInputChunkFull() {
+  if (testingTriggerSpill()) {
+    return true;
+  }
+  auto tracker = pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  return (spillMemoryThreshold_ != 0 &&
+          tracker->currentBytes() > spillMemoryThreshold_) ||
+      tracker->highUsage();
+}
+
 bool HashBuild::isInputFromSpill() const {
   return spillInputReader_ != nullptr;
 }
@@ -439,6 +588,18 @@ bool HashBuild::reserveMemory(const RowVectorPtr& input) {
     return false;
   }
 
+  // The table for all the rows is allocated at the end of the build. Reserves
+  // for it ahead, so that the build spills while it can instead of failing
+  // to allocate the table.
+  const int64_t tableBytes =
+      BaseHashTable::joinTableBytes(numRows + input->size());
+  if (!tracker->reservePredictedPeak(currentUsage + tableBytes)) {
+    numSpillRows_ = std::max<int64_t>(
+        1, tableBytes / (rows->fixedRowSize() + outOfLineBytesPerRow));
+    numSpillBytes_ = numSpillRows_ * outOfLineBytesPerRow;
+    return false;
+  }
+
   if (freeRows > input->size() &&
       (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
     // Enough free rows for input rows and enough variable length free
@@ -665,6 +826,23 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
   }
 }
 
+bool HashBuild::canReclaim() const {
+  return spillEnabled() && spiller_ != nullptr &&
+      !spiller_->state().isAllPartitionSpilled() && spillGroup_->canReclaim();
+}
+
+void HashBuild::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+  // Set the spill targets to spill all the spillable partitions as spilling
+  // part of the rows doesn't free memory from the row container.
+  numSpillRows_ = std::numeric_limits<int64_t>::max();
+  numSpillBytes_ = std::numeric_limits<int64_t>::max();
+  if (!spillGroup_->reclaimSpill()) {
+    numSpillRows_ = 0;
+    numSpillBytes_ = 0;
+  }
+}
+
 void HashBuild::addAndClearSpillTarget(uint64_t& numRows, uint64_t& numBytes) {
   numRows += numSpillRows_;
   numSpillRows_ = 0;
@@ -687,6 +865,7 @@ void HashBuild::noMoreInputInternal() {
   if (spillEnabled()) {
     spillGroup_->operatorStopped(*this);
   }
+  recordPredictedPeak();
 
   if (!finishHashBuild()) {
     return;
@@ -715,6 +894,26 @@ bool HashBuild::finishHashBuild() {
   otherTables.reserve(peers.size());
   SpillPartitionSet spillPartitions;
   Spiller::Stats spillStats;
+  // The spill files of the restored partition which are not in the built table
+  // if it is restored in chunks.
+  std::unique_ptr<SpillPartition> restoredPartitionRemainder;
+  bool restoredInChunks{false};
+  auto addRestoredPartitionRemainder = [&](HashBuild* build) {
+    auto& partition = build->spillInputPartition_;
+    if (partition == nullptr) {
+      return;
+    }
+    restoredInChunks = true;
+    if (partition->numFiles() == 0) {
+      return;
+    }
+    if (restoredPartitionRemainder == nullptr) {
+      restoredPartitionRemainder =
+          std::make_unique<SpillPartition>(partition->id());
+    }
+    restoredPartitionRemainder->addFiles(
+        partition->removeFiles(partition->numFiles()));
+  };
   if (joinHasNullKeys_ && isAntiJoin(joinType_) && nullAware_ &&
       !joinNode_->filter()) {
     joinBridge_->setAntiJoinHasNullKeys();
@@ -730,6 +929,7 @@ bool HashBuild::finishHashBuild() {
         }
       }
       otherTables.push_back(std::move(build->table_));
+      addRestoredPartitionRemainder(build);
       if (build->spiller_ != nullptr) {
         spillStats += build->spiller_->stats();
         build->spiller_->finishSpill(spillPartitions);
@@ -749,6 +949,7 @@ bool HashBuild::finishHashBuild() {
           lockedStats->spilledRows += spillStats.spilledRows;
           lockedStats->spilledPartitions += spillStats.spilledPartitions;
           lockedStats->spilledFiles += spillStats.spilledFiles;
+          lockedStats->spillWriteTiming.add(spillStats.spillWriteTiming);
         }
 
         spiller_->finishSpill(spillPartitions);
@@ -764,16 +965,46 @@ bool HashBuild::finishHashBuild() {
       // https://github.com/facebookincubator/velox/issues/3567 is fixed.
       const bool allowPrallelJoinBuild =
           !otherTables.empty() && spillPartitions.empty();
+      // The merged table keeps the rows of 'otherTables'.
+      uint64_t otherTablesBytes = 0;
+      for (const auto& otherTable : otherTables) {
+        otherTablesBytes += otherTable->rows()->allocatedBytes();
+      }
+      table_->setRadixPartitionBits(operatorCtx_->driverCtx()
+                                        ->queryConfig()
+                                        .hashJoinRadixPartitionBits());
       table_->prepareJoinTable(
           std::move(otherTables),
           allowPrallelJoinBuild ? operatorCtx_->task()->queryCtx()->executor()
                                 : nullptr);
 
-      addRuntimeStats();
+      addRestoredPartitionRemainder(this);
+      addRuntimeStats(spillPartitions);
+      if (restoredInChunks) {
+        stats_.wlock()->addRuntimeStat(
+            "spillRestoreChunks", RuntimeCounter(1));
+      }
+      // The query keeps the table it built. A copy of a table with all the
+      // build rows is cached.
+      if (buildCache_ != nullptr && spillPartitions.empty() &&
+          !restoredInChunks && !restoringSpill_) {
+        const auto tableBytes = table_->allocatedBytes() + otherTablesBytes;
+        if (buildCache_->put(
+                buildCacheKey_,
+                tableBytes,
+                joinHasNullKeys_,
+                [&](memory::MemoryPool* cachePool) {
+                  return copyTable(*table_, cachePool);
+                })) {
+          stats_.wlock()->addRuntimeStat(
+              "buildCacheInserts", RuntimeCounter(1));
+        }
+      }
       if (joinBridge_->setHashTable(
               std::move(table_),
               std::move(spillPartitions),
-              joinHasNullKeys_)) {
+              joinHasNullKeys_,
+              std::move(restoredPartitionRemainder))) {
         spillGroup_->restart();
       }
     }
@@ -820,6 +1051,7 @@ void HashBuild::setupSpillInput(HashJoinBridge::SpillInput spillInput) {
   table_.reset();
   spiller_.reset();
   spillInputReader_.reset();
+  spillInputPartition_.reset();
 
   // Reset the key and dependent channels as the spilled data columns have
   // already been ordered.
@@ -839,16 +1071,26 @@ void HashBuild::setupSpillInput(HashJoinBridge::SpillInput spillInput) {
 void HashBuild::processSpillInput() {
   checkRunning();
 
-  while (spillInputReader_->nextBatch(input_)) {
-    addInput(std::move(input_));
-    if (!isRunning()) {
-      return;
+  for (;;) {
+    while (spillInputReader_->nextBatch(input_)) {
+      addInput(std::move(input_));
+      if (!isRunning()) {
+        return;
+      }
+    }
+    // If the partition is restored in chunks, read the next spill file unless
+    // the table built so far reaches the memory limit. The remaining files are
+    // restored after the probe side has processed this table.
+    if (spillInputPartition_ == nullptr ||
+        spillInputPartition_->numFiles() == 0 || spillInputChunkFull()) {
+      break;
     }
+    spillInputReader_ = nextSpillInputChunkReader();
   }
   noMoreInputInternal();
 }
 
-void HashBuild::addRuntimeStats() {
+void HashBuild::addRuntimeStats(const SpillPartitionSet& spillPartitions) {
   // Report range sizes and number of distinct values for the join keys.
   const auto& hashers = table_->hashers();
   const auto hashTableStats = table_->stats();
@@ -878,6 +1120,13 @@ void HashBuild::addRuntimeStats() {
     lockedStats->runtimeStats["hashtable.numTombstones"] =
         RuntimeMetric(hashTableStats.numTombstones);
   }
+  if (hashTableStats.numRadixPartitions != 0) {
+    lockedStats->runtimeStats["hashtable.numRadixPartitions"] =
+        RuntimeMetric(hashTableStats.numRadixPartitions);
+  }
+  lockedStats->addRuntimeStat(
+      fmt::format("hashtable.mode.{}", table_->hashModeName()),
+      RuntimeCounter(1));
 
   // Add max spilling level stats if spilling has been triggered.
   if (spiller_ != nullptr && spiller_->isAnySpilled()) {
@@ -886,6 +1135,15 @@ void HashBuild::addRuntimeStats() {
         RuntimeCounter(
             spillConfig()->spillLevel(spiller_->hashBits().begin())));
   }
+
+  // Add the size distribution of the spilled partitions for each spill level.
+  for (const auto& [id, partition] : spillPartitions) {
+    lockedStats->addRuntimeStat(
+        fmt::format(
+            "spillPartitionBytes.level{}",
+            spillConfig()->spillLevel(id.partitionBitOffset())),
+        RuntimeCounter(partition->size(), RuntimeCounter::Unit::kBytes));
+  }
 }
 
 BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
@@ -77,6 +77,12 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
+  bool canReclaim() const override;
+
+  /// Spills all the spillable partitions from this and all the peer hash build
+  /// operators by running a group spill.
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   void setState(State state);
   void checkStateTransition(State state);
@@ -88,6 +94,15 @@ class HashBuild final : public Operator {
   // Invoked to set up hash table to build.
   void setupTable();
 
+  // Creates an empty table for the join in 'pool'.
+  std::unique_ptr<BaseHashTable> createTable(memory::MemoryPool* pool) const;
+
+  // Copies the rows of the built 'table' and its merged tables into a new
+  // table in 'pool' and prepares it for probing.
+  std::unique_ptr<BaseHashTable> copyTable(
+      BaseHashTable& table,
+      memory::MemoryPool* pool);
+
   // Invoked when operator has finished processing the build input and wait for
   // all the other drivers to finish the processing. The last driver that
   // reaches to the hash build barrier, is responsible to build the hash table
@@ -127,6 +142,19 @@ class HashBuild final : public Operator {
   // in memory, then we will recursively spill part(s) of its data on disk.
   void setupSpiller(SpillPartition* FOLLY_NULLABLE spillPartition = nullptr);
 
+  // Indicates if a spilled partition which exceeds the max spill level can be
+  // restored in chunks of spill files. Each chunk builds a separate table which
+  // is probed with all the spilled probe rows of the partition.
+  bool canRestoreInChunks() const;
+
+  // Returns a reader for the next spill file in 'spillInputPartition_'.
+  std::unique_ptr<UnorderedStreamReader<BatchStream>>
+  nextSpillInputChunkReader();
+
+  // Invoked after restoring a spill file in chunks to check if the table can't
+  // grow anymore.
+  bool spillInputChunkFull();
+
   // Invoked when either there is no more input from the build source or from
   // the spill input reader during the restoring.
   void noMoreInputInternal();
@@ -220,7 +248,7 @@ class HashBuild final : public Operator {
   // will be added to the joined output.
   void removeInputRowsForAntiJoinFilter();
 
-  void addRuntimeStats();
+  void addRuntimeStats(const SpillPartitionSet& spillPartitions);
 
   // Invoked to check if it needs to trigger spilling for test purpose only.
   bool testingTriggerSpill();
@@ -233,6 +261,16 @@ class HashBuild final : public Operator {
 
   const std::shared_ptr<HashJoinBridge> joinBridge_;
 
+  // The cache to store a copy of the built table in if the join node has a
+  // build cache key. The table is only cached if none of it is spilled.
+  const std::shared_ptr<HashBuildCache> buildCache_;
+
+  // The key of the table in 'buildCache_'.
+  std::string buildCacheKey_;
+
+  // True if the table is built from a spilled partition.
+  bool restoringSpill_{false};
+
   // The maximum memory usage that a hash build can hold before spilling.
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
@@ -289,6 +327,10 @@ class HashBuild final : public Operator {
   // Used to read input from previously spilled data for restoring.
   std::unique_ptr<UnorderedStreamReader<BatchStream>> spillInputReader_;
 
+  // Set to the spill files remaining to restore if the restored partition
+  // exceeds the max spill level and is restored in chunks.
+  std::unique_ptr<SpillPartition> spillInputPartition_;
+
   // Reusable memory for spill partition calculation for input data.
   std::vector<uint32_t> spillPartitions_;
 
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/HashBuildCache.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+std::shared_ptr<HashBuildCache>& instance() {
+  static std::shared_ptr<HashBuildCache> cache;
+  return cache;
+}
+
+std::mutex& instanceMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::string newPoolName() {
+  static std::atomic<int64_t> id{0};
+  return fmt::format("HashBuildCache_{}", id++);
+}
+} // namespace
+
+HashBuildCache::HashBuildCache(uint64_t maxBytes, uint64_t maxEntryBytes)
+    : maxEntryBytes_(maxEntryBytes),
+      pool_(memory::defaultMemoryManager()
+                .addRootPool(newPoolName(), maxBytes)
+                ->addLeafChild("tables")),
+      cache_(maxBytes) {}
+
+// static
+std::shared_ptr<HashBuildCache> HashBuildCache::getInstance() {
+  std::lock_guard<std::mutex> l(instanceMutex());
+  return instance();
+}
+
+// static
+void HashBuildCache::setInstance(std::shared_ptr<HashBuildCache> cache) {
+  std::lock_guard<std::mutex> l(instanceMutex());
+  instance() = std::move(cache);
+}
+
+std::optional<HashBuildCache::Table> HashBuildCache::get(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* entry = cache_.get(key);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+  auto table = *entry;
+  cache_.release(key);
+  return table;
+}
+
+bool HashBuildCache::put(
+    const std::string& key,
+    uint64_t bytes,
+    bool hasNullKeys,
+    const CopyTable& copyTable) {
+  if (!accepts(bytes) || get(key).has_value()) {
+    return false;
+  }
+  std::unique_ptr<BaseHashTable> copy;
+  try {
+    copy = copyTable(pool_.get());
+  } catch (const VeloxRuntimeError& e) {
+    if (e.errorCode() != error_code::kMemCapExceeded) {
+      throw;
+    }
+    // The evicted tables that are still in use hold the capacity.
+    return false;
+  }
+  VELOX_CHECK_NOT_NULL(copy);
+  VELOX_CHECK_EQ(copy->rows()->pool(), pool_.get());
+  // The table is allocated from 'pool_', so it keeps 'pool_' alive if it
+  // outlives the cache.
+  std::shared_ptr<BaseHashTable> shared(
+      copy.release(), [pool = pool_](BaseHashTable* table) { delete table; });
+  auto entry = std::make_unique<Table>(Table{std::move(shared), hasNullKeys});
+  std::lock_guard<std::mutex> l(mutex_);
+  // The cache takes ownership of 'entry' if it is added.
+  if (!cache_.add(key, entry.get(), bytes + key.size())) {
+    return false;
+  }
+  entry.release();
+  return true;
+}
+
+void HashBuildCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  cache_.free(cache_.maxSize());
+}
+
+SimpleLRUCacheStats HashBuildCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return cache_.getStats();
+}
+
+} // namespace facebook::velox::exec
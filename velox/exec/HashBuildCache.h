@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <optional>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/exec/HashTable.h"
+
+namespace facebook::velox::exec {
+
+/// Process-wide cache of the hash tables built by the build sides of hash
+/// joins, so that repeated joins with the same build side skip the build. A
+/// join opts in by setting HashJoinNode::buildCacheKey(), which must identify
+/// the build plan, the splits it reads and the snapshot of the data they are
+/// read from. HashBuild builds the table in the memory pool of its query as
+/// for any join, with spilling, and copies it into the cache once it is
+/// built if it is not spilled and fits. HashProbe probes the cached table
+/// instead when the key is found. The cached tables are allocated from the
+/// memory pool of the cache, whose capacity is the max size of the cache, and
+/// are shared by the probes of concurrent queries, so only the joins that do
+/// not set probed flags in the table are cached. A table stays valid for the
+/// queries that use it when its entry gets evicted. Thread-safe.
+class HashBuildCache {
+ public:
+  struct Table {
+    std::shared_ptr<BaseHashTable> table;
+
+    /// True if the build side has a null in a join key. See
+    /// HashJoinBridge::HashBuildResult.
+    bool hasNullKeys;
+  };
+
+  /// Makes a copy of a table in the given pool.
+  using CopyTable = std::function<std::unique_ptr<BaseHashTable>(
+      memory::MemoryPool* pool)>;
+
+  /// @param maxBytes The max total size of the cached tables and the capacity
+  /// of pool().
+  /// @param maxEntryBytes The max size of one table. Larger tables are not
+  /// cached.
+  HashBuildCache(uint64_t maxBytes, uint64_t maxEntryBytes);
+
+  /// Returns the process-wide cache or nullptr if none has been set.
+  static std::shared_ptr<HashBuildCache> getInstance();
+
+  /// Sets the process-wide cache. Clears it if 'cache' is nullptr.
+  static void setInstance(std::shared_ptr<HashBuildCache> cache);
+
+  /// The pool of the cached tables.
+  memory::MemoryPool* pool() const {
+    return pool_.get();
+  }
+
+  /// Returns true if a table of 'bytes' is small enough to be cached.
+  bool accepts(uint64_t bytes) const {
+    return bytes <= maxEntryBytes_;
+  }
+
+  /// Returns the table stored for 'key' or std::nullopt if there is none.
+  std::optional<Table> get(const std::string& key);
+
+  /// Stores the copy of a table of 'bytes' that 'copyTable' makes in pool()
+  /// under 'key', evicting the oldest entries to make room. Does not copy the
+  /// table if 'key' is already cached or the table is not accepted, and does
+  /// not store the copy if pool() runs out of capacity while copying. Returns
+  /// true if the copy is stored. The copy keeps pool() alive.
+  bool put(
+      const std::string& key,
+      uint64_t bytes,
+      bool hasNullKeys,
+      const CopyTable& copyTable);
+
+  /// Removes all entries.
+  void clear();
+
+  SimpleLRUCacheStats stats() const;
+
+ private:
+  const uint64_t maxEntryBytes_;
+  // The leaf child of a root pool with a capacity of the max size of the
+  // cache. The root is outside of the memory pools of the queries.
+  const std::shared_ptr<memory::MemoryPool> pool_;
+
+  mutable std::mutex mutex_;
+  SimpleLRUCache<std::string, Table> cache_;
+};
+
+} // namespace facebook::velox::exec
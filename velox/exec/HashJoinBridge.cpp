@@ -31,9 +31,10 @@ void HashJoinBridge::addBuilder() {
 }
 
 bool HashJoinBridge::setHashTable(
-    std::unique_ptr<BaseHashTable> table,
+    std::shared_ptr<BaseHashTable> table,
     SpillPartitionSet spillPartitionSet,
-    bool hasNullKeys) {
+    bool hasNullKeys,
+    std::unique_ptr<SpillPartition> restoredPartitionRemainder) {
   VELOX_CHECK_NOT_NULL(table, "setHashTable called with null table");
 
   auto spillPartitionIdSet = toSpillPartitionIdSet(spillPartitionSet);
@@ -45,6 +46,15 @@ bool HashJoinBridge::setHashTable(
     VELOX_CHECK(started_);
     VELOX_CHECK(!buildResult_.has_value());
     VELOX_CHECK(restoringSpillShards_.empty());
+    VELOX_CHECK_NULL(restoredPartitionRemainder_);
+
+    if (restoredPartitionRemainder != nullptr) {
+      VELOX_CHECK(restoringSpillPartitionId_.has_value());
+      VELOX_CHECK_EQ(
+          restoredPartitionRemainder->id(), restoringSpillPartitionId_.value());
+      VELOX_CHECK(spillPartitionSet.empty());
+      restoredPartitionRemainder_ = std::move(restoredPartitionRemainder);
+    }
 
     if (restoringSpillPartitionId_.has_value()) {
       for (const auto& id : spillPartitionIdSet) {
@@ -63,10 +73,12 @@ bool HashJoinBridge::setHashTable(
         std::move(table),
         std::move(restoringSpillPartitionId_),
         std::move(spillPartitionIdSet),
-        hasNullKeys);
+        hasNullKeys,
+        restoredPartitionRemainder_ != nullptr);
     restoringSpillPartitionId_.reset();
 
-    hasSpillData = !spillPartitionSets_.empty();
+    hasSpillData =
+        !spillPartitionSets_.empty() || restoredPartitionRemainder_ != nullptr;
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -84,12 +96,33 @@ void HashJoinBridge::setAntiJoinHasNullKeys() {
 
     buildResult_ = HashBuildResult{};
     restoringSpillPartitionId_.reset();
+    restoredPartitionRemainder_.reset();
     spillPartitions.swap(spillPartitionSets_);
     promises = std::move(promises_);
   }
   notify(std::move(promises));
 }
 
+bool HashJoinBridge::setCachedHashTable(
+    HashBuildCache& cache,
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!started_);
+  if (!cachedTableFound_.has_value()) {
+    auto cached = cache.get(key);
+    cachedTableFound_ = cached.has_value();
+    if (cached.has_value()) {
+      VELOX_CHECK(!buildResult_.has_value());
+      buildResult_ = HashBuildResult(
+          std::move(cached->table),
+          std::nullopt,
+          SpillPartitionIdSet{},
+          cached->hasNullKeys);
+    }
+  }
+  return cachedTableFound_.value();
+}
+
 std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableOrFuture(
     ContinueFuture* future) {
   std::lock_guard<std::mutex> l(mutex_);
@@ -125,7 +158,14 @@ bool HashJoinBridge::probeFinished() {
     // table from the next spill partition now.
     buildResult_.reset();
 
-    if (!spillPartitionSets_.empty()) {
+    if (restoredPartitionRemainder_ != nullptr) {
+      hasSpillInput = true;
+      restoringSpillPartitionId_ = restoredPartitionRemainder_->id();
+      restoringSpillShards_ = restoredPartitionRemainder_->split(numBuilders_);
+      VELOX_CHECK_EQ(restoringSpillShards_.size(), numBuilders_);
+      restoredPartitionRemainder_.reset();
+      promises = std::move(promises_);
+    } else if (!spillPartitionSets_.empty()) {
       hasSpillInput = true;
       restoringSpillPartitionId_ = spillPartitionSets_.begin()->first;
       restoringSpillShards_ =
@@ -150,7 +190,7 @@ std::optional<HashJoinBridge::SpillInput> HashJoinBridge::spillInputOrFuture(
       !restoringSpillPartitionId_.has_value() || !buildResult_.has_value());
 
   if (!restoringSpillPartitionId_.has_value()) {
-    if (spillPartitionSets_.empty()) {
+    if (spillPartitionSets_.empty() && restoredPartitionRemainder_ == nullptr) {
       return HashJoinBridge::SpillInput{};
     } else {
       promises_.emplace_back("HashJoinBridge::spillInputOrFuture");
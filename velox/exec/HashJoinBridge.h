@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/exec/HashBuildCache.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Spill.h"
@@ -35,32 +36,48 @@ class HashJoinBridge : public JoinBridge {
   void addBuilder();
 
   /// 'spillPartitionSet' contains the spilled partitions while building
-  /// 'table'. The function returns true if there is spill data to restore
-  /// after HashProbe operators process 'table', otherwise false. This only
-  /// applies if the disk spilling is enabled.
+  /// 'table'. 'restoredPartitionRemainder' is set if 'table' is built from
+  /// part of the restoring spill partition, and contains the spill files of
+  /// that partition not in 'table'. They are restored after HashProbe
+  /// operators process 'table'. The function returns true if there is spill
+  /// data to restore after HashProbe operators process 'table', otherwise
+  /// false. This only applies if the disk spilling is enabled.
   bool setHashTable(
-      std::unique_ptr<BaseHashTable> table,
+      std::shared_ptr<BaseHashTable> table,
       SpillPartitionSet spillPartitionSet,
-      bool hasNullKeys);
+      bool hasNullKeys,
+      std::unique_ptr<SpillPartition> restoredPartitionRemainder = nullptr);
 
   void setAntiJoinHasNullKeys();
 
+  /// Invoked by HashBuild operator ctor to take the table for 'key' from
+  /// 'cache'. The lookup is done once for all the HashBuild operators, so
+  /// that they all either build the table or finish without input. Returns
+  /// true if the table is cached, in which case it is the table of the
+  /// HashProbe operators.
+  bool setCachedHashTable(HashBuildCache& cache, const std::string& key);
+
   /// Represents the result of HashBuild operators: a hash table, an optional
   /// restored spill partition id associated with the table, and the spilled
   /// partitions while building the table if not empty. In case of an anti join,
   /// a build side entry with a null in a join key makes the join return
   /// nothing. In this case, HashBuild operators finishes early without
   /// processing all the input and without finishing building the hash table.
+  /// 'restoredPartitionHasMore' is true if the table is built from part of the
+  /// restored spill partition. The HashProbe operators then need to keep the
+  /// spilled probe data of that partition to probe the next table.
   struct HashBuildResult {
     HashBuildResult(
         std::shared_ptr<BaseHashTable> _table,
         std::optional<SpillPartitionId> _restoredPartitionId,
         SpillPartitionIdSet _spillPartitionIds,
-        bool _hasNullKeys)
+        bool _hasNullKeys,
+        bool _restoredPartitionHasMore = false)
         : hasNullKeys(_hasNullKeys),
           table(std::move(_table)),
           restoredPartitionId(std::move(_restoredPartitionId)),
-          spillPartitionIds(std::move(_spillPartitionIds)) {}
+          spillPartitionIds(std::move(_spillPartitionIds)),
+          restoredPartitionHasMore(_restoredPartitionHasMore) {}
 
     HashBuildResult() : hasNullKeys(true) {}
 
@@ -68,6 +85,7 @@ class HashJoinBridge : public JoinBridge {
     std::shared_ptr<BaseHashTable> table;
     std::optional<SpillPartitionId> restoredPartitionId;
     SpillPartitionIdSet spillPartitionIds;
+    bool restoredPartitionHasMore{false};
   };
 
   /// Invoked by HashProbe operator to get the table to probe which is built by
@@ -109,6 +127,9 @@ class HashJoinBridge : public JoinBridge {
 
   std::optional<HashBuildResult> buildResult_;
 
+  // Set by the first setCachedHashTable() to true if the table is cached.
+  std::optional<bool> cachedTableFound_;
+
   // restoringSpillPartitionXxx member variables are populated by the
   // bridge itself. When probe side finished processing, the bridge picks the
   // first partition from 'spillPartitionSets_', splits it into "even" shards
@@ -123,6 +144,11 @@ class HashJoinBridge : public JoinBridge {
   // of spill files and will be processed by one of the HashBuild operator.
   std::vector<std::unique_ptr<SpillPartition>> restoringSpillShards_;
 
+  // The spill files of the last restored partition which are not in the
+  // current table if the partition is restored in chunks. They are restored
+  // next, before the partitions in 'spillPartitionSets_'.
+  std::unique_ptr<SpillPartition> restoredPartitionRemainder_;
+
   // The spill partitions remaining to restore. This set is populated using
   // information provided by the HashBuild operators if spilling is enabled.
   // This set can grow if HashBuild operator cannot load full partition in
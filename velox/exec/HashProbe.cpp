@@ -15,10 +15,14 @@
  */
 
 #include "velox/exec/HashProbe.h"
+#include "velox/common/process/ProcessBase.h"
+#include "velox/common/testutil/TestValue.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/FieldReference.h"
 
+using facebook::velox::common::testutil::TestValue;
+
 namespace facebook::velox::exec {
 
 namespace {
@@ -53,20 +57,23 @@ RowTypePtr makeTableType(
 }
 
 // Copy values from 'rows' of 'table' according to 'projections' in
-// 'result'. Reuses 'result' children where possible.
+// 'result'. Reuses 'result' children where possible. Complex children are
+// recycled through 'vectorPool', which resets their nulls and nested vectors.
 void extractColumns(
     BaseHashTable* table,
     folly::Range<char**> rows,
     folly::Range<const IdentityProjection*> projections,
-    memory::MemoryPool* pool,
+    VectorPool& vectorPool,
     const RowVectorPtr& result) {
   for (auto projection : projections) {
     auto& child = result->childAt(projection.outputChannel);
-    // TODO: Consider reuse of complex types.
+    if (child && !child->isFlatEncoding()) {
+      vectorPool.release(child);
+    }
     if (!child || !BaseVector::isVectorWritable(child) ||
         !child->isFlatEncoding()) {
-      child = BaseVector::create(
-          result->type()->childAt(projection.outputChannel), rows.size(), pool);
+      child = vectorPool.get(
+          result->type()->childAt(projection.outputChannel), rows.size());
     }
     child->resize(rows.size());
     table->rows()->extractColumn(
@@ -74,6 +81,49 @@ void extractColumns(
   }
 }
 
+// Extracts a build side column for the hash table rows matched by a batch of
+// probe output. Holds the table and a copy of the row pointers until loaded so
+// that the batch can outlive the probe of its input.
+class BuildColumnLoader : public VectorLoader {
+ public:
+  BuildColumnLoader(
+      std::shared_ptr<BaseHashTable> table,
+      BufferPtr rows,
+      column_index_t column,
+      TypePtr type,
+      memory::MemoryPool* pool)
+      : table_(std::move(table)),
+        rows_(std::move(rows)),
+        column_(column),
+        type_(std::move(type)),
+        pool_(pool) {}
+
+ protected:
+  void loadInternal(RowSet rows, ValueHook* hook, VectorPtr* result) override {
+    VELOX_CHECK_NULL(hook, "HashProbe build side columns don't support hooks");
+    const auto* tableRows = rows_->as<char*>();
+    const vector_size_t size = rows.back() + 1;
+    *result = BaseVector::create(type_, size, pool_);
+    if (rows.size() == size) {
+      table_->rows()->extractColumn(tableRows, size, column_, *result);
+      return;
+    }
+    // The rows that are not accessed are extracted as nulls.
+    std::vector<char*> selectedRows(size, nullptr);
+    for (auto row : rows) {
+      selectedRows[row] = tableRows[row];
+    }
+    table_->rows()->extractColumn(selectedRows.data(), size, column_, *result);
+  }
+
+ private:
+  const std::shared_ptr<BaseHashTable> table_;
+  const BufferPtr rows_;
+  const column_index_t column_;
+  const TypePtr type_;
+  memory::MemoryPool* const pool_;
+};
+
 folly::Range<vector_size_t*> initializeRowNumberMapping(
     BufferPtr& mapping,
     vector_size_t size,
@@ -110,6 +160,88 @@ SpillPartitionNumSet toPartitionNumSet(
   }
   return partitionNumSet;
 }
+
+template <typename T>
+void addToBloomFilter(
+    const DecodedVector& decoded,
+    vector_size_t numRows,
+    BloomFilter<>& bloomFilter,
+    int64_t& min,
+    int64_t& max) {
+  for (auto row = 0; row < numRows; ++row) {
+    if (decoded.isNullAt(row)) {
+      continue;
+    }
+    const int64_t value = decoded.valueAt<T>(row);
+    bloomFilter.insert(common::BigintValuesUsingBloomFilter::hash(value));
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+}
+
+// Makes a Bloom filter based dynamic filter on the 'keyIndex'th join key of
+// 'table'. Returns null if the key is not of an integral type or the Bloom
+// filter takes more than 'maxSize' bytes.
+std::unique_ptr<common::Filter> makeBloomFilter(
+    BaseHashTable& table,
+    column_index_t keyIndex,
+    uint64_t maxSize,
+    memory::MemoryPool* pool) {
+  const auto& type = table.hashers()[keyIndex]->type();
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      break;
+    default:
+      return nullptr;
+  }
+  // NOTE: the number of distinct entries of a join table is the number of
+  // build side rows. The Bloom filter takes 2 bytes per entry.
+  const auto numEntries = table.numDistinct();
+  if (numEntries == 0 ||
+      numEntries > std::numeric_limits<int32_t>::max() / 2 ||
+      bits::nextPowerOfTwo(numEntries) * 2 > maxSize) {
+    return nullptr;
+  }
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(numEntries);
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+
+  std::vector<char*> rows(kBatchSize);
+  auto values = BaseVector::create(type, kBatchSize, pool);
+  DecodedVector decoded;
+  BaseHashTable::RowsIterator iter;
+  while (auto numRows = table.listAllRows(
+             &iter, kBatchSize, RowContainer::kUnlimited, rows.data())) {
+    values->resize(numRows);
+    table.rows()->extractColumn(rows.data(), numRows, keyIndex, values);
+    const SelectivityVector selected(numRows);
+    decoded.decode(*values, selected);
+    switch (type->kind()) {
+      case TypeKind::TINYINT:
+        addToBloomFilter<int8_t>(decoded, numRows, *bloomFilter, min, max);
+        break;
+      case TypeKind::SMALLINT:
+        addToBloomFilter<int16_t>(decoded, numRows, *bloomFilter, min, max);
+        break;
+      case TypeKind::INTEGER:
+        addToBloomFilter<int32_t>(decoded, numRows, *bloomFilter, min, max);
+        break;
+      default:
+        addToBloomFilter<int64_t>(decoded, numRows, *bloomFilter, min, max);
+        break;
+    }
+  }
+  if (min > max) {
+    // All the keys are null.
+    return nullptr;
+  }
+  return std::make_unique<common::BigintValuesUsingBloomFilter>(
+      min, max, std::move(bloomFilter), false);
+}
 } // namespace
 
 HashProbe::HashProbe(
@@ -133,6 +265,9 @@ HashProbe::HashProbe(
           joinNode_->canSpill(driverCtx->queryConfig())
               ? operatorCtx_->makeSpillConfig(Spiller::Type::kHashJoinProbe)
               : std::nullopt),
+      bloomFilterPushdownMaxSize_(
+          driverCtx->queryConfig().hashProbeBloomFilterPushdownMaxSize()),
+      lazyBuildOutput_(driverCtx->queryConfig().hashProbeLazyBuildOutput()),
       probeType_(joinNode_->sources()[0]->outputType()),
       filterResult_(1),
       outputTableRows_(outputBatchSize_) {
@@ -225,19 +360,26 @@ void HashProbe::initializeFilter(
 
 void HashProbe::maybeSetupSpillInput(
     const std::optional<SpillPartitionId>& restoredPartitionId,
-    const SpillPartitionIdSet& spillPartitionIds) {
+    const SpillPartitionIdSet& spillPartitionIds,
+    bool restoredPartitionHasMore) {
   VELOX_CHECK_NULL(spillInputReader_);
 
   // If 'restoredPartitionId' is not null, then 'table_' is built from the
   // spilled build data. Create an unsorted reader to read the probe inputs from
-  // the corresponding spilled probe partition on disk.
+  // the corresponding spilled probe partition on disk. If 'table_' is built
+  // from part of the spilled build data, keep the probe partition to probe the
+  // tables built from the rest of it.
   if (restoredPartitionId.has_value()) {
     auto iter = spillPartitionSet_.find(restoredPartitionId.value());
     VELOX_CHECK(iter != spillPartitionSet_.end());
-    auto partition = std::move(iter->second);
-    VELOX_CHECK_EQ(partition->id(), restoredPartitionId.value());
-    spillInputReader_ = partition->createReader();
-    spillPartitionSet_.erase(iter);
+    VELOX_CHECK_EQ(iter->second->id(), restoredPartitionId.value());
+    if (restoredPartitionHasMore) {
+      spillInputReader_ = iter->second->createSharedReader();
+    } else {
+      auto partition = std::move(iter->second);
+      spillInputReader_ = partition->createReader();
+      spillPartitionSet_.erase(iter);
+    }
   }
 
   VELOX_CHECK_NULL(spiller_);
@@ -260,7 +402,11 @@ void HashProbe::maybeSetupSpillInput(
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.maxSpillWriteParallelism,
+      spillConfig.directIo,
+      spillConfig.tiers);
   // Set the spill partitions to the corresponding ones at the build side. The
   // hash probe operator itself won't trigger any spilling.
   spiller_->setPartitionsSpilled(toPartitionNumSet(spillInputPartitionIds_));
@@ -300,7 +446,9 @@ void HashProbe::asyncWaitForHashTable() {
   VELOX_CHECK_NOT_NULL(table_);
 
   maybeSetupSpillInput(
-      hashBuildResult->restoredPartitionId, hashBuildResult->spillPartitionIds);
+      hashBuildResult->restoredPartitionId,
+      hashBuildResult->spillPartitionIds,
+      hashBuildResult->restoredPartitionHasMore);
 
   if (table_->numDistinct() == 0) {
     if (skipProbeOnEmptyBuild()) {
@@ -311,8 +459,9 @@ void HashProbe::asyncWaitForHashTable() {
   } else if (
       (isInnerJoin(joinType_) || isLeftSemiFilterJoin(joinType_) ||
        isRightSemiFilterJoin(joinType_) || isRightSemiProjectJoin(joinType_)) &&
-      table_->hashMode() != BaseHashTable::HashMode::kHash && !isSpillInput() &&
-      !hasMoreSpillData()) {
+      (table_->hashMode() != BaseHashTable::HashMode::kHash ||
+       bloomFilterPushdownMaxSize_ != 0) &&
+      !isSpillInput() && !hasMoreSpillData()) {
     // Find out whether there are any upstream operators that can accept
     // dynamic filters on all or a subset of the join keys. Create dynamic
     // filters to push down.
@@ -321,14 +470,27 @@ void HashProbe::asyncWaitForHashTable() {
     // probe input is read from spilled data and there is no upstream operators
     // involved; (2) if there is spill data to restore, then we can't filter
     // probe inputs solely based on the current table's join keys.
+    //
+    // The key value sets are only tracked by the hashers if the table is not
+    // in kHash mode. Otherwise, or if a key has too many distinct values, we
+    // try to push down a Bloom filter built over the key values instead.
     const auto& buildHashers = table_->hashers();
     auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
         this, keyChannels_);
     for (auto i = 0; i < keyChannels_.size(); i++) {
-      if (channels.find(keyChannels_[i]) != channels.end()) {
-        if (auto filter = buildHashers[i]->getFilter(false)) {
-          dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
-        }
+      if (channels.find(keyChannels_[i]) == channels.end()) {
+        continue;
+      }
+      std::unique_ptr<common::Filter> filter;
+      if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+        filter = buildHashers[i]->getFilter(false);
+      }
+      if (filter == nullptr && bloomFilterPushdownMaxSize_ != 0) {
+        filter =
+            makeBloomFilter(*table_, i, bloomFilterPushdownMaxSize_, pool());
+      }
+      if (filter != nullptr) {
+        dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
       }
     }
   }
@@ -488,9 +650,12 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the pushed down filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      dynamicFilters_.begin()->second->kind() !=
+          common::FilterKind::kBigintValuesUsingBloomFilter) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -567,6 +732,14 @@ void HashProbe::addInput(RowVectorPtr input) {
   }
 
   activeRows_ = nonNullInputRows_;
+  if (table_->numaNode() != -1) {
+    auto numaNode = process::getNumaNode();
+    TestValue::adjust(
+        "facebook::velox::exec::HashProbe::addInput::numaNode", &numaNode);
+    if (numaNode != table_->numaNode()) {
+      addRuntimeStat("numaRemoteProbeRows", RuntimeCounter(input_->size()));
+    }
+  }
   lookup_->hashes.resize(input_->size());
   auto mode = table_->hashMode();
   auto& buildHashers = table_->hashers();
@@ -699,16 +872,40 @@ void HashProbe::fillOutput(vector_size_t size) {
 
   if (isLeftSemiProjectJoin(joinType_)) {
     fillLeftSemiProjectMatchColumn(size);
+  } else if (lazyBuildOutput_) {
+    fillLazyBuildOutput(size);
   } else {
     extractColumns(
         table_.get(),
         folly::Range<char**>(outputTableRows_.data(), size),
         tableOutputProjections_,
-        pool(),
+        operatorCtx_->execCtx()->vectorPool(),
         output_);
   }
 }
 
+void HashProbe::fillLazyBuildOutput(vector_size_t size) {
+  if (tableOutputProjections_.empty()) {
+    return;
+  }
+  // 'outputTableRows_' is overwritten by the next batch, so the loaders share
+  // a copy of its rows.
+  auto rows = AlignedBuffer::allocate<char*>(size, pool());
+  std::copy(
+      outputTableRows_.begin(),
+      outputTableRows_.begin() + size,
+      rows->asMutable<char*>());
+  for (auto projection : tableOutputProjections_) {
+    const auto& type = outputType_->childAt(projection.outputChannel);
+    output_->childAt(projection.outputChannel) = std::make_shared<LazyVector>(
+        pool(),
+        type,
+        size,
+        std::make_unique<BuildColumnLoader>(
+            table_, rows, projection.inputChannel, type, pool()));
+  }
+}
+
 RowVectorPtr HashProbe::getBuildSideOutput() {
   outputTableRows_.resize(outputBatchSize_);
   int32_t numOut;
@@ -748,7 +945,7 @@ RowVectorPtr HashProbe::getBuildSideOutput() {
       table_.get(),
       folly::Range<char**>(outputTableRows_.data(), numOut),
       tableOutputProjections_,
-      pool(),
+      operatorCtx_->execCtx()->vectorPool(),
       output_);
 
   if (isRightSemiProjectJoin(joinType_)) {
@@ -777,6 +974,12 @@ void HashProbe::clearIdentityProjectedOutput() {
   for (auto& projection : identityProjections_) {
     output_->childAt(projection.outputChannel) = nullptr;
   }
+  if (lazyBuildOutput_) {
+    // The build side columns are new LazyVectors for each batch.
+    for (auto& projection : tableOutputProjections_) {
+      output_->childAt(projection.outputChannel) = nullptr;
+    }
+  }
 }
 
 bool HashProbe::needLastProbe() const {
@@ -843,6 +1046,7 @@ RowVectorPtr HashProbe::getOutput() {
 
   checkRunning();
 
+  outputBatchSize_ = adaptiveOutputBatchRows();
   clearIdentityProjectedOutput();
   if (!input_) {
     if (!hasMoreInput()) {
@@ -977,7 +1181,7 @@ void HashProbe::fillFilterInput(vector_size_t size) {
       table_.get(),
       folly::Range<char**>(outputTableRows_.data(), size),
       filterTableProjections_,
-      pool(),
+      operatorCtx_->execCtx()->vectorPool(),
       filterInput_);
 }
 
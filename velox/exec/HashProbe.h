@@ -102,10 +102,12 @@ class HashProbe : public Operator {
   // 'restoredSpillPartitionId' is not null. If 'spillPartitionIds' is not
   // empty, then spilling has been triggered at the build side and the function
   // will set up a spiller and the associated data structures to spill probe
-  // inputs.
+  // inputs. If 'restoredPartitionHasMore' is true, the spilled probe partition
+  // is kept to probe the next table built from the same partition.
   void maybeSetupSpillInput(
       const std::optional<SpillPartitionId>& restoredSpillPartitionId,
-      const SpillPartitionIdSet& spillPartitionIds);
+      const SpillPartitionIdSet& spillPartitionIds,
+      bool restoredPartitionHasMore);
 
   // Sets up 'filter_' and related members.p
   void initializeFilter(
@@ -119,6 +121,10 @@ class HashProbe : public Operator {
   // Populate output columns.
   void fillOutput(vector_size_t size);
 
+  // Sets the build side columns of 'output_' to LazyVectors that extract the
+  // first 'size' rows of 'outputTableRows_' from 'table_' when loaded.
+  void fillLazyBuildOutput(vector_size_t size);
+
   // Populate 'match' output column for the left semi join project,
   void fillLeftSemiProjectMatchColumn(vector_size_t size);
 
@@ -253,8 +259,9 @@ class HashProbe : public Operator {
         spillInputPartitionIds_.empty();
   }
 
-  // TODO: Define batch size as bytes based on RowContainer row sizes.
-  const uint32_t outputBatchSize_;
+  // Maximum number of rows in the output batch. Adapted to the size of the
+  // output rows at the start of each getOutput().
+  uint32_t outputBatchSize_;
 
   const std::shared_ptr<const core::HashJoinNode> joinNode_;
 
@@ -266,6 +273,15 @@ class HashProbe : public Operator {
 
   const std::optional<Spiller::Config> spillConfig_;
 
+  // The max size in bytes of a Bloom filter to push down as a dynamic filter.
+  // Zero disables the Bloom filter pushdown.
+  const uint64_t bloomFilterPushdownMaxSize_;
+
+  // If true, the build side columns of the probe output are LazyVectors which
+  // are extracted from 'table_' only for the rows that are accessed
+  // downstream.
+  const bool lazyBuildOutput_;
+
   const RowTypePtr probeType_;
 
   State state_{State::kWaitForBuild};
@@ -23,12 +23,27 @@
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/vector/VectorTypeUtils.h"
 
+DECLARE_bool(velox_hash_table_batched_probe);
+
 using facebook::velox::common::testutil::TestValue;
 
 namespace facebook::velox::exec {
 namespace {
 constexpr int32_t kMinTableSizeForParallelJoinBuild = 1000;
-}
+
+// The min number of rows per radix partition to build a radix partitioned join
+// table. Smaller tables fit in cache and don't benefit from partitioning.
+constexpr int64_t kMinRadixPartitionRows = 1024;
+
+// The first hash bit used to select the radix partition. The bits are above
+// the tag bits ([32, 39)) and are not used to index into a sub-table.
+constexpr uint8_t kRadixPartitionStartBit = 40;
+
+// The number of rows probed together by batchJoinProbe(). The tag words of all
+// the rows are prefetched before the first one is compared so that the cache
+// misses of the batch overlap.
+constexpr int32_t kProbeBatchSize = 16;
+} // namespace
 
 // static
 std::string BaseHashTable::modeString(HashMode mode) {
@@ -45,6 +60,13 @@ std::string BaseHashTable::modeString(HashMode mode) {
   }
 }
 
+std::string BaseHashTable::hashModeName() const {
+  if (hashMode() == HashMode::kNormalizedKey && hasRawKeys()) {
+    return "RAW_NORMALIZED_KEY";
+  }
+  return modeString(hashMode());
+}
+
 template <bool ignoreNullKeys>
 HashTable<ignoreNullKeys>::HashTable(
     std::vector<std::unique_ptr<VectorHasher>>&& hashers,
@@ -74,6 +96,7 @@ HashTable<ignoreNullKeys>::HashTable(
       pool,
       ContainerRowSerde::instance());
   nextOffset_ = rows_->nextOffset();
+  keyComparator_.emplace(rows_.get());
 }
 
 class ProbeState {
@@ -104,10 +127,17 @@ class ProbeState {
   // Use another instruction to make 16 copies of the tag being searched for
   inline void
   preProbe(uint8_t* tags, uint64_t sizeMask, uint64_t hash, int32_t row) {
+    preProbe(
+        tags, tagsByteOffset(hash, sizeMask), BaseHashTable::hashTag(hash), row);
+  }
+
+  // Same as above but with the tag word offset and the tag of 'row'
+  // precomputed, e.g. for a batch of rows with SIMD.
+  inline void
+  preProbe(uint8_t* tags, int32_t tagIndex, uint8_t tag, int32_t row) {
     row_ = row;
-    tagIndex_ = tagsByteOffset(hash, sizeMask);
+    tagIndex_ = tagIndex;
     tagsInTable_ = BaseHashTable::loadTags(tags, tagIndex_);
-    auto tag = BaseHashTable::hashTag(hash);
     wantedTags_ = BaseHashTable::TagVector::broadcast(tag);
     group_ = nullptr;
     indexInTags_ = kNotSet;
@@ -326,8 +356,8 @@ bool HashTable<ignoreNullKeys>::compareKeys(
   int32_t i = 0;
   do {
     auto& hasher = lookup.hashers[i];
-    if (!rows_->equals<!ignoreNullKeys>(
-            group, rows_->columnAt(i), hasher->decodedVector(), row)) {
+    if (!keyComparator_->equals<!ignoreNullKeys>(
+            i, group, hasher->decodedVector(), row)) {
       return false;
     }
   } while (++i < numKeys);
@@ -341,7 +371,7 @@ bool HashTable<ignoreNullKeys>::compareKeys(
   auto numKeys = hashers_.size();
   int32_t i = 0;
   do {
-    if (rows_->compare(group, inserted, i, CompareFlags{true, true})) {
+    if (keyComparator_->compare(group, inserted, i)) {
       return false;
     }
   } while (++i < numKeys);
@@ -421,6 +451,8 @@ void populateNormalizedKeys(HashLookup& lookup, int8_t sizeBits) {
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
+  // Allocates the rows for the possible new groups in bulk.
+  rows_->reserveRows(lookup.rows.size());
   if (hashMode_ == HashMode::kArray) {
     arrayGroupProbe(lookup);
     return;
@@ -431,6 +463,9 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   if (hashMode_ == HashMode::kNormalizedKey) {
     populateNormalizedKeys(lookup, sizeBits_);
   }
+  if (oldTags_) {
+    continueIncrementalRehash(lookup);
+  }
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
@@ -530,7 +565,16 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
     joinNormalizedKeyProbe(lookup);
     return;
   }
+  if (radixPartitioned_) {
+    radixJoinProbe(lookup);
+    return;
+  }
   int32_t probeIndex = 0;
+  if (FLAGS_velox_hash_table_batched_probe) {
+    probeIndex = batchJoinProbe(lookup, [&](ProbeState& state) {
+      fullProbe<true>(lookup, state, false);
+    });
+  }
   int32_t numProbes = lookup.rows.size();
   const vector_size_t* rows = lookup.rows.data();
   ProbeState state1;
@@ -564,17 +608,148 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
 }
 
 template <bool ignoreNullKeys>
-void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
-  int32_t probeIndex = 0;
-  int32_t numProbes = lookup.rows.size();
+template <typename FullProbe>
+int32_t HashTable<ignoreNullKeys>::batchJoinProbe(
+    HashLookup& lookup,
+    FullProbe fullProbe) {
+  using HashBatch = xsimd::batch<int64_t>;
+  constexpr int32_t kWidth = HashBatch::size;
+  static_assert(kProbeBatchSize % kWidth == 0);
+  const int32_t numProbes = lookup.rows.size();
   const vector_size_t* rows = lookup.rows.data();
+  const auto* hashes = reinterpret_cast<const int64_t*>(lookup.hashes.data());
+  const bool dense = simd::isDense(rows, numProbes);
+  const auto tagIndexMask = HashBatch::broadcast(
+      sizeMask_ & ~static_cast<int64_t>(sizeof(TagVector) - 1));
+  const auto tagBit = HashBatch::broadcast(0x80);
+  int64_t tagIndices[kProbeBatchSize];
+  int64_t wantedTags[kProbeBatchSize];
+  std::array<ProbeState, kProbeBatchSize> states;
+  int32_t probeIndex = 0;
+  for (; probeIndex + kProbeBatchSize <= numProbes;
+       probeIndex += kProbeBatchSize) {
+    // Computes the tag word offsets and the tags of the batch, same as
+    // ProbeState::tagsByteOffset() and hashTag().
+    for (auto i = 0; i < kProbeBatchSize; i += kWidth) {
+      const auto batchHashes = dense
+          ? HashBatch::load_unaligned(hashes + rows[probeIndex + i])
+          : simd::gather(hashes, rows + probeIndex + i);
+      (batchHashes & tagIndexMask).store_unaligned(tagIndices + i);
+      ((batchHashes >> 32) | tagBit).store_unaligned(wantedTags + i);
+    }
+    for (auto i = 0; i < kProbeBatchSize; ++i) {
+      __builtin_prefetch(tags_ + tagIndices[i]);
+    }
+    for (auto i = 0; i < kProbeBatchSize; ++i) {
+      states[i].preProbe(
+          tags_,
+          static_cast<int32_t>(tagIndices[i]),
+          static_cast<uint8_t>(wantedTags[i]),
+          rows[probeIndex + i]);
+    }
+    // Loads and prefetches the first candidate row of each probe.
+    for (auto i = 0; i < kProbeBatchSize; ++i) {
+      states[i].firstProbe(table_, 0);
+    }
+    for (auto i = 0; i < kProbeBatchSize; ++i) {
+      fullProbe(states[i]);
+    }
+  }
+  return probeIndex;
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::radixJoinProbe(HashLookup& lookup) {
+  VELOX_DCHECK(radixPartitioned_);
+  const auto numPartitions = radixBitRange_.numPartitions();
+  const auto numProbes = lookup.rows.size();
+  // Group the probe rows by radix partition with a counting sort.
+  std::vector<int32_t> partitionOffsets(numPartitions + 1, 0);
+  for (auto row : lookup.rows) {
+    ++partitionOffsets[radixPartition(lookup.hashes[row]) + 1];
+  }
+  for (auto i = 1; i <= numPartitions; ++i) {
+    partitionOffsets[i] += partitionOffsets[i - 1];
+  }
+  raw_vector<vector_size_t> partitionRows(numProbes);
+  {
+    std::vector<int32_t> nextOffsets(
+        partitionOffsets.begin(), partitionOffsets.end() - 1);
+    for (auto row : lookup.rows) {
+      partitionRows[nextOffsets[radixPartition(lookup.hashes[row])]++] = row;
+    }
+  }
+
+  const uint64_t sizeMask = radixPartitionCapacity_ - 1;
+  auto probe = [&](ProbeState& state, uint8_t* tags, char** table) {
+    lookup.hits[state.row()] = state.fullProbe<ProbeState::Operation::kProbe>(
+        tags,
+        table,
+        sizeMask,
+        0,
+        [&](char* group, int32_t row) {
+          return compareKeys(group, lookup, row);
+        },
+        [&](int32_t /*index*/, int32_t /*row*/) { return nullptr; },
+        numTombstones_,
+        false);
+  };
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
   ProbeState state4;
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    const int64_t offset = partition * radixPartitionCapacity_;
+    uint8_t* tags = tags_ + offset;
+    char** table = table_ + offset;
+    const vector_size_t* rows = partitionRows.data();
+    int32_t probeIndex = partitionOffsets[partition];
+    const int32_t probeEnd = partitionOffsets[partition + 1];
+    for (; probeIndex + 4 <= probeEnd; probeIndex += 4) {
+      int32_t row = rows[probeIndex];
+      state1.preProbe(tags, sizeMask, lookup.hashes[row], row);
+      row = rows[probeIndex + 1];
+      state2.preProbe(tags, sizeMask, lookup.hashes[row], row);
+      row = rows[probeIndex + 2];
+      state3.preProbe(tags, sizeMask, lookup.hashes[row], row);
+      row = rows[probeIndex + 3];
+      state4.preProbe(tags, sizeMask, lookup.hashes[row], row);
+      state1.firstProbe(table, 0);
+      state2.firstProbe(table, 0);
+      state3.firstProbe(table, 0);
+      state4.firstProbe(table, 0);
+      probe(state1, tags, table);
+      probe(state2, tags, table);
+      probe(state3, tags, table);
+      probe(state4, tags, table);
+    }
+    for (; probeIndex < probeEnd; ++probeIndex) {
+      const int32_t row = rows[probeIndex];
+      state1.preProbe(tags, sizeMask, lookup.hashes[row], row);
+      state1.firstProbe(table, 0);
+      probe(state1, tags, table);
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
   const uint64_t* keys = lookup.normalizedKeys.data();
   const uint64_t* hashes = lookup.hashes.data();
   char** hits = lookup.hits.data();
+  int32_t probeIndex = 0;
+  if (FLAGS_velox_hash_table_batched_probe) {
+    probeIndex = batchJoinProbe(lookup, [&](ProbeState& state) {
+      hits[state.row()] =
+          state.joinNormalizedKeyFullProbe(tags_, table_, sizeMask_, keys);
+    });
+  }
+  int32_t numProbes = lookup.rows.size();
+  const vector_size_t* rows = lookup.rows.data();
+  ProbeState state1;
+  ProbeState state2;
+  ProbeState state3;
+  ProbeState state4;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, hashes[row], row);
@@ -610,6 +785,7 @@ template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::allocateTables(uint64_t size) {
   VELOX_CHECK(bits::isPowerOfTwo(size), "Size is not a power of two: {}", size);
   VELOX_CHECK_GT(size, 0);
+  radixPartitioned_ = false;
   capacity_ = size;
   numTombstones_ = 0;
   sizeMask_ = capacity_ - 1;
@@ -624,10 +800,16 @@ void HashTable<ignoreNullKeys>::allocateTables(uint64_t size) {
   memset(tags_, 0, capacity_);
   // Not strictly necessary to clear 'table_' but more debuggable.
   memset(table_, 0, capacity_ * sizeof(char*));
+  // The pages are placed on the node of the thread which touches them first.
+  numaNode_ = process::getNumaNode();
+  peakTableBytes_ = std::max<int64_t>(
+      peakTableBytes_,
+      tableAllocation_.size() + oldTableAllocation_.size());
 }
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::clear() {
+  freeOldTable();
   rows_->clear();
   if (hashMode_ != HashMode::kArray && tags_) {
     memset(tags_, 0, capacity_);
@@ -638,6 +820,17 @@ void HashTable<ignoreNullKeys>::clear() {
   numDistinct_ = 0;
 }
 
+// static
+uint64_t BaseHashTable::joinTableBytes(uint64_t numDistinct) {
+  // Same as the initial size in checkSize().
+  auto size = std::max<uint64_t>(2048, bits::nextPowerOfTwo(numDistinct));
+  if (numDistinct > size - size / 8) {
+    size *= 2;
+  }
+  // One pointer and one tag byte per slot.
+  return size * (sizeof(char*) + 1);
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
   // NOTE: the way we decide the table size and trigger rehash, guarantees the
@@ -652,6 +845,10 @@ void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
 
   const int64_t newNumDistincts = numNew + numDistinct_;
   if (table_ == nullptr || capacity_ == 0) {
+    if (canApplyRadixJoinBuild()) {
+      radixJoinBuild();
+      return;
+    }
     // Initial guess of cardinality is double the first input batch or at
     // least 2K entries.
     // stats_.numDistinct is non-0 when switching from HashMode::kArray to
@@ -676,11 +873,127 @@ void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
     // NOTE: we need to plus one here as number itself could be power of two.
     const auto newCapacity = bits::nextPowerOfTwo(
         std::max(newNumDistincts, capacity_ - numTombstones_) + 1);
+    if (incrementalRehash_ && hashMode_ != HashMode::kArray) {
+      startIncrementalRehash(newCapacity);
+      return;
+    }
     allocateTables(newCapacity);
     rehash();
   }
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::startIncrementalRehash(uint64_t newCapacity) {
+  // The previous move normally ends before the table is full again.
+  finishIncrementalRehash();
+  ++numRehashes_;
+  oldTableAllocation_ = std::move(tableAllocation_);
+  oldTags_ = tags_;
+  oldTable_ = table_;
+  oldSizeMask_ = sizeMask_;
+  numOldGroups_ = capacity_ / sizeof(TagVector);
+  numOldGroupsMoved_ = 0;
+  nextOldGroup_ = 0;
+  oldMovedGroups_.assign(bits::nwords(numOldGroups_), 0);
+  allocateTables(newCapacity);
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::continueIncrementalRehash(HashLookup& lookup) {
+  const auto kEmptyGroup = TagVector::broadcast(ProbeState::kEmptyTag);
+  for (auto row : lookup.rows) {
+    auto group = ProbeState::tagsByteOffset(lookup.hashes[row], oldSizeMask_) /
+        sizeof(TagVector);
+    // Moves the groups up to the one where a probe of the old table stops.
+    for (auto i = 0; i < numOldGroups_; ++i) {
+      if (!bits::isBitSet(oldMovedGroups_.data(), group)) {
+        addOldGroup(group);
+      }
+      if (simd::toBitMask(
+              loadTags(oldTags_, group * sizeof(TagVector)) == kEmptyGroup)) {
+        break;
+      }
+      group = (group + 1) & (numOldGroups_ - 1);
+    }
+  }
+  // Moves 2 slots per probed row. The table grows again after about as many
+  // new entries as the old table has slots, so the move ends before this.
+  auto numGroups = 1 + 2 * lookup.rows.size() / sizeof(TagVector);
+  for (; numGroups > 0 && nextOldGroup_ < numOldGroups_; ++nextOldGroup_) {
+    if (!bits::isBitSet(oldMovedGroups_.data(), nextOldGroup_)) {
+      addOldGroup(nextOldGroup_);
+      --numGroups;
+    }
+  }
+  insertRehashRows();
+  if (numOldGroupsMoved_ == numOldGroups_) {
+    freeOldTable();
+  }
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::finishIncrementalRehash() {
+  if (!oldTags_) {
+    return;
+  }
+  constexpr int32_t kHashBatchSize = 1024;
+  for (; nextOldGroup_ < numOldGroups_; ++nextOldGroup_) {
+    if (!bits::isBitSet(oldMovedGroups_.data(), nextOldGroup_)) {
+      addOldGroup(nextOldGroup_);
+      if (rehashRows_.size() >= kHashBatchSize) {
+        insertRehashRows();
+      }
+    }
+  }
+  insertRehashRows();
+  freeOldTable();
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::addOldGroup(int64_t group) {
+  bits::setBit(oldMovedGroups_.data(), group);
+  ++numOldGroupsMoved_;
+  const auto offset = group * sizeof(TagVector);
+  for (auto i = 0; i < sizeof(TagVector); ++i) {
+    const auto tag = oldTags_[offset + i];
+    if (tag != ProbeState::kEmptyTag && tag != ProbeState::kTombstoneTag) {
+      rehashRows_.push_back(oldTable_[offset + i]);
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::insertRehashRows() {
+  if (rehashRows_.empty()) {
+    return;
+  }
+  rehashHashes_.resize(rehashRows_.size());
+  // The hashes of a normalized key table are made from the normalized keys
+  // stored with the rows, so this does not fail.
+  VELOX_CHECK(hashRows(
+      folly::Range(rehashRows_.data(), rehashRows_.size()),
+      false,
+      rehashHashes_));
+  insertForGroupBy(
+      rehashRows_.data(), rehashHashes_.data(), rehashRows_.size());
+  rehashRows_.clear();
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::freeOldTable() {
+  if (!oldTableAllocation_.empty()) {
+    rows_->pool()->freeContiguous(oldTableAllocation_);
+  }
+  oldTags_ = nullptr;
+  oldTable_ = nullptr;
+  oldSizeMask_ = 0;
+  numOldGroups_ = 0;
+  numOldGroupsMoved_ = 0;
+  nextOldGroup_ = 0;
+  oldMovedGroups_.clear();
+  rehashRows_.clear();
+}
+
 template <bool ignoreNullKeys>
 bool HashTable<ignoreNullKeys>::hashRows(
     folly::Range<char**> rows,
@@ -762,6 +1075,107 @@ bool HashTable<ignoreNullKeys>::canApplyParallelJoinBuild() const {
       kMinTableSizeForParallelJoinBuild;
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::setRadixPartitionBits(uint8_t numBits) {
+  VELOX_CHECK(isJoinBuild_);
+  VELOX_CHECK_EQ(capacity_, 0, "Can't radix partition a built hash table");
+  VELOX_CHECK_LE(kRadixPartitionStartBit + numBits, 64);
+  radixBitRange_ =
+      HashBitRange(kRadixPartitionStartBit, kRadixPartitionStartBit + numBits);
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::canApplyRadixJoinBuild() const {
+  if (!isJoinBuild_ || radixBitRange_.numBits() == 0) {
+    return false;
+  }
+  if (hashMode_ != HashMode::kHash) {
+    return false;
+  }
+  return numDistinct_ / radixBitRange_.numPartitions() >=
+      kMinRadixPartitionRows;
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::radixJoinBuild() {
+  TestValue::adjust("facebook::velox::exec::HashTable::radixJoinBuild", this);
+  ++numRehashes_;
+  constexpr int32_t kBatch = 1024;
+  raw_vector<char*> rows(kBatch);
+  raw_vector<uint64_t> hashes(kBatch);
+  const auto numPartitions = radixBitRange_.numPartitions();
+  // Counts the rows per partition to size the sub-tables.
+  std::vector<int64_t> partitionSizes(numPartitions, 0);
+  for (int32_t i = 0; i <= otherTables_.size(); ++i) {
+    auto* table = i == 0 ? this : otherTables_[i - 1].get();
+    RowContainerIterator iter;
+    while (auto numRows = table->rows_->listRows(
+               &iter, kBatch, RowContainer::kUnlimited, rows.data())) {
+      hashRows(folly::Range<char**>(rows.data(), numRows), false, hashes);
+      for (auto row = 0; row < numRows; ++row) {
+        ++partitionSizes[radixPartition(hashes[row])];
+      }
+    }
+  }
+  const auto maxPartitionSize =
+      *std::max_element(partitionSizes.begin(), partitionSizes.end());
+  // Use the same initial load factor as a single table.
+  const auto partitionCapacity = std::max<uint64_t>(
+      kMinRadixPartitionRows, bits::nextPowerOfTwo(maxPartitionSize * 2));
+  allocateTables(numPartitions * partitionCapacity);
+  radixPartitionCapacity_ = partitionCapacity;
+  radixPartitioned_ = true;
+
+  for (int32_t i = 0; i <= otherTables_.size(); ++i) {
+    auto* table = i == 0 ? this : otherTables_[i - 1].get();
+    RowContainerIterator iter;
+    while (auto numRows = table->rows_->listRows(
+               &iter, kBatch, RowContainer::kUnlimited, rows.data())) {
+      hashRows(folly::Range<char**>(rows.data(), numRows), false, hashes);
+      insertForRadixJoin(rows.data(), hashes.data(), numRows);
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::insertForRadixJoin(
+    char** groups,
+    uint64_t* hashes,
+    int32_t numGroups) {
+  VELOX_DCHECK(radixPartitioned_);
+  const uint64_t sizeMask = radixPartitionCapacity_ - 1;
+  ProbeState state;
+  for (auto i = 0; i < numGroups; ++i) {
+    const auto hash = hashes[i];
+    char* inserted = groups[i];
+    const int64_t offset = radixPartition(hash) * radixPartitionCapacity_;
+    uint8_t* tags = tags_ + offset;
+    char** table = table_ + offset;
+    state.preProbe(tags, sizeMask, hash, i);
+    state.firstProbe(table, 0);
+    state.fullProbe<ProbeState::Operation::kInsert>(
+        tags,
+        table,
+        sizeMask,
+        0,
+        [&](char* group, int32_t /*row*/) {
+          if (compareKeys(group, inserted)) {
+            if (nextOffset_) {
+              pushNext(group, inserted);
+            }
+            return true;
+          }
+          return false;
+        },
+        [&](int32_t /*row*/, int32_t index) {
+          storeRowPointer(offset + index, hash, inserted);
+          return nullptr;
+        },
+        numTombstones_,
+        false);
+  }
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::parallelJoinBuild() {
   TestValue::adjust(
@@ -1085,6 +1499,8 @@ void HashTable<ignoreNullKeys>::insertForJoin(
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::rehash() {
+  // All the rows are inserted from the RowContainers.
+  freeOldTable();
   ++numRehashes_;
   constexpr int32_t kHashBatchSize = 1024;
   if (canApplyParallelJoinBuild()) {
@@ -1263,10 +1679,39 @@ void HashTable<ignoreNullKeys>::clearUseRange(std::vector<bool>& useRange) {
   }
 }
 
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::canUseRawKeys() const {
+  if (hashers_.size() < 2) {
+    return false;
+  }
+  int32_t numBits = 0;
+  for (const auto& hasher : hashers_) {
+    const auto bits =
+        VectorHasher::rawKeyBits(hasher->typeKind(), !ignoreNullKeys);
+    if (bits == 0) {
+      return false;
+    }
+    numBits += bits;
+  }
+  return numBits <= 64;
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::enableRawKeys() {
+  int32_t shift = 0;
+  for (auto& hasher : hashers_) {
+    shift = hasher->enableRawKey(shift, !ignoreNullKeys);
+  }
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::decideHashMode(
     int32_t numNew,
     bool disableRangeArrayHash) {
+  if (hashMode_ == HashMode::kNormalizedKey && hasRawKeys()) {
+    // All values map to raw keys, so there is nothing better to change to.
+    return;
+  }
   std::vector<uint64_t> rangeSizes(hashers_.size());
   std::vector<uint64_t> distinctSizes(hashers_.size());
   std::vector<bool> useRange(hashers_.size());
@@ -1336,6 +1781,13 @@ void HashTable<ignoreNullKeys>::decideHashMode(
     setHashMode(HashMode::kArray, numNew);
     return;
   }
+  if (canUseRawKeys()) {
+    // Concatenating the bits of the keys is cheaper than looking up value ids
+    // and takes any new keys without a rehash.
+    enableRawKeys();
+    setHashMode(HashMode::kNormalizedKey, numNew);
+    return;
+  }
   if (distinctsWithReserve == VectorHasher::kRangeTooLarge &&
       rangesWithReserve == VectorHasher::kRangeTooLarge) {
     setHashMode(HashMode::kHash, numNew);
@@ -1366,6 +1818,10 @@ std::string HashTable<ignoreNullKeys>::toString() {
   out << "[HashTable  size: " << capacity_ << " occupied: " << occupied
       << " distinct count: " << numDistinct_
       << " tombstone count: " << numTombstones_ << "]";
+  if (oldTags_) {
+    out << "(rehashing, moved " << numOldGroupsMoved_ << " of "
+        << numOldGroups_ << " tag groups) ";
+  }
   if (table_ == nullptr) {
     out << "(no table) ";
   }
@@ -1644,6 +2100,7 @@ HashTable<true>::listNullKeyRows(NullKeyRowsIterator*, int32_t, char**) {
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::erase(folly::Range<char**> rows) {
+  finishIncrementalRehash();
   auto numRows = rows.size();
   raw_vector<uint64_t> hashes;
   hashes.resize(numRows);
@@ -1686,14 +2143,25 @@ void HashTable<ignoreNullKeys>::eraseWithHashes(
     }
 
     ProbeState state;
+    uint8_t* tags = tags_;
+    char** table = table_;
+    const uint64_t sizeMask =
+        radixPartitioned_ ? radixPartitionCapacity_ - 1 : sizeMask_;
     for (auto i = 0; i < numRows; ++i) {
-      state.preProbe(tags_, sizeMask_, hashes[i], i);
+      if (radixPartitioned_) {
+        // Erases from the sub-table of the row's radix partition.
+        const int64_t offset =
+            radixPartition(hashes[i]) * radixPartitionCapacity_;
+        tags = tags_ + offset;
+        table = table_ + offset;
+      }
+      state.preProbe(tags, sizeMask, hashes[i], i);
 
-      state.firstProbe<ProbeState::Operation::kErase>(table_, 0);
+      state.firstProbe<ProbeState::Operation::kErase>(table, 0);
       state.fullProbe<ProbeState::Operation::kErase>(
-          tags_,
-          table_,
-          sizeMask_,
+          tags,
+          table,
+          sizeMask,
           0,
           [&](const char* group, int32_t row) { return rows[row] == group; },
           [&](int32_t /*index*/, int32_t /*row*/) { return nullptr; },
@@ -1713,6 +2181,18 @@ void HashTable<ignoreNullKeys>::checkConsistency() const {
   }
   uint64_t numEmpty = 0;
   uint64_t numTombstone = 0;
+  // The entries of the old table that an incremental rehash has not moved.
+  uint64_t numOld = 0;
+  for (auto group = 0; group < numOldGroups_; ++group) {
+    if (bits::isBitSet(oldMovedGroups_.data(), group)) {
+      continue;
+    }
+    for (auto i = 0; i < sizeof(TagVector); ++i) {
+      const auto tag = oldTags_[group * sizeof(TagVector) + i];
+      numOld +=
+          tag != ProbeState::kEmptyTag && tag != ProbeState::kTombstoneTag;
+    }
+  }
   for (auto i = 0; i < capacity_; ++i) {
     if (tags_[i] == ProbeState::kTombstoneTag) {
       ++numTombstone;
@@ -1724,7 +2204,7 @@ void HashTable<ignoreNullKeys>::checkConsistency() const {
     }
   }
   VELOX_CHECK_EQ(
-      numEmpty + numTombstone + numDistinct_,
+      numEmpty + numTombstone + numDistinct_ - numOld,
       capacity_,
       "capacity: {}, numEmpty: {}, numTombstone: {}, numDistinct: {}",
       capacity_,
@@ -17,7 +17,9 @@
 
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/HashBitRange.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/RowComparator.h"
 #include "velox/exec/RowContainer.h"
 #include "velox/exec/VectorHasher.h"
 
@@ -54,6 +56,12 @@ struct HashTableStats {
   int64_t numDistinct{0};
   /// Counts the number of tombstone table slots.
   int64_t numTombstones{0};
+  /// The number of radix partitioned sub-tables of a hash join table. Zero if
+  /// the table is not radix partitioned.
+  int64_t numRadixPartitions{0};
+  /// The max bytes of the tag and pointer tables, including the smaller table
+  /// that an incremental rehash is still moving entries from.
+  int64_t peakTableBytes{0};
 };
 
 class BaseHashTable {
@@ -75,6 +83,19 @@ class BaseHashTable {
   /// Returns the string of the given 'mode'.
   static std::string modeString(HashMode mode);
 
+  /// Returns the string of the hash mode of 'this' for runtime stats. This is
+  /// modeString() of hashMode() or RAW_NORMALIZED_KEY for a normalized key
+  /// of raw keys.
+  std::string hashModeName() const;
+
+  /// Returns true if the normalized keys are the bits of the keys, see
+  /// VectorHasher::enableRawKey().
+  bool hasRawKeys() const {
+    return std::any_of(hashers_.begin(), hashers_.end(), [](const auto& h) {
+      return h->isRawKey();
+    });
+  }
+
   // Keeps track of results returned from a join table. One batch of
   // keys can produce multiple batches of results. This is initialized
   // from HashLookup, which is expected to stay constant while 'this'
@@ -176,6 +197,20 @@ class BaseHashTable {
       std::vector<std::unique_ptr<BaseHashTable>> tables,
       folly::Executor* FOLLY_NULLABLE executor = nullptr) = 0;
 
+  /// Sets the number of hash bits used to radix partition a hash join table.
+  /// If 'numBits' is not zero, prepareJoinTable() builds a large table in
+  /// kHash mode as 2^numBits independent sub-tables, and joinProbe() probes
+  /// the rows partition by partition so that the random table accesses stay
+  /// within a cache sized sub-table. This must be set before
+  /// prepareJoinTable().
+  virtual void setRadixPartitionBits(uint8_t numBits) = 0;
+
+  /// If 'enable' is true, a group by table that grows keeps the smaller table
+  /// and moves its entries to the larger one a few tag groups at a time during
+  /// the following groupProbe() calls, instead of rehashing all the rows at
+  /// once. Does not apply to join build sides.
+  virtual void setIncrementalRehash(bool enable) = 0;
+
   /// Returns the memory footprint in bytes for any data structures
   /// owned by 'this'.
   virtual int64_t allocatedBytes() const = 0;
@@ -196,10 +231,21 @@ class BaseHashTable {
   /// profiling.
   virtual HashTableStats stats() const = 0;
 
+  /// Returns the NUMA node of the thread which allocated and first touched
+  /// the hash table memory, or -1 if the table has not been allocated. The
+  /// OS places the pages on that node, so probes from other nodes access
+  /// remote memory.
+  virtual int32_t numaNode() const = 0;
+
   /// Returns table growth in bytes after adding 'numNewDistinct' distinct
   /// entries. This only concerns the hash table, not the payload rows.
   virtual uint64_t hashTableSizeIncrease(int32_t numNewDistinct) const = 0;
 
+  /// Returns the size in bytes of the table allocated for a join build side
+  /// with 'numDistinct' entries in hash mode. This only concerns the hash
+  /// table, not the payload rows.
+  static uint64_t joinTableBytes(uint64_t numDistinct);
+
   /// Returns true if the hash table contains rows with duplicate keys.
   virtual bool hasDuplicateKeys() const = 0;
 
@@ -330,11 +376,12 @@ class HashTable : public BaseHashTable {
   static std::unique_ptr<HashTable> createForAggregation(
       std::vector<std::unique_ptr<VectorHasher>>&& hashers,
       const std::vector<std::unique_ptr<Aggregate>>& aggregates,
-      memory::MemoryPool* FOLLY_NULLABLE pool) {
+      memory::MemoryPool* FOLLY_NULLABLE pool,
+      const std::vector<TypePtr>& dependentTypes = {}) {
     return std::make_unique<HashTable>(
         std::move(hashers),
         aggregates,
-        std::vector<TypePtr>{},
+        dependentTypes,
         false, // allowDuplicates
         false, // isJoinBuild
         false, // hasProbedFlag
@@ -398,7 +445,8 @@ class HashTable : public BaseHashTable {
   int64_t allocatedBytes() const override {
     // for each row: 1 byte per tag + sizeof(Entry) per table entry + memory
     // allocated with MemoryAllocator for fixed-width rows and strings.
-    return (1 + sizeof(char*)) * capacity_ + rows_->allocatedBytes();
+    return (1 + sizeof(char*)) * capacity_ + oldTableAllocation_.size() +
+        rows_->allocatedBytes();
   }
 
   HashStringAllocator* FOLLY_NULLABLE stringAllocator() override {
@@ -415,7 +463,16 @@ class HashTable : public BaseHashTable {
 
   HashTableStats stats() const override {
     return HashTableStats{
-        capacity_, numRehashes_, numDistinct_, numTombstones_};
+        capacity_,
+        numRehashes_,
+        numDistinct_,
+        numTombstones_,
+        radixPartitioned_ ? radixBitRange_.numPartitions() : 0,
+        peakTableBytes_};
+  }
+
+  int32_t numaNode() const override {
+    return numaNode_;
   }
 
   bool hasDuplicateKeys() const override {
@@ -445,11 +502,29 @@ class HashTable : public BaseHashTable {
       std::vector<std::unique_ptr<BaseHashTable>> tables,
       folly::Executor* FOLLY_NULLABLE executor = nullptr) override;
 
+  void setRadixPartitionBits(uint8_t numBits) override;
+
+  void setIncrementalRehash(bool enable) override {
+    incrementalRehash_ = enable && !isJoinBuild_;
+  }
+
+  /// Returns true if an incremental rehash is moving entries to the table.
+  bool isRehashing() const {
+    return oldTags_ != nullptr;
+  }
+
+  /// Returns true if the join table has been built as radix partitioned
+  /// sub-tables.
+  bool isRadixPartitioned() const {
+    return radixPartitioned_;
+  }
+
   uint64_t hashTableSizeIncrease(int32_t numNewDistinct) const override {
     if (numDistinct_ + numNewDistinct > rehashSize()) {
       // If rehashed, the table adds size_ entries (i.e. doubles),
-      // adding one pointer and one tag byte for each new position.
-      return capacity_ * (sizeof(void*) + 1);
+      // adding one pointer and one tag byte for each new position. An
+      // incremental rehash keeps the old table while it moves the entries.
+      return capacity_ * (sizeof(void*) + 1) * (incrementalRehash_ ? 2 : 1);
     }
     return 0;
   }
@@ -520,6 +595,14 @@ class HashTable : public BaseHashTable {
   // VectorHashers.
   void clearUseRange(std::vector<bool>& useRange);
 
+  // Returns true if the bits of all the keys fit in a normalized key. Only
+  // multi-part keys of narrow types qualify.
+  bool canUseRawKeys() const;
+
+  // Sets the VectorHashers of 'this' to raw key mode, with the first key in
+  // the low bits of the normalized key.
+  void enableRawKeys();
+
   void rehash();
   void storeKeys(HashLookup& lookup, vector_size_t row);
 
@@ -531,6 +614,29 @@ class HashTable : public BaseHashTable {
 
   void checkSize(int32_t numNew);
 
+  // Makes a table of 'newCapacity' and starts moving the entries of the
+  // current table to it, see setIncrementalRehash().
+  void startIncrementalRehash(uint64_t newCapacity);
+
+  // Moves the entries of the old table that a probe of any row of 'lookup'
+  // can visit to 'table_', so that the probe sees all the entries with its
+  // key. Also moves a part of the remaining entries, so that the move ends
+  // before 'table_' needs to grow.
+  void continueIncrementalRehash(HashLookup& lookup);
+
+  // Moves all the remaining entries of the old table to 'table_'.
+  void finishIncrementalRehash();
+
+  // Adds the entries in tag group 'group' of the old table to
+  // 'rehashRows_' and marks the group moved.
+  void addOldGroup(int64_t group);
+
+  // Inserts 'rehashRows_' into 'table_' and clears it.
+  void insertRehashRows();
+
+  // Frees the old table of an incremental rehash if any.
+  void freeOldTable();
+
   // Computes hash numbers of the appropriate hash mode for 'groups',
   // stores these in 'hashes' and inserts the groups using
   // insertForJoin or insertForGroupBy.
@@ -583,6 +689,35 @@ class HashTable : public BaseHashTable {
   // else.
   void parallelJoinBuild();
 
+  /// Checks if we can build the hash join table as radix partitioned
+  /// sub-tables. The function returns true if all of the following conditions:
+  /// 1. the hash table is built for join;
+  /// 2. the radix partitioning has been enabled by setRadixPartitionBits();
+  /// 3. the table is in kHash mode;
+  /// 4. the number of table entries per each radix partition is no less than a
+  ///    pre-defined threshold: 'kMinRadixPartitionRows' for now.
+  bool canApplyRadixJoinBuild() const;
+
+  // Builds the join table with one sub-table per radix partition. All the
+  // sub-tables have the same power of two capacity which is sized for the
+  // largest partition. The sub-tables are laid out consecutively in 'table_'
+  // and 'tags_'.
+  void radixJoinBuild();
+
+  // Inserts 'numGroups' rows into the sub-tables of their radix partitions.
+  void insertForRadixJoin(
+      char* FOLLY_NULLABLE* FOLLY_NULLABLE groups,
+      uint64_t* FOLLY_NULLABLE hashes,
+      int32_t numGroups);
+
+  // Probes the radix partitioned join table. The probe rows are first grouped
+  // by radix partition and then each group probes its own sub-table.
+  void radixJoinProbe(HashLookup& lookup);
+
+  int32_t radixPartition(uint64_t hash) const {
+    return radixBitRange_.partition(hash);
+  }
+
   // Inserts the rows in 'partition' from this and 'otherTables' into 'this'.
   // The rows that would have gone past the end of the partition are returned in
   // 'overflow'.
@@ -623,6 +758,15 @@ class HashTable : public BaseHashTable {
   // Shortcut for probe with normalized keys.
   void joinNormalizedKeyProbe(HashLookup& lookup);
 
+  // Probes the join table for the rows of 'lookup' in batches of 16. The tag
+  // word offsets and tags of a batch are computed with SIMD from the gathered
+  // hashes and all the tag words are prefetched before the first probe. Calls
+  // 'fullProbe' with the ProbeState of each row to finish its probe. Returns
+  // the number of rows probed, which is a multiple of the batch size. The
+  // caller probes the remaining rows.
+  template <typename FullProbe>
+  int32_t batchJoinProbe(HashLookup& lookup, FullProbe fullProbe);
+
   // Adds a row to a hash join table in kArray hash mode. Returns true
   // if a new entry was made and false if the row was added to an
   // existing set of rows with the same key.
@@ -672,6 +816,10 @@ class HashTable : public BaseHashTable {
   // Offset of next row link for join build side, 0 if none. Copied
   // from 'rows_'.
   int32_t nextOffset_;
+
+  // Compares the keys of the rows of 'rows_' with each other and with the
+  // probe keys.
+  std::optional<RowComparator> keyComparator_;
   uint8_t* FOLLY_NULLABLE tags_ = nullptr;
   char* FOLLY_NULLABLE* FOLLY_NULLABLE table_ = nullptr;
   memory::ContiguousAllocation tableAllocation_;
@@ -682,6 +830,31 @@ class HashTable : public BaseHashTable {
   int64_t numTombstones_{0};
   /// Counts the number of rehash() calls.
   int64_t numRehashes_{0};
+  // The max of the bytes of 'tableAllocation_' and 'oldTableAllocation_'.
+  int64_t peakTableBytes_{0};
+
+  // True if a group by table grows by incremental rehash.
+  bool incrementalRehash_{false};
+  // The tags, pointers and allocation of the table that an incremental rehash
+  // moves entries from. The tag groups whose bit is set in
+  // 'oldMovedGroups_' are moved. 'oldTags_' is nullptr if no rehash is in
+  // progress. A probe of the old table stops at the first tag group with an
+  // empty slot, as for 'tags_'. The tags of the old table are kept as they
+  // were so that the probes see the same groups after the move.
+  uint8_t* FOLLY_NULLABLE oldTags_{nullptr};
+  char* FOLLY_NULLABLE* FOLLY_NULLABLE oldTable_{nullptr};
+  memory::ContiguousAllocation oldTableAllocation_;
+  int64_t oldSizeMask_{0};
+  int64_t numOldGroups_{0};
+  int64_t numOldGroupsMoved_{0};
+  // The next tag group the background part of the rehash looks at.
+  int64_t nextOldGroup_{0};
+  std::vector<uint64_t> oldMovedGroups_;
+  // The rows being moved, with their hashes.
+  raw_vector<char*> rehashRows_;
+  raw_vector<uint64_t> rehashHashes_;
+  // The NUMA node of the thread which last allocated 'table_'.
+  int32_t numaNode_{-1};
   HashMode hashMode_ = HashMode::kArray;
   // Owns the memory of multiple build side hash join tables that are
   // combined into a single probe hash table.
@@ -703,6 +876,17 @@ class HashTable : public BaseHashTable {
 
   // If true, avoids using VectorHasher value ranges with kArray hash mode.
   bool disableRangeArrayHash_{false};
+
+  // The hash bits used to select the radix partition of a row. The bits are
+  // above the tag bits and the sub-table index bits. Empty if the radix
+  // partitioning is not enabled.
+  HashBitRange radixBitRange_;
+
+  // True if the join table has been built as radix partitioned sub-tables.
+  bool radixPartitioned_{false};
+
+  // The capacity of each radix partitioned sub-table.
+  int64_t radixPartitionCapacity_{0};
 };
 
 } // namespace facebook::velox::exec
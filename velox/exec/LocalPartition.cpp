@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/LocalPartition.h"
+#include "velox/exec/RoundRobinPartitionFunction.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -29,55 +30,72 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
-  std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  if (bufferedBytes_.fetch_add(added) + added < maxBufferSize_) {
+    return false;
   }
 
-  return false;
+  std::lock_guard<std::mutex> l(mutex_);
+  hasWaiters_ = true;
+  // A consumer that decreased the usage before seeing 'hasWaiters_' does not
+  // notify, so check again before waiting.
+  if (bufferedBytes_ < maxBufferSize_) {
+    hasWaiters_ = !promises_.empty();
+    return false;
+  }
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 std::vector<ContinuePromise> LocalExchangeMemoryManager::decreaseMemoryUsage(
     int64_t removed) {
-  std::vector<ContinuePromise> promises;
-  {
-    std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
+  if (bufferedBytes_.fetch_sub(removed) - removed >= maxBufferSize_ ||
+      !hasWaiters_) {
+    return {};
+  }
 
-    if (bufferedBytes_ < maxBufferSize_) {
-      promises = std::move(promises_);
-    }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (bufferedBytes_ >= maxBufferSize_) {
+    // The next decrease below the limit notifies.
+    return {};
   }
-  return promises;
+  hasWaiters_ = false;
+  return std::move(promises_);
 }
 
 void LocalExchangeQueue::addProducer() {
-  queue_.withWLock([&](auto& /*queue*/) {
-    VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
-    ++pendingProducers_;
-  });
+  std::lock_guard<std::mutex> l(mutex_);
+  // A producer can join late while an earlier one holds the queue open, see
+  // tryAddProducer().
+  VELOX_CHECK(
+      !noMoreProducers_ || pendingProducers_ > 0,
+      "addProducer called after noMoreProducers");
+  ++pendingProducers_;
+}
+
+bool LocalExchangeQueue::tryAddProducer() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (noMoreProducers_ && pendingProducers_ == 0) {
+    return false;
+  }
+  ++pendingProducers_;
+  return true;
 }
 
 void LocalExchangeQueue::noMoreProducers() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!noMoreProducers_, "noMoreProducers can be called only once");
     noMoreProducers_ = true;
     if (pendingProducers_ == 0) {
       // No more data will be produced.
-      consumerPromises = std::move(consumerPromises_);
-
-      if (queue.empty()) {
-        // All data has been consumed.
-        producerPromises = std::move(producerPromises_);
-      }
+      noMoreData_ = true;
+      consumerPromises = wakeConsumerLocked();
+      producerPromises = producerPromisesIfFinishedLocked();
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
@@ -85,23 +103,34 @@ void LocalExchangeQueue::noMoreProducers() {
 BlockingReason LocalExchangeQueue::enqueue(
     RowVectorPtr input,
     ContinueFuture* future) {
+  if (closed_) {
+    return BlockingReason::kNotBlocked;
+  }
+
   auto inputBytes = input->retainedSize();
+  queue_.enqueue(std::move(input));
 
-  std::vector<ContinuePromise> consumerPromises;
-  bool isClosed = queue_.withWLock([&](auto& queue) {
-    if (closed_) {
-      return true;
+  // Pairs with the fence in close() and next(): either this producer sees
+  // 'closed_' and 'consumerWaiting_' or the other side sees the new data.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (closed_) {
+    std::vector<ContinuePromise> memoryPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      memoryPromises = dropDataLocked();
     }
-    queue.push(std::move(input));
-    consumerPromises = std::move(consumerPromises_);
-    return false;
-  });
-
-  if (isClosed) {
+    notify(memoryPromises);
     return BlockingReason::kNotBlocked;
   }
 
-  notify(consumerPromises);
+  if (consumerWaiting_) {
+    std::vector<ContinuePromise> consumerPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      consumerPromises = wakeConsumerLocked();
+    }
+    notify(consumerPromises);
+  }
 
   if (memoryManager_->increaseMemoryUsage(future, inputBytes)) {
     return BlockingReason::kWaitForConsumer;
@@ -113,16 +142,16 @@ BlockingReason LocalExchangeQueue::enqueue(
 void LocalExchangeQueue::noMoreData() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK_GT(pendingProducers_, 0);
     --pendingProducers_;
     if (noMoreProducers_ && pendingProducers_ == 0) {
-      consumerPromises = std::move(consumerPromises_);
-      if (queue.empty()) {
-        producerPromises = std::move(producerPromises_);
-      }
+      noMoreData_ = true;
+      consumerPromises = wakeConsumerLocked();
+      producerPromises = producerPromisesIfFinishedLocked();
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
@@ -131,12 +160,20 @@ BlockingReason LocalExchangeQueue::next(
     ContinueFuture* future,
     memory::MemoryPool* pool,
     RowVectorPtr* data) {
-  std::vector<ContinuePromise> producerPromises;
-  std::vector<ContinuePromise> memoryPromises;
-  auto blockingReason = queue_.withWLock([&](auto& queue) {
-    *data = nullptr;
-    if (queue.empty()) {
-      if (isFinishedLocked(queue)) {
+  *data = nullptr;
+  if (closed_) {
+    return BlockingReason::kNotBlocked;
+  }
+
+  if (!queue_.try_dequeue(*data)) {
+    std::lock_guard<std::mutex> l(mutex_);
+    consumerWaiting_ = true;
+    // Pairs with the fence in enqueue(): data enqueued after this point sees
+    // 'consumerWaiting_'.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!queue_.try_dequeue(*data)) {
+      if (isFinished()) {
+        consumerWaiting_ = false;
         return BlockingReason::kNotBlocked;
       }
 
@@ -145,73 +182,87 @@ BlockingReason LocalExchangeQueue::next(
 
       return BlockingReason::kWaitForProducer;
     }
+    consumerWaiting_ = !consumerPromises_.empty();
+  }
 
-    *data = queue.front();
-    queue.pop();
-
-    memoryPromises =
-        memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
+  auto memoryPromises =
+      memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
 
-    if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
-      producerPromises = std::move(producerPromises_);
-    }
+  std::vector<ContinuePromise> producerPromises;
+  if (noMoreData_ && queue_.empty()) {
+    std::lock_guard<std::mutex> l(mutex_);
+    producerPromises = producerPromisesIfFinishedLocked();
+  }
 
-    return BlockingReason::kNotBlocked;
-  });
   notify(memoryPromises);
   notify(producerPromises);
-  return blockingReason;
+  return BlockingReason::kNotBlocked;
 }
 
-bool LocalExchangeQueue::isFinishedLocked(
-    const std::queue<RowVectorPtr>& queue) const {
-  if (closed_) {
-    return true;
+std::vector<ContinuePromise> LocalExchangeQueue::wakeConsumerLocked() {
+  consumerWaiting_ = false;
+  return std::move(consumerPromises_);
+}
+
+std::vector<ContinuePromise>
+LocalExchangeQueue::producerPromisesIfFinishedLocked() {
+  if (!isFinished()) {
+    return {};
   }
+  return std::move(producerPromises_);
+}
 
-  if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
-    return true;
+std::vector<ContinuePromise> LocalExchangeQueue::dropDataLocked() {
+  uint64_t freedBytes = 0;
+  RowVectorPtr data;
+  while (queue_.try_dequeue(data)) {
+    freedBytes += data->retainedSize();
   }
 
-  return false;
+  if (freedBytes) {
+    return memoryManager_->decreaseMemoryUsage(freedBytes);
+  }
+  return {};
 }
 
 BlockingReason LocalExchangeQueue::isFinished(ContinueFuture* future) {
-  return queue_.withWLock([&](auto& queue) {
-    if (isFinishedLocked(queue)) {
-      return BlockingReason::kNotBlocked;
-    }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (isFinished()) {
+    return BlockingReason::kNotBlocked;
+  }
 
-    producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
-    *future = producerPromises_.back().getSemiFuture();
+  producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
+  *future = producerPromises_.back().getSemiFuture();
 
-    return BlockingReason::kWaitForConsumer;
-  });
+  return BlockingReason::kWaitForConsumer;
 }
 
 bool LocalExchangeQueue::isFinished() {
-  return queue_.withWLock([&](auto& queue) { return isFinishedLocked(queue); });
+  if (closed_) {
+    return true;
+  }
+
+  if (noMoreData_ && queue_.empty()) {
+    return true;
+  }
+
+  return false;
 }
 
 void LocalExchangeQueue::close() {
   std::vector<ContinuePromise> producerPromises;
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> memoryPromises;
-  queue_.withWLock([&](auto& queue) {
-    uint64_t freedBytes = 0;
-    while (!queue.empty()) {
-      freedBytes += queue.front()->retainedSize();
-      queue.pop();
-    }
-
-    if (freedBytes) {
-      memoryPromises = memoryManager_->decreaseMemoryUsage(freedBytes);
-    }
-
-    producerPromises = std::move(producerPromises_);
-    consumerPromises = std::move(consumerPromises_);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     closed_ = true;
-  });
+    // Pairs with the fence in enqueue(): data enqueued after this point is
+    // dropped by the producer.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    memoryPromises = dropDataLocked();
+    producerPromises = std::move(producerPromises_);
+    consumerPromises = wakeConsumerLocked();
+  }
   notify(producerPromises);
   notify(consumerPromises);
   notify(memoryPromises);
@@ -266,7 +317,9 @@ bool LocalExchange::isFinished() {
 LocalPartition::LocalPartition(
     int32_t operatorId,
     DriverCtx* ctx,
-    const std::shared_ptr<const core::LocalPartitionNode>& planNode)
+    const std::shared_ptr<const core::LocalPartitionNode>& planNode,
+    bool hashJoinProbeInput,
+    bool tableWriterInput)
     : Operator(
           ctx,
           planNode->outputType(),
@@ -280,12 +333,38 @@ LocalPartition::LocalPartition(
           numPartitions_ == 1
               ? nullptr
               : planNode->partitionFunctionSpec().create(numPartitions_)),
+      stringCompactionMinUsedRatio_(
+          ctx->queryConfig().stringCompactionMinUsedRatio()),
       blockingReasons_{numPartitions_} {
   VELOX_CHECK(numPartitions_ == 1 || partitionFunction_ != nullptr);
 
   for (auto& queue : queues_) {
     queue->addProducer();
   }
+
+  if (hashJoinProbeInput && numPartitions_ > 1 &&
+      ctx->queryConfig().hashJoinSkewedKeyRoutingEnabled()) {
+    hashPartitionFunction_ =
+        dynamic_cast<HashPartitionFunction*>(partitionFunction_.get());
+  }
+  if (hashPartitionFunction_ != nullptr) {
+    skewSketch_ = std::make_unique<
+        functions::ApproxMostFrequentStreamSummary<uint64_t>>();
+    // There are at most 'numPartitions_' keys more frequent than the average
+    // number of rows per partition.
+    skewSketch_->setCapacity(std::max<int>(128, 4 * numPartitions_));
+    // Spread the skewed rows of different producers over different partitions.
+    nextSkewedPartition_ = ctx->driverId % numPartitions_;
+  }
+
+  if (tableWriterInput && numPartitions_ > 1 &&
+      ctx->queryConfig().scaledWriterEnabled() &&
+      dynamic_cast<RoundRobinPartitionFunction*>(partitionFunction_.get())) {
+    // All the producers start on the first partition and add partitions in the
+    // same order, so that a small input goes to few writers.
+    scaledWriterMinBytes_ = std::max<uint64_t>(
+        1, ctx->queryConfig().scaledWriterMinDataProcessedBytes());
+  }
 }
 
 namespace {
@@ -338,7 +417,9 @@ void LocalPartition::addInput(RowVectorPtr input) {
 
   input_ = std::move(input);
 
-  if (numPartitions_ == 1) {
+  if (scaledWriters()) {
+    addScaledWriterInput();
+  } else if (numPartitions_ == 1) {
     ContinueFuture future;
     auto blockingReason = queues_[0]->enqueue(input_, &future);
     if (blockingReason != BlockingReason::kNotBlocked) {
@@ -347,6 +428,9 @@ void LocalPartition::addInput(RowVectorPtr input) {
     }
   } else {
     partitionFunction_->partition(*input_, partitions_);
+    if (hashPartitionFunction_ != nullptr) {
+      routeSkewedKeys();
+    }
 
     auto numInput = input_->size();
     auto indexBuffers = allocateIndexBuffers(numPartitions_, numInput, pool());
@@ -368,6 +452,11 @@ void LocalPartition::addInput(RowVectorPtr input) {
       indexBuffers[i]->setSize(partitionSize * sizeof(vector_size_t));
       auto partitionData =
           wrapChildren(input_, partitionSize, std::move(indexBuffers[i]));
+      if (stringCompactionMinUsedRatio_ > 0) {
+        partitionData = std::static_pointer_cast<RowVector>(
+            BaseVector::compactStringBuffers(
+                partitionData, stringCompactionMinUsedRatio_));
+      }
 
       ContinueFuture future;
       auto reason = queues_[i]->enqueue(partitionData, &future);
@@ -379,6 +468,77 @@ void LocalPartition::addInput(RowVectorPtr input) {
   }
 }
 
+void LocalPartition::addScaledWriterInput() {
+  const auto bytes = input_->estimateFlatSize();
+  ContinueFuture future;
+  auto reason = queues_[nextScaledWriter_]->enqueue(input_, &future);
+  if (reason != BlockingReason::kNotBlocked) {
+    blockingReasons_.push_back(reason);
+    futures_.push_back(std::move(future));
+    scaledWriterBlocked_ = true;
+  }
+  nextScaledWriter_ = (nextScaledWriter_ + 1) % numScaledWriters_;
+  scaledWriterBytes_ += bytes;
+  updateScaledWriters();
+}
+
+void LocalPartition::updateScaledWriters() {
+  if (scaledWriterBytes_ / numScaledWriters_ < scaledWriterMinBytes_) {
+    return;
+  }
+  const auto numWriters = numScaledWriters_;
+  if (scaledWriterBlocked_) {
+    numScaledWriters_ = std::min<uint32_t>(numWriters + 1, numPartitions_);
+  } else {
+    numScaledWriters_ = std::max<uint32_t>(numWriters - 1, 1);
+  }
+  scaledWriterBytes_ = 0;
+  scaledWriterBlocked_ = false;
+  if (numScaledWriters_ != numWriters) {
+    nextScaledWriter_ %= numScaledWriters_;
+    addRuntimeStat("scaledWriters", RuntimeCounter(numScaledWriters_));
+  }
+}
+
+void LocalPartition::routeSkewedKeys() {
+  const auto& hashes = hashPartitionFunction_->hashes();
+  const auto numInput = input_->size();
+  for (auto i = 0; i < numInput; i += kSkewSampleStride) {
+    skewSketch_->insert(hashes[i]);
+    ++numSkewSampledRows_;
+  }
+  updateSkewedKeys();
+  if (skewedKeys_.empty()) {
+    return;
+  }
+
+  int64_t numSkewedRows = 0;
+  for (auto i = 0; i < numInput; ++i) {
+    if (skewedKeys_.contains(hashes[i])) {
+      partitions_[i] = nextSkewedPartition_;
+      nextSkewedPartition_ = (nextSkewedPartition_ + 1) % numPartitions_;
+      ++numSkewedRows;
+    }
+  }
+  if (numSkewedRows > 0) {
+    addRuntimeStat("skewedRows", RuntimeCounter(numSkewedRows));
+  }
+}
+
+void LocalPartition::updateSkewedKeys() {
+  if (numSkewSampledRows_ < kMinSkewSampledRows) {
+    return;
+  }
+  skewedKeys_.clear();
+  const auto minCount = numSkewSampledRows_ / numPartitions_;
+  for (const auto& [hash, count] : skewSketch_->topK(numPartitions_)) {
+    if (count < minCount) {
+      break;
+    }
+    skewedKeys_.insert(hash);
+  }
+}
+
 BlockingReason LocalPartition::isBlocked(ContinueFuture* future) {
   if (!futures_.empty()) {
     auto blockingReason = blockingReasons_.front();
@@ -399,10 +559,19 @@ void LocalPartition::noMoreInput() {
 }
 
 bool LocalPartition::isFinished() {
-  if (!futures_.empty() || !noMoreInput_) {
+  if (!futures_.empty()) {
     return false;
   }
-
+  if (noMoreInput_) {
+    return true;
+  }
+  for (const auto& queue : queues_) {
+    if (!queue->isClosed()) {
+      return false;
+    }
+  }
+  // No consumer needs more data.
+  noMoreInput();
   return true;
 }
 } // namespace facebook::velox::exec
@@ -15,13 +15,20 @@
  */
 #pragma once
 
+#include <folly/concurrency/UnboundedQueue.h>
+#include <folly/container/F14Set.h>
+
+#include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/VectorHasher.h"
+#include "velox/functions/lib/ApproxMostFrequentStreamSummary.h"
 
 namespace facebook::velox::exec {
 
 /// Keeps track of the total size in bytes of the data buffered in all
-/// LocalExchangeQueues.
+/// LocalExchangeQueues. The size is updated with atomic operations so that
+/// producers and consumers do not contend on a lock. The mutex is only taken to
+/// block producers when the limit is reached and to unblock them.
 class LocalExchangeMemoryManager {
  public:
   explicit LocalExchangeMemoryManager(int64_t maxBufferSize)
@@ -38,17 +45,24 @@ class LocalExchangeMemoryManager {
 
  private:
   const int64_t maxBufferSize_;
+  std::atomic<int64_t> bufferedBytes_{0};
+  // True if 'promises_' may be non-empty. Lets consumers skip 'mutex_' when no
+  // producer is blocked.
+  std::atomic<bool> hasWaiters_{false};
   std::mutex mutex_;
-  int64_t bufferedBytes_{0};
   std::vector<ContinuePromise> promises_;
 };
 
 /// Buffers data for a single partition produced by local exchange. Allows
-/// multiple producers to enqueue data and multiple consumers fetch data. Each
+/// multiple producers to enqueue data and a single consumer to fetch data. Each
 /// producer must be registered with a call to 'addProducer'. 'noMoreProducers'
 /// must be called after all producers have been registered. A producer calls
 /// 'enqueue' multiple time to put the data and calls 'noMoreData' when done.
-/// Consumers call 'next' repeatedly to fetch the data.
+/// The consumer calls 'next' repeatedly to fetch the data.
+///
+/// The data is kept in a lock-free multi-producer single-consumer queue.
+/// Producers and the consumer take 'mutex_' only to wait for each other, to
+/// register and finish producers and on close.
 class LocalExchangeQueue {
  public:
   LocalExchangeQueue(
@@ -62,6 +76,12 @@ class LocalExchangeQueue {
 
   void addProducer();
 
+  /// Registers a producer after 'noMoreProducers' has been called, e.g. for a
+  /// Driver that the Task adds to a running pipeline. Returns false if all
+  /// producers are done, so that the consumer may have seen the end of the
+  /// data. A producer added this way is finished with 'noMoreData' as usual.
+  bool tryAddProducer();
+
   void noMoreProducers();
 
   /// Used by a producer to add data. Returning kNotBlocked if can accept more
@@ -72,7 +92,7 @@ class LocalExchangeQueue {
   /// Called by a producer to indicate that no more data will be added.
   void noMoreData();
 
-  /// Used by a consumer to fetch some data. Returns kNotBlocked and sets data
+  /// Used by the consumer to fetch some data. Returns kNotBlocked and sets data
   /// to nullptr if all data has been fetched and all producers are done
   /// producing data. Returns kWaitForProducer if there is no data, but some
   /// producers are not done producing data. Sets future that will be completed
@@ -96,12 +116,34 @@ class LocalExchangeQueue {
   /// called before all the data has been processed. No-op otherwise.
   void close();
 
+  /// True after close(), e.g. when the consumer needs no more data.
+  bool isClosed() const {
+    return closed_;
+  }
+
  private:
-  bool isFinishedLocked(const std::queue<RowVectorPtr>& queue) const;
+  // Returns 'consumerPromises_' to fulfill.
+  std::vector<ContinuePromise> wakeConsumerLocked();
+
+  // Returns 'producerPromises_' to fulfill if all data has been fetched.
+  std::vector<ContinuePromise> producerPromisesIfFinishedLocked();
+
+  // Drops the data in 'queue_' after close. Returns the promises of the
+  // producers waiting for memory to fulfill.
+  std::vector<ContinuePromise> dropDataLocked();
 
   std::shared_ptr<LocalExchangeMemoryManager> memoryManager_;
   const int partition_;
-  folly::Synchronized<std::queue<RowVectorPtr>> queue_;
+  folly::UMPSCQueue<RowVectorPtr, false> queue_;
+  // True while the consumer waits on 'consumerPromises_'. Producers take
+  // 'mutex_' to wake up the consumer only if set.
+  std::atomic<bool> consumerWaiting_{false};
+  // True when noMoreProducers_ is true and pendingProducers_ is zero.
+  std::atomic<bool> noMoreData_{false};
+  // Once set, 'queue_' is only dequeued under 'mutex_'.
+  std::atomic<bool> closed_{false};
+
+  std::mutex mutex_;
   // Satisfied when data becomes available or all producers report that they
   // finished producing, e.g. queue_ is not empty or noMoreProducers_ is true
   // and pendingProducers_ is zero.
@@ -112,7 +154,6 @@ class LocalExchangeQueue {
   std::vector<ContinuePromise> producerPromises_;
   int pendingProducers_{0};
   bool noMoreProducers_{false};
-  bool closed_{false};
 };
 
 /// Fetches data for a single partition produced by local exchange from
@@ -154,12 +195,33 @@ class LocalExchange : public SourceOperator {
 
 /// Hash partitions the data using specified keys. The number of partitions is
 /// determined by the number of LocalExchangeQueues(s) found in the task.
+///
+/// If the partitions feed the probe side of a hash join and
+/// hash_join_skewed_key_routing_enabled is set, tracks the most frequent key
+/// hashes in a sample of the input rows. The rows of the keys that are more
+/// frequent than the average number of rows per partition are sent to all the
+/// partitions round-robin instead of to a single one. All the hash probe
+/// drivers share the same hash table, so each of them can join these rows.
+///
+/// If the partitions are round-robin, feed a table writer and
+/// scaled_writer_enabled is set, the input batches are sent whole to the first
+/// 'numScaledWriters_' partitions round-robin. This starts at one and grows by
+/// one while the writers do not keep up with the input, i.e. the producer
+/// waits for buffer space, and each writer has received enough data for a
+/// file of scaled_writer_min_data_processed_bytes. It shrinks by one when as
+/// much data went through without waiting. The partitions that receive no
+/// data write no files.
 class LocalPartition : public Operator {
  public:
+  /// @param hashJoinProbeInput True if the partitions feed the probe side of a
+  /// hash join.
+  /// @param tableWriterInput True if the partitions feed a table writer.
   LocalPartition(
       int32_t operatorId,
       DriverCtx* ctx,
-      const std::shared_ptr<const core::LocalPartitionNode>& planNode);
+      const std::shared_ptr<const core::LocalPartitionNode>& planNode,
+      bool hashJoinProbeInput = false,
+      bool tableWriterInput = false);
 
   std::string toString() const override {
     return fmt::format("LocalPartition({})", numPartitions_);
@@ -181,13 +243,76 @@ class LocalPartition : public Operator {
 
   void noMoreInput() override;
 
+  /// True after noMoreInput() once the data is enqueued or as soon as all the
+  /// queues are closed, e.g. by consumers that finished early after a Limit.
   bool isFinished() override;
 
  private:
+  // Samples the key hashes of 'input_' into 'skewSketch_' and sends the rows
+  // of the skewed keys to all the partitions round-robin by updating
+  // 'partitions_'.
+  void routeSkewedKeys();
+
+  // Updates 'skewedKeys_' from 'skewSketch_'.
+  void updateSkewedKeys();
+
+  bool scaledWriters() const {
+    return scaledWriterMinBytes_ > 0;
+  }
+
+  // Enqueues 'input_' whole to the next of the scaled writer partitions.
+  void addScaledWriterInput();
+
+  // Adds or removes a scaled writer partition once the active partitions have
+  // received enough data since the last change.
+  void updateScaledWriters();
+
+  // Sample one of this many input rows to detect skewed keys.
+  static constexpr int32_t kSkewSampleStride = 8;
+
+  // Min number of sampled rows before any key is considered skewed.
+  static constexpr int64_t kMinSkewSampledRows = 256;
+
   const std::vector<std::shared_ptr<LocalExchangeQueue>> queues_;
   const size_t numPartitions_;
   std::unique_ptr<core::PartitionFunction> partitionFunction_;
 
+  // Min fraction of the string buffers of a column that the rows of a
+  // partition must reference for the partition to keep the buffers. 0 if
+  // disabled.
+  const double stringCompactionMinUsedRatio_;
+
+  // Set if skewed keys are routed round-robin. Points to
+  // 'partitionFunction_'.
+  HashPartitionFunction* hashPartitionFunction_{nullptr};
+
+  // Approximate counts of the most frequent key hashes in the sampled rows.
+  std::unique_ptr<functions::ApproxMostFrequentStreamSummary<uint64_t>>
+      skewSketch_;
+
+  int64_t numSkewSampledRows_{0};
+
+  // Hashes of the keys whose rows are sent round-robin.
+  folly::F14FastSet<uint64_t> skewedKeys_;
+
+  // The partition to send the next row of a skewed key to.
+  uint32_t nextSkewedPartition_{0};
+
+  // The bytes each scaled writer partition receives between changes of
+  // 'numScaledWriters_'. 0 if the input is not routed to scaled writers.
+  uint64_t scaledWriterMinBytes_{0};
+
+  // The number of leading partitions that receive the input batches.
+  uint32_t numScaledWriters_{1};
+
+  // The scaled writer partition to send the next batch to.
+  uint32_t nextScaledWriter_{0};
+
+  // The bytes sent and whether an enqueue had to wait for the writers since
+  // the last change of 'numScaledWriters_'.
+  uint64_t scaledWriterBytes_{0};
+  bool scaledWriterBlocked_{false};
+
   std::vector<BlockingReason> blockingReasons_;
   std::vector<ContinueFuture> futures_;
 
@@ -33,10 +33,12 @@
 #include "velox/exec/MergeJoin.h"
 #include "velox/exec/OrderBy.h"
 #include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/ShuffleWrite.h"
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/TableScan.h"
 #include "velox/exec/TableWriter.h"
 #include "velox/exec/TopN.h"
+#include "velox/exec/TopNRowNumber.h"
 #include "velox/exec/Unnest.h"
 #include "velox/exec/ValueStream.h"
 #include "velox/exec/Values.h"
@@ -74,8 +76,18 @@ OperatorSupplier makeConsumerSupplier(ConsumerSupplier consumerSupplier) {
   return nullptr;
 }
 
+// Returns true if 'planNode' is the probe side input of 'consumerNode' hash
+// join.
+bool isHashJoinProbeInput(
+    const std::shared_ptr<const core::PlanNode>& planNode,
+    const std::shared_ptr<const core::PlanNode>& consumerNode) {
+  auto join = std::dynamic_pointer_cast<const core::HashJoinNode>(consumerNode);
+  return join != nullptr && join->sources()[0] == planNode;
+}
+
 OperatorSupplier makeConsumerSupplier(
-    const std::shared_ptr<const core::PlanNode>& planNode) {
+    const std::shared_ptr<const core::PlanNode>& planNode,
+    const std::shared_ptr<const core::PlanNode>& consumerNode) {
   if (auto localMerge =
           std::dynamic_pointer_cast<const core::LocalMergeNode>(planNode)) {
     return [localMerge](int32_t operatorId, DriverCtx* ctx) {
@@ -92,9 +104,19 @@ OperatorSupplier makeConsumerSupplier(
 
   if (auto localPartitionNode =
           std::dynamic_pointer_cast<const core::LocalPartitionNode>(planNode)) {
-    return [localPartitionNode](int32_t operatorId, DriverCtx* ctx) {
+    const bool hashJoinProbeInput =
+        isHashJoinProbeInput(localPartitionNode, consumerNode);
+    const bool tableWriterInput =
+        std::dynamic_pointer_cast<const core::TableWriteNode>(consumerNode) !=
+        nullptr;
+    return [localPartitionNode, hashJoinProbeInput, tableWriterInput](
+               int32_t operatorId, DriverCtx* ctx) {
       return std::make_unique<LocalPartition>(
-          operatorId, ctx, localPartitionNode);
+          operatorId,
+          ctx,
+          localPartitionNode,
+          hashJoinProbeInput,
+          tableWriterInput);
     };
   }
 
@@ -150,7 +172,7 @@ void plan(
           sources[i],
           mustStartNewPipeline(planNode, i) ? nullptr : currentPlanNodes,
           planNode,
-          makeConsumerSupplier(planNode),
+          makeConsumerSupplier(planNode, consumerNode),
           driverFactories);
     }
   }
@@ -185,12 +207,21 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
       if (!values->isParallelizable()) {
         return 1;
       }
-    } else if (std::dynamic_pointer_cast<const core::ValueStreamNode>(node)) {
-      // ValueStream node must run single-threaded.
-      return 1;
+    } else if (
+        auto valueStream =
+            std::dynamic_pointer_cast<const core::ValueStreamNode>(node)) {
+      // ValueStream node must run single-threaded, unless each driver makes
+      // its own stream.
+      if (!valueStream->isParallelizable()) {
+        return 1;
+      }
     } else if (std::dynamic_pointer_cast<const core::ArrowStreamNode>(node)) {
       // ArrowStream node must run single-threaded.
       return 1;
+    } else if (
+        std::dynamic_pointer_cast<const core::ArrowStreamSinkNode>(node)) {
+      // The consumer of ArrowStreamSink is called by a single driver.
+      return 1;
     } else if (
         auto limit = std::dynamic_pointer_cast<const core::LimitNode>(node)) {
       // final limit must run single-threaded
@@ -412,6 +443,12 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
             std::dynamic_pointer_cast<const core::ArrowStreamNode>(planNode)) {
       operators.push_back(
           std::make_unique<ArrowStream>(id, ctx.get(), arrowStreamNode));
+    } else if (
+        auto arrowStreamSinkNode =
+            std::dynamic_pointer_cast<const core::ArrowStreamSinkNode>(
+                planNode)) {
+      operators.push_back(std::make_unique<ArrowStreamSink>(
+          id, ctx.get(), arrowStreamSinkNode));
     } else if (
         auto tableScanNode =
             std::dynamic_pointer_cast<const core::TableScanNode>(planNode)) {
@@ -441,6 +478,12 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
                 planNode)) {
       operators.push_back(std::make_unique<PartitionedOutput>(
           id, ctx.get(), partitionedOutputNode));
+    } else if (
+        auto shuffleWriteNode =
+            std::dynamic_pointer_cast<const core::ShuffleWriteNode>(
+                planNode)) {
+      operators.push_back(
+          std::make_unique<ShuffleWrite>(id, ctx.get(), shuffleWriteNode));
     } else if (
         auto joinNode =
             std::dynamic_pointer_cast<const core::HashJoinNode>(planNode)) {
@@ -456,7 +499,8 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
             std::dynamic_pointer_cast<const core::AggregationNode>(planNode)) {
       if (!aggregationNode->preGroupedKeys().empty() &&
           aggregationNode->preGroupedKeys().size() ==
-              aggregationNode->groupingKeys().size()) {
+              aggregationNode->groupingKeys().size() &&
+          !aggregationNode->hasSortedOrDistinctInputs()) {
         operators.push_back(std::make_unique<StreamingAggregation>(
             id, ctx.get(), aggregationNode));
       } else {
@@ -470,12 +514,33 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     } else if (
         auto groupIdNode =
             std::dynamic_pointer_cast<const core::GroupIdNode>(planNode)) {
+      if (i < planNodes.size() - 1) {
+        // An aggregation over GroupId that can roll up the grouping sets
+        // aggregates the input of GroupId without expanding it.
+        auto aggregationNode =
+            std::dynamic_pointer_cast<const core::AggregationNode>(
+                planNodes[i + 1]);
+        if (aggregationNode &&
+            HashAggregation::canRollUp(
+                *groupIdNode, *aggregationNode, ctx->queryConfig())) {
+          operators.push_back(std::make_unique<HashAggregation>(
+              id, ctx.get(), aggregationNode, groupIdNode));
+          i++;
+          continue;
+        }
+      }
       operators.push_back(
           std::make_unique<GroupId>(id, ctx.get(), groupIdNode));
     } else if (
         auto topNNode =
             std::dynamic_pointer_cast<const core::TopNNode>(planNode)) {
       operators.push_back(std::make_unique<TopN>(id, ctx.get(), topNNode));
+    } else if (
+        auto topNRowNumberNode =
+            std::dynamic_pointer_cast<const core::TopNRowNumberNode>(
+                planNode)) {
+      operators.push_back(
+          std::make_unique<TopNRowNumber>(id, ctx.get(), topNRowNumberNode));
     } else if (
         auto limitNode =
             std::dynamic_pointer_cast<const core::LimitNode>(planNode)) {
@@ -553,6 +618,40 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
   return std::make_shared<Driver>(std::move(ctx), std::move(operators));
 }
 
+bool DriverFactory::supportsAddingDrivers() const {
+  if (groupedExecution ||
+      !std::dynamic_pointer_cast<const core::TableScanNode>(
+          planNodes.front())) {
+    return false;
+  }
+  for (auto i = 1; i < planNodes.size(); ++i) {
+    const auto& node = planNodes[i];
+    if (std::dynamic_pointer_cast<const core::FilterNode>(node) ||
+        std::dynamic_pointer_cast<const core::ProjectNode>(node)) {
+      continue;
+    }
+    if (auto aggregation =
+            std::dynamic_pointer_cast<const core::AggregationNode>(node)) {
+      if (aggregation->step() == core::AggregationNode::Step::kPartial) {
+        continue;
+      }
+      return false;
+    }
+    if (i == planNodes.size() - 1 &&
+        std::dynamic_pointer_cast<const core::PartitionedOutputNode>(node)) {
+      continue;
+    }
+    return false;
+  }
+  if (needsPartitionedOutput()) {
+    return true;
+  }
+  // The results of the other output pipelines go to a consumer that may count
+  // its producers when the Task starts.
+  return std::dynamic_pointer_cast<const core::LocalPartitionNode>(
+             consumerNode) != nullptr;
+}
+
 std::vector<core::PlanNodeId> DriverFactory::needsHashJoinBridges() const {
   std::vector<core::PlanNodeId> planNodeIds;
   // Ungrouped execution pipelines need to take care of cross-mode bridges.
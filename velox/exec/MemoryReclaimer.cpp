@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/MemoryReclaimer.h"
+
+#include "velox/exec/Driver.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+std::shared_ptr<memory::MemoryReclaimer> MemoryReclaimer::create() {
+  return std::shared_ptr<memory::MemoryReclaimer>(new MemoryReclaimer());
+}
+
+void MemoryReclaimer::enterArbitration() {
+  auto* driverThreadCtx = driverThreadContext();
+  if (driverThreadCtx == nullptr) {
+    // Not a driver thread.
+    return;
+  }
+  auto* driver = driverThreadCtx->driver;
+  if (driver->state().isSuspended) {
+    // The driver has been suspended by the caller.
+    return;
+  }
+  if (driver->task()->enterSuspended(driver->state()) != StopReason::kNone) {
+    VELOX_FAIL(
+        "Terminate detected when entering suspended section for memory arbitration");
+  }
+  driverThreadCtx->suspendedForArbitration = true;
+}
+
+void MemoryReclaimer::leaveArbitration() noexcept {
+  auto* driverThreadCtx = driverThreadContext();
+  if (driverThreadCtx == nullptr ||
+      !driverThreadCtx->suspendedForArbitration) {
+    return;
+  }
+  driverThreadCtx->suspendedForArbitration = false;
+  auto* driver = driverThreadCtx->driver;
+  if (driver->task()->leaveSuspended(driver->state()) != StopReason::kNone) {
+    // NOTE: the driver checks the task termination on the next operator call
+    // so we don't throw here.
+    LOG(WARNING)
+        << "Terminate detected when leaving suspended section for memory arbitration: "
+        << driver->label();
+  }
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+namespace facebook::velox::exec {
+
+/// The default memory reclaimer for the memory pools created by the execution
+/// engine. On entering a memory arbitration, it puts the driver running on the
+/// current thread, if any, into the suspended state so that its task can be
+/// paused for memory reclamation by the arbitration. The query root memory pool
+/// should be created with this reclaimer if the memory manager uses shared
+/// memory arbitration.
+class MemoryReclaimer : public memory::MemoryReclaimer {
+ public:
+  static std::shared_ptr<memory::MemoryReclaimer> create();
+
+  void enterArbitration() override;
+
+  void leaveArbitration() noexcept override;
+
+ protected:
+  MemoryReclaimer() = default;
+};
+} // namespace facebook::velox::exec
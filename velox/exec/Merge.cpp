@@ -16,6 +16,7 @@
 
 #include "velox/exec/Merge.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 
 using facebook::velox::common::testutil::TestValue;
@@ -69,8 +70,8 @@ void Merge::initializeTreeOfLosers() {
     streams_.push_back(cursor.get());
   }
 
-  treeOfLosers_ =
-      std::make_unique<TreeOfLosers<SourceStream>>(std::move(sourceCursors));
+  treeOfLosers_ = std::make_unique<PrefixTreeOfLosers<SourceStream>>(
+      std::move(sourceCursors));
 }
 
 BlockingReason Merge::isBlocked(ContinueFuture* future) {
@@ -145,16 +146,23 @@ RowVectorPtr Merge::getOutput() {
       return std::move(output_);
     }
 
-    if (stream->setOutputRow(outputSize_)) {
-      // The stream is at end of input batch. Need to copy out the rows before
-      // fetching next batch in 'pop'.
-      stream->copyToOutput(output_);
-    }
+    // The rows of 'stream' with a prefix below 'bound' come before the rows
+    // of all the other streams and are taken without going through the tree.
+    const auto bound = treeOfLosers_->runBound();
+    bool blocked;
+    do {
+      if (stream->setOutputRow(outputSize_)) {
+        // The stream is at end of input batch. Need to copy out the rows
+        // before fetching next batch in 'pop'.
+        stream->copyToOutput(output_);
+      }
 
-    ++outputSize_;
+      ++outputSize_;
 
-    // Advance the stream.
-    stream->pop(sourceBlockingFutures_);
+      // Advance the stream.
+      blocked = stream->pop(sourceBlockingFutures_);
+    } while (!blocked && outputSize_ < outputBatchSize_ && stream->hasData() &&
+             stream->prefix() < bound);
 
     if (outputSize_ == outputBatchSize_) {
       // Copy out data from all sources.
@@ -255,6 +263,8 @@ bool SourceStream::fetchMoreData(std::vector<ContinueFuture>& futures) {
     for (const auto& key : sortingKeys_) {
       keyColumns_.push_back(data_->childAt(key.first).get());
     }
+    hasPrefixes_ = PrefixSort::encodePrefixes(
+        keyColumns_, compareFlags_, data_->size(), prefixes_);
   }
   return false;
 }
@@ -296,7 +306,11 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange"),
+      serdeOptions_(
+          false,
+          common::stringToCompressionKind(
+              driverCtx->queryConfig().exchangeCompressionKind())) {}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
@@ -68,7 +68,7 @@ class Merge : public SourceOperator {
   std::vector<SourceStream*> streams_;
 
   /// Used to merge data from two or more sources.
-  std::unique_ptr<TreeOfLosers<SourceStream>> treeOfLosers_;
+  std::unique_ptr<PrefixTreeOfLosers<SourceStream>> treeOfLosers_;
 
   RowVectorPtr output_;
 
@@ -93,6 +93,10 @@ class SourceStream final : public MergeStream {
         outputRows_(outputBatchSize, false),
         sourceRows_(outputBatchSize) {
     keyColumns_.reserve(sortingKeys.size());
+    compareFlags_.reserve(sortingKeys.size());
+    for (const auto& key : sortingKeys) {
+      compareFlags_.push_back(key.second);
+    }
   }
 
   /// Returns true and appends a future to 'futures' if needs to wait for the
@@ -112,6 +116,13 @@ class SourceStream final : public MergeStream {
   /// 'other'.
   bool operator<(const MergeStream& other) const override;
 
+  /// Returns the first 8 bytes of the binary comparable encoding of the keys
+  /// of the current source row. See PrefixSort::encodePrefixes(). Returns 0
+  /// if the keys cannot be encoded.
+  uint64_t prefix() const {
+    return hasPrefixes_ ? prefixes_[currentSourceRow_] : 0;
+  }
+
   /// Advances to the next row. Returns true and appends a future to 'futures'
   /// if runs out of rows in the current batch and needs to wait for the
   /// source to produce the next batch. The return flag has the meaning of
@@ -147,6 +158,14 @@ class SourceStream final : public MergeStream {
   /// order as 'sortingKeys_'.
   std::vector<BaseVector*> keyColumns_;
 
+  /// The compare flags of 'sortingKeys_'.
+  std::vector<CompareFlags> compareFlags_;
+
+  /// The prefix of each row of 'data_' if 'hasPrefixes_' is true.
+  std::vector<uint64_t> prefixes_;
+
+  bool hasPrefixes_{false};
+
   /// Index of the current row.
   vector_size_t currentSourceRow_{0};
 
@@ -191,10 +210,16 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  // Options for deserializing the pages, e.g. the compression codec.
+  const VectorSerde::Options* serdeOptions() const {
+    return &serdeOptions_;
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
@@ -32,10 +32,16 @@ MergeJoin::MergeJoin(
           "MergeJoin"),
       outputBatchSize_{outputBatchRows()},
       joinType_{joinNode->joinType()},
-      numKeys_{joinNode->leftKeys().size()} {
+      numKeys_{joinNode->leftKeys().size()},
+      spillMemoryThreshold_(
+          driverCtx->queryConfig().mergeJoinSpillMemoryThreshold()) {
   VELOX_USER_CHECK(
-      joinNode->isInnerJoin() || joinNode->isLeftJoin(),
-      "Merge join supports only inner and left joins. Other join types are not supported yet.");
+      isSupported(joinType_),
+      "Merge join doesn't support {} join",
+      core::joinTypeName(joinType_));
+  VELOX_USER_CHECK(
+      joinNode->filter() == nullptr || !joinNode->isFullJoin(),
+      "Merge join doesn't support full join with a filter");
 
   leftKeys_.reserve(numKeys_);
   rightKeys_.reserve(numKeys_);
@@ -69,10 +75,31 @@ MergeJoin::MergeJoin(
   if (joinNode->filter()) {
     initializeFilter(joinNode->filter(), leftType, rightType);
 
-    if (joinNode->isLeftJoin()) {
-      leftJoinTracker_ = LeftJoinTracker(outputBatchSize_, pool());
+    if (!joinNode->isInnerJoin()) {
+      joinTracker_ = JoinTracker(outputBatchSize_, pool());
     }
   }
+
+  if (!joinTracker_ && joinNode->canSpill(driverCtx->queryConfig())) {
+    // The spill type is not used as the matching rows are written to spill
+    // files directly.
+    spillConfig_ = operatorCtx_->makeSpillConfig(Spiller::Type::kOrderBy);
+  }
+}
+
+// static
+bool MergeJoin::isSupported(core::JoinType joinType) {
+  switch (joinType) {
+    case core::JoinType::kInner:
+    case core::JoinType::kLeft:
+    case core::JoinType::kRight:
+    case core::JoinType::kFull:
+    case core::JoinType::kLeftSemiFilter:
+    case core::JoinType::kAnti:
+      return true;
+    default:
+      return false;
+  }
 }
 
 void MergeJoin::initializeFilter(
@@ -132,8 +159,8 @@ void MergeJoin::addInput(RowVectorPtr input) {
   input_ = std::move(input);
   index_ = 0;
 
-  if (leftJoinTracker_) {
-    leftJoinTracker_->resetLastVector();
+  if (joinTracker_ && !isRightJoin(joinType_)) {
+    joinTracker_->resetLastVector();
   }
 }
 
@@ -156,6 +183,50 @@ int32_t MergeJoin::compare(
   return 0;
 }
 
+namespace {
+bool hasNullKeys(
+    const RowVectorPtr& rowVector,
+    const std::vector<column_index_t>& keys,
+    vector_size_t index) {
+  for (auto key : keys) {
+    if (rowVector->childAt(key)->isNullAt(index)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+vector_size_t firstNonNull(
+    const RowVectorPtr& rowVector,
+    const std::vector<column_index_t>& keys,
+    vector_size_t start = 0) {
+  for (auto i = start; i < rowVector->size(); ++i) {
+    if (!hasNullKeys(rowVector, keys, i)) {
+      return i;
+    }
+  }
+
+  return rowVector->size();
+}
+} // namespace
+
+int32_t MergeJoin::compare() const {
+  if (producesRightMisses() &&
+      hasNullKeys(rightInput_, rightKeys_, rightIndex_)) {
+    return 1;
+  }
+  return compare(
+      leftKeys_, input_, index_, rightKeys_, rightInput_, rightIndex_);
+}
+
+vector_size_t MergeJoin::nextRightIndex(vector_size_t start) const {
+  if (producesRightMisses()) {
+    // Rows with nulls in the join keys are added to the output as misses.
+    return start;
+  }
+  return firstNonNull(rightInput_, rightKeys_, start);
+}
+
 bool MergeJoin::findEndOfMatch(
     Match& match,
     const RowVectorPtr& input,
@@ -179,20 +250,128 @@ bool MergeJoin::findEndOfMatch(
     // Inputs are kept past getting a new batch of inputs. LazyVectors
     // must be loaded before advancing to the next batch.
     loadColumns(input, *operatorCtx_->execCtx());
-    match.inputs.push_back(input);
+    if (match.spilled()) {
+      spillRows(match, input, 0, endIndex);
+      match.inputs = {input};
+    } else {
+      match.inputs.push_back(input);
+      match.inputBytes += input->retainedSize();
+    }
     match.endIndex = endIndex;
+    maybeSpill(match);
     return false;
   }
 
   if (endIndex > 0) {
     // Match ends here, no need to pre-load lazies.
-    match.inputs.push_back(input);
+    if (match.spilled()) {
+      spillRows(match, input, 0, endIndex);
+      match.inputs = {input};
+    } else {
+      match.inputs.push_back(input);
+    }
     match.endIndex = endIndex;
   }
   match.complete = true;
   return true;
 }
 
+void MergeJoin::maybeSpill(Match& match) {
+  if (!spillConfig_.has_value() || match.spilled()) {
+    return;
+  }
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  const bool testSpill = spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct;
+  if (!testSpill &&
+      (spillMemoryThreshold_ == 0 ||
+       match.inputBytes <= spillMemoryThreshold_)) {
+    auto tracker = pool()->getMemoryUsageTracker();
+    if (tracker == nullptr || !tracker->highUsage()) {
+      return;
+    }
+  }
+
+  match.spill = std::make_unique<SpillFileList>(
+      asRowType(match.inputs[0]->type()),
+      0,
+      std::vector<CompareFlags>{},
+      spillConfig.filePath,
+      spillConfig.maxFileSize,
+      *pool(),
+      spillConfig.compressionKind,
+      spillConfig.directIo,
+      spillConfig.tiers);
+  for (size_t i = 0; i < match.inputs.size(); ++i) {
+    const auto& input = match.inputs[i];
+    spillRows(match, input, i == 0 ? match.startIndex : 0, input->size());
+  }
+  match.inputs = {match.inputs.back()};
+  match.inputBytes = 0;
+}
+
+void MergeJoin::spillRows(
+    Match& match,
+    const RowVectorPtr& input,
+    vector_size_t begin,
+    vector_size_t end) {
+  loadColumns(input, *operatorCtx_->execCtx());
+  IndexRange range{begin, end - begin};
+  match.spill->write(input, folly::Range<IndexRange*>(&range, 1));
+  stats_.wlock()->spilledRows += end - begin;
+}
+
+void MergeJoin::finishSpill(Match& match) {
+  if (!match.spilled() || !match.spillFiles.empty()) {
+    return;
+  }
+
+  const auto spilledBytes = match.spill->spilledBytes();
+  match.spillFiles = match.spill->files();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes += spilledBytes;
+  lockedStats->spilledFiles += match.spillFiles.size();
+  ++lockedStats->spilledPartitions;
+}
+
+bool MergeJoin::Match::nextBatch() {
+  if (!spilled()) {
+    if (nextBatchIndex == inputs.size()) {
+      batch = nullptr;
+      return false;
+    }
+    batch = inputs[nextBatchIndex];
+    batchStart = nextBatchIndex == 0 ? startIndex : 0;
+    batchEnd = nextBatchIndex == inputs.size() - 1 ? endIndex : batch->size();
+    ++nextBatchIndex;
+    return true;
+  }
+
+  while (nextBatchIndex < spillFiles.size()) {
+    if (spillFiles[nextBatchIndex]->nextBatch(batch)) {
+      batchStart = 0;
+      batchEnd = batch->size();
+      return true;
+    }
+    if (++nextBatchIndex < spillFiles.size()) {
+      spillFiles[nextBatchIndex]->startRead();
+    }
+  }
+  batch = nullptr;
+  return false;
+}
+
+void MergeJoin::Match::rewind() {
+  nextBatchIndex = 0;
+  batch = nullptr;
+  if (spilled()) {
+    spillFiles[0]->startRead();
+  }
+}
+
 namespace {
 void copyRow(
     const RowVectorPtr& source,
@@ -218,9 +397,27 @@ void MergeJoin::addOutputRowForLeftJoin(
     target->setNull(outputSize_, true);
   }
 
-  if (leftJoinTracker_) {
+  if (joinTracker_) {
     // Record left-side row with no match on the right side.
-    leftJoinTracker_->addMiss(outputSize_);
+    joinTracker_->addMiss(outputSize_);
+  }
+
+  ++outputSize_;
+}
+
+void MergeJoin::addOutputRowForRightJoin(
+    const RowVectorPtr& right,
+    vector_size_t rightIndex) {
+  copyRow(right, rightIndex, output_, outputSize_, rightProjections_);
+
+  for (const auto& projection : leftProjections_) {
+    const auto& target = output_->childAt(projection.outputChannel);
+    target->setNull(outputSize_, true);
+  }
+
+  if (joinTracker_) {
+    // Record right-side row with no match on the left side.
+    joinTracker_->addMiss(outputSize_);
   }
 
   ++outputSize_;
@@ -240,9 +437,13 @@ void MergeJoin::addOutputRow(
     copyRow(left, leftIndex, filterInput_, outputSize_, filterLeftInputs_);
     copyRow(right, rightIndex, filterInput_, outputSize_, filterRightInputs_);
 
-    if (leftJoinTracker_) {
-      // Record left-side row with a match on the right-side.
-      leftJoinTracker_->addMatch(left, leftIndex, outputSize_);
+    if (joinTracker_) {
+      // Record outer-side row with a match on the other side.
+      if (isRightJoin(joinType_)) {
+        joinTracker_->addMatch(right, rightIndex, outputSize_);
+      } else {
+        joinTracker_->addMatch(left, leftIndex, outputSize_);
+      }
     }
   }
 
@@ -251,6 +452,9 @@ void MergeJoin::addOutputRow(
 
 void MergeJoin::prepareOutput() {
   if (output_ == nullptr) {
+    if (filter_ == nullptr) {
+      outputBatchSize_ = adaptiveOutputBatchRows();
+    }
     std::vector<VectorPtr> localColumns(outputType_->size());
     for (auto i = 0; i < outputType_->size(); ++i) {
       localColumns[i] = BaseVector::create(
@@ -299,50 +503,56 @@ void MergeJoin::prepareOutput() {
   }
 }
 
-bool MergeJoin::addToOutput() {
-  prepareOutput();
+template <typename TAddRow>
+bool MergeJoin::addToOutput(Match& outer, Match& inner, TAddRow addRow) {
+  // A left semi join without a filter adds each left-side row only once.
+  const bool firstInnerRowOnly = isLeftSemiFilterJoin(joinType_) && !filter_;
 
-  size_t firstLeftBatch;
-  vector_size_t leftStartIndex;
-  if (leftMatch_->cursor) {
-    firstLeftBatch = leftMatch_->cursor->batchIndex;
-    leftStartIndex = leftMatch_->cursor->index;
+  size_t firstOuterBatch;
+  vector_size_t outerStartIndex;
+  if (outer.cursor) {
+    firstOuterBatch = outer.cursor->batchIndex;
+    outerStartIndex = outer.cursor->index;
   } else {
-    firstLeftBatch = 0;
-    leftStartIndex = leftMatch_->startIndex;
+    firstOuterBatch = 0;
+    outerStartIndex = outer.startIndex;
   }
 
-  size_t numLefts = leftMatch_->inputs.size();
-  for (size_t l = firstLeftBatch; l < numLefts; ++l) {
-    auto left = leftMatch_->inputs[l];
-    auto leftStart = l == firstLeftBatch ? leftStartIndex : 0;
-    auto leftEnd = l == numLefts - 1 ? leftMatch_->endIndex : left->size();
+  size_t numOuters = outer.inputs.size();
+  for (size_t o = firstOuterBatch; o < numOuters; ++o) {
+    const auto& outerBatch = outer.inputs[o];
+    auto outerStart = o == firstOuterBatch ? outerStartIndex : 0;
+    auto outerEnd = o == numOuters - 1 ? outer.endIndex : outerBatch->size();
 
-    for (auto i = leftStart; i < leftEnd; ++i) {
-      auto firstRightBatch =
-          (l == firstLeftBatch && i == leftStart && rightMatch_->cursor)
-          ? rightMatch_->cursor->batchIndex
+    for (auto i = outerStart; i < outerEnd; ++i) {
+      auto firstInnerBatch =
+          (o == firstOuterBatch && i == outerStart && inner.cursor)
+          ? inner.cursor->batchIndex
           : 0;
 
-      auto rightStartIndex =
-          (l == firstLeftBatch && i == leftStart && rightMatch_->cursor)
-          ? rightMatch_->cursor->index
-          : rightMatch_->startIndex;
-
-      auto numRights = rightMatch_->inputs.size();
-      for (size_t r = firstRightBatch; r < numRights; ++r) {
-        auto right = rightMatch_->inputs[r];
-        auto rightStart = r == firstRightBatch ? rightStartIndex : 0;
-        auto rightEnd =
-            r == numRights - 1 ? rightMatch_->endIndex : right->size();
+      auto innerStartIndex =
+          (o == firstOuterBatch && i == outerStart && inner.cursor)
+          ? inner.cursor->index
+          : inner.startIndex;
+
+      auto numInners = inner.inputs.size();
+      auto lastInnerBatch = firstInnerRowOnly ? firstInnerBatch : numInners - 1;
+      for (size_t r = firstInnerBatch; r <= lastInnerBatch; ++r) {
+        const auto& innerBatch = inner.inputs[r];
+        auto innerStart = r == firstInnerBatch ? innerStartIndex : 0;
+        auto innerEnd =
+            r == numInners - 1 ? inner.endIndex : innerBatch->size();
+        if (firstInnerRowOnly) {
+          innerEnd = innerStart + 1;
+        }
 
-        for (auto j = rightStart; j < rightEnd; ++j) {
+        for (auto j = innerStart; j < innerEnd; ++j) {
           if (outputSize_ == outputBatchSize_) {
-            leftMatch_->setCursor(l, i);
-            rightMatch_->setCursor(r, j);
+            outer.setCursor(o, i);
+            inner.setCursor(r, j);
             return true;
           }
-          addOutputRow(left, i, right, j);
+          addRow(outerBatch, i, innerBatch, j);
         }
       }
     }
@@ -354,27 +564,100 @@ bool MergeJoin::addToOutput() {
   return outputSize_ == outputBatchSize_;
 }
 
-namespace {
-vector_size_t firstNonNull(
-    const RowVectorPtr& rowVector,
-    const std::vector<column_index_t>& keys,
-    vector_size_t start = 0) {
-  for (auto i = start; i < rowVector->size(); ++i) {
-    bool hasNull = false;
-    for (auto key : keys) {
-      if (rowVector->childAt(key)->isNullAt(i)) {
-        hasNull = true;
+template <typename TAddRow>
+bool MergeJoin::addSpilledToOutput(Match& outer, Match& inner, TAddRow addRow) {
+  // A left semi join without a filter adds each left-side row only once.
+  const bool firstInnerRowOnly = isLeftSemiFilterJoin(joinType_) && !filter_;
+
+  if (!outer.cursor) {
+    outer.rewind();
+    outer.setCursor(0, 0);
+    inner.setCursor(0, 0);
+  }
+
+  for (;;) {
+    if (outer.batch == nullptr) {
+      if (!outer.nextBatch()) {
         break;
       }
+      inner.rewind();
     }
-    if (!hasNull) {
-      return i;
+
+    if (inner.batch == nullptr) {
+      if (!inner.nextBatch()) {
+        outer.batch = nullptr;
+        continue;
+      }
+      outer.cursor->index = outer.batchStart;
+      inner.cursor->index = inner.batchStart;
+    }
+
+    auto& i = outer.cursor->index;
+    auto& j = inner.cursor->index;
+    const auto innerEnd =
+        firstInnerRowOnly ? inner.batchStart + 1 : inner.batchEnd;
+    for (; i < outer.batchEnd; ++i) {
+      for (; j < innerEnd; ++j) {
+        if (outputSize_ == outputBatchSize_) {
+          return true;
+        }
+        addRow(outer.batch, i, inner.batch, j);
+      }
+      j = inner.batchStart;
+    }
+
+    inner.batch = nullptr;
+    if (firstInnerRowOnly) {
+      outer.batch = nullptr;
     }
   }
 
-  return rowVector->size();
+  leftMatch_.reset();
+  rightMatch_.reset();
+
+  return outputSize_ == outputBatchSize_;
+}
+
+bool MergeJoin::addToOutput() {
+  finishSpill(leftMatch_.value());
+  finishSpill(rightMatch_.value());
+
+  if (isAntiJoin(joinType_) && !filter_) {
+    // Left-side rows with a match are not included in the output.
+    leftMatch_.reset();
+    rightMatch_.reset();
+    return false;
+  }
+
+  prepareOutput();
+
+  auto addRightMajor = [&](const RowVectorPtr& right,
+                           vector_size_t rightIndex,
+                           const RowVectorPtr& left,
+                           vector_size_t leftIndex) {
+    addOutputRow(left, leftIndex, right, rightIndex);
+  };
+  auto addLeftMajor = [&](const RowVectorPtr& left,
+                          vector_size_t leftIndex,
+                          const RowVectorPtr& right,
+                          vector_size_t rightIndex) {
+    addOutputRow(left, leftIndex, right, rightIndex);
+  };
+
+  if (leftMatch_->spilled() || rightMatch_->spilled()) {
+    if (isRightJoin(joinType_)) {
+      return addSpilledToOutput(
+          rightMatch_.value(), leftMatch_.value(), addRightMajor);
+    }
+    return addSpilledToOutput(
+        leftMatch_.value(), rightMatch_.value(), addLeftMajor);
+  }
+
+  if (isRightJoin(joinType_)) {
+    return addToOutput(rightMatch_.value(), leftMatch_.value(), addRightMajor);
+  }
+  return addToOutput(leftMatch_.value(), rightMatch_.value(), addLeftMajor);
 }
-} // namespace
 
 RowVectorPtr MergeJoin::getOutput() {
   // Make sure to have is-blocked or needs-input as true if returning null
@@ -416,7 +699,10 @@ RowVectorPtr MergeJoin::getOutput() {
         }
 
         if (rightInput_) {
-          rightIndex_ = firstNonNull(rightInput_, rightKeys_);
+          if (joinTracker_ && isRightJoin(joinType_)) {
+            joinTracker_->resetLastVector();
+          }
+          rightIndex_ = nextRightIndex(0);
           if (rightIndex_ == rightInput_->size()) {
             // Ran out of rows on the right side.
             rightInput_ = nullptr;
@@ -475,8 +761,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
         return nullptr;
       }
       if (rightMatch_->inputs.back() == rightInput_) {
-        rightIndex_ =
-            firstNonNull(rightInput_, rightKeys_, rightMatch_->endIndex);
+        rightIndex_ = nextRightIndex(rightMatch_->endIndex);
         if (rightIndex_ == rightInput_->size()) {
           rightInput_ = nullptr;
         }
@@ -501,8 +786,11 @@ RowVectorPtr MergeJoin::doGetOutput() {
   }
 
   if (!input_ || !rightInput_) {
-    if (isLeftJoin(joinType_)) {
-      if (input_ && noMoreRightInput_) {
+    if (input_ && noMoreRightInput_) {
+      // The remaining left-side rows have no match.
+      if (!producesLeftMisses()) {
+        input_ = nullptr;
+      } else {
         prepareOutput();
         while (true) {
           if (outputSize_ == outputBatchSize_) {
@@ -519,21 +807,37 @@ RowVectorPtr MergeJoin::doGetOutput() {
           }
         }
       }
+    }
 
-      if (noMoreInput_ && output_) {
-        output_->resize(outputSize_);
-        return std::move(output_);
-      }
-    } else {
-      if (noMoreInput_ || noMoreRightInput_) {
-        if (output_) {
-          output_->resize(outputSize_);
+    if (rightInput_ && noMoreInput_ && producesRightMisses()) {
+      // The remaining right-side rows have no match.
+      prepareOutput();
+      while (true) {
+        if (outputSize_ == outputBatchSize_) {
           return std::move(output_);
         }
-        input_ = nullptr;
+
+        addOutputRowForRightJoin(rightInput_, rightIndex_);
+
+        ++rightIndex_;
+        if (rightIndex_ == rightInput_->size()) {
+          // Ran out of rows on the right side.
+          rightInput_ = nullptr;
+          return nullptr;
+        }
       }
     }
 
+    // Flush the output once the rows from neither side can be added to it.
+    const bool leftDone = noMoreInput_ && input_ == nullptr;
+    const bool rightDone = noMoreRightInput_ && rightInput_ == nullptr;
+    if (output_ &&
+        ((leftDone && (rightDone || !producesRightMisses())) ||
+         (rightDone && !producesLeftMisses()))) {
+      output_->resize(outputSize_);
+      return std::move(output_);
+    }
+
     return nullptr;
   }
 
@@ -544,7 +848,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
   for (;;) {
     // Catch up input_ with rightInput_.
     while (compareResult < 0) {
-      if (isLeftJoin(joinType_)) {
+      if (producesLeftMisses()) {
         prepareOutput();
 
         if (outputSize_ == outputBatchSize_) {
@@ -565,7 +869,17 @@ RowVectorPtr MergeJoin::doGetOutput() {
 
     // Catch up rightInput_ with input_.
     while (compareResult > 0) {
-      rightIndex_ = firstNonNull(rightInput_, rightKeys_, rightIndex_ + 1);
+      if (producesRightMisses()) {
+        prepareOutput();
+
+        if (outputSize_ == outputBatchSize_) {
+          return std::move(output_);
+        }
+
+        addOutputRowForRightJoin(rightInput_, rightIndex_);
+      }
+
+      rightIndex_ = nextRightIndex(rightIndex_ + 1);
       if (rightIndex_ == rightInput_->size()) {
         // Ran out of rows on the right side.
         rightInput_ = nullptr;
@@ -616,7 +930,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
       }
 
       index_ = endIndex;
-      rightIndex_ = firstNonNull(rightInput_, rightKeys_, endRightIndex);
+      rightIndex_ = nextRightIndex(endRightIndex);
       if (rightIndex_ == rightInput_->size()) {
         // Ran out of rows on the right side.
         rightInput_ = nullptr;
@@ -644,8 +958,8 @@ RowVectorPtr MergeJoin::applyFilter(const RowVectorPtr& output) {
   auto rawIndices = indices->asMutable<vector_size_t>();
   vector_size_t numPassed = 0;
 
-  if (leftJoinTracker_) {
-    const auto& filterRows = leftJoinTracker_->matchingRows(numRows);
+  if (joinTracker_) {
+    const auto& filterRows = joinTracker_->matchingRows(numRows);
 
     if (!filterRows.hasSelections()) {
       // No matches in the output, no need to evaluate the filter.
@@ -654,12 +968,19 @@ RowVectorPtr MergeJoin::applyFilter(const RowVectorPtr& output) {
 
     evaluateFilter(filterRows);
 
-    // If all matches for a given left-side row fail the filter, add a row to
-    // the output with nulls for the right-side columns.
+    // If all matches for a given outer-side row fail the filter, add a row to
+    // the output with nulls for the other side's columns. Left semi joins
+    // don't include such rows.
+    const auto& missProjections =
+        isRightJoin(joinType_) ? leftProjections_ : rightProjections_;
     auto onMiss = [&](auto row) {
+      if (isLeftSemiFilterJoin(joinType_)) {
+        return;
+      }
+
       rawIndices[numPassed++] = row;
 
-      for (auto& projection : rightProjections_) {
+      for (auto& projection : missProjections) {
         auto target = output->childAt(projection.outputChannel);
         target->setNull(row, true);
       }
@@ -670,20 +991,34 @@ RowVectorPtr MergeJoin::applyFilter(const RowVectorPtr& output) {
         const bool passed = !decodedFilterResult_.isNullAt(i) &&
             decodedFilterResult_.valueAt<bool>(i);
 
-        leftJoinTracker_->processFilterResult(i, passed, onMiss);
+        // Left semi joins add a left-side row for its first passing match.
+        // Anti joins add only the left-side rows with no passing match.
+        bool keep = passed;
+        if (isLeftSemiFilterJoin(joinType_)) {
+          keep = passed && !joinTracker_->passedBefore(i);
+        } else if (isAntiJoin(joinType_)) {
+          keep = false;
+        }
+
+        joinTracker_->processFilterResult(i, passed, onMiss);
 
-        if (passed) {
+        if (keep) {
           rawIndices[numPassed++] = i;
         }
       } else {
-        // This row doesn't have a match on the right side. Keep it
+        // This row doesn't have a match on the other side. Keep it
         // unconditionally.
         rawIndices[numPassed++] = i;
       }
     }
 
-    if (!leftMatch_) {
-      leftJoinTracker_->noMoreFilterResults(onMiss);
+    // The next batch of output continues with the matches of the last
+    // outer-side row if the output filled up in the middle of these.
+    const auto& innerMatch = isRightJoin(joinType_) ? leftMatch_ : rightMatch_;
+    if (!leftMatch_ ||
+        (innerMatch->cursor->batchIndex == 0 &&
+         innerMatch->cursor->index == innerMatch->startIndex)) {
+      joinTracker_->noMoreFilterResults(onMiss);
     }
   } else {
     filterRows_.resize(numRows);
@@ -721,6 +1056,11 @@ void MergeJoin::evaluateFilter(const SelectivityVector& rows) {
 }
 
 bool MergeJoin::isFinished() {
+  if (producesRightMisses()) {
+    // Right-side rows with no match are added after all the left-side rows.
+    return noMoreInput_ && input_ == nullptr && noMoreRightInput_ &&
+        rightInput_ == nullptr && output_ == nullptr;
+  }
   return noMoreInput_ && input_ == nullptr;
 }
 
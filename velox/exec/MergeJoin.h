@@ -16,6 +16,7 @@
 #pragma once
 #include "velox/exec/MergeSource.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
 
 namespace facebook::velox::exec {
 class MergeJoin : public Operator {
@@ -42,6 +43,10 @@ class MergeJoin : public Operator {
     Operator::close();
   }
 
+  /// Returns true if merge join supports the specified join type: inner, left,
+  /// right, full, left semi filter and anti joins.
+  static bool isSupported(core::JoinType joinType);
+
  private:
   // Sets up 'filter_' and related member variables.
   void initializeFilter(
@@ -60,10 +65,10 @@ class MergeJoin : public Operator {
       vector_size_t otherIndex);
 
   // Compare rows on the left and right at index_ and rightIndex_ respectively.
-  int32_t compare() const {
-    return compare(
-        leftKeys_, input_, index_, rightKeys_, rightInput_, rightIndex_);
-  }
+  // For right and full joins, a right-side row with nulls in the join keys
+  // compares greater than any left-side row as it doesn't match any row, but
+  // needs to be added to the output.
+  int32_t compare() const;
 
   // Compare two rows on the left: index_ and index.
   int32_t compareLeft(vector_size_t index) const {
@@ -134,6 +139,39 @@ class MergeJoin : public Operator {
     void setCursor(size_t batchIndex, vector_size_t index) {
       cursor = Cursor{batchIndex, index};
     }
+
+    /// Retained size of 'inputs'.
+    uint64_t inputBytes{0};
+
+    /// Set if the matching rows were spilled because they took too much
+    /// memory. All the matching rows are then written to 'spill' and 'inputs'
+    /// only holds the last batch of input to compare with the next batch.
+    std::unique_ptr<SpillFileList> spill;
+
+    /// The files with all the spilled matching rows. Set once the match is
+    /// complete.
+    SpillFiles spillFiles;
+
+    bool spilled() const {
+      return spill != nullptr;
+    }
+
+    /// The batch of matching rows returned by the last call to nextBatch().
+    /// The matching rows are in [batchStart, batchEnd).
+    RowVectorPtr batch;
+    vector_size_t batchStart{0};
+    vector_size_t batchEnd{0};
+
+    /// Index of the next batch in 'inputs' or of the spill file being read
+    /// by nextBatch().
+    size_t nextBatchIndex{0};
+
+    /// Sets 'batch' to the next batch of matching rows, from 'inputs' or from
+    /// 'spillFiles' if spilled. Returns false if there are no more rows.
+    bool nextBatch();
+
+    /// Positions nextBatch() at the first batch of matching rows.
+    void rewind();
   };
 
   /// Given a partial set of rows with matching keys (match) finds all rows from
@@ -147,6 +185,41 @@ class MergeJoin : public Operator {
       const RowVectorPtr& input,
       const std::vector<column_index_t>& keys);
 
+  /// Spills the rows of an incomplete 'match' if these take more memory than
+  /// allowed. Spilling is enabled only if the output rows for a set of
+  /// matching rows can be produced in any order, i.e. there is no
+  /// 'joinTracker_'.
+  void maybeSpill(Match& match);
+
+  /// Writes the rows of 'input' in [begin, end) to the spill files of 'match'.
+  void spillRows(
+      Match& match,
+      const RowVectorPtr& input,
+      vector_size_t begin,
+      vector_size_t end);
+
+  /// Finishes the spill files of a complete 'match' if it was spilled.
+  void finishSpill(Match& match);
+
+  /// Returns true if left-side rows with no match on the right side are
+  /// included in the output: left, full and anti joins.
+  bool producesLeftMisses() const {
+    return isLeftJoin(joinType_) || isFullJoin(joinType_) ||
+        isAntiJoin(joinType_);
+  }
+
+  /// Returns true if right-side rows with no match on the left side are
+  /// included in the output: right and full joins.
+  bool producesRightMisses() const {
+    return isRightJoin(joinType_) || isFullJoin(joinType_);
+  }
+
+  /// Returns the row number of the first row at or after 'start' in
+  /// 'rightInput_' to compare with the left side. Skips rows with nulls in the
+  /// join keys unless right-side rows with no match are included in the
+  /// output.
+  vector_size_t nextRightIndex(vector_size_t start) const;
+
   /// Initialize 'output_' vector using 'ouputType_' and 'outputBatchSize_' if
   /// it is null.
   void prepareOutput();
@@ -158,8 +231,30 @@ class MergeJoin : public Operator {
   // rightMatchCursor_ positions if these are set. Clears leftMatch_ and
   // rightMatch_ if all rows were added. Updates leftMatchCursor_ and
   // rightMatchCursor_ if output_ filled up before all rows were added.
+  //
+  // Right joins iterate over the right-side rows first, so that the output
+  // rows for a given right-side row are next to each other. Left semi joins
+  // without a filter add one row for each left-side row. Anti joins without
+  // a filter add no rows.
   bool addToOutput();
 
+  // Appends the cartesian product of 'outer' x 'inner' to output_ by calling
+  // 'addRow(outerBatch, outerIndex, innerBatch, innerIndex)' for each pair of
+  // rows, iterating over the 'inner' rows for each 'outer' row. Sets the
+  // cursors of both matches if output_ filled up before all the rows were
+  // added. Clears leftMatch_ and rightMatch_ if all rows were added.
+  template <typename TAddRow>
+  bool addToOutput(Match& outer, Match& inner, TAddRow addRow);
+
+  // Same as above if 'outer' or 'inner' was spilled. Adds the product of each
+  // batch of 'outer' rows with each batch of 'inner' rows in turn, so that
+  // the spilled rows are read back one batch at a time. Reads the 'inner'
+  // rows once for each batch of 'outer' rows. The cursors only mark that the
+  // output of the match is in progress, the position is kept in the 'batch'
+  // of each match and the 'index' of its cursor.
+  template <typename TAddRow>
+  bool addSpilledToOutput(Match& outer, Match& inner, TAddRow addRow);
+
   // Adds one row of output by copying values from left and right batches at the
   // specified rows. Advances outputSize_. Assumes that output_ has room.
   //
@@ -180,6 +275,13 @@ class MergeJoin : public Operator {
       const RowVectorPtr& left,
       vector_size_t leftIndex);
 
+  /// Adds one row of output for a right-side row with no left-side match.
+  /// Copies values from the 'rightIndex' row of 'right' and fills in nulls
+  /// for columns that correspond to the left side.
+  void addOutputRowForRightJoin(
+      const RowVectorPtr& right,
+      vector_size_t rightIndex);
+
   /// Evaluates join filter on 'filterInput_' and returns 'output' that contains
   /// a subset of rows on which the filter passed. Returns nullptr if no rows
   /// passed the filter.
@@ -189,9 +291,13 @@ class MergeJoin : public Operator {
   /// the result using 'decodedFilterResult_'.
   void evaluateFilter(const SelectivityVector& rows);
 
-  /// As we populate the results of the left join, we track whether a given
-  /// output row is a result of a match between left and right sides or a miss.
-  /// We use LeftJoinTracker::addMatch and addMiss methods for that.
+  /// As we populate the results of an outer, semi or anti join with a filter,
+  /// we track whether a given output row is a result of a match between left
+  /// and right sides or a miss. We use JoinTracker::addMatch and addMiss
+  /// methods for that. The tracker follows the rows of the side whose rows
+  /// with no match are included in the output: the left side for left and
+  /// anti joins, the right side for right joins. We refer to it as the outer
+  /// side. For left semi joins, it follows the left side.
   ///
   /// Once we have a batch of output, we evaluate the filter on a subset of rows
   /// which correspond to matches between left and right sides. There is no
@@ -199,36 +305,37 @@ class MergeJoin : public Operator {
   /// output regardless of whether filter passes or fails.
   ///
   /// We also track blocks of consecutive output rows that correspond to the
-  /// same left-side row. If the filter passes on at least one row in such a
+  /// same outer-side row. If the filter passes on at least one row in such a
   /// block, we keep the subset of passing rows. However, if the filter failed
   /// on all rows in such a block, we add one of these rows back and update
-  /// build-side columns to null.
-  struct LeftJoinTracker {
-    LeftJoinTracker(vector_size_t numRows, memory::MemoryPool* pool)
+  /// the other side's columns to null. Semi joins keep only the first passing
+  /// row of each block. Anti joins keep only the rows added back.
+  struct JoinTracker {
+    JoinTracker(vector_size_t numRows, memory::MemoryPool* pool)
         : matchingRows_{numRows, false} {
-      leftRowNumbers_ = AlignedBuffer::allocate<vector_size_t>(numRows, pool);
-      rawLeftRowNumbers_ = leftRowNumbers_->asMutable<vector_size_t>();
+      outerRowNumbers_ = AlignedBuffer::allocate<vector_size_t>(numRows, pool);
+      rawOuterRowNumbers_ = outerRowNumbers_->asMutable<vector_size_t>();
     }
 
-    /// Records a row of output that corresponds to a match between a left-side
-    /// row and a right-side row. Assigns synthetic number to uniquely identify
-    /// the corresponding left-side row. The caller must call addMatch or
-    /// addMiss method for each row of output in order, starting with the first
-    /// row.
+    /// Records a row of output that corresponds to a match between an
+    /// outer-side row and a row on the other side. Assigns synthetic number to
+    /// uniquely identify the corresponding outer-side row. The caller must call
+    /// addMatch or addMiss method for each row of output in order, starting
+    /// with the first row.
     void addMatch(
-        const VectorPtr& left,
-        vector_size_t leftIndex,
+        const VectorPtr& outer,
+        vector_size_t outerIndex,
         vector_size_t outputIndex) {
       matchingRows_.setValid(outputIndex, true);
 
-      if (lastVector_ != left || lastIndex_ != leftIndex) {
-        // New left-side row.
-        ++lastLeftRowNumber_;
-        lastVector_ = left;
-        lastIndex_ = leftIndex;
+      if (lastVector_ != outer || lastIndex_ != outerIndex) {
+        // New outer-side row.
+        ++lastOuterRowNumber_;
+        lastVector_ = outer;
+        lastIndex_ = outerIndex;
       }
 
-      rawLeftRowNumbers_[outputIndex] = lastLeftRowNumber_;
+      rawOuterRowNumbers_[outputIndex] = lastOuterRowNumber_;
     }
 
     /// Returns a subset of "match" rows in [0, numRows) range that were
@@ -239,17 +346,16 @@ class MergeJoin : public Operator {
       return matchingRows_;
     }
 
-    /// Records a row of output that corresponds to a left-side
-    /// row that has no match on the right-side. The caller must call addMatch
-    /// or addMiss method for each row of output in order, starting with the
-    /// first row.
+    /// Records a row of output that corresponds to an outer-side row that has
+    /// no match on the other side. The caller must call addMatch or addMiss
+    /// method for each row of output in order, starting with the first row.
     void addMiss(vector_size_t outputIndex) {
       matchingRows_.setValid(outputIndex, false);
       resetLastVector();
     }
 
-    /// Clear the left-side vector and index of the last added output row. The
-    /// left-side vector has been fully processed and is now available for
+    /// Clear the outer-side vector and index of the last added output row. The
+    /// outer-side vector has been fully processed and is now available for
     /// re-use, hence, need to make sure that new rows won't be confused with
     /// the old ones.
     void resetLastVector() {
@@ -257,23 +363,31 @@ class MergeJoin : public Operator {
       lastIndex_ = -1;
     }
 
+    /// Returns true if the filter passed on an earlier output row for the same
+    /// outer-side row as the 'outputIndex' row. Must be called before
+    /// 'processFilterResult' for 'outputIndex'.
+    bool passedBefore(vector_size_t outputIndex) const {
+      return currentRowPassed_ &&
+          rawOuterRowNumbers_[outputIndex] == currentOuterRowNumber_;
+    }
+
     /// Called for each row that the filter was evaluated on in order starting
     /// with the first row. Calls 'onMiss' if the filter failed on all output
-    /// rows that correspond to a single left-side row. Use
+    /// rows that correspond to a single outer-side row. Use
     /// 'noMoreFilterResults' to make sure 'onMiss' is called for the last
-    /// left-side row.
+    /// outer-side row.
     template <typename TOnMiss>
     void processFilterResult(
         vector_size_t outputIndex,
         bool passed,
         TOnMiss onMiss) {
-      auto rowNumber = rawLeftRowNumbers_[outputIndex];
-      if (currentLeftRowNumber_ != rowNumber) {
+      auto rowNumber = rawOuterRowNumbers_[outputIndex];
+      if (currentOuterRowNumber_ != rowNumber) {
         if (currentRow_ != -1 && !currentRowPassed_) {
           onMiss(currentRow_);
         }
         currentRow_ = outputIndex;
-        currentLeftRowNumber_ = rowNumber;
+        currentOuterRowNumber_ = rowNumber;
         currentRowPassed_ = false;
       } else {
         currentRow_ = outputIndex;
@@ -285,8 +399,8 @@ class MergeJoin : public Operator {
     }
 
     /// Called when all rows from the current output batch are processed and the
-    /// next batch of output will start with a new left-side row or there will
-    /// be no more batches. Calls 'onMiss' for the last left-side row if the
+    /// next batch of output will start with a new outer-side row or there will
+    /// be no more batches. Calls 'onMiss' for the last outer-side row if the
     /// filter failed for all matches of that row.
     template <typename TOnMiss>
     void noMoreFilterResults(TOnMiss onMiss) {
@@ -303,40 +417,43 @@ class MergeJoin : public Operator {
     /// keys. Used in filter evaluation.
     SelectivityVector matchingRows_;
 
-    /// The left-side vector and index of the last added row. Used to identify
-    /// the end of a block of output rows that correspond to the same left-side
-    /// row.
+    /// The outer-side vector and index of the last added row. Used to identify
+    /// the end of a block of output rows that correspond to the same
+    /// outer-side row.
     VectorPtr lastVector_{nullptr};
     vector_size_t lastIndex_{-1};
 
-    /// Synthetic numbers used to uniquely identify a left-side row. We cannot
-    /// use row number from the left-side vector because a given batch of output
-    /// may contains rows from multiple left-side batches. Only "match" rows
-    /// added via addMatch are being tracked. The values for "miss" rows are
-    /// not defined.
-    BufferPtr leftRowNumbers_;
-    vector_size_t* rawLeftRowNumbers_;
+    /// Synthetic numbers used to uniquely identify an outer-side row. We cannot
+    /// use row number from the outer-side vector because a given batch of
+    /// output may contains rows from multiple outer-side batches. Only "match"
+    /// rows added via addMatch are being tracked. The values for "miss" rows
+    /// are not defined.
+    BufferPtr outerRowNumbers_;
+    vector_size_t* rawOuterRowNumbers_;
 
     /// Synthetic number assigned to the last added "match" row or zero if
     /// no row has been added yet.
-    vector_size_t lastLeftRowNumber_{0};
+    vector_size_t lastOuterRowNumber_{0};
 
     /// Output index of the last output row for which filter result was
     /// recorded.
     vector_size_t currentRow_{-1};
 
     /// Synthetic number for the 'currentRow'.
-    vector_size_t currentLeftRowNumber_{-1};
+    vector_size_t currentOuterRowNumber_{-1};
 
     /// True if at least one row in a block of output rows corresponding a
-    /// single left-side row identified by 'currentRowNumber' passed the filter.
+    /// single outer-side row identified by 'currentOuterRowNumber' passed the
+    /// filter.
     bool currentRowPassed_{false};
   };
 
-  std::optional<LeftJoinTracker> leftJoinTracker_{std::nullopt};
+  std::optional<JoinTracker> joinTracker_{std::nullopt};
 
-  /// Maximum number of rows in the output batch.
-  const uint32_t outputBatchSize_;
+  /// Maximum number of rows in the output batch. Without a filter, adapted to
+  /// the size of the output rows before each output batch. With a filter, it
+  /// is fixed because 'joinTracker_' and 'filterInput_' are sized for it.
+  uint32_t outputBatchSize_;
 
   /// Type of join.
   const core::JoinType joinType_;
@@ -395,5 +512,16 @@ class MergeJoin : public Operator {
 
   /// True if all the right side data has been received.
   bool noMoreRightInput_{false};
+
+  /// The max memory that the rows of a match on one side can use before
+  /// spilling. If it is zero, then there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  /// The disk spilling related configs if spilling is enabled, otherwise null.
+  std::optional<Spiller::Config> spillConfig_;
+
+  /// Counts the batches added to matches and triggers spilling if folly hash
+  /// of this % 100 <= 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
 };
 } // namespace facebook::velox::exec
@@ -89,6 +89,16 @@ OperatorCtx::createConnectorQueryCtx(
     const std::string& connectorId,
     const std::string& planNodeId,
     memory::MemoryPool* connectorPool) const {
+  const auto& queryConfig = driverCtx_->task->queryCtx()->queryConfig();
+  std::string spillPath;
+  if (queryConfig.spillEnabled() &&
+      !driverCtx_->task->spillDirectory().empty()) {
+    spillPath = makeOperatorSpillPath(
+        driverCtx_->task->spillDirectory(),
+        driverCtx()->pipelineId,
+        driverCtx()->driverId,
+        operatorId_);
+  }
   return std::make_shared<connector::ConnectorQueryCtx>(
       pool_,
       connectorPool,
@@ -98,7 +108,9 @@ OperatorCtx::createConnectorQueryCtx(
       driverCtx_->task->queryCtx()->allocator(),
       taskId(),
       planNodeId,
-      driverCtx_->driverId);
+      driverCtx_->driverId,
+      std::move(spillPath),
+      driverCtx_->task->queryCtx()->spillExecutor());
 }
 
 std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
@@ -125,7 +137,11 @@ std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
           queryConfig.spillStartPartitionBit() +
               queryConfig.spillPartitionBits()),
       queryConfig.maxSpillLevel(),
-      queryConfig.testingSpillPct());
+      queryConfig.testingSpillPct(),
+      common::stringToCompressionKind(queryConfig.spillCompressionKind()),
+      queryConfig.maxSpillWriteParallelism(),
+      queryConfig.spillDirectIo(),
+      driverCtx_->task->spillTiers());
 }
 
 Operator::Operator(
@@ -157,6 +173,76 @@ Operator::Operator(
           return out.str();
         });
   }
+  if (auto* reclaimer =
+          dynamic_cast<Operator::MemoryReclaimer*>(pool()->reclaimer())) {
+    reclaimer->setOperator(this);
+  }
+}
+
+Operator::~Operator() {
+  if (auto* reclaimer =
+          dynamic_cast<Operator::MemoryReclaimer*>(pool()->reclaimer())) {
+    reclaimer->setOperator(nullptr);
+  }
+}
+
+// static
+std::shared_ptr<memory::MemoryReclaimer> Operator::MemoryReclaimer::create() {
+  return std::shared_ptr<memory::MemoryReclaimer>(new MemoryReclaimer());
+}
+
+void Operator::MemoryReclaimer::setOperator(Operator* op) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(op == nullptr || op_ == nullptr);
+  op_ = op;
+}
+
+bool Operator::MemoryReclaimer::canReclaimLocked() const {
+  if (op_ == nullptr || !op_->canReclaim()) {
+    return false;
+  }
+  const auto* driver = op_->operatorCtx_->driver();
+  return driver != nullptr && !driver->isOnThread();
+}
+
+bool Operator::MemoryReclaimer::canReclaim(
+    const memory::MemoryPool& /*unused*/) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return canReclaimLocked();
+}
+
+bool Operator::MemoryReclaimer::canReclaimWithoutSpill() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return canReclaimLocked() && op_->canReclaimWithoutSpill();
+}
+
+uint64_t Operator::MemoryReclaimer::reclaimableBytes(
+    const memory::MemoryPool& pool) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!canReclaimLocked()) {
+    return 0;
+  }
+  return pool.getCurrentBytes();
+}
+
+uint64_t Operator::MemoryReclaimer::reclaim(
+    memory::MemoryPool* pool,
+    uint64_t targetBytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!canReclaimLocked()) {
+    return 0;
+  }
+  VELOX_CHECK(
+      op_->operatorCtx_->task()->pauseRequested(),
+      "Can only reclaim memory from an operator with its task paused: {}",
+      op_->toString());
+  const auto usedBytes = pool->getCurrentBytes();
+  op_->reclaim(targetBytes);
+  if (pool->getMemoryUsageTracker() != nullptr) {
+    // Release the unused memory reservation back to the query memory pool.
+    pool->getMemoryUsageTracker()->release();
+  }
+  return std::max<int64_t>(0, usedBytes - pool->getCurrentBytes());
 }
 
 std::vector<std::unique_ptr<Operator::PlanNodeTranslator>>&
@@ -312,6 +398,27 @@ uint32_t Operator::outputBatchRows(
       queryConfig.preferredOutputBatchBytes() / rowSize, 1);
 }
 
+uint32_t Operator::adaptiveOutputBatchRows() const {
+  std::optional<uint64_t> averageRowSize;
+  {
+    auto lockedStats = stats_.rlock();
+    if (lockedStats->outputPositions > 0) {
+      averageRowSize = lockedStats->outputBytes / lockedStats->outputPositions;
+    }
+  }
+  return outputBatchRows(averageRowSize);
+}
+
+void Operator::recordPredictedPeak() {
+  const auto predictedPeakBytes =
+      pool()->getMemoryUsageTracker()->stats().predictedPeakBytes;
+  if (predictedPeakBytes > 0) {
+    addRuntimeStat(
+        "predictedPeakBytes",
+        RuntimeCounter(predictedPeakBytes, RuntimeCounter::Unit::kBytes));
+  }
+}
+
 void Operator::recordBlockingTime(uint64_t start, BlockingReason reason) {
   uint64_t now =
       std::chrono::duration_cast<std::chrono::microseconds>(
@@ -437,6 +544,7 @@ void OperatorStats::add(const OperatorStats& other) {
   spilledRows += other.spilledRows;
   spilledPartitions += other.spilledPartitions;
   spilledFiles += other.spilledFiles;
+  spillWriteTiming.add(other.spillWriteTiming);
 }
 
 void OperatorStats::clear() {
@@ -20,6 +20,7 @@
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Driver.h"
 #include "velox/exec/JoinBridge.h"
+#include "velox/exec/MemoryReclaimer.h"
 #include "velox/exec/Spiller.h"
 #include "velox/type/Filter.h"
 
@@ -140,6 +141,11 @@ struct OperatorStats {
   // Total current spilled files.
   uint32_t spilledFiles{0};
 
+  // The spill write timing. The wall time is spent by the driver thread on
+  // waiting for the spill writes. The cpu time is the total cpu time of the
+  // spill writes which might run in parallel on the spill executor.
+  CpuWallTiming spillWriteTiming;
+
   std::unordered_map<std::string, RuntimeMetric> runtimeStats;
 
   int numDrivers = 0;
@@ -297,7 +303,7 @@ class Operator : public BaseRuntimeStatWriter {
       std::string planNodeId,
       std::string operatorType);
 
-  virtual ~Operator() = default;
+  virtual ~Operator();
 
   // Returns true if 'this' can accept input. Not used if operator is a source
   // operator, e.g. the first operator in the pipeline.
@@ -338,6 +344,14 @@ class Operator : public BaseRuntimeStatWriter {
   // side is empty.
   virtual bool isFinished() = 0;
 
+  // Informs 'this' that the operators after it in the pipeline need no more
+  // of its output because one of them finished early, e.g. a Limit that
+  // produced all of its rows or a HashProbe over an empty build side. Sources
+  // stop reading, e.g. TableScan stops reading splits and Exchange closes its
+  // remote sources. The driver does not call getOutput() on 'this' after
+  // this. The default does nothing.
+  virtual void noMoreOutputNeeded() {}
+
   // Returns single-column dynamically generated filters to be pushed down to
   // upstream operators. Used to push down filters on join keys from broadcast
   // hash join into probe-side table scan. Can also be used to push down TopN
@@ -387,6 +401,58 @@ class Operator : public BaseRuntimeStatWriter {
     }
   }
 
+  /// Returns true if this operator can reclaim its used memory through
+  /// techniques such as disk spilling. It is invoked by the memory arbitrator
+  /// with the task paused.
+  virtual bool canReclaim() const {
+    return false;
+  }
+
+  /// Invoked by the memory arbitrator with the task paused to reclaim at least
+  /// 'targetBytes' of used memory from this operator. If 'targetBytes' is zero,
+  /// the operator reclaims all its reclaimable memory. It is only invoked if
+  /// canReclaim() returns true.
+  virtual void reclaim(uint64_t /*targetBytes*/) {}
+
+  /// Returns true if this operator reclaims memory without disk spilling, e.g.
+  /// a partial aggregation which flushes its accumulated groups to output. The
+  /// task memory reclaimer reclaims from such operators first as it is cheap.
+  virtual bool canReclaimWithoutSpill() const {
+    return false;
+  }
+
+  /// The memory reclaimer of an operator memory pool which reclaims memory
+  /// from the associated operator.
+  class MemoryReclaimer : public exec::MemoryReclaimer {
+   public:
+    static std::shared_ptr<memory::MemoryReclaimer> create();
+
+    /// Sets the operator to reclaim memory from. 'op' is null when the
+    /// operator is destroyed.
+    void setOperator(Operator* FOLLY_NULLABLE op);
+
+    bool canReclaim(const memory::MemoryPool& pool) const override;
+
+    uint64_t reclaimableBytes(const memory::MemoryPool& pool) const override;
+
+    uint64_t reclaim(memory::MemoryPool* pool, uint64_t targetBytes) override;
+
+    /// Returns true if memory can be reclaimed from the operator without disk
+    /// spilling.
+    bool canReclaimWithoutSpill() const;
+
+   private:
+    MemoryReclaimer() = default;
+
+    // Returns true if memory can be reclaimed from 'op_'. An operator can't be
+    // reclaimed if its driver is on thread, e.g. suspended in the middle of a
+    // memory allocation.
+    bool canReclaimLocked() const;
+
+    mutable std::mutex mutex_;
+    Operator* FOLLY_NULLABLE op_{nullptr};
+  };
+
   // Returns true if 'this' never has more output rows than input rows.
   virtual bool isFilter() const {
     return false;
@@ -429,6 +495,10 @@ class Operator : public BaseRuntimeStatWriter {
     return operatorCtx_->operatorId();
   }
 
+  const OperatorCtx* operatorCtx() const {
+    return operatorCtx_.get();
+  }
+
   const std::string& operatorType() const {
     return operatorCtx_->operatorType();
   }
@@ -476,6 +546,12 @@ class Operator : public BaseRuntimeStatWriter {
   // 'identityProjections_' and 'resultProjections_'.
   RowVectorPtr fillOutput(vector_size_t size, BufferPtr mapping);
 
+  // Adds the largest peak memory usage predicted by the operator with
+  // MemoryUsageTracker::reservePredictedPeak() as the 'predictedPeakBytes'
+  // runtime stat, to compare with the actual peak in the memory stats. No-op
+  // if no peak was predicted.
+  void recordPredictedPeak();
+
   // Returns the number of rows for the output batch. This uses averageRowSize
   // to calculate how many rows fit in preferredOutputBatchBytes. It caps the
   // number of rows at 10K and returns at least one row. The averageRowSize must
@@ -485,6 +561,12 @@ class Operator : public BaseRuntimeStatWriter {
   uint32_t outputBatchRows(
       std::optional<uint64_t> averageRowSize = std::nullopt) const;
 
+  // Returns the number of rows for the next output batch based on the average
+  // size of the rows this operator has produced so far, so that the batches
+  // stay close to preferredOutputBatchBytes however wide the rows are. Returns
+  // preferredOutputBatchRows before the first output.
+  uint32_t adaptiveOutputBatchRows() const;
+
   std::unique_ptr<OperatorCtx> operatorCtx_;
   folly::Synchronized<OperatorStats> stats_;
   const RowTypePtr outputType_;
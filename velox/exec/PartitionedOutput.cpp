@@ -27,13 +27,18 @@ BlockingReason Destination::advance(
     const std::function<void()>& bufferReleaseFn,
     bool* atEnd,
     ContinueFuture* future) {
+  uint32_t adjustedMaxBytes = std::max(
+      PartitionedOutput::kMinDestinationSize,
+      (maxBytes * targetSizePct_) / 100);
   if (row_ >= rows_.size()) {
     *atEnd = true;
+    // Rows appended by scatter are flushed once there are enough of them.
+    if (bytesInCurrent_ >= adjustedMaxBytes ||
+        scatteredRows_ >= targetNumRows_) {
+      return flush(bufferManager, bufferReleaseFn, future);
+    }
     return BlockingReason::kNotBlocked;
   }
-  uint32_t adjustedMaxBytes = std::max(
-      PartitionedOutput::kMinDestinationSize,
-      (maxBytes * targetSizePct_) / 100);
   if (bytesInCurrent_ >= adjustedMaxBytes) {
     return flush(bufferManager, bufferReleaseFn, future);
   }
@@ -64,17 +69,34 @@ void Destination::serialize(
     vector_size_t begin,
     vector_size_t end) {
   if (!current_) {
-    current_ = std::make_unique<VectorStreamGroup>(pool_);
-    auto rowType = std::dynamic_pointer_cast<const RowType>(output->type());
     vector_size_t numRows = 0;
     for (vector_size_t i = begin; i < end; i++) {
       numRows += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
+    createStreamTree(asRowType(output->type()), numRows);
   }
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
 
+VectorStreamGroup* Destination::prepareScatter(
+    const RowTypePtr& type,
+    vector_size_t numRows,
+    uint64_t numBytes) {
+  if (!current_) {
+    createStreamTree(type, numRows);
+  }
+  scatteredRows_ += numRows;
+  bytesInCurrent_ += numBytes;
+  return current_.get();
+}
+
+void Destination::createStreamTree(
+    const RowTypePtr& type,
+    vector_size_t numRows) {
+  current_ = std::make_unique<VectorStreamGroup>(pool_);
+  current_->createStreamTree(type, numRows, serdeOptions_);
+}
+
 BlockingReason Destination::flush(
     PartitionedOutputBufferManager& bufferManager,
     const std::function<void()>& bufferReleaseFn,
@@ -92,6 +114,7 @@ BlockingReason Destination::flush(
   current_->flush(&stream);
   current_.reset();
   bytesInCurrent_ = 0;
+  scatteredRows_ = 0;
   setTargetSizePct();
 
   return bufferManager.enqueue(
@@ -101,6 +124,15 @@ BlockingReason Destination::flush(
       future);
 }
 
+// static
+serializer::presto::PrestoVectorSerde::PrestoOptions
+PartitionedOutput::serdeOptions(const core::QueryConfig& config) {
+  serializer::presto::PrestoVectorSerde::PrestoOptions options(
+      false, common::stringToCompressionKind(config.exchangeCompressionKind()));
+  options.preserveEncodings = config.exchangePreserveEncodings();
+  return options;
+}
+
 PartitionedOutput::PartitionedOutput(
     int32_t operatorId,
     DriverCtx* FOLLY_NONNULL ctx,
@@ -130,7 +162,8 @@ PartitionedOutput::PartitionedOutput(
       bufferReleaseFn_([task = operatorCtx_->task()]() {}),
       maxBufferedBytes_(ctx->task->queryCtx()
                             ->queryConfig()
-                            .maxPartitionedOutputBufferSize()) {
+                            .maxPartitionedOutputBufferSize()),
+      serdeOptions_(serdeOptions(ctx->task->queryCtx()->queryConfig())) {
   if (numDestinations_ == 1 || planNode->isBroadcast()) {
     VELOX_CHECK(keyChannels_.empty());
     VELOX_CHECK_NULL(partitionFunction_);
@@ -162,7 +195,8 @@ void PartitionedOutput::initializeDestinations() {
   if (destinations_.empty()) {
     auto taskId = operatorCtx_->taskId();
     for (int i = 0; i < numDestinations_; ++i) {
-      destinations_.push_back(std::make_unique<Destination>(taskId, i, pool()));
+      destinations_.push_back(
+          std::make_unique<Destination>(taskId, i, pool(), &serdeOptions_));
     }
   }
 }
@@ -240,6 +274,8 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
           destinations_[partitions_[i]]->addRow(i);
         }
       }
+    } else if (numInput < numDestinations_ * kMaxScatterRowsPerDestination) {
+      scatterInput();
     } else {
       for (vector_size_t i = 0; i < numInput; ++i) {
         destinations_[partitions_[i]]->addRow(i);
@@ -248,6 +284,28 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
   }
 }
 
+void PartitionedOutput::scatterInput() {
+  const auto numInput = output_->size();
+  partitionSizes_.assign(numDestinations_, 0);
+  partitionBytes_.assign(numDestinations_, 0);
+  for (vector_size_t i = 0; i < numInput; ++i) {
+    ++partitionSizes_[partitions_[i]];
+    partitionBytes_[partitions_[i]] += rowSize_[i];
+  }
+  const auto rowType = asRowType(output_->type());
+  scatterGroups_.resize(numDestinations_);
+  for (auto i = 0; i < numDestinations_; ++i) {
+    scatterGroups_[i] = partitionSizes_[i] == 0
+        ? nullptr
+        : destinations_[i]->prepareScatter(
+              rowType, partitionSizes_[i], partitionBytes_[i]);
+  }
+  VectorStreamGroup::scatter(
+      output_,
+      partitions_.data(),
+      folly::Range(scatterGroups_.data(), scatterGroups_.size()));
+}
+
 void PartitionedOutput::collectNullRows() {
   auto size = input_->size();
   rows_.resize(size);
@@ -282,6 +340,17 @@ RowVectorPtr PartitionedOutput::getOutput() {
   VELOX_CHECK_NOT_NULL(
       bufferManager, "PartitionedOutputBufferManager was already destructed");
 
+  // All the consumers may have deleted their results before the end of the
+  // input, e.g. after a Limit. Their data would be dropped, so we finish and
+  // the driver stops the operators that feed 'this'.
+  if (!noMoreInput_ &&
+      bufferManager->isFinished(operatorCtx_->task()->taskId())) {
+    finished_ = true;
+    input_ = nullptr;
+    output_ = nullptr;
+    return nullptr;
+  }
+
   bool workLeft;
   do {
     workLeft = false;
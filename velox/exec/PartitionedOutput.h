@@ -18,17 +18,23 @@
 #include <folly/Random.h>
 #include "velox/exec/Operator.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/serializers/PrestoSerializer.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
 
 class Destination {
  public:
+  // 'serdeOptions' must outlive 'this'.
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MemoryPool* FOLLY_NONNULL pool)
-      : taskId_(taskId), destination_(destination), pool_(pool) {
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      const VectorSerde::Options* FOLLY_NULLABLE serdeOptions = nullptr)
+      : taskId_(taskId),
+        destination_(destination),
+        pool_(pool),
+        serdeOptions_(serdeOptions) {
     setTargetSizePct();
   }
 
@@ -46,6 +52,13 @@ class Destination {
     rows_.push_back(rows);
   }
 
+  // Returns the stream group to which PartitionedOutput::scatterInput()
+  // appends 'numRows' rows of 'type' with an estimated size of 'numBytes'.
+  VectorStreamGroup* FOLLY_NONNULL prepareScatter(
+      const RowTypePtr& type,
+      vector_size_t numRows,
+      uint64_t numBytes);
+
   BlockingReason advance(
       uint64_t maxBytes,
       const std::vector<vector_size_t>& sizes,
@@ -76,6 +89,8 @@ class Destination {
   void
   serialize(const RowVectorPtr& input, vector_size_t begin, vector_size_t end);
 
+  void createStreamTree(const RowTypePtr& type, vector_size_t numRows);
+
   // Sets the next target size for flushing. This is called at the
   // start of each batch of output for the destination. The effect is
   // to make different destinations ready at slightly different times
@@ -92,7 +107,10 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MemoryPool* FOLLY_NONNULL const pool_;
+  const VectorSerde::Options* FOLLY_NULLABLE const serdeOptions_;
   uint64_t bytesInCurrent_{0};
+  // Number of rows appended to 'current_' by scatter.
+  vector_size_t scatteredRows_{0};
   std::vector<IndexRange> rows_;
 
   // First row of 'rows_' that is not appended to 'current_'
@@ -128,11 +146,24 @@ class PartitionedOutput : public Operator {
   // network MTU of 64K.
   static constexpr uint64_t kMinDestinationSize = 60 * 1024;
 
+  // An input batch is scattered to the destinations in one pass over its
+  // columns if it has fewer than this many rows per destination on average.
+  // Appending the rows of each destination separately has a per column and
+  // per destination cost that dominates when the destinations get a few rows
+  // each. A scattered batch is not split between pages of a destination.
+  static constexpr vector_size_t kMaxScatterRowsPerDestination = 64;
+
   PartitionedOutput(
       int32_t operatorId,
       DriverCtx* FOLLY_NONNULL ctx,
       const std::shared_ptr<const core::PartitionedOutputNode>& planNode);
 
+  // Returns the options for serializing the output pages with the exchange
+  // compression and encoding settings of 'config'. Also used by ShuffleWrite,
+  // which writes pages in the same format.
+  static serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions(
+      const core::QueryConfig& config);
+
   void addInput(RowVectorPtr input) override;
 
   // Always returns nullptr. The action is to further process
@@ -173,6 +204,10 @@ class PartitionedOutput : public Operator {
   /// Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
+  // Appends the rows of 'output_' to the destinations in 'partitions_' with
+  // VectorStreamGroup::scatter().
+  void scatterInput();
+
   const std::vector<column_index_t> keyChannels_;
   const int numDestinations_;
   const bool replicateNullsAndAny_;
@@ -183,6 +218,9 @@ class PartitionedOutput : public Operator {
   const std::function<void()> bufferReleaseFn_;
   const int64_t maxBufferedBytes_;
 
+  // Options for serializing the pages, e.g. the compression codec.
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
+
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
   ContinueFuture future_;
   bool finished_{false};
@@ -201,6 +239,9 @@ class PartitionedOutput : public Operator {
   SelectivityVector nullRows_;
   std::vector<uint32_t> partitions_;
   std::vector<DecodedVector> decodedVectors_;
+  std::vector<vector_size_t> partitionSizes_;
+  std::vector<uint64_t> partitionBytes_;
+  std::vector<VectorStreamGroup*> scatterGroups_;
 };
 
 } // namespace facebook::velox::exec
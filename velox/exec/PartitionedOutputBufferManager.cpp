@@ -15,9 +15,91 @@
  */
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include <velox/exec/Exchange.h>
+#include "velox/common/file/FileSystems.h"
 
 namespace facebook::velox::exec {
 
+OutputBufferSpillFile::~OutputBufferSpillFile() {
+  input_.reset();
+  output_.reset();
+  if (size_ == 0) {
+    return;
+  }
+  try {
+    auto fs = filesystems::getFileSystem(path_, nullptr);
+    fs->remove(path_);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to remove output buffer spill file '" << path_
+               << "': " << e.what();
+  }
+}
+
+OutputBufferSpillFile::Page OutputBufferSpillFile::write(
+    const SerializedPage& page) {
+  if (!output_) {
+    auto fs = filesystems::getFileSystem(path_, nullptr);
+    output_ = fs->openFileForWrite(path_);
+  }
+  Page result{size_, page.size()};
+  auto iobuf = page.getIOBuf();
+  for (auto& range : *iobuf) {
+    output_->append(std::string_view(
+        reinterpret_cast<const char*>(range.data()), range.size()));
+  }
+  size_ += result.size;
+  return result;
+}
+
+std::unique_ptr<SerializedPage> OutputBufferSpillFile::read(const Page& page) {
+  VELOX_CHECK_LE(page.offset + page.size, size_);
+  if (page.offset + page.size > flushedSize_) {
+    output_->flush();
+    flushedSize_ = size_;
+  }
+  if (!input_) {
+    auto fs = filesystems::getFileSystem(path_, nullptr);
+    input_ = fs->openFileForRead(path_);
+  }
+  auto iobuf = folly::IOBuf::create(page.size);
+  input_->pread(page.offset, page.size, iobuf->writableData());
+  iobuf->append(page.size);
+  return std::make_unique<SerializedPage>(std::move(iobuf));
+}
+
+void DestinationBuffer::spill(
+    const SerializedPage& data,
+    OutputBufferSpillFile& spillFile) {
+  VELOX_CHECK(
+      spillFile_ == nullptr || spillFile_ == &spillFile,
+      "Destination buffer spills to more than one file");
+  VELOX_CHECK(!endAfterSpilled_, "Data page spilled after the end marker");
+  spillFile_ = &spillFile;
+  spilled_.push_back(spillFile.write(data));
+}
+
+void DestinationBuffer::loadSpilled(uint64_t maxBytes, int64_t sequence) {
+  const auto first = sequence - sequence_;
+  uint64_t bytes = 0;
+  for (auto i = first; i < data_.size(); ++i) {
+    if (data_[i]) {
+      bytes += data_[i]->size();
+    }
+  }
+  while (!spilled_.empty() && (first >= data_.size() || bytes < maxBytes)) {
+    auto page = spillFile_->read(spilled_.front());
+    spilled_.pop_front();
+    unspilledBytes_ += page->size();
+    data_.push_back(std::move(page));
+    if (first < data_.size()) {
+      bytes += data_.back()->size();
+    }
+  }
+  if (spilled_.empty() && endAfterSpilled_) {
+    endAfterSpilled_ = false;
+    data_.push_back(nullptr);
+  }
+}
+
 std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
     uint64_t maxBytes,
     int64_t sequence,
@@ -25,6 +107,10 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
   VELOX_CHECK_GE(
       sequence, sequence_, "Get received for an already acknowledged item");
 
+  if (!spilled_.empty()) {
+    loadSpilled(maxBytes, sequence);
+  }
+
   if (sequence - sequence_ > data_.size()) {
     VLOG(0) << this << " Out of order get: " << sequence << " over "
             << sequence_ << " Setting second notify " << notifySequence_
@@ -120,12 +206,15 @@ DestinationBuffer::deleteResults() {
     freed.push_back(std::move(data_[i]));
   }
   data_.clear();
+  spilled_.clear();
+  endAfterSpilled_ = false;
   return freed;
 }
 
 std::string DestinationBuffer::toString() {
   std::stringstream out;
   out << "[available: " << data_.size() << ", "
+      << "spilled: " << spilled_.size() << ", "
       << "sequence: " << sequence_ << ", "
       << (notify_ ? "notify registered, " : "") << this << "]";
   return out.str();
@@ -153,6 +242,9 @@ PartitionedOutputBuffer::PartitionedOutputBuffer(
     uint32_t numDrivers)
     : task_(std::move(task)),
       broadcast_(broadcast),
+      spillEnabled_(
+          !broadcast_ && task_->queryCtx()->queryConfig().spillEnabled() &&
+          task_->queryCtx()->queryConfig().partitionedOutputSpillEnabled()),
       numDrivers_(numDrivers),
       maxSize_(
           task_->queryCtx()->queryConfig().maxPartitionedOutputBufferSize()),
@@ -207,6 +299,15 @@ void PartitionedOutputBuffer::updateNumDrivers(uint32_t newNumDrivers) {
   }
 }
 
+bool PartitionedOutputBuffer::addDriver() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (atEnd_) {
+    return false;
+  }
+  ++numDrivers_;
+  return true;
+}
+
 void PartitionedOutputBuffer::addBroadcastOutputBuffersLocked(int numBuffers) {
   VELOX_CHECK(!noMoreBroadcastBuffers_)
   buffers_.reserve(numBuffers);
@@ -235,6 +336,9 @@ BlockingReason PartitionedOutputBuffer::enqueue(
     std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK_LT(destination, buffers_.size());
 
+    // True if 'data' went to the spill file instead of memory.
+    bool spilled = false;
+
     totalSize_ += data->size();
     if (broadcast_) {
       std::shared_ptr<SerializedPage> sharedData(data.release());
@@ -250,8 +354,15 @@ BlockingReason PartitionedOutputBuffer::enqueue(
       }
     } else {
       if (auto buffer = buffers_[destination].get()) {
-        buffer->enqueue(std::move(data));
+        if (shouldSpillLocked(*buffer, *data)) {
+          totalSize_ -= data->size();
+          spillLocked(*buffer, *data);
+          spilled = true;
+        } else {
+          buffer->enqueue(std::move(data));
+        }
         dataAvailableCallbacks.emplace_back(buffer->getAndClearNotify());
+        totalSize_ += buffer->takeUnspilledBytes();
       } else {
         // Some downstream tasks may finish early and delete the
         // corresponding buffers. Further data for these buffers is dropped.
@@ -259,7 +370,9 @@ BlockingReason PartitionedOutputBuffer::enqueue(
       }
     }
 
-    if (totalSize_ > maxSize_ && future) {
+    // A producer whose page could not be spilled, e.g. because the task has
+    // no spill directory, is blocked like without spilling.
+    if (totalSize_ > maxSize_ && !spilled && future) {
       promises_.emplace_back("PartitionedOutputBuffer::enqueue");
       *future = promises_.back().getSemiFuture();
       blocked = true;
@@ -275,6 +388,28 @@ BlockingReason PartitionedOutputBuffer::enqueue(
                  : BlockingReason::kNotBlocked;
 }
 
+bool PartitionedOutputBuffer::shouldSpillLocked(
+    const DestinationBuffer& buffer,
+    const SerializedPage& data) const {
+  if (!spillEnabled_ || task_->spillDirectory().empty()) {
+    return false;
+  }
+  // Once a destination has spilled pages, the following pages are spilled as
+  // well to keep them in order.
+  return buffer.hasSpilled() || totalSize_ > maxSize_;
+}
+
+void PartitionedOutputBuffer::spillLocked(
+    DestinationBuffer& buffer,
+    const SerializedPage& data) {
+  if (!spillFile_) {
+    spillFile_ = std::make_unique<OutputBufferSpillFile>(
+        fmt::format("{}/partitioned_output", task_->spillDirectory()));
+  }
+  buffer.spill(data, *spillFile_);
+  ++numSpilledPages_;
+}
+
 void PartitionedOutputBuffer::noMoreData() {
   checkIfDone(true); // Increment number of finished drivers.
 }
@@ -300,6 +435,7 @@ void PartitionedOutputBuffer::checkIfDone(bool oneDriverFinished) {
         if (buffer) {
           buffer->enqueue(nullptr);
           finished.push_back(buffer->getAndClearNotify());
+          totalSize_ += buffer->takeUnspilledBytes();
         }
       }
     }
@@ -431,6 +567,7 @@ void PartitionedOutputBuffer::getData(
     freed = destinationBuffer->acknowledge(sequence, true);
     updateAfterAcknowledgeLocked(freed, promises);
     data = destinationBuffer->getData(maxBytes, sequence, notify);
+    totalSize_ += destinationBuffer->takeUnspilledBytes();
   }
   releaseAfterAcknowledge(freed, promises);
   if (!data.empty()) {
@@ -456,7 +593,9 @@ std::string PartitionedOutputBuffer::toString() {
   std::stringstream out;
   out << "[PartitionedOutputBuffer totalSize_=" << totalSize_
       << "b, num producers blocked=" << promises_.size()
-      << ", completed=" << numFinished_ << "/" << numDrivers_ << ", "
+      << ", completed=" << numFinished_ << "/" << numDrivers_
+      << ", spilled pages=" << numSpilledPages_ << " ("
+      << (spillFile_ ? spillFile_->size() : 0) << "b), "
       << (atEnd_ ? "at end, " : "") << "destinations: " << std::endl;
   for (auto i = 0; i < buffers_.size(); ++i) {
     auto buffer = buffers_[i].get();
@@ -587,6 +726,13 @@ void PartitionedOutputBufferManager::updateNumDrivers(
   getBuffer(taskId)->updateNumDrivers(newNumDrivers);
 }
 
+bool PartitionedOutputBufferManager::addDriver(const std::string& taskId) {
+  if (auto buffer = getBufferIfExists(taskId)) {
+    return buffer->addDriver();
+  }
+  return false;
+}
+
 void PartitionedOutputBufferManager::removeTask(const std::string& taskId) {
   auto buffer = buffers_.withLock(
       [&](auto& buffers) -> std::shared_ptr<PartitionedOutputBuffer> {
@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <deque>
+
+#include "velox/common/file/File.h"
 #include "velox/exec/Exchange.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Task.h"
@@ -40,9 +43,57 @@ struct DataAvailable {
   }
 };
 
+/// Spill file shared by the destinations of a PartitionedOutputBuffer. Pages
+/// that do not fit in the buffer are appended to the file and read back when
+/// their destination fetches them. The file is removed on destruction.
+class OutputBufferSpillFile {
+ public:
+  /// Location of a page in the file.
+  struct Page {
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  explicit OutputBufferSpillFile(std::string path) : path_(std::move(path)) {}
+
+  ~OutputBufferSpillFile();
+
+  /// Appends 'page' to the file and returns its location.
+  Page write(const SerializedPage& page);
+
+  /// Reads back a page previously returned by write().
+  std::unique_ptr<SerializedPage> read(const Page& page);
+
+  const std::string& path() const {
+    return path_;
+  }
+
+  /// Returns the number of bytes written to the file.
+  uint64_t size() const {
+    return size_;
+  }
+
+ private:
+  const std::string path_;
+  std::unique_ptr<WriteFile> output_;
+  std::unique_ptr<ReadFile> input_;
+  // Bytes appended to 'output_'.
+  uint64_t size_{0};
+  // Bytes of 'output_' that are flushed and visible to 'input_'.
+  uint64_t flushedSize_{0};
+};
+
 class DestinationBuffer {
  public:
   void enqueue(std::shared_ptr<SerializedPage> data) {
+    // Pages that arrive after a spilled page are spilled as well, so that
+    // the end marker is the only thing that can follow spilled pages.
+    if (!spilled_.empty()) {
+      VELOX_CHECK_NULL(data, "Data page enqueued after spilled pages");
+      endAfterSpilled_ = true;
+      return;
+    }
+
     // drop duplicate end markers
     if (data == nullptr && !data_.empty() && data_.back() == nullptr) {
       return;
@@ -51,6 +102,22 @@ class DestinationBuffer {
     data_.push_back(std::move(data));
   }
 
+  // Writes 'data' to 'spillFile' instead of keeping it in memory. The page is
+  // read back when a getData() reaches it.
+  void spill(const SerializedPage& data, OutputBufferSpillFile& spillFile);
+
+  // Returns true if there are pages in the spill file that are not yet read
+  // back.
+  bool hasSpilled() const {
+    return !spilled_.empty();
+  }
+
+  // Returns and clears the number of bytes read back from the spill file into
+  // memory since the last call.
+  uint64_t takeUnspilledBytes() {
+    return std::exchange(unspilledBytes_, 0);
+  }
+
   // Returns a shallow copy (folly::IOBuf::clone) of the data starting at
   // 'sequence', stopping after exceeding 'maxBytes'. If there is no data,
   // 'notify' is installed so that this gets called when data is added.
@@ -75,6 +142,10 @@ class DestinationBuffer {
   std::string toString();
 
  private:
+  // Reads spilled pages back into 'data_' until the pages from 'sequence' on
+  // cover 'maxBytes' or there are no more spilled pages.
+  void loadSpilled(uint64_t maxBytes, int64_t sequence);
+
   std::vector<std::shared_ptr<SerializedPage>> data_;
   // The sequence number of the first in 'data_'.
   int64_t sequence_ = 0;
@@ -82,6 +153,15 @@ class DestinationBuffer {
   // The sequence number of the first item to pass to 'notify'.
   int64_t notifySequence_;
   uint64_t notifyMaxBytes_;
+
+  // Pages in 'spillFile_' that logically follow 'data_', in order.
+  std::deque<OutputBufferSpillFile::Page> spilled_;
+  OutputBufferSpillFile* spillFile_{nullptr};
+  // True if the end marker was enqueued while there were spilled pages. The
+  // marker is added to 'data_' after the last spilled page is read back.
+  bool endAfterSpilled_{false};
+  // Bytes read back from 'spillFile_', see takeUnspilledBytes().
+  uint64_t unspilledBytes_{0};
 };
 
 class PartitionedOutputBuffer {
@@ -101,6 +181,11 @@ class PartitionedOutputBuffer {
   /// only), we need to update the number of producing drivers here.
   void updateNumDrivers(uint32_t newNumDrivers);
 
+  /// Registers one more producing driver while the task runs, e.g. a Driver
+  /// that the Task adds to the output pipeline. Returns false if all drivers
+  /// have finished and the buffers are at end.
+  bool addDriver();
+
   BlockingReason enqueue(
       int destination,
       std::unique_ptr<SerializedPage> data,
@@ -154,13 +239,28 @@ class PartitionedOutputBuffer {
   /// and enqueue data that has been produced so far (e.g. dataToBroadcast_).
   void addBroadcastOutputBuffersLocked(int numBuffers);
 
+  // Returns true if 'data' for 'buffer' should go to the spill file instead
+  // of blocking the producer.
+  bool shouldSpillLocked(
+      const DestinationBuffer& buffer,
+      const SerializedPage& data) const;
+
+  // Writes 'data' to the spill file of 'this', creating the file on first
+  // use.
+  void spillLocked(DestinationBuffer& buffer, const SerializedPage& data);
+
   const std::shared_ptr<Task> task_;
   const bool broadcast_;
+  /// True if pages that do not fit within 'maxSize_' are spilled to disk
+  /// instead of blocking the producers. Never set for broadcast.
+  const bool spillEnabled_;
   /// Total number of drivers expected to produce results. This number will
   /// decrease in the end of grouped execution, when we understand the real
   /// number of producer drivers (depending on the number of split groups).
   uint32_t numDrivers_{0};
-  /// If 'totalSize_' > 'maxSize_', each producer is blocked after adding data.
+  /// If 'totalSize_' > 'maxSize_', each producer is blocked after adding data,
+  /// unless 'spillEnabled_' is set and the task has a spill directory, in
+  /// which case further pages are spilled.
   const uint64_t maxSize_;
   /// When 'totalSize_' goes below 'continueSize_', blocked producers are
   /// resumed.
@@ -174,8 +274,11 @@ class PartitionedOutputBuffer {
   std::vector<std::shared_ptr<SerializedPage>> dataToBroadcast_;
 
   std::mutex mutex_;
-  // Actual data size in 'buffers_'.
+  // Actual data size in 'buffers_'. Does not include spilled pages.
   uint64_t totalSize_ = 0;
+  // Created on first spill. Declared before 'buffers_', which refer to it.
+  std::unique_ptr<OutputBufferSpillFile> spillFile_;
+  uint64_t numSpilledPages_{0};
   std::vector<ContinuePromise> promises_;
   // One buffer per destination
   std::vector<std::unique_ptr<DestinationBuffer>> buffers_;
@@ -204,6 +307,10 @@ class PartitionedOutputBufferManager {
   /// only), we need to update the number of producing drivers here.
   void updateNumDrivers(const std::string& taskId, uint32_t newNumDrivers);
 
+  /// Registers one more producing driver for the buffer of 'taskId'. Returns
+  /// false if the buffer doesn't exist or if all its drivers have finished.
+  bool addDriver(const std::string& taskId);
+
   // Adds data to the outgoing queue for 'destination'. 'data' must not be
   // nullptr. 'data' is always added but if the buffers are full the future is
   // set to a ContinueFuture that will be realized when there is space.
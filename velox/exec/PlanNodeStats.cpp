@@ -75,6 +75,7 @@ void PlanNodeStats::addTotals(const OperatorStats& stats) {
   spilledRows += stats.spilledRows;
   spilledPartitions += stats.spilledPartitions;
   spilledFiles += stats.spilledFiles;
+  spillWriteTiming.add(stats.spillWriteTiming);
 }
 
 std::string PlanNodeStats::toString(bool includeInputStats) const {
@@ -111,6 +111,11 @@ struct PlanNodeStats {
   /// Total spilled files.
   uint32_t spilledFiles{0};
 
+  /// The spill write timing. The wall time is spent by the driver threads on
+  /// waiting for the spill writes. The cpu time is the total cpu time of the
+  /// spill writes which might run in parallel on the spill executor.
+  CpuWallTiming spillWriteTiming;
+
   /// Add stats for a single operator instance.
   void add(const OperatorStats& stats);
 
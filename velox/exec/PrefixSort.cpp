@@ -0,0 +1,555 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+
+#include <folly/lang/Bits.h>
+#include <thread>
+
+#include "velox/common/base/AsyncSource.h"
+#include "velox/exec/RowComparator.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+// Number of leading bytes of a string key in the prefix.
+constexpr int32_t kStringPrefixBytes = 8;
+
+// Returns the encoded size of a key of 'kind' without the null byte. Returns
+// 0 if the kind cannot be encoded.
+constexpr int32_t encodedSize(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+    case TypeKind::DATE:
+      return 4;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+      return 8;
+    case TypeKind::TIMESTAMP:
+      return 16;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return kStringPrefixBytes;
+    default:
+      return 0;
+  }
+}
+
+bool isString(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+// Stores 'value' so that memcmp orders the unsigned values.
+template <typename U>
+inline void storeUnsigned(U value, bool ascending, char* out) {
+  if (!ascending) {
+    value = ~value;
+  }
+  if constexpr (sizeof(U) > 1) {
+    value = folly::Endian::big(value);
+  }
+  memcpy(out, &value, sizeof(U));
+}
+
+template <typename T>
+inline void storeSigned(T value, bool ascending, char* out) {
+  using U = std::make_unsigned_t<T>;
+  storeUnsigned<U>(
+      static_cast<U>(value) ^ (U(1) << (sizeof(U) * 8 - 1)), ascending, out);
+}
+
+// NaN is larger than all other values and -0.0 is equal to 0.0, as in
+// RowContainer::comparePrimitiveAsc.
+template <typename T, typename U>
+inline void storeFloatingPoint(T value, bool ascending, char* out) {
+  U bits;
+  if (std::isnan(value)) {
+    bits = ~U(0);
+  } else {
+    if (value == 0) {
+      value = 0;
+    }
+    memcpy(&bits, &value, sizeof(T));
+    constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+    bits = (bits & kSignBit) ? ~bits : bits | kSignBit;
+  }
+  storeUnsigned<U>(bits, ascending, out);
+}
+
+inline void storeString(StringView value, bool ascending, char* out) {
+  const auto size = std::min<int32_t>(value.size(), kStringPrefixBytes);
+  memcpy(out, value.data(), size);
+  memset(out + size, 0, kStringPrefixBytes - size);
+  if (!ascending) {
+    for (auto i = 0; i < kStringPrefixBytes; ++i) {
+      out[i] = ~out[i];
+    }
+  }
+}
+
+// Stores the null flag and 'value' of a key of 'Kind' at 'out'. 'value' is
+// nullptr for a null key.
+template <TypeKind Kind>
+inline void encodeValue(
+    const typename KindToFlatVector<Kind>::HashRowType* value,
+    CompareFlags flags,
+    char* out) {
+  using T = typename KindToFlatVector<Kind>::HashRowType;
+  if (value == nullptr) {
+    // Nulls come first or last regardless of the order of the values.
+    out[0] = flags.nullsFirst ? 0 : 2;
+    memset(out + 1, 0, encodedSize(Kind));
+    return;
+  }
+  out[0] = 1;
+  ++out;
+  if constexpr (Kind == TypeKind::BOOLEAN) {
+    storeUnsigned<uint8_t>(*value, flags.ascending, out);
+  } else if constexpr (std::is_same_v<T, float>) {
+    storeFloatingPoint<float, uint32_t>(*value, flags.ascending, out);
+  } else if constexpr (std::is_same_v<T, double>) {
+    storeFloatingPoint<double, uint64_t>(*value, flags.ascending, out);
+  } else if constexpr (std::is_same_v<T, Timestamp>) {
+    storeSigned<int64_t>(value->getSeconds(), flags.ascending, out);
+    storeUnsigned<uint64_t>(value->getNanos(), flags.ascending, out + 8);
+  } else if constexpr (std::is_same_v<T, Date>) {
+    storeSigned<int32_t>(value->days(), flags.ascending, out);
+  } else if constexpr (std::is_same_v<T, StringView>) {
+    storeString(*value, flags.ascending, out);
+  } else {
+    storeSigned<T>(*value, flags.ascending, out);
+  }
+}
+
+template <TypeKind Kind>
+void encodeKey(
+    folly::Range<char**> rows,
+    RowColumn column,
+    CompareFlags flags,
+    int32_t offset,
+    char* entries,
+    int32_t entrySize) {
+  using T = typename KindToFlatVector<Kind>::HashRowType;
+  for (auto i = 0; i < rows.size(); ++i) {
+    const char* row = rows[i];
+    const bool isNull =
+        RowContainer::isNullAt(row, column.nullByte(), column.nullMask());
+    T value;
+    if (!isNull) {
+      value = RowContainer::valueAt<T>(row, column.offset());
+    }
+    encodeValue<Kind>(
+        isNull ? nullptr : &value, flags, entries + i * entrySize + offset);
+  }
+}
+
+template <TypeKind Kind>
+void encodeKey(
+    const DecodedVector& decoded,
+    vector_size_t numRows,
+    CompareFlags flags,
+    int32_t offset,
+    char* entries,
+    int32_t entrySize) {
+  using T = typename KindToFlatVector<Kind>::HashRowType;
+  for (auto row = 0; row < numRows; ++row) {
+    const bool isNull = decoded.isNullAt(row);
+    T value;
+    if (!isNull) {
+      value = decoded.valueAt<T>(row);
+    }
+    encodeValue<Kind>(
+        isNull ? nullptr : &value, flags, entries + row * entrySize + offset);
+  }
+}
+
+// 'Source' is the RowContainer rows and column or the DecodedVector and
+// number of rows of the key to encode.
+template <typename... Source>
+void encodeKey(
+    TypeKind kind,
+    CompareFlags flags,
+    int32_t offset,
+    char* entries,
+    int32_t entrySize,
+    const Source&... source) {
+  switch (kind) {
+#define ENCODE_KEY(Kind)                                            \
+  case TypeKind::Kind:                                              \
+    return encodeKey<TypeKind::Kind>(                               \
+        source..., flags, offset, entries, entrySize);
+    ENCODE_KEY(BOOLEAN)
+    ENCODE_KEY(TINYINT)
+    ENCODE_KEY(SMALLINT)
+    ENCODE_KEY(INTEGER)
+    ENCODE_KEY(BIGINT)
+    ENCODE_KEY(REAL)
+    ENCODE_KEY(DOUBLE)
+    ENCODE_KEY(DATE)
+    ENCODE_KEY(TIMESTAMP)
+    ENCODE_KEY(VARCHAR)
+    ENCODE_KEY(VARBINARY)
+#undef ENCODE_KEY
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+// Stable sorts with a merge sort that runs on an executor. The data is split
+// into at most 'parallelism' runs that are sorted in parallel and then merged
+// pairwise in parallel rounds. Work items that have not started on the
+// executor when they are needed run on the calling thread, so a busy
+// executor does not block the sort.
+class ParallelSorter {
+ public:
+  ParallelSorter(folly::Executor* executor, int32_t parallelism)
+      : executor_(executor), parallelism_(executor ? parallelism : 1) {}
+
+  template <typename T, typename Less>
+  void sort(T* data, size_t size, Less less) {
+    const auto numRuns = std::min<size_t>(
+        std::max(parallelism_, 1), size / PrefixSort::kMinParallelSortRun);
+    if (numRuns <= 1) {
+      std::stable_sort(data, data + size, less);
+      return;
+    }
+    std::vector<size_t> bounds(numRuns + 1);
+    for (size_t i = 0; i <= numRuns; ++i) {
+      bounds[i] = size * i / numRuns;
+    }
+    run(numRuns, [&](int32_t i) {
+      std::stable_sort(data + bounds[i], data + bounds[i + 1], less);
+    });
+
+    std::vector<T> buffer(size);
+    T* source = data;
+    T* target = buffer.data();
+    while (bounds.size() > 2) {
+      const int32_t numSourceRuns = bounds.size() - 1;
+      run((numSourceRuns + 1) / 2, [&](int32_t i) {
+        const auto begin = bounds[2 * i];
+        const auto middle = bounds[std::min(2 * i + 1, numSourceRuns)];
+        const auto end = bounds[std::min(2 * i + 2, numSourceRuns)];
+        std::merge(
+            source + begin,
+            source + middle,
+            source + middle,
+            source + end,
+            target + begin,
+            less);
+      });
+      std::vector<size_t> newBounds;
+      for (auto i = 0; i < numSourceRuns; i += 2) {
+        newBounds.push_back(bounds[i]);
+      }
+      newBounds.push_back(size);
+      bounds = std::move(newBounds);
+      std::swap(source, target);
+    }
+    if (source != data) {
+      std::copy(source, source + size, data);
+    }
+  }
+
+  // CPU time of the work items that ran on the executor threads.
+  uint64_t workerCpuNanos() const {
+    return workerCpuNanos_;
+  }
+
+ private:
+  // Runs 'work(i)' for 'i' in [0, numItems) and returns when all are done.
+  template <typename Work>
+  void run(int32_t numItems, const Work& work) {
+    const auto callerId = std::this_thread::get_id();
+    std::vector<std::shared_ptr<AsyncSource<uint64_t>>> items;
+    for (auto i = 0; i < numItems; ++i) {
+      items.push_back(
+          std::make_shared<AsyncSource<uint64_t>>([i, &work, callerId]() {
+            const auto onWorker = std::this_thread::get_id() != callerId;
+            CpuWallTiming timing;
+            {
+              CpuWallTimer timer(timing);
+              work(i);
+            }
+            // The caller's own CPU time is measured by the caller.
+            return std::make_unique<uint64_t>(onWorker ? timing.cpuNanos : 0);
+          }));
+      // The first item runs on the caller.
+      if (i > 0) {
+        executor_->add([item = items.back()]() { item->prepare(); });
+      }
+    }
+    // All items must be waited for also in case of error because they
+    // reference the data being sorted.
+    std::exception_ptr error;
+    for (auto& item : items) {
+      try {
+        if (auto cpuNanos = item->move()) {
+          workerCpuNanos_ += *cpuNanos;
+        }
+      } catch (const std::exception& e) {
+        error = std::current_exception();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  folly::Executor* const executor_;
+  const int32_t parallelism_;
+  uint64_t workerCpuNanos_{0};
+};
+
+template <int32_t kPrefixBytes>
+struct Entry {
+  char prefix[kPrefixBytes];
+  char* row;
+};
+
+template <int32_t kPrefixBytes>
+void sortPrefixes(
+    RowContainer& container,
+    const std::vector<CompareFlags>& compareFlags,
+    const RowComparator& comparator,
+    folly::Range<char**> rows,
+    ParallelSorter& sorter,
+    int32_t numEncodedKeys,
+    bool complete) {
+  using SortEntry = Entry<kPrefixBytes>;
+  const auto& keyTypes = container.keyTypes();
+  std::vector<SortEntry> entries(rows.size());
+  auto* data = reinterpret_cast<char*>(entries.data());
+  int32_t offset = 0;
+  for (auto i = 0; i < numEncodedKeys; ++i) {
+    const auto kind = keyTypes[i]->kind();
+    encodeKey(
+        kind,
+        compareFlags[i],
+        offset,
+        data,
+        sizeof(SortEntry),
+        rows,
+        container.columnAt(i));
+    offset += 1 + encodedSize(kind);
+  }
+  for (auto i = 0; i < rows.size(); ++i) {
+    memset(entries[i].prefix + offset, 0, kPrefixBytes - offset);
+    entries[i].row = rows[i];
+  }
+
+  // The encoded keys are equal if the prefixes are, except for a string key
+  // of which only a prefix is encoded.
+  const auto firstKeyToCompare =
+      numEncodedKeys > 0 && isString(keyTypes[numEncodedKeys - 1]->kind())
+      ? numEncodedKeys - 1
+      : numEncodedKeys;
+  const auto numKeys = keyTypes.size();
+  auto less = [&](const SortEntry& left, const SortEntry& right) {
+    if (auto result = memcmp(left.prefix, right.prefix, kPrefixBytes)) {
+      return result < 0;
+    }
+    if (complete) {
+      return false;
+    }
+    for (auto i = firstKeyToCompare; i < numKeys; ++i) {
+      if (auto result = comparator.compare(left.row, right.row, i)) {
+        return result < 0;
+      }
+    }
+    return false;
+  };
+  sorter.sort(entries.data(), entries.size(), less);
+  for (auto i = 0; i < rows.size(); ++i) {
+    rows[i] = entries[i].row;
+  }
+}
+
+// Returns the number of leading keys of 'keyTypes' encoded in the prefix.
+int32_t numEncodedKeys(const std::vector<TypePtr>& keyTypes) {
+  int32_t offset = 0;
+  for (auto i = 0; i < keyTypes.size(); ++i) {
+    const auto kind = keyTypes[i]->kind();
+    const auto size = encodedSize(kind);
+    if (size == 0 || offset + 1 + size > PrefixSort::kMaxPrefixBytes) {
+      return i;
+    }
+    offset += 1 + size;
+    if (isString(kind)) {
+      return i + 1;
+    }
+  }
+  return keyTypes.size();
+}
+
+void sortRows(
+    RowContainer& container,
+    const std::vector<CompareFlags>& compareFlags,
+    folly::Range<char**> rows,
+    ParallelSorter& sorter) {
+  const auto& keyTypes = container.keyTypes();
+  bool complete;
+  const auto size = PrefixSort::prefixSize(keyTypes, complete);
+  const auto numKeys = numEncodedKeys(keyTypes);
+  const RowComparator comparator(&container, compareFlags);
+  switch (size) {
+    case 8:
+      return sortPrefixes<8>(
+          container,
+          compareFlags,
+          comparator,
+          rows,
+          sorter,
+          numKeys,
+          complete);
+    case 16:
+      return sortPrefixes<16>(
+          container,
+          compareFlags,
+          comparator,
+          rows,
+          sorter,
+          numKeys,
+          complete);
+    case 24:
+      return sortPrefixes<24>(
+          container,
+          compareFlags,
+          comparator,
+          rows,
+          sorter,
+          numKeys,
+          complete);
+    case 32:
+      return sortPrefixes<32>(
+          container,
+          compareFlags,
+          comparator,
+          rows,
+          sorter,
+          numKeys,
+          complete);
+    default:
+      VELOX_CHECK_EQ(size, 0);
+  }
+  // The first key has no binary comparable encoding.
+  sorter.sort(
+      rows.data(), rows.size(), [&](const char* left, const char* right) {
+        return comparator(left, right);
+      });
+}
+
+} // namespace
+
+// static
+int32_t PrefixSort::prefixSize(
+    const std::vector<TypePtr>& keyTypes,
+    bool& complete) {
+  const auto numKeys = numEncodedKeys(keyTypes);
+  int32_t size = 0;
+  for (auto i = 0; i < numKeys; ++i) {
+    size += 1 + encodedSize(keyTypes[i]->kind());
+  }
+  complete = numKeys == keyTypes.size() &&
+      (numKeys == 0 || !isString(keyTypes[numKeys - 1]->kind()));
+  return bits::roundUp(size, 8);
+}
+
+// static
+bool PrefixSort::encodePrefixes(
+    const std::vector<BaseVector*>& keys,
+    const std::vector<CompareFlags>& compareFlags,
+    vector_size_t numRows,
+    std::vector<uint64_t>& prefixes) {
+  VELOX_CHECK_EQ(keys.size(), compareFlags.size());
+  std::vector<TypePtr> keyTypes;
+  for (const auto* key : keys) {
+    keyTypes.push_back(key->type());
+  }
+  const auto numKeys = numEncodedKeys(keyTypes);
+  if (numKeys == 0) {
+    return false;
+  }
+  constexpr int32_t kPrefixBytes = sizeof(uint64_t);
+  // The keys that start in the first 8 bytes are encoded in entries with
+  // room for the largest key after these bytes.
+  constexpr int32_t kEntrySize =
+      kPrefixBytes + 1 + encodedSize(TypeKind::TIMESTAMP);
+  std::vector<char> entries(numRows * kEntrySize, 0);
+  const SelectivityVector rows(numRows);
+  DecodedVector decoded;
+  int32_t offset = 0;
+  for (auto i = 0; i < numKeys && offset < kPrefixBytes; ++i) {
+    const auto kind = keyTypes[i]->kind();
+    decoded.decode(*keys[i], rows);
+    encodeKey(
+        kind,
+        compareFlags[i],
+        offset,
+        entries.data(),
+        kEntrySize,
+        decoded,
+        numRows);
+    offset += 1 + encodedSize(kind);
+  }
+  prefixes.resize(numRows);
+  for (auto row = 0; row < numRows; ++row) {
+    uint64_t prefix;
+    memcpy(&prefix, entries.data() + row * kEntrySize, sizeof(prefix));
+    prefixes[row] = folly::Endian::big(prefix);
+  }
+  return true;
+}
+
+// static
+void PrefixSort::sort(
+    RowContainer& container,
+    const std::vector<CompareFlags>& compareFlags,
+    folly::Range<char**> rows,
+    folly::Executor* executor,
+    int32_t parallelism,
+    CpuWallTiming* timing) {
+  const auto& keyTypes = container.keyTypes();
+  if (compareFlags.empty()) {
+    sort(
+        container,
+        std::vector<CompareFlags>(keyTypes.size()),
+        rows,
+        executor,
+        parallelism,
+        timing);
+    return;
+  }
+  VELOX_CHECK_EQ(compareFlags.size(), keyTypes.size());
+  ParallelSorter sorter(executor, parallelism);
+  CpuWallTiming sortTiming;
+  {
+    CpuWallTimer timer(sortTiming);
+    sortRows(container, compareFlags, rows, sorter);
+  }
+  if (timing != nullptr) {
+    sortTiming.cpuNanos += sorter.workerCpuNanos();
+    timing->add(sortTiming);
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Executor.h>
+
+#include "velox/common/base/CompareFlags.h"
+#include "velox/common/time/CpuWallTimer.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Sorts rows of a RowContainer on its keys using a binary comparable prefix
+/// of the keys. The leading keys are encoded into a fixed size prefix next to
+/// each row pointer so that memcmp of two prefixes orders the rows like
+/// RowContainer::compare with the CompareFlags of the keys. The keys are
+/// compared in the RowContainer only if the prefixes are equal and do not
+/// cover all the keys.
+///
+/// A key of a fixed width type (integers, boolean, floating point, date and
+/// timestamp) takes one byte for the null flag and its width in the prefix.
+/// A string key takes a null byte and its first 8 bytes and ends the prefix.
+/// The prefix ends before the first key of another type or that does not fit
+/// in kMaxPrefixBytes.
+class PrefixSort {
+ public:
+  static constexpr int32_t kMaxPrefixBytes = 32;
+
+  /// Minimum number of rows per sorted run of a parallel sort.
+  static constexpr int32_t kMinParallelSortRun = 10'000;
+
+  /// Sorts 'rows' of 'container' on the keys of 'container'. 'compareFlags'
+  /// has one entry per key or is empty for the default flags. The sort is
+  /// stable. If 'executor' is given, sorts runs of at least
+  /// kMinParallelSortRun rows on up to 'parallelism' threads of 'executor'
+  /// and the calling thread, and merges them. Adds the wall time and the CPU
+  /// time of all threads to 'timing' if given.
+  static void sort(
+      RowContainer& container,
+      const std::vector<CompareFlags>& compareFlags,
+      folly::Range<char**> rows,
+      folly::Executor* executor = nullptr,
+      int32_t parallelism = 1,
+      CpuWallTiming* timing = nullptr);
+
+  /// Returns the number of bytes of the prefix for keys of 'keyTypes', a
+  /// multiple of 8 or 0 if the first key cannot be encoded. Sets 'complete'
+  /// to true if the prefix covers all the keys.
+  static int32_t prefixSize(
+      const std::vector<TypePtr>& keyTypes,
+      bool& complete);
+
+  /// Sets 'prefixes' to the first 8 bytes of the prefix of the keys of each
+  /// of the first 'numRows' rows of 'keys', read as a big endian number. A
+  /// row with a smaller number sorts before a row with a larger one with
+  /// 'compareFlags', which has one entry per key. Rows with equal numbers need
+  /// a comparison of their keys. Returns false and leaves 'prefixes' as is if
+  /// the first key cannot be encoded.
+  static bool encodePrefixes(
+      const std::vector<BaseVector*>& keys,
+      const std::vector<CompareFlags>& compareFlags,
+      vector_size_t numRows,
+      std::vector<uint64_t>& prefixes);
+};
+
+} // namespace facebook::velox::exec
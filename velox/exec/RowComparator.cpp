@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/RowComparator.h"
+
+#include <numeric>
+
+namespace facebook::velox::exec {
+
+namespace {
+std::vector<column_index_t> keyColumns(const RowContainer& container) {
+  std::vector<column_index_t> columns(container.keyTypes().size());
+  std::iota(columns.begin(), columns.end(), 0);
+  return columns;
+}
+} // namespace
+
+// static
+template <TypeKind Kind>
+void RowComparator::initKey(Key& key) {
+  if (key.flags.nullsFirst) {
+    if (key.flags.ascending) {
+      initCompare<Kind, true, true>(key);
+    } else {
+      initCompare<Kind, true, false>(key);
+    }
+  } else {
+    if (key.flags.ascending) {
+      initCompare<Kind, false, true>(key);
+    } else {
+      initCompare<Kind, false, false>(key);
+    }
+  }
+  key.equalsDecoded[false] = equalsDecoded<Kind, false>;
+  key.equalsDecoded[true] = equalsDecoded<Kind, true>;
+}
+
+// static
+template <TypeKind Kind, bool nullsFirst, bool ascending>
+void RowComparator::initCompare(Key& key) {
+  key.compareRows = compareRows<Kind, nullsFirst, ascending>;
+  key.compareDecoded = compareDecoded<Kind, nullsFirst, ascending>;
+}
+
+RowComparator::RowComparator(
+    RowContainer* container,
+    const std::vector<column_index_t>& columns,
+    const std::vector<CompareFlags>& flags)
+    : container_(container) {
+  VELOX_CHECK_EQ(columns.size(), flags.size());
+  keys_.reserve(columns.size());
+  for (auto i = 0; i < columns.size(); ++i) {
+    const auto column = columns[i];
+    VELOX_CHECK_LT(column, container_->columnTypes().size());
+    Key key;
+    key.column = column;
+    key.type = container_->columnTypes()[column].get();
+    key.flags = flags[i];
+    VELOX_DYNAMIC_TYPE_DISPATCH(initKey, key.type->kind(), key);
+    keys_.push_back(key);
+  }
+}
+
+RowComparator::RowComparator(
+    RowContainer* container,
+    const std::vector<CompareFlags>& flags)
+    : RowComparator(
+          container,
+          keyColumns(*container),
+          flags.empty()
+              ? std::vector<CompareFlags>(container->keyTypes().size())
+              : flags) {}
+
+} // namespace facebook::velox::exec
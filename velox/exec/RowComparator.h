@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/base/CompareFlags.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Compares the rows of a RowContainer, or a row with a row of a
+/// DecodedVector, on a list of columns. The TypeKind and the ascending and
+/// nulls first flags of each column are resolved at construction into
+/// functions specialized for them, so that comparing rows makes no switch on
+/// the type and no checks of the flags. Make one per operator and use it in
+/// the sort and probe loops instead of RowContainer::compare().
+class RowComparator {
+ public:
+  /// Compares on 'columns' of 'container' with the respective 'flags'.
+  RowComparator(
+      RowContainer* container,
+      const std::vector<column_index_t>& columns,
+      const std::vector<CompareFlags>& flags);
+
+  /// Compares on the keys of 'container' in order. 'flags' has one entry per
+  /// key or is empty for the default flags.
+  explicit RowComparator(
+      RowContainer* container,
+      const std::vector<CompareFlags>& flags = {});
+
+  /// Returns 0 if 'left' and 'right' are equal on all the columns, < 0 if
+  /// 'left' is ordered first, > 0 otherwise.
+  int32_t compare(const char* left, const char* right) const {
+    for (const auto& key : keys_) {
+      if (auto result = key.compareRows(*container_, left, right, key)) {
+        return result;
+      }
+    }
+    return 0;
+  }
+
+  /// Returns true if 'left' is ordered before 'right'.
+  bool operator()(const char* left, const char* right) const {
+    return compare(left, right) < 0;
+  }
+
+  /// Compares 'left' and 'right' on the 'i'th column only.
+  int32_t compare(const char* left, const char* right, int32_t i) const {
+    const auto& key = keys_[i];
+    return key.compareRows(*container_, left, right, key);
+  }
+
+  /// Compares 'row' on the 'i'th column with the value at 'index' in
+  /// 'decoded', which must be of the type of the column.
+  int32_t compare(
+      int32_t i,
+      const char* row,
+      const DecodedVector& decoded,
+      vector_size_t index) const {
+    const auto& key = keys_[i];
+    return key.compareDecoded(*container_, row, key, decoded, index);
+  }
+
+  /// Returns true if 'row' on the 'i'th column equals the value at 'index' in
+  /// 'decoded'. Nulls are only checked if 'mayHaveNulls' is true.
+  template <bool mayHaveNulls>
+  bool equals(
+      int32_t i,
+      const char* row,
+      const DecodedVector& decoded,
+      vector_size_t index) const {
+    const auto& key = keys_[i];
+    return key.equalsDecoded[mayHaveNulls](
+        *container_, row, key, decoded, index);
+  }
+
+  size_t numColumns() const {
+    return keys_.size();
+  }
+
+ private:
+  struct Key;
+
+  using CompareRowsFn = int32_t (*)(
+      RowContainer& container,
+      const char* left,
+      const char* right,
+      const Key& key);
+
+  using CompareDecodedFn = int32_t (*)(
+      RowContainer& container,
+      const char* row,
+      const Key& key,
+      const DecodedVector& decoded,
+      vector_size_t index);
+
+  using EqualsDecodedFn = bool (*)(
+      RowContainer& container,
+      const char* row,
+      const Key& key,
+      const DecodedVector& decoded,
+      vector_size_t index);
+
+  struct Key {
+    // The index of the column in the container. RowColumn is not assignable,
+    // so it is looked up in the container by index.
+    column_index_t column;
+    const Type* type;
+    // The flags, of which only 'equalsOnly' and 'stopAtNull' are read at
+    // comparison time, for complex types.
+    CompareFlags flags;
+    CompareRowsFn compareRows;
+    CompareDecodedFn compareDecoded;
+    // Indexed by 'mayHaveNulls'.
+    EqualsDecodedFn equalsDecoded[2];
+  };
+
+  template <TypeKind Kind>
+  static void initKey(Key& key);
+
+  template <TypeKind Kind, bool nullsFirst, bool ascending>
+  static void initCompare(Key& key);
+
+  template <TypeKind Kind, bool nullsFirst, bool ascending>
+  static int32_t compareRows(
+      RowContainer& container,
+      const char* left,
+      const char* right,
+      const Key& key) {
+    return container.compare<Kind>(
+        left,
+        right,
+        key.type,
+        container.columnAt(key.column),
+        {nullsFirst, ascending, key.flags.equalsOnly, key.flags.stopAtNull});
+  }
+
+  template <TypeKind Kind, bool nullsFirst, bool ascending>
+  static int32_t compareDecoded(
+      RowContainer& container,
+      const char* row,
+      const Key& key,
+      const DecodedVector& decoded,
+      vector_size_t index) {
+    return container.compare<Kind>(
+        row,
+        container.columnAt(key.column),
+        decoded,
+        index,
+        {nullsFirst, ascending, key.flags.equalsOnly, key.flags.stopAtNull});
+  }
+
+  template <TypeKind Kind, bool mayHaveNulls>
+  static bool equalsDecoded(
+      RowContainer& container,
+      const char* row,
+      const Key& key,
+      const DecodedVector& decoded,
+      vector_size_t index) {
+    const auto column = container.columnAt(key.column);
+    if constexpr (mayHaveNulls) {
+      return container.equalsWithNulls<Kind>(
+          row,
+          column.offset(),
+          column.nullByte(),
+          column.nullMask(),
+          decoded,
+          index);
+    } else {
+      return container.equalsNoNulls<Kind>(
+          row, column.offset(), decoded, index);
+    }
+  }
+
+  RowContainer* container_;
+  std::vector<Key> keys_;
+};
+
+} // namespace facebook::velox::exec
@@ -56,7 +56,8 @@ RowContainer::RowContainer(
     bool hasProbedFlag,
     bool hasNormalizedKeys,
     memory::MemoryPool* pool,
-    const RowSerde& serde)
+    const RowSerde& serde,
+    bool columnarLayout)
     : keyTypes_(keyTypes),
       nullableKeys_(nullableKeys),
       aggregates_(aggregates),
@@ -158,6 +159,38 @@ RowContainer::RowContainer(
     offset += sizeof(void*);
   }
   fixedRowSize_ = bits::roundUp(offset, alignment_);
+  if (columnarLayout && aggregates.empty() && !hasNext && !hasProbedFlag &&
+      !hasNormalizedKeys) {
+    // Each slot must hold the widest column, the flags and the next pointer
+    // of a free row.
+    int32_t slotSize = std::max<int32_t>(sizeof(void*), nullBytes);
+    for (auto kind : typeKinds_) {
+      slotSize = std::max(slotSize, typeKindSize(kind));
+    }
+    slotSize = bits::nextPowerOfTwo(slotSize);
+    if (slotSize <= 2 * sizeof(void*)) {
+      columnar_ = true;
+      columnarSlotSize_ = slotSize;
+      // The slots are the keys and dependents, the flags and the row size if
+      // any, in this order.
+      const int32_t slotBytes = kColumnarBlockRows * slotSize;
+      int32_t numSlots = 0;
+      for (auto& columnOffset : offsets_) {
+        columnOffset = numSlots++ * slotBytes;
+      }
+      const int32_t flagsShift =
+          (numSlots++ * slotBytes - firstAggregateOffset) * 8;
+      for (auto& flagOffset : nullOffsets_) {
+        flagOffset += flagsShift;
+      }
+      freeFlagOffset_ += flagsShift;
+      if (isVariableWidth) {
+        rowSizeOffset_ = numSlots++ * slotBytes;
+      }
+      fixedRowSize_ = numSlots * slotSize;
+      columnarBlockBytes_ = numSlots * slotBytes;
+    }
+  }
   for (int i = 0; i < aggregates_.size(); ++i) {
     nullOffset = nullOffsets_[i + firstAggregate];
     aggregates_[i]->setOffsets(
@@ -200,6 +233,14 @@ char* RowContainer::newRow() {
     VELOX_CHECK(bits::isBitSet(row, freeFlagOffset_));
     firstFreeRow_ = nextFree(row);
     --numFreeRows_;
+  } else if (nextReservedRow_ < reservedRows_.size() || columnar_) {
+    if (nextReservedRow_ == reservedRows_.size()) {
+      newColumnarBlock();
+    }
+    // Reserved rows are initialized except for the free flag.
+    row = reservedRows_[nextReservedRow_++];
+    bits::clearBit(row, freeFlagOffset_);
+    return row;
   } else {
     row = rows_.allocateFixed(fixedRowSize_ + normalizedKeySize_, alignment_) +
         normalizedKeySize_;
@@ -210,6 +251,132 @@ char* RowContainer::newRow() {
   return initializeRow(row, false /* reuse */);
 }
 
+void RowContainer::reserveRows(int32_t numRows) {
+  VELOX_DCHECK(
+      !partitions_, "Rows may not be added after partitions() has been called");
+  int64_t numNeeded = static_cast<int64_t>(numRows) -
+      static_cast<int64_t>(numFreeRows_) - numReservedRows();
+  if (numNeeded <= 0) {
+    return;
+  }
+  reservedRows_.erase(
+      reservedRows_.begin(), reservedRows_.begin() + nextReservedRow_);
+  nextReservedRow_ = 0;
+  if (columnar_) {
+    for (; numNeeded > 0; numNeeded -= kColumnarBlockRows) {
+      newColumnarBlock();
+    }
+    return;
+  }
+  const int32_t rowSize = fixedRowSize_ + normalizedKeySize_;
+  while (numNeeded > 0) {
+    // Fills up the current run first. Rows are never placed across runs.
+    int64_t numInRun = 0;
+    if (const auto available = rows_.availableInRun()) {
+      const auto padding =
+          memory::alignmentPadding(rows_.firstFreeInRun(), alignment_);
+      numInRun = std::max<int64_t>(0, available - padding) / rowSize;
+    }
+    // If no row fits, allocates a single row to start a new run.
+    const auto numRowsInBlock =
+        std::min(numNeeded, std::max<int64_t>(1, numInRun));
+    auto* firstRow =
+        rows_.allocateFixed(numRowsInBlock * rowSize, alignment_) +
+        normalizedKeySize_;
+    if (normalizedKeySize_) {
+      numRowsWithNormalizedKey_ += numRowsInBlock;
+    }
+    // Initializes the first row and copies it over the rest of the block.
+    memset(firstRow - normalizedKeySize_, 0, rowSize);
+    initializeRow(firstRow, false /* reuse */);
+    bits::setBit(firstRow, freeFlagOffset_);
+    for (auto i = 1; i < numRowsInBlock; ++i) {
+      memcpy(
+          firstRow + i * rowSize - normalizedKeySize_,
+          firstRow - normalizedKeySize_,
+          rowSize);
+    }
+    for (auto i = 0; i < numRowsInBlock; ++i) {
+      reservedRows_.push_back(firstRow + i * rowSize);
+    }
+    numNeeded -= numRowsInBlock;
+  }
+}
+
+void RowContainer::newColumnarBlock() {
+  if (nextReservedRow_ == reservedRows_.size()) {
+    reservedRows_.clear();
+    nextReservedRow_ = 0;
+  }
+  // The blocks are consecutive from the start of each run, so that
+  // listColumnarRows() finds them at multiples of 'columnarBlockBytes_'.
+  auto* block = rows_.allocateFixed(columnarBlockBytes_, columnarSlotSize_);
+  memset(block, 0, columnarBlockBytes_);
+  for (auto i = 0; i < kColumnarBlockRows; ++i) {
+    auto* row = block + i * columnarSlotSize_;
+    initializeRow(row, false /* reuse */);
+    bits::setBit(row, freeFlagOffset_);
+    reservedRows_.push_back(row);
+  }
+}
+
+int32_t RowContainer::listColumnarRows(
+    RowContainerIterator* iter,
+    int32_t maxRows,
+    uint64_t maxBytes,
+    char** rows) {
+  int32_t count = 0;
+  uint64_t totalBytes = 0;
+  const int32_t firstColumnBytes = kColumnarBlockRows * columnarSlotSize_;
+  VELOX_CHECK_EQ(rows_.numLargeAllocations(), 0);
+  auto numAllocations = rows_.numSmallAllocations();
+  for (auto i = iter->allocationIndex; i < numAllocations; ++i) {
+    auto allocation = rows_.allocationAt(i);
+    auto numRuns = allocation->numRuns();
+    for (auto runIndex = iter->runIndex; runIndex < numRuns; ++runIndex) {
+      memory::Allocation::PageRun run = allocation->runAt(runIndex);
+      auto* data = run.data<char>();
+      int64_t limit;
+      if (i == numAllocations - 1 && runIndex == rows_.currentRunIndex()) {
+        limit = rows_.currentOffset();
+      } else {
+        limit = run.numPages() * memory::AllocationTraits::kPageSize;
+      }
+      // 'rowOffset' is the offset of the row's slot in the first column.
+      auto row = iter->rowOffset;
+      for (;;) {
+        const auto blockOffset = row - row % columnarBlockBytes_;
+        if (blockOffset + columnarBlockBytes_ > limit) {
+          break;
+        }
+        auto* rowPtr = data + row;
+        row += columnarSlotSize_;
+        if (row - blockOffset == firstColumnBytes) {
+          row = blockOffset + columnarBlockBytes_;
+        }
+        if (bits::isBitSet(rowPtr, freeFlagOffset_)) {
+          continue;
+        }
+        rows[count++] = rowPtr;
+        totalBytes += fixedRowSize_;
+        if (rowSizeOffset_) {
+          totalBytes += variableRowSize(rowPtr);
+        }
+        if (count == maxRows || totalBytes > maxBytes) {
+          iter->rowOffset = row;
+          iter->runIndex = runIndex;
+          iter->allocationIndex = i;
+          return count;
+        }
+      }
+      iter->rowOffset = 0;
+    }
+    iter->runIndex = 0;
+  }
+  iter->allocationIndex = std::numeric_limits<int32_t>::max();
+  return count;
+}
+
 char* RowContainer::initializeRow(char* row, bool reuse) {
   if (reuse) {
     auto rows = folly::Range<char**>(&row, 1);
@@ -266,6 +433,57 @@ void RowContainer::freeVariableWidthFields(folly::Range<char**> rows) {
   }
 }
 
+void RowContainer::relocateVariableWidthFields(folly::Range<char**> rows) {
+  for (auto i = 0; i < types_.size(); ++i) {
+    switch (typeKinds_[i]) {
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+      case TypeKind::ROW:
+      case TypeKind::ARRAY:
+      case TypeKind::MAP: {
+        auto column = columnAt(i);
+        for (auto row : rows) {
+          if (isNullAt(row, column.nullByte(), column.nullMask())) {
+            continue;
+          }
+          auto& view = valueAt<StringView>(row, column.offset());
+          if (view.isInline()) {
+            continue;
+          }
+          auto header = HashStringAllocator::headerOf(view.data());
+          auto newHeader = stringAllocator_.relocate(header);
+          if (newHeader != header) {
+            view = StringView(newHeader->begin(), view.size());
+          }
+        }
+      } break;
+      default:;
+    }
+  }
+}
+
+int64_t RowContainer::compactStringAllocator(double freeRatio) {
+  if (stringAllocator_.retainedSize() <= compactedRetainedBytes_ ||
+      stringAllocator_.freeRatio() < freeRatio) {
+    return 0;
+  }
+  if (stringAllocator_.startCompaction(freeRatio) > 0) {
+    constexpr int32_t kBatch = 1000;
+    std::vector<char*> rows(kBatch);
+    RowContainerIterator iter;
+    while (auto numRows = listRows(&iter, kBatch, rows.data())) {
+      folly::Range<char**> range(rows.data(), numRows);
+      relocateVariableWidthFields(range);
+      for (auto& aggregate : aggregates_) {
+        aggregate->relocate(range);
+      }
+    }
+  }
+  const auto freedBytes = stringAllocator_.finishCompaction();
+  compactedRetainedBytes_ = stringAllocator_.retainedSize();
+  return freedBytes;
+}
+
 void RowContainer::checkConsistency() {
   constexpr int32_t kBatch = 1000;
   std::vector<char*> rows(kBatch);
@@ -291,6 +509,9 @@ void RowContainer::checkConsistency() {
   }
   VELOX_CHECK_EQ(numFree, numFreeRows_);
   VELOX_CHECK_EQ(allocatedRows, numRows_);
+  for (auto i = nextReservedRow_; i < reservedRows_.size(); ++i) {
+    VELOX_CHECK(bits::isBitSet(reservedRows_[i], freeFlagOffset_));
+  }
 }
 
 void RowContainer::freeAggregates(folly::Range<char**> rows) {
@@ -513,6 +734,8 @@ void RowContainer::clear() {
   normalizedKeySize_ = originalNormalizedKeySize_;
   numFreeRows_ = 0;
   firstFreeRow_ = nullptr;
+  reservedRows_.clear();
+  nextReservedRow_ = 0;
 }
 
 void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
@@ -565,7 +788,8 @@ std::optional<int64_t> RowContainer::estimateRowSize() const {
   if (numRows_ == 0) {
     return std::nullopt;
   }
-  int64_t freeBytes = rows_.availableInRun() + fixedRowSize_ * numFreeRows_;
+  int64_t freeBytes = rows_.availableInRun() +
+      fixedRowSize_ * (numFreeRows_ + numReservedRows());
   int64_t usedSize = rows_.allocatedBytes() - freeBytes +
       stringAllocator_.retainedSize() - stringAllocator_.freeSpace();
   int64_t rowSize = usedSize / numRows_;
@@ -579,7 +803,8 @@ int64_t RowContainer::sizeIncrement(
     int64_t variableLengthBytes) const {
   constexpr int32_t kAllocUnit =
       AllocationPool::kMinPages * memory::AllocationTraits::kPageSize;
-  int32_t needRows = std::max<int64_t>(0, numRows - numFreeRows_);
+  int32_t needRows =
+      std::max<int64_t>(0, numRows - numFreeRows_ - numReservedRows());
   int64_t needBytes =
       std::min<int64_t>(0, variableLengthBytes - stringAllocator_.freeSpace());
   return bits::roundUp(needRows * fixedRowSize_, kAllocUnit) +
@@ -588,6 +813,7 @@ int64_t RowContainer::sizeIncrement(
 
 void RowContainer::skip(RowContainerIterator& iter, int32_t numRows) {
   VELOX_DCHECK(aggregates_.empty(), "Used in join only");
+  VELOX_DCHECK(!columnar_, "Used in join only");
   VELOX_DCHECK_LE(0, numRows);
   if (!iter.endOfRun) {
     // Set to first row.
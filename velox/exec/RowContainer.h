@@ -133,10 +133,13 @@ class RowContainer {
       memory::MemoryPool* FOLLY_NONNULL pool)
       : RowContainer(keyTypes, std::vector<TypePtr>{}, pool) {}
 
+  // If 'columnarLayout' is true, the rows are stored in column-major blocks,
+  // see isColumnar().
   RowContainer(
       const std::vector<TypePtr>& keyTypes,
       const std::vector<TypePtr>& dependentTypes,
-      memory::MemoryPool* FOLLY_NONNULL pool)
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      bool columnarLayout = false)
       : RowContainer(
             keyTypes,
             true, // nullableKeys
@@ -147,7 +150,8 @@ class RowContainer {
             false, // hasProbedFlag
             false, // hasNormalizedKey
             pool,
-            ContainerRowSerde::instance()) {}
+            ContainerRowSerde::instance(),
+            columnarLayout) {}
 
   // 'keyTypes' gives the type of the key of each row. For a group by,
   // order by or right outer join build side these may be
@@ -164,7 +168,8 @@ class RowContainer {
   // below each row for a normalized key that collapses all parts
   // into one word for faster comparison. The bulk allocation is done
   // from 'allocator'.  'serde_' is used for serializing complex
-  // type values into the container.
+  // type values into the container. 'columnarLayout' requests the
+  // column-major layout described at isColumnar().
   RowContainer(
       const std::vector<TypePtr>& keyTypes,
       bool nullableKeys,
@@ -175,11 +180,37 @@ class RowContainer {
       bool hasProbedFlag,
       bool hasNormalizedKey,
       memory::MemoryPool* FOLLY_NONNULL pool,
-      const RowSerde& serde);
+      const RowSerde& serde,
+      bool columnarLayout = false);
+
+  // Number of rows in a column-major block of a columnar container.
+  static constexpr int32_t kColumnarBlockRows = 256;
+
+  // Returns true if the rows are stored in column-major blocks of
+  // kColumnarBlockRows rows. Each column, the null and free flags and the
+  // row size each take a slot of the same width in a row, e.g. 16 bytes if
+  // there is a VARCHAR column, and the slots of a column are contiguous in
+  // the block. A row is then addressed by a pointer to its slot in the first
+  // column with the offset of each column being a multiple of the column
+  // size of the block, so that the API is the same as for row-wise storage.
+  // Extracting a column reads a dense range of memory instead of striding
+  // over whole rows. This is used only if requested and if there are no
+  // accumulators, next pointers, probed flags or normalized keys and if the
+  // flags fit in a slot. Otherwise the rows are stored one after the other.
+  bool isColumnar() const {
+    return columnar_;
+  }
 
   // Allocates a new row and initializes possible aggregates to null.
   char* FOLLY_NONNULL newRow();
 
+  // Prepares the rows for the next 'numRows' calls to newRow(). The rows not
+  // covered by free or previously reserved rows are bump allocated in
+  // contiguous blocks and initialized together, so that newRow() only needs
+  // to hand them out. The reserved rows are flagged as free until then and are
+  // not returned by listRows().
+  void reserveRows(int32_t numRows);
+
   uint32_t rowSize(const char* FOLLY_NONNULL row) const {
     return fixedRowSize_ +
         (rowSizeOffset_
@@ -336,6 +367,9 @@ class RowContainer {
       int32_t maxRows,
       uint64_t maxBytes,
       char* FOLLY_NONNULL* FOLLY_NONNULL rows) {
+    if (columnar_) {
+      return listColumnarRows(iter, maxRows, maxBytes, rows);
+    }
     int32_t count = 0;
     uint64_t totalBytes = 0;
     VELOX_CHECK_EQ(rows_.numLargeAllocations(), 0);
@@ -521,13 +555,22 @@ class RowContainer {
   // reserved storage for variable length data.
   std::pair<uint64_t, uint64_t> freeSpace() const {
     return std::make_pair<uint64_t, uint64_t>(
-        rows_.availableInRun() / fixedRowSize_ + numFreeRows_,
+        rows_.availableInRun() / fixedRowSize_ + numFreeRows_ +
+            numReservedRows(),
         stringAllocator_.freeSpace());
   }
 
   // Returns the average size of rows in bytes stored in this container.
   std::optional<int64_t> estimateRowSize() const;
 
+  // Compacts the variable width data if at least 'freeRatio' of the memory
+  // of 'stringAllocator_' is free and it has grown since the last
+  // compaction. Moves the variable width keys and dependents and the
+  // accumulators that support Aggregate::relocate() out of the slabs that
+  // have at least 'freeRatio' free and releases the slabs that become
+  // empty. Returns the number of bytes released.
+  int64_t compactStringAllocator(double freeRatio);
+
   // Returns a cap on  extra memory that may be needed when adding 'numRows'
   // and variableLengthBytes of out-of-line variable length data.
   int64_t sizeIncrement(vector_size_t numRows, int64_t variableLengthBytes)
@@ -620,6 +663,9 @@ class RowContainer {
   void skip(RowContainerIterator& iterator, int32_t numRows);
 
  private:
+  // Uses the typed compare() and equals() templates.
+  friend class RowComparator;
+
   // Offset of the pointer to the next free row on a free row.
   static constexpr int32_t kNextFreeOffset = 0;
 
@@ -1019,6 +1065,27 @@ class RowContainer {
   // Free any aggregates associated with the 'rows'.
   void freeAggregates(folly::Range<char**> rows);
 
+  // Implements listRows() for a columnar container. Columnar containers have
+  // no probed flags, so this lists all rows.
+  int32_t listColumnarRows(
+      RowContainerIterator* FOLLY_NONNULL iter,
+      int32_t maxRows,
+      uint64_t maxBytes,
+      char* FOLLY_NONNULL* FOLLY_NONNULL rows);
+
+  // Allocates a column-major block of rows and adds them to 'reservedRows_'.
+  void newColumnarBlock();
+
+  // Returns the number of rows allocated by reserveRows() and not yet
+  // returned by newRow().
+  int64_t numReservedRows() const {
+    return reservedRows_.size() - nextReservedRow_;
+  }
+
+  // Moves the variable-width fields of 'rows' out of the slabs being
+  // evacuated by a compaction of 'stringAllocator_'.
+  void relocateVariableWidthFields(folly::Range<char**> rows);
+
   const std::vector<TypePtr> keyTypes_;
   const bool nullableKeys_;
 
@@ -1050,6 +1117,14 @@ class RowContainer {
   int32_t rowSizeOffset_ = 0;
 
   int32_t fixedRowSize_;
+
+  // True if rows are stored in column-major blocks. See isColumnar().
+  bool columnar_{false};
+  // Width of each slot in a row of a columnar container. The slots of a
+  // column are at this distance in the block.
+  int32_t columnarSlotSize_{0};
+  // Size of a column-major block of kColumnarBlockRows rows.
+  int32_t columnarBlockBytes_{0};
   // True if normalized keys are enabled in initial state.
   const bool hasNormalizedKeys_;
   // The count of entries that have an extra normalized_key_t before the
@@ -1068,10 +1143,17 @@ class RowContainer {
   // Head of linked list of free rows.
   char* FOLLY_NULLABLE firstFreeRow_ = nullptr;
   uint64_t numFreeRows_ = 0;
+  // Rows allocated by reserveRows() in allocation order. The ones starting at
+  // 'nextReservedRow_' are still to be returned by newRow().
+  std::vector<char*> reservedRows_;
+  size_t nextReservedRow_ = 0;
 
   AllocationPool rows_;
   HashStringAllocator stringAllocator_;
 
+  // Retained size of 'stringAllocator_' after the last compaction.
+  uint64_t compactedRetainedBytes_{0};
+
   // Partition number for each row. Used only in parallel hash join build.
   std::unique_ptr<RowPartitions> partitions_;
 
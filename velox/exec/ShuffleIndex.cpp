@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/ShuffleIndex.h"
+
+#include <fmt/format.h>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+namespace {
+constexpr int32_t kIndexVersion = 1;
+
+template <typename T>
+void append(T value, std::string& out) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+class IndexReader {
+ public:
+  explicit IndexReader(std::string_view data) : data_(data) {}
+
+  template <typename T>
+  T read() {
+    VELOX_CHECK_LE(
+        offset_ + sizeof(T), data_.size(), "Truncated shuffle index");
+    T value;
+    memcpy(&value, data_.data() + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return value;
+  }
+
+  int32_t readCount() {
+    const auto count = read<int32_t>();
+    VELOX_CHECK_GE(count, 0, "Negative count in shuffle index");
+    return count;
+  }
+
+  std::string readString() {
+    const auto size = readCount();
+    VELOX_CHECK_LE(offset_ + size, data_.size(), "Truncated shuffle index");
+    std::string result(data_.data() + offset_, size);
+    offset_ += size;
+    return result;
+  }
+
+  bool atEnd() const {
+    return offset_ == data_.size();
+  }
+
+ private:
+  const std::string_view data_;
+  size_t offset_{0};
+};
+} // namespace
+
+// static
+std::string ShuffleIndex::dataPath(const std::string& path, int32_t driverId) {
+  return fmt::format("{}.{}.data", path, driverId);
+}
+
+// static
+std::string ShuffleIndex::indexPath(const std::string& path) {
+  return path + ".index";
+}
+
+std::string ShuffleIndex::serialize() const {
+  std::string out;
+  append<int32_t>(kIndexVersion, out);
+  append<int32_t>(files.size(), out);
+  for (const auto& file : files) {
+    append<int32_t>(file.size(), out);
+    out.append(file);
+  }
+  append<int32_t>(partitions.size(), out);
+  for (const auto& ranges : partitions) {
+    append<int32_t>(ranges.size(), out);
+    for (const auto& range : ranges) {
+      append(range.file, out);
+      append(range.offset, out);
+      append(range.size, out);
+    }
+  }
+  return out;
+}
+
+// static
+ShuffleIndex ShuffleIndex::deserialize(std::string_view data) {
+  IndexReader reader(data);
+  const auto version = reader.read<int32_t>();
+  VELOX_CHECK_EQ(version, kIndexVersion, "Unsupported shuffle index version");
+  ShuffleIndex index;
+  index.files.resize(reader.readCount());
+  for (auto& file : index.files) {
+    file = reader.readString();
+  }
+  index.partitions.resize(reader.readCount());
+  for (auto& ranges : index.partitions) {
+    ranges.resize(reader.readCount());
+    for (auto& range : ranges) {
+      range.file = reader.read<int32_t>();
+      VELOX_CHECK(
+          range.file >= 0 && range.file < index.files.size(),
+          "Bad file number in shuffle index: {}",
+          range.file);
+      range.offset = reader.read<uint64_t>();
+      range.size = reader.read<uint64_t>();
+    }
+  }
+  VELOX_CHECK(reader.atEnd(), "Extra bytes after shuffle index");
+  return index;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// Describes where the data of each partition of a persistent shuffle is. The
+/// shuffle output of a task with path 'path' consists of the data files
+/// 'path' + files[i] and the index file 'path' + ".index". Each data file
+/// holds serialized pages grouped by partition. The ranges of a partition
+/// are listed in the order in which their pages were written.
+struct ShuffleIndex {
+  struct Range {
+    // Index into 'files'.
+    int32_t file;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  // Suffixes of the data file paths.
+  std::vector<std::string> files;
+
+  // Ranges of each partition.
+  std::vector<std::vector<Range>> partitions;
+
+  /// Returns the path of the data file written by driver 'driverId'.
+  static std::string dataPath(const std::string& path, int32_t driverId);
+
+  /// Returns the path of the index file.
+  static std::string indexPath(const std::string& path);
+
+  std::string serialize() const;
+
+  /// Parses the result of serialize(). Throws if 'data' is malformed.
+  static ShuffleIndex deserialize(std::string_view data);
+};
+
+} // namespace facebook::velox::exec
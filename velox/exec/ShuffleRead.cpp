@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/ShuffleRead.h"
+#include "velox/common/file/FileSystems.h"
+
+namespace facebook::velox::exec {
+
+ShuffleReadExchangeSource::ShuffleReadExchangeSource(
+    const std::string& taskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* FOLLY_NONNULL pool)
+    : ExchangeSource(taskId, destination, std::move(queue), pool),
+      path_(taskId.substr(kScheme.size())) {}
+
+bool ShuffleReadExchangeSource::shouldRequestLocked() {
+  if (atEnd_) {
+    return false;
+  }
+  return !requestPending_.exchange(true);
+}
+
+void ShuffleReadExchangeSource::readIndex() {
+  const auto indexPath = ShuffleIndex::indexPath(path_);
+  auto fs = filesystems::getFileSystem(indexPath, nullptr);
+  auto indexFile = fs->openFileForRead(indexPath);
+  index_ = ShuffleIndex::deserialize(indexFile->pread(0, indexFile->size()));
+  VELOX_CHECK_LT(
+      destination_,
+      index_->partitions.size(),
+      "Shuffle partition out of range: {}",
+      taskId_);
+  files_.resize(index_->files.size());
+}
+
+ReadFile& ShuffleReadExchangeSource::file(int32_t file) {
+  if (!files_[file]) {
+    const auto path = path_ + index_->files[file];
+    auto fs = filesystems::getFileSystem(path, nullptr);
+    files_[file] = fs->openFileForRead(path);
+  }
+  return *files_[file];
+}
+
+void ShuffleReadExchangeSource::request(uint64_t maxBytes) {
+  VELOX_CHECK(requestPending_);
+  if (!index_.has_value()) {
+    readIndex();
+  }
+  const auto& ranges = index_->partitions[destination_];
+
+  // The sequence number is the index of the next range to read. The ranges
+  // are read synchronously, outside of the queue mutex.
+  std::vector<std::unique_ptr<SerializedPage>> pages;
+  uint64_t totalBytes = 0;
+  auto next = sequence_;
+  while (next < ranges.size() && (pages.empty() || totalBytes < maxBytes)) {
+    const auto& range = ranges[next++];
+    auto iobuf = folly::IOBuf::create(range.size);
+    file(range.file).pread(range.offset, range.size, iobuf->writableData());
+    iobuf->append(range.size);
+    pages.push_back(std::make_unique<SerializedPage>(std::move(iobuf), pool_));
+    totalBytes += range.size;
+  }
+
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(queue_->mutex());
+    requestPending_ = false;
+    for (auto& page : pages) {
+      queue_->enqueueLocked(std::move(page), promises);
+    }
+    sequence_ = next;
+    if (next == ranges.size()) {
+      queue_->enqueueLocked(nullptr, promises);
+      atEnd_ = true;
+    }
+    uint64_t remainingBytes = 0;
+    for (auto i = next; i < ranges.size(); ++i) {
+      remainingBytes += ranges[i].size;
+    }
+    finishRequestLocked(totalBytes, remainingBytes);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void ShuffleReadExchangeSource::close() {
+  files_.clear();
+}
+
+// static
+std::unique_ptr<ExchangeSource> ShuffleReadExchangeSource::create(
+    const std::string& taskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* FOLLY_NONNULL pool) {
+  if (taskId.compare(0, kScheme.size(), kScheme) == 0) {
+    return std::make_unique<ShuffleReadExchangeSource>(
+        taskId, destination, std::move(queue), pool);
+  }
+  return nullptr;
+}
+
+} // namespace facebook::velox::exec
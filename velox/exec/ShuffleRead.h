@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/file/File.h"
+#include "velox/exec/Exchange.h"
+#include "velox/exec/ShuffleIndex.h"
+
+namespace facebook::velox::exec {
+
+/// Reads one partition of a persistent shuffle written by ShuffleWrite. The
+/// remote task id is 'shuffle://<path>', where <path> is
+/// '<shuffleDirectory>/<taskId>' of the producer and may be on any registered
+/// file system, e.g. local disk or S3. The source reads the index on the
+/// first request and then reads the ranges of the partition in order, one or
+/// more ranges per request up to the requested byte limit. Each range becomes
+/// one page in the queue.
+/// Register with ExchangeSource::registerFactory(
+/// ShuffleReadExchangeSource::create).
+class ShuffleReadExchangeSource : public ExchangeSource {
+ public:
+  static constexpr std::string_view kScheme{"shuffle://"};
+
+  ShuffleReadExchangeSource(
+      const std::string& taskId,
+      int destination,
+      std::shared_ptr<ExchangeQueue> queue,
+      memory::MemoryPool* FOLLY_NONNULL pool);
+
+  bool shouldRequestLocked() override;
+
+  void request(uint64_t maxBytes) override;
+
+  void close() override;
+
+  static std::unique_ptr<ExchangeSource> create(
+      const std::string& taskId,
+      int destination,
+      std::shared_ptr<ExchangeQueue> queue,
+      memory::MemoryPool* FOLLY_NONNULL pool);
+
+ private:
+  void readIndex();
+
+  // Returns the file for 'ShuffleIndex::files[file]', opening it on first use.
+  ReadFile& file(int32_t file);
+
+  // The path without the scheme.
+  const std::string path_;
+  std::optional<ShuffleIndex> index_;
+  std::vector<std::unique_ptr<ReadFile>> files_;
+};
+
+} // namespace facebook::velox::exec
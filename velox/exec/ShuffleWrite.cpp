@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/ShuffleWrite.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+ShuffleWrite::ShuffleWrite(
+    int32_t operatorId,
+    DriverCtx* FOLLY_NONNULL ctx,
+    const std::shared_ptr<const core::ShuffleWriteNode>& planNode)
+    : Operator(
+          ctx,
+          planNode->outputType(),
+          operatorId,
+          planNode->id(),
+          "ShuffleWrite"),
+      numPartitions_(planNode->numPartitions()),
+      partitionFunction_(
+          numPartitions_ == 1
+              ? nullptr
+              : planNode->partitionFunctionSpec().create(numPartitions_)),
+      path_(fmt::format(
+          "{}/{}", planNode->shuffleDirectory(), ctx->task->taskId())),
+      dataPath_(ShuffleIndex::dataPath(path_, ctx->driverId)),
+      maxBufferedBytes_(ctx->task->queryCtx()
+                            ->queryConfig()
+                            .maxPartitionedOutputBufferSize()),
+      serdeOptions_(PartitionedOutput::serdeOptions(
+          ctx->task->queryCtx()->queryConfig())),
+      streams_(numPartitions_),
+      ranges_(numPartitions_),
+      partitionRows_(numPartitions_) {
+  VELOX_CHECK_EQ(
+      ctx->splitGroupId,
+      kUngroupedGroupId,
+      "ShuffleWrite does not support grouped execution");
+}
+
+void ShuffleWrite::addInput(RowVectorPtr input) {
+  {
+    auto lockedStats = stats_.wlock();
+    lockedStats->addOutputVector(input->estimateFlatSize(), input->size());
+  }
+  for (auto& child : input->children()) {
+    child->loadedVector();
+  }
+
+  const auto numInput = input->size();
+  for (auto& rows : partitionRows_) {
+    rows.clear();
+  }
+  if (numPartitions_ == 1) {
+    partitionRows_[0].push_back(IndexRange{0, numInput});
+  } else {
+    partitionFunction_->partition(*input, partitions_);
+    for (vector_size_t i = 0; i < numInput; ++i) {
+      partitionRows_[partitions_[i]].push_back(IndexRange{i, 1});
+    }
+  }
+
+  for (auto partition = 0; partition < numPartitions_; ++partition) {
+    const auto& rows = partitionRows_[partition];
+    if (rows.empty()) {
+      continue;
+    }
+    auto& stream = streams_[partition];
+    if (!stream) {
+      stream = std::make_unique<VectorStreamGroup>(pool());
+      stream->createStreamTree(outputType_, rows.size(), &serdeOptions_);
+    }
+    bufferedBytes_ -= stream->size();
+    stream->append(input, folly::Range(rows.data(), rows.size()));
+    bufferedBytes_ += stream->size();
+  }
+
+  if (bufferedBytes_ >= maxBufferedBytes_) {
+    flush();
+  }
+}
+
+void ShuffleWrite::flush() {
+  if (!dataFile_) {
+    auto fs = filesystems::getFileSystem(dataPath_, nullptr);
+    dataFile_ = fs->openFileForWrite(dataPath_);
+  }
+  auto bufferManager = PartitionedOutputBufferManager::getInstance().lock();
+  VELOX_CHECK_NOT_NULL(bufferManager, "invalid PartitionedOutputBufferManager");
+  const auto initialSize = dataFile_->size();
+  for (auto partition = 0; partition < numPartitions_; ++partition) {
+    auto& stream = streams_[partition];
+    if (!stream) {
+      continue;
+    }
+    auto listener = bufferManager->newListener();
+    IOBufOutputStream out(*pool(), listener.get(), stream->size());
+    stream->flush(&out);
+    stream.reset();
+    const auto offset = dataFile_->size();
+    auto iobuf = out.getIOBuf();
+    for (auto& range : *iobuf) {
+      dataFile_->append(std::string_view(
+          reinterpret_cast<const char*>(range.data()), range.size()));
+    }
+    ranges_[partition].push_back(
+        ShuffleIndex::Range{0, offset, dataFile_->size() - offset});
+  }
+  bufferedBytes_ = 0;
+  addRuntimeStat(
+      "shuffleWrittenBytes",
+      RuntimeCounter(
+          dataFile_->size() - initialSize, RuntimeCounter::Unit::kBytes));
+}
+
+void ShuffleWrite::noMoreInput() {
+  Operator::noMoreInput();
+  flush();
+  dataFile_->close();
+
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last Driver to finish writes the index of the data files of all
+  // Drivers. The other Drivers wait for the index so that the output is
+  // complete when the Task finishes.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+
+  std::vector<ShuffleWrite*> peerWriters;
+  for (auto& peer : peers) {
+    auto* op = peer->findOperator(planNodeId());
+    auto* writer = dynamic_cast<ShuffleWrite*>(op);
+    VELOX_CHECK(writer);
+    peerWriters.push_back(writer);
+  }
+  writeIndex(peerWriters);
+
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void ShuffleWrite::writeIndex(const std::vector<ShuffleWrite*>& peers) {
+  ShuffleIndex index;
+  index.partitions.resize(numPartitions_);
+  auto addRanges = [&](const ShuffleWrite& writer) {
+    const int32_t file = index.files.size();
+    index.files.push_back(writer.dataPath_.substr(path_.size()));
+    for (auto partition = 0; partition < numPartitions_; ++partition) {
+      for (const auto& range : writer.ranges_[partition]) {
+        index.partitions[partition].push_back(
+            ShuffleIndex::Range{file, range.offset, range.size});
+      }
+    }
+  };
+  addRanges(*this);
+  for (const auto* peer : peers) {
+    addRanges(*peer);
+  }
+
+  const auto indexPath = ShuffleIndex::indexPath(path_);
+  auto fs = filesystems::getFileSystem(indexPath, nullptr);
+  auto file = fs->openFileForWrite(indexPath);
+  file->append(index.serialize());
+  file->close();
+}
+
+BlockingReason ShuffleWrite::isBlocked(ContinueFuture* future) {
+  if (!future_.valid()) {
+    return BlockingReason::kNotBlocked;
+  }
+  // Waits for the last Driver to make the output visible to consumers.
+  *future = std::move(future_);
+  return BlockingReason::kWaitForConsumer;
+}
+
+void ShuffleWrite::close() {
+  streams_.clear();
+  dataFile_.reset();
+  Operator::close();
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/file/File.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/ShuffleIndex.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/VectorStream.h"
+
+namespace facebook::velox::exec {
+
+/// Writes its input to a persistent shuffle, see core::ShuffleWriteNode. The
+/// input rows are serialized per partition in the same format as
+/// PartitionedOutput. When the serialized data exceeds the output buffer size,
+/// the pages of all partitions are appended to the data file of the driver
+/// in partition order. The last driver to finish writes the index of all data
+/// files of the task.
+class ShuffleWrite : public Operator {
+ public:
+  ShuffleWrite(
+      int32_t operatorId,
+      DriverCtx* FOLLY_NONNULL ctx,
+      const std::shared_ptr<const core::ShuffleWriteNode>& planNode);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  void noMoreInput() override;
+
+  RowVectorPtr getOutput() override {
+    return nullptr;
+  }
+
+  BlockingReason isBlocked(ContinueFuture* FOLLY_NONNULL future) override;
+
+  bool isFinished() override {
+    return noMoreInput_ && !future_.valid();
+  }
+
+  void close() override;
+
+ private:
+  // Appends the buffered pages of all partitions to the data file.
+  void flush();
+
+  // Writes the index for the ranges of 'this' and 'peers'.
+  void writeIndex(const std::vector<ShuffleWrite*>& peers);
+
+  const int numPartitions_;
+  std::unique_ptr<core::PartitionFunction> partitionFunction_;
+  // '<shuffleDirectory>/<taskId>'.
+  const std::string path_;
+  const std::string dataPath_;
+  const uint64_t maxBufferedBytes_;
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
+
+  // Serialized pages being accumulated for each partition.
+  std::vector<std::unique_ptr<VectorStreamGroup>> streams_;
+  uint64_t bufferedBytes_{0};
+
+  std::unique_ptr<WriteFile> dataFile_;
+  // Ranges of 'dataFile_' for each partition.
+  std::vector<std::vector<ShuffleIndex::Range>> ranges_;
+
+  // Reusable memory.
+  std::vector<uint32_t> partitions_;
+  std::vector<std::vector<IndexRange>> partitionRows_;
+
+  // Future for waiting on the last driver to write the index.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+};
+
+} // namespace facebook::velox::exec
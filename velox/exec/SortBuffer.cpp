@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/SortBuffer.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
+
+namespace facebook::velox::exec {
+
+SortBuffer::SortBuffer(
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& sortColumnIndices,
+    const std::vector<CompareFlags>& sortCompareFlags,
+    uint32_t outputBatchSize,
+    memory::MemoryPool* pool,
+    std::optional<Spiller::Config> spillConfig,
+    uint64_t spillMemoryThreshold,
+    bool columnarRowContainer)
+    : inputType_(inputType),
+      sortCompareFlags_(sortCompareFlags),
+      outputBatchSize_(std::max<uint32_t>(1, outputBatchSize)),
+      pool_(pool),
+      spillConfig_(std::move(spillConfig)),
+      spillMemoryThreshold_(spillMemoryThreshold) {
+  VELOX_CHECK_EQ(sortColumnIndices.size(), sortCompareFlags.size());
+  VELOX_CHECK(!sortColumnIndices.empty(), "SortBuffer needs sort columns");
+
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<TypePtr> types;
+  std::vector<std::string> names;
+  std::unordered_set<column_index_t> keyChannelSet;
+  for (column_index_t i = 0; i < sortColumnIndices.size(); ++i) {
+    const auto channel = sortColumnIndices[i];
+    VELOX_CHECK_LT(channel, inputType_->size());
+    VELOX_CHECK(
+        keyChannelSet.emplace(channel).second,
+        "Duplicate sort column: {}",
+        inputType_->nameOf(channel));
+    columnMap_.emplace_back(i, channel);
+    keyTypes.push_back(inputType_->childAt(channel));
+    types.push_back(keyTypes.back());
+    names.push_back(inputType_->nameOf(channel));
+  }
+  for (column_index_t channel = 0, nextColumn = keyTypes.size();
+       channel < inputType_->size();
+       ++channel) {
+    if (keyChannelSet.count(channel) != 0) {
+      continue;
+    }
+    columnMap_.emplace_back(nextColumn++, channel);
+    dependentTypes.push_back(inputType_->childAt(channel));
+    types.push_back(dependentTypes.back());
+    names.push_back(inputType_->nameOf(channel));
+  }
+
+  data_ = std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, pool_, columnarRowContainer);
+  spillType_ = ROW(std::move(names), std::move(types));
+}
+
+void SortBuffer::addInput(const RowVectorPtr& input) {
+  VELOX_CHECK(!noMoreInput_);
+  ensureInputFits(input);
+
+  const auto numRows = input->size();
+  inputRows_.resize(numRows);
+  addedRows_.resize(numRows);
+  for (auto row = 0; row < numRows; ++row) {
+    addedRows_[row] = data_->newRow();
+  }
+  for (const auto& projection : columnMap_) {
+    decoded_.decode(*input->childAt(projection.outputChannel), inputRows_);
+    for (auto row = 0; row < numRows; ++row) {
+      data_->store(decoded_, row, addedRows_[row], projection.inputChannel);
+    }
+  }
+  numInputRows_ += numRows;
+}
+
+void SortBuffer::ensureInputFits(const RowVectorPtr& input) {
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
+    return;
+  }
+
+  auto tracker = pool_->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if ((spillMemoryThreshold_ != 0 &&
+       data_->allocatedBytes() > spillMemoryThreshold_) ||
+      tracker->highUsage()) {
+    const int64_t bytesToSpill =
+        currentUsage * spillConfig.spillableReservationGrowthPct / 100;
+    auto rowsToSpill = std::max<int64_t>(
+        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
+    spill(
+        std::max<int64_t>(0, numRows - rowsToSpill),
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation. The peak is predicted from the input bytes
+  // stored so far and in this input, plus the sort buffer of a pointer per
+  // row, which is allocated after all the input is received.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  const int64_t sortBufferBytes = (numRows + input->size()) * sizeof(char*);
+  if (tracker->reservePredictedPeak(
+          currentUsage + targetIncrementBytes + sortBufferBytes)) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+void SortBuffer::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        data_->keyTypes().size(),
+        sortCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.maxSpillWriteParallelism,
+        spillConfig.directIo,
+        spillConfig.tiers);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
+}
+
+void SortBuffer::noMoreInput(
+    folly::Executor* executor,
+    int32_t sortParallelism,
+    CpuWallTiming* sortTiming) {
+  VELOX_CHECK(!noMoreInput_);
+  noMoreInput_ = true;
+  if (numInputRows_ == 0) {
+    return;
+  }
+
+  if (spiller_ == nullptr) {
+    VELOX_CHECK_EQ(numInputRows_, data_->numRows());
+    // Sort the pointers to the rows in 'data_' instead of sorting the rows.
+    sortedRows_.resize(numInputRows_);
+    RowContainerIterator iter;
+    data_->listRows(&iter, numInputRows_, sortedRows_.data());
+    PrefixSort::sort(
+        *data_,
+        sortCompareFlags_,
+        folly::Range<char**>(sortedRows_.data(), sortedRows_.size()),
+        executor,
+        sortParallelism,
+        sortTiming);
+  } else {
+    // Finish spill, and we shouldn't get any rows from non-spilled partition
+    // as there is only one partition. The rows left in 'data_' are merged
+    // with the spilled runs.
+    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    VELOX_CHECK_NULL(spillMerge_);
+    spillMerge_ = spiller_->startMerge(0);
+  }
+}
+
+RowVectorPtr SortBuffer::getOutput() {
+  VELOX_CHECK(noMoreInput_);
+  if (numOutputRows_ == numInputRows_) {
+    return nullptr;
+  }
+  prepareOutput(std::min<vector_size_t>(
+      numInputRows_ - numOutputRows_, outputBatchSize_));
+  if (spiller_ != nullptr) {
+    getOutputWithSpill();
+  } else {
+    getOutputWithoutSpill();
+  }
+  return output_;
+}
+
+void SortBuffer::prepareOutput(vector_size_t size) {
+  if (output_ != nullptr) {
+    VectorPtr output = std::move(output_);
+    BaseVector::prepareForReuse(output, size);
+    output_ = std::static_pointer_cast<RowVector>(output);
+  } else {
+    output_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(inputType_, size, pool_));
+  }
+  for (auto& child : output_->children()) {
+    child->resize(size);
+  }
+}
+
+void SortBuffer::getOutputWithoutSpill() {
+  for (const auto& projection : columnMap_) {
+    data_->extractColumn(
+        sortedRows_.data() + numOutputRows_,
+        output_->size(),
+        projection.inputChannel,
+        output_->childAt(projection.outputChannel));
+  }
+  numOutputRows_ += output_->size();
+}
+
+void SortBuffer::getOutputWithSpill() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  spillSources_.resize(output_->size());
+  spillSourceRows_.resize(output_->size());
+
+  int32_t outputRow = 0;
+  int32_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < output_->size()) {
+    SpillMergeStream* stream = spillMerge_->next();
+    VELOX_CHECK_NOT_NULL(stream);
+
+    spillSources_[outputSize] = &stream->current();
+    spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
+    ++outputSize;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherCopy(
+          output_.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+    stream->pop();
+  }
+
+  if (FOLLY_LIKELY(outputSize != 0)) {
+    gatherCopy(
+        output_.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+  }
+  numOutputRows_ += output_->size();
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Executor.h>
+
+#include "velox/common/time/CpuWallTimer.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
+
+namespace facebook::velox::exec {
+
+/// Buffers the input rows in a RowContainer and returns them sorted on
+/// 'sortColumnIndices' after all the input is received. This is the sorting
+/// logic of the OrderBy operator. It is also used outside of operators, e.g.
+/// by a table writer that sorts the rows of each file it writes.
+///
+/// If 'spillConfig' is set, addInput() spills rows in sorted runs when the
+/// memory reservation of 'pool' cannot grow to fit the input or the buffered
+/// rows take more than 'spillMemoryThreshold' bytes. The spilled runs are
+/// merged with the rows in memory at output.
+class SortBuffer {
+ public:
+  SortBuffer(
+      const RowTypePtr& inputType,
+      const std::vector<column_index_t>& sortColumnIndices,
+      const std::vector<CompareFlags>& sortCompareFlags,
+      uint32_t outputBatchSize,
+      memory::MemoryPool* pool,
+      std::optional<Spiller::Config> spillConfig = std::nullopt,
+      uint64_t spillMemoryThreshold = 0,
+      bool columnarRowContainer = false);
+
+  void addInput(const RowVectorPtr& input);
+
+  /// Sorts the buffered rows or finishes spilling. The sort uses up to
+  /// 'sortParallelism' threads of 'executor' and adds its time to
+  /// 'sortTiming' if not null. No input may be added after this.
+  void noMoreInput(
+      folly::Executor* executor = nullptr,
+      int32_t sortParallelism = 1,
+      CpuWallTiming* sortTiming = nullptr);
+
+  /// Returns the next batch of at most 'outputBatchSize' sorted rows, or
+  /// nullptr after all the rows have been returned.
+  RowVectorPtr getOutput();
+
+  /// Returns true if spilling is enabled and there are buffered rows to
+  /// spill. Rows cannot be spilled after noMoreInput().
+  bool canSpill() const {
+    return spillConfig_.has_value() && !noMoreInput_ && data_->numRows() > 0;
+  }
+
+  /// Spills rows until under 'targetRows' rows and under 'targetBytes' bytes
+  /// of out of line data are left. If 'targetRows' is 0, spills all the rows
+  /// and frees the memory of 'data_'.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  uint64_t numInputRows() const {
+    return numInputRows_;
+  }
+
+  uint64_t numOutputRows() const {
+    return numOutputRows_;
+  }
+
+  /// Returns the spill stats, or empty stats if no spilling happened.
+  Spiller::Stats spillStats() const {
+    return spiller_ == nullptr ? Spiller::Stats{} : spiller_->stats();
+  }
+
+ private:
+  // Checks if 'input' will fit in the existing memory and increases the
+  // reservation if not. If the reservation cannot be increased, spills
+  // enough to make 'input' fit.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  void prepareOutput(vector_size_t size);
+
+  void getOutputWithoutSpill();
+
+  void getOutputWithSpill();
+
+  const RowTypePtr inputType_;
+  const std::vector<CompareFlags> sortCompareFlags_;
+  const uint32_t outputBatchSize_;
+  memory::MemoryPool* const pool_;
+  const std::optional<Spiller::Config> spillConfig_;
+  const uint64_t spillMemoryThreshold_;
+
+  // The map from the column in 'data_' to the input channel. The sort
+  // columns are stored first in 'data_' to be able to sort and merge the
+  // spilled rows.
+  std::vector<IdentityProjection> columnMap_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr spillType_;
+
+  std::unique_ptr<RowContainer> data_;
+
+  // Reusable memory for adding input.
+  SelectivityVector inputRows_;
+  DecodedVector decoded_;
+  std::vector<char*> addedRows_;
+
+  bool noMoreInput_{false};
+
+  uint64_t numInputRows_{0};
+
+  uint64_t numOutputRows_{0};
+
+  // The sorted rows of 'data_' if nothing was spilled.
+  std::vector<char*> sortedRows_;
+
+  RowVectorPtr output_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back the spilled runs in order if spilling happened.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Record the source rows to copy to 'output_' in order.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+};
+
+} // namespace facebook::velox::exec
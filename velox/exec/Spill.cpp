@@ -15,7 +15,10 @@
  */
 
 #include "velox/exec/Spill.h"
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/IoUring.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/serializers/PrestoSerializer.h"
 
@@ -29,14 +32,99 @@ namespace facebook::velox::exec {
 static const serializer::presto::PrestoVectorSerde::PrestoOptions
     kDefaultSerdeOptions(/*useLosslessTimestamp*/ true);
 
+namespace {
+// The header of a compressed block which consists of the uncompressed and
+// compressed byte sizes of the block.
+constexpr int32_t kCompressedBlockHeaderSize = 2 * sizeof(int32_t);
+} // namespace
+
+std::string SpillTiers::tierName(Tier tier) {
+  switch (tier) {
+    case Tier::kLocal:
+      return "LOCAL";
+    case Tier::kOverflow:
+      return "OVERFLOW";
+    default:
+      VELOX_UNREACHABLE("Unknown spill tier: {}", static_cast<int>(tier));
+  }
+}
+
+std::string SpillTiers::path(Tier tier, const std::string& localPath) const {
+  if (tier == Tier::kLocal) {
+    return localPath;
+  }
+  VELOX_CHECK_EQ(
+      localPath.compare(0, localDirectory_.size(), localDirectory_),
+      0,
+      "Spill path {} is not under the spill directory {}",
+      localPath,
+      localDirectory_);
+  return overflowDirectory_ + localPath.substr(localDirectory_.size());
+}
+
 std::atomic<int32_t> SpillFile::ordinalCounter_;
 
+SpillInput::SpillInput(
+    std::unique_ptr<ReadFile>&& input,
+    BufferPtr buffer,
+    BufferPtr prefetchBuffer,
+    uint64_t alignment)
+    : input_(std::move(input)),
+      buffer_(std::move(buffer)),
+      prefetchBuffer_(
+          input_->hasPreadvAsync() ? std::move(prefetchBuffer) : nullptr),
+      alignment_(alignment),
+      readSize_(
+          alignment_ == 0
+              ? buffer_->capacity()
+              : (buffer_->capacity() - alignment_) / alignment_ * alignment_),
+      size_(input_->size()) {
+  VELOX_CHECK_GT(readSize_, 0);
+  if (prefetchBuffer_ != nullptr) {
+    VELOX_CHECK_EQ(buffer_->capacity(), prefetchBuffer_->capacity());
+  }
+  next(true);
+}
+
+SpillInput::~SpillInput() {
+  // Wait for the pending read so that it does not write into a freed buffer.
+  if (prefetch_.has_value()) {
+    std::move(prefetch_.value()).wait();
+  }
+}
+
 void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
+  if (prefetch_.has_value()) {
+    const auto readBytes = std::move(prefetch_.value()).get();
+    prefetch_.reset();
+    VELOX_CHECK_EQ(readBytes, prefetchBytes_, "Short read from spill file");
+    std::swap(buffer_, prefetchBuffer_);
+    setRange(
+        {reinterpret_cast<uint8_t*>(bufferData(buffer_)),
+         static_cast<int32_t>(readBytes),
+         0});
+    maybePrefetch();
+    return;
+  }
+  int32_t readBytes = std::min(input_->size() - offset_, readSize_);
   VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
-  setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
+  auto* data = bufferData(buffer_);
+  setRange({reinterpret_cast<uint8_t*>(data), readBytes, 0});
+  input_->pread(offset_, readBytes, data);
   offset_ += readBytes;
+  maybePrefetch();
+}
+
+void SpillInput::maybePrefetch() {
+  VELOX_CHECK(!prefetch_.has_value());
+  if (prefetchBuffer_ == nullptr || offset_ >= size_) {
+    return;
+  }
+  prefetchBytes_ = std::min(size_ - offset_, readSize_);
+  prefetch_ = input_->preadvAsync(
+      offset_,
+      {folly::Range<char*>(bufferData(prefetchBuffer_), prefetchBytes_)});
+  offset_ += prefetchBytes_;
 }
 
 void SpillMergeStream::pop() {
@@ -48,46 +136,134 @@ void SpillMergeStream::pop() {
 WriteFile& SpillFile::output() {
   if (!output_) {
     auto fs = filesystems::getFileSystem(path_, nullptr);
-    output_ = fs->openFileForWrite(path_);
+    filesystems::FileOptions options;
+    options.pool = &pool_;
+    options.directIo = directIo_;
+    output_ = fs->openFileForWrite(path_, options);
   }
   return *output_;
 }
 
+void SpillFile::write(std::unique_ptr<folly::IOBuf> iobuf) {
+  const auto uncompressedSize = iobuf->computeChainDataLength();
+  uncompressedSize_ += uncompressedSize;
+  auto& file = output();
+  if (codec_ != nullptr) {
+    VELOX_CHECK_LE(uncompressedSize, std::numeric_limits<int32_t>::max());
+    iobuf = codec_->compress(iobuf.get());
+    const auto compressedSize = iobuf->computeChainDataLength();
+    VELOX_CHECK_LE(compressedSize, std::numeric_limits<int32_t>::max());
+    int32_t header[2] = {
+        static_cast<int32_t>(uncompressedSize),
+        static_cast<int32_t>(compressedSize)};
+    static_assert(sizeof(header) == kCompressedBlockHeaderSize);
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(header), kCompressedBlockHeaderSize));
+  }
+  for (auto& range : *iobuf) {
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(range.data()), range.size()));
+  }
+}
+
 void SpillFile::startRead() {
   constexpr uint64_t kMaxReadBufferSize =
       (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
+  // A read of remote storage has a high latency, so the overflow files are
+  // read in larger ranges, which are also prefetched if the file system
+  // supports async reads.
+  constexpr uint64_t kMaxOverflowReadBufferSize =
+      (8 << 20) - AlignedBuffer::kPaddedSize; // 8MB - padding.
   VELOX_CHECK(!output_);
-  VELOX_CHECK(!input_);
+  input_.reset();
   auto fs = filesystems::getFileSystem(path_, nullptr);
-  auto file = fs->openFileForRead(path_);
-  auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  filesystems::FileOptions options;
+  options.directIo = directIo_;
+  auto file = fs->openFileForRead(path_, options);
+  auto readSize = std::min<uint64_t>(
+      fileSize_,
+      tier_ == SpillTiers::Tier::kOverflow ? kMaxOverflowReadBufferSize
+                                           : kMaxReadBufferSize);
+  uint64_t bufferSize = readSize;
+  // Direct reads need aligned offsets and buffers. The buffers are padded
+  // for aligning their start.
+  uint64_t alignment = 0;
+  if (directIo_) {
+    alignment = IoUring::kDirectIoAlignment;
+    bufferSize = bits::roundUp(readSize, alignment) + alignment;
+  }
+  auto buffer = AlignedBuffer::allocate<char>(bufferSize, &pool_);
+  // Double buffer the reads if the file spans more than one buffer and the
+  // file system supports async reads.
+  BufferPtr prefetchBuffer;
+  if (fileSize_ > readSize && file->hasPreadvAsync()) {
+    prefetchBuffer = AlignedBuffer::allocate<char>(bufferSize, &pool_);
+  }
+  input_ = std::make_unique<SpillInput>(
+      std::move(file),
+      std::move(buffer),
+      std::move(prefetchBuffer),
+      alignment);
 }
 
 bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
   if (input_->atEnd()) {
     return false;
   }
+  if (codec_ == nullptr) {
+    VectorStreamGroup::read(
+        input_.get(), &pool_, type_, &rowVector, &kDefaultSerdeOptions);
+    return true;
+  }
+
+  const auto uncompressedSize = input_->read<int32_t>();
+  const auto compressedSize = input_->read<int32_t>();
+  if (compressedBuffer_ == nullptr ||
+      compressedBuffer_->capacity() < compressedSize) {
+    compressedBuffer_ = AlignedBuffer::allocate<char>(compressedSize, &pool_);
+  }
+  input_->readBytes(compressedBuffer_->asMutable<char>(), compressedSize);
+  auto compressed = folly::IOBuf::wrapBufferAsValue(
+      compressedBuffer_->as<char>(), compressedSize);
+  auto uncompressed = codec_->uncompress(&compressed, uncompressedSize);
+
+  std::vector<ByteRange> ranges;
+  for (const auto& range : *uncompressed) {
+    ranges.push_back(
+        {const_cast<uint8_t*>(range.data()),
+         static_cast<int32_t>(range.size()),
+         0});
+  }
+  ByteStream batchInput;
+  batchInput.resetInput(std::move(ranges));
   VectorStreamGroup::read(
-      input_.get(), &pool_, type_, &rowVector, &kDefaultSerdeOptions);
+      &batchInput, &pool_, type_, &rowVector, &kDefaultSerdeOptions);
   return true;
 }
 
-WriteFile& SpillFileList::currentOutput() {
+SpillFile& SpillFileList::currentOutput() {
   if (files_.empty() || !files_.back()->isWritable() ||
       files_.back()->size() > targetFileSize_) {
     if (!files_.empty() && files_.back()->isWritable()) {
       files_.back()->finishWrite();
     }
+    auto path = fmt::format("{}-{}", path_, files_.size());
+    auto tier = SpillTiers::Tier::kLocal;
+    if (tiers_ != nullptr) {
+      tier = tiers_->nextFileTier();
+      path = tiers_->path(tier, path);
+    }
     files_.push_back(std::make_unique<SpillFile>(
         type_,
         numSortingKeys_,
         sortCompareFlags_,
-        fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        path,
+        pool_,
+        compressionKind_,
+        directIo_ && tier == SpillTiers::Tier::kLocal,
+        tier));
   }
-  return files_.back()->output();
+  return *files_.back();
 }
 
 void SpillFileList::flush() {
@@ -96,11 +272,11 @@ void SpillFileList::flush() {
         pool_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
     batch_->flush(&out);
     batch_.reset();
-    auto iobuf = out.getIOBuf();
-    auto& file = currentOutput();
-    for (auto& range : *iobuf) {
-      file.append(std::string_view(
-          reinterpret_cast<const char*>(range.data()), range.size()));
+    auto& output = currentOutput();
+    const auto sizeBefore = output.size();
+    output.write(out.getIOBuf());
+    if (tiers_ != nullptr) {
+      tiers_->addSpilledBytes(output.tier(), output.size() - sizeBefore);
     }
   }
 }
@@ -138,11 +314,32 @@ uint64_t SpillFileList::spilledBytes() const {
   return bytes;
 }
 
+uint64_t SpillFileList::spilledUncompressedBytes() const {
+  uint64_t bytes = 0;
+  for (auto& file : files_) {
+    bytes += file->uncompressedSize();
+  }
+  return bytes;
+}
+
 void SpillFileList::recordRuntimeStats() {
   for (const auto& file : files_) {
     addThreadLocalRuntimeStat(
         "spillFileSize",
-        RuntimeCounter(file->size(), RuntimeCounter::Unit::kBytes));
+        RuntimeCounter(file->size(), RuntimeCounter::Unit::kBytes, true));
+    REPORT_ADD_HISTOGRAM_VALUE(kCounterSpillFileSizeMb, file->size() >> 20);
+    if (compressionKind_ != common::CompressionKind_NONE) {
+      addThreadLocalRuntimeStat(
+          "spillUncompressedFileSize",
+          RuntimeCounter(
+              file->uncompressedSize(), RuntimeCounter::Unit::kBytes));
+    }
+    if (tiers_ != nullptr) {
+      addThreadLocalRuntimeStat(
+          file->tier() == SpillTiers::Tier::kLocal ? "spillLocalBytes"
+                                                   : "spillOverflowBytes",
+          RuntimeCounter(file->size(), RuntimeCounter::Unit::kBytes));
+    }
   }
 }
 
@@ -173,7 +370,10 @@ void SpillState::appendToPartition(
         sortCompareFlags_,
         fmt::format("{}-spill-{}", path_, partition),
         targetFileSize_,
-        pool_);
+        pool_,
+        compressionKind_,
+        directIo_,
+        tiers_);
   }
 
   IndexRange range{0, rows->size()};
@@ -221,6 +421,16 @@ uint64_t SpillState::spilledBytes() const {
   return bytes;
 }
 
+uint64_t SpillState::spilledUncompressedBytes() const {
+  uint64_t bytes = 0;
+  for (auto& list : files_) {
+    if (list) {
+      bytes += list->spilledUncompressedBytes();
+    }
+  }
+  return bytes;
+}
+
 uint32_t SpillState::spilledPartitions() const {
   return spilledPartitionSet_.size();
 }
@@ -271,6 +481,36 @@ std::vector<std::unique_ptr<SpillPartition>> SpillPartition::split(
   return shards;
 }
 
+uint64_t SpillPartition::size() const {
+  uint64_t size = 0;
+  for (const auto& file : files_) {
+    size += file->size();
+  }
+  return size;
+}
+
+SpillFiles SpillPartition::removeFiles(int32_t numFiles) {
+  VELOX_CHECK_LE(numFiles, files_.size());
+  SpillFiles files;
+  files.reserve(numFiles);
+  for (auto i = 0; i < numFiles; ++i) {
+    files.push_back(std::move(files_[i]));
+  }
+  files_.erase(files_.begin(), files_.begin() + numFiles);
+  return files;
+}
+
+std::unique_ptr<UnorderedStreamReader<BatchStream>>
+SpillPartition::createSharedReader() {
+  std::vector<std::unique_ptr<BatchStream>> streams;
+  streams.reserve(files_.size());
+  for (auto& file : files_) {
+    streams.push_back(FileSpillBatchStream::create(file.get()));
+  }
+  return std::make_unique<UnorderedStreamReader<BatchStream>>(
+      std::move(streams));
+}
+
 std::unique_ptr<UnorderedStreamReader<BatchStream>>
 SpillPartition::createReader() {
   std::vector<std::unique_ptr<BatchStream>> streams;
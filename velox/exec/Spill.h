@@ -18,6 +18,7 @@
 
 #include <folly/container/F14Set.h>
 
+#include "velox/common/compression/Compression.h"
 #include "velox/common/file/File.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/exec/UnorderedStreamReader.h"
@@ -28,35 +29,151 @@
 namespace facebook::velox::exec {
 
 // Input stream backed by spill file.
+//
+// If 'prefetchBuffer' is set and 'input' supports native async reads, the next
+// range of the file is read into 'prefetchBuffer' via ReadFile::preadvAsync()
+// while the current range in 'buffer' is being consumed. The two buffers are
+// swapped on each next() call.
+//
+// If 'alignment' is set, the reads start at multiples of 'alignment' in the
+// file and in the buffers, so that a file opened for direct I/O reads them
+// with O_DIRECT. The buffers then need 'alignment' bytes of padding.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
-      : input_(std::move(input)),
-        buffer_(std::move(buffer)),
-        size_(input_->size()) {
-    next(true);
-  }
+  // Reads from 'input' using 'buffer' for buffering reads. 'prefetchBuffer' is
+  // optional and must have the same capacity as 'buffer' if set.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      BufferPtr prefetchBuffer = nullptr,
+      uint64_t alignment = 0);
+
+  ~SpillInput() override;
 
   void next(bool throwIfPastEnd) override;
 
   // True if all of the file has been read into vectors.
   bool atEnd() const {
-    return offset_ >= size_ && ranges()[0].position >= ranges()[0].size;
+    return offset_ >= size_ && ranges()[0].position >= ranges()[0].size &&
+        !prefetch_.has_value();
+  }
+
+  // True if reads of the next range are issued ahead of consumption.
+  bool prefetchEnabled() const {
+    return prefetchBuffer_ != nullptr;
   }
 
  private:
+  // Issues an async read of the next range of 'input_' into 'prefetchBuffer_'
+  // if prefetch is enabled and there is more data to read.
+  void maybePrefetch();
+
+  // Returns the start of the data of 'buffer', aligned to 'alignment_'.
+  char* bufferData(const BufferPtr& buffer) const {
+    auto* data = buffer->asMutable<char>();
+    return alignment_ == 0 ? data
+                           : reinterpret_cast<char*>(bits::roundUp(
+                                 reinterpret_cast<uintptr_t>(data),
+                                 alignment_));
+  }
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
+  // Null if prefetch is disabled.
+  BufferPtr prefetchBuffer_;
+  const uint64_t alignment_;
+  // Max bytes read into a buffer. A multiple of 'alignment_' if set.
+  const uint64_t readSize_;
   const uint64_t size_;
-  // Offset of first byte not in 'buffer_'
+  // Offset of first byte not in 'buffer_' or being read into
+  // 'prefetchBuffer_'.
   uint64_t offset_ = 0;
+  // Pending read into 'prefetchBuffer_' and its size in bytes.
+  std::optional<folly::SemiFuture<uint64_t>> prefetch_;
+  uint64_t prefetchBytes_{0};
+};
+
+/// Places the spill files of the spillers of a task on two tiers. The files
+/// go to the local tier, e.g. a local disk, until the files there total
+/// 'localQuota' bytes and then to the overflow tier, which may be any
+/// registered FileSystem, e.g. S3 or HDFS. A node with a small local disk can
+/// so spill more than fits on the disk. A file is placed when it is started
+/// and is not moved, so the local tier may exceed the quota by up to one
+/// spill file per spiller of the task.
+///
+/// Thread-safe.
+class SpillTiers {
+ public:
+  enum class Tier {
+    kLocal,
+    kOverflow,
+  };
+
+  /// 'localDirectory' is the spill directory of the task, under which the
+  /// spillers make their local file paths. The files on the overflow tier
+  /// have the same paths relative to 'overflowDirectory'.
+  SpillTiers(
+      std::string localDirectory,
+      std::string overflowDirectory,
+      uint64_t localQuota)
+      : localDirectory_(std::move(localDirectory)),
+        overflowDirectory_(std::move(overflowDirectory)),
+        localQuota_(localQuota) {
+    VELOX_CHECK(!localDirectory_.empty());
+    VELOX_CHECK(!overflowDirectory_.empty());
+  }
+
+  static std::string tierName(Tier tier);
+
+  /// Returns the tier of a new spill file.
+  Tier nextFileTier() const {
+    return localBytes_ < localQuota_ ? Tier::kLocal : Tier::kOverflow;
+  }
+
+  /// Returns the path on 'tier' of the spill file with 'localPath', which is
+  /// under the local directory.
+  std::string path(Tier tier, const std::string& localPath) const;
+
+  /// Adds 'bytes' written to the spill files on 'tier'.
+  void addSpilledBytes(Tier tier, uint64_t bytes) {
+    (tier == Tier::kLocal ? localBytes_ : overflowBytes_) += bytes;
+  }
+
+  uint64_t localBytes() const {
+    return localBytes_;
+  }
+
+  uint64_t overflowBytes() const {
+    return overflowBytes_;
+  }
+
+  const std::string& overflowDirectory() const {
+    return overflowDirectory_;
+  }
+
+ private:
+  const std::string localDirectory_;
+  const std::string overflowDirectory_;
+  const uint64_t localQuota_;
+  std::atomic<uint64_t> localBytes_{0};
+  std::atomic<uint64_t> overflowBytes_{0};
 };
 
 /// Represents a spill file that is first in write mode and then
 /// turns into a source of spilled RowVectors. Owns a file system file that
 /// contains the spilled data and is live for the duration of 'this'.
 
+/// If 'compressionKind' is not CompressionKind_NONE, each serialized batch is
+/// compressed as a separate block which is prefixed with its uncompressed and
+/// compressed byte sizes.
+///
+/// If 'directIo' is true, the file is written and read with O_DIRECT where the
+/// file system supports it, with page aligned buffers from 'pool', so that
+/// spilling does not evict the page cache.
+///
+/// 'tier' is the SpillTiers tier of the file. The files on the overflow tier
+/// are read with larger reads, which suit remote storage.
+///
 /// NOTE: The class will not delete spill file upon destruction, so the user
 /// needs to remove the unused spill files at some point later. For example, a
 /// query Task deletes all the generated spill files in one operation using
@@ -68,11 +185,21 @@ class SpillFile {
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      bool directIo = false,
+      SpillTiers::Tier tier = SpillTiers::Tier::kLocal)
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         pool_(pool),
+        compressionKind_(compressionKind),
+        directIo_(directIo),
+        tier_(tier),
+        codec_(
+            compressionKind_ == common::CompressionKind_NONE
+                ? nullptr
+                : common::compressionKindToCodec(compressionKind_)),
         ordinal_(ordinalCounter_++),
         path_(fmt::format("{}-{}", path, ordinal_)) {
     // NOTE: if the spilling operator has specified the sort comparison flags,
@@ -90,6 +217,18 @@ class SpillFile {
     return sortCompareFlags_;
   }
 
+  common::CompressionKind compressionKind() const {
+    return compressionKind_;
+  }
+
+  bool directIo() const {
+    return directIo_;
+  }
+
+  SpillTiers::Tier tier() const {
+    return tier_;
+  }
+
   /// Returns a file for writing spilled data. The caller constructs
   /// this, then calls output() and writes serialized data to the file
   /// and calls finishWrite when the file has reached its final
@@ -97,6 +236,10 @@ class SpillFile {
   // sorted.
   WriteFile& output();
 
+  /// Appends a serialized batch in 'iobuf' to the file. The batch is
+  /// compressed first if 'this' has a compression codec.
+  void write(std::unique_ptr<folly::IOBuf> iobuf);
+
   bool isWritable() const {
     return output_ != nullptr;
   }
@@ -110,6 +253,7 @@ class SpillFile {
 
   /// Prepares 'this' for reading. Positions the read at the first row of
   /// content. The caller must call output() and finishWrite() before this.
+  /// May be called again to read the content from the start one more time.
   void startRead();
 
   bool nextBatch(RowVectorPtr& rowVector);
@@ -124,6 +268,12 @@ class SpillFile {
     return fileSize_;
   }
 
+  /// Returns the byte size of the serialized data written to this file before
+  /// compression. This equals to size() if there is no compression.
+  uint64_t uncompressedSize() const {
+    return uncompressedSize_;
+  }
+
   std::string label() const {
     return fmt::format("{}", ordinal_);
   }
@@ -140,6 +290,11 @@ class SpillFile {
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   memory::MemoryPool& pool_;
+  const common::CompressionKind compressionKind_;
+  const bool directIo_;
+  const SpillTiers::Tier tier_;
+  // Codec for 'compressionKind_'. Null if there is no compression.
+  const std::unique_ptr<folly::io::Codec> codec_;
 
   // Ordinal number used for making a label for debugging.
   const int32_t ordinal_;
@@ -147,8 +302,12 @@ class SpillFile {
 
   // Byte size of the backing file. Set when finishing writing.
   uint64_t fileSize_ = 0;
+  // Byte size of the serialized data before compression.
+  uint64_t uncompressedSize_ = 0;
   std::unique_ptr<WriteFile> output_;
   std::unique_ptr<SpillInput> input_;
+  // Buffers a compressed block read from 'input_' for decompression.
+  BufferPtr compressedBuffer_;
 };
 
 using SpillFiles = std::vector<std::unique_ptr<SpillFile>>;
@@ -163,6 +322,10 @@ class SpillFileList {
   /// data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
   /// target byte size of a single file in the file set. 'pool' is used for
   /// buffering and constructing the result data read from 'this'.
+  /// 'compressionKind' specifies the compression codec of the spill files.
+  /// 'directIo' specifies whether the spill files use O_DIRECT. If 'tiers' is
+  /// set, each new file is placed on the tier it gives and the bytes written
+  /// are added to it. The overflow files never use O_DIRECT.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -172,13 +335,19 @@ class SpillFileList {
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      bool directIo = false,
+      std::shared_ptr<SpillTiers> tiers = nullptr)
       : type_(type),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         path_(path),
         targetFileSize_(targetFileSize),
-        pool_(pool) {
+        pool_(pool),
+        compressionKind_(compressionKind),
+        directIo_(directIo),
+        tiers_(std::move(tiers)) {
     // NOTE: if the associated spilling operator has specified the sort
     // comparison flags, then it must match the number of sorting keys.
     VELOX_CHECK(
@@ -207,6 +376,9 @@ class SpillFileList {
 
   uint64_t spilledBytes() const;
 
+  /// Returns the spilled bytes before compression.
+  uint64_t spilledUncompressedBytes() const;
+
   uint64_t spilledFiles() const {
     return files_.size();
   }
@@ -215,7 +387,7 @@ class SpillFileList {
 
  private:
   // Returns the current file to write to and creates one if needed.
-  WriteFile& currentOutput();
+  SpillFile& currentOutput();
 
   // Writes data from 'batch_' to the current output file.
   void flush();
@@ -230,6 +402,9 @@ class SpillFileList {
   const std::string path_;
   const uint64_t targetFileSize_;
   memory::MemoryPool& pool_;
+  const common::CompressionKind compressionKind_;
+  const bool directIo_;
+  const std::shared_ptr<SpillTiers> tiers_;
   std::unique_ptr<VectorStreamGroup> batch_;
   SpillFiles files_;
 };
@@ -408,6 +583,13 @@ class FileSpillBatchStream : public BatchStream {
     return std::unique_ptr<BatchStream>(spillStream);
   }
 
+  /// Creates a stream that reads 'spillFile' without taking its ownership.
+  /// 'spillFile' must outlive the stream.
+  static std::unique_ptr<BatchStream> create(SpillFile* spillFile) {
+    auto* spillStream = new FileSpillBatchStream(nullptr, spillFile);
+    return std::unique_ptr<BatchStream>(spillStream);
+  }
+
   bool nextBatch(RowVectorPtr& batch) override {
     if (FOLLY_UNLIKELY(!isFileOpened_)) {
       spillFile_->startRead();
@@ -418,7 +600,15 @@ class FileSpillBatchStream : public BatchStream {
 
  private:
   explicit FileSpillBatchStream(std::unique_ptr<SpillFile> spillFile)
-      : isFileOpened_(false), spillFile_(std::move(spillFile)) {
+      : FileSpillBatchStream(std::move(spillFile), nullptr) {}
+
+  FileSpillBatchStream(
+      std::unique_ptr<SpillFile> ownedSpillFile,
+      SpillFile* spillFile)
+      : isFileOpened_(false),
+        ownedSpillFile_(std::move(ownedSpillFile)),
+        spillFile_(
+            ownedSpillFile_ != nullptr ? ownedSpillFile_.get() : spillFile) {
     VELOX_CHECK_NOT_NULL(spillFile_);
   }
 
@@ -427,7 +617,9 @@ class FileSpillBatchStream : public BatchStream {
   // NOTE: we open the file until the first read on this stream object so that
   // we don't open too many files at the same time.
   bool isFileOpened_;
-  std::unique_ptr<SpillFile> spillFile_;
+  // Set if this stream owns 'spillFile_'.
+  std::unique_ptr<SpillFile> ownedSpillFile_;
+  SpillFile* spillFile_;
 };
 
 /// Identifies a spill partition generated from a given spilling operator. It
@@ -521,6 +713,13 @@ class SpillPartition {
     return files_.size();
   }
 
+  /// Returns the total size in bytes of the spill files.
+  uint64_t size() const;
+
+  /// Invoked to move out the first 'numFiles' spill files of this partition,
+  /// e.g. to restore a large partition a few files at a time.
+  SpillFiles removeFiles(int32_t numFiles);
+
   /// Invoked to split this spill partition into 'numShards' to process in
   /// parallel.
   ///
@@ -531,6 +730,11 @@ class SpillPartition {
   /// The created reader will take the ownership of the spill files.
   std::unique_ptr<UnorderedStreamReader<BatchStream>> createReader();
 
+  /// Invoked to create an unordered stream reader from this spill partition
+  /// which doesn't take the ownership of the spill files, so that the data can
+  /// be read again. This partition must outlive the created reader.
+  std::unique_ptr<UnorderedStreamReader<BatchStream>> createSharedReader();
+
  private:
   SpillPartitionId id_;
   SpillFiles files_;
@@ -549,19 +753,27 @@ class SpillState {
   /// 'numSortingKeys' is the number of leading columns on which the data is
   /// sorted, 0 if only hash partitioning is used. 'targetFileSize' is the
   /// target size of a single file.  'pool' owns the memory for state and
-  /// results.
+  /// results. 'compressionKind' is the compression codec of the spill files.
+  /// 'directIo' specifies whether the spill files use O_DIRECT. 'tiers' places
+  /// the spill files on the local or the overflow tier if set.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      bool directIo = false,
+      std::shared_ptr<SpillTiers> tiers = nullptr)
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         targetFileSize_(targetFileSize),
+        compressionKind_(compressionKind),
+        directIo_(directIo),
+        tiers_(std::move(tiers)),
         pool_(pool),
         files_(maxPartitions_) {}
 
@@ -591,6 +803,18 @@ class SpillState {
     return sortCompareFlags_;
   }
 
+  common::CompressionKind compressionKind() const {
+    return compressionKind_;
+  }
+
+  bool directIo() const {
+    return directIo_;
+  }
+
+  const std::shared_ptr<SpillTiers>& tiers() const {
+    return tiers_;
+  }
+
   bool isAllPartitionSpilled() const {
     VELOX_CHECK_LE(spilledPartitionSet_.size(), maxPartitions_);
     return spilledPartitionSet_.size() == maxPartitions_;
@@ -628,6 +852,9 @@ class SpillState {
 
   uint64_t spilledBytes() const;
 
+  /// Returns the spilled bytes before compression.
+  uint64_t spilledUncompressedBytes() const;
+
   /// Return the number of spilled partitions.
   uint32_t spilledPartitions() const;
 
@@ -646,6 +873,9 @@ class SpillState {
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   const uint64_t targetFileSize_;
+  const common::CompressionKind compressionKind_;
+  const bool directIo_;
+  const std::shared_ptr<SpillTiers> tiers_;
 
   memory::MemoryPool& pool_;
 
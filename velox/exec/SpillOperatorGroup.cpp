@@ -167,6 +167,38 @@ bool SpillOperatorGroup::waitSpillLocked(
   return true;
 }
 
+bool SpillOperatorGroup::canReclaim() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return canReclaimLocked();
+}
+
+bool SpillOperatorGroup::canReclaimLocked() const {
+  if (state_ != State::kRunning || needSpill_ || numWaitingOperators_ != 0) {
+    return false;
+  }
+  // NOTE: an operator whose driver is on thread might be in the middle of
+  // updating its spillable data structures, e.g. suspended for memory
+  // arbitration within a memory allocation.
+  for (const auto* op : operators_) {
+    const auto* driver = op->operatorCtx()->driver();
+    if (driver == nullptr || driver->isOnThread()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SpillOperatorGroup::reclaimSpill() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!canReclaimLocked()) {
+      return false;
+    }
+  }
+  spillRunner_(operators_);
+  return true;
+}
+
 void SpillOperatorGroup::runSpill(std::vector<ContinuePromise>& promises) {
   VELOX_CHECK(needSpill_);
   spillRunner_(operators_);
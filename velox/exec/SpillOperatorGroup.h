@@ -110,7 +110,21 @@ class SpillOperatorGroup {
   /// spill for the group.
   bool waitSpill(Operator& op, ContinueFuture& future);
 
+  /// Indicates if the memory arbitrator can reclaim memory from this group by
+  /// running a group spill. It requires the group is running without any
+  /// pending spill, and none of the operators is running on thread.
+  ///
+  /// NOTE: the task of the group is expected to be paused.
+  bool canReclaim();
+
+  /// Invoked by the memory arbitrator to run spill on all the operators in the
+  /// group inline with the task paused. The function returns false if the
+  /// group can't be reclaimed.
+  bool reclaimSpill();
+
  private:
+  bool canReclaimLocked() const;
+
   void checkStoppedStateLocked() const;
 
   // Return the number of non-stopped operators which includes both running and
@@ -17,7 +17,9 @@
 #include "velox/exec/Spiller.h"
 #include <folly/ScopeGuard.h>
 #include "velox/common/base/AsyncSource.h"
+#include "velox/common/process/ProcessBase.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/PrefixSort.h"
 
 using facebook::velox::common::testutil::TestValue;
 
@@ -37,7 +39,11 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    common::CompressionKind compressionKind,
+    int32_t maxSpillWriteParallelism,
+    bool directIo,
+    std::shared_ptr<SpillTiers> tiers)
     : Spiller(
           type,
           container,
@@ -50,8 +56,15 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
-  VELOX_CHECK_EQ(type_, Type::kOrderBy);
+          executor,
+          compressionKind,
+          maxSpillWriteParallelism,
+          directIo,
+          std::move(tiers)) {
+  VELOX_CHECK(
+      type_ == Type::kOrderBy || type_ == Type::kWindow,
+      "Unexpected spiller type: {}",
+      typeName(type_));
 }
 
 Spiller::Spiller(
@@ -62,7 +75,11 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* FOLLY_NULLABLE executor)
+    folly::Executor* FOLLY_NULLABLE executor,
+    common::CompressionKind compressionKind,
+    int32_t maxSpillWriteParallelism,
+    bool directIo,
+    std::shared_ptr<SpillTiers> tiers)
     : Spiller(
           type,
           nullptr,
@@ -75,7 +92,11 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
+          executor,
+          compressionKind,
+          maxSpillWriteParallelism,
+          directIo,
+          std::move(tiers)) {
   VELOX_CHECK_EQ(type_, Type::kHashJoinProbe);
 }
 
@@ -91,7 +112,11 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    common::CompressionKind compressionKind,
+    int32_t maxSpillWriteParallelism,
+    bool directIo,
+    std::shared_ptr<SpillTiers> tiers)
     : type_(type),
       container_(container),
       eraser_(eraser),
@@ -104,15 +129,22 @@ Spiller::Spiller(
           numSortingKeys,
           sortCompareFlags,
           targetFileSize,
-          pool),
+          pool,
+          compressionKind,
+          directIo,
+          std::move(tiers)),
       pool_(pool),
-      executor_(executor) {
+      executor_(executor),
+      maxSpillWriteParallelism_(maxSpillWriteParallelism) {
+  VELOX_CHECK_GE(maxSpillWriteParallelism_, 0);
   TestValue::adjust(
       "facebook::velox::exec::Spiller", const_cast<HashBitRange*>(&bits_));
 
   VELOX_CHECK_EQ(container_ == nullptr, type_ == Type::kHashJoinProbe);
-  // kOrderBy spiller type must only have one partition.
-  VELOX_CHECK((type_ != Type::kOrderBy) || (state_.maxPartitions() == 1));
+  // kOrderBy and kWindow spiller types must only have one partition.
+  VELOX_CHECK(
+      (type_ != Type::kOrderBy && type_ != Type::kWindow) ||
+      (state_.maxPartitions() == 1));
   spillRuns_.reserve(state_.maxPartitions());
   for (int i = 0; i < state_.maxPartitions(); ++i) {
     spillRuns_.emplace_back(pool_);
@@ -242,13 +274,10 @@ std::unique_ptr<SpillMergeStream> Spiller::spillMergeStreamOverRows(
 void Spiller::ensureSorted(SpillRun& run) {
   // The spill data of a hash join doesn't need to be sorted.
   if (!run.sorted && needSort()) {
-    std::sort(
-        run.rows.begin(),
-        run.rows.end(),
-        [&](const char* left, const char* right) {
-          return container_->compareRows(
-                     left, right, state_.sortCompareFlags()) < 0;
-        });
+    PrefixSort::sort(
+        *container_,
+        state_.sortCompareFlags(),
+        folly::Range<char**>(run.rows.data(), run.rows.size()));
     run.sorted = true;
   }
 }
@@ -262,6 +291,7 @@ std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(int32_t partition) {
   constexpr int32_t kTargetBatchBytes = 1 << 18; // 256K
   constexpr int32_t kTargetBatchRows = 64;
 
+  const uint64_t startCpuNanos = process::threadCpuNanos();
   RowVectorPtr spillVector;
   auto& run = spillRuns_[partition];
   try {
@@ -276,7 +306,11 @@ std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(int32_t partition) {
         break;
       }
     }
-    return std::make_unique<SpillStatus>(partition, written, nullptr);
+    return std::make_unique<SpillStatus>(
+        partition,
+        written,
+        nullptr,
+        process::threadCpuNanos() - startCpuNanos);
   } catch (const std::exception& e) {
     // The exception is passed to the caller thread which checks this in
     // advanceSpill().
@@ -286,34 +320,70 @@ std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(int32_t partition) {
 }
 
 void Spiller::advanceSpill() {
-  std::vector<std::shared_ptr<AsyncSource<SpillStatus>>> writes;
+  std::vector<int32_t> partitions;
+  partitions.reserve(pendingSpillPartitions_.size());
   for (auto partition = 0; partition < spillRuns_.size(); ++partition) {
-    if (pendingSpillPartitions_.count(partition) == 0) {
-      continue;
-    }
-    writes.push_back(std::make_shared<AsyncSource<SpillStatus>>(
-        [partition, this]() { return writeSpill(partition); }));
-    if (executor_) {
-      executor_->add([source = writes.back()]() { source->prepare(); });
+    if (pendingSpillPartitions_.count(partition) != 0) {
+      partitions.push_back(partition);
     }
   }
-  auto sync = folly::makeGuard([&]() {
-    for (auto& write : writes) {
-      // We consume the result for the pending writes. This is a
-      // cleanup in the guard and must not throw. The first error is
-      // already captured before this runs.
-      try {
-        write->move();
-      } catch (const std::exception& e) {
+  // Bounds the number of concurrent spill writes on 'executor_'. The waiting
+  // writes are dispatched once the previous ones have finished.
+  const size_t maxParallelWrites =
+      (executor_ == nullptr || maxSpillWriteParallelism_ == 0)
+      ? std::max<size_t>(1, partitions.size())
+      : maxSpillWriteParallelism_;
+
+  std::vector<std::unique_ptr<SpillStatus>> results;
+  results.reserve(partitions.size());
+  const auto startWallTime = std::chrono::steady_clock::now();
+  for (size_t begin = 0; begin < partitions.size();
+       begin += maxParallelWrites) {
+    const size_t end = std::min(partitions.size(), begin + maxParallelWrites);
+    std::vector<std::shared_ptr<AsyncSource<SpillStatus>>> writes;
+    writes.reserve(end - begin);
+    for (auto i = begin; i < end; ++i) {
+      writes.push_back(std::make_shared<AsyncSource<SpillStatus>>(
+          [partition = partitions[i], this]() {
+            return writeSpill(partition);
+          }));
+      if (executor_) {
+        executor_->add([source = writes.back()]() { source->prepare(); });
       }
     }
-  });
+    auto sync = folly::makeGuard([&]() {
+      for (auto& write : writes) {
+        // We consume the result for the pending writes. This is a
+        // cleanup in the guard and must not throw. The first error is
+        // already captured before this runs.
+        try {
+          write->move();
+        } catch (const std::exception& e) {
+        }
+      }
+    });
 
-  std::vector<std::unique_ptr<SpillStatus>> results;
-  results.reserve(writes.size());
-  for (auto& write : writes) {
-    results.push_back(write->move());
+    bool hasError = false;
+    for (auto& write : writes) {
+      results.push_back(write->move());
+      hasError |= results.back()->error != nullptr;
+    }
+    if (hasError) {
+      // The error is rethrown below. No need to start the remaining writes.
+      break;
+    }
   }
+
+  CpuWallTiming timing;
+  timing.count = 1;
+  timing.wallNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - startWallTime)
+                         .count();
+  for (const auto& result : results) {
+    timing.cpuNanos += result->cpuNanos;
+  }
+  spillWriteTiming_.add(timing);
+
   for (auto& result : results) {
     if (result->error) {
       std::rethrow_exception(result->error);
@@ -548,7 +618,8 @@ void Spiller::fillSpillRuns(SpillRows* rowsFromNonSpillingPartitions) {
     for (auto i = 0; i < numRows; ++i) {
       // TODO: consider to cache the hash bits in row container so we only need
       // to calculate them once.
-      const auto partition = (type_ == Type::kOrderBy)
+      const auto partition =
+          (type_ == Type::kOrderBy || type_ == Type::kWindow)
           ? 0
           : bits_.partition(hashes[i], state_.maxPartitions());
       VELOX_DCHECK_GE(partition, 0);
@@ -626,6 +697,8 @@ std::string Spiller::typeName(Type type) {
       return "HASH_JOIN_PROBE";
     case Type::kAggregate:
       return "AGGREGATE";
+    case Type::kWindow:
+      return "WINDOW";
     default:
       VELOX_UNREACHABLE("Unknown type: {}", static_cast<int>(type));
       return fmt::format("UNKNOWN TYPE: {}", static_cast<int>(type));
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/time/CpuWallTimer.h"
 #include "velox/exec/HashBitRange.h"
 #include "velox/exec/RowContainer.h"
 
@@ -33,8 +34,10 @@ class Spiller {
     kHashJoinProbe = 2,
     // Used for order by.
     kOrderBy = 3,
+    // Used for window.
+    kWindow = 4,
   };
-  static constexpr int kNumTypes = 4;
+  static constexpr int kNumTypes = 5;
   static std::string typeName(Type);
 
   // Specifies the config for spilling.
@@ -47,7 +50,12 @@ class Spiller {
         int32_t _spillableReservationGrowthPct,
         const HashBitRange& _hashBitRange,
         int32_t _maxSpillLevel,
-        int32_t _testSpillPct)
+        int32_t _testSpillPct,
+        common::CompressionKind _compressionKind =
+            common::CompressionKind_NONE,
+        int32_t _maxSpillWriteParallelism = 0,
+        bool _directIo = false,
+        std::shared_ptr<SpillTiers> _tiers = nullptr)
         : filePath(_filePath),
           maxFileSize(
               _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
@@ -57,7 +65,11 @@ class Spiller {
           spillableReservationGrowthPct(_spillableReservationGrowthPct),
           hashBitRange(_hashBitRange),
           maxSpillLevel(_maxSpillLevel),
-          testSpillPct(_testSpillPct) {}
+          testSpillPct(_testSpillPct),
+          compressionKind(_compressionKind),
+          maxSpillWriteParallelism(_maxSpillWriteParallelism),
+          directIo(_directIo),
+          tiers(std::move(_tiers)) {}
 
     /// Returns the spilling level with given 'startBitOffset'.
     ///
@@ -104,12 +116,30 @@ class Spiller {
     // Percentage of input batches to be spilled for testing. 0 means no
     // spilling for test.
     int32_t testSpillPct;
+
+    // The compression codec used to compress the spill files.
+    common::CompressionKind compressionKind;
+
+    // The max number of spill partitions written in parallel on 'executor'.
+    // If it is zero, then all the partitions being spilled are written in
+    // parallel.
+    int32_t maxSpillWriteParallelism;
+
+    // Whether the spill files are written and read with O_DIRECT, bypassing
+    // the page cache.
+    bool directIo;
+
+    // Places the spill files on the local tier under 'filePath' or on the
+    // overflow tier, e.g. remote storage, once the local files of the task
+    // exceed a quota. If nullptr, all the spill files are under 'filePath'.
+    std::shared_ptr<SpillTiers> tiers;
   };
 
   using SpillRows = std::vector<char*, memory::StlAllocator<char*>>;
 
   // The constructor without specifying hash bits which will only use one
-  // partition by default. It is only used by kOrderBy spiller type as for now.
+  // partition by default. It is only used by kOrderBy and kWindow spiller
+  // types as for now.
   Spiller(
       Type type,
       RowContainer* FOLLY_NONNULL container,
@@ -121,7 +151,11 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      int32_t maxSpillWriteParallelism = 0,
+      bool directIo = false,
+      std::shared_ptr<SpillTiers> tiers = nullptr);
 
   Spiller(
       Type type,
@@ -131,7 +165,11 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      int32_t maxSpillWriteParallelism = 0,
+      bool directIo = false,
+      std::shared_ptr<SpillTiers> tiers = nullptr);
 
   Spiller(
       Type type,
@@ -145,7 +183,11 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE,
+      int32_t maxSpillWriteParallelism = 0,
+      bool directIo = false,
+      std::shared_ptr<SpillTiers> tiers = nullptr);
 
   /// Spills rows from 'this' until there are under 'targetRows' rows
   /// and 'targetBytes' of allocated variable length space in use. spill()
@@ -255,22 +297,35 @@ class Spiller {
 
   /// Define the spiller stats.
   struct Stats {
+    /// The spilled bytes written to disk which are compressed if spill
+    /// compression is enabled.
     uint64_t spilledBytes{0};
     uint64_t spilledRows{0};
     /// NOTE: when we sum up the stats from a group of spill operators, it is
     /// the total number of spilled partitions X number of operators.
     uint32_t spilledPartitions{0};
     uint64_t spilledFiles{0};
+    /// The spilled bytes before compression.
+    uint64_t spilledUncompressedBytes{0};
+    /// The spill write timing. The wall time is the time spent by the driver
+    /// thread on waiting for the spill writes, and the cpu time is the total
+    /// cpu time of the spill writes which might run in parallel on the spill
+    /// executor.
+    CpuWallTiming spillWriteTiming;
 
     Stats(
         uint64_t _spilledBytes,
         uint64_t _spilledRows,
         uint32_t _spilledPartitions,
-        uint64_t _spilledFiles)
+        uint64_t _spilledFiles,
+        uint64_t _spilledUncompressedBytes,
+        const CpuWallTiming& _spillWriteTiming = {})
         : spilledBytes(_spilledBytes),
           spilledRows(_spilledRows),
           spilledPartitions(_spilledPartitions),
-          spilledFiles(_spilledFiles) {}
+          spilledFiles(_spilledFiles),
+          spilledUncompressedBytes(_spilledUncompressedBytes),
+          spillWriteTiming(_spillWriteTiming) {}
 
     Stats() = default;
 
@@ -279,6 +334,8 @@ class Spiller {
       spilledRows += other.spilledRows;
       spilledPartitions += other.spilledPartitions;
       spilledFiles += other.spilledFiles;
+      spilledUncompressedBytes += other.spilledUncompressedBytes;
+      spillWriteTiming.add(other.spillWriteTiming);
       return *this;
     }
   };
@@ -288,7 +345,9 @@ class Spiller {
         state_.spilledBytes(),
         spilledRows_,
         state_.spilledPartitions(),
-        spilledFiles()};
+        spilledFiles(),
+        state_.spilledUncompressedBytes(),
+        spillWriteTiming_};
   }
 
   /// Return the number of spilled files we have.
@@ -354,12 +413,18 @@ class Spiller {
     const int32_t partition;
     const int32_t rowsWritten;
     const std::exception_ptr error;
+    // The cpu time spent on writing the partition.
+    const uint64_t cpuNanos;
 
     SpillStatus(
         int32_t _partition,
         int32_t _numWritten,
-        std::exception_ptr _error)
-        : partition(_partition), rowsWritten(_numWritten), error(_error) {}
+        std::exception_ptr _error,
+        uint64_t _cpuNanos = 0)
+        : partition(_partition),
+          rowsWritten(_numWritten),
+          error(_error),
+          cpuNanos(_cpuNanos) {}
   };
 
   // Prepares spill runs for the spillable data from all the hash partitions.
@@ -393,7 +458,9 @@ class Spiller {
   // written.
   std::unique_ptr<SpillStatus> writeSpill(int32_t partition);
 
-  // Writes out and erases rows marked for spilling.
+  // Writes out and erases rows marked for spilling. If 'executor_' is set, the
+  // partitions are written in parallel on it with up to
+  // 'maxSpillWriteParallelism_' partitions at a time.
   void advanceSpill();
 
   // Indicates if the spill data needs to be sorted before write to file. It is
@@ -428,7 +495,11 @@ class Spiller {
 
   folly::Executor* FOLLY_NULLABLE const executor_;
 
+  const int32_t maxSpillWriteParallelism_;
+
   uint64_t spilledRows_{0};
+
+  CpuWallTiming spillWriteTiming_;
 };
 
 } // namespace facebook::velox::exec
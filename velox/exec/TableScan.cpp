@@ -14,14 +14,25 @@
  * limitations under the License.
  */
 #include "velox/exec/TableScan.h"
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/time/Timer.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/VectorStream.h"
 
 DEFINE_int32(split_preload_per_driver, 2, "Prefetch split metadata");
 
 namespace facebook::velox::exec {
 
+namespace {
+// Timestamps keep their nanoseconds so that the cached results are the same
+// as the scanned ones.
+const serializer::presto::PrestoVectorSerde::PrestoOptions
+    kResultSerdeOptions(/*useLosslessTimestamp*/ true);
+} // namespace
+
 std::atomic<uint64_t> TableScan::ioWaitNanos_;
 
 TableScan::TableScan(
@@ -47,6 +58,19 @@ TableScan::TableScan(
                          ->queryConfig()
                          .preferredOutputBatchRows()) {
   connector_ = connector::getConnector(tableHandle_->connectorId());
+  if (driverCtx_->queryConfig().fragmentResultCacheEnabled() &&
+      isRegisteredVectorSerde()) {
+    resultCache_ = FragmentResultCache::getInstance();
+  }
+  if (resultCache_) {
+    auto keyPrefix = connector_->resultCacheKey(
+        outputType_, tableHandle_, columnHandles_);
+    if (keyPrefix.has_value()) {
+      resultKeyPrefix_ = std::move(keyPrefix.value());
+    } else {
+      resultCache_.reset();
+    }
+  }
 }
 
 RowVectorPtr TableScan::getOutput() {
@@ -55,6 +79,14 @@ RowVectorPtr TableScan::getOutput() {
   }
 
   for (;;) {
+    if (!cachedPages_.empty()) {
+      if (auto data = nextCachedBatch()) {
+        return data;
+      }
+      driverCtx_->task->splitFinished();
+      needNewSplit_ = true;
+    }
+
     if (needNewSplit_) {
       exec::Split split;
       blockingReason_ = driverCtx_->task->getSplitOrFuture(
@@ -70,24 +102,7 @@ RowVectorPtr TableScan::getOutput() {
 
       if (!split.hasConnectorSplit()) {
         noMoreSplits_ = true;
-        if (dataSource_) {
-          auto connectorStats = dataSource_->runtimeStats();
-          auto lockedStats = stats_.wlock();
-          for (const auto& [name, counter] : connectorStats) {
-            if (name == "ioWaitNanos") {
-              ioWaitNanos_ += counter.value - lastIoWaitNanos_;
-              lastIoWaitNanos_ = counter.value;
-            }
-            if (UNLIKELY(lockedStats->runtimeStats.count(name) == 0)) {
-              lockedStats->runtimeStats.insert(
-                  std::make_pair(name, RuntimeMetric(counter.unit)));
-            } else {
-              VELOX_CHECK_EQ(
-                  lockedStats->runtimeStats.at(name).unit, counter.unit);
-            }
-            lockedStats->runtimeStats.at(name).addValue(counter.value);
-          }
-        }
+        recordConnectorStats();
         return nullptr;
       }
 
@@ -99,6 +114,11 @@ RowVectorPtr TableScan::getOutput() {
           connectorSplit->connectorId,
           "Got splits with different connector IDs");
 
+      if (!resultKeyPrefix_.empty() && lookupResult(*connectorSplit)) {
+        ++stats_.wlock()->numSplits;
+        continue;
+      }
+
       if (!dataSource_) {
         connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
             connectorSplit->connectorId, planNodeId(), connectorPool_);
@@ -165,12 +185,19 @@ RowVectorPtr TableScan::getOutput() {
     checkPreload();
 
     {
+      const auto ioTimeMicros = getCurrentTimeMicro() - ioTimeStartMicros;
+      REPORT_ADD_HISTOGRAM_VALUE(
+          kCounterTableScanBatchLatencyMs, ioTimeMicros / 1'000);
       auto lockedStats = stats_.wlock();
       lockedStats->addRuntimeStat(
           "dataSourceWallNanos",
+          RuntimeCounter(ioTimeMicros * 1'000, RuntimeCounter::Unit::kNanos));
+      // Not aggregated per Driver like 'dataSourceWallNanos', so that the
+      // histogram shows the latency of the individual batches.
+      lockedStats->addRuntimeStat(
+          "dataSourceBatchWallNanos",
           RuntimeCounter(
-              (getCurrentTimeMicro() - ioTimeStartMicros) * 1'000,
-              RuntimeCounter::Unit::kNanos));
+              ioTimeMicros * 1'000, RuntimeCounter::Unit::kNanos, true));
 
       if (!dataOptional.has_value()) {
         blockingReason_ = BlockingReason::kWaitForConnector;
@@ -183,12 +210,17 @@ RowVectorPtr TableScan::getOutput() {
       if (data) {
         if (data->size() > 0) {
           lockedStats->addInputVector(data->estimateFlatSize(), data->size());
+          if (!resultKey_.empty()) {
+            addResultPage(data);
+          }
           return data;
         }
         continue;
       }
     }
 
+    finishResult();
+
     {
       auto lockedStats = stats_.wlock();
       if (numPreloadedSplits_ > 0) {
@@ -264,13 +296,135 @@ void TableScan::checkPreload() {
   }
 }
 
+bool TableScan::lookupResult(const connector::ConnectorSplit& split) {
+  dropResult();
+  auto splitKey = split.resultCacheKey();
+  if (!splitKey.has_value()) {
+    return false;
+  }
+  auto key = fmt::format("{} {}", resultKeyPrefix_, splitKey.value());
+  auto pages = resultCache_->get(key);
+  if (pages.has_value()) {
+    stats_.wlock()->addRuntimeStat(
+        "fragmentResultCacheHits", RuntimeCounter(1));
+    cachedPages_ = std::move(pages.value());
+    nextCachedPage_ = 0;
+    if (!cachedPages_.empty()) {
+      return true;
+    }
+    // An empty result. Finishes the split without reading it.
+    driverCtx_->task->splitFinished();
+    needNewSplit_ = true;
+    return true;
+  }
+  stats_.wlock()->addRuntimeStat(
+      "fragmentResultCacheMisses", RuntimeCounter(1));
+  resultKey_ = std::move(key);
+  return false;
+}
+
+RowVectorPtr TableScan::nextCachedBatch() {
+  if (nextCachedPage_ == cachedPages_.size()) {
+    cachedPages_.clear();
+    cachedBatch_ = nullptr;
+    return nullptr;
+  }
+  const auto& page = cachedPages_[nextCachedPage_++];
+  std::vector<ByteRange> ranges;
+  for (const auto& range : *page) {
+    ranges.push_back(
+        {const_cast<uint8_t*>(range.data()),
+         static_cast<int32_t>(range.size()),
+         0});
+  }
+  ByteStream input;
+  input.resetInput(std::move(ranges));
+  // Reads into the previous batch if the consumer has released it.
+  VectorStreamGroup::read(
+      &input, pool(), outputType_, &cachedBatch_, &kResultSerdeOptions);
+  stats_.wlock()->addInputVector(
+      cachedBatch_->estimateFlatSize(), cachedBatch_->size());
+  return cachedBatch_;
+}
+
+void TableScan::addResultPage(const RowVectorPtr& data) {
+  VectorStreamGroup group(pool());
+  group.createStreamTree(outputType_, data->size(), &kResultSerdeOptions);
+  IndexRange range{0, data->size()};
+  group.append(data, folly::Range<const IndexRange*>(&range, 1));
+  IOBufOutputStream out(
+      *resultCache_->pool(),
+      nullptr,
+      std::max<int64_t>(memory::AllocationTraits::kPageSize, group.size()));
+  group.flush(&out);
+  resultPages_.push_back(out.getIOBuf());
+  resultBytes_ += resultPages_.back()->computeChainDataLength();
+  if (resultBytes_ > resultCache_->maxEntryBytes()) {
+    dropResult();
+  }
+}
+
+void TableScan::finishResult() {
+  if (!resultKey_.empty()) {
+    resultCache_->put(resultKey_, std::move(resultPages_));
+  }
+  dropResult();
+}
+
+void TableScan::dropResult() {
+  resultKey_.clear();
+  resultPages_.clear();
+  resultBytes_ = 0;
+}
+
 bool TableScan::isFinished() {
   return noMoreSplits_;
 }
 
+void TableScan::noMoreOutputNeeded() {
+  if (noMoreSplits_) {
+    return;
+  }
+  noMoreSplits_ = true;
+  if (!needNewSplit_) {
+    driverCtx_->task->splitFinished();
+    needNewSplit_ = true;
+  }
+  // The results of the unfinished split are incomplete.
+  dropResult();
+  cachedPages_.clear();
+  recordConnectorStats();
+  dataSource_.reset();
+}
+
+void TableScan::recordConnectorStats() {
+  if (!dataSource_) {
+    return;
+  }
+  auto connectorStats = dataSource_->runtimeStats();
+  auto lockedStats = stats_.wlock();
+  for (const auto& [name, counter] : connectorStats) {
+    if (name == "ioWaitNanos") {
+      ioWaitNanos_ += counter.value - lastIoWaitNanos_;
+      lastIoWaitNanos_ = counter.value;
+    }
+    if (UNLIKELY(lockedStats->runtimeStats.count(name) == 0)) {
+      lockedStats->runtimeStats.insert(
+          std::make_pair(name, RuntimeMetric(counter.unit)));
+    } else {
+      VELOX_CHECK_EQ(lockedStats->runtimeStats.at(name).unit, counter.unit);
+    }
+    lockedStats->runtimeStats.at(name).addValue(counter.value);
+  }
+}
+
 void TableScan::addDynamicFilter(
     column_index_t outputChannel,
     const std::shared_ptr<common::Filter>& filter) {
+  // The dynamic filter removes rows, so that the results are not the same as
+  // of the scan without it.
+  dropResult();
+  resultKeyPrefix_.clear();
   if (dataSource_) {
     dataSource_->addDynamicFilter(outputChannel, filter);
   } else {
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/core/PlanNode.h"
+#include "velox/exec/FragmentResultCache.h"
 #include "velox/exec/Operator.h"
 
 DECLARE_int32(split_preload_per_driver);
@@ -41,6 +42,10 @@ class TableScan : public SourceOperator {
 
   bool isFinished() override;
 
+  /// Finishes the current split and drops the data source, which stops its
+  /// IO. Reads no more splits.
+  void noMoreOutputNeeded() override;
+
   bool canAddDynamicFilter() const override {
     return connector_->canAddDynamicFilter();
   }
@@ -57,6 +62,9 @@ class TableScan : public SourceOperator {
   }
 
  private:
+  // Adds the runtime stats of 'dataSource_' to the stats of 'this'.
+  void recordConnectorStats();
+
   // Sets 'maxPreloadSplits' and 'splitPreloader' if prefetching
   // splits is appropriate. The preloader will be applied to the
   // 'first 'maxPreloadSplits' of the Tasks's split queue for 'this'
@@ -69,6 +77,25 @@ class TableScan : public SourceOperator {
   // needed before prepare is done, it will be made when needed.
   void preload(std::shared_ptr<connector::ConnectorSplit> split);
 
+  // Looks up the result of 'split' in 'resultCache_'. Sets 'cachedPages_' and
+  // returns true if found. Otherwise, sets 'resultKey_' to collect the result
+  // of 'split' if the split has a key.
+  bool lookupResult(const connector::ConnectorSplit& split);
+
+  // Returns the next batch of 'cachedPages_' or nullptr if all have been
+  // returned.
+  RowVectorPtr nextCachedBatch();
+
+  // Adds 'data' to the result of the current split to be cached.
+  void addResultPage(const RowVectorPtr& data);
+
+  // Stores the result of the current split in 'resultCache_' if it has been
+  // collected.
+  void finishResult();
+
+  // Stops collecting the result of the current split.
+  void dropResult();
+
   // Process-wide IO wait time.
   static std::atomic<uint64_t> ioWaitNanos_;
 
@@ -113,5 +140,30 @@ class TableScan : public SourceOperator {
   // The last value of the IO wait time of 'this' that has been added to the
   // global static 'ioWaitNanos_'.
   uint64_t lastIoWaitNanos_{0};
+
+  // The cache for the results of the splits. Null if the results are not
+  // cached, e.g. because the scan is not deterministic.
+  std::shared_ptr<FragmentResultCache> resultCache_;
+
+  // The key of the scan, see Connector::resultCacheKey(). The key of the
+  // result of a split is this followed by the key of the split. Empty if the
+  // results are not cached, e.g. after a dynamic filter has been added.
+  std::string resultKeyPrefix_;
+
+  // The key of the result of the current split if it is being collected,
+  // otherwise empty.
+  std::string resultKey_;
+
+  // The serialized batches of the current split to cache and their size.
+  FragmentResultCache::Pages resultPages_;
+  uint64_t resultBytes_{0};
+
+  // The cached result of the current split and the next page to return.
+  FragmentResultCache::Pages cachedPages_;
+  size_t nextCachedPage_{0};
+
+  // The last batch read from 'cachedPages_'. Reused for the next batch if
+  // singly referenced.
+  RowVectorPtr cachedBatch_;
 };
 } // namespace facebook::velox::exec
@@ -57,6 +57,32 @@ TableWriter::TableWriter(
 
   mappedType_ = ROW(std::move(names), std::move(types));
   createDataSink();
+
+  // The file writers allocate from 'connectorPool_'. Reclaims its memory
+  // from this operator.
+  if (auto* reclaimer = dynamic_cast<Operator::MemoryReclaimer*>(
+          connectorPool_->reclaimer())) {
+    reclaimer->setOperator(this);
+  }
+}
+
+TableWriter::~TableWriter() {
+  if (auto* reclaimer = dynamic_cast<Operator::MemoryReclaimer*>(
+          connectorPool_->reclaimer())) {
+    reclaimer->setOperator(nullptr);
+  }
+}
+
+bool TableWriter::canReclaim() const {
+  return !closed_ && dataSink_ != nullptr && dataSink_->canReclaim();
+}
+
+void TableWriter::reclaim(uint64_t targetBytes) {
+  VELOX_CHECK(canReclaim());
+  const auto reclaimedBytes = dataSink_->reclaim(targetBytes);
+  stats_.wlock()->addRuntimeStat(
+      "reclaimedWriterBytes",
+      RuntimeCounter(reclaimedBytes, RuntimeCounter::Unit::kBytes));
 }
 
 void TableWriter::createDataSink() {
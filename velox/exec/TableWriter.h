@@ -61,6 +61,18 @@ class TableWriter : public Operator {
     return finished_;
   }
 
+  ~TableWriter() override;
+
+  /// The data sink can free the memory buffered by its file writers by
+  /// flushing them.
+  bool canReclaim() const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
+  bool canReclaimWithoutSpill() const override {
+    return canReclaim();
+  }
+
  private:
   void createDataSink();
 
@@ -16,6 +16,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/ScopeGuard.h>
 #include <string>
 
 #include "velox/codegen/Codegen.h"
@@ -185,11 +186,17 @@ Task::Task(
       destination_(destination),
       queryCtx_(std::move(queryCtx)),
       pool_(queryCtx_->pool()->addAggregateChild(
-          fmt::format("task.{}", taskId_.c_str()))),
+          fmt::format("task.{}", taskId_.c_str()),
+          Task::MemoryReclaimer::create(this))),
       consumerSupplier_(std::move(consumerSupplier)),
       onError_(onError),
       splitsStates_(buildSplitStates(planFragment_.planNode)),
       bufferManager_(PartitionedOutputBufferManager::getInstance()) {
+  if (const auto sampleBytes =
+          queryCtx_->queryConfig().memoryProfileSampleBytes()) {
+    pool_->setAllocationSampler(
+        std::make_shared<memory::AllocationSampler>(sampleBytes));
+  }
   auto memoryUsageTracker = pool_->getMemoryUsageTracker();
   if (memoryUsageTracker) {
     memoryUsageTracker->setMakeMemoryCapExceededMessage(
@@ -244,26 +251,51 @@ bool Task::allNodesReceivedNoMoreSplitsMessageLocked() const {
   return true;
 }
 
+void Task::setSpillOverflowDirectory(const std::string& overflowDirectory) {
+  VELOX_CHECK(
+      !spillDirectory_.empty(),
+      "Spill overflow directory needs a spill directory");
+  const auto localQuota = queryCtx_->queryConfig().spillLocalQuotaBytes();
+  if (overflowDirectory.empty() || localQuota == 0) {
+    spillTiers_ = nullptr;
+    return;
+  }
+  spillTiers_ = std::make_shared<SpillTiers>(
+      spillDirectory_, overflowDirectory, localQuota);
+}
+
 void Task::removeSpillDirectoryIfExists() {
+  std::vector<std::string> directories;
   if (!spillDirectory_.empty()) {
+    directories.push_back(spillDirectory_);
+  }
+  if (spillTiers_ != nullptr) {
+    directories.push_back(spillTiers_->overflowDirectory());
+  }
+  for (const auto& directory : directories) {
     try {
-      auto fs = filesystems::getFileSystem(spillDirectory_, nullptr);
-      fs->rmdir(spillDirectory_);
+      auto fs = filesystems::getFileSystem(directory, nullptr);
+      fs->rmdir(directory);
     } catch (const std::exception& e) {
-      LOG(ERROR) << "Failed to remove spill directory '" << spillDirectory_
+      LOG(ERROR) << "Failed to remove spill directory '" << directory
                  << "' for Task " << taskId() << ": " << e.what();
     }
   }
 }
 
+std::string Task::allocationProfile() const {
+  const auto& sampler = pool_->allocationSampler();
+  return sampler ? sampler->pprofProfile() : "";
+}
+
 velox::memory::MemoryPool* FOLLY_NONNULL
 Task::getOrAddNodePool(const core::PlanNodeId& planNodeId) {
   if (nodePools_.count(planNodeId) == 1) {
     return nodePools_[planNodeId];
   }
 
-  childPools_.push_back(
-      pool_->addAggregateChild(fmt::format("node.{}", planNodeId)));
+  childPools_.push_back(pool_->addAggregateChild(
+      fmt::format("node.{}", planNodeId), exec::MemoryReclaimer::create()));
   auto* nodePool = childPools_.back().get();
   nodePools_[planNodeId] = nodePool;
   return nodePool;
@@ -275,8 +307,11 @@ velox::memory::MemoryPool* Task::addOperatorPool(
     uint32_t driverId,
     const std::string& operatorType) {
   auto* nodePool = getOrAddNodePool(planNodeId);
-  childPools_.push_back(nodePool->addLeafChild(fmt::format(
-      "op.{}.{}.{}.{}", planNodeId, pipelineId, driverId, operatorType)));
+  childPools_.push_back(nodePool->addLeafChild(
+      fmt::format(
+          "op.{}.{}.{}.{}", planNodeId, pipelineId, driverId, operatorType),
+      true,
+      Operator::MemoryReclaimer::create()));
   return childPools_.back().get();
 }
 
@@ -287,13 +322,17 @@ velox::memory::MemoryPool* Task::addConnectorPoolLocked(
     const std::string& operatorType,
     const std::string& connectorId) {
   auto* nodePool = getOrAddNodePool(planNodeId);
-  childPools_.push_back(nodePool->addAggregateChild(fmt::format(
-      "op.{}.{}.{}.{}.{}",
-      planNodeId,
-      pipelineId,
-      driverId,
-      operatorType,
-      connectorId)));
+  // The operator using the pool may bind itself to the reclaimer to free the
+  // memory buffered by the connector, see TableWriter.
+  childPools_.push_back(nodePool->addAggregateChild(
+      fmt::format(
+          "op.{}.{}.{}.{}.{}",
+          planNodeId,
+          pipelineId,
+          driverId,
+          operatorType,
+          connectorId),
+      Operator::MemoryReclaimer::create()));
   return childPools_.back().get();
 }
 
@@ -472,10 +511,20 @@ void Task::start(
           std::make_shared<codegen::DefaultLogger>(self->taskId_);
       auto codegen = codegen::Codegen(codegenLogger);
       auto lazyLoading = config.codegenLazyLoading();
-      codegen.initializeFromFile(
-          config.codegenConfigurationFilePath(), lazyLoading);
-      if (auto newPlanNode = codegen.compile(*(self->planFragment_.planNode))) {
-        self->planFragment_.planNode = newPlanNode;
+      // The plan runs interpreted if codegen cannot be initialized or the
+      // plan cannot be compiled.
+      bool initialized = false;
+      try {
+        initialized = codegen.initializeFromFile(
+            config.codegenConfigurationFilePath(), lazyLoading);
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Codegen initialization failed: " << e.what();
+      }
+      if (initialized) {
+        if (auto newPlanNode =
+                codegen.compile(*(self->planFragment_.planNode))) {
+          self->planFragment_.planNode = newPlanNode;
+        }
       }
     }
 #endif
@@ -487,6 +536,14 @@ void Task::start(
         &self->driverFactories_,
         maxDrivers);
 
+    // With an inline executor, an added Driver would run on the thread of
+    // the Driver that adds it.
+    if (!dynamic_cast<const folly::InlineLikeExecutor*>(
+            self->queryCtx()->executor())) {
+      self->adaptiveMaxDrivers_ =
+          self->queryCtx()->queryConfig().adaptiveMaxDrivers();
+    }
+
     // Keep one exchange client per pipeline (NULL if not used).
     numPipelines = self->driverFactories_.size();
     self->exchangeClients_.resize(numPipelines);
@@ -922,19 +979,37 @@ bool Task::addSplitWithSequence(
 }
 
 void Task::addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split) {
+  // Divide a large split into morsels which can be read by different drivers.
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> morsels;
+  const auto maxMorselBytes = queryCtx_->queryConfig().maxSplitMorselBytes();
+  if (maxMorselBytes != 0 && split.hasConnectorSplit()) {
+    morsels = split.connectorSplit->splitIntoMorsels(maxMorselBytes);
+  }
+
   bool isTaskRunning;
-  std::unique_ptr<ContinuePromise> promise;
+  std::vector<std::unique_ptr<ContinuePromise>> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
     isTaskRunning = isRunningLocked();
     if (isTaskRunning) {
-      promise = addSplitLocked(
-          getPlanNodeSplitsStateLocked(planNodeId), std::move(split));
+      auto& splitsState = getPlanNodeSplitsStateLocked(planNodeId);
+      if (morsels.empty()) {
+        promises.push_back(addSplitLocked(splitsState, std::move(split)));
+      } else {
+        ++taskStats_.numSplitsDividedIntoMorsels;
+        taskStats_.numSplitMorsels += morsels.size();
+        for (auto& morsel : morsels) {
+          promises.push_back(addSplitLocked(
+              splitsState, exec::Split(std::move(morsel), split.groupId)));
+        }
+      }
     }
   }
 
-  if (promise) {
-    promise->setValue();
+  for (auto& promise : promises) {
+    if (promise) {
+      promise->setValue();
+    }
   }
 
   if (!isTaskRunning) {
@@ -1106,13 +1181,124 @@ BlockingReason Task::getSplitOrFuture(
     ContinueFuture& future,
     int32_t maxPreloadSplits,
     std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
-  std::lock_guard<std::mutex> l(mutex_);
-  return getSplitOrFutureLocked(
-      getPlanNodeSplitsStateLocked(planNodeId).groupSplitsStores[splitGroupId],
-      split,
-      future,
-      maxPreloadSplits,
-      preload);
+  std::shared_ptr<Driver> addedDriver;
+  BlockingReason reason;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& splitsStore = getPlanNodeSplitsStateLocked(planNodeId)
+                            .groupSplitsStores[splitGroupId];
+    const auto pipelineId = adaptivePipelineIdLocked(splitGroupId, planNodeId);
+    if (pipelineId != -1 && splitsStore.splits.empty() &&
+        !splitsStore.noMoreSplits && maybeRetireDriverLocked(pipelineId)) {
+      // No split tells the caller that its Driver is done.
+      return BlockingReason::kNotBlocked;
+    }
+    reason = getSplitOrFutureLocked(
+        splitsStore, split, future, maxPreloadSplits, preload);
+    if (pipelineId != -1 && split.hasConnectorSplit()) {
+      addedDriver = maybeAddDriverLocked(pipelineId, splitsStore);
+    }
+  }
+  if (addedDriver) {
+    Driver::enqueue(addedDriver);
+  }
+  return reason;
+}
+
+int32_t Task::adaptivePipelineIdLocked(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) const {
+  if (adaptiveMaxDrivers_ == 0 || splitGroupId != kUngroupedGroupId ||
+      !isUngroupedExecution()) {
+    return -1;
+  }
+  for (auto i = 0; i < driverFactories_.size(); ++i) {
+    const auto& factory = driverFactories_[i];
+    if (factory->leafNodeId() == planNodeId) {
+      return factory->supportsAddingDrivers() ? i : -1;
+    }
+  }
+  return -1;
+}
+
+std::shared_ptr<Driver> Task::maybeAddDriverLocked(
+    uint32_t pipelineId,
+    const SplitsStore& splitsStore) {
+  auto& factory = driverFactories_[pipelineId];
+  auto& pipelineStats = taskStats_.pipelineStats[pipelineId];
+  const auto numDrivers = factory->numDrivers - pipelineStats.numRetiredDrivers;
+  if (!isRunningLocked() || pauseRequested_ ||
+      splitsStore.splits.size() <= numDrivers ||
+      numDrivers >= std::min(adaptiveMaxDrivers_, factory->maxDrivers)) {
+    return nullptr;
+  }
+
+  // The sink of the pipeline must take one more producer. This fails if all
+  // the Drivers of the pipeline have finished, e.g. because the consumer
+  // needs no more data.
+  std::shared_ptr<PartitionedOutputBufferManager> bufferManager;
+  std::vector<std::shared_ptr<LocalExchangeQueue>> reservedQueues;
+  // The new Driver's LocalPartition registers as a producer of the queues
+  // when it is made. Until then the reservations keep the queues open.
+  SCOPE_EXIT {
+    for (auto& queue : reservedQueues) {
+      queue->noMoreData();
+    }
+  };
+  if (factory->needsPartitionedOutput()) {
+    bufferManager = bufferManager_.lock();
+    if (bufferManager == nullptr || !bufferManager->addDriver(taskId_)) {
+      return nullptr;
+    }
+  } else {
+    for (auto& queue : getLocalExchangeQueues(
+             kUngroupedGroupId, factory->consumerNode->id())) {
+      if (!queue->tryAddProducer()) {
+        return nullptr;
+      }
+      reservedQueues.push_back(queue);
+    }
+  }
+
+  auto self = shared_from_this();
+  const uint32_t driverId = factory->numDrivers;
+  std::shared_ptr<Driver> driver;
+  try {
+    driver = factory->createDriver(
+        std::make_unique<DriverCtx>(
+            self, driverId, pipelineId, kUngroupedGroupId, driverId),
+        getExchangeClientLocked(pipelineId),
+        [self](size_t i) {
+          return i < self->driverFactories_.size()
+              ? self->driverFactories_[i]->numTotalDrivers
+              : 0;
+        });
+  } catch (const std::exception&) {
+    if (bufferManager != nullptr) {
+      // Finishes the producer registered above.
+      bufferManager->noMoreData(taskId_);
+    }
+    throw;
+  }
+
+  ++factory->numDrivers;
+  ++factory->numTotalDrivers;
+  ++numDriversUngrouped_;
+  ++numTotalDrivers_;
+  ++splitGroupStates_[kUngroupedGroupId].numRunningDrivers;
+  ++numRunningDrivers_;
+  ++pipelineStats.numAddedDrivers;
+  drivers_.push_back(driver);
+  return driver;
+}
+
+bool Task::maybeRetireDriverLocked(uint32_t pipelineId) {
+  auto& pipelineStats = taskStats_.pipelineStats[pipelineId];
+  if (pipelineStats.numRetiredDrivers == pipelineStats.numAddedDrivers) {
+    return false;
+  }
+  ++pipelineStats.numRetiredDrivers;
+  return true;
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
@@ -1142,14 +1328,27 @@ exec::Split Task::getSplitLocked(
     std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
   int32_t readySplitIndex = -1;
   if (maxPreloadSplits) {
+    // The preloads stay within 'maxPreloadBytes' of splits in flight, except
+    // that a single split is always preloaded.
+    const auto maxPreloadBytes =
+        queryCtx_->queryConfig().maxSplitPreloadBytes();
+    uint64_t preloadBytes = 0;
     for (auto i = 0; i < splitsStore.splits.size() && i < maxPreloadSplits;
          ++i) {
       auto& split = splitsStore.splits[i].connectorSplit;
       if (!split->dataSource) {
+        if (maxPreloadBytes != 0 && preloadBytes > 0 &&
+            preloadBytes + split->size() > maxPreloadBytes) {
+          continue;
+        }
         // Initializes split->dataSource
         preload(split);
-      } else if (readySplitIndex == -1 && split->dataSource->hasValue()) {
-        readySplitIndex = i;
+        preloadBytes += split->size();
+      } else {
+        preloadBytes += split->size();
+        if (readySplitIndex == -1 && split->dataSource->hasValue()) {
+          readySplitIndex = i;
+        }
       }
     }
   }
@@ -1630,6 +1829,19 @@ void Task::addOperatorStats(OperatorStats& stats) {
       .add(stats);
 }
 
+void Task::addTimeline(DriverTimelineEvents timeline) {
+  std::lock_guard<std::mutex> l(mutex_);
+  timelines_.push_back(std::move(timeline));
+}
+
+std::string Task::timelineToChromeTrace() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (timelines_.empty()) {
+    return "";
+  }
+  return exec::timelineToChromeTrace(timelines_);
+}
+
 TaskStats Task::taskStats() const {
   std::lock_guard<std::mutex> l(mutex_);
 
@@ -1654,12 +1866,17 @@ TaskStats Task::taskStats() const {
           .operatorStats[statsCopy.operatorId]
           .add(statsCopy);
     }
+    auto& pipelineStats =
+        taskStats.pipelineStats[driver->driverCtx()->pipelineId];
+    ++pipelineStats.numDrivers;
     if (driver->isOnThread()) {
       ++taskStats.numRunningDrivers;
+      ++pipelineStats.numRunningDrivers;
     } else if (driver->isTerminated()) {
       ++taskStats.numTerminatedDrivers;
     } else {
       ++taskStats.numBlockedDrivers[driver->blockingReason()];
+      ++pipelineStats.numBlockedDrivers[driver->blockingReason()];
     }
   }
 
@@ -2045,6 +2262,73 @@ ContinueFuture Task::requestPause() {
   return makeFinishFutureLocked("Task::requestPause");
 }
 
+// static
+std::shared_ptr<memory::MemoryReclaimer> Task::MemoryReclaimer::create(
+    Task* FOLLY_NONNULL task) {
+  return std::shared_ptr<memory::MemoryReclaimer>(new MemoryReclaimer(task));
+}
+
+uint64_t Task::MemoryReclaimer::reclaim(
+    memory::MemoryPool* pool,
+    uint64_t targetBytes) {
+  auto task = task_->weak_from_this().lock();
+  if (task == nullptr) {
+    // The task is not owned by a shared pointer or is being destroyed.
+    return 0;
+  }
+  // If a driver of this task initiates the memory arbitration on the current
+  // thread and hasn't been suspended, we need to suspend it for the task to
+  // be paused.
+  std::optional<SuspendedSection> suspendedSection;
+  auto* driverThreadCtx = driverThreadContext();
+  if (driverThreadCtx != nullptr &&
+      driverThreadCtx->driver->task().get() == task.get() &&
+      !driverThreadCtx->driver->state().isSuspended) {
+    suspendedSection.emplace(driverThreadCtx->driver);
+  }
+  task->requestPause().wait();
+  auto resumeGuard = folly::makeGuard([&]() {
+    try {
+      Task::resume(task);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to resume task " << task->taskId()
+                   << " after memory reclamation: " << e.what();
+    }
+  });
+  // Reclaim from the operators which can free memory without disk spilling
+  // first, such as partial aggregations.
+  const uint64_t reclaimedBytes = reclaimWithoutSpill(pool, targetBytes);
+  if (targetBytes != 0 && reclaimedBytes >= targetBytes) {
+    return reclaimedBytes;
+  }
+  return reclaimedBytes +
+      exec::MemoryReclaimer::reclaim(
+             pool, targetBytes == 0 ? 0 : targetBytes - reclaimedBytes);
+}
+
+// static
+uint64_t Task::MemoryReclaimer::reclaimWithoutSpill(
+    memory::MemoryPool* pool,
+    uint64_t targetBytes) {
+  uint64_t reclaimedBytes{0};
+  // NOTE: the task memory pool has node memory pools as its children which
+  // have the operator memory pools as their children.
+  pool->visitChildren([&](memory::MemoryPool* nodePool) {
+    nodePool->visitChildren([&](memory::MemoryPool* opPool) {
+      auto* reclaimer =
+          dynamic_cast<Operator::MemoryReclaimer*>(opPool->reclaimer());
+      if (reclaimer == nullptr || !reclaimer->canReclaimWithoutSpill()) {
+        return true;
+      }
+      reclaimedBytes += opPool->reclaim(
+          targetBytes == 0 ? 0 : targetBytes - reclaimedBytes);
+      return targetBytes == 0 || reclaimedBytes < targetBytes;
+    });
+    return targetBytes == 0 || reclaimedBytes < targetBytes;
+  });
+  return reclaimedBytes;
+}
+
 Task::TaskCompletionNotifier::~TaskCompletionNotifier() {
   notify();
 }
@@ -2088,7 +2372,8 @@ void Task::createExchangeClient(
   exchangeClients_[pipelineId] = std::make_shared<ExchangeClient>(
       destination_,
       addExchangeClientPool(planNodeId, pipelineId),
-      queryCtx()->queryConfig().maxPartitionedOutputBufferSize() / 2);
+      queryCtx()->queryConfig().maxPartitionedOutputBufferSize() / 2,
+      queryCtx()->queryConfig().exchangeMaxRequestsInFlight());
   exchangeClientByPlanNode_.emplace(planNodeId, exchangeClients_[pipelineId]);
 }
 
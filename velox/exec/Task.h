@@ -18,7 +18,9 @@
 #include "velox/core/QueryCtx.h"
 #include "velox/exec/Driver.h"
 #include "velox/exec/LocalPartition.h"
+#include "velox/exec/MemoryReclaimer.h"
 #include "velox/exec/MergeSource.h"
+#include "velox/exec/Spill.h"
 #include "velox/exec/Split.h"
 #include "velox/exec/TaskStats.h"
 #include "velox/exec/TaskStructs.h"
@@ -72,6 +74,12 @@ class Task : public std::enable_shared_from_this<Task> {
     spillDirectory_ = spillDirectory;
   }
 
+  /// Specify the directory to which data is spilled once the spill files in
+  /// the spill directory exceed the 'spill-local-quota-bytes' query config.
+  /// May be on any registered FileSystem, e.g. S3 or HDFS. Must be called
+  /// after setSpillDirectory() and before the task starts.
+  void setSpillOverflowDirectory(const std::string& overflowDirectory);
+
   std::string toString() const;
 
   /// Returns universally unique identifier of the task.
@@ -103,6 +111,11 @@ class Task : public std::enable_shared_from_this<Task> {
     return pool_.get();
   }
 
+  /// Returns the allocations sampled from the memory pools of 'this' as a
+  /// heap profile for 'pprof', see AllocationSampler::pprofProfile(). Empty
+  /// if the 'memory_profile_sample_bytes' query config is not set.
+  std::string allocationProfile() const;
+
   /// Returns ConsumerSupplier passed in the constructor.
   ConsumerSupplier consumerSupplier() const {
     return consumerSupplier_;
@@ -442,6 +455,15 @@ class Task : public std::enable_shared_from_this<Task> {
   /// stats. Called from Drivers upon their closure.
   void addOperatorStats(OperatorStats& stats);
 
+  /// Adds the timeline of a Driver. Called from Drivers upon their closure if
+  /// the timeline is enabled.
+  void addTimeline(DriverTimelineEvents timeline);
+
+  /// Returns the timelines of the finished Drivers in the Chrome trace event
+  /// format. Empty if the timeline is disabled by the
+  /// 'driver.timeline_max_events' config.
+  std::string timelineToChromeTrace() const;
+
   /// Returns kNone if no pause or terminate is requested. The thread count is
   /// incremented if kNone is returned. If something else is returned the
   /// calling thread should unwind and return itself to its pool. If 'this' goes
@@ -494,6 +516,30 @@ class Task : public std::enable_shared_from_this<Task> {
   /// can be resumed with resume() after the future is realized.
   ContinueFuture requestPause();
 
+  /// The memory reclaimer of the task memory pool. It pauses the task before
+  /// reclaiming memory from its child memory pools, and resumes the task
+  /// after that. This avoids the race condition between the memory
+  /// reclamation and the task execution.
+  class MemoryReclaimer : public exec::MemoryReclaimer {
+   public:
+    static std::shared_ptr<memory::MemoryReclaimer> create(
+        Task* FOLLY_NONNULL task);
+
+    uint64_t reclaim(memory::MemoryPool* pool, uint64_t targetBytes) override;
+
+   private:
+    explicit MemoryReclaimer(Task* FOLLY_NONNULL task) : task_(task) {}
+
+    // Reclaims memory from the operators which can reclaim without disk
+    // spilling under the task memory 'pool'. Returns the reclaimed bytes.
+    static uint64_t reclaimWithoutSpill(
+        memory::MemoryPool* pool,
+        uint64_t targetBytes);
+
+    // NOTE: 'task_' owns the memory pool that owns this reclaimer.
+    Task* const task_;
+  };
+
   /// Requests activity of 'this' to stop. The returned future will be
   /// realized when the last thread stops running for 'this'. This is used to
   /// mark cancellation by the user.
@@ -547,6 +593,12 @@ class Task : public std::enable_shared_from_this<Task> {
     return spillDirectory_;
   }
 
+  /// Returns the tiers of the spill files of the drivers of 'this', or
+  /// nullptr if there is no spill overflow directory or local quota.
+  const std::shared_ptr<SpillTiers>& spillTiers() const {
+    return spillTiers_;
+  }
+
   /// True if produces output via PartitionedOutputBufferManager.
   bool hasPartitionedOutput() const {
     return numDriversInPartitionedOutput_ > 0;
@@ -643,6 +695,25 @@ class Task : public std::enable_shared_from_this<Task> {
       std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload =
           nullptr);
 
+  /// Returns the id of the pipeline that reads the splits of 'planNodeId' in
+  /// 'splitGroupId' if it can add and retire Drivers while it runs, see the
+  /// adaptive_max_drivers query config. Returns -1 otherwise.
+  int32_t adaptivePipelineIdLocked(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId) const;
+
+  /// Adds a Driver to 'pipelineId' if its splits queued in 'splitsStore'
+  /// outnumber its Drivers. Returns the new Driver, which the caller enqueues
+  /// after releasing 'mutex_', or nullptr if no Driver was added.
+  std::shared_ptr<Driver> maybeAddDriverLocked(
+      uint32_t pipelineId,
+      const SplitsStore& splitsStore);
+
+  /// Returns true if a Driver of 'pipelineId' that finds no queued split
+  /// should finish instead of waiting. This is the case while the pipeline
+  /// has more Drivers than it started with.
+  bool maybeRetireDriverLocked(uint32_t pipelineId);
+
   /// Returns next split from the store. The caller must ensure the store is not
   /// empty.
   exec::Split getSplitLocked(
@@ -925,6 +996,10 @@ class Task : public std::enable_shared_from_this<Task> {
   /// The number of splits groups we run concurrently.
   uint32_t concurrentSplitGroups_{1};
 
+  /// The max number of Drivers of a pipeline that adds Drivers while it runs.
+  /// Zero if the pipelines keep the number of Drivers they start with.
+  uint32_t adaptiveMaxDrivers_{0};
+
   /// Have we already initialized stats of operators in the drivers for Grouped
   /// Execution?
   bool initializedGroupedOpStats_{false};
@@ -958,6 +1033,9 @@ class Task : public std::enable_shared_from_this<Task> {
 
   TaskStats taskStats_;
 
+  /// The timelines of the finished Drivers.
+  std::vector<DriverTimelineEvents> timelines_;
+
   /// Stores inter-operator state (exchange, bridges) per split group.
   /// During ungrouped execution we use the [0] entry in this vector.
   std::unordered_map<uint32_t, SplitGroupState> splitGroupStates_;
@@ -989,6 +1067,10 @@ class Task : public std::enable_shared_from_this<Task> {
 
   // Base spill directory for this task.
   std::string spillDirectory_;
+
+  // Places the spill files in 'spillDirectory_' or in the overflow directory.
+  // Set if there are an overflow directory and a local quota.
+  std::shared_ptr<SpillTiers> spillTiers_;
 };
 
 /// Listener invoked on task completion.
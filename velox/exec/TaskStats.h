@@ -39,6 +39,20 @@ struct PipelineStats {
   // True if contains the sync node for the task.
   bool outputPipeline;
 
+  // The number of unfinished Drivers of the pipeline when the stats are taken.
+  // Of those, the ones on thread and the ones blocked for each reason. Sampled
+  // over time, these show which pipelines are starved of input and which ones
+  // can't keep up with their producers.
+  uint64_t numDrivers{0};
+  uint64_t numRunningDrivers{0};
+  std::unordered_map<BlockingReason, uint64_t> numBlockedDrivers;
+
+  // The number of Drivers that the Task added to the pipeline after it started
+  // and the number of Drivers that it retired since. See the
+  // adaptive_max_drivers query config.
+  uint64_t numAddedDrivers{0};
+  uint64_t numRetiredDrivers{0};
+
   PipelineStats(bool _inputPipeline, bool _outputPipeline)
       : inputPipeline{_inputPipeline}, outputPipeline{_outputPipeline} {}
 };
@@ -49,6 +63,11 @@ struct TaskStats {
   int32_t numFinishedSplits{0};
   int32_t numRunningSplits{0};
   int32_t numQueuedSplits{0};
+  /// The number of splits which were divided into morsels when added, and the
+  /// number of morsels they were divided into. The morsels are counted in the
+  /// split counts above instead of the divided splits.
+  int32_t numSplitsDividedIntoMorsels{0};
+  int32_t numSplitMorsels{0};
   std::unordered_set<int32_t> completedSplitGroups;
 
   /// The subscript is given by each Operator's
@@ -15,9 +15,64 @@
  */
 #include "velox/exec/TopN.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Returns the map from the row container column to the output channel. The
+// sorting key columns are stored first in the row container to be able to
+// sort and merge the spilled rows.
+std::vector<IdentityProjection> makeColumnMap(
+    const RowTypePtr& type,
+    const std::vector<core::FieldAccessTypedExprPtr>& sortingKeys) {
+  std::vector<IdentityProjection> columnMap;
+  columnMap.reserve(type->size());
+  std::unordered_set<column_index_t> keyChannels;
+  for (auto i = 0; i < sortingKeys.size(); ++i) {
+    const auto channel = exprToChannel(sortingKeys[i].get(), type);
+    VELOX_CHECK(
+        channel != kConstantChannel,
+        "TopN doesn't allow constant comparison keys");
+    columnMap.emplace_back(i, channel);
+    keyChannels.insert(channel);
+  }
+  column_index_t column = sortingKeys.size();
+  for (column_index_t channel = 0; channel < type->size(); ++channel) {
+    if (keyChannels.count(channel) == 0) {
+      columnMap.emplace_back(column++, channel);
+    }
+  }
+  return columnMap;
+}
+
+std::vector<CompareFlags> makeCompareFlags(
+    const std::vector<core::SortOrder>& sortingOrders) {
+  std::vector<CompareFlags> compareFlags;
+  compareFlags.reserve(sortingOrders.size());
+  for (const auto& sortOrder : sortingOrders) {
+    compareFlags.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+  }
+  return compareFlags;
+}
+
+RowTypePtr makeSpillType(
+    const RowTypePtr& type,
+    const std::vector<IdentityProjection>& columnMap) {
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  names.reserve(columnMap.size());
+  types.reserve(columnMap.size());
+  for (const auto& projection : columnMap) {
+    names.push_back(type->nameOf(projection.outputChannel));
+    types.push_back(type->childAt(projection.outputChannel));
+  }
+  return ROW(std::move(names), std::move(types));
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -29,7 +84,22 @@ TopN::TopN(
           topNNode->id(),
           "TopN"),
       count_(topNNode->count()),
-      data_(std::make_unique<RowContainer>(outputType_->children(), pool())),
+      spillMemoryThreshold_(
+          operatorCtx_->driverCtx()->queryConfig().topNSpillMemoryThreshold()),
+      spillConfig_(
+          topNNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kOrderBy)
+              : std::nullopt),
+      columnMap_(makeColumnMap(outputType_, topNNode->sortingKeys())),
+      spillType_(makeSpillType(outputType_, columnMap_)),
+      data_(std::make_unique<RowContainer>(
+          std::vector<TypePtr>(
+              spillType_->children().begin(),
+              spillType_->children().begin() + topNNode->sortingKeys().size()),
+          std::vector<TypePtr>(
+              spillType_->children().begin() + topNNode->sortingKeys().size(),
+              spillType_->children().end()),
+          pool())),
       comparator_(
           outputType_,
           topNNode->sortingKeys(),
@@ -44,7 +114,8 @@ TopN::Comparator::Comparator(
         sortingKeys,
     const std::vector<core::SortOrder>& sortingOrders,
     RowContainer* rowContainer)
-    : rowContainer_(rowContainer) {
+    : compareFlags_(makeCompareFlags(sortingOrders)),
+      rowComparator_(rowContainer, compareFlags_) {
   auto numKeys = sortingKeys.size();
   for (int i = 0; i < numKeys; ++i) {
     auto channel = exprToChannel(sortingKeys[i].get(), type);
@@ -56,6 +127,8 @@ TopN::Comparator::Comparator(
 }
 
 void TopN::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   SelectivityVector allRows(input->size());
 
   // TODO Decode keys first, then decode the rest only for passing positions
@@ -64,6 +137,12 @@ void TopN::addInput(RowVectorPtr input) {
   }
 
   for (int row = 0; row < input->size(); ++row) {
+    // The spilled runs already have 'count_' rows ordered before or equal to
+    // the spill threshold row.
+    if (spillThresholdRow_ != nullptr && !belowSpillThreshold(row)) {
+      continue;
+    }
+
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
       newRow = data_->newRow();
@@ -78,19 +157,168 @@ void TopN::addInput(RowVectorPtr input) {
       newRow = data_->initializeRow(topRow, true /* reuse */);
     }
 
-    for (int col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedVectors_[col], row, newRow, col);
+    for (const auto& projection : columnMap_) {
+      data_->store(
+          decodedVectors_[projection.outputChannel],
+          row,
+          newRow,
+          projection.inputChannel);
     }
 
     topRows_.push(newRow);
   }
 }
 
+bool TopN::belowSpillThreshold(vector_size_t index) {
+  const auto& keyInfo = comparator_.keyInfo();
+  for (auto i = 0; i < keyInfo.size(); ++i) {
+    if (auto result = spillThresholdComparator_->compare(
+            i, spillThresholdRow_, decodedVectors_[keyInfo[i].first], index)) {
+      return result > 0;
+    }
+  }
+  return false;
+}
+
+void TopN::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  if (data_->numRows() == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    spill();
+    return;
+  }
+
+  auto tracker = pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if ((spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) ||
+      tracker->highUsage()) {
+    spill();
+    return;
+  }
+
+  // The heap only allocates new rows until it holds 'count_' rows. After that,
+  // the new top rows reuse the memory of the replaced ones.
+  const int64_t numNewRows = std::min<int64_t>(
+      input->size(), static_cast<int64_t>(count_) - topRows_.size());
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+  if (freeRows >= numNewRows &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for the new rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(numNewRows, outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  spill();
+}
+
+void TopN::spill() {
+  const auto numKeys = comparator_.keyInfo().size();
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK_NOT_NULL(pool()->getMemoryUsageTracker());
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        numKeys,
+        comparator_.compareFlags(),
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.maxSpillWriteParallelism,
+        spillConfig.directIo,
+        spillConfig.tiers);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+
+  // If the heap is full, its top row becomes the new spill threshold. It is
+  // ordered before any previous threshold as all the heap rows are.
+  if (topRows_.size() == count_) {
+    if (spillThreshold_ == nullptr) {
+      spillThreshold_ = std::make_unique<RowContainer>(
+          std::vector<TypePtr>(
+              spillType_->children().begin(),
+              spillType_->children().begin() + numKeys),
+          pool());
+      spillThresholdComparator_.emplace(
+          spillThreshold_.get(), comparator_.compareFlags());
+    }
+    spillThreshold_->clear();
+    spillThresholdRow_ = spillThreshold_->newRow();
+    char* topRow = topRows_.top();
+    SelectivityVector row(1);
+    for (auto i = 0; i < numKeys; ++i) {
+      auto key = BaseVector::create(spillType_->childAt(i), 1, pool());
+      data_->extractColumn(&topRow, 1, i, key);
+      DecodedVector decodedKey(*key, row);
+      spillThreshold_->store(decodedKey, 0, spillThresholdRow_, i);
+    }
+  }
+
+  topRows_ = decltype(topRows_)(comparator_);
+  spiller_->spill(0, 0);
+  VELOX_CHECK_EQ(data_->numRows(), 0);
+  // Physically frees the memory of the spilled rows.
+  data_->clear();
+
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  lockedStats->spillWriteTiming = spillStats.spillWriteTiming;
+}
+
 RowVectorPtr TopN::getOutput() {
   if (finished_ || !noMoreInput_) {
     return nullptr;
   }
 
+  if (spillMerge_ != nullptr) {
+    return getOutputWithSpill();
+  }
+
   uint32_t numRowsToReturn =
       std::min(kMaxNumRowsToReturn, rows_.size() - numRowsReturned_);
   VELOX_CHECK(numRowsToReturn > 0);
@@ -98,20 +326,89 @@ RowVectorPtr TopN::getOutput() {
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numRowsToReturn, operatorCtx_->pool()));
 
-  for (int i = 0; i < outputType_->size(); ++i) {
+  for (const auto& projection : columnMap_) {
     data_->extractColumn(
         rows_.data() + numRowsReturned_,
         numRowsToReturn,
-        i,
-        result->childAt(i));
+        projection.inputChannel,
+        result->childAt(projection.outputChannel));
   }
   numRowsReturned_ += numRowsToReturn;
   finished_ = (numRowsReturned_ == rows_.size());
   return result;
 }
 
+RowVectorPtr TopN::getOutputWithSpill() {
+  const vector_size_t maxOutputRows =
+      std::min<uint32_t>(kMaxNumRowsToReturn, count_ - numRowsReturned_);
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, maxOutputRows, operatorCtx_->pool()));
+  spillSources_.resize(maxOutputRows);
+  spillSourceRows_.resize(maxOutputRows);
+
+  vector_size_t outputRow = 0;
+  vector_size_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < maxOutputRows) {
+    SpillMergeStream* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      break;
+    }
+
+    spillSources_[outputSize] = &stream->current();
+    spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
+    ++outputSize;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherCopy(
+          result.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+
+    // Advance the stream.
+    stream->pop();
+  }
+
+  if (FOLLY_LIKELY(outputSize != 0)) {
+    gatherCopy(
+        result.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+    outputRow += outputSize;
+  }
+
+  numRowsReturned_ += outputRow;
+  if (outputRow < maxOutputRows || numRowsReturned_ == count_) {
+    finished_ = true;
+  }
+  if (outputRow == 0) {
+    return nullptr;
+  }
+  result->resize(outputRow);
+  return result;
+}
+
 void TopN::noMoreInput() {
   Operator::noMoreInput();
+  if (spiller_ != nullptr) {
+    // Merge the rows left in 'data_' with the spilled runs at output. There is
+    // only one spill partition so all the rows are from the spilled partition.
+    topRows_ = decltype(topRows_)(comparator_);
+    VELOX_CHECK(spiller_->finishSpill().empty());
+    spillMerge_ = spiller_->startMerge(0);
+    return;
+  }
+
   if (topRows_.empty()) {
     finished_ = true;
     return;
@@ -16,10 +16,16 @@
 #pragma once
 
 #include "velox/exec/Operator.h"
+#include "velox/exec/RowComparator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+/// Keeps the top 'count' rows of the input in a RowContainer based heap. If
+/// disk spilling is enabled for a final TopN, then the heap rows are spilled
+/// in sorted runs when the memory usage grows too large, and the top rows are
+/// produced by merging the spilled runs at output.
 class TopN : public Operator {
  public:
   TopN(
@@ -45,6 +51,9 @@ class TopN : public Operator {
 
  private:
   static constexpr size_t kMaxNumRowsToReturn = 1024;
+
+  // Compares the rows of a RowContainer which stores the sorting keys as its
+  // leading columns in the sorting key order.
   class Comparator {
    public:
     Comparator(
@@ -59,16 +68,7 @@ class TopN : public Operator {
       if (lhs == rhs) {
         return false;
       }
-      for (auto& key : keyInfo_) {
-        if (auto result = rowContainer_->compare(
-                lhs,
-                rhs,
-                key.first,
-                {key.second.isNullsFirst(), key.second.isAscending(), false})) {
-          return result < 0;
-        }
-      }
-      return false;
+      return rowComparator_(lhs, rhs);
     }
 
     // Returns true if decodeVectors[index] < rhs, false otherwise.
@@ -76,26 +76,63 @@ class TopN : public Operator {
         const std::vector<DecodedVector>& decodedVectors,
         vector_size_t index,
         const char* rhs) {
-      for (auto& key : keyInfo_) {
-        if (auto result = rowContainer_->compare(
-                rhs,
-                rowContainer_->columnAt(key.first),
-                decodedVectors[key.first],
-                index,
-                {key.second.isNullsFirst(), key.second.isAscending(), false})) {
+      for (auto i = 0; i < keyInfo_.size(); ++i) {
+        if (auto result = rowComparator_.compare(
+                i, rhs, decodedVectors[keyInfo_[i].first], index)) {
           return result > 0;
         }
       }
       return false;
     }
 
+    // The input channel and the sort order of each sorting key.
+    const std::vector<std::pair<column_index_t, core::SortOrder>>& keyInfo()
+        const {
+      return keyInfo_;
+    }
+
+    // The compare flags of the sorting keys.
+    const std::vector<CompareFlags>& compareFlags() const {
+      return compareFlags_;
+    }
+
    private:
     std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
-    RowContainer* rowContainer_;
+    std::vector<CompareFlags> compareFlags_;
+    RowComparator rowComparator_;
   };
 
+  // Checks if spilling is enabled and if 'input' fits in the existing memory
+  // reservation. Spills all the rows of 'data_' if not.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills all the rows of 'data_'. If the heap is full, the sorting keys of
+  // its top row are saved in 'spillThreshold_' as only the input rows ordered
+  // before it can be in the final output.
+  void spill();
+
+  // Returns true if the row at 'index' of 'decodedVectors_' is ordered before
+  // 'spillThresholdRow_'.
+  bool belowSpillThreshold(vector_size_t index);
+
+  RowVectorPtr getOutputWithSpill();
+
   const int32_t count_;
 
+  // The max memory that a TopN can hold before spilling. If it is zero, then
+  // there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
+  // The map from the column channel in 'data_' to the output channel. The
+  // sorting key columns are stored first in 'data_'.
+  std::vector<IdentityProjection> columnMap_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr spillType_;
+
   bool finished_ = false;
   uint32_t numRowsReturned_ = 0;
 
@@ -114,5 +151,26 @@ class TopN : public Operator {
   std::vector<char*> rows_;
 
   std::vector<DecodedVector> decodedVectors_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Stores the sorting keys of the last top row of the heap when it was
+  // spilled. There are already 'count_' spilled rows ordered before or equal
+  // to this, so the input rows not ordered before it can be discarded.
+  std::unique_ptr<RowContainer> spillThreshold_;
+  std::optional<RowComparator> spillThresholdComparator_;
+  char* spillThresholdRow_{nullptr};
+
+  // Set to read back the spilled rows in order if disk spilling has been
+  // triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Record the source rows to copy to the output in order.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,531 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TopNRowNumber.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+TopNRowNumber::TopNRowNumber(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::TopNRowNumberNode>& node)
+    : Operator(
+          driverCtx,
+          node->outputType(),
+          operatorId,
+          node->id(),
+          "TopNRowNumber"),
+      limit_(node->limit()),
+      generateRowNumber_(node->generateRowNumber()),
+      numPartitionKeys_(node->partitionKeys().size()),
+      spillMemoryThreshold_(operatorCtx_->driverCtx()
+                                ->queryConfig()
+                                .topNRowNumberSpillMemoryThreshold()),
+      spillConfig_(
+          node->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kOrderBy)
+              : std::nullopt),
+      decodedVectors_(node->sources()[0]->outputType()->size()) {
+  const auto& inputType = node->sources()[0]->outputType();
+
+  // Store the partition keys and then the sorting keys in the row container
+  // first, followed by the other input columns as dependents. A key channel
+  // which appears more than once is stored in one column for each appearance.
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<std::string> names;
+  std::vector<bool> isKeyChannel(inputType->size(), false);
+  auto addKey = [&](const core::FieldAccessTypedExprPtr& key,
+                    const core::SortOrder& sortOrder) {
+    const auto channel = exprToChannel(key.get(), inputType);
+    VELOX_CHECK(
+        channel != kConstantChannel,
+        "TopNRowNumber doesn't allow constant partition or sorting keys");
+    isKeyChannel[channel] = true;
+    columnMap_.emplace_back(keyTypes.size(), channel);
+    keyTypes.push_back(inputType->childAt(channel));
+    names.push_back(inputType->nameOf(channel));
+    spillCompareFlags_.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+    return channel;
+  };
+
+  const core::SortOrder defaultPartitionSortOrder(true, true);
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  for (const auto& key : node->partitionKeys()) {
+    const auto channel = addKey(key, defaultPartitionSortOrder);
+    hashers.push_back(
+        VectorHasher::create(inputType->childAt(channel), channel));
+  }
+  for (auto i = 0; i < node->sortingKeys().size(); ++i) {
+    const auto& sortOrder = node->sortingOrders()[i];
+    sortingChannels_.push_back(addKey(node->sortingKeys()[i], sortOrder));
+    sortingOrders_.push_back(sortOrder);
+  }
+  for (column_index_t channel = 0; channel < inputType->size(); ++channel) {
+    if (isKeyChannel[channel]) {
+      continue;
+    }
+    columnMap_.emplace_back(keyTypes.size() + dependentTypes.size(), channel);
+    dependentTypes.push_back(inputType->childAt(channel));
+    names.push_back(inputType->nameOf(channel));
+  }
+
+  std::vector<TypePtr> types = keyTypes;
+  types.insert(types.end(), dependentTypes.begin(), dependentTypes.end());
+  spillType_ = ROW(std::move(names), std::move(types));
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+
+  if (!hashers.empty()) {
+    // Each partition stores its index into 'partitions_' in an INTEGER
+    // dependent column of the hash table.
+    static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+    table_ = HashTable<false>::createForAggregation(
+        std::move(hashers), kNoAggregates, pool(), {INTEGER()});
+    lookup_ = std::make_unique<HashLookup>(table_->hashers());
+    partitionIndexOffset_ =
+        table_->rows()->columnAt(numPartitionKeys_).offset();
+  }
+  resetPartitions();
+}
+
+void TopNRowNumber::resetPartitions() {
+  partitions_.clear();
+  if (numPartitionKeys_ == 0) {
+    partitions_.emplace_back();
+  }
+}
+
+void TopNRowNumber::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
+  const auto numInput = input->size();
+  inputRows_.resize(numInput);
+  for (auto col = 0; col < input->childrenSize(); ++col) {
+    decodedVectors_[col].decode(*input->childAt(col), inputRows_);
+  }
+
+  if (table_ == nullptr) {
+    for (auto row = 0; row < numInput; ++row) {
+      addToPartition(row, partitions_[0]);
+    }
+    return;
+  }
+
+  probePartitions(input);
+  for (auto row = 0; row < numInput; ++row) {
+    addToPartition(row, partitions_[partitionIndex(lookup_->hits[row])]);
+  }
+}
+
+void TopNRowNumber::probePartitions(const RowVectorPtr& input) {
+  auto& hashers = lookup_->hashers;
+  lookup_->reset(input->size());
+  const auto mode = table_->hashMode();
+
+  for (auto i = 0; i < hashers.size(); ++i) {
+    auto key = input->childAt(hashers[i]->channel())->loadedVector();
+    hashers[i]->decode(*key, inputRows_);
+  }
+
+  bool rehash = false;
+  for (auto i = 0; i < hashers.size(); ++i) {
+    if (mode != BaseHashTable::HashMode::kHash) {
+      if (!hashers[i]->computeValueIds(inputRows_, lookup_->hashes)) {
+        rehash = true;
+      }
+    } else {
+      hashers[i]->hash(inputRows_, i > 0, lookup_->hashes);
+    }
+  }
+
+  if (rehash) {
+    if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+      table_->decideHashMode(input->size());
+    }
+    probePartitions(input);
+    return;
+  }
+
+  std::iota(lookup_->rows.begin(), lookup_->rows.end(), 0);
+  table_->groupProbe(*lookup_);
+  for (auto row : lookup_->newGroups) {
+    partitionIndex(lookup_->hits[row]) = partitions_.size();
+    partitions_.emplace_back();
+  }
+}
+
+bool TopNRowNumber::isBefore(const char* lhs, const char* rhs) {
+  for (auto i = 0; i < sortingOrders_.size(); ++i) {
+    const auto& sortOrder = sortingOrders_[i];
+    if (auto result = data_->compare(
+            lhs,
+            rhs,
+            numPartitionKeys_ + i,
+            {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
+      return result < 0;
+    }
+  }
+  return false;
+}
+
+bool TopNRowNumber::isBefore(vector_size_t index, const char* rhs) {
+  for (auto i = 0; i < sortingOrders_.size(); ++i) {
+    const auto& sortOrder = sortingOrders_[i];
+    if (auto result = data_->compare(
+            rhs,
+            data_->columnAt(numPartitionKeys_ + i),
+            decodedVectors_[sortingChannels_[i]],
+            index,
+            {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
+      return result > 0;
+    }
+  }
+  return false;
+}
+
+void TopNRowNumber::addToPartition(
+    vector_size_t index,
+    std::vector<char*>& partition) {
+  auto isBeforeRow = [&](const char* lhs, const char* rhs) {
+    return isBefore(lhs, rhs);
+  };
+
+  char* newRow = nullptr;
+  if (static_cast<int32_t>(partition.size()) < limit_) {
+    newRow = data_->newRow();
+  } else {
+    if (!isBefore(index, partition.front())) {
+      return;
+    }
+    std::pop_heap(partition.begin(), partition.end(), isBeforeRow);
+    // Reuse the memory of the row that drops out of the top rows.
+    newRow = data_->initializeRow(partition.back(), true /* reuse */);
+    partition.pop_back();
+  }
+
+  for (const auto& projection : columnMap_) {
+    data_->store(
+        decodedVectors_[projection.outputChannel],
+        index,
+        newRow,
+        projection.inputChannel);
+  }
+  partition.push_back(newRow);
+  std::push_heap(partition.begin(), partition.end(), isBeforeRow);
+}
+
+void TopNRowNumber::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  if (data_->numRows() == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    spill();
+    return;
+  }
+
+  auto tracker = pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if ((spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) ||
+      tracker->highUsage()) {
+    spill();
+    return;
+  }
+
+  // Each input row may start a new partition, so all of them may need a new
+  // row.
+  const int64_t numNewRows = input->size();
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+  if (freeRows >= numNewRows &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for the new rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(numNewRows, outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  spill();
+}
+
+void TopNRowNumber::spill() {
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK_NOT_NULL(pool()->getMemoryUsageTracker());
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        spillCompareFlags_.size(),
+        spillCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.maxSpillWriteParallelism,
+        spillConfig.directIo,
+        spillConfig.tiers);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+
+  // The spilled runs hold the top rows of each partition for the input so
+  // far. The top rows of a partition over all the input are the first rows of
+  // the partition in the merged runs.
+  spiller_->spill(0, 0);
+  VELOX_CHECK_EQ(data_->numRows(), 0);
+  // Physically frees the memory of the spilled rows.
+  data_->clear();
+  if (table_ != nullptr) {
+    table_->clear();
+  }
+  resetPartitions();
+  updateSpillStats();
+}
+
+void TopNRowNumber::updateSpillStats() {
+  VELOX_CHECK_NOT_NULL(spiller_);
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  lockedStats->spillWriteTiming = spillStats.spillWriteTiming;
+}
+
+void TopNRowNumber::noMoreInput() {
+  Operator::noMoreInput();
+  numRowsPerOutput_ = outputBatchRows(data_->estimateRowSize());
+
+  if (spiller_ != nullptr) {
+    // Merge the rows left in 'data_' with the spilled runs at output. There is
+    // only one spill partition so all the rows are from the spilled partition.
+    VELOX_CHECK(spiller_->finishSpill().empty());
+    spillMerge_ = spiller_->startMerge(0);
+    resetPartitions();
+    updateSpillStats();
+    return;
+  }
+
+  if (data_->numRows() == 0) {
+    finished_ = true;
+  }
+}
+
+RowVectorPtr TopNRowNumber::getOutput() {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  if (spillMerge_ != nullptr) {
+    return getOutputWithSpill();
+  }
+
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numRowsPerOutput_, pool()));
+  int64_t* rawRowNumbers = generateRowNumber_
+      ? result->children().back()->asFlatVector<int64_t>()->mutableRawValues()
+      : nullptr;
+
+  auto isBeforeRow = [&](const char* lhs, const char* rhs) {
+    return isBefore(lhs, rhs);
+  };
+  outputRows_.resize(numRowsPerOutput_);
+  vector_size_t numOutputRows = 0;
+  while (numOutputRows < numRowsPerOutput_ &&
+         outputPartition_ < partitions_.size()) {
+    auto& partition = partitions_[outputPartition_];
+    if (outputPartitionRow_ == 0) {
+      std::sort_heap(partition.begin(), partition.end(), isBeforeRow);
+    }
+    const auto numRows = std::min<vector_size_t>(
+        numRowsPerOutput_ - numOutputRows,
+        partition.size() - outputPartitionRow_);
+    for (auto i = 0; i < numRows; ++i) {
+      outputRows_[numOutputRows + i] = partition[outputPartitionRow_ + i];
+      if (rawRowNumbers != nullptr) {
+        rawRowNumbers[numOutputRows + i] = outputPartitionRow_ + i + 1;
+      }
+    }
+    numOutputRows += numRows;
+    outputPartitionRow_ += numRows;
+    if (static_cast<size_t>(outputPartitionRow_) == partition.size()) {
+      ++outputPartition_;
+      outputPartitionRow_ = 0;
+    }
+  }
+  finished_ = (outputPartition_ == partitions_.size());
+  if (numOutputRows == 0) {
+    return nullptr;
+  }
+
+  result->resize(numOutputRows);
+  for (const auto& projection : columnMap_) {
+    data_->extractColumn(
+        outputRows_.data(),
+        numOutputRows,
+        projection.inputChannel,
+        result->childAt(projection.outputChannel));
+  }
+  return result;
+}
+
+bool TopNRowNumber::startsNewPartition(SpillMergeStream* stream) {
+  if (numPartitionKeys_ == 0) {
+    // All the rows are in one partition.
+    return spillRowNumber_ == 0;
+  }
+
+  const auto index = stream->currentIndex();
+  if (spillPartitionRow_ != nullptr) {
+    bool samePartition = true;
+    for (auto i = 0; i < numPartitionKeys_; ++i) {
+      if (spillPartition_->compare(
+              spillPartitionRow_,
+              spillPartition_->columnAt(i),
+              stream->decoded(i),
+              index) != 0) {
+        samePartition = false;
+        break;
+      }
+    }
+    if (samePartition) {
+      return false;
+    }
+  }
+
+  if (spillPartition_ == nullptr) {
+    spillPartition_ = std::make_unique<RowContainer>(
+        std::vector<TypePtr>(
+            spillType_->children().begin(),
+            spillType_->children().begin() + numPartitionKeys_),
+        pool());
+  }
+  spillPartition_->clear();
+  spillPartitionRow_ = spillPartition_->newRow();
+  for (auto i = 0; i < numPartitionKeys_; ++i) {
+    spillPartition_->store(stream->decoded(i), index, spillPartitionRow_, i);
+  }
+  return true;
+}
+
+RowVectorPtr TopNRowNumber::getOutputWithSpill() {
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numRowsPerOutput_, pool()));
+  int64_t* rawRowNumbers = generateRowNumber_
+      ? result->children().back()->asFlatVector<int64_t>()->mutableRawValues()
+      : nullptr;
+  spillSources_.resize(numRowsPerOutput_);
+  spillSourceRows_.resize(numRowsPerOutput_);
+
+  vector_size_t outputRow = 0;
+  vector_size_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < numRowsPerOutput_) {
+    SpillMergeStream* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      finished_ = true;
+      break;
+    }
+
+    if (startsNewPartition(stream)) {
+      spillRowNumber_ = 0;
+    }
+    const auto index = stream->currentIndex(&isEndOfBatch);
+    // The rows after the first 'limit_' of a partition are skipped.
+    if (spillRowNumber_ < limit_) {
+      ++spillRowNumber_;
+      spillSources_[outputSize] = &stream->current();
+      spillSourceRows_[outputSize] = index;
+      if (rawRowNumbers != nullptr) {
+        rawRowNumbers[outputRow + outputSize] = spillRowNumber_;
+      }
+      ++outputSize;
+    }
+    if (FOLLY_UNLIKELY(isEndOfBatch) && outputSize != 0) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherCopy(
+          result.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+
+    // Advance the stream.
+    stream->pop();
+  }
+
+  if (FOLLY_LIKELY(outputSize != 0)) {
+    gatherCopy(
+        result.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+    outputRow += outputSize;
+  }
+
+  if (outputRow == 0) {
+    return nullptr;
+  }
+  result->resize(outputRow);
+  return result;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/HashTable.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
+
+namespace facebook::velox::exec {
+
+/// Computes row_number() over (partition by ... order by ...) <= limit. Keeps
+/// a heap of the top 'limit' rows for each partition. The partitions are
+/// looked up in a hash table on the partition keys. Each partition has an
+/// index into 'partitions_' stored in its hash table row. The input rows are
+/// stored in a RowContainer only while they are in the top rows of their
+/// partition. The partitions are output one after the other after all the
+/// input is received.
+///
+/// If disk spilling is enabled, all the rows are spilled in runs sorted by
+/// (partition keys + sorting keys) when the memory usage grows too large, and
+/// the hash table is cleared. At output, the spilled runs are merged and the
+/// first 'limit' rows of each partition are produced.
+class TopNRowNumber : public Operator {
+ public:
+  TopNRowNumber(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::TopNRowNumberNode>& node);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  void noMoreInput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+ private:
+  // Looks up or creates the partitions of all the rows of 'input' in
+  // 'table_'. Sets lookup_->hits to the partitions.
+  void probePartitions(const RowVectorPtr& input);
+
+  // Returns the index into 'partitions_' of a hash table row.
+  int32_t& partitionIndex(char* group) const {
+    return *reinterpret_cast<int32_t*>(group + partitionIndexOffset_);
+  }
+
+  // Adds the row at 'index' of 'decodedVectors_' to the top rows in
+  // 'partition' if it is ordered before the last of them.
+  void addToPartition(vector_size_t index, std::vector<char*>& partition);
+
+  // Returns true if 'lhs' is ordered before 'rhs' on the sorting keys.
+  bool isBefore(const char* lhs, const char* rhs);
+
+  // Returns true if the row at 'index' of 'decodedVectors_' is ordered before
+  // 'rhs' on the sorting keys.
+  bool isBefore(vector_size_t index, const char* rhs);
+
+  // Clears the partitions. If there are no partition keys, adds the single
+  // partition that all the rows belong to.
+  void resetPartitions();
+
+  // Checks if spilling is enabled and if 'input' fits in the existing memory
+  // reservation. Spills all the rows of 'data_' if not.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills all the rows of 'data_' and clears the partitions.
+  void spill();
+
+  void updateSpillStats();
+
+  // Returns true if the current row of 'stream' is in a different partition
+  // than the previous row read from the spilled runs. Saves the partition
+  // keys of the row in 'spillPartition_' if so.
+  bool startsNewPartition(SpillMergeStream* stream);
+
+  RowVectorPtr getOutputWithSpill();
+
+  const int32_t limit_;
+
+  const bool generateRowNumber_;
+
+  const size_t numPartitionKeys_;
+
+  // The max memory that a TopNRowNumber can hold before spilling. If it is
+  // zero, then there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
+  // The map from the column in 'data_' to the input channel. The partition
+  // keys are stored first in 'data_', followed by the sorting keys, to be able
+  // to sort and merge the spilled rows.
+  std::vector<IdentityProjection> columnMap_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr spillType_;
+
+  // The compare flags of the key columns of 'data_' used for spilling.
+  std::vector<CompareFlags> spillCompareFlags_;
+
+  // The sort order of each sorting key. The sorting keys are the columns
+  // following the partition keys in 'data_'.
+  std::vector<core::SortOrder> sortingOrders_;
+
+  // The input channel of each sorting key.
+  std::vector<column_index_t> sortingChannels_;
+
+  // Stores the top rows of all the partitions.
+  std::unique_ptr<RowContainer> data_;
+
+  std::vector<DecodedVector> decodedVectors_;
+
+  SelectivityVector inputRows_;
+
+  // Hash table on the partition keys. Null if there are no partition keys.
+  std::unique_ptr<BaseHashTable> table_;
+  std::unique_ptr<HashLookup> lookup_;
+
+  // Offset of the partition index in the rows of 'table_'.
+  int32_t partitionIndexOffset_{0};
+
+  // A max-heap of up to 'limit_' rows in 'data_' for each partition. The
+  // first row is the last one in the sort order.
+  std::vector<std::vector<char*>> partitions_;
+
+  // Number of rows that fit into an output block.
+  vector_size_t numRowsPerOutput_{0};
+
+  // The partition and the row in it to output next. The rows of a partition
+  // are sorted when its output starts.
+  size_t outputPartition_{0};
+  vector_size_t outputPartitionRow_{0};
+
+  std::vector<char*> outputRows_;
+
+  bool finished_{false};
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back the spilled rows in order if disk spilling has been
+  // triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Stores the partition keys of the partition being read back from
+  // 'spillMerge_'.
+  std::unique_ptr<RowContainer> spillPartition_;
+  char* spillPartitionRow_{nullptr};
+
+  // The row number of the last row read back from 'spillMerge_' in its
+  // partition.
+  int64_t spillRowNumber_{0};
+
+  // Record the source rows to copy to the output in order.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+};
+} // namespace facebook::velox::exec
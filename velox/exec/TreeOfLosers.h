@@ -55,6 +55,35 @@ class MergeStream {
   }
 };
 
+// Returns the number of inner nodes of a tree of losers over 'numStreams'
+// streams. The streams follow the inner nodes in the node numbering.
+inline int32_t treeOfLosersFirstStream(int32_t numStreams) {
+  int32_t size = 0;
+  int32_t levelSize = 1;
+  while (numStreams > levelSize) {
+    size += levelSize;
+    levelSize *= 2;
+  }
+
+  if (numStreams == bits::nextPowerOfTwo(numStreams)) {
+    // All leaves are on last level.
+    return size;
+  }
+  // Some of the streams are on the last level and some on the level before.
+  // The first stream follows the last inner node in the node numbering.
+
+  auto secondLastSize = levelSize / 2;
+  auto overflow = numStreams - secondLastSize;
+  // Suppose 12 streams. The last level has 16 places, the second
+  // last 8. If we fill the second last level we have 8 streams
+  // and 4 left over. These 4 need parents on the second last
+  // level. So, we end up with 4 inner nodes on the second last
+  // level and 8 nodes on the last level. The streams at the left
+  // of the second last level become inner nodes and their streams
+  // move to the level below.
+  return (size - secondLastSize) + overflow;
+}
+
 // Implements a tree of losers algorithm for merging ordered
 // streams. The TreeOfLosers owns one or more instances of
 // Stream. At each call of next(), it returns the Stream that has
@@ -71,33 +100,7 @@ class TreeOfLosers {
     static_assert(std::is_base_of_v<MergeStream, Stream>);
     VELOX_CHECK_LT(streams_.size(), std::numeric_limits<TIndex>::max());
     VELOX_CHECK_GE(streams_.size(), 1);
-
-    int32_t size = 0;
-    int32_t levelSize = 1;
-    int32_t numStreams = streams_.size();
-    while (numStreams > levelSize) {
-      size += levelSize;
-      levelSize *= 2;
-    }
-
-    if (numStreams == bits::nextPowerOfTwo(numStreams)) {
-      // All leaves are on last level.
-      firstStream_ = size;
-    } else {
-      // Some of the streams are on the last level and some on the level before.
-      // The first stream follows the last inner node in the node numbering.
-
-      auto secondLastSize = levelSize / 2;
-      auto overflow = numStreams - secondLastSize;
-      // Suppose 12 streams. The last level has 16 places, the second
-      // last 8. If we fill the second last level we have 8 streams
-      // and 4 left over. These 4 need parents on the second last
-      // level. So, we end up with 4 inner nodes on the second last
-      // level and 8 nodes on the last level. The streams at the left
-      // of the second last level become inner nodes and their streams
-      // move to the level below.
-      firstStream_ = (size - secondLastSize) + overflow;
-    }
+    firstStream_ = treeOfLosersFirstStream(streams_.size());
     values_.resize(firstStream_, kEmpty);
     equals_.resize(firstStream_, false);
   }
@@ -300,6 +303,143 @@ class TreeOfLosers {
   int32_t firstStream_;
 };
 
+// TreeOfLosers for streams that have a 64 bit prefix of their first value.
+// Stream::prefix() returns the prefix. A stream with a lower prefix than
+// another has a lower first value. Streams with equal prefixes are compared
+// with Stream::operator<. The inner nodes keep the prefix of their stream next
+// to its index, so that most comparisons are comparisons of integers in one
+// array and do not touch the streams. The caller may also take a run of values
+// from the winner without going through the tree, see runBound().
+template <typename Stream, typename TIndex = uint16_t>
+class PrefixTreeOfLosers {
+ public:
+  explicit PrefixTreeOfLosers(std::vector<std::unique_ptr<Stream>> streams)
+      : streams_(std::move(streams)) {
+    static_assert(std::is_base_of_v<MergeStream, Stream>);
+    VELOX_CHECK_LT(streams_.size(), std::numeric_limits<TIndex>::max());
+    VELOX_CHECK_GE(streams_.size(), 1);
+    firstStream_ = treeOfLosersFirstStream(streams_.size());
+    nodes_.resize(firstStream_, Node{0, kEmpty});
+  }
+
+  // Returns the stream with the lowest first element. The caller is
+  // expected to pop off the first element of the stream before
+  // calling this again. Returns nullptr when all streams are at end.
+  Stream* next() {
+    if (UNLIKELY(lastIndex_ == kEmpty)) {
+      if (UNLIKELY(nodes_.empty())) {
+        // Only one stream. We handle this off the common path.
+        return streams_[0]->hasData() ? streams_[0].get() : nullptr;
+      }
+      lastIndex_ = first(0).index;
+    } else {
+      lastIndex_ =
+          propagate(parent(firstStream_ + lastIndex_), leaf(lastIndex_));
+    }
+    return lastIndex_ == kEmpty ? nullptr : streams_[lastIndex_].get();
+  }
+
+  // Returns the lowest prefix of the streams other than the one returned by
+  // the last next(). While the prefix of the returned stream is less than
+  // this, its first value is less than the first values of all the other
+  // streams and the caller may pop it and take the next value without calling
+  // next(). Returns the max uint64_t if no other stream has data.
+  uint64_t runBound() const {
+    auto bound = std::numeric_limits<uint64_t>::max();
+    if (nodes_.empty()) {
+      return bound;
+    }
+    VELOX_DCHECK_NE(lastIndex_, kEmpty);
+    // The lowest of the other values is one of the losers on the path of the
+    // winner.
+    int32_t node = firstStream_ + lastIndex_;
+    do {
+      node = parent(node);
+      if (nodes_[node].index != kEmpty) {
+        bound = std::min(bound, nodes_[node].prefix);
+      }
+    } while (node != 0);
+    return bound;
+  }
+
+ private:
+  static constexpr TIndex kEmpty = std::numeric_limits<TIndex>::max();
+
+  struct Node {
+    uint64_t prefix;
+    TIndex index;
+  };
+
+  Node leaf(TIndex index) const {
+    return streams_[index]->hasData() ? Node{streams_[index]->prefix(), index}
+                                      : Node{0, kEmpty};
+  }
+
+  bool less(const Node& left, const Node& right) const {
+    if (left.prefix != right.prefix) {
+      return left.prefix < right.prefix;
+    }
+    return *streams_[left.index] < *streams_[right.index];
+  }
+
+  Node first(int32_t node) {
+    if (node >= firstStream_) {
+      return leaf(node - firstStream_);
+    }
+    auto left = first(leftChild(node));
+    auto right = first(rightChild(node));
+    if (left.index == kEmpty) {
+      return right;
+    } else if (right.index == kEmpty) {
+      return left;
+    } else if (less(left, right)) {
+      nodes_[node] = right;
+      return left;
+    } else {
+      nodes_[node] = left;
+      return right;
+    }
+  }
+
+  FOLLY_ALWAYS_INLINE TIndex propagate(int32_t node, Node value) {
+    for (;;) {
+      auto& loser = nodes_[node];
+      if (UNLIKELY(loser.index == kEmpty)) {
+        // The value goes past the node and the node stays empty.
+      } else if (UNLIKELY(value.index == kEmpty)) {
+        value = loser;
+        loser.index = kEmpty;
+      } else if (less(loser, value)) {
+        // The node had the lower value, the value stays here and the previous
+        // value goes up.
+        std::swap(value, loser);
+      }
+      if (UNLIKELY(node == 0)) {
+        return value.index;
+      }
+      node = parent(node);
+    }
+  }
+
+  static int32_t parent(int32_t node) {
+    return (node - 1) / 2;
+  }
+
+  static int32_t leftChild(int32_t node) {
+    return node * 2 + 1;
+  }
+
+  static int32_t rightChild(int32_t node) {
+    return node * 2 + 2;
+  }
+
+  // The loser at each inner node and its prefix.
+  std::vector<Node> nodes_;
+  std::vector<std::unique_ptr<Stream>> streams_;
+  TIndex lastIndex_ = kEmpty;
+  int32_t firstStream_;
+};
+
 // Array-based merging structure implementing the same interface as
 // TreOfLosers. The streams are sorted on their first value. The
 // first stream is returned and then reinserted in the array at the
@@ -41,6 +41,7 @@ Unnest::Unnest(
   }
 
   unnestDecoded_.resize(unnestVariables.size());
+  elementIndices_.resize(unnestVariables.size());
 
   if (withOrdinality_) {
     VELOX_CHECK_EQ(
@@ -58,65 +59,113 @@ Unnest::Unnest(
 
 void Unnest::addInput(RowVectorPtr input) {
   input_ = std::move(input);
-}
+  nextInputRow_ = 0;
+  nextElement_ = 0;
 
-RowVectorPtr Unnest::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
-
-  auto size = input_->size();
+  const auto size = input_->size();
   inputRows_.resize(size);
 
   // The max number of elements at each row across all unnested columns.
-  auto maxSizes = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
-  auto rawMaxSizes = maxSizes->asMutable<int64_t>();
-
-  std::vector<const vector_size_t*> rawSizes;
-  std::vector<const vector_size_t*> rawOffsets;
-  std::vector<const vector_size_t*> rawIndices;
+  maxSizes_ = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
+  rawMaxSizes_ = maxSizes_->asMutable<int64_t>();
 
-  rawSizes.resize(unnestChannels_.size());
-  rawOffsets.resize(unnestChannels_.size());
-  rawIndices.resize(unnestChannels_.size());
+  rawSizes_.resize(unnestChannels_.size());
+  rawOffsets_.resize(unnestChannels_.size());
+  rawIndices_.resize(unnestChannels_.size());
 
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     const auto& unnestVector = input_->childAt(unnestChannels_[channel]);
     unnestDecoded_[channel].decode(*unnestVector, inputRows_);
 
     auto& currentDecoded = unnestDecoded_[channel];
-    rawIndices[channel] = currentDecoded.indices();
+    rawIndices_[channel] = currentDecoded.indices();
 
     const ArrayVector* unnestBaseArray;
     const MapVector* unnestBaseMap;
     if (unnestVector->typeKind() == TypeKind::ARRAY) {
       unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      rawSizes[channel] = unnestBaseArray->rawSizes();
-      rawOffsets[channel] = unnestBaseArray->rawOffsets();
+      rawSizes_[channel] = unnestBaseArray->rawSizes();
+      rawOffsets_[channel] = unnestBaseArray->rawOffsets();
     } else {
       VELOX_CHECK(unnestVector->typeKind() == TypeKind::MAP);
       unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      rawSizes[channel] = unnestBaseMap->rawSizes();
-      rawOffsets[channel] = unnestBaseMap->rawOffsets();
+      rawSizes_[channel] = unnestBaseMap->rawSizes();
+      rawOffsets_[channel] = unnestBaseMap->rawOffsets();
     }
 
     // Count max number of elements per row.
-    auto currentSizes = rawSizes[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentIndices = rawIndices_[channel];
     for (auto row = 0; row < size; ++row) {
       if (!currentDecoded.isNullAt(row)) {
         auto unnestSize = currentSizes[currentIndices[row]];
-        if (rawMaxSizes[row] < unnestSize) {
-          rawMaxSizes[row] = unnestSize;
+        if (rawMaxSizes_[row] < unnestSize) {
+          rawMaxSizes_[row] = unnestSize;
         }
       }
     }
   }
+}
 
-  // Calculate the number of rows in the unnest result.
-  int numElements = 0;
-  for (auto row = 0; row < size; ++row) {
-    numElements += rawMaxSizes[row];
+namespace {
+// Returns a mutable buffer of at least 'size' indices. Reuses 'indices' if
+// the previous output that used it has been released.
+vector_size_t* initializeIndices(
+    BufferPtr& indices,
+    vector_size_t size,
+    memory::MemoryPool* pool) {
+  if (!indices || !indices->unique() ||
+      indices->capacity() < sizeof(vector_size_t) * size) {
+    indices = allocateIndices(size, pool);
+  } else {
+    indices->setSize(sizeof(vector_size_t) * size);
+  }
+  return indices->asMutable<vector_size_t>();
+}
+} // namespace
+
+template <typename Func>
+void Unnest::forEachOutputRow(Func func) const {
+  for (auto row = firstRow_; row <= lastRow_; ++row) {
+    const vector_size_t begin = row == firstRow_ ? firstRowBegin_ : 0;
+    const vector_size_t end =
+        row == lastRow_ ? lastRowEnd_ : rawMaxSizes_[row];
+    if (begin < end) {
+      func(row, begin, end);
+    }
+  }
+}
+
+RowVectorPtr Unnest::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  // Unnest the rows from 'nextInputRow_' until the output batch is full. A
+  // row with more elements than fit in a batch is split between batches, so
+  // that the batches stay within adaptiveOutputBatchRows().
+  const auto size = input_->size();
+  const vector_size_t maxOutputRows = adaptiveOutputBatchRows();
+  firstRow_ = nextInputRow_;
+  firstRowBegin_ = nextElement_;
+  vector_size_t numElements = 0;
+  while (nextInputRow_ < size && numElements < maxOutputRows) {
+    const auto remaining = rawMaxSizes_[nextInputRow_] - nextElement_;
+    if (numElements + remaining > maxOutputRows) {
+      nextElement_ += maxOutputRows - numElements;
+      numElements = maxOutputRows;
+      break;
+    }
+    numElements += remaining;
+    ++nextInputRow_;
+    nextElement_ = 0;
+  }
+  if (nextElement_ > 0) {
+    lastRow_ = nextInputRow_;
+    lastRowEnd_ = nextElement_;
+  } else {
+    lastRow_ = nextInputRow_ - 1;
+    lastRowEnd_ = lastRow_ >= 0 ? rawMaxSizes_[lastRow_] : 0;
   }
 
   if (numElements == 0) {
@@ -127,67 +176,79 @@ RowVectorPtr Unnest::getOutput() {
 
   // Create "indices" buffer to repeat rows as many times as there are elements
   // in the array (or map) in unnestDecoded.
-  auto repeatedIndices = allocateIndices(numElements, pool());
-  auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
+  auto* rawRepeatedIndices =
+      initializeIndices(repeatedIndices_, numElements, pool());
   vector_size_t index = 0;
-  for (auto row = 0; row < size; ++row) {
-    for (auto i = 0; i < rawMaxSizes[row]; i++) {
-      rawRepeatedIndices[index++] = row;
-    }
-  }
-
-  // Wrap "replicated" columns in a dictionary using 'repeatedIndices'.
+  forEachOutputRow([&](auto row, auto begin, auto end) {
+    std::fill(
+        rawRepeatedIndices + index,
+        rawRepeatedIndices + index + end - begin,
+        row);
+    index += end - begin;
+  });
+
+  // Wrap "replicated" columns in a dictionary using 'repeatedIndices_'.
   std::vector<VectorPtr> outputs(outputType_->size());
   for (const auto& projection : identityProjections_) {
     outputs[projection.outputChannel] = wrapChild(
-        numElements, repeatedIndices, input_->childAt(projection.inputChannel));
+        numElements,
+        repeatedIndices_,
+        input_->childAt(projection.inputChannel));
   }
 
   // Create unnest columns.
   vector_size_t outputsIndex = identityProjections_.size();
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     auto& currentDecoded = unnestDecoded_[channel];
-    auto currentSizes = rawSizes[channel];
-    auto currentOffsets = rawOffsets[channel];
-    auto currentIndices = rawIndices[channel];
-
-    BufferPtr elementIndices = allocateIndices(numElements, pool());
-    auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
-
-    auto nulls =
-        AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
-    auto rawNulls = nulls->asMutable<uint64_t>();
+    auto currentSizes = rawSizes_[channel];
+    auto currentOffsets = rawOffsets_[channel];
+    auto currentIndices = rawIndices_[channel];
+
+    auto* rawElementIndices =
+        initializeIndices(elementIndices_[channel], numElements, pool());
+
+    // Allocated on the first row that is shorter than the others or null.
+    BufferPtr nulls;
+    uint64_t* rawNulls = nullptr;
+    auto setNulls = [&](vector_size_t begin, vector_size_t end) {
+      if (!rawNulls) {
+        nulls =
+            AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
+        rawNulls = nulls->asMutable<uint64_t>();
+      }
+      bits::fillBits(rawNulls, begin, end, bits::kNull);
+    };
 
     // Make dictionary index for elements column since they may be out of order.
     index = 0;
     bool identityMapping = true;
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-
-      if (!currentDecoded.isNullAt(row)) {
-        auto offset = currentOffsets[currentIndices[row]];
-        auto unnestSize = currentSizes[currentIndices[row]];
-
-        if (index != offset || unnestSize < maxSize) {
-          identityMapping = false;
-        }
-
-        for (auto i = 0; i < unnestSize; i++) {
-          rawElementIndices[index++] = offset + i;
-        }
-
-        for (auto i = unnestSize; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
-        }
-      } else if (maxSize > 0) {
+    forEachOutputRow([&](auto row, auto begin, auto end) {
+      const auto numRowElements = end - begin;
+      if (currentDecoded.isNullAt(row)) {
         identityMapping = false;
-
-        for (auto i = 0; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
-        }
+        setNulls(index, index + numRowElements);
+        index += numRowElements;
+        return;
       }
-    }
+      const auto offset = currentOffsets[currentIndices[row]] + begin;
+      const auto unnestSize =
+          std::max<vector_size_t>(currentSizes[currentIndices[row]] - begin, 0);
+      const auto numValues = std::min(unnestSize, numRowElements);
+      if (index != offset || numValues < numRowElements) {
+        identityMapping = false;
+      }
+      std::iota(
+          rawElementIndices + index,
+          rawElementIndices + index + numValues,
+          offset);
+      if (numValues < numRowElements) {
+        setNulls(index + numValues, index + numRowElements);
+      }
+      index += numRowElements;
+    });
 
+    // The indices buffer stays owned by 'elementIndices_' if not used.
+    const auto& indices = elementIndices_[channel];
     if (currentDecoded.base()->typeKind() == TypeKind::ARRAY) {
       // Construct unnest column using Array elements wrapped using above
       // created dictionary.
@@ -195,22 +256,17 @@ RowVectorPtr Unnest::getOutput() {
       outputs[outputsIndex++] = identityMapping
           ? unnestBaseArray->elements()
           : wrapChild(
-                numElements,
-                elementIndices,
-                unnestBaseArray->elements(),
-                nulls);
+                numElements, indices, unnestBaseArray->elements(), nulls);
     } else {
       // Construct two unnest columns for Map keys and values vectors wrapped
       // using above created dictionary.
       auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
       outputs[outputsIndex++] = identityMapping
           ? unnestBaseMap->mapKeys()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapKeys(), nulls);
+          : wrapChild(numElements, indices, unnestBaseMap->mapKeys(), nulls);
       outputs[outputsIndex++] = identityMapping
           ? unnestBaseMap->mapValues()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapValues(), nulls);
+          : wrapChild(numElements, indices, unnestBaseMap->mapValues(), nulls);
     }
   }
 
@@ -221,17 +277,18 @@ RowVectorPtr Unnest::getOutput() {
     // Set the ordinality at each result row to be the index of the element in
     // the original array (or map) plus one.
     auto rawOrdinality = ordinalityVector->mutableRawValues();
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-      std::iota(rawOrdinality, rawOrdinality + maxSize, 1);
-      rawOrdinality += maxSize;
-    }
+    forEachOutputRow([&](auto /*row*/, auto begin, auto end) {
+      std::iota(rawOrdinality, rawOrdinality + end - begin, begin + 1);
+      rawOrdinality += end - begin;
+    });
 
     // Ordinality column is always at the end.
     outputs.back() = std::move(ordinalityVector);
   }
 
-  input_ = nullptr;
+  if (nextInputRow_ == size) {
+    input_ = nullptr;
+  }
   return std::make_shared<RowVector>(
       pool(), outputType_, BufferPtr(nullptr), numElements, std::move(outputs));
 }
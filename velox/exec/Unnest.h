@@ -29,7 +29,7 @@ class Unnest : public Operator {
   }
 
   bool needsInput() const override {
-    return true;
+    return !input_;
   }
 
   void addInput(RowVectorPtr input) override;
@@ -39,11 +39,49 @@ class Unnest : public Operator {
   bool isFinished() override;
 
  private:
+  // Calls 'func(row, begin, end)' for each row of 'input_' in the current
+  // output batch, where [begin, end) are the positions among the unnested
+  // elements of 'row' that go to the batch.
+  template <typename Func>
+  void forEachOutputRow(Func func) const;
+
   std::vector<column_index_t> unnestChannels_;
 
   SelectivityVector inputRows_;
   std::vector<DecodedVector> unnestDecoded_;
 
+  // The max number of elements at each row of 'input_' across all unnested
+  // columns.
+  BufferPtr maxSizes_;
+  int64_t* rawMaxSizes_{nullptr};
+
+  // The sizes, offsets and decoded indices of each unnested column.
+  std::vector<const vector_size_t*> rawSizes_;
+  std::vector<const vector_size_t*> rawOffsets_;
+  std::vector<const vector_size_t*> rawIndices_;
+
+  // The first row of 'input_' that is not fully unnested yet and the number
+  // of its elements that are already unnested. The output batches are
+  // limited to adaptiveOutputBatchRows(), so an input with large arrays or
+  // maps is unnested over several getOutput() calls and a single large array
+  // or map may be split between batches.
+  vector_size_t nextInputRow_{0};
+  vector_size_t nextElement_{0};
+
+  // The first and last rows of 'input_' in the current output batch, the
+  // position of the first element of 'firstRow_' and one past the last
+  // element of 'lastRow_' in the batch.
+  vector_size_t firstRow_{0};
+  vector_size_t firstRowBegin_{0};
+  vector_size_t lastRow_{0};
+  vector_size_t lastRowEnd_{0};
+
+  // The indices of the replicated columns and of the elements of each
+  // unnested column in the last output batch. Reused for the next batch if
+  // no longer referenced.
+  BufferPtr repeatedIndices_;
+  std::vector<BufferPtr> elementIndices_;
+
   const bool withOrdinality_;
 };
 } // namespace facebook::velox::exec
@@ -31,6 +31,11 @@ ValueStream::ValueStream(
           valueStreamNode->id(),
           "ValueStream") {
   valueStream_ = valueStreamNode->rowVectorStream();
+  if (!valueStream_) {
+    valueStream_ =
+        valueStreamNode->streamFactory()(driverCtx->driverId, pool());
+    VELOX_CHECK_NOT_NULL(valueStream_);
+  }
 }
 
 RowVectorPtr ValueStream::getOutput() {
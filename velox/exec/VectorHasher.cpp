@@ -243,8 +243,16 @@ template <typename T, bool mayHaveNulls>
 bool VectorHasher::makeValueIdsDecoded(
     const SelectivityVector& rows,
     uint64_t* result) {
-  cachedHashes_.resize(decoded_.base()->size());
-  std::fill(cachedHashes_.begin(), cachedHashes_.end(), 0);
+  // 'cachedIds_' is kept all zeros between calls. Only the entries for the
+  // base values referenced by 'rows' are set and then reset, so that a large
+  // dictionary shared by many small batches, e.g. a string dictionary of a
+  // stripe, is not cleared for every batch.
+  const auto baseSize = decoded_.base()->size();
+  if (cachedIds_.size() < baseSize) {
+    const auto oldSize = cachedIds_.size();
+    cachedIds_.resize(baseSize);
+    std::fill(cachedIds_.begin() + oldSize, cachedIds_.end(), 0);
+  }
 
   auto indices = decoded_.indices();
   auto values = decoded_.data<T>();
@@ -260,7 +268,7 @@ bool VectorHasher::makeValueIdsDecoded(
       }
     }
     auto baseIndex = indices[row];
-    uint64_t id = cachedHashes_[baseIndex];
+    uint64_t id = cachedIds_[baseIndex];
     if (id == 0) {
       T value = values[baseIndex];
 
@@ -276,10 +284,16 @@ bool VectorHasher::makeValueIdsDecoded(
         success = false;
         return;
       }
-      cachedHashes_[baseIndex] = id;
+      cachedIds_[baseIndex] = id;
+      cachedIdIndices_.push_back(baseIndex);
     }
     result[row] = multiplier_ == 1 ? id : result[row] + multiplier_ * id;
   });
+
+  for (auto baseIndex : cachedIdIndices_) {
+    cachedIds_[baseIndex] = 0;
+  }
+  cachedIdIndices_.clear();
   return success;
 }
 
@@ -756,6 +770,7 @@ uint64_t VectorHasher::enableValueIds(uint64_t multiplier, int32_t reservePct) {
   multiplier_ = multiplier;
   rangeSize_ = addIdReserve(uniqueValues_.size(), reservePct) + 1;
   isRange_ = false;
+  isRawKey_ = false;
   uint64_t result;
   if (__builtin_mul_overflow(multiplier_, rangeSize_, &result)) {
     return kRangeTooLarge;
@@ -771,6 +786,7 @@ uint64_t VectorHasher::enableValueRange(
   VELOX_CHECK(hasRange_);
   extendRange(type_->kind(), reservePct, min_, max_);
   isRange_ = true;
+  isRawKey_ = false;
   // No overflow because max range is under 63 bits.
   if (typeKind_ == TypeKind::BOOLEAN) {
     rangeSize_ = 3;
@@ -784,6 +800,40 @@ uint64_t VectorHasher::enableValueRange(
   return result;
 }
 
+// static
+int32_t VectorHasher::rawKeyBits(TypeKind kind, bool nullable) {
+  const int32_t nullBits = nullable ? 1 : 0;
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return 2;
+    case TypeKind::TINYINT:
+      return 8 + nullBits;
+    case TypeKind::SMALLINT:
+      return 16 + nullBits;
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      return 32 + nullBits;
+    default:
+      return 0;
+  }
+}
+
+int32_t VectorHasher::enableRawKey(int32_t shift, bool nullable) {
+  const auto numBits = rawKeyBits(typeKind_, nullable);
+  VELOX_CHECK_GT(numBits, 0, "No raw key mode for {}", type_->toString());
+  VELOX_CHECK_LE(shift + numBits, 64);
+  if (typeKind_ == TypeKind::BOOLEAN) {
+    enableValueRange(1UL << shift, 0);
+    return shift + numBits;
+  }
+  multiplier_ = 1UL << shift;
+  isRange_ = false;
+  isRawKey_ = true;
+  rawKeyNullable_ = nullable;
+  rawKeyMask_ = bits::lowMask(numBits - (nullable ? 1 : 0));
+  return shift + numBits;
+}
+
 void VectorHasher::copyStatsFrom(const VectorHasher& other) {
   hasRange_ = other.hasRange_;
   rangeOverflow_ = other.rangeOverflow_;
@@ -831,6 +881,7 @@ void VectorHasher::merge(const VectorHasher& other) {
 std::string VectorHasher::toString() const {
   std::stringstream out;
   out << "<VectorHasher type=" << type_->toString() << "  isRange_=" << isRange_
+      << " isRawKey_=" << isRawKey_
       << " rangeSize= " << rangeSize_ << " min=" << min_ << " max=" << max_
       << " multiplier=" << multiplier_
       << " numDistinct=" << uniqueValues_.size() << ">";
@@ -287,6 +287,25 @@ class VectorHasher {
     return isRange_;
   }
 
+  // True if the value ids are the bits of the values, see enableRawKey().
+  bool isRawKey() const {
+    return isRawKey_;
+  }
+
+  // Returns the bits of a value id of 'kind' in raw key mode, including a bit
+  // for null if 'nullable'. Returns 0 if 'kind' has no raw key mode. BIGINT
+  // has none since it would fill a normalized key alone.
+  static int32_t rawKeyBits(TypeKind kind, bool nullable);
+
+  // Sets 'this' to raw key mode, where the value id is the low
+  // rawKeyBits() bits of the value and 'multiplier' is 1 << 'shift'. Every
+  // value has an id without any statistics, so a normalized key of raw keys
+  // never needs a rehash for new values. If 'nullable', the value bits are
+  // shifted left by one and the low bit is set for non-null values, so that
+  // null has id 0. A boolean is set to range mode, which has 2 bit ids
+  // including null. Returns 'shift' plus the bits of the id.
+  int32_t enableRawKey(int32_t shift, bool nullable);
+
   static bool typeKindSupportsValueIds(TypeKind kind) {
     switch (kind) {
       case TypeKind::BOOLEAN:
@@ -463,8 +482,17 @@ class VectorHasher {
     return inRange;
   }
 
+  template <typename T>
+  uint64_t rawKeyId(T value) const {
+    const uint64_t id = static_cast<uint64_t>(toInt64(value)) & rawKeyMask_;
+    return rawKeyNullable_ ? (id << 1) | 1 : id;
+  }
+
   template <typename T>
   uint64_t valueId(T value) {
+    if (isRawKey_) {
+      return rawKeyId(value);
+    }
     auto int64Value = toInt64(value);
     if (isRange_) {
       if (int64Value > max_ || int64Value < min_) {
@@ -488,6 +516,9 @@ class VectorHasher {
 
   template <typename T>
   uint64_t lookupValueId(T value) const {
+    if (isRawKey_) {
+      return rawKeyId(value);
+    }
     auto int64Value = toInt64(value);
     if (isRange_) {
       if (int64Value > max_ || int64Value < min_) {
@@ -538,6 +569,14 @@ class VectorHasher {
   DecodedVector decoded_;
   raw_vector<uint64_t> cachedHashes_;
 
+  // Value ids of the base values of a dictionary encoded input, indexed by
+  // base index, used by makeValueIdsDecoded(). 0 means not computed. All the
+  // entries are 0 outside of makeValueIdsDecoded().
+  raw_vector<uint64_t> cachedIds_;
+
+  // The base indices of the non-zero entries of 'cachedIds_'.
+  raw_vector<vector_size_t> cachedIdIndices_;
+
   // Single precomputed hash for constant partition keys.
   uint64_t precomputedHash_{0};
 
@@ -553,6 +592,15 @@ class VectorHasher {
   // True if the mapping is simply value - min_.
   bool isRange_ = false;
 
+  // True if the mapping is the low bits of the value, see enableRawKey().
+  bool isRawKey_ = false;
+
+  // True if the raw key ids reserve 0 for null.
+  bool rawKeyNullable_ = false;
+
+  // The value bits of a raw key id.
+  uint64_t rawKeyMask_ = 0;
+
   // True if 'min_' and 'max_' are initialized.
   bool hasRange_ = false;
 
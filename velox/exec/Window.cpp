@@ -55,9 +55,14 @@ Window::Window(
           windowNode->id(),
           "Window"),
       numInputColumns_(windowNode->sources()[0]->outputType()->size()),
-      data_(std::make_unique<RowContainer>(
-          windowNode->sources()[0]->outputType()->children(),
-          pool())),
+      inputsSorted_(windowNode->inputsSorted()),
+      spillMemoryThreshold_(operatorCtx_->driverCtx()
+                                ->queryConfig()
+                                .windowSpillMemoryThreshold()),
+      spillConfig_(
+          windowNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kWindow)
+              : std::nullopt),
       decodedInputVectors_(numInputColumns_),
       stringAllocator_(pool()) {
   auto inputType = windowNode->sources()[0]->outputType();
@@ -73,9 +78,52 @@ Window::Window(
   allKeyInfo_.insert(
       allKeyInfo_.cend(), sortKeyInfo_.begin(), sortKeyInfo_.end());
 
+  // Store (partition keys + sort keys) columns in the row container first,
+  // followed by the other input columns as dependents. A key channel which
+  // appears more than once is stored in one column for each appearance.
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<TypePtr> types;
+  std::vector<std::string> names;
+  std::vector<bool> isKeyChannel(numInputColumns_, false);
+  dataColumns_.resize(numInputColumns_);
+  inputChannels_.reserve(numInputColumns_ + allKeyInfo_.size());
+  spillCompareFlags_.reserve(allKeyInfo_.size());
+  for (const auto& [channel, sortOrder] : allKeyInfo_) {
+    if (!isKeyChannel[channel]) {
+      isKeyChannel[channel] = true;
+      dataColumns_[channel] = inputChannels_.size();
+    }
+    inputChannels_.push_back(channel);
+    keyTypes.push_back(inputType->childAt(channel));
+    types.push_back(keyTypes.back());
+    names.push_back(inputType->nameOf(channel));
+    spillCompareFlags_.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+  }
+  for (column_index_t channel = 0; channel < inputType->size(); ++channel) {
+    if (isKeyChannel[channel]) {
+      continue;
+    }
+    dataColumns_[channel] = inputChannels_.size();
+    inputChannels_.push_back(channel);
+    dependentTypes.push_back(inputType->childAt(channel));
+    types.push_back(dependentTypes.back());
+    names.push_back(inputType->nameOf(channel));
+  }
+  data_ = std::make_unique<RowContainer>(
+      keyTypes,
+      dependentTypes,
+      pool(),
+      driverCtx->queryConfig().columnarRowContainerEnabled());
+  spillType_ = ROW(std::move(names), std::move(types));
+  partitionComparator_.emplace(makeComparator(partitionKeyInfo_));
+  sortComparator_.emplace(makeComparator(sortKeyInfo_));
+  allComparator_.emplace(makeComparator(allKeyInfo_));
+
   std::vector<exec::RowColumn> inputColumns;
   for (int i = 0; i < inputType->children().size(); i++) {
-    inputColumns.push_back(data_->columnAt(i));
+    inputColumns.push_back(data_->columnAt(dataColumns_[i]));
   }
   // The WindowPartition is structured over all the input columns data.
   // Individual functions access its input argument column values from it.
@@ -183,40 +231,256 @@ void Window::initRangeValuesMap() {
 }
 
 void Window::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   inputRows_.resize(input->size());
 
   for (auto col = 0; col < input->childrenSize(); ++col) {
     decodedInputVectors_[col].decode(*input->childAt(col), inputRows_);
   }
 
-  // Add all the rows into the RowContainer.
+  // Add all the rows into the RowContainer. Sorted input rows are kept in
+  // the input order.
+  const vector_size_t firstNewRow = sortedRows_.size();
   for (auto row = 0; row < input->size(); ++row) {
     char* newRow = data_->newRow();
 
-    for (auto col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedInputVectors_[col], row, newRow, col);
+    for (auto col = 0; col < inputChannels_.size(); ++col) {
+      data_->store(decodedInputVectors_[inputChannels_[col]], row, newRow, col);
+    }
+    if (inputsSorted_) {
+      sortedRows_.push_back(newRow);
     }
   }
   numRows_ += inputRows_.size();
+
+  if (inputsSorted_) {
+    updateStreamingPartitionStartRows(firstNewRow);
+    return;
+  }
+
+  if (spiller_ != nullptr) {
+    updateSpillStats();
+  }
+}
+
+void Window::updateStreamingPartitionStartRows(vector_size_t firstNewRow) {
+  if (partitionStartRows_.empty() && !sortedRows_.empty()) {
+    partitionStartRows_.push_back(0);
+  }
+  const vector_size_t numRows = sortedRows_.size();
+  for (auto i = std::max<vector_size_t>(firstNewRow, 1); i < numRows; ++i) {
+    if (partitionComparator_->compare(sortedRows_[i - 1], sortedRows_[i]) !=
+        0) {
+      partitionStartRows_.push_back(i);
+    }
+  }
+}
+
+void Window::eraseOutputRows() {
+  VELOX_CHECK_EQ(numProcessedRows_, partitionStartRows_.back());
+  data_->eraseRows(folly::Range(sortedRows_.data(), numProcessedRows_));
+  sortedRows_.erase(
+      sortedRows_.begin(), sortedRows_.begin() + numProcessedRows_);
+  numRows_ = sortedRows_.size();
+  numProcessedRows_ = 0;
+  // The remaining rows are the start of the partition that is still
+  // receiving input.
+  partitionStartRows_ = {0};
+  currentPartition_ = 0;
+}
+
+void Window::updateSpillStats() {
+  VELOX_CHECK_NOT_NULL(spiller_);
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  lockedStats->spillWriteTiming = spillStats.spillWriteTiming;
+  VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
+}
+
+void Window::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
+    return;
+  }
+
+  auto tracker = pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if ((spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) ||
+      tracker->highUsage()) {
+    const int64_t bytesToSpill =
+        currentUsage * spillConfig.spillableReservationGrowthPct / 100;
+    auto rowsToSpill = std::max<int64_t>(
+        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
+    spill(
+        std::max<int64_t>(0, numRows - rowsToSpill),
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+void Window::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK_NOT_NULL(pool()->getMemoryUsageTracker());
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kWindow,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        data_->keyTypes().size(),
+        spillCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.maxSpillWriteParallelism,
+        spillConfig.directIo,
+        spillConfig.tiers);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
+}
+
+bool Window::loadNextSpilledPartition() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  data_->clear();
+  sortedRows_.clear();
+
+  // The spilled rows are merged in (partition keys + sort keys) order. Copy
+  // the rows into 'data_' until the partition keys change. The first row of
+  // the next partition is left in 'spillMerge_' for the next call.
+  const auto numPartitionKeys = partitionKeyInfo_.size();
+  for (;;) {
+    auto* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      break;
+    }
+    if (!sortedRows_.empty()) {
+      bool samePartition = true;
+      for (auto i = 0; i < numPartitionKeys; ++i) {
+        if (partitionComparator_->compare(
+                i,
+                sortedRows_[0],
+                stream->decoded(i),
+                stream->currentIndex()) != 0) {
+          samePartition = false;
+          break;
+        }
+      }
+      if (!samePartition) {
+        break;
+      }
+    }
+
+    char* newRow = data_->newRow();
+    for (auto i = 0; i < inputChannels_.size(); ++i) {
+      data_->store(stream->decoded(i), stream->currentIndex(), newRow, i);
+    }
+    sortedRows_.push_back(newRow);
+    stream->pop();
+  }
+
+  if (sortedRows_.empty()) {
+    return false;
+  }
+
+  numRows_ = sortedRows_.size();
+  numProcessedRows_ = 0;
+  partitionStartRows_ = {0, numRows_};
+  currentPartition_ = 0;
+  return true;
 }
 
 inline bool Window::compareRowsWithKeys(
     const char* lhs,
     const char* rhs,
-    const std::vector<std::pair<column_index_t, core::SortOrder>>& keys) {
+    const RowComparator& comparator) {
   if (lhs == rhs) {
     return false;
   }
-  for (auto& key : keys) {
-    if (auto result = data_->compare(
-            lhs,
-            rhs,
-            key.first,
-            {key.second.isNullsFirst(), key.second.isAscending(), false})) {
-      return result < 0;
-    }
+  return comparator(lhs, rhs);
+}
+
+RowComparator Window::makeComparator(
+    const std::vector<std::pair<column_index_t, core::SortOrder>>& keys) {
+  std::vector<column_index_t> columns;
+  std::vector<CompareFlags> flags;
+  columns.reserve(keys.size());
+  flags.reserve(keys.size());
+  for (const auto& [channel, sortOrder] : keys) {
+    columns.push_back(dataColumns_[channel]);
+    flags.push_back({sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
   }
-  return false;
+  return RowComparator(data_.get(), columns, flags);
 }
 
 void Window::createPeerAndFrameBuffers() {
@@ -249,7 +513,7 @@ void Window::computePartitionStartRows() {
   // Randomly assuming that max 10000 partitions are in the data.
   partitionStartRows_.reserve(numRows_);
   auto partitionCompare = [&](const char* lhs, const char* rhs) -> bool {
-    return compareRowsWithKeys(lhs, rhs, partitionKeyInfo_);
+    return compareRowsWithKeys(lhs, rhs, *partitionComparator_);
   };
 
   // Using a sequential traversal to find changing partitions.
@@ -284,7 +548,7 @@ void Window::sortPartitions() {
         sortedRows_.begin(),
         sortedRows_.end(),
         [this](const char* leftRow, const char* rightRow) {
-          return compareRowsWithKeys(leftRow, rightRow, allKeyInfo_);
+          return compareRowsWithKeys(leftRow, rightRow, *allComparator_);
         });
   }
 
@@ -301,6 +565,28 @@ void Window::noMoreInput() {
     return;
   }
 
+  if (spiller_ != nullptr) {
+    // Size the output buffers before spilling the remaining rows as the row
+    // size estimate needs the rows in 'data_'.
+    createPeerAndFrameBuffers();
+
+    // Spill all the remaining rows and merge the spilled runs. The rows are
+    // read back one partition at a time in getOutput().
+    spiller_->spill(0, 0);
+    VELOX_CHECK(spiller_->finishSpill().empty());
+    spillMerge_ = spiller_->startMerge(0);
+    numRows_ = 0;
+    numProcessedRows_ = 0;
+    updateSpillStats();
+    return;
+  }
+
+  if (inputsSorted_) {
+    // The last partition has received all its rows.
+    partitionStartRows_.push_back(sortedRows_.size());
+    return;
+  }
+
   // At this point we have seen all the input rows. We can start
   // outputting rows now.
   // However, some preparation is needed. The rows should be
@@ -311,32 +597,150 @@ void Window::noMoreInput() {
 }
 
 void Window::computeRangeValuesMap() {
-  auto peerCompare = [&](const char* lhs, const char* rhs) -> bool {
-    return compareRowsWithKeys(lhs, rhs, sortKeyInfo_);
-  };
-  auto firstPartitionRow = partitionStartRows_[currentPartition_];
-  auto lastPartitionRow = partitionStartRows_[currentPartition_ + 1] - 1;
-  auto numRows = lastPartitionRow - firstPartitionRow + 1;
-  rangeValuesMap_.rangeValues->resize(numRows);
-  rangeValuesMap_.rowIndices.resize(numRows);
-
-  rangeValuesMap_.rowIndices[0] = 0;
-  int j = 1;
-  for (auto i = firstPartitionRow + 1; i <= lastPartitionRow; i++) {
-    // Here, we removed the below check code, in order to keep raw values.
-    // if (peerCompare(sortedRows_[i - 1], sortedRows_[i])) {
-    // The order by values are extracted from the Window partition which
-    // starts from row number 0 for the firstPartitionRow. So the index
-    // requires adjustment.
-    rangeValuesMap_.rowIndices[j++] = i - firstPartitionRow;
-    // }
-  }
-
-  // If sort key is desc then reverse the rowIndices so that the range values
-  // are guaranteed ascending for the further lookup logic.
-  auto valueIndexesRange = folly::Range(rangeValuesMap_.rowIndices.data(), j);
+  const auto numRows = windowPartition_->numRows();
+  auto& rangeValues = rangeValuesMap_.rangeValues;
+  rangeValues->resize(numRows);
   windowPartition_->extractColumn(
-      sortKeyInfo_[0].first, valueIndexesRange, 0, rangeValuesMap_.rangeValues);
+      sortKeyInfo_[0].first, 0, numRows, 0, rangeValues);
+
+  vector_size_t nonNullStart = 0;
+  vector_size_t nonNullEnd = numRows;
+  if (rangeValues->mayHaveNulls()) {
+    while (nonNullStart < numRows && rangeValues->isNullAt(nonNullStart)) {
+      ++nonNullStart;
+    }
+    while (nonNullEnd > nonNullStart && rangeValues->isNullAt(nonNullEnd - 1)) {
+      --nonNullEnd;
+    }
+  }
+  rangeValuesMap_.nonNullStart = nonNullStart;
+  rangeValuesMap_.nonNullEnd = nonNullEnd;
+}
+
+namespace {
+
+template <typename T>
+inline bool peerValuesEqual(T lhs, T rhs) {
+  if constexpr (std::is_floating_point_v<T>) {
+    // NaNs sort together as the largest values.
+    return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
+  } else {
+    return lhs == rhs;
+  }
+}
+
+// Sets newPeers[i] to 1 if the value at 'i' differs from the value at 'i -
+// 1'. A null differs from a non-null and equals another null.
+template <TypeKind Kind>
+void markNewPeers(
+    const BaseVector& vector,
+    vector_size_t numRows,
+    uint8_t* newPeers) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  const auto* flatValues = vector.as<FlatVector<T>>();
+  VELOX_CHECK_NOT_NULL(flatValues);
+  const auto& values = *flatValues;
+  const auto* rawValues = values.rawValues();
+  if (!values.mayHaveNulls()) {
+    for (auto i = 1; i < numRows; ++i) {
+      newPeers[i] |= !peerValuesEqual(rawValues[i - 1], rawValues[i]);
+    }
+    return;
+  }
+  const auto* rawNulls = values.rawNulls();
+  for (auto i = 1; i < numRows; ++i) {
+    const bool previousNull = bits::isBitNull(rawNulls, i - 1);
+    const bool null = bits::isBitNull(rawNulls, i);
+    newPeers[i] |= previousNull != null ||
+        (!null && !peerValuesEqual(rawValues[i - 1], rawValues[i]));
+  }
+}
+
+bool canMarkNewPeers(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+void Window::computePeerGroups() {
+  const auto numRows = windowPartition_->numRows();
+  newPeers_.assign(numRows, 0);
+  auto* newPeers = newPeers_.data();
+  if (numRows > 0) {
+    newPeers[0] = 1;
+  }
+
+  bool vectorized = true;
+  for (const auto& [channel, sortOrder] : sortKeyInfo_) {
+    vectorized &= canMarkNewPeers(outputType_->childAt(channel)->kind());
+  }
+  if (vectorized) {
+    sortKeyValues_.resize(sortKeyInfo_.size());
+    for (auto i = 0; i < sortKeyInfo_.size(); ++i) {
+      const auto channel = sortKeyInfo_[i].first;
+      VectorPtr values;
+      if (i == 0 && hasKRangeFrames_) {
+        // Extracted by computeRangeValuesMap().
+        values = rangeValuesMap_.rangeValues;
+      } else {
+        if (sortKeyValues_[i] == nullptr) {
+          sortKeyValues_[i] =
+              BaseVector::create(outputType_->childAt(channel), 0, pool());
+        }
+        values = sortKeyValues_[i];
+        values->resize(numRows);
+        windowPartition_->extractColumn(channel, 0, numRows, 0, values);
+      }
+      switch (values->typeKind()) {
+        case TypeKind::TINYINT:
+          markNewPeers<TypeKind::TINYINT>(*values, numRows, newPeers);
+          break;
+        case TypeKind::SMALLINT:
+          markNewPeers<TypeKind::SMALLINT>(*values, numRows, newPeers);
+          break;
+        case TypeKind::INTEGER:
+          markNewPeers<TypeKind::INTEGER>(*values, numRows, newPeers);
+          break;
+        case TypeKind::BIGINT:
+          markNewPeers<TypeKind::BIGINT>(*values, numRows, newPeers);
+          break;
+        case TypeKind::REAL:
+          markNewPeers<TypeKind::REAL>(*values, numRows, newPeers);
+          break;
+        case TypeKind::DOUBLE:
+          markNewPeers<TypeKind::DOUBLE>(*values, numRows, newPeers);
+          break;
+        default:
+          VELOX_UNREACHABLE();
+      }
+    }
+  } else {
+    const auto* partitionRows =
+        sortedRows_.data() + partitionStartRows_[currentPartition_];
+    for (auto i = 1; i < numRows; ++i) {
+      newPeers[i] = compareRowsWithKeys(
+          partitionRows[i - 1], partitionRows[i], *sortComparator_);
+    }
+  }
+
+  peerGroupStarts_.clear();
+  for (auto i = 0; i < numRows; ++i) {
+    if (newPeers[i]) {
+      peerGroupStarts_.push_back(i);
+    }
+  }
+  peerGroupStarts_.push_back(numRows);
+  peerGroup_ = 0;
 }
 
 void Window::callResetPartition(vector_size_t partitionNumber) {
@@ -353,6 +757,7 @@ void Window::callResetPartition(vector_size_t partitionNumber) {
   if (hasKRangeFrames_) {
     computeRangeValuesMap();
   }
+  computePeerGroups();
 }
 
 void Window::updateKRowsFrameBounds(
@@ -404,79 +809,26 @@ void Window::updateKRowsFrameBounds(
 namespace {
 
 template <typename T>
-vector_size_t findIndex(
-    const T value,
-    vector_size_t leftBound,
-    vector_size_t rightBound,
-    const FlatVectorPtr<T>& values,
-    bool findStart) {
-  vector_size_t originalRightBound = rightBound;
-  vector_size_t originalLeftBound = leftBound;
-  while (leftBound < rightBound) {
-    vector_size_t mid = round((leftBound + rightBound) / 2.0);
-    auto midValue = values->valueAt(mid);
-    if (value == midValue) {
-      return mid;
-    }
-
-    if (value < midValue) {
-      rightBound = mid - 1;
-    } else {
-      leftBound = mid + 1;
-    }
-  }
-
-  // The value is not found but leftBound == rightBound at this point.
-  // This could be a value which is the least number greater than
-  // or the largest number less than value.
-  // The semantics of this function are to always return the smallest larger
-  // value (or rightBound if end of range).
-  if (findStart) {
-    if (value <= values->valueAt(rightBound)) {
-      // return std::max(originalLeftBound, rightBound);
-      return rightBound;
-    }
-    return std::min(originalRightBound, rightBound + 1);
-  }
-  if (value < values->valueAt(rightBound)) {
-    return std::max(originalLeftBound, rightBound - 1);
-  }
-  // std::max(originalLeftBound, rightBound)?
-  return std::min(originalRightBound, rightBound);
+inline int64_t rangeValue(const T& value) {
+  return value;
 }
 
-} // namespace
-
-// TODO: unify into one function.
-template <typename T>
-inline vector_size_t Window::kRangeStartBoundSearch(
-    const T value,
-    vector_size_t leftBound,
-    vector_size_t rightBound,
-    const FlatVectorPtr<T>& valuesVector,
-    const vector_size_t* rawPeerStarts,
-    vector_size_t& indexFound) {
-  auto index = findIndex<T>(value, leftBound, rightBound, valuesVector, true);
-  indexFound = index;
-  // Since this is a kPreceding bound it includes the row at the index.
-  return rangeValuesMap_.rowIndices[rawPeerStarts[index]];
+template <>
+inline int64_t rangeValue(const Date& value) {
+  return value.days();
 }
 
-// TODO: lastRightBoundRow looks useless.
-template <typename T>
-vector_size_t Window::kRangeEndBoundSearch(
-    const T value,
-    vector_size_t leftBound,
-    vector_size_t rightBound,
-    vector_size_t lastRightBoundRow,
-    const FlatVectorPtr<T>& valuesVector,
-    const vector_size_t* rawPeerEnds,
-    vector_size_t& indexFound) {
-  auto index = findIndex<T>(value, leftBound, rightBound, valuesVector, false);
-  indexFound = index;
-  return rangeValuesMap_.rowIndices[rawPeerEnds[index]];
+inline int64_t addSaturated(int64_t value, int64_t offset) {
+  int64_t result;
+  if (__builtin_add_overflow(value, offset, &result)) {
+    return offset > 0 ? std::numeric_limits<int64_t>::max()
+                      : std::numeric_limits<int64_t>::min();
+  }
+  return result;
 }
 
+} // namespace
+
 template <TypeKind T>
 void Window::updateKRangeFrameBounds(
     bool isKPreceding,
@@ -487,98 +839,71 @@ void Window::updateKRangeFrameBounds(
     const vector_size_t* rawPeerStarts,
     const vector_size_t* rawPeerEnds) {
   using NativeType = typename TypeTraits<T>::NativeType;
-  // Extract the order by key column to calculate the range values for the frame
-  // boundaries.
-  std::shared_ptr<const Type> sortKeyType =
-      outputType_->childAt(sortKeyInfo_[0].first);
-  auto orderByValues = BaseVector::create(sortKeyType, numRows, pool());
-  windowPartition_->extractColumn(
-      sortKeyInfo_[0].first, partitionOffset_, numRows, 0, orderByValues);
-  auto* rangeValuesFlatVector = orderByValues->asFlatVector<NativeType>();
-  auto* rawRangeValues = rangeValuesFlatVector->mutableRawValues();
-
-  if (frameArg.index == kConstantChannel) {
-    auto constantOffset = frameArg.constant.value();
-    constantOffset = isKPreceding ? -constantOffset : constantOffset;
-    for (int i = 0; i < numRows; i++) {
-      rawRangeValues[i] = rangeValuesFlatVector->valueAt(i) + constantOffset;
-    }
-  } else {
+  // The order by values of the partition, extracted once per partition.
+  const auto* rawValues =
+      rangeValuesMap_.rangeValues->asFlatVector<NativeType>()->rawValues();
+  const auto nonNullStart = rangeValuesMap_.nonNullStart;
+  const auto nonNullEnd = rangeValuesMap_.nonNullEnd;
+
+  const int64_t* offsets = nullptr;
+  if (frameArg.index != kConstantChannel) {
     windowPartition_->extractColumn(
         frameArg.index, partitionOffset_, numRows, 0, frameArg.value);
-    auto offsets = frameArg.value->values()->as<int64_t>();
+    offsets = frameArg.value->values()->as<int64_t>();
     for (auto i = 0; i < numRows; i++) {
       VELOX_USER_CHECK(
           !frameArg.value->isNullAt(i), "k in frame bounds cannot be null");
       VELOX_USER_CHECK_GE(
           offsets[i], 1, "k in frame bounds must be at least 1");
     }
-
-    auto precedingFactor = isKPreceding ? -1 : 1;
-    for (auto i = 0; i < numRows; i++) {
-      rawRangeValues[i] = rangeValuesFlatVector->valueAt(i) +
-          vector_size_t(precedingFactor * offsets[i]);
-    }
   }
 
-  // Set the frame bounds from looking up the rangeValues index.
-  vector_size_t leftBound = 0;
-  vector_size_t rightBound = rangeValuesMap_.rowIndices.size() - 1;
-  auto lastPartitionRow = partitionStartRows_[currentPartition_ + 1] - 1;
-  auto rangeIndexValues = std::dynamic_pointer_cast<FlatVector<NativeType>>(
-      rangeValuesMap_.rangeValues);
-  vector_size_t indexFound;
-  if (isStartBound) {
-    vector_size_t dynamicLeftBound = leftBound;
-    vector_size_t dynamicRightBound = 0;
-    for (auto i = 0; i < numRows; i++) {
-      // Handle null.
-      // Different with duckDB result. May need to separate the handling for
-      // spark & presto.
-      if (rangeValuesFlatVector->mayHaveNulls() &&
-          rangeValuesFlatVector->isNullAt(i)) {
-        rawFrameBounds[i] = i;
-        continue;
+  // The preceding rows have smaller values if the order is ascending and
+  // larger values if it is descending.
+  const bool ascending = sortKeyInfo_[0].second.isAscending();
+  const int64_t sign = isKPreceding == ascending ? -1 : 1;
+  // A start bound is the first row at or past the target value in the sort
+  // order. An end bound is the last row before the first row past it.
+  auto isPast = [&](vector_size_t row, int64_t target) {
+    const auto value = rangeValue(rawValues[row]);
+    if (ascending) {
+      return isStartBound ? value >= target : value > target;
+    }
+    return isStartBound ? value <= target : value < target;
+  };
+  // Returns the first row in [low, high) that is past 'target', or 'high'.
+  auto search = [&](vector_size_t low, vector_size_t high, int64_t target) {
+    while (low < high) {
+      const auto mid = low + (high - low) / 2;
+      if (isPast(mid, target)) {
+        high = mid;
+      } else {
+        low = mid + 1;
       }
-      // It is supposed the index being found is always on the left of the
-      // current handling position if we only consider positive lower value
-      // offset (>= 1).
-      dynamicRightBound = i;
-      rawFrameBounds[i] = kRangeStartBoundSearch<NativeType>(
-          rawRangeValues[i],
-          dynamicLeftBound,
-          dynamicRightBound,
-          rangeIndexValues,
-          rawPeerStarts,
-          indexFound);
-      dynamicLeftBound = indexFound;
     }
-  } else {
-    vector_size_t dynamicRightBound = rightBound;
-    vector_size_t dynamicLeftBound = 0;
-    for (auto i = 0; i < numRows; i++) {
-      // Handle null.
-      // Different with duckDB result. May need to separate the handling for
-      // spark & presto.
-      if (rangeValuesFlatVector->mayHaveNulls() &&
-          rangeValuesFlatVector->isNullAt(i)) {
-        rawFrameBounds[i] = i;
-        continue;
+    return low;
+  };
+
+  // With a constant offset the target values are in sort order like the
+  // rows, so that the bounds are found by one sweep after the first search.
+  std::optional<vector_size_t> bound;
+  for (auto i = 0; i < numRows; i++) {
+    const auto row = partitionOffset_ + i;
+    if (row < nonNullStart || row >= nonNullEnd) {
+      // The frame of a row with a null order by value is its peer group.
+      rawFrameBounds[i] = isStartBound ? rawPeerStarts[i] : rawPeerEnds[i];
+      continue;
+    }
+    const int64_t offset = offsets ? offsets[i] : frameArg.constant.value();
+    const auto target = addSaturated(rangeValue(rawValues[row]), sign * offset);
+    if (offsets || !bound.has_value()) {
+      bound = search(nonNullStart, nonNullEnd, target);
+    } else {
+      while (*bound < nonNullEnd && !isPast(*bound, target)) {
+        ++*bound;
       }
-      // It is supposed the index being found is always on the right of the
-      // current handling position if we only consider positive higher value
-      // offset (>= 1).
-      dynamicLeftBound = i;
-      rawFrameBounds[i] = kRangeEndBoundSearch<NativeType>(
-          rawRangeValues[i],
-          dynamicLeftBound,
-          dynamicRightBound,
-          lastPartitionRow,
-          rangeIndexValues,
-          rawPeerEnds,
-          indexFound);
-      dynamicRightBound = rightBound;
     }
+    rawFrameBounds[i] = isStartBound ? *bound : *bound - 1;
   }
 }
 
@@ -764,38 +1089,17 @@ void Window::callApplyForPartitionRows(
     rawFrameEnds.push_back(rawFrameEnd);
   }
 
-  auto peerCompare = [&](const char* lhs, const char* rhs) -> bool {
-    return compareRowsWithKeys(lhs, rhs, sortKeyInfo_);
-  };
   auto firstPartitionRow = partitionStartRows_[currentPartition_];
   auto lastPartitionRow = partitionStartRows_[currentPartition_ + 1] - 1;
-  for (auto i = startRow, j = 0; i < endRow; i++, j++) {
-    // When traversing input partition rows, the peers are the rows
-    // with the same values for the ORDER BY clause. These rows
-    // are equal in some ways and affect the results of ranking functions.
-    // This logic exploits the fact that all rows between the peerStartRow_
-    // and peerEndRow_ have the same values for peerStartRow_ and peerEndRow_.
-    // So we can compute them just once and reuse across the rows in that peer
-    // interval. Note: peerStartRow_ and peerEndRow_ can be maintained across
-    // getOutput calls.
-
-    // Compute peerStart and peerEnd rows for the first row of the partition or
-    // when past the previous peerGroup.
-    if (i == firstPartitionRow || i >= peerEndRow_) {
-      peerStartRow_ = i;
-      peerEndRow_ = i;
-      while (peerEndRow_ <= lastPartitionRow) {
-        if (peerCompare(sortedRows_[peerStartRow_], sortedRows_[peerEndRow_])) {
-          break;
-        }
-        peerEndRow_++;
-      }
+  // Peer buffer values should be offsets from the start of the partition
+  // as WindowFunction only sees one partition at a time.
+  for (auto i = 0; i < numRows; i++) {
+    const auto row = startRow - firstPartitionRow + i;
+    while (peerGroupStarts_[peerGroup_ + 1] <= row) {
+      ++peerGroup_;
     }
-
-    // Peer buffer values should be offsets from the start of the partition
-    // as WindowFunction only sees one partition at a time.
-    rawPeerStarts[j] = peerStartRow_ - firstPartitionRow;
-    rawPeerEnds[j] = peerEndRow_ - 1 - firstPartitionRow;
+    rawPeerStarts[i] = peerGroupStarts_[peerGroup_];
+    rawPeerEnds[i] = peerGroupStarts_[peerGroup_ + 1] - 1;
   }
 
   for (auto i = 0; i < numFuncs; i++) {
@@ -891,11 +1195,25 @@ void Window::callApplyLoop(
 }
 
 RowVectorPtr Window::getOutput() {
-  if (finished_ || !noMoreInput_) {
+  if (finished_ || (!noMoreInput_ && !hasCompletePartitions())) {
     return nullptr;
   }
 
-  auto numRowsLeft = numRows_ - numProcessedRows_;
+  if (spillMerge_ != nullptr && numProcessedRows_ == numRows_) {
+    if (!loadNextSpilledPartition()) {
+      finished_ = true;
+      return nullptr;
+    }
+  }
+
+  // Sorted input is output up to the end of the last complete partition.
+  auto numRowsLeft = inputsSorted_
+      ? partitionStartRows_.back() - numProcessedRows_
+      : numRows_ - numProcessedRows_;
+  if (inputsSorted_ && peerStartBuffer_ == nullptr) {
+    // The output buffers are sized by the rows of the first partition.
+    createPeerAndFrameBuffers();
+  }
   auto numOutputRows = std::min(numRowsPerOutput_, numRowsLeft);
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
@@ -905,7 +1223,7 @@ RowVectorPtr Window::getOutput() {
     data_->extractColumn(
         sortedRows_.data() + numProcessedRows_,
         numOutputRows,
-        i,
+        dataColumns_[i],
         result->childAt(i));
   }
 
@@ -925,7 +1243,14 @@ RowVectorPtr Window::getOutput() {
     result->childAt(j) = windowOutputs[j - numInputColumns_];
   }
 
-  finished_ = (numProcessedRows_ == sortedRows_.size());
+  // In spill mode, the next partition is loaded from 'spillMerge_' in the next
+  // getOutput() call.
+  if (inputsSorted_ && !noMoreInput_ && !hasCompletePartitions()) {
+    eraseOutputRows();
+  }
+
+  finished_ =
+      (spillMerge_ == nullptr && numProcessedRows_ == sortedRows_.size());
   return result;
 }
 
@@ -16,7 +16,9 @@
 #pragma once
 
 #include "velox/exec/Operator.h"
+#include "velox/exec/RowComparator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/exec/WindowPartition.h"
 
@@ -34,6 +36,17 @@ namespace facebook::velox::exec {
 ///
 /// We will revise this algorithm in the future using a HashTable based
 /// approach pending some profiling results.
+///
+/// If spilling is enabled and the window has partition keys, the buffered
+/// input rows are sorted by (partition_by keys + order_by keys) and spilled in
+/// sorted runs when the memory usage grows too large. After all the input is
+/// received, the spilled runs are merged and read back one partition at a
+/// time, so the memory usage is bounded by the largest partition.
+///
+/// If the WindowNode specifies that the input is sorted, the rows are not
+/// sorted and the operator does not wait for all the input. A partition is
+/// output as soon as the first row of the next partition arrives. Only the
+/// rows of the partitions that are not output yet are kept in memory.
 class Window : public Operator {
  public:
   Window(
@@ -46,7 +59,7 @@ class Window : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_;
+    return !noMoreInput_ && !hasCompletePartitions();
   }
 
   void noMoreInput() override;
@@ -93,6 +106,40 @@ class Window : public Operator {
   // row indices to send in window function apply invocations.
   void createPeerAndFrameBuffers();
 
+  // Returns true if the input is sorted and there are rows of partitions
+  // which have received all their rows that are not output yet.
+  bool hasCompletePartitions() const {
+    return inputsSorted_ && !partitionStartRows_.empty() &&
+        numProcessedRows_ < partitionStartRows_.back();
+  }
+
+  // Used when the input is sorted. Adds the start of each partition in
+  // sortedRows_[firstNewRow...] to 'partitionStartRows_'. The last entry of
+  // 'partitionStartRows_' is the start of the partition that may receive more
+  // rows.
+  void updateStreamingPartitionStartRows(vector_size_t firstNewRow);
+
+  // Used when the input is sorted. Erases the rows which have been output
+  // from 'data_' and 'sortedRows_' after all the complete partitions are
+  // output.
+  void eraseOutputRows();
+
+  // Checks if the spilling is enabled and if the input fits in the existing
+  // reservation. Spills enough rows from 'data_' if not.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills content until under 'targetRows' and under 'targetBytes' of out of
+  // line data are left. If 'targetRows' is 0, spills everything.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  // Copies the spiller stats into the operator stats.
+  void updateSpillStats();
+
+  // Reads the rows of the next partition from 'spillMerge_' into 'data_' and
+  // resets the partition state to process it. Returns false if all the
+  // spilled partitions have been read.
+  bool loadNextSpilledPartition();
+
   // Function to compute the partitionStartRows_ structure.
   // partitionStartRows_ is vector of the starting rows index
   // of each partition in the data. This is an auxiliary
@@ -118,6 +165,12 @@ class Window : public Operator {
   // each partition of rows.
   void computeRangeValuesMap();
 
+  // Computes 'peerGroupStarts_' for the current partition. The sort keys are
+  // extracted once for the partition and the adjacent values are compared in
+  // a loop per key if the keys are of fixed width types. Otherwise the
+  // adjacent rows are compared with 'sortComparator_'.
+  void computePeerGroups();
+
   // Helper method to call WindowFunction::apply to all the rows
   // of a partition between startRow and endRow. The outputs
   // will be written to the vectors in windowFunctionOutputs
@@ -129,11 +182,15 @@ class Window : public Operator {
       vector_size_t resultOffset);
 
   // Helper function to compare the rows at lhs and rhs pointers
-  // using the keyInfo in keys. This can be used to compare the
-  // rows for partitionKeys, orderByKeys or a combination of both.
+  // using 'comparator'. This can be used to compare the rows for
+  // partitionKeys, orderByKeys or a combination of both.
   inline bool compareRowsWithKeys(
       const char* lhs,
       const char* rhs,
+      const RowComparator& comparator);
+
+  // Makes a comparator of the 'data_' columns of 'keys'.
+  RowComparator makeComparator(
       const std::vector<std::pair<column_index_t, core::SortOrder>>& keys);
 
   // Function to compute window function values for the current output
@@ -176,33 +233,49 @@ class Window : public Operator {
       const vector_size_t* rawPeerEnds,
       vector_size_t* rawFrameBounds);
 
-  template <typename T>
-  vector_size_t kRangeStartBoundSearch(
-      const T value,
-      vector_size_t leftBound,
-      vector_size_t rightBound,
-      const FlatVectorPtr<T>& valuesVector,
-      const vector_size_t* rawPeerStarts,
-      vector_size_t& indexFound);
-
-  template <typename T>
-  vector_size_t kRangeEndBoundSearch(
-      const T value,
-      vector_size_t leftBound,
-      vector_size_t rightBound,
-      vector_size_t lastRightBoundRow,
-      const FlatVectorPtr<T>& valuesVector,
-      const vector_size_t* rawPeerEnds,
-      vector_size_t& indexFound);
-
   bool finished_ = false;
   const vector_size_t numInputColumns_;
 
+  // True if the input is clustered on the partition keys and sorted on the
+  // sort keys. The partitions are then output as the input arrives.
+  const bool inputsSorted_;
+
+  // The max memory that the window can hold before spilling.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
   // The Window operator needs to see all the input rows before starting
   // any function computation. As the Window operators gets input rows
   // we store the rows in the RowContainer (data_).
+  // The partition and sort keys are stored first as the key columns, followed
+  // by the rest of the input columns as dependents. This enables the spilled
+  // rows to be sorted and merged by the key columns.
   std::unique_ptr<RowContainer> data_;
 
+  // The input channel stored in each column of 'data_'.
+  std::vector<column_index_t> inputChannels_;
+
+  // The column of 'data_' that stores each input channel.
+  std::vector<column_index_t> dataColumns_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr spillType_;
+
+  // The compare flags of the key columns of 'data_' used for spilling.
+  std::vector<CompareFlags> spillCompareFlags_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back the spilled rows partition by partition if disk spilling
+  // has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
   // The decodedInputVectors_ are reused across addInput() calls to decode
   // the partition and sort keys for the above RowContainer.
   std::vector<DecodedVector> decodedInputVectors_;
@@ -224,6 +297,12 @@ class Window : public Operator {
   std::vector<std::pair<column_index_t, core::SortOrder>> sortKeyInfo_;
   std::vector<std::pair<column_index_t, core::SortOrder>> allKeyInfo_;
 
+  // Compare the rows of 'data_' on the keys of partitionKeyInfo_,
+  // sortKeyInfo_ and allKeyInfo_ respectively.
+  std::optional<RowComparator> partitionComparator_;
+  std::optional<RowComparator> sortComparator_;
+  std::optional<RowComparator> allComparator_;
+
   // Vector of WindowFunction objects required by this operator.
   // WindowFunction is the base API implemented by all the window functions.
   // The functions are ordered by their positions in the output columns.
@@ -234,7 +313,9 @@ class Window : public Operator {
 
   // This SelectivityVector is used across addInput calls for decoding.
   SelectivityVector inputRows_;
-  // Number of input rows.
+  // Number of input rows. If spilling has been triggered, this is the number
+  // of rows of the partition read back from 'spillMerge_'. If the input is
+  // sorted, this is the number of rows in 'data_'.
   vector_size_t numRows_ = 0;
 
   // Vector of pointers to each input row in the data_ RowContainer.
@@ -281,20 +362,17 @@ class Window : public Operator {
   std::vector<SelectivityVector> validFrames_;
 
   // When computing k Range frames, the range value for the frame index needs
-  // to be mapped to the partition row for the value.
-  // This is an auxiliary structure to materialize a mapping from
-  // range value -> row index (in RowContainer) for that purpose.
-  // It uses a vector of the ordered range values and another vector of the
-  // corresponding row indices. Ideally a binary search
-  // tree or B-tree index (especially if the data is spilled to disk) should be
-  // used.
+  // to be mapped to the partition row for the value. The order by column of
+  // the partition is extracted once per partition and the frame bounds are
+  // found by a sweep over it for constant offsets or by binary search.
   struct RangeValuesMap {
     TypePtr rangeType;
-    // The range values appear in sorted order in this vector.
+    // The order by values of the partition rows in sort order.
     VectorPtr rangeValues;
-    // TODO (Make this a BufferPtr so that it can be allocated in the
-    // MemoryPool) ?
-    std::vector<vector_size_t> rowIndices;
+    // The rows with non-null values, which are contiguous since the nulls
+    // sort first or last.
+    vector_size_t nonNullStart{0};
+    vector_size_t nonNullEnd{0};
   };
   RangeValuesMap rangeValuesMap_;
 
@@ -311,15 +389,21 @@ class Window : public Operator {
   // be tracked in the operator.
   vector_size_t currentPartition_;
 
-  // When traversing input partition rows, the peers are the rows
-  // with the same values for the ORDER BY clause. These rows
-  // are equal in some ways and affect the results of ranking functions.
-  // Since all rows between the peerStartRow_ and peerEndRow_ have the same
-  // values for peerStartRow_ and peerEndRow_, we needn't compute
-  // them for each row independently. Since these rows might
-  // cross getOutput boundaries they are saved in the operator.
-  vector_size_t peerStartRow_ = 0;
-  vector_size_t peerEndRow_ = 0;
+  // The peers are the rows of a partition with the same values for the
+  // ORDER BY clause. These rows are equal in some ways and affect the results
+  // of ranking functions. The first row of each peer group of the current
+  // partition relative to the partition start, followed by the number of rows
+  // of the partition. Computed once per partition and shared by all the
+  // functions.
+  std::vector<vector_size_t> peerGroupStarts_;
+  // The index in 'peerGroupStarts_' of the peer group of the next row to
+  // output. The partition may be output across getOutput calls.
+  vector_size_t peerGroup_ = 0;
+  // 1 for each row of the current partition that starts a peer group. Kept
+  // to reuse its memory.
+  std::vector<uint8_t> newPeers_;
+  // The sort keys of the current partition. Kept to reuse their memory.
+  std::vector<VectorPtr> sortKeyValues_;
 
   // Tracks how far along the partition rows have been output.
   vector_size_t partitionOffset_ = 0;
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_int32(num_batches, 20, "Batches produced by each driver");
+DEFINE_int32(num_groups, 200'000, "Number of distinct grouping keys");
+
+/// Measures the throughput of GROUP BY with a varying number of drivers. Each
+/// driver runs a partial aggregation over the same input. The intermediate
+/// results are either gathered into a single driver running the final
+/// aggregation or hash partitioned on the grouping keys between as many
+/// drivers as the partial aggregation has, which merge disjoint groups.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+namespace {
+
+constexpr vector_size_t kBatchSize = 10'000;
+
+class AggregationBenchmark : public VectorTestBase {
+ public:
+  AggregationBenchmark() {
+    for (auto i = 0; i < FLAGS_num_batches; ++i) {
+      data_.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              kBatchSize,
+              [&](auto row) {
+                return (i * kBatchSize + row) * 7'919L % FLAGS_num_groups;
+              }),
+          makeFlatVector<int64_t>(kBatchSize, [](auto row) { return row; }),
+      }));
+    }
+  }
+
+  void run(int numDrivers, bool partitioned) {
+    folly::BenchmarkSuspender suspender;
+    PlanBuilder builder;
+    builder.values(data_, true).partialAggregation(
+        {"c0"}, {"sum(c1)", "count(1)"});
+    if (partitioned) {
+      builder.localPartitionedFinalAggregation();
+    } else {
+      builder.localPartition({}).finalAggregation();
+    }
+    auto plan = builder.planNode();
+    suspender.dismiss();
+
+    auto result =
+        AssertQueryBuilder(plan).maxDrivers(numDrivers).copyResults(pool());
+    folly::doNotOptimizeAway(result->size());
+  }
+
+ private:
+  std::vector<RowVectorPtr> data_;
+};
+
+std::unique_ptr<AggregationBenchmark> benchmark;
+
+void gatheredFinalAggregation(uint32_t iterations, int numDrivers) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run(numDrivers, false);
+  }
+}
+
+void partitionedFinalAggregation(uint32_t iterations, int numDrivers) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run(numDrivers, true);
+  }
+}
+
+BENCHMARK_PARAM(gatheredFinalAggregation, 1);
+BENCHMARK_RELATIVE_PARAM(partitionedFinalAggregation, 1);
+BENCHMARK_PARAM(gatheredFinalAggregation, 4);
+BENCHMARK_RELATIVE_PARAM(partitionedFinalAggregation, 4);
+BENCHMARK_PARAM(gatheredFinalAggregation, 8);
+BENCHMARK_RELATIVE_PARAM(partitionedFinalAggregation, 8);
+BENCHMARK_PARAM(gatheredFinalAggregation, 16);
+BENCHMARK_RELATIVE_PARAM(partitionedFinalAggregation, 16);
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  aggregate::prestosql::registerAllAggregateFunctions();
+  parse::registerTypeResolver();
+  benchmark = std::make_unique<AggregationBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <numeric>
+
+#include "velox/exec/HashTable.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+DECLARE_bool(velox_hash_table_batched_probe);
+
+namespace {
+constexpr int32_t kBatchSize = 1024;
+
+// Compares building and probing a large hash join table in kHash mode with and
+// without radix partitioning and with and without batched probes. The keys are
+// random so that the table accesses have no cache locality.
+class HashJoinBenchmark {
+ public:
+  explicit HashJoinBenchmark(int64_t numRows) {
+    folly::Random::DefaultGenerator rng(1);
+    for (auto i = 0; i < numRows; i += kBatchSize) {
+      batches_.push_back(vectorMaker_.flatVector<int64_t>(
+          std::min<int64_t>(kBatchSize, numRows - i),
+          [&](auto /*row*/) { return folly::Random::rand64(rng); }));
+    }
+  }
+
+  // Makes a join table with all the rows but doesn't build the hash table.
+  std::unique_ptr<BaseHashTable> makeTable() {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    hashers.push_back(std::make_unique<VectorHasher>(BIGINT(), 0));
+    auto table = HashTable<true>::createForJoin(
+        std::move(hashers), {}, true, false, pool_.get());
+    raw_vector<uint64_t> dummy(kBatchSize);
+    for (const auto& batch : batches_) {
+      SelectivityVector rows(batch->size());
+      DecodedVector decoded(*batch, rows);
+      auto& hasher = table->hashers()[0];
+      hasher->decode(*batch, rows);
+      if (hasher->mayUseValueIds()) {
+        hasher->computeValueIds(rows, dummy);
+      }
+      for (auto row = 0; row < batch->size(); ++row) {
+        table->rows()->store(decoded, row, table->rows()->newRow(), 0);
+      }
+    }
+    return table;
+  }
+
+  // Builds the join table with 'radixPartitionBits'.
+  void build(uint8_t radixPartitionBits) {
+    folly::BenchmarkSuspender suspender;
+    auto table = makeTable();
+    suspender.dismiss();
+
+    table->setRadixPartitionBits(radixPartitionBits);
+    table->prepareJoinTable({});
+    folly::doNotOptimizeAway(table->stats().capacity);
+  }
+
+  // Probes the join table built with 'radixPartitionBits' with all the build
+  // keys. 'batched' specifies if the rows are probed in batches with the tag
+  // words prefetched.
+  void probe(uint8_t radixPartitionBits, bool batched = true) {
+    folly::BenchmarkSuspender suspender;
+    gflags::FlagSaver flagSaver;
+    FLAGS_velox_hash_table_batched_probe = batched;
+    auto table = makeTable();
+    table->setRadixPartitionBits(radixPartitionBits);
+    table->prepareJoinTable({});
+    VELOX_CHECK_EQ(table->hashMode(), BaseHashTable::HashMode::kHash);
+    HashLookup lookup(table->hashers());
+    suspender.dismiss();
+
+    int64_t numHits{0};
+    for (const auto& batch : batches_) {
+      SelectivityVector rows(batch->size());
+      lookup.reset(batch->size());
+      auto& hasher = table->hashers()[0];
+      hasher->decode(*batch, rows);
+      hasher->hash(rows, false, lookup.hashes);
+      lookup.rows.resize(batch->size());
+      std::iota(lookup.rows.begin(), lookup.rows.end(), 0);
+      table->joinProbe(lookup);
+      for (auto row : lookup.rows) {
+        numHits += lookup.hits[row] != nullptr;
+      }
+    }
+    folly::doNotOptimizeAway(numHits);
+  }
+
+ private:
+  std::shared_ptr<memory::MemoryPool> pool_{memory::addDefaultLeafMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::vector<VectorPtr> batches_;
+};
+
+std::unique_ptr<HashJoinBenchmark> benchmark;
+} // namespace
+
+BENCHMARK(build) {
+  benchmark->build(0);
+}
+
+BENCHMARK_RELATIVE(buildRadix4) {
+  benchmark->build(4);
+}
+
+BENCHMARK_RELATIVE(buildRadix6) {
+  benchmark->build(6);
+}
+
+BENCHMARK(probeUnbatched) {
+  benchmark->probe(0, false);
+}
+
+BENCHMARK_RELATIVE(probe) {
+  benchmark->probe(0);
+}
+
+BENCHMARK_RELATIVE(probeRadix4) {
+  benchmark->probe(4);
+}
+
+BENCHMARK_RELATIVE(probeRadix6) {
+  benchmark->probe(6);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  // Builds a table with 8M entries which is much larger than the L3 cache.
+  benchmark = std::make_unique<HashJoinBenchmark>(8 << 20);
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/LocalPartition.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_int32(batches_per_driver, 10'000, "Batches enqueued by each producer");
+DEFINE_int64(
+    max_buffer_size,
+    32 << 20,
+    "Limit on the bytes buffered in all local exchange queues");
+
+/// Measures the throughput of local exchange queues with a varying number of
+/// drivers. There is one queue and one consumer thread per driver. Each
+/// producer thread enqueues small batches to all queues round robin, as
+/// LocalPartition does after hash partitioning.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+class LocalExchangeBenchmark : public VectorTestBase {
+ public:
+  void run(int numDrivers) {
+    folly::BenchmarkSuspender suspender;
+    auto data = makeRowVector(
+        {makeFlatVector<int64_t>(100, [](auto row) { return row; })});
+    auto memoryManager =
+        std::make_shared<LocalExchangeMemoryManager>(FLAGS_max_buffer_size);
+    std::vector<std::shared_ptr<LocalExchangeQueue>> queues;
+    for (auto i = 0; i < numDrivers; ++i) {
+      queues.push_back(std::make_shared<LocalExchangeQueue>(memoryManager, i));
+      for (auto j = 0; j < numDrivers; ++j) {
+        queues.back()->addProducer();
+      }
+      queues.back()->noMoreProducers();
+    }
+    suspender.dismiss();
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < numDrivers; ++i) {
+      threads.emplace_back([&, i]() {
+        for (auto j = 0; j < FLAGS_batches_per_driver; ++j) {
+          ContinueFuture future;
+          auto& queue = queues[(i + j) % numDrivers];
+          if (queue->enqueue(data, &future) != BlockingReason::kNotBlocked) {
+            future.wait();
+          }
+        }
+        for (auto& queue : queues) {
+          queue->noMoreData();
+        }
+      });
+      threads.emplace_back([&, i]() {
+        for (;;) {
+          ContinueFuture future;
+          RowVectorPtr batch;
+          if (queues[i]->next(&future, pool(), &batch) !=
+              BlockingReason::kNotBlocked) {
+            future.wait();
+          } else if (batch == nullptr) {
+            break;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+};
+
+std::unique_ptr<LocalExchangeBenchmark> benchmark;
+
+void localExchange(uint32_t iterations, int numDrivers) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run(numDrivers);
+  }
+}
+
+BENCHMARK_PARAM(localExchange, 1);
+BENCHMARK_PARAM(localExchange, 4);
+BENCHMARK_PARAM(localExchange, 16);
+BENCHMARK_PARAM(localExchange, 32);
+BENCHMARK_PARAM(localExchange, 64);
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<LocalExchangeBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
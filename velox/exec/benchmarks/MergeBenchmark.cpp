@@ -37,6 +37,14 @@ BENCHMARK_RELATIVE(narrowArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(narrow, false);
 }
 
+BENCHMARK_RELATIVE(narrowPrefixTree) {
+  MergeTestBase::test<PrefixTreeOfLosers<TestingStream>>(narrow, false);
+}
+
+BENCHMARK_RELATIVE(narrowPrefixTreeRuns) {
+  MergeTestBase::testRuns<PrefixTreeOfLosers<TestingStream>>(narrow, false);
+}
+
 BENCHMARK(mediumTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(medium, false);
 }
@@ -45,6 +53,14 @@ BENCHMARK_RELATIVE(mediumArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(medium, false);
 }
 
+BENCHMARK_RELATIVE(mediumPrefixTree) {
+  MergeTestBase::test<PrefixTreeOfLosers<TestingStream>>(medium, false);
+}
+
+BENCHMARK_RELATIVE(mediumPrefixTreeRuns) {
+  MergeTestBase::testRuns<PrefixTreeOfLosers<TestingStream>>(medium, false);
+}
+
 BENCHMARK(wideTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(wide, false);
 }
@@ -53,6 +69,14 @@ BENCHMARK_RELATIVE(wideArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(wide, false);
 }
 
+BENCHMARK_RELATIVE(widePrefixTree) {
+  MergeTestBase::test<PrefixTreeOfLosers<TestingStream>>(wide, false);
+}
+
+BENCHMARK_RELATIVE(widePrefixTreeRuns) {
+  MergeTestBase::testRuns<PrefixTreeOfLosers<TestingStream>>(wide, false);
+}
+
 int main(int argc, char* argv[]) {
   folly::init(&argc, &argv);
   gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_int32(num_destinations, 500, "Number of destinations of the shuffle");
+DEFINE_int32(batch_size, 10'000, "Number of rows in an input batch");
+
+/// Compares serializing the rows of a batch for each destination with
+/// VectorSerializer::append() against scattering the batch to all
+/// destinations in one pass with VectorSerde::scatter(). This is the work
+/// PartitionedOutput does for each input batch before flushing pages.
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+namespace {
+
+class PartitionedOutputBenchmark : public VectorTestBase {
+ public:
+  void setUp(RowTypePtr type) {
+    type_ = std::move(type);
+    input_ = std::dynamic_pointer_cast<RowVector>(
+        BatchMaker::createBatch(type_, FLAGS_batch_size, *pool_));
+    partitions_.resize(FLAGS_batch_size);
+    for (auto i = 0; i < FLAGS_batch_size; ++i) {
+      partitions_[i] = folly::Random::rand32(FLAGS_num_destinations);
+    }
+    rows_.assign(FLAGS_num_destinations, {});
+    for (auto i = 0; i < FLAGS_batch_size; ++i) {
+      rows_[partitions_[i]].push_back(IndexRange{i, 1});
+    }
+  }
+
+  // Appends the rows of each destination separately.
+  int64_t runAppend() {
+    StreamArena arena(pool_.get());
+    auto serializers = makeSerializers(arena);
+    for (auto i = 0; i < serializers.size(); ++i) {
+      serializers[i]->append(
+          input_, folly::Range(rows_[i].data(), rows_[i].size()));
+    }
+    return flush(serializers);
+  }
+
+  // Scatters the rows to all destinations in one pass.
+  int64_t runScatter() {
+    StreamArena arena(pool_.get());
+    auto serializers = makeSerializers(arena);
+    std::vector<VectorSerializer*> rawSerializers;
+    for (auto& serializer : serializers) {
+      rawSerializers.push_back(serializer.get());
+    }
+    serde_.scatter(
+        input_,
+        partitions_.data(),
+        folly::Range(rawSerializers.data(), rawSerializers.size()));
+    return flush(serializers);
+  }
+
+ private:
+  std::vector<std::unique_ptr<VectorSerializer>> makeSerializers(
+      StreamArena& arena) {
+    std::vector<std::unique_ptr<VectorSerializer>> serializers;
+    for (auto i = 0; i < FLAGS_num_destinations; ++i) {
+      serializers.push_back(serde_.createSerializer(
+          type_, rows_[i].size(), &arena, nullptr));
+    }
+    return serializers;
+  }
+
+  int64_t flush(std::vector<std::unique_ptr<VectorSerializer>>& serializers) {
+    int64_t bytes = 0;
+    for (auto& serializer : serializers) {
+      IOBufOutputStream out(*pool_);
+      serializer->flush(&out);
+      bytes += out.tellp();
+    }
+    return bytes;
+  }
+
+  serializer::presto::PrestoVectorSerde serde_;
+  RowTypePtr type_;
+  RowVectorPtr input_;
+  std::vector<uint32_t> partitions_;
+  std::vector<std::vector<IndexRange>> rows_;
+};
+
+PartitionedOutputBenchmark flatBm;
+PartitionedOutputBenchmark stringBm;
+
+BENCHMARK(appendFlat) {
+  folly::doNotOptimizeAway(flatBm.runAppend());
+}
+
+BENCHMARK_RELATIVE(scatterFlat) {
+  folly::doNotOptimizeAway(flatBm.runScatter());
+}
+
+BENCHMARK(appendString) {
+  folly::doNotOptimizeAway(stringBm.runAppend());
+}
+
+BENCHMARK_RELATIVE(scatterString) {
+  folly::doNotOptimizeAway(stringBm.runScatter());
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  flatBm.setUp(
+      ROW({"c0", "c1", "c2", "c3", "c4", "c5"},
+          {BIGINT(), BIGINT(), INTEGER(), SMALLINT(), DOUBLE(), REAL()}));
+  stringBm.setUp(ROW({"c0", "c1", "c2"}, {BIGINT(), VARCHAR(), VARCHAR()}));
+  folly::runBenchmarks();
+  return 0;
+}
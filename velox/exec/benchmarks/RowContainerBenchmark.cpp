@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <random>
+
+#include "velox/exec/RowContainer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_int32(num_rows, 1'000'000, "Rows in each RowContainer");
+
+/// Compares extracting the columns of a RowContainer with the row-wise and
+/// the columnar layouts, see RowContainer::isColumnar(). The rows are
+/// extracted in container order, as for spilling, and in a random order, as
+/// for the output of an OrderBy.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+class RowContainerBenchmark : public VectorTestBase {
+ public:
+  RowContainerBenchmark() {
+    std::vector<VectorPtr> columns;
+    for (auto i = 0; i < 8; ++i) {
+      columns.push_back(makeFlatVector<int64_t>(
+          FLAGS_num_rows, [i](auto row) { return row * (i + 1); }));
+    }
+    data_ = makeRowVector(columns);
+    for (auto columnar : {false, true}) {
+      auto& container = columnar ? columnar_ : rowWise_;
+      auto& rows = columnar ? columnarRows_ : rowWiseRows_;
+      container = std::make_unique<RowContainer>(
+          std::vector<TypePtr>{BIGINT()},
+          std::vector<TypePtr>(columns.size() - 1, BIGINT()),
+          pool(),
+          columnar);
+      VELOX_CHECK_EQ(columnar, container->isColumnar());
+      for (auto i = 0; i < FLAGS_num_rows; ++i) {
+        rows.push_back(container->newRow());
+      }
+      SelectivityVector allRows(FLAGS_num_rows);
+      for (auto column = 0; column < columns.size(); ++column) {
+        DecodedVector decoded(*columns[column], allRows);
+        for (auto i = 0; i < FLAGS_num_rows; ++i) {
+          container->store(decoded, i, rows[i], column);
+        }
+      }
+    }
+    // The same random permutation of the rows for both layouts.
+    std::vector<int32_t> order(FLAGS_num_rows);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+    for (auto i : order) {
+      shuffledRowWiseRows_.push_back(rowWiseRows_[i]);
+      shuffledColumnarRows_.push_back(columnarRows_[i]);
+    }
+    result_ = BaseVector::create(BIGINT(), FLAGS_num_rows, pool());
+  }
+
+  int64_t extract(bool columnar, bool shuffled) {
+    auto& container = columnar ? *columnar_ : *rowWise_;
+    auto& rows = shuffled
+        ? (columnar ? shuffledColumnarRows_ : shuffledRowWiseRows_)
+        : (columnar ? columnarRows_ : rowWiseRows_);
+    int64_t sum = 0;
+    for (auto column = 0; column < data_->childrenSize(); ++column) {
+      container.extractColumn(rows.data(), rows.size(), column, result_);
+      sum += result_->asFlatVector<int64_t>()->valueAt(0);
+    }
+    return sum;
+  }
+
+ private:
+  RowVectorPtr data_;
+  std::unique_ptr<RowContainer> rowWise_;
+  std::unique_ptr<RowContainer> columnar_;
+  std::vector<char*> rowWiseRows_;
+  std::vector<char*> columnarRows_;
+  std::vector<char*> shuffledRowWiseRows_;
+  std::vector<char*> shuffledColumnarRows_;
+  VectorPtr result_;
+};
+
+std::unique_ptr<RowContainerBenchmark> benchmark;
+
+BENCHMARK(extractRowWise) {
+  folly::doNotOptimizeAway(benchmark->extract(false, false));
+}
+
+BENCHMARK_RELATIVE(extractColumnar) {
+  folly::doNotOptimizeAway(benchmark->extract(true, false));
+}
+
+BENCHMARK(extractShuffledRowWise) {
+  folly::doNotOptimizeAway(benchmark->extract(false, true));
+}
+
+BENCHMARK_RELATIVE(extractShuffledColumnar) {
+  folly::doNotOptimizeAway(benchmark->extract(true, true));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<RowContainerBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
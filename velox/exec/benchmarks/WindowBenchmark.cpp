@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_int32(num_rows, 100'000, "Rows in each of the 4 partitions");
+
+/// Measures aggregate window functions over sliding frames of a varying
+/// number of preceding rows. count() retracts the rows that leave the frame
+/// and sum() and min() combine the nodes of a segment tree, so their cost
+/// per row grows with log(frame size) at most, whereas re-aggregating each
+/// frame grows linearly with the frame size.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+namespace {
+
+class WindowBenchmark : public VectorTestBase {
+ public:
+  WindowBenchmark() {
+    constexpr vector_size_t kBatchSize = 10'000;
+    const auto numRows = FLAGS_num_rows * 4;
+    for (auto i = 0; i < numRows; i += kBatchSize) {
+      data_.push_back(makeRowVector({
+          makeFlatVector<int32_t>(
+              kBatchSize, [&](auto row) { return (i + row) % 4; }),
+          makeFlatVector<int64_t>(
+              kBatchSize, [&](auto row) { return i + row; }),
+          makeFlatVector<int64_t>(
+              kBatchSize, [&](auto row) { return (i + row) * 7'919 % 1'000; }),
+      }));
+    }
+  }
+
+  void run(const std::string& function, int32_t numPreceding) {
+    folly::BenchmarkSuspender suspender;
+    auto plan = PlanBuilder()
+                    .values(data_)
+                    .window({fmt::format(
+                        "{}(c2) over (partition by c0 order by c1 rows between "
+                        "{} preceding and current row)",
+                        function,
+                        numPreceding)})
+                    .planNode();
+    suspender.dismiss();
+
+    auto result = AssertQueryBuilder(plan).copyResults(pool());
+    folly::doNotOptimizeAway(result->size());
+  }
+
+ private:
+  std::vector<RowVectorPtr> data_;
+};
+
+std::unique_ptr<WindowBenchmark> benchmark;
+
+void slidingSum(uint32_t iterations, int32_t numPreceding) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run("sum", numPreceding);
+  }
+}
+
+void slidingMin(uint32_t iterations, int32_t numPreceding) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run("min", numPreceding);
+  }
+}
+
+void slidingCount(uint32_t iterations, int32_t numPreceding) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run("count", numPreceding);
+  }
+}
+
+BENCHMARK_PARAM(slidingSum, 10);
+BENCHMARK_PARAM(slidingSum, 100);
+BENCHMARK_PARAM(slidingSum, 1000);
+BENCHMARK_PARAM(slidingSum, 10000);
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(slidingMin, 10);
+BENCHMARK_PARAM(slidingMin, 100);
+BENCHMARK_PARAM(slidingMin, 1000);
+BENCHMARK_PARAM(slidingMin, 10000);
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(slidingCount, 10);
+BENCHMARK_PARAM(slidingCount, 100);
+BENCHMARK_PARAM(slidingCount, 1000);
+BENCHMARK_PARAM(slidingCount, 10000);
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  aggregate::prestosql::registerAllAggregateFunctions();
+  parse::registerTypeResolver();
+  benchmark = std::make_unique<WindowBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -24,6 +24,7 @@
 #include "velox/exec/HashAggregation.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Values.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -678,6 +679,146 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
           .customStats.count("flushRowCount"));
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }, nullEvery(97)),
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row % 7; }, nullEvery(9)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto makePlan = [&](const std::vector<std::string>& keys,
+                      const std::vector<std::string>& aggregates,
+                      core::PlanNodeId& partialAggId) {
+    return PlanBuilder()
+        .values(vectors)
+        .partialAggregation(keys, aggregates)
+        .capturePlanNodeId(partialAggId)
+        .finalAggregation()
+        .planNode();
+  };
+
+  // The keys are unique. The partial aggregation flushes the groups of the
+  // first batch and passes the following batches through.
+  core::PlanNodeId partialAggId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(QueryConfig::kAbandonPartialAggregationMinRows, "100")
+          .config(QueryConfig::kAbandonPartialAggregationMinPct, "50")
+          .plan(makePlan(
+              {"c0"}, {"sum(c1)", "count(c1)", "avg(c1)"}, partialAggId))
+          .assertResults(
+              "SELECT c0, sum(c1), count(c1), avg(c1) FROM tmp GROUP BY 1");
+  auto stats = toPlanStats(task->taskStats()).at(partialAggId).customStats;
+  EXPECT_EQ(1, stats.at("abandonedPartialAggregation").sum);
+  EXPECT_EQ(9'000, stats.at("abandonedPartialAggregationRows").sum);
+
+  // Distinct aggregation.
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .config(QueryConfig::kAbandonPartialAggregationMinRows, "100")
+             .config(QueryConfig::kAbandonPartialAggregationMinPct, "50")
+             .plan(makePlan({"c0"}, {}, partialAggId))
+             .assertResults("SELECT distinct c0 FROM tmp");
+  stats = toPlanStats(task->taskStats()).at(partialAggId).customStats;
+  EXPECT_EQ(9'000, stats.at("abandonedPartialAggregationRows").sum);
+
+  // The keys repeat. The partial aggregation keeps the hash table.
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .config(QueryConfig::kAbandonPartialAggregationMinRows, "100")
+             .config(QueryConfig::kAbandonPartialAggregationMinPct, "50")
+             .plan(makePlan({"c1"}, {"count(c0)"}, partialAggId))
+             .assertResults("SELECT c1, count(c0) FROM tmp GROUP BY 1");
+  stats = toPlanStats(task->taskStats()).at(partialAggId).customStats;
+  EXPECT_EQ(0, stats.count("abandonedPartialAggregationRows"));
+}
+
+TEST_F(AggregationTest, streamingClusteredPartialAggregation) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (i * 1'000 + row) / 10; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 7; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId partialAggId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .partialAggregation({"c0"}, {"sum(c1)", "max(c1)"})
+                    .capturePlanNodeId(partialAggId)
+                    .finalAggregation()
+                    .planNode())
+          .assertResults("SELECT c0, sum(c1), max(c1) FROM tmp GROUP BY 1");
+  const auto stats = toPlanStats(task->taskStats()).at(partialAggId);
+  EXPECT_EQ(1, stats.customStats.at("streamingPartialAggregation").sum);
+  // No group spans two batches, so each is produced once.
+  EXPECT_EQ(1'000, stats.outputRows);
+
+  // The keys repeat after each batch.
+  vectors = std::vector<RowVectorPtr>(10, vectors[0]);
+  createDuckDbTable(vectors);
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .plan(PlanBuilder()
+                       .values(vectors)
+                       .partialAggregation({"c0"}, {"sum(c1)"})
+                       .capturePlanNodeId(partialAggId)
+                       .finalAggregation()
+                       .planNode())
+             .assertResults("SELECT c0, sum(c1) FROM tmp GROUP BY 1");
+  EXPECT_EQ(
+      0,
+      toPlanStats(task->taskStats())
+          .at(partialAggId)
+          .customStats.count("streamingPartialAggregation"));
+}
+
+TEST_F(AggregationTest, localPartitionedFinalAggregation) {
+  constexpr int32_t kNumDrivers = 4;
+  auto vectors = makeVectors(rowType_, 1'000, 10);
+  // Each driver of the parallelizable Values node produces all the vectors.
+  std::vector<RowVectorPtr> allVectors;
+  for (auto i = 0; i < kNumDrivers; ++i) {
+    allVectors.insert(allVectors.end(), vectors.begin(), vectors.end());
+  }
+  createDuckDbTable(allVectors);
+
+  core::PlanNodeId finalAggId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .maxDrivers(kNumDrivers)
+          .plan(PlanBuilder()
+                    .values(vectors, true)
+                    .partialAggregation(
+                        {"c1"}, {"count(1)", "sum(c2)", "max(c6)"})
+                    .localPartitionedFinalAggregation()
+                    .capturePlanNodeId(finalAggId)
+                    .planNode())
+          .assertResults(
+              "SELECT c1, count(1), sum(c2), max(c6) FROM tmp GROUP BY 1");
+  EXPECT_EQ(
+      kNumDrivers, toPlanStats(task->taskStats()).at(finalAggId).numDrivers);
+
+  // Global aggregation.
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .maxDrivers(kNumDrivers)
+             .plan(PlanBuilder()
+                       .values(vectors, true)
+                       .partialAggregation({}, {"count(1)", "sum(c2)"})
+                       .localPartitionedFinalAggregation()
+                       .capturePlanNodeId(finalAggId)
+                       .planNode())
+             .assertResults("SELECT count(1), sum(c2) FROM tmp");
+  EXPECT_EQ(1, toPlanStats(task->taskStats()).at(finalAggId).numDrivers);
+}
+
 TEST_F(AggregationTest, largeValueRangeArray) {
   // We have keys that map to integer range. The keys are
   // a little under max array hash table size apart. This wastes 16MB of
@@ -857,6 +998,55 @@ TEST_F(AggregationTest, partialAggregationMaybeReservationReleaseCheck) {
       task->pool()->getMemoryUsageTracker()->currentBytes());
 }
 
+DEBUG_ONLY_TEST_F(AggregationTest, reclaimFromPartialAggregation) {
+  const int32_t numBatches = 10;
+  std::vector<RowVectorPtr> batches;
+  for (int32_t i = 0; i < numBatches; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<int32_t>(
+        1'000, [&](auto row) { return row + i * 100; })}));
+  }
+  createDuckDbTable(batches);
+
+  // Reclaims memory from the task after the partial aggregation has received
+  // some input. The reclaim runs on a separate thread as it needs to wait for
+  // the driver to go off thread to pause the task.
+  std::atomic<int> numValuesOutputs{0};
+  std::thread reclaimThread;
+  uint64_t reclaimedBytes{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Values::getOutput",
+      std::function<void(const exec::Values*)>(
+          ([&](const exec::Values* values) {
+            if (++numValuesOutputs != numBatches / 2) {
+              return;
+            }
+            auto task = values->operatorCtx()->task();
+            reclaimThread = std::thread([task, &reclaimedBytes]() {
+              reclaimedBytes = task->pool()->reclaim(0);
+            });
+            while (!task->pauseRequested()) {
+              std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+          })));
+
+  core::PlanNodeId aggNodeId;
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(PlanBuilder()
+                            .values(batches)
+                            .partialAggregation({"c0"}, {"count(1)"})
+                            .capturePlanNodeId(aggNodeId)
+                            .finalAggregation()
+                            .planNode())
+                  .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  reclaimThread.join();
+  ASSERT_GT(reclaimedBytes, 0);
+  auto planStats = toPlanStats(task->taskStats());
+  ASSERT_EQ(
+      planStats.at(aggNodeId).customStats.at("reclaimFlushTimes").sum, 1);
+  ASSERT_GT(planStats.at(aggNodeId).customStats.at("flushRowCount").sum, 0);
+  ASSERT_EQ(planStats.at(aggNodeId).spilledBytes, 0);
+}
+
 TEST_F(AggregationTest, spillWithMemoryLimit) {
   constexpr int32_t kNumDistinct = 2000;
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
@@ -1285,6 +1475,95 @@ TEST_F(AggregationTest, groupingSets) {
       "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp GROUP BY ROLLUP (k1, k2)");
 }
 
+TEST_F(AggregationTest, groupingSetsRollUp) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector(
+      {"k1", "k2", "a", "b"},
+      {
+          makeFlatVector<int64_t>(
+              size, [](auto row) { return row % 11; }, nullEvery(7)),
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 17; }),
+          makeFlatVector<int64_t>(
+              size, [](auto row) { return row; }, nullEvery(5)),
+          makeFlatVector<StringView>(
+              size,
+              [](auto row) {
+                auto str = std::string(row % 12, 'x');
+                return StringView(str);
+              }),
+      });
+
+  createDuckDbTable({data, data});
+
+  // The input of GroupId is aggregated once on (k1, k2) and the grouping sets
+  // are rolled up from these groups. A null k1 in the input is a separate
+  // group from the null k1 of the grouping sets without k1.
+  core::PlanNodeId groupIdNodeId;
+  core::PlanNodeId aggNodeId;
+  auto plan = PlanBuilder()
+                  .values({data, data})
+                  .groupId({{"k1", "k2"}, {"k1"}, {"k2"}, {}}, {"a", "b"})
+                  .capturePlanNodeId(groupIdNodeId)
+                  .partialAggregation(
+                      {"k1", "k2", "group_id"},
+                      {"count(1) as count_1",
+                       "sum(a) as sum_a",
+                       "max(b) as max_b",
+                       "avg(a) as avg_a"})
+                  .capturePlanNodeId(aggNodeId)
+                  .finalAggregation()
+                  .project({"k1", "k2", "count_1", "sum_a", "max_b", "avg_a"})
+                  .planNode();
+  const std::string cube =
+      "SELECT k1, k2, count(1), sum(a), max(b), avg(a) FROM tmp "
+      "GROUP BY CUBE (k1, k2)";
+
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_).assertResults(cube);
+  auto planStats = toPlanStats(task->taskStats());
+  EXPECT_EQ(0, planStats.count(groupIdNodeId));
+  // 11 values of k1 and a null times 17 values of k2.
+  EXPECT_EQ(
+      12 * 17,
+      planStats.at(aggNodeId).customStats.at("rollUpFinestGroups").sum);
+
+  // The partial aggregation rolls up and flushes the groups at its memory
+  // limit.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .config(QueryConfig::kMaxPartialAggregationMemory, "1")
+             .assertResults(cube);
+  planStats = toPlanStats(task->taskStats());
+  EXPECT_GT(planStats.at(aggNodeId).customStats.at("flushTimes").sum, 1);
+
+  // Single aggregation.
+  plan = PlanBuilder()
+             .values({data, data})
+             .groupId({{"k1", "k2"}, {"k1"}, {}}, {"a", "b"})
+             .capturePlanNodeId(groupIdNodeId)
+             .singleAggregation(
+                 {"k1", "k2", "group_id"}, {"count(1) as count_1", "max(b)"})
+             .project({"k1", "k2", "count_1", "a1"})
+             .planNode();
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .assertResults(
+                 "SELECT k1, k2, count(1), max(b) FROM tmp "
+                 "GROUP BY ROLLUP (k1, k2)");
+  EXPECT_EQ(0, toPlanStats(task->taskStats()).count(groupIdNodeId));
+
+  // An aggregate over a grouping key needs GroupId to null out the key.
+  plan = PlanBuilder()
+             .values({data})
+             .groupId({{"k1"}, {}}, {"a", "k2"})
+             .capturePlanNodeId(groupIdNodeId)
+             .singleAggregation({"k1", "group_id"}, {"count(k1)", "sum(a)"})
+             .project({"k1", "a0", "a1"})
+             .planNode();
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .assertResults(
+                 "SELECT k1, count(k1), sum(a) FROM tmp GROUP BY k1 "
+                 "UNION ALL SELECT null, 0, sum(a) FROM tmp");
+  EXPECT_EQ(1, toPlanStats(task->taskStats()).count(groupIdNodeId));
+}
+
 TEST_F(AggregationTest, groupingSetsByExpand) {
   vector_size_t size = 1'000;
   auto data = makeRowVector(
@@ -1523,8 +1802,37 @@ TEST_F(AggregationTest, distinctWithSpilling) {
                             .capturePlanNodeId(aggrNodeId)
                             .planNode())
                   .assertResults("SELECT distinct c0 FROM tmp");
-  // Verify that spilling is not triggered.
-  ASSERT_EQ(toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
+  // The keys returned before spilling started are not returned again.
+  ASSERT_GT(toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+
+  // Multiple keys with high cardinality.
+  vectors.clear();
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row * i % 997; }),
+        makeFlatVector<StringView>(
+            1'000,
+            [](auto row) {
+              return StringView(fmt::format("session {}", row % 89));
+            },
+            nullEvery(13)),
+    }));
+  }
+  createDuckDbTable(vectors);
+  spillDirectory = exec::test::TempDirectoryPath::create();
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .spillDirectory(spillDirectory->path)
+             .config(QueryConfig::kSpillEnabled, "true")
+             .config(QueryConfig::kAggregationSpillEnabled, "true")
+             .config(QueryConfig::kTestingSpillPct, "100")
+             .plan(PlanBuilder()
+                       .values(vectors)
+                       .singleAggregation({"c0", "c1"}, {}, {})
+                       .capturePlanNodeId(aggrNodeId)
+                       .planNode())
+             .assertResults("SELECT distinct c0, c1 FROM tmp");
+  ASSERT_GT(toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
@@ -1566,6 +1874,119 @@ TEST_F(AggregationTest, preGroupedAggregationWithSpilling) {
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
+// Returns a copy of the single aggregation 'node' whose i-th aggregate sorts
+// its input by the ascending 'sortingKeys[i]' and deduplicates it if
+// 'distincts[i]' is true.
+core::PlanNodePtr sortedOrDistinctInputs(
+    const core::PlanNodePtr& node,
+    const std::vector<std::vector<std::string>>& sortingKeys,
+    const std::vector<bool>& distincts) {
+  auto aggregationNode =
+      std::dynamic_pointer_cast<const core::AggregationNode>(node);
+  VELOX_CHECK_NOT_NULL(aggregationNode);
+  const auto& inputType = aggregationNode->sources()[0]->outputType();
+  std::vector<std::vector<core::FieldAccessTypedExprPtr>> keys;
+  std::vector<std::vector<core::SortOrder>> orders;
+  for (const auto& names : sortingKeys) {
+    keys.emplace_back();
+    orders.emplace_back();
+    for (const auto& name : names) {
+      keys.back().push_back(std::make_shared<core::FieldAccessTypedExpr>(
+          inputType->findChild(name), name));
+      orders.back().push_back(core::kAscNullsLast);
+    }
+  }
+  return std::make_shared<core::AggregationNode>(
+      aggregationNode->id(),
+      aggregationNode->step(),
+      aggregationNode->groupingKeys(),
+      aggregationNode->preGroupedKeys(),
+      aggregationNode->aggregateNames(),
+      aggregationNode->aggregates(),
+      aggregationNode->aggregateMasks(),
+      keys,
+      orders,
+      distincts,
+      aggregationNode->ignoreNullKeys(),
+      aggregationNode->sources()[0]);
+}
+
+TEST_F(AggregationTest, distinctInputs) {
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; }),
+      makeFlatVector<int64_t>(
+          1'000, [](auto row) { return row % 31; }, nullEvery(11)),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row % 13; }),
+  });
+  createDuckDbTable({data, data});
+
+  auto plan = PlanBuilder()
+                  .values({data, data})
+                  .singleAggregation({"c0"}, {"count(c1)", "sum(c2)"})
+                  .planNode();
+  assertQuery(
+      sortedOrDistinctInputs(plan, {}, {true, false}),
+      "SELECT c0, count(DISTINCT c1), sum(c2) FROM tmp GROUP BY 1");
+
+  // Global aggregation.
+  plan = PlanBuilder()
+             .values({data, data})
+             .singleAggregation({}, {"count(c1)", "sum(c2)"})
+             .planNode();
+  assertQuery(
+      sortedOrDistinctInputs(plan, {}, {true, true}),
+      "SELECT count(DISTINCT c1), sum(DISTINCT c2) FROM tmp");
+
+  // Only single aggregations may use distinct inputs.
+  plan = PlanBuilder()
+             .values({data})
+             .partialAggregation({"c0"}, {"count(c1)"})
+             .planNode();
+  VELOX_ASSERT_THROW(
+      sortedOrDistinctInputs(plan, {}, {true}),
+      "Aggregations over sorted or distinct inputs support only single aggregation");
+}
+
+TEST_F(AggregationTest, sortedInputs) {
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 1, 2, 1, 1}),
+      makeFlatVector<int64_t>({30, 20, 10, 40, 20, 0}),
+      makeFlatVector<int64_t>({1, 2, 3, 4, 5, 6}),
+  });
+
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .singleAggregation({"c0"}, {"array_agg(c2)", "sum(c2)"})
+                  .planNode();
+  auto expected = makeRowVector({
+      makeFlatVector<int32_t>({1, 2}),
+      makeArrayVector<int64_t>({{6, 3, 5, 1}, {2, 4}}),
+      makeFlatVector<int64_t>({15, 6}),
+  });
+  AssertQueryBuilder(sortedOrDistinctInputs(plan, {{"c1"}, {}}, {}))
+      .assertResults(expected);
+
+  // Sorted and distinct.
+  plan = PlanBuilder()
+             .values({data})
+             .singleAggregation({}, {"array_agg(c1)"})
+             .planNode();
+  auto node = sortedOrDistinctInputs(plan, {{"c1"}}, {true});
+  ASSERT_EQ(
+      node->toString(true, false),
+      "-- Aggregation[SINGLE a0 := array_agg(ROW[\"c1\"]) distinct "
+      "order by: c1 ASC NULLS LAST] -> a0:ARRAY<BIGINT>\n");
+  AssertQueryBuilder(node).assertResults(makeRowVector({
+      makeArrayVector<int64_t>({{0, 10, 20, 30, 40}}),
+  }));
+
+  // A distinct aggregate may only be ordered by its arguments. Ordering
+  // array_agg(DISTINCT c1) by c2 would put equal c1 values apart.
+  VELOX_ASSERT_THROW(
+      sortedOrDistinctInputs(plan, {{"c2"}}, {true}),
+      "For aggregate function with DISTINCT, ORDER BY expressions must appear in arguments: c2");
+}
+
 TEST_F(AggregationTest, adaptiveOutputBatchRows) {
   int32_t defaultOutputBatchRows = 10;
   vector_size_t size = defaultOutputBatchRows * 5;
@@ -226,3 +226,50 @@ TEST_F(ArrowStreamTest, error) {
       AssertQueryBuilder(plan).copyResults(pool_.get()),
       "Failed to call get_schema on ArrowStream: get_schema failed.");
 }
+
+TEST_F(ArrowStreamTest, sink) {
+  vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            size, [&](auto row) { return size * i + row; }, nullEvery(5)),
+        makeFlatVector<StringView>(
+            size,
+            [](auto row) {
+              return StringView(fmt::format("string value {}", row));
+            },
+            nullEvery(7)),
+        wrapInDictionary(
+            makeIndicesInReverse(size),
+            size,
+            makeFlatVector<int32_t>(size, [](auto row) { return row; })),
+        makeConstant<int32_t>(i, size),
+    }));
+  }
+
+  // The consumer checks each batch while the task is alive.
+  size_t numBatches = 0;
+  auto consumer = [&](ArrowSchema& arrowSchema, ArrowArray& arrowArray) {
+    auto batch = std::dynamic_pointer_cast<RowVector>(
+        importFromArrowAsOwner(arrowSchema, arrowArray, pool()));
+    ASSERT_LT(numBatches, vectors.size());
+    assertEqualVectors(vectors[numBatches++], batch);
+    // Dictionary and constant columns are not flattened.
+    EXPECT_EQ(
+        batch->childAt(2)->encoding(), VectorEncoding::Simple::DICTIONARY);
+    EXPECT_EQ(
+        batch->childAt(3)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  };
+  auto plan =
+      PlanBuilder()
+          .values(vectors)
+          .addNode([&](std::string id, core::PlanNodePtr input) {
+            return std::make_shared<core::ArrowStreamSinkNode>(
+                id, consumer, std::move(input));
+          })
+          .planNode();
+  auto result = AssertQueryBuilder(plan).copyResults(pool());
+  EXPECT_EQ(result->size(), 0);
+  EXPECT_EQ(numBatches, vectors.size());
+}
@@ -15,6 +15,7 @@
  */
 #include <folly/Unit.h>
 #include <folly/init/Init.h>
+#include <folly/json.h>
 #include <velox/exec/Driver.h>
 #include "folly/experimental/EventCount.h"
 #include "velox/common/base/tests/GTestUtils.h"
@@ -597,6 +598,187 @@ TEST_F(DriverTest, yield) {
   }
 }
 
+TEST_F(DriverTest, timeSliceYield) {
+  std::vector<RowVectorPtr> batches;
+  for (int32_t i = 0; i < 100; ++i) {
+    batches.push_back(std::dynamic_pointer_cast<RowVector>(
+        BatchMaker::createBatch(rowType_, 10'000, *pool_)));
+  }
+  CursorParameters params;
+  params.planNode =
+      PlanBuilder()
+          .values(batches, true)
+          .project(
+              {"m1 % 3 + m2 % 5 + m3 % 7 + m4 % 11 + m5 % 13 + m6 % 17 + m7 % 19 AS p0"})
+          .partialAggregation({}, {"sum(p0)"})
+          .planNode();
+  params.maxDrivers = 4;
+  const auto expected = readCursor(params, [](auto*) {}).second;
+
+  // Each Driver runs without blocking until all its input is aggregated. Check
+  // that it yields the thread after each time slice.
+  params.queryCtx = std::make_shared<core::QueryCtx>(
+      executor_.get(),
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {core::QueryConfig::kDriverCpuTimeSliceLimitMs, "1"}}));
+  auto [cursor, results] = readCursor(params, [](auto*) {});
+  assertEqualResults(expected, results);
+
+  int64_t numYields = 0;
+  for (auto& pipelineStats : cursor->task()->taskStats().pipelineStats) {
+    for (auto& operatorStats : pipelineStats.operatorStats) {
+      if (operatorStats.runtimeStats.count("timeSliceYields") != 0) {
+        numYields += operatorStats.runtimeStats["timeSliceYields"].sum;
+      }
+    }
+  }
+  ASSERT_GT(numYields, 0);
+}
+
+TEST_F(DriverTest, pipelineDriverStats) {
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 4; ++i) {
+    batches.push_back(
+        makeRowVector({"c0"}, {makeFlatVector<int32_t>({1, 2, 3})}));
+  }
+  auto plan = PlanBuilder().values(batches, true).planFragment();
+  std::mutex mutex;
+  bool blockConsumer{true};
+  std::vector<ContinuePromise> promises;
+  auto task = std::make_shared<exec::Task>(
+      "t0",
+      plan,
+      0,
+      std::make_shared<core::QueryCtx>(driverExecutor_.get()),
+      [&](RowVectorPtr vector, ContinueFuture* future) {
+        std::lock_guard<std::mutex> l(mutex);
+        if (vector == nullptr || !blockConsumer) {
+          return BlockingReason::kNotBlocked;
+        }
+        promises.emplace_back("DriverTest::pipelineDriverStats");
+        *future = promises.back().getSemiFuture();
+        return BlockingReason::kWaitForConsumer;
+      });
+  task->start(task, 2, 1);
+
+  // Both Drivers block on the consumer after their first output.
+  EXPECT_WITH_DELAY(
+      task->taskStats()
+          .pipelineStats[0]
+          .numBlockedDrivers[BlockingReason::kWaitForConsumer] == 2);
+  auto pipelineStats = task->taskStats().pipelineStats[0];
+  ASSERT_EQ(pipelineStats.numDrivers, 2);
+  ASSERT_EQ(pipelineStats.numRunningDrivers, 0);
+
+  {
+    std::lock_guard<std::mutex> l(mutex);
+    blockConsumer = false;
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  }
+  ASSERT_TRUE(waitForTaskCompletion(task.get(), 1'000'000));
+  ASSERT_EQ(task->taskStats().pipelineStats[0].numDrivers, 0);
+}
+
+TEST_F(DriverTest, inlineWakeup) {
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 10; ++i) {
+    batches.push_back(
+        makeRowVector({"c0"}, {makeFlatVector<int32_t>({1, 2, 3})}));
+  }
+  auto plan = PlanBuilder().values(batches).planFragment();
+  int32_t numBatches{0};
+  // The consumer is blocked on a future that is fulfilled before the Driver
+  // checks it. The Driver continues on thread instead of going through the
+  // executor queue.
+  auto task = std::make_shared<exec::Task>(
+      "t0",
+      plan,
+      0,
+      std::make_shared<core::QueryCtx>(driverExecutor_.get()),
+      [&](RowVectorPtr vector, ContinueFuture* future) {
+        if (vector == nullptr) {
+          return BlockingReason::kNotBlocked;
+        }
+        ++numBatches;
+        auto [promise, semiFuture] =
+            makeVeloxContinuePromiseContract("DriverTest::inlineWakeup");
+        promise.setValue();
+        *future = std::move(semiFuture);
+        return BlockingReason::kWaitForConsumer;
+      });
+  task->start(task, 1, 1);
+  ASSERT_TRUE(waitForTaskCompletion(task.get(), 1'000'000));
+  ASSERT_EQ(numBatches, 10);
+
+  int64_t numInlineWakeups = 0;
+  for (auto& operatorStats :
+       task->taskStats().pipelineStats[0].operatorStats) {
+    if (operatorStats.runtimeStats.count("inlineWakeups") != 0) {
+      numInlineWakeups += operatorStats.runtimeStats["inlineWakeups"].sum;
+    }
+  }
+  ASSERT_EQ(numInlineWakeups, 10);
+}
+
+TEST_F(DriverTest, timeline) {
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 10; ++i) {
+    batches.push_back(
+        makeRowVector({"c0"}, {makeFlatVector<int32_t>({1, 2, 3})}));
+  }
+  auto plan =
+      PlanBuilder().values(batches).project({"c0 + 1"}).planFragment();
+  auto consumer = [](RowVectorPtr /*vector*/, ContinueFuture* /*future*/) {
+    return BlockingReason::kNotBlocked;
+  };
+
+  auto task = std::make_shared<exec::Task>(
+      "t0",
+      plan,
+      0,
+      std::make_shared<core::QueryCtx>(driverExecutor_.get()),
+      consumer);
+  task->start(task, 1, 1);
+  ASSERT_TRUE(waitForTaskCompletion(task.get(), 1'000'000));
+  ASSERT_EQ(task->timelineToChromeTrace(), "");
+
+  // Keeps the last 8 of the 30+ events.
+  task = std::make_shared<exec::Task>(
+      "t1",
+      plan,
+      0,
+      std::make_shared<core::QueryCtx>(
+          driverExecutor_.get(),
+          std::make_shared<core::MemConfig>(
+              std::unordered_map<std::string, std::string>{
+                  {core::QueryConfig::kDriverTimelineMaxEvents, "8"}})),
+      consumer);
+  task->start(task, 1, 1);
+  ASSERT_TRUE(waitForTaskCompletion(task.get(), 1'000'000));
+
+  auto trace = folly::parseJson(task->timelineToChromeTrace());
+  auto& events = trace["traceEvents"];
+  ASSERT_EQ(events.size(), 8);
+  int64_t lastStartMicros = 0;
+  int32_t numNoMoreInput = 0;
+  for (auto& event : events) {
+    ASSERT_EQ(event["ph"], "X");
+    ASSERT_EQ(event["pid"], 0);
+    ASSERT_EQ(event["tid"], 0);
+    ASSERT_GE(event["ts"].asInt(), lastStartMicros);
+    lastStartMicros = event["ts"].asInt();
+    if (event["cat"] == "noMoreInput") {
+      ++numNoMoreInput;
+    }
+  }
+  // The end of input of the project and the consumer are among the last
+  // events.
+  ASSERT_EQ(numNoMoreInput, 2);
+}
+
 // A testing Operator that periodically does one of the following:
 //
 // 1. Blocks and registers a resume that continues the Driver after a timed
@@ -1102,3 +1284,50 @@ DEBUG_ONLY_TEST_F(DriverTest, driverSuspensionCalledFromOffThread) {
   ASSERT_ANY_THROW(driver->task()->enterSuspended(driver->state()));
   ASSERT_ANY_THROW(driver->task()->leaveSuspended(driver->state()));
 }
+
+DEBUG_ONLY_TEST_F(DriverTest, numaNodeSwitches) {
+  // Pretends that the driver thread lands on another NUMA node every time it
+  // comes on thread.
+  std::atomic<int32_t> numQuanta{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::numaNode",
+      std::function<void(int32_t*)>(
+          [&](int32_t* numaNode) { *numaNode = numQuanta++ % 2; }));
+
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 4; ++i) {
+    batches.push_back(
+        makeRowVector({"c0"}, {makeFlatVector<int32_t>({1, 2, 3})}));
+  }
+  auto plan = PlanBuilder().values(batches).planFragment();
+  // The consumer blocks the driver after each batch so that the driver goes
+  // off and back on thread once per batch.
+  auto task = std::make_shared<exec::Task>(
+      "t0",
+      plan,
+      0,
+      std::make_shared<core::QueryCtx>(driverExecutor_.get()),
+      [](RowVectorPtr /*unused*/, ContinueFuture* future) {
+        if (future == nullptr) {
+          return exec::BlockingReason::kNotBlocked;
+        }
+        *future = folly::makeSemiFuture();
+        return exec::BlockingReason::kWaitForConsumer;
+      });
+  task->start(task, 1, 1);
+  ASSERT_TRUE(waitForTaskCompletion(task.get(), 100'000'000));
+
+  int64_t numSwitches = 0;
+  for (const auto& pipeline : task->taskStats().pipelineStats) {
+    for (const auto& op : pipeline.operatorStats) {
+      auto it = op.runtimeStats.find("numaNodeSwitches");
+      if (it != op.runtimeStats.end()) {
+        numSwitches += it->second.sum;
+      }
+    }
+  }
+  ASSERT_GT(numQuanta, 1);
+  // The first quantum has no previous node to switch from.
+  ASSERT_GT(numSwitches, 0);
+  ASSERT_LT(numSwitches, numQuanta);
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "velox/exec/Exchange.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+// Records the requests and responds only when the test calls respond().
+class TestExchangeSource : public ExchangeSource {
+ public:
+  TestExchangeSource(
+      const std::string& taskId,
+      int destination,
+      std::shared_ptr<ExchangeQueue> queue,
+      memory::MemoryPool* pool)
+      : ExchangeSource(taskId, destination, std::move(queue), pool) {}
+
+  bool shouldRequestLocked() override {
+    if (atEnd_) {
+      return false;
+    }
+    return !requestPending_.exchange(true);
+  }
+
+  void request(uint64_t maxBytes) override {
+    requests.push_back(maxBytes);
+  }
+
+  void close() override {}
+
+  // Responds to the pending request with a page of 'bytes' and the end marker
+  // if 'atEnd'.
+  void respond(uint64_t bytes, bool atEnd, uint64_t availableBytes = 0) {
+    std::vector<ContinuePromise> promises;
+    {
+      std::lock_guard<std::mutex> l(queue_->mutex());
+      VELOX_CHECK(requestPending_);
+      requestPending_ = false;
+      auto iobuf = folly::IOBuf::create(bytes);
+      iobuf->append(bytes);
+      queue_->enqueueLocked(
+          std::make_unique<SerializedPage>(std::move(iobuf), pool_), promises);
+      if (atEnd) {
+        queue_->enqueueLocked(nullptr, promises);
+        atEnd_ = true;
+      }
+      finishRequestLocked(bytes, availableBytes);
+    }
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  }
+
+  std::vector<uint64_t> requests;
+};
+
+std::vector<TestExchangeSource*>& testSources() {
+  static std::vector<TestExchangeSource*> sources;
+  return sources;
+}
+
+std::unique_ptr<ExchangeSource> createTestExchangeSource(
+    const std::string& taskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* pool) {
+  if (strncmp(taskId.c_str(), "test://", 7) != 0) {
+    return nullptr;
+  }
+  auto source = std::make_unique<TestExchangeSource>(
+      taskId, destination, std::move(queue), pool);
+  testSources().push_back(source.get());
+  return source;
+}
+
+constexpr uint64_t kMB = 1 << 20;
+
+class ExchangeClientTest : public testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    ExchangeSource::registerFactory(createTestExchangeSource);
+  }
+
+  void SetUp() override {
+    testSources().clear();
+    pool_ = memory::addDefaultLeafMemoryPool();
+  }
+
+  void addSources(ExchangeClient& client, int numSources) {
+    for (auto i = 0; i < numSources; ++i) {
+      client.addRemoteTaskId(fmt::format("test://{}", testSources().size()));
+    }
+  }
+
+  std::unique_ptr<SerializedPage> next(ExchangeClient& client, bool& atEnd) {
+    ContinueFuture future;
+    return client.next(&atEnd, &future);
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_;
+};
+
+TEST_F(ExchangeClientTest, maxRequestsInFlight) {
+  // 8MB budget, at most 4 requests of 2MB each.
+  ExchangeClient client(0, pool_.get(), 8 * kMB, 4);
+  addSources(client, 10);
+  auto& sources = testSources();
+  for (auto i = 0; i < sources.size(); ++i) {
+    if (i < 4) {
+      EXPECT_EQ(std::vector<uint64_t>{2 * kMB}, sources[i]->requests) << i;
+    } else {
+      EXPECT_TRUE(sources[i]->requests.empty()) << i;
+    }
+  }
+
+  // A response frees a slot and its budget once the page is consumed. The
+  // source that waited longest is requested next.
+  sources[0]->respond(kMB, false);
+  bool atEnd;
+  ASSERT_NE(nullptr, next(client, atEnd));
+  EXPECT_FALSE(atEnd);
+  EXPECT_EQ(1, sources[0]->requests.size());
+  EXPECT_EQ(std::vector<uint64_t>{2 * kMB}, sources[4]->requests);
+
+  // A source that reports more data is preferred over the ones that were not
+  // requested yet.
+  sources[1]->respond(2 * kMB, false, 2 * kMB);
+  ASSERT_NE(nullptr, next(client, atEnd));
+  EXPECT_EQ(2, sources[1]->requests.size());
+  EXPECT_TRUE(sources[5]->requests.empty());
+
+  auto stats = client.stats();
+  EXPECT_EQ(6, stats.at("exchangeRequests").sum);
+  EXPECT_EQ(2, stats.at("exchangeRequestLatency").count);
+  EXPECT_EQ(8 * kMB, stats.at("exchangeMaxBytesInFlight").max);
+}
+
+TEST_F(ExchangeClientTest, smallBudget) {
+  // With a budget below the minimum request size, only one request is sent
+  // at a time.
+  ExchangeClient client(0, pool_.get(), kMB / 2, 4);
+  addSources(client, 3);
+  auto& sources = testSources();
+  EXPECT_EQ(std::vector<uint64_t>{kMB}, sources[0]->requests);
+  EXPECT_TRUE(sources[1]->requests.empty());
+  EXPECT_TRUE(sources[2]->requests.empty());
+
+  sources[0]->respond(kMB, true);
+  bool atEnd;
+  ASSERT_NE(nullptr, next(client, atEnd));
+  EXPECT_EQ(std::vector<uint64_t>{kMB}, sources[1]->requests);
+  EXPECT_TRUE(sources[2]->requests.empty());
+}
+
+} // namespace
@@ -15,6 +15,7 @@
  */
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -23,6 +24,7 @@ using namespace facebook::velox::exec;
 using namespace facebook::velox::exec::test;
 
 using facebook::velox::test::BatchMaker;
+using facebook::velox::test::SimpleVectorLoader;
 
 class FilterProjectTest : public OperatorTestBase {
  protected:
@@ -298,6 +300,44 @@ TEST_F(FilterProjectTest, filterProjectFused) {
       "SELECT c0, c1, c0 %100 + c1 % 50, c0 % 100 FROM tmp WHERE c0 % 10 < 5");
 }
 
+TEST_F(FilterProjectTest, projectInBlocks) {
+  vector_size_t size = 2'500;
+  auto valueAtC0 = [](auto row) -> int64_t { return row % 7 - 3; };
+  auto valueAtC1 = [](auto row) -> double { return row * 0.5; };
+  auto vectors = makeRowVector({
+      makeFlatVector<int64_t>(size, valueAtC0),
+      makeFlatVector<double>(size, valueAtC1, nullEvery(11)),
+  });
+  auto lazyVectors = makeRowVector({
+      vectorMaker_.lazyFlatVector<int64_t>(size, valueAtC0),
+      vectorMaker_.lazyFlatVector<double>(size, valueAtC1, nullEvery(11)),
+  });
+  createDuckDbTable({vectors});
+
+  // c0 + 1 is shared between the projections, so its results for the earlier
+  // blocks must be kept.
+  const std::vector<std::string> projections = {
+      "(c0 + 1) * (c0 + 1) - c0", "(c0 + 1) * 3 + c0", "c1 * 2.0 + c1", "c0"};
+  const std::string sql =
+      "SELECT (c0 + 1) * (c0 + 1) - c0, (c0 + 1) * 3 + c0, c1 * 2.0 + c1, c0 "
+      "FROM tmp";
+  for (const auto& input : {vectors, lazyVectors}) {
+    auto plan = PlanBuilder().values({input}).project(projections).planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kProjectionBlockSize, "256")
+        .assertResults(sql);
+
+    plan = PlanBuilder()
+               .values({input})
+               .filter("c0 % 3 = 0")
+               .project(projections)
+               .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kProjectionBlockSize, "256")
+        .assertResults(sql + " WHERE c0 % 3 = 0");
+  }
+}
+
 TEST_F(FilterProjectTest, projectAndIdentityOverLazy) {
   // Verify that a lazy column which is a part of both an identity projection
   // and a regular projection is loaded correctly. This is done by running a
@@ -322,3 +362,37 @@ TEST_F(FilterProjectTest, projectAndIdentityOverLazy) {
                   .planNode();
   assertQuery(plan, "SELECT c0 < 10 AND c1 < 10, c1 FROM tmp");
 }
+
+TEST_F(FilterProjectTest, loadLazyForPassingRows) {
+  // A lazy column that is both projected out and used in a projection, but
+  // not in the filter, is loaded only for the rows that pass the filter.
+  vector_size_t size = 1'000;
+  auto valueAt = [](auto row) -> int32_t { return row; };
+  vector_size_t numLoadedRows = 0;
+  auto lazyVectors = makeRowVector({
+      makeFlatVector<int64_t>(size, valueAt),
+      std::make_shared<LazyVector>(
+          pool(),
+          INTEGER(),
+          size,
+          std::make_unique<SimpleVectorLoader>([&](RowSet rows) {
+            numLoadedRows += rows.size();
+            return makeFlatVector<int32_t>(rows.back() + 1, valueAt);
+          })),
+  });
+
+  auto vectors = makeRowVector({
+      makeFlatVector<int64_t>(size, valueAt),
+      makeFlatVector<int32_t>(size, valueAt),
+  });
+
+  createDuckDbTable({vectors});
+
+  auto plan = PlanBuilder()
+                  .values({lazyVectors})
+                  .filter("c0 % 100 = 0")
+                  .project({"c0", "c1 + 1", "c1"})
+                  .planNode();
+  assertQuery(plan, "SELECT c0, c1 + 1, c1 FROM tmp WHERE c0 % 100 = 0");
+  EXPECT_EQ(10, numLoadedRows);
+}
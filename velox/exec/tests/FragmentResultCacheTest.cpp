@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/FragmentResultCache.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+FragmentResultCache::Pages makePages(int32_t numPages, int32_t pageSize) {
+  FragmentResultCache::Pages pages;
+  for (auto i = 0; i < numPages; ++i) {
+    auto page = folly::IOBuf::create(pageSize);
+    page->append(pageSize);
+    pages.push_back(std::move(page));
+  }
+  return pages;
+}
+
+} // namespace
+
+TEST(FragmentResultCacheTest, basic) {
+  FragmentResultCache cache(1'000, 500);
+  ASSERT_FALSE(cache.get("a").has_value());
+
+  cache.put("a", makePages(2, 100));
+  auto pages = cache.get("a");
+  ASSERT_TRUE(pages.has_value());
+  ASSERT_EQ(pages->size(), 2);
+  ASSERT_EQ(pages->at(0)->computeChainDataLength(), 100);
+
+  // An empty result is cached too.
+  cache.put("b", {});
+  ASSERT_TRUE(cache.get("b").has_value());
+  ASSERT_TRUE(cache.get("b")->empty());
+
+  // A result larger than the max entry size is not cached.
+  cache.put("c", makePages(6, 100));
+  ASSERT_FALSE(cache.get("c").has_value());
+
+  auto stats = cache.stats();
+  ASSERT_EQ(stats.numElements, 2);
+  // The keys count towards the size.
+  ASSERT_EQ(stats.curSize, 202);
+  ASSERT_EQ(stats.numLookups, 5);
+  ASSERT_EQ(stats.numHits, 3);
+
+  cache.clear();
+  ASSERT_FALSE(cache.get("a").has_value());
+  ASSERT_EQ(cache.stats().curSize, 0);
+}
+
+TEST(FragmentResultCacheTest, evict) {
+  FragmentResultCache cache(1'000, 500);
+  cache.put("a", makePages(4, 100));
+  cache.put("b", makePages(4, 100));
+  auto pagesA = cache.get("a");
+  ASSERT_TRUE(pagesA.has_value());
+
+  // Evicts the oldest entry.
+  cache.put("c", makePages(4, 100));
+  ASSERT_FALSE(cache.get("a").has_value());
+  ASSERT_TRUE(cache.get("b").has_value());
+  ASSERT_TRUE(cache.get("c").has_value());
+  ASSERT_EQ(cache.stats().numElements, 2);
+
+  // The pages returned before stay valid after their entry is evicted.
+  ASSERT_EQ(pagesA->size(), 4);
+  ASSERT_EQ(pagesA->at(3)->computeChainDataLength(), 100);
+}
+
+TEST(FragmentResultCacheTest, instance) {
+  ASSERT_EQ(FragmentResultCache::getInstance(), nullptr);
+  auto cache = std::make_shared<FragmentResultCache>(1'000, 500);
+  FragmentResultCache::setInstance(cache);
+  ASSERT_EQ(FragmentResultCache::getInstance(), cache);
+  FragmentResultCache::setInstance(nullptr);
+  ASSERT_EQ(FragmentResultCache::getInstance(), nullptr);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/FragmentResultCache.h"
+#include "velox/exec/HashBuildCache.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+std::unique_ptr<BaseHashTable> makeTable(memory::MemoryPool* pool) {
+  std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+  keyHashers.push_back(std::make_unique<VectorHasher>(BIGINT(), 0));
+  return HashTable<true>::createForJoin(
+      std::move(keyHashers), {}, true, false, pool);
+}
+
+} // namespace
+
+TEST(HashBuildCacheTest, basic) {
+  HashBuildCache cache(1'000, 500);
+  ASSERT_FALSE(cache.get("a").has_value());
+
+  BaseHashTable* rawTable = nullptr;
+  int32_t numCopies = 0;
+  auto copyTable = [&](memory::MemoryPool* pool) {
+    ++numCopies;
+    auto table = makeTable(pool);
+    rawTable = table.get();
+    return table;
+  };
+  ASSERT_TRUE(cache.put("a", 100, true, copyTable));
+  auto cached = cache.get("a");
+  ASSERT_TRUE(cached.has_value());
+  ASSERT_EQ(cached->table.get(), rawTable);
+  ASSERT_EQ(cached->table->rows()->pool(), cache.pool());
+  ASSERT_TRUE(cached->hasNullKeys);
+
+  // A cached key and a table larger than the max entry size are not copied.
+  ASSERT_FALSE(cache.put("a", 100, false, copyTable));
+  ASSERT_FALSE(cache.accepts(600));
+  ASSERT_FALSE(cache.put("b", 600, false, copyTable));
+  ASSERT_EQ(numCopies, 1);
+  ASSERT_FALSE(cache.get("b").has_value());
+
+  // A copy in another pool is not accepted.
+  auto pool = memory::addDefaultLeafMemoryPool();
+  ASSERT_ANY_THROW(cache.put("c", 100, false, [&](memory::MemoryPool*) {
+    return makeTable(pool.get());
+  }));
+
+  auto stats = cache.stats();
+  ASSERT_EQ(stats.numElements, 1);
+  // The keys count towards the size.
+  ASSERT_EQ(stats.curSize, 101);
+  // put() looks up the key before copying.
+  ASSERT_EQ(stats.numLookups, 6);
+  ASSERT_EQ(stats.numHits, 2);
+
+  cache.clear();
+  ASSERT_FALSE(cache.get("a").has_value());
+  ASSERT_EQ(cache.stats().curSize, 0);
+}
+
+TEST(HashBuildCacheTest, capacity) {
+  HashBuildCache cache(1 << 20, 1 << 20);
+  // The copy exceeds the capacity of the pool of the cache and is dropped.
+  ASSERT_FALSE(cache.put("a", 100, false, [](memory::MemoryPool* pool) {
+    auto table = makeTable(pool);
+    pool->free(pool->allocate(2 << 20), 2 << 20);
+    return table;
+  }));
+  ASSERT_FALSE(cache.get("a").has_value());
+  ASSERT_EQ(cache.pool()->getCurrentBytes(), 0);
+}
+
+TEST(HashBuildCacheTest, evict) {
+  auto cache = std::make_shared<HashBuildCache>(1'000, 500);
+  auto copyTable = [](memory::MemoryPool* pool) { return makeTable(pool); };
+  ASSERT_TRUE(cache->put("a", 400, false, copyTable));
+  ASSERT_TRUE(cache->put("b", 400, false, copyTable));
+  auto tableA = cache->get("a");
+  ASSERT_TRUE(tableA.has_value());
+
+  // Evicts the oldest entry.
+  ASSERT_TRUE(cache->put("c", 400, false, copyTable));
+  ASSERT_FALSE(cache->get("a").has_value());
+  ASSERT_TRUE(cache->get("b").has_value());
+  ASSERT_TRUE(cache->get("c").has_value());
+  ASSERT_EQ(cache->stats().numElements, 2);
+
+  // The tables returned before stay valid after their entry is evicted and
+  // after the cache is destroyed.
+  cache.reset();
+  ASSERT_EQ(tableA->table->numDistinct(), 0);
+  tableA.reset();
+}
+
+TEST(HashBuildCacheTest, instance) {
+  ASSERT_EQ(HashBuildCache::getInstance(), nullptr);
+  auto cache = std::make_shared<HashBuildCache>(1'000, 500);
+  HashBuildCache::setInstance(cache);
+  ASSERT_EQ(HashBuildCache::getInstance(), cache);
+  HashBuildCache::setInstance(nullptr);
+  ASSERT_EQ(HashBuildCache::getInstance(), nullptr);
+}
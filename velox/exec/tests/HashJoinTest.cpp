@@ -17,6 +17,7 @@
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/exec/HashBuildCache.h"
 #include "velox/exec/HashJoinBridge.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
@@ -2791,6 +2792,60 @@ TEST_P(MultiThreadedHashJoinTest, noSpillLevelLimit) {
       .run();
 }
 
+TEST_P(MultiThreadedHashJoinTest, restoreSpillInChunks) {
+  // The spilled partitions exceed the max spill level when restored and are
+  // built into tables a spill file at a time.
+  struct {
+    core::JoinType joinType;
+    std::string referenceQuery;
+
+    std::string debugString() const {
+      return fmt::format("joinType: {}", core::joinTypeName(joinType));
+    }
+  } testSettings[] = {
+      {core::JoinType::kInner,
+       "SELECT t_k0, t_data, u_k0, u_data FROM t, u WHERE t.t_k0 = u.u_k0"},
+      {core::JoinType::kRight,
+       "SELECT t_k0, t_data, u_k0, u_data FROM t RIGHT JOIN u ON t.t_k0 = u.u_k0"}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .numDrivers(numDrivers_)
+        .keyTypes({INTEGER()})
+        .probeVectors(1600, 5)
+        .buildVectors(1500, 5)
+        .joinType(testData.joinType)
+        .referenceQuery(testData.referenceQuery)
+        .maxSpillLevel(0)
+        .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+          if (!hasSpill) {
+            return;
+          }
+          int64_t numChunks = 0;
+          int64_t numLevel0Partitions = 0;
+          for (auto& pipelineStat : task->taskStats().pipelineStats) {
+            for (auto& operatorStat : pipelineStat.operatorStats) {
+              if (operatorStat.operatorType != "HashBuild") {
+                continue;
+              }
+              auto& runtimeStats = operatorStat.runtimeStats;
+              if (runtimeStats.count("spillRestoreChunks") != 0) {
+                numChunks += runtimeStats["spillRestoreChunks"].sum;
+              }
+              if (runtimeStats.count("spillPartitionBytes.level0") != 0) {
+                numLevel0Partitions +=
+                    runtimeStats["spillPartitionBytes.level0"].count;
+              }
+              ASSERT_EQ(runtimeStats.count("spillPartitionBytes.level1"), 0);
+            }
+          }
+          ASSERT_GE(numChunks, numLevel0Partitions);
+          ASSERT_GT(numLevel0Partitions, 0);
+        })
+        .run();
+  }
+}
+
 TEST_F(HashJoinTest, semiProject) {
   // Some keys have multiple rows: 2, 3, 5.
   auto probeVectors = makeBatches(3, [&](int32_t /*unused*/) {
@@ -4366,6 +4421,69 @@ TEST_F(HashJoinTest, smallOutputBatchSize) {
       .run();
 }
 
+TEST_F(HashJoinTest, lazyBuildOutput) {
+  auto probeVectors = makeBatches(5, [&](int32_t /*unused*/) {
+    return makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row % 23; }, nullEvery(11)),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+    });
+  });
+  auto buildVectors = makeBatches(3, [&](int32_t batch) {
+    return makeRowVector(
+        {"u_c0", "u_c1", "u_c2"},
+        {
+            makeFlatVector<int32_t>(50, [](auto row) { return row % 17; }),
+            makeFlatVector<int32_t>(
+                50, [batch](auto row) { return batch * 50 + row; }),
+            makeFlatVector<StringView>(
+                50,
+                [](auto row) {
+                  return StringView::makeInline(fmt::format("s{}", row));
+                },
+                nullEvery(7)),
+        });
+  });
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  // Only some of the joined rows pass the filter on a build side column and
+  // the other is only accessed for these rows.
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kLeft}) {
+    SCOPED_TRACE(core::joinTypeName(joinType));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors)
+                            .planNode(),
+                        "",
+                        {"c0", "c1", "u_c1", "u_c2"},
+                        joinType)
+                    .filter("u_c1 % 7 = 0 OR u_c1 IS NULL")
+                    .project({"c1", "u_c2"})
+                    .planNode();
+    const auto referenceQuery = fmt::format(
+        "SELECT c1, u_c2 FROM t {} JOIN u ON c0 = u_c0 "
+        "WHERE u_c1 % 7 = 0 OR u_c1 IS NULL",
+        joinType == core::JoinType::kInner ? "INNER" : "LEFT");
+    for (bool lazyBuildOutput : {false, true}) {
+      SCOPED_TRACE(fmt::format("lazyBuildOutput: {}", lazyBuildOutput));
+      HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+          .planNode(plan)
+          .config(
+              core::QueryConfig::kHashProbeLazyBuildOutput,
+              lazyBuildOutput ? "true" : "false")
+          .config(core::QueryConfig::kPreferredOutputBatchRows, "100")
+          .referenceQuery(referenceQuery)
+          .run();
+    }
+  }
+}
+
 TEST_F(HashJoinTest, spillFileSize) {
   const std::vector<uint64_t> maxSpillFileSizes({0, 1, 1'000'000'000});
   for (const auto spillFileSize : maxSpillFileSizes) {
@@ -4457,6 +4575,131 @@ DEBUG_ONLY_TEST_F(HashJoinTest, buildReservationReleaseCheck) {
   ASSERT_TRUE(waitForTaskAborted(task, 5'000'000));
 }
 
+DEBUG_ONLY_TEST_F(HashJoinTest, numaRemoteProbeRows) {
+  auto probeVectors = makeBatches(5, [&](int32_t /*unused*/) {
+    return makeRowVector(
+        {"t0"}, {makeFlatVector<int64_t>(100, [](auto row) { return row; })});
+  });
+  auto buildVectors = makeBatches(1, [&](int32_t /*unused*/) {
+    return makeRowVector(
+        {"u0"}, {makeFlatVector<int64_t>(10, [](auto row) { return row; })});
+  });
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  // Pretends that the probe runs on a NUMA node other than the one the table
+  // was built on.
+  std::atomic<int32_t> numProbeBatches{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::HashProbe::addInput::numaNode",
+      std::function<void(int32_t*)>([&](int32_t* numaNode) {
+        ++numProbeBatches;
+        *numaNode = -2;
+      }));
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId joinNodeId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(probeVectors)
+                  .hashJoin(
+                      {"t0"},
+                      {"u0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildVectors)
+                          .planNode(),
+                      "",
+                      {"t0", "u0"})
+                  .capturePlanNodeId(joinNodeId)
+                  .planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .assertResults("SELECT t0, u0 FROM t, u WHERE t0 = u0");
+  auto planStats = toPlanStats(task->taskStats());
+  ASSERT_EQ(numProbeBatches, probeVectors.size());
+  ASSERT_EQ(
+      planStats.at(joinNodeId).customStats.at("numaRemoteProbeRows").sum,
+      500);
+}
+
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 5;
+  const int32_t numRowsProbe = 1'000;
+  // The build side has too many distinct keys to push down as an IN-list.
+  const int32_t numRowsBuild = 200'000;
+
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<std::shared_ptr<TempFilePath>> tempFiles;
+  std::vector<exec::Split> probeSplits;
+  for (int32_t i = 0; i < numSplits; ++i) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<int64_t>(
+            numRowsProbe,
+            [&](auto row) { return (row + i * numRowsProbe) * 7; }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    probeVectors.push_back(rowVector);
+    tempFiles.push_back(TempFilePath::create());
+    writeToFile(tempFiles.back()->path, rowVector);
+    probeSplits.push_back(
+        exec::Split(makeHiveConnectorSplit(tempFiles.back()->path)));
+  }
+
+  std::vector<RowVectorPtr> buildVectors;
+  for (int i = 0; i < 10; ++i) {
+    buildVectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        numRowsBuild / 10,
+        [i](auto row) { return (row + i * numRowsBuild / 10) * 3; })}));
+  }
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto probeType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator)
+                       .values(buildVectors)
+                       .project({"c0 AS u_c0"})
+                       .planNode();
+  core::PlanNodeId probeScanId;
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .tableScan(probeType)
+                .capturePlanNodeId(probeScanId)
+                .hashJoin(
+                    {"c0"},
+                    {"u_c0"},
+                    buildSide,
+                    "",
+                    {"c0", "c1"},
+                    core::JoinType::kInner)
+                .planNode();
+
+  for (bool enableBloomFilter : {false, true}) {
+    SCOPED_TRACE(fmt::format("enableBloomFilter: {}", enableBloomFilter));
+    SplitInput splits;
+    splits.emplace(probeScanId, probeSplits);
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .planNode(op)
+        .inputSplits(splits)
+        .config(
+            core::QueryConfig::kHashProbeBloomFilterPushdownMaxSize,
+            enableBloomFilter ? "1048576" : "0")
+        .referenceQuery("SELECT t.c0, t.c1 FROM t, u WHERE t.c0 = u.c0")
+        .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+          SCOPED_TRACE(fmt::format("hasSpill:{}", hasSpill));
+          if (hasSpill || !enableBloomFilter) {
+            ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(0, getFiltersAccepted(task, 0).sum);
+            ASSERT_EQ(getInputPositions(task, 1), numRowsProbe * numSplits);
+          } else {
+            ASSERT_EQ(1, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(1, getFiltersAccepted(task, 0).sum);
+            // The join can't be replaced by an inexact Bloom filter.
+            ASSERT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+            ASSERT_LT(getInputPositions(task, 1), numRowsProbe * numSplits);
+          }
+        })
+        .run();
+  }
+}
+
 TEST_F(HashJoinTest, dynamicFilterOnPartitionKey) {
   vector_size_t size = 10;
   auto filePaths = makeFilePaths(1);
@@ -4503,4 +4746,172 @@ TEST_F(HashJoinTest, dynamicFilterOnPartitionKey) {
       .run();
 }
 
+TEST_F(HashJoinTest, buildCache) {
+  auto cache = std::make_shared<HashBuildCache>(64 << 20, 16 << 20);
+  HashBuildCache::setInstance(cache);
+
+  std::vector<RowVectorPtr> probeVectors =
+      makeBatches(3, [&](int32_t /*unused*/) {
+        return makeRowVector(
+            {makeFlatVector<int32_t>(1'000, [](auto row) { return row % 5; })});
+      });
+  std::vector<RowVectorPtr> buildVectors{makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(3, [](auto row) { return row; }),
+       makeFlatVector<int64_t>(3, [](auto row) { return row * 10; })})};
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  struct {
+    core::JoinType joinType;
+    std::string referenceQuery;
+    bool cached;
+  } testSettings[] = {
+      {core::JoinType::kInner,
+       "SELECT c0, u_c1 FROM t, u WHERE c0 = u_c0",
+       false},
+      {core::JoinType::kInner,
+       "SELECT c0, u_c1 FROM t, u WHERE c0 = u_c0",
+       true},
+      {core::JoinType::kLeft,
+       "SELECT c0, u_c1 FROM t LEFT JOIN u ON c0 = u_c0",
+       false},
+      {core::JoinType::kLeft,
+       "SELECT c0, u_c1 FROM t LEFT JOIN u ON c0 = u_c0",
+       true},
+      // The tables of right joins are not cached as the probes set flags in
+      // them.
+      {core::JoinType::kRight,
+       "SELECT c0, u_c1 FROM t RIGHT JOIN u ON c0 = u_c0",
+       false},
+      {core::JoinType::kRight,
+       "SELECT c0, u_c1 FROM t RIGHT JOIN u ON c0 = u_c0",
+       false}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(core::joinTypeName(testData.joinType));
+    core::PlanNodeId buildValuesId;
+    core::PlanNodeId joinNodeId;
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors)
+                            .capturePlanNodeId(buildValuesId)
+                            .planNode(),
+                        "",
+                        {"c0", "u_c1"},
+                        testData.joinType,
+                        false,
+                        "u")
+                    .capturePlanNodeId(joinNodeId)
+                    .planNode();
+
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .assertResults(testData.referenceQuery);
+    auto planStats = toPlanStats(task->taskStats());
+    // The build side input is not read if the table is cached.
+    ASSERT_EQ(planStats.at(buildValuesId).outputRows, testData.cached ? 0 : 3);
+    ASSERT_EQ(
+        planStats.at(joinNodeId).customStats.count("buildCacheHits"),
+        testData.cached ? 1 : 0);
+    // The first build of a join that can be cached stores a copy of its
+    // table.
+    ASSERT_EQ(
+        planStats.at(joinNodeId).customStats.count("buildCacheInserts"),
+        !testData.cached && testData.joinType != core::JoinType::kRight ? 1
+                                                                        : 0);
+  }
+  ASSERT_EQ(cache->stats().numElements, 2);
+  ASSERT_EQ(cache->stats().numHits, 2);
+  // The cached copies are allocated from the pool of the cache.
+  ASSERT_GT(cache->pool()->getCurrentBytes(), 0);
+
+  HashBuildCache::setInstance(nullptr);
+}
+
+TEST_F(HashJoinTest, buildCacheNotCached) {
+  auto cache = std::make_shared<HashBuildCache>(64 << 20, 16 << 20);
+  HashBuildCache::setInstance(cache);
+
+  std::vector<RowVectorPtr> probeVectors =
+      makeBatches(3, [&](int32_t /*unused*/) {
+        return makeRowVector({makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row % 50; })});
+      });
+  std::vector<RowVectorPtr> buildVectors =
+      makeBatches(5, [&](int32_t batch) {
+        return makeRowVector(
+            {"u_c0", "u_c1"},
+            {makeFlatVector<int32_t>(
+                 100, [&](auto row) { return batch * 100 + row; }),
+             makeFlatVector<int64_t>(100, [](auto row) { return row * 10; })});
+      });
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  core::PlanNodeId buildValuesId;
+  core::PlanNodeId joinNodeId;
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(probeVectors)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildVectors)
+                          .capturePlanNodeId(buildValuesId)
+                          .planNode(),
+                      "",
+                      {"c0", "u_c1"},
+                      core::JoinType::kInner,
+                      false,
+                      "u")
+                  .capturePlanNodeId(joinNodeId)
+                  .planNode();
+  const std::string referenceQuery =
+      "SELECT c0, u_c1 FROM t, u WHERE c0 = u_c0";
+
+  // A spilled build is not cached.
+  {
+    auto spillDirectory = exec::test::TempDirectoryPath::create();
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .spillDirectory(spillDirectory->path)
+                    .config(core::QueryConfig::kSpillEnabled, "true")
+                    .config(core::QueryConfig::kJoinSpillEnabled, "true")
+                    .config(core::QueryConfig::kTestingSpillPct, "100")
+                    .assertResults(referenceQuery);
+    ASSERT_GT(taskSpilledStats(*task).spilledRows, 0);
+    auto planStats = toPlanStats(task->taskStats());
+    ASSERT_EQ(
+        planStats.at(joinNodeId).customStats.count("buildCacheInserts"), 0);
+    ASSERT_EQ(cache->stats().numElements, 0);
+  }
+
+  // A table larger than the max entry size is built as usual and not cached.
+  HashBuildCache::setInstance(std::make_shared<HashBuildCache>(64 << 20, 1));
+  for (auto i = 0; i < 2; ++i) {
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .assertResults(referenceQuery);
+    auto planStats = toPlanStats(task->taskStats());
+    ASSERT_EQ(planStats.at(buildValuesId).outputRows, 500);
+    ASSERT_EQ(
+        planStats.at(joinNodeId).customStats.count("buildCacheInserts"), 0);
+  }
+
+  // The build that is not spilled is cached.
+  HashBuildCache::setInstance(cache);
+  for (auto i = 0; i < 2; ++i) {
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .assertResults(referenceQuery);
+    auto planStats = toPlanStats(task->taskStats());
+    ASSERT_EQ(planStats.at(buildValuesId).outputRows, i == 0 ? 500 : 0);
+  }
+  ASSERT_EQ(cache->stats().numElements, 1);
+
+  HashBuildCache::setInstance(nullptr);
+}
+
 } // namespace
@@ -21,10 +21,14 @@
 #include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
 #include "velox/vector/tests/utils/VectorMaker.h"
 
+#include <folly/Random.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include <memory>
 
+DECLARE_bool(velox_hash_table_batched_probe);
+
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
 using namespace facebook::velox::test;
@@ -91,6 +95,7 @@ class HashTableTest : public testing::TestWithParam<bool> {
       batches_.insert(batches_.end(), batches.begin(), batches.end());
       startOffset += size;
     }
+    topTable_->setRadixPartitionBits(radixPartitionBits_);
     topTable_->prepareJoinTable(std::move(otherTables), executor_.get());
     EXPECT_EQ(topTable_->hashMode(), mode);
     LOG(INFO) << "Made table " << describeTable();
@@ -489,6 +494,8 @@ class HashTableTest : public testing::TestWithParam<bool> {
   // Spacing between consecutive generated keys. Affects whether
   // Vectorhashers make ranges or ids of distinct values.
   int64_t keySpacing_ = 1;
+  // The number of hash bits used to radix partition the join table.
+  uint8_t radixPartitionBits_ = 0;
   std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
 };
 
@@ -541,6 +548,46 @@ TEST_P(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 100000, 9, type, 6);
 }
 
+TEST_P(HashTableTest, radixPartitionedJoin) {
+  auto type =
+      ROW({"key"}, {ROW({"k1", "k2", "k3"}, {BIGINT(), VARCHAR(), BIGINT()})});
+  keySpacing_ = 1000;
+  radixPartitionBits_ = 4;
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 2, type, 1);
+  ASSERT_TRUE(topTable_->isRadixPartitioned());
+  ASSERT_EQ(topTable_->stats().numRadixPartitions, 16);
+}
+
+TEST_P(HashTableTest, radixPartitionedJoinSmallTable) {
+  // The table is too small to be radix partitioned.
+  auto type =
+      ROW({"key"}, {ROW({"k1", "k2", "k3"}, {BIGINT(), VARCHAR(), BIGINT()})});
+  keySpacing_ = 1000;
+  radixPartitionBits_ = 4;
+  testCycle(BaseHashTable::HashMode::kHash, 1000, 2, type, 1);
+  ASSERT_FALSE(topTable_->isRadixPartitioned());
+  ASSERT_EQ(topTable_->stats().numRadixPartitions, 0);
+}
+
+TEST_P(HashTableTest, unbatchedProbe) {
+  // The batched probe is on by default and is covered by the other tests.
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_hash_table_batched_probe = false;
+  keySpacing_ = 1000;
+  testCycle(
+      BaseHashTable::HashMode::kHash,
+      100000,
+      2,
+      ROW({"key"}, {ROW({"k1", "k2"}, {BIGINT(), VARCHAR()})}),
+      1);
+  testCycle(
+      BaseHashTable::HashMode::kNormalizedKey,
+      10000,
+      2,
+      ROW({"k1", "k2"}, {BIGINT(), BIGINT()}),
+      2);
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_P(HashTableTest, clear) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
@@ -689,6 +736,49 @@ TEST_P(HashTableTest, arrayProbeNormalizedKey) {
   ASSERT_EQ(table->hashMode(), BaseHashTable::HashMode::kNormalizedKey);
 }
 
+TEST_P(HashTableTest, rawNormalizedKey) {
+  // Two INTEGER keys that span their type and have more distinct values than
+  // value ids can take. Neither ranges nor value ids fit in a normalized key
+  // but the bits of the keys do.
+  constexpr int32_t kSize = 150'000;
+  auto makeKeys = [&](int32_t step) {
+    return vectorMaker_->flatVector<int32_t>(kSize, [step](auto row) {
+      if (row == 0) {
+        return std::numeric_limits<int32_t>::min();
+      }
+      if (row == 1) {
+        return std::numeric_limits<int32_t>::max();
+      }
+      return row * step;
+    });
+  };
+  batches_.push_back(vectorMaker_->rowVector({makeKeys(7), makeKeys(-3)}));
+
+  std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+  keyHashers.emplace_back(std::make_unique<VectorHasher>(INTEGER(), 0));
+  keyHashers.emplace_back(std::make_unique<VectorHasher>(INTEGER(), 1));
+  topTable_ = HashTable<true>::createForJoin(
+      std::move(keyHashers), {}, true, false, pool_.get());
+  copyVectorsToTable(batches_, 0, topTable_.get());
+  topTable_->prepareJoinTable({}, executor_.get());
+  ASSERT_EQ(topTable_->hashMode(), BaseHashTable::HashMode::kNormalizedKey);
+  ASSERT_TRUE(topTable_->hasRawKeys());
+  ASSERT_EQ("RAW_NORMALIZED_KEY", topTable_->hashModeName());
+  ASSERT_EQ(kSize, topTable_->numDistinct());
+  testProbe();
+
+  // The same keys that are nullable take 66 bits and go to kHash.
+  keyHashers.clear();
+  keyHashers.emplace_back(std::make_unique<VectorHasher>(INTEGER(), 0));
+  keyHashers.emplace_back(std::make_unique<VectorHasher>(INTEGER(), 1));
+  auto nullableTable = HashTable<false>::createForJoin(
+      std::move(keyHashers), {}, true, false, pool_.get());
+  copyVectorsToTable(batches_, 0, nullableTable.get());
+  nullableTable->prepareJoinTable({}, executor_.get());
+  ASSERT_EQ(nullableTable->hashMode(), BaseHashTable::HashMode::kHash);
+  ASSERT_FALSE(nullableTable->hasRawKeys());
+}
+
 TEST_P(HashTableTest, regularHashingTableSize) {
   keySpacing_ = 1000;
   auto checkTableSize = [&](BaseHashTable::HashMode mode,
@@ -752,6 +842,65 @@ TEST_P(HashTableTest, checkSizeValidation) {
   ASSERT_EQ(table->capacity(), 512 << 10);
 }
 
+TEST_P(HashTableTest, incrementalRehash) {
+  // Without a forced hash mode the keys fit a normalized key table, which may
+  // change hash mode and rehash all the rows when the key ranges grow.
+  for (auto forceHashMode : {true, false}) {
+    SCOPED_TRACE(fmt::format("forceHashMode: {}", forceHashMode));
+    auto table = createHashTableForAggregation(
+        ROW({"k1", "k2"}, {BIGINT(), BIGINT()}), 2);
+    table->setIncrementalRehash(true);
+    if (forceHashMode) {
+      table->testingSetHashMode(BaseHashTable::HashMode::kHash, 1'000);
+    }
+    auto lookup = std::make_unique<HashLookup>(table->hashers());
+
+    // Each batch has 500 new keys and 500 keys of previous batches, which
+    // must find the groups of their first insert while the table grows.
+    constexpr int32_t kBatchSize = 1'000;
+    std::vector<char*> groups;
+    folly::Random::DefaultGenerator rng(1);
+    bool sawRehash = false;
+    for (auto batch = 0; batch < 200; ++batch) {
+      const int64_t numOld = groups.size();
+      std::vector<int64_t> keys(kBatchSize);
+      for (auto i = 0; i < kBatchSize; ++i) {
+        if (numOld == 0) {
+          keys[i] = i;
+        } else {
+          keys[i] = i % 2 == 0 ? numOld + i / 2
+                               : folly::Random::rand64(numOld, rng);
+        }
+      }
+      auto data = vectorMaker_->rowVector(
+          {vectorMaker_->flatVector<int64_t>(
+               kBatchSize, [&](auto row) { return keys[row]; }),
+           vectorMaker_->flatVector<int64_t>(
+               kBatchSize, [&](auto row) { return keys[row] * 1'000; })});
+      insertGroups(*data, *lookup, *table);
+
+      groups.resize(numOld + (numOld == 0 ? kBatchSize : kBatchSize / 2));
+      for (auto i = 0; i < kBatchSize; ++i) {
+        if (keys[i] >= numOld) {
+          groups[keys[i]] = lookup->hits[i];
+        } else {
+          ASSERT_EQ(lookup->hits[i], groups[keys[i]]) << keys[i];
+        }
+      }
+      ASSERT_EQ(table->numDistinct(), groups.size());
+      sawRehash |= table->isRehashing();
+      table->checkConsistency();
+    }
+    if (forceHashMode) {
+      ASSERT_EQ(table->hashMode(), BaseHashTable::HashMode::kHash);
+      ASSERT_TRUE(sawRehash);
+      ASSERT_GT(
+          table->stats().peakTableBytes,
+          static_cast<int64_t>(table->capacity()) * 9);
+    }
+  }
+}
+
 TEST_P(HashTableTest, listNullKeyRows) {
   VectorPtr keys = vectorMaker_->flatVector<int64_t>(500, folly::identity);
   testListNullKeyRows(keys, BaseHashTable::HashMode::kArray);
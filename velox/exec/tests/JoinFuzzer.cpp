@@ -15,6 +15,7 @@
  */
 #include "velox/exec/tests/JoinFuzzer.h"
 #include <boost/random/uniform_int_distribution.hpp>
+#include "velox/exec/MergeJoin.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
@@ -514,8 +515,10 @@ void makeAlternativePlans(
                           joinNode->isNullAware())
                       .planNode());
 
-  // Use OrderBy + MergeJoin (if join type is inner or left).
-  if (joinNode->isInnerJoin() || joinNode->isLeftJoin()) {
+  // Use OrderBy + MergeJoin (if merge join supports the join type). Merge
+  // anti join is not null-aware.
+  if (MergeJoin::isSupported(joinNode->joinType()) &&
+      !joinNode->isNullAware()) {
     planNodeIdGenerator->reset();
     plans.push_back(PlanBuilder(planNodeIdGenerator)
                         .values(probeInput)
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/LocalPartition.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -509,3 +511,222 @@ TEST_F(LocalPartitionTest, unionAllLocalExchange) {
       "   SELECT * FROM (VALUES ('y')) as t2(c0)"
       ")");
 }
+
+TEST_F(LocalPartitionTest, concurrentProducers) {
+  // Producers enqueue to a single queue from many threads with a memory limit
+  // that keeps them blocking while the consumer drains the queue.
+  constexpr int kNumProducers = 16;
+  constexpr int kNumBatches = 200;
+  auto data = makeRowVector({makeFlatSequence<int64_t>(0, 100)});
+  auto memoryManager = std::make_shared<exec::LocalExchangeMemoryManager>(
+      10 * data->retainedSize());
+  auto queue = std::make_shared<exec::LocalExchangeQueue>(memoryManager, 0);
+  for (auto i = 0; i < kNumProducers; ++i) {
+    queue->addProducer();
+  }
+  queue->noMoreProducers();
+
+  std::vector<std::thread> producers;
+  for (auto i = 0; i < kNumProducers; ++i) {
+    producers.emplace_back([&]() {
+      for (auto j = 0; j < kNumBatches; ++j) {
+        ContinueFuture future;
+        if (queue->enqueue(data, &future) !=
+            exec::BlockingReason::kNotBlocked) {
+          future.wait();
+        }
+      }
+      queue->noMoreData();
+    });
+  }
+
+  int64_t numRows = 0;
+  for (;;) {
+    ContinueFuture future;
+    RowVectorPtr batch;
+    auto reason = queue->next(&future, pool(), &batch);
+    if (reason != exec::BlockingReason::kNotBlocked) {
+      future.wait();
+      continue;
+    }
+    if (batch == nullptr) {
+      break;
+    }
+    numRows += batch->size();
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(numRows, kNumProducers * kNumBatches * data->size());
+  EXPECT_TRUE(queue->isFinished());
+}
+
+TEST_F(LocalPartitionTest, skewedHashJoinProbe) {
+  // 80% of the probe rows have the same key.
+  std::vector<RowVectorPtr> probeVectors;
+  for (auto i = 0; i < 10; ++i) {
+    probeVectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row % 5 == 0 ? row % 100 : 7; }),
+        makeFlatSequence<int64_t>(i * 1'000, 1'000),
+    }));
+  }
+  auto buildVectors = {makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatSequence<int32_t>(0, 50), makeFlatSequence<int64_t>(0, 50)})};
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  for (auto joinType :
+       {core::JoinType::kInner,
+        core::JoinType::kLeft,
+        core::JoinType::kRight,
+        core::JoinType::kFull}) {
+    SCOPED_TRACE(core::joinTypeName(joinType));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId partitionNodeId;
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .localPartition(
+                        {"c0"},
+                        {PlanBuilder(planNodeIdGenerator)
+                             .values(probeVectors)
+                             .planNode()})
+                    .capturePlanNodeId(partitionNodeId)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors)
+                            .planNode(),
+                        "",
+                        {"c0", "c1", "u_c1"},
+                        joinType)
+                    .planNode();
+
+    auto sql = fmt::format(
+        "SELECT c0, c1, u_c1 FROM t {} JOIN u ON c0 = u_c0",
+        core::joinTypeName(joinType));
+
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .maxDrivers(4)
+            .config(core::QueryConfig::kHashJoinSkewedKeyRoutingEnabled, "true")
+            .assertResults(sql);
+    auto planStats = toPlanStats(task->taskStats());
+    ASSERT_GT(
+        planStats.at(partitionNodeId).customStats.at("skewedRows").sum, 0);
+
+    task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+               .maxDrivers(4)
+               .assertResults(sql);
+    planStats = toPlanStats(task->taskStats());
+    ASSERT_EQ(0, planStats.at(partitionNodeId).customStats.count("skewedRows"));
+  }
+}
+
+TEST_F(LocalPartitionTest, addDrivers) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({makeFlatSequence<int32_t>(i * 100, 100)}));
+  }
+  auto filePaths = writeToFiles(vectors);
+  auto rowType = asRowType(vectors[0]->type());
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localPartition(
+                      {},
+                      {PlanBuilder(planNodeIdGenerator)
+                           .tableScan(rowType)
+                           .capturePlanNodeId(scanNodeId)
+                           .planNode()})
+                  .singleAggregation({}, {"count(1)", "min(c0)", "max(c0)"})
+                  .planNode();
+
+  AssertQueryBuilder queryBuilder(plan, duckDbQueryRunner_);
+  queryBuilder.maxDrivers(1).config(
+      core::QueryConfig::kAdaptiveMaxDrivers, "4");
+  for (const auto& filePath : filePaths) {
+    queryBuilder.split(scanNodeId, makeHiveConnectorSplit(filePath->path));
+  }
+  auto task = queryBuilder.assertResults("SELECT 1000, 0, 999");
+
+  // The scan adds a Driver each time it takes a split while more splits than
+  // Drivers are queued, up to 4 Drivers. None retires because all the splits
+  // arrived before the scan started.
+  auto scanStats = task->taskStats().pipelineStats[1];
+  ASSERT_EQ(scanStats.numAddedDrivers, 3);
+  ASSERT_EQ(scanStats.numRetiredDrivers, 0);
+  ASSERT_EQ(toPlanStats(task->taskStats()).at(scanNodeId).numDrivers, 4);
+
+  // Without the config the scan keeps its single Driver.
+  AssertQueryBuilder fixedBuilder(plan, duckDbQueryRunner_);
+  fixedBuilder.maxDrivers(1);
+  for (const auto& filePath : filePaths) {
+    fixedBuilder.split(scanNodeId, makeHiveConnectorSplit(filePath->path));
+  }
+  task = fixedBuilder.assertResults("SELECT 1000, 0, 999");
+  ASSERT_EQ(task->taskStats().pipelineStats[1].numAddedDrivers, 0);
+  ASSERT_EQ(toPlanStats(task->taskStats()).at(scanNodeId).numDrivers, 1);
+}
+
+TEST_F(LocalPartitionTest, retireDrivers) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({makeFlatSequence<int32_t>(i * 100, 100)}));
+  }
+  auto filePaths = writeToFiles(vectors);
+  auto rowType = asRowType(vectors[0]->type());
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localPartition(
+                      {},
+                      {PlanBuilder(planNodeIdGenerator)
+                           .tableScan(rowType)
+                           .capturePlanNodeId(scanNodeId)
+                           .planNode()})
+                  .singleAggregation({}, {"count(1)", "min(c0)", "max(c0)"})
+                  .planNode();
+
+  CursorParameters params;
+  params.planNode = plan;
+  params.maxDrivers = 1;
+  auto cursor = std::make_unique<TaskCursor>(params);
+  auto task = cursor->task();
+  task->queryCtx()->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kAdaptiveMaxDrivers, "4"}});
+  for (const auto& filePath : filePaths) {
+    task->addSplit(
+        scanNodeId, exec::Split(makeHiveConnectorSplit(filePath->path)));
+  }
+  cursor->start();
+
+  // Once the queued splits are read, the added Drivers retire while the
+  // Driver that the scan started with waits for more splits.
+  auto scanStats = [&]() { return task->taskStats().pipelineStats[1]; };
+  for (auto i = 0; i < 1'000; ++i) {
+    const auto stats = scanStats();
+    if (stats.numRetiredDrivers == 3 && stats.numDrivers == 1) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(scanStats().numAddedDrivers, 3);
+  ASSERT_EQ(scanStats().numRetiredDrivers, 3);
+  ASSERT_EQ(scanStats().numDrivers, 1);
+  ASSERT_EQ(task->state(), exec::kRunning);
+
+  task->noMoreSplits(scanNodeId);
+  ASSERT_TRUE(cursor->moveNext());
+  auto result = cursor->current();
+  ASSERT_EQ(result->size(), 1);
+  ASSERT_EQ(result->childAt(0)->asFlatVector<int64_t>()->valueAt(0), 1'000);
+  ASSERT_EQ(result->childAt(1)->asFlatVector<int32_t>()->valueAt(0), 0);
+  ASSERT_EQ(result->childAt(2)->asFlatVector<int32_t>()->valueAt(0), 999);
+  ASSERT_FALSE(cursor->moveNext());
+  ASSERT_EQ(toPlanStats(task->taskStats()).at(scanNodeId).numDrivers, 4);
+}
@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -119,67 +122,55 @@ class MergeJoinTest : public HiveConnectorTestBase {
     createDuckDbTable("t", left);
     createDuckDbTable("u", right);
 
-    // Test INNER join.
-    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
-    auto plan = PlanBuilder(planNodeIdGenerator)
-                    .values(left)
-                    .mergeJoin(
-                        {"c0"},
-                        {"u_c0"},
-                        PlanBuilder(planNodeIdGenerator)
-                            .values(right)
-                            .project({"c1 AS u_c1", "c0 AS u_c0"})
-                            .planNode(),
-                        "",
-                        {"c0", "c1", "u_c1"},
-                        core::JoinType::kInner)
-                    .planNode();
-
-    // Use very small output batch size.
-    assertQuery(
-        makeCursorParameters(plan, 16),
-        "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0");
-
-    // Use regular output batch size.
-    assertQuery(
-        makeCursorParameters(plan, 1024),
-        "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0");
-
-    // Use very large output batch size.
-    assertQuery(
-        makeCursorParameters(plan, 10'000),
-        "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0");
-
-    // Test LEFT join.
-    planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
-    plan = PlanBuilder(planNodeIdGenerator)
-               .values(left)
-               .mergeJoin(
-                   {"c0"},
-                   {"u_c0"},
-                   PlanBuilder(planNodeIdGenerator)
-                       .values(right)
-                       .project({"c1 as u_c1", "c0 as u_c0"})
-                       .planNode(),
-                   "",
-                   {"c0", "c1", "u_c1"},
-                   core::JoinType::kLeft)
-               .planNode();
-
-    // Use very small output batch size.
-    assertQuery(
-        makeCursorParameters(plan, 16),
-        "SELECT t.c0, t.c1, u.c1 FROM t LEFT JOIN u ON t.c0 = u.c0");
-
-    // Use regular output batch size.
-    assertQuery(
-        makeCursorParameters(plan, 1024),
-        "SELECT t.c0, t.c1, u.c1 FROM t LEFT JOIN u ON t.c0 = u.c0");
-
-    // Use very large output batch size.
-    assertQuery(
-        makeCursorParameters(plan, 10'000),
-        "SELECT t.c0, t.c1, u.c1 FROM t LEFT JOIN u ON t.c0 = u.c0");
+    struct TestCase {
+      core::JoinType joinType;
+      std::vector<std::string> outputLayout;
+      std::string duckDbSql;
+    };
+
+    const std::vector<TestCase> testCases = {
+        {core::JoinType::kInner,
+         {"c0", "c1", "u_c1"},
+         "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0"},
+        {core::JoinType::kLeft,
+         {"c0", "c1", "u_c1"},
+         "SELECT t.c0, t.c1, u.c1 FROM t LEFT JOIN u ON t.c0 = u.c0"},
+        {core::JoinType::kRight,
+         {"c0", "c1", "u_c1"},
+         "SELECT t.c0, t.c1, u.c1 FROM t RIGHT JOIN u ON t.c0 = u.c0"},
+        {core::JoinType::kFull,
+         {"c0", "c1", "u_c1"},
+         "SELECT t.c0, t.c1, u.c1 FROM t FULL OUTER JOIN u ON t.c0 = u.c0"},
+        {core::JoinType::kLeftSemiFilter,
+         {"c0", "c1"},
+         "SELECT t.c0, t.c1 FROM t WHERE EXISTS (SELECT * FROM u WHERE t.c0 = u.c0)"},
+        {core::JoinType::kAnti,
+         {"c0", "c1"},
+         "SELECT t.c0, t.c1 FROM t WHERE NOT EXISTS (SELECT * FROM u WHERE t.c0 = u.c0)"},
+    };
+
+    for (const auto& testCase : testCases) {
+      SCOPED_TRACE(core::joinTypeName(testCase.joinType));
+      auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+      auto plan = PlanBuilder(planNodeIdGenerator)
+                      .values(left)
+                      .mergeJoin(
+                          {"c0"},
+                          {"u_c0"},
+                          PlanBuilder(planNodeIdGenerator)
+                              .values(right)
+                              .project({"c1 AS u_c1", "c0 AS u_c0"})
+                              .planNode(),
+                          "",
+                          testCase.outputLayout,
+                          testCase.joinType)
+                      .planNode();
+
+      // Use very small, regular and very large output batch sizes.
+      for (auto batchSize : {16, 1024, 10'000}) {
+        assertQuery(makeCursorParameters(plan, batchSize), testCase.duckDbSql);
+      }
+    }
   }
 };
 
@@ -417,6 +408,101 @@ TEST_F(MergeJoinTest, leftJoinFilter) {
   }
 }
 
+// Many-to-many matches with a filter for the join types that track which rows
+// had a passing match.
+TEST_F(MergeJoinTest, outerSemiAntiJoinFilter) {
+  auto left = makeRowVector(
+      {"t_c0", "t_c1"},
+      {
+          makeFlatVector<int32_t>({5, 10, 10, 10, 20, 25}),
+          makeFlatVector<int32_t>({0, 1, 2, 3, 4, 5}),
+      });
+
+  auto right = makeRowVector(
+      {"u_c0", "u_c1"},
+      {
+          makeFlatVector<int32_t>({10, 10, 10, 15, 20, 20}),
+          makeFlatVector<int32_t>({0, 1, 2, 3, 4, 5}),
+      });
+
+  createDuckDbTable("t", {left});
+  createDuckDbTable("u", {right});
+
+  struct TestCase {
+    core::JoinType joinType;
+    std::vector<std::string> outputLayout;
+    std::string duckDbSql;
+  };
+
+  const std::vector<TestCase> testCases = {
+      {core::JoinType::kLeft,
+       {"t_c0", "t_c1", "u_c1"},
+       "SELECT t_c0, t_c1, u_c1 FROM t LEFT JOIN u ON t_c0 = u_c0 AND {}"},
+      {core::JoinType::kRight,
+       {"t_c0", "t_c1", "u_c1"},
+       "SELECT t_c0, t_c1, u_c1 FROM t RIGHT JOIN u ON t_c0 = u_c0 AND {}"},
+      {core::JoinType::kLeftSemiFilter,
+       {"t_c0", "t_c1"},
+       "SELECT t_c0, t_c1 FROM t WHERE EXISTS (SELECT * FROM u WHERE t_c0 = u_c0 AND {})"},
+      {core::JoinType::kAnti,
+       {"t_c0", "t_c1"},
+       "SELECT t_c0, t_c1 FROM t WHERE NOT EXISTS (SELECT * FROM u WHERE t_c0 = u_c0 AND {})"},
+  };
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE(core::joinTypeName(testCase.joinType));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = [&](const std::string& filter) {
+      return PlanBuilder(planNodeIdGenerator)
+          .values({left})
+          .mergeJoin(
+              {"t_c0"},
+              {"u_c0"},
+              PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+              filter,
+              testCase.outputLayout,
+              testCase.joinType)
+          .planNode();
+    };
+
+    // Test with different filters and output batch sizes.
+    for (auto batchSize : {1, 2, 3, 16}) {
+      for (auto filter :
+           {"t_c1 + u_c1 > 3",
+            "t_c1 + u_c1 < 3",
+            "t_c1 + u_c1 > 100",
+            "t_c1 + u_c1 < 100"}) {
+        assertQuery(
+            makeCursorParameters(plan(filter), batchSize),
+            fmt::format(testCase.duckDbSql, filter));
+      }
+    }
+  }
+}
+
+TEST_F(MergeJoinTest, fullJoinFilter) {
+  auto data = makeRowVector({"t_c0"}, {makeFlatVector<int32_t>({1, 2, 3})});
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values({data})
+                  .mergeJoin(
+                      {"t_c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values({data})
+                          .project({"t_c0 AS u_c0"})
+                          .planNode(),
+                      "t_c0 + u_c0 > 2",
+                      {"t_c0", "u_c0"},
+                      core::JoinType::kFull)
+                  .planNode();
+
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan).copyResults(pool()),
+      "Merge join doesn't support full join with a filter");
+}
+
 // Verify that both left-side and right-side pipelines feeding the merge join
 // always run single-threaded.
 TEST_F(MergeJoinTest, numDrivers) {
@@ -540,4 +626,167 @@ TEST_F(MergeJoinTest, nullKeys) {
              .planNode();
   AssertQueryBuilder(plan, duckDbQueryRunner_)
       .assertResults("SELECT * FROM t LEFT JOIN u ON t.t0 = u.u0");
+
+  // Right join.
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "",
+                 {"t0", "u0"},
+                 core::JoinType::kRight)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults("SELECT * FROM t RIGHT JOIN u ON t.t0 = u.u0");
+
+  // Full outer join.
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "",
+                 {"t0", "u0"},
+                 core::JoinType::kFull)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults("SELECT * FROM t FULL OUTER JOIN u ON t.t0 = u.u0");
+
+  // Left semi join.
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "",
+                 {"t0"},
+                 core::JoinType::kLeftSemiFilter)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults(
+          "SELECT * FROM t WHERE EXISTS (SELECT * FROM u WHERE t.t0 = u.u0)");
+
+  // Anti join.
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .mergeJoin(
+                 {"t0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "",
+                 {"t0"},
+                 core::JoinType::kAnti)
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults(
+          "SELECT * FROM t WHERE NOT EXISTS (SELECT * FROM u WHERE t.t0 = u.u0)");
+}
+
+// Many rows with the same join key on both sides. The matching rows span
+// multiple batches and are spilled.
+TEST_F(MergeJoinTest, spillSkewedKeys) {
+  auto makeBatches = [&](const std::string& prefix, int32_t payloadScale) {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < 4; ++i) {
+      batches.push_back(makeRowVector(
+          {prefix + "0", prefix + "1"},
+          {
+              makeFlatVector<int32_t>(
+                  50,
+                  [i](auto row) {
+                    // Key 0 in the first rows, key 5 in the middle batches
+                    // and key 7 in the last rows.
+                    const auto n = i * 50 + row;
+                    return n < 10 ? 0 : (n < 190 ? 5 : 7);
+                  }),
+              makeFlatVector<int32_t>(
+                  50,
+                  [i, payloadScale](auto row) {
+                    return (i * 50 + row) * payloadScale;
+                  }),
+          }));
+    }
+    return batches;
+  };
+
+  auto left = makeBatches("t", 1);
+  auto right = makeBatches("u", 3);
+  createDuckDbTable("t", left);
+  createDuckDbTable("u", right);
+
+  struct TestCase {
+    core::JoinType joinType;
+    std::string filter;
+    std::vector<std::string> outputLayout;
+    std::string duckDbSql;
+  };
+
+  const std::vector<TestCase> testCases = {
+      {core::JoinType::kInner,
+       "",
+       {"t0", "t1", "u1"},
+       "SELECT t0, t1, u1 FROM t, u WHERE t0 = u0"},
+      {core::JoinType::kInner,
+       "(t1 + u1) % 3 = 0",
+       {"t0", "t1", "u1"},
+       "SELECT t0, t1, u1 FROM t, u WHERE t0 = u0 AND (t1 + u1) % 3 = 0"},
+      {core::JoinType::kLeft,
+       "",
+       {"t0", "t1", "u1"},
+       "SELECT t0, t1, u1 FROM t LEFT JOIN u ON t0 = u0"},
+      {core::JoinType::kRight,
+       "",
+       {"t0", "t1", "u1"},
+       "SELECT t0, t1, u1 FROM t RIGHT JOIN u ON t0 = u0"},
+      {core::JoinType::kFull,
+       "",
+       {"t0", "t1", "u1"},
+       "SELECT t0, t1, u1 FROM t FULL OUTER JOIN u ON t0 = u0"},
+      {core::JoinType::kLeftSemiFilter,
+       "",
+       {"t0", "t1"},
+       "SELECT t0, t1 FROM t WHERE EXISTS (SELECT * FROM u WHERE t0 = u0)"},
+  };
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE(fmt::format(
+        "{} {}", core::joinTypeName(testCase.joinType), testCase.filter));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId joinId;
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(left)
+                    .mergeJoin(
+                        {"t0"},
+                        {"u0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(right)
+                            .planNode(),
+                        testCase.filter,
+                        testCase.outputLayout,
+                        testCase.joinType)
+                    .capturePlanNodeId(joinId)
+                    .planNode();
+
+    for (auto batchSize : {7, 1024}) {
+      auto spillDirectory = TempDirectoryPath::create();
+      auto task =
+          AssertQueryBuilder(plan, duckDbQueryRunner_)
+              .spillDirectory(spillDirectory->path)
+              .config(core::QueryConfig::kSpillEnabled, "true")
+              .config(core::QueryConfig::kMergeJoinSpillEnabled, "true")
+              .config(core::QueryConfig::kTestingSpillPct, "100")
+              .config(
+                  core::QueryConfig::kPreferredOutputBatchRows,
+                  std::to_string(batchSize))
+              .assertResults(testCase.duckDbSql);
+
+      const auto stats = toPlanStats(task->taskStats()).at(joinId);
+      EXPECT_LT(0, stats.spilledBytes);
+      EXPECT_LT(0, stats.spilledRows);
+    }
+  }
 }
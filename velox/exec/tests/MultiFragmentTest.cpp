@@ -23,6 +23,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -351,6 +352,136 @@ TEST_F(MultiFragmentTest, mergeExchange) {
   }
 }
 
+TEST_F(MultiFragmentTest, compression) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 17; }),
+        makeFlatVector<StringView>(
+            1'000,
+            [](auto row) {
+              return StringView(row % 3 ? "apple" : "a somewhat longer string");
+            }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto* codec : {"lz4", "zstd"}) {
+    SCOPED_TRACE(codec);
+    configSettings_[core::QueryConfig::kExchangeCompressionKind] = codec;
+    auto producerTaskId = makeTaskId("producer", 0);
+    auto producerPlan =
+        PlanBuilder().values(vectors).partitionedOutput({}, 1).planNode();
+    auto producerTask = makeTask(producerTaskId, producerPlan, 0);
+    Task::start(producerTask, 1);
+
+    core::PlanNodeId exchangeId;
+    auto plan = PlanBuilder()
+                    .exchange(producerPlan->outputType())
+                    .capturePlanNodeId(exchangeId)
+                    .planNode();
+    auto split = std::make_shared<RemoteConnectorSplit>(producerTaskId);
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .config(core::QueryConfig::kExchangeCompressionKind, codec)
+                    .split(split)
+                    .assertResults("SELECT * FROM tmp");
+    ASSERT_TRUE(waitForTaskCompletion(producerTask.get()));
+
+    auto stats = toPlanStats(task->taskStats()).at(exchangeId).customStats;
+    const auto wireBytes = stats.at("exchangeWireBytes").sum;
+    const auto rawBytes = stats.at("exchangeRawBytes").sum;
+    EXPECT_LT(0, wireBytes);
+    EXPECT_LT(wireBytes * 2, rawBytes);
+  }
+}
+
+TEST_F(MultiFragmentTest, zeroCopyDeserialize) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [i](auto row) { return row * i; }),
+        makeFlatVector<int8_t>(1'000, [](auto row) { return row % 100; }),
+        makeFlatVector<double>(
+            1'000, [](auto row) { return row * 0.1; }, nullEvery(11)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto* codec : {"none", "lz4"}) {
+    SCOPED_TRACE(codec);
+    configSettings_[core::QueryConfig::kExchangeCompressionKind] = codec;
+    auto producerTaskId = makeTaskId("producer", 0);
+    auto producerPlan =
+        PlanBuilder().values(vectors).partitionedOutput({}, 1).planNode();
+    auto producerTask = makeTask(producerTaskId, producerPlan, 0);
+    Task::start(producerTask, 1);
+
+    auto plan = PlanBuilder().exchange(producerPlan->outputType()).planNode();
+    auto split = std::make_shared<RemoteConnectorSplit>(producerTaskId);
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kExchangeCompressionKind, codec)
+        .config(core::QueryConfig::kExchangeZeroCopyDeserialize, "true")
+        .split(split)
+        .assertResults("SELECT * FROM tmp");
+    ASSERT_TRUE(waitForTaskCompletion(producerTask.get()));
+  }
+}
+
+TEST_F(MultiFragmentTest, scatter) {
+  // With 1'000 rows per batch and 50 destinations the batches are scattered
+  // to the destinations in one pass.
+  constexpr int32_t kNumPartitions = 50;
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [i](auto row) { return row + i; }),
+        makeFlatVector<StringView>(
+            1'000,
+            [](auto row) {
+              return StringView(row % 3 ? "apple" : "a somewhat longer string");
+            },
+            nullEvery(7)),
+        makeArrayVector<int32_t>(
+            1'000,
+            [](auto row) { return row % 5; },
+            [](auto row, auto index) { return row + index; }),
+        makeConstant<int32_t>(i, 1'000),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto producerTaskId = makeTaskId("producer", 0);
+  auto producerPlan = PlanBuilder()
+                          .values(vectors)
+                          .partitionedOutput({"c0"}, kNumPartitions)
+                          .planNode();
+  auto producerTask = makeTask(producerTaskId, producerPlan, 0);
+  Task::start(producerTask, 1);
+
+  std::vector<std::shared_ptr<Task>> tasks;
+  std::vector<std::string> consumerTaskIds;
+  core::PlanNodePtr consumerPlan;
+  for (auto i = 0; i < kNumPartitions; ++i) {
+    consumerPlan = PlanBuilder()
+                       .exchange(producerPlan->outputType())
+                       .partitionedOutput({}, 1)
+                       .planNode();
+    consumerTaskIds.push_back(makeTaskId("consumer", i));
+    auto task = makeTask(consumerTaskIds.back(), consumerPlan, i);
+    tasks.push_back(task);
+    Task::start(task, 1);
+    addRemoteSplits(task, {producerTaskId});
+  }
+
+  auto op = PlanBuilder().exchange(consumerPlan->outputType()).planNode();
+  assertQuery(op, consumerTaskIds, "SELECT * FROM tmp");
+
+  ASSERT_TRUE(waitForTaskCompletion(producerTask.get()));
+  for (auto& task : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+  }
+}
+
 // Test reordering and dropping columns in PartitionedOutput operator.
 TEST_F(MultiFragmentTest, partitionedOutput) {
   setupSources(10, 1000);
@@ -608,6 +739,45 @@ TEST_F(MultiFragmentTest, limit) {
   ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
 }
 
+TEST_F(MultiFragmentTest, limitStopsLeafScan) {
+  // Make the leaf task block on full output buffers, so that it cannot scan
+  // all its splits before the final Limit has all its rows.
+  configSettings_[core::QueryConfig::kMaxPartitionedOutputBufferSize] = "100";
+
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(10'000, [](auto row) { return row; })});
+  auto file = TempFilePath::create();
+  writeToFile(file->path, {data});
+
+  // Make leaf task: TableScan -> Repartitioning(0).
+  core::PlanNodeId scanId;
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan = PlanBuilder()
+                      .tableScan(asRowType(data->type()))
+                      .capturePlanNodeId(scanId)
+                      .partitionedOutput({}, 1)
+                      .planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  Task::start(leafTask, 1);
+  constexpr int kNumSplits = 20;
+  addHiveSplits(
+      leafTask, std::vector<std::shared_ptr<TempFilePath>>(kNumSplits, file));
+
+  // Make final task: Exchange -> FinalLimit(10).
+  auto plan = PlanBuilder()
+                  .exchange(leafPlan->outputType())
+                  .limit(0, 10, false)
+                  .singleAggregation({}, {"count(1)"})
+                  .planNode();
+  assertQuery(plan, {leafTaskId}, "SELECT 10");
+
+  // The Exchange closes its source after the Limit finishes and the leaf task
+  // stops scanning.
+  ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
+  auto scanStats = toPlanStats(leafTask->taskStats()).at(scanId);
+  ASSERT_LT(scanStats.numSplits, kNumSplits);
+}
+
 TEST_F(MultiFragmentTest, mergeExchangeOverEmptySources) {
   std::vector<std::shared_ptr<Task>> tasks;
   std::vector<std::string> leafTaskIds;
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -32,6 +33,17 @@ class NestedLoopJoinTest : public HiveConnectorTestBase {
         size, [start](auto row) { return start + row; });
   }
 
+  // Returns the (join type, SQL join clause) pairs supported with a join
+  // condition.
+  static std::vector<std::pair<core::JoinType, std::string>> joinTypes() {
+    return {
+        {core::JoinType::kInner, "INNER"},
+        {core::JoinType::kLeft, "LEFT"},
+        {core::JoinType::kRight, "RIGHT"},
+        {core::JoinType::kFull, "FULL"},
+    };
+  }
+
   template <typename T>
   VectorPtr lazySequence(vector_size_t size, T start = 0) {
     return vectorMaker_.lazyFlatVector<int32_t>(
@@ -257,3 +269,127 @@ TEST_F(NestedLoopJoinTest, parallelism) {
 
   OperatorTestBase::assertQuery(params, "VALUES (30), (30), (30), (30), (30)");
 }
+
+TEST_F(NestedLoopJoinTest, rangeJoin) {
+  auto leftVectors = {
+      makeRowVector({makeFlatVector<int32_t>(
+          100, [](auto row) { return row * 3; }, nullEvery(13))}),
+      makeRowVector({sequence<int32_t>(1'000, 300)}),
+      makeRowVector({sequence<int32_t>(7, 5'000)}),
+  };
+
+  auto rightVectors = {
+      makeRowVector(
+          {"u_start", "u_end"},
+          {
+              makeFlatVector<int32_t>({0, 10, 15, 200, 900, 2'000}),
+              makeFlatVector<int32_t>({5, 20, 17, 150, 1'000, 2'100}),
+          }),
+      makeRowVector(
+          {"u_start", "u_end"},
+          {
+              makeFlatVector<int32_t>(
+                  3'000, [](auto row) { return row * 7; }, nullEvery(11)),
+              makeFlatVector<int32_t>(
+                  3'000, [](auto row) { return row * 7 + 3; }),
+          }),
+  };
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  for (const auto& [joinType, sqlJoinType] : joinTypes()) {
+    SCOPED_TRACE(sqlJoinType);
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values({leftVectors})
+                    .nestedLoopJoin(
+                        PlanBuilder(planNodeIdGenerator)
+                            .values({rightVectors})
+                            .planNode(),
+                        "c0 BETWEEN u_start AND u_end",
+                        {"c0", "u_start", "u_end"},
+                        joinType)
+                    .planNode();
+
+    auto sql = fmt::format(
+        "SELECT c0, u_start, u_end FROM t {} JOIN u ON c0 BETWEEN u_start AND u_end",
+        sqlJoinType);
+    assertQuery(plan, sql);
+
+    // Small output batches split the large build side vector into blocks.
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kPreferredOutputBatchRows, "10")
+        .assertResults(sql);
+  }
+}
+
+TEST_F(NestedLoopJoinTest, emptyBuild) {
+  auto leftVectors = {makeRowVector({sequence<int32_t>(100)})};
+  auto rightVectors = {makeRowVector({"u_c0"}, {sequence<int32_t>(10)})};
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  for (const auto& [joinType, sqlJoinType] : joinTypes()) {
+    SCOPED_TRACE(sqlJoinType);
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values({leftVectors})
+                    .nestedLoopJoin(
+                        PlanBuilder(planNodeIdGenerator)
+                            .values({rightVectors})
+                            .filter("u_c0 < 0")
+                            .planNode(),
+                        "c0 < u_c0",
+                        {"c0", "u_c0"},
+                        joinType)
+                    .planNode();
+
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT c0, u_c0 FROM t {} JOIN (SELECT * FROM u WHERE u_c0 < 0) u ON c0 < u_c0",
+            sqlJoinType));
+  }
+}
+
+// Test that the build side rows with no match are produced once when there are
+// multiple probe threads.
+TEST_F(NestedLoopJoinTest, parallelOuterJoin) {
+  auto leftVectors = {
+      makeRowVector({sequence<int32_t>(100)}),
+      makeRowVector({sequence<int32_t>(50, 1'000)}),
+  };
+  auto rightVectors = {makeRowVector(
+      {"u_c0"},
+      {makeFlatVector<int32_t>(
+          200, [](auto row) { return row * 10; }, nullEvery(7))})};
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  for (const auto& [joinType, sqlJoinType] : joinTypes()) {
+    SCOPED_TRACE(sqlJoinType);
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values({leftVectors}, true)
+                    .nestedLoopJoin(
+                        PlanBuilder(planNodeIdGenerator)
+                            .values({rightVectors})
+                            .planNode(),
+                        "u_c0 BETWEEN c0 AND c0 + 5",
+                        {"c0", "u_c0"},
+                        joinType)
+                    .planNode();
+
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .maxDrivers(4)
+        .assertResults(fmt::format(
+            "SELECT c0, u_c0 FROM "
+            "(SELECT * FROM t UNION ALL SELECT * FROM t UNION ALL "
+            "SELECT * FROM t UNION ALL SELECT * FROM t) t "
+            "{} JOIN u ON u_c0 BETWEEN c0 AND c0 + 5",
+            sqlJoinType));
+  }
+}
@@ -306,6 +306,87 @@ TEST_F(OrderByTest, multiBatchResult) {
   testSingleKey(vectors, "c0");
 }
 
+TEST_F(OrderByTest, sortParallelism) {
+  vector_size_t batchSize = 10'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            batchSize,
+            [&](vector_size_t row) { return (row * 7919 + i) % 4'999; },
+            nullEvery(13)),
+        makeFlatVector<StringView>(
+            batchSize,
+            [&](vector_size_t row) {
+              return StringView(fmt::format("string value {}", row % 101));
+            }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId orderById;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .orderBy({"c1 DESC", "c0 NULLS FIRST"}, false)
+                  .capturePlanNodeId(orderById)
+                  .planNode();
+  for (const auto& parallelism : {"1", "4", "0"}) {
+    SCOPED_TRACE(parallelism);
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kOrderBySortParallelism, parallelism},
+    });
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = queryCtx;
+    auto task = assertQueryOrdered(
+        params,
+        "SELECT * FROM tmp ORDER BY c1 DESC, c0 NULLS FIRST",
+        {1, 0});
+    const auto& stats = toPlanStats(task->taskStats()).at(orderById);
+    EXPECT_EQ(1, stats.customStats.at("sortWallNanos").count);
+    EXPECT_EQ(1, stats.customStats.at("sortCpuNanos").count);
+  }
+}
+
+TEST_F(OrderByTest, columnarRowContainer) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            batchSize,
+            [&](vector_size_t row) { return (row * 7919 + i) % 997; },
+            nullEvery(13)),
+        makeFlatVector<StringView>(
+            batchSize,
+            [&](vector_size_t row) {
+              return StringView(fmt::format("string value {}", row % 101));
+            },
+            nullEvery(17)),
+        makeFlatVector<double>(
+            batchSize, [](vector_size_t row) { return row * 0.1; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .orderBy({"c1 DESC", "c0 NULLS FIRST", "c2"}, false)
+                  .planNode();
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  queryCtx->setConfigOverridesUnsafe({
+      {core::QueryConfig::kColumnarRowContainerEnabled, "true"},
+  });
+  CursorParameters params;
+  params.planNode = plan;
+  params.queryCtx = queryCtx;
+  assertQueryOrdered(
+      params,
+      "SELECT * FROM tmp ORDER BY c1 DESC, c0 NULLS FIRST, c2",
+      {1, 0, 2});
+}
+
 TEST_F(OrderByTest, varfields) {
   vector_size_t batchSize = 1000;
   std::vector<RowVectorPtr> vectors;
@@ -16,9 +16,11 @@
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include <gtest/gtest.h>
 #include <velox/common/memory/MemoryAllocator.h>
+#include "velox/common/file/FileSystems.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/Exchange.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/serializers/PrestoSerializer.h"
 
 using namespace facebook::velox;
@@ -30,6 +32,7 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
  protected:
   void SetUp() override {
     pool_ = facebook::velox::memory::addDefaultLeafMemoryPool();
+    filesystems::registerLocalFileSystem();
     bufferManager_ = PartitionedOutputBufferManager::getInstance().lock();
     if (!isRegisteredVectorSerde()) {
       facebook::velox::serializer::presto::PrestoVectorSerde::
@@ -45,7 +48,9 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
       const std::string& taskId,
       const RowTypePtr& rowType,
       int numDestinations,
-      int numDrivers) {
+      int numDrivers,
+      const std::unordered_map<std::string, std::string>& config = {},
+      const std::string& spillDirectory = "") {
     bufferManager_->removeTask(taskId);
 
     auto planFragment = exec::test::PlanBuilder()
@@ -56,7 +61,9 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
         taskId,
         std::move(planFragment),
         0,
-        std::make_shared<core::QueryCtx>(executor_.get()));
+        std::make_shared<core::QueryCtx>(
+            executor_.get(), std::make_shared<core::MemConfig>(config)));
+    task->setSpillDirectory(spillDirectory);
 
     bufferManager_->initializeTask(task, false, numDestinations, numDrivers);
     return task;
@@ -364,6 +371,99 @@ TEST_F(PartitionedOutputBufferManagerTest, outOfOrderAcks) {
   bufferManager_->removeTask(taskId);
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, spill) {
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  const std::string taskId = "t0";
+  // With a 1 byte buffer all pages go to the spill file and the producer is
+  // never blocked.
+  initializeTask(
+      taskId,
+      rowType,
+      2,
+      1,
+      {{core::QueryConfig::kSpillEnabled, "true"},
+       {core::QueryConfig::kPartitionedOutputSpillEnabled, "true"},
+       {core::QueryConfig::kMaxPartitionedOutputBufferSize, "1"}},
+      spillDirectory->path);
+
+  std::vector<std::string> expected;
+  for (int i = 0; i < 10; ++i) {
+    auto page = makeSerializedPage(rowType, 100);
+    expected.push_back(page->getIOBuf()->moveToFbString().toStdString());
+    ContinueFuture future;
+    ASSERT_EQ(
+        bufferManager_->enqueue(taskId, i % 2, std::move(page), &future),
+        BlockingReason::kNotBlocked);
+  }
+  const auto spillPath = spillDirectory->path + "/partitioned_output";
+  auto fs = filesystems::getFileSystem(spillPath, nullptr);
+  ASSERT_TRUE(fs->exists(spillPath));
+  ASSERT_NE(
+      bufferManager_->toString().find("spilled pages=10"), std::string::npos);
+
+  // The end marker follows the spilled pages.
+  noMoreData(taskId);
+
+  // Each destination reads back its pages in order, then the end marker.
+  for (int destination = 0; destination < 2; ++destination) {
+    for (int64_t sequence = 0; sequence < 5; ++sequence) {
+      bool received = false;
+      ASSERT_TRUE(bufferManager_->getData(
+          taskId,
+          destination,
+          1,
+          sequence,
+          [&](std::vector<std::unique_ptr<folly::IOBuf>> pages,
+              int64_t inSequence) {
+            ASSERT_EQ(pages.size(), 1);
+            ASSERT_TRUE(pages[0] != nullptr);
+            EXPECT_EQ(inSequence, sequence);
+            EXPECT_EQ(
+                pages[0]->moveToFbString().toStdString(),
+                expected[sequence * 2 + destination]);
+            received = true;
+          }));
+      EXPECT_TRUE(received);
+    }
+    fetchEndMarker(taskId, destination, 5);
+  }
+  EXPECT_TRUE(bufferManager_->isFinished(taskId));
+  bufferManager_->removeTask(taskId);
+  EXPECT_FALSE(fs->exists(spillPath));
+}
+
+TEST_F(PartitionedOutputBufferManagerTest, spillWithoutSpillDirectory) {
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  const std::string taskId = "t0";
+  // Spilling is enabled but the task has no spill directory, so a full
+  // buffer blocks the producer instead of spilling. A page of 100 rows is
+  // larger than the 1000 byte buffer.
+  auto task = initializeTask(
+      taskId,
+      rowType,
+      2,
+      1,
+      {{core::QueryConfig::kSpillEnabled, "true"},
+       {core::QueryConfig::kPartitionedOutputSpillEnabled, "true"},
+       {core::QueryConfig::kMaxPartitionedOutputBufferSize, "1000"}});
+  ContinueFuture future;
+  ASSERT_EQ(
+      bufferManager_->enqueue(
+          taskId, 0, makeSerializedPage(rowType, 100), &future),
+      BlockingReason::kWaitForConsumer);
+  ASSERT_FALSE(future.isReady());
+  ASSERT_NE(
+      bufferManager_->toString().find("spilled pages=0"), std::string::npos);
+
+  // Consuming the page unblocks the producer.
+  fetchOneAndAck(taskId, 0, 0);
+  ASSERT_TRUE(future.isReady());
+
+  task->requestCancel();
+  bufferManager_->removeTask(taskId);
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, errorInQueue) {
   auto queue = std::make_shared<ExchangeQueue>(1 << 20);
   auto page = std::make_unique<SerializedPage>(folly::IOBuf::copyBuffer("", 0));
@@ -65,6 +65,30 @@ TEST_F(PlanNodeSerdeTest, aggregation) {
                   .planNode();
 
   testSerde(plan);
+
+  // Sorted and distinct inputs.
+  plan = PlanBuilder()
+             .values({data_})
+             .singleAggregation({"c0"}, {"array_agg(c1)", "count(c1)"})
+             .planNode();
+  auto aggregation =
+      std::dynamic_pointer_cast<const core::AggregationNode>(plan);
+  auto c1 = std::make_shared<core::FieldAccessTypedExpr>(INTEGER(), "c1");
+  plan = std::make_shared<core::AggregationNode>(
+      aggregation->id(),
+      aggregation->step(),
+      aggregation->groupingKeys(),
+      aggregation->preGroupedKeys(),
+      aggregation->aggregateNames(),
+      aggregation->aggregates(),
+      aggregation->aggregateMasks(),
+      std::vector<std::vector<core::FieldAccessTypedExprPtr>>{{c1}, {}},
+      std::vector<std::vector<core::SortOrder>>{{core::kDescNullsFirst}, {}},
+      std::vector<bool>{false, true},
+      aggregation->ignoreNullKeys(),
+      aggregation->sources()[0]);
+
+  testSerde(plan);
 }
 
 TEST_F(PlanNodeSerdeTest, assignUniqueId) {
@@ -98,6 +122,16 @@ TEST_F(PlanNodeSerdeTest, nestedLoopJoin) {
               {"t0", "u1", "t2", "t1"})
           .planNode();
   testSerde(plan);
+
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .nestedLoopJoin(
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "t0 < u0 AND t1 > u1",
+                 {"t0", "u1", "t2", "t1"},
+                 core::JoinType::kFull)
+             .planNode();
+  testSerde(plan);
 }
 
 TEST_F(PlanNodeSerdeTest, enforceSingleRow) {
@@ -246,6 +280,15 @@ TEST_F(PlanNodeSerdeTest, partitionedOutput) {
   testSerde(plan);
 }
 
+TEST_F(PlanNodeSerdeTest, shuffleWrite) {
+  auto plan =
+      PlanBuilder().values({data_}).shuffleWrite({"c0"}, 50, "/tmp").planNode();
+  testSerde(plan);
+
+  plan = PlanBuilder().values({data_}).shuffleWrite({}, 1, "/tmp").planNode();
+  testSerde(plan);
+}
+
 TEST_F(PlanNodeSerdeTest, project) {
   auto plan = PlanBuilder()
                   .values({data_})
@@ -315,6 +358,20 @@ TEST_F(PlanNodeSerdeTest, topN) {
   testSerde(plan);
 }
 
+TEST_F(PlanNodeSerdeTest, topNRowNumber) {
+  auto plan = PlanBuilder()
+                  .values({data_})
+                  .topNRowNumber({"c0"}, {"c1 DESC NULLS FIRST"}, 10, true)
+                  .planNode();
+  testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRowNumber({}, {"c1", "c0 DESC"}, 5, false)
+             .planNode();
+  testSerde(plan);
+}
+
 TEST_F(PlanNodeSerdeTest, unnest) {
   auto data = makeRowVector({
       makeFlatVector<int64_t>({1, 2, 3}),
@@ -364,6 +421,13 @@ TEST_F(PlanNodeSerdeTest, window) {
              .planNode();
 
   testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .streamingWindow({"sum(c0) over (partition by c1 order by c2)"})
+             .planNode();
+
+  testSerde(plan);
 }
 
 } // namespace facebook::velox::exec::test
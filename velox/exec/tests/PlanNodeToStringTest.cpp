@@ -466,6 +466,27 @@ TEST_F(PlanNodeToStringTest, topN) {
       plan->toString(true, false));
 }
 
+TEST_F(PlanNodeToStringTest, topNRowNumber) {
+  auto plan = PlanBuilder()
+                  .values({data_})
+                  .topNRowNumber({"c0"}, {"c1 DESC"}, 10, true)
+                  .planNode();
+
+  ASSERT_EQ("-- TopNRowNumber\n", plan->toString());
+  ASSERT_EQ(
+      "-- TopNRowNumber[partition by [c0] order by [c1 DESC NULLS LAST] limit 10] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT, row_number:BIGINT\n",
+      plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRowNumber({}, {"c1"}, 5, false)
+             .planNode();
+
+  ASSERT_EQ(
+      "-- TopNRowNumber[partition by [] order by [c1 ASC NULLS LAST] limit 5] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
+      plan->toString(true, false));
+}
+
 TEST_F(PlanNodeToStringTest, enforceSingleRow) {
   auto plan = PlanBuilder().values({data_}).enforceSingleRow().planNode();
 
@@ -555,6 +576,18 @@ TEST_F(PlanNodeToStringTest, partitionedOutput) {
       plan->toString(true, false));
 }
 
+TEST_F(PlanNodeToStringTest, shuffleWrite) {
+  auto plan = PlanBuilder()
+                  .values({data_})
+                  .shuffleWrite({"c0"}, 4, "/tmp/shuffle")
+                  .planNode();
+
+  ASSERT_EQ("-- ShuffleWrite\n", plan->toString());
+  ASSERT_EQ(
+      "-- ShuffleWrite[HASH(c0) 4 /tmp/shuffle] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
+      plan->toString(true, false));
+}
+
 TEST_F(PlanNodeToStringTest, localMerge) {
   auto plan =
       PlanBuilder()
@@ -673,4 +706,15 @@ TEST_F(PlanNodeToStringTest, window) {
       "w0 := window1(ROW[\"c\"]) RANGE between CURRENT ROW and b FOLLOWING] "
       "-> a:VARCHAR, b:BIGINT, c:BIGINT, w0:BIGINT\n",
       plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .tableScan(ROW({"a", "b", "c"}, {VARCHAR(), BIGINT(), BIGINT()}))
+             .streamingWindow({"window1(c) over (partition by a order by b)"})
+             .planNode();
+  ASSERT_EQ("-- Window\n", plan->toString());
+  ASSERT_EQ(
+      "-- Window[STREAMING partition by [a] order by [b ASC NULLS LAST] "
+      "w0 := window1(ROW[\"c\"]) RANGE between UNBOUNDED PRECEDING and CURRENT ROW] "
+      "-> a:VARCHAR, b:BIGINT, c:BIGINT, w0:BIGINT\n",
+      plan->toString(true, false));
 }
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+class PrefixSortTest : public testing::Test, public VectorTestBase {
+ protected:
+  // Stores 'data' in a RowContainer with all columns as keys and checks that
+  // PrefixSort gives the same order as a stable sort with compareRows for
+  // each combination of 'flags'. Sorts on up to 'parallelism' threads of
+  // 'executor' if given.
+  void testSort(
+      const RowVectorPtr& data,
+      const std::vector<std::vector<CompareFlags>>& flags,
+      folly::Executor* executor = nullptr,
+      int32_t parallelism = 1) {
+    std::vector<TypePtr> keyTypes;
+    for (auto i = 0; i < data->childrenSize(); ++i) {
+      keyTypes.push_back(data->childAt(i)->type());
+    }
+    RowContainer container(keyTypes, pool());
+    SelectivityVector allRows(data->size());
+    std::vector<DecodedVector> decoded;
+    for (auto i = 0; i < data->childrenSize(); ++i) {
+      decoded.emplace_back(*data->childAt(i), allRows);
+    }
+    std::vector<char*> rows(data->size());
+    for (auto row = 0; row < data->size(); ++row) {
+      rows[row] = container.newRow();
+      for (auto i = 0; i < decoded.size(); ++i) {
+        container.store(decoded[i], row, rows[row], i);
+      }
+    }
+
+    for (const auto& compareFlags : flags) {
+      std::vector<char*> expected = rows;
+      std::stable_sort(
+          expected.begin(),
+          expected.end(),
+          [&](const char* left, const char* right) {
+            return container.compareRows(left, right, compareFlags) < 0;
+          });
+      std::vector<char*> actual = rows;
+      CpuWallTiming timing;
+      PrefixSort::sort(
+          container,
+          compareFlags,
+          folly::Range<char**>(actual.data(), actual.size()),
+          executor,
+          parallelism,
+          &timing);
+      ASSERT_EQ(expected, actual);
+      ASSERT_EQ(1, timing.count);
+    }
+  }
+
+  // Returns the flags for 'numKeys' keys for each combination of ascending
+  // and nulls first applied to all keys, and two mixed combinations.
+  static std::vector<std::vector<CompareFlags>> allFlags(int numKeys) {
+    std::vector<std::vector<CompareFlags>> flags;
+    for (auto nullsFirst : {true, false}) {
+      for (auto ascending : {true, false}) {
+        flags.push_back(std::vector<CompareFlags>(
+            numKeys, CompareFlags{nullsFirst, ascending}));
+      }
+    }
+    std::vector<CompareFlags> mixed;
+    std::vector<CompareFlags> reverseMixed;
+    for (auto i = 0; i < numKeys; ++i) {
+      mixed.push_back({i % 2 == 0, i % 3 != 0});
+      reverseMixed.push_back({i % 2 != 0, i % 3 == 0});
+    }
+    flags.push_back(mixed);
+    flags.push_back(reverseMixed);
+    return flags;
+  }
+};
+
+TEST_F(PrefixSortTest, fixedWidth) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          1'000, [](auto row) { return (row % 17) - 8; }, nullEvery(11)),
+      makeFlatVector<int32_t>(
+          1'000,
+          [](auto row) {
+            return row % 5 == 0 ? std::numeric_limits<int32_t>::min()
+                                : (row * 7) % 13 - 6;
+          }),
+      makeFlatVector<bool>(
+          1'000, [](auto row) { return row % 3 == 0; }, nullEvery(7)),
+      makeFlatVector<int16_t>(1'000, [](auto row) { return row % 4 - 2; }),
+  });
+  testSort(data, allFlags(4));
+
+  // A single key that fits the prefix.
+  testSort(makeRowVector({data->childAt(1)}), allFlags(1));
+}
+
+TEST_F(PrefixSortTest, floatingPoint) {
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  const auto inf = std::numeric_limits<double>::infinity();
+  const std::vector<double> values = {
+      nan, -inf, inf, 0.0, -0.0, 1.5, -1.5, std::numeric_limits<double>::min()};
+  auto data = makeRowVector({
+      makeFlatVector<double>(
+          200,
+          [&](auto row) { return values[row % values.size()]; },
+          nullEvery(9)),
+      makeFlatVector<float>(
+          200, [&](auto row) { return values[(row / 3) % values.size()]; }),
+      makeFlatVector<int64_t>(200, [](auto row) { return row % 3; }),
+  });
+  testSort(data, allFlags(3));
+}
+
+TEST_F(PrefixSortTest, strings) {
+  // Strings that share prefixes longer than the 8 bytes in the prefix, and
+  // strings that are prefixes of each other or have trailing zero bytes.
+  auto data = makeRowVector({
+      makeFlatVector<StringView>(
+          1'000,
+          [](auto row) {
+            switch (row % 5) {
+              case 0:
+                return StringView(fmt::format("common prefix {}", row % 13));
+              case 1:
+                return StringView(std::string(row % 10, 'a'));
+              case 2:
+                return StringView(std::string("ab\0\0", 2 + row % 3));
+              case 3:
+                return StringView("");
+              default:
+                return StringView(fmt::format("{}", row % 23));
+            }
+          },
+          nullEvery(13)),
+      makeFlatVector<Timestamp>(
+          1'000, [](auto row) { return Timestamp(row % 3 - 1, row % 7); }),
+      makeFlatVector<StringView>(
+          1'000,
+          [](auto row) {
+            return StringView(fmt::format("some longer value {}", row % 11));
+          }),
+  });
+  testSort(data, allFlags(3));
+
+  // Timestamp first, so that the prefix ends with the first string key.
+  testSort(
+      makeRowVector({data->childAt(1), data->childAt(0), data->childAt(2)}),
+      allFlags(3));
+}
+
+TEST_F(PrefixSortTest, complexTypeKey) {
+  // A leading key that cannot be encoded falls back to compareRows.
+  auto data = makeRowVector({
+      makeArrayVector<int64_t>(
+          100,
+          [](auto row) { return row % 4; },
+          [](auto row, auto index) { return (row + index) % 3; }),
+      makeFlatVector<int64_t>(100, [](auto row) { return row % 7; }),
+  });
+  testSort(data, allFlags(2));
+}
+
+TEST_F(PrefixSortTest, parallel) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          100'000,
+          [](auto row) { return (row * 7919) % 1'000; },
+          nullEvery(97)),
+      makeFlatVector<StringView>(100'000, [](auto row) {
+        return StringView(fmt::format("value {}", (row * 31) % 557));
+      }),
+  });
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  // More runs than threads, an odd number of runs and no parallel runs.
+  testSort(data, allFlags(2), executor.get(), 8);
+  testSort(data, allFlags(2), executor.get(), 3);
+  testSort(data, allFlags(2), executor.get(), 1);
+
+  // Fewer rows than in two runs.
+  testSort(
+      makeRowVector({data->childAt(0)->slice(0, 15'000)}),
+      allFlags(1),
+      executor.get(),
+      8);
+}
+
+TEST_F(PrefixSortTest, encodePrefixes) {
+  auto data = makeRowVector({
+      makeFlatVector<int16_t>(
+          200, [](auto row) { return row % 7 - 3; }, nullEvery(11)),
+      wrapInDictionary(
+          makeIndicesInReverse(200),
+          makeFlatVector<StringView>(200, [](auto row) {
+            return StringView(fmt::format("{}", row % 13));
+          })),
+      makeFlatVector<int64_t>(200, [](auto row) { return row % 3; }),
+  });
+  std::vector<BaseVector*> keys;
+  for (const auto& child : data->children()) {
+    keys.push_back(child.get());
+  }
+  for (const auto& compareFlags : allFlags(3)) {
+    std::vector<uint64_t> prefixes;
+    ASSERT_TRUE(PrefixSort::encodePrefixes(
+        keys, compareFlags, data->size(), prefixes));
+    ASSERT_EQ(data->size(), prefixes.size());
+    auto compare = [&](auto left, auto right) {
+      for (auto i = 0; i < keys.size(); ++i) {
+        if (auto result =
+                keys[i]->compare(keys[i], left, right, compareFlags[i])
+                    .value()) {
+          return result;
+        }
+      }
+      return 0;
+    };
+    for (auto left = 0; left < data->size(); ++left) {
+      for (auto right = 0; right < data->size(); ++right) {
+        if (prefixes[left] < prefixes[right]) {
+          ASSERT_LT(compare(left, right), 0) << left << " " << right;
+        }
+      }
+    }
+  }
+
+  // A leading key that cannot be encoded.
+  auto arrays = makeArrayVector<int64_t>(
+      10, [](auto row) { return row % 4; }, [](auto row) { return row; });
+  std::vector<uint64_t> prefixes;
+  EXPECT_FALSE(PrefixSort::encodePrefixes(
+      {arrays.get()}, {CompareFlags{}}, arrays->size(), prefixes));
+  EXPECT_TRUE(prefixes.empty());
+}
+
+TEST_F(PrefixSortTest, prefixSize) {
+  bool complete;
+  EXPECT_EQ(16, PrefixSort::prefixSize({BIGINT()}, complete));
+  EXPECT_TRUE(complete);
+  EXPECT_EQ(8, PrefixSort::prefixSize({INTEGER(), SMALLINT()}, complete));
+  EXPECT_TRUE(complete);
+  EXPECT_EQ(16, PrefixSort::prefixSize({VARCHAR(), BIGINT()}, complete));
+  EXPECT_FALSE(complete);
+  EXPECT_EQ(0, PrefixSort::prefixSize({ARRAY(BIGINT())}, complete));
+  EXPECT_FALSE(complete);
+  EXPECT_EQ(
+      32,
+      PrefixSort::prefixSize(
+          {BIGINT(), BIGINT(), BIGINT(), BIGINT()}, complete));
+  EXPECT_FALSE(complete);
+}
+
+} // namespace
@@ -20,6 +20,7 @@
 #include "velox/common/file/FileSystems.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/RowComparator.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/exec/tests/utils/RowContainerTestBase.h"
 #include "velox/serializers/PrestoSerializer.h"
@@ -659,6 +660,128 @@ TEST_F(RowContainerTest, erase) {
   data->checkConsistency();
 }
 
+TEST_F(RowContainerTest, reserveRows) {
+  constexpr int32_t kNumRows = 10'000;
+  // Not a join build, as in aggregation.
+  auto data = makeRowContainer({BIGINT()}, {VARCHAR()}, false);
+  auto isNullAt = [&](const char* row, int32_t i) {
+    auto column = data->columnAt(i);
+    return RowContainer::isNullAt(row, column.nullByte(), column.nullMask());
+  };
+
+  // Reserved rows are not listed until returned by newRow().
+  data->reserveRows(kNumRows);
+  EXPECT_EQ(0, data->numRows());
+  EXPECT_LE(kNumRows, data->freeSpace().first);
+  std::vector<char*> rows(kNumRows);
+  RowContainerIterator iter;
+  EXPECT_EQ(0, data->listRows(&iter, kNumRows, rows.data()));
+  data->checkConsistency();
+
+  std::vector<char*> newRows;
+  for (auto i = 0; i < kNumRows / 2; ++i) {
+    newRows.push_back(data->newRow());
+    EXPECT_FALSE(isNullAt(newRows.back(), 0));
+    EXPECT_FALSE(isNullAt(newRows.back(), 1));
+    EXPECT_EQ(0, data->rowSize(newRows.back()) - data->fixedRowSize());
+  }
+  // Tops up the reservation past the rows left and uses all of it.
+  data->reserveRows(kNumRows);
+  for (auto i = kNumRows / 2; i < kNumRows * 3 / 2; ++i) {
+    newRows.push_back(data->newRow());
+  }
+  // Past the reservation, rows are allocated one at a time.
+  newRows.push_back(data->newRow());
+  EXPECT_EQ(newRows.size(), data->numRows());
+  data->checkConsistency();
+
+  rows.resize(newRows.size());
+  iter.reset();
+  EXPECT_EQ(
+      newRows.size(), data->listRows(&iter, newRows.size(), rows.data()));
+  std::sort(rows.begin(), rows.end());
+  std::sort(newRows.begin(), newRows.end());
+  EXPECT_EQ(newRows, rows);
+
+  data->clear();
+  EXPECT_EQ(0, data->freeSpace().first);
+  data->checkConsistency();
+}
+
+TEST_F(RowContainerTest, columnar) {
+  constexpr int32_t kNumRows = 1'000;
+  auto batch = makeDataset(
+      ROW({
+          {"long_val", BIGINT()},
+          {"small_val", SMALLINT()},
+          {"string_val", VARCHAR()},
+          {"array_val", ARRAY(INTEGER())},
+          {"double_val", DOUBLE()},
+      }),
+      kNumRows,
+      [](RowVectorPtr /*rows*/) {});
+  const auto& types = batch->type()->as<TypeKind::ROW>().children();
+  std::vector<TypePtr> keys(types.begin(), types.begin() + 2);
+  std::vector<TypePtr> dependents(types.begin() + 2, types.end());
+  auto data =
+      std::make_unique<RowContainer>(keys, dependents, pool_.get(), true);
+  ASSERT_TRUE(data->isColumnar());
+  // 5 columns, flags and row size in 16 byte slots.
+  EXPECT_EQ(7 * 16, data->fixedRowSize());
+
+  std::vector<char*> rows;
+  for (auto i = 0; i < kNumRows; ++i) {
+    rows.push_back(data->newRow());
+  }
+  // Consecutive rows are one slot apart within a block.
+  EXPECT_EQ(16, rows[1] - rows[0]);
+  SelectivityVector allRows(kNumRows);
+  for (auto column = 0; column < batch->childrenSize(); ++column) {
+    DecodedVector decoded(*batch->childAt(column), allRows);
+    for (auto i = 0; i < kNumRows; ++i) {
+      data->store(decoded, i, rows[i], column);
+    }
+  }
+  checkSizes(rows, *data);
+  data->checkConsistency();
+
+  std::vector<char*> listed(kNumRows);
+  RowContainerIterator iter;
+  EXPECT_EQ(kNumRows, data->listRows(&iter, kNumRows, listed.data()));
+  EXPECT_EQ(0, data->listRows(&iter, kNumRows, listed.data()));
+  EXPECT_EQ(rows, listed);
+  for (auto column = 0; column < batch->childrenSize(); ++column) {
+    testExtractColumn(*data, rows, column, batch->childAt(column));
+  }
+
+  // Erased rows are skipped by listRows() and reused by newRow().
+  std::vector<char*> erased;
+  std::vector<char*> remaining;
+  for (auto i = 0; i < kNumRows; ++i) {
+    (i % 3 == 0 ? erased : remaining).push_back(rows[i]);
+  }
+  data->eraseRows(folly::Range<char**>(erased.data(), erased.size()));
+  data->checkConsistency();
+  iter.reset();
+  listed.resize(remaining.size());
+  EXPECT_EQ(
+      remaining.size(),
+      data->listRows(&iter, remaining.size(), listed.data()));
+  EXPECT_EQ(remaining, listed);
+  std::unordered_set<char*> erasedSet(erased.begin(), erased.end());
+  for (auto i = 0; i < erased.size(); ++i) {
+    EXPECT_EQ(1, erasedSet.count(data->newRow()));
+  }
+  data->checkConsistency();
+
+  // A row-wise layout is used if columnar storage is not requested or if the
+  // flags do not fit in a slot.
+  EXPECT_FALSE(RowContainer(keys, dependents, pool_.get()).isColumnar());
+  std::vector<TypePtr> manyTypes(200, BIGINT());
+  EXPECT_FALSE(
+      RowContainer(manyTypes, dependents, pool_.get(), true).isColumnar());
+}
+
 TEST_F(RowContainerTest, initialNulls) {
   std::vector<TypePtr> keys{INTEGER()};
   std::vector<TypePtr> dependent{INTEGER()};
@@ -1036,3 +1159,90 @@ TEST_F(RowContainerTest, probedFlag) {
           {true, true, true, true, std::nullopt, true}),
       result);
 }
+
+TEST_F(RowContainerTest, rowComparator) {
+  constexpr int32_t kNumRows = 100;
+  // Few distinct values, so that the rows tie on some keys.
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(
+          kNumRows, [](auto row) { return row % 3; }, nullEvery(5)),
+      makeFlatVector<StringView>(
+          kNumRows,
+          [](auto row) { return row % 4 == 0 ? "a" : "abcdefghijklmnop"; },
+          nullEvery(7)),
+      makeArrayVector<int32_t>(
+          kNumRows,
+          [](auto row) { return row % 3; },
+          [](auto row, auto index) { return (row + index) % 2; },
+          nullEvery(11)),
+      makeFlatVector<double>(
+          kNumRows, [](auto row) { return row % 2 * 0.5; }, nullEvery(13)),
+  });
+  const auto& keyTypes = input->type()->asRow().children();
+  // NOTE: set 'isJoinBuild' to false to enable nullable keys.
+  auto data = makeRowContainer(keyTypes, {}, false);
+  SelectivityVector allRows(kNumRows);
+  std::vector<DecodedVector> decoded(keyTypes.size());
+  std::vector<char*> rows(kNumRows);
+  for (auto row = 0; row < kNumRows; ++row) {
+    rows[row] = data->newRow();
+  }
+  for (auto column = 0; column < keyTypes.size(); ++column) {
+    decoded[column].decode(*input->childAt(column), allRows);
+    for (auto row = 0; row < kNumRows; ++row) {
+      data->store(decoded[column], row, rows[row], column);
+    }
+  }
+
+  auto sign = [](int32_t result) { return result < 0 ? -1 : result > 0; };
+  for (auto flagsMask = 0; flagsMask < 16; ++flagsMask) {
+    SCOPED_TRACE(fmt::format("flagsMask: {}", flagsMask));
+    // Each key gets a different combination of flags.
+    std::vector<CompareFlags> flags;
+    for (auto i = 0; i < keyTypes.size(); ++i) {
+      const auto keyMask = flagsMask >> i | flagsMask << (4 - i);
+      flags.push_back({(keyMask & 1) != 0, (keyMask & 2) != 0, false});
+    }
+    RowComparator comparator(data.get(), flags);
+    ASSERT_EQ(comparator.numColumns(), keyTypes.size());
+    for (auto left = 0; left < kNumRows; ++left) {
+      for (auto right = 0; right < kNumRows; ++right) {
+        ASSERT_EQ(
+            sign(comparator.compare(rows[left], rows[right])),
+            sign(data->compareRows(rows[left], rows[right], flags)));
+        ASSERT_EQ(
+            comparator(rows[left], rows[right]),
+            data->compareRows(rows[left], rows[right], flags) < 0);
+        for (auto i = 0; i < keyTypes.size(); ++i) {
+          ASSERT_EQ(
+              sign(comparator.compare(rows[left], rows[right], i)),
+              sign(data->compare(rows[left], rows[right], i, flags[i])));
+          ASSERT_EQ(
+              sign(comparator.compare(i, rows[left], decoded[i], right)),
+              sign(data->compare(
+                  rows[left], data->columnAt(i), decoded[i], right, flags[i])));
+          ASSERT_EQ(
+              comparator.equals<true>(i, rows[left], decoded[i], right),
+              data->compare(
+                  rows[left], data->columnAt(i), decoded[i], right) == 0);
+        }
+      }
+    }
+  }
+
+  // A comparator on a subset of the columns in another order.
+  RowComparator comparator(
+      data.get(), {3, 1}, {CompareFlags{false, false}, CompareFlags{}});
+  ASSERT_EQ(comparator.numColumns(), 2);
+  for (auto left = 0; left < kNumRows; ++left) {
+    for (auto right = 0; right < kNumRows; ++right) {
+      auto expected =
+          data->compare(rows[left], rows[right], 3, CompareFlags{false, false});
+      if (expected == 0) {
+        expected = data->compare(rows[left], rows[right], 1);
+      }
+      ASSERT_EQ(
+          sign(comparator.compare(rows[left], rows[right])), sign(expected));
+    }
+  }
+}
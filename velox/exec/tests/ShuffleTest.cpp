@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/ShuffleRead.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class ShuffleTest : public OperatorTestBase {
+ protected:
+  static void SetUpTestCase() {
+    OperatorTestBase::SetUpTestCase();
+    ExchangeSource::registerFactory(ShuffleReadExchangeSource::create);
+  }
+
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    filesystems::registerLocalFileSystem();
+  }
+
+  // Runs a ShuffleWrite of 'input' with 'numDrivers' drivers and returns the
+  // producer task id.
+  std::string write(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& keys,
+      int numPartitions,
+      int numDrivers,
+      const std::string& shuffleDirectory) {
+    CursorParameters params;
+    params.planNode = PlanBuilder()
+                          .values(input, true)
+                          .shuffleWrite(keys, numPartitions, shuffleDirectory)
+                          .planNode();
+    params.maxDrivers = numDrivers;
+    params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    // Use a small buffer so that each driver writes several runs.
+    params.queryCtx->setConfigOverridesUnsafe(
+        {{core::QueryConfig::kMaxPartitionedOutputBufferSize, "2048"}});
+    auto [cursor, results] = readCursor(params, [](Task*) {});
+    EXPECT_TRUE(results.empty());
+    EXPECT_TRUE(waitForTaskCompletion(cursor->task().get()));
+    return cursor->task()->taskId();
+  }
+
+  // Reads 'partition' of the shuffle at 'path' with an Exchange.
+  std::vector<RowVectorPtr>
+  read(const std::string& path, const RowTypePtr& rowType, int partition) {
+    core::PlanNodeId exchangeId;
+    CursorParameters params;
+    params.planNode = PlanBuilder()
+                          .exchange(rowType)
+                          .capturePlanNodeId(exchangeId)
+                          .planNode();
+    params.destination = partition;
+    auto [cursor, results] = readCursor(params, [&](Task* task) {
+      task->addSplit(
+          exchangeId,
+          Split(std::make_shared<RemoteConnectorSplit>(
+              fmt::format("{}{}", ShuffleReadExchangeSource::kScheme, path))));
+      task->noMoreSplits(exchangeId);
+    });
+    return results;
+  }
+};
+
+TEST_F(ShuffleTest, writeAndRead) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 10; ++i) {
+    input.push_back(makeRowVector({
+        makeFlatVector<int64_t>(100, [&](auto row) { return i * 100 + row; }),
+        makeFlatVector<StringView>(
+            100,
+            [](auto row) {
+              return StringView(fmt::format("string value {}", row % 17));
+            }),
+    }));
+  }
+  auto rowType = asRowType(input[0]->type());
+  auto shuffleDirectory = TempDirectoryPath::create();
+  const int kNumPartitions = 5;
+  const int kNumDrivers = 3;
+  const auto taskId =
+      write(input, {"c0"}, kNumPartitions, kNumDrivers, shuffleDirectory->path);
+  const auto path = fmt::format("{}/{}", shuffleDirectory->path, taskId);
+
+  auto fs = filesystems::getFileSystem(path, nullptr);
+  ASSERT_TRUE(fs->exists(ShuffleIndex::indexPath(path)));
+  for (auto driver = 0; driver < kNumDrivers; ++driver) {
+    ASSERT_TRUE(fs->exists(ShuffleIndex::dataPath(path, driver)));
+  }
+
+  // Each driver of the Values node produces all of 'input'.
+  std::vector<RowVectorPtr> expected;
+  for (auto i = 0; i < kNumDrivers; ++i) {
+    expected.insert(expected.end(), input.begin(), input.end());
+  }
+
+  // The partitions have disjoint keys and together they have all rows. A
+  // partition can be read any number of times.
+  std::vector<RowVectorPtr> all;
+  std::unordered_map<int64_t, int> keyPartitions;
+  for (auto partition = 0; partition < kNumPartitions; ++partition) {
+    auto results = read(path, rowType, partition);
+    ASSERT_FALSE(results.empty());
+    for (const auto& result : results) {
+      auto keys = result->childAt(0)->asFlatVector<int64_t>();
+      for (auto row = 0; row < result->size(); ++row) {
+        auto it = keyPartitions.emplace(keys->valueAt(row), partition).first;
+        ASSERT_EQ(it->second, partition);
+      }
+    }
+    ASSERT_TRUE(assertEqualResults(results, read(path, rowType, partition)));
+    all.insert(all.end(), results.begin(), results.end());
+  }
+  ASSERT_TRUE(assertEqualResults(expected, all));
+}
+
+TEST_F(ShuffleTest, singlePartition) {
+  auto input = makeRowVector({makeFlatVector<int32_t>(1'000, folly::identity)});
+  auto shuffleDirectory = TempDirectoryPath::create();
+  const auto taskId = write({input}, {}, 1, 1, shuffleDirectory->path);
+  auto results = read(
+      fmt::format("{}/{}", shuffleDirectory->path, taskId),
+      asRowType(input->type()),
+      0);
+  ASSERT_TRUE(assertEqualResults({input}, results));
+}
+
+TEST_F(ShuffleTest, index) {
+  ShuffleIndex index;
+  index.files = {".0.data", ".1.data"};
+  index.partitions = {{{0, 0, 100}, {1, 0, 50}}, {}, {{1, 50, 10}}};
+  auto serialized = index.serialize();
+  auto copy = ShuffleIndex::deserialize(serialized);
+  ASSERT_EQ(copy.files, index.files);
+  ASSERT_EQ(copy.partitions.size(), 3);
+  ASSERT_EQ(copy.partitions[0].size(), 2);
+  ASSERT_EQ(copy.partitions[0][1].file, 1);
+  ASSERT_EQ(copy.partitions[0][1].size, 50);
+  ASSERT_TRUE(copy.partitions[1].empty());
+  ASSERT_EQ(copy.partitions[2][0].offset, 50);
+
+  VELOX_ASSERT_THROW(
+      ShuffleIndex::deserialize(
+          std::string_view(serialized.data(), serialized.size() - 1)),
+      "Truncated shuffle index");
+}
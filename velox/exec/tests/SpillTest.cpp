@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <memory>
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
@@ -47,6 +48,32 @@ class TestRuntimeStatWriter : public BaseRuntimeStatWriter {
  private:
   std::unordered_map<std::string, RuntimeMetric>& stats_;
 };
+
+// In-memory read file which reports native async read support and counts the
+// async reads issued against it.
+class AsyncInMemoryReadFile : public InMemoryReadFile {
+ public:
+  explicit AsyncInMemoryReadFile(std::string file)
+      : InMemoryReadFile(std::move(file)) {}
+
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
+    ++numAsyncReads_;
+    return InMemoryReadFile::preadvAsync(offset, buffers);
+  }
+
+  bool hasPreadvAsync() const override {
+    return true;
+  }
+
+  int32_t numAsyncReads() const {
+    return numAsyncReads_;
+  }
+
+ private:
+  mutable int32_t numAsyncReads_{0};
+};
 } // namespace
 
 class SpillTest : public testing::Test,
@@ -144,8 +171,17 @@ class SpillTest : public testing::Test,
     // the batch number of the vector in the partition. When read back, both
     // partitions produce an ascending sequence of integers without gaps.
     state_ = std::make_unique<SpillState>(
-        spillPath_, numPartitions, 1, compareFlags, targetFileSize, *pool());
+        spillPath_,
+        numPartitions,
+        1,
+        compareFlags,
+        targetFileSize,
+        *pool(),
+        compressionKind_,
+        directIo_);
     EXPECT_EQ(targetFileSize, state_->targetFileSize());
+    EXPECT_EQ(compressionKind_, state_->compressionKind());
+    EXPECT_EQ(directIo_, state_->directIo());
     EXPECT_EQ(numPartitions, state_->maxPartitions());
     EXPECT_EQ(0, state_->spilledPartitions());
     EXPECT_TRUE(state_->spilledPartitionSet().empty());
@@ -217,6 +253,11 @@ class SpillTest : public testing::Test,
     EXPECT_EQ(expectedFiles, state_->spilledFiles());
     EXPECT_LT(
         numPartitions * numBatches * sizeof(int64_t), state_->spilledBytes());
+    if (compressionKind_ == common::CompressionKind_NONE) {
+      EXPECT_EQ(state_->spilledBytes(), state_->spilledUncompressedBytes());
+    } else if (compressionKind_ == common::CompressionKind_ZSTD) {
+      EXPECT_LT(state_->spilledBytes(), state_->spilledUncompressedBytes());
+    }
   }
 
   // 'numDuplicates' specifies the number of duplicates generated for each
@@ -305,6 +346,12 @@ class SpillTest : public testing::Test,
     }
     // Verify stats.
     ASSERT_EQ(stats_["spillFileSize"].count, spilledFiles.size());
+    if (compressionKind_ != common::CompressionKind_NONE) {
+      ASSERT_EQ(
+          stats_["spillUncompressedFileSize"].count, spilledFiles.size());
+    } else {
+      ASSERT_EQ(stats_.count("spillUncompressedFileSize"), 0);
+    }
   }
 
   folly::Random::DefaultGenerator rng_;
@@ -313,6 +360,8 @@ class SpillTest : public testing::Test,
   std::vector<std::optional<int64_t>> values_;
   std::vector<std::vector<RowVectorPtr>> batchesByPartition_;
   std::string spillPath_;
+  common::CompressionKind compressionKind_{common::CompressionKind_NONE};
+  bool directIo_{false};
   std::unique_ptr<SpillState> state_;
   std::unordered_map<std::string, RuntimeMetric> stats_;
   std::unique_ptr<TestRuntimeStatWriter> statWriter_;
@@ -337,6 +386,29 @@ TEST_F(SpillTest, spillState) {
   spillStateTest(kGB, 2, 10, 10, {}, 10);
 }
 
+TEST_F(SpillTest, spillStateWithCompression) {
+  for (const auto kind :
+       {common::CompressionKind_ZLIB,
+        common::CompressionKind_SNAPPY,
+        common::CompressionKind_ZSTD,
+        common::CompressionKind_LZ4}) {
+    SCOPED_TRACE(common::compressionKindToString(kind));
+    compressionKind_ = kind;
+    spillStateTest(kGB, 2, 10, 1, {CompareFlags{true, true}}, 10);
+    spillStateTest(kGB, 2, 10, 10, {CompareFlags{false, false}}, 10);
+    spillStateTest(1, 2, 10, 1, {CompareFlags{true, false}}, 10 * 2);
+    spillStateTest(1, 2, 10, 10, {}, 10 * 2);
+  }
+}
+
+TEST_F(SpillTest, spillStateWithDirectIo) {
+  directIo_ = true;
+  spillStateTest(kGB, 2, 10, 1, {CompareFlags{true, true}}, 10);
+  spillStateTest(1, 2, 10, 10, {}, 10 * 2);
+  compressionKind_ = common::CompressionKind_ZSTD;
+  spillStateTest(kGB, 2, 10, 10, {CompareFlags{false, false}}, 10);
+}
+
 TEST_F(SpillTest, spillTimestamp) {
   // Verify that timestamp type retains it nanosecond precision when spilled and
   // read back.
@@ -590,3 +662,155 @@ TEST_F(SpillTest, nonExistSpillFileOnDeletion) {
   tempDir_.reset();
   state_.reset();
 }
+
+TEST_F(SpillTest, spillInputPrefetch) {
+  constexpr int32_t kFileSize = 10'000;
+  std::string content(kFileSize, '\0');
+  for (int32_t i = 0; i < kFileSize; ++i) {
+    content[i] = static_cast<char>(i % 127);
+  }
+  for (const bool asyncFile : {false, true}) {
+    SCOPED_TRACE(fmt::format("asyncFile: {}", asyncFile));
+    std::unique_ptr<ReadFile> file;
+    AsyncInMemoryReadFile* asyncFilePtr = nullptr;
+    if (asyncFile) {
+      auto asyncReadFile = std::make_unique<AsyncInMemoryReadFile>(content);
+      asyncFilePtr = asyncReadFile.get();
+      file = std::move(asyncReadFile);
+    } else {
+      file = std::make_unique<InMemoryReadFile>(content);
+    }
+    auto buffer = AlignedBuffer::allocate<char>(1'000, pool());
+    auto prefetchBuffer = AlignedBuffer::allocate<char>(1'000, pool());
+    const auto bufferSize = buffer->capacity();
+    SpillInput input(
+        std::move(file), std::move(buffer), std::move(prefetchBuffer));
+    ASSERT_EQ(input.prefetchEnabled(), asyncFile);
+    std::string result(kFileSize, '\0');
+    // Read in chunks which straddle the buffer boundaries.
+    constexpr int32_t kChunkSize = 333;
+    for (int32_t offset = 0; offset < kFileSize; offset += kChunkSize) {
+      ASSERT_FALSE(input.atEnd());
+      input.readBytes(
+          result.data() + offset, std::min(kChunkSize, kFileSize - offset));
+    }
+    ASSERT_TRUE(input.atEnd());
+    ASSERT_EQ(result, content);
+    if (asyncFile) {
+      // All but the first buffer are read ahead.
+      ASSERT_EQ(
+          asyncFilePtr->numAsyncReads(),
+          bits::roundUp(kFileSize, bufferSize) / bufferSize - 1);
+    }
+  }
+}
+
+TEST_F(SpillTest, spillInputAlignment) {
+  constexpr int32_t kAlignment = 4096;
+  constexpr int32_t kFileSize = 10 * kAlignment + 123;
+  std::string content(kFileSize, '\0');
+  for (int32_t i = 0; i < kFileSize; ++i) {
+    content[i] = static_cast<char>(i % 127);
+  }
+  for (const bool asyncFile : {false, true}) {
+    SCOPED_TRACE(fmt::format("asyncFile: {}", asyncFile));
+    std::unique_ptr<ReadFile> file;
+    AsyncInMemoryReadFile* asyncFilePtr = nullptr;
+    if (asyncFile) {
+      auto asyncReadFile = std::make_unique<AsyncInMemoryReadFile>(content);
+      asyncFilePtr = asyncReadFile.get();
+      file = std::move(asyncReadFile);
+    } else {
+      file = std::make_unique<InMemoryReadFile>(content);
+    }
+    // Each buffer reads 3 aligned blocks at an aligned address.
+    auto buffer = AlignedBuffer::allocate<char>(4 * kAlignment, pool());
+    auto prefetchBuffer = AlignedBuffer::allocate<char>(4 * kAlignment, pool());
+    SpillInput input(
+        std::move(file),
+        std::move(buffer),
+        std::move(prefetchBuffer),
+        kAlignment);
+    std::string result(kFileSize, '\0');
+    constexpr int32_t kChunkSize = 1'000;
+    for (int32_t offset = 0; offset < kFileSize; offset += kChunkSize) {
+      ASSERT_FALSE(input.atEnd());
+      input.readBytes(
+          result.data() + offset, std::min(kChunkSize, kFileSize - offset));
+    }
+    ASSERT_TRUE(input.atEnd());
+    ASSERT_EQ(result, content);
+    if (asyncFile) {
+      ASSERT_EQ(asyncFilePtr->numAsyncReads(), 3);
+    }
+  }
+}
+
+TEST_F(SpillTest, spillStateWithOverflowTier) {
+  auto localDir = TempDirectoryPath::create();
+  auto overflowDir = TempDirectoryPath::create();
+  // The first file fills the local quota, so the next files overflow.
+  auto tiers =
+      std::make_shared<SpillTiers>(localDir->path, overflowDir->path, 1);
+  // A target file size of 1 starts a new file on each batch.
+  SpillState state(
+      localDir->path + "/test",
+      1,
+      0,
+      {},
+      1,
+      *pool(),
+      common::CompressionKind_NONE,
+      /*directIo=*/true,
+      tiers);
+  constexpr int32_t kNumBatches = 4;
+  constexpr int32_t kNumRowsPerBatch = 100;
+  state.setPartitionSpilled(0);
+  for (auto i = 0; i < kNumBatches; ++i) {
+    ASSERT_EQ(
+        tiers->nextFileTier(),
+        i == 0 ? SpillTiers::Tier::kLocal : SpillTiers::Tier::kOverflow);
+    state.appendToPartition(
+        0,
+        makeRowVector({makeFlatVector<int64_t>(
+            kNumRowsPerBatch, [&](auto row) { return i * 1000 + row; })}));
+  }
+  state.finishWrite(0);
+
+  const auto paths = state.testingSpilledFilePaths();
+  ASSERT_EQ(paths.size(), kNumBatches);
+  for (auto i = 0; i < kNumBatches; ++i) {
+    ASSERT_EQ(paths[i].find(i == 0 ? localDir->path : overflowDir->path), 0)
+        << paths[i];
+  }
+  ASSERT_GT(tiers->localBytes(), 0);
+  ASSERT_GT(tiers->overflowBytes(), 0);
+  ASSERT_EQ(
+      tiers->localBytes() + tiers->overflowBytes(), state.spilledBytes());
+
+  auto files = state.files(0);
+  ASSERT_EQ(files.size(), kNumBatches);
+  ASSERT_EQ(stats_.at("spillLocalBytes").count, 1);
+  ASSERT_EQ(stats_.at("spillLocalBytes").sum, tiers->localBytes());
+  ASSERT_EQ(stats_.at("spillOverflowBytes").count, kNumBatches - 1);
+  ASSERT_EQ(stats_.at("spillOverflowBytes").sum, tiers->overflowBytes());
+  for (auto i = 0; i < kNumBatches; ++i) {
+    ASSERT_EQ(
+        files[i]->tier(),
+        i == 0 ? SpillTiers::Tier::kLocal : SpillTiers::Tier::kOverflow);
+    // Direct I/O is only used on the local tier.
+    ASSERT_EQ(files[i]->directIo(), i == 0);
+    auto stream = FileSpillBatchStream::create(std::move(files[i]));
+    RowVectorPtr batch;
+    ASSERT_TRUE(stream->nextBatch(batch));
+    ASSERT_EQ(batch->size(), kNumRowsPerBatch);
+    ASSERT_EQ(
+        batch->childAt(0)->asFlatVector<int64_t>()->valueAt(0), i * 1000);
+    ASSERT_FALSE(stream->nextBatch(batch));
+  }
+
+  VELOX_ASSERT_THROW(
+      tiers->path(SpillTiers::Tier::kOverflow, "/elsewhere/test"),
+      "is not under the spill directory");
+  ASSERT_EQ(SpillTiers::tierName(SpillTiers::Tier::kOverflow), "OVERFLOW");
+}
@@ -109,7 +109,12 @@ class SpillerTest : public exec::test::RowContainerTestBase {
       : param_(param),
         type_(param.type),
         executorPoolSize_(param.poolSize),
-        hashBits_(0, type_ == Spiller::Type::kOrderBy ? 0 : 2),
+        hashBits_(
+            0,
+            (type_ == Spiller::Type::kOrderBy ||
+             type_ == Spiller::Type::kWindow)
+                ? 0
+                : 2),
         numPartitions_(hashBits_.numPartitions()),
         statWriter_(std::make_unique<TestRuntimeStatWriter>(stats_)) {
     setThreadLocalRunTimeStatWriter(statWriter_.get());
@@ -178,6 +183,9 @@ class SpillerTest : public exec::test::RowContainerTestBase {
     if (makeError) {
       return;
     }
+    const auto spillWriteTiming = spiller_->stats().spillWriteTiming;
+    EXPECT_LT(0, spillWriteTiming.count);
+    EXPECT_LT(0, spillWriteTiming.wallNanos);
     // Verify the spilled file exist on file system.
     const auto numSpilledFiles = spiller_->spilledFiles();
     EXPECT_GT(numSpilledFiles, 0);
@@ -401,10 +409,13 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           targetFileSize,
           minSpillRunSize,
           *pool_,
-          executor());
-    } else if (type_ == Spiller::Type::kOrderBy) {
-      // We spill 'data' in one partition in type of kOrderBy, otherwise in 4
-      // partitions.
+          executor(),
+          common::CompressionKind_NONE,
+          maxSpillWriteParallelism_);
+    } else if (
+        type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kWindow) {
+      // We spill 'data' in one partition in type of kOrderBy and kWindow,
+      // otherwise in 4 partitions.
       spiller_ = std::make_unique<Spiller>(
           type_,
           rowContainer_.get(),
@@ -416,7 +427,9 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           targetFileSize,
           minSpillRunSize,
           *pool_,
-          executor());
+          executor(),
+          common::CompressionKind_NONE,
+          maxSpillWriteParallelism_);
     } else {
       spiller_ = std::make_unique<Spiller>(
           type_,
@@ -430,9 +443,11 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           targetFileSize,
           minSpillRunSize,
           *pool_,
-          executor());
+          executor(),
+          common::CompressionKind_NONE,
+          maxSpillWriteParallelism_);
     }
-    if (type_ == Spiller::Type::kOrderBy) {
+    if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kWindow) {
       ASSERT_EQ(spiller_->state().maxPartitions(), 1);
     } else {
       ASSERT_EQ(spiller_->state().maxPartitions(), numPartitions_);
@@ -776,6 +791,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
   const int32_t executorPoolSize_;
   const HashBitRange hashBits_;
   const int32_t numPartitions_;
+  int32_t maxSpillWriteParallelism_{0};
   std::unordered_map<std::string, RuntimeMetric> stats_;
   std::unique_ptr<TestRuntimeStatWriter> statWriter_;
   folly::Random::DefaultGenerator rng_;
@@ -829,7 +845,8 @@ class NoHashJoinNoOrderBy : public SpillerTest,
         .typesToExclude =
             {Spiller::Type::kHashJoinProbe,
              Spiller::Type::kHashJoinBuild,
-             Spiller::Type::kOrderBy}}
+             Spiller::Type::kOrderBy,
+             Spiller::Type::kWindow}}
         .getTestParams();
   }
 };
@@ -878,6 +895,16 @@ TEST_P(NoHashJoin, error) {
   testSortedSpill(100, 1, 0, true);
 }
 
+TEST_P(NoHashJoinNoOrderBy, maxSpillWriteParallelism) {
+  for (const auto maxSpillWriteParallelism : {1, 3}) {
+    SCOPED_TRACE(
+        fmt::format("maxSpillWriteParallelism: {}", maxSpillWriteParallelism));
+    maxSpillWriteParallelism_ = maxSpillWriteParallelism;
+    testSortedSpill(100, 1);
+    testSortedSpill(60, 10, 32);
+  }
+}
+
 TEST_P(NoHashJoinNoOrderBy, spillWithEmptyPartitions) {
   // kOrderBy type which has only one partition which is not relevant for this
   // test.
@@ -1013,7 +1040,8 @@ TEST_P(NoHashJoinNoOrderBy, spillWithNonSpillingPartitions) {
 }
 
 TEST_P(AllTypes, nonSortedSpillFunctions) {
-  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kAggregate) {
+  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kWindow ||
+      type_ == Spiller::Type::kAggregate) {
     setupSpillData(rowType_, numKeys_, 1'000, 1, nullptr, {});
     sortSpillData();
     setupSpiller(100'000, 0, false);
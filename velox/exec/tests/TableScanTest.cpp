@@ -20,6 +20,7 @@
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/dwio/common/tests/utils/DataFiles.h"
+#include "velox/exec/FragmentResultCache.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
@@ -803,6 +804,160 @@ TEST_F(TableScanTest, multipleSplits) {
   }
 }
 
+TEST_F(TableScanTest, splitPreloadBytesLimit) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_split_preload_per_driver = 4;
+  auto filePaths = makeFilePaths(20);
+  auto vectors = makeVectors(20, 100);
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+    splits.push_back(makeHiveConnectorSplit(
+        filePaths[i]->path, 0, fs::file_size(filePaths[i]->path)));
+  }
+  createDuckDbTable(vectors);
+
+  // Allows a single split to preload at a time.
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(tableScanNode())
+                  .splits(splits)
+                  .config(
+                      QueryConfig::kMaxSplitPreloadBytes,
+                      folly::to<std::string>(
+                          fs::file_size(filePaths[0]->path)))
+                  .assertResults("SELECT * FROM tmp");
+  auto stats = getTableScanRuntimeStats(task);
+  ASSERT_GT(stats.at("preloadedSplits").sum, 0);
+}
+
+TEST_F(TableScanTest, splitMorsels) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+  const auto fileSize = fs::file_size(filePath->path);
+
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(tableScanNode())
+                  .maxDrivers(4)
+                  .split(makeHiveConnectorSplit(filePath->path, 0, fileSize))
+                  .config(
+                      QueryConfig::kMaxSplitMorselBytes,
+                      folly::to<std::string>((fileSize + 3) / 4))
+                  .assertResults("SELECT * FROM tmp");
+  const auto taskStats = task->taskStats();
+  ASSERT_EQ(taskStats.numSplitsDividedIntoMorsels, 1);
+  ASSERT_EQ(taskStats.numSplitMorsels, 4);
+  ASSERT_EQ(taskStats.numTotalSplits, 4);
+  ASSERT_EQ(taskStats.numFinishedSplits, 4);
+}
+
+TEST_F(TableScanTest, fragmentResultCache) {
+  auto cache = std::make_shared<FragmentResultCache>(64 << 20, 16 << 20);
+  FragmentResultCache::setInstance(cache);
+  SCOPE_EXIT {
+    FragmentResultCache::setInstance(nullptr);
+  };
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder()
+                  .tableScan(rowType_)
+                  .capturePlanNodeId(scanNodeId)
+                  .planNode();
+  auto runQuery = [&](std::optional<int64_t> fileModifiedTime) {
+    HiveConnectorSplitBuilder builder(filePath->path);
+    builder.fileSize(fs::file_size(filePath->path));
+    if (fileModifiedTime.has_value()) {
+      builder.fileModifiedTime(fileModifiedTime.value());
+    }
+    auto split = builder.build();
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .plan(plan)
+                    .split(split)
+                    .config(QueryConfig::kFragmentResultCacheEnabled, "true")
+                    .assertResults("SELECT * FROM tmp");
+    return toPlanStats(task->taskStats()).at(scanNodeId).customStats;
+  };
+
+  auto stats = runQuery(100);
+  ASSERT_EQ(stats.at("fragmentResultCacheMisses").sum, 1);
+  ASSERT_EQ(stats.count("fragmentResultCacheHits"), 0);
+  ASSERT_EQ(cache->stats().numElements, 1);
+
+  stats = runQuery(100);
+  ASSERT_EQ(stats.at("fragmentResultCacheHits").sum, 1);
+  ASSERT_EQ(stats.count("fragmentResultCacheMisses"), 0);
+
+  // The file has been modified.
+  stats = runQuery(200);
+  ASSERT_EQ(stats.at("fragmentResultCacheMisses").sum, 1);
+  ASSERT_EQ(cache->stats().numElements, 2);
+
+  // The result of a split without a modification time is not cached.
+  stats = runQuery(std::nullopt);
+  ASSERT_EQ(stats.count("fragmentResultCacheHits"), 0);
+  ASSERT_EQ(stats.count("fragmentResultCacheMisses"), 0);
+  ASSERT_EQ(cache->stats().numElements, 2);
+}
+
+TEST_F(TableScanTest, fileMetadataCache) {
+  auto hiveConnector =
+      std::dynamic_pointer_cast<connector::hive::HiveConnector>(
+          connector::getConnector(kHiveConnectorId));
+  hiveConnector->clearFileMetadataCache();
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  auto plan = tableScanNode();
+  auto runQuery = [&](std::optional<int64_t> fileModifiedTime) {
+    HiveConnectorSplitBuilder builder(filePath->path);
+    builder.fileSize(fs::file_size(filePath->path));
+    if (fileModifiedTime.has_value()) {
+      builder.fileModifiedTime(fileModifiedTime.value());
+    }
+    AssertQueryBuilder(duckDbQueryRunner_)
+        .plan(plan)
+        .split(builder.build())
+        .assertResults("SELECT * FROM tmp");
+  };
+
+  const auto initial = hiveConnector->fileMetadataCacheStats();
+  runQuery(100);
+  auto stats = hiveConnector->fileMetadataCacheStats();
+  ASSERT_EQ(stats.numEntries, 1);
+  ASSERT_GT(stats.numBytes, 0);
+  ASSERT_EQ(stats.numHits, initial.numHits);
+
+  // The second query reuses the footer parsed by the first.
+  runQuery(100);
+  stats = hiveConnector->fileMetadataCacheStats();
+  ASSERT_EQ(stats.numEntries, 1);
+  ASSERT_EQ(stats.numHits, initial.numHits + 1);
+
+  // The file has been modified.
+  runQuery(200);
+  stats = hiveConnector->fileMetadataCacheStats();
+  ASSERT_EQ(stats.numEntries, 2);
+  ASSERT_EQ(stats.numHits, initial.numHits + 1);
+
+  // The footer of a file without a modification time is not cached.
+  const auto numLookups = stats.numLookups;
+  runQuery(std::nullopt);
+  stats = hiveConnector->fileMetadataCacheStats();
+  ASSERT_EQ(stats.numEntries, 2);
+  ASSERT_EQ(stats.numLookups, numLookups);
+
+  hiveConnector->clearFileMetadataCache();
+  ASSERT_EQ(hiveConnector->fileMetadataCacheStats().numEntries, 0);
+  ASSERT_EQ(hiveConnector->fileMetadataCacheStats().numBytes, 0);
+}
+
 TEST_F(TableScanTest, waitForSplit) {
   auto filePaths = makeFilePaths(10);
   auto vectors = makeVectors(10, 1'000);
@@ -1756,6 +1911,80 @@ TEST_F(TableScanTest, bucket) {
   }
 }
 
+TEST_F(TableScanTest, bucketPruning) {
+  // 8 buckets on c0. The Hive hash of a small non-negative bigint is its
+  // value, so the rows of bucket 'b' have c0 % 8 == b.
+  constexpr int32_t kNumBuckets = 8;
+  auto filePaths = makeFilePaths(kNumBuckets);
+  std::vector<RowVectorPtr> rowVectors;
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  for (auto bucket = 0; bucket < kNumBuckets; ++bucket) {
+    auto rowVector = makeRowVector(
+        {makeFlatVector<int64_t>(
+             100, [&](auto row) { return bucket + row * kNumBuckets; }),
+         makeFlatVector<int32_t>(100, [](auto row) { return row; })});
+    writeToFile(filePaths[bucket]->path, rowVector);
+    rowVectors.push_back(rowVector);
+    splits.push_back(HiveConnectorSplitBuilder(filePaths[bucket]->path)
+                         .tableBucketNumber(bucket)
+                         .build());
+  }
+  createDuckDbTable(rowVectors);
+
+  auto rowType = asRowType(rowVectors.front()->type());
+  const connector::hive::HiveBucketProperty bucketProperty{
+      kNumBuckets, {"c0"}, {BIGINT()}};
+  auto assertBuckets = [&](common::test::SubfieldFilters filters,
+                           const std::string& sql,
+                           int32_t numSkipped,
+                           bool bucketed = true) {
+    SCOPED_TRACE(sql);
+    auto tableHandle = std::make_shared<connector::hive::HiveTableHandle>(
+        kHiveConnectorId,
+        "hive_table",
+        true,
+        std::move(filters),
+        nullptr,
+        bucketed ? std::make_optional(bucketProperty) : std::nullopt);
+    auto plan = PlanBuilder()
+                    .tableScan(rowType, tableHandle, allRegularColumns(rowType))
+                    .planNode();
+    auto task = OperatorTestBase::assertQuery(plan, splits, sql);
+    EXPECT_EQ(numSkipped, getSkippedSplitsStat(task));
+  };
+
+  assertBuckets(
+      singleSubfieldFilter("c0", equal(13)),
+      "SELECT * FROM tmp WHERE c0 = 13",
+      kNumBuckets - 1);
+  assertBuckets(
+      singleSubfieldFilter("c0", in(std::vector<int64_t>{3, 11, 12})),
+      "SELECT * FROM tmp WHERE c0 IN (3, 11, 12)",
+      kNumBuckets - 2);
+  assertBuckets(
+      singleSubfieldFilter("c0", between(16, 19)),
+      "SELECT * FROM tmp WHERE c0 BETWEEN 16 AND 19",
+      kNumBuckets - 4);
+  // Too many values to enumerate. The splits are read and the filter drops
+  // their rows.
+  assertBuckets(
+      singleSubfieldFilter("c0", greaterThanOrEqual(790)),
+      "SELECT * FROM tmp WHERE c0 >= 790",
+      0);
+  // The table is not known to be bucketed.
+  assertBuckets(
+      singleSubfieldFilter("c0", equal(13)),
+      "SELECT * FROM tmp WHERE c0 = 13",
+      0,
+      false);
+  // A filter on $bucket prunes without the bucketing of the table.
+  assertBuckets(
+      singleSubfieldFilter("$bucket", equal(2)),
+      "SELECT * FROM tmp WHERE c0 % 8 = 2",
+      kNumBuckets - 1,
+      false);
+}
+
 TEST_F(TableScanTest, integerNotEqualFilter) {
   auto rowType = ROW(
       {"c0", "c1", "c2", "c3"}, {TINYINT(), SMALLINT(), INTEGER(), BIGINT()});
@@ -1975,6 +2204,94 @@ TEST_F(TableScanTest, remainingFilter) {
       "SELECT c1, c2 FROM tmp WHERE c1 > c0");
 }
 
+TEST_F(TableScanTest, remainingFilterInReader) {
+  // The remaining filter is evaluated by the reader after the subfield
+  // filters. The columns that are not filter inputs are read only for the
+  // rows that pass.
+  auto rowType = ROW(
+      {"c0", "c1", "c2", "c3"}, {BIGINT(), INTEGER(), VARCHAR(), DOUBLE()});
+  auto filePaths = makeFilePaths(5);
+  auto vectors = makeVectors(5, 1'000, rowType);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  assertQuery(
+      PlanBuilder()
+          .tableScan(rowType, {}, "c0 % 3 = 0 or c1 % 5 = 0")
+          .planNode(),
+      filePaths,
+      "SELECT * FROM tmp WHERE c0 % 3 = 0 or c1 % 5 = 0");
+
+  // A subfield filter on an input of the remaining filter.
+  assertQuery(
+      PlanBuilder()
+          .tableScan(rowType, {"c1 > 0::INTEGER"}, "c0 % 3 = 0 or c1 % 5 = 0")
+          .planNode(),
+      filePaths,
+      "SELECT * FROM tmp WHERE c1 > 0 AND (c0 % 3 = 0 or c1 % 5 = 0)");
+
+  // A subfield filter on a column that is not an input of the remaining
+  // filter.
+  assertQuery(
+      PlanBuilder()
+          .tableScan(rowType, {"c3 > 0.0"}, "c0 % 3 = 0 or c1 % 5 = 0")
+          .planNode(),
+      filePaths,
+      "SELECT * FROM tmp WHERE c3 > 0 AND (c0 % 3 = 0 or c1 % 5 = 0)");
+
+  // Only a string column is projected out.
+  ColumnHandleMap assignments = {{"c2", regularColumn("c2", VARCHAR())}};
+  auto tableHandle = makeTableHandle(
+      SubfieldFilters{}, parseExpr("c0 % 3 = 0 or c1 % 5 = 0", rowType));
+  assertQuery(
+      PlanBuilder()
+          .tableScan(ROW({"c2"}, {VARCHAR()}), tableHandle, assignments)
+          .planNode(),
+      filePaths,
+      "SELECT c2 FROM tmp WHERE c0 % 3 = 0 or c1 % 5 = 0");
+}
+
+TEST_F(TableScanTest, remainingFilterMapSubscripts) {
+  // A map column that is only accessed with constant subscripts in the
+  // remaining filter is read with only these keys.
+  constexpr vector_size_t kSize = 1'000;
+  std::vector<RowVectorPtr> vectors = {makeRowVector(
+      {"c0", "c1"},
+      {makeFlatVector<int64_t>(kSize, [](auto row) { return row; }),
+       makeMapVector<int64_t, int64_t>(
+           kSize,
+           [](auto /*row*/) { return 5; },
+           [](auto index) { return index % 5; },
+           [](auto index) { return index; })})};
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable({makeRowVector(
+      {"c0"}, {makeFlatVector<int64_t>(kSize, [](auto row) { return row; })})});
+
+  auto rowType = asRowType(vectors[0]->type());
+  ColumnHandleMap assignments = {{"c0", regularColumn("c0", BIGINT())}};
+  auto assertFilter = [&](const std::string& filter, const std::string& sql) {
+    auto tableHandle =
+        makeTableHandle(SubfieldFilters{}, parseExpr(filter, rowType));
+    assertQuery(
+        PlanBuilder()
+            .tableScan(ROW({"c0"}, {BIGINT()}), tableHandle, assignments)
+            .planNode(),
+        {filePath},
+        "SELECT c0 FROM tmp WHERE " + sql);
+  };
+
+  assertFilter("c1[2] % 3 = 0", "(c0 * 5 + 2) % 3 = 0");
+  assertFilter(
+      "c1[1] % 3 = 0 or element_at(c1, 4) % 7 = 0 or c1[1] % 11 = 0",
+      "(c0 * 5 + 1) % 3 = 0 or (c0 * 5 + 4) % 7 = 0 or (c0 * 5 + 1) % 11 = 0");
+  // The map is also used without a subscript, so all the keys are read.
+  assertFilter(
+      "c1[2] % 3 = 0 and cardinality(c1) = 5", "(c0 * 5 + 2) % 3 = 0");
+}
+
 TEST_F(TableScanTest, remainingFilterSkippedStrides) {
   auto rowType = ROW({{"c0", BIGINT()}, {"c1", BIGINT()}});
   std::vector<RowVectorPtr> vectors(3);
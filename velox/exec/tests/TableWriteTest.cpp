@@ -17,8 +17,11 @@
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/connectors/hive/HivePartitionUtil.h"
 #include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -666,3 +669,216 @@ TEST_F(TableWriteTest, appendToAnExistingUnpartitionedTable) {
         "SELECT * FROM tmp");
   }
 }
+
+TEST_F(TableWriteTest, bucketedSortedWrite) {
+  constexpr int32_t kBucketCount = 4;
+  auto rowType = ROW({"c0", "c1", "c2"}, {BIGINT(), INTEGER(), VARCHAR()});
+  // Batches of rows in reverse order of 'c1' with nulls.
+  std::vector<RowVectorPtr> vectors = makeBatches(5, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return (row * 7 + batch) % 101; }),
+         makeFlatVector<int32_t>(
+             1'000,
+             [&](auto row) { return (5 - batch) * 1'000 - row; },
+             nullEvery(37)),
+         makeFlatVector<StringView>(1'000, [&](auto row) {
+           return StringView(fmt::format("str_{}_{}", batch, row));
+         })});
+  });
+  createDuckDbTable(vectors);
+
+  auto bucketProperty = std::make_shared<HiveBucketProperty>(
+      kBucketCount,
+      std::vector<std::string>{"c0"},
+      std::vector<HiveSortingColumn>{{"c1", core::kAscNullsFirst}});
+
+  for (bool spill : {false, true}) {
+    SCOPED_TRACE(fmt::format("spill: {}", spill));
+    auto outputDirectory = TempDirectoryPath::create();
+    auto insertHandle = std::make_shared<core::InsertTableHandle>(
+        kHiveConnectorId,
+        std::make_shared<HiveInsertTableHandle>(
+            std::vector<std::shared_ptr<const HiveColumnHandle>>{
+                regularColumn("c0", BIGINT()),
+                regularColumn("c1", INTEGER()),
+                regularColumn("c2", VARCHAR())},
+            makeLocationHandle(outputDirectory->path),
+            bucketProperty));
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .tableWrite(
+                        rowType->names(),
+                        insertHandle,
+                        CommitStrategy::kNoCommit,
+                        "rows")
+                    .project({"rows"})
+                    .planNode();
+
+    auto spillDirectory = TempDirectoryPath::create();
+    AssertQueryBuilder builder(plan, duckDbQueryRunner_);
+    if (spill) {
+      builder.config(core::QueryConfig::kSpillEnabled, "true")
+          .connectorConfig(
+              kHiveConnectorId,
+              HiveConfig::kSortedWriteSpillMemoryThreshold,
+              "1")
+          .spillDirectory(spillDirectory->path);
+    }
+    builder.assertResults("SELECT count(*) FROM tmp");
+
+    // Each bucket is written to one file named after the bucket. The rows of
+    // each file are in the bucket and sorted on 'c1'.
+    auto files = getRecursiveFiles(outputDirectory->path);
+    ASSERT_EQ(files.size(), kBucketCount);
+    std::set<uint32_t> buckets;
+    for (const auto& file : files) {
+      const auto fileName = fs::path(file).filename().string();
+      const uint32_t bucket = std::stoi(fileName.substr(0, 6));
+      EXPECT_EQ(fileName.substr(6, 3), "_0_");
+      buckets.insert(bucket);
+
+      auto result = AssertQueryBuilder(
+                        PlanBuilder().tableScan(rowType).planNode())
+                        .split(makeHiveConnectorSplit(file))
+                        .copyResults(pool());
+      ASSERT_GT(result->size(), 0);
+      HivePartitionFunction bucketFunction(
+          kBucketCount, {0, 1, 2, 3}, std::vector<column_index_t>{0});
+      std::vector<uint32_t> rowBuckets;
+      bucketFunction.partition(*result, rowBuckets);
+      const auto& c1 = result->childAt(1);
+      for (auto row = 0; row < result->size(); ++row) {
+        ASSERT_EQ(rowBuckets[row], bucket);
+        if (row > 0) {
+          ASSERT_LE(c1->compare(c1.get(), row - 1, row), 0);
+        }
+      }
+    }
+    EXPECT_EQ(buckets.size(), kBucketCount);
+
+    assertQuery(
+        PlanBuilder().tableScan(rowType).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+  }
+}
+
+TEST_F(TableWriteTest, writersMemoryBudget) {
+  constexpr int32_t kNumPartitions = 10;
+  constexpr int32_t kNumBatches = 3;
+  auto rowType = ROW({"c0", "p0"}, {BIGINT(), INTEGER()});
+  std::vector<RowVectorPtr> vectors = makeBatches(kNumBatches, [&](auto) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+         makeFlatVector<int32_t>(
+             1'000, [](auto row) { return row % kNumPartitions; })});
+  });
+  createDuckDbTable(vectors);
+
+  for (bool limited : {false, true}) {
+    SCOPED_TRACE(fmt::format("limited: {}", limited));
+    auto outputDirectory = TempDirectoryPath::create();
+    auto plan = createInsertPlan(
+        PlanBuilder().values(vectors), rowType, outputDirectory->path, {"p0"});
+    AssertQueryBuilder builder(plan, duckDbQueryRunner_);
+    if (limited) {
+      // Every batch exceeds the budget and flushes the stripes of all the
+      // partition writers.
+      builder.connectorConfig(
+          kHiveConnectorId, HiveConfig::kWritersMemoryBudget, "1");
+    }
+    builder.assertResults("SELECT count(*) FROM tmp");
+
+    auto files = getRecursiveFiles(outputDirectory->path);
+    ASSERT_EQ(files.size(), kNumPartitions);
+    for (const auto& file : files) {
+      dwio::common::ReaderOptions readerOptions{pool()};
+      auto reader = dwrf::DwrfReader::create(
+          std::make_unique<dwio::common::BufferedInput>(
+              std::make_shared<LocalReadFile>(file), *pool()),
+          readerOptions);
+      EXPECT_EQ(reader->getNumberOfStripes(), limited ? kNumBatches : 1);
+    }
+
+    assertQuery(
+        PlanBuilder().tableScan(rowType).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+  }
+}
+
+TEST_F(TableWriteTest, scaledWriters) {
+  constexpr int32_t kNumDrivers = 4;
+  constexpr int32_t kNumBatches = 20;
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  auto vectors = makeBatches(kNumBatches, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(100, [&](auto row) { return batch + row; }),
+         makeFlatVector<std::string>(
+             100, [](auto row) { return std::string(row % 20, 'x'); })});
+  });
+  createDuckDbTable(vectors);
+
+  struct {
+    bool scaled;
+    std::string minDataProcessedBytes;
+    // Makes every enqueue wait for the writers.
+    std::string maxLocalExchangeBufferSize;
+    uint32_t expectedNumFiles;
+
+    std::string debugString() const {
+      return fmt::format(
+          "scaled {}, minDataProcessedBytes {}, maxLocalExchangeBufferSize {}",
+          scaled,
+          minDataProcessedBytes,
+          maxLocalExchangeBufferSize);
+    }
+  } testSettings[] = {
+      // Each writer gets rows of each batch.
+      {false, "1", "1", kNumDrivers},
+      // A small input stays on one writer.
+      {true, "1000000000", "1", 1},
+      // The input does not wait for the writers.
+      {true, "1", "1000000000", 1},
+      // The writers are added while the input waits for them.
+      {true, "1", "1", kNumDrivers}};
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    auto outputDirectory = TempDirectoryPath::create();
+    core::PlanNodeId partitionNodeId;
+    auto planBuilder = PlanBuilder().values(vectors).localPartitionRoundRobin();
+    planBuilder.capturePlanNodeId(partitionNodeId);
+    auto plan = createInsertPlan(planBuilder, rowType, outputDirectory->path);
+
+    std::shared_ptr<Task> task;
+    AssertQueryBuilder(plan)
+        .maxDrivers(kNumDrivers)
+        .config(
+            core::QueryConfig::kScaledWriterEnabled,
+            testData.scaled ? "true" : "false")
+        .config(
+            core::QueryConfig::kScaledWriterMinDataProcessedBytes,
+            testData.minDataProcessedBytes)
+        .config(
+            core::QueryConfig::kMaxLocalExchangeBufferSize,
+            testData.maxLocalExchangeBufferSize)
+        .copyResults(pool(), task);
+    ASSERT_EQ(
+        countRecursiveFiles(outputDirectory->path), testData.expectedNumFiles);
+    const auto& customStats =
+        toPlanStats(task->taskStats()).at(partitionNodeId).customStats;
+    ASSERT_EQ(
+        customStats.count("scaledWriters"),
+        testData.scaled && testData.expectedNumFiles > 1 ? 1 : 0);
+
+    assertQuery(
+        PlanBuilder().tableScan(rowType).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+  }
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+class TopNRowNumberTest : public OperatorTestBase {
+ protected:
+  // Makes 'numBatches' batches with partition keys c0 and c2 and a sorting
+  // key c1 that is unique over all the batches, so that the top rows of each
+  // partition are deterministic. Needs less than 10'007 rows in total.
+  std::vector<RowVectorPtr> makeVectors(
+      int32_t numBatches,
+      vector_size_t batchSize,
+      int32_t numPartitions) {
+    std::vector<RowVectorPtr> vectors;
+    for (int32_t i = 0; i < numBatches; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) { return (i * batchSize + row) % numPartitions; },
+              nullEvery(13)),
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) { return (i * batchSize + row) * 7 % 10'007; }),
+          makeFlatVector<StringView>(
+              batchSize,
+              [](auto row) {
+                return StringView::makeInline(std::to_string(row % 3));
+              }),
+      }));
+    }
+    return vectors;
+  }
+
+  // Returns the DuckDB query with the row_number() window function filtered
+  // on 'limit'.
+  static std::string makeSql(
+      const std::string& partitionBy,
+      const std::string& orderBy,
+      int32_t limit,
+      bool generateRowNumber) {
+    return fmt::format(
+        "SELECT c0, c1, c2{} FROM (SELECT *, row_number() over "
+        "({} order by {}) as row_number FROM tmp) WHERE row_number <= {}",
+        generateRowNumber ? ", row_number" : "",
+        partitionBy.empty() ? "" : "partition by " + partitionBy,
+        orderBy,
+        limit);
+  }
+
+  void testTopNRowNumber(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& partitionKeys,
+      const std::string& orderBy) {
+    createDuckDbTable(input);
+    for (const auto limit : {1, 5, 100, 10'000}) {
+      for (const auto generateRowNumber : {false, true}) {
+        SCOPED_TRACE(fmt::format(
+            "limit: {}, generateRowNumber: {}", limit, generateRowNumber));
+        auto plan = PlanBuilder()
+                        .values(input)
+                        .topNRowNumber(
+                            partitionKeys, {orderBy}, limit, generateRowNumber)
+                        .planNode();
+        assertQuery(
+            plan,
+            makeSql(
+                folly::join(", ", partitionKeys),
+                orderBy,
+                limit,
+                generateRowNumber));
+      }
+    }
+  }
+};
+
+TEST_F(TopNRowNumberTest, basic) {
+  auto vectors = makeVectors(5, 1'000, 17);
+  testTopNRowNumber(vectors, {"c0"}, "c1 DESC NULLS LAST");
+  testTopNRowNumber(vectors, {"c0"}, "c1");
+  testTopNRowNumber(vectors, {"c0", "c2"}, "c1");
+}
+
+TEST_F(TopNRowNumberTest, noPartitionKeys) {
+  auto vectors = makeVectors(5, 1'000, 17);
+  testTopNRowNumber(vectors, {}, "c1 DESC");
+}
+
+TEST_F(TopNRowNumberTest, manyPartitions) {
+  // Most partitions have a single row, the others have a few.
+  auto vectors = makeVectors(5, 1'000, 3'000);
+  testTopNRowNumber(vectors, {"c0"}, "c1");
+}
+
+TEST_F(TopNRowNumberTest, empty) {
+  auto vectors = makeVectors(1, 1'000, 17);
+  createDuckDbTable(vectors);
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .filter("c0 > 100")
+                  .topNRowNumber({"c0"}, {"c1"}, 10, true)
+                  .planNode();
+  assertQuery(plan, "SELECT c0, c1, c2, 1::BIGINT FROM tmp WHERE c0 > 100");
+}
+
+TEST_F(TopNRowNumberTest, spill) {
+  auto vectors = makeVectors(5, 1'000, 17);
+  createDuckDbTable(vectors);
+
+  for (const auto& partitionKeys :
+       std::vector<std::vector<std::string>>{{"c0"}, {}}) {
+    for (const auto limit : {1, 10, 10'000}) {
+      SCOPED_TRACE(fmt::format(
+          "partitionKeys: {}, limit: {}",
+          folly::join(", ", partitionKeys),
+          limit));
+      core::PlanNodeId topNRowNumberId;
+      auto plan = PlanBuilder()
+                      .values(vectors)
+                      .topNRowNumber(partitionKeys, {"c1 DESC"}, limit, true)
+                      .capturePlanNodeId(topNRowNumberId)
+                      .planNode();
+
+      auto spillDirectory = TempDirectoryPath::create();
+      auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+      queryCtx->setConfigOverridesUnsafe({
+          {core::QueryConfig::kTestingSpillPct, "100"},
+          {core::QueryConfig::kSpillEnabled, "true"},
+          {core::QueryConfig::kTopNRowNumberSpillEnabled, "true"},
+          {core::QueryConfig::kPreferredOutputBatchRows, "100"},
+      });
+      CursorParameters params;
+      params.planNode = plan;
+      params.queryCtx = queryCtx;
+      params.spillDirectory = spillDirectory->path;
+      auto task = assertQuery(
+          params,
+          makeSql(folly::join(", ", partitionKeys), "c1 DESC", limit, true));
+
+      const auto& stats = toPlanStats(task->taskStats()).at(topNRowNumberId);
+      EXPECT_LT(0, stats.spilledBytes);
+      EXPECT_EQ(1, stats.spilledPartitions);
+      EXPECT_LT(0, stats.spilledFiles);
+      OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+    }
+  }
+}
@@ -13,8 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
@@ -261,3 +263,58 @@ TEST_F(TopNTest, lowCardinality) {
 
   testTwoKeys(vectors, "c0", "c1", 200);
 }
+
+TEST_F(TopNTest, spill) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize,
+        [&](vector_size_t row) { return (batchSize * (5 - i) + row) % 1'700; },
+        nullEvery(17));
+    auto c1 = makeFlatVector<double>(
+        batchSize, [](vector_size_t row) { return row * 0.1; });
+    auto c2 = makeFlatVector<StringView>(batchSize, [](vector_size_t row) {
+      return StringView::makeInline(std::to_string(row));
+    });
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto limit : {10, 1'500, 10'000}) {
+    SCOPED_TRACE(fmt::format("limit: {}", limit));
+    core::PlanNodeId topNId;
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .topN({"c0 DESC NULLS LAST", "c1"}, limit, false)
+                    .capturePlanNodeId(topNId)
+                    .planNode();
+
+    auto spillDirectory = TempDirectoryPath::create();
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kTestingSpillPct, "100"},
+        {core::QueryConfig::kSpillEnabled, "true"},
+        {core::QueryConfig::kTopNSpillEnabled, "true"},
+    });
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = queryCtx;
+    params.spillDirectory = spillDirectory->path;
+    auto task = assertQueryOrdered(
+        params,
+        fmt::format(
+            "SELECT * FROM tmp ORDER BY c0 DESC NULLS LAST, c1 LIMIT {}",
+            limit),
+        {0, 1});
+
+    const auto& topNStats = toPlanStats(task->taskStats()).at(topNId);
+    EXPECT_LT(0, topNStats.spilledBytes);
+    EXPECT_EQ(1, topNStats.spilledPartitions);
+    EXPECT_LT(0, topNStats.spilledFiles);
+    // The first input batch never spills. The rows which can't make into the
+    // top rows after the first spill are also not spilled.
+    EXPECT_GT(5 * batchSize, topNStats.spilledRows);
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+}
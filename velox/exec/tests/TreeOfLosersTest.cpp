@@ -28,6 +28,7 @@ class TreeOfLosersTest : public testing::Test, public MergeTestBase {
     TestData testData = makeTestData(numValues, numStreams);
     test<TreeOfLosers<TestingStream>>(testData, true);
     test<MergeArray<TestingStream>>(testData, true);
+    test<PrefixTreeOfLosers<TestingStream>>(testData, true);
   }
 };
 
@@ -40,6 +41,42 @@ TEST_F(TreeOfLosersTest, merge) {
   testBoth(500, 1);
 }
 
+TEST_F(TreeOfLosersTest, prefixRuns) {
+  for (auto [numValues, numStreams] : std::vector<std::pair<int32_t, int32_t>>{
+           {11, 2}, {16, 32}, {17, 17}, {0, 9}, {100000, 37}, {500, 1}}) {
+    SCOPED_TRACE(fmt::format("{} values, {} streams", numValues, numStreams));
+    TestData testData = makeTestData(numValues, numStreams);
+    testRuns<PrefixTreeOfLosers<TestingStream>>(testData, true);
+  }
+
+  // Streams whose values are below the prefixes of the next stream. Each
+  // stream is taken in one run.
+  std::vector<uint32_t> allNumbers;
+  std::vector<std::unique_ptr<TestingStream>> mergeStreams;
+  for (auto i = 0; i < 4; ++i) {
+    std::vector<uint32_t> numbers;
+    for (auto j = 0; j < 1'000; ++j) {
+      allNumbers.push_back(i * 4'096 + j);
+    }
+    numbers.assign(allNumbers.rbegin(), allNumbers.rbegin() + 1'000);
+    mergeStreams.push_back(std::make_unique<TestingStream>(std::move(numbers)));
+  }
+  PrefixTreeOfLosers<TestingStream> merge(std::move(mergeStreams));
+  int32_t numNext = 0;
+  int32_t numValues = 0;
+  TestingStream* stream;
+  while ((stream = merge.next())) {
+    ++numNext;
+    const auto bound = merge.runBound();
+    do {
+      ASSERT_EQ(stream->current()->value(), allNumbers[numValues++]);
+      stream->pop();
+    } while (stream->hasData() && stream->prefix() < bound);
+  }
+  ASSERT_EQ(numValues, allNumbers.size());
+  ASSERT_EQ(numNext, 4);
+}
+
 TEST_F(TreeOfLosersTest, nextWithEquals) {
   constexpr int32_t kNumStreams = 17;
   std::vector<std::vector<uint32_t>> streams(kNumStreams);
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -352,6 +354,93 @@ TEST_F(UnnestTest, multipleColumnsWithOrdinality) {
   assertQuery(op, expected);
 }
 
+TEST_F(UnnestTest, outputBatchSize) {
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(5, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(
+          5,
+          [](auto /* row */) { return 4; },
+          [](auto row, auto index) { return row * 10 + index; }),
+  });
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>(20, [](auto row) { return row / 4; }),
+      makeFlatVector<int32_t>(
+          20, [](auto row) { return row / 4 * 10 + row % 4; }),
+  });
+
+  core::PlanNodeId unnestId;
+  auto plan = PlanBuilder()
+                  .values({vector})
+                  .unnest({"c0"}, {"c1"})
+                  .capturePlanNodeId(unnestId)
+                  .planNode();
+
+  // The first batch has 10 rows. After that, the batches are sized by the
+  // average output row size, which makes them a single row of output with a
+  // preferred batch size of 1 byte. The input rows are split between the
+  // batches.
+  auto task = AssertQueryBuilder(plan)
+                  .config(core::QueryConfig::kPreferredOutputBatchRows, "10")
+                  .config(core::QueryConfig::kPreferredOutputBatchBytes, "1")
+                  .assertResults(expected);
+  auto stats = toPlanStats(task->taskStats());
+  ASSERT_EQ(stats.at(unnestId).outputRows, 20);
+  ASSERT_EQ(stats.at(unnestId).outputVectors, 11);
+}
+
+TEST_F(UnnestTest, splitLargeArrays) {
+  std::vector<std::vector<int32_t>> c1{{0}, {}, {200, 201, 202}};
+  for (auto i = 0; i < 25; ++i) {
+    c1[1].push_back(100 + i);
+  }
+  std::vector<std::optional<std::vector<std::optional<int32_t>>>> c2{
+      {{10, 11}}, {{20, 21, 22, 23, 24, 25, 26}}, std::nullopt};
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>({0, 1, 2}),
+      makeArrayVector<int32_t>(c1),
+      makeNullableArrayVector<int32_t>(c2),
+  });
+
+  std::vector<int64_t> expectedC0;
+  std::vector<std::optional<int32_t>> expectedC1;
+  std::vector<std::optional<int32_t>> expectedC2;
+  std::vector<int64_t> expectedOrdinality;
+  for (auto row = 0; row < 3; ++row) {
+    const size_t c2Size = c2[row].has_value() ? c2[row]->size() : 0;
+    const auto maxSize = std::max(c1[row].size(), c2Size);
+    for (size_t i = 0; i < maxSize; ++i) {
+      expectedC0.push_back(row);
+      expectedC1.push_back(
+          i < c1[row].size() ? std::optional(c1[row][i]) : std::nullopt);
+      expectedC2.push_back(i < c2Size ? c2[row].value()[i] : std::nullopt);
+      expectedOrdinality.push_back(i + 1);
+    }
+  }
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>(expectedC0),
+      makeNullableFlatVector<int32_t>(expectedC1),
+      makeNullableFlatVector<int32_t>(expectedC2),
+      makeFlatVector<int64_t>(expectedOrdinality),
+  });
+
+  core::PlanNodeId unnestId;
+  auto plan = PlanBuilder()
+                  .values({vector})
+                  .unnest({"c0"}, {"c1", "c2"}, "ordinal")
+                  .capturePlanNodeId(unnestId)
+                  .planNode();
+
+  // The 30 output rows are produced in batches of 10. The array of 25
+  // elements in the second row is split over the 3 batches.
+  auto task = AssertQueryBuilder(plan)
+                  .config(core::QueryConfig::kPreferredOutputBatchRows, "10")
+                  .config(core::QueryConfig::kMaxOutputBatchRows, "10")
+                  .assertResults(expected);
+  auto stats = toPlanStats(task->taskStats());
+  ASSERT_EQ(stats.at(unnestId).outputRows, 30);
+  ASSERT_EQ(stats.at(unnestId).outputVectors, 3);
+}
+
 TEST_F(UnnestTest, allEmptyOrNullArrays) {
   auto vector = makeRowVector(
       {makeFlatVector<int64_t>(100, [](auto row) { return row; }),
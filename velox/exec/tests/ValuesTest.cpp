@@ -17,6 +17,7 @@
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/RowVectorStreams.h"
 
 using namespace facebook::velox;
 using exec::test::AssertQueryBuilder;
@@ -109,4 +110,49 @@ TEST_F(ValuesTest, valuesWithRepeatAndParallelism) {
           {input_, input2_, input_, input2_, input_, input2_, input_, input2_});
 }
 
+TEST_F(ValuesTest, fuzzerValueStream) {
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  VectorFuzzer::Options options;
+  options.vectorSize = 100;
+  auto plan =
+      PlanBuilder()
+          .valueStream(
+              rowType, FuzzerRowVectorStream::factory(rowType, options, 1, 3))
+          .planNode();
+  auto result = AssertQueryBuilder(plan).maxDrivers(4).copyResults(pool());
+  ASSERT_EQ(result->size(), 4 * 3 * 100);
+
+  // Draw the rows of each driver from 10 distinct rows.
+  plan =
+      PlanBuilder()
+          .valueStream(
+              rowType,
+              FuzzerRowVectorStream::factory(rowType, options, 1, 3, 10))
+          .singleAggregation({"c0", "c1"}, {})
+          .planNode();
+  result = AssertQueryBuilder(plan).copyResults(pool());
+  ASSERT_LE(result->size(), 10);
+}
+
+TEST_F(ValuesTest, tpchValueStream) {
+  auto plan = PlanBuilder()
+                  .valueStream(
+                      tpch::getTableSchema(tpch::Table::TBL_NATION),
+                      TpchRowVectorStream::factory(
+                          tpch::Table::TBL_NATION, 0.01, 10, 2))
+                  .planNode();
+  AssertQueryBuilder(plan).maxDrivers(2).assertResults(
+      tpch::genTpchNation(pool()));
+
+  // Each driver generates the lineitems of half of the orders.
+  plan = PlanBuilder()
+             .valueStream(
+                 tpch::getTableSchema(tpch::Table::TBL_LINEITEM),
+                 TpchRowVectorStream::factory(
+                     tpch::Table::TBL_LINEITEM, 0.001, 100, 2))
+             .planNode();
+  AssertQueryBuilder(plan).maxDrivers(2).assertResults(
+      tpch::genTpchLineItem(pool(), 10'000, 0, 0.001));
+}
+
 } // namespace facebook::velox::exec::test
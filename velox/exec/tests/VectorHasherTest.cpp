@@ -728,6 +728,57 @@ TEST_F(VectorHasherTest, computeValueIdsStrings) {
   ASSERT_LE(uniqueValues.size(), multiplier);
 }
 
+// Tests value ids of small batches of dictionaries over a large base, like
+// the batches of a stripe with a string dictionary.
+TEST_F(VectorHasherTest, computeValueIdsLargeDictionary) {
+  constexpr vector_size_t kBaseSize = 10'000;
+  constexpr vector_size_t kBatchSize = 100;
+  std::string value;
+  auto base = vectorMaker_->flatVector<StringView>(kBaseSize, [&](auto row) {
+    value = fmt::format("value {}", row % 5'000);
+    return StringView(value);
+  });
+  // Same values in a different order.
+  auto reversedBase =
+      vectorMaker_->flatVector<StringView>(kBaseSize, [&](auto row) {
+        value = fmt::format("value {}", 4'999 - row % 5'000);
+        return StringView(value);
+      });
+
+  auto hasher = std::make_unique<exec::VectorHasher>(VARCHAR(), 0);
+  SelectivityVector baseRows(kBaseSize);
+  raw_vector<uint64_t> baseIds(kBaseSize);
+  hasher->decode(*base, baseRows);
+  ASSERT_FALSE(hasher->computeValueIds(baseRows, baseIds));
+  hasher->enableValueIds(1, 0);
+  ASSERT_TRUE(hasher->computeValueIds(baseRows, baseIds));
+
+  std::unordered_map<StringView, uint64_t> expectedIds;
+  for (auto i = 0; i < kBaseSize; ++i) {
+    expectedIds[base->valueAt(i)] = baseIds[i];
+  }
+
+  SelectivityVector rows(kBatchSize);
+  raw_vector<uint64_t> ids(kBatchSize);
+  for (auto batch = 0; batch < 10; ++batch) {
+    const auto& batchBase = batch % 2 == 0 ? base : reversedBase;
+    auto dictionary = BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        makeIndices(
+            kBatchSize,
+            [&](auto row) { return (row * 37 + batch * 11) % kBaseSize; }),
+        kBatchSize,
+        batchBase);
+    hasher->decode(*dictionary, rows);
+    ASSERT_TRUE(hasher->computeValueIds(rows, ids));
+    auto strings = dictionary->as<SimpleVector<StringView>>();
+    for (auto row = 0; row < kBatchSize; ++row) {
+      ASSERT_EQ(ids[row], expectedIds[strings->valueAt(row)])
+          << "at " << row << " in batch " << batch;
+    }
+  }
+}
+
 namespace {
 
 // enum for marking special values to be tested in a type.
@@ -860,6 +911,62 @@ TEST_F(VectorHasherTest, endOfRange) {
   EXPECT_EQ(tinyData->size(), uniques.size());
 }
 
+TEST_F(VectorHasherTest, rawKey) {
+  using exec::VectorHasher;
+  EXPECT_EQ(0, VectorHasher::rawKeyBits(TypeKind::BIGINT, false));
+  EXPECT_EQ(0, VectorHasher::rawKeyBits(TypeKind::VARCHAR, false));
+  EXPECT_EQ(2, VectorHasher::rawKeyBits(TypeKind::BOOLEAN, true));
+  EXPECT_EQ(33, VectorHasher::rawKeyBits(TypeKind::INTEGER, true));
+
+  // A nullable TINYINT in the low 9 bits and a non-null INTEGER in the next
+  // 32 bits. Null is 0 and the bits of the values are kept as is.
+  auto tinyValues = vectorMaker_->flatVectorNullable<int8_t>(
+      {std::nullopt, -1, 0, 127, -128});
+  auto intValues = vectorMaker_->flatVector<int32_t>(
+      {-1,
+       5,
+       std::numeric_limits<int32_t>::min(),
+       0,
+       std::numeric_limits<int32_t>::max()});
+  auto tinyHasher = VectorHasher::create(TINYINT(), 0);
+  auto intHasher = VectorHasher::create(INTEGER(), 1);
+  EXPECT_EQ(9, tinyHasher->enableRawKey(0, true));
+  EXPECT_EQ(41, intHasher->enableRawKey(9, false));
+  EXPECT_TRUE(intHasher->isRawKey());
+  EXPECT_FALSE(intHasher->isRange());
+
+  const std::vector<uint64_t> expected = {
+      0xffffffffUL << 9,
+      0x1ff + (5UL << 9),
+      1 + (0x80000000UL << 9),
+      0xff,
+      0x101 + (0x7fffffffUL << 9)};
+
+  SelectivityVector rows(tinyValues->size());
+  raw_vector<uint64_t> result(rows.size());
+  tinyHasher->decode(*tinyValues, rows);
+  EXPECT_TRUE(tinyHasher->computeValueIds(rows, result));
+  intHasher->decode(*intValues, rows);
+  EXPECT_TRUE(intHasher->computeValueIds(rows, result));
+  for (auto i = 0; i < rows.size(); ++i) {
+    EXPECT_EQ(expected[i], result[i]) << i;
+  }
+
+  // Every value has an id, so the lookup keeps all the rows.
+  VectorHasher::ScratchMemory scratch;
+  std::fill(result.begin(), result.end(), 0);
+  tinyHasher->lookupValueIds(*tinyValues, rows, scratch, result, false);
+  intHasher->lookupValueIds(*intValues, rows, scratch, result);
+  EXPECT_EQ(tinyValues->size(), rows.countSelected());
+  for (auto i = 0; i < rows.size(); ++i) {
+    EXPECT_EQ(expected[i], result[i]) << i;
+  }
+
+  // Setting another mode leaves raw key mode.
+  intHasher->enableValueIds(1, 0);
+  EXPECT_FALSE(intHasher->isRawKey());
+}
+
 TEST_F(VectorHasherTest, hashCollision) {
   constexpr int kValue = 42;
   UniqueValue x(kValue);
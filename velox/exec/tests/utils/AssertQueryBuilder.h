@@ -127,6 +127,12 @@ class AssertQueryBuilder {
   /// query returns empty result.
   RowVectorPtr copyResults(memory::MemoryPool* FOLLY_NONNULL pool);
 
+  /// Same as above, but also returns the task that ran the query, e.g. to read
+  /// its stats.
+  RowVectorPtr copyResults(
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      std::shared_ptr<Task>& task);
+
  private:
   std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>>
   readCursor();
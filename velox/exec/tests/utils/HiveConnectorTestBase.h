@@ -171,6 +171,16 @@ class HiveConnectorSplitBuilder {
     return *this;
   }
 
+  HiveConnectorSplitBuilder& fileSize(uint64_t size) {
+    fileSize_ = size;
+    return *this;
+  }
+
+  HiveConnectorSplitBuilder& fileModifiedTime(int64_t time) {
+    fileModifiedTime_ = time;
+    return *this;
+  }
+
   std::shared_ptr<connector::hive::HiveConnectorSplit> build() const {
     return std::make_shared<connector::hive::HiveConnectorSplit>(
         kHiveConnectorId,
@@ -179,7 +189,9 @@ class HiveConnectorSplitBuilder {
         start_,
         length_,
         partitionKeys_,
-        tableBucketNumber_);
+        tableBucketNumber_,
+        fileSize_,
+        fileModifiedTime_);
   }
 
  private:
@@ -189,6 +201,8 @@ class HiveConnectorSplitBuilder {
   uint64_t length_{std::numeric_limits<uint64_t>::max()};
   std::unordered_map<std::string, std::optional<std::string>> partitionKeys_;
   std::optional<int32_t> tableBucketNumber_;
+  std::optional<uint64_t> fileSize_;
+  std::optional<int64_t> fileModifiedTime_;
 };
 
 } // namespace facebook::velox::exec::test
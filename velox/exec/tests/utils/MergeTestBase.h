@@ -84,6 +84,12 @@ class TestingStream final : public MergeStream {
         static_cast<const TestingStream&>(other).current_.value();
   }
 
+  // The high bits of the first value, so that different values have equal
+  // prefixes. Used by PrefixTreeOfLosers.
+  uint64_t prefix() const {
+    return current()->value() >> 8;
+  }
+
   int32_t compare(const MergeStream& other) const final {
     auto otherValue = static_cast<const TestingStream&>(other).current_.value();
     return current_.value() < otherValue ? -1
@@ -175,6 +181,34 @@ class MergeTestBase {
     }
   }
 
+  // Like test() but takes the values below MergeType::runBound() from the
+  // stream returned by MergeType::next() without calling next() again.
+  template <typename MergeType>
+  static void testRuns(const TestData& testData, bool check) {
+    std::vector<std::unique_ptr<TestingStream>> sources;
+    for (auto& source : testData.sources) {
+      sources.push_back(std::make_unique<TestingStream>(*source));
+    }
+    MergeType merge(std::move(sources));
+    int32_t numValues = 0;
+    TestingStream* source;
+    while ((source = merge.next())) {
+      const auto bound = merge.runBound();
+      do {
+        if (check) {
+          ASSERT_LT(numValues, testData.data.size())
+              << "Extra values in merged stream";
+          ASSERT_EQ(source->current()->value(), testData.data[numValues]);
+        }
+        ++numValues;
+        source->pop();
+      } while (source->hasData() && source->prefix() < bound);
+    }
+    if (check) {
+      ASSERT_EQ(numValues, testData.data.size());
+    }
+  }
+
  protected:
   folly::Random::DefaultGenerator rng_;
 };
@@ -171,6 +171,15 @@ PlanBuilder& PlanBuilder::values(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::valueStream(
+    const RowTypePtr& outputType,
+    core::ValueStreamNode::StreamFactory streamFactory) {
+  VELOX_CHECK_NULL(planNode_, "valueStream() must be the first call");
+  planNode_ = std::make_shared<core::ValueStreamNode>(
+      nextPlanNodeId(), outputType, std::move(streamFactory));
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::exchange(const RowTypePtr& outputType) {
   VELOX_CHECK_NULL(planNode_, "exchange() must be the first call");
   planNode_ =
@@ -536,6 +545,24 @@ PlanBuilder& PlanBuilder::finalAggregation() {
   return *this;
 }
 
+PlanBuilder& PlanBuilder::localPartitionedFinalAggregation() {
+  const auto* aggNode =
+      dynamic_cast<const core::AggregationNode*>(planNode_.get());
+  VELOX_CHECK_NOT_NULL(
+      aggNode,
+      "Current plan node must be a partial or intermediate aggregation. Got: {}",
+      planNode_->toString());
+  VELOX_CHECK(exec::isPartialOutput(aggNode->step()));
+
+  std::vector<std::string> keys;
+  keys.reserve(aggNode->groupingKeys().size());
+  for (const auto& key : aggNode->groupingKeys()) {
+    keys.push_back(key->name());
+  }
+  localPartition(keys);
+  return finalAggregation();
+}
+
 PlanBuilder::ExpressionsAndNames
 PlanBuilder::createAggregateExpressionsAndNames(
     const std::vector<std::string>& aggregates,
@@ -766,6 +793,28 @@ PlanBuilder& PlanBuilder::topN(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::topNRowNumber(
+    const std::vector<std::string>& partitionKeys,
+    const std::vector<std::string>& sortingKeys,
+    int32_t limit,
+    bool generateRowNumber) {
+  auto [sortingFields, sortingOrders] =
+      parseOrderByClauses(sortingKeys, planNode_->outputType(), pool_);
+  std::optional<std::string> rowNumberColumnName;
+  if (generateRowNumber) {
+    rowNumberColumnName = "row_number";
+  }
+  planNode_ = std::make_shared<core::TopNRowNumberNode>(
+      nextPlanNodeId(),
+      fields(partitionKeys),
+      sortingFields,
+      sortingOrders,
+      rowNumberColumnName,
+      limit,
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::limit(int32_t offset, int32_t count, bool isPartial) {
   planNode_ = std::make_shared<core::LimitNode>(
       nextPlanNodeId(), offset, count, isPartial, planNode_);
@@ -919,6 +968,22 @@ PlanBuilder& PlanBuilder::partitionedOutput(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::shuffleWrite(
+    const std::vector<std::string>& keys,
+    int numPartitions,
+    const std::string& shuffleDirectory) {
+  auto partitionFunctionFactory =
+      createPartitionFunctionSpec(planNode_->outputType(), keys);
+  planNode_ = std::make_shared<core::ShuffleWriteNode>(
+      nextPlanNodeId(),
+      exprs(keys),
+      numPartitions,
+      std::move(partitionFunctionFactory),
+      shuffleDirectory,
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::partitionedOutputBroadcast(
     const std::vector<std::string>& outputLayout) {
   auto outputType = outputLayout.empty()
@@ -1000,7 +1065,8 @@ PlanBuilder& PlanBuilder::hashJoin(
     const std::string& filter,
     const std::vector<std::string>& outputLayout,
     core::JoinType joinType,
-    bool nullAware) {
+    bool nullAware,
+    std::optional<std::string> buildCacheKey) {
   VELOX_CHECK_EQ(leftKeys.size(), rightKeys.size());
 
   auto leftType = planNode_->outputType();
@@ -1040,7 +1106,8 @@ PlanBuilder& PlanBuilder::hashJoin(
       std::move(filterExpr),
       std::move(planNode_),
       build,
-      outputType);
+      outputType,
+      std::move(buildCacheKey));
   return *this;
 }
 
@@ -1087,6 +1154,28 @@ PlanBuilder& PlanBuilder::nestedLoopJoin(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::nestedLoopJoin(
+    const core::PlanNodePtr& right,
+    const std::string& joinCondition,
+    const std::vector<std::string>& outputLayout,
+    core::JoinType joinType) {
+  auto resultType = concat(planNode_->outputType(), right->outputType());
+  core::TypedExprPtr joinConditionExpr;
+  if (!joinCondition.empty()) {
+    joinConditionExpr = parseExpr(joinCondition, resultType, options_, pool_);
+  }
+  auto outputType = extract(resultType, outputLayout);
+
+  planNode_ = std::make_shared<core::NestedLoopJoinNode>(
+      nextPlanNodeId(),
+      joinType,
+      std::move(joinConditionExpr),
+      std::move(planNode_),
+      right,
+      outputType);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::unnest(
     const std::vector<std::string>& replicateColumns,
     const std::vector<std::string>& unnestColumns,
@@ -1333,6 +1422,19 @@ bool equalSortOrderList(
 
 PlanBuilder& PlanBuilder::window(
     const std::vector<std::string>& windowFunctions) {
+  planNode_ = createWindowNode(windowFunctions, false);
+  return *this;
+}
+
+PlanBuilder& PlanBuilder::streamingWindow(
+    const std::vector<std::string>& windowFunctions) {
+  planNode_ = createWindowNode(windowFunctions, true);
+  return *this;
+}
+
+core::PlanNodePtr PlanBuilder::createWindowNode(
+    const std::vector<std::string>& windowFunctions,
+    bool inputsSorted) {
   VELOX_CHECK_GT(
       windowFunctions.size(),
       0,
@@ -1404,15 +1506,15 @@ PlanBuilder& PlanBuilder::window(
     }
   }
 
-  planNode_ = std::make_shared<core::WindowNode>(
+  return std::make_shared<core::WindowNode>(
       nextPlanNodeId(),
       partitionKeys,
       sortingKeys,
       sortingOrders,
       windowNames,
       windowNodeFunctions,
+      inputsSorted,
       planNode_);
-  return *this;
 }
 
 core::PlanNodeId PlanBuilder::nextPlanNodeId() {
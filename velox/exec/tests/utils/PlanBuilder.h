@@ -172,6 +172,16 @@ class PlanBuilder {
       bool parallelizable = false,
       size_t repeatTimes = 1);
 
+  /// Add a ValueStreamNode where each driver reads a stream made by
+  /// 'streamFactory'. See FuzzerRowVectorStream and TpchRowVectorStream for
+  /// streams that generate data while read.
+  ///
+  /// @param outputType The type of the rows in the streams.
+  /// @param streamFactory Makes the stream of a driver given the driver id.
+  PlanBuilder& valueStream(
+      const RowTypePtr& outputType,
+      core::ValueStreamNode::StreamFactory streamFactory);
+
   /// Add an ExchangeNode.
   ///
   /// Use capturePlanNodeId method to capture the node ID needed for adding
@@ -296,6 +306,14 @@ class PlanBuilder {
   /// after partial or intermediate aggregation.
   PlanBuilder& finalAggregation();
 
+  /// Add a local exchange that hash partitions the output of the current
+  /// partial or intermediate aggregation node on its grouping keys, followed
+  /// by a final aggregation. The final aggregation runs in as many drivers as
+  /// the exchange has partitions, each merging a disjoint set of groups,
+  /// instead of merging all the groups in one driver. The output of a global
+  /// aggregation is gathered into one partition.
+  PlanBuilder& localPartitionedFinalAggregation();
+
   /// Add final aggregation plan node using specified grouping keys, aggregate
   /// expressions and their types.
   ///
@@ -485,6 +503,25 @@ class PlanBuilder {
   PlanBuilder&
   topN(const std::vector<std::string>& keys, int32_t count, bool isPartial);
 
+  /// Add a TopNRowNumberNode which produces the first 'limit' rows of each
+  /// partition in the order of the ORDER BY clauses, i.e. the rows with
+  /// row_number() over (partition by partitionKeys order by sortingKeys) <=
+  /// limit.
+  ///
+  /// For example,
+  ///
+  ///     .topNRowNumber({"a"}, {"b DESC"}, 10, true)
+  ///
+  /// @param partitionKeys Partition by columns. Can be empty.
+  /// @param sortingKeys ORDER BY clauses like in orderBy().
+  /// @param generateRowNumber Adds a BIGINT column named "row_number" with the
+  /// row numbers at the end of the input columns if true.
+  PlanBuilder& topNRowNumber(
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      int32_t limit,
+      bool generateRowNumber);
+
   /// Add a LimitNode.
   ///
   /// @param offset Offset, i.e. number of rows of input to skip.
@@ -538,6 +575,19 @@ class PlanBuilder {
       int numPartitions,
       const std::vector<std::string>& outputLayout = {});
 
+  /// Add a ShuffleWriteNode to hash-partition the input on the specified keys
+  /// into persistent files under 'shuffleDirectory'.
+  ///
+  /// @param keys Partitioning keys. May be empty, in which case all input will
+  /// be placed in a single partition.
+  /// @param numPartitions Number of partitions. Must be greater than or equal
+  /// to 1. Keys must not be empty if greater than 1.
+  /// @param shuffleDirectory Directory for the files of the producer task.
+  PlanBuilder& shuffleWrite(
+      const std::vector<std::string>& keys,
+      int numPartitions,
+      const std::string& shuffleDirectory);
+
   /// Add a PartitionedOutputNode to broadcast the input data.
   ///
   /// @param outputLayout Optional output layout in case it is different then
@@ -591,6 +641,8 @@ class PlanBuilder {
   /// @param joinType Type of the join: inner, left, right, full, semi, or anti.
   /// @param nullAware Applies to semi and anti joins. Indicates whether the
   /// join follows IN (null-aware) or EXISTS (regular) semantic.
+  /// @param buildCacheKey Optional key to cache the build side hash table
+  /// under. See core::HashJoinNode::buildCacheKey().
   PlanBuilder& hashJoin(
       const std::vector<std::string>& leftKeys,
       const std::vector<std::string>& rightKeys,
@@ -598,7 +650,8 @@ class PlanBuilder {
       const std::string& filter,
       const std::vector<std::string>& outputLayout,
       core::JoinType joinType = core::JoinType::kInner,
-      bool nullAware = false);
+      bool nullAware = false,
+      std::optional<std::string> buildCacheKey = std::nullopt);
 
   /// Add a MergeJoinNode to join two inputs using one or more join keys and an
   /// optional filter. The caller is responsible to ensure that inputs are
@@ -626,6 +679,23 @@ class PlanBuilder {
       const core::PlanNodePtr& right,
       const std::vector<std::string>& outputLayout);
 
+  /// Add a NestedLoopJoinNode to join two inputs using an arbitrary join
+  /// condition, e.g. a range condition like 'ts BETWEEN u_start AND u_end'.
+  /// Supports inner, left, right and full joins.
+  ///
+  /// @param right Right-side input. Typically, to reduce memory usage, the
+  /// smaller input is placed on the right-side.
+  /// @param joinCondition SQL expression that may reference columns from both
+  /// inputs. If empty, all pairs of rows match.
+  /// @param outputLayout Output layout consisting of columns from left and
+  /// right sides.
+  /// @param joinType Type of the join.
+  PlanBuilder& nestedLoopJoin(
+      const core::PlanNodePtr& right,
+      const std::string& joinCondition,
+      const std::vector<std::string>& outputLayout,
+      core::JoinType joinType = core::JoinType::kInner);
+
   /// Add an UnnestNode to unnest one or more columns of type array or map.
   ///
   /// The output will contain 'replicatedColumns' followed by unnested columns,
@@ -671,6 +741,12 @@ class PlanBuilder {
   ///  rows between a + 10 preceding and 10 following)"
   PlanBuilder& window(const std::vector<std::string>& windowFunctions);
 
+  /// Add a WindowNode like window() for input that is already clustered on the
+  /// PARTITION BY keys and sorted on the ORDER BY keys within each partition.
+  /// The window functions are computed one partition at a time as the input
+  /// arrives.
+  PlanBuilder& streamingWindow(const std::vector<std::string>& windowFunctions);
+
   /// Stores the latest plan node ID into the specified variable. Useful for
   /// capturing IDs of the leaf plan nodes (table scans, exchanges, etc.) to use
   /// when adding splits at runtime.
@@ -756,6 +832,10 @@ class PlanBuilder {
       const RowTypePtr& inputType,
       const std::string& name);
 
+  core::PlanNodePtr createWindowNode(
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted);
+
   core::PlanNodePtr createIntermediateOrFinalAggregation(
       core::AggregationNode::Step step,
       const core::AggregationNode* partialAggNode);
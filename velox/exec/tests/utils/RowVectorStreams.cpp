@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/tests/utils/RowVectorStreams.h"
+
+namespace facebook::velox::exec::test {
+
+FuzzerRowVectorStream::FuzzerRowVectorStream(
+    RowTypePtr rowType,
+    const VectorFuzzer::Options& options,
+    size_t seed,
+    size_t numBatches,
+    memory::MemoryPool* pool,
+    vector_size_t cardinality)
+    : rowType_(std::move(rowType)),
+      batchSize_(options.vectorSize),
+      pool_(pool),
+      fuzzer_(options, pool, seed),
+      batchesLeft_(numBatches),
+      rng_(seed) {
+  if (cardinality > 0) {
+    distinctRows_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(rowType_, cardinality, pool_));
+    auto distinctRows = fuzzer_.fuzzInputRow(rowType_);
+    for (vector_size_t row = 0; row < cardinality;) {
+      auto numRows =
+          std::min<vector_size_t>(distinctRows->size(), cardinality - row);
+      distinctRows_->copy(distinctRows.get(), row, 0, numRows);
+      row += numRows;
+      if (row < cardinality) {
+        distinctRows = fuzzer_.fuzzInputRow(rowType_);
+      }
+    }
+  }
+}
+
+RowVectorPtr FuzzerRowVectorStream::next() {
+  VELOX_CHECK(hasNext());
+  --batchesLeft_;
+  if (distinctRows_ == nullptr) {
+    return fuzzer_.fuzzInputRow(rowType_);
+  }
+
+  auto batch = std::static_pointer_cast<RowVector>(
+      BaseVector::create(rowType_, batchSize_, pool_));
+  std::vector<vector_size_t> sourceRows(batchSize_);
+  std::uniform_int_distribution<vector_size_t> distribution(
+      0, distinctRows_->size() - 1);
+  for (auto& row : sourceRows) {
+    row = distribution(rng_);
+  }
+  batch->copy(
+      distinctRows_.get(),
+      SelectivityVector(batchSize_),
+      sourceRows.data());
+  return batch;
+}
+
+// static
+core::ValueStreamNode::StreamFactory FuzzerRowVectorStream::factory(
+    RowTypePtr rowType,
+    const VectorFuzzer::Options& options,
+    size_t seed,
+    size_t numBatches,
+    vector_size_t cardinality) {
+  return [rowType, options, seed, numBatches, cardinality](
+             int32_t driverId, memory::MemoryPool* pool) {
+    return std::make_shared<FuzzerRowVectorStream>(
+        rowType, options, seed + driverId, numBatches, pool, cardinality);
+  };
+}
+
+TpchRowVectorStream::TpchRowVectorStream(
+    tpch::Table table,
+    double scaleFactor,
+    size_t batchSize,
+    size_t begin,
+    size_t end,
+    memory::MemoryPool* pool)
+    : table_(table),
+      scaleFactor_(scaleFactor),
+      batchSize_(batchSize),
+      end_(end),
+      pool_(pool),
+      offset_(begin) {
+  VELOX_CHECK_GT(batchSize_, 0);
+}
+
+RowVectorPtr TpchRowVectorStream::next() {
+  VELOX_CHECK(hasNext());
+  const auto maxRows = std::min(batchSize_, end_ - offset_);
+  const auto offset = offset_;
+  offset_ += maxRows;
+  switch (table_) {
+    case tpch::Table::TBL_PART:
+      return tpch::genTpchPart(pool_, maxRows, offset, scaleFactor_);
+    case tpch::Table::TBL_SUPPLIER:
+      return tpch::genTpchSupplier(pool_, maxRows, offset, scaleFactor_);
+    case tpch::Table::TBL_PARTSUPP:
+      return tpch::genTpchPartSupp(pool_, maxRows, offset, scaleFactor_);
+    case tpch::Table::TBL_CUSTOMER:
+      return tpch::genTpchCustomer(pool_, maxRows, offset, scaleFactor_);
+    case tpch::Table::TBL_ORDERS:
+      return tpch::genTpchOrders(pool_, maxRows, offset, scaleFactor_);
+    case tpch::Table::TBL_LINEITEM:
+      return tpch::genTpchLineItem(pool_, maxRows, offset, scaleFactor_);
+    case tpch::Table::TBL_NATION:
+      return tpch::genTpchNation(pool_, maxRows, offset, scaleFactor_);
+    case tpch::Table::TBL_REGION:
+      return tpch::genTpchRegion(pool_, maxRows, offset, scaleFactor_);
+  }
+  VELOX_UNREACHABLE();
+}
+
+// static
+core::ValueStreamNode::StreamFactory TpchRowVectorStream::factory(
+    tpch::Table table,
+    double scaleFactor,
+    size_t batchSize,
+    int32_t numDrivers) {
+  VELOX_CHECK_GT(numDrivers, 0);
+  // The lineitem rows are generated by order.
+  const auto numRows = tpch::getRowCount(
+      table == tpch::Table::TBL_LINEITEM ? tpch::Table::TBL_ORDERS : table,
+      scaleFactor);
+  return [table, scaleFactor, batchSize, numDrivers, numRows](
+             int32_t driverId, memory::MemoryPool* pool) {
+    VELOX_CHECK_LT(driverId, numDrivers);
+    return std::make_shared<TpchRowVectorStream>(
+        table,
+        scaleFactor,
+        batchSize,
+        numRows * driverId / numDrivers,
+        numRows * (driverId + 1) / numDrivers,
+        pool);
+  };
+}
+
+} // namespace facebook::velox::exec::test
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <random>
+
+#include "velox/core/PlanNode.h"
+#include "velox/tpch/gen/TpchGen.h"
+#include "velox/vector/ComplexVectorStream.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+namespace facebook::velox::exec::test {
+
+/// Produces 'numBatches' batches of random rows of 'rowType' made by a
+/// VectorFuzzer. Each batch is generated when read, so that a benchmark can
+/// run a pipeline on more data than fits in memory.
+///
+/// If 'cardinality' is not zero, the rows are drawn uniformly at random from
+/// 'cardinality' distinct fuzzed rows, e.g. to control the number of groups
+/// of an aggregation. The batches are flat in this case.
+class FuzzerRowVectorStream : public RowVectorStream {
+ public:
+  FuzzerRowVectorStream(
+      RowTypePtr rowType,
+      const VectorFuzzer::Options& options,
+      size_t seed,
+      size_t numBatches,
+      memory::MemoryPool* pool,
+      vector_size_t cardinality = 0);
+
+  bool hasNext() override {
+    return batchesLeft_ > 0;
+  }
+
+  RowVectorPtr next() override;
+
+  /// Returns a factory for a parallel ValueStreamNode where each driver reads
+  /// 'numBatches' batches seeded with 'seed' + driver id.
+  static core::ValueStreamNode::StreamFactory factory(
+      RowTypePtr rowType,
+      const VectorFuzzer::Options& options,
+      size_t seed,
+      size_t numBatches,
+      vector_size_t cardinality = 0);
+
+ private:
+  const RowTypePtr rowType_;
+  const vector_size_t batchSize_;
+  memory::MemoryPool* const pool_;
+  VectorFuzzer fuzzer_;
+  size_t batchesLeft_;
+
+  // The distinct rows to draw from if 'cardinality' is set.
+  RowVectorPtr distinctRows_;
+  std::mt19937 rng_;
+};
+
+/// Produces the rows of a TPC-H table in batches of up to 'batchSize' rows.
+/// The rows are generated when read. The stream covers rows [begin, end) of
+/// the table. For lineitem, 'batchSize', 'begin' and 'end' count the orders
+/// the lineitems belong to, see genTpchLineItem().
+class TpchRowVectorStream : public RowVectorStream {
+ public:
+  TpchRowVectorStream(
+      tpch::Table table,
+      double scaleFactor,
+      size_t batchSize,
+      size_t begin,
+      size_t end,
+      memory::MemoryPool* pool);
+
+  bool hasNext() override {
+    return offset_ < end_;
+  }
+
+  RowVectorPtr next() override;
+
+  /// Returns a factory for a parallel ValueStreamNode that runs in
+  /// 'numDrivers' drivers. The driver with id i produces the i-th of
+  /// 'numDrivers' slices of the table.
+  static core::ValueStreamNode::StreamFactory factory(
+      tpch::Table table,
+      double scaleFactor,
+      size_t batchSize,
+      int32_t numDrivers);
+
+ private:
+  const tpch::Table table_;
+  const double scaleFactor_;
+  const size_t batchSize_;
+  const size_t end_;
+  memory::MemoryPool* const pool_;
+  size_t offset_;
+};
+
+} // namespace facebook::velox::exec::test
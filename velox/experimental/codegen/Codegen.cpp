@@ -16,6 +16,7 @@
 
 #include "velox/experimental/codegen/Codegen.h"
 #include <glog/logging.h>
+#include <chrono>
 #include <memory>
 #include "velox/core/PlanNode.h"
 #include "velox/experimental/codegen/CodegenCompiledExpressionTransform.h"
@@ -65,11 +66,26 @@ bool Codegen::initializeFromFile(
 std::shared_ptr<const core::PlanNode> Codegen::compile(
     const core::PlanNode& planNode) {
   codegenLogger_->onCompileStart(planNode);
-  auto transformedPlanNode = transform_->transform(planNode);
+  const auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<const core::PlanNode> transformedPlanNode;
+  try {
+    transformedPlanNode = transform_->transform(planNode);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Codegen: running plan interpreted, compilation failed: "
+                 << e.what();
+  }
+
+  stats_ = transform_->stats();
+  stats_.transformTimeNanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+  stats_.fallback = transformedPlanNode == nullptr;
   codegenLogger_->onCompileEnd(
       *std::static_pointer_cast<DefaultScopedTimer::EventSequence>(
           eventSequence_),
       planNode);
+  VLOG(1) << "Codegen: " << stats_.toString();
   return transformedPlanNode;
 }
 
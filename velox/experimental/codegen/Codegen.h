@@ -20,6 +20,7 @@
 #include <string>
 #include "velox/core/PlanNode.h"
 #include "velox/experimental/codegen/CodegenLogger.h"
+#include "velox/experimental/codegen/CodegenStats.h"
 #include "velox/experimental/codegen/proto/codegen_proto.pb.h"
 
 namespace facebook {
@@ -46,9 +47,21 @@ class Codegen {
       const std::filesystem::path& codegenOptionsJsonFile,
       bool lazyLoading = true);
 
+  /// Returns 'planNode' with the supported filter and project expressions
+  /// replaced by compiled ones. Returns nullptr if the plan cannot be
+  /// compiled, e.g. because it has a node type the transformation does not
+  /// support or the compiler failed. The caller then runs the plan
+  /// interpreted.
   std::shared_ptr<const core::PlanNode> compile(const core::PlanNode& planNode);
 
+  /// Statistics of the last call to compile().
+  const CodegenStats& stats() const {
+    return stats_;
+  }
+
  private:
+  CodegenStats stats_;
+
   std::shared_ptr<ICodegenLogger> codegenLogger_;
 
   std::shared_ptr<CodeManager> codeManager_;
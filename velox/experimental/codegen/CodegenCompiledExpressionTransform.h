@@ -18,12 +18,15 @@
 // This file defines the tranasformation that replaces velox expressions with
 // codegen compiled expressions
 
+#include <chrono>
 #include <functional>
 #include <optional>
 #include "velox/core/PlanNode.h"
+#include "velox/experimental/codegen/CodegenStats.h"
 #include "velox/experimental/codegen/CompiledExpressionAnalysis.h"
 #include "velox/experimental/codegen/code_generator/ExprCodeGenerator.h"
 #include "velox/experimental/codegen/compiler_utils/CodeManager.h"
+#include "velox/experimental/codegen/compiler_utils/CompiledModuleCache.h"
 #include "velox/experimental/codegen/compiler_utils/ICompiledCall.h"
 #include "velox/experimental/codegen/transform/PlanNodeTransform.h"
 #include "velox/experimental/codegen/transform/utils/ranges_utils.h"
@@ -43,10 +46,12 @@ class CompiledExpressionTransformVisitor {
       const CompiledExpressionAnalysisResult& compiledExprAnalysisResult,
       const CompilerOptions& options,
       DefaultScopedTimer::EventSequence& eventSequence,
+      CodegenStats& stats,
       bool compileFilter = true,
       bool mergeFilter = true)
       : codeManager_(options, eventSequence),
         compiledExprAnalysisResult_(compiledExprAnalysisResult),
+        stats_(stats),
         compileFilter_(compileFilter),
         mergeFilter_(mergeFilter) {}
 
@@ -107,9 +112,37 @@ class CompiledExpressionTransformVisitor {
 
   const CompiledExpressionAnalysisResult& compiledExprAnalysisResult_;
 
+  CodegenStats& stats_;
+
   bool compileFilter_;
   bool mergeFilter_;
 
+  /// Compiles and links 'source' into a shared library and returns its path.
+  /// Reuses the library built from the same source for an earlier plan if
+  /// there is one.
+  std::filesystem::path compileAndLink(const std::string& source) {
+    const auto start = std::chrono::steady_clock::now();
+    bool cacheHit;
+    auto library = compiler_utils::CompiledModuleCache::instance().getOrBuild(
+        codeManager_.compiler().compilerOptions(),
+        source,
+        [&]() {
+          auto object = codeManager_.compiler().compileString({}, source);
+          return codeManager_.compiler().link({}, {object});
+        },
+        cacheHit);
+    if (cacheHit) {
+      ++stats_.numModuleCacheHits;
+    } else {
+      ++stats_.numModulesCompiled;
+    }
+    stats_.compileTimeNanos +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    return library;
+  }
+
   std::optional<std::reference_wrapper<const GeneratedExpressionStruct>>
   getGeneratedCode(const std::shared_ptr<const ITypedExpr>& expression) {
     auto it = compiledExprAnalysisResult_.generatedCode_.find(expression);
@@ -487,8 +520,7 @@ class CompiledExpressionTransformVisitor {
             fmt::arg(
                 "isDefaultNullStrict",
                 isDefaultNullStrict(filter.id()) ? "true" : "false")));
-    auto compiledObject = codeManager_.compiler().compileString({}, fileString);
-    auto dynamicObject = codeManager_.compiler().link({}, {compiledObject});
+    auto dynamicObject = compileAndLink(fileString);
 
     // Extract the row input expression from the current filter
     const auto inputType = filter.sources()[0]->outputType();
@@ -586,8 +618,7 @@ class CompiledExpressionTransformVisitor {
                 "isDefaultNullStrict",
                 isDefaultNullStrict ? "true" : "false")));
 
-    auto compiledObject = codeManager_.compiler().compileString({}, fileString);
-    auto dynamicObject = codeManager_.compiler().link({}, {compiledObject});
+    auto dynamicObject = compileAndLink(fileString);
     std::vector<std::shared_ptr<const ITypedExpr>> newProjections;
 
     // Extract the row input expression from the current projection
@@ -671,6 +702,7 @@ class CodegenCompiledExpressionTransform final : PlanNodeTransform {
       const core::PlanNode& plan) override {
     DefaultScopedTimer timer(
         "CodegenCompiledExpressionTransform", eventSequence_);
+    stats_ = CodegenStats();
 
     CompiledExpressionAnalysis expressionAnalysis(
         udfManager_,
@@ -685,6 +717,7 @@ class CodegenCompiledExpressionTransform final : PlanNodeTransform {
         expressionAnalysis.results(),
         compilerOptions_,
         eventSequence_,
+        stats_,
         flags_.compileFilter,
         flags_.mergeFilter);
 
@@ -702,12 +735,18 @@ class CodegenCompiledExpressionTransform final : PlanNodeTransform {
     flags_ = flags;
   }
 
+  /// Compile statistics of the last call to transform().
+  const CodegenStats& stats() const {
+    return stats_;
+  }
+
  private:
   CompilerOptions compilerOptions_;
   const UDFManager& udfManager_;
   bool useSymbolsForArithmetic_;
   NamedSteadyClockEventSequence& eventSequence_;
   TransformFlags flags_;
+  CodegenStats stats_;
 };
 
 } // namespace codegen
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "fmt/format.h"
+
+namespace facebook::velox::codegen {
+
+/// Statistics of compiling the expressions of one plan with Codegen. The
+/// time spent running the compiled code is reported in the stats of the
+/// FilterProject operators like for interpreted expressions.
+struct CodegenStats {
+  /// Number of shared libraries built by the compiler and the linker.
+  uint64_t numModulesCompiled{0};
+
+  /// Number of shared libraries reused from earlier plans.
+  uint64_t numModuleCacheHits{0};
+
+  /// Time spent compiling and linking.
+  uint64_t compileTimeNanos{0};
+
+  /// Time spent transforming the plan. Includes the analysis, the code
+  /// generation and 'compileTimeNanos'.
+  uint64_t transformTimeNanos{0};
+
+  /// True if the plan could not be compiled and runs interpreted.
+  bool fallback{false};
+
+  std::string toString() const {
+    return fmt::format(
+        "numModulesCompiled: {}, numModuleCacheHits: {}, "
+        "compileTimeNanos: {}, transformTimeNanos: {}, fallback: {}",
+        numModulesCompiled,
+        numModuleCacheHits,
+        compileTimeNanos,
+        transformTimeNanos,
+        fallback);
+  }
+};
+
+} // namespace facebook::velox::codegen
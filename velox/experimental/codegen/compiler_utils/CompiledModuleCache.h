@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "fmt/format.h"
+#include "velox/experimental/codegen/compiler_utils/CompilerOptions.h"
+
+namespace facebook::velox::codegen::compiler_utils {
+
+/// Process wide cache of the shared libraries built from generated code. A
+/// library is found by its source code and the compiler options it was
+/// built with, so that queries with the same expressions over the same types
+/// load the library built for the first of them instead of running the
+/// compiler and the linker again.
+class CompiledModuleCache {
+ public:
+  static CompiledModuleCache& instance() {
+    static CompiledModuleCache cache;
+    return cache;
+  }
+
+  /// Returns the library built from 'source' with 'options'. Calls 'build'
+  /// to compile and link it if the cache has no library for 'source' or if
+  /// the file of the cached library was removed. Sets 'cacheHit' to true if
+  /// 'build' was not called. 'build' runs without holding the cache lock. If
+  /// two callers build the same source concurrently, the first library
+  /// added is kept.
+  std::filesystem::path getOrBuild(
+      const CompilerOptions& options,
+      const std::string& source,
+      const std::function<std::filesystem::path()>& build,
+      bool& cacheHit) {
+    auto key = cacheKey(options, source);
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      auto it = libraries_.find(key);
+      if (it != libraries_.end() && std::filesystem::exists(it->second)) {
+        cacheHit = true;
+        return it->second;
+      }
+    }
+    cacheHit = false;
+    auto library = build();
+    std::lock_guard<std::mutex> l(mutex_);
+    auto [it, inserted] = libraries_.emplace(std::move(key), library);
+    if (!inserted && !std::filesystem::exists(it->second)) {
+      it->second = library;
+    }
+    return it->second;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return libraries_.size();
+  }
+
+  /// Drops all entries. The library files are not removed.
+  void clear() {
+    std::lock_guard<std::mutex> l(mutex_);
+    libraries_.clear();
+  }
+
+ private:
+  // The options that change the code built from the same source come before
+  // the source.
+  static std::string cacheKey(
+      const CompilerOptions& options,
+      const std::string& source) {
+    return fmt::format(
+        "{}\n{}\n{}\n{}\n{}",
+        options.compilerPath.string(),
+        options.optimizationLevel,
+        fmt::join(options.extraCompileOptions, " "),
+        fmt::join(options.extraLinkOptions, " "),
+        source);
+  }
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::filesystem::path> libraries_;
+};
+
+} // namespace facebook::velox::codegen::compiler_utils
@@ -20,6 +20,7 @@
 #include <iostream>
 #include <regex>
 #include "boost/filesystem.hpp"
+#include "velox/experimental/codegen/compiler_utils/CompiledModuleCache.h"
 #include "velox/experimental/codegen/compiler_utils/Compiler.h"
 #include "velox/experimental/codegen/compiler_utils/tests/definitions.h"
 #include "velox/experimental/codegen/external_process/Filesystem.h"
@@ -290,4 +291,46 @@ TEST(Compiler, CompileAndLink) {
   ASSERT_EQ(dlerror(), nullptr);
   ASSERT_EQ(f(), 24);
 };
+TEST(CompilerUtils, compiledModuleCache) {
+  auto& cache = CompiledModuleCache::instance();
+  cache.clear();
+  auto options = CompilerOptions()
+                     .withCompilerPath("/usr/bin/clang")
+                     .withOptimizationLevel("-O3");
+  auto directory = std::filesystem::temp_directory_path();
+  int32_t numBuilds = 0;
+  auto build = [&]() {
+    auto path =
+        directory / fmt::format("compiledModuleCache{}.so", numBuilds++);
+    std::ofstream(path) << "library";
+    return path;
+  };
+
+  bool cacheHit;
+  auto library = cache.getOrBuild(options, "int f() {}", build, cacheHit);
+  ASSERT_FALSE(cacheHit);
+  ASSERT_EQ(cache.getOrBuild(options, "int f() {}", build, cacheHit), library);
+  ASSERT_TRUE(cacheHit);
+  ASSERT_EQ(numBuilds, 1);
+
+  // A different source or different options build a new library.
+  auto other = cache.getOrBuild(options, "int g() {}", build, cacheHit);
+  ASSERT_FALSE(cacheHit);
+  ASSERT_NE(other, library);
+  auto optionsO0 = CompilerOptions(options).withOptimizationLevel("-O0");
+  cache.getOrBuild(optionsO0, "int f() {}", build, cacheHit);
+  ASSERT_FALSE(cacheHit);
+  ASSERT_EQ(numBuilds, 3);
+  ASSERT_EQ(cache.size(), 3);
+
+  // A library whose file is gone is built again.
+  std::filesystem::remove(library);
+  auto rebuilt = cache.getOrBuild(options, "int f() {}", build, cacheHit);
+  ASSERT_FALSE(cacheHit);
+  ASSERT_NE(rebuilt, library);
+  ASSERT_EQ(cache.getOrBuild(options, "int f() {}", build, cacheHit), rebuilt);
+  ASSERT_TRUE(cacheHit);
+  cache.clear();
+}
+
 } // namespace facebook::velox::codegen::compiler_utils::test
@@ -15,13 +15,11 @@
  */
 
 #include "velox/experimental/exec/OffProcessExpressionEval.h"
+#include <folly/futures/Future.h>
+#include "velox/common/time/Timer.h"
 
 namespace facebook::velox::exec {
 
-// Maximum buffer size in bytes for stream groups before they are
-// flushed.
-constexpr int32_t kMaxStreamGroupSizeBytes{50000};
-
 void OffProcessExpressionEvalNode::addDetails(std::stringstream& stream) const {
   stream << "expressions: ";
   for (auto i = 0; i < expressions_.size(); i++) {
@@ -45,73 +43,90 @@ OffProcessExpressionEvalOperator::OffProcessExpressionEvalOperator(
           planNode->id(),
           "OffProcessExpressionEval"),
       inputType_(planNode->sources().front()->outputType()),
-      expressions_{planNode->expressions()} {}
+      expressions_{planNode->expressions()},
+      transport_{OffProcessTransportPool::instance().acquire()} {
+  transport_->begin(inputType_, expressions_);
+}
 
 void OffProcessExpressionEvalOperator::addInput(RowVectorPtr input) {
-  if (!streamGroup_) {
-    streamGroup_ = std::make_unique<VectorStreamGroup>(pool());
-    streamGroup_->createStreamTree(inputType_, 1000);
-  }
-
-  IndexRange range{0, input->size()};
-  streamGroup_->append(input, folly::Range<IndexRange*>(&range, 1));
+  VELOX_CHECK_NULL(pendingInput_);
+  pendingInput_ = std::move(input);
+  trySendPendingInput();
+}
 
-  if (streamGroup_->size() > kMaxStreamGroupSizeBytes) {
-    flushStreamGroup();
+void OffProcessExpressionEvalOperator::trySendPendingInput() {
+  if (pendingInput_ != nullptr && transport_->trySend(pendingInput_)) {
+    pendingInput_ = nullptr;
+    ++numInFlight_;
+    endWait();
   }
 }
 
-void OffProcessExpressionEvalOperator::flushStreamGroup() {
-  if (streamGroup_) {
-    IOBufOutputStream stream(*pool());
-    streamGroup_->flush(&stream);
-    addRuntimeStat(
-        "dataFlushes",
-        RuntimeCounter(streamGroup_->size(), RuntimeCounter::Unit::kBytes));
-
-    auto ioBuf = stream.getIOBuf();
-    streamGroup_.reset();
-
-    ioBuf_ = sendOffProcess(expressions_, std::move(ioBuf));
+void OffProcessExpressionEvalOperator::tryReceiveOutput() {
+  if (output_ != nullptr || numInFlight_ == 0) {
+    return;
+  }
+  output_ = transport_->tryReceive(pool());
+  if (output_ != nullptr) {
+    --numInFlight_;
+    endWait();
   }
 }
 
-std::unique_ptr<folly::IOBuf> OffProcessExpressionEvalOperator::sendOffProcess(
-    const std::vector<core::TypedExprPtr>& /* expressions */,
-    std::unique_ptr<folly::IOBuf>&& ioBuf) {
-  // TODO: Implement a pluggable logic to send data off-process.
-  return std::move(ioBuf);
+void OffProcessExpressionEvalOperator::endWait() {
+  if (waitStartMicros_ == 0) {
+    return;
+  }
+  const auto waitMicros = getCurrentTimeMicro() - waitStartMicros_;
+  waitStartMicros_ = 0;
+  addRuntimeStat(
+      "offProcessWaitNanos",
+      RuntimeCounter(waitMicros * 1'000, RuntimeCounter::Unit::kNanos));
 }
 
-void OffProcessExpressionEvalOperator::noMoreInput() {
-  flushStreamGroup();
-  Operator::noMoreInput();
+exec::BlockingReason OffProcessExpressionEvalOperator::isBlocked(
+    ContinueFuture* future) {
+  trySendPendingInput();
+  tryReceiveOutput();
+  if (output_ != nullptr || numInFlight_ == 0 ||
+      (pendingInput_ == nullptr && !noMoreInput_)) {
+    return exec::BlockingReason::kNotBlocked;
+  }
+  const auto nowMicros = getCurrentTimeMicro();
+  if (waitStartMicros_ == 0) {
+    waitStartMicros_ = nowMicros;
+  }
+  transport_->checkRemote(nowMicros - waitStartMicros_);
+  *future = folly::futures::sleep(kPollInterval);
+  // A pending input waits for the remote process to take it, otherwise the
+  // operator waits for a result.
+  return pendingInput_ != nullptr ? exec::BlockingReason::kWaitForConsumer
+                                  : exec::BlockingReason::kWaitForProducer;
 }
 
 RowVectorPtr OffProcessExpressionEvalOperator::getOutput() {
-  if (!ioBuf_) {
-    return nullptr;
+  trySendPendingInput();
+  tryReceiveOutput();
+  auto output = std::move(output_);
+  output_ = nullptr;
+  if (output != nullptr) {
+    trySendPendingInput();
   }
-
-  auto outputVector = deserializeIOBuf(*ioBuf_);
-  ioBuf_.reset();
-  return outputVector;
+  return output;
 }
 
-RowVectorPtr OffProcessExpressionEvalOperator::deserializeIOBuf(
-    const folly::IOBuf& ioBuf) {
-  std::vector<ByteRange> ranges;
-  ranges.reserve(4);
-
-  for (const auto& range : ioBuf) {
-    ranges.emplace_back(ByteRange{
-        const_cast<uint8_t*>(range.data()), (int32_t)range.size(), 0});
+void OffProcessExpressionEvalOperator::close() {
+  if (transport_ != nullptr) {
+    if (pendingInput_ == nullptr && numInFlight_ == 0) {
+      // The transport is reused by the next operator, possibly of another
+      // task.
+      transport_->end();
+      OffProcessTransportPool::instance().release(std::move(transport_));
+    }
+    transport_.reset();
   }
-  byteStream_.resetInput(std::move(ranges));
-
-  RowVectorPtr outputVector;
-  VectorStreamGroup::read(&byteStream_, pool(), outputType_, &outputVector);
-  return outputVector;
+  output_ = nullptr;
+  Operator::close();
 }
 
 } // namespace facebook::velox::exec
@@ -15,17 +15,17 @@
  */
 #pragma once
 
-#include <folly/io/IOBuf.h>
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Operator.h"
-#include "velox/vector/VectorStream.h"
+#include "velox/experimental/exec/OffProcessTransport.h"
 
 namespace facebook::velox::exec {
 
 /// This file contains the plan node and operators that can be used for
-/// off-process expression evaluation in a plan. The operator serializes input
-/// batches and sends them to a remote process along with the expressions
-/// specified in `expressions`.
+/// off-process expression evaluation in a plan. The operator sends input
+/// batches to a remote process along with the expressions specified in
+/// `expressions` through an OffProcessTransport from the
+/// OffProcessTransportPool.
 
 /// Off-process expression eval plan node. `expressions` control the expressions
 /// that will be remotely executed.
@@ -73,43 +73,56 @@ class OffProcessExpressionEvalOperator : public exec::Operator {
 
   void addInput(RowVectorPtr input) override;
 
-  void noMoreInput() override;
-
   bool needsInput() const override {
-    return !noMoreInput_;
+    return !noMoreInput_ && pendingInput_ == nullptr;
   }
 
   RowVectorPtr getOutput() override;
 
-  exec::BlockingReason isBlocked(ContinueFuture* /* future */) override {
-    return exec::BlockingReason::kNotBlocked;
-  }
+  /// Blocked if neither the pending input can be sent nor a result received.
+  /// The transport has no notification, so the returned future is a timer
+  /// after which the transport is polled again. Throws if the remote process
+  /// has exited or has made no progress within the timeout of the transport.
+  exec::BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override {
-    return noMoreInput_;
+    return noMoreInput_ && pendingInput_ == nullptr && numInFlight_ == 0 &&
+        output_ == nullptr;
   }
 
- private:
-  // Sends the current IOBuf off-process, returning the result IOBuf received
-  // from the remote process.
-  //
-  // TODO: this function will need to return a future.
-  std::unique_ptr<folly::IOBuf> sendOffProcess(
-      const std::vector<core::TypedExprPtr>& expressions,
-      std::unique_ptr<folly::IOBuf>&& ioBuf);
+  void close() override;
 
-  // Flushes the current stream group contents.
-  void flushStreamGroup();
+ private:
+  // The interval at which a blocked operator polls the transport.
+  static constexpr std::chrono::microseconds kPollInterval{100};
 
-  RowVectorPtr deserializeIOBuf(const folly::IOBuf& ioBuf);
+  // Sends 'pendingInput_' if the transport has room for it.
+  void trySendPendingInput();
 
-  std::unique_ptr<VectorStreamGroup> streamGroup_;
-  ByteStream byteStream_;
+  // Receives the result of the oldest batch in flight into 'output_' if it is
+  // ready.
+  void tryReceiveOutput();
 
-  std::unique_ptr<folly::IOBuf> ioBuf_;
+  // Records the time waited for the transport when it makes progress.
+  void endWait();
 
   RowTypePtr inputType_;
   std::vector<core::TypedExprPtr> expressions_;
+
+  std::unique_ptr<OffProcessTransport> transport_;
+
+  // The input not yet accepted by 'transport_'.
+  RowVectorPtr pendingInput_;
+
+  // The result received by isBlocked() and not yet returned by getOutput().
+  RowVectorPtr output_;
+
+  // The time the operator started waiting for the transport. 0 if not
+  // waiting.
+  uint64_t waitStartMicros_{0};
+
+  // The number of batches sent and not yet received.
+  int32_t numInFlight_{0};
 };
 
 class OffProcessExpressionEvalTranslator
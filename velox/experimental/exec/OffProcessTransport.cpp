@@ -0,0 +1,555 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/experimental/exec/OffProcessTransport.h"
+
+#include <folly/json.h>
+#include <glog/logging.h>
+#include <signal.h>
+#include <cerrno>
+#include <thread>
+#include "velox/common/time/Timer.h"
+#include "velox/vector/FlatVector.h"
+#include "velox/vector/VectorStream.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+// The first 8 bytes of each message.
+enum class MessageKind : uint64_t {
+  // Followed by the JSON of the input type and the expressions.
+  kBegin,
+  // Followed by a batch in the raw format.
+  kRawBatch,
+  // Followed by a batch in the Presto serialization format.
+  kSerializedBatch,
+  kEnd,
+  kShutdown,
+  // Followed by the error message of a failed batch.
+  kError,
+};
+
+// Returns true if the process 'pid' exists or if 'pid' is 0. A process that
+// has exited and is not reaped yet still exists, which the timeouts cover.
+bool isProcessAlive(pid_t pid) {
+  return pid == 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// Calls 'tryAction' until it returns true, yielding and then sleeping in
+// between. While sleeping, calls 'check' with the microseconds waited so far
+// every few milliseconds and gives up if it returns false. 'check' may also
+// throw. Returns true if 'tryAction' succeeded.
+template <typename TryAction, typename Check>
+bool waitFor(TryAction tryAction, Check check) {
+  const auto startMicros = getCurrentTimeMicro();
+  for (int32_t attempt = 0; !tryAction(); ++attempt) {
+    if (attempt < 1'000) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    if (attempt % 100 == 0 && !check(getCurrentTimeMicro() - startMicros)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns a check for waitFor() that throws if 'transport' gives up on its
+// remote process.
+auto makeRemoteCheck(OffProcessTransport& transport) {
+  return [&transport](uint64_t waitMicros) {
+    transport.checkRemote(waitMicros);
+    return true;
+  };
+}
+
+template <typename T>
+folly::ByteRange toRange(const T* data, size_t size) {
+  return folly::ByteRange(reinterpret_cast<const uint8_t*>(data), size);
+}
+
+bool tryWrite(
+    SharedMemoryRingBuffer& ring,
+    const std::vector<folly::ByteRange>& parts) {
+  return ring.tryWrite(
+      folly::Range<const folly::ByteRange*>(parts.data(), parts.size()));
+}
+
+template <typename Check>
+bool write(
+    SharedMemoryRingBuffer& ring,
+    const std::vector<folly::ByteRange>& parts,
+    Check check) {
+  return waitFor([&]() { return tryWrite(ring, parts); }, check);
+}
+
+template <typename Check>
+bool writeMessage(
+    SharedMemoryRingBuffer& ring,
+    MessageKind kind,
+    Check check,
+    std::string_view payload = {}) {
+  const std::vector<folly::ByteRange> parts = {
+      toRange(&kind, sizeof(MessageKind)),
+      toRange(payload.data(), payload.size())};
+  return write(ring, parts, check);
+}
+
+MessageKind messageKind(folly::ByteRange message) {
+  VELOX_CHECK_GE(message.size(), sizeof(MessageKind));
+  MessageKind kind;
+  memcpy(&kind, message.data(), sizeof(MessageKind));
+  return kind;
+}
+
+folly::ByteRange payload(folly::ByteRange message) {
+  return message.subpiece(sizeof(MessageKind));
+}
+
+bool isRawType(const TypePtr& type) {
+  return type->kind() == TypeKind::VARCHAR ||
+      type->kind() == TypeKind::VARBINARY ||
+      (type->isFixedWidth() && type->kind() != TypeKind::UNKNOWN);
+}
+
+// A batch with the ranges of its message. The ranges point into 'header',
+// 'columns', 'lengths', 'strings' and 'serialized'.
+struct EncodedBatch {
+  // The message kind, then the number of rows and columns, then 3 words per
+  // column: whether there are nulls and the sizes of the values and the
+  // strings. The nulls and values of each column follow in that order.
+  std::vector<uint64_t> header;
+  std::vector<VectorPtr> columns;
+  std::vector<std::vector<int32_t>> lengths;
+  std::vector<std::string> strings;
+  std::unique_ptr<folly::IOBuf> serialized;
+  std::vector<folly::ByteRange> parts;
+};
+
+void encodeSerializedBatch(const RowVectorPtr& input, EncodedBatch& batch) {
+  VectorStreamGroup streamGroup(input->pool());
+  streamGroup.createStreamTree(asRowType(input->type()), input->size());
+  IndexRange range{0, input->size()};
+  streamGroup.append(input, folly::Range<IndexRange*>(&range, 1));
+  IOBufOutputStream stream(*input->pool());
+  streamGroup.flush(&stream);
+  batch.serialized = stream.getIOBuf();
+
+  batch.header = {static_cast<uint64_t>(MessageKind::kSerializedBatch)};
+  batch.parts.push_back(toRange(batch.header.data(), sizeof(uint64_t)));
+  for (const auto& buffer : *batch.serialized) {
+    batch.parts.push_back(buffer);
+  }
+}
+
+void encodeBatch(const RowVectorPtr& input, EncodedBatch& batch) {
+  const auto& rowType = asRowType(input->type());
+  for (const auto& type : rowType->children()) {
+    if (!isRawType(type)) {
+      encodeSerializedBatch(input, batch);
+      return;
+    }
+  }
+
+  const auto numRows = input->size();
+  const auto numColumns = input->childrenSize();
+  batch.header = {
+      static_cast<uint64_t>(MessageKind::kRawBatch), numRows, numColumns};
+  batch.lengths.resize(numColumns);
+  batch.strings.resize(numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    auto column = BaseVector::loadedVectorShared(input->childAt(i));
+    if (column->encoding() != VectorEncoding::Simple::FLAT) {
+      BaseVector::flattenVector(column, numRows);
+    }
+    const auto& type = column->type();
+    const bool hasNulls = column->mayHaveNulls();
+    uint64_t valuesBytes;
+    uint64_t stringBytes = 0;
+    if (type->isFixedWidth()) {
+      valuesBytes = type->kind() == TypeKind::BOOLEAN
+          ? bits::nbytes(numRows)
+          : numRows * type->cppSizeInBytes();
+    } else {
+      auto& lengths = batch.lengths[i];
+      auto& strings = batch.strings[i];
+      lengths.resize(numRows);
+      const auto* values = column->asFlatVector<StringView>()->rawValues();
+      for (auto row = 0; row < numRows; ++row) {
+        if (hasNulls && column->isNullAt(row)) {
+          lengths[row] = 0;
+          continue;
+        }
+        lengths[row] = values[row].size();
+        strings.append(values[row].data(), values[row].size());
+      }
+      valuesBytes = numRows * sizeof(int32_t);
+      stringBytes = strings.size();
+    }
+    batch.header.push_back(hasNulls);
+    batch.header.push_back(valuesBytes);
+    batch.header.push_back(stringBytes);
+    batch.columns.push_back(std::move(column));
+  }
+
+  batch.parts.push_back(
+      toRange(batch.header.data(), batch.header.size() * sizeof(uint64_t)));
+  for (auto i = 0; i < numColumns; ++i) {
+    const auto& column = batch.columns[i];
+    if (column->mayHaveNulls()) {
+      batch.parts.push_back(
+          toRange(column->rawNulls(), bits::nbytes(numRows)));
+    }
+    const auto valuesBytes = batch.header[3 + i * 3 + 1];
+    if (column->type()->isFixedWidth()) {
+      VELOX_CHECK_NOT_NULL(column->values());
+      batch.parts.push_back(
+          toRange(column->values()->as<uint8_t>(), valuesBytes));
+    } else {
+      batch.parts.push_back(toRange(batch.lengths[i].data(), valuesBytes));
+      batch.parts.push_back(
+          toRange(batch.strings[i].data(), batch.strings[i].size()));
+    }
+  }
+}
+
+RowVectorPtr decodeSerializedBatch(
+    folly::ByteRange data,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) {
+  ByteStream byteStream;
+  byteStream.resetInput({ByteRange{
+      const_cast<uint8_t*>(data.data()),
+      static_cast<int32_t>(data.size()),
+      0}});
+  RowVectorPtr result;
+  VectorStreamGroup::read(&byteStream, pool, type, &result);
+  return result;
+}
+
+RowVectorPtr decodeRawBatch(
+    folly::ByteRange data,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) {
+  const auto* header = reinterpret_cast<const uint64_t*>(data.data());
+  const vector_size_t numRows = header[0];
+  const auto numColumns = header[1];
+  VELOX_CHECK_EQ(numColumns, type->size());
+  const auto* cursor = data.data() + (2 + 3 * numColumns) * sizeof(uint64_t);
+
+  std::vector<VectorPtr> children;
+  for (auto i = 0; i < numColumns; ++i) {
+    const bool hasNulls = header[2 + 3 * i];
+    const auto valuesBytes = header[2 + 3 * i + 1];
+    const auto stringBytes = header[2 + 3 * i + 2];
+    const auto& childType = type->childAt(i);
+    auto child = BaseVector::create(childType, numRows, pool);
+    if (hasNulls) {
+      memcpy(child->mutableRawNulls(), cursor, bits::nbytes(numRows));
+      cursor += bits::nbytes(numRows);
+    }
+    if (childType->isFixedWidth()) {
+      memcpy(child->values()->asMutable<uint8_t>(), cursor, valuesBytes);
+      cursor += valuesBytes;
+    } else {
+      // The lengths may not be aligned.
+      const auto* lengths = cursor;
+      cursor += valuesBytes;
+      auto strings = AlignedBuffer::allocate<char>(stringBytes, pool);
+      memcpy(strings->asMutable<char>(), cursor, stringBytes);
+      cursor += stringBytes;
+      auto* flat = child->asFlatVector<StringView>();
+      const auto* rawStrings = strings->as<char>();
+      for (auto row = 0; row < numRows; ++row) {
+        if (!hasNulls || !child->isNullAt(row)) {
+          int32_t length;
+          memcpy(&length, lengths + row * sizeof(int32_t), sizeof(int32_t));
+          flat->setNoCopy(row, StringView(rawStrings, length));
+          rawStrings += length;
+        }
+      }
+      flat->addStringBuffer(strings);
+    }
+    children.push_back(std::move(child));
+  }
+  VELOX_CHECK_EQ(cursor, data.end());
+  return std::make_shared<RowVector>(
+      pool, type, nullptr, numRows, std::move(children));
+}
+
+// Decodes a message of kind kRawBatch or kSerializedBatch.
+RowVectorPtr decodeBatch(
+    folly::ByteRange message,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) {
+  if (messageKind(message) == MessageKind::kRawBatch) {
+    return decodeRawBatch(payload(message), type, pool);
+  }
+  VELOX_CHECK(messageKind(message) == MessageKind::kSerializedBatch);
+  return decodeSerializedBatch(payload(message), type, pool);
+}
+
+} // namespace
+
+bool LoopbackTransport::trySend(const RowVectorPtr& input) {
+  if (inFlight_.size() >= maxBatchesInFlight_) {
+    return false;
+  }
+  inFlight_.push_back(input);
+  return true;
+}
+
+RowVectorPtr LoopbackTransport::tryReceive(memory::MemoryPool* /* pool */) {
+  if (inFlight_.empty()) {
+    return nullptr;
+  }
+  auto result = std::move(inFlight_.front());
+  inFlight_.pop_front();
+  return result;
+}
+
+void LoopbackTransport::end() {
+  VELOX_CHECK(inFlight_.empty());
+}
+
+SharedMemoryTransport::SharedMemoryTransport(
+    std::shared_ptr<SharedMemoryRingBuffer> requests,
+    std::shared_ptr<SharedMemoryRingBuffer> responses,
+    int32_t maxBatchesInFlight,
+    uint64_t timeoutMs,
+    pid_t remotePid)
+    : requests_(std::move(requests)),
+      responses_(std::move(responses)),
+      maxBatchesInFlight_(maxBatchesInFlight),
+      timeoutMs_(timeoutMs),
+      remotePid_(remotePid) {
+  VELOX_CHECK_NOT_NULL(requests_);
+  VELOX_CHECK_NOT_NULL(responses_);
+  VELOX_CHECK_GT(maxBatchesInFlight_, 0);
+  VELOX_CHECK_GT(timeoutMs_, 0);
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+  // Gives up if the remote process does not read its requests, since this
+  // may not throw.
+  const bool shutdown = writeMessage(
+      *requests_, MessageKind::kShutdown, [&](uint64_t waitMicros) {
+        return isProcessAlive(remotePid_) && waitMicros < timeoutMs_ * 1'000;
+      });
+  if (!shutdown) {
+    LOG(WARNING) << "Failed to shut down the off-process expression "
+                 << "evaluation process " << remotePid_;
+  }
+}
+
+void SharedMemoryTransport::checkRemote(uint64_t waitMicros) {
+  if (!isProcessAlive(remotePid_)) {
+    VELOX_FAIL(
+        "Off-process expression evaluation process {} has exited",
+        remotePid_);
+  }
+  if (waitMicros >= timeoutMs_ * 1'000) {
+    VELOX_FAIL(
+        "Off-process expression evaluation made no progress for {} ms",
+        waitMicros / 1'000);
+  }
+}
+
+void SharedMemoryTransport::begin(
+    const RowTypePtr& inputType,
+    const std::vector<core::TypedExprPtr>& expressions) {
+  VELOX_CHECK_NULL(inputType_, "The previous stream has not ended");
+  inputType_ = inputType;
+  folly::dynamic serializedExpressions = folly::dynamic::array;
+  for (const auto& expression : expressions) {
+    serializedExpressions.push_back(expression->serialize());
+  }
+  folly::dynamic obj = folly::dynamic::object;
+  obj["inputType"] = inputType->serialize();
+  obj["expressions"] = std::move(serializedExpressions);
+  writeMessage(
+      *requests_,
+      MessageKind::kBegin,
+      makeRemoteCheck(*this),
+      folly::toJson(obj));
+}
+
+bool SharedMemoryTransport::trySend(const RowVectorPtr& input) {
+  VELOX_CHECK_NOT_NULL(inputType_, "begin() was not called");
+  if (numInFlight_ >= maxBatchesInFlight_) {
+    return false;
+  }
+  EncodedBatch batch;
+  encodeBatch(input, batch);
+  if (!tryWrite(*requests_, batch.parts)) {
+    return false;
+  }
+  ++numInFlight_;
+  return true;
+}
+
+RowVectorPtr SharedMemoryTransport::tryReceive(memory::MemoryPool* pool) {
+  auto message = responses_->peek();
+  if (!message.has_value()) {
+    return nullptr;
+  }
+  VELOX_CHECK_GT(numInFlight_, 0);
+  --numInFlight_;
+  if (messageKind(*message) == MessageKind::kError) {
+    const auto error = payload(*message).toString();
+    responses_->consume();
+    VELOX_FAIL("Off-process expression evaluation failed: {}", error);
+  }
+  auto result = decodeBatch(*message, inputType_, pool);
+  responses_->consume();
+  return result;
+}
+
+void SharedMemoryTransport::end() {
+  VELOX_CHECK_EQ(numInFlight_, 0, "Not all results have been received");
+  writeMessage(*requests_, MessageKind::kEnd, makeRemoteCheck(*this));
+  inputType_ = nullptr;
+}
+
+void serveSharedMemoryTransport(
+    SharedMemoryRingBuffer& requests,
+    SharedMemoryRingBuffer& responses,
+    OffProcessEvaluator& evaluator,
+    memory::MemoryPool* pool,
+    pid_t clientPid) {
+  // Stops serving if the client is gone, since nothing reads the responses
+  // or writes the requests then.
+  const auto isClientAlive = [clientPid](uint64_t /* waitMicros */) {
+    return isProcessAlive(clientPid);
+  };
+  RowTypePtr inputType;
+  // Set if begin() failed. Each batch of the stream fails with it then.
+  std::optional<std::string> beginError;
+  for (;;) {
+    std::optional<folly::ByteRange> message;
+    if (!waitFor(
+            [&]() { return (message = requests.peek()).has_value(); },
+            isClientAlive)) {
+      return;
+    }
+    const auto kind = messageKind(*message);
+    switch (kind) {
+      case MessageKind::kShutdown:
+        requests.consume();
+        return;
+      case MessageKind::kBegin: {
+        const auto obj = folly::parseJson(payload(*message).toString());
+        requests.consume();
+        beginError.reset();
+        try {
+          inputType = asRowType(Type::create(obj["inputType"]));
+          std::vector<core::TypedExprPtr> expressions;
+          for (const auto& expression : obj["expressions"]) {
+            expressions.push_back(
+                ISerializable::deserialize<core::ITypedExpr>(expression, pool));
+          }
+          evaluator.begin(inputType, expressions);
+        } catch (const std::exception& e) {
+          beginError = e.what();
+        }
+        break;
+      }
+      case MessageKind::kEnd:
+        requests.consume();
+        if (!beginError.has_value()) {
+          evaluator.end();
+        }
+        break;
+      default: {
+        std::optional<std::string> error = beginError;
+        EncodedBatch batch;
+        bool consumed = false;
+        try {
+          // Decoding copies the batch out of 'requests', so that the next
+          // batch can be written while this one is evaluated.
+          auto input = decodeBatch(*message, inputType, pool);
+          requests.consume();
+          consumed = true;
+          if (!error.has_value()) {
+            auto result = evaluator.evaluate(input);
+            VELOX_CHECK_NOT_NULL(result);
+            encodeBatch(result, batch);
+          }
+        } catch (const std::exception& e) {
+          error = e.what();
+        }
+        if (!consumed) {
+          requests.consume();
+        }
+        const bool written = error.has_value()
+            ? writeMessage(
+                  responses, MessageKind::kError, isClientAlive, error.value())
+            : write(responses, batch.parts, isClientAlive);
+        if (!written) {
+          return;
+        }
+      }
+    }
+  }
+}
+
+// static
+OffProcessTransportPool& OffProcessTransportPool::instance() {
+  static OffProcessTransportPool pool;
+  return pool;
+}
+
+void OffProcessTransportPool::setFactory(Factory factory) {
+  std::vector<std::unique_ptr<OffProcessTransport>> idle;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    factory_ = std::move(factory);
+    idle = std::move(idle_);
+    idle_.clear();
+  }
+  // The transports are destroyed outside of the lock.
+}
+
+std::unique_ptr<OffProcessTransport> OffProcessTransportPool::acquire() {
+  Factory factory;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!idle_.empty()) {
+      auto transport = std::move(idle_.back());
+      idle_.pop_back();
+      return transport;
+    }
+    factory = factory_;
+  }
+  if (factory == nullptr) {
+    return std::make_unique<LoopbackTransport>();
+  }
+  return factory();
+}
+
+void OffProcessTransportPool::release(
+    std::unique_ptr<OffProcessTransport> transport) {
+  std::lock_guard<std::mutex> l(mutex_);
+  idle_.push_back(std::move(transport));
+}
+
+size_t OffProcessTransportPool::numIdle() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return idle_.size();
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <sys/types.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "velox/core/Expressions.h"
+#include "velox/experimental/exec/SharedMemoryRingBuffer.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+/// Moves the input batches of an OffProcessExpressionEvalOperator to the
+/// process that evaluates its expressions and the results back. Several
+/// batches may be sent before their results are received, so that the remote
+/// process works on one batch while the operator sends the next.
+class OffProcessTransport {
+ public:
+  virtual ~OffProcessTransport() = default;
+
+  /// Starts a stream of batches of 'inputType' to evaluate 'expressions' over.
+  virtual void begin(
+      const RowTypePtr& inputType,
+      const std::vector<core::TypedExprPtr>& expressions) = 0;
+
+  /// Sends 'input'. Returns false without sending if the transport has no
+  /// room for another batch in flight. A result must be received first then.
+  virtual bool trySend(const RowVectorPtr& input) = 0;
+
+  /// Returns the result for the oldest batch in flight, or nullptr if it is
+  /// not ready yet. Throws if the evaluation of the batch failed.
+  virtual RowVectorPtr tryReceive(memory::MemoryPool* pool) = 0;
+
+  /// Ends the stream started by begin() after all the results are received.
+  /// The transport may begin another stream after this.
+  virtual void end() = 0;
+
+  /// Throws if the remote process has exited or if 'waitMicros' spent
+  /// waiting for the transport without any batch sent or result received
+  /// exceed the timeout of the transport. Called by a blocked operator.
+  virtual void checkRemote(uint64_t /* waitMicros */) {}
+};
+
+/// Returns the input batches as they are. This is the transport used if no
+/// other is configured in OffProcessTransportPool.
+class LoopbackTransport : public OffProcessTransport {
+ public:
+  explicit LoopbackTransport(int32_t maxBatchesInFlight = 4)
+      : maxBatchesInFlight_(maxBatchesInFlight) {}
+
+  void begin(
+      const RowTypePtr& /* inputType */,
+      const std::vector<core::TypedExprPtr>& /* expressions */) override {}
+
+  bool trySend(const RowVectorPtr& input) override;
+
+  RowVectorPtr tryReceive(memory::MemoryPool* pool) override;
+
+  void end() override;
+
+ private:
+  const int32_t maxBatchesInFlight_;
+  std::deque<RowVectorPtr> inFlight_;
+};
+
+/// Sends the batches through a pair of SharedMemoryRingBuffers to a process
+/// that runs serveSharedMemoryTransport() on the other ends. A batch whose
+/// columns are all of fixed width or string types is written to the ring
+/// buffer as the nulls and values buffers of its flattened columns, with the
+/// strings of a string column following their lengths, and is read into new
+/// flat vectors from there. The other batches are written in the Presto
+/// serialization format.
+///
+/// A batch in either format must fit in half of the capacity of the ring
+/// buffers.
+///
+/// The operator fails if the remote process makes no progress for
+/// 'timeoutMs' or if the process 'remotePid' has exited. 'remotePid' is 0 if
+/// the remote end is not a process whose liveness can be checked.
+class SharedMemoryTransport : public OffProcessTransport {
+ public:
+  SharedMemoryTransport(
+      std::shared_ptr<SharedMemoryRingBuffer> requests,
+      std::shared_ptr<SharedMemoryRingBuffer> responses,
+      int32_t maxBatchesInFlight = 4,
+      uint64_t timeoutMs = 60'000,
+      pid_t remotePid = 0);
+
+  /// Makes the remote process return from serveSharedMemoryTransport().
+  ~SharedMemoryTransport() override;
+
+  void begin(
+      const RowTypePtr& inputType,
+      const std::vector<core::TypedExprPtr>& expressions) override;
+
+  bool trySend(const RowVectorPtr& input) override;
+
+  RowVectorPtr tryReceive(memory::MemoryPool* pool) override;
+
+  void end() override;
+
+  void checkRemote(uint64_t waitMicros) override;
+
+ private:
+  const std::shared_ptr<SharedMemoryRingBuffer> requests_;
+  const std::shared_ptr<SharedMemoryRingBuffer> responses_;
+  const int32_t maxBatchesInFlight_;
+  const uint64_t timeoutMs_;
+  const pid_t remotePid_;
+
+  RowTypePtr inputType_;
+  int32_t numInFlight_{0};
+};
+
+/// Evaluates the expressions of an OffProcessExpressionEvalNode in the remote
+/// process.
+class OffProcessEvaluator {
+ public:
+  virtual ~OffProcessEvaluator() = default;
+
+  virtual void begin(
+      const RowTypePtr& inputType,
+      const std::vector<core::TypedExprPtr>& expressions) = 0;
+
+  virtual RowVectorPtr evaluate(const RowVectorPtr& input) = 0;
+
+  virtual void end() {}
+};
+
+/// Runs the remote end of a SharedMemoryTransport: evaluates the batches read
+/// from 'requests' with 'evaluator' and writes the results to 'responses'
+/// until the transport is destroyed or the process 'clientPid' of the
+/// transport exits. 'clientPid' is 0 if its liveness is not checked. An
+/// exception from 'evaluator' is returned as the result of the batch and
+/// rethrown by tryReceive(). The expressions are deserialized with 'pool' as
+/// context, so Type::registerSerDe() and core::ITypedExpr::registerSerDe()
+/// must have been called.
+void serveSharedMemoryTransport(
+    SharedMemoryRingBuffer& requests,
+    SharedMemoryRingBuffer& responses,
+    OffProcessEvaluator& evaluator,
+    memory::MemoryPool* pool,
+    pid_t clientPid = 0);
+
+/// Keeps the transports of finished operators to give them to the next ones,
+/// so that the remote processes and their shared memory are reused across
+/// tasks instead of being set up for each.
+class OffProcessTransportPool {
+ public:
+  using Factory = std::function<std::unique_ptr<OffProcessTransport>()>;
+
+  static OffProcessTransportPool& instance();
+
+  /// Sets the factory of new transports and drops the idle transports. A
+  /// nullptr factory makes LoopbackTransports.
+  void setFactory(Factory factory);
+
+  /// Returns an idle transport or a new one.
+  std::unique_ptr<OffProcessTransport> acquire();
+
+  /// Returns a transport whose stream has ended for reuse.
+  void release(std::unique_ptr<OffProcessTransport> transport);
+
+  size_t numIdle() const;
+
+ private:
+  mutable std::mutex mutex_;
+  Factory factory_;
+  std::vector<std::unique_ptr<OffProcessTransport>> idle_;
+};
+
+} // namespace facebook::velox::exec
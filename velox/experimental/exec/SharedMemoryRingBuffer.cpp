@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/experimental/exec/SharedMemoryRingBuffer.h"
+
+#include <fcntl.h>
+#include <folly/String.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+// The length preceding each message.
+constexpr uint64_t kLengthSize = sizeof(uint64_t);
+
+// The length of the filler at the end of the buffer when a message does not
+// fit before the end.
+constexpr uint64_t kPadding = ~0UL;
+
+// The data starts at this offset from the start of the mapping.
+constexpr uint64_t kDataOffset = 192;
+
+uint64_t messageSize(uint64_t length) {
+  return kLengthSize + bits::roundUp(length, kLengthSize);
+}
+
+} // namespace
+
+// static
+void* SharedMemoryRingBuffer::map(int fd, uint64_t size) {
+  auto* memory = mmap(
+      nullptr,
+      size,
+      PROT_READ | PROT_WRITE,
+      fd == -1 ? MAP_SHARED | MAP_ANONYMOUS : MAP_SHARED,
+      fd,
+      0);
+  VELOX_CHECK(
+      memory != MAP_FAILED,
+      "Failed to map {} bytes of shared memory: {}",
+      size,
+      folly::errnoStr(errno));
+  return memory;
+}
+
+// static
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::create(
+    uint64_t capacity) {
+  capacity = bits::roundUp(capacity, kLengthSize);
+  const auto size = kDataOffset + capacity;
+  auto* header = new (map(-1, size)) Header();
+  header->capacity = capacity;
+  return std::unique_ptr<SharedMemoryRingBuffer>(
+      new SharedMemoryRingBuffer(header, size, std::nullopt));
+}
+
+// static
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::create(
+    const std::string& name,
+    uint64_t capacity) {
+  capacity = bits::roundUp(capacity, kLengthSize);
+  const auto size = kDataOffset + capacity;
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  VELOX_CHECK_GE(
+      fd,
+      0,
+      "Failed to create shared memory {}: {}",
+      name,
+      folly::errnoStr(errno));
+  if (ftruncate(fd, size) != 0) {
+    const auto error = errno;
+    ::close(fd);
+    shm_unlink(name.c_str());
+    VELOX_FAIL(
+        "Failed to resize shared memory {}: {}",
+        name,
+        folly::errnoStr(error));
+  }
+  void* memory;
+  try {
+    memory = map(fd, size);
+  } catch (const std::exception&) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    throw;
+  }
+  ::close(fd);
+  auto* header = new (memory) Header();
+  header->capacity = capacity;
+  return std::unique_ptr<SharedMemoryRingBuffer>(
+      new SharedMemoryRingBuffer(header, size, name));
+}
+
+// static
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::open(
+    const std::string& name) {
+  const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  VELOX_CHECK_GE(
+      fd,
+      0,
+      "Failed to open shared memory {}: {}",
+      name,
+      folly::errnoStr(errno));
+  struct stat stats;
+  if (fstat(fd, &stats) != 0) {
+    const auto error = errno;
+    ::close(fd);
+    VELOX_FAIL(
+        "Failed to stat shared memory {}: {}", name, folly::errnoStr(error));
+  }
+  void* memory;
+  try {
+    memory = map(fd, stats.st_size);
+  } catch (const std::exception&) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+  return std::unique_ptr<SharedMemoryRingBuffer>(
+      new SharedMemoryRingBuffer(memory, stats.st_size, std::nullopt));
+}
+
+SharedMemoryRingBuffer::SharedMemoryRingBuffer(
+    void* memory,
+    uint64_t mappedSize,
+    std::optional<std::string> ownedName)
+    : memory_(memory),
+      mappedSize_(mappedSize),
+      ownedName_(std::move(ownedName)),
+      header_(reinterpret_cast<Header*>(memory)),
+      data_(reinterpret_cast<uint8_t*>(memory) + kDataOffset) {
+  static_assert(sizeof(Header) <= kDataOffset);
+  VELOX_CHECK_EQ(kDataOffset + header_->capacity, mappedSize_);
+}
+
+SharedMemoryRingBuffer::~SharedMemoryRingBuffer() {
+  munmap(memory_, mappedSize_);
+  if (ownedName_.has_value()) {
+    shm_unlink(ownedName_->c_str());
+  }
+}
+
+bool SharedMemoryRingBuffer::tryWrite(
+    folly::Range<const folly::ByteRange*> parts) {
+  uint64_t length = 0;
+  for (const auto& part : parts) {
+    length += part.size();
+  }
+  const auto capacity = header_->capacity;
+  const auto size = messageSize(length);
+  // A message that does not fit before the end is preceded by less padding
+  // than its size, so messages of up to half the capacity always fit in an
+  // empty buffer.
+  VELOX_CHECK_LE(
+      2 * size,
+      capacity,
+      "Message is too large for the shared memory ring buffer");
+
+  // Only this thread moves 'writeOffset'.
+  auto writeOffset = header_->writeOffset.load(std::memory_order_relaxed);
+  const auto readOffset = header_->readOffset.load(std::memory_order_acquire);
+  const auto position = writeOffset % capacity;
+  const auto padding = capacity - position < size ? capacity - position : 0;
+  if (capacity - (writeOffset - readOffset) < padding + size) {
+    return false;
+  }
+  if (padding != 0) {
+    memcpy(data_ + position, &kPadding, kLengthSize);
+    writeOffset += padding;
+  }
+  auto* target = data_ + writeOffset % capacity;
+  memcpy(target, &length, kLengthSize);
+  target += kLengthSize;
+  for (const auto& part : parts) {
+    memcpy(target, part.data(), part.size());
+    target += part.size();
+  }
+  header_->writeOffset.store(writeOffset + size, std::memory_order_release);
+  return true;
+}
+
+std::optional<folly::ByteRange> SharedMemoryRingBuffer::peek() {
+  const auto capacity = header_->capacity;
+  // Only this thread moves 'readOffset'.
+  auto readOffset = header_->readOffset.load(std::memory_order_relaxed);
+  const auto writeOffset = header_->writeOffset.load(std::memory_order_acquire);
+  if (readOffset == writeOffset) {
+    return std::nullopt;
+  }
+  auto position = readOffset % capacity;
+  uint64_t length;
+  memcpy(&length, data_ + position, kLengthSize);
+  if (length == kPadding) {
+    // The message starts at the beginning. The writer writes the padding and
+    // the message together, so the message is there.
+    readOffset += capacity - position;
+    header_->readOffset.store(readOffset, std::memory_order_release);
+    position = 0;
+    memcpy(&length, data_, kLengthSize);
+  }
+  peekedSize_ = messageSize(length);
+  return folly::ByteRange(data_ + position + kLengthSize, length);
+}
+
+void SharedMemoryRingBuffer::consume() {
+  VELOX_CHECK_NE(peekedSize_, 0, "consume() without peek()");
+  header_->readOffset.fetch_add(peekedSize_, std::memory_order_release);
+  peekedSize_ = 0;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace facebook::velox::exec {
+
+/// A single producer, single consumer queue of variable size messages in
+/// memory that can be shared between processes. The memory is either an
+/// anonymous shared mapping, which is inherited by processes forked after
+/// create(), or a named POSIX shared memory object that another process maps
+/// with open().
+///
+/// A message is written in one piece after an 8 byte length. A message never
+/// wraps around the end of the buffer, so that the reader can use it in place
+/// without copying it out first.
+class SharedMemoryRingBuffer {
+ public:
+  /// Creates a ring buffer with 'capacity' bytes for messages in an anonymous
+  /// shared mapping.
+  static std::unique_ptr<SharedMemoryRingBuffer> create(uint64_t capacity);
+
+  /// Creates a ring buffer in the POSIX shared memory object 'name', which is
+  /// unlinked when the returned ring buffer is destroyed.
+  static std::unique_ptr<SharedMemoryRingBuffer> create(
+      const std::string& name,
+      uint64_t capacity);
+
+  /// Maps the ring buffer created in the POSIX shared memory object 'name' by
+  /// another process.
+  static std::unique_ptr<SharedMemoryRingBuffer> open(const std::string& name);
+
+  ~SharedMemoryRingBuffer();
+
+  /// Writes a message made of the concatenation of 'parts'. Returns false
+  /// without writing if there is not enough free space. A message with its
+  /// length may take at most half of the capacity.
+  bool tryWrite(folly::Range<const folly::ByteRange*> parts);
+
+  /// Returns the oldest message, or std::nullopt if there is none. The range
+  /// stays valid until consume().
+  std::optional<folly::ByteRange> peek();
+
+  /// Frees the message returned by the last peek().
+  void consume();
+
+  uint64_t capacity() const {
+    return header_->capacity;
+  }
+
+ private:
+  struct Header {
+    uint64_t capacity;
+    // The offsets grow monotonically. The position in 'data_' is the offset
+    // modulo 'capacity'. The writer and the reader are on different cache
+    // lines.
+    alignas(64) std::atomic<uint64_t> writeOffset;
+    alignas(64) std::atomic<uint64_t> readOffset;
+  };
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  SharedMemoryRingBuffer(
+      void* memory,
+      uint64_t mappedSize,
+      std::optional<std::string> ownedName);
+
+  // Maps 'fd' or anonymous memory if 'fd' is -1.
+  static void* map(int fd, uint64_t size);
+
+  void* const memory_;
+  const uint64_t mappedSize_;
+  // The name of the shared memory object to unlink at destruction.
+  const std::optional<std::string> ownedName_;
+  Header* const header_;
+  uint8_t* const data_;
+
+  // The size including the length of the message returned by peek().
+  uint64_t peekedSize_{0};
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/synchronization/Baton.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <thread>
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/experimental/exec/OffProcessExpressionEval.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+std::string readMessage(SharedMemoryRingBuffer& ring) {
+  auto message = ring.peek();
+  VELOX_CHECK(message.has_value());
+  auto result = message->toString();
+  ring.consume();
+  return result;
+}
+
+bool writeMessage(SharedMemoryRingBuffer& ring, std::string_view message) {
+  folly::ByteRange part(
+      reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  return ring.tryWrite(folly::Range<const folly::ByteRange*>(&part, 1));
+}
+
+// Returns the input as is after checking that the expressions of the node are
+// received. Fails the batches with a first value of 'kFailValue'.
+class EchoEvaluator : public OffProcessEvaluator {
+ public:
+  static constexpr int64_t kFailValue = -1;
+
+  void begin(
+      const RowTypePtr& /* inputType */,
+      const std::vector<core::TypedExprPtr>& expressions) override {
+    VELOX_CHECK_EQ(expressions.size(), 1);
+    VELOX_CHECK_EQ(expressions[0]->toString(), "plus(1,2)");
+  }
+
+  RowVectorPtr evaluate(const RowVectorPtr& input) override {
+    auto* first = input->childAt(0)->asFlatVector<int64_t>();
+    if (first != nullptr && input->size() > 0 && !first->isNullAt(0) &&
+        first->valueAt(0) == kFailValue) {
+      VELOX_USER_FAIL("Failing as requested");
+    }
+    return input;
+  }
+};
+
+// Returns the input after 'release' is posted.
+class BlockingEvaluator : public OffProcessEvaluator {
+ public:
+  explicit BlockingEvaluator(folly::Baton<>& release) : release_(release) {}
+
+  void begin(
+      const RowTypePtr& /* inputType */,
+      const std::vector<core::TypedExprPtr>& /* expressions */) override {}
+
+  RowVectorPtr evaluate(const RowVectorPtr& input) override {
+    release_.wait();
+    return input;
+  }
+
+ private:
+  folly::Baton<>& release_;
+};
+
+class SharedMemoryTransportTest : public OperatorTestBase {
+ protected:
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    Type::registerSerDe();
+    core::ITypedExpr::registerSerDe();
+    exec::Operator::registerOperator(
+        std::make_unique<OffProcessExpressionEvalTranslator>());
+    OffProcessTransportPool::instance().setFactory([this]() {
+      auto requests = std::shared_ptr<SharedMemoryRingBuffer>(
+          SharedMemoryRingBuffer::create(1 << 20));
+      auto responses = std::shared_ptr<SharedMemoryRingBuffer>(
+          SharedMemoryRingBuffer::create(1 << 20));
+      servers_.emplace_back([this, requests, responses]() {
+        EchoEvaluator evaluator;
+        serveSharedMemoryTransport(*requests, *responses, evaluator, pool());
+      });
+      ++numTransports_;
+      return std::make_unique<SharedMemoryTransport>(
+          requests, responses, 2);
+    });
+  }
+
+  void TearDown() override {
+    // Destroying the idle transports stops their servers.
+    OffProcessTransportPool::instance().setFactory(nullptr);
+    for (auto& server : servers_) {
+      server.join();
+    }
+    OperatorTestBase::TearDown();
+  }
+
+  core::PlanNodePtr makePlan(const std::vector<RowVectorPtr>& input) {
+    auto rowType = asRowType(input[0]->type());
+    return PlanBuilder()
+        .values(input)
+        .addNode([&](std::string id, core::PlanNodePtr source) {
+          return std::make_shared<OffProcessExpressionEvalNode>(
+              id,
+              std::vector<core::TypedExprPtr>{
+                  parseExpr("1 + 2", rowType, parse::ParseOptions{})},
+              source);
+        })
+        .planNode();
+  }
+
+  std::vector<std::thread> servers_;
+  int32_t numTransports_{0};
+};
+
+TEST_F(SharedMemoryTransportTest, ringBuffer) {
+  auto ring = SharedMemoryRingBuffer::create(256);
+  EXPECT_FALSE(ring->peek().has_value());
+
+  // Writes messages of varying sizes so that they wrap around the end many
+  // times, keeping up to 3 messages in the ring.
+  std::deque<std::string> expected;
+  for (auto i = 0; i < 1'000; ++i) {
+    std::string message(i % 57, 'a' + i % 26);
+    if (expected.size() == 3) {
+      EXPECT_EQ(readMessage(*ring), expected.front());
+      expected.pop_front();
+    }
+    ASSERT_TRUE(writeMessage(*ring, message));
+    expected.push_back(message);
+  }
+  while (!expected.empty()) {
+    EXPECT_EQ(readMessage(*ring), expected.front());
+    expected.pop_front();
+  }
+  EXPECT_FALSE(ring->peek().has_value());
+
+  // A new ring fills up with 48 byte messages, including the length.
+  ring = SharedMemoryRingBuffer::create(256);
+  std::string message(40, 'x');
+  auto numWritten = 0;
+  while (writeMessage(*ring, message)) {
+    ++numWritten;
+  }
+  EXPECT_EQ(numWritten, 256 / 48);
+  readMessage(*ring);
+  EXPECT_TRUE(writeMessage(*ring, message));
+
+  VELOX_ASSERT_THROW(
+      writeMessage(*ring, std::string(200, 'x')),
+      "Message is too large for the shared memory ring buffer");
+}
+
+TEST_F(SharedMemoryTransportTest, namedRingBuffer) {
+  const auto name = fmt::format("/velox_ring_buffer_test_{}", getpid());
+  auto writer = SharedMemoryRingBuffer::create(name, 1024);
+  auto reader = SharedMemoryRingBuffer::open(name);
+  EXPECT_EQ(reader->capacity(), 1024);
+  ASSERT_TRUE(writeMessage(*writer, "hello"));
+  EXPECT_EQ(readMessage(*reader), "hello");
+
+  writer.reset();
+  VELOX_ASSERT_THROW(
+      SharedMemoryRingBuffer::open(name), "Failed to open shared memory");
+}
+
+TEST_F(SharedMemoryTransportTest, rawBatches) {
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 30; ++i) {
+    strings.push_back(std::string(i, 'a' + i));
+  }
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 20; ++i) {
+    auto base =
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row + i; });
+    input.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return row * i; }, nullEvery(7)),
+        makeFlatVector<StringView>(
+            1'000,
+            [&](auto row) { return StringView(strings[row % 30]); },
+            nullEvery(5)),
+        makeFlatVector<bool>(1'000, [](auto row) { return row % 3 == 0; }),
+        makeFlatVector<Timestamp>(
+            1'000, [](auto row) { return Timestamp(row, row); }),
+        wrapInDictionary(makeIndicesInReverse(1'000), 1'000, base),
+        makeConstant<double>(i * 0.5, 1'000),
+    }));
+  }
+
+  auto plan = makePlan(input);
+  AssertQueryBuilder(plan).assertResults(input);
+  // The transport and its server are reused by the next query.
+  AssertQueryBuilder(plan).assertResults(input);
+  EXPECT_EQ(numTransports_, 1);
+  EXPECT_EQ(OffProcessTransportPool::instance().numIdle(), 1);
+}
+
+TEST_F(SharedMemoryTransportTest, serializedBatches) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 10; ++i) {
+    input.push_back(makeRowVector({
+        makeFlatVector<int64_t>(100, [&](auto row) { return row + i; }),
+        makeArrayVector<int32_t>(
+            100,
+            [](auto row) { return row % 5; },
+            [](auto row, auto index) { return row + index; }),
+    }));
+  }
+  AssertQueryBuilder(makePlan(input)).assertResults(input);
+}
+
+TEST_F(SharedMemoryTransportTest, error) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 10; ++i) {
+    input.push_back(makeRowVector({makeFlatVector<int64_t>(
+        {i == 5 ? EchoEvaluator::kFailValue : i, 1, 2})}));
+  }
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(makePlan(input)).copyResults(pool()),
+      "Off-process expression evaluation failed");
+  // The transport of the failed query is not reused.
+  EXPECT_EQ(OffProcessTransportPool::instance().numIdle(), 0);
+
+  input.erase(input.begin() + 5);
+  AssertQueryBuilder(makePlan(input)).assertResults(input);
+  EXPECT_EQ(numTransports_, 2);
+}
+
+TEST_F(SharedMemoryTransportTest, timeout) {
+  folly::Baton<> release;
+  OffProcessTransportPool::instance().setFactory([&]() {
+    auto requests = std::shared_ptr<SharedMemoryRingBuffer>(
+        SharedMemoryRingBuffer::create(1 << 20));
+    auto responses = std::shared_ptr<SharedMemoryRingBuffer>(
+        SharedMemoryRingBuffer::create(1 << 20));
+    servers_.emplace_back([&, requests, responses]() {
+      BlockingEvaluator evaluator(release);
+      serveSharedMemoryTransport(*requests, *responses, evaluator, pool());
+    });
+    return std::make_unique<SharedMemoryTransport>(
+        requests, responses, 2, 100);
+  });
+
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeRowVector({makeFlatVector<int64_t>({i, 1, 2})}));
+  }
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(makePlan(input)).copyResults(pool()),
+      "Off-process expression evaluation made no progress for");
+  EXPECT_EQ(OffProcessTransportPool::instance().numIdle(), 0);
+  // Lets the server reach the shutdown of the failed transport.
+  release.post();
+}
+
+TEST_F(SharedMemoryTransportTest, remoteExited) {
+  // A process that has exited and is reaped.
+  const auto pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    _exit(0);
+  }
+  ASSERT_EQ(waitpid(pid, nullptr, 0), pid);
+
+  // No process serves the transport, so the batches are never evaluated.
+  OffProcessTransportPool::instance().setFactory([pid]() {
+    return std::make_unique<SharedMemoryTransport>(
+        std::shared_ptr<SharedMemoryRingBuffer>(
+            SharedMemoryRingBuffer::create(1 << 20)),
+        std::shared_ptr<SharedMemoryRingBuffer>(
+            SharedMemoryRingBuffer::create(1 << 20)),
+        2,
+        60'000,
+        pid);
+  });
+  std::vector<RowVectorPtr> input = {
+      makeRowVector({makeFlatVector<int64_t>({1, 2, 3})})};
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(makePlan(input)).copyResults(pool()),
+      fmt::format(
+          "Off-process expression evaluation process {} has exited", pid));
+}
+
+} // namespace
+} // namespace facebook::velox::exec::test
@@ -0,0 +1,554 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/experimental/gpu/GpuAggregation.h"
+
+#include <gflags/gflags.h>
+#include <cub/cub.cuh> // @manual
+#include <limits>
+
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+DEFINE_int32(
+    velox_gpu_aggregation_min_rows,
+    10'000,
+    "Input batches of GpuAggregation with fewer rows are aggregated on the "
+    "CPU, since the transfer to the GPU costs more than it saves");
+
+namespace facebook::velox::gpu {
+
+namespace {
+
+constexpr int32_t kBlockSize = 256;
+constexpr int32_t kMaxBlocks = 1024;
+
+template <typename T>
+struct SumOp {
+  __host__ __device__ T operator()(T lhs, T rhs) const {
+    return lhs + rhs;
+  }
+};
+
+template <typename T>
+struct MinOp {
+  __host__ __device__ T operator()(T lhs, T rhs) const {
+    return rhs < lhs ? rhs : lhs;
+  }
+};
+
+template <typename T>
+struct MaxOp {
+  __host__ __device__ T operator()(T lhs, T rhs) const {
+    return lhs < rhs ? rhs : lhs;
+  }
+};
+
+__device__ void atomicCombine(SumOp<int64_t>, int64_t* target, int64_t value) {
+  atomicAdd(
+      reinterpret_cast<unsigned long long*>(target),
+      static_cast<unsigned long long>(value));
+}
+
+__device__ void atomicCombine(MinOp<int64_t>, int64_t* target, int64_t value) {
+  atomicMin(reinterpret_cast<long long*>(target), value);
+}
+
+__device__ void atomicCombine(MaxOp<int64_t>, int64_t* target, int64_t value) {
+  atomicMax(reinterpret_cast<long long*>(target), value);
+}
+
+__device__ void atomicCombine(SumOp<double>, double* target, double value) {
+  atomicAdd(target, value);
+}
+
+// There is no atomic min and max for doubles.
+template <typename Op>
+__device__ void atomicCombine(Op op, double* target, double value) {
+  auto address = reinterpret_cast<unsigned long long*>(target);
+  unsigned long long old = *address;
+  unsigned long long assumed;
+  do {
+    assumed = old;
+    old = atomicCAS(
+        address,
+        assumed,
+        __double_as_longlong(op(__longlong_as_double(assumed), value)));
+  } while (assumed != old);
+}
+
+// Reduces 'values' with 'op' and combines the result into 'result'.
+template <typename T, typename Op>
+__global__ void
+reduceKernel(const T* values, int32_t size, Op op, T identity, T* result) {
+  using Reduce = cub::BlockReduce<T, kBlockSize>;
+  __shared__ typename Reduce::TempStorage temp;
+  T accumulator = identity;
+  for (int32_t i = threadIdx.x + blockIdx.x * blockDim.x; i < size;
+       i += blockDim.x * gridDim.x) {
+    accumulator = op(accumulator, values[i]);
+  }
+  accumulator = Reduce(temp).Reduce(accumulator, op);
+  if (threadIdx.x == 0) {
+    atomicCombine(op, result, accumulator);
+  }
+}
+
+template <typename T, typename Op>
+void reduce(
+    const int8_t* values,
+    int32_t size,
+    Op op,
+    T identity,
+    int64_t* result,
+    cudaStream_t stream) {
+  const auto numBlocks =
+      std::min((size + kBlockSize - 1) / kBlockSize, kMaxBlocks);
+  reduceKernel<<<numBlocks, kBlockSize, 0, stream>>>(
+      reinterpret_cast<const T*>(values),
+      size,
+      op,
+      identity,
+      reinterpret_cast<T*>(result));
+  CUDA_CHECK_FATAL(cudaGetLastError());
+}
+
+template <typename T>
+T identity(bool isMin) {
+  return isMin ? std::numeric_limits<T>::max()
+               : std::numeric_limits<T>::lowest();
+}
+
+template <>
+double identity(bool isMin) {
+  return isMin ? std::numeric_limits<double>::infinity()
+               : -std::numeric_limits<double>::infinity();
+}
+
+bool hasGpu() {
+  int32_t count = 0;
+  if (cudaGetDeviceCount(&count) != cudaSuccess) {
+    // Clears the error.
+    cudaGetLastError();
+    return false;
+  }
+  return count > 0;
+}
+
+class GpuAggregationTranslator : public exec::Operator::PlanNodeTranslator {
+  std::unique_ptr<exec::Operator> toOperator(
+      exec::DriverCtx* ctx,
+      int32_t id,
+      const core::PlanNodePtr& node) override {
+    if (auto aggregation =
+            std::dynamic_pointer_cast<const GpuAggregationNode>(node)) {
+      return std::make_unique<GpuAggregation>(id, ctx, aggregation);
+    }
+    return nullptr;
+  }
+};
+
+} // namespace
+
+GpuAggregationNode::GpuAggregationNode(
+    const core::PlanNodeId& id,
+    std::shared_ptr<const core::AggregationNode> aggregation)
+    : PlanNode(id), aggregation_(std::move(aggregation)) {
+  VELOX_CHECK_NOT_NULL(aggregation_);
+  VELOX_USER_CHECK(
+      canOffload(*aggregation_),
+      "Aggregation cannot run on the GPU: {}",
+      aggregation_->toString(true));
+}
+
+// static
+bool GpuAggregationNode::canOffload(const core::AggregationNode& aggregation) {
+  if (aggregation.step() != core::AggregationNode::Step::kPartial ||
+      !aggregation.groupingKeys().empty()) {
+    return false;
+  }
+  const auto& aggregates = aggregation.aggregates();
+  for (auto i = 0; i < aggregates.size(); ++i) {
+    if (aggregation.aggregateMasks()[i] != nullptr ||
+        aggregation.hasSortedOrDistinctInput(i)) {
+      return false;
+    }
+    const auto& name = aggregates[i]->name();
+    const auto& inputs = aggregates[i]->inputs();
+    const auto& resultType = aggregation.outputType()->childAt(i);
+    if (name == "count") {
+      if (inputs.size() > 1 || resultType->kind() != TypeKind::BIGINT) {
+        return false;
+      }
+      continue;
+    }
+    if ((name != "sum" && name != "min" && name != "max") ||
+        inputs.size() != 1 ||
+        !std::dynamic_pointer_cast<const core::FieldAccessTypedExpr>(
+            inputs[0])) {
+      return false;
+    }
+    const auto& type = inputs[0]->type();
+    if ((type->kind() != TypeKind::BIGINT &&
+         type->kind() != TypeKind::DOUBLE) ||
+        *resultType != *type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GpuAggregationNode::addDetails(std::stringstream& stream) const {
+  const auto& names = aggregation_->aggregateNames();
+  const auto& aggregates = aggregation_->aggregates();
+  for (auto i = 0; i < aggregates.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << names[i] << " := " << aggregates[i]->toString();
+  }
+}
+
+GpuAggregation::GpuAggregation(
+    int32_t operatorId,
+    exec::DriverCtx* driverCtx,
+    const std::shared_ptr<const GpuAggregationNode>& planNode)
+    : Operator(
+          driverCtx,
+          planNode->outputType(),
+          operatorId,
+          planNode->id(),
+          "GpuAggregation"),
+      hasGpu_(hasGpu()) {
+  const auto& inputType = planNode->sources()[0]->outputType();
+  for (const auto& call : planNode->aggregation()->aggregates()) {
+    Aggregate aggregate;
+    const auto& name = call->name();
+    aggregate.function = name == "sum" ? Function::kSum
+        : name == "min"                ? Function::kMin
+        : name == "max"                ? Function::kMax
+                                       : Function::kCount;
+    aggregate.channel = 0;
+    // count(1) has no input or a constant input.
+    if (auto field = call->inputs().empty()
+            ? nullptr
+            : std::dynamic_pointer_cast<const core::FieldAccessTypedExpr>(
+                  call->inputs()[0])) {
+      aggregate.type = field->type();
+      aggregate.channel = inputType->getChildIdx(field->name());
+    }
+    if (aggregate.function == Function::kCount ||
+        aggregate.type->isBigint()) {
+      aggregate.cpuAccumulator.bigint = aggregate.function == Function::kMin
+          ? identity<int64_t>(true)
+          : aggregate.function == Function::kMax ? identity<int64_t>(false)
+                                                 : 0;
+    } else {
+      aggregate.cpuAccumulator.real = aggregate.function == Function::kMin
+          ? identity<double>(true)
+          : aggregate.function == Function::kMax ? identity<double>(false)
+                                                 : 0;
+    }
+    if (aggregate.function != Function::kCount) {
+      auto it = std::find(
+          transferChannels_.begin(),
+          transferChannels_.end(),
+          aggregate.channel);
+      aggregate.transferIndex = it - transferChannels_.begin();
+      if (it == transferChannels_.end()) {
+        transferChannels_.push_back(aggregate.channel);
+      }
+    }
+    aggregates_.push_back(aggregate);
+  }
+
+  if (!hasGpu_) {
+    return;
+  }
+  // The device accumulators start with the same identities as the CPU ones.
+  std::vector<int64_t> accumulators(aggregates_.size());
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    accumulators[i] = aggregates_[i].cpuAccumulator.bigint;
+  }
+  int64_t* deviceAccumulators;
+  const auto bytes = accumulators.size() * sizeof(int64_t);
+  CUDA_CHECK_FATAL(cudaMalloc(&deviceAccumulators, bytes));
+  deviceAccumulators_.reset(deviceAccumulators);
+  CUDA_CHECK_FATAL(cudaMemcpy(
+      deviceAccumulators, accumulators.data(), bytes, cudaMemcpyHostToDevice));
+  for (auto& transfer : transfers_) {
+    transfer.stream = createCudaStream();
+    transfer.done = createCudaEvent();
+  }
+}
+
+bool GpuAggregation::useGpu(const RowVectorPtr& input) const {
+  if (!hasGpu_ || input->size() < FLAGS_velox_gpu_aggregation_min_rows) {
+    return false;
+  }
+  for (const auto& aggregate : aggregates_) {
+    if (aggregate.type == nullptr) {
+      continue;
+    }
+    const auto& vector = input->childAt(aggregate.channel);
+    if (vector->encoding() != VectorEncoding::Simple::FLAT ||
+        vector->mayHaveNulls()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GpuAggregation::addInput(RowVectorPtr input) {
+  for (const auto& aggregate : aggregates_) {
+    if (aggregate.type != nullptr) {
+      input->childAt(aggregate.channel)->loadedVector();
+    }
+  }
+  if (useGpu(input)) {
+    addInputGpu(input);
+  } else {
+    addInputCpu(input);
+  }
+}
+
+void GpuAggregation::addInputGpu(const RowVectorPtr& input) {
+  auto& transfer = transfers_[nextTransfer_];
+  nextTransfer_ = 1 - nextTransfer_;
+  // Waits for the previous batch in 'transfer' to be reduced before
+  // overwriting its buffers.
+  CUDA_CHECK_FATAL(cudaEventSynchronize(transfer.done.get()));
+
+  const auto numRows = input->size();
+  const auto columnBytes = numRows * sizeof(int64_t);
+  const auto bytes = transferChannels_.size() * columnBytes;
+  if (transfer.capacity < bytes) {
+    CUDA_CHECK_LOG(cudaFreeHost(transfer.hostBuffer));
+    transfer.hostBuffer = nullptr;
+    transfer.deviceBuffer.reset();
+    CUDA_CHECK_FATAL(cudaMallocHost(&transfer.hostBuffer, bytes));
+    int8_t* deviceBuffer;
+    CUDA_CHECK_FATAL(cudaMalloc(&deviceBuffer, bytes));
+    transfer.deviceBuffer.reset(deviceBuffer);
+    transfer.capacity = bytes;
+  }
+  for (auto i = 0; i < transferChannels_.size(); ++i) {
+    const auto& values = input->childAt(transferChannels_[i])->values();
+    memcpy(
+        transfer.hostBuffer + i * columnBytes,
+        values->as<int8_t>(),
+        columnBytes);
+  }
+  auto stream = transfer.stream.get();
+  CUDA_CHECK_FATAL(cudaMemcpyAsync(
+      transfer.deviceBuffer.get(),
+      transfer.hostBuffer,
+      bytes,
+      cudaMemcpyHostToDevice,
+      stream));
+
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    auto& aggregate = aggregates_[i];
+    if (aggregate.function == Function::kCount) {
+      aggregate.cpuAccumulator.bigint += numRows;
+      continue;
+    }
+    aggregate.hasValue = true;
+    const auto* values =
+        transfer.deviceBuffer.get() + aggregate.transferIndex * columnBytes;
+    auto* result = deviceAccumulators_.get() + i;
+    if (aggregate.type->isBigint()) {
+      switch (aggregate.function) {
+        case Function::kSum:
+          reduce<int64_t>(
+              values, numRows, SumOp<int64_t>(), 0, result, stream);
+          break;
+        case Function::kMin:
+          reduce<int64_t>(
+              values,
+              numRows,
+              MinOp<int64_t>(),
+              identity<int64_t>(true),
+              result,
+              stream);
+          break;
+        default:
+          reduce<int64_t>(
+              values,
+              numRows,
+              MaxOp<int64_t>(),
+              identity<int64_t>(false),
+              result,
+              stream);
+      }
+    } else {
+      switch (aggregate.function) {
+        case Function::kSum:
+          reduce<double>(values, numRows, SumOp<double>(), 0, result, stream);
+          break;
+        case Function::kMin:
+          reduce<double>(
+              values,
+              numRows,
+              MinOp<double>(),
+              identity<double>(true),
+              result,
+              stream);
+          break;
+        default:
+          reduce<double>(
+              values,
+              numRows,
+              MaxOp<double>(),
+              identity<double>(false),
+              result,
+              stream);
+      }
+    }
+  }
+  CUDA_CHECK_FATAL(cudaEventRecord(transfer.done.get(), stream));
+  gpuUsed_ = true;
+}
+
+namespace {
+
+template <typename T>
+T combine(int32_t function, T accumulator, T value) {
+  switch (function) {
+    case 0:
+      return SumOp<T>()(accumulator, value);
+    case 1:
+      return MinOp<T>()(accumulator, value);
+    default:
+      return MaxOp<T>()(accumulator, value);
+  }
+}
+
+} // namespace
+
+void GpuAggregation::addInputCpu(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  SelectivityVector rows(numRows);
+  DecodedVector decoded;
+  for (auto& aggregate : aggregates_) {
+    if (aggregate.type == nullptr) {
+      aggregate.cpuAccumulator.bigint += numRows;
+      continue;
+    }
+    decoded.decode(*input->childAt(aggregate.channel), rows);
+    const auto function = static_cast<int32_t>(aggregate.function);
+    for (auto row = 0; row < numRows; ++row) {
+      if (decoded.isNullAt(row)) {
+        continue;
+      }
+      if (aggregate.function == Function::kCount) {
+        ++aggregate.cpuAccumulator.bigint;
+        continue;
+      }
+      aggregate.hasValue = true;
+      if (aggregate.type->isBigint()) {
+        aggregate.cpuAccumulator.bigint = combine(
+            function,
+            aggregate.cpuAccumulator.bigint,
+            decoded.valueAt<int64_t>(row));
+      } else {
+        aggregate.cpuAccumulator.real = combine(
+            function,
+            aggregate.cpuAccumulator.real,
+            decoded.valueAt<double>(row));
+      }
+    }
+  }
+}
+
+void GpuAggregation::mergeGpuResults() {
+  if (!gpuUsed_) {
+    return;
+  }
+  for (auto& transfer : transfers_) {
+    CUDA_CHECK_FATAL(cudaStreamSynchronize(transfer.stream.get()));
+  }
+  std::vector<int64_t> accumulators(aggregates_.size());
+  CUDA_CHECK_FATAL(cudaMemcpy(
+      accumulators.data(),
+      deviceAccumulators_.get(),
+      accumulators.size() * sizeof(int64_t),
+      cudaMemcpyDeviceToHost));
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    auto& aggregate = aggregates_[i];
+    if (aggregate.function == Function::kCount) {
+      continue;
+    }
+    const auto function = static_cast<int32_t>(aggregate.function);
+    if (aggregate.type->isBigint()) {
+      aggregate.cpuAccumulator.bigint =
+          combine(function, aggregate.cpuAccumulator.bigint, accumulators[i]);
+    } else {
+      double value;
+      memcpy(&value, &accumulators[i], sizeof(double));
+      aggregate.cpuAccumulator.real =
+          combine(function, aggregate.cpuAccumulator.real, value);
+    }
+  }
+}
+
+RowVectorPtr GpuAggregation::getOutput() {
+  if (!noMoreInput_ || finished_) {
+    return nullptr;
+  }
+  finished_ = true;
+  mergeGpuResults();
+
+  std::vector<VectorPtr> children;
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    const auto& aggregate = aggregates_[i];
+    auto child = BaseVector::create(outputType_->childAt(i), 1, pool());
+    if (aggregate.function != Function::kCount && !aggregate.hasValue) {
+      child->setNull(0, true);
+    } else if (outputType_->childAt(i)->isBigint()) {
+      child->asFlatVector<int64_t>()->set(0, aggregate.cpuAccumulator.bigint);
+    } else {
+      child->asFlatVector<double>()->set(0, aggregate.cpuAccumulator.real);
+    }
+    children.push_back(std::move(child));
+  }
+  return std::make_shared<RowVector>(
+      pool(), outputType_, nullptr, 1, std::move(children));
+}
+
+void GpuAggregation::freeTransfers() {
+  for (auto& transfer : transfers_) {
+    if (transfer.stream != nullptr) {
+      CUDA_CHECK_LOG(cudaStreamSynchronize(transfer.stream.get()));
+    }
+    CUDA_CHECK_LOG(cudaFreeHost(transfer.hostBuffer));
+    transfer.hostBuffer = nullptr;
+    transfer.deviceBuffer.reset();
+    transfer.capacity = 0;
+  }
+}
+
+void GpuAggregation::close() {
+  freeTransfers();
+  Operator::close();
+}
+
+void registerGpuOperators() {
+  exec::Operator::registerOperator(
+      std::make_unique<GpuAggregationTranslator>());
+}
+
+} // namespace facebook::velox::gpu
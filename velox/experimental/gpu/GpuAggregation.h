@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/core/PlanNode.h"
+#include "velox/exec/Operator.h"
+#include "velox/experimental/gpu/Common.h"
+
+namespace facebook::velox::gpu {
+
+/// Runs a partial global aggregation, i.e. one without grouping keys, on the
+/// GPU. Supports sum, min and max over BIGINT and DOUBLE columns and count.
+/// Use canOffload() to check if an AggregationNode is supported, then replace
+/// it with a GpuAggregationNode made from it:
+///
+///   PlanBuilder()
+///       .values(...)
+///       .partialAggregation({}, {"sum(c0)", "max(c1)"})
+///       .addNode([](std::string id, core::PlanNodePtr aggregation) {
+///         return std::make_shared<GpuAggregationNode>(
+///             id, std::dynamic_pointer_cast<const core::AggregationNode>(
+///                     aggregation));
+///       })
+///
+/// registerGpuOperators() registers the translator to GpuAggregation.
+class GpuAggregationNode : public core::PlanNode {
+ public:
+  GpuAggregationNode(
+      const core::PlanNodeId& id,
+      std::shared_ptr<const core::AggregationNode> aggregation);
+
+  /// Returns true if 'aggregation' can run in a GpuAggregation.
+  static bool canOffload(const core::AggregationNode& aggregation);
+
+  const RowTypePtr& outputType() const override {
+    return aggregation_->outputType();
+  }
+
+  const std::vector<core::PlanNodePtr>& sources() const override {
+    return aggregation_->sources();
+  }
+
+  const std::shared_ptr<const core::AggregationNode>& aggregation() const {
+    return aggregation_;
+  }
+
+  std::string_view name() const override {
+    return "GpuAggregation";
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::shared_ptr<const core::AggregationNode> aggregation_;
+};
+
+/// Computes the aggregates of a GpuAggregationNode. The values of each input
+/// batch are copied into a pinned host buffer and transferred to the device
+/// from there. There are two such buffers, each with its own stream, so that
+/// the transfer and reduction of a batch on the GPU overlap with copying the
+/// next batch on the CPU.
+///
+/// Batches with fewer than --velox_gpu_aggregation_min_rows rows, batches
+/// that are not flat or have nulls in aggregated columns, and all batches if
+/// there is no GPU, are aggregated on the CPU. The partial results of the CPU
+/// and the GPU are combined at the end.
+///
+/// BIGINT sums wrap around on overflow on the GPU instead of failing.
+class GpuAggregation : public exec::Operator {
+ public:
+  GpuAggregation(
+      int32_t operatorId,
+      exec::DriverCtx* driverCtx,
+      const std::shared_ptr<const GpuAggregationNode>& planNode);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  exec::BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return exec::BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+  void close() override;
+
+ private:
+  enum class Function { kSum, kMin, kMax, kCount };
+
+  struct Aggregate {
+    Function function;
+    // The type of the argument, or nullptr for count(1).
+    TypePtr type;
+    // The input channel of the argument.
+    column_index_t channel;
+    // The index of 'channel' in 'transferChannels_' if the aggregate runs on
+    // the GPU.
+    int32_t transferIndex{-1};
+    // The GPU accumulator is in the 8 bytes of 'deviceAccumulators_' at the
+    // index of the aggregate. The CPU accumulator is 'cpuAccumulator'. Only
+    // one of the fields of the union is used, depending on 'type'.
+    union {
+      int64_t bigint;
+      double real;
+    } cpuAccumulator;
+    // False until the aggregate sees a non-null value. The result of sum, min
+    // and max is null if so.
+    bool hasValue{false};
+  };
+
+  // A pinned host buffer and a device buffer with a stream and an event to
+  // transfer a batch to the device and reduce it there.
+  struct Transfer {
+    int8_t* hostBuffer{nullptr};
+    CudaPtr<int8_t[]> deviceBuffer;
+    size_t capacity{0};
+    CudaStream stream;
+    CudaEvent done;
+  };
+
+  // Returns true if 'input' should be aggregated on the GPU.
+  bool useGpu(const RowVectorPtr& input) const;
+
+  void addInputGpu(const RowVectorPtr& input);
+
+  void addInputCpu(const RowVectorPtr& input);
+
+  // Waits for the GPU and adds the GPU accumulators to the CPU accumulators.
+  void mergeGpuResults();
+
+  void freeTransfers();
+
+  std::vector<Aggregate> aggregates_;
+
+  // The input channels to transfer to the GPU. The values of each are 8
+  // bytes per row.
+  std::vector<column_index_t> transferChannels_;
+
+  // True if there is a GPU to aggregate on.
+  bool hasGpu_{false};
+
+  Transfer transfers_[2];
+
+  // The index in 'transfers_' of the next transfer to use.
+  int32_t nextTransfer_{0};
+
+  // True if some batch was aggregated on the GPU.
+  bool gpuUsed_{false};
+
+  CudaPtr<int64_t[]> deviceAccumulators_;
+
+  bool finished_{false};
+};
+
+/// Registers the translator from GpuAggregationNode to GpuAggregation.
+void registerGpuOperators();
+
+} // namespace facebook::velox::gpu
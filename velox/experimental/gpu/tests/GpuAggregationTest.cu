@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/experimental/gpu/GpuAggregation.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_int32(num_batches, 20, "");
+DEFINE_int32(batch_size, 100'000, "");
+
+namespace facebook::velox::gpu {
+namespace {
+
+using exec::test::AssertQueryBuilder;
+using exec::test::PlanBuilder;
+
+class GpuAggregationTest : public test::VectorTestBase {
+ public:
+  GpuAggregationTest() {
+    aggregate::prestosql::registerAllAggregateFunctions();
+    parse::registerTypeResolver();
+    registerGpuOperators();
+  }
+
+  // Makes batches that alternate between large flat batches, which run on the
+  // GPU, and small, dictionary encoded or nullable batches, which run on the
+  // CPU.
+  std::vector<RowVectorPtr> makeBatches() {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < FLAGS_num_batches; ++i) {
+      const auto size = i % 2 == 0 ? FLAGS_batch_size : 100 + i;
+      // Integral doubles keep the sums exact in any order.
+      VectorPtr c0 = makeFlatVector<int64_t>(
+          size, [&](auto row) { return (row * 7919 + i) % 100'003 - 50'000; });
+      VectorPtr c1 = makeFlatVector<double>(
+          size, [&](auto row) { return (row * 104'729 + i) % 1'000 - 500; });
+      switch (i % 6) {
+        case 1:
+          c0 = wrapInDictionary(makeIndicesInReverse(size), size, c0);
+          break;
+        case 3:
+          for (auto row = 0; row < size; row += 3) {
+            c1->setNull(row, true);
+          }
+          break;
+        default:
+          break;
+      }
+      batches.push_back(makeRowVector({c0, c1}));
+    }
+    return batches;
+  }
+
+  void run() {
+    const auto batches = makeBatches();
+    const std::vector<std::string> aggregates = {
+        "sum(c0)",
+        "min(c0)",
+        "max(c0)",
+        "sum(c1)",
+        "min(c1)",
+        "max(c1)",
+        "count(c1)",
+        "count(1)"};
+
+    auto expected = AssertQueryBuilder(PlanBuilder()
+                                           .values(batches)
+                                           .partialAggregation({}, aggregates)
+                                           .planNode())
+                        .copyResults(pool());
+
+    auto plan =
+        PlanBuilder()
+            .values(batches)
+            .partialAggregation({}, aggregates)
+            .addNode([](std::string id, core::PlanNodePtr node) {
+              return std::make_shared<GpuAggregationNode>(
+                  id,
+                  std::dynamic_pointer_cast<const core::AggregationNode>(
+                      node));
+            })
+            .planNode();
+    auto actual = AssertQueryBuilder(plan).copyResults(pool());
+
+    VELOX_CHECK(
+        exec::test::assertEqualResults({expected}, {actual}),
+        "GpuAggregation result differs: {} vs. {}",
+        actual->toString(0),
+        expected->toString(0));
+  }
+
+  void runEmpty() {
+    auto plan =
+        PlanBuilder()
+            .values({makeRowVector({makeFlatVector<int64_t>({})})})
+            .partialAggregation({}, {"sum(c0)", "count(1)"})
+            .addNode([](std::string id, core::PlanNodePtr node) {
+              return std::make_shared<GpuAggregationNode>(
+                  id,
+                  std::dynamic_pointer_cast<const core::AggregationNode>(
+                      node));
+            })
+            .planNode();
+    auto actual = AssertQueryBuilder(plan).copyResults(pool());
+    VELOX_CHECK_EQ(actual->size(), 1);
+    VELOX_CHECK(actual->childAt(0)->isNullAt(0));
+    VELOX_CHECK_EQ(actual->childAt(1)->asFlatVector<int64_t>()->valueAt(0), 0);
+  }
+};
+
+} // namespace
+} // namespace facebook::velox::gpu
+
+int main(int argc, char** argv) {
+  using namespace facebook::velox::gpu;
+  folly::init(&argc, &argv);
+  GpuAggregationTest test;
+  test.run();
+  test.runEmpty();
+  return 0;
+}
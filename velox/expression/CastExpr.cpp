@@ -28,6 +28,7 @@
 #include "velox/external/date/tz.h"
 #include "velox/functions/lib/RowsTranslationUtil.h"
 #include "velox/type/DecimalUtilOp.h"
+#include "velox/type/FastStringConversions.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FunctionVector.h"
 #include "velox/vector/SelectivityVector.h"
@@ -103,6 +104,56 @@ void applyCastKernel(
   }
 }
 
+template <typename To>
+constexpr bool kHasStringCastFastPath = std::is_same_v<To, int8_t> ||
+    std::is_same_v<To, int16_t> || std::is_same_v<To, int32_t> ||
+    std::is_same_v<To, int64_t> || std::is_same_v<To, double> ||
+    std::is_same_v<To, Date> || std::is_same_v<To, Timestamp>;
+
+template <typename To>
+bool tryCastFromStringFast(const StringView& input, To& output) {
+  if constexpr (std::is_same_v<To, double>) {
+    return util::tryParseDouble(input.data(), input.size(), output);
+  } else if constexpr (std::is_same_v<To, Date>) {
+    int64_t daysSinceEpoch;
+    if (!util::tryParseDate(input.data(), input.size(), daysSinceEpoch)) {
+      return false;
+    }
+    output = Date(daysSinceEpoch);
+    return true;
+  } else if constexpr (std::is_same_v<To, Timestamp>) {
+    return util::tryParseTimestamp(input.data(), input.size(), output);
+  } else {
+    return util::tryParseInteger(input.data(), input.size(), output);
+  }
+}
+
+/// Casts the strings of 'rows' that are in the common, unambiguous formats
+/// without exceptions or per-row conversion dispatch. Returns the rows that
+/// need the general path, e.g. because they have whitespace or an exponent
+/// or are malformed. These are usually none.
+template <typename To>
+const SelectivityVector* castFromStringFastPath(
+    const SelectivityVector& rows,
+    const SimpleVector<StringView>& input,
+    FlatVector<To>* result,
+    LocalSelectivityVector& remainingRows) {
+  auto* remaining = remainingRows.get(rows);
+  const auto* rawInput = input.isFlatEncoding()
+      ? input.asUnchecked<FlatVector<StringView>>()->rawValues()
+      : nullptr;
+  rows.applyToSelected([&](auto row) {
+    To output;
+    if (tryCastFromStringFast(
+            rawInput ? rawInput[row] : input.valueAt(row), output)) {
+      result->set(row, output);
+      remaining->setValid(row, false);
+    }
+  });
+  remaining->updateBounds();
+  return remaining;
+}
+
 std::string makeErrorMessage(
     const BaseVector& input,
     vector_size_t row,
@@ -251,8 +302,17 @@ void CastExpr::applyCastWithTry(
 
   auto* inputSimpleVector = input.as<SimpleVector<From>>();
 
+  // The rows left for the general, row by row path.
+  const SelectivityVector* castRows = &rows;
+  LocalSelectivityVector remainingRows(context);
+  if constexpr (
+      std::is_same_v<From, StringView> && kHasStringCastFastPath<To>) {
+    castRows = castFromStringFastPath(
+        rows, *inputSimpleVector, resultFlatVector, remainingRows);
+  }
+
   if (!isCastIntByTruncate) {
-    context.applyToSelectedNoThrow(rows, [&](int row) {
+    context.applyToSelectedNoThrow(*castRows, [&](int row) {
       bool nullOutput = false;
       try {
         // Passing a false truncate flag
@@ -268,21 +328,30 @@ void CastExpr::applyCastWithTry(
             makeErrorMessage(input, row, resultFlatVector->type()) + " " +
             re.message());
       } catch (const VeloxUserError& ue) {
-        VELOX_USER_FAIL(
-            makeErrorMessage(input, row, resultFlatVector->type()) + " " +
-            ue.message());
+        context.setStatus(
+            row,
+            Status::UserError(
+                makeErrorMessage(input, row, resultFlatVector->type()) + " " +
+                ue.message()));
+        return;
       } catch (const std::exception& e) {
-        VELOX_USER_FAIL(
-            makeErrorMessage(input, row, resultFlatVector->type()) + " " +
-            e.what());
+        context.setStatus(
+            row,
+            Status::UserError(
+                makeErrorMessage(input, row, resultFlatVector->type()) + " " +
+                e.what()));
+        return;
       }
 
       if (nullOutput) {
-        VELOX_USER_FAIL(makeErrorMessage(input, row, resultFlatVector->type()));
+        context.setStatus(
+            row,
+            Status::UserError(
+                makeErrorMessage(input, row, resultFlatVector->type())));
       }
     });
   } else {
-    context.applyToSelectedNoThrow(rows, [&](int row) {
+    context.applyToSelectedNoThrow(*castRows, [&](int row) {
       bool nullOutput = false;
       try {
         // Passing a true truncate flag
@@ -298,17 +367,26 @@ void CastExpr::applyCastWithTry(
             makeErrorMessage(input, row, resultFlatVector->type()) + " " +
             re.message());
       } catch (const VeloxUserError& ue) {
-        VELOX_USER_FAIL(
-            makeErrorMessage(input, row, resultFlatVector->type()) + " " +
-            ue.message());
+        context.setStatus(
+            row,
+            Status::UserError(
+                makeErrorMessage(input, row, resultFlatVector->type()) + " " +
+                ue.message()));
+        return;
       } catch (const std::exception& e) {
-        VELOX_USER_FAIL(
-            makeErrorMessage(input, row, resultFlatVector->type()) + " " +
-            e.what());
+        context.setStatus(
+            row,
+            Status::UserError(
+                makeErrorMessage(input, row, resultFlatVector->type()) + " " +
+                e.what()));
+        return;
       }
 
       if (nullOutput) {
-        VELOX_USER_FAIL(makeErrorMessage(input, row, resultFlatVector->type()));
+        context.setStatus(
+            row,
+            Status::UserError(
+                makeErrorMessage(input, row, resultFlatVector->type())));
       }
     });
   }
@@ -18,6 +18,7 @@
 #include <folly/Likely.h>
 #include <cinttypes>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <tuple>
@@ -25,6 +26,7 @@
 #include <utility>
 #include <variant>
 
+#include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/core/CoreTypeSystem.h"
 #include "velox/expression/ComplexViewTypes.h"
@@ -93,6 +95,23 @@ bool constexpr provide_std_interface =
     CppToType<V>::isPrimitiveType && !std::is_same_v<Varchar, V> &&
     !std::is_same_v<Varbinary, V> && !std::is_same_v<Any, V>;
 
+// True if the values of 'VectorType' are contiguous in memory and can be
+// copied with memcpy into a values array of primitive type 'V'. Bools are
+// excluded because FlatVector<bool> stores them as bits.
+template <typename V, typename VectorType, typename = void>
+bool constexpr provide_contiguous_values = false;
+
+template <typename V, typename VectorType>
+bool constexpr provide_contiguous_values<
+    V,
+    VectorType,
+    std::void_t<decltype(std::declval<const VectorType&>().data())>> =
+    provide_std_interface<V> && !std::is_same_v<V, bool> &&
+    std::is_same_v<
+        std::remove_cv_t<std::remove_pointer_t<
+            decltype(std::declval<const VectorType&>().data())>>,
+        typename CppToType<V>::NativeType>;
+
 // bool is an exception, it requires commit but also provides std::interface.
 template <typename V>
 bool constexpr requires_commit =
@@ -111,7 +130,7 @@ class ArrayWriter {
     auto currentSize = size + valuesOffset_;
 
     if (UNLIKELY(currentSize > elementsVectorCapacity_)) {
-      elementsVectorCapacity_ = std::pow(2, std::ceil(std::log2(currentSize)));
+      elementsVectorCapacity_ = bits::nextPowerOfTwo(currentSize);
       childWriter_->ensureSize(elementsVectorCapacity_);
     }
   }
@@ -140,6 +159,18 @@ class ArrayWriter {
     // Note: no need to commit the null item.
   }
 
+  // Add a new not null string item that points to 'value' without copying it
+  // and without going through the string writer. The caller must make sure
+  // the memory of 'value' outlives the elements vector, e.g. by acquiring the
+  // string buffers of the input.
+  template <typename T = V>
+  typename std::enable_if_t<
+      std::is_same_v<T, Varchar> || std::is_same_v<T, Varbinary>>
+  add_item_no_copy(const StringView& value) {
+    resize(length_ + 1);
+    elementsVector_->setNoCopy(valuesOffset_ + length_ - 1, value);
+  }
+
   // Should be called by the user (VectorWriter) when writing is done to commit
   // last item if needed.
   void finalize() {
@@ -214,8 +245,24 @@ class ArrayWriter {
   // Any vector type with std-like optional-free interface.
   template <typename VectorType>
   void add_items(const VectorType& data) {
-    if constexpr (provide_std_interface<V>) {
-      // TODO: accelerate this with memcpy.
+    if constexpr (provide_contiguous_values<V, VectorType>) {
+      // Copy the values directly into the elements vector.
+      auto start = valuesOffset_ + length_;
+      resize(length_ + data.size());
+      if (data.size() > 0) {
+        std::memcpy(
+            elementsVector_->mutableRawValues() + start,
+            data.data(),
+            data.size() * sizeof(element_t));
+        if (elementsVector_->rawNulls()) {
+          bits::fillBits(
+              elementsVector_->mutableRawNulls(),
+              start,
+              start + data.size(),
+              bits::kNotNull);
+        }
+      }
+    } else if constexpr (provide_std_interface<V>) {
       auto start = length_;
       resize(length_ + data.size());
       for (auto i = 0; i < data.size(); i++) {
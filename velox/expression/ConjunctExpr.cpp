@@ -123,8 +123,12 @@ void ConjunctExpr::evalSpecialForm(
   LocalSelectivityVector activeRowsHolder(context, rows);
   auto activeRows = activeRowsHolder.get();
   VELOX_DCHECK(activeRows != nullptr);
-  int32_t numActive = activeRows->countSelected();
+  const int32_t numRows = activeRows->countSelected();
+  int32_t numActive = numRows;
+  int32_t numEvaluated = 0;
   for (int32_t i = 0; i < inputs_.size(); ++i) {
+    stats_.numShortCircuitedRows += numRows - numActive;
+    ++numEvaluated;
     VectorPtr inputResult;
     VectorRecycler inputResultRecycler(inputResult, context.vectorPool());
     ErrorVectorPtr errors;
@@ -157,6 +161,9 @@ void ConjunctExpr::evalSpecialForm(
       break;
     }
   }
+  // The inputs after the one that decided all rows are skipped entirely.
+  stats_.numShortCircuitedRows +=
+      static_cast<uint64_t>(inputs_.size() - numEvaluated) * numRows;
   // Clear errors for 'rows' that are not in 'activeRows'.
   finalizeErrors(rows, *activeRows, throwOnError, context);
   if (!reorderEnabledChecked_) {
@@ -172,22 +179,20 @@ void ConjunctExpr::evalSpecialForm(
 }
 
 void ConjunctExpr::maybeReorderInputs() {
-  bool reorder = false;
-  for (auto i = 1; i < inputs_.size(); ++i) {
-    if (selectivity_[inputOrder_[i - 1]].timeToDropValue() >
-        selectivity_[inputOrder_[i]].timeToDropValue()) {
-      reorder = true;
-      break;
+  // Inputs that have not seen any rows yet have no cost to compare. They
+  // are kept after the measured inputs in their current order. Putting them
+  // first would evaluate them on all rows although the inputs before them
+  // decide all rows, as they have so far.
+  auto lessCostly = [this](int32_t left, int32_t right) {
+    const auto& leftInfo = selectivity_[left];
+    const auto& rightInfo = selectivity_[right];
+    if (leftInfo.numIn() == 0 || rightInfo.numIn() == 0) {
+      return leftInfo.numIn() != 0 && rightInfo.numIn() == 0;
     }
-  }
-  if (reorder) {
-    std::sort(
-        inputOrder_.begin(),
-        inputOrder_.end(),
-        [this](size_t left, size_t right) {
-          return selectivity_[left].timeToDropValue() <
-              selectivity_[right].timeToDropValue();
-        });
+    return leftInfo.timeToDropValue() < rightInfo.timeToDropValue();
+  };
+  if (!std::is_sorted(inputOrder_.begin(), inputOrder_.end(), lessCostly)) {
+    std::stable_sort(inputOrder_.begin(), inputOrder_.end(), lessCostly);
   }
 }
 
@@ -36,20 +36,29 @@ class DecodedArgs {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       exec::EvalCtx& context) {
+    holders_.reserve(args.size());
+    decoded_.reserve(args.size());
     for (auto& arg : args) {
-      holders_.emplace_back(context, *arg, rows);
+      // Nested dictionaries are decoded once per EvalCtx and shared.
+      if (auto* decoded = context.decodeNestedDictionary(arg, rows)) {
+        decoded_.push_back(const_cast<DecodedVector*>(decoded));
+      } else {
+        holders_.emplace_back(context, *arg, rows);
+        decoded_.push_back(holders_.back().get());
+      }
     }
   }
 
   DecodedVector* FOLLY_NONNULL at(int i) const {
-    return const_cast<exec::LocalDecodedVector*>(&holders_[i])->get();
+    return decoded_[i];
   }
 
   size_t size() const {
-    return holders_.size();
+    return decoded_.size();
   }
 
  private:
   std::vector<exec::LocalDecodedVector> holders_;
+  std::vector<DecodedVector*> decoded_;
 };
 } // namespace facebook::velox::exec
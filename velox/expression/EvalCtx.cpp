@@ -70,6 +70,28 @@ void EvalCtx::saveAndReset(
   }
 }
 
+const DecodedVector* EvalCtx::decodeNestedDictionary(
+    const VectorPtr& vector,
+    const SelectivityVector& rows) {
+  if (vector->encoding() != VectorEncoding::Simple::DICTIONARY ||
+      vector->valueVector()->encoding() != VectorEncoding::Simple::DICTIONARY) {
+    return nullptr;
+  }
+  for (const auto& entry : decodedNestedDictionaries_) {
+    if (entry.vector == vector && rows.isSubset(entry.rows)) {
+      return entry.decoded.get();
+    }
+  }
+  if (decodedNestedDictionaries_.size() >= kMaxDecodedNestedDictionaries) {
+    return nullptr;
+  }
+  auto& entry = decodedNestedDictionaries_.emplace_back();
+  entry.vector = vector;
+  entry.rows = rows;
+  entry.decoded = std::make_unique<DecodedVector>(*vector, rows);
+  return entry.decoded.get();
+}
+
 void EvalCtx::ensureErrorsVectorSize(ErrorVectorPtr& vector, vector_size_t size)
     const {
   auto oldSize = vector ? vector->size() : 0;
@@ -180,6 +202,24 @@ void EvalCtx::setError(
   addError(index, toVeloxException(exceptionPtr), errors_);
 }
 
+void EvalCtx::setStatus(vector_size_t index, const Status& status) {
+  VELOX_DCHECK(!status.ok());
+  auto exceptionPtr = std::make_exception_ptr(VeloxUserError(
+      __FILE__,
+      __LINE__,
+      __FUNCTION__,
+      "",
+      status.message(),
+      error_source::kErrorSourceUser,
+      status.errorCode(),
+      /* isRetriable */ false));
+  if (throwOnError_) {
+    std::rethrow_exception(exceptionPtr);
+  }
+
+  addError(index, exceptionPtr, errors_);
+}
+
 void EvalCtx::setErrors(
     const SelectivityVector& rows,
     const std::exception_ptr& exceptionPtr) {
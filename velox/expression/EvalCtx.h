@@ -19,6 +19,7 @@
 #include <functional>
 
 #include "velox/common/base/Portability.h"
+#include "velox/common/base/Status.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FlatVector.h"
@@ -87,6 +88,11 @@ class EvalCtx {
       const SelectivityVector& rows,
       const std::exception_ptr& exceptionPtr);
 
+  /// Records the error reported by a non-OK 'status' at 'index' as a
+  /// VeloxUserError, like setError() but without throwing and catching an
+  /// exception. Throws the error if 'throwOnError_' is set.
+  void setStatus(vector_size_t index, const Status& status);
+
   /// Invokes a function on each selected row. Records per-row exceptions by
   /// calling 'setError'. The function must take a single "row" argument of type
   /// vector_size_t and return void.
@@ -253,7 +259,28 @@ class EvalCtx {
     return peeledEncoding_.get();
   }
 
+  /// Returns 'vector' decoded for 'rows' if 'vector' is a dictionary over
+  /// another dictionary, or nullptr otherwise. Decoding such a vector composes
+  /// the indices of all the layers, so the result is kept for the lifetime of
+  /// 'this' and returned again for the same vector and a subset of 'rows',
+  /// e.g. when different functions take the same input. The returned
+  /// DecodedVector must not be modified.
+  const DecodedVector* FOLLY_NULLABLE decodeNestedDictionary(
+      const VectorPtr& vector,
+      const SelectivityVector& rows);
+
  private:
+  struct DecodedNestedDictionary {
+    // Holds a reference to the vector, so that its address identifies it for
+    // the lifetime of the cache.
+    VectorPtr vector;
+    SelectivityVector rows;
+    std::unique_ptr<DecodedVector> decoded;
+  };
+
+  // Max number of vectors in 'decodedNestedDictionaries_'.
+  static constexpr int32_t kMaxDecodedNestedDictionaries = 8;
+
   core::ExecCtx* const FOLLY_NONNULL execCtx_;
   ExprSet* FOLLY_NULLABLE const exprSet_;
   const RowVector* FOLLY_NULLABLE row_;
@@ -284,6 +311,8 @@ class EvalCtx {
   // in a opaque flat vector, which will translate to a
   // std::shared_ptr<std::exception_ptr>.
   ErrorVectorPtr errors_;
+
+  std::vector<DecodedNestedDictionary> decodedNestedDictionaries_;
 };
 
 /// Utility wrapper struct that is used to temporarily reset the value of the an
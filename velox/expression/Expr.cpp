@@ -952,25 +952,28 @@ void Expr::evalWithMemo(
     VectorPtr& result) {
   VectorPtr base;
   distinctFields_[0]->evalSpecialForm(rows, context, base);
-  ++numCachableInput_;
-  if (baseDictionary_ == base) {
-    ++numCacheableRepeats_;
-    if (cachedDictionaryIndices_) {
-      LocalSelectivityVector cachedHolder(context, rows);
-      auto cached = cachedHolder.get();
-      VELOX_DCHECK(cached != nullptr);
-      cached->intersect(*cachedDictionaryIndices_);
-      if (cached->hasSelections()) {
-        context.ensureWritable(rows, type(), result);
-        result->copy(dictionaryCache_.get(), *cached, nullptr);
-      }
+  auto it = std::find_if(memo_.begin(), memo_.end(), [&](const auto& entry) {
+    return entry.baseDictionary == base;
+  });
+  if (it != memo_.end()) {
+    ++stats_.numMemoHits;
+    // Move the entry to the front.
+    std::rotate(memo_.begin(), it, it + 1);
+    auto& dictionaryCache = memo_.front().dictionaryCache;
+    auto& cachedDictionaryIndices = *memo_.front().cachedDictionaryIndices;
+
+    LocalSelectivityVector cachedHolder(context, rows);
+    auto cached = cachedHolder.get();
+    VELOX_DCHECK(cached != nullptr);
+    cached->intersect(cachedDictionaryIndices);
+    if (cached->hasSelections()) {
+      context.ensureWritable(rows, type(), result);
+      result->copy(dictionaryCache.get(), *cached, nullptr);
     }
     LocalSelectivityVector uncachedHolder(context, rows);
     auto uncached = uncachedHolder.get();
     VELOX_DCHECK(uncached != nullptr);
-    if (cachedDictionaryIndices_) {
-      uncached->deselect(*cachedDictionaryIndices_);
-    }
+    uncached->deselect(cachedDictionaryIndices);
     if (uncached->hasSelections()) {
       // Fix finalSelection at "rows" if uncached rows is a strict subset to
       // avoid losing values not in uncached rows that were copied earlier into
@@ -983,44 +986,54 @@ void Expr::evalWithMemo(
       context.exprSet()->addToMemo(this);
       auto newCacheSize = uncached->end();
 
-      // dictionaryCache_ is valid only for cachedDictionaryIndices_. Hence, a
+      // dictionaryCache is valid only for cachedDictionaryIndices. Hence, a
       // safe call to BaseVector::ensureWritable must include all the rows not
-      // covered by cachedDictionaryIndices_. If BaseVector::ensureWritable is
+      // covered by cachedDictionaryIndices. If BaseVector::ensureWritable is
       // called only for a subset of rows not covered by
-      // cachedDictionaryIndices_, it will attempt to copy rows that are not
+      // cachedDictionaryIndices, it will attempt to copy rows that are not
       // valid leading to a crash.
-      LocalSelectivityVector allUncached(context, dictionaryCache_->size());
+      LocalSelectivityVector allUncached(context, dictionaryCache->size());
       allUncached.get()->setAll();
-      allUncached.get()->deselect(*cachedDictionaryIndices_);
-      context.ensureWritable(*allUncached.get(), type(), dictionaryCache_);
+      allUncached.get()->deselect(cachedDictionaryIndices);
+      context.ensureWritable(*allUncached.get(), type(), dictionaryCache);
 
-      if (cachedDictionaryIndices_->size() < newCacheSize) {
-        cachedDictionaryIndices_->resize(newCacheSize, false);
+      if (cachedDictionaryIndices.size() < newCacheSize) {
+        cachedDictionaryIndices.resize(newCacheSize, false);
       }
 
-      cachedDictionaryIndices_->select(*uncached);
+      cachedDictionaryIndices.select(*uncached);
 
-      // Resize the dictionaryCache_ to accommodate all the necessary rows.
-      if (dictionaryCache_->size() < uncached->end()) {
-        dictionaryCache_->resize(uncached->end());
+      // Resize the dictionaryCache to accommodate all the necessary rows.
+      if (dictionaryCache->size() < uncached->end()) {
+        dictionaryCache->resize(uncached->end());
       }
-      dictionaryCache_->copy(result.get(), *uncached, nullptr);
+      dictionaryCache->copy(result.get(), *uncached, nullptr);
     }
     context.releaseVector(base);
     return;
   }
-  context.releaseVector(baseDictionary_);
-  baseDictionary_ = base;
+
+  ++stats_.numMemoMisses;
+  std::unique_ptr<SelectivityVector> cachedDictionaryIndices;
+  if (memo_.size() == kMaxMemoEntries) {
+    auto& leastRecentlyUsed = memo_.back();
+    context.releaseVector(leastRecentlyUsed.baseDictionary);
+    context.releaseVector(leastRecentlyUsed.dictionaryCache);
+    cachedDictionaryIndices =
+        std::move(leastRecentlyUsed.cachedDictionaryIndices);
+    memo_.pop_back();
+  }
   evalWithNulls(rows, context, result);
 
-  context.releaseVector(dictionaryCache_);
-  dictionaryCache_ = result;
-  if (!cachedDictionaryIndices_) {
-    cachedDictionaryIndices_ =
+  if (!cachedDictionaryIndices) {
+    cachedDictionaryIndices =
         context.execCtx()->getSelectivityVector(rows.end());
   }
-  *cachedDictionaryIndices_ = rows;
-  context.deselectErrors(*cachedDictionaryIndices_);
+  *cachedDictionaryIndices = rows;
+  context.deselectErrors(*cachedDictionaryIndices);
+  memo_.insert(
+      memo_.begin(),
+      MemoEntry{std::move(base), result, std::move(cachedDictionaryIndices)});
 }
 
 void Expr::setAllNulls(
@@ -1221,8 +1234,13 @@ void Expr::evalAllImpl(
 
     // Avoid subsequent computation on rows with known null output.
     if (defaultNulls && inputValues_[i]->mayHaveNulls()) {
-      LocalDecodedVector decoded(
-          context, *inputValues_[i], remainingRows.rows());
+      LocalDecodedVector holder(context);
+      const DecodedVector* decoded = context.decodeNestedDictionary(
+          inputValues_[i], remainingRows.rows());
+      if (!decoded) {
+        holder.get()->decode(*inputValues_[i], remainingRows.rows());
+        decoded = holder.get();
+      }
 
       if (auto* rawNulls = decoded->nulls()) {
         if (!remainingRows.deselectNulls(rawNulls)) {
@@ -56,18 +56,38 @@ struct ExprStats {
   /// size.
   uint64_t numProcessedVectors{0};
 
+  /// Number of evaluations over dictionary encoded inputs whose base was
+  /// found in the memo of the expression.
+  uint64_t numMemoHits{0};
+
+  /// Number of evaluations over dictionary encoded inputs whose base was not
+  /// in the memo and was added to it.
+  uint64_t numMemoMisses{0};
+
+  /// Number of rows AND and OR did not evaluate an input for because the
+  /// result of the row was decided by the inputs evaluated before it. Summed
+  /// over the inputs.
+  uint64_t numShortCircuitedRows{0};
+
   void add(const ExprStats& other) {
     timing.add(other.timing);
     numProcessedRows += other.numProcessedRows;
     numProcessedVectors += other.numProcessedVectors;
+    numMemoHits += other.numMemoHits;
+    numMemoMisses += other.numMemoMisses;
+    numShortCircuitedRows += other.numShortCircuitedRows;
   }
 
   std::string toString() const {
     return fmt::format(
-        "timing: {}, numProcessedRows: {}, numProcessedVectors: {}",
+        "timing: {}, numProcessedRows: {}, numProcessedVectors: {}, "
+        "numMemoHits: {}, numMemoMisses: {}, numShortCircuitedRows: {}",
         timing.toString(),
         numProcessedRows,
-        numProcessedVectors);
+        numProcessedVectors,
+        numMemoHits,
+        numMemoMisses,
+        numShortCircuitedRows);
   }
 };
 
@@ -163,9 +183,7 @@ class Expr {
   }
 
   void clearMemo() {
-    baseDictionary_ = nullptr;
-    dictionaryCache_ = nullptr;
-    cachedDictionaryIndices_ = nullptr;
+    memo_.clear();
   }
 
   const TypePtr& type() const {
@@ -439,21 +457,27 @@ class Expr {
   // evaluateSharedSubexpr() is called to the cached shared results.
   std::map<std::vector<const BaseVector*>, SharedResults> sharedSubexprResults_;
 
-  VectorPtr baseDictionary_;
+  // Results memoized for the base of a dictionary encoded input.
+  struct MemoEntry {
+    VectorPtr baseDictionary;
 
-  // Values computed for the base dictionary, 1:1 to the positions in
-  // 'baseDictionary_'.
-  VectorPtr dictionaryCache_;
+    // Values computed for the base dictionary, 1:1 to the positions in
+    // 'baseDictionary'.
+    VectorPtr dictionaryCache;
 
-  // The indices that are valid in 'dictionaryCache_'.
-  std::unique_ptr<SelectivityVector> cachedDictionaryIndices_;
+    // The indices that are valid in 'dictionaryCache'.
+    std::unique_ptr<SelectivityVector> cachedDictionaryIndices;
+  };
 
-  // Count of executions where this is wrapped in a dictionary so that
-  // results could be cached.
-  int32_t numCachableInput_{0};
+  // Maximum number of bases in 'memo_'.
+  static constexpr int32_t kMaxMemoEntries = 4;
 
-  // Count of times the cacheable vector is seen for a non-first time.
-  int32_t numCacheableRepeats_{0};
+  // Memoized results keyed on the identity of the base vector, most recently
+  // used first. Keeping more than one base lets batches that interleave
+  // dictionaries over a few bases, e.g. from different files or row groups,
+  // evaluate each distinct value once. The least recently used base is
+  // dropped when a new one is added to a full memo.
+  std::vector<MemoEntry> memo_;
 
   /// Runtime statistics. CPU time, wall time and number of processed rows.
   ExprStats stats_;
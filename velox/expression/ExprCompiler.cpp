@@ -21,6 +21,7 @@
 #include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/FieldReference.h"
+#include "velox/expression/FunctionResolutionCache.h"
 #include "velox/expression/LambdaExpr.h"
 #include "velox/expression/SimpleFunctionRegistry.h"
 #include "velox/expression/SwitchExpr.h"
@@ -369,6 +370,13 @@ std::vector<VectorPtr> getConstantInputs(const std::vector<ExprPtr>& exprs) {
   return constants;
 }
 
+// Returns the cache of function resolutions of the query, which is shared by
+// the ExprSets of all its drivers.
+FunctionResolutionCache& functionResolutions(Scope* scope) {
+  return FunctionResolutionCache::get(
+      *scope->exprSet->execCtx()->queryCtx());
+}
+
 ExprPtr compileExpression(
     const TypedExprPtr& expr,
     Scope* scope,
@@ -416,27 +424,20 @@ ExprPtr compileExpression(
             trackCpuUsage)) {
       result = specialForm;
     } else if (
-        auto func = getVectorFunction(
-            call->name(), inputTypes, getConstantInputs(compiledInputs))) {
-      result = std::make_shared<Expr>(
-          resultType,
-          std::move(compiledInputs),
-          func,
-          call->name(),
-          trackCpuUsage);
-    } else if (
-        auto simpleFunctionEntry =
-            SimpleFunctions().resolveFunction(call->name(), inputTypes)) {
-      VELOX_USER_CHECK(
-          resultType->equivalent(*simpleFunctionEntry->type().get()),
-          "Found incompatible return types for '{}' ({} vs. {}) "
-          "for input types ({}).",
-          call->name(),
-          simpleFunctionEntry->type(),
-          resultType,
-          folly::join(", ", inputTypes));
-      auto func = simpleFunctionEntry->createFunction()->createVectorFunction(
-          config, getConstantInputs(compiledInputs));
+        auto resolution = functionResolutions(scope).resolve(
+            call->name(), inputTypes)) {
+      if (resolution->simpleFunctionType != nullptr) {
+        VELOX_USER_CHECK(
+            resultType->equivalent(*resolution->simpleFunctionType),
+            "Found incompatible return types for '{}' ({} vs. {}) "
+            "for input types ({}).",
+            call->name(),
+            resolution->simpleFunctionType,
+            resultType,
+            folly::join(", ", inputTypes));
+      }
+      auto func = resolution->makeFunction(
+          getConstantInputs(compiledInputs), config);
       result = std::make_shared<Expr>(
           resultType,
           std::move(compiledInputs),
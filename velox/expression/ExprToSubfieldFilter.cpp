@@ -457,6 +457,31 @@ std::unique_ptr<common::Filter> makeBetweenFilter(
   }
 }
 
+// Makes the filter of Spark's might_contain(bloomFilter, value) with a
+// constant 'bloomFilterExpr' in the serialized format of the Bloom filter
+// aggregate. A null or empty Bloom filter contains no values.
+std::unique_ptr<common::Filter> makeMightContainFilter(
+    const core::TypedExprPtr& bloomFilterExpr) {
+  auto queryCtx = std::make_shared<core::QueryCtx>();
+  auto serialized = toConstant(bloomFilterExpr, queryCtx);
+  if (!serialized || serialized->typeKind() != TypeKind::VARBINARY) {
+    return nullptr;
+  }
+  if (serialized->isNullAt(0)) {
+    return std::make_unique<common::AlwaysFalse>();
+  }
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->merge(singleValue<StringView>(serialized).data());
+  if (!bloomFilter->isSet()) {
+    return std::make_unique<common::AlwaysFalse>();
+  }
+  return std::make_unique<common::BigintValuesUsingBloomFilter>(
+      std::numeric_limits<int64_t>::min(),
+      std::numeric_limits<int64_t>::max(),
+      std::move(bloomFilter),
+      false);
+}
+
 } // namespace
 
 std::unique_ptr<common::Filter> leafCallToSubfieldFilter(
@@ -517,6 +542,14 @@ std::unique_ptr<common::Filter> leafCallToSubfieldFilter(
         return makeInFilter(call.inputs()[1], negated);
       }
     }
+  } else if (call.name() == "might_contain") {
+    // NOTE: a Bloom filter can't test that a value is not contained.
+    if (auto field = asField(&call, 1)) {
+      if (!negated && field->type()->kind() == TypeKind::BIGINT &&
+          toSubfield(field, subfield)) {
+        return makeMightContainFilter(call.inputs()[0]);
+      }
+    }
   } else if (call.name() == "is_null" || call.name() == "isnull") {
     if (auto field = asField(&call, 0)) {
       if (toSubfield(field, subfield)) {
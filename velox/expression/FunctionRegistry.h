@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/expression/SignatureBinder.h"
+#include "velox/expression/SignatureResolutionCache.h"
 #include "velox/type/Type.h"
 
 namespace facebook::velox::exec {
@@ -85,6 +86,8 @@ class FunctionRegistry {
   /// Used only in the unit tests.
   void testingClear() {
     registeredFunctions_.clear();
+    advanceFunctionRegistryVersion();
+    resolutions_.clear();
   }
 
   std::vector<const FunctionSignature*> getFunctionSignatures(
@@ -124,9 +127,38 @@ class FunctionRegistry {
     TypePtr type_;
   };
 
+  /// Returns the function with the highest priority among the ones whose
+  /// signatures bind to 'argTypes'. The results are cached, so that the
+  /// signatures are bound once per distinct call.
   std::optional<ResolvedSimpleFunction> resolveFunction(
       const std::string& name,
       const std::vector<TypePtr>& argTypes) const {
+    const auto resolved = resolutions_.resolve(
+        sanitizeName(name), argTypes, [&]() {
+          return resolveFunctionUncached(name, argTypes);
+        });
+    return resolved.entry != nullptr
+        ? std::optional<ResolvedSimpleFunction>(
+              ResolvedSimpleFunction(*resolved.entry, resolved.type))
+        : std::nullopt;
+  }
+
+  void clearRegistry() {
+    registeredFunctions_.clear();
+    advanceFunctionRegistryVersion();
+    resolutions_.clear();
+  }
+
+ private:
+  struct Resolution {
+    // nullptr if no function matches.
+    const FunctionEntry<Function, Metadata>* entry;
+    TypePtr type;
+  };
+
+  Resolution resolveFunctionUncached(
+      const std::string& name,
+      const std::vector<TypePtr>& argTypes) const {
     const FunctionEntry<Function, Metadata>* selectedCandidate = nullptr;
     TypePtr selectedCandidateType = nullptr;
     if (const auto* signatureMap = getSignatureMap(name)) {
@@ -146,17 +178,9 @@ class FunctionRegistry {
 
     VELOX_DCHECK(!selectedCandidate || selectedCandidateType);
 
-    return selectedCandidate
-        ? std::optional<ResolvedSimpleFunction>(
-              ResolvedSimpleFunction(*selectedCandidate, selectedCandidateType))
-        : std::nullopt;
-  }
-
-  void clearRegistry() {
-    registeredFunctions_.clear();
+    return {selectedCandidate, selectedCandidateType};
   }
 
- private:
   template <typename T>
   static std::unique_ptr<T> CreateUdf() {
     return std::make_unique<T>();
@@ -172,6 +196,8 @@ class FunctionRegistry {
     signatureMap[*metadata->signature()] =
         std::make_unique<const FunctionEntry<Function, Metadata>>(
             metadata, factory);
+    advanceFunctionRegistryVersion();
+    resolutions_.clear();
   }
 
   const SignatureMap* getSignatureMap(const std::string& name) const {
@@ -181,5 +207,6 @@ class FunctionRegistry {
   }
 
   FunctionMap registeredFunctions_;
+  mutable SignatureResolutionCache<Resolution> resolutions_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/FunctionResolutionCache.h"
+
+#include <chrono>
+
+#include "velox/expression/SimpleFunctionRegistry.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+std::string makeKey(
+    const std::string& name,
+    const std::vector<TypePtr>& argTypes) {
+  std::string key = sanitizeName(name);
+  key += '(';
+  for (auto i = 0; i < argTypes.size(); ++i) {
+    if (i > 0) {
+      key += ", ";
+    }
+    key += argTypes[i]->toString();
+  }
+  key += ')';
+  return key;
+}
+
+// Sets the function maker of 'resolution' if a vector or simple function
+// matches. Like getVectorFunction() and SimpleFunctions().resolveFunction()
+// but without making the function.
+bool resolveFunction(
+    const std::string& name,
+    const std::vector<TypePtr>& argTypes,
+    FunctionResolutionCache::Resolution& resolution) {
+  if (auto factory = resolveVectorFunctionFactory(name, argTypes)) {
+    resolution.makeFunction =
+        [factory = std::move(factory),
+         sanitizedName = sanitizeName(name),
+         argTypes](
+            const std::vector<VectorPtr>& constantInputs,
+            const core::QueryConfig& /*config*/) {
+          if (!constantInputs.empty()) {
+            VELOX_CHECK_EQ(argTypes.size(), constantInputs.size());
+          }
+          std::vector<VectorFunctionArg> inputArgs;
+          inputArgs.reserve(argTypes.size());
+          for (auto i = 0; i < argTypes.size(); ++i) {
+            inputArgs.push_back(
+                {argTypes[i],
+                 constantInputs.empty() ? nullptr : constantInputs[i]});
+          }
+          return (*factory)(sanitizedName, inputArgs);
+        };
+    return true;
+  }
+
+  auto simpleFunction = SimpleFunctions().resolveFunction(name, argTypes);
+  if (!simpleFunction.has_value()) {
+    return false;
+  }
+  resolution.simpleFunctionType = simpleFunction->type();
+  resolution.makeFunction =
+      [simpleFunction = std::move(simpleFunction.value())](
+          const std::vector<VectorPtr>& constantInputs,
+          const core::QueryConfig& config) {
+        auto function = simpleFunction;
+        return std::shared_ptr<VectorFunction>(
+            function.createFunction()->createVectorFunction(
+                config, constantInputs));
+      };
+  return true;
+}
+} // namespace
+
+std::shared_ptr<const FunctionResolutionCache::Resolution>
+FunctionResolutionCache::resolve(
+    const std::string& name,
+    const std::vector<TypePtr>& argTypes) {
+  auto key = makeKey(name, argTypes);
+  uint64_t registryVersion;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numLookups;
+    registryVersion = functionRegistryVersion();
+    if (registryVersion != registryVersion_) {
+      resolutions_.clear();
+      registryVersion_ = registryVersion;
+    }
+    auto it = resolutions_.find(key);
+    if (it != resolutions_.end()) {
+      ++stats_.numHits;
+      stats_.savedNanos += it->second->resolveNanos;
+      return it->second;
+    }
+  }
+
+  auto resolution = std::make_shared<Resolution>();
+  const auto start = std::chrono::steady_clock::now();
+  if (!resolveFunction(name, argTypes, *resolution)) {
+    return nullptr;
+  }
+  resolution->resolveNanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+
+  std::lock_guard<std::mutex> l(mutex_);
+  // The resolution may refer to functions replaced by a registration since.
+  if (registryVersion == registryVersion_ &&
+      registryVersion == functionRegistryVersion()) {
+    resolutions_.emplace(std::move(key), resolution);
+  }
+  return resolution;
+}
+
+FunctionResolutionCache::Stats FunctionResolutionCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+
+#include "folly/container/F14Map.h"
+#include "velox/core/QueryCtx.h"
+#include "velox/expression/VectorFunction.h"
+
+namespace facebook::velox::exec {
+
+/// Caches the resolution of function calls to the registered vector and
+/// simple functions by function name and argument types. Resolving binds the
+/// argument types to each signature registered for the name, which is most of
+/// the time of compiling an ExprSet. The ExprSets of all the drivers of all
+/// the tasks of a query share one cache through the QueryCtx, so that each
+/// call is resolved once per query instead of once per driver. The function
+/// instances are still made for each ExprSet, since they may keep state that
+/// is not thread-safe, e.g. of simple functions.
+///
+/// Thread-safe.
+class FunctionResolutionCache {
+ public:
+  struct Resolution {
+    /// The return type of the simple function the call resolved to. nullptr
+    /// if the call resolved to a vector function.
+    TypePtr simpleFunctionType;
+
+    /// Makes an instance of the function for a call with 'constantInputs',
+    /// which has one entry per argument or is empty.
+    std::function<std::shared_ptr<VectorFunction>(
+        const std::vector<VectorPtr>& constantInputs,
+        const core::QueryConfig& config)>
+        makeFunction;
+
+    /// The time it took to resolve.
+    uint64_t resolveNanos{0};
+  };
+
+  struct Stats {
+    uint64_t numLookups{0};
+    uint64_t numHits{0};
+
+    /// The time the hits would have taken to resolve.
+    uint64_t savedNanos{0};
+  };
+
+  /// Returns the cache shared by the ExprSets of the query of 'queryCtx'.
+  static FunctionResolutionCache& get(core::QueryCtx& queryCtx) {
+    return *queryCtx.sharedState<FunctionResolutionCache>();
+  }
+
+  /// Returns the resolution of a call to 'name' with 'argTypes', preferring
+  /// vector functions over simple functions. Returns nullptr if no function
+  /// matches.
+  std::shared_ptr<const Resolution> resolve(
+      const std::string& name,
+      const std::vector<TypePtr>& argTypes);
+
+  Stats stats() const;
+
+ private:
+  mutable std::mutex mutex_;
+  // The functionRegistryVersion() of 'resolutions_'.
+  uint64_t registryVersion_{0};
+  folly::F14FastMap<std::string, std::shared_ptr<const Resolution>>
+      resolutions_;
+  Stats stats_;
+};
+
+} // namespace facebook::velox::exec
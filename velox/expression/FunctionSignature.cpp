@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <atomic>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/trim.hpp>
 
@@ -22,6 +24,18 @@
 
 namespace facebook::velox::exec {
 
+namespace {
+std::atomic<uint64_t> registryVersion{0};
+} // namespace
+
+uint64_t functionRegistryVersion() {
+  return registryVersion;
+}
+
+void advanceFunctionRegistryVersion() {
+  ++registryVersion;
+}
+
 std::string sanitizeName(const std::string& name) {
   std::string sanitizedName;
   sanitizedName.resize(name.size());
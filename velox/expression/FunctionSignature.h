@@ -27,6 +27,15 @@ namespace facebook::velox::exec {
 
 std::string sanitizeName(const std::string& name);
 
+/// Returns a number that changes whenever a vector or simple function is
+/// registered. Caches of function resolutions compare it to its value at the
+/// time they resolved to drop stale entries.
+uint64_t functionRegistryVersion();
+
+/// Changes the value returned by functionRegistryVersion(). Called by the
+/// function registries on each registration.
+void advanceFunctionRegistryVersion();
+
 inline bool isCommonDecimalName(const std::string& typeName) {
   return (typeName == "DECIMAL");
 }
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "folly/concurrency/ConcurrentHashMap.h"
+#include "folly/hash/Hash.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/type/Type.h"
+
+namespace facebook::velox::exec {
+
+/// Caches the results of resolving calls to the functions of a registry by
+/// function name and argument types, including the calls that match no
+/// function. The entries are in a folly::ConcurrentHashMap, whose readers
+/// do not lock, so that the drivers that compile expressions at the same
+/// time do not contend on the registry or bind each signature again.
+///
+/// The registry clears the cache on each registration. Registering functions
+/// while resolving calls is not supported, as for the registries themselves.
+template <typename Value>
+class SignatureResolutionCache {
+ public:
+  /// Returns the cached value for a call to 'sanitizedName' with 'argTypes',
+  /// or calls 'resolve' and caches its result.
+  template <typename Resolve>
+  Value resolve(
+      const std::string& sanitizedName,
+      const std::vector<TypePtr>& argTypes,
+      Resolve&& resolve) {
+    Key key{sanitizedName, argTypes};
+    auto it = map_.find(key);
+    if (it != map_.cend()) {
+      return it->second;
+    }
+    const auto version = functionRegistryVersion();
+    auto value = resolve();
+    if (map_.size() < kMaxEntries && version == functionRegistryVersion()) {
+      map_.insert(std::move(key), value);
+    }
+    return value;
+  }
+
+  void clear() {
+    map_.clear();
+  }
+
+  size_t size() const {
+    return map_.size();
+  }
+
+ private:
+  // Bounds the memory of the processes that see many distinct calls, e.g.
+  // with many row types.
+  static constexpr size_t kMaxEntries = 100'000;
+
+  struct Key {
+    std::string name;
+    std::vector<TypePtr> argTypes;
+
+    bool operator==(const Key& other) const {
+      if (name != other.name || argTypes.size() != other.argTypes.size()) {
+        return false;
+      }
+      for (auto i = 0; i < argTypes.size(); ++i) {
+        if (*argTypes[i] != *other.argTypes[i]) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      auto hash = folly::hasher<std::string>()(key.name);
+      for (const auto& type : key.argTypes) {
+        hash = folly::hash::hash_combine(hash, type->hashKind());
+      }
+      return hash;
+    }
+  };
+
+  folly::ConcurrentHashMap<Key, Value, KeyHasher> map_;
+};
+
+} // namespace facebook::velox::exec
@@ -133,6 +133,14 @@ class SimpleFunctionAdapter : public VectorFunction {
     }() && ...);
   }
 
+  /// When true, callBatch() of the function is used for flat arguments. The
+  /// function is then called once for the contiguous range of values between
+  /// the first and the last selected row.
+  static constexpr bool batchIteration = FUNC::udf_has_callBatch &&
+      fastPathIteration &&
+      return_type_traits::typeKind != TypeKind::BOOLEAN &&
+      allArgsFlatConstantFastPathEligible();
+
   /// When true, a fast path for each possible combination of encodings will be
   /// used for reading arguments when all arguments are flat or constant
   /// primitivies.
@@ -155,8 +163,9 @@ class SimpleFunctionAdapter : public VectorFunction {
         const TypePtr& outputType,
         EvalCtx& _context,
         VectorPtr& _result,
-        bool isResultReused)
-        : rows{_rows}, context{_context} {
+        bool isResultReused,
+        FUNC& _fn)
+        : rows{_rows}, context{_context}, fn{_fn} {
       // If we're reusing the input, we've already checked that the vector
       // is unique, as is nulls.  We also know the size of the vector is
       // at least as large as the size of rows.
@@ -177,13 +186,25 @@ class SimpleFunctionAdapter : public VectorFunction {
 
     template <typename Callable>
     void applyToSelectedNoThrow(Callable func) {
-      context.template applyToSelectedNoThrow<Callable>(*rows, func);
+      if constexpr (FUNC::udf_has_call_return_status) {
+        // Records the errors reported by call() as they happen. The row has
+        // already been written as null.
+        context.applyToSelectedNoThrow(*rows, [&](auto row) INLINE_LAMBDA {
+          func(row);
+          if (UNLIKELY(fn.hasError())) {
+            context.setStatus(row, fn.takeError());
+          }
+        });
+      } else {
+        context.template applyToSelectedNoThrow<Callable>(*rows, func);
+      }
     }
 
     const SelectivityVector* rows;
     result_vector_t* result;
     VectorWriter<typename FUNC::return_type> resultWriter;
     EvalCtx& context;
+    FUNC& fn;
     bool allAscii{false};
     bool mayHaveNullsRecursive{false};
   };
@@ -274,6 +295,9 @@ class SimpleFunctionAdapter : public VectorFunction {
       const TypePtr& outputType,
       EvalCtx& context,
       VectorPtr& result) const override {
+    // Values of rows that are not in 'rows' can be overwritten if the result
+    // is allocated here.
+    const bool canWriteUnselectedRows = result == nullptr;
     auto* reusableResult = &result;
     // If result is null, check if one of the arguments can be re-used for
     // storing the result. This is possible if all the following conditions are
@@ -298,7 +322,7 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
 
     ApplyContext applyContext{
-        &rows, outputType, context, *reusableResult, isResultReused};
+        &rows, outputType, context, *reusableResult, isResultReused, *fn_};
 
     // If the function provides an initialize() method and it threw, we set that
     // exception in all active rows and we're done with it.
@@ -330,6 +354,18 @@ class SimpleFunctionAdapter : public VectorFunction {
       }
     }
 
+    if constexpr (batchIteration) {
+      if ((rows.isAllSelected() || canWriteUnselectedRows) &&
+          allArgsFlat(args)) {
+        applyBatch(
+            applyContext, args, std::make_index_sequence<FUNC::num_args>());
+        if (isResultReused) {
+          result = std::move(*reusableResult);
+        }
+        return;
+      }
+    }
+
     std::vector<std::optional<LocalDecodedVector>> decoded;
     if (allPrimitiveArgsFlatConstant(args)) {
       if constexpr (
@@ -430,6 +466,49 @@ class SimpleFunctionAdapter : public VectorFunction {
   }
 
  private:
+  static bool allArgsFlat(const std::vector<VectorPtr>& args) {
+    for (const auto& arg : args) {
+      if (!arg->isFlatEncoding()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Calls callBatch() for all values from the first to the last selected row.
+  // The nulls of the result are the nulls of the arguments ANDed a word at a
+  // time.
+  template <size_t... Is>
+  void applyBatch(
+      ApplyContext& applyContext,
+      const std::vector<VectorPtr>& args,
+      std::index_sequence<Is...>) const {
+    const auto begin = applyContext.rows->begin();
+    const auto end = applyContext.rows->end();
+    (*fn_).callBatch(
+        applyContext.resultWriter.data_ + begin,
+        (args[Is]->template asUnchecked<FlatVector<exec_arg_at<Is>>>()
+             ->rawValues() +
+         begin)...,
+        end - begin);
+
+    uint64_t* rawNulls = nullptr;
+    (
+        [&]() {
+          auto* argNulls = args[Is]->rawNulls();
+          if (!argNulls) {
+            return;
+          }
+          if (!rawNulls) {
+            rawNulls = applyContext.result->mutableRawNulls();
+          }
+          if (argNulls != rawNulls) {
+            bits::andBits(rawNulls, argNulls, begin, end);
+          }
+        }(),
+        ...);
+  }
+
   // This is called only when we know that all args are flat or constant and are
   // eligible for the optimization and the optimization is enabled.
   template <int32_t POSITION, typename... TReader>
@@ -18,6 +18,7 @@
 #include "folly/Singleton.h"
 #include "folly/Synchronized.h"
 #include "velox/expression/SignatureBinder.h"
+#include "velox/expression/SignatureResolutionCache.h"
 
 namespace facebook::velox::exec {
 
@@ -38,20 +39,61 @@ std::optional<std::vector<FunctionSignaturePtr>> getVectorFunctionSignatures(
       });
 }
 
+namespace {
+struct VectorFunctionResolution {
+  // nullptr if no signature binds.
+  TypePtr returnType;
+  std::shared_ptr<const VectorFunctionFactory> factory;
+};
+
+SignatureResolutionCache<VectorFunctionResolution>&
+vectorFunctionResolutions() {
+  static SignatureResolutionCache<VectorFunctionResolution> resolutions;
+  return resolutions;
+}
+
+VectorFunctionResolution resolveVectorFunctionCached(
+    const std::string& sanitizedName,
+    const std::vector<TypePtr>& argTypes) {
+  return vectorFunctionResolutions().resolve(sanitizedName, argTypes, [&]() {
+    return vectorFunctionFactories().withRLock(
+        [&](auto& functionMap) -> VectorFunctionResolution {
+          auto it = functionMap.find(sanitizedName);
+          if (it == functionMap.end()) {
+            return {};
+          }
+          for (const auto& signature : it->second.signatures) {
+            SignatureBinder binder(*signature, argTypes);
+            if (binder.tryBind()) {
+              return {
+                  binder.tryResolveReturnType(),
+                  std::make_shared<const VectorFunctionFactory>(
+                      it->second.factory)};
+            }
+          }
+          return {};
+        });
+  });
+}
+} // namespace
+
 std::shared_ptr<const Type> resolveVectorFunction(
     const std::string& functionName,
     const std::vector<TypePtr>& argTypes) {
-  if (auto vectorFunctionSignatures =
-          exec::getVectorFunctionSignatures(functionName)) {
-    for (const auto& signature : vectorFunctionSignatures.value()) {
-      exec::SignatureBinder binder(*signature, argTypes);
-      if (binder.tryBind()) {
-        return binder.tryResolveReturnType();
-      }
-    }
-  }
+  return resolveVectorFunctionCached(sanitizeName(functionName), argTypes)
+      .returnType;
+}
 
-  return nullptr;
+std::shared_ptr<const VectorFunctionFactory> resolveVectorFunctionFactory(
+    const std::string& name,
+    const std::vector<TypePtr>& argTypes) {
+  auto resolution = resolveVectorFunctionCached(sanitizeName(name), argTypes);
+  return resolution.returnType != nullptr ? resolution.factory : nullptr;
+}
+
+void clearVectorFunctionResolutions() {
+  advanceFunctionRegistryVersion();
+  vectorFunctionResolutions().clear();
 }
 
 std::shared_ptr<VectorFunction> getVectorFunction(
@@ -64,6 +106,11 @@ std::shared_ptr<VectorFunction> getVectorFunction(
     VELOX_CHECK_EQ(inputTypes.size(), constantInputs.size());
   }
 
+  auto resolution = resolveVectorFunctionCached(sanitizedName, inputTypes);
+  if (resolution.returnType == nullptr) {
+    return nullptr;
+  }
+
   // Zip `inputTypes` and `constantInputs` vectors into a single vector of
   // `VectorFunctionArg`.
   std::vector<VectorFunctionArg> inputArgs;
@@ -76,15 +123,7 @@ std::shared_ptr<VectorFunction> getVectorFunction(
     });
   }
 
-  return vectorFunctionFactories().withRLock(
-      [&sanitizedName, &inputArgs, &inputTypes](
-          auto& functionMap) -> std::shared_ptr<VectorFunction> {
-        if (resolveVectorFunction(sanitizedName, inputTypes)) {
-          auto functionIterator = functionMap.find(sanitizedName);
-          return functionIterator->second.factory(sanitizedName, inputArgs);
-        }
-        return nullptr;
-      });
+  return (*resolution.factory)(sanitizedName, inputArgs);
 }
 
 /// Registers a new vector function. When overwrite = true, previous functions
@@ -104,15 +143,20 @@ bool registerStatefulVectorFunction(
       functionMap[sanitizedName] = {
           std::move(signatures), std::move(factory), std::move(metadata)};
     });
+    clearVectorFunctionResolutions();
     return true;
   }
 
-  return vectorFunctionFactories().withWLock([&](auto& functionMap) {
+  auto inserted = vectorFunctionFactories().withWLock([&](auto& functionMap) {
     auto [iterator, inserted] = functionMap.insert(
         {sanitizedName,
          {std::move(signatures), std::move(factory), std::move(metadata)}});
     return inserted;
   });
+  if (inserted) {
+    clearVectorFunctionResolutions();
+  }
+  return inserted;
 }
 
 // Returns true iff an insertion actually happened
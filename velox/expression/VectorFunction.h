@@ -233,6 +233,20 @@ using VectorFunctionMap =
 
 VectorFunctionMap& vectorFunctionFactories();
 
+/// Returns the factory of the vector function 'name' if one of its signatures
+/// binds to 'argTypes', nullptr otherwise. Like getVectorFunction() without
+/// making the function. The results of this, resolveVectorFunction() and
+/// getVectorFunction() are cached by name and argument types, so that the
+/// signatures are bound once per distinct call and the lookups do not lock.
+std::shared_ptr<const VectorFunctionFactory> resolveVectorFunctionFactory(
+    const std::string& name,
+    const std::vector<TypePtr>& argTypes);
+
+/// Drops the cached resolutions of calls to vector functions. The
+/// registration functions do this. Must be called after modifying
+/// vectorFunctionFactories() directly.
+void clearVectorFunctionResolutions();
+
 // A template to simplify making VectorFunctionFactory for a function that has a
 // constructor that takes inputTypes and constantInputs
 //
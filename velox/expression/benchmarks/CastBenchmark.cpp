@@ -28,20 +28,49 @@ class CastBenchmark : public functions::test::FunctionBenchmarkBase {
   CastBenchmark() : FunctionBenchmarkBase() {}
 
   size_t doRun(const TypePtr& inputType, const TypePtr& outputType) {
+    folly::BenchmarkSuspender suspender;
+    facebook::velox::VectorFuzzer fuzzer({}, pool());
+    // With encodings, evalMemo can get invoked which does a copy and adds a lot
+    // of overhead.
+    auto input = fuzzer.fuzzFlatNotNull(inputType);
+    suspender.dismiss();
+
+    return doRun(input, outputType);
+  }
+
+  // Casts 1000 strings made by 'makeString' from the row number.
+  template <typename MakeString>
+  size_t doRunStrings(
+      const TypePtr& outputType,
+      MakeString makeString,
+      bool dictionary = false) {
+    folly::BenchmarkSuspender suspender;
+    VectorPtr input = vectorMaker_.flatVector<StringView>(
+        1'000, [&](auto row) { return StringView(makeString(row)); });
+    if (dictionary) {
+      // 10 distinct strings, each 100 times.
+      auto indices = AlignedBuffer::allocate<vector_size_t>(10'000, pool());
+      auto* rawIndices = indices->asMutable<vector_size_t>();
+      for (auto i = 0; i < 10'000; ++i) {
+        rawIndices[i] = i % 10;
+      }
+      input = BaseVector::wrapInDictionary(nullptr, indices, 10'000, input);
+    }
+    suspender.dismiss();
+
+    return doRun(input, outputType);
+  }
+
+  size_t doRun(const VectorPtr& input, const TypePtr& outputType) {
     folly::BenchmarkSuspender suspender;
     std::string colName = "c0";
     std::vector<facebook::velox::core::TypedExprPtr> inputs{
         std::make_shared<facebook::velox::core::FieldAccessTypedExpr>(
-            inputType, colName)};
+            input->type(), colName)};
     std::vector<facebook::velox::core::TypedExprPtr> expr{
         std::make_shared<facebook::velox::core::CastTypedExpr>(
             outputType, inputs, false)};
     exec::ExprSet exprSet(expr, &execCtx_);
-
-    facebook::velox::VectorFuzzer fuzzer({}, pool());
-    // With encodings, evalMemo can get invoked which does a copy and adds a lot
-    // of overhead.
-    auto input = fuzzer.fuzzFlatNotNull(inputType);
     auto rowVector = vectorMaker_.rowVector({colName}, {input});
     suspender.dismiss();
 
@@ -69,6 +98,63 @@ BENCHMARK_MULTI(scalar) {
   return benchmark.doRun(INTEGER(), BIGINT());
 }
 
+BENCHMARK_MULTI(castVarcharToBigint) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(BIGINT(), [](auto row) {
+    return fmt::format("{}", row * 7'919 - 1'000'000);
+  });
+}
+
+BENCHMARK_MULTI(castVarcharDictionaryToBigint) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(
+      BIGINT(), [](auto row) { return fmt::format("{}", row * 7'919); }, true);
+}
+
+BENCHMARK_MULTI(castVarcharToDouble) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(DOUBLE(), [](auto row) {
+    return fmt::format("{}.{}", row * 13, row % 100);
+  });
+}
+
+BENCHMARK_MULTI(castVarcharToDate) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(DATE(), [](auto row) {
+    return fmt::format(
+        "20{:02}-{:02}-{:02}", row % 100, row % 12 + 1, row % 28 + 1);
+  });
+}
+
+BENCHMARK_MULTI(castVarcharToTimestamp) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(TIMESTAMP(), [](auto row) {
+    return fmt::format(
+        "2020-{:02}-{:02} {:02}:{:02}:{:02}.{:03}",
+        row % 12 + 1,
+        row % 28 + 1,
+        row % 24,
+        row % 60,
+        row % 59,
+        row % 1'000);
+  });
+}
+
 BENCHMARK_MULTI(renameSmallStruct) {
   folly::BenchmarkSuspender suspender;
   CastBenchmark benchmark;
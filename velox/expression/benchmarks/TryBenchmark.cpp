@@ -27,10 +27,10 @@
 // it with no Try expression, a single Try expression around the entire sum,
 // and a Try around each individual addition. No exceptions are thrown or
 // caught in these benchmarks.
-// 2) Benchmark the performance impact of throwing exceptions and catching them
-// using Try.
-// It divides two integers, using division by 0 to trigger an exception getting
-// thrown.
+// 2) Benchmark the performance impact of errors handled by Try.
+// It divides two integers, using division by 0 to trigger an error. Integer
+// division reports errors with a Status, so no exception is thrown. It also
+// casts strings that are not numbers to integers.
 // These benchmarks show that meerly adding a Try expression does not
 // significantly impact performance, and the performance cost of handling
 // exceptions scales linearly with the number of rows that saw exceptions.
@@ -144,6 +144,19 @@ class TryBenchmark : public functions::test::FunctionBenchmarkBase {
     return doRun(exprSet, rowVector);
   }
 
+  size_t runCastWithAllErrors() {
+    folly::BenchmarkSuspender suspender;
+    auto strings = vectorMaker_.flatVector<StringView>(
+        1'000, [](auto /*row*/) { return StringView("not a number"); });
+    auto rowVector = vectorMaker_.rowVector({strings});
+
+    auto exprSet =
+        compileExpression("TRY(cast(c0 as integer))", rowVector->type());
+    suspender.dismiss();
+
+    return doRun(exprSet, rowVector);
+  }
+
   size_t doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -182,6 +195,11 @@ BENCHMARK_MULTI(divideAllExceptions) {
   TryBenchmark benchmark;
   return benchmark.runDivisionWithAllExceptions();
 }
+
+BENCHMARK_MULTI(castAllErrors) {
+  TryBenchmark benchmark;
+  return benchmark.runCastWithAllErrors();
+}
 } // namespace
 
 int main(int argc, char** argv) {
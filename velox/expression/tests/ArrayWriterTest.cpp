@@ -871,5 +871,78 @@ TEST_F(ArrayWriterTest, appendToElements) {
   ASSERT_EQ(arrayElements->size(), 6);
   ASSERT_EQ(arrayElements->asFlatVector<int32_t>()->valueAt(3), 4);
 }
+TEST_F(ArrayWriterTest, addItemsContiguous) {
+  using out_t = Array<int64_t>;
+
+  auto result = prepareResult(CppToType<out_t>::create(), 3);
+  // Add null elements so that the elements vector has a nulls buffer. The
+  // positions appended by the writer then start out null and the bulk copy
+  // must clear them.
+  auto elements = result->as<ArrayVector>()->elements();
+  elements->resize(8);
+  for (auto i = 0; i < 8; ++i) {
+    elements->setNull(i, true);
+  }
+
+  exec::VectorWriter<out_t> vectorWriter;
+  vectorWriter.init(*result->as<ArrayVector>());
+
+  vectorWriter.setOffset(0);
+  vectorWriter.current().add_items(std::vector<int64_t>{1, 2, 3});
+  vectorWriter.commit();
+
+  vectorWriter.setOffset(1);
+  vectorWriter.current().add_items(std::vector<int64_t>{});
+  vectorWriter.commit();
+
+  vectorWriter.setOffset(2);
+  auto& arrayWriter = vectorWriter.current();
+  arrayWriter.add_null();
+  arrayWriter.add_items(std::vector<int64_t>{4, 5});
+  vectorWriter.commit();
+  vectorWriter.finish();
+
+  assertEqualVectors(
+      result,
+      makeNullableArrayVector<int64_t>({{1, 2, 3}, {}, {std::nullopt, 4, 5}}));
+}
+
+TEST_F(ArrayWriterTest, addItemNoCopy) {
+  using out_t = Array<Varchar>;
+
+  auto result = prepareResult(CppToType<out_t>::create(), 2);
+
+  // Strings that are not inlined in StringView.
+  const std::string a = "a string longer than twelve bytes";
+  const std::string b = "another string longer than twelve bytes";
+
+  exec::VectorWriter<out_t> vectorWriter;
+  vectorWriter.init(*result->as<ArrayVector>());
+
+  vectorWriter.setOffset(0);
+  auto& arrayWriter = vectorWriter.current();
+  arrayWriter.add_item_no_copy(StringView(a));
+  arrayWriter.add_null();
+  arrayWriter.add_item_no_copy(StringView("short"));
+  vectorWriter.commit();
+
+  vectorWriter.setOffset(1);
+  vectorWriter.current().add_item_no_copy(StringView(b));
+  vectorWriter.commit();
+  vectorWriter.finish();
+
+  auto elements =
+      result->as<ArrayVector>()->elements()->asFlatVector<StringView>();
+  // The long strings point to the original memory.
+  ASSERT_EQ(elements->valueAt(0).data(), a.data());
+  ASSERT_EQ(elements->valueAt(3).data(), b.data());
+
+  assertEqualVectors(
+      result,
+      makeNullableArrayVector<StringView>(
+          {{StringView(a), std::nullopt, StringView("short")},
+           {StringView(b)}}));
+}
+
 } // namespace
 } // namespace facebook::velox
@@ -555,6 +555,73 @@ TEST_F(CastExprTest, errorHandling) {
       "tinyint", {"1", "2", "3", "100", "-100.5"}, {1, 2, 3, 100, -100}, true);
 }
 
+// Strings in the common formats are cast without the general conversions.
+// The others, e.g. with more digits or an exponent, still use them.
+TEST_F(CastExprTest, stringFastPath) {
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"0",
+       "-17",
+       "123456789012345678",
+       "9223372036854775807",
+       "-9223372036854775808",
+       std::nullopt},
+      {0,
+       -17,
+       123456789012345678,
+       std::numeric_limits<int64_t>::max(),
+       std::numeric_limits<int64_t>::min(),
+       std::nullopt});
+  testCast<std::string, int32_t>(
+      "integer",
+      {"2147483647", "-2147483648", "123456789", "2147483648"},
+      {std::numeric_limits<int32_t>::max(),
+       std::numeric_limits<int32_t>::min(),
+       123456789,
+       std::nullopt},
+      false,
+      true);
+  testCast<std::string, double>(
+      "double",
+      {"1.5", "-0.25", "123456789012.345", "1e3", "12345678901234567"},
+      {1.5, -0.25, 123456789012.345, 1000, 12345678901234567.0});
+  testCast<std::string, Date>(
+      "date",
+      {"2020-02-29", "1969-12-31", "2020-02-30", "2020-01-01 10:00:00"},
+      {Date(18321), Date(-1), std::nullopt, Date(18262)},
+      false,
+      true);
+  testCast<std::string, Timestamp>(
+      "timestamp",
+      {"2000-01-01 12:21:56.123",
+       "2000-01-01T12:21:56",
+       "1970-01-01 00:00:00.000001",
+       "1970-01-01 00:00:00-02:00"},
+      {Timestamp(946729316, 123'000'000),
+       Timestamp(946729316, 0),
+       Timestamp(0, 1'000),
+       Timestamp(7200, 0)});
+
+  // Dictionary encoded input with nulls.
+  auto input = wrapInDictionary(
+      makeIndicesInReverse(1'000),
+      1'000,
+      makeFlatVector<StringView>(
+          1'000,
+          [](auto row) {
+            return StringView(
+                row % 10 == 0 ? fmt::format("{}e0", row)
+                              : fmt::format("{}", row));
+          },
+          nullEvery(7)));
+  auto expected = makeFlatVector<double>(
+      1'000,
+      [](auto row) { return 999 - row; },
+      [](auto row) { return (999 - row) % 7 == 0; });
+  assertEqualVectors(
+      expected, evaluate("cast(c0 as double)", makeRowVector({input})));
+}
+
 TEST_F(CastExprTest, allowDecimal) {
   // Allow decimal.
   setCastIntAllowDecimalAndByTruncate(true);
@@ -221,3 +221,42 @@ TEST_F(EvalCtxTest, localSingleRow) {
     }
   }
 }
+
+TEST_F(EvalCtxTest, decodeNestedDictionary) {
+  EvalCtx context(&execCtx_);
+  const vector_size_t size = 100;
+  auto base = makeFlatVector<int64_t>(size, [](auto row) { return row; });
+  auto dictionary = wrapInDictionary(makeIndicesInReverse(size), size, base);
+  auto nested = wrapInDictionary(
+      makeIndices(size, [](auto row) { return (row * 7) % size; }),
+      size,
+      dictionary);
+
+  SelectivityVector rows(size);
+  // Flat vectors and single dictionaries are not cached.
+  ASSERT_EQ(context.decodeNestedDictionary(base, rows), nullptr);
+  ASSERT_EQ(context.decodeNestedDictionary(dictionary, rows), nullptr);
+
+  auto* decoded = context.decodeNestedDictionary(nested, rows);
+  ASSERT_NE(decoded, nullptr);
+  for (auto i = 0; i < size; ++i) {
+    ASSERT_EQ(decoded->valueAt<int64_t>(i), size - 1 - (i * 7) % size);
+  }
+
+  // A subset of the rows reuses the decoded vector.
+  SelectivityVector oddRows(size);
+  for (auto i = 0; i < size; i += 2) {
+    oddRows.setValid(i, false);
+  }
+  oddRows.updateBounds();
+  ASSERT_EQ(context.decodeNestedDictionary(nested, oddRows), decoded);
+
+  // A superset of the rows is decoded again.
+  EvalCtx otherContext(&execCtx_);
+  auto* oddDecoded = otherContext.decodeNestedDictionary(nested, oddRows);
+  auto* allDecoded = otherContext.decodeNestedDictionary(nested, rows);
+  ASSERT_NE(oddDecoded, allDecoded);
+  for (auto i = 1; i < size; i += 2) {
+    ASSERT_EQ(oddDecoded->valueAt<int64_t>(i), allDecoded->valueAt<int64_t>(i));
+  }
+}
@@ -16,6 +16,7 @@
 #include "gtest/gtest.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/FunctionResolutionCache.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/functions/prestosql/types/JsonType.h"
 #include "velox/parse/TypeResolver.h"
@@ -224,4 +225,44 @@ TEST_F(ExprCompilerTest, customTypeConstant) {
   ASSERT_EQ("[1, 2, 3]:JSON", compile(expression)->toString());
 }
 
+TEST_F(ExprCompilerTest, functionResolutionCache) {
+  auto rowType =
+      ROW({"a", "b", "c", "d"}, {BIGINT(), BIGINT(), VARCHAR(), VARCHAR()});
+  auto field = makeField(rowType);
+
+  // A simple function and a vector function.
+  auto plus = call("plus", {field("a"), field("b")});
+  auto concat = concatCall({field("c"), field("d")});
+  const auto expected = "plus(a, b)\nconcat(c, d)";
+  auto compileBoth = [&](core::ExecCtx* execCtx) {
+    return std::make_unique<ExprSet>(
+        std::vector<core::TypedExprPtr>{plus, concat}, execCtx);
+  };
+
+  auto& cache = FunctionResolutionCache::get(*queryCtx_);
+  ASSERT_EQ(expected, compileBoth(execCtx_.get())->toString());
+  EXPECT_EQ(cache.stats().numLookups, 2);
+  EXPECT_EQ(cache.stats().numHits, 0);
+
+  // The ExprSets of the other drivers of the query reuse the resolutions.
+  for (auto i = 0; i < 3; ++i) {
+    core::ExecCtx execCtx(pool_.get(), queryCtx_.get());
+    ASSERT_EQ(expected, compileBoth(&execCtx)->toString());
+  }
+  EXPECT_EQ(cache.stats().numLookups, 8);
+  EXPECT_EQ(cache.stats().numHits, 6);
+
+  // Another query has its own cache.
+  auto otherQueryCtx = std::make_shared<core::QueryCtx>();
+  core::ExecCtx otherExecCtx(pool_.get(), otherQueryCtx.get());
+  ASSERT_EQ(expected, compileBoth(&otherExecCtx)->toString());
+  EXPECT_EQ(FunctionResolutionCache::get(*otherQueryCtx).stats().numHits, 0);
+
+  // Registering functions drops the resolutions.
+  functions::prestosql::registerAllScalarFunctions();
+  ASSERT_EQ(expected, compileBoth(execCtx_.get())->toString());
+  EXPECT_EQ(cache.stats().numLookups, 10);
+  EXPECT_EQ(cache.stats().numHits, 6);
+}
+
 } // namespace facebook::velox::exec::test
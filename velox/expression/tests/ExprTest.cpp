@@ -384,6 +384,35 @@ TEST_F(ExprTest, reorder) {
   }
 }
 
+TEST_F(ExprTest, reorderUnevaluatedInputs) {
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  auto exprSet = compileExpression(
+      "if (c0 < 0 and c0 % 7 = 0, 1, 2)", asRowType(data->type()));
+
+  // The first input decides all rows. The second is never evaluated and must
+  // not be moved before the first on the next batches.
+  for (auto i = 0; i < 3; ++i) {
+    evaluate(exprSet.get(), data);
+  }
+  auto condition = std::dynamic_pointer_cast<exec::ConjunctExpr>(
+      exprSet->expr(0)->inputs()[0]);
+  ASSERT_TRUE(condition != nullptr);
+  EXPECT_EQ(3'000, condition->selectivityAt(0).numIn());
+  EXPECT_EQ(0, condition->selectivityAt(0).numOut());
+  EXPECT_EQ(0, condition->selectivityAt(1).numIn());
+  EXPECT_EQ(3'000, condition->stats().numShortCircuitedRows);
+
+  // With c0 % 2 = 1 first, c0 % 3 = 0 sees half of the rows.
+  exprSet = compileExpression(
+      "if (c0 % 2 = 1 or c0 % 3 = 0, 1, 2)", asRowType(data->type()));
+  evaluate(exprSet.get(), data);
+  condition = std::dynamic_pointer_cast<exec::ConjunctExpr>(
+      exprSet->expr(0)->inputs()[0]);
+  ASSERT_TRUE(condition != nullptr);
+  EXPECT_EQ(500, condition->stats().numShortCircuitedRows);
+}
+
 TEST_F(ExprTest, constant) {
   auto exprSet = compileExpression("1 + 2 + 3 + 4", ROW({}));
   auto constExpr = dynamic_cast<exec::ConstantExpr*>(exprSet->expr(0).get());
@@ -1966,6 +1995,40 @@ TEST_F(ExprTest, memo) {
   assertEqualVectors(expectedResult, result);
 }
 
+TEST_F(ExprTest, memoInterleavedBases) {
+  auto makeBase = [&](int32_t offset) {
+    return makeArrayVector<int64_t>(
+        1'000,
+        [](auto row) { return row % 5 + 1; },
+        [offset](auto row, auto index) { return (row + offset) % 3 + index; });
+  };
+  auto firstBase = makeBase(0);
+  auto secondBase = makeBase(1);
+  auto indices = makeIndices(100, [](auto row) { return row * 3; });
+
+  auto rowType = ROW({"c0"}, {firstBase->type()});
+  auto exprSet = compileExpression("c0[1] = 1", rowType);
+
+  // Batches alternate between dictionaries over two bases. Each base is
+  // evaluated once and the repeats are served from the memo.
+  for (auto i = 0; i < 4; ++i) {
+    const auto offset = i % 2;
+    auto result = evaluate(
+        exprSet.get(),
+        makeRowVector({wrapInDictionary(
+            indices, 100, offset == 0 ? firstBase : secondBase)}));
+    auto expectedResult = makeFlatVector<bool>(100, [offset](auto row) {
+      return (row * 3 + offset) % 3 == 1;
+    });
+    assertEqualVectors(expectedResult, result);
+  }
+
+  auto stats = exprSet->stats();
+  EXPECT_EQ(2, stats.at("eq").numMemoHits);
+  EXPECT_EQ(2, stats.at("eq").numMemoMisses);
+  EXPECT_EQ(200, stats.at("eq").numProcessedRows);
+}
+
 // This test triggers the situation when peelEncodings() produces an empty
 // selectivity vector, which if passed to evalWithMemo() causes the latter to
 // produce null Expr::dictionaryCache_, which leads to a crash in evaluation
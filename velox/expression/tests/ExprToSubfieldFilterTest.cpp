@@ -216,6 +216,52 @@ TEST_F(ExprToSubfieldFilterTest, nonConstant) {
   ASSERT_FALSE(filter);
 }
 
+TEST_F(ExprToSubfieldFilterTest, mightContain) {
+  constexpr int32_t kSize = 100;
+  BloomFilter bloomFilter;
+  bloomFilter.reset(kSize);
+  for (auto i = 0; i < kSize; ++i) {
+    bloomFilter.insert(folly::hasher<int64_t>()(i));
+  }
+  std::string serialized;
+  serialized.resize(bloomFilter.serializedSize());
+  bloomFilter.serialize(serialized.data());
+
+  // Not parsed because the DuckDB parser cannot parse the Bloom filter.
+  auto makeCall = [](const variant& bloomFilter) {
+    return std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<core::TypedExprPtr>{
+            std::make_shared<core::ConstantTypedExpr>(VARBINARY(), bloomFilter),
+            std::make_shared<core::FieldAccessTypedExpr>(BIGINT(), "a")},
+        "might_contain");
+  };
+
+  Subfield subfield;
+  auto filter = leafCallToSubfieldFilter(
+      *makeCall(variant::binary(serialized)), subfield);
+  ASSERT_TRUE(filter);
+  validateSubfield(subfield, {"a"});
+  ASSERT_TRUE(dynamic_cast<BigintValuesUsingBloomFilter*>(filter.get()));
+  ASSERT_FALSE(filter->testNull());
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < kSize; ++i) {
+    ASSERT_TRUE(filter->testInt64(i));
+    numFalsePositives += filter->testInt64(i + kSize);
+  }
+  ASSERT_LT(numFalsePositives, kSize / 10);
+
+  filter = leafCallToSubfieldFilter(
+      *makeCall(variant::null(TypeKind::VARBINARY)), subfield);
+  ASSERT_TRUE(filter);
+  ASSERT_EQ(filter->kind(), FilterKind::kAlwaysFalse);
+
+  // A Bloom filter cannot be negated.
+  filter = leafCallToSubfieldFilter(
+      *makeCall(variant::binary(serialized)), subfield, true);
+  ASSERT_FALSE(filter);
+}
+
 TEST_F(ExprToSubfieldFilterTest, userError) {
   auto call = parseCallExpr("a = 1 / 0", ROW({{"a", BIGINT()}}));
   Subfield subfield;
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/functions/Udf.h"
+#include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+
+namespace facebook::velox {
+namespace {
+
+using namespace facebook::velox::test;
+
+class SimpleFunctionCallBatchTest : public functions::test::FunctionBaseTest {
+ protected:
+  void SetUp() override {
+    FunctionBaseTest::SetUp();
+    numBatchCalls = 0;
+  }
+
+ public:
+  static inline int32_t numBatchCalls = 0;
+};
+
+template <typename T>
+struct BatchPlusFunction {
+  void call(int64_t& out, const int64_t& a, const int64_t& b) {
+    out = a + b;
+  }
+
+  void
+  callBatch(int64_t* out, const int64_t* a, const int64_t* b, int32_t size) {
+    ++SimpleFunctionCallBatchTest::numBatchCalls;
+    for (auto i = 0; i < size; ++i) {
+      out[i] = a[i] + b[i];
+    }
+  }
+};
+
+// callBatch() is not used for functions that may return null.
+template <typename T>
+struct BatchNullableFunction {
+  bool call(int64_t& out, const int64_t& a) {
+    out = a;
+    return a % 2 == 0;
+  }
+
+  void callBatch(int64_t* /*out*/, const int64_t* /*a*/, int32_t /*size*/) {
+    VELOX_UNREACHABLE();
+  }
+};
+
+TEST_F(SimpleFunctionCallBatchTest, flat) {
+  registerFunction<BatchPlusFunction, int64_t, int64_t, int64_t>(
+      {"batch_plus"});
+
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          1'000, [](auto row) { return row * 2; }, nullEvery(5)),
+  });
+  auto expected = makeFlatVector<int64_t>(
+      1'000, [](auto row) { return row * 3; }, nullEvery(5));
+
+  assertEqualVectors(expected, evaluate("batch_plus(c0, c1)", data));
+  EXPECT_EQ(1, numBatchCalls);
+
+  assertEqualVectors(expected, evaluate("batch_plus(c0, c1 * 1)", data));
+  EXPECT_EQ(2, numBatchCalls);
+
+  // Only even rows are selected.
+  expected = makeFlatVector<int64_t>(
+      1'000,
+      [](auto row) { return row % 2 == 0 ? row * 3 : 0; },
+      [](auto row) { return row % 2 == 0 && row % 5 == 0; });
+  assertEqualVectors(
+      expected,
+      evaluate("if(c0 % 2 = 0, batch_plus(c0, c1), cast(0 as bigint))", data));
+  EXPECT_EQ(3, numBatchCalls);
+}
+
+TEST_F(SimpleFunctionCallBatchTest, notFlat) {
+  registerFunction<BatchPlusFunction, int64_t, int64_t, int64_t>(
+      {"batch_plus"});
+
+  auto flat = makeFlatVector<int64_t>(100, [](auto row) { return row; });
+  auto data = makeRowVector({
+      flat,
+      wrapInDictionary(makeIndicesInReverse(100), 100, flat),
+  });
+
+  // Dictionary and constant arguments use call().
+  assertEqualVectors(
+      makeFlatVector<int64_t>(100, [](auto /*row*/) { return 99; }),
+      evaluate("batch_plus(c0, c1)", data));
+  assertEqualVectors(
+      makeFlatVector<int64_t>(100, [](auto row) { return row + 1; }),
+      evaluate("batch_plus(c0, cast(1 as bigint))", data));
+  EXPECT_EQ(0, numBatchCalls);
+}
+
+TEST_F(SimpleFunctionCallBatchTest, nullableOutput) {
+  registerFunction<BatchNullableFunction, int64_t, int64_t>(
+      {"batch_nullable"});
+
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(100, [](auto row) { return row; })});
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          100, [](auto row) { return row; }, [](auto row) { return row % 2; }),
+      evaluate("batch_nullable(c0)", data));
+}
+
+} // namespace
+} // namespace facebook::velox
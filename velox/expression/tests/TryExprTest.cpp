@@ -75,6 +75,54 @@ TEST_F(TryExprTest, skipExecution) {
   assertEqualVectors(makeNullableFlatVector(expected), result);
 }
 
+// Doubles its input. Reports an error for negative inputs with a Status
+// instead of throwing.
+template <typename T>
+struct DoubleNonNegativeFunction {
+  Status call(int64_t& out, const int64_t& in) {
+    if (in < 0) {
+      return Status::UserError(fmt::format("Negative input: {}", in));
+    }
+    out = in * 2;
+    return Status::OK();
+  }
+};
+
+TEST_F(TryExprTest, statusErrors) {
+  registerFunction<DoubleNonNegativeFunction, int64_t, int64_t>(
+      {"double_non_negative"});
+
+  auto data = makeRowVector({makeNullableFlatVector<int64_t>(
+      {1, -2, 3, std::nullopt, -5, 6})});
+  auto result = evaluate("try(double_non_negative(c0))", data);
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>(
+          {2, std::nullopt, 6, std::nullopt, std::nullopt, 12}),
+      result);
+
+  // The rows that fail are skipped by the expressions above the failing one.
+  result = evaluate("try(double_non_negative(c0) + 1)", data);
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>(
+          {3, std::nullopt, 7, std::nullopt, std::nullopt, 13}),
+      result);
+
+  // Outside of TRY the error is thrown.
+  VELOX_ASSERT_THROW(
+      evaluate("double_non_negative(c0)", data), "Negative input: -2");
+
+  // Integer division reports division by zero with a Status.
+  data = makeRowVector({
+      makeFlatVector<int32_t>({10, 20, 30}),
+      makeFlatVector<int32_t>({0, 5, 0}),
+  });
+  result = evaluate("try(c0 / c1)", data);
+  assertEqualVectors(
+      makeNullableFlatVector<int32_t>({std::nullopt, 4, std::nullopt}),
+      result);
+  VELOX_ASSERT_THROW(evaluate("c0 / c1", data), "division by zero");
+}
+
 TEST_F(TryExprTest, nestedTryChildErrors) {
   // This tests that with nested TRY expressions, the parent TRY does not see
   // errors the child TRY already handled.
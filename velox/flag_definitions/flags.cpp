@@ -72,6 +72,14 @@ DEFINE_bool(avx2, true, "Enables use of AVX2 when available");
 
 DEFINE_bool(bmi2, true, "Enables use of BMI2 when available");
 
+// Used in exec/HashTable.cpp
+
+DEFINE_bool(
+    velox_hash_table_batched_probe,
+    true,
+    "If true, hash join tables in kHash and kNormalizedKey modes are probed in "
+    "batches of 16 rows whose tag words are prefetched before any is compared");
+
 // Used in exec/Expr.cpp
 
 DEFINE_string(
@@ -81,6 +81,7 @@ void clearFunctionRegistry() {
   exec::SimpleFunctions().clearRegistry();
   exec::vectorFunctionFactories().withWLock(
       [](auto& functionMap) { functionMap.clear(); });
+  exec::clearVectorFunctionResolutions();
 }
 
 std::shared_ptr<const Type> resolveFunction(
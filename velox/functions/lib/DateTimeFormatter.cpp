@@ -19,6 +19,7 @@
 #include <velox/common/base/Exceptions.h>
 #include <velox/type/Date.h>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
 #include "velox/external/date/date.h"
 #include "velox/external/date/tz.h"
@@ -949,9 +950,216 @@ void parseFromPattern(
 
 } // namespace
 
+void DateTimeFormatter::initializeFixedWidth() {
+  std::vector<FixedWidthField> fields;
+  std::vector<FixedWidthLiteral> literals;
+  std::string fixedWidthTemplate;
+  bool hasYear = false;
+  bool hasMonth = false;
+  bool hasDay = false;
+  bool hasHour = false;
+  bool hasMinute = false;
+  bool hasSecond = false;
+
+  // Sets 'seen' and returns true if the field has not been seen before.
+  auto addOnce = [](bool& seen) {
+    if (seen) {
+      return false;
+    }
+    seen = true;
+    return true;
+  };
+
+  for (const auto& token : tokens_) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      // Digits in literals could be consumed by the variable width year.
+      for (auto c : token.literal) {
+        if (characterIsDigit(c)) {
+          return;
+        }
+      }
+      literals.push_back(
+          {static_cast<uint8_t>(fixedWidthTemplate.size()), token.literal});
+      fixedWidthTemplate += token.literal;
+    } else {
+      const auto& pattern = token.pattern;
+      bool fixed = false;
+      switch (pattern.specifier) {
+        case DateTimeFormatSpecifier::YEAR:
+        case DateTimeFormatSpecifier::YEAR_OF_ERA:
+          fixed = pattern.minRepresentDigits == 4 && addOnce(hasYear);
+          break;
+        case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+          fixed = pattern.minRepresentDigits == 2 && addOnce(hasMonth);
+          break;
+        case DateTimeFormatSpecifier::DAY_OF_MONTH:
+          fixed = pattern.minRepresentDigits == 2 && addOnce(hasDay);
+          break;
+        case DateTimeFormatSpecifier::HOUR_OF_DAY:
+          fixed = pattern.minRepresentDigits == 2 && addOnce(hasHour);
+          break;
+        case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+          fixed = pattern.minRepresentDigits == 2 && addOnce(hasMinute);
+          break;
+        case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+          fixed = pattern.minRepresentDigits == 2 && addOnce(hasSecond);
+          break;
+        default:
+          break;
+      }
+      if (!fixed) {
+        return;
+      }
+      fields.push_back(
+          {pattern.specifier,
+           static_cast<uint8_t>(fixedWidthTemplate.size()),
+           static_cast<uint8_t>(pattern.minRepresentDigits)});
+      fixedWidthTemplate.append(pattern.minRepresentDigits, '0');
+    }
+    if (fixedWidthTemplate.size() > std::numeric_limits<uint8_t>::max()) {
+      return;
+    }
+  }
+
+  // Without a year, month and day the general path applies Joda's defaults.
+  if (!hasYear || !hasMonth || !hasDay) {
+    return;
+  }
+  fixedWidthFields_ = std::move(fields);
+  fixedWidthLiterals_ = std::move(literals);
+  fixedWidthTemplate_ = std::move(fixedWidthTemplate);
+}
+
+bool DateTimeFormatter::tryParseFixedWidth(
+    const std::string_view& input,
+    DateTimeResult& result) const {
+  if (input.size() != fixedWidthTemplate_.size()) {
+    return false;
+  }
+  for (const auto& literal : fixedWidthLiterals_) {
+    if (std::memcmp(
+            input.data() + literal.offset,
+            literal.literal.data(),
+            literal.literal.size()) != 0) {
+      return false;
+    }
+  }
+
+  int32_t year = 0;
+  int32_t month = 0;
+  int32_t day = 0;
+  int32_t hour = 0;
+  int32_t minute = 0;
+  int32_t second = 0;
+  bool isYearOfEra = false;
+  bool allDigits = true;
+  for (const auto& field : fixedWidthFields_) {
+    int32_t value = 0;
+    for (auto i = 0; i < field.size; ++i) {
+      const uint8_t digit = input[field.offset + i] - '0';
+      allDigits &= digit <= 9;
+      value = value * 10 + digit;
+    }
+    switch (field.specifier) {
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        isYearOfEra = true;
+        FMT_FALLTHROUGH;
+      case DateTimeFormatSpecifier::YEAR:
+        year = value;
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+        month = value;
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+        day = value;
+        break;
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+        hour = value;
+        break;
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+        minute = value;
+        break;
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        second = value;
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+  if (!allDigits || (isYearOfEra && year == 0) || hour > 23 || minute > 59 ||
+      second > 59 || !util::isValidDate(year, month, day)) {
+    return false;
+  }
+
+  result.timestamp = util::fromDatetime(
+      util::daysSinceEpochFromDate(year, month, day),
+      util::fromTime(hour, minute, second, 0));
+  result.timezoneId = -1;
+  return true;
+}
+
+bool DateTimeFormatter::tryFormatFixedWidth(
+    const Timestamp& timestamp,
+    std::string& result) const {
+  // 0001-01-01 00:00:00 and 9999-12-31 23:59:59.
+  constexpr int64_t kMinSeconds = -62'135'596'800;
+  constexpr int64_t kMaxSeconds = 253'402'300'799;
+  const auto seconds = timestamp.getSeconds();
+  if (seconds < kMinSeconds || seconds > kMaxSeconds) {
+    return false;
+  }
+  auto days = seconds / util::kSecsPerDay;
+  auto secondsInDay = seconds % util::kSecsPerDay;
+  if (secondsInDay < 0) {
+    --days;
+    secondsInDay += util::kSecsPerDay;
+  }
+  const date::year_month_day calDate{date::sys_days{date::days(days)}};
+
+  result = fixedWidthTemplate_;
+  for (const auto& field : fixedWidthFields_) {
+    int32_t value;
+    switch (field.specifier) {
+      case DateTimeFormatSpecifier::YEAR:
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        value = static_cast<int>(calDate.year());
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+        value = static_cast<unsigned>(calDate.month());
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+        value = static_cast<unsigned>(calDate.day());
+        break;
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+        value = secondsInDay / 3'600;
+        break;
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+        value = secondsInDay / 60 % 60;
+        break;
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        value = secondsInDay % 60;
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+    for (auto i = field.size; i > 0; --i) {
+      result[field.offset + i - 1] = '0' + value % 10;
+      value /= 10;
+    }
+  }
+  return true;
+}
+
 std::string DateTimeFormatter::format(
     const Timestamp& timestamp,
     const date::time_zone* timezone) const {
+  if (!fixedWidthTemplate_.empty()) {
+    std::string result;
+    if (tryFormatFixedWidth(timestamp, result)) {
+      return result;
+    }
+  }
+
   const std::chrono::
       time_point<std::chrono::system_clock, std::chrono::milliseconds>
           timePoint(std::chrono::milliseconds(timestamp.toMillis()));
@@ -1130,6 +1338,13 @@ std::string DateTimeFormatter::format(
 }
 
 DateTimeResult DateTimeFormatter::parse(const std::string_view& input) const {
+  if (!fixedWidthTemplate_.empty()) {
+    DateTimeResult result;
+    if (tryParseFixedWidth(input, result)) {
+      return result;
+    }
+  }
+
   Date date;
   const char* cur = input.data();
   const char* end = cur + input.size();
@@ -159,7 +159,9 @@ class DateTimeFormatter {
       : literalBuf_(std::move(literalBuf)),
         bufSize_(bufSize),
         tokens_(std::move(tokens)),
-        type_(type) {}
+        type_(type) {
+    initializeFixedWidth();
+  }
 
   const std::unique_ptr<char[]>& literalBuf() const {
     return literalBuf_;
@@ -180,10 +182,48 @@ class DateTimeFormatter {
       const date::time_zone* timezone) const;
 
  private:
+  struct FixedWidthField {
+    DateTimeFormatSpecifier specifier;
+    uint8_t offset;
+    uint8_t size;
+  };
+
+  struct FixedWidthLiteral {
+    uint8_t offset;
+    std::string_view literal;
+  };
+
+  // Recognizes formats made of a 4 digit year, 2 digit month, day, hour,
+  // minute and second fields and literals without digits, e.g.
+  // 'yyyy-MM-dd HH:mm:ss'. All the values of such formats have the same
+  // width, so they are parsed and formatted at fixed offsets without
+  // interpreting 'tokens_'.
+  void initializeFixedWidth();
+
+  // Parses 'input' at the fixed offsets of a fixed width format. Returns
+  // false if 'input' does not match the format or has an out of range field.
+  // parse() then produces the result or the error of the general path.
+  bool tryParseFixedWidth(const std::string_view& input, DateTimeResult& result)
+      const;
+
+  // Formats 'timestamp' with a fixed width format. Returns false if the year
+  // is not in [1, 9999].
+  bool tryFormatFixedWidth(const Timestamp& timestamp, std::string& result)
+      const;
+
   std::unique_ptr<char[]> literalBuf_;
   size_t bufSize_;
   std::vector<DateTimeToken> tokens_;
   DateTimeFormatterType type_;
+
+  // The fields and literals of a fixed width format. Empty if the format is
+  // not fixed width.
+  std::vector<FixedWidthField> fixedWidthFields_;
+  std::vector<FixedWidthLiteral> fixedWidthLiterals_;
+
+  // The literals of a fixed width format at their offsets, with '0' at the
+  // offsets of the fields. Empty if the format is not fixed width.
+  std::string fixedWidthTemplate_;
 };
 
 std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
@@ -481,12 +481,18 @@ template <typename T, typename A, typename C>
 std::vector<std::pair<T, uint64_t>> KllSketch<T, A, C>::getFrequencies() const {
   VELOX_USER_CHECK(
       isLevelZeroSorted_, "finish() must be called before estimate quantiles");
+  return toView().getFrequencies();
+}
+
+template <typename T, typename A, typename C>
+std::vector<std::pair<T, uint64_t>> KllSketch<T, A, C>::View::getFrequencies()
+    const {
   std::vector<std::pair<T, uint64_t>> entries;
-  entries.reserve(levels_.back());
+  entries.reserve(levels.back());
   for (int level = 0; level < numLevels(); ++level) {
     auto oldLen = entries.size();
-    for (int i = levels_[level]; i < levels_[level + 1]; ++i) {
-      entries.emplace_back(items_[i], 1ll << level);
+    for (int i = levels[level]; i < levels[level + 1]; ++i) {
+      entries.emplace_back(items[i], 1ll << level);
     }
     if (oldLen > 0) {
       std::inplace_merge(
@@ -496,17 +502,17 @@ std::vector<std::pair<T, uint64_t>> KllSketch<T, A, C>::getFrequencies() const {
           [](auto& x, auto& y) { return C()(x.first, y.first); });
     }
   }
-  int k = 0;
+  int numEntries = 0;
   for (int i = 0; i < entries.size();) {
-    entries[k] = entries[i];
+    entries[numEntries] = entries[i];
     int j = i + 1;
     while (j < entries.size() && entries[j].first == entries[i].first) {
-      entries[k].second += entries[j++].second;
+      entries[numEntries].second += entries[j++].second;
     }
-    ++k;
+    ++numEntries;
     i = j;
   }
-  entries.resize(k);
+  entries.resize(numEntries);
   return entries;
 }
 
@@ -532,6 +538,17 @@ void KllSketch<T, A, C>::estimateQuantiles(
     const folly::Range<Iter>& fractions,
     T* out) const {
   VELOX_USER_CHECK_GT(n_, 0, "estimateQuantiles called on empty sketch");
+  VELOX_USER_CHECK(
+      isLevelZeroSorted_, "finish() must be called before estimate quantiles");
+  toView().estimateQuantiles(fractions, out);
+}
+
+template <typename T, typename A, typename C>
+template <typename Iter>
+void KllSketch<T, A, C>::View::estimateQuantiles(
+    const folly::Range<Iter>& fractions,
+    T* out) const {
+  VELOX_USER_CHECK_GT(n, 0, "estimateQuantiles called on empty sketch");
   auto entries = getFrequencies();
   uint64_t totalWeight = 0;
   for (auto& [_, w] : entries) {
@@ -543,11 +560,11 @@ void KllSketch<T, A, C>::estimateQuantiles(
     VELOX_CHECK_GE(q, 0.0);
     VELOX_CHECK_LE(q, 1.0);
     if (fractions[i] == 0.0) {
-      out[i++] = minValue_;
+      out[i++] = minValue;
       continue;
     }
     if (fractions[i] == 1.0) {
-      out[i++] = maxValue_;
+      out[i++] = maxValue;
       continue;
     }
     uint64_t maxWeight = q * totalWeight;
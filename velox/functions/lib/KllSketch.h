@@ -158,6 +158,18 @@ struct KllSketch {
     }
 
     void deserialize(const char* FOLLY_NONNULL);
+
+    /// Same as KllSketch::getFrequencies().  The items of level 0 must be
+    /// sorted.
+    std::vector<std::pair<T, uint64_t>> getFrequencies() const;
+
+    /// Same as KllSketch::estimateQuantiles().  The items of level 0 must be
+    /// sorted.  This allows estimating from items that are not in a sketch,
+    /// e.g. a small number of exact values.
+    template <typename Iter>
+    void estimateQuantiles(
+        const folly::Range<Iter>& quantiles,
+        T* FOLLY_NONNULL out) const;
   };
 
   /// Internal API, do not use outside Velox.
@@ -16,9 +16,11 @@
 #include "velox/functions/lib/Re2Functions.h"
 
 #include <re2/re2.h>
+#include <cstring>
 #include <optional>
 #include <string>
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorWriters.h"
 
 namespace facebook::velox::functions {
@@ -89,6 +91,12 @@ bool re2PartialMatch(StringView str, const RE2& re) {
   return RE2::PartialMatch(toStringPiece(str), re);
 }
 
+bool matchSubstring(StringView input, const std::string& substring) {
+  return simd::findSubstring(
+             input.data(), input.size(), substring.data(), substring.size()) !=
+      std::string_view::npos;
+}
+
 bool re2Extract(
     FlatVector<StringView>& result,
     int row,
@@ -181,7 +189,25 @@ template <bool (*Fn)(StringView, const RE2&)>
 class Re2MatchConstantPattern final : public VectorFunction {
  public:
   explicit Re2MatchConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(toStringPiece(pattern), RE2::Quiet),
+        requiredLiteral_(requiredLiteral(std::string_view(pattern))),
+        isLiteral_(requiredLiteral_.size() == pattern.size()) {}
+
+  // Checks for 'requiredLiteral_' with simd::findSubstring before running the
+  // regex, so that most non-matching rows never enter RE2. Patterns that are
+  // literals are matched without RE2.
+  bool match(StringView input) const {
+    if (!requiredLiteral_.empty() && !matchSubstring(input, requiredLiteral_)) {
+      return false;
+    }
+    if (isLiteral_) {
+      if constexpr (Fn == re2FullMatch) {
+        return input.size() == requiredLiteral_.size();
+      }
+      return true;
+    }
+    return Fn(input, re_);
+  }
 
   void apply(
       const SelectivityVector& rows,
@@ -200,12 +226,16 @@ class Re2MatchConstantPattern final : public VectorFunction {
     }
 
     context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
-      result.set(i, Fn(toSearch->valueAt<StringView>(i), re_));
+      result.set(i, match(toSearch->valueAt<StringView>(i)));
     });
   }
 
  private:
   RE2 re_;
+  // The characters that any match must contain. Empty if none are known.
+  const std::string requiredLiteral_;
+  // True if the pattern has no special characters and matches only itself.
+  const bool isLiteral_;
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -412,6 +442,53 @@ bool matchSuffixPattern(
           length) == 0;
 }
 
+// Returns true if string 'input' contains 'pattern', which has no wildcard
+// characters. Matching bytes is correct for UTF-8 strings with no special
+// handling of non-ASCII characters.
+bool matchSubstringPattern(
+    StringView input,
+    StringView pattern,
+    vector_size_t length) {
+  return simd::findSubstring(
+             input.data(), input.size(), pattern.data(), length) !=
+      std::string_view::npos;
+}
+
+// Sets 'resultRef' to match(input) for the first argument of like, which is
+// expected to be flat or constant because the pattern and escape arguments
+// are constants.
+template <typename Match>
+void applyLikeMatch(
+    const SelectivityVector& rows,
+    std::vector<VectorPtr>& args,
+    EvalCtx& context,
+    VectorPtr& resultRef,
+    Match match) {
+  VELOX_CHECK(args.size() == 2 || args.size() == 3);
+  FlatVector<bool>& result = ensureWritableBool(rows, context, resultRef);
+  exec::DecodedArgs decodedArgs(rows, args, context);
+  auto toSearch = decodedArgs.at(0);
+
+  if (toSearch->isIdentityMapping()) {
+    auto input = toSearch->data<StringView>();
+    context.applyToSelectedNoThrow(
+        rows, [&](vector_size_t i) { result.set(i, match(input[i])); });
+    return;
+  }
+  if (toSearch->isConstantMapping()) {
+    auto input = toSearch->valueAt<StringView>(0);
+    bool matchResult = match(input);
+    context.applyToSelectedNoThrow(
+        rows, [&](vector_size_t i) { result.set(i, matchResult); });
+    return;
+  }
+
+  // Since the likePattern and escapeChar (2nd and 3rd args) are both
+  // constants, so the first arg is expected to be either of flat or constant
+  // vector only. This code path is unreachable.
+  VELOX_UNREACHABLE();
+}
+
 template <PatternKind P>
 class OptimizedLikeWithMemcmp final : public VectorFunction {
  public:
@@ -432,6 +509,8 @@ class OptimizedLikeWithMemcmp final : public VectorFunction {
         return matchPrefixPattern(input, pattern_, reducedPatternLength_);
       case PatternKind::kSuffix:
         return matchSuffixPattern(input, pattern_, reducedPatternLength_);
+      case PatternKind::kSubstring:
+        return matchSubstringPattern(input, pattern_, reducedPatternLength_);
     }
   }
 
@@ -441,34 +520,85 @@ class OptimizedLikeWithMemcmp final : public VectorFunction {
       const TypePtr& /* outputType */,
       EvalCtx& context,
       VectorPtr& resultRef) const final {
-    VELOX_CHECK(args.size() == 2 || args.size() == 3);
-    FlatVector<bool>& result = ensureWritableBool(rows, context, resultRef);
-    exec::DecodedArgs decodedArgs(rows, args, context);
-    auto toSearch = decodedArgs.at(0);
+    applyLikeMatch(rows, args, context, resultRef, [&](StringView input) {
+      return match(input);
+    });
+  }
 
-    if (toSearch->isIdentityMapping()) {
-      auto input = toSearch->data<StringView>();
-      context.applyToSelectedNoThrow(
-          rows, [&](vector_size_t i) { result.set(i, match(input[i])); });
-      return;
+ private:
+  // The fixed part of the pattern for kSubstring, the whole pattern
+  // otherwise.
+  StringView pattern_;
+  vector_size_t reducedPatternLength_;
+};
+
+// Matches patterns with '%' wildcards only and any number of fixed parts,
+// such as 'foo%bar', '%a%b%' or 'a%b%c%d'. The fixed parts that are not at
+// the start or end of the pattern are found left to right, each after the
+// previous one, with simd::findSubstring.
+class OptimizedLikeWithSubstrings final : public VectorFunction {
+ public:
+  explicit OptimizedLikeWithSubstrings(StringView pattern) {
+    std::string_view patternView(pattern);
+    size_t start = 0;
+    while (start <= patternView.size()) {
+      auto end = std::min(patternView.find('%', start), patternView.size());
+      if (end > start) {
+        auto part = patternView.substr(start, end - start);
+        if (start == 0) {
+          prefix_ = part;
+        } else if (end == patternView.size()) {
+          suffix_ = part;
+        } else {
+          substrings_.emplace_back(part);
+        }
+      }
+      start = end + 1;
     }
-    if (toSearch->isConstantMapping()) {
-      auto input = toSearch->valueAt<StringView>(0);
-      bool matchResult = match(input);
-      context.applyToSelectedNoThrow(
-          rows, [&](vector_size_t i) { result.set(i, matchResult); });
-      return;
+  }
+
+  bool match(StringView input) const {
+    const char* data = input.data();
+    size_t size = input.size();
+    if (size < prefix_.size() + suffix_.size() ||
+        std::memcmp(data, prefix_.data(), prefix_.size()) != 0 ||
+        std::memcmp(
+            data + size - suffix_.size(), suffix_.data(), suffix_.size()) !=
+            0) {
+      return false;
+    }
+    data += prefix_.size();
+    size -= prefix_.size() + suffix_.size();
+    for (const auto& substring : substrings_) {
+      auto offset = simd::findSubstring(
+          data, size, substring.data(), substring.size());
+      if (offset == std::string_view::npos) {
+        return false;
+      }
+      data += offset + substring.size();
+      size -= offset + substring.size();
     }
+    return true;
+  }
 
-    // Since the likePattern and escapeChar (2nd and 3rd args) are both
-    // constants, so the first arg is expected to be either of flat or constant
-    // vector only. This code path is unreachable.
-    VELOX_UNREACHABLE();
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      EvalCtx& context,
+      VectorPtr& resultRef) const final {
+    applyLikeMatch(rows, args, context, resultRef, [&](StringView input) {
+      return match(input);
+    });
   }
 
  private:
-  StringView pattern_;
-  vector_size_t reducedPatternLength_;
+  // The fixed part before the first '%', if any.
+  std::string prefix_;
+  // The fixed part after the last '%', if any.
+  std::string suffix_;
+  // The fixed parts between '%' characters in pattern order.
+  std::vector<std::string> substrings_;
 };
 
 class LikeWithRe2 final : public VectorFunction {
@@ -846,6 +976,10 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   vector_size_t wildcardStart = -1;
   // Index of the first character that is not % and not _.
   vector_size_t fixedPatternStart = -1;
+  // Index of the second stream of % and _ characters. Set only if the first
+  // stream is at the start of the pattern and there is a single fixed
+  // pattern between the two streams.
+  vector_size_t secondWildcardStart = -1;
   // Total number of % characters.
   vector_size_t anyCharacterWildcardCount = 0;
   // Total number of _ characters.
@@ -855,13 +989,17 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   while (i < patternLength) {
     if (patternStr[i] == '%' || patternStr[i] == '_') {
       // Ensures that pattern has a single contiguous stream of wildcard
-      // characters.
+      // characters or a stream at each end of a single fixed pattern.
       if (wildcardStart != -1) {
-        return std::make_pair(PatternKind::kGeneric, 0);
+        if (wildcardStart != 0 || secondWildcardStart != -1) {
+          return std::make_pair(PatternKind::kGeneric, 0);
+        }
+        secondWildcardStart = i;
+      } else {
+        wildcardStart = i;
       }
       // Look till the last contiguous wildcard character, starting from this
       // index, is found, or the end of pattern is reached.
-      wildcardStart = i;
       while (i < patternLength &&
              (patternStr[i] == '%' || patternStr[i] == '_')) {
         singleCharacterWildcardCount += (patternStr[i] == '_');
@@ -883,6 +1021,14 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
     }
   }
 
+  // A fixed pattern between two streams of wildcard characters is a
+  // substring pattern if all the wildcard characters are '%'.
+  if (secondWildcardStart != -1) {
+    if (singleCharacterWildcardCount) {
+      return {PatternKind::kGeneric, 0};
+    }
+    return {PatternKind::kSubstring, secondWildcardStart - fixedPatternStart};
+  }
   // Pattern contains wildcard characters only.
   if (fixedPatternStart == -1) {
     if (!anyCharacterWildcardCount) {
@@ -906,6 +1052,55 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   return {PatternKind::kSuffix, patternLength - fixedPatternStart};
 }
 
+std::string requiredLiteral(std::string_view pattern) {
+  // Any character may be optional in an alternation.
+  if (pattern.find('|') != std::string_view::npos) {
+    return "";
+  }
+  std::string longest;
+  std::string current;
+  auto endRun = [&]() {
+    if (current.size() > longest.size()) {
+      longest = current;
+    }
+    current.clear();
+  };
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const char c = pattern[i];
+    if (c == '\\' || c == '(' || c == '[') {
+      // Escapes, groups and character classes are not analyzed.
+      break;
+    }
+    if (c == '{') {
+      endRun();
+      i = pattern.find('}', i);
+      if (i == std::string_view::npos) {
+        break;
+      }
+      continue;
+    }
+    // Non-ASCII characters are skipped so that a quantifier after a multi-byte
+    // character does not leave a part of it in the run.
+    if (static_cast<unsigned char>(c) >= 0x80 || c == '\0' ||
+        std::strchr("^$.?*+)]}", c) != nullptr) {
+      endRun();
+      continue;
+    }
+    const char next = i + 1 < pattern.size() ? pattern[i + 1] : '\0';
+    if (next == '?' || next == '*' || next == '{') {
+      // The character may be repeated zero times.
+      endRun();
+      continue;
+    }
+    current.push_back(c);
+    if (next == '+') {
+      endRun();
+    }
+  }
+  endRun();
+  return longest;
+}
+
 std::shared_ptr<exec::VectorFunction> makeLike(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs) {
@@ -987,7 +1182,17 @@ std::shared_ptr<exec::VectorFunction> makeLike(
       case PatternKind::kSuffix:
         return std::make_shared<OptimizedLikeWithMemcmp<PatternKind::kSuffix>>(
             pattern, reducedLength);
+      case PatternKind::kSubstring: {
+        // The fixed pattern follows the leading '%' characters.
+        auto start = std::string_view(pattern).find_first_not_of('%');
+        return std::make_shared<
+            OptimizedLikeWithMemcmp<PatternKind::kSubstring>>(
+            StringView(pattern.data() + start, reducedLength), reducedLength);
+      }
       default:
+        if (std::string_view(pattern).find('_') == std::string_view::npos) {
+          return std::make_shared<OptimizedLikeWithSubstrings>(pattern);
+        }
         return std::make_shared<LikeWithRe2>(pattern, escapeChar);
     }
   }
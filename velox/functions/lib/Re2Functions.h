@@ -39,6 +39,9 @@ enum class PatternKind {
   kPrefix,
   /// Fixed pattern preceded by one or more '%', such as '%foo', '%%%hello'.
   kSuffix,
+  /// Fixed pattern preceded and followed by one or more '%', such as '%foo%',
+  /// '%%hello%'.
+  kSubstring,
   /// Patterns which do not fit any of the above types, such as 'hello_world',
   /// '_presto%'.
   kGeneric,
@@ -101,6 +104,14 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures();
 /// {kGenericPattern, 0} for generic patterns).
 std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern);
 
+/// Returns the longest sequence of characters that any match of the RE2
+/// 'pattern' must contain, or an empty string if none is found. The analysis
+/// is conservative: it gives up on alternations and only considers ASCII
+/// characters before the first escape, group or character class that are not
+/// followed by a quantifier allowing zero repetitions. Returns 'pattern' itself
+/// if it has no special characters.
+std::string requiredLiteral(std::string_view pattern);
+
 std::shared_ptr<exec::VectorFunction> makeLike(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs);
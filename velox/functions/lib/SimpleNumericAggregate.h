@@ -20,6 +20,7 @@
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/LazyVector.h"
+#include "velox/vector/SequenceVector.h"
 
 namespace facebook::velox::aggregate {
 
@@ -140,6 +141,73 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
   }
 
+  // Same as updateGroups(), but pre-aggregates the rows of each group with
+  // updateFewGroups() when the rows hit few distinct groups. 'initialValue'
+  // must be the identity of 'updateSingleValue', e.g. 0 for a sum.
+  template <
+      bool tableHasNulls,
+      typename TData = TResult,
+      typename TValue = TInput,
+      typename UpdateSingleValue>
+  void updateGroupsPreAggregated(
+      char** groups,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      UpdateSingleValue updateSingleValue,
+      TData initialValue) {
+    DecodedVector decoded(*arg, rows);
+    auto noNulls = [](vector_size_t /*row*/) { return false; };
+    auto updateGroup = [&](char* group, TData partial) {
+      updateNonNullValue<tableHasNulls, TData>(
+          group, partial, updateSingleValue);
+    };
+    if (decoded.isConstantMapping()) {
+      if (!decoded.isNullAt(0)) {
+        auto value = TData(decoded.valueAt<TValue>(0));
+        updateFewGroups(
+            groups,
+            rows,
+            initialValue,
+            noNulls,
+            [&](TData& partial, vector_size_t /*row*/) {
+              updateSingleValue(partial, value);
+            },
+            updateGroup);
+      }
+    } else if (decoded.mayHaveNulls()) {
+      updateFewGroups(
+          groups,
+          rows,
+          initialValue,
+          [&](vector_size_t row) { return decoded.isNullAt(row); },
+          [&](TData& partial, vector_size_t row) {
+            updateSingleValue(partial, TData(decoded.valueAt<TValue>(row)));
+          },
+          updateGroup);
+    } else if (decoded.isIdentityMapping() && !std::is_same_v<TValue, bool>) {
+      auto data = decoded.data<TValue>();
+      updateFewGroups(
+          groups,
+          rows,
+          initialValue,
+          noNulls,
+          [&](TData& partial, vector_size_t row) {
+            updateSingleValue(partial, TData(data[row]));
+          },
+          updateGroup);
+    } else {
+      updateFewGroups(
+          groups,
+          rows,
+          initialValue,
+          noNulls,
+          [&](TData& partial, vector_size_t row) {
+            updateSingleValue(partial, TData(decoded.valueAt<TValue>(row)));
+          },
+          updateGroup);
+    }
+  }
+
   // TData is used to store the updated group state. It can be either
   // TAccumulator or TResult, which in most cases are the same, but for
   // sum(real) can differ. TValue is used to decode the update input 'args'.
@@ -158,6 +226,20 @@ class SimpleNumericAggregate : public exec::Aggregate {
       UpdateDuplicate updateDuplicateValues,
       bool /*mayPushdown*/,
       TData initialValue) {
+    if (arg->encoding() == VectorEncoding::Simple::SEQUENCE) {
+      // Update once per run of equal values, like for a constant.
+      DecodedVector decodedRuns(*arg->valueVector());
+      forEachSelectedRun(*arg, rows, [&](auto run, auto numRows) {
+        if (!decodedRuns.isNullAt(run)) {
+          TData partial = initialValue;
+          updateDuplicateValues(
+              partial, TData(decodedRuns.valueAt<TValue>(run)), numRows);
+          updateNonNullValue<true, TData>(group, partial, updateSingleValue);
+        }
+      });
+      return;
+    }
+
     DecodedVector decoded(*arg, rows);
 
     // Do row by row if not all rows are selected.
@@ -317,46 +317,82 @@ class SubscriptImpl : public exec::VectorFunction {
     auto rawSizes = baseMap->rawSizes();
     auto rawOffsets = baseMap->rawOffsets();
 
-    // Lambda that does the search for a key, for each row.
-    auto processRow = [&](vector_size_t row, TKey searchKey) {
-      size_t mapIndex = mapIndices[row];
-      size_t offsetStart = rawOffsets[mapIndex];
-      size_t offsetEnd = offsetStart + rawSizes[mapIndex];
-      bool found = false;
+    const bool sortedKeys = baseMap->hasSortedKeys();
+
+    // Returns the offset of 'searchKey' in the map at 'mapIndex' of 'baseMap'
+    // or -1 if the map does not have the key.
+    auto findKey = [&](vector_size_t mapIndex,
+                       TKey searchKey) -> vector_size_t {
+      vector_size_t offsetStart = rawOffsets[mapIndex];
+      vector_size_t offsetEnd = offsetStart + rawSizes[mapIndex];
+
+      // The keys of canonicalized maps are sorted smallest first, so large
+      // maps can be binary searched.
+      if (sortedKeys && offsetEnd - offsetStart > kMinBinarySearchSize) {
+        auto low = offsetStart;
+        auto high = offsetEnd;
+        while (low < high) {
+          auto middle = low + (high - low) / 2;
+          if (decodedMapKeys->valueAt<TKey>(middle) < searchKey) {
+            low = middle + 1;
+          } else {
+            high = middle;
+          }
+        }
+        return low < offsetEnd &&
+                decodedMapKeys->valueAt<TKey>(low) == searchKey
+            ? low
+            : -1;
+      }
 
       // Sequentially check each key on this map for a match. We use a
       // sequential scan over the keys because it's easier to express (and
-      // likely has good memory locality), but if we find that this is slow
-      // for large maps we could try to canonicalize the whole vector and binary
-      // search `searchKey`.
-      for (size_t offset = offsetStart; offset < offsetEnd; ++offset) {
+      // likely has good memory locality).
+      for (auto offset = offsetStart; offset < offsetEnd; ++offset) {
         if (decodedMapKeys->valueAt<TKey>(offset) == searchKey) {
-          rawIndices[row] = offset;
-          found = true;
-          break;
+          return offset;
         }
       }
+      return -1;
+    };
 
-      // NB: We still allow non-existent map keys, even if out of bounds is
-      // disabled for arrays.
-
-      // Handle NULLs.
-      if (!found) {
+    // NB: We still allow non-existent map keys, even if out of bounds is
+    // disabled for arrays.
+    auto setResult = [&](vector_size_t row, vector_size_t offset) {
+      if (offset == -1) {
         nullsBuilder.setNull(row);
+      } else {
+        rawIndices[row] = offset;
       }
     };
 
     // When second argument ("at") is a constant.
     if (decodedIndices->isConstantMapping()) {
       auto searchKey = decodedIndices->valueAt<TKey>(0);
-      rows.applyToSelected(
-          [&](vector_size_t row) { processRow(row, searchKey); });
+      if (!decodedMap->isIdentityMapping() && baseMap->size() < rows.end()) {
+        // The rows repeat maps of a dictionary or constant encoded map
+        // vector. Look up the key once per distinct base map.
+        constexpr vector_size_t kNotLookedUp = -2;
+        std::vector<vector_size_t> baseOffsets(baseMap->size(), kNotLookedUp);
+        rows.applyToSelected([&](vector_size_t row) {
+          auto mapIndex = mapIndices[row];
+          auto& offset = baseOffsets[mapIndex];
+          if (offset == kNotLookedUp) {
+            offset = findKey(mapIndex, searchKey);
+          }
+          setResult(row, offset);
+        });
+      } else {
+        rows.applyToSelected([&](vector_size_t row) {
+          setResult(row, findKey(mapIndices[row], searchKey));
+        });
+      }
     }
     // When the second argument ("at") is also a variable vector.
     else {
       rows.applyToSelected([&](vector_size_t row) {
         auto searchKey = decodedIndices->valueAt<TKey>(row);
-        processRow(row, searchKey);
+        setResult(row, findKey(mapIndices[row], searchKey));
       });
     }
 
@@ -370,6 +406,10 @@ class SubscriptImpl : public exec::VectorFunction {
     return BaseVector::wrapInDictionary(
         nullsBuilder.build(), indices, rows.size(), baseMap->mapValues());
   }
+
+  // Maps with sorted keys and more than this many entries are binary searched
+  // instead of scanned.
+  static constexpr vector_size_t kMinBinarySearchSize = 16;
 };
 
 } // namespace facebook::velox::functions
@@ -48,12 +48,60 @@ getSeconds(Timestamp timestamp, const date::time_zone* timeZone) {
 }
 } // namespace
 
+/// Fills 'dateTime' with the UTC date and time of 'seconds' since the epoch,
+/// like gmtime_r(). Computes the calendar date with integer arithmetic
+/// instead of calling into libc. Returns false if the year does not fit in
+/// 'tm_year'.
+FOLLY_ALWAYS_INLINE bool toDateTime(int64_t seconds, std::tm& dateTime) {
+  dateTime = std::tm{};
+  int64_t days = seconds / kSecondsInDay;
+  int64_t secondsInDay = seconds % kSecondsInDay;
+  if (secondsInDay < 0) {
+    --days;
+    secondsInDay += kSecondsInDay;
+  }
+
+  // Civil date from days since the epoch, in 400 year eras that start on
+  // March 1st. See http://howardhinnant.github.io/date_algorithms.html.
+  const int64_t shiftedDays = days + 719'468;
+  const int64_t era =
+      (shiftedDays >= 0 ? shiftedDays : shiftedDays - 146'096) / 146'097;
+  const int64_t dayOfEra = shiftedDays - era * 146'097;
+  const int64_t yearOfEra =
+      (dayOfEra - dayOfEra / 1'460 + dayOfEra / 36'524 - dayOfEra / 146'096) /
+      365;
+  const int64_t dayOfMarchYear =
+      dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  const int64_t marchMonth = (5 * dayOfMarchYear + 2) / 153;
+  const int64_t month = marchMonth < 10 ? marchMonth + 2 : marchMonth - 10;
+  const int64_t year = yearOfEra + era * 400 + (month <= 1);
+  if (year - 1900 > std::numeric_limits<int>::max() ||
+      year - 1900 < std::numeric_limits<int>::min()) {
+    return false;
+  }
+  const bool isLeapYear =
+      (year % 4 == 0) && (year % 100 != 0 || year % 400 == 0);
+
+  dateTime.tm_sec = secondsInDay % 60;
+  dateTime.tm_min = secondsInDay / 60 % 60;
+  dateTime.tm_hour = secondsInDay / 3'600;
+  dateTime.tm_mday = dayOfMarchYear - (153 * marchMonth + 2) / 5 + 1;
+  dateTime.tm_mon = month;
+  dateTime.tm_year = year - 1900;
+  // 1970-01-01 was a Thursday.
+  dateTime.tm_wday = (days % kDaysInWeek + kDaysInWeek + 4) % kDaysInWeek;
+  // March 1st is day 59 of the year, or 60 in leap years.
+  dateTime.tm_yday = marchMonth < 10 ? dayOfMarchYear + 59 + isLeapYear
+                                     : dayOfMarchYear - 306;
+  return true;
+}
+
 FOLLY_ALWAYS_INLINE
 std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
   int64_t seconds = getSeconds(timestamp, timeZone);
   std::tm dateTime;
-  VELOX_USER_CHECK_NOT_NULL(
-      gmtime_r((const time_t*)&seconds, &dateTime),
+  VELOX_USER_CHECK(
+      toDateTime(seconds, dateTime),
       "Timestamp is too large: {} seconds since epoch",
       seconds);
   return dateTime;
@@ -63,22 +111,70 @@ FOLLY_ALWAYS_INLINE
 std::tm getDateTime(Date date) {
   int64_t seconds = date.days() * kSecondsInDay;
   std::tm dateTime;
-  VELOX_USER_CHECK_NOT_NULL(
-      gmtime_r((const time_t*)&seconds, &dateTime),
+  VELOX_USER_CHECK(
+      toDateTime(seconds, dateTime),
       "Date is too large: {} days",
       date.days());
   return dateTime;
 }
 
+/// Converts UTC seconds to the local seconds of a time zone. Remembers the
+/// interval between the two transitions of the time zone around the last
+/// converted time and its UTC offset. Nearby timestamps then skip the time
+/// zone database lookup until a transition is crossed.
+class TimeZoneOffsetCache {
+ public:
+  void setTimeZone(const date::time_zone* timeZone) {
+    timeZone_ = timeZone;
+    begin_ = 0;
+    end_ = 0;
+  }
+
+  const date::time_zone* timeZone() const {
+    return timeZone_;
+  }
+
+  FOLLY_ALWAYS_INLINE int64_t toLocalSeconds(int64_t seconds) {
+    if (UNLIKELY(seconds < begin_ || seconds >= end_)) {
+      auto info = timeZone_->get_info(
+          date::sys_seconds(std::chrono::seconds(seconds)));
+      begin_ = info.begin.time_since_epoch().count();
+      end_ = info.end.time_since_epoch().count();
+      offset_ = info.offset.count();
+    }
+    return seconds + offset_;
+  }
+
+  /// Returns the date and time of 'timestamp' in the time zone, or in UTC if
+  /// the time zone is not set.
+  FOLLY_ALWAYS_INLINE std::tm getDateTime(Timestamp timestamp) {
+    if (timeZone_ == nullptr) {
+      return functions::getDateTime(timestamp, nullptr);
+    }
+    return functions::getDateTime(
+        Timestamp(toLocalSeconds(timestamp.getSeconds()), 0), nullptr);
+  }
+
+ private:
+  const date::time_zone* timeZone_{nullptr};
+
+  // The UTC seconds [begin_, end_) that have the UTC offset 'offset_'.
+  int64_t begin_{0};
+  int64_t end_{0};
+  int64_t offset_{0};
+};
+
 template <typename T>
 struct InitSessionTimezone {
   VELOX_DEFINE_FUNCTION_TYPES(T);
   const date::time_zone* timeZone_{nullptr};
+  TimeZoneOffsetCache timeZoneCache_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
       const arg_type<Timestamp>* /*timestamp*/) {
     timeZone_ = getTimeZoneFromConfig(config);
+    timeZoneCache_.setTimeZone(timeZone_);
   }
 };
 } // namespace facebook::velox::functions
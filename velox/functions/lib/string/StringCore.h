@@ -19,7 +19,9 @@
 #include <string>
 #include <string_view>
 #include "folly/CPortability.h"
+#include "folly/lang/Bits.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/external/utf8proc/utf8procImpl.h"
 
 #if (ENABLE_VECTORIZATION > 0) && !defined(_DEBUG) && !defined(DEBUG)
@@ -48,7 +50,21 @@ namespace stringCore {
 static bool isAscii(const char* str, size_t length);
 
 FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
-  for (auto i = 0; i < length; i++) {
+  // Check the sign bits of a SIMD register worth of bytes at a time, then 8
+  // bytes at a time, then the remaining bytes one by one.
+  using Batch = xsimd::batch<int8_t>;
+  size_t i = 0;
+  for (; i + Batch::size <= length; i += Batch::size) {
+    if (simd::toBitMask(Batch::load_unaligned(str + i) < Batch(0)) != 0) {
+      return false;
+    }
+  }
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    if (folly::loadUnaligned<uint64_t>(str + i) & 0x8080808080808080ULL) {
+      return false;
+    }
+  }
+  for (; i < length; i++) {
     if (str[i] & 0x80) {
       return false;
     }
@@ -29,6 +29,7 @@
 #include "folly/Likely.h"
 #include "folly/ssl/OpenSSLHash.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/external/md5/md5.h"
 #include "velox/functions/lib/string/StringCore.h"
 #include "velox/type/StringView.h"
@@ -324,7 +325,14 @@ FOLLY_ALWAYS_INLINE bool splitPart(
   }
   while (curPos <= inputSv.size()) {
     size_t start = curPos;
-    curPos = inputSv.find(delim, curPos);
+    curPos = simd::findSubstring(
+        inputSv.data() + curPos,
+        inputSv.size() - curPos,
+        delim.data(),
+        delim.size());
+    if (curPos != std::string_view::npos) {
+      curPos += start;
+    }
     if (iteration == index) {
       size_t end = curPos;
       if (end == std::string_view::npos) {
@@ -176,6 +176,22 @@ TEST_F(StringImplTest, length) {
   }
 }
 
+TEST_F(StringImplTest, isAscii) {
+  ASSERT_TRUE(isAscii("", 0));
+
+  // Put a non-ASCII byte at each position of strings of lengths that cover
+  // the SIMD, 8 byte and single byte loops.
+  for (auto length : {1, 7, 8, 15, 31, 32, 33, 64, 100}) {
+    std::string input(length, 'a');
+    ASSERT_TRUE(isAscii(input.data(), input.size())) << length;
+    for (auto i = 0; i < length; ++i) {
+      input[i] = '\xC3';
+      ASSERT_FALSE(isAscii(input.data(), input.size())) << length << " " << i;
+      input[i] = 'a';
+    }
+  }
+}
+
 TEST_F(StringImplTest, badUnicodeLength) {
   ASSERT_EQ(0, length</*isAscii*/ false>(std::string("")));
   ASSERT_EQ(2, length</*isAscii*/ false>(std::string("ab")));
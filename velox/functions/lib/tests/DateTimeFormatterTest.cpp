@@ -1359,6 +1359,49 @@ TEST_F(JodaDateTimeFormatterTest, parseConsecutiveSpecifiers) {
   EXPECT_THROW(parseJoda("12312", "yyH"), VeloxUserError);
 }
 
+TEST_F(JodaDateTimeFormatterTest, fixedWidth) {
+  const std::string format = "yyyy-MM-dd HH:mm:ss";
+  EXPECT_EQ(
+      util::fromTimestampString("2022-03-14 01:02:03"),
+      parseJoda("2022-03-14 01:02:03", format).timestamp);
+  EXPECT_EQ(-1, parseJoda("2022-03-14 01:02:03", format).timezoneId);
+  EXPECT_EQ(
+      util::fromTimestampString("1969-12-31 23:59:59"),
+      parseJoda("1969-12-31 23:59:59", format).timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("2020-02-29 00:00:00"),
+      parseJoda("2020-02-29 00:00:00", format).timestamp);
+
+  // Inputs not matching the fixed width layout fall back to the general
+  // parser.
+  EXPECT_EQ(
+      util::fromTimestampString("2022-03-14 01:02:03"),
+      parseJoda("2022-3-14 01:02:03", format).timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("12022-03-14 01:02:03"),
+      parseJoda("12022-03-14 01:02:03", format).timestamp);
+  EXPECT_THROW(parseJoda("2022-13-14 01:02:03", format), VeloxUserError);
+  EXPECT_THROW(parseJoda("2022-02-30 01:02:03", format), VeloxUserError);
+  EXPECT_THROW(parseJoda("2022-03-14 24:02:03", format), VeloxUserError);
+  EXPECT_THROW(parseJoda("2022-03-14T01:02:03", format), VeloxUserError);
+
+  auto* timezone = date::locate_zone("GMT");
+  auto formatter = buildJodaDateTimeFormatter(format);
+  for (const auto& input :
+       {"0001-01-01 00:00:00",
+        "1969-12-31 23:59:59",
+        "1970-01-01 00:00:00",
+        "2022-03-14 01:02:03",
+        "9999-12-31 23:59:59"}) {
+    EXPECT_EQ(
+        input, formatter->format(util::fromTimestampString(input), timezone));
+  }
+  EXPECT_EQ(
+      "2022-03-14",
+      buildJodaDateTimeFormatter("yyyy-MM-dd")
+          ->format(util::fromTimestampString("2022-03-14 01:02:03"), timezone));
+}
+
 class MysqlDateTimeTest : public DateTimeFormatterTest {};
 
 TEST_F(MysqlDateTimeTest, validBuild) {
@@ -1435,6 +1478,19 @@ TEST_F(MysqlDateTimeTest, invalidBuild) {
   EXPECT_THROW(buildMysqlDateTimeFormatter(""), VeloxUserError);
 }
 
+TEST_F(MysqlDateTimeTest, fixedWidth) {
+  const std::string format = "%Y-%m-%d %H:%i:%s";
+  EXPECT_EQ(
+      util::fromTimestampString("2022-03-14 01:02:03"),
+      parseMysql("2022-03-14 01:02:03", format));
+  EXPECT_THROW(parseMysql("2022-02-30 01:02:03", format), VeloxUserError);
+  EXPECT_EQ(
+      "2022-03-14 01:02:03",
+      buildMysqlDateTimeFormatter(format)->format(
+          util::fromTimestampString("2022-03-14 01:02:03"),
+          date::locate_zone("GMT")));
+}
+
 TEST_F(MysqlDateTimeTest, formatYear) {
   auto* timezone = date::locate_zone("GMT");
   EXPECT_EQ(
@@ -84,6 +84,38 @@ TEST(KllSketchTest, exactMode) {
   }
 }
 
+TEST(KllSketchTest, viewEstimateQuantiles) {
+  constexpr int N = 1000;
+  KllSketch<double> kll(200, {}, 0);
+  insertRandomData(0, N, kll, nullptr);
+  kll.finish();
+  auto q = linspace(101);
+  auto expected = kll.estimateQuantiles(folly::Range(q.begin(), q.end()));
+  std::vector<double> actual(q.size());
+  kll.toView().estimateQuantiles(
+      folly::Range(q.begin(), q.end()), actual.data());
+  for (int i = 0; i < q.size(); ++i) {
+    EXPECT_EQ(actual[i], expected[i]);
+  }
+
+  // Sorted values that are not in a sketch.
+  std::vector<int> items = {1, 2, 2, 5, 9};
+  std::vector<uint32_t> levels = {0, 5};
+  KllSketch<int>::View view{
+      .k = 200,
+      .n = items.size(),
+      .minValue = 1,
+      .maxValue = 9,
+      .items = {items.data(), items.size()},
+      .levels = {levels.data(), levels.size()},
+  };
+  std::vector<double> fractions = {0.0, 0.2, 0.5, 0.7, 1.0};
+  std::vector<int> values(fractions.size());
+  view.estimateQuantiles(
+      folly::Range(fractions.begin(), fractions.end()), values.data());
+  EXPECT_EQ(values, (std::vector<int>{1, 2, 2, 5, 9}));
+}
+
 TEST(KllSketchTest, estimationMode) {
   constexpr int N = 1e5;
   constexpr int M = 1001;
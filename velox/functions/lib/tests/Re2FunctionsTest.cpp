@@ -270,6 +270,58 @@ TEST_F(Re2FunctionsTest, regexSearchBatch) {
   re2Search.testBatchAll();
 }
 
+TEST_F(Re2FunctionsTest, regexRequiredLiteral) {
+  EXPECT_EQ(requiredLiteral("abc"), "abc");
+  EXPECT_EQ(requiredLiteral("^abc$"), "abc");
+  EXPECT_EQ(requiredLiteral("abcd*"), "abc");
+  EXPECT_EQ(requiredLiteral("ab?c"), "a");
+  EXPECT_EQ(requiredLiteral("ab+c"), "ab");
+  EXPECT_EQ(requiredLiteral("foo.*barbaz"), "barbaz");
+  EXPECT_EQ(requiredLiteral("x{2}yz"), "yz");
+  EXPECT_EQ(requiredLiteral("ab(cd)*efg"), "ab");
+  EXPECT_EQ(requiredLiteral("hello\\d+world"), "hello");
+  EXPECT_EQ(requiredLiteral("\u00e9*ab"), "ab");
+  EXPECT_EQ(requiredLiteral("abc|def"), "");
+  EXPECT_EQ(requiredLiteral(".*"), "");
+  EXPECT_EQ(requiredLiteral(""), "");
+}
+
+TEST_F(Re2FunctionsTest, regexRequiredLiteralBatch) {
+  auto data = makeRowVector({makeFlatVector<std::string>({
+      "foo",
+      "xfoox",
+      "fo",
+      "abbbc",
+      "ac",
+      "hello 123 world",
+      "hello world",
+  })});
+  auto test = [&](const std::string& pattern,
+                  const std::vector<bool>& expectedSearch,
+                  const std::vector<bool>& expectedMatch) {
+    SCOPED_TRACE(pattern);
+    assertEqualVectors(
+        makeFlatVector<bool>(expectedSearch),
+        evaluate(fmt::format("re2_search(c0, '{}')", pattern), data));
+    assertEqualVectors(
+        makeFlatVector<bool>(expectedMatch),
+        evaluate(fmt::format("re2_match(c0, '{}')", pattern), data));
+  };
+
+  test(
+      "foo",
+      {true, true, false, false, false, false, false},
+      {true, false, false, false, false, false, false});
+  test(
+      "ab+c",
+      {false, false, false, true, false, false, false},
+      {false, false, false, true, false, false, false});
+  test(
+      "hello \\d+ world",
+      {false, false, false, false, false, true, false},
+      {false, false, false, false, false, true, false});
+}
+
 template <typename F>
 void testRe2Extract(F&& regexExtract) {
   // Regex with no subgroup matches.
@@ -439,6 +491,14 @@ TEST_F(Re2FunctionsTest, likeDeterminePatternKind) {
   testPattern("%%_%aBcD", PatternKind::kGeneric, 0);
   testPattern("%%a%%BcD", PatternKind::kGeneric, 0);
   testPattern("foo%bar", PatternKind::kGeneric, 0);
+
+  testPattern("%presto%", PatternKind::kSubstring, 6);
+  testPattern("%%hello%%%", PatternKind::kSubstring, 5);
+  testPattern("%a%", PatternKind::kSubstring, 1);
+  testPattern("%_a%", PatternKind::kGeneric, 0);
+  testPattern("%a_%", PatternKind::kGeneric, 0);
+  testPattern("%a%b%", PatternKind::kGeneric, 0);
+  testPattern("a%b%", PatternKind::kGeneric, 0);
 }
 
 TEST_F(Re2FunctionsTest, likePatternWildcard) {
@@ -592,6 +652,65 @@ TEST_F(Re2FunctionsTest, likePatternSuffix) {
   EXPECT_TRUE(like(input, generateString(kAnyWildcardCharacter) + input));
 }
 
+TEST_F(Re2FunctionsTest, likePatternSubstring) {
+  auto like = [&](std::string str, std::string pattern) {
+    auto likeResult = evaluateOnce<bool>(
+        fmt::format("like(c0, '{}')", pattern), std::make_optional(str));
+    VELOX_CHECK(likeResult, "Like operator evaluation failed");
+    return *likeResult;
+  };
+
+  EXPECT_TRUE(like("abcde", "%bcd%"));
+  EXPECT_TRUE(like("abcde", "%%abcde%%"));
+  EXPECT_TRUE(like("abcde", "%e%"));
+  EXPECT_TRUE(like("\nabc\nde\n", "%\nde%"));
+  EXPECT_FALSE(like("", "%a%"));
+  EXPECT_FALSE(like("abcde", "%ce%"));
+  EXPECT_FALSE(like("ABCDE", "%bcd%"));
+  EXPECT_FALSE(like("abcd", "%abcde%"));
+
+  // Strings longer than a SIMD batch with the match at different offsets.
+  std::string input = generateString(kLikePatternCharacterSet, 100);
+  for (auto i = 0; i + 10 <= input.size(); i += 7) {
+    EXPECT_TRUE(like(input, "%" + input.substr(i, 10) + "%"));
+  }
+  EXPECT_FALSE(like(std::string(100, 'a') + "b", "%aab%a%"));
+  EXPECT_TRUE(like(std::string(100, 'a') + "b", "%aab%"));
+  EXPECT_TRUE(like("\u4FE1\u5FF5 \u7231 \u5E0C\u671B", "%\u7231%"));
+  EXPECT_FALSE(like("\u4FE1\u5FF5 \u7231 \u5E0C\u671B", "%\u7232%"));
+}
+
+TEST_F(Re2FunctionsTest, likePatternMultipleSubstrings) {
+  auto like = [&](std::string str, std::string pattern) {
+    auto likeResult = evaluateOnce<bool>(
+        fmt::format("like(c0, '{}')", pattern), std::make_optional(str));
+    VELOX_CHECK(likeResult, "Like operator evaluation failed");
+    return *likeResult;
+  };
+
+  EXPECT_TRUE(like("abcde", "%b%d%"));
+  EXPECT_TRUE(like("abcde", "a%c%e"));
+  EXPECT_TRUE(like("abcde", "ab%de"));
+  EXPECT_TRUE(like("abcde", "%a%%b%c%d%e%"));
+  EXPECT_TRUE(like("abab", "ab%ab"));
+  EXPECT_FALSE(like("aba", "ab%ba"));
+  EXPECT_FALSE(like("abcde", "%d%b%"));
+  EXPECT_FALSE(like("abcde", "b%e"));
+  EXPECT_FALSE(like("abcde", "a%c%d"));
+  EXPECT_FALSE(like("abcde", "%bc%cd%"));
+  EXPECT_TRUE(like("\nab\ncd\n", "%b\n%\n"));
+
+  // The first match of each part is used, which is enough for patterns
+  // without '_'.
+  EXPECT_TRUE(like("xaxbxaxc", "%a%c"));
+  EXPECT_TRUE(like(
+      std::string(50, 'a') + "foo" + std::string(50, 'b') + "bar",
+      "a%foo%bar"));
+  EXPECT_FALSE(like(
+      std::string(50, 'a') + "bar" + std::string(50, 'b') + "foo",
+      "a%foo%bar"));
+}
+
 TEST_F(Re2FunctionsTest, likePatternAndEscape) {
   auto like = ([&](std::optional<std::string> str,
                    std::optional<std::string> pattern,
@@ -25,6 +25,7 @@
 
 #include "folly/CPortability.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/Macros.h"
 #include "velox/functions/prestosql/ArithmeticImpl.h"
 
@@ -40,6 +41,26 @@ inline constexpr char digits[36] = {
 
 namespace {
 
+// Sets result[i] to op(a[i], b[i]) for 'size' values, a SIMD batch at a time.
+// 'op' is called with both xsimd batches and scalars.
+template <typename TInput, typename Op>
+FOLLY_ALWAYS_INLINE void applyBinaryBatch(
+    TInput* result,
+    const TInput* a,
+    const TInput* b,
+    int32_t size,
+    Op op) {
+  using Batch = xsimd::batch<TInput>;
+  int32_t i = 0;
+  for (; i + static_cast<int32_t>(Batch::size) <= size; i += Batch::size) {
+    op(Batch::load_unaligned(a + i), Batch::load_unaligned(b + i))
+        .store_unaligned(result + i);
+  }
+  for (; i < size; ++i) {
+    result[i] = op(a[i], b[i]);
+  }
+}
+
 template <typename T>
 struct PlusFunction {
   template <typename TInput>
@@ -47,6 +68,14 @@ struct PlusFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = plus(a, b);
   }
+
+  template <
+      typename TInput,
+      std::enable_if_t<std::is_floating_point_v<TInput>, int32_t> = 0>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(TInput* result, const TInput* a, const TInput* b, int32_t size) {
+    applyBinaryBatch(result, a, b, size, [](auto x, auto y) { return x + y; });
+  }
 };
 
 template <typename T>
@@ -56,6 +85,14 @@ struct MinusFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = minus(a, b);
   }
+
+  template <
+      typename TInput,
+      std::enable_if_t<std::is_floating_point_v<TInput>, int32_t> = 0>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(TInput* result, const TInput* a, const TInput* b, int32_t size) {
+    applyBinaryBatch(result, a, b, size, [](auto x, auto y) { return x - y; });
+  }
 };
 
 template <typename T>
@@ -65,6 +102,14 @@ struct MultiplyFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = multiply(a, b);
   }
+
+  template <
+      typename TInput,
+      std::enable_if_t<std::is_floating_point_v<TInput>, int32_t> = 0>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(TInput* result, const TInput* a, const TInput* b, int32_t size) {
+    applyBinaryBatch(result, a, b, size, [](auto x, auto y) { return x * y; });
+  }
 };
 
 template <typename T>
@@ -13,12 +13,38 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/vector/DecodedVector.h"
 
 namespace facebook::velox::functions {
 namespace {
 
+// Returns true if any of the 'size' values starting at 'values' is equal to
+// 'search'. Arrays of numbers are compared a SIMD batch at a time.
+template <typename T>
+bool containsValue(const T* values, vector_size_t size, const T& search) {
+  vector_size_t i = 0;
+  if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+    using Batch = xsimd::batch<T>;
+    constexpr vector_size_t kBatchSize = Batch::size;
+    if (size >= kBatchSize) {
+      const auto searchBatch = Batch::broadcast(search);
+      for (; i + kBatchSize <= size; i += kBatchSize) {
+        if (simd::toBitMask(Batch::load_unaligned(values + i) == searchBatch)) {
+          return true;
+        }
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    if (values[i] == search) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <TypeKind kind>
 void applyTyped(
     const SelectivityVector& rows,
@@ -36,23 +62,29 @@ void applyTyped(
   constexpr bool isBoolType = std::is_same_v<bool, T>;
 
   if (!isBoolType && elementsDecoded.isIdentityMapping() &&
-      !elementsDecoded.mayHaveNulls() && searchDecoded.isConstantMapping()) {
+      !elementsDecoded.mayHaveNulls()) {
     auto rawElements = elementsDecoded.data<T>();
-    auto search = searchDecoded.valueAt<T>(0);
-
-    rows.applyToSelected([&](auto row) {
-      auto size = rawSizes[indices[row]];
-      auto offset = rawOffsets[indices[row]];
 
-      for (auto i = 0; i < size; i++) {
-        if (rawElements[offset + i] == search) {
-          flatResult.set(row, true);
-          return;
-        }
-      }
-
-      flatResult.set(row, false);
-    });
+    if (searchDecoded.isConstantMapping()) {
+      auto search = searchDecoded.valueAt<T>(0);
+      rows.applyToSelected([&](auto row) {
+        flatResult.set(
+            row,
+            containsValue(
+                rawElements + rawOffsets[indices[row]],
+                rawSizes[indices[row]],
+                search));
+      });
+    } else {
+      rows.applyToSelected([&](auto row) {
+        flatResult.set(
+            row,
+            containsValue(
+                rawElements + rawOffsets[indices[row]],
+                rawSizes[indices[row]],
+                searchDecoded.valueAt<T>(row)));
+      });
+    }
   } else {
     rows.applyToSelected([&](auto row) {
       auto size = rawSizes[indices[row]];
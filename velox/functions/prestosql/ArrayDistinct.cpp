@@ -15,6 +15,7 @@
  */
 
 #include <folly/container/F14Set.h>
+#include <array>
 
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
@@ -43,6 +44,9 @@ namespace {
 template <typename T>
 class ArrayDistinctFunction : public exec::VectorFunction {
  public:
+  // Arrays of at most this many elements are deduplicated without a hash set.
+  static constexpr vector_size_t kMaxLinearSearchSize = 16;
+
   void apply(
       const SelectivityVector& rows,
       std::vector<VectorPtr>& args,
@@ -105,6 +109,30 @@ class ArrayDistinctFunction : public exec::VectorFunction {
 
       rawOffsets[row] = indicesCursor;
       bool hasNulls = false;
+      if (size <= kMaxLinearSearchSize) {
+        // Small arrays are deduplicated by comparing with the distinct values
+        // found so far, which is faster than hashing.
+        std::array<T, kMaxLinearSearchSize> distinctValues;
+        auto numDistinct = 0;
+        for (vector_size_t i = offset; i < offset + size; ++i) {
+          if (elements->isNullAt(i)) {
+            if (!hasNulls) {
+              hasNulls = true;
+              rawNewIndices[indicesCursor++] = i;
+            }
+          } else {
+            auto value = elements->valueAt<T>(i);
+            auto* end = distinctValues.begin() + numDistinct;
+            if (std::find(distinctValues.begin(), end, value) == end) {
+              distinctValues[numDistinct++] = value;
+              rawNewIndices[indicesCursor++] = i;
+            }
+          }
+        }
+        rawSizes[row] = indicesCursor - rawOffsets[row];
+        return;
+      }
+
       for (vector_size_t i = offset; i < offset + size; ++i) {
         if (elements->isNullAt(i)) {
           if (!hasNulls) {
@@ -26,14 +26,42 @@ struct SetWithNull {
     set.reserve(initialSetSize);
   }
 
-  void reset() {
+  // Clears the set. If at most 'maxSize' values will be inserted and that is
+  // no more than kMaxLinearSearchSize, the values are kept in 'values' and
+  // searched linearly, which is faster than hashing for small arrays.
+  void reset(
+      vector_size_t maxSize = std::numeric_limits<vector_size_t>::max()) {
     set.clear();
+    values.clear();
+    useValues = maxSize <= kMaxLinearSearchSize;
     hasNull = false;
   }
 
+  bool contains(const T& value) const {
+    if (useValues) {
+      return std::find(values.begin(), values.end(), value) != values.end();
+    }
+    return set.count(value) > 0;
+  }
+
+  // Returns true if 'value' was not in the set before.
+  bool insert(const T& value) {
+    if (useValues) {
+      if (contains(value)) {
+        return false;
+      }
+      values.push_back(value);
+      return true;
+    }
+    return set.insert(value).second;
+  }
+
   folly::F14FastSet<T> set;
+  std::vector<T> values;
+  bool useValues{false};
   bool hasNull{false};
   static constexpr vector_size_t kInitialSetSize{128};
+  static constexpr vector_size_t kMaxLinearSearchSize{16};
 };
 // Generates a set based on the elements of an ArrayVector. Note that we take
 // rightSet as a parameter (instead of returning a new one) to reuse the
@@ -46,7 +74,7 @@ void generateSet(
     SetWithNull<T>& rightSet) {
   auto size = arrayVector->sizeAt(idx);
   auto offset = arrayVector->offsetAt(idx);
-  rightSet.reset();
+  rightSet.reset(size);
 
   for (vector_size_t i = offset; i < (offset + size); ++i) {
     if (arrayElements->isNullAt(i)) {
@@ -55,9 +83,9 @@ void generateSet(
       // Function can be called with either FlatVector or DecodedVector, but
       // their APIs are slightly different.
       if constexpr (std::is_same_v<TVector, DecodedVector>) {
-        rightSet.set.insert(arrayElements->template valueAt<T>(i));
+        rightSet.insert(arrayElements->template valueAt<T>(i));
       } else {
-        rightSet.set.insert(arrayElements->valueAt(i));
+        rightSet.insert(arrayElements->valueAt(i));
       }
     }
   }
@@ -166,7 +194,7 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
       auto size = baseLeftArray->sizeAt(idx);
       auto offset = baseLeftArray->offsetAt(idx);
 
-      outputSet.reset();
+      outputSet.reset(size);
       rawNewOffsets[row] = indicesCursor;
 
       // Scans the array elements on the left-hand side.
@@ -194,15 +222,12 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
           // (check outputSet).
           bool addValue = false;
           if constexpr (isIntersect) {
-            addValue = rightSet.set.count(val) > 0;
+            addValue = rightSet.contains(val);
           } else {
-            addValue = rightSet.set.count(val) == 0;
+            addValue = !rightSet.contains(val);
           }
-          if (addValue) {
-            auto it = outputSet.set.insert(val);
-            if (it.second) {
-              rawNewIndices[indicesCursor++] = i;
-            }
+          if (addValue && outputSet.insert(val)) {
+            rawNewIndices[indicesCursor++] = i;
           }
         }
       }
@@ -227,9 +252,15 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
           decodeArrayElements(rightHolder, rightElementsHolder, rows);
       SetWithNull<T> rightSet;
       auto rightArrayVector = rightHolder.get()->base()->as<ArrayVector>();
+      // The set is reused for consecutive rows with the same right-hand side
+      // array, e.g. a dictionary or constant encoded one.
+      vector_size_t rightSetIdx = -1;
       rows.applyToSelected([&](vector_size_t row) {
         auto idx = rightHolder.get()->index(row);
-        generateSet<T>(rightArrayVector, decodedRightElements, idx, rightSet);
+        if (idx != rightSetIdx) {
+          generateSet<T>(rightArrayVector, decodedRightElements, idx, rightSet);
+          rightSetIdx = idx;
+        }
         processRow(row, rightSet, outputSet);
       });
     }
@@ -292,7 +323,7 @@ class ArraysOverlapFunction : public exec::VectorFunction {
           hasNull = true;
           continue;
         }
-        if (rightSet.set.count(decodedLeftElements->valueAt<T>(i)) > 0) {
+        if (rightSet.contains(decodedLeftElements->valueAt<T>(i))) {
           // Found an overlapping element. Add to result set.
           resultBoolVector->set(row, true);
           return;
@@ -320,9 +351,13 @@ class ArraysOverlapFunction : public exec::VectorFunction {
           decodeArrayElements(rightDecoder, rightElementsDecoder, rows);
       SetWithNull<T> rightSet;
       auto baseRightArray = rightDecoder.get()->base()->as<ArrayVector>();
+      vector_size_t rightSetIdx = -1;
       rows.applyToSelected([&](vector_size_t row) {
         auto idx = rightDecoder.get()->index(row);
-        generateSet<T>(baseRightArray, decodedRightElements, idx, rightSet);
+        if (idx != rightSetIdx) {
+          generateSet<T>(baseRightArray, decodedRightElements, idx, rightSet);
+          rightSetIdx = idx;
+        }
         processRow(row, rightSet);
       });
     }
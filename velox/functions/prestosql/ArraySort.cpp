@@ -15,6 +15,7 @@
  */
 
 #include <folly/container/F14Set.h>
+#include <array>
 
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
@@ -88,6 +89,77 @@ inline void swapWithNull(
   vector->setNull(index, true);
 }
 
+// Arrays of at most this many elements are sorted with insertion sort.
+constexpr vector_size_t kMaxInsertionSortSize = 16;
+
+// Arrays of integers of at least this many elements are sorted with radix
+// sort.
+constexpr vector_size_t kMinRadixSortSize = 256;
+
+// Sorts the integers in [begin, end) with LSD radix sort on one byte at a time,
+// using 'scratch' as the temporary buffer. The sign bit is flipped so that
+// negative values sort first. Passes in which all values have the same byte
+// are skipped.
+template <typename T>
+void radixSort(T* begin, T* end, std::vector<T>& scratch) {
+  using U = std::make_unsigned_t<T>;
+  constexpr U kSignBit = U(1) << (sizeof(T) * 8 - 1);
+  const auto size = end - begin;
+  scratch.resize(size);
+  T* from = begin;
+  T* to = scratch.data();
+  for (size_t byte = 0; byte < sizeof(T); ++byte) {
+    const auto shift = byte * 8;
+    std::array<vector_size_t, 256> counts{};
+    for (auto i = 0; i < size; ++i) {
+      ++counts[((static_cast<U>(from[i]) ^ kSignBit) >> shift) & 0xFF];
+    }
+    if (counts[((static_cast<U>(from[0]) ^ kSignBit) >> shift) & 0xFF] ==
+        size) {
+      continue;
+    }
+    vector_size_t offset = 0;
+    for (auto& count : counts) {
+      const auto numValues = count;
+      count = offset;
+      offset += numValues;
+    }
+    for (auto i = 0; i < size; ++i) {
+      to[counts[((static_cast<U>(from[i]) ^ kSignBit) >> shift) & 0xFF]++] =
+          from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != begin) {
+    std::copy(from, from + size, begin);
+  }
+}
+
+// Sorts the non-null values of one array in place. 'scratch' is reused across
+// arrays for radix sort.
+template <typename T>
+void sortValues(T* begin, T* end, std::vector<T>& scratch) {
+  const auto size = end - begin;
+  if (size <= kMaxInsertionSortSize) {
+    for (auto* current = begin + 1; current < end; ++current) {
+      const T value = *current;
+      auto* position = current;
+      for (; position > begin && value < *(position - 1); --position) {
+        *position = *(position - 1);
+      }
+      *position = value;
+    }
+    return;
+  }
+  if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    if (size >= kMinRadixSortSize) {
+      radixSort(begin, end, scratch);
+      return;
+    }
+  }
+  std::sort(begin, end);
+}
+
 template <TypeKind kind>
 void applyScalarType(
     const SelectivityVector& rows,
@@ -112,19 +184,24 @@ void applyScalarType(
       inputElements.get(), inputElementRows, /*toSourceRow=*/nullptr);
 
   auto flatResults = resultElements->asFlatVector<T>();
+  const bool mayHaveNulls = flatResults->mayHaveNulls();
+  std::vector<T> scratch;
 
   auto processRow = [&](vector_size_t row) {
     const auto size = inputArray->sizeAt(row);
     const auto offset = inputArray->offsetAt(row);
-    if (size == 0) {
+    if (size <= 1) {
       return;
     }
     vector_size_t numNulls = 0;
     // Move nulls to end of array.
-    for (vector_size_t i = size - 1; i >= 0; --i) {
-      if (flatResults->isNullAt(offset + i)) {
-        swapWithNull<T>(flatResults, offset + size - numNulls - 1, offset + i);
-        ++numNulls;
+    if (mayHaveNulls) {
+      for (vector_size_t i = size - 1; i >= 0; --i) {
+        if (flatResults->isNullAt(offset + i)) {
+          swapWithNull<T>(
+              flatResults, offset + size - numNulls - 1, offset + i);
+          ++numNulls;
+        }
       }
     }
     // Exclude null values while sorting.
@@ -139,7 +216,7 @@ void applyScalarType(
       bits::fillBits(rawBits, endZeroRow, endRow, bits::kNotNull);
     } else {
       T* resultRawValues = flatResults->mutableRawValues();
-      std::sort(resultRawValues + startRow, resultRawValues + endRow);
+      sortValues(resultRawValues + startRow, resultRawValues + endRow, scratch);
     }
   };
   rows.applyToSelected(processRow);
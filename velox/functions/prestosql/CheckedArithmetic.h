@@ -19,6 +19,7 @@
 #include <limits>
 #include "CheckedArithmeticImpl.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/Status.h"
 #include "velox/functions/Macros.h"
 
 namespace facebook::velox::functions {
@@ -52,19 +53,37 @@ struct CheckedMultiplyFunction {
 
 template <typename T>
 struct CheckedDivideFunction {
+  // Reports errors with a Status instead of throwing to make TRY(a / b) cheap
+  // when many rows divide by zero. Same errors as checkedDivide().
   template <typename TInput>
-  FOLLY_ALWAYS_INLINE void
+  FOLLY_ALWAYS_INLINE Status
   call(TInput& result, const TInput& a, const TInput& b) {
-    result = checkedDivide(a, b);
+    if (UNLIKELY(b == 0)) {
+      return Status::UserError(
+          "division by zero", error_code::kArithmeticError.c_str());
+    }
+    if (UNLIKELY(a == std::numeric_limits<TInput>::min() && b == -1)) {
+      return Status::UserError(
+          fmt::format("integer overflow: {} / {}", a, b),
+          error_code::kArithmeticError.c_str());
+    }
+    result = a / b;
+    return Status::OK();
   }
 };
 
 template <typename T>
 struct CheckedModulusFunction {
+  // Same errors as checkedModulus(), reported without throwing.
   template <typename TInput>
-  FOLLY_ALWAYS_INLINE void
+  FOLLY_ALWAYS_INLINE Status
   call(TInput& result, const TInput& a, const TInput& b) {
+    if (UNLIKELY(b == 0)) {
+      return Status::UserError(
+          "Cannot divide by 0", error_code::kArithmeticError.c_str());
+    }
     result = checkedModulus(a, b);
+    return Status::OK();
   }
 };
 
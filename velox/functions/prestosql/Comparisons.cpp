@@ -25,8 +25,11 @@ namespace {
 
 /// This class implements comparison for vectors of primitive types using SIMD.
 /// Currently this only supports fixed length primitive types (except Boolean).
-/// It also requires the vectors to have a flat encoding.
-/// If the vector encoding is not flat, we revert to non simd approach.
+/// It also requires the vectors to have a flat or constant encoding. If the
+/// vector encoding is not flat, we revert to non simd approach. Rows that are
+/// not selected, e.g. because one of the inputs is null, do not disable SIMD.
+/// The whole range of rows is compared 64 rows at a time and the result bits
+/// are merged with the selected rows a word at a time.
 template <typename ComparisonOp, typename Arch = xsimd::default_arch>
 struct SimdComparator {
   template <typename T, bool isConstant>
@@ -40,57 +43,44 @@ struct SimdComparator {
 
   template <typename T, bool isLeftConstant, bool isRightConstant>
   void applySimdComparison(
-      const vector_size_t begin,
-      const vector_size_t end,
+      const SelectivityVector& rows,
       const T* rawLhs,
       const T* rawRhs,
-      uint8_t* rawResult) {
+      uint64_t* rawResult) {
     using d_type = xsimd::batch<T>;
     constexpr auto numScalarElements = d_type::size;
-    const auto vectorEnd = (end - begin) - (end - begin) % numScalarElements;
-
-    if constexpr (numScalarElements == 2 || numScalarElements == 4) {
-      for (auto i = begin; i < vectorEnd; i += 8) {
-        rawResult[i / 8] = 0;
-        for (auto j = 0; j < 8 && j < vectorEnd; j += numScalarElements) {
-          auto left = loadSimdData<T, isLeftConstant>(rawLhs, i + j);
-          auto right = loadSimdData<T, isRightConstant>(rawRhs, i + j);
-
-          uint8_t res = simd::toBitMask(ComparisonOp()(left, right));
-          rawResult[i / 8] |= res << j;
-        }
+    static_assert(64 % numScalarElements == 0);
+
+    const bool allSelected = rows.isAllSelected();
+    const auto* selectedBits = rows.asRange().bits();
+    const auto wordsEnd = bits::roundDown(rows.end(), 64);
+    for (auto i = bits::roundDown(rows.begin(), 64); i < wordsEnd; i += 64) {
+      uint64_t word = 0;
+      for (auto j = 0; j < 64; j += numScalarElements) {
+        auto left = loadSimdData<T, isLeftConstant>(rawLhs, i + j);
+        auto right = loadSimdData<T, isRightConstant>(rawRhs, i + j);
+        auto mask = simd::toBitMask(ComparisonOp()(left, right));
+        word |= static_cast<uint64_t>(
+                    static_cast<std::make_unsigned_t<decltype(mask)>>(mask))
+            << j;
       }
-    } else {
-      for (auto i = begin; i < vectorEnd; i += numScalarElements) {
-        auto left = loadSimdData<T, isLeftConstant>(rawLhs, i);
-        auto right = loadSimdData<T, isRightConstant>(rawRhs, i);
-
-        auto res = simd::toBitMask(ComparisonOp()(left, right));
-        if constexpr (numScalarElements == 8) {
-          rawResult[i / 8] = res;
-        } else if constexpr (numScalarElements == 16) {
-          uint16_t* addr = reinterpret_cast<uint16_t*>(rawResult + i / 8);
-          *addr = res;
-        } else if constexpr (numScalarElements == 32) {
-          uint32_t* addr = reinterpret_cast<uint32_t*>(rawResult + i / 8);
-          *addr = res;
-        } else {
-          VELOX_FAIL("Unsupported number of scalar elements");
-        }
+      const auto index = i / 64;
+      if (allSelected) {
+        rawResult[index] = word;
+      } else {
+        rawResult[index] = (rawResult[index] & ~selectedBits[index]) |
+            (word & selectedBits[index]);
       }
     }
 
     // Evaluate remaining values.
-    for (auto i = vectorEnd; i < end; i++) {
-      if constexpr (isRightConstant && isLeftConstant) {
-        bits::setBit(rawResult, i, ComparisonOp()(rawLhs[0], rawRhs[0]));
-      } else if constexpr (isRightConstant) {
-        bits::setBit(rawResult, i, ComparisonOp()(rawLhs[i], rawRhs[0]));
-      } else if constexpr (isLeftConstant) {
-        bits::setBit(rawResult, i, ComparisonOp()(rawLhs[0], rawRhs[i]));
-      } else {
-        bits::setBit(rawResult, i, ComparisonOp()(rawLhs[i], rawRhs[i]));
+    for (auto i = std::max(wordsEnd, rows.begin()); i < rows.end(); i++) {
+      if (!allSelected && !bits::isBitSet(selectedBits, i)) {
+        continue;
       }
+      const auto& left = isLeftConstant ? rawLhs[0] : rawLhs[i];
+      const auto& right = isRightConstant ? rawRhs[0] : rawRhs[i];
+      bits::setBit(rawResult, i, ComparisonOp()(left, right));
     }
   }
 
@@ -110,11 +100,10 @@ struct SimdComparator {
     using T = typename TypeTraits<kind>::NativeType;
 
     auto resultVector = result->asUnchecked<FlatVector<bool>>();
-    auto rawResult = resultVector->mutableRawValues<uint8_t>();
+    auto rawResult = resultVector->mutableRawValues<uint64_t>();
 
     auto isSimdizable = (lhs.isConstantEncoding() || lhs.isFlatEncoding()) &&
-        (rhs.isConstantEncoding() || rhs.isFlatEncoding()) &&
-        rows.isAllSelected();
+        (rhs.isConstantEncoding() || rhs.isFlatEncoding());
 
     if (!isSimdizable) {
       exec::LocalDecodedVector lhsDecoded(context, lhs, rows);
@@ -132,23 +121,19 @@ struct SimdComparator {
     if (lhs.isConstantEncoding() && rhs.isConstantEncoding()) {
       auto l = lhs.asUnchecked<ConstantVector<T>>()->valueAt(0);
       auto r = rhs.asUnchecked<ConstantVector<T>>()->valueAt(0);
-      applySimdComparison<T, true, true>(
-          rows.begin(), rows.end(), &l, &r, rawResult);
+      applySimdComparison<T, true, true>(rows, &l, &r, rawResult);
     } else if (lhs.isConstantEncoding()) {
       auto l = lhs.asUnchecked<ConstantVector<T>>()->valueAt(0);
       auto rawRhs = rhs.asUnchecked<FlatVector<T>>()->rawValues();
-      applySimdComparison<T, true, false>(
-          rows.begin(), rows.end(), &l, rawRhs, rawResult);
+      applySimdComparison<T, true, false>(rows, &l, rawRhs, rawResult);
     } else if (rhs.isConstantEncoding()) {
       auto rawLhs = lhs.asUnchecked<FlatVector<T>>()->rawValues();
       auto r = rhs.asUnchecked<ConstantVector<T>>()->valueAt(0);
-      applySimdComparison<T, false, true>(
-          rows.begin(), rows.end(), rawLhs, &r, rawResult);
+      applySimdComparison<T, false, true>(rows, rawLhs, &r, rawResult);
     } else {
       auto rawLhs = lhs.asUnchecked<FlatVector<T>>()->rawValues();
       auto rawRhs = rhs.asUnchecked<FlatVector<T>>()->rawValues();
-      applySimdComparison<T, false, false>(
-          rows.begin(), rows.end(), rawLhs, rawRhs, rawResult);
+      applySimdComparison<T, false, false>(rows, rawLhs, rawRhs, rawResult);
     }
 
     resultVector->clearNulls(rows);
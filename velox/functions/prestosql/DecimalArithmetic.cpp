@@ -161,16 +161,20 @@ class Addition {
 #endif
 #endif
   {
-    int128_t aRescaled;
-    int128_t bRescaled;
-    if (__builtin_mul_overflow(
-            a.unscaledValue(),
-            DecimalUtil::kPowersOfTen[aRescale],
-            &aRescaled) ||
-        __builtin_mul_overflow(
-            b.unscaledValue(),
-            DecimalUtil::kPowersOfTen[bRescale],
-            &bRescaled)) {
+    // At most one side is rescaled, none if the scales are the same. The
+    // 128 bit multiplication with overflow check is skipped when not needed.
+    int128_t aRescaled = a.unscaledValue();
+    int128_t bRescaled = b.unscaledValue();
+    if ((aRescale != 0 &&
+         __builtin_mul_overflow(
+             a.unscaledValue(),
+             DecimalUtil::kPowersOfTen[aRescale],
+             &aRescaled)) ||
+        (bRescale != 0 &&
+         __builtin_mul_overflow(
+             b.unscaledValue(),
+             DecimalUtil::kPowersOfTen[bRescale],
+             &bRescaled))) {
       VELOX_ARITHMETIC_ERROR(
           "Decimal overflow: {} + {}", a.unscaledValue(), b.unscaledValue());
     }
@@ -207,16 +211,20 @@ class Subtraction {
 #endif
 #endif
   {
-    int128_t aRescaled;
-    int128_t bRescaled;
-    if (__builtin_mul_overflow(
-            a.unscaledValue(),
-            DecimalUtil::kPowersOfTen[aRescale],
-            &aRescaled) ||
-        __builtin_mul_overflow(
-            b.unscaledValue(),
-            DecimalUtil::kPowersOfTen[bRescale],
-            &bRescaled)) {
+    // At most one side is rescaled, none if the scales are the same. The
+    // 128 bit multiplication with overflow check is skipped when not needed.
+    int128_t aRescaled = a.unscaledValue();
+    int128_t bRescaled = b.unscaledValue();
+    if ((aRescale != 0 &&
+         __builtin_mul_overflow(
+             a.unscaledValue(),
+             DecimalUtil::kPowersOfTen[aRescale],
+             &aRescaled)) ||
+        (bRescale != 0 &&
+         __builtin_mul_overflow(
+             b.unscaledValue(),
+             DecimalUtil::kPowersOfTen[bRescale],
+             &bRescaled))) {
       VELOX_ARITHMETIC_ERROR(
           "Decimal overflow: {} - {}", a.unscaledValue(), b.unscaledValue());
     }
@@ -243,6 +251,24 @@ class Multiply {
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale) {
+    if constexpr (std::is_same_v<R, UnscaledLongDecimal>) {
+      const int128_t aValue = a.unscaledValue();
+      const int128_t bValue = b.unscaledValue();
+      if (aRescale + bRescale == 0 &&
+          aValue == static_cast<int64_t>(aValue) &&
+          bValue == static_cast<int64_t>(bValue)) {
+        // The product of two 64 bit values is at most 2^126 in magnitude,
+        // which is below 10^38. It neither overflows nor goes out of the
+        // range of a long decimal, so no 128 bit overflow check is needed.
+        r = R(static_cast<int128_t>(static_cast<int64_t>(aValue)) *
+              static_cast<int64_t>(bValue));
+        return;
+      }
+    }
+    if (aRescale + bRescale == 0) {
+      r = checkedMultiply<R>(R(a), R(b));
+      return;
+    }
     r = checkedMultiply<R>(
         checkedMultiply<R>(R(a), R(b)),
         R(DecimalUtil::kPowersOfTen[aRescale + bRescale]));
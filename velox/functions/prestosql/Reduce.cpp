@@ -19,35 +19,55 @@
 namespace facebook::velox::functions {
 namespace {
 
-/// Populates indices of the n-th elements of the arrays.
-/// Selects 'row' in 'arrayRows' if corresponding array has an n-th element.
-/// Sets elementIndices[row] to the index of the n-th element in the 'elements'
-/// vector.
+/// Selects the rows of 'rows' with non-empty arrays in 'arrayRows'. These are
+/// the arrays that have a 0-th element.
+void toNonEmptyArrayRows(
+    const ArrayVectorPtr& arrayVector,
+    const SelectivityVector& rows,
+    SelectivityVector& arrayRows) {
+  auto* rawSizes = arrayVector->rawSizes();
+  auto* rawNulls = arrayVector->rawNulls();
+
+  arrayRows.clearAll();
+  rows.applyToSelected([&](auto row) {
+    if ((!rawNulls || !bits::isBitNull(rawNulls, row)) && rawSizes[row] > 0) {
+      arrayRows.setValid(row, true);
+    }
+  });
+  arrayRows.updateBounds();
+}
+
+/// Populates indices of the n-th elements of the arrays. 'arrayRows' must
+/// select the arrays that have an (n-1)-th element. Moves the rows of the
+/// arrays that have no n-th element from 'arrayRows' to 'finishedRows', so
+/// each step only visits the arrays that are left. Sets elementIndices[row]
+/// to the index of the n-th element in the 'elements' vector for the rows
+/// left in 'arrayRows'. The other indices are left as they were, which keeps
+/// them valid.
 /// Returns true if at least one array has n-th element.
 bool toNthElementRows(
     const ArrayVectorPtr& arrayVector,
-    const SelectivityVector& rows,
     vector_size_t n,
     SelectivityVector& arrayRows,
+    SelectivityVector& finishedRows,
     BufferPtr& elementIndices) {
   auto* rawSizes = arrayVector->rawSizes();
   auto* rawOffsets = arrayVector->rawOffsets();
-  auto* rawNulls = arrayVector->rawNulls();
 
   auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
 
-  arrayRows.clearAll();
-  memset(rawElementIndices, 0, elementIndices->size());
-
-  rows.applyToSelected([&](auto row) {
-    if (!rawNulls || !bits::isBitNull(rawNulls, row)) {
-      if (n < rawSizes[row]) {
-        arrayRows.setValid(row, true);
-        rawElementIndices[row] = rawOffsets[row] + n;
-      }
+  finishedRows.clearAll();
+  arrayRows.applyToSelected([&](auto row) {
+    if (n < rawSizes[row]) {
+      rawElementIndices[row] = rawOffsets[row] + n;
+    } else {
+      finishedRows.setValid(row, true);
     }
   });
-  arrayRows.updateBounds();
+  finishedRows.updateBounds();
+  if (finishedRows.hasSelections()) {
+    arrayRows.deselect(finishedRows);
+  }
 
   return arrayRows.hasSelections();
 }
@@ -104,30 +124,41 @@ class ReduceFunction : public exec::VectorFunction {
     BufferPtr elementIndices =
         allocateIndices(flatArray->size(), context.pool());
     SelectivityVector arrayRows(flatArray->size(), false);
+    SelectivityVector finishedRows(flatArray->size(), false);
 
     // Iteratively apply input function to array elements.
     // First, apply input function to first elements of all arrays.
     // Then, apply input function to second elements of all arrays.
     // And so on until all elements of all arrays have been processed.
     // At each step the number of arrays being processed will get smaller as
-    // some arrays will run out of elements.
+    // some arrays will run out of elements. The state of an array is copied
+    // to 'partialResult' once, when the array runs out of elements.
     while (auto entry = inputFuncIt.next()) {
       VectorPtr state = initialState;
 
-      vector_size_t n = 0;
-      while (true) {
+      // The state of the step before the last one. Its rows are no longer
+      // needed, so it is reused for the result of the next step. This avoids
+      // allocating a vector and copying all rows of 'state' at each step, which
+      // writing the result into 'state' itself would do.
+      VectorPtr spareState;
+
+      toNonEmptyArrayRows(flatArray, *entry.rows, arrayRows);
+      for (vector_size_t n = 0;; ++n) {
         // 'state' might use the 'elementIndices', in that case we need to
         // reallocate them to avoid overwriting.
         if (not elementIndices->unique()) {
           elementIndices = allocateIndices(flatArray->size(), context.pool());
         }
 
-        // Sets arrayRows[row] to true if array at that row has n-th element, to
-        // false otherwise.
-        // Set elementIndices[row] to the index of the n-th element in the
-        // array's elements vector.
-        if (!toNthElementRows(
-                flatArray, *entry.rows, n, arrayRows, elementIndices)) {
+        // Keeps the rows of the arrays that have n-th element in 'arrayRows'
+        // and moves the others to 'finishedRows'. Sets elementIndices[row] to
+        // the index of the n-th element in the array's elements vector.
+        const bool hasNthElements = toNthElementRows(
+            flatArray, n, arrayRows, finishedRows, elementIndices);
+        if (finishedRows.hasSelections()) {
+          partialResult->copy(state.get(), finishedRows, nullptr);
+        }
+        if (!hasNthElements) {
           break; // Ran out of elements in all arrays.
         }
 
@@ -139,8 +170,9 @@ class ReduceFunction : public exec::VectorFunction {
             flatArray->elements());
 
         // Run input lambda on our dictionary - adding n-th element to the
-        // initial state for every row.
-        std::vector<VectorPtr> lambdaArgs = {state, dictNthElements};
+        // current state for every row.
+        std::vector<VectorPtr> lambdaArgs = {state, std::move(dictNthElements)};
+        VectorPtr newState = std::move(spareState);
         entry.callable->apply(
             arrayRows,
             finalSelectionRows,
@@ -148,9 +180,14 @@ class ReduceFunction : public exec::VectorFunction {
             &context,
             lambdaArgs,
             nullptr,
-            &partialResult);
-        state = partialResult;
-        n++;
+            &newState);
+        lambdaArgs.clear();
+
+        // 'initialState' is an input and must not be written to.
+        if (n > 0) {
+          spareState = std::move(state);
+        }
+        state = std::move(newState);
       }
     }
 
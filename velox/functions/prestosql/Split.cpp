@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/StringWriter.h"
@@ -201,7 +202,7 @@ class SplitFunction : public exec::VectorFunction {
 
     // Trivial case of converting string to array with 1 element.
     if (hasLimit and limit == 1) {
-      arrayWriter.add_item().setNoCopy(input);
+      arrayWriter.add_item_no_copy(input);
       resultWriter.commit();
       return;
     }
@@ -214,7 +215,8 @@ class SplitFunction : public exec::VectorFunction {
     const std::string_view sdelim(delim.data(), delim.size());
     while (true) {
       // Find the byte of the 1st delimiter.
-      auto byteIndex = sinput.find(sdelim, 0);
+      auto byteIndex = simd::findSubstring(
+          sinput.data(), sinput.size(), sdelim.data(), sdelim.size());
 
       // Special case for empty delimiters. Split character by character with an
       // empty string at the end.
@@ -228,7 +230,7 @@ class SplitFunction : public exec::VectorFunction {
       }
 
       // Add the new element, we've split
-      arrayWriter.add_item().setNoCopy(StringView(sinput.data(), byteIndex));
+      arrayWriter.add_item_no_copy(StringView(sinput.data(), byteIndex));
 
       // Advance input by the size of the element + delimiter.
       // Note: should we add 'advance' method?
@@ -247,7 +249,7 @@ class SplitFunction : public exec::VectorFunction {
 
     // Add the rest of the string and we are done.
     // Note, that the rest of the string can be empty - we still add it.
-    arrayWriter.add_item().setNoCopy(StringView(sinput.data(), sinput.size()));
+    arrayWriter.add_item_no_copy(StringView(sinput.data(), sinput.size()));
     resultWriter.commit();
   }
 };
@@ -19,38 +19,57 @@
 
 namespace facebook::velox::functions {
 
-bool matchAuthorityAndPath(
-    const boost::cmatch& urlMatch,
-    boost::cmatch& authAndPathMatch,
-    boost::cmatch& authorityMatch,
-    bool& hasAuthority) {
-  static const boost::regex kAuthorityAndPathRegex("//([^/]*)(/.*)?");
-  auto authorityAndPath = submatch(urlMatch, 2);
-  if (!boost::regex_match(
-          authorityAndPath.begin(),
-          authorityAndPath.end(),
-          authAndPathMatch,
-          kAuthorityAndPathRegex)) {
-    // Does not start with //, doesn't have authority.
-    hasAuthority = false;
+namespace {
+
+// Parses 'hostAndPort' of the form host[:port], where host is an IP-literal
+// in brackets (e.g. '['+IPv6+']'), a dotted IPv4 address or a host name, and
+// port is a possibly empty sequence of digits.
+bool parseHostAndPort(
+    const char* begin,
+    const char* end,
+    URLAuthority& result) {
+  const char* hostEnd;
+  if (begin < end && *begin == '[') {
+    hostEnd = static_cast<const char*>(memchr(begin, ']', end - begin));
+    if (hostEnd == nullptr) {
+      return false;
+    }
+    ++hostEnd;
+  } else {
+    hostEnd = begin;
+    while (hostEnd < end && *hostEnd != '[' && *hostEnd != ':') {
+      ++hostEnd;
+    }
+  }
+  result.host = StringView(begin, hostEnd - begin);
+  result.port = StringView();
+  if (hostEnd == end) {
     return true;
   }
-
-  static const boost::regex kAuthorityRegex(
-      "(?:([^@:]*)(?::([^@]*))?@)?" // username, password.
-      "(\\[[^\\]]*\\]|[^\\[:]*)" // host (IP-literal (e.g. '['+IPv6+']',
-      // dotted-IPv4, or named host).
-      "(?::(\\d*))?"); // port.
-
-  const auto authority = authAndPathMatch[1];
-  if (!boost::regex_match(
-          authority.first, authority.second, authorityMatch, kAuthorityRegex)) {
-    return false; // Invalid URI Authority.
+  if (*hostEnd != ':') {
+    return false;
+  }
+  for (auto p = hostEnd + 1; p < end; ++p) {
+    if (*p < '0' || *p > '9') {
+      return false;
+    }
   }
+  result.port = StringView(hostEnd + 1, end - hostEnd - 1);
+  return true;
+}
 
-  hasAuthority = true;
+} // namespace
 
-  return true;
+bool parseAuthority(StringView authority, URLAuthority& result) {
+  const char* begin = authority.data();
+  const char* end = begin + authority.size();
+  // The user info ends at the first '@'. If the rest is not a valid host and
+  // port, the '@' may still be part of the host name.
+  const char* at = static_cast<const char*>(memchr(begin, '@', end - begin));
+  if (at != nullptr && parseHostAndPort(at + 1, end, result)) {
+    return true;
+  }
+  return parseHostAndPort(begin, end, result);
 }
 
 } // namespace facebook::velox::functions
@@ -17,26 +17,82 @@
 
 #include <boost/regex.hpp>
 #include <cctype>
+#include <cstring>
+#include <string_view>
 #include "velox/functions/Macros.h"
 
 namespace facebook::velox::functions {
 
+/// The components of a URL as views into the URL string.
+struct URLComponents {
+  StringView scheme;
+  StringView authorityAndPath;
+  StringView query;
+  StringView fragment;
+};
+
+/// The host and the port of the authority [userinfo@]host[:port] of a URL as
+/// views into the URL string.
+struct URLAuthority {
+  StringView host;
+  StringView port;
+};
+
 namespace {
 FOLLY_ALWAYS_INLINE StringView submatch(const boost::cmatch& match, int idx) {
   const auto& sub = match[idx];
   return StringView(sub.first, sub.length());
 }
 
+FOLLY_ALWAYS_INLINE bool isSchemeStart(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+FOLLY_ALWAYS_INLINE bool isSchemeChar(char c) {
+  return isSchemeStart(c) || (c >= '0' && c <= '9') || c == '+' || c == '.' ||
+      c == '-';
+}
+
+/// Splits 'rawUrl' of the form scheme:authority-and-path[?query][#fragment]
+/// into its components in a single pass. The components point into
+/// 'rawUrl'. The ones missing from the URL are left empty. Returns false if
+/// 'rawUrl' does not start with a valid scheme followed by ':'.
 template <typename TInString>
-bool parse(const TInString& rawUrl, boost::cmatch& match) {
-  static const boost::regex kUriRegex(
-      "([a-zA-Z][a-zA-Z0-9+.-]*):" // scheme:
-      "([^?#]*)" // authority and path
-      "(?:\\?([^#]*))?" // ?query
-      "(?:#(.*))?"); // #fragment
-
-  return boost::regex_match(
-      rawUrl.data(), rawUrl.data() + rawUrl.size(), match, kUriRegex);
+FOLLY_ALWAYS_INLINE bool parse(const TInString& rawUrl, URLComponents& url) {
+  const char* data = rawUrl.data();
+  const size_t size = rawUrl.size();
+  if (size == 0 || !isSchemeStart(data[0])) {
+    return false;
+  }
+  size_t schemeEnd = 1;
+  while (schemeEnd < size && isSchemeChar(data[schemeEnd])) {
+    ++schemeEnd;
+  }
+  if (schemeEnd == size || data[schemeEnd] != ':') {
+    return false;
+  }
+  url.scheme = StringView(data, schemeEnd);
+
+  const std::string_view rest(data + schemeEnd + 1, size - schemeEnd - 1);
+  const auto pathEnd = rest.find_first_of("?#");
+  url.authorityAndPath = StringView(
+      rest.data(), pathEnd == std::string_view::npos ? rest.size() : pathEnd);
+  if (pathEnd == std::string_view::npos) {
+    return true;
+  }
+
+  auto fragmentStart = pathEnd;
+  if (rest[pathEnd] == '?') {
+    fragmentStart = rest.find('#', pathEnd + 1);
+    const auto queryEnd =
+        fragmentStart == std::string_view::npos ? rest.size() : fragmentStart;
+    url.query = StringView(rest.data() + pathEnd + 1, queryEnd - pathEnd - 1);
+  }
+  if (fragmentStart != std::string_view::npos) {
+    url.fragment = StringView(
+        rest.data() + fragmentStart + 1, rest.size() - fragmentStart - 1);
+  }
+  return true;
 }
 
 FOLLY_ALWAYS_INLINE unsigned char toHex(unsigned char c) {
@@ -124,11 +180,31 @@ FOLLY_ALWAYS_INLINE void urlUnescape(
 
 } // namespace
 
-bool matchAuthorityAndPath(
-    const boost::cmatch& urlMatch,
-    boost::cmatch& authAndPathMatch,
-    boost::cmatch& authorityMatch,
-    bool& hasAuthority);
+/// Splits the 'authorityAndPath' component of a URL of the form
+/// //authority[/path] into 'authority' and 'path'. Returns false if the URL
+/// has no authority, i.e. 'authorityAndPath' does not start with '//'.
+FOLLY_ALWAYS_INLINE bool splitAuthorityAndPath(
+    StringView authorityAndPath,
+    StringView& authority,
+    StringView& path) {
+  const char* data = authorityAndPath.data();
+  const size_t size = authorityAndPath.size();
+  if (size < 2 || data[0] != '/' || data[1] != '/') {
+    return false;
+  }
+  const char* authorityEnd =
+      static_cast<const char*>(memchr(data + 2, '/', size - 2));
+  if (authorityEnd == nullptr) {
+    authorityEnd = data + size;
+  }
+  authority = StringView(data + 2, authorityEnd - data - 2);
+  path = StringView(authorityEnd, data + size - authorityEnd);
+  return true;
+}
+
+/// Parses the host and the port of 'authority'. Returns false if 'authority'
+/// is not valid.
+bool parseAuthority(StringView authority, URLAuthority& result);
 
 template <typename T>
 struct UrlExtractProtocolFunction {
@@ -143,11 +219,11 @@ struct UrlExtractProtocolFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    URLComponents components;
+    if (!parse(url, components)) {
       result.setEmpty();
     } else {
-      result.setNoCopy(submatch(match, 1));
+      result.setNoCopy(components.scheme);
     }
     return true;
   }
@@ -166,11 +242,11 @@ struct UrlExtractFragmentFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    URLComponents components;
+    if (!parse(url, components)) {
       result.setEmpty();
     } else {
-      result.setNoCopy(submatch(match, 4));
+      result.setNoCopy(components.fragment);
     }
     return true;
   }
@@ -189,19 +265,14 @@ struct UrlExtractHostFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-      return true;
-    }
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
-        hasAuthority) {
-      result.setNoCopy(submatch(authorityMatch, 3));
+    URLComponents components;
+    StringView authority;
+    StringView path;
+    URLAuthority parsedAuthority;
+    if (parse(url, components) &&
+        splitAuthorityAndPath(components.authorityAndPath, authority, path) &&
+        parseAuthority(authority, parsedAuthority)) {
+      result.setNoCopy(parsedAuthority.host);
     } else {
       result.setEmpty();
     }
@@ -214,18 +285,14 @@ struct UrlExtractPortFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
   FOLLY_ALWAYS_INLINE bool call(int64_t& result, const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      return false;
-    }
-
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
-        hasAuthority) {
-      auto port = submatch(authorityMatch, 4);
+    URLComponents components;
+    StringView authority;
+    StringView path;
+    URLAuthority parsedAuthority;
+    if (parse(url, components) &&
+        splitAuthorityAndPath(components.authorityAndPath, authority, path) &&
+        parseAuthority(authority, parsedAuthority)) {
+      const auto& port = parsedAuthority.port;
       if (!port.empty()) {
         try {
           result = to<int64_t>(port);
@@ -251,22 +318,20 @@ struct UrlExtractPathFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    URLComponents components;
+    if (!parse(url, components)) {
       result.setEmpty();
       return true;
     }
 
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority)) {
-      if (hasAuthority) {
-        result.setNoCopy(submatch(authAndPathMatch, 2));
-      } else {
-        result.setNoCopy(submatch(match, 2));
+    StringView authority;
+    StringView path;
+    if (!splitAuthorityAndPath(components.authorityAndPath, authority, path)) {
+      result.setNoCopy(components.authorityAndPath);
+    } else {
+      URLAuthority parsedAuthority;
+      if (parseAuthority(authority, parsedAuthority)) {
+        result.setNoCopy(path);
       }
     }
 
@@ -287,14 +352,13 @@ struct UrlExtractQueryFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    URLComponents components;
+    if (!parse(url, components)) {
       result.setEmpty();
       return true;
     }
 
-    auto query = submatch(match, 3);
-    result.setNoCopy(query);
+    result.setNoCopy(components.query);
     return true;
   }
 };
@@ -313,13 +377,13 @@ struct UrlExtractParameterFunction {
       out_type<Varchar>& result,
       const arg_type<Varchar>& url,
       const arg_type<Varchar>& param) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    URLComponents components;
+    if (!parse(url, components)) {
       result.setEmpty();
       return false;
     }
 
-    auto query = submatch(match, 3);
+    const auto& query = components.query;
     if (!query.empty()) {
       // Parse query string.
       static const boost::regex kQueryParamRegex(
@@ -201,6 +201,7 @@ class ApproxDistinctAggregate : public exec::Aggregate {
       addIntermediateResults(groups, rows, args, false /*unused*/);
     } else {
       decodeArguments(rows, args);
+      hashValues(rows);
 
       rows.applyToSelected([&](auto row) {
         if (decodedValue_.isNullAt(row)) {
@@ -212,9 +213,7 @@ class ApproxDistinctAggregate : public exec::Aggregate {
         auto accumulator = value<HllAccumulator>(group);
         clearNull(group);
         accumulator->setIndexBitLength(indexBitLength_);
-
-        auto hash = hashOne(decodedValue_.valueAt<T>(row));
-        accumulator->append(hash);
+        accumulator->append(hashAt(row));
       });
     }
   }
@@ -252,18 +251,27 @@ class ApproxDistinctAggregate : public exec::Aggregate {
       addSingleGroupIntermediateResults(group, rows, args, false /*unused*/);
     } else {
       decodeArguments(rows, args);
+      if (decodedValue_.isConstantMapping()) {
+        // Inserting the same hash again does not change the HLL.
+        if (!decodedValue_.isNullAt(rows.begin())) {
+          auto accumulator = value<HllAccumulator>(group);
+          clearNull(group);
+          accumulator->setIndexBitLength(indexBitLength_);
+          accumulator->append(hashOne(decodedValue_.valueAt<T>(rows.begin())));
+        }
+        return;
+      }
+      hashValues(rows);
 
+      auto accumulator = value<HllAccumulator>(group);
+      accumulator->setIndexBitLength(indexBitLength_);
       rows.applyToSelected([&](auto row) {
         if (decodedValue_.isNullAt(row)) {
           return;
         }
 
-        auto accumulator = value<HllAccumulator>(group);
         clearNull(group);
-        accumulator->setIndexBitLength(indexBitLength_);
-
-        auto hash = hashOne(decodedValue_.valueAt<T>(row));
-        accumulator->append(hash);
+        accumulator->append(hashAt(row));
       });
     }
   }
@@ -341,6 +349,47 @@ class ApproxDistinctAggregate : public exec::Aggregate {
     }
   }
 
+  // Hashes the non-null values of 'decodedValue_' in 'rows' before they are
+  // routed to the groups. A constant is hashed once. Dictionary encoded
+  // values are hashed once per base value when there are fewer base values
+  // than rows. hashAt(row) returns the hash of 'row'.
+  void hashValues(const SelectivityVector& rows) {
+    hashBaseValues_ = false;
+    if (decodedValue_.isConstantMapping()) {
+      hashes_.resize(1);
+      if (!decodedValue_.isNullAt(rows.begin())) {
+        hashes_[0] = hashOne(decodedValue_.valueAt<T>(rows.begin()));
+      }
+      return;
+    }
+    if (!decodedValue_.isIdentityMapping()) {
+      auto base = decodedValue_.base()->as<SimpleVector<T>>();
+      if (base && base->size() < rows.countSelected()) {
+        hashes_.resize(base->size());
+        for (auto i = 0; i < base->size(); ++i) {
+          if (!base->isNullAt(i)) {
+            hashes_[i] = hashOne(base->valueAt(i));
+          }
+        }
+        hashBaseValues_ = true;
+        return;
+      }
+    }
+    hashes_.resize(rows.end());
+    rows.applyToSelected([&](auto row) {
+      if (!decodedValue_.isNullAt(row)) {
+        hashes_[row] = hashOne(decodedValue_.valueAt<T>(row));
+      }
+    });
+  }
+
+  uint64_t hashAt(vector_size_t row) const {
+    if (decodedValue_.isConstantMapping()) {
+      return hashes_[0];
+    }
+    return hashes_[hashBaseValues_ ? decodedValue_.index(row) : row];
+  }
+
   void checkSetMaxStandardError() {
     VELOX_USER_CHECK(
         decodedMaxStandardError_.isConstantMapping(),
@@ -378,6 +427,11 @@ class ApproxDistinctAggregate : public exec::Aggregate {
   DecodedVector decodedValue_;
   DecodedVector decodedMaxStandardError_;
   DecodedVector decodedHll_;
+
+  // Hashes of the input values. Indexed by row, or by the index in the base
+  // vector if 'hashBaseValues_' is true.
+  std::vector<uint64_t> hashes_;
+  bool hashBaseValues_{false};
 };
 
 template <TypeKind kind>
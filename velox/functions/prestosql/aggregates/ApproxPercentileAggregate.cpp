@@ -31,78 +31,191 @@ namespace {
 template <typename T>
 using KllSketch = functions::kll::KllSketch<T, StlAllocator<T>>;
 
-// Accumulator to buffer large count values in addition to the KLL
-// sketch itself.
+// Accumulator of the values of one group. Up to kMaxExactValues values are
+// kept exactly in the accumulator itself, so that small groups need neither
+// a KLL sketch nor any allocation. Once a group has more values, they are
+// moved to a KLL sketch allocated from the HashStringAllocator, together with
+// a buffer of large count values.
 template <typename T>
 struct KllSketchAccumulator {
-  explicit KllSketchAccumulator(HashStringAllocator* allocator)
-      : allocator_(allocator),
-        sketch_(
-            functions::kll::kDefaultK,
-            StlAllocator<T>(allocator),
-            random::getSeed()),
-        largeCountValues_(StlAllocator<std::pair<T, int64_t>>(allocator)) {}
+  using View = typename KllSketch<T>::View;
+
+  static constexpr int32_t kMaxExactValues = 48 / sizeof(T);
 
   void setAccuracy(double value) {
     k_ = functions::kll::kFromEpsilon(value);
-    sketch_.setK(k_);
+    if (sketch_) {
+      sketch_->sketch.setK(k_);
+    }
   }
 
-  void append(T value) {
-    sketch_.insert(value);
+  void append(T value, HashStringAllocator* allocator) {
+    if (!sketch_) {
+      if (numExact_ < kMaxExactValues) {
+        exact_[numExact_++] = value;
+        return;
+      }
+      makeSketch(allocator);
+    }
+    sketch_->sketch.insert(value);
   }
 
-  void append(T value, int64_t count) {
-    constexpr size_t kMaxBufferSize = 4096;
-    constexpr int64_t kMinCountToBuffer = 512;
-    if (count < kMinCountToBuffer) {
-      for (int i = 0; i < count; ++i) {
-        sketch_.insert(value);
+  void append(T value, int64_t count, HashStringAllocator* allocator) {
+    if (!sketch_) {
+      if (numExact_ + count <= kMaxExactValues) {
+        std::fill(exact_ + numExact_, exact_ + numExact_ + count, value);
+        numExact_ += count;
+        return;
       }
-    } else {
-      largeCountValues_.emplace_back(value, count);
-      if (largeCountValues_.size() >= kMaxBufferSize) {
-        flush();
+      makeSketch(allocator);
+    }
+    sketch_->append(value, count, k_, allocator);
+  }
+
+  void append(const View& view, HashStringAllocator* allocator) {
+    append(folly::Range(&view, 1), allocator);
+  }
+
+  // Appends the views that fit to the exact values and merges the others
+  // into the sketch.
+  void append(folly::Range<const View*> views, HashStringAllocator* allocator) {
+    if (!sketch_) {
+      while (!views.empty() && appendExact(views.front())) {
+        views.advance(1);
       }
+      if (views.empty()) {
+        return;
+      }
+      makeSketch(allocator);
     }
+    sketch_->sketch.mergeViews(views);
   }
 
-  void append(const typename KllSketch<T>::View& view) {
-    sketch_.mergeViews(folly::Range(&view, 1));
+  void finalize(HashStringAllocator* allocator) {
+    if (sketch_) {
+      sketch_->finalize(k_, allocator);
+    } else {
+      std::sort(exact_, exact_ + numExact_);
+    }
   }
 
-  void append(const std::vector<typename KllSketch<T>::View>& views) {
-    sketch_.mergeViews(views);
+  size_t totalCount() const {
+    return sketch_ ? sketch_->sketch.totalCount() : numExact_;
   }
 
-  void finalize() {
-    if (!largeCountValues_.empty()) {
-      flush();
+  // Returns a view of the values after finalize(). 'levels' provides the
+  // storage for the levels of the exact values.
+  View toView(std::array<uint32_t, 2>& levels) const {
+    if (sketch_) {
+      return sketch_->sketch.toView();
     }
-    sketch_.compact();
+    levels = {0, numExact_};
+    return {
+        .k = k_,
+        .n = numExact_,
+        .minValue = numExact_ ? exact_[0] : T{},
+        .maxValue = numExact_ ? exact_[numExact_ - 1] : T{},
+        .items = {exact_, numExact_},
+        .levels = {levels.data(), levels.size()},
+    };
   }
 
-  const KllSketch<T>& getSketch() const {
-    return sketch_;
+  // Estimates 'percentiles' after finalize().
+  template <typename Iter>
+  void estimateQuantiles(const folly::Range<Iter>& percentiles, T* out) const {
+    std::array<uint32_t, 2> levels;
+    toView(levels).estimateQuantiles(percentiles, out);
+  }
+
+  void destroy(HashStringAllocator* allocator) {
+    if (sketch_) {
+      sketch_->~Sketch();
+      StlAllocator<Sketch>(allocator).deallocate(sketch_, 1);
+      sketch_ = nullptr;
+    }
   }
 
  private:
-  uint16_t k_;
-  HashStringAllocator* allocator_;
-  KllSketch<T> sketch_;
-  std::vector<std::pair<T, int64_t>, StlAllocator<std::pair<T, int64_t>>>
-      largeCountValues_;
-
-  void flush() {
-    std::vector<KllSketch<T>> sketches;
-    sketches.reserve(largeCountValues_.size());
-    for (auto [x, n] : largeCountValues_) {
-      sketches.push_back(KllSketch<T>::fromRepeatedValue(
-          x, n, k_, StlAllocator<T>(allocator_), random::getSeed()));
-    }
-    sketch_.merge(folly::Range(sketches.begin(), sketches.end()));
-    largeCountValues_.clear();
+  // KLL sketch with a buffer of large count values.
+  struct Sketch {
+    Sketch(uint16_t k, HashStringAllocator* allocator)
+        : sketch(k, StlAllocator<T>(allocator), random::getSeed()),
+          largeCountValues(StlAllocator<std::pair<T, int64_t>>(allocator)) {}
+
+    void append(
+        T value,
+        int64_t count,
+        uint16_t k,
+        HashStringAllocator* allocator) {
+      constexpr size_t kMaxBufferSize = 4096;
+      constexpr int64_t kMinCountToBuffer = 512;
+      if (count < kMinCountToBuffer) {
+        for (int i = 0; i < count; ++i) {
+          sketch.insert(value);
+        }
+      } else {
+        largeCountValues.emplace_back(value, count);
+        if (largeCountValues.size() >= kMaxBufferSize) {
+          flush(k, allocator);
+        }
+      }
+    }
+
+    void finalize(uint16_t k, HashStringAllocator* allocator) {
+      if (!largeCountValues.empty()) {
+        flush(k, allocator);
+      }
+      sketch.compact();
+    }
+
+    void flush(uint16_t k, HashStringAllocator* allocator) {
+      std::vector<KllSketch<T>> sketches;
+      sketches.reserve(largeCountValues.size());
+      for (auto [x, n] : largeCountValues) {
+        sketches.push_back(KllSketch<T>::fromRepeatedValue(
+            x, n, k, StlAllocator<T>(allocator), random::getSeed()));
+      }
+      sketch.merge(folly::Range(sketches.begin(), sketches.end()));
+      largeCountValues.clear();
+    }
+
+    KllSketch<T> sketch;
+    std::vector<std::pair<T, int64_t>, StlAllocator<std::pair<T, int64_t>>>
+        largeCountValues;
+  };
+
+  // Copies the items of 'view' to the exact values if 'view' has only
+  // items of weight 1 and they fit. Returns false if not.
+  bool appendExact(const View& view) {
+    if (view.n == 0) {
+      return true;
+    }
+    if (view.numLevels() != 1 || view.levels[1] - view.levels[0] != view.n ||
+        numExact_ + view.n > kMaxExactValues) {
+      return false;
+    }
+    std::copy(
+        view.items.begin() + view.levels[0],
+        view.items.begin() + view.levels[1],
+        exact_ + numExact_);
+    numExact_ += view.n;
+    return true;
   }
+
+  // Moves the exact values to a new sketch.
+  void makeSketch(HashStringAllocator* allocator) {
+    sketch_ = new (StlAllocator<Sketch>(allocator).allocate(1))
+        Sketch(k_, allocator);
+    for (auto i = 0; i < numExact_; ++i) {
+      sketch_->sketch.insert(exact_[i]);
+    }
+    numExact_ = 0;
+  }
+
+  Sketch* sketch_{nullptr};
+  uint16_t k_{functions::kll::kDefaultK};
+  uint8_t numExact_{0};
+  T exact_[kMaxExactValues];
 };
 
 enum IntermediateTypeChildIndex {
@@ -152,13 +265,13 @@ class ApproxPercentileAggregate : public exec::Aggregate {
     exec::Aggregate::setAllNulls(groups, indices);
     for (auto i : indices) {
       auto group = groups[i];
-      new (group + offset_) KllSketchAccumulator<T>(allocator_);
+      new (group + offset_) KllSketchAccumulator<T>();
     }
   }
 
   void destroy(folly::Range<char**> groups) override {
     for (auto group : groups) {
-      value<KllSketchAccumulator<T>>(group)->~KllSketchAccumulator<T>();
+      value<KllSketchAccumulator<T>>(group)->destroy(allocator_);
     }
   }
 
@@ -175,7 +288,7 @@ class ApproxPercentileAggregate : public exec::Aggregate {
       for (auto i = 0; i < numGroups; ++i) {
         char* group = groups[i];
         auto accumulator = value<KllSketchAccumulator<T>>(group);
-        if (accumulator->getSketch().totalCount() > 0) {
+        if (accumulator->totalCount() > 0) {
           elementsCount += percentiles.size();
         }
       }
@@ -187,10 +300,11 @@ class ApproxPercentileAggregate : public exec::Aggregate {
           groups,
           numGroups,
           arrayResult,
-          [&](const KllSketch<T>& digest,
+          [&](const KllSketchAccumulator<T>& accumulator,
               ArrayVector* result,
               vector_size_t index) {
-            digest.estimateQuantiles(percentiles, rawValues + elementsCount);
+            accumulator.estimateQuantiles(
+                percentiles, rawValues + elementsCount);
             result->setOffsetAndSize(index, elementsCount, percentiles.size());
             elementsCount += percentiles.size();
           });
@@ -199,12 +313,14 @@ class ApproxPercentileAggregate : public exec::Aggregate {
           groups,
           numGroups,
           (*result)->asFlatVector<T>(),
-          [&](const KllSketch<T>& digest,
+          [&](const KllSketchAccumulator<T>& accumulator,
               FlatVector<T>* result,
               vector_size_t index) {
             VELOX_DCHECK_EQ(percentiles_->values.size(), 1);
-            result->set(
-                index, digest.estimateQuantile(percentiles_->values.back()));
+            T estimate;
+            accumulator.estimateQuantiles(
+                folly::Range(&percentiles_->values.back(), 1), &estimate);
+            result->set(index, estimate);
           });
     }
   }
@@ -269,9 +385,10 @@ class ApproxPercentileAggregate : public exec::Aggregate {
     auto levelsElements = levels->elements()->asFlatVector<int32_t>();
     size_t itemsCount = 0;
     vector_size_t levelsCount = 0;
+    std::array<uint32_t, 2> exactLevels;
     for (int i = 0; i < numGroups; ++i) {
       auto accumulator = value<const KllSketchAccumulator<T>>(groups[i]);
-      auto v = accumulator->getSketch().toView();
+      auto v = accumulator->toView(exactLevels);
       itemsCount += v.items.size();
       levelsCount += v.levels.size();
     }
@@ -287,7 +404,7 @@ class ApproxPercentileAggregate : public exec::Aggregate {
     levelsCount = 0;
     for (int i = 0; i < numGroups; ++i) {
       auto accumulator = value<const KllSketchAccumulator<T>>(groups[i]);
-      auto v = accumulator->getSketch().toView();
+      auto v = accumulator->toView(exactLevels);
       if (v.n == 0) {
         rowResult->setNull(i, true);
       } else {
@@ -324,7 +441,7 @@ class ApproxPercentileAggregate : public exec::Aggregate {
         auto value = decodedValue_.valueAt<T>(row);
         auto weight = decodedWeight_.valueAt<int64_t>(row);
         checkWeight(weight);
-        accumulator->append(value, weight);
+        accumulator->append(value, weight, allocator_);
       });
     } else {
       if (decodedValue_.mayHaveNulls()) {
@@ -334,12 +451,12 @@ class ApproxPercentileAggregate : public exec::Aggregate {
           }
 
           auto accumulator = initRawAccumulator(groups[row]);
-          accumulator->append(decodedValue_.valueAt<T>(row));
+          accumulator->append(decodedValue_.valueAt<T>(row), allocator_);
         });
       } else {
         rows.applyToSelected([&](auto row) {
           auto accumulator = initRawAccumulator(groups[row]);
-          accumulator->append(decodedValue_.valueAt<T>(row));
+          accumulator->append(decodedValue_.valueAt<T>(row), allocator_);
         });
       }
     }
@@ -372,7 +489,7 @@ class ApproxPercentileAggregate : public exec::Aggregate {
         auto value = decodedValue_.valueAt<T>(row);
         auto weight = decodedWeight_.valueAt<int64_t>(row);
         checkWeight(weight);
-        accumulator->append(value, weight);
+        accumulator->append(value, weight, allocator_);
       });
     } else {
       if (decodedValue_.mayHaveNulls()) {
@@ -381,11 +498,11 @@ class ApproxPercentileAggregate : public exec::Aggregate {
             return;
           }
 
-          accumulator->append(decodedValue_.valueAt<T>(row));
+          accumulator->append(decodedValue_.valueAt<T>(row), allocator_);
         });
       } else {
         rows.applyToSelected([&](auto row) {
-          accumulator->append(decodedValue_.valueAt<T>(row));
+          accumulator->append(decodedValue_.valueAt<T>(row), allocator_);
         });
       }
     }
@@ -402,7 +519,7 @@ class ApproxPercentileAggregate : public exec::Aggregate {
  private:
   void finalize(char** groups, int32_t numGroups) {
     for (auto i = 0; i < numGroups; ++i) {
-      value<KllSketchAccumulator<T>>(groups[i])->finalize();
+      value<KllSketchAccumulator<T>>(groups[i])->finalize(allocator_);
     }
   }
 
@@ -424,13 +541,13 @@ class ApproxPercentileAggregate : public exec::Aggregate {
     for (auto i = 0; i < numGroups; ++i) {
       char* group = groups[i];
       auto accumulator = value<KllSketchAccumulator<T>>(group);
-      if (accumulator->getSketch().totalCount() == 0) {
+      if (accumulator->totalCount() == 0) {
         result->setNull(i, true);
       } else {
         if (rawNulls) {
           bits::clearBit(rawNulls, i);
         }
-        extractFunction(accumulator->getSketch(), result, i);
+        extractFunction(*accumulator, result, i);
       }
     }
   }
@@ -620,13 +737,14 @@ class ApproxPercentileAggregate : public exec::Aggregate {
         views.push_back(v);
       } else {
         auto tracker = trackRowSize(group[row]);
-        accumulator->append(v);
+        accumulator->append(v, allocator_);
       }
     });
     if constexpr (kSingleGroup) {
       if (!views.empty()) {
         auto tracker = trackRowSize(group);
-        accumulator->append(views);
+        accumulator->append(
+            folly::Range(views.data(), views.size()), allocator_);
       }
     }
   }
@@ -137,24 +137,27 @@ class ArbitraryAggregate : public SimpleNumericAggregate<T, T, T> {
 
 // Arbitrary for non-numeric types. We always keep the first (non-NULL) element
 // seen. Arbitrary (x) will produce partial and final aggregations of type x.
+// TAccumulator is StringViewAccumulator for VARCHAR, which keeps short strings
+// inline, and SingleValueAccumulator for the other types.
+template <typename TAccumulator>
 class NonNumericArbitrary : public exec::Aggregate {
  public:
   explicit NonNumericArbitrary(const TypePtr& resultType)
       : exec::Aggregate(resultType) {}
 
-  // We use singleValueAccumulator to save the results for each group. This
-  // struct will allow us to save variable-width value.
+  // We use TAccumulator to save the results for each group. This struct will
+  // allow us to save variable-width value.
   int32_t accumulatorFixedWidthSize() const override {
-    return sizeof(SingleValueAccumulator);
+    return sizeof(TAccumulator);
   }
 
   // Initialize each group, we will not use the null flags because
-  // SingleValueAccumulator has its own flag.
+  // TAccumulator has its own flag.
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
     for (auto i : indices) {
-      new (groups[i] + offset_) SingleValueAccumulator();
+      new (groups[i] + offset_) TAccumulator();
     }
   }
 
@@ -167,7 +170,7 @@ class NonNumericArbitrary : public exec::Aggregate {
 
     for (int32_t i = 0; i < numGroups; ++i) {
       char* group = groups[i];
-      auto accumulator = value<SingleValueAccumulator>(group);
+      auto accumulator = value<TAccumulator>(group);
       if (!accumulator->hasValue()) {
         (*result)->setNull(i, true);
       } else {
@@ -184,7 +187,7 @@ class NonNumericArbitrary : public exec::Aggregate {
 
   void destroy(folly::Range<char**> groups) override {
     for (auto group : groups) {
-      value<SingleValueAccumulator>(group)->destroy(allocator_);
+      value<TAccumulator>(group)->destroy(allocator_);
     }
   }
 
@@ -205,7 +208,7 @@ class NonNumericArbitrary : public exec::Aggregate {
       if (decoded.isNullAt(i)) {
         return;
       }
-      auto* accumulator = value<SingleValueAccumulator>(groups[i]);
+      auto* accumulator = value<TAccumulator>(groups[i]);
       if (!accumulator->hasValue()) {
         accumulator->write(baseVector, indices[i], allocator_);
       }
@@ -233,7 +236,7 @@ class NonNumericArbitrary : public exec::Aggregate {
 
     const auto* indices = decoded.indices();
     const auto* baseVector = decoded.base();
-    auto* accumulator = value<SingleValueAccumulator>(group);
+    auto* accumulator = value<TAccumulator>(group);
     // Find the first non-null value.
     rows.testSelected([&](vector_size_t i) {
       if (!decoded.isNullAt(i)) {
@@ -292,10 +295,13 @@ bool registerArbitrary(const std::string& name) {
           case TypeKind::DATE:
             return std::make_unique<ArbitraryAggregate<Date>>(inputType);
           case TypeKind::VARCHAR:
+            return std::make_unique<NonNumericArbitrary<StringViewAccumulator>>(
+                inputType);
           case TypeKind::ARRAY:
           case TypeKind::MAP:
           case TypeKind::ROW:
-            return std::make_unique<NonNumericArbitrary>(inputType);
+            return std::make_unique<
+                NonNumericArbitrary<SingleValueAccumulator>>(inputType);
           default:
             VELOX_FAIL(
                 "Unknown input type for {} aggregation {}",
@@ -155,6 +155,12 @@ class ArrayAggAggregate : public exec::Aggregate {
     }
   }
 
+  void relocate(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      value<ArrayAccumulator>(group)->elements.relocate(allocator_);
+    }
+  }
+
  private:
   vector_size_t countElements(char** groups, int32_t numGroups) const {
     vector_size_t size = 0;
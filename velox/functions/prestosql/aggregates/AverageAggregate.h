@@ -114,13 +114,31 @@ class AverageAggregate : public exec::Aggregate {
       });
     } else if (!exec::Aggregate::numNulls_ && decodedRaw_.isIdentityMapping()) {
       auto data = decodedRaw_.data<T>();
-      rows.applyToSelected([&](vector_size_t i) {
-        updateNonNullValue<false>(groups[i], data[i]);
-      });
+      updateFewGroups(
+          groups,
+          rows,
+          SumCount(),
+          [](vector_size_t /*row*/) { return false; },
+          [&](SumCount& partial, vector_size_t row) {
+            partial.sum += data[row];
+            ++partial.count;
+          },
+          [&](char* group, const SumCount& partial) {
+            updateNonNullValue<false>(group, partial.count, partial.sum);
+          });
     } else {
-      rows.applyToSelected([&](vector_size_t i) {
-        updateNonNullValue(groups[i], decodedRaw_.valueAt<T>(i));
-      });
+      updateFewGroups(
+          groups,
+          rows,
+          SumCount(),
+          [](vector_size_t /*row*/) { return false; },
+          [&](SumCount& partial, vector_size_t row) {
+            partial.sum += decodedRaw_.valueAt<T>(row);
+            ++partial.count;
+          },
+          [&](char* group, const SumCount& partial) {
+            updateNonNullValue(group, partial.count, partial.sum);
+          });
     }
   }
 
@@ -194,13 +212,19 @@ class AverageAggregate : public exec::Aggregate {
             baseSumVector->valueAt(decodedIndex));
       });
     } else {
-      rows.applyToSelected([&](vector_size_t i) {
-        auto decodedIndex = decodedPartial_.index(i);
-        updateNonNullValue(
-            groups[i],
-            baseCountVector->valueAt(decodedIndex),
-            baseSumVector->valueAt(decodedIndex));
-      });
+      updateFewGroups(
+          groups,
+          rows,
+          SumCount(),
+          [](vector_size_t /*row*/) { return false; },
+          [&](SumCount& partial, vector_size_t row) {
+            auto decodedIndex = decodedPartial_.index(row);
+            partial.sum += baseSumVector->valueAt(decodedIndex);
+            partial.count += baseCountVector->valueAt(decodedIndex);
+          },
+          [&](char* group, const SumCount& partial) {
+            updateNonNullValue(group, partial.count, partial.sum);
+          });
     }
   }
 
@@ -53,27 +53,19 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
-    if (args.empty()) {
-      rows.applyToSelected([&](vector_size_t i) { addToGroup(groups[i], 1); });
-      return;
-    }
+    updateRawInput(groups, rows, args, 1);
+  }
 
-    DecodedVector decoded(*args[0], rows);
-    if (decoded.isConstantMapping()) {
-      if (!decoded.isNullAt(0)) {
-        rows.applyToSelected(
-            [&](vector_size_t i) { addToGroup(groups[i], 1); });
-      }
-    } else if (decoded.mayHaveNulls()) {
-      rows.applyToSelected([&](vector_size_t i) {
-        if (decoded.isNullAt(i)) {
-          return;
-        }
-        addToGroup(groups[i], 1);
-      });
-    } else {
-      rows.applyToSelected([&](vector_size_t i) { addToGroup(groups[i], 1); });
-    }
+  void retractRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    updateRawInput(groups, rows, args, -1);
+  }
+
+  bool supportsRetract() const override {
+    return true;
   }
 
   void addIntermediateResults(
@@ -82,9 +74,15 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
     decodedIntermediate_.decode(*args[0], rows);
-    rows.applyToSelected([&](vector_size_t i) {
-      addToGroup(groups[i], decodedIntermediate_.valueAt<int64_t>(i));
-    });
+    updateFewGroups(
+        groups,
+        rows,
+        int64_t(0),
+        [](vector_size_t /*row*/) { return false; },
+        [&](int64_t& count, vector_size_t row) {
+          count += decodedIntermediate_.valueAt<int64_t>(row);
+        },
+        [&](char* group, int64_t count) { addToGroup(group, count); });
   }
 
   void addSingleGroupRawInput(
@@ -97,6 +95,19 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       return;
     }
 
+    if (args[0]->encoding() == VectorEncoding::Simple::SEQUENCE) {
+      // Count the rows of the non-null runs.
+      DecodedVector decodedRuns(*args[0]->valueVector());
+      int64_t nonNullCount = 0;
+      forEachSelectedRun(*args[0], rows, [&](auto run, auto numRows) {
+        if (!decodedRuns.isNullAt(run)) {
+          nonNullCount += numRows;
+        }
+      });
+      addToGroup(group, nonNullCount);
+      return;
+    }
+
     DecodedVector decoded(*args[0], rows);
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
@@ -143,6 +154,52 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
     *value<int64_t>(group) += count;
   }
 
+  // Adds 'sign' times the count of the non-null rows of 'args' to their
+  // groups. 'sign' is -1 for retracting the rows.
+  void updateRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      int64_t sign) {
+    auto noNulls = [](vector_size_t /*row*/) { return false; };
+    if (args.empty()) {
+      countRows(groups, rows, noNulls, sign);
+      return;
+    }
+
+    DecodedVector decoded(*args[0], rows);
+    if (decoded.isConstantMapping()) {
+      if (!decoded.isNullAt(0)) {
+        countRows(groups, rows, noNulls, sign);
+      }
+    } else if (decoded.mayHaveNulls()) {
+      countRows(
+          groups,
+          rows,
+          [&](vector_size_t row) { return decoded.isNullAt(row); },
+          sign);
+    } else {
+      countRows(groups, rows, noNulls, sign);
+    }
+  }
+
+  // Adds 'sign' times the number of 'rows' for which 'isNull(row)' is false
+  // to their groups.
+  template <typename IsNull>
+  void countRows(
+      char** groups,
+      const SelectivityVector& rows,
+      IsNull isNull,
+      int64_t sign) {
+    updateFewGroups(
+        groups,
+        rows,
+        int64_t(0),
+        isNull,
+        [](int64_t& count, vector_size_t /*row*/) { ++count; },
+        [&](char* group, int64_t count) { addToGroup(group, sign * count); });
+  }
+
   DecodedVector decodedIntermediate_;
 };
 
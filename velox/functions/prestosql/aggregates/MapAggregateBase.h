@@ -79,6 +79,14 @@ class MapAggregateBase : public exec::Aggregate {
     }
   }
 
+  void relocate(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      auto accumulator = value<MapAccumulator>(group);
+      accumulator->keys.relocate(allocator_);
+      accumulator->values.relocate(allocator_);
+    }
+  }
+
  protected:
   vector_size_t countElements(char** groups, int32_t numGroups) const {
     vector_size_t size = 0;
@@ -107,6 +107,13 @@ struct AccumulatorTypeTraits<T, std::enable_if_t<!isNumericOrDate<T>(), void>> {
   using AccumulatorType = SingleValueAccumulator;
 };
 
+/// Strings are kept in StringViewAccumulator, which stores short strings
+/// inline instead of allocating them from the HashStringAllocator.
+template <>
+struct AccumulatorTypeTraits<StringView> {
+  using AccumulatorType = StringViewAccumulator;
+};
+
 template <typename T>
 struct MinMaxTrait : public std::numeric_limits<T> {};
 
@@ -154,16 +161,14 @@ class MinMaxByAggregate : public exec::Aggregate {
       valueIsNull(group) = true;
 
       if constexpr (!isNumericOrDate<T>()) {
-        new (group + offset_) SingleValueAccumulator();
+        new (group + offset_) ValueAccumulatorType();
       }
 
       if constexpr (isNumericOrDate<U>()) {
         *comparisonValue(group) = initialValue_;
       } else {
-        new (
-            group + offset_ +
-            (isNumericOrDate<T>() ? sizeof(T) : sizeof(ValueAccumulatorType)))
-            SingleValueAccumulator();
+        new (group + offset_ + sizeof(ValueAccumulatorType))
+            ComparisonAccumulatorType();
       }
     }
   }
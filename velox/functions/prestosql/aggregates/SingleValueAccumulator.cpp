@@ -15,6 +15,7 @@
  */
 
 #include "velox/functions/prestosql/aggregates/SingleValueAccumulator.h"
+#include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::aggregate {
 
@@ -67,4 +68,43 @@ void SingleValueAccumulator::destroy(HashStringAllocator* allocator) {
   }
 }
 
+void StringViewAccumulator::write(
+    const BaseVector* vector,
+    vector_size_t index,
+    HashStringAllocator* allocator) {
+  auto newValue =
+      vector->asUnchecked<SimpleVector<StringView>>()->valueAt(index);
+  destroy(allocator);
+  value_ = newValue;
+  allocator->copyMultipart(reinterpret_cast<char*>(&value_), 0);
+  hasValue_ = true;
+}
+
+void StringViewAccumulator::read(const VectorPtr& vector, vector_size_t index)
+    const {
+  VELOX_CHECK(hasValue_);
+
+  std::string storage;
+  vector->asUnchecked<FlatVector<StringView>>()->set(
+      index, HashStringAllocator::contiguousString(value_, storage));
+}
+
+int32_t StringViewAccumulator::compare(
+    const DecodedVector& decoded,
+    vector_size_t index) const {
+  VELOX_CHECK(hasValue_);
+
+  std::string storage;
+  return HashStringAllocator::contiguousString(value_, storage)
+      .compare(decoded.valueAt<StringView>(index));
+}
+
+void StringViewAccumulator::destroy(HashStringAllocator* allocator) {
+  if (hasValue_ && !value_.isInline()) {
+    allocator->free(HashStringAllocator::headerOf(value_.data()));
+  }
+  value_ = StringView();
+  hasValue_ = false;
+}
+
 } // namespace facebook::velox::aggregate
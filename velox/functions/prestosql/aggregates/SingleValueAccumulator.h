@@ -44,4 +44,34 @@ struct SingleValueAccumulator {
   HashStringAllocator::Header* begin_{nullptr};
 };
 
+// An accumulator for a single VARCHAR or VARBINARY value. Has the same
+// interface as SingleValueAccumulator. Strings of up to
+// StringView::kInlineSize bytes are stored inline in the accumulator. Only
+// longer strings are copied into the HashStringAllocator.
+struct StringViewAccumulator {
+  void write(
+      const BaseVector* vector,
+      vector_size_t index,
+      HashStringAllocator* allocator);
+
+  void read(const VectorPtr& vector, vector_size_t index) const;
+
+  bool hasValue() const {
+    return hasValue_;
+  }
+
+  // Returns 0 if stored and new values are equal; <0 if stored value is less
+  // then new value; >0 if stored value is greated than new value
+  int32_t compare(const DecodedVector& decoded, vector_size_t index) const;
+
+  void destroy(HashStringAllocator* allocator);
+
+ private:
+  // Points to the data of a string written by
+  // HashStringAllocator::copyMultipart() if not inline.
+  StringView value_;
+
+  bool hasValue_{false};
+};
+
 } // namespace facebook::velox::aggregate
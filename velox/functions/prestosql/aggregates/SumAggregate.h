@@ -134,11 +134,11 @@ class SumAggregate
     }
 
     if (exec::Aggregate::numNulls_) {
-      BaseAggregate::template updateGroups<true, TData, TValue>(
-          groups, rows, arg, &updateSingleValue<TData>, false);
+      BaseAggregate::template updateGroupsPreAggregated<true, TData, TValue>(
+          groups, rows, arg, &updateSingleValue<TData>, TData(0));
     } else {
-      BaseAggregate::template updateGroups<false, TData, TValue>(
-          groups, rows, arg, &updateSingleValue<TData>, false);
+      BaseAggregate::template updateGroupsPreAggregated<false, TData, TValue>(
+          groups, rows, arg, &updateSingleValue<TData>, TData(0));
     }
   }
 
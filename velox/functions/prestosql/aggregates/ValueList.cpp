@@ -98,6 +98,30 @@ void ValueList::appendRange(
   }
 }
 
+namespace {
+void relocateAllocation(
+    HashStringAllocator::Header*& begin,
+    HashStringAllocator::Position& current,
+    HashStringAllocator* allocator) {
+  const auto offset = HashStringAllocator::offset(begin, current);
+  VELOX_CHECK_GE(offset, 0);
+  auto* newBegin = allocator->relocate(begin);
+  if (newBegin != begin) {
+    begin = newBegin;
+    current = HashStringAllocator::seek(begin, offset);
+  }
+}
+} // namespace
+
+void ValueList::relocate(HashStringAllocator* allocator) {
+  if (nullsBegin_) {
+    relocateAllocation(nullsBegin_, nullsCurrent_, allocator);
+  }
+  if (dataBegin_) {
+    relocateAllocation(dataBegin_, dataCurrent_, allocator);
+  }
+}
+
 ValueListReader::ValueListReader(ValueList& values)
     : size_{values.size()},
       lastNullsStart_{size_ % 64 == 0 ? size_ - 64 : size_ - size_ % 64},
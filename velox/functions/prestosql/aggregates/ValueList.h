@@ -64,6 +64,10 @@ class ValueList {
     }
   }
 
+  // Moves the allocations out of the slabs being evacuated by a compaction of
+  // 'allocator'. See HashStringAllocator::relocate().
+  void relocate(HashStringAllocator* allocator);
+
  private:
   // An array_agg or related begins with an allocation of 5 words and
   // 4 bytes for header. This is compact for small arrays (up to 5
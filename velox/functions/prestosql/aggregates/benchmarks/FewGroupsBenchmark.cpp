@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/Aggregate.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+/// Measures updating the accumulators of sum, count and avg with batches that
+/// hit a varying number of distinct groups in random order. Batches that hit
+/// up to Aggregate::kMaxFewGroups groups are pre-aggregated per group, the
+/// rows of the others are applied one at a time.
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+namespace {
+
+constexpr int32_t kRowsPerBatch = 10'000;
+constexpr int32_t kBatchesPerIteration = 100;
+
+class FewGroupsBenchmark : public VectorTestBase {
+ public:
+  FewGroupsBenchmark() {
+    aggregate::prestosql::registerAllAggregateFunctions();
+    input_ = makeRowVector({
+        makeFlatVector<int64_t>(kRowsPerBatch, [](auto row) { return row; }),
+        makeFlatVector<double>(
+            kRowsPerBatch, [](auto row) { return row * 0.1; }),
+        makeFlatVector<int64_t>(
+            kRowsPerBatch, [](auto row) { return row; }, nullEvery(2)),
+    });
+  }
+
+  void run(const std::string& name, column_index_t column, int32_t numGroups) {
+    folly::BenchmarkSuspender suspender;
+    constexpr int32_t kOffset = 8;
+    HashStringAllocator allocator(pool());
+    auto type = input_->childAt(column)->type();
+    auto function = exec::Aggregate::create(
+        name,
+        core::AggregationNode::Step::kPartial,
+        {type},
+        exec::Aggregate::intermediateType(name, {type}));
+    function->setAllocator(&allocator);
+    function->setOffsets(kOffset, 0, 1, 0);
+
+    const auto rowSize = kOffset + function->accumulatorFixedWidthSize();
+    std::vector<char> rows(rowSize * numGroups);
+    std::vector<char*> groups(numGroups);
+    std::vector<vector_size_t> indices(numGroups);
+    for (auto i = 0; i < numGroups; ++i) {
+      groups[i] = rows.data() + i * rowSize;
+      indices[i] = i;
+    }
+    function->initializeNewGroups(groups.data(), indices);
+
+    std::vector<char*> rowGroups(kRowsPerBatch);
+    folly::Random::DefaultGenerator rng(1);
+    for (auto i = 0; i < kRowsPerBatch; ++i) {
+      rowGroups[i] = groups[folly::Random::rand32(numGroups, rng)];
+    }
+    SelectivityVector allRows(kRowsPerBatch);
+    std::vector<VectorPtr> args = {input_->childAt(column)};
+    suspender.dismiss();
+
+    for (auto i = 0; i < kBatchesPerIteration; ++i) {
+      function->addRawInput(rowGroups.data(), allRows, args, false);
+    }
+    folly::doNotOptimizeAway(rows);
+  }
+
+ private:
+  RowVectorPtr input_;
+};
+
+std::unique_ptr<FewGroupsBenchmark> benchmark;
+
+void sumBigint(uint32_t iterations, int32_t numGroups) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run("sum", 0, numGroups);
+  }
+}
+
+void sumDouble(uint32_t iterations, int32_t numGroups) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run("sum", 1, numGroups);
+  }
+}
+
+void sumBigintHalfNull(uint32_t iterations, int32_t numGroups) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run("sum", 2, numGroups);
+  }
+}
+
+void countBigintHalfNull(uint32_t iterations, int32_t numGroups) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run("count", 2, numGroups);
+  }
+}
+
+void avgDouble(uint32_t iterations, int32_t numGroups) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run("avg", 1, numGroups);
+  }
+}
+
+#define FEW_GROUPS_BENCHMARKS(_name_) \
+  BENCHMARK_PARAM(_name_, 1);         \
+  BENCHMARK_PARAM(_name_, 4);         \
+  BENCHMARK_PARAM(_name_, 16);        \
+  BENCHMARK_PARAM(_name_, 64);        \
+  BENCHMARK_PARAM(_name_, 128);       \
+  BENCHMARK_PARAM(_name_, 1024);      \
+  BENCHMARK_DRAW_LINE();
+
+FEW_GROUPS_BENCHMARKS(sumBigint)
+FEW_GROUPS_BENCHMARKS(sumDouble)
+FEW_GROUPS_BENCHMARKS(sumBigintHalfNull)
+FEW_GROUPS_BENCHMARKS(countBigintHalfNull)
+FEW_GROUPS_BENCHMARKS(avgDouble)
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<FewGroupsBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
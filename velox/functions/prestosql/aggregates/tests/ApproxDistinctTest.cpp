@@ -161,6 +161,25 @@ TEST_F(ApproxDistinctTest, groupByAllNulls) {
   testAggregations({vectors}, {"c0"}, {"approx_distinct(c1)"}, {expected});
 }
 
+TEST_F(ApproxDistinctTest, dictionaryAndConstantInput) {
+  vector_size_t size = 1'000;
+  auto keys = makeFlatVector<int32_t>(size, [](auto row) { return row % 2; });
+
+  // Fewer base values than rows. The base values are hashed once.
+  auto base = makeFlatVector<StringView>(
+      kFruits.size(),
+      [&](auto row) { return StringView(kFruits[row]); },
+      nullEvery(5));
+  auto indices = makeIndices(
+      size, [&](auto row) { return (row / 2) % kFruits.size(); });
+  auto values = wrapInDictionary(indices, size, base);
+  testGroupByAgg(keys, values, {{0, 8}, {1, 8}});
+  testGlobalAgg(values, 8);
+
+  testGroupByAgg(keys, makeConstant<int32_t>(7, size), {{0, 1}, {1, 1}});
+  testGlobalAgg(makeConstant<int32_t>(7, size), 1);
+}
+
 TEST_F(ApproxDistinctTest, globalAggIntegers) {
   vector_size_t size = 1'000;
   auto values =
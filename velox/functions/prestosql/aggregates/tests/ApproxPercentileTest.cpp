@@ -203,6 +203,32 @@ TEST_F(ApproxPercentileTest, groupByAgg) {
       keys, valuesWithNulls, weightsWithNulls, 0.5, 0.005, expectedResult);
 }
 
+// Groups with at most KllSketchAccumulator::kMaxExactValues values keep them
+// exactly and the others use a KLL sketch. Both give exact results when the
+// groups are smaller than k.
+TEST_F(ApproxPercentileTest, smallAndLargeGroups) {
+  constexpr vector_size_t kSize = 1'000;
+  auto values = makeFlatVector<double>(kSize, [](auto row) { return row; });
+  auto weights = makeFlatVector<int64_t>(kSize, [](auto row) { return 1; });
+  for (int32_t numGroups : {100, 300, 500}) {
+    SCOPED_TRACE(fmt::format("numGroups: {}", numGroups));
+    auto keys = makeFlatVector<int32_t>(
+        kSize, [&](auto row) { return row % numGroups; });
+    // Group 'g' has the values g, g + numGroups, g + 2 * numGroups...
+    auto expected = makeRowVector({
+        makeFlatVector<int32_t>(numGroups, folly::identity),
+        makeFlatVector<double>(
+            numGroups,
+            [&](auto group) {
+              auto size = (kSize - group + numGroups - 1) / numGroups;
+              return group + numGroups * (size / 2);
+            }),
+    });
+    testGroupByAgg(keys, values, nullptr, 0.5, -1, expected);
+    testGroupByAgg(keys, values, weights, 0.5, -1, expected);
+  }
+}
+
 // Test large values of "weight" parameter used in global aggregation.
 TEST_F(ApproxPercentileTest, largeWeightsGlobal) {
   vector_size_t size = 1'000;
@@ -175,6 +175,33 @@ TEST_F(ArbitraryTest, varcharConstAndNulls) {
       "SELECT c0, first(c1), first(c2) FROM tmp group by c0");
 }
 
+TEST_F(ArbitraryTest, inlineAndNonInlineVarchar) {
+  // All rows of a group have the same value. Odd groups have strings that are
+  // too long to be stored inline in the accumulator.
+  auto value = [](auto group) {
+    return group % 2 ? fmt::format("a longer string {}", group)
+                     : fmt::format("s{}", group);
+  };
+  std::vector<std::string> values;
+  for (auto i = 0; i < 17; ++i) {
+    values.push_back(value(i));
+  }
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 17; }),
+      makeFlatVector<StringView>(
+          1'000,
+          [&](auto row) { return StringView(values[row % 17]); },
+          nullEvery(7)),
+  });
+  auto expected = makeRowVector({
+      makeFlatVector<int32_t>(17, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          17, [&](auto row) { return StringView(values[row]); }),
+  });
+
+  testAggregations({data}, {"c0"}, {"arbitrary(c1)"}, {expected});
+}
+
 TEST_F(ArbitraryTest, numericConstAndNulls) {
   auto vectors = {makeRowVector(
       {makeFlatVector<int32_t>(100, [](auto row) { return row % 7; }),
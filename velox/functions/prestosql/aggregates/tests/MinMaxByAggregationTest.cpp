@@ -972,5 +972,54 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
     MinMaxByGroupByAggregationTest,
     testing::ValuesIn(getTestParams()));
 
+class MinMaxByStringTest : public AggregationTestBase {};
+
+// Mixes strings that are stored inline in the accumulator with strings that
+// are copied to the HashStringAllocator, both as values and as comparison
+// values.
+TEST_F(MinMaxByStringTest, inlineAndNonInlineStrings) {
+  auto value = [](auto row) {
+    return row % 3 == 0 ? fmt::format("a longer string {}", row)
+                        : fmt::format("s{}", row);
+  };
+  // Sorts in the same order as 'row'.
+  auto comparison = [](auto row) {
+    return fmt::format("{:04}{}", row, row % 2 ? " with a long suffix" : "");
+  };
+
+  std::vector<std::string> values;
+  std::vector<std::string> comparisons;
+  for (auto i = 0; i < 1'000; ++i) {
+    values.push_back(value(i));
+    comparisons.push_back(comparison(i));
+  }
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 10; }),
+      makeFlatVector<StringView>(
+          1'000, [&](auto row) { return StringView(values[row]); }),
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          1'000, [&](auto row) { return StringView(comparisons[row]); }),
+  });
+
+  auto expected = makeRowVector({
+      makeFlatVector<int32_t>(10, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          10, [&](auto row) { return StringView(values[990 + row]); }),
+      makeFlatVector<StringView>(
+          10, [&](auto row) { return StringView(values[row]); }),
+      makeFlatVector<StringView>(
+          10, [&](auto row) { return StringView(values[990 + row]); }),
+      makeFlatVector<StringView>(
+          10, [&](auto row) { return StringView(comparisons[row]); }),
+  });
+
+  testAggregations(
+      {data},
+      {"c0"},
+      {"max_by(c1, c2)", "min_by(c1, c2)", "max_by(c1, c3)", "min_by(c3, c2)"},
+      {expected});
+}
+
 } // namespace
 } // namespace facebook::velox::aggregate::test
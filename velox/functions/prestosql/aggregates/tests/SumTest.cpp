@@ -213,6 +213,60 @@ TEST_F(SumTest, sumTinyint) {
       "SELECT sum(c1) FROM tmp WHERE c0 % 2 = 0");
 }
 
+// Covers batches that hit few enough groups to be pre-aggregated per group and
+// batches that hit more, where the rows past the first kMaxFewGroups groups
+// are applied one at a time.
+TEST_F(SumTest, fewAndManyGroupsPerBatch) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(1'000, [](auto row) { return row % 200; }),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return row * 7 - i; }, nullEvery(11)),
+        makeFlatVector<double>(1'000, [](auto row) { return row * 0.5; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto& key : {"c0 % 3", "c0 % 64", "c0 % 65", "c0"}) {
+    SCOPED_TRACE(key);
+    testAggregations(
+        [&](auto& builder) {
+          builder.values(vectors).project({key, "c1", "c2"});
+        },
+        {"p0"},
+        {"sum(c1)", "count(c1)", "count(1)", "avg(c1)", "sum(c2)", "avg(c2)"},
+        fmt::format(
+            "SELECT {}, sum(c1), count(c1), count(1), avg(c1), sum(c2), "
+            "avg(c2) FROM tmp GROUP BY 1",
+            key));
+  }
+}
+
+TEST_F(SumTest, sequenceInput) {
+  // Runs of equal values are aggregated once per run.
+  auto data = makeRowVector({
+      vectorMaker_.sequenceVector<int64_t>(
+          {1, 1, 1, std::nullopt, std::nullopt, 5, 5, 7, 7, 7, 7}),
+      makeFlatVector<bool>(11, [](auto row) { return row % 3 != 1; }),
+  });
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .singleAggregation(
+                      {},
+                      {"sum(c0)", "count(c0)", "min(c0)", "max(c0)", "sum(c0)"},
+                      {"", "", "", "", "c1"})
+                  .planNode();
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>({41}),
+      makeFlatVector<int64_t>({9}),
+      makeFlatVector<int64_t>({1}),
+      makeFlatVector<int64_t>({7}),
+      makeFlatVector<int64_t>({26}),
+  });
+  AssertQueryBuilder(plan).assertResults(expected);
+}
+
 TEST_F(SumTest, sumBigIntOverflow) {
   auto data = makeRowVector(
       {makeFlatVector<int64_t>({-9223372036854775806L, -100, 3400})});
@@ -95,6 +95,47 @@ class ArrayContainsBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, rowVector);
   }
 
+  // Searches long arrays for a value that is not in them, so that all
+  // elements are compared.
+  void runIntegerLongArrays(const std::string& functionName) {
+    folly::BenchmarkSuspender suspender;
+    vector_size_t size = 1'000;
+    auto arrayVector = vectorMaker_.arrayVector<int32_t>(
+        size,
+        [](auto row) { return 100 + row % 100; },
+        [](auto row) { return row % 23; });
+
+    auto elementVector =
+        BaseVector::createConstant(INTEGER(), 30, size, execCtx_.pool());
+
+    auto rowVector = vectorMaker_.rowVector({arrayVector, elementVector});
+    auto exprSet = compileExpression(
+        fmt::format("{}(c0, c1)", functionName), rowVector->type());
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
+  void runIntersect(const std::string& functionName, vector_size_t arraySize) {
+    folly::BenchmarkSuspender suspender;
+    vector_size_t size = 1'000;
+    auto left = vectorMaker_.arrayVector<int32_t>(
+        size,
+        [&](auto /*row*/) { return arraySize; },
+        [](auto row) { return row % 23; });
+    auto right = vectorMaker_.arrayVector<int32_t>(
+        size,
+        [&](auto /*row*/) { return arraySize; },
+        [](auto row) { return row % 29; });
+
+    auto rowVector = vectorMaker_.rowVector({left, right});
+    auto exprSet = compileExpression(
+        fmt::format("{}(c0, c1)", functionName), rowVector->type());
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
   void runVarchar(const std::string& functionName) {
     folly::BenchmarkSuspender suspender;
     vector_size_t size = 1'000;
@@ -144,6 +185,31 @@ BENCHMARK_RELATIVE(vectorFunctionInteger) {
   benchmark.runInteger("contains");
 }
 
+BENCHMARK(vectorSimpleFunctionLongArrays) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runIntegerLongArrays("contains_alt");
+}
+
+BENCHMARK_RELATIVE(vectorFunctionIntegerLongArrays) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runIntegerLongArrays("contains");
+}
+
+BENCHMARK(arrayIntersectSmallArrays) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runIntersect("array_intersect", 5);
+}
+
+BENCHMARK(arrayIntersectLargeArrays) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runIntersect("array_intersect", 100);
+}
+
+BENCHMARK(arraysOverlapSmallArrays) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runIntersect("arrays_overlap", 5);
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
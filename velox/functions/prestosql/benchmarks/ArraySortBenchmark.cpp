@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+/// Measures array_sort and array_distinct on arrays of primitive elements of
+/// different sizes.
+
+namespace {
+
+class ArraySortBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  ArraySortBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerArrayFunctions();
+  }
+
+  template <typename T>
+  void run(const std::string& functionName, vector_size_t arraySize) {
+    folly::BenchmarkSuspender suspender;
+    const vector_size_t numElements = 100'000;
+    auto arrayVector = vectorMaker_.arrayVector<T>(
+        numElements / arraySize,
+        [&](auto /*row*/) { return arraySize; },
+        [](auto row) { return (row * 2654435761) % 1000; });
+
+    auto rowVector = vectorMaker_.rowVector({arrayVector});
+    auto exprSet = compileExpression(
+        fmt::format("{}(c0)", functionName), rowVector->type());
+    suspender.dismiss();
+
+    int cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      cnt += evaluate(exprSet, rowVector)->size();
+    }
+    folly::doNotOptimizeAway(cnt);
+  }
+};
+
+BENCHMARK(sortInteger4) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<int32_t>("array_sort", 4);
+}
+
+BENCHMARK(sortInteger16) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<int32_t>("array_sort", 16);
+}
+
+BENCHMARK(sortBigint1000) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<int64_t>("array_sort", 1'000);
+}
+
+BENCHMARK(sortDouble1000) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<double>("array_sort", 1'000);
+}
+
+BENCHMARK(distinctInteger4) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<int32_t>("array_distinct", 4);
+}
+
+BENCHMARK(distinctInteger16) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<int32_t>("array_distinct", 16);
+}
+
+BENCHMARK(distinctBigint1000) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<int64_t>("array_distinct", 1'000);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  folly::runBenchmarks();
+  return 0;
+}
@@ -124,6 +124,24 @@ class DateTimeBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, data);
   }
 
+  // Evaluates 'expression' over timestamps one minute apart in 2022,
+  // converted to the session time zone.
+  void runWithTimeZone(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kAdjustTimestampToTimezone, "true"},
+        {core::QueryConfig::kSessionTimezone, "America/Los_Angeles"},
+    });
+    auto timestamps = vectorMaker_.flatVector<Timestamp>(10'000, [](auto row) {
+      return Timestamp(1'641'000'000 + row * 60, 0);
+    });
+    auto data = vectorMaker_.rowVector({timestamps});
+    auto exprSet = compileExpression(expression, data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
   void doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -197,6 +215,26 @@ BENCHMARK(second) {
   DateTimeBenchmark benchmark;
   benchmark.run("second");
 }
+
+BENCHMARK(yearWithTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runWithTimeZone("year(c0)");
+}
+
+BENCHMARK(hourWithTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runWithTimeZone("hour(c0)");
+}
+
+BENCHMARK_RELATIVE(hourVectorWithTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runWithTimeZone("hour_vector(c0)");
+}
+
+BENCHMARK(truncDayWithTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runWithTimeZone("date_trunc('day', c0)");
+}
 } // namespace
 
 int main(int argc, char** argv) {
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/type/DecimalUtil.h"
+
+/// Measures the arithmetic on long decimals. The values of the financial
+/// columns typically fit in 64 bits even if their type is DECIMAL(38, x),
+/// which takes the fast paths of add, subtract and multiply. 'large' inputs
+/// have values that do not fit in 64 bits.
+
+namespace {
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class DecimalArithmeticBenchmark
+    : public functions::test::FunctionBenchmarkBase {
+ public:
+  DecimalArithmeticBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerArithmeticFunctions();
+    options_.parseDecimalAsDouble = false;
+
+    constexpr vector_size_t kSize = 10'000;
+    auto makeDecimals = [&](const TypePtr& type, int128_t factor) {
+      std::vector<int128_t> values(kSize);
+      for (auto i = 0; i < kSize; ++i) {
+        values[i] = (i * 7'919 + 17) * factor;
+      }
+      return vectorMaker_.longDecimalFlatVector(values, type);
+    };
+    data_ = vectorMaker_.rowVector(
+        {"c0", "c1", "c2", "c3"},
+        {makeDecimals(DECIMAL(38, 2), 1),
+         makeDecimals(DECIMAL(38, 2), 3),
+         makeDecimals(DECIMAL(38, 4), 5),
+         makeDecimals(DECIMAL(38, 2), DecimalUtil::kPowersOfTen[20])});
+  }
+
+  void run(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    auto exprSet = compileExpression(expression, data_->type());
+    suspender.dismiss();
+
+    uint32_t count = 0;
+    for (auto i = 0; i < 100; i++) {
+      count += evaluate(exprSet, data_)->size();
+    }
+    folly::doNotOptimizeAway(count);
+  }
+
+ private:
+  RowVectorPtr data_;
+};
+
+std::unique_ptr<DecimalArithmeticBenchmark> benchmark;
+
+BENCHMARK(addSameScale) {
+  benchmark->run("c0 + c1");
+}
+
+BENCHMARK_RELATIVE(addRescale) {
+  benchmark->run("c0 + c2");
+}
+
+BENCHMARK_RELATIVE(addLarge) {
+  benchmark->run("c3 + c1");
+}
+
+BENCHMARK(subtractSameScale) {
+  benchmark->run("c0 - c1");
+}
+
+BENCHMARK_RELATIVE(subtractRescale) {
+  benchmark->run("c0 - c2");
+}
+
+BENCHMARK(multiply) {
+  benchmark->run("c0 * c1");
+}
+
+BENCHMARK_RELATIVE(multiplyLarge) {
+  benchmark->run("c3 * c1");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<DecimalArithmeticBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
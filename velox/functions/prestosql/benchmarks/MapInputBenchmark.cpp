@@ -249,6 +249,7 @@ class MapInputBenchmark : public functions::test::FunctionBenchmarkBase {
   MapInputBenchmark() : FunctionBenchmarkBase() {
     functions::prestosql::registerMapFunctions();
     functions::prestosql::registerArrayFunctions();
+    functions::prestosql::registerGeneralFunctions();
 
     registerFunction<MapSumValuesAndKeysSimple, int64_t, Map<int64_t, int64_t>>(
         {"map_sum_simple"});
@@ -348,6 +349,35 @@ class MapInputBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, rowVector);
   }
 
+  // Evaluates 10 subscripts with constant keys over a dictionary that
+  // repeats 100 maps of 64 keys each, optionally with sorted keys.
+  void runSubscripts(bool sortedKeys) {
+    folly::BenchmarkSuspender suspender;
+    auto mapVector = vectorMaker_.mapVector<int64_t, int64_t>(
+        100,
+        [](auto /*row*/) { return 64; },
+        [](auto idx) { return (idx * 37) % 64; },
+        [](auto idx) { return idx; });
+    if (sortedKeys) {
+      MapVector::canonicalize(mapVector);
+    }
+    const vector_size_t size = 10'000;
+    auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < size; ++i) {
+      rawIndices[i] = i % 100;
+    }
+    auto rowVector = vectorMaker_.rowVector(
+        {BaseVector::wrapInDictionary(nullptr, indices, size, mapVector)});
+    auto exprSet = compileExpression(
+        "array_constructor(c0[1], c0[7], c0[13], c0[19], c0[25], c0[31], "
+        "c0[37], c0[43], c0[49], c0[55])",
+        rowVector->type());
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -431,6 +461,16 @@ BENCHMARK_RELATIVE(nestedMapSumVectorFunctionMapView) {
   MapInputBenchmark benchmark;
   benchmark.runNested("nested_map_sum_vector_mapview");
 }
+
+BENCHMARK(mapSubscripts) {
+  MapInputBenchmark benchmark;
+  benchmark.runSubscripts(false);
+}
+
+BENCHMARK_RELATIVE(mapSubscriptsSortedKeys) {
+  MapInputBenchmark benchmark;
+  benchmark.runSubscripts(true);
+}
 } // namespace
 
 int main(int argc, char** argv) {
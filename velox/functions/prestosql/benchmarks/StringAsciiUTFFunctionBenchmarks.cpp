@@ -114,6 +114,31 @@ class StringAsciiUTFFunctionBenchmark
     doRun(exprSet, rowVector);
   }
 
+  // Evaluates 'expression' over strings of 100 characters in c0.
+  void runUnary(const std::string& expression, bool utf) {
+    folly::BenchmarkSuspender suspender;
+
+    VectorFuzzer::Options opts;
+    if (utf) {
+      opts.charEncodings.clear();
+      opts.charEncodings = {
+          UTF8CharList::UNICODE_CASE_SENSITIVE,
+          UTF8CharList::EXTENDED_UNICODE,
+          UTF8CharList::MATHEMATICAL_SYMBOLS};
+    }
+
+    opts.stringLength = 100;
+    opts.vectorSize = 10'000;
+    VectorFuzzer fuzzer(opts, execCtx_.pool());
+    auto vector = fuzzer.fuzzFlat(VARCHAR());
+
+    auto rowVector = vectorMaker_.rowVector({vector});
+    auto exprSet = compileExpression(expression, rowVector->type());
+
+    suspender.dismiss();
+    doRun(exprSet, rowVector);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     uint32_t cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -172,6 +197,46 @@ BENCHMARK_RELATIVE(aciiRPad) {
   StringAsciiUTFFunctionBenchmark benchmark;
   benchmark.runLPadRPad("rpad", false);
 }
+
+BENCHMARK(utfLength) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("length(c0)", true);
+}
+
+BENCHMARK_RELATIVE(asciiLength) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("length(c0)", false);
+}
+
+BENCHMARK(utfStrPos) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("strpos(c0, 'xyz')", true);
+}
+
+BENCHMARK_RELATIVE(asciiStrPos) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("strpos(c0, 'xyz')", false);
+}
+
+BENCHMARK(utfReverse) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("reverse(c0)", true);
+}
+
+BENCHMARK_RELATIVE(asciiReverse) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("reverse(c0)", false);
+}
+
+BENCHMARK(utfTrim) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("trim(c0)", true);
+}
+
+BENCHMARK_RELATIVE(asciiTrim) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("trim(c0)", false);
+}
 } // namespace
 
 // Preliminary release run, before ascii optimization.
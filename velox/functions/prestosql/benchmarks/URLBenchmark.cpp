@@ -165,6 +165,7 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
  public:
   UrlBenchmark() : FunctionBenchmarkBase() {
     functions::prestosql::registerURLFunctions();
+    functions::prestosql::registerStringFunctions();
 
     // Register folly based implementations.
     registerFunction<FollyUrlExtractFragmentFunction, Varchar, Varchar>(
@@ -186,12 +187,9 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
         Varchar>({"folly_url_extract_parameter"});
   }
 
-  void runUrlExtract(const std::string& fnName, bool isParameter = false) {
-    folly::BenchmarkSuspender suspender;
-
-    size_t size = 1000;
+  VectorPtr makeUrls(size_t size) {
     std::string url;
-    auto vectorUrls = vectorMaker_.flatVector<StringView>(
+    return vectorMaker_.flatVector<StringView>(
         size,
         [&](auto row) {
           // construct some pseudo random url
@@ -203,6 +201,13 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
           return StringView(url);
         },
         nullptr);
+  }
+
+  void runUrlExtract(const std::string& fnName, bool isParameter = false) {
+    folly::BenchmarkSuspender suspender;
+
+    size_t size = 1000;
+    auto vectorUrls = makeUrls(size);
     auto constVector =
         BaseVector::createConstant(VARCHAR(), "k1", size, pool());
     auto rowVector = isParameter
@@ -218,6 +223,18 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, rowVector);
   }
 
+  // Evaluates 'expression' over the urls in column c0.
+  void runExpression(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+
+    auto rowVector = vectorMaker_.rowVector({makeUrls(1000)});
+    auto exprSet = compileExpression(expression, rowVector->type());
+
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     uint32_t cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -297,6 +314,26 @@ BENCHMARK_RELATIVE(velox_param) {
   benchmark.runUrlExtract("url_extract_parameter", true);
 }
 
+BENCHMARK(velox_host_and_path) {
+  UrlBenchmark benchmark;
+  benchmark.runExpression("concat(url_extract_host(c0), url_extract_path(c0))");
+}
+
+BENCHMARK(split_part_path) {
+  UrlBenchmark benchmark;
+  benchmark.runExpression("split_part(c0, '/', 4)");
+}
+
+BENCHMARK(split_part_query) {
+  UrlBenchmark benchmark;
+  benchmark.runExpression("split_part(c0, 'p.php?', 2)");
+}
+
+BENCHMARK(split_url) {
+  UrlBenchmark benchmark;
+  benchmark.runExpression("split(c0, '/')");
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
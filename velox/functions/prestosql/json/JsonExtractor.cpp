@@ -16,12 +16,14 @@
 
 #include "velox/functions/prestosql/json/JsonExtractor.h"
 
+#include <array>
 #include <cctype>
 #include <unordered_map>
 #include <vector>
 
 #include "boost/algorithm/string/trim.hpp"
 #include "folly/String.h"
+#include "folly/hash/Hash.h"
 #include "folly/json.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/functions/prestosql/json/JsonPathTokenizer.h"
@@ -166,6 +168,47 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
   }
 }
 
+// Parsed documents of the last calls in this thread. Slots are chosen by the
+// address of the text, which is the same when several functions read one
+// vector. A hit also requires the same text, since buffers are reused.
+class JsonDocumentCache {
+ public:
+  const folly::dynamic& parse(folly::StringPiece json) {
+    if (json.size() > kMaxCachedSize) {
+      uncached_ = folly::parseJson(json);
+      return uncached_;
+    }
+    auto& entry = entries_[folly::hash::twang_mix64(
+                               reinterpret_cast<uint64_t>(json.data())) %
+                           kNumEntries];
+    if (entry.valid && folly::StringPiece(entry.text) == json) {
+      return entry.document;
+    }
+    entry.valid = false;
+    entry.document = folly::parseJson(json);
+    entry.text.assign(json.data(), json.size());
+    entry.valid = true;
+    return entry.document;
+  }
+
+ private:
+  // Enough for the default batch size. Bounds the text kept per thread to
+  // 4MB.
+  static constexpr size_t kNumEntries = 1024;
+  static constexpr size_t kMaxCachedSize = 4 << 10;
+
+  struct Entry {
+    bool valid{false};
+    std::string text;
+    folly::dynamic document;
+  };
+
+  std::array<Entry, kNumEntries> entries_;
+  folly::dynamic uncached_;
+};
+
+thread_local JsonDocumentCache kDocumentCache;
+
 bool isScalarType(const folly::Optional<folly::dynamic>& json) {
   return json.has_value() && !json->isObject() && !json->isArray() &&
       !json->isNull();
@@ -173,6 +216,10 @@ bool isScalarType(const folly::Optional<folly::dynamic>& json) {
 
 } // namespace
 
+const folly::dynamic& parseJsonCached(folly::StringPiece json) {
+  return kDocumentCache.parse(json);
+}
+
 folly::Optional<folly::dynamic> jsonExtract(
     folly::StringPiece json,
     folly::StringPiece path) {
@@ -182,7 +229,7 @@ folly::Optional<folly::dynamic> jsonExtract(
     // json parsing failures (in which cases we return folly::none instead of
     // throw).
     auto& extractor = JsonExtractor::getInstance(path);
-    return extractor.extract(folly::parseJson(json));
+    return extractor.extract(parseJsonCached(json));
   } catch (const folly::json::parse_error&) {
   } catch (const folly::ConversionError&) {
     // Folly might throw a conversion error while parsing the input json. In
@@ -23,6 +23,14 @@
 
 namespace facebook::velox::functions {
 
+/// Returns 'json' parsed with folly::parseJson. The last parsed documents
+/// are cached per thread by address and checked by content, so JSON functions
+/// over the same column, e.g. json_extract_scalar(payload, '$.a') and
+/// json_extract_scalar(payload, '$.b'), parse each row once per batch. The
+/// returned reference is valid until the next call in the same thread. Throws
+/// like folly::parseJson on malformed input.
+const folly::dynamic& parseJsonCached(folly::StringPiece json);
+
 /**
  * Extract a json object from path
  * @param json: A json object
@@ -23,6 +23,7 @@
 using facebook::velox::VeloxUserError;
 using facebook::velox::functions::jsonExtract;
 using facebook::velox::functions::jsonExtractScalar;
+using facebook::velox::functions::parseJsonCached;
 using folly::json::parse_error;
 using namespace std::string_literals;
 
@@ -501,3 +502,24 @@ TEST(JsonExtractorTest, jsonMultipleExtractsTest) {
   ASSERT_TRUE(extract2.hasValue());
   EXPECT_EQ(jsonExtract(json, "$.store.fruit").value(), extract2.value());
 }
+
+TEST(JsonExtractorTest, parseJsonCached) {
+  std::string json = R"({"a": 1, "b": [1, 2]})";
+  const auto* document = &parseJsonCached(json);
+  EXPECT_EQ(folly::parseJson(json), *document);
+  // The same text at the same address is not parsed again.
+  EXPECT_EQ(document, &parseJsonCached(json));
+  EXPECT_EQ(jsonExtractScalar(json, "$.a"s).value(), "1");
+  EXPECT_EQ(jsonExtractScalar(json, "$.b[1]"s).value(), "2");
+
+  // Different text at the same address.
+  json[6] = '3';
+  EXPECT_EQ(parseJsonCached(json)["a"], 3);
+  EXPECT_EQ(jsonExtractScalar(json, "$.a"s).value(), "3");
+
+  json[0] = '[';
+  EXPECT_THROW(parseJsonCached(json), parse_error);
+  EXPECT_FALSE(jsonExtractScalar(json, "$.a"s).hasValue());
+  json[0] = '{';
+  EXPECT_EQ(parseJsonCached(json)["a"], 3);
+}
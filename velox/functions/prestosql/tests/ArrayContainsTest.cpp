@@ -349,4 +349,52 @@ TEST_F(ArrayContainsTest, preAllocatedNulls) {
        std::nullopt});
 }
 
+// Covers arrays shorter and longer than a SIMD batch for all numeric types,
+// with constant and non-constant search values.
+TEST_F(ArrayContainsTest, longArrays) {
+  auto test = [&](auto valueAt) {
+    using T = decltype(valueAt(0));
+    const vector_size_t numRows = 100;
+    auto arrayVector = makeArrayVector<T>(
+        numRows,
+        [](auto row) { return row; },
+        [&](auto row, auto index) { return valueAt(row + index); });
+    auto search = makeFlatVector<T>(
+        numRows, [&](auto row) { return valueAt(2 * row - 1); });
+
+    auto expected = makeFlatVector<bool>(numRows, [&](auto row) {
+      for (auto i = 0; i < row; ++i) {
+        if (valueAt(row + i) == valueAt(2 * row - 1)) {
+          return true;
+        }
+      }
+      return false;
+    });
+    auto result =
+        evaluate("contains(c0, c1)", makeRowVector({arrayVector, search}));
+    assertEqualVectors(expected, result);
+
+    const auto constantSearch = valueAt(150);
+    expected = makeFlatVector<bool>(numRows, [&](auto row) {
+      for (auto i = 0; i < row; ++i) {
+        if (valueAt(row + i) == constantSearch) {
+          return true;
+        }
+      }
+      return false;
+    });
+    result = evaluate(
+        "contains(c0, c1)",
+        makeRowVector({arrayVector, makeConstant(constantSearch, numRows)}));
+    assertEqualVectors(expected, result);
+  };
+
+  test([](auto i) { return static_cast<int8_t>(i); });
+  test([](auto i) { return static_cast<int16_t>(i * 3); });
+  test([](auto i) { return static_cast<int32_t>(i * 5); });
+  test([](auto i) { return static_cast<int64_t>(i) * 7; });
+  test([](auto i) { return static_cast<float>(i) / 2; });
+  test([](auto i) { return static_cast<double>(i) / 4; });
+}
+
 } // namespace
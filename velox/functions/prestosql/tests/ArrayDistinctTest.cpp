@@ -329,3 +329,31 @@ TEST_F(ArrayDistinctTest, constant) {
   expected = makeConstantArray<int64_t>(size, {6});
   assertEqualVectors(expected, result);
 }
+
+TEST_F(ArrayDistinctTest, arraySizes) {
+  // Arrays around the largest size deduplicated without a hash set.
+  std::vector<std::vector<std::optional<int64_t>>> input;
+  std::vector<std::vector<std::optional<int64_t>>> expected;
+  vector_size_t index = 0;
+  for (auto size = 0; size <= 40; ++size) {
+    std::vector<std::optional<int64_t>> array;
+    std::vector<std::optional<int64_t>> distinct;
+    for (auto i = 0; i < size; ++i, ++index) {
+      std::optional<int64_t> value;
+      if (index % 13 != 0) {
+        value = index % 9;
+      }
+      array.push_back(value);
+      if (std::find(distinct.begin(), distinct.end(), value) ==
+          distinct.end()) {
+        distinct.push_back(value);
+      }
+    }
+    input.push_back(std::move(array));
+    expected.push_back(std::move(distinct));
+  }
+
+  auto result = evaluate(
+      "array_distinct(c0)", makeRowVector({makeNullableArrayVector(input)}));
+  assertEqualVectors(makeNullableArrayVector(expected), result);
+}
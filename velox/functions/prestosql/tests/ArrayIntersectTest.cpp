@@ -320,3 +320,54 @@ TEST_F(ArrayIntersectTest, dictionaryEncodedElementsInConstant) {
       "array_intersect(c0, testing_dictionary_array_elements(ARRAY [2, 2, 3, 1, 2, 2]))",
       {array});
 }
+
+// Covers arrays below and above the size at which the sets switch from linear
+// search to hashing, and right-hand side arrays repeated across rows.
+TEST_F(ArrayIntersectTest, arraySizes) {
+  const vector_size_t numRows = 40;
+  auto left = makeArrayVector<int32_t>(
+      numRows,
+      [](auto row) { return row; },
+      [](auto row, auto index) { return (row + index) % 11; });
+  auto right = makeArrayVector<int32_t>(
+      numRows,
+      [](auto row) { return numRows - row; },
+      [](auto /*row*/, auto index) { return index % 8; });
+
+  std::vector<std::vector<int32_t>> intersect;
+  std::vector<std::vector<int32_t>> except;
+  for (auto row = 0; row < numRows; ++row) {
+    std::vector<int32_t> rightValues;
+    for (auto i = 0; i < numRows - row; ++i) {
+      rightValues.push_back(i % 8);
+    }
+    intersect.emplace_back();
+    except.emplace_back();
+    for (auto i = 0; i < row; ++i) {
+      const int32_t value = (row + i) % 11;
+      const bool inRight =
+          std::find(rightValues.begin(), rightValues.end(), value) !=
+          rightValues.end();
+      auto& output = inRight ? intersect.back() : except.back();
+      if (std::find(output.begin(), output.end(), value) == output.end()) {
+        output.push_back(value);
+      }
+    }
+  }
+  testExpr(
+      makeArrayVector<int32_t>(intersect),
+      "array_intersect(c0, c1)",
+      {left, right});
+  testExpr(
+      makeArrayVector<int32_t>(except), "array_except(c0, c1)", {left, right});
+
+  // All rows have the same right-hand side array.
+  auto repeatedRight = wrapInDictionary(
+      makeIndices(numRows, [](auto /*row*/) { return 0; }), numRows, right);
+  auto result = evaluate<ArrayVector>(
+      "array_intersect(c0, c1)", makeRowVector({left, repeatedRight}));
+  auto expected = evaluate<ArrayVector>(
+      "array_intersect(c0, c1)", makeRowVector({left, flatten(repeatedRight)}));
+  assertEqualVectors(expected, result);
+}
+
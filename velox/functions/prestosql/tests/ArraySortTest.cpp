@@ -465,6 +465,57 @@ TEST_P(ArraySortTest, encodedElements) {
   assertEqualVectors(expected, result);
 }
 
+// Covers the insertion sort, radix sort and std::sort paths for arrays of
+// different sizes, with and without nulls.
+TEST_F(ArraySortTest, arraySizes) {
+  const std::vector<vector_size_t> sizes = {0, 1, 2, 16, 17, 255, 256, 1000};
+
+  auto test = [&](auto valueAt, bool withNulls) {
+    using T = decltype(valueAt(0));
+    std::vector<std::vector<std::optional<T>>> input;
+    std::vector<std::vector<std::optional<T>>> expected;
+    vector_size_t index = 0;
+    for (auto size : sizes) {
+      std::vector<std::optional<T>> array;
+      std::vector<T> sorted;
+      for (auto i = 0; i < size; ++i, ++index) {
+        if (withNulls && index % 7 == 0) {
+          array.push_back(std::nullopt);
+        } else {
+          array.push_back(valueAt(index));
+          sorted.push_back(valueAt(index));
+        }
+      }
+      std::sort(sorted.begin(), sorted.end());
+      std::vector<std::optional<T>> sortedArray(sorted.begin(), sorted.end());
+      sortedArray.resize(array.size(), std::nullopt);
+      input.push_back(std::move(array));
+      expected.push_back(std::move(sortedArray));
+    }
+    auto result = evaluate(
+        "array_sort(c0)", makeRowVector({makeNullableArrayVector(input)}));
+    assertEqualVectors(makeNullableArrayVector(expected), result);
+  };
+
+  for (auto withNulls : {false, true}) {
+    SCOPED_TRACE(fmt::format("withNulls: {}", withNulls));
+    test([](auto row) { return static_cast<int8_t>(row * 37); }, withNulls);
+    test([](auto row) { return static_cast<int16_t>(row * 7919); }, withNulls);
+    test(
+        [](auto row) { return static_cast<int32_t>(row * 2654435761); },
+        withNulls);
+    test(
+        [](auto row) { return static_cast<int64_t>(row * 7) - 3000; },
+        withNulls);
+    test(
+        [](auto row) {
+          return static_cast<int64_t>(row * 0x9E3779B97F4A7C15ULL);
+        },
+        withNulls);
+    test([](auto row) { return (row % 101) * -0.5; }, withNulls);
+  }
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     ArraySortTest,
     ArraySortTest,
@@ -553,6 +553,22 @@ class SimdComparisonsTest : public functions::test::FunctionBaseTest {
     }
   }
 
+  // Null inputs deselect rows. The remaining rows are still compared with
+  // SIMD.
+  void testFlatWithNulls(vector_size_t size) {
+    auto lhs = makeFlatVector<T>(
+        size, [](auto row) { return row % 7; }, nullEvery(3));
+    auto rhs = makeFlatVector<T>(
+        size, [](auto row) { return row % 5; }, nullEvery(11));
+    auto result = evaluate<SimpleVector<bool>>(
+        fmt::format("{}(c0, c1)", sqlFn), makeRowVector({lhs, rhs}));
+    auto expected = makeFlatVector<bool>(
+        size,
+        [](auto row) { return ComparisonOp()(T(row % 7), T(row % 5)); },
+        [](auto row) { return row % 3 == 0 || row % 11 == 0; });
+    test::assertEqualVectors(expected, result);
+  }
+
   void testDictionary() {
     // Identity mapping, however this will result in non-simd path.
     auto makeDictionary = [&](const std::vector<T>& data) {
@@ -594,6 +610,12 @@ TYPED_TEST(SimdComparisonsTest, flat) {
   this->testFlat();
 }
 
+TYPED_TEST(SimdComparisonsTest, flatWithNulls) {
+  this->testFlatWithNulls(7);
+  this->testFlatWithNulls(64);
+  this->testFlatWithNulls(1'027);
+}
+
 TYPED_TEST(SimdComparisonsTest, dictionary) {
   this->testDictionary();
 }
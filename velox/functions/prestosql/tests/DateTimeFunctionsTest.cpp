@@ -17,6 +17,7 @@
 #include <optional>
 #include <string>
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/functions/lib/TimeUtils.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/type/tz/TimeZoneMap.h"
@@ -724,6 +725,50 @@ TEST_F(DateTimeFunctionsTest, hour) {
   EXPECT_EQ(8, hour(Timestamp(998423705, 321000000)));
 }
 
+TEST_F(DateTimeFunctionsTest, toDateTime) {
+  // Compare with gmtime_r() at 2000 points over 1600 years around the epoch,
+  // which covers leap years and negative times. The step is an odd number of
+  // seconds to hit all the times of day.
+  constexpr int64_t kStep = 25'000'001;
+  for (int64_t seconds = -25'000'000'000; seconds < 25'000'000'000;
+       seconds += kStep) {
+    std::tm expected;
+    ASSERT_NE(nullptr, gmtime_r((const time_t*)&seconds, &expected));
+    std::tm actual;
+    ASSERT_TRUE(functions::toDateTime(seconds, actual));
+    ASSERT_EQ(expected.tm_sec, actual.tm_sec) << seconds;
+    ASSERT_EQ(expected.tm_min, actual.tm_min) << seconds;
+    ASSERT_EQ(expected.tm_hour, actual.tm_hour) << seconds;
+    ASSERT_EQ(expected.tm_mday, actual.tm_mday) << seconds;
+    ASSERT_EQ(expected.tm_mon, actual.tm_mon) << seconds;
+    ASSERT_EQ(expected.tm_year, actual.tm_year) << seconds;
+    ASSERT_EQ(expected.tm_wday, actual.tm_wday) << seconds;
+    ASSERT_EQ(expected.tm_yday, actual.tm_yday) << seconds;
+  }
+}
+
+TEST_F(DateTimeFunctionsTest, hourAcrossTimeZoneTransitions) {
+  // Every 20 minutes for 2 days around the start and the end of daylight
+  // saving time in 2022 in Los Angeles.
+  std::vector<Timestamp> timestamps;
+  for (int64_t start : {1'647'072'000, 1'667'606'400}) {
+    for (auto i = 0; i < 144; ++i) {
+      timestamps.emplace_back(start + i * 1'200, 0);
+    }
+  }
+  std::vector<int64_t> expected;
+  const auto* timeZone = date::locate_zone("America/Los_Angeles");
+  for (auto timestamp : timestamps) {
+    timestamp.toTimezone(*timeZone);
+    expected.push_back(timestamp.getSeconds() / 3'600 % 24);
+  }
+
+  setQueryTimeZone("America/Los_Angeles");
+  auto result = evaluate<SimpleVector<int64_t>>(
+      "hour(c0)", makeRowVector({makeFlatVector(timestamps)}));
+  assertEqualVectors(makeFlatVector(expected), result);
+}
+
 TEST_F(DateTimeFunctionsTest, hourTimestampWithTimezone) {
   EXPECT_EQ(
       20,
@@ -247,6 +247,21 @@ TEST_F(DecimalArithmeticTest, multiply) {
       "multiply(c0, c1)",
       {longFlat, longFlat});
 
+  // Multiply long and long with values at the limits of 64 bits and beyond.
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+  testDecimalExpr<TypeKind::LONG_DECIMAL>(
+      makeLongDecimalFlatVector(
+          {buildInt128(0x3FFFFFFFFFFFFFFF, 1),
+           buildInt128(0x4000000000000000, 0),
+           -buildInt128(0x3FFFFFFFFFFFFFFF, 0x8000000000000000),
+           buildInt128(2, 0)},
+          DECIMAL(38, 0)),
+      "multiply(c0, c1)",
+      {makeLongDecimalFlatVector(
+           {kMax, kMin, kMin, buildInt128(1, 0)}, DECIMAL(20, 0)),
+       makeLongDecimalFlatVector({kMax, kMin, kMax, 2}, DECIMAL(19, 0))});
+
   // Multiply short and short, returning short.
   shortFlat = makeShortDecimalFlatVector({1000, 2000}, DECIMAL(6, 3));
   testDecimalExpr<TypeKind::SHORT_DECIMAL>(
@@ -140,6 +140,37 @@ TEST_F(ElementAtTest, mapWithDictionaryKeys) {
   }
 }
 
+TEST_F(ElementAtTest, mapWithSortedKeys) {
+  // 10 maps of 40 keys each in descending order. Map 'row' has keys
+  // [row, row + 40) and the value of key 'k' is k * 10.
+  auto mapVector = makeMapVector<int64_t, int64_t>(
+      10,
+      [](auto /*row*/) { return 40; },
+      [](auto idx) { return idx / 40 + 39 - idx % 40; },
+      [](auto idx) { return (idx / 40 + 39 - idx % 40) * 10; });
+  MapVector::canonicalize(mapVector);
+  ASSERT_TRUE(mapVector->hasSortedKeys());
+
+  auto keys = makeFlatVector<int64_t>({0, 1, 41, 3, 100, 44, 45, 6, 8, 9});
+  auto expected = makeNullableFlatVector<int64_t>(
+      {0, 10, 410, 30, std::nullopt, 440, 450, std::nullopt, 80, 90});
+  auto result =
+      evaluate("element_at(c0, c1)", makeRowVector({mapVector, keys}));
+  test::assertEqualVectors(expected, result);
+
+  expected = makeFlatVector<int64_t>(10, [](auto /*row*/) { return 390; });
+  result = evaluate("c0[39]", makeRowVector({mapVector}));
+  test::assertEqualVectors(expected, result);
+
+  // Constant key over a dictionary that repeats the maps.
+  auto dictionary = wrapInDictionary(
+      makeIndices(100, [](auto row) { return row % 3; }), 100, mapVector);
+  expected = makeFlatVector<int64_t>(
+      100, [](auto /*row*/) { return 400; }, nullEvery(3));
+  result = evaluate("element_at(c0, 40)", makeRowVector({dictionary}));
+  test::assertEqualVectors(expected, result);
+}
+
 TEST_F(ElementAtTest, arrayWithDictionaryElements) {
   {
     auto elementsIndices = makeIndices({6, 5, 4, 3, 2, 1, 0});
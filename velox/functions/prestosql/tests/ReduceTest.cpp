@@ -180,3 +180,40 @@ TEST_F(ReduceTest, try) {
       makeNullableFlatVector<int64_t>({std::nullopt, std::nullopt, 0});
   assertEqualVectors(expectedResult, result);
 }
+
+// Arrays of very different lengths finish at different steps. Also covers
+// lambdas that return one of their arguments as is.
+TEST_F(ReduceTest, varyingLengths) {
+  vector_size_t size = 1'000;
+  auto sizeAt = [](auto row) { return row % 7 == 0 ? row % 200 : row % 3; };
+  auto input = makeRowVector({makeArrayVector<int64_t>(
+      size,
+      sizeAt,
+      [](auto row, auto index) { return row + index; },
+      nullEvery(13))});
+
+  auto result = evaluate("reduce(c0, 0, (s, x) -> s + x, s -> s)", input);
+  auto expected = makeFlatVector<int64_t>(
+      size,
+      [&](auto row) {
+        int64_t sum = 0;
+        for (auto i = 0; i < sizeAt(row); i++) {
+          sum += row + i;
+        }
+        return sum;
+      },
+      nullEvery(13));
+  assertEqualVectors(expected, result);
+
+  result = evaluate("reduce(c0, -1, (s, x) -> x, s -> s)", input);
+  expected = makeFlatVector<int64_t>(
+      size,
+      [&](auto row) { return sizeAt(row) == 0 ? -1 : row + sizeAt(row) - 1; },
+      nullEvery(13));
+  assertEqualVectors(expected, result);
+
+  result = evaluate("reduce(c0, -1, (s, x) -> s, s -> s)", input);
+  expected = makeFlatVector<int64_t>(
+      size, [](auto /*row*/) { return -1; }, nullEvery(13));
+  assertEqualVectors(expected, result);
+}
@@ -80,5 +80,18 @@ TEST_F(SplitPartTest, basic) {
   EXPECT_EQ("", split_part("зелёное небоలేదాలేదాలేదా緑の空లేదా", "లేదా", 5));
   EXPECT_FALSE(split_part("зелёное небоలేదాలేదాలేదా緑の空లేదా", "లేదా", 6));
 }
+
+// Parts longer than a SIMD batch.
+TEST_F(SplitPartTest, longParts) {
+  const std::string a(100, 'a');
+  const std::string b = std::string(70, 'b') + "::" + std::string(30, 'b');
+  const std::string input = a + ":::" + b + ":::" + a + ":";
+  EXPECT_EQ(a, split_part(input, ":::", 1));
+  EXPECT_EQ(b, split_part(input, ":::", 2));
+  EXPECT_EQ(a + ":", split_part(input, ":::", 3));
+  EXPECT_FALSE(split_part(input, ":::", 4).has_value());
+  EXPECT_EQ(std::string(30, 'b'), split_part(input, ":", 6));
+  EXPECT_EQ("", split_part(input, ":", 10));
+}
 } // namespace
 } // namespace facebook::velox::functions::test
@@ -101,6 +101,28 @@ TEST_F(URLFunctionsTest, validateURL) {
   validate("foo", "", "", "", "", "", std::nullopt);
 }
 
+TEST_F(URLFunctionsTest, validateAuthority) {
+  validate(
+      "http://user:pw@[::1]:80/x?q#f", "http", "[::1]", "/x", "f", "q", 80);
+  // The user info ends at the first '@'.
+  validate("http://a@b@c:1/x", "http", "b@c", "/x", "", "", 1);
+  validate("http://a:b@host:/p", "http", "host", "/p", "", "", std::nullopt);
+  // Invalid authority.
+  validate("http://[::1/x", "http", "", "", "", "", std::nullopt);
+  validate("http://host:8a/p", "http", "", "", "", "", std::nullopt);
+  // No authority.
+  validate(
+      "mailto:someone@example.com",
+      "mailto",
+      "",
+      "someone@example.com",
+      "",
+      "",
+      std::nullopt);
+  validate("http:?q#a#b", "http", "", "", "a#b", "q", std::nullopt);
+  validate("http:#a?b", "http", "", "", "a?b", "", std::nullopt);
+}
+
 TEST_F(URLFunctionsTest, extractParameter) {
   const auto extractParam = [&](const std::optional<std::string>& a,
                                 const std::optional<std::string>& b) {
@@ -75,6 +75,26 @@ TEST_P(RankTest, basic) {
   testWindowFunction({makeSimpleVector(50)});
 }
 
+// Tests all functions with disk spilling so that the partitions are read back
+// from the spilled runs.
+TEST_P(RankTest, spill) {
+  std::vector<RowVectorPtr> vectors;
+  for (int i = 0; i < 5; ++i) {
+    vectors.push_back(makeSimpleVector(50));
+  }
+  testWindowFunctionWithSpill(vectors, function_, {overClause_});
+}
+
+// Tests all functions with input sorted on the partition and sort keys, so
+// that the partitions are computed as the input arrives.
+TEST_P(RankTest, sortedInput) {
+  std::vector<RowVectorPtr> vectors;
+  for (int i = 0; i < 5; ++i) {
+    vectors.push_back(makeSimpleVector(50));
+  }
+  testWindowFunctionWithSortedInput(vectors, function_, {overClause_});
+}
+
 // Tests all functions with a dataset with all rows in a single partition.
 TEST_P(RankTest, singlePartition) {
   testWindowFunction({makeSinglePartitionVector(50)});
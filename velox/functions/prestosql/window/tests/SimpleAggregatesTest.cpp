@@ -127,6 +127,47 @@ TEST_F(StringAggregatesTest, nonFixedWidthAggregate) {
   testWindowFunction(input, "max(c2)", kOverClauses);
 }
 
+class LargeFrameTest : public WindowTestBase {};
+
+// Tests frames that are large enough to be aggregated from the segment tree
+// over the partition or by sliding the previous frame.
+TEST_F(LargeFrameTest, slidingFrames) {
+  const vector_size_t size = 3'000;
+  auto input = {makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 2; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row % 17 - 8; }, nullEvery(7)),
+      // Mostly nulls, so that some frames have only nulls.
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row; },
+          [](auto row) { return row % 500 >= 4; }),
+  })};
+
+  const std::vector<std::string> frameClauses = {
+      "rows between 100 preceding and current row",
+      "rows between 300 preceding and 50 following",
+      "rows between current row and 200 following",
+      "rows between 40 following and unbounded following",
+      "rows between 100 preceding and 50 preceding",
+      "range between 150 preceding and 150 following",
+  };
+  for (const auto& function :
+       {"sum(c2)",
+        "min(c2)",
+        "max(c2)",
+        "count(c2)",
+        "count(1)",
+        "avg(c2)",
+        "sum(c3)",
+        "count(c3)",
+        "max(c3)"}) {
+    testWindowFunction(
+        input, function, {"partition by c0 order by c1"}, frameClauses);
+  }
+}
+
 class KPrecedingFollowingTest : public WindowTestBase {
  public:
   const std::vector<std::string> kRangeFrames = {
@@ -207,6 +248,21 @@ TEST_F(KPrecedingFollowingTest, rangeFrames3) {
   }
 }
 
+TEST_F(KPrecedingFollowingTest, rangeFramesDescending) {
+  // Partitions of many rows with repeated sort keys, so that the frame bounds
+  // are swept over many peer groups.
+  constexpr vector_size_t kSize = 1'000;
+  auto vectors = makeRowVector({
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row % 97 / 3; }),
+      makeFlatVector<int32_t>(kSize, [](auto row) { return row % 3; }),
+  });
+  for (const auto& overClause :
+       {"partition by c1 order by c0 desc", "order by c0 desc"}) {
+    testWindowFunction({vectors}, "count(c0)", {overClause}, kRangeFrames);
+    testWindowFunction({vectors}, "sum(c0)", {overClause}, kRangeFrames);
+  }
+}
+
 TEST_F(KPrecedingFollowingTest, rowsFrames) {
   auto vectors = makeRowVector({
       makeFlatVector<int64_t>({1, 1, 2147483650, 3, 2, 2147483650}),
@@ -19,8 +19,10 @@
 #include <boost/random/uniform_int_distribution.hpp>
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 
 using namespace facebook::velox::exec::test;
@@ -124,6 +126,84 @@ void WindowTestBase::testWindowFunction(
   }
 }
 
+void WindowTestBase::testWindowFunctionWithSpill(
+    const std::vector<RowVectorPtr>& input,
+    const std::string& function,
+    const std::vector<std::string>& overClauses) {
+  createDuckDbTable(input);
+  for (const auto& overClause : overClauses) {
+    auto queryInfo = buildWindowQuery(input, function, overClause, "");
+    SCOPED_TRACE(queryInfo.functionSql);
+    auto spillDirectory = TempDirectoryPath::create();
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kTestingSpillPct, "100"},
+        {core::QueryConfig::kSpillEnabled, "true"},
+        {core::QueryConfig::kWindowSpillEnabled, "true"},
+    });
+    CursorParameters params;
+    params.planNode = queryInfo.planNode;
+    params.queryCtx = queryCtx;
+    params.spillDirectory = spillDirectory->path;
+    auto task = assertQuery(params, queryInfo.querySql);
+
+    const auto windowNode =
+        std::dynamic_pointer_cast<const core::WindowNode>(queryInfo.planNode);
+    const auto& windowStats =
+        toPlanStats(task->taskStats()).at(windowNode->id());
+    // Spilling is only supported with partition keys. The first input batch
+    // never spills.
+    if (windowNode->partitionKeys().empty() || input.size() < 2) {
+      EXPECT_EQ(0, windowStats.spilledBytes);
+    } else {
+      EXPECT_LT(0, windowStats.spilledBytes);
+      EXPECT_EQ(1, windowStats.spilledPartitions);
+      EXPECT_LT(0, windowStats.spilledFiles);
+    }
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+}
+
+void WindowTestBase::testWindowFunctionWithSortedInput(
+    const std::vector<RowVectorPtr>& input,
+    const std::string& function,
+    const std::vector<std::string>& overClauses) {
+  createDuckDbTable(input);
+  for (const auto& overClause : overClauses) {
+    auto queryInfo = buildWindowQuery(input, function, overClause, "");
+    SCOPED_TRACE(queryInfo.functionSql);
+    const auto windowNode =
+        std::dynamic_pointer_cast<const core::WindowNode>(queryInfo.planNode);
+    std::vector<std::string> sortingKeys;
+    for (const auto& key : windowNode->partitionKeys()) {
+      sortingKeys.push_back(key->name());
+    }
+    for (auto i = 0; i < windowNode->sortingKeys().size(); ++i) {
+      sortingKeys.push_back(fmt::format(
+          "{} {}",
+          windowNode->sortingKeys()[i]->name(),
+          windowNode->sortingOrders()[i].toString()));
+    }
+
+    PlanBuilder plan;
+    plan.values(input);
+    if (!sortingKeys.empty()) {
+      plan.orderBy(sortingKeys, false);
+    }
+    plan.streamingWindow({queryInfo.functionSql});
+
+    // Small batches so that the partitions span several input batches.
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kPreferredOutputBatchRows, "7"},
+    });
+    CursorParameters params;
+    params.planNode = plan.planNode();
+    params.queryCtx = queryCtx;
+    assertQuery(params, queryInfo.querySql);
+  }
+}
+
 void WindowTestBase::testKRangeFrames(const std::string& function) {
   // The current support for k Range frames is limited to ascending sort
   // orders without null values. Frames clauses generating empty frames
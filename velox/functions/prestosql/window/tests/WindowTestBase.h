@@ -157,6 +157,24 @@ class WindowTestBase : public exec::test::OperatorTestBase {
       const std::vector<std::string>& overClauses,
       const std::vector<std::string>& frameClauses = {""});
 
+  /// This function tests SQL queries for the window function and the
+  /// specified overClauses with the input RowVectors with disk spilling
+  /// enabled. It is expected that the window operator spills if the
+  /// overClause has partition keys and there is more than one input RowVector.
+  void testWindowFunctionWithSpill(
+      const std::vector<RowVectorPtr>& input,
+      const std::string& function,
+      const std::vector<std::string>& overClauses);
+
+  /// This function tests SQL queries for the window function and the
+  /// specified overClauses with the input RowVectors sorted on the partition
+  /// and sort keys by an OrderBy in small batches. The window is computed with
+  /// a streaming WindowNode for sorted input.
+  void testWindowFunctionWithSortedInput(
+      const std::vector<RowVectorPtr>& input,
+      const std::string& function,
+      const std::vector<std::string>& overClauses);
+
   void testKRangeFrames(const std::string& function);
 
   /// This function tests the SQL query for the window function and overClause
@@ -25,6 +25,36 @@
 namespace facebook::velox::functions::sparksql {
 namespace {
 
+// Hashes the 'rows' of 'decoded' into 'rawResult', using the hash of the
+// previous column in 'rawResult' as the seed. Flat columns are hashed in a
+// tight loop over their values, which the compiler can unroll and vectorize
+// for fixed-width types.
+template <typename T, typename ReturnType, typename HashOne>
+void hashColumn(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    ReturnType* rawResult,
+    HashOne hashOne) {
+  if constexpr (!std::is_same_v<T, bool>) {
+    if (decoded.isIdentityMapping()) {
+      auto* rawValues = decoded.data<T>();
+      if (rows.isAllSelected()) {
+        for (auto row = rows.begin(); row < rows.end(); ++row) {
+          rawResult[row] = hashOne(rawValues[row], rawResult[row]);
+        }
+      } else {
+        rows.applyToSelected([&](auto row) {
+          rawResult[row] = hashOne(rawValues[row], rawResult[row]);
+        });
+      }
+      return;
+    }
+  }
+  rows.applyToSelected([&](auto row) {
+    rawResult[row] = hashOne(decoded.valueAt<T>(row), rawResult[row]);
+  });
+}
+
 // ReturnType can be either int32_t or int64_t
 // HashClass contains the function like hashInt32
 template <typename ReturnType, typename HashClass, typename SeedType>
@@ -43,7 +73,9 @@ void applyWithType(
   HashClass hash;
 
   auto& result = *resultRef->as<FlatVector<ReturnType>>();
-  rows.applyToSelected([&](int row) { result.set(row, seed); });
+  result.clearNulls(rows);
+  auto* rawResult = result.mutableRawValues();
+  rows.applyToSelected([&](int row) { rawResult[row] = seed; });
 
   exec::LocalSelectivityVector selectedMinusNulls(context);
 
@@ -62,10 +94,13 @@ void applyWithType(
 // https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
 #define CASE(typeEnum, hashFn, inputType)                                      \
   case TypeKind::typeEnum:                                                     \
-    selected->applyToSelected([&](int row) {                                   \
-      result.set(                                                              \
-          row, hashFn(decoded->valueAt<inputType>(row), result.valueAt(row))); \
-    });                                                                        \
+    hashColumn<inputType>(                                                     \
+        *decoded,                                                              \
+        *selected,                                                             \
+        rawResult,                                                             \
+        [&](const inputType& value, ReturnType previous) {                     \
+          return static_cast<ReturnType>(hashFn(value, previous));             \
+        });                                                                    \
     break;
       CASE(BOOLEAN, hash.hashInt32, bool);
       CASE(TINYINT, hash.hashInt32, int8_t);
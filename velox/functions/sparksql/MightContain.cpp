@@ -43,10 +43,18 @@ class BloomFilterMightContainFunction final : public exec::VectorFunction {
     if (!bloomFilter_.isSet()) {
       rows.applyToSelected([&](int row) { result.set(row, false); });
     } else {
+      // Hashes the values first and probes the Bloom filter in batches.
+      std::vector<uint64_t> hashes;
+      hashes.reserve(rows.countSelected());
       rows.applyToSelected([&](int row) {
-        auto contain = bloomFilter_.mayContain(
+        hashes.push_back(
             folly::hasher<int64_t>()(value->valueAt<int64_t>(row)));
-        result.set(row, contain);
+      });
+      std::vector<uint64_t> contained(bits::nwords(hashes.size()));
+      bloomFilter_.mayContain(hashes.data(), hashes.size(), contained.data());
+      int32_t i = 0;
+      rows.applyToSelected([&](int row) {
+        result.set(row, bits::isBitSet(contained.data(), i++));
       });
     }
   }
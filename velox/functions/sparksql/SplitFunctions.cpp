@@ -55,7 +55,7 @@ class SplitCharacter final : public exec::VectorFunction {
       const char* delim;
       do {
         delim = std::find(pos, end, pattern_);
-        arrayWriter.add_item().setNoCopy(StringView(pos, delim - pos));
+        arrayWriter.add_item_no_copy(StringView(pos, delim - pos));
         pos = delim + 1; // Skip past delim.
       } while (delim != end);
 
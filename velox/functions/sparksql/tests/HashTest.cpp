@@ -89,6 +89,30 @@ TEST_F(HashTest, StringInt32) {
   EXPECT_EQ(hash("", 0), 1143746540);
 }
 
+TEST_F(HashTest, multipleRows) {
+  auto bigints = makeFlatVector<int64_t>({0, 1, -1, INT64_MAX});
+  auto expected = makeFlatVector<int32_t>(
+      {-1670924195, -1712319331, -939490007, -1604625029});
+  velox::test::assertEqualVectors(
+      expected, evaluate("hash(c0)", makeRowVector({bigints})));
+
+  // Same values in reverse order through a dictionary.
+  auto reversed = wrapInDictionary(makeIndicesInReverse(4), bigints);
+  expected = makeFlatVector<int32_t>(
+      {-1604625029, -939490007, -1712319331, -1670924195});
+  velox::test::assertEqualVectors(
+      expected, evaluate("hash(c0)", makeRowVector({reversed})));
+
+  // Two columns with nulls hash the second column into the first.
+  auto strings =
+      makeNullableFlatVector<std::string>({"", std::nullopt, "", std::nullopt});
+  auto ints =
+      makeNullableFlatVector<int32_t>({std::nullopt, 0, 0, std::nullopt});
+  expected = makeFlatVector<int32_t>({142593372, 933211791, 1143746540, 42});
+  velox::test::assertEqualVectors(
+      expected, evaluate("hash(c0, c1)", makeRowVector({strings, ints})));
+}
+
 TEST_F(HashTest, Double) {
   using limits = std::numeric_limits<double>;
 
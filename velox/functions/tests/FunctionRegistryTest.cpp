@@ -16,6 +16,7 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <thread>
 
 #include "velox/expression/Expr.h"
 #include "velox/expression/FunctionSignature.h"
@@ -562,4 +563,43 @@ TEST_F(FunctionRegistryTest, resolveCast) {
       velox::VeloxRuntimeError);
 }
 
+TEST_F(FunctionRegistryTest, resolutionCache) {
+  // Calls that match no function are cached and resolve after registering a
+  // matching function.
+  EXPECT_EQ(resolveFunction("cached_func", {BIGINT()}), nullptr);
+  EXPECT_EQ(resolveFunction("cached_func", {BIGINT()}), nullptr);
+  registerFunction<FuncFive, int64_t, int64_t>({"cached_func"});
+  checkEqual(resolveFunction("cached_func", {BIGINT()}), BIGINT());
+
+  EXPECT_EQ(resolveVectorFunction("cached_vector_func", {VARCHAR()}), nullptr);
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_vector_func_one, "cached_vector_func");
+  checkEqual(
+      resolveVectorFunction("cached_vector_func", {VARCHAR()}), BIGINT());
+  EXPECT_NE(
+      exec::resolveVectorFunctionFactory("Cached_Vector_Func", {VARCHAR()}),
+      nullptr);
+  EXPECT_EQ(
+      exec::resolveVectorFunctionFactory("cached_vector_func", {BIGINT()}),
+      nullptr);
+
+  // Many threads resolve the same calls at the same time.
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < 1'000; ++j) {
+        checkEqual(
+            resolveFunction("func_two", {BIGINT(), SMALLINT()}), BIGINT());
+        checkEqual(resolveFunction("func_two", {BIGINT(), BIGINT()}), nullptr);
+        checkEqual(resolveFunction("vector_func_one", {VARCHAR()}), BIGINT());
+        checkEqual(
+            resolveFunction("func_three_alias1", {ARRAY(BIGINT())}),
+            ARRAY(BIGINT()));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 } // namespace facebook::velox
@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/row/UnsafeRowBatchSerde.h"
+
+#include "velox/row/UnsafeRowDeserializers.h"
+#include "velox/row/UnsafeRowSerializers.h"
+
+namespace facebook::velox::row {
+
+namespace {
+
+// The kinds serialized into the fixed width slot of a row.
+bool isFixedWidthKind(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isStringKind(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+// Writes the offset and size of variable length data to a fixed width slot.
+void writeDataPointer(char* slot, size_t offset, size_t size) {
+  *reinterpret_cast<uint64_t*>(slot) = offset << 32 | size;
+}
+
+// Returns the size and the offset from the fixed width slot of variable
+// length data.
+std::pair<uint32_t, uint32_t> readDataPointer(const char* slot) {
+  uint64_t pointer;
+  memcpy(&pointer, slot, sizeof(pointer));
+  return {
+      static_cast<uint32_t>(pointer), static_cast<uint32_t>(pointer >> 32)};
+}
+
+bool isNullAt(const std::optional<std::string_view>& row, size_t column) {
+  return !row.has_value() || bits::isBitSet(row->data(), column);
+}
+
+template <TypeKind Kind>
+VectorPtr deserializeFixedWidth(
+    const std::vector<std::optional<std::string_view>>& data,
+    const TypePtr& type,
+    size_t slot,
+    size_t column,
+    memory::MemoryPool* pool) {
+  using Traits = ScalarTraits<Kind>;
+  using T = typename Traits::InMemoryType;
+  using Serialized = typename Traits::SerializedType;
+  constexpr bool kRawCopy =
+      std::is_same_v<T, Serialized> && Kind != TypeKind::BOOLEAN;
+
+  const auto numRows = data.size();
+  auto vector = BaseVector::create<FlatVector<T>>(type, numRows, pool);
+  T* rawValues = nullptr;
+  if constexpr (kRawCopy) {
+    rawValues = vector->mutableRawValues();
+  }
+  uint64_t* rawNulls = nullptr;
+  vector_size_t nullCount = 0;
+  for (auto i = 0; i < numRows; ++i) {
+    if (isNullAt(data[i], column)) {
+      if (!rawNulls) {
+        rawNulls = vector->mutableRawNulls();
+      }
+      bits::setNull(rawNulls, i);
+      ++nullCount;
+      continue;
+    }
+    Serialized value;
+    memcpy(&value, data[i]->data() + slot, sizeof(Serialized));
+    if constexpr (kRawCopy) {
+      rawValues[i] = value;
+    } else {
+      Traits::set(vector.get(), i, value);
+    }
+  }
+  if (rawNulls) {
+    vector->setNullCount(nullCount);
+  }
+  return vector;
+}
+
+VectorPtr deserializeStrings(
+    const std::vector<std::optional<std::string_view>>& data,
+    const TypePtr& type,
+    size_t slot,
+    size_t column,
+    memory::MemoryPool* pool) {
+  const auto numRows = data.size();
+  size_t totalSize = 0;
+  for (auto i = 0; i < numRows; ++i) {
+    if (!isNullAt(data[i], column)) {
+      totalSize += readDataPointer(data[i]->data() + slot).first;
+    }
+  }
+
+  auto vector = BaseVector::create<FlatVector<StringView>>(type, numRows, pool);
+  auto* rawValues = vector->mutableRawValues();
+  BufferPtr buffer = AlignedBuffer::allocate<char>(totalSize, pool);
+  auto* rawBuffer = buffer->asMutable<char>();
+  uint64_t* rawNulls = nullptr;
+  vector_size_t nullCount = 0;
+  for (auto i = 0; i < numRows; ++i) {
+    if (isNullAt(data[i], column)) {
+      if (!rawNulls) {
+        rawNulls = vector->mutableRawNulls();
+      }
+      bits::setNull(rawNulls, i);
+      ++nullCount;
+      continue;
+    }
+    const char* row = data[i]->data();
+    auto [size, offset] = readDataPointer(row + slot);
+    memcpy(rawBuffer, row + offset, size);
+    rawValues[i] = StringView(rawBuffer, size);
+    rawBuffer += size;
+  }
+  if (rawNulls) {
+    vector->setNullCount(nullCount);
+  }
+  if (totalSize > 0) {
+    vector->setStringBuffers({std::move(buffer)});
+  }
+  return vector;
+}
+
+// Deserializes a column with UnsafeRowDeserializer, the same way as
+// UnsafeRowDeserializer::convertStructIteratorsToVectors().
+VectorPtr deserializeOther(
+    const std::vector<std::optional<std::string_view>>& data,
+    const TypePtr& type,
+    size_t slot,
+    size_t column,
+    size_t numFields,
+    memory::MemoryPool* pool) {
+  const size_t fixedSize =
+      type->isFixedWidth() ? serializedSizeInBytes(type) : 0;
+  std::vector<std::optional<std::string_view>> columnData(data.size());
+  for (auto i = 0; i < data.size(); ++i) {
+    if (isNullAt(data[i], column)) {
+      continue;
+    }
+    const char* row = data[i]->data();
+    if (fixedSize > 0) {
+      columnData[i] = std::string_view(row + slot, fixedSize);
+    } else {
+      auto [size, offset] = readDataPointer(row + slot);
+      columnData[i] = std::string_view(row + offset, size);
+    }
+  }
+  return UnsafeRowDeserializer::deserialize(
+      columnData, type, pool, numFields, column);
+}
+
+} // namespace
+
+UnsafeRowBatchSerializer::UnsafeRowBatchSerializer(const RowVectorPtr& input)
+    : input_(input),
+      nullLength_(UnsafeRow::getNullLength(input->childrenSize())),
+      fixedRowSize_(
+          nullLength_ + input->childrenSize() * UnsafeRow::kFieldWidthBytes) {
+  const auto numColumns = input_->childrenSize();
+  children_.reserve(numColumns);
+  decoded_.resize(numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    children_.push_back(BaseVector::loadedVectorShared(input_->childAt(i)));
+    const auto kind = children_[i]->typeKind();
+    if (isFixedWidthKind(kind) || isStringKind(kind)) {
+      decoded_[i].decode(*children_[i]);
+    } else if (
+        kind != TypeKind::ARRAY && kind != TypeKind::MAP &&
+        kind != TypeKind::ROW) {
+      VELOX_UNSUPPORTED(
+          "Unsupported type: {}", children_[i]->type()->toString());
+    }
+  }
+}
+
+void UnsafeRowBatchSerializer::rowSizes(
+    folly::Range<const vector_size_t*> rows,
+    size_t* sizes) const {
+  std::fill(sizes, sizes + rows.size(), fixedRowSize_);
+  for (auto column = 0; column < children_.size(); ++column) {
+    const auto& type = children_[column]->type();
+    if (isFixedWidthKind(type->kind())) {
+      continue;
+    }
+    if (isStringKind(type->kind())) {
+      const auto& decoded = decoded_[column];
+      for (auto i = 0; i < rows.size(); ++i) {
+        if (!decoded.isNullAt(rows[i])) {
+          sizes[i] += UnsafeRow::alignToFieldWidth(
+              decoded.valueAt<StringView>(rows[i]).size());
+        }
+      }
+      continue;
+    }
+    for (auto i = 0; i < rows.size(); ++i) {
+      sizes[i] += UnsafeRow::alignToFieldWidth(
+          UnsafeRowSerializer::getSize(type, children_[column], rows[i]));
+    }
+  }
+
+  // A null row is empty, as in UnsafeRowSerializer::getSizeRow().
+  if (input_->mayHaveNulls()) {
+    for (auto i = 0; i < rows.size(); ++i) {
+      if (input_->isNullAt(rows[i])) {
+        sizes[i] = 0;
+      }
+    }
+  }
+}
+
+void UnsafeRowBatchSerializer::serialize(
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer) const {
+  if (input_->mayHaveNulls()) {
+    std::vector<vector_size_t> nonNullRows;
+    std::vector<size_t> nonNullOffsets;
+    for (auto i = 0; i < rows.size(); ++i) {
+      if (!input_->isNullAt(rows[i])) {
+        nonNullRows.push_back(rows[i]);
+        nonNullOffsets.push_back(offsets[i]);
+      }
+    }
+    serializeNonNull(
+        folly::Range(nonNullRows.data(), nonNullRows.size()),
+        nonNullOffsets.data(),
+        buffer);
+    return;
+  }
+  serializeNonNull(rows, offsets, buffer);
+}
+
+void UnsafeRowBatchSerializer::serializeNonNull(
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer) const {
+  // The offset of the next variable length data of each row from the start
+  // of the row.
+  std::vector<size_t> variableOffsets(rows.size(), fixedRowSize_);
+  for (auto column = 0; column < children_.size(); ++column) {
+    switch (children_[column]->typeKind()) {
+#define FIXED_WIDTH(kind)                                               \
+  case TypeKind::kind:                                                  \
+    serializeFixedWidth<TypeKind::kind>(column, rows, offsets, buffer); \
+    break;
+      FIXED_WIDTH(BOOLEAN);
+      FIXED_WIDTH(TINYINT);
+      FIXED_WIDTH(SMALLINT);
+      FIXED_WIDTH(INTEGER);
+      FIXED_WIDTH(BIGINT);
+      FIXED_WIDTH(REAL);
+      FIXED_WIDTH(DOUBLE);
+      FIXED_WIDTH(TIMESTAMP);
+      FIXED_WIDTH(DATE);
+#undef FIXED_WIDTH
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        serializeStrings(column, rows, offsets, buffer, variableOffsets);
+        break;
+      default:
+        serializeComplex(column, rows, offsets, buffer, variableOffsets);
+        break;
+    }
+  }
+}
+
+template <TypeKind Kind>
+void UnsafeRowBatchSerializer::serializeFixedWidth(
+    column_index_t column,
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer) const {
+  using Traits = ScalarTraits<Kind>;
+  using T = typename Traits::InMemoryType;
+  using Serialized = typename Traits::SerializedType;
+  const auto& decoded = decoded_[column];
+  const size_t slot = nullLength_ + column * UnsafeRow::kFieldWidthBytes;
+  if (!decoded.mayHaveNulls()) {
+    if constexpr (
+        std::is_same_v<T, Serialized> && Kind != TypeKind::BOOLEAN) {
+      if (decoded.isIdentityMapping()) {
+        const auto* values = decoded.data<T>();
+        for (auto i = 0; i < rows.size(); ++i) {
+          *reinterpret_cast<T*>(buffer + offsets[i] + slot) = values[rows[i]];
+        }
+        return;
+      }
+    }
+    for (auto i = 0; i < rows.size(); ++i) {
+      *reinterpret_cast<Serialized*>(buffer + offsets[i] + slot) =
+          Traits::get(decoded, rows[i]);
+    }
+    return;
+  }
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (decoded.isNullAt(rows[i])) {
+      bits::setBit(buffer + offsets[i], column);
+    } else {
+      *reinterpret_cast<Serialized*>(buffer + offsets[i] + slot) =
+          Traits::get(decoded, rows[i]);
+    }
+  }
+}
+
+void UnsafeRowBatchSerializer::serializeStrings(
+    column_index_t column,
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer,
+    std::vector<size_t>& variableOffsets) const {
+  const auto& decoded = decoded_[column];
+  const size_t slot = nullLength_ + column * UnsafeRow::kFieldWidthBytes;
+  for (auto i = 0; i < rows.size(); ++i) {
+    char* row = buffer + offsets[i];
+    if (decoded.isNullAt(rows[i])) {
+      bits::setBit(row, column);
+      continue;
+    }
+    const auto value = decoded.valueAt<StringView>(rows[i]);
+    auto& offset = variableOffsets[i];
+    memcpy(row + offset, value.data(), value.size());
+    writeDataPointer(row + slot, offset, value.size());
+    offset += UnsafeRow::alignToFieldWidth(value.size());
+  }
+}
+
+void UnsafeRowBatchSerializer::serializeComplex(
+    column_index_t column,
+    folly::Range<const vector_size_t*> rows,
+    const size_t* offsets,
+    char* buffer,
+    std::vector<size_t>& variableOffsets) const {
+  const auto& child = children_[column];
+  const size_t slot = nullLength_ + column * UnsafeRow::kFieldWidthBytes;
+  for (auto i = 0; i < rows.size(); ++i) {
+    char* row = buffer + offsets[i];
+    auto& offset = variableOffsets[i];
+    auto size = UnsafeRowSerializer::serialize(child, row + offset, rows[i]);
+    if (!size.has_value()) {
+      bits::setBit(row, column);
+      continue;
+    }
+    writeDataPointer(row + slot, offset, size.value());
+    offset += UnsafeRow::alignToFieldWidth(size.value());
+  }
+}
+
+// static
+RowVectorPtr UnsafeRowBatchDeserializer::deserialize(
+    const std::vector<std::optional<std::string_view>>& data,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) {
+  const auto numRows = data.size();
+  const auto numFields = type->size();
+  const auto nullLength = UnsafeRow::getNullLength(numFields);
+
+  BufferPtr nulls;
+  for (auto i = 0; i < numRows; ++i) {
+    if (!data[i].has_value()) {
+      if (!nulls) {
+        nulls = allocateNulls(numRows, pool);
+      }
+      bits::setNull(nulls->asMutable<uint64_t>(), i);
+    }
+  }
+
+  std::vector<VectorPtr> children(numFields);
+  for (auto column = 0; column < numFields; ++column) {
+    const auto& childType = type->childAt(column);
+    const size_t slot = nullLength + column * UnsafeRow::kFieldWidthBytes;
+    switch (childType->kind()) {
+#define FIXED_WIDTH(kind)                                     \
+  case TypeKind::kind:                                        \
+    children[column] = deserializeFixedWidth<TypeKind::kind>( \
+        data, childType, slot, column, pool);                 \
+    break;
+      FIXED_WIDTH(BOOLEAN);
+      FIXED_WIDTH(TINYINT);
+      FIXED_WIDTH(SMALLINT);
+      FIXED_WIDTH(INTEGER);
+      FIXED_WIDTH(BIGINT);
+      FIXED_WIDTH(REAL);
+      FIXED_WIDTH(DOUBLE);
+      FIXED_WIDTH(TIMESTAMP);
+      FIXED_WIDTH(DATE);
+#undef FIXED_WIDTH
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        children[column] =
+            deserializeStrings(data, childType, slot, column, pool);
+        break;
+      default:
+        children[column] = deserializeOther(
+            data, childType, slot, column, numFields, pool);
+        break;
+    }
+  }
+  return std::make_shared<RowVector>(
+      pool, type, std::move(nulls), numRows, std::move(children));
+}
+
+} // namespace facebook::velox::row
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::row {
+
+/// Serializes many rows of a RowVector into UnsafeRow format a column at a
+/// time. The sizes of the rows are computed column by column, the values of
+/// fixed width columns are written with one strided loop per column and
+/// strings are copied without per row type dispatch. Only the values of
+/// ARRAY, MAP and ROW columns are serialized row by row with
+/// UnsafeRowSerializer. The result is the same as UnsafeRowSerializer's for
+/// each row written into a zeroed buffer.
+class UnsafeRowBatchSerializer {
+ public:
+  explicit UnsafeRowBatchSerializer(const RowVectorPtr& input);
+
+  /// Sets sizes[i] to the serialized size of row rows[i] of 'input'.
+  void rowSizes(folly::Range<const vector_size_t*> rows, size_t* sizes) const;
+
+  /// Serializes row rows[i] of 'input' at buffer + offsets[i]. Each row
+  /// must have the space given by rowSizes(). The space must be zeroed.
+  void serialize(
+      folly::Range<const vector_size_t*> rows,
+      const size_t* offsets,
+      char* buffer) const;
+
+ private:
+  // serialize() for rows that are not null.
+  void serializeNonNull(
+      folly::Range<const vector_size_t*> rows,
+      const size_t* offsets,
+      char* buffer) const;
+
+  template <TypeKind Kind>
+  void serializeFixedWidth(
+      column_index_t column,
+      folly::Range<const vector_size_t*> rows,
+      const size_t* offsets,
+      char* buffer) const;
+
+  void serializeStrings(
+      column_index_t column,
+      folly::Range<const vector_size_t*> rows,
+      const size_t* offsets,
+      char* buffer,
+      std::vector<size_t>& variableOffsets) const;
+
+  void serializeComplex(
+      column_index_t column,
+      folly::Range<const vector_size_t*> rows,
+      const size_t* offsets,
+      char* buffer,
+      std::vector<size_t>& variableOffsets) const;
+
+  const RowVectorPtr input_;
+
+  // Size of the null bits of a row.
+  const size_t nullLength_;
+
+  // Size of the null bits and the fixed width slots of a row.
+  const size_t fixedRowSize_;
+
+  // The loaded children of 'input_'.
+  std::vector<VectorPtr> children_;
+
+  // 'children_' decoded. Used for the scalar columns.
+  std::vector<DecodedVector> decoded_;
+};
+
+/// Deserializes UnsafeRows of 'type' a column at a time. The values of fixed
+/// width and string columns are read with one loop per column directly from
+/// the rows. ARRAY, MAP, ROW and decimal columns are deserialized with
+/// UnsafeRowDeserializer. String values are copied into one buffer per
+/// column, so 'data' does not need to outlive the result. A std::nullopt row
+/// is a null row.
+struct UnsafeRowBatchDeserializer {
+  static RowVectorPtr deserialize(
+      const std::vector<std::optional<std::string_view>>& data,
+      const RowTypePtr& type,
+      memory::MemoryPool* pool);
+};
+
+} // namespace facebook::velox::row
@@ -18,17 +18,22 @@
 #include <folly/init/Init.h>
 #include <random>
 
+#include "velox/row/UnsafeRowBatchSerde.h"
 #include "velox/row/UnsafeRowDeserializers.h"
 #include "velox/row/UnsafeRowSerializers.h"
+#include "velox/row/experimental/UnsafeRow24Deserializer.h"
 #include "velox/type/Type.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
-#include "velox/vector/tests/utils/VectorMaker.h"
+
+/// Compares the throughput of UnsafeRowDeserializer, which deserializes one
+/// row at a time, with UnsafeRowBatchDeserializer and UnsafeRow24Deserializer,
+/// which deserialize a column at a time, for rows of fixed width, string,
+/// nested and mixed types.
 
 namespace facebook::spark::benchmarks {
 namespace {
 using namespace facebook::velox;
 using namespace facebook::velox::row;
-using facebook::velox::test::VectorMaker;
 
 class Deserializer {
  public:
@@ -36,72 +41,133 @@ class Deserializer {
   virtual void deserialize(
       const std::vector<std::optional<std::string_view>>& data,
       const TypePtr& type) = 0;
+
+ protected:
+  std::shared_ptr<memory::MemoryPool> pool_ =
+      memory::addDefaultLeafMemoryPool();
 };
 
-class UnsaferowBatchDeserializer : public Deserializer {
+class UnsaferowDeserializer : public Deserializer {
  public:
-  UnsaferowBatchDeserializer() {}
-
   void deserialize(
       const std::vector<std::optional<std::string_view>>& data,
       const TypePtr& type) override {
     UnsafeRowDeserializer::deserialize(data, type, pool_.get());
   }
+};
 
- private:
-  std::shared_ptr<memory::MemoryPool> pool_ =
-      memory::addDefaultLeafMemoryPool();
+class UnsaferowBatchDeserializer : public Deserializer {
+ public:
+  void deserialize(
+      const std::vector<std::optional<std::string_view>>& data,
+      const TypePtr& type) override {
+    UnsafeRowBatchDeserializer::deserialize(data, asRowType(type), pool_.get());
+  }
+};
+
+class Unsaferow24Deserializer : public Deserializer {
+ public:
+  void deserialize(
+      const std::vector<std::optional<std::string_view>>& data,
+      const TypePtr& type) override {
+    std::vector<const char*> rows(data.size());
+    for (auto i = 0; i < data.size(); ++i) {
+      rows[i] = data[i].has_value() ? data[i]->data() : nullptr;
+    }
+    UnsafeRow24Deserializer::Create(asRowType(type))
+        ->DeserializeRows(pool_.get(), rows);
+  }
 };
 
+enum class TypeMix { kFixedWidth, kStrings, kNested, kAll };
+
 class BenchmarkHelper {
  public:
   std::tuple<std::vector<std::optional<std::string_view>>, TypePtr>
-  randomUnsaferows(int nFields, int nRows, bool stringOnly) {
-    RowTypePtr rowType;
+  randomUnsaferows(int nFields, int nRows, TypeMix typeMix) {
+    const auto& candidates = typesOf(typeMix);
     std::vector<std::string> names;
     std::vector<TypePtr> types;
     names.reserve(nFields);
     types.reserve(nFields);
     for (int32_t i = 0; i < nFields; ++i) {
-      names.push_back("");
-      if (stringOnly) {
-        types.push_back(VARCHAR());
-      } else {
-        auto idx = folly::Random::rand32() % allTypes_.size();
-        types.push_back(allTypes_[idx]);
-      }
+      names.push_back(fmt::format("f{}", i));
+      types.push_back(candidates[i % candidates.size()]);
     }
-    rowType =
-        TypeFactory<TypeKind::ROW>::create(std::move(names), std::move(types));
+    auto rowType = ROW(std::move(names), std::move(types));
 
     VectorFuzzer::Options opts;
-    opts.vectorSize = 1;
+    opts.vectorSize = nRows;
     opts.nullRatio = 0.1;
+    opts.containerHasNulls = false;
+    opts.dictionaryHasNulls = false;
     opts.stringVariableLength = true;
     opts.stringLength = 20;
+    opts.containerLength = 5;
     // Spark uses microseconds to store timestamp
     opts.timestampPrecision =
         VectorFuzzer::Options::TimestampPrecision::kMicroSeconds;
 
-    auto seed = folly::Random::rand32();
-    VectorFuzzer fuzzer(opts, pool_.get(), seed);
-    const auto& inputVector = fuzzer.fuzzRow(rowType);
+    VectorFuzzer fuzzer(opts, pool_.get(), 1);
+    const auto inputVector = fuzzer.fuzzInputRow(rowType);
+
+    // Serialize rowVector into bytes. The rows refer to 'buffer_', which
+    // lives as long as the helper.
+    std::vector<size_t> offsets(nRows);
+    size_t totalSize = 0;
+    for (int32_t i = 0; i < nRows; ++i) {
+      offsets[i] = totalSize;
+      totalSize += UnsafeRowSerializer::getSizeRow(inputVector.get(), i);
+    }
+    buffer_.assign(totalSize, '\0');
     std::vector<std::optional<std::string_view>> results;
     results.reserve(nRows);
-    // Serialize rowVector into bytes.
     for (int32_t i = 0; i < nRows; ++i) {
-      BufferPtr bufferPtr =
-          AlignedBuffer::allocate<char>(1024, pool_.get(), true);
-      char* buffer = bufferPtr->asMutable<char>();
-      auto rowSize =
-          UnsafeRowSerializer::serialize(inputVector, buffer, /*idx=*/0);
-      results.push_back(std::string_view(buffer, rowSize.value()));
+      auto rowSize = UnsafeRowSerializer::serialize(
+          inputVector, buffer_.data() + offsets[i], /*idx=*/i);
+      results.push_back(
+          std::string_view(buffer_.data() + offsets[i], rowSize.value()));
     }
     return {results, rowType};
   }
 
  private:
-  std::vector<TypePtr> allTypes_{
+  const std::vector<TypePtr>& typesOf(TypeMix typeMix) const {
+    switch (typeMix) {
+      case TypeMix::kFixedWidth:
+        return fixedWidthTypes_;
+      case TypeMix::kStrings:
+        return stringTypes_;
+      case TypeMix::kNested:
+        return nestedTypes_;
+      case TypeMix::kAll:
+        return allTypes_;
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  const std::vector<TypePtr> fixedWidthTypes_{
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      TIMESTAMP(),
+      DATE()};
+
+  const std::vector<TypePtr> stringTypes_{VARCHAR()};
+
+  const std::vector<TypePtr> nestedTypes_{
+      ARRAY(INTEGER()),
+      ARRAY(VARCHAR()),
+      ARRAY(ARRAY(BIGINT())),
+      MAP(VARCHAR(), ARRAY(INTEGER())),
+      ROW({INTEGER(), VARCHAR()}),
+      ARRAY(ROW({BIGINT(), DOUBLE()}))};
+
+  const std::vector<TypePtr> allTypes_{
       BOOLEAN(),
       TINYINT(),
       SMALLINT(),
@@ -111,23 +177,25 @@ class BenchmarkHelper {
       DOUBLE(),
       VARCHAR(),
       TIMESTAMP(),
+      DATE(),
       ARRAY(INTEGER()),
       MAP(VARCHAR(), ARRAY(INTEGER())),
       ROW({INTEGER()})};
 
   std::shared_ptr<memory::MemoryPool> pool_ =
       memory::addDefaultLeafMemoryPool();
+  std::string buffer_;
 };
 
 int deserialize(
     int nIters,
     int nFields,
     int nRows,
-    bool variable,
+    TypeMix typeMix,
     std::unique_ptr<Deserializer> deserializer) {
   folly::BenchmarkSuspender suspender;
   BenchmarkHelper helper;
-  auto [data, rowType] = helper.randomUnsaferows(nFields, nRows, variable);
+  auto [data, rowType] = helper.randomUnsaferows(nFields, nRows, typeMix);
   suspender.dismiss();
 
   for (int i = 0; i < nIters; i++) {
@@ -137,37 +205,38 @@ int deserialize(
   return nIters * nFields * nRows;
 }
 
-BENCHMARK_NAMED_PARAM_MULTI(
-    deserialize,
-    batch_10_100k_string_only,
-    10,
-    100000,
-    true,
-    std::make_unique<UnsaferowBatchDeserializer>());
-
-BENCHMARK_NAMED_PARAM_MULTI(
-    deserialize,
-    batch_100_100k_string_only,
-    100,
-    100000,
-    true,
-    std::make_unique<UnsaferowBatchDeserializer>());
-
-BENCHMARK_NAMED_PARAM_MULTI(
-    deserialize,
-    batch_10_100k_all_types,
-    10,
-    100000,
-    false,
-    std::make_unique<UnsaferowBatchDeserializer>());
-
-BENCHMARK_NAMED_PARAM_MULTI(
-    deserialize,
-    batch_100_100k_all_types,
-    100,
-    100000,
-    false,
-    std::make_unique<UnsaferowBatchDeserializer>());
+#define DESERIALIZE_BENCHMARKS(name, nFields, typeMix)   \
+  BENCHMARK_NAMED_PARAM_MULTI(                           \
+      deserialize,                                       \
+      row_##name,                                        \
+      nFields,                                           \
+      100000,                                            \
+      typeMix,                                           \
+      std::make_unique<UnsaferowDeserializer>());        \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(                  \
+      deserialize,                                       \
+      batch_##name,                                      \
+      nFields,                                           \
+      100000,                                            \
+      typeMix,                                           \
+      std::make_unique<UnsaferowBatchDeserializer>());   \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(                  \
+      deserialize,                                       \
+      row24_##name,                                      \
+      nFields,                                           \
+      100000,                                            \
+      typeMix,                                           \
+      std::make_unique<Unsaferow24Deserializer>());      \
+  BENCHMARK_DRAW_LINE()
+
+DESERIALIZE_BENCHMARKS(10_100k_fixed_width, 10, TypeMix::kFixedWidth);
+DESERIALIZE_BENCHMARKS(10_100k_string_only, 10, TypeMix::kStrings);
+DESERIALIZE_BENCHMARKS(100_100k_string_only, 100, TypeMix::kStrings);
+DESERIALIZE_BENCHMARKS(10_100k_nested, 10, TypeMix::kNested);
+DESERIALIZE_BENCHMARKS(10_100k_all_types, 10, TypeMix::kAll);
+DESERIALIZE_BENCHMARKS(100_100k_all_types, 100, TypeMix::kAll);
+
+#undef DESERIALIZE_BENCHMARKS
 
 } // namespace
 } // namespace facebook::spark::benchmarks
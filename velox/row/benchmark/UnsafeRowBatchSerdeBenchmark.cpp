@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/row/UnsafeRowBatchSerde.h"
+#include "velox/row/UnsafeRowDeserializers.h"
+#include "velox/row/UnsafeRowSerializers.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+/// Compares serializing and deserializing UnsafeRows one row at a time with
+/// UnsafeRowSerializer and UnsafeRowDeserializer against doing it a column at
+/// a time with UnsafeRowBatchSerializer and UnsafeRowBatchDeserializer.
+
+namespace facebook::spark::benchmarks {
+namespace {
+using namespace facebook::velox;
+using namespace facebook::velox::row;
+
+class UnsafeRowBatchSerdeBenchmark {
+ public:
+  void setUp(RowTypePtr rowType) {
+    rowType_ = std::move(rowType);
+    VectorFuzzer::Options opts;
+    opts.vectorSize = 10'000;
+    opts.nullRatio = 0.1;
+    opts.containerHasNulls = false;
+    opts.dictionaryHasNulls = false;
+    opts.stringVariableLength = true;
+    opts.stringLength = 20;
+    opts.containerLength = 5;
+    // Spark uses microseconds to store timestamp
+    opts.timestampPrecision =
+        VectorFuzzer::Options::TimestampPrecision::kMicroSeconds;
+    VectorFuzzer fuzzer(opts, pool_.get(), 1);
+    input_ = fuzzer.fuzzInputRow(rowType_);
+    rows_.resize(input_->size());
+    std::iota(rows_.begin(), rows_.end(), 0);
+
+    // The input of the deserialize benchmarks.
+    serializeBatch();
+    serializedBuffer_ = buffer_;
+    serialized_.clear();
+    for (auto i = 0; i < rows_.size(); ++i) {
+      serialized_.push_back(
+          std::string_view(serializedBuffer_.data() + offsets_[i], sizes_[i]));
+    }
+  }
+
+  size_t serializeRows() {
+    UnsafeRowSerializer::preloadVector(input_);
+    sizes_.resize(rows_.size());
+    size_t totalSize = 0;
+    for (auto i = 0; i < rows_.size(); ++i) {
+      sizes_[i] = UnsafeRowSerializer::getSizeRow(input_.get(), i);
+      totalSize += sizes_[i];
+    }
+    buffer_.assign(totalSize, 0);
+    size_t offset = 0;
+    for (auto i = 0; i < rows_.size(); ++i) {
+      UnsafeRowSerializer::serialize(input_, buffer_.data() + offset, i);
+      offset += sizes_[i];
+    }
+    return offset;
+  }
+
+  size_t serializeBatch() {
+    UnsafeRowBatchSerializer serializer(input_);
+    sizes_.resize(rows_.size());
+    serializer.rowSizes(
+        folly::Range(rows_.data(), rows_.size()), sizes_.data());
+    offsets_.resize(rows_.size());
+    size_t totalSize = 0;
+    for (auto i = 0; i < rows_.size(); ++i) {
+      offsets_[i] = totalSize;
+      totalSize += sizes_[i];
+    }
+    buffer_.assign(totalSize, 0);
+    serializer.serialize(
+        folly::Range(rows_.data(), rows_.size()),
+        offsets_.data(),
+        buffer_.data());
+    return totalSize;
+  }
+
+  vector_size_t deserializeRows() {
+    return UnsafeRowDeserializer::deserialize(
+               serialized_, rowType_, pool_.get())
+        ->size();
+  }
+
+  vector_size_t deserializeBatch() {
+    return UnsafeRowBatchDeserializer::deserialize(
+               serialized_, rowType_, pool_.get())
+        ->size();
+  }
+
+ private:
+  std::shared_ptr<memory::MemoryPool> pool_ =
+      memory::addDefaultLeafMemoryPool();
+  RowTypePtr rowType_;
+  RowVectorPtr input_;
+  std::vector<vector_size_t> rows_;
+  std::vector<size_t> sizes_;
+  std::vector<size_t> offsets_;
+  std::vector<char> buffer_;
+  std::vector<char> serializedBuffer_;
+  std::vector<std::optional<std::string_view>> serialized_;
+};
+
+UnsafeRowBatchSerdeBenchmark fixedWidthBm;
+UnsafeRowBatchSerdeBenchmark stringBm;
+UnsafeRowBatchSerdeBenchmark complexBm;
+
+BENCHMARK(serializeRowsFixedWidth) {
+  folly::doNotOptimizeAway(fixedWidthBm.serializeRows());
+}
+
+BENCHMARK_RELATIVE(serializeBatchFixedWidth) {
+  folly::doNotOptimizeAway(fixedWidthBm.serializeBatch());
+}
+
+BENCHMARK(serializeRowsString) {
+  folly::doNotOptimizeAway(stringBm.serializeRows());
+}
+
+BENCHMARK_RELATIVE(serializeBatchString) {
+  folly::doNotOptimizeAway(stringBm.serializeBatch());
+}
+
+BENCHMARK(serializeRowsComplex) {
+  folly::doNotOptimizeAway(complexBm.serializeRows());
+}
+
+BENCHMARK_RELATIVE(serializeBatchComplex) {
+  folly::doNotOptimizeAway(complexBm.serializeBatch());
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(deserializeRowsFixedWidth) {
+  folly::doNotOptimizeAway(fixedWidthBm.deserializeRows());
+}
+
+BENCHMARK_RELATIVE(deserializeBatchFixedWidth) {
+  folly::doNotOptimizeAway(fixedWidthBm.deserializeBatch());
+}
+
+BENCHMARK(deserializeRowsString) {
+  folly::doNotOptimizeAway(stringBm.deserializeRows());
+}
+
+BENCHMARK_RELATIVE(deserializeBatchString) {
+  folly::doNotOptimizeAway(stringBm.deserializeBatch());
+}
+
+BENCHMARK(deserializeRowsComplex) {
+  folly::doNotOptimizeAway(complexBm.deserializeRows());
+}
+
+BENCHMARK_RELATIVE(deserializeBatchComplex) {
+  folly::doNotOptimizeAway(complexBm.deserializeBatch());
+}
+
+} // namespace
+} // namespace facebook::spark::benchmarks
+
+int main(int argc, char** argv) {
+  using namespace facebook::velox;
+  using namespace facebook::spark::benchmarks;
+  folly::init(&argc, &argv);
+  fixedWidthBm.setUp(
+      ROW({BIGINT(), INTEGER(), SMALLINT(), DOUBLE(), REAL(), TIMESTAMP()}));
+  stringBm.setUp(ROW({BIGINT(), VARCHAR(), VARCHAR(), INTEGER()}));
+  complexBm.setUp(
+      ROW({BIGINT(), VARCHAR(), ARRAY(INTEGER()), MAP(VARCHAR(), BIGINT())}));
+  folly::runBenchmarks();
+  return 0;
+}
@@ -75,10 +75,11 @@ VectorPtr DeserializeVariableLength(
     std::vector<const char*>& valuePointers);
 
 // FixedWidth types mostly have the same representation in Vectors and
-// UnsafeRow, with the exception of bools (bitpacked) and timestamp (micros
-// only).
+// UnsafeRow, with the exception of bools (bitpacked), timestamp (micros
+// only) and short decimals (the unscaled value as an int64_t).
 template <TypeKind kind, typename ValuePointerNextCallback>
 VectorPtr DeserializeFixedWidth(
+    const TypePtr& type,
     memory::MemoryPool* pool,
     std::size_t size,
     ValuePointerNextCallback valuePointers) {
@@ -100,13 +101,16 @@ VectorPtr DeserializeFixedWidth(
     } else if constexpr (kind == TypeKind::TIMESTAMP) {
       data[i] = Timestamp::fromMicros(
           *reinterpret_cast<const int64_t*>(valuePointer));
+    } else if constexpr (kind == TypeKind::SHORT_DECIMAL) {
+      data[i] =
+          UnscaledShortDecimal(*reinterpret_cast<const int64_t*>(valuePointer));
     } else {
       data[i] = *reinterpret_cast<const T*>(valuePointer);
     }
   }
   return std::make_shared<FlatVector<T>>(
       pool,
-      ScalarType<kind>::create(),
+      type,
       hasNull ? std::move(nulls.buf_) : nullptr,
       size,
       std::move(values),
@@ -136,6 +140,38 @@ FlatVectorPtr<StringView> DeserializeString(
   return result;
 }
 
+// Decodes a big-endian two's complement integer of at most 16 bytes.
+int128_t decodeLongDecimal(const char* data, uint32_t size) {
+  VELOX_CHECK_LE(size, sizeof(int128_t), "Invalid long decimal size");
+  __uint128_t value = size > 0 && static_cast<int8_t>(data[0]) < 0 ? ~0 : 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    value = value << 8 | static_cast<uint8_t>(data[i]);
+  }
+  return static_cast<int128_t>(value);
+}
+
+// Long decimals are variable-length. The unscaled value is stored in the
+// minimum number of big-endian bytes, like Java's BigInteger.toByteArray().
+VectorPtr DeserializeLongDecimal(
+    const TypePtr& type,
+    memory::MemoryPool* pool,
+    const std::vector<const char*>& basePointers,
+    const std::vector<const char*>& valuePointers) {
+  const vector_size_t size = valuePointers.size();
+  auto result =
+      BaseVector::create<FlatVector<UnscaledLongDecimal>>(type, size, pool);
+  auto* rawValues = result->mutableRawValues();
+  for (int i = 0; i < size; ++i) {
+    if (valuePointers[i]) {
+      auto [data, size] = decodeVarOffset(basePointers[i], valuePointers[i]);
+      rawValues[i] = UnscaledLongDecimal(decodeLongDecimal(data, size));
+    } else {
+      result->setNull(i, true);
+    }
+  }
+  return result;
+}
+
 // Memory layout:
 //   int64_t nulls[]
 //   int64_t elements[]
@@ -155,10 +191,10 @@ RowVectorPtr DeserializeRow(
       return data && !bits::isBitSet(data, field) ? data + offset : nullptr;
     };
     switch (fieldTypes[field]->kind()) {
-#define FIXED_WIDTH(kind)                                   \
-  case TypeKind::kind:                                      \
-    fields.push_back(DeserializeFixedWidth<TypeKind::kind>( \
-        pool, rows.size(), fieldPointerCallback));          \
+#define FIXED_WIDTH(kind)                                               \
+  case TypeKind::kind:                                                  \
+    fields.push_back(DeserializeFixedWidth<TypeKind::kind>(             \
+        fieldTypes[field], pool, rows.size(), fieldPointerCallback));  \
     break
       FIXED_WIDTH(BOOLEAN);
       FIXED_WIDTH(TINYINT);
@@ -169,6 +205,7 @@ RowVectorPtr DeserializeRow(
       FIXED_WIDTH(DOUBLE);
       FIXED_WIDTH(TIMESTAMP);
       FIXED_WIDTH(DATE);
+      FIXED_WIDTH(SHORT_DECIMAL);
 #undef FIXED_WIDTH
       default: {
         std::vector<const char*> fieldPointers(rows.size());
@@ -187,6 +224,7 @@ RowVectorPtr DeserializeRow(
 
 template <TypeKind kind, int stride>
 VectorPtr DeserializeFixedWidthArrayElements(
+    const TypePtr& elementType,
     memory::MemoryPool* pool,
     const std::vector<const char*>& arrays,
     const vector_size_t* const offsets,
@@ -198,7 +236,7 @@ VectorPtr DeserializeFixedWidthArrayElements(
   const char* currentNulls = nullptr;
   const char* currentData = nullptr;
   int64_t currentElementIndex = 0;
-  return DeserializeFixedWidth<kind>(pool, totalElements, [&] {
+  return DeserializeFixedWidth<kind>(elementType, pool, totalElements, [&] {
     if (UNLIKELY(currentElementIndex == lastElementIndex)) {
       // Skip forward to the next non-empty array.
       do {
@@ -251,7 +289,7 @@ ArrayVectorPtr DeserializeArray(
   case TypeKind::kind:                                              \
     elementsVector =                                                \
         DeserializeFixedWidthArrayElements<TypeKind::kind, stride>( \
-            pool, arrays, offsets, sizes);                          \
+            elementType, pool, arrays, offsets, sizes);             \
     break;
     FIXED_WIDTH(BOOLEAN, 1);
     FIXED_WIDTH(TINYINT, 1);
@@ -262,6 +300,7 @@ ArrayVectorPtr DeserializeArray(
     FIXED_WIDTH(DOUBLE, 8);
     FIXED_WIDTH(TIMESTAMP, 8);
     FIXED_WIDTH(DATE, 4);
+    FIXED_WIDTH(SHORT_DECIMAL, 8);
 #undef FIXED_WIDTH
     default: {
       std::vector<const char*> elementBases(offsets[numArrays]);
@@ -319,9 +358,7 @@ MapVectorPtr DeserializeMap(
   }
   auto values = DeserializeArray(type->valueType(), pool, maps);
   VELOX_CHECK_EQ(values->size(), numMaps);
-  VELOX_CHECK_EQ(
-      keys->offsetAt(numMaps - 1) + keys->sizeAt(numMaps - 1),
-      values->offsetAt(numMaps - 1) + values->sizeAt(numMaps - 1));
+  VELOX_CHECK_EQ(keys->elements()->size(), values->elements()->size());
   // Debug-only sanity checks.
   for (int i = 0; i < numMaps; ++i) {
     DCHECK_EQ(keys->isNullAt(i), values->isNullAt(i));
@@ -362,6 +399,8 @@ VectorPtr DeserializeVariableLength(
     case TypeKind::VARCHAR:
     case TypeKind::VARBINARY:
       return DeserializeString(type, pool, basePointers, valuePointers);
+    case TypeKind::LONG_DECIMAL:
+      return DeserializeLongDecimal(type, pool, basePointers, valuePointers);
     case TypeKind::ARRAY:
       return DeserializeArray(
           std::dynamic_pointer_cast<const ArrayType>(type)->elementType(),
@@ -378,7 +417,8 @@ VectorPtr DeserializeVariableLength(
           pool,
           resolveValuePointers());
     default:
-      VELOX_CHECK(false, "Unexpected type: {}", type->toString());
+      VELOX_UNSUPPORTED(
+          "Unsupported type for UnsafeRow: {}", type->toString());
   }
 }
 
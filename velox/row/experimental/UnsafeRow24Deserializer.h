@@ -24,10 +24,12 @@
 
 namespace facebook::velox::row {
 
-/// Caller is responsible for controlling batching.
+/// Deserializes UnsafeRows of all the types UnsafeRow supports, including
+/// nested arrays, maps and structs, decimals and timestamps, column by column
+/// instead of row by row. This is what UnsafeRowVectorSerde uses unless
+/// --velox_unsafe_row24_deserializer is false.
 ///
-/// NOTE: This is an experimental deserializer yet to be completed. It is NOT
-/// used in current codebase.
+/// Caller is responsible for controlling batching.
 class UnsafeRow24Deserializer {
  public:
   virtual ~UnsafeRow24Deserializer() = default;
@@ -603,7 +603,51 @@ TEST_F(UnsafeRowComplexDeserializerTests, nullRows) {
   }
 }
 
-TEST_F(UnsafeRowComplexDeserializerTests, DISABLED_Testfuzzer) {
+TEST_F(UnsafeRowComplexDeserializerTests, decimals) {
+  // UnsafeRowSerializer does not write decimals, so the rows are crafted by
+  // hand.
+  //
+  // row[0]
+  // {
+  //  12345,
+  //  32llu << 32 | 9,
+  //  48llu << 32 | 24,
+  //  0x01 0x00 0x00 0x00 0x00 0x00 0x00 0x00 0x00, (2^64 in big-endian)
+  //  [-7]
+  // }
+  uint64_t data0[] = {
+      0,
+      12345,
+      32llu << 32 | 9,
+      48llu << 32 | 24,
+      0x01,
+      0,
+      1,
+      0,
+      static_cast<uint64_t>(-7)};
+  // row[1], 0b001
+  // {
+  //  null,
+  //  32llu << 32 | 1,
+  //  40llu << 32 | 8,
+  //  0xFF, (-1 in big-endian)
+  //  []
+  // }
+  uint64_t data1[] = {0x01, 0, 32llu << 32 | 1, 40llu << 32 | 8, 0xFF, 0};
+  std::vector<std::optional<std::string_view>> rows{
+      std::string_view(reinterpret_cast<const char*>(data0), sizeof(data0)),
+      std::string_view(reinterpret_cast<const char*>(data1), sizeof(data1))};
+
+  auto rowType = ROW({DECIMAL(10, 2), DECIMAL(20, 3), ARRAY(DECIMAL(10, 2))});
+  auto expected = makeRowVector({
+      makeNullableShortDecimalFlatVector({12345, std::nullopt}, DECIMAL(10, 2)),
+      makeLongDecimalFlatVector({int128_t(1) << 64, -1}, DECIMAL(20, 3)),
+      makeArrayVector({0, 1}, makeShortDecimalFlatVector({-7}, DECIMAL(10, 2))),
+  });
+  assertEqualVectors(expected, deserialize(rows, rowType, this->pool_.get()));
+}
+
+TEST_F(UnsafeRowComplexDeserializerTests, fuzzer) {
   std::string buffer(100 << 20, '\0'); // Up to 100MB.
   VectorFuzzer fuzzer(
       {
@@ -618,7 +662,7 @@ TEST_F(UnsafeRowComplexDeserializerTests, DISABLED_Testfuzzer) {
       this->pool_.get(),
       0);
   for (int i = 0; i < 100; ++i) {
-    auto seed = i; // TODO: Switch to folly::Random::rand32().
+    auto seed = i;
     fuzzer.reSeed(seed);
     const auto type = fuzzer.randRowType();
     LOG(INFO) << "i=" << i << " seed=" << seed << " type=" << type->toString();
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <folly/Random.h>
+
+#include "velox/row/UnsafeRowBatchSerde.h"
+#include "velox/row/UnsafeRowSerializers.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+namespace facebook::velox::row {
+namespace {
+
+using namespace facebook::velox::test;
+
+class UnsafeRowBatchSerdeTest : public ::testing::Test,
+                                public VectorTestBase {
+ protected:
+  // Serializes 'rows' of 'input' with UnsafeRowBatchSerializer and checks
+  // that each row is the same as from UnsafeRowSerializer. Returns the
+  // serialized rows, which point into 'buffer_'.
+  std::vector<std::optional<std::string_view>> serialize(
+      const RowVectorPtr& input,
+      const std::vector<vector_size_t>& rows) {
+    UnsafeRowBatchSerializer serializer(input);
+    std::vector<size_t> sizes(rows.size());
+    serializer.rowSizes(folly::Range(rows.data(), rows.size()), sizes.data());
+    std::vector<size_t> offsets(rows.size());
+    size_t totalSize = 0;
+    for (auto i = 0; i < rows.size(); ++i) {
+      offsets[i] = totalSize;
+      totalSize += sizes[i];
+    }
+    buffer_.assign(totalSize, 0);
+    serializer.serialize(
+        folly::Range(rows.data(), rows.size()), offsets.data(), buffer_.data());
+
+    std::vector<std::optional<std::string_view>> serialized;
+    for (auto i = 0; i < rows.size(); ++i) {
+      std::vector<char> expected(sizes[i] + 64, 0);
+      UnsafeRowSerializer::preloadVector(input);
+      const auto expectedSize =
+          UnsafeRowSerializer::serialize(input, expected.data(), rows[i]);
+      EXPECT_EQ(expectedSize.value_or(0), sizes[i]) << "row " << rows[i];
+      EXPECT_EQ(
+          std::string_view(expected.data(), sizes[i]),
+          std::string_view(buffer_.data() + offsets[i], sizes[i]))
+          << "row " << rows[i];
+      serialized.push_back(
+          std::string_view(buffer_.data() + offsets[i], sizes[i]));
+    }
+    return serialized;
+  }
+
+  void testRoundTrip(const RowVectorPtr& input) {
+    std::vector<vector_size_t> rows(input->size());
+    std::iota(rows.begin(), rows.end(), 0);
+    auto serialized = serialize(input, rows);
+    auto result = UnsafeRowBatchDeserializer::deserialize(
+        serialized, asRowType(input->type()), pool());
+    assertEqualVectors(input, result);
+  }
+
+  std::vector<char> buffer_;
+};
+
+TEST_F(UnsafeRowBatchSerdeTest, fixedWidth) {
+  auto input = makeRowVector({
+      makeFlatVector<bool>(100, [](auto row) { return row % 3 == 0; }),
+      makeFlatVector<int8_t>(100, [](auto row) { return row; }),
+      makeFlatVector<int16_t>(100, [](auto row) { return row * 3; }),
+      makeFlatVector<int32_t>(
+          100, [](auto row) { return row * 7; }, nullEvery(5)),
+      makeFlatVector<int64_t>(100, [](auto row) { return row * 11; }),
+      makeFlatVector<float>(100, [](auto row) { return row * 0.5; }),
+      makeFlatVector<double>(
+          100, [](auto row) { return row * 0.25; }, nullEvery(7)),
+      makeFlatVector<Timestamp>(
+          100, [](auto row) { return Timestamp(row, row * 1'000); }),
+      makeFlatVector<Date>(100, [](auto row) { return Date(row); }),
+      // Dictionary with nulls over a flat vector.
+      wrapInDictionary(
+          makeIndicesInReverse(100),
+          100,
+          makeFlatVector<int64_t>(
+              100, [](auto row) { return row; }, nullEvery(3))),
+      makeConstant<int32_t>(17, 100),
+  });
+  testRoundTrip(input);
+}
+
+TEST_F(UnsafeRowBatchSerdeTest, strings) {
+  auto input = makeRowVector({
+      makeFlatVector<StringView>(
+          100,
+          [](auto row) {
+            return StringView(std::string(row % 30, 'a' + row % 26));
+          },
+          nullEvery(6)),
+      makeFlatVector<int32_t>(100, [](auto row) { return row; }),
+      wrapInDictionary(
+          makeIndicesInReverse(100),
+          100,
+          makeFlatVector<StringView>(100, [](auto row) {
+            return StringView(fmt::format("a longer string {}", row));
+          })),
+  });
+  testRoundTrip(input);
+
+  // A subset of the rows in a different order.
+  std::vector<vector_size_t> rows = {5, 99, 0, 6, 42};
+  auto serialized = serialize(input, rows);
+  auto result = UnsafeRowBatchDeserializer::deserialize(
+      serialized, asRowType(input->type()), pool());
+  auto indices = makeIndices(rows.size(), [&](auto row) { return rows[row]; });
+  assertEqualVectors(wrapInDictionary(indices, rows.size(), input), result);
+}
+
+TEST_F(UnsafeRowBatchSerdeTest, fuzz) {
+  auto rowType = ROW({
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      VARCHAR(),
+      TIMESTAMP(),
+      ROW({VARCHAR(), INTEGER()}),
+      ARRAY(INTEGER()),
+      MAP(VARCHAR(), ARRAY(INTEGER())),
+  });
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 100;
+  opts.nullRatio = 0.1;
+  opts.containerHasNulls = false;
+  opts.dictionaryHasNulls = false;
+  opts.stringVariableLength = true;
+  opts.stringLength = 20;
+  opts.containerVariableLength = true;
+  opts.containerLength = 10;
+  // Spark uses microseconds to store timestamp
+  opts.timestampPrecision =
+      VectorFuzzer::Options::TimestampPrecision::kMicroSeconds;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  SCOPED_TRACE(fmt::format("seed: {}", seed));
+  VectorFuzzer fuzzer(opts, pool(), seed);
+  for (auto i = 0; i < 100; ++i) {
+    testRoundTrip(fuzzer.fuzzInputRow(rowType));
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::row
@@ -29,6 +29,11 @@ constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
 constexpr folly::StringPiece kRLE{"RLE"};
+constexpr folly::StringPiece kDictionary{"DICTIONARY"};
+
+// Size of the dictionary id written after the ids of a DICTIONARY block. It is
+// two longs of a UUID and a sequence number.
+constexpr int32_t kDictionaryIdSize = 3 * sizeof(int64_t);
 
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
@@ -46,11 +51,12 @@ int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   bits::Crc32 crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -323,14 +329,76 @@ readNulls(ByteStream* source, vector_size_t size, BaseVector* result) {
   return nullCount;
 }
 
+// Releaser for a BufferView over deserialized input. Keeps the input alive.
+class InputReleaser {
+ public:
+  explicit InputReleaser(std::shared_ptr<const void> owner)
+      : owner_(std::move(owner)) {}
+
+  void addRef() const {}
+
+  void release() const {}
+
+ private:
+  const std::shared_ptr<const void> owner_;
+};
+
+// Returns true if the wire format of the values of 'T' is the same as their
+// layout in a FlatVector<T>.
+template <typename T>
+constexpr bool hasFlatWireLayout() {
+  return std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+      std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+      std::is_same_v<T, float> || std::is_same_v<T, double> ||
+      std::is_same_v<T, Date> || std::is_same_v<T, UnscaledShortDecimal>;
+}
+
+// Sets 'result' to a flat vector over the values of the column at the read
+// position of 'source' without copying them. Returns false and does not move
+// the read position if the column has nulls or if its values are not
+// contiguous and aligned in 'source'.
+template <typename T>
+bool readValuesView(
+    ByteStream* source,
+    const TypePtr& type,
+    vector_size_t size,
+    velox::memory::MemoryPool* pool,
+    const std::shared_ptr<const void>& inputOwner,
+    VectorPtr* result) {
+  // The null flag byte is followed by the values.
+  const int32_t valuesBytes = size * sizeof(T);
+  const auto* data = source->peekContiguous(1 + valuesBytes);
+  if (!data || data[0] != 0 ||
+      reinterpret_cast<uintptr_t>(data + 1) % alignof(T) != 0) {
+    return false;
+  }
+  auto values = BufferView<InputReleaser>::create(
+      data + 1, valuesBytes, InputReleaser(inputOwner));
+  source->skip(1 + valuesBytes);
+  *result = std::make_shared<FlatVector<T>>(
+      pool,
+      type,
+      BufferPtr(nullptr),
+      size,
+      std::move(values),
+      std::vector<BufferPtr>{});
+  return true;
+}
+
 template <typename T>
 void read(
     ByteStream* source,
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
-    bool useLosslessTimestamp) {
+    const PrestoVectorSerde::PrestoOptions& opts) {
   int32_t size = source->read<int32_t>();
+  if constexpr (hasFlatWireLayout<T>()) {
+    if (opts.inputOwner &&
+        readValuesView<T>(source, type, size, pool, opts.inputOwner, result)) {
+      return;
+    }
+  }
   if (*result && result->unique()) {
     (*result)->resize(size);
   } else {
@@ -342,7 +410,7 @@ void read(
 
   BufferPtr values = flatResult->mutableValues(size);
   if constexpr (std::is_same_v<T, Timestamp>) {
-    if (useLosslessTimestamp) {
+    if (opts.useLosslessTimestamp) {
       readLosslessTimestampValues(
           source, size, flatResult->nulls(), nullCount, values);
       return;
@@ -376,7 +444,7 @@ void read<StringView>(
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
-    bool useLosslessTimestamp) {
+    const PrestoVectorSerde::PrestoOptions& opts) {
   int32_t size = source->read<int32_t>();
 
   if (*result && result->unique()) {
@@ -416,28 +484,45 @@ void readColumns(
     velox::memory::MemoryPool* pool,
     const std::vector<TypePtr>& types,
     std::vector<VectorPtr>* result,
-    bool useLosslessTimestamp);
+    const PrestoVectorSerde::PrestoOptions& opts);
 
 void readConstantVector(
     ByteStream* source,
     const TypePtr& type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
-    bool useLosslessTimestamp) {
+    const PrestoVectorSerde::PrestoOptions& opts) {
   auto size = source->read<int32_t>();
   std::vector<TypePtr> childTypes = {type};
   std::vector<VectorPtr> children(1);
-  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+  readColumns(source, pool, childTypes, &children, opts);
   VELOX_CHECK_EQ(1, children[0]->size());
   *result = BaseVector::wrapInConstant(size, 0, children[0]);
 }
 
+void readDictionaryVector(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result,
+    const PrestoVectorSerde::PrestoOptions& opts) {
+  auto size = source->read<int32_t>();
+  std::vector<TypePtr> childTypes = {type};
+  std::vector<VectorPtr> children(1);
+  readColumns(source, pool, childTypes, &children, opts);
+  auto indices = allocateIndices(size, pool);
+  source->readBytes(indices->asMutable<char>(), size * sizeof(int32_t));
+  // Skip the dictionary id.
+  source->skip(kDictionaryIdSize);
+  *result = BaseVector::wrapInDictionary(nullptr, indices, size, children[0]);
+}
+
 void readArrayVector(
     ByteStream* source,
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
-    bool useLosslessTimestamp) {
+    const PrestoVectorSerde::PrestoOptions& opts) {
   ArrayVector* arrayVector =
       (*result && result->unique()) ? (*result)->as<ArrayVector>() : nullptr;
   std::vector<TypePtr> childTypes = {type->childAt(0)};
@@ -445,7 +530,7 @@ void readArrayVector(
   if (arrayVector) {
     children[0] = arrayVector->elements();
   }
-  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+  readColumns(source, pool, childTypes, &children, opts);
 
   vector_size_t size = source->read<int32_t>();
   if (arrayVector) {
@@ -476,7 +561,7 @@ void readMapVector(
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
-    bool useLosslessTimestamp) {
+    const PrestoVectorSerde::PrestoOptions& opts) {
   MapVector* mapVector =
       (*result && result->unique()) ? (*result)->as<MapVector>() : nullptr;
   std::vector<TypePtr> childTypes = {type->childAt(0), type->childAt(1)};
@@ -485,7 +570,7 @@ void readMapVector(
     children[0] = mapVector->mapKeys();
     children[1] = mapVector->mapValues();
   }
-  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+  readColumns(source, pool, childTypes, &children, opts);
 
   int32_t hashTableSize = source->read<int32_t>();
   if (hashTableSize != -1) {
@@ -532,9 +617,10 @@ void unpackTimestampWithTimeZone(
 void readTimestampWithTimeZone(
     ByteStream* source,
     velox::memory::MemoryPool* pool,
-    VectorPtr* result) {
+    VectorPtr* result,
+    const PrestoVectorSerde::PrestoOptions& opts) {
   VectorPtr timestamps;
-  read<int64_t>(source, BIGINT(), pool, &timestamps, false);
+  read<int64_t>(source, BIGINT(), pool, &timestamps, opts);
 
   auto rawTimestamps = timestamps->asFlatVector<int64_t>()->mutableRawValues();
 
@@ -564,9 +650,9 @@ void readRowVector(
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
-    bool useLosslessTimestamp) {
+    const PrestoVectorSerde::PrestoOptions& opts) {
   if (isTimestampWithTimeZoneType(type)) {
-    readTimestampWithTimeZone(source, pool, result);
+    readTimestampWithTimeZone(source, pool, result, opts);
     return;
   }
 
@@ -589,7 +675,7 @@ void readRowVector(
   }
 
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+  readColumns(source, pool, childTypes, children, opts);
 
   auto size = source->read<int32_t>();
 
@@ -672,7 +758,7 @@ void readColumns(
     velox::memory::MemoryPool* pool,
     const std::vector<TypePtr>& types,
     std::vector<VectorPtr>* result,
-    bool useLosslessTimestamp) {
+    const PrestoVectorSerde::PrestoOptions& opts) {
   static std::unordered_map<
       TypeKind,
       std::function<void(
@@ -680,7 +766,7 @@ void readColumns(
           std::shared_ptr<const Type> type,
           velox::memory::MemoryPool * pool,
           VectorPtr * result,
-          bool useLosslessTimestamp)>>
+          const PrestoVectorSerde::PrestoOptions& opts)>>
       readers = {
           {TypeKind::BOOLEAN, &read<bool>},
           {TypeKind::TINYINT, &read<int8_t>},
@@ -703,9 +789,17 @@ void readColumns(
   for (int32_t i = 0; i < types.size(); ++i) {
     auto encoding = readLengthPrefixedString(source);
     if (encoding == kRLE) {
-      readConstantVector(
-          source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+      readConstantVector(source, types[i], pool, &(*result)[i], opts);
+    } else if (encoding == kDictionary) {
+      readDictionaryVector(source, types[i], pool, &(*result)[i], opts);
     } else {
+      auto& previous = (*result)[i];
+      if (previous &&
+          (previous->encoding() == VectorEncoding::Simple::CONSTANT ||
+           previous->encoding() == VectorEncoding::Simple::DICTIONARY)) {
+        // A RLE or DICTIONARY block of a previous page cannot be reused.
+        previous.reset();
+      }
       checkTypeEncoding(encoding, types[i]);
       auto it = readers.find(types[i]->kind());
       VELOX_CHECK(
@@ -713,7 +807,7 @@ void readColumns(
           "Column reader for type {} is missing",
           types[i]->kindName());
 
-      it->second(source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+      it->second(source, types[i], pool, &(*result)[i], opts);
     }
   }
 }
@@ -741,7 +835,8 @@ class VectorStream {
         useLosslessTimestamp_(useLosslessTimestamp),
         nulls_(streamArena, true, true),
         lengths_(streamArena),
-        values_(streamArena) {
+        values_(streamArena),
+        indices_(streamArena) {
     streamArena->newTinyRange(50, &header_);
     auto name = typeToEncodingName(type);
     header_.size = name.size() + sizeof(int32_t);
@@ -828,8 +923,49 @@ class VectorStream {
     return children_[index].get();
   }
 
+  // Makes 'this' write a RLE block of 'size' rows. The caller appends the
+  // single value.
+  void setRle(vector_size_t size) {
+    encoding_ = VectorEncoding::Simple::CONSTANT;
+    encodedSize_ = size;
+  }
+
+  // Makes 'this' write a DICTIONARY block with 'indices' into the values. The
+  // caller appends the values of the dictionary.
+  void setDictionary(const std::vector<vector_size_t>& indices) {
+    encoding_ = VectorEncoding::Simple::DICTIONARY;
+    encodedSize_ = indices.size();
+    indices_.startWrite(indices.size() * sizeof(int32_t));
+    indices_.append(folly::Range(indices.data(), indices.size()));
+  }
+
   // Writes out the accumulated contents. Does not change the state.
   void flush(OutputStream* out) {
+    switch (encoding_) {
+      case VectorEncoding::Simple::CONSTANT:
+        writeInt32(out, kRLE.size());
+        out->write(kRLE.data(), kRLE.size());
+        writeInt32(out, encodedSize_);
+        flushValues(out);
+        return;
+      case VectorEncoding::Simple::DICTIONARY: {
+        writeInt32(out, kDictionary.size());
+        out->write(kDictionary.data(), kDictionary.size());
+        writeInt32(out, encodedSize_);
+        flushValues(out);
+        indices_.flush(out);
+        char dictionaryId[kDictionaryIdSize] = {};
+        out->write(dictionaryId, kDictionaryIdSize);
+        return;
+      }
+      default:
+        flushValues(out);
+    }
+  }
+
+ private:
+  // Writes the values with the type specific encoding.
+  void flushValues(OutputStream* out) {
     out->write(reinterpret_cast<char*>(header_.buffer), header_.size);
     switch (type_->kind()) {
       case TypeKind::ROW:
@@ -907,7 +1043,6 @@ class VectorStream {
     }
   }
 
- private:
   const TypePtr type_;
   /// Indicates whether to serialize timestamps with nanosecond precision.
   /// If false, they are serialized with millisecond precision which is
@@ -922,6 +1057,14 @@ class VectorStream {
   ByteStream lengths_;
   ByteStream values_;
   std::vector<std::unique_ptr<VectorStream>> children_;
+
+  // FLAT unless the values are the single value of a RLE block or the
+  // dictionary of a DICTIONARY block of 'encodedSize_' rows.
+  VectorEncoding::Simple encoding_{VectorEncoding::Simple::FLAT};
+  vector_size_t encodedSize_{0};
+
+  // Dictionary indices of a DICTIONARY block.
+  ByteStream indices_;
 };
 
 template <>
@@ -1577,13 +1720,22 @@ class PrestoVectorSerializer : public VectorSerializer {
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
       StreamArena* streamArena,
-      bool useLosslessTimestamp) {
+      const PrestoVectorSerde::PrestoOptions& options)
+      : streamArena_(streamArena),
+        pool_(streamArena->pool()),
+        useLosslessTimestamp_(options.useLosslessTimestamp),
+        preserveEncodings_(options.preserveEncodings),
+        codec_(
+            options.compressionKind == common::CompressionKind_NONE
+                ? nullptr
+                : common::compressionKindToCodec(options.compressionKind)),
+        minCompressionRatio_(options.minCompressionRatio) {
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
     for (int i = 0; i < numTypes; i++) {
       streams_[i] = std::make_unique<VectorStream>(
-          types[i], streamArena, numRows, useLosslessTimestamp);
+          types[i], streamArena, numRows, useLosslessTimestamp_);
     }
   }
 
@@ -1591,16 +1743,37 @@ class PrestoVectorSerializer : public VectorSerializer {
       const RowVectorPtr& vector,
       const folly::Range<const IndexRange*>& ranges) override {
     auto newRows = rangesTotalSize(ranges);
-    if (newRows > 0) {
-      numRows_ += newRows;
-      for (int32_t i = 0; i < vector->childrenSize(); ++i) {
-        serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
-      }
+    if (newRows == 0) {
+      return;
+    }
+    if (preserveEncodings_ && numRows_ == 0) {
+      // The encodings can be kept if this is the only append before flush.
+      pending_ = vector;
+      pendingRanges_.assign(ranges.begin(), ranges.end());
+      numRows_ = newRows;
+      return;
     }
+    appendPending();
+    numRows_ += newRows;
+    appendFlat(vector, ranges);
   }
 
   void flush(OutputStream* out) override {
-    flushInternal(numRows_, false /*rle*/, out);
+    if (pending_) {
+      appendEncoded();
+    }
+    flushInternal(numRows_, out);
+  }
+
+  // Prepares for 'numRows' rows that are appended directly to the column
+  // streams by scatter().
+  void beginScatter(vector_size_t numRows) {
+    appendPending();
+    numRows_ += numRows;
+  }
+
+  VectorStream* streamAt(int32_t column) {
+    return streams_[column].get();
   }
 
   void flushRle(const RowVectorPtr& vector, OutputStream* out) {
@@ -1610,13 +1783,16 @@ class PrestoVectorSerializer : public VectorSerializer {
     }
 
     std::vector<IndexRange> ranges{{0, 1}};
-    append(vector, folly::Range(ranges.data(), ranges.size()));
+    appendFlat(vector, folly::Range(ranges.data(), ranges.size()));
+    for (auto& stream : streams_) {
+      stream->setRle(vector->size());
+    }
 
-    flushInternal(vector->size(), true /*rle*/, out);
+    flushInternal(vector->size(), out);
   }
 
   // Writes the contents to 'stream' in wire format
-  void flushInternal(int32_t numRows, bool rle, OutputStream* out) {
+  void flushInternal(int32_t numRows, OutputStream* out) {
     auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
     // Reset CRC computation
     if (listener) {
@@ -1647,18 +1823,12 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
-    writeInt32(out, streams_.size());
-
-    if (rle) {
-      // Write RLE encoding marker.
-      writeInt32(out, kRLE.size());
-      out->write(kRLE.data(), kRLE.size());
-      // Write number of RLE values.
-      writeInt32(out, numRows);
-    }
-
-    for (auto& stream : streams_) {
-      stream->flush(out);
+    int32_t uncompressedSize;
+    if (codec_) {
+      uncompressedSize = flushCompressed(out, codec);
+    } else {
+      flushColumns(out);
+      uncompressedSize = (int32_t)out->tellp() - offset - kHeaderSize;
     }
 
     // Pause CRC computation
@@ -1668,28 +1838,222 @@ class PrestoVectorSerializer : public VectorSerializer {
 
     // Fill in uncompressedSizeInBytes & sizeInBytes
     int32_t size = (int32_t)out->tellp() - offset;
-    int32_t uncompressedSize = size - kHeaderSize;
+    int32_t sizeInBytes = size - kHeaderSize;
     int64_t crc = 0;
     if (listener) {
       crc = computeChecksum(listener, codec, numRows, uncompressedSize);
     }
 
-    out->seekp(offset + kSizeInBytesOffset);
-    writeInt32(out, uncompressedSize);
+    out->seekp(offset + kCodecOffset);
+    out->write(&codec, 1);
     writeInt32(out, uncompressedSize);
+    writeInt32(out, sizeInBytes);
     writeInt64(out, crc);
     out->seekp(offset + size);
   }
 
  private:
+  static const int32_t kCodecOffset{4};
   static const int32_t kSizeInBytesOffset{4 + 1};
   static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
 
+  void appendFlat(
+      const RowVectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges) {
+    for (int32_t i = 0; i < vector->childrenSize(); ++i) {
+      serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+    }
+  }
+
+  // Serializes the rows of 'pending_' without their encodings.
+  void appendPending() {
+    if (!pending_) {
+      return;
+    }
+    appendFlat(
+        pending_, folly::Range(pendingRanges_.data(), pendingRanges_.size()));
+    pending_ = nullptr;
+  }
+
+  // Serializes the rows of 'pending_'. Constant columns are written as RLE
+  // blocks and dictionary columns as DICTIONARY blocks unless the dictionary
+  // adds nulls or has more values than there are rows.
+  void appendEncoded() {
+    const auto ranges =
+        folly::Range(pendingRanges_.data(), pendingRanges_.size());
+    for (int32_t i = 0; i < pending_->childrenSize(); ++i) {
+      auto* column = pending_->childAt(i)->loadedVector();
+      const auto& type = column->type();
+      if (column->isConstantEncoding()) {
+        streams_[i] = std::make_unique<VectorStream>(
+            type, streamArena_, 1, useLosslessTimestamp_);
+        IndexRange first{ranges[0].begin, 1};
+        serializeColumn(column, folly::Range(&first, 1), streams_[i].get());
+        streams_[i]->setRle(numRows_);
+        continue;
+      }
+      if (column->encoding() == VectorEncoding::Simple::DICTIONARY &&
+          !column->rawNulls() && column->valueVector()->size() <= numRows_) {
+        auto* dictionary = column->valueVector().get();
+        const auto* rawIndices = column->wrapInfo()->as<vector_size_t>();
+        std::vector<vector_size_t> indices;
+        indices.reserve(numRows_);
+        for (const auto& range : ranges) {
+          indices.insert(
+              indices.end(),
+              rawIndices + range.begin,
+              rawIndices + range.begin + range.size);
+        }
+        streams_[i] = std::make_unique<VectorStream>(
+            type, streamArena_, dictionary->size(), useLosslessTimestamp_);
+        IndexRange all{0, dictionary->size()};
+        serializeColumn(dictionary, folly::Range(&all, 1), streams_[i].get());
+        streams_[i]->setDictionary(indices);
+        continue;
+      }
+      serializeColumn(column, ranges, streams_[i].get());
+    }
+    pending_ = nullptr;
+  }
+
+  // Writes the number of columns and the columns.
+  void flushColumns(OutputStream* out) {
+    writeInt32(out, streams_.size());
+    for (auto& stream : streams_) {
+      stream->flush(out);
+    }
+  }
+
+  // Serializes the columns into a temporary buffer and writes them to 'out'
+  // with 'codec_' if they compress well enough, in which case the compressed
+  // bit is set in 'codec'. Returns the uncompressed size.
+  int32_t flushCompressed(OutputStream* out, char& codec) {
+    IOBufOutputStream columns(*pool_);
+    flushColumns(&columns);
+    auto uncompressed = columns.getIOBuf();
+    const auto uncompressedSize = uncompressed->computeChainDataLength();
+    VELOX_CHECK_LE(uncompressedSize, std::numeric_limits<int32_t>::max());
+    auto compressed = codec_->compress(uncompressed.get());
+    const folly::IOBuf* page = uncompressed.get();
+    if (compressed->computeChainDataLength() * minCompressionRatio_ <=
+        uncompressedSize) {
+      codec |= kCompressedBitMask;
+      page = compressed.get();
+    }
+    for (const auto& range : *page) {
+      out->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
+    return uncompressedSize;
+  }
+
+  StreamArena* const streamArena_;
+  memory::MemoryPool* const pool_;
+  const bool useLosslessTimestamp_;
+  const bool preserveEncodings_;
+  const std::unique_ptr<folly::io::Codec> codec_;
+  const float minCompressionRatio_;
+
+  // The vector and rows of the first append() if encodings are preserved.
+  // Serialized with their encodings at flush() unless there is another
+  // append().
+  RowVectorPtr pending_;
+  std::vector<IndexRange> pendingRanges_;
   int32_t numRows_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
 };
+// Appends each row of the flat 'column' to the stream of its partition in
+// 'streams'.
+template <TypeKind kind>
+void scatterFlatColumn(
+    const BaseVector* column,
+    const uint32_t* partitions,
+    const std::vector<VectorStream*>& streams) {
+  using T = typename TypeTraits<kind>::NativeType;
+  const auto* flatVector = column->asUnchecked<FlatVector<T>>();
+  const bool mayHaveNulls = column->mayHaveNulls();
+  for (vector_size_t row = 0; row < column->size(); ++row) {
+    auto* stream = streams[partitions[row]];
+    if (mayHaveNulls && column->isNullAt(row)) {
+      stream->appendNull();
+      continue;
+    }
+    stream->appendNonNull();
+    if constexpr (std::is_same_v<T, bool>) {
+      stream->appendOne<uint8_t>(flatVector->valueAtFast(row) ? 1 : 0);
+    } else {
+      stream->appendOne(flatVector->rawValues()[row]);
+    }
+  }
+}
+
+// Returns the rows of each partition as ranges of consecutive rows.
+std::vector<std::vector<IndexRange>> partitionRanges(
+    const uint32_t* partitions,
+    vector_size_t numRows,
+    int32_t numPartitions) {
+  std::vector<std::vector<IndexRange>> ranges(numPartitions);
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    auto& partitionRanges = ranges[partitions[row]];
+    if (!partitionRanges.empty() &&
+        partitionRanges.back().begin + partitionRanges.back().size == row) {
+      ++partitionRanges.back().size;
+    } else {
+      partitionRanges.push_back(IndexRange{row, 1});
+    }
+  }
+  return ranges;
+}
 } // namespace
 
+void PrestoVectorSerde::scatter(
+    const RowVectorPtr& vector,
+    const uint32_t* partitions,
+    folly::Range<VectorSerializer* const*> serializers) {
+  const auto numRows = vector->size();
+  const auto numPartitions = serializers.size();
+  std::vector<vector_size_t> partitionSizes(numPartitions);
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    ++partitionSizes[partitions[row]];
+  }
+  std::vector<PrestoVectorSerializer*> prestoSerializers(numPartitions);
+  for (auto i = 0; i < numPartitions; ++i) {
+    if (partitionSizes[i] > 0) {
+      VELOX_CHECK_NOT_NULL(serializers[i]);
+      prestoSerializers[i] =
+          static_cast<PrestoVectorSerializer*>(serializers[i]);
+      prestoSerializers[i]->beginScatter(partitionSizes[i]);
+    }
+  }
+
+  std::vector<VectorStream*> streams(numPartitions);
+  // Computed on first use for the columns that are not flat.
+  std::vector<std::vector<IndexRange>> ranges;
+  for (auto column = 0; column < vector->childrenSize(); ++column) {
+    for (auto i = 0; i < numPartitions; ++i) {
+      streams[i] = prestoSerializers[i]
+          ? prestoSerializers[i]->streamAt(column)
+          : nullptr;
+    }
+    const auto* child = vector->childAt(column)->loadedVector();
+    if (child->encoding() == VectorEncoding::Simple::FLAT) {
+      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+          scatterFlatColumn, child->typeKind(), child, partitions, streams);
+      continue;
+    }
+    if (ranges.empty()) {
+      ranges = partitionRanges(partitions, numRows, numPartitions);
+    }
+    for (auto i = 0; i < numPartitions; ++i) {
+      if (!ranges[i].empty()) {
+        serializeColumn(
+            child,
+            folly::Range(ranges[i].data(), ranges[i].size()),
+            streams[i]);
+      }
+    }
+  }
+}
+
 void PrestoVectorSerde::estimateSerializedSize(
     VectorPtr vector,
     const folly::Range<const IndexRange*>& ranges,
@@ -1702,11 +2066,12 @@ std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
     int32_t numRows,
     StreamArena* streamArena,
     const Options* options) {
-  bool useLosslessTimestamp = options != nullptr
-      ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
-      : false;
   return std::make_unique<PrestoVectorSerializer>(
-      type, numRows, streamArena, useLosslessTimestamp);
+      type,
+      numRows,
+      streamArena,
+      options != nullptr ? *static_cast<const PrestoOptions*>(options)
+                         : PrestoOptions(false));
 }
 
 void PrestoVectorSerde::serializeConstants(
@@ -1726,9 +2091,9 @@ void PrestoVectorSerde::deserialize(
     std::shared_ptr<const RowType> type,
     std::shared_ptr<RowVector>* result,
     const Options* options) {
-  bool useLosslessTimestamp = options != nullptr
-      ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
-      : false;
+  auto opts = options != nullptr
+      ? *static_cast<const PrestoOptions*>(options)
+      : PrestoOptions(false);
   auto numRows = source->read<int32_t>();
   if (!(*result) || !result->unique() || (*result)->type() != type) {
     *result = std::dynamic_pointer_cast<RowVector>(
@@ -1739,25 +2104,67 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
-  // skip number of columns
-  source->skip(4);
-
   auto children = &(*result)->children();
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+  if (!isCompressedBitSet(pageCodecMarker)) {
+    // skip number of columns
+    source->skip(4);
+    readColumns(source, pool, childTypes, children, opts);
+    return;
+  }
+
+  VELOX_CHECK_NE(
+      opts.compressionKind,
+      common::CompressionKind_NONE,
+      "Received a compressed page without a compression codec");
+  auto compressedBuffer = AlignedBuffer::allocate<char>(sizeInBytes, pool);
+  source->readBytes(compressedBuffer->asMutable<char>(), sizeInBytes);
+  auto compressed =
+      folly::IOBuf::wrapBufferAsValue(compressedBuffer->as<char>(), sizeInBytes);
+  std::shared_ptr<folly::IOBuf> uncompressed =
+      common::compressionKindToCodec(opts.compressionKind)
+          ->uncompress(&compressed, uncompressedSize);
+  std::vector<ByteRange> ranges;
+  for (const auto& range : *uncompressed) {
+    ranges.push_back(
+        {const_cast<uint8_t*>(range.data()),
+         static_cast<int32_t>(range.size()),
+         0});
+  }
+  if (opts.inputOwner) {
+    // The values are wrapped from the uncompressed page, which then lives as
+    // long as the vectors that reference it.
+    opts.inputOwner = uncompressed;
+  }
+  ByteStream uncompressedSource;
+  uncompressedSource.resetInput(std::move(ranges));
+  // skip number of columns
+  uncompressedSource.skip(4);
+  readColumns(&uncompressedSource, pool, childTypes, children, opts);
+}
+
+// static
+std::pair<int32_t, int32_t> PrestoVectorSerde::peekPageSizes(
+    ByteStream* source) {
+  const auto offset = source->tellp();
+  // Skip number of rows and codec marker.
+  source->skip(4 + 1);
+  const auto uncompressedSize = source->read<int32_t>();
+  const auto sizeInBytes = source->read<int32_t>();
+  source->seekp(offset);
+  return {uncompressedSize, sizeInBytes};
 }
 
 // static
@@ -15,6 +15,7 @@
  */
 #pragma once
 #include "velox/common/base/Crc.h"
+#include "velox/common/compression/Compression.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::serializer::presto {
@@ -22,13 +23,36 @@ class PrestoVectorSerde : public VectorSerde {
  public:
   // Input options that the serializer recognizes.
   struct PrestoOptions : VectorSerde::Options {
-    explicit PrestoOptions(bool useLosslessTimestamp)
-        : useLosslessTimestamp(useLosslessTimestamp) {}
+    explicit PrestoOptions(
+        bool useLosslessTimestamp,
+        common::CompressionKind compressionKind = common::CompressionKind_NONE)
+        : useLosslessTimestamp(useLosslessTimestamp),
+          compressionKind(compressionKind) {}
     // Currently presto only supports millisecond precision and the serializer
     // converts velox native timestamp to that resulting in loss of precision.
     // This option allows it to serialize with nanosecond precision and is
     // currently used for spilling. Is false by default.
     bool useLosslessTimestamp{false};
+
+    // Codec for the pages. A page is compressed if its raw size divided by
+    // its compressed size is at least 'minCompressionRatio', otherwise it is
+    // written uncompressed. The compressed bit of the page codec marker tells
+    // which. The reader must use the same codec as the writer.
+    common::CompressionKind compressionKind{common::CompressionKind_NONE};
+    float minCompressionRatio{1.2};
+
+    // If true and a page is made from a single append of a vector, constant
+    // and dictionary columns are written as RLE and DICTIONARY blocks instead
+    // of being flattened. The reader returns these as constant and dictionary
+    // vectors.
+    bool preserveEncodings{false};
+
+    // If set, deserialize() does not copy the values of fixed width columns
+    // without nulls when the values are contiguous and aligned in the input.
+    // The result vectors reference the input through BufferViews that keep
+    // 'inputOwner' alive. The input must not change while these vectors
+    // exist.
+    std::shared_ptr<const void> inputOwner;
   };
 
   void estimateSerializedSize(
@@ -42,6 +66,13 @@ class PrestoVectorSerde : public VectorSerde {
       StreamArena* streamArena,
       const Options* options) override;
 
+  /// Appends each row of 'vector' to the serializer of its partition in one
+  /// pass over each flat column. The serializers must be made by this serde.
+  void scatter(
+      const RowVectorPtr& vector,
+      const uint32_t* partitions,
+      folly::Range<VectorSerializer* const*> serializers) override;
+
   /// Serializes a RowVector with a constant children.
   void serializeConstants(
       const RowVectorPtr& vector,
@@ -56,6 +87,11 @@ class PrestoVectorSerde : public VectorSerde {
       std::shared_ptr<RowVector>* result,
       const Options* options) override;
 
+  /// Returns the sizes of the serialized page at the read position of
+  /// 'source' before and after compression, not counting the page header.
+  /// Does not move the read position.
+  static std::pair<int32_t, int32_t> peekPageSizes(ByteStream* source);
+
   static void registerVectorSerde();
 };
 
@@ -14,8 +14,15 @@
  * limitations under the License.
  */
 #include "velox/serializers/UnsafeRowSerializer.h"
-#include "velox/row/UnsafeRowDeserializers.h"
-#include "velox/row/UnsafeRowSerializers.h"
+#include <gflags/gflags.h>
+#include "velox/row/UnsafeRowBatchSerde.h"
+#include "velox/row/experimental/UnsafeRow24Deserializer.h"
+
+DEFINE_bool(
+    velox_unsafe_row24_deserializer,
+    true,
+    "Deserialize UnsafeRows with UnsafeRow24Deserializer instead of "
+    "UnsafeRowBatchDeserializer");
 
 namespace facebook::velox::serializer::spark {
 
@@ -35,40 +42,41 @@ class UnsafeRowVectorSerializer : public VectorSerializer {
   void append(
       const RowVectorPtr& vector,
       const folly::Range<const IndexRange*>& ranges) override {
-    size_t totalSize = 0;
+    std::vector<vector_size_t> rows;
     for (auto& range : ranges) {
       for (auto i = range.begin; i < range.begin + range.size; ++i) {
-        auto rowSize = row::UnsafeRowSerializer::getSizeRow(vector.get(), i);
-        totalSize += rowSize + sizeof(size_t);
+        rows.push_back(i);
       }
     }
 
+    // Sizes and values are computed a column at a time for all rows.
+    row::UnsafeRowBatchSerializer serializer(vector);
+    std::vector<size_t> sizes(rows.size());
+    serializer.rowSizes(folly::Range(rows.data(), rows.size()), sizes.data());
+
+    size_t totalSize = 0;
+    std::vector<size_t> offsets(rows.size());
+    for (auto i = 0; i < rows.size(); ++i) {
+      offsets[i] = totalSize + sizeof(size_t);
+      totalSize += sizes[i] + sizeof(size_t);
+    }
+
     if (totalSize == 0) {
       return;
     }
 
-    auto* buffer = (char*)pool_->allocate(totalSize);
+    // The values are written into zeroed memory, so that null fields and
+    // padding are zeros as in Spark.
+    auto* buffer = (char*)pool_->allocateZeroFilled(1, totalSize);
     buffers_.push_back(
         ByteRange{(uint8_t*)buffer, (int32_t)totalSize, (int32_t)totalSize});
 
-    size_t offset = 0;
-    for (auto& range : ranges) {
-      for (auto i = range.begin; i < range.begin + range.size; ++i) {
-        // Write row data.
-        auto rowSize = row::UnsafeRowSerializer::getSizeRow(vector.get(), i);
-        auto size = row::UnsafeRowSerializer::serialize(
-                        vector, buffer + offset + sizeof(size_t), i)
-                        .value_or(0);
-
-        // Sanity check.
-        VELOX_CHECK_EQ(rowSize, size);
-
-        // Write raw size.
-        *(size_t*)(buffer + offset) = size;
-
-        offset += sizeof(size_t) + size;
-      }
+    for (auto i = 0; i < rows.size(); ++i) {
+      // Write raw size.
+      *(size_t*)(buffer + offsets[i] - sizeof(size_t)) = sizes[i];
     }
+    serializer.serialize(
+        folly::Range(rows.data(), rows.size()), offsets.data(), buffer);
   }
 
   void flush(OutputStream* stream) override {
@@ -99,7 +107,7 @@ void UnsafeRowVectorSerde::deserialize(
     RowTypePtr type,
     RowVectorPtr* result,
     const Options* /* options */) {
-  std::vector<std::optional<std::string_view>> serializedRows;
+  std::vector<std::string_view> serializedRows;
   while (!source->atEnd()) {
     auto rowSize = source->read<size_t>();
     auto row = source->nextView(rowSize);
@@ -112,9 +120,20 @@ void UnsafeRowVectorSerde::deserialize(
     return;
   }
 
-  *result = std::dynamic_pointer_cast<RowVector>(
-      velox::row::UnsafeRowDeserializer::deserialize(
-          serializedRows, type, pool));
+  if (FLAGS_velox_unsafe_row24_deserializer) {
+    std::vector<const char*> rows(serializedRows.size());
+    for (auto i = 0; i < serializedRows.size(); ++i) {
+      rows[i] = serializedRows[i].data();
+    }
+    *result = velox::row::UnsafeRow24Deserializer::Create(type)
+                  ->DeserializeRows(pool, rows);
+    return;
+  }
+
+  std::vector<std::optional<std::string_view>> optionalRows(
+      serializedRows.begin(), serializedRows.end());
+  *result = velox::row::UnsafeRowBatchDeserializer::deserialize(
+      optionalRows, type, pool);
 }
 
 // static
@@ -322,6 +322,188 @@ TEST_F(PrestoSerializerTest, timestampWithNanosecondPrecision) {
   assertEqualVectors(deserialized, expectedOutputWithLostPrecision);
 }
 
+TEST_F(PrestoSerializerTest, compression) {
+  // Repeating values that compress well.
+  auto rowVector = vectorMaker_->rowVector(
+      {vectorMaker_->flatVector<int64_t>(
+           10'000, [](vector_size_t row) { return row % 7; }),
+       vectorMaker_->flatVector<StringView>(10'000, [](vector_size_t row) {
+         return StringView(row % 3 ? "apple" : "a string that is not inlined");
+       })});
+  auto rowType = asRowType(rowVector->type());
+  std::ostringstream rawOut;
+  serialize(rowVector, &rawOut, nullptr);
+  const int32_t rawSize = rawOut.str().size();
+
+  for (auto kind :
+       {common::CompressionKind_LZ4, common::CompressionKind_ZSTD}) {
+    SCOPED_TRACE(common::compressionKindToString(kind));
+    serializer::presto::PrestoVectorSerde::PrestoOptions options(false, kind);
+    std::ostringstream out;
+    serialize(rowVector, &out, &options);
+    auto page = out.str();
+    EXPECT_LT(page.size(), rawSize / 2.0);
+    // The compressed bit of the codec marker is set.
+    EXPECT_EQ(1, page[4] & 1);
+    auto byteStream = toByteStream(page);
+    auto [uncompressedSize, sizeInBytes] =
+        serializer::presto::PrestoVectorSerde::peekPageSizes(byteStream.get());
+    EXPECT_EQ(rawSize - 21, uncompressedSize);
+    EXPECT_EQ(static_cast<int32_t>(page.size()) - 21, sizeInBytes);
+    assertEqualVectors(rowVector, deserialize(rowType, page, &options));
+
+    // A page that does not compress by 'minCompressionRatio' is written raw.
+    options.minCompressionRatio = 1'000;
+    std::ostringstream uncompressedOut;
+    serialize(rowVector, &uncompressedOut, &options);
+    page = uncompressedOut.str();
+    EXPECT_EQ(rawOut.str(), page);
+    assertEqualVectors(rowVector, deserialize(rowType, page, &options));
+  }
+
+  // A compressed page cannot be read without the codec.
+  serializer::presto::PrestoVectorSerde::PrestoOptions options(
+      false, common::CompressionKind_LZ4);
+  std::ostringstream out;
+  serialize(rowVector, &out, &options);
+  VELOX_ASSERT_THROW(
+      deserialize(rowType, out.str(), nullptr),
+      "Received a compressed page without a compression codec");
+}
+
+TEST_F(PrestoSerializerTest, zeroCopy) {
+  constexpr vector_size_t kSize = 1'000;
+  auto rowVector = vectorMaker_->rowVector({
+      vectorMaker_->flatVector<int64_t>(
+          kSize, [](auto row) { return row * 3; }),
+      vectorMaker_->flatVector<int8_t>(
+          kSize, [](auto row) { return row % 100; }),
+      vectorMaker_->flatVector<int32_t>(
+          kSize,
+          [](auto row) { return row; },
+          [](auto row) { return row % 7 == 0; }),
+  });
+  auto rowType = asRowType(rowVector->type());
+  std::ostringstream out;
+  serialize(rowVector, &out, nullptr);
+  const auto page = out.str();
+
+  // The values of the first column start 44 bytes into the page. They are
+  // aligned if the page starts 4 bytes past an 8 byte boundary.
+  for (auto offset : {0, 4}) {
+    SCOPED_TRACE(offset);
+    auto input = std::make_shared<std::vector<int64_t>>(page.size() / 8 + 2);
+    auto* data = reinterpret_cast<uint8_t*>(input->data()) + offset;
+    memcpy(data, page.data(), page.size());
+    ByteStream source;
+    source.setRange({data, static_cast<int32_t>(page.size()), 0});
+    serializer::presto::PrestoVectorSerde::PrestoOptions options(false);
+    options.inputOwner = input;
+    RowVectorPtr result;
+    serde_->deserialize(&source, pool_.get(), rowType, &result, &options);
+    assertEqualVectors(rowVector, result);
+
+    // 1 byte values are always aligned. Columns with nulls are copied.
+    EXPECT_EQ(offset == 4, result->childAt(0)->values()->isView());
+    EXPECT_TRUE(result->childAt(1)->values()->isView());
+    EXPECT_FALSE(result->childAt(2)->values()->isView());
+
+    // The vectors keep the input alive.
+    std::weak_ptr<std::vector<int64_t>> weakInput = input;
+    options.inputOwner = nullptr;
+    input = nullptr;
+    EXPECT_FALSE(weakInput.expired());
+    assertEqualVectors(rowVector, result);
+    result = nullptr;
+    EXPECT_TRUE(weakInput.expired());
+  }
+}
+
+TEST_F(PrestoSerializerTest, scatter) {
+  constexpr vector_size_t kSize = 1'000;
+  constexpr int32_t kNumPartitions = 7;
+  auto indices = AlignedBuffer::allocate<vector_size_t>(kSize, pool_.get());
+  for (auto i = 0; i < kSize; ++i) {
+    indices->asMutable<vector_size_t>()[i] = kSize - 1 - i;
+  }
+  auto rowVector = vectorMaker_->rowVector({
+      vectorMaker_->flatVector<int64_t>(kSize, [](auto row) { return row; }),
+      vectorMaker_->flatVector<bool>(
+          kSize,
+          [](auto row) { return row % 3 == 0; },
+          [](auto row) { return row % 11 == 0; }),
+      vectorMaker_->flatVector<StringView>(
+          kSize,
+          [](auto row) {
+            return StringView(row % 2 ? "apple" : "not an inlined string");
+          },
+          [](auto row) { return row % 5 == 0; }),
+      vectorMaker_->flatVector<Timestamp>(
+          kSize, [](auto row) { return Timestamp(row, 0); }),
+      BaseVector::wrapInDictionary(
+          nullptr,
+          indices,
+          kSize,
+          vectorMaker_->flatVector<double>(
+              kSize, [](auto row) { return row * 0.1; })),
+      BaseVector::createConstant(INTEGER(), 11, kSize, pool_.get()),
+      vectorMaker_->arrayVector<int32_t>(
+          kSize,
+          [](auto row) { return row % 4; },
+          [](auto row, auto index) { return row + index; }),
+  });
+  auto rowType = asRowType(rowVector->type());
+
+  // Rows go to partitions in runs of varying length. Partition 0 gets no rows.
+  std::vector<uint32_t> partitions(kSize);
+  for (auto i = 0; i < kSize; ++i) {
+    partitions[i] = 1 + (i / (1 + i % 3)) % (kNumPartitions - 1);
+  }
+
+  auto flushToString = [](VectorSerializer& serializer) {
+    std::ostringstream out;
+    facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+    OStreamOutputStream output(&out, &listener);
+    serializer.flush(&output);
+    return out.str();
+  };
+
+  auto arena = std::make_unique<StreamArena>(pool_.get());
+  std::vector<std::unique_ptr<VectorSerializer>> serializers;
+  std::vector<VectorSerializer*> rawSerializers(kNumPartitions, nullptr);
+  for (auto i = 1; i < kNumPartitions; ++i) {
+    serializers.push_back(
+        serde_->createSerializer(rowType, kSize, arena.get(), nullptr));
+    rawSerializers[i] = serializers.back().get();
+  }
+  serde_->scatter(
+      rowVector,
+      partitions.data(),
+      folly::Range(rawSerializers.data(), rawSerializers.size()));
+
+  // Each partition is the same as appending its rows one by one.
+  for (auto i = 1; i < kNumPartitions; ++i) {
+    SCOPED_TRACE(i);
+    std::vector<IndexRange> rows;
+    for (auto row = 0; row < kSize; ++row) {
+      if (partitions[row] == i) {
+        rows.push_back(IndexRange{row, 1});
+      }
+    }
+    auto expected =
+        serde_->createSerializer(rowType, kSize, arena.get(), nullptr);
+    expected->append(rowVector, folly::Range(rows.data(), rows.size()));
+    const auto page = flushToString(*rawSerializers[i]);
+    EXPECT_EQ(flushToString(*expected), page);
+
+    auto result = deserialize(rowType, page, nullptr);
+    ASSERT_EQ(rows.size(), result->size());
+    for (auto row = 0; row < rows.size(); ++row) {
+      ASSERT_TRUE(result->equalValueAt(rowVector.get(), row, rows[row].begin));
+    }
+  }
+}
+
 TEST_F(PrestoSerializerTest, unscaledLongDecimal) {
   std::vector<int128_t> decimalValues(102);
   decimalValues[0] = UnscaledLongDecimal::min().unscaledValue();
@@ -380,3 +562,73 @@ TEST_F(PrestoSerializerTest, lazy) {
       std::make_unique<SimpleVectorLoader>([&](auto) { return rowVector; }));
   testRoundTrip(lazyVector);
 }
+
+TEST_F(PrestoSerializerTest, preserveEncodings) {
+  constexpr vector_size_t kSize = 10'000;
+  const std::string longString(200, 'x');
+  auto dictionaryBase = vectorMaker_->flatVector<int64_t>({1, 2, 3, 4, 5});
+  auto indices = AlignedBuffer::allocate<vector_size_t>(kSize, pool_.get());
+  for (auto i = 0; i < kSize; ++i) {
+    indices->asMutable<vector_size_t>()[i] = i % 5;
+  }
+  auto rowVector = vectorMaker_->rowVector({
+      BaseVector::createConstant(
+          VARCHAR(), StringView(longString), kSize, pool_.get()),
+      BaseVector::wrapInDictionary(nullptr, indices, kSize, dictionaryBase),
+      BaseVector::createNullConstant(BIGINT(), kSize, pool_.get()),
+      vectorMaker_->flatVector<int32_t>(kSize, [](auto row) { return row; }),
+  });
+  auto rowType = asRowType(rowVector->type());
+
+  serializer::presto::PrestoVectorSerde::PrestoOptions options(false);
+  options.preserveEncodings = true;
+  std::ostringstream out;
+  serialize(rowVector, &out, &options);
+  std::ostringstream flatOut;
+  serialize(rowVector, &flatOut, nullptr);
+  // The constant string is written once and the dictionary has 5 values.
+  EXPECT_LT(out.str().size(), flatOut.str().size() / 10);
+
+  auto deserialized = deserialize(rowType, out.str(), &options);
+  assertEqualVectors(rowVector, deserialized);
+  EXPECT_TRUE(deserialized->childAt(0)->isConstantEncoding());
+  EXPECT_EQ(
+      VectorEncoding::Simple::DICTIONARY,
+      deserialized->childAt(1)->encoding());
+  EXPECT_TRUE(deserialized->childAt(2)->isConstantEncoding());
+  EXPECT_EQ(VectorEncoding::Simple::FLAT, deserialized->childAt(3)->encoding());
+
+  // A flat page can be read into the result of an encoded page.
+  auto byteStream = toByteStream(flatOut.str());
+  serde_->deserialize(
+      byteStream.get(), pool_.get(), rowType, &deserialized, nullptr);
+  assertEqualVectors(rowVector, deserialized);
+  EXPECT_EQ(VectorEncoding::Simple::FLAT, deserialized->childAt(0)->encoding());
+
+  // Several appends to one page are flattened.
+  auto arena = std::make_unique<StreamArena>(pool_.get());
+  auto serializer =
+      serde_->createSerializer(rowType, 2 * kSize, arena.get(), &options);
+  IndexRange range{0, kSize};
+  serializer->append(rowVector, folly::Range(&range, 1));
+  serializer->append(rowVector, folly::Range(&range, 1));
+  std::ostringstream twoAppendsOut;
+  OStreamOutputStream twoAppendsStream(&twoAppendsOut);
+  serializer->flush(&twoAppendsStream);
+  deserialized = deserialize(rowType, twoAppendsOut.str(), &options);
+  EXPECT_EQ(2 * kSize, deserialized->size());
+  EXPECT_EQ(VectorEncoding::Simple::FLAT, deserialized->childAt(0)->encoding());
+  EXPECT_EQ(VectorEncoding::Simple::FLAT, deserialized->childAt(1)->encoding());
+}
+
+TEST_F(PrestoSerializerTest, rleMultipleColumns) {
+  auto rowVector = vectorMaker_->rowVector({
+      BaseVector::createConstant(INTEGER(), 7, 100, pool_.get()),
+      BaseVector::createConstant(VARCHAR(), "abc", 100, pool_.get()),
+  });
+  std::ostringstream out;
+  serializeRle(rowVector, &out, nullptr);
+  auto deserialized =
+      deserialize(asRowType(rowVector->type()), out.str(), nullptr);
+  assertEqualVectors(rowVector, deserialized);
+}
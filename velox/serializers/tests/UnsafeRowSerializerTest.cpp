@@ -14,10 +14,13 @@
  * limitations under the License.
  */
 #include "velox/serializers/UnsafeRowSerializer.h"
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
+DECLARE_bool(velox_unsafe_row24_deserializer);
+
 using namespace facebook::velox;
 
 class UnsafeRowSerializerTest : public ::testing::Test {
@@ -115,4 +118,8 @@ TEST_F(UnsafeRowSerializerTest, types) {
 
   auto data = fuzzer.fuzzRow(rowType);
   testRoundTrip(data);
+
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_unsafe_row24_deserializer = false;
+  testRoundTrip(data);
 }
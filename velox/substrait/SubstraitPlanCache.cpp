@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/substrait/SubstraitPlanCache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "velox/substrait/SubstraitToVeloxPlanValidator.h"
+
+namespace facebook::velox::substrait {
+
+namespace {
+
+// The file of a ReadRel in the plans that are converted for the cache is
+// this prefix followed by the ordinal of the ReadRel.
+const std::string kFilePlaceholder = "substrait-plan-cache:";
+
+// Appends the ReadRels under 'rel' to 'reads' in depth first order.
+void collectReadRels(
+    ::substrait::Rel& rel,
+    std::vector<::substrait::ReadRel*>& reads) {
+  ::substrait::Rel* input = nullptr;
+  if (rel.has_read()) {
+    reads.push_back(rel.mutable_read());
+  } else if (rel.has_aggregate() && rel.aggregate().has_input()) {
+    input = rel.mutable_aggregate()->mutable_input();
+  } else if (rel.has_project() && rel.project().has_input()) {
+    input = rel.mutable_project()->mutable_input();
+  } else if (rel.has_filter() && rel.filter().has_input()) {
+    input = rel.mutable_filter()->mutable_input();
+  } else if (rel.has_sort() && rel.sort().has_input()) {
+    input = rel.mutable_sort()->mutable_input();
+  } else if (rel.has_fetch() && rel.fetch().has_input()) {
+    input = rel.mutable_fetch()->mutable_input();
+  } else if (rel.has_expand() && rel.expand().has_input()) {
+    input = rel.mutable_expand()->mutable_input();
+  } else if (rel.has_window() && rel.window().has_input()) {
+    input = rel.mutable_window()->mutable_input();
+  } else if (rel.has_join()) {
+    auto* join = rel.mutable_join();
+    if (join->has_left()) {
+      collectReadRels(*join->mutable_left(), reads);
+    }
+    if (join->has_right()) {
+      collectReadRels(*join->mutable_right(), reads);
+    }
+  }
+  if (input != nullptr) {
+    collectReadRels(*input, reads);
+  }
+}
+
+struct KeyedPlan {
+  // The plan with one placeholder file in each ReadRel that scans files.
+  ::substrait::Plan plan;
+
+  // The deterministic serialization of 'plan'.
+  std::string key;
+
+  // The split info of the files of each ReadRel, indexed by the ordinal of
+  // the ReadRel. nullptr for ReadRels that do not scan files.
+  std::vector<std::shared_ptr<SplitInfo>> fileSplits;
+
+  bool hasStreamInput{false};
+};
+
+KeyedPlan makeKeyedPlan(const ::substrait::Plan& plan) {
+  KeyedPlan keyed;
+  keyed.plan = plan;
+  std::vector<::substrait::ReadRel*> reads;
+  for (auto& relation : *keyed.plan.mutable_relations()) {
+    if (relation.has_root() && relation.root().has_input()) {
+      collectReadRels(*relation.mutable_root()->mutable_input(), reads);
+    } else if (relation.has_rel()) {
+      collectReadRels(*relation.mutable_rel(), reads);
+    }
+  }
+
+  keyed.fileSplits.resize(reads.size());
+  for (auto i = 0; i < reads.size(); ++i) {
+    auto* read = reads[i];
+    if (!read->has_local_files() || read->local_files().items().empty()) {
+      continue;
+    }
+    auto* items = read->mutable_local_files()->mutable_items();
+    if (items->Get(0).uri_file().find("iterator:") != std::string::npos) {
+      keyed.hasStreamInput = true;
+      continue;
+    }
+    auto splitInfo = std::make_shared<SplitInfo>();
+    parseLocalFiles(read->local_files(), *splitInfo);
+    keyed.fileSplits[i] = std::move(splitInfo);
+
+    // The converter takes the format of the plan from the last file.
+    auto placeholder = items->Get(items->size() - 1);
+    placeholder.set_uri_file(fmt::format("{}{}", kFilePlaceholder, i));
+    placeholder.set_partition_index(0);
+    placeholder.set_start(0);
+    placeholder.set_length(0);
+    items->Clear();
+    *items->Add() = std::move(placeholder);
+  }
+
+  {
+    google::protobuf::io::StringOutputStream stream(&keyed.key);
+    google::protobuf::io::CodedOutputStream output(&stream);
+    output.SetSerializationDeterministic(true);
+    keyed.plan.SerializeToCodedStream(&output);
+  }
+  return keyed;
+}
+
+} // namespace
+
+SubstraitPlanCache::SubstraitPlanCache(size_t maxEntries)
+    : maxEntries_(maxEntries),
+      plans_(std::make_unique<SimpleLRUCache<std::string, Entry>>(maxEntries)),
+      validations_(
+          std::make_unique<SimpleLRUCache<std::string, bool>>(maxEntries)) {}
+
+// static
+void SubstraitPlanCache::setSplitInfos(
+    const Entry& entry,
+    const std::vector<std::shared_ptr<SplitInfo>>& fileSplits,
+    std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>&
+        splitInfos) {
+  splitInfos.clear();
+  for (const auto& [id, splitInfo] : entry.splitInfos) {
+    splitInfos[id] = std::make_shared<SplitInfo>(*splitInfo);
+  }
+  for (const auto& [ordinal, id] : entry.scans) {
+    VELOX_CHECK_NOT_NULL(fileSplits[ordinal]);
+    splitInfos[id] = fileSplits[ordinal];
+  }
+}
+
+core::PlanNodePtr SubstraitPlanCache::toVeloxPlan(
+    const ::substrait::Plan& plan,
+    memory::MemoryPool* pool,
+    std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>&
+        splitInfos) {
+  auto keyed = makeKeyedPlan(plan);
+  if (keyed.hasStreamInput) {
+    SubstraitVeloxPlanConverter converter(pool);
+    auto veloxPlan = converter.toVeloxPlan(plan);
+    splitInfos = converter.splitInfos();
+    return veloxPlan;
+  }
+
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (auto* entry = plans_->get(keyed.key)) {
+      auto veloxPlan = entry->plan;
+      setSplitInfos(*entry, keyed.fileSplits, splitInfos);
+      plans_->release(keyed.key);
+      return veloxPlan;
+    }
+  }
+
+  // Converts the plan with the placeholder files, which tell the TableScan
+  // of each ReadRel.
+  SubstraitVeloxPlanConverter converter(pool);
+  auto entry = std::make_unique<Entry>();
+  entry->plan = converter.toVeloxPlan(keyed.plan);
+  for (const auto& [id, splitInfo] : converter.splitInfos()) {
+    if (!splitInfo->paths.empty() &&
+        splitInfo->paths[0].compare(
+            0, kFilePlaceholder.size(), kFilePlaceholder) == 0) {
+      entry->scans.emplace_back(
+          std::stoi(splitInfo->paths[0].substr(kFilePlaceholder.size())), id);
+    } else {
+      entry->splitInfos[id] = splitInfo;
+    }
+  }
+  setSplitInfos(*entry, keyed.fileSplits, splitInfos);
+  auto veloxPlan = entry->plan;
+
+  std::lock_guard<std::mutex> l(mutex_);
+  // Another thread may have added the plan meanwhile.
+  if (plans_->add(keyed.key, entry.get(), 1)) {
+    entry.release();
+  }
+  return veloxPlan;
+}
+
+bool SubstraitPlanCache::validate(
+    const ::substrait::Plan& plan,
+    memory::MemoryPool* pool,
+    core::ExecCtx* execCtx) {
+  const auto key = makeKeyedPlan(plan).key;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (auto* valid = validations_->get(key)) {
+      const bool result = *valid;
+      validations_->release(key);
+      return result;
+    }
+  }
+
+  SubstraitToVeloxPlanValidator validator(pool, execCtx);
+  auto valid = std::make_unique<bool>(validator.validate(plan));
+  const bool result = *valid;
+
+  std::lock_guard<std::mutex> l(mutex_);
+  if (validations_->add(key, valid.get(), 1)) {
+    valid.release();
+  }
+  return result;
+}
+
+SimpleLRUCacheStats SubstraitPlanCache::planStats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return plans_->getStats();
+}
+
+SimpleLRUCacheStats SubstraitPlanCache::validationStats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return validations_->getStats();
+}
+
+void SubstraitPlanCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  plans_ = std::make_unique<SimpleLRUCache<std::string, Entry>>(maxEntries_);
+  validations_ =
+      std::make_unique<SimpleLRUCache<std::string, bool>>(maxEntries_);
+}
+
+} // namespace facebook::velox::substrait
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/substrait/SubstraitToVeloxPlan.h"
+
+namespace facebook::velox::substrait {
+
+/// Caches the Velox plans converted from Substrait plans and the results of
+/// their validation. A plan is keyed by its serialization without the files
+/// of its ReadRels, so that the tasks of a query, which only differ in the
+/// files they scan, and repeated queries of the same shape convert and
+/// validate the plan once. The cached plan is returned with split infos made
+/// from the files of each plan.
+///
+/// The plans that read from input streams, i.e. have 'iterator:<index>' as
+/// file, are converted each time, since their input nodes are made by the
+/// caller. Their validation is cached.
+///
+/// Thread-safe.
+class SubstraitPlanCache {
+ public:
+  /// Keeps up to 'maxEntries' plans and as many validation results.
+  explicit SubstraitPlanCache(size_t maxEntries = 1'000);
+
+  /// Returns the Velox plan for 'plan' converted with 'pool'. Sets
+  /// 'splitInfos' to what SubstraitVeloxPlanConverter::splitInfos() returns
+  /// after converting 'plan'.
+  core::PlanNodePtr toVeloxPlan(
+      const ::substrait::Plan& plan,
+      memory::MemoryPool* pool,
+      std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>&
+          splitInfos);
+
+  /// Returns what SubstraitToVeloxPlanValidator::validate() returns for
+  /// 'plan'.
+  bool validate(
+      const ::substrait::Plan& plan,
+      memory::MemoryPool* pool,
+      core::ExecCtx* execCtx);
+
+  SimpleLRUCacheStats planStats() const;
+
+  SimpleLRUCacheStats validationStats() const;
+
+  /// Drops all the cached plans and validation results.
+  void clear();
+
+ private:
+  struct Entry {
+    core::PlanNodePtr plan;
+
+    // The split infos of the leaf nodes that do not scan files, e.g. of
+    // virtual tables.
+    std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>
+        splitInfos;
+
+    // The ordinal of each ReadRel with files and the id of its TableScan.
+    std::vector<std::pair<int32_t, core::PlanNodeId>> scans;
+  };
+
+  // Sets 'splitInfos' to the split infos of 'entry' for a plan whose ReadRels
+  // scan the files in 'fileSplits', indexed by the ordinal of the ReadRel.
+  static void setSplitInfos(
+      const Entry& entry,
+      const std::vector<std::shared_ptr<SplitInfo>>& fileSplits,
+      std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>&
+          splitInfos);
+
+  const size_t maxEntries_;
+  mutable std::mutex mutex_;
+  std::unique_ptr<SimpleLRUCache<std::string, Entry>> plans_;
+  std::unique_ptr<SimpleLRUCache<std::string, bool>> validations_;
+};
+
+} // namespace facebook::velox::substrait
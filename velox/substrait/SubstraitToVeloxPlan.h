@@ -42,6 +42,12 @@ struct SplitInfo {
   dwio::common::FileFormat format;
 };
 
+/// Sets the partition index, paths, starts, lengths and format of
+/// 'splitInfo' from the files of a Substrait ReadRel.
+void parseLocalFiles(
+    const ::substrait::ReadRel::LocalFiles& localFiles,
+    SplitInfo& splitInfo);
+
 /// This class is used to convert the Substrait plan into Velox plan.
 class SubstraitVeloxPlanConverter {
  public:
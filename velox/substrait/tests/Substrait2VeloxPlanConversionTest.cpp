@@ -23,6 +23,7 @@
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/substrait/SubstraitPlanCache.h"
 #include "velox/substrait/SubstraitToVeloxPlan.h"
 #include "velox/substrait/SubstraitToVeloxPlanValidator.h"
 #include "velox/type/Type.h"
@@ -330,3 +331,87 @@ TEST_F(Substrait2VeloxPlanConversionTest, filterUpper) {
       "[(key, BigintRange: [-2147483648, 2] no nulls)]] -> n0_0:INTEGER\n",
       planNode->toString(true, true));
 }
+
+TEST_F(Substrait2VeloxPlanConversionTest, planCache) {
+  std::string subPlanPath =
+      getDataFilePath("velox/substrait/tests", "data/filter_upper.json");
+
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(subPlanPath, substraitPlan);
+
+  // Returns 'substraitPlan' scanning 'numFiles' files named after 'name'.
+  auto withFiles = [&](const std::string& name, int32_t numFiles) {
+    auto plan = substraitPlan;
+    auto* items = plan.mutable_relations(0)
+                      ->mutable_root()
+                      ->mutable_input()
+                      ->mutable_project()
+                      ->mutable_input()
+                      ->mutable_read()
+                      ->mutable_local_files()
+                      ->mutable_items();
+    auto file = items->Get(0);
+    items->Clear();
+    for (auto i = 0; i < numFiles; ++i) {
+      file.set_uri_file(fmt::format("file:///tmp/{}_{}.parquet", name, i));
+      file.set_start(i * 100);
+      file.set_partition_index(numFiles);
+      *items->Add() = file;
+    }
+    return plan;
+  };
+
+  vestrait::SubstraitPlanCache cache;
+  std::unordered_map<core::PlanNodeId, std::shared_ptr<vestrait::SplitInfo>>
+      splitInfos;
+  auto planNode = cache.toVeloxPlan(withFiles("a", 1), pool(), splitInfos);
+  EXPECT_EQ(
+      planNode->toString(true, true),
+      planConverter_->toVeloxPlan(substraitPlan)->toString(true, true));
+  auto scanId = *planNode->leafPlanNodeIds().begin();
+  ASSERT_EQ(splitInfos.size(), 1);
+  EXPECT_EQ(
+      splitInfos.at(scanId)->paths,
+      std::vector<std::string>{"file:///tmp/a_0.parquet"});
+
+  // A plan over other files gets the same plan with its own split infos.
+  auto otherPlanNode =
+      cache.toVeloxPlan(withFiles("b", 3), pool(), splitInfos);
+  EXPECT_EQ(otherPlanNode, planNode);
+  ASSERT_EQ(splitInfos.size(), 1);
+  const auto& splitInfo = *splitInfos.at(scanId);
+  EXPECT_EQ(
+      splitInfo.paths,
+      (std::vector<std::string>{
+          "file:///tmp/b_0.parquet",
+          "file:///tmp/b_1.parquet",
+          "file:///tmp/b_2.parquet"}));
+  EXPECT_EQ(splitInfo.starts, (std::vector<u_int64_t>{0, 100, 200}));
+  EXPECT_EQ(splitInfo.partitionIndex, 3);
+  EXPECT_EQ(splitInfo.format, dwio::common::FileFormat::PARQUET);
+  EXPECT_EQ(cache.planStats().numLookups, 2);
+  EXPECT_EQ(cache.planStats().numHits, 1);
+
+  // A plan with a different filter is converted again.
+  auto otherPlan = withFiles("a", 1);
+  otherPlan.mutable_relations(0)
+      ->mutable_root()
+      ->mutable_input()
+      ->mutable_project()
+      ->mutable_input()
+      ->mutable_read()
+      ->clear_filter();
+  EXPECT_NE(cache.toVeloxPlan(otherPlan, pool(), splitInfos), planNode);
+  EXPECT_EQ(cache.planStats().numElements, 2);
+
+  // Validation results are cached by the same key.
+  auto queryCtx = std::make_shared<core::QueryCtx>();
+  core::ExecCtx execCtx(pool(), queryCtx.get());
+  EXPECT_TRUE(cache.validate(withFiles("a", 1), pool(), &execCtx));
+  EXPECT_TRUE(cache.validate(withFiles("c", 2), pool(), &execCtx));
+  EXPECT_EQ(cache.validationStats().numHits, 1);
+
+  cache.clear();
+  EXPECT_EQ(cache.planStats().numElements, 0);
+  EXPECT_EQ(cache.validationStats().numElements, 0);
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "velox/type/Timestamp.h"
+#include "velox/type/TimestampConversion.h"
+
+/// Parsers for the common, unambiguous text forms of numbers, dates and
+/// timestamps. They never throw and return false for anything they do not
+/// handle, e.g. whitespace, a '+' sign, exponents, values that may overflow
+/// and malformed input. Callers fall back to the general conversions for
+/// these. When they return true, the result is the same as from the general
+/// conversions.
+namespace facebook::velox::util {
+
+namespace detail {
+// Returns true if the 8 bytes of 'chunk' are ASCII digits.
+inline bool isEightDigits(uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+          (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+      0x3333333333333333;
+}
+
+// Returns the value of 8 ASCII digits, the first in the lowest byte.
+inline uint64_t parseEightDigits(uint64_t chunk) {
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+          (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >>
+      32;
+}
+
+// Parses 'size' ASCII digits 8 at a time. 'size' must be at most 19.
+inline bool parseDigits(const char* data, size_t size, uint64_t& value) {
+  value = 0;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t chunk;
+    std::memcpy(&chunk, data + i, sizeof(chunk));
+    if (!isEightDigits(chunk)) {
+      return false;
+    }
+    value = value * 100'000'000 + parseEightDigits(chunk);
+  }
+  for (; i < size; ++i) {
+    const auto digit = static_cast<uint8_t>(data[i] - '0');
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  return true;
+}
+
+// Parses exactly 'size' digits into a small number.
+inline bool parseFixedDigits(const char* data, size_t size, int32_t& value) {
+  uint64_t result;
+  if (!parseDigits(data, size, result)) {
+    return false;
+  }
+  value = result;
+  return true;
+}
+} // namespace detail
+
+/// Parses an optional '-' followed by at most digits10 digits of T.
+template <typename T>
+bool tryParseInteger(const char* data, size_t size, T& result) {
+  static_assert(std::is_integral_v<T> && std::is_signed_v<T>);
+  const bool negative = size > 0 && data[0] == '-';
+  const size_t numDigits = size - negative;
+  if (numDigits == 0 || numDigits > std::numeric_limits<T>::digits10) {
+    return false;
+  }
+  uint64_t value;
+  if (!detail::parseDigits(data + negative, numDigits, value)) {
+    return false;
+  }
+  result = negative ? -static_cast<int64_t>(value) : value;
+  return true;
+}
+
+/// Parses an optional '-', at least one digit and an optional '.' followed
+/// by at least one digit, with at most 15 digits in total. The result is
+/// exact since both the digits and the power of 10 they are divided by are
+/// exact doubles and the division is correctly rounded.
+inline bool tryParseDouble(const char* data, size_t size, double& result) {
+  static constexpr double kPowersOf10[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15};
+  const bool negative = size > 0 && data[0] == '-';
+  const char* digits = data + negative;
+  const size_t length = size - negative;
+  const auto* dot = static_cast<const char*>(std::memchr(digits, '.', length));
+  const size_t numIntegerDigits = dot ? dot - digits : length;
+  const size_t numFractionDigits = dot ? length - numIntegerDigits - 1 : 0;
+  if (numIntegerDigits == 0 || (dot && numFractionDigits == 0) ||
+      numIntegerDigits + numFractionDigits > 15) {
+    return false;
+  }
+  uint64_t integerPart;
+  uint64_t fractionPart = 0;
+  if (!detail::parseDigits(digits, numIntegerDigits, integerPart) ||
+      (dot && !detail::parseDigits(dot + 1, numFractionDigits, fractionPart))) {
+    return false;
+  }
+  const auto scale = kPowersOf10[numFractionDigits];
+  result = static_cast<double>(
+               integerPart * static_cast<uint64_t>(scale) + fractionPart) /
+      scale;
+  if (negative) {
+    result = -result;
+  }
+  return true;
+}
+
+/// Parses YYYY-MM-DD into days since epoch.
+inline bool tryParseDate(const char* data, size_t size, int64_t& result) {
+  int32_t year;
+  int32_t month;
+  int32_t day;
+  if (size != 10 || data[4] != '-' || data[7] != '-' ||
+      !detail::parseFixedDigits(data, 4, year) ||
+      !detail::parseFixedDigits(data + 5, 2, month) ||
+      !detail::parseFixedDigits(data + 8, 2, day) || year == 0 ||
+      !isValidDate(year, month, day)) {
+    return false;
+  }
+  result = daysSinceEpochFromDate(year, month, day);
+  return true;
+}
+
+/// Parses YYYY-MM-DD HH:MM:SS with an optional fraction of up to 6 digits.
+/// The separator between date and time can also be 'T'.
+inline bool
+tryParseTimestamp(const char* data, size_t size, Timestamp& result) {
+  int64_t daysSinceEpoch;
+  int32_t hour;
+  int32_t minute;
+  int32_t second;
+  int32_t micros = 0;
+  if (size < 19 || size == 20 || size > 26 ||
+      !tryParseDate(data, 10, daysSinceEpoch) ||
+      (data[10] != ' ' && data[10] != 'T') || data[13] != ':' ||
+      data[16] != ':' || !detail::parseFixedDigits(data + 11, 2, hour) ||
+      !detail::parseFixedDigits(data + 14, 2, minute) ||
+      !detail::parseFixedDigits(data + 17, 2, second) || hour >= 24 ||
+      minute >= 60 || second > 60) {
+    return false;
+  }
+  if (size > 19) {
+    if (data[19] != '.' ||
+        !detail::parseFixedDigits(data + 20, size - 20, micros)) {
+      return false;
+    }
+    for (auto i = size - 20; i < 6; ++i) {
+      micros *= 10;
+    }
+  }
+  result = fromDatetime(daysSinceEpoch, fromTime(hour, minute, second, micros));
+  return true;
+}
+
+} // namespace facebook::velox::util
@@ -95,6 +95,9 @@ std::string Filter::toString() const {
     case FilterKind::kShortDecimalMultiRange:
       strKind = "ShortDecimalMultiRange";
       break;
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      strKind = "BigintValuesUsingBloomFilter";
+      break;
   };
 
   return fmt::format(
@@ -193,6 +196,14 @@ BigintValuesUsingHashTable::BigintValuesUsingHashTable(
   for (auto i = 0; i < kPaddingElements; ++i) {
     hashTable_[sizeMask_ + 1 + i] = hashTable_[sizeMask_];
   }
+  if (size >= kMinSizeForOccupiedBits) {
+    occupied_.resize(bits::nwords(size));
+    for (uint32_t i = 0; i < size; ++i) {
+      if (hashTable_[i] != kEmptyMarker) {
+        bits::setBit(occupied_.data(), i);
+      }
+    }
+  }
   std::sort(values_.begin(), values_.end());
 }
 
@@ -204,6 +215,9 @@ bool BigintValuesUsingHashTable::testInt64(int64_t value) const {
     return false;
   }
   uint32_t pos = (value * M) & sizeMask_;
+  if (!occupied_.empty() && !bits::isBitSet(occupied_.data(), pos)) {
+    return false;
+  }
   for (auto i = pos; i <= pos + sizeMask_; i++) {
     int32_t idx = i & sizeMask_;
     int64_t l = hashTable_[idx];
@@ -231,8 +245,25 @@ xsimd::batch_bool<int64_t> BigintValuesUsingHashTable::testValues(
   // Temporarily casted to unsigned to suppress overflow error.
   auto indices = simd::reinterpretBatch<int64_t>(
       simd::reinterpretBatch<uint64_t>(x) * M & sizeMask_);
-  auto data =
-      simd::maskGather(allEmpty, ~outOfRange, hashTable_.data(), indices);
+  constexpr int kAlign = xsimd::default_arch::alignment();
+  constexpr int kArraySize = xsimd::batch<int64_t>::size;
+  auto toProbe = ~outOfRange;
+  if (!occupied_.empty()) {
+    // Leaves out the lanes whose first slot is empty, so that these miss
+    // without accessing 'hashTable_'.
+    alignas(kAlign) int64_t firstIndices[kArraySize];
+    indices.store_aligned(firstIndices);
+    int32_t occupiedBits = 0;
+    for (auto i = 0; i < kArraySize; ++i) {
+      occupiedBits |= bits::isBitSet(occupied_.data(), firstIndices[i]) << i;
+    }
+    occupiedBits &= ~simd::toBitMask(outOfRange);
+    if (!occupiedBits) {
+      return xsimd::batch_bool<int64_t>(false);
+    }
+    toProbe = simd::fromBitMask<int64_t>(occupiedBits);
+  }
+  auto data = simd::maskGather(allEmpty, toProbe, hashTable_.data(), indices);
   // The lanes with kEmptyMarker missed, the lanes matching x hit and the other
   // lanes must check next positions.
 
@@ -244,8 +275,6 @@ xsimd::batch_bool<int64_t> BigintValuesUsingHashTable::testValues(
   if (!unresolved) {
     return result;
   }
-  constexpr int kAlign = xsimd::default_arch::alignment();
-  constexpr int kArraySize = xsimd::batch<int64_t>::size;
   alignas(kAlign) int64_t indicesArray[kArraySize];
   alignas(kAlign) int64_t valuesArray[kArraySize];
   (indices + 1).store_aligned(indicesArray);
@@ -588,6 +617,23 @@ bool BytesRange::testBytesRange(
   return true;
 }
 
+void BytesValues::initPrefilter() {
+  for (auto length : lengths_) {
+    if (length < 64) {
+      lengthBits_ |= 1UL << length;
+    }
+  }
+  auto numBits =
+      std::max<uint64_t>(64, bits::nextPowerOfTwo(8 * values_.size()));
+  prefilter_.resize(numBits / 64);
+  prefilterMask_ = numBits - 1;
+  for (const auto& value : values_) {
+    bits::setBit(
+        prefilter_.data(),
+        prefilterHash(value.data(), value.size()) & prefilterMask_);
+  }
+}
+
 bool BytesValues::testBytesRange(
     std::optional<std::string_view> min,
     std::optional<std::string_view> max,
@@ -1198,6 +1244,7 @@ std::unique_ptr<Filter> BigintRange::mergeWith(const Filter* other) const {
     case FilterKind::kNegatedBigintRange:
     case FilterKind::kBigintValuesUsingBitmask:
     case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
@@ -1387,6 +1434,7 @@ std::unique_ptr<Filter> NegatedBigintRange::mergeWith(
     }
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kNegatedBigintValuesUsingHashTable:
     case FilterKind::kNegatedBigintValuesUsingBitmask: {
@@ -1442,6 +1490,7 @@ std::unique_ptr<Filter> BigintValuesUsingHashTable::mergeWith(
       return mergeWith(min, max, other);
     }
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
@@ -1515,6 +1564,7 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
     case FilterKind::kIsNull:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
       return std::make_unique<BigintValuesUsingBitmask>(*this, false);
@@ -1584,6 +1634,96 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
   return createBigintValues(valuesToKeep, bothNullAllowed);
 }
 
+xsimd::batch_bool<int64_t> BigintValuesUsingBloomFilter::testValues(
+    xsimd::batch<int64_t> values) const {
+  if (otherFilter_ != nullptr) {
+    return Filter::testValues(values);
+  }
+  // The values are hashed one by one and their Bloom filter words are
+  // gathered at once.
+  constexpr int32_t kBatchSize = xsimd::batch<int64_t>::size;
+  alignas(xsimd::default_arch::alignment()) int64_t hashes[kBatchSize];
+  values.store_aligned(hashes);
+  for (auto i = 0; i < kBatchSize; ++i) {
+    hashes[i] = hash(hashes[i]);
+  }
+  return (xsimd::broadcast<int64_t>(min_) <= values) &
+      (values <= xsimd::broadcast<int64_t>(max_)) &
+      bloomFilter_->mayContain(xsimd::load_aligned(hashes));
+}
+
+bool BigintValuesUsingBloomFilter::testInt64Range(
+    int64_t min,
+    int64_t max,
+    bool hasNull) const {
+  if (hasNull && nullAllowed_) {
+    return true;
+  }
+  if (min > max_ || max < min_) {
+    return false;
+  }
+  if (min == max) {
+    return testInt64(min);
+  }
+  return otherFilter_ == nullptr ||
+      otherFilter_->testInt64Range(
+          std::max(min, min_), std::min(max, max_), false);
+}
+
+std::unique_ptr<Filter> BigintValuesUsingBloomFilter::mergeWith(
+    const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this, false);
+    case FilterKind::kBigintRange: {
+      auto otherRange = static_cast<const BigintRange*>(other);
+      const bool bothNullAllowed = nullAllowed_ && other->testNull();
+      const auto min = std::max(min_, otherRange->lower());
+      const auto max = std::min(max_, otherRange->upper());
+      if (min > max) {
+        return nullOrFalse(bothNullAllowed);
+      }
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          min, max, bloomFilter_, bothNullAllowed, otherFilter_);
+    }
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBitmask: {
+      // The exact IN-list is usually much smaller so we only keep the values
+      // which pass 'this'.
+      const auto values =
+          other->kind() == FilterKind::kBigintValuesUsingHashTable
+          ? static_cast<const BigintValuesUsingHashTable*>(other)->values()
+          : static_cast<const BigintValuesUsingBitmask*>(other)->values();
+      std::vector<int64_t> valuesToKeep;
+      for (auto value : values) {
+        if (testInt64(value)) {
+          valuesToKeep.push_back(value);
+        }
+      }
+      const bool bothNullAllowed = nullAllowed_ && other->testNull();
+      return createBigintValues(valuesToKeep, bothNullAllowed);
+    }
+    case FilterKind::kNegatedBigintRange:
+    case FilterKind::kNegatedBigintValuesUsingHashTable:
+    case FilterKind::kNegatedBigintValuesUsingBitmask:
+    case FilterKind::kBigintMultiRange:
+    case FilterKind::kBigintValuesUsingBloomFilter: {
+      const bool bothNullAllowed = nullAllowed_ && other->testNull();
+      std::shared_ptr<const Filter> otherFilter = otherFilter_ == nullptr
+          ? other->clone(false)
+          : otherFilter_->mergeWith(other);
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          min_, max_, bloomFilter_, bothNullAllowed, std::move(otherFilter));
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
 std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
     const Filter* other) const {
   // Rules of NegatedBigintValuesUsingHashTable with IsNull/IsNotNull
@@ -1604,7 +1744,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
     case FilterKind::kBigintRange:
-    case FilterKind::kBigintMultiRange: {
+    case FilterKind::kBigintMultiRange:
+    case FilterKind::kBigintValuesUsingBloomFilter: {
       return other->mergeWith(this);
     }
     case FilterKind::kNegatedBigintValuesUsingHashTable: {
@@ -1644,7 +1785,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingBitmask::mergeWith(
     case FilterKind::kBigintValuesUsingBitmask:
     case FilterKind::kBigintRange:
     case FilterKind::kNegatedBigintRange:
-    case FilterKind::kBigintMultiRange: {
+    case FilterKind::kBigintMultiRange:
+    case FilterKind::kBigintValuesUsingBloomFilter: {
       return other->mergeWith(this);
     }
     case FilterKind::kNegatedBigintValuesUsingHashTable: {
@@ -1684,7 +1826,8 @@ std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
     case FilterKind::kBigintRange:
     case FilterKind::kNegatedBigintRange:
     case FilterKind::kBigintValuesUsingBitmask:
-    case FilterKind::kBigintValuesUsingHashTable: {
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBloomFilter: {
       return other->mergeWith(this);
     }
     case FilterKind::kBigintMultiRange: {
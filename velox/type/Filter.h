@@ -24,7 +24,9 @@
 
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
+#include <folly/hash/Hash.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/type/StringView.h"
@@ -57,6 +59,7 @@ enum class FilterKind {
   kHugeintRange,
   kShortDecimalRange,
   kShortDecimalMultiRange,
+  kBigintValuesUsingBloomFilter,
 };
 
 /**
@@ -942,6 +945,7 @@ class BigintValuesUsingHashTable final : public Filter {
         min_(other.min_),
         max_(other.max_),
         hashTable_(other.hashTable_),
+        occupied_(other.occupied_),
         containsEmptyMarker_(other.containsEmptyMarker_),
         values_(other.values_),
         sizeMask_(other.sizeMask_) {}
@@ -994,9 +998,18 @@ class BigintValuesUsingHashTable final : public Filter {
   // from Murmur hash
   static constexpr uint64_t M = 0xc6a4a7935bd1e995L;
 
+  // Hash tables with at least this many slots get 'occupied_'. Smaller ones
+  // stay in cache and are probed directly.
+  static constexpr int32_t kMinSizeForOccupiedBits = 1 << 15;
+
   const int64_t min_;
   const int64_t max_;
   std::vector<int64_t> hashTable_;
+  // A bit per slot of 'hashTable_', set if the slot is not empty. Empty for
+  // small tables. A value whose first slot is empty misses without touching
+  // 'hashTable_', which is 64x larger and does not fit in cache for large IN
+  // lists.
+  std::vector<uint64_t> occupied_;
   bool containsEmptyMarker_ = false;
   std::vector<int64_t> values_;
   int32_t sizeMask_;
@@ -1052,6 +1065,101 @@ class BigintValuesUsingBitmask final : public Filter {
   const int64_t max_;
 };
 
+/// Approximate IN-list filter for integral data types. Implemented as a Bloom
+/// filter over the hashes of the values. Passes all the values in the list and
+/// a small fraction (~2%) of the other values within [min, max]. Used for the
+/// dynamic filters pushed down from a hash join build side with too many
+/// distinct keys to express as an exact IN-list, and for the runtime filters
+/// of Spark's might_contain().
+class BigintValuesUsingBloomFilter final : public Filter {
+ public:
+  /// @param min Minimum value.
+  /// @param max Maximum value.
+  /// @param bloomFilter A Bloom filter with the hash of each value in the list
+  /// inserted. The hash is computed by hash(value).
+  /// @param nullAllowed Null values are passing the filter if true.
+  /// @param otherFilter An optional filter the values must also pass. This is
+  /// set when merging with a filter which can't be applied to the Bloom filter
+  /// directly.
+  BigintValuesUsingBloomFilter(
+      int64_t min,
+      int64_t max,
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed,
+      std::shared_ptr<const Filter> otherFilter = nullptr)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(min),
+        max_(max),
+        bloomFilter_(std::move(bloomFilter)),
+        otherFilter_(std::move(otherFilter)) {
+    VELOX_CHECK_LE(min_, max_);
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+    VELOX_CHECK(bloomFilter_->isSet());
+  }
+
+  BigintValuesUsingBloomFilter(
+      const BigintValuesUsingBloomFilter& other,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(other.min_),
+        max_(other.max_),
+        bloomFilter_(other.bloomFilter_),
+        otherFilter_(other.otherFilter_) {}
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    if (nullAllowed) {
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          *this, nullAllowed.value());
+    } else {
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this);
+    }
+  }
+
+  /// Returns the hash of 'value' to insert into or test against the Bloom
+  /// filter.
+  static uint64_t hash(int64_t value) {
+    return folly::hasher<int64_t>()(value);
+  }
+
+  bool testInt64(int64_t value) const final {
+    return value >= min_ && value <= max_ &&
+        bloomFilter_->mayContain(hash(value)) &&
+        (otherFilter_ == nullptr || otherFilter_->testInt64(value));
+  }
+
+  xsimd::batch_bool<int64_t> testValues(
+      xsimd::batch<int64_t> values) const final;
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
+
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  int64_t min() const {
+    return min_;
+  }
+
+  int64_t max() const {
+    return max_;
+  }
+
+  std::string toString() const final {
+    return fmt::format(
+        "BigintValuesUsingBloomFilter: [{}, {}] {}",
+        min_,
+        max_,
+        nullAllowed_ ? "with nulls" : "no nulls");
+  }
+
+ private:
+  const int64_t min_;
+  const int64_t max_;
+  // Shared by the copies of the filter as the Bloom filter is immutable and
+  // can be large.
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+  const std::shared_ptr<const Filter> otherFilter_;
+};
+
 // NOT IN-list filter for integral data types. Implemented as a hash table. Good
 // for large number of rejected values that do not fit within a small range.
 class NegatedBigintValuesUsingHashTable final : public Filter {
@@ -1701,6 +1809,7 @@ class BytesValues final : public Filter {
 
     lower_ = *std::min_element(values_.begin(), values_.end());
     upper_ = *std::max_element(values_.begin(), values_.end());
+    initPrefilter();
   }
 
   BytesValues(const BytesValues& other, bool nullAllowed)
@@ -1708,7 +1817,10 @@ class BytesValues final : public Filter {
         lower_(other.lower_),
         upper_(other.upper_),
         values_(other.values_),
-        lengths_(other.lengths_) {}
+        lengths_(other.lengths_),
+        lengthBits_(other.lengthBits_),
+        prefilter_(other.prefilter_),
+        prefilterMask_(other.prefilterMask_) {}
 
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
@@ -1720,12 +1832,18 @@ class BytesValues final : public Filter {
   }
 
   bool testLength(int32_t length) const final {
+    if (length < 64) {
+      return lengthBits_ & (1UL << length);
+    }
     return lengths_.contains(length);
   }
 
   bool testBytes(const char* value, int32_t length) const final {
-    return lengths_.contains(length) &&
-        values_.contains(std::string(value, length));
+    return testLength(length) &&
+        bits::isBitSet(
+               prefilter_.data(),
+               prefilterHash(value, length) & prefilterMask_) &&
+        values_.contains(folly::StringPiece(value, length));
   }
 
   bool testBytesRange(
@@ -1740,10 +1858,35 @@ class BytesValues final : public Filter {
   }
 
  private:
+  // Hashes the length and the first and last 8 bytes of a value for
+  // 'prefilter_'. These tell apart most values of large IN lists, including
+  // ids that only differ in their last characters.
+  static uint64_t prefilterHash(const char* value, int32_t length) {
+    if (length < 8) {
+      return bits::hashMix(
+          length,
+          bits::loadPartialWord(
+              reinterpret_cast<const uint8_t*>(value), length));
+    }
+    return bits::hashMix(
+        folly::loadUnaligned<uint64_t>(value) + length,
+        folly::loadUnaligned<uint64_t>(value + length - 8));
+  }
+
+  // Sets 'lengthBits_' and 'prefilter_' from 'lengths_' and 'values_'.
+  void initPrefilter();
+
   std::string lower_;
   std::string upper_;
   folly::F14FastSet<std::string> values_;
   folly::F14FastSet<uint32_t> lengths_;
+  // A bit for each of the lengths in 'lengths_' that is less than 64.
+  uint64_t lengthBits_{0};
+  // A bit array indexed by 'prefilterHash' of the values, with about 8 bits
+  // per value. Most values that are not in 'values_' find their bit clear, so
+  // that only about 1 in 8 of them gets hashed and compared in full.
+  std::vector<uint64_t> prefilter_;
+  uint64_t prefilterMask_{0};
 };
 
 /// Represents a combination of two of more range filters on integral types with
@@ -531,7 +531,7 @@ int64_t fromDateString(const char* str, size_t len) {
   if (!tryParseDateString(str, len, pos, daysSinceEpoch, true)) {
     if (len == 19) {
       // Timestamp format: (YYYY-MM-DD HH:MM:SS).
-      std::string input(str);
+      std::string input(str, len);
       size_t strLen = 10;
       std::string leadingStr = input.substr(0, strLen);
       if (!tryParseDateString(
@@ -31,21 +31,30 @@ using namespace facebook::velox::common;
 std::vector<int64_t> sparseValues;
 std::vector<int64_t> denseValues;
 std::unique_ptr<BigintValuesUsingHashTable> filter;
+// An IN list large enough to have a bitmap of occupied hash table slots.
+std::unique_ptr<BigintValuesUsingHashTable> largeFilter;
 
-int32_t run1x64(const std::vector<int64_t>& data) {
+std::vector<std::string> bytesData;
+std::unique_ptr<BytesValues> bytesFilter;
+
+int32_t run1x64(
+    const std::vector<int64_t>& data,
+    const BigintValuesUsingHashTable& filter = *::filter) {
   int32_t count = 0;
   for (auto i = 0; i < data.size(); ++i) {
-    count += filter->testInt64(data[i]);
+    count += filter.testInt64(data[i]);
   }
   return count;
 }
 
-int32_t run4x64(const std::vector<int64_t>& data) {
+int32_t run4x64(
+    const std::vector<int64_t>& data,
+    const BigintValuesUsingHashTable& filter = *::filter) {
   constexpr int kStep = xsimd::batch<int64_t>::size;
   int32_t count = 0;
   assert(data.size() % kStep == 0);
   for (auto i = 0; i < data.size(); i += kStep) {
-    auto result = filter->testValues(xsimd::load_unaligned(data.data() + i));
+    auto result = filter.testValues(xsimd::load_unaligned(data.data() + i));
     count += __builtin_popcount(simd::toBitMask(result));
   }
   return count;
@@ -67,6 +76,22 @@ BENCHMARK_RELATIVE(simdSparse) {
   folly::doNotOptimizeAway(run4x64(sparseValues));
 }
 
+BENCHMARK(scalarLargeInList) {
+  folly::doNotOptimizeAway(run1x64(sparseValues, *largeFilter));
+}
+
+BENCHMARK_RELATIVE(simdLargeInList) {
+  folly::doNotOptimizeAway(run4x64(sparseValues, *largeFilter));
+}
+
+BENCHMARK(bytesInList) {
+  int32_t count = 0;
+  for (const auto& value : bytesData) {
+    count += bytesFilter->testBytes(value.data(), value.size());
+  }
+  folly::doNotOptimizeAway(count);
+}
+
 int32_t main(int32_t argc, char* argv[]) {
   constexpr int32_t kNumValues = 1000000;
   constexpr int32_t kFilterValues = 1000;
@@ -79,6 +104,28 @@ int32_t main(int32_t argc, char* argv[]) {
   }
   filter = std::make_unique<BigintValuesUsingHashTable>(
       filterValues.front(), filterValues.back(), filterValues, false);
+  // 1 in 10 of 'sparseValues' hits in 'largeFilter'.
+  constexpr int32_t kLargeFilterValues = 100000;
+  filterValues.clear();
+  for (auto i = 0; i < kLargeFilterValues; ++i) {
+    filterValues.push_back(i * 10000);
+  }
+  largeFilter = std::make_unique<BigintValuesUsingHashTable>(
+      filterValues.front(), filterValues.back(), filterValues, false);
+
+  // Strings of 10 to 30 bytes with a common prefix. 1 in 10 of 'bytesData'
+  // hits in 'bytesFilter'.
+  std::vector<std::string> bytesValues;
+  for (auto i = 0; i < kFilterValues * 10; ++i) {
+    bytesValues.push_back(fmt::format("item_{}", i * 10 * (1 + i % 1000)));
+  }
+  bytesFilter = std::make_unique<BytesValues>(bytesValues, false);
+  for (auto i = 0; i < kNumValues; ++i) {
+    auto n = folly::Random::rand32() % (kFilterValues * 10);
+    bytesData.push_back(fmt::format(
+        "item_{}", n * 10 * (1 + n % 1000) + (i % 10 == 0 ? 0 : 1)));
+  }
+
   denseValues.resize(kNumValues);
   sparseValues.resize(kNumValues);
   for (auto i = 0; i < kNumValues; ++i) {
@@ -88,6 +135,8 @@ int32_t main(int32_t argc, char* argv[]) {
 
   VELOX_CHECK_EQ(run1x64(denseValues), run4x64(denseValues));
   VELOX_CHECK_EQ(run1x64(sparseValues), run4x64(sparseValues));
+  VELOX_CHECK_EQ(
+      run1x64(sparseValues, *largeFilter), run4x64(sparseValues, *largeFilter));
   folly::runBenchmarks();
   return 0;
 }
@@ -397,6 +397,39 @@ TEST(FilterTest, bigintValuesUsingHashTableSimd) {
   checkSimd(filter.get(), values, verify);
 }
 
+TEST(FilterTest, bigintValuesUsingHashTableLarge) {
+  // A large IN list whose hash table is big enough to have a bitmap of the
+  // occupied slots. Test values that hit, that miss within [min, max] and
+  // that fall outside of [min, max].
+  std::vector<int64_t> numbers;
+  for (auto i = 0; i < 100'000; ++i) {
+    numbers.push_back(i * 997);
+  }
+  auto filter = createBigintValues(numbers, false);
+  ASSERT_TRUE(dynamic_cast<BigintValuesUsingHashTable*>(filter.get()));
+  auto verify = [&](int64_t x) { return filter->testInt64(x); };
+  for (auto i = 0; i < 1'000; ++i) {
+    EXPECT_TRUE(filter->testInt64(numbers[i * 97]));
+    EXPECT_FALSE(filter->testInt64(numbers[i * 97] + 1));
+  }
+  EXPECT_FALSE(filter->testInt64(-1));
+  EXPECT_FALSE(filter->testInt64(numbers.back() + 997));
+  applySimdTestToVector(numbers, *filter, verify);
+
+  std::vector<int64_t> misses;
+  for (auto i = 0; i < 1'000; ++i) {
+    misses.push_back(i * 1'203 + 1);
+  }
+  applySimdTestToVector(misses, *filter, verify);
+
+  // The clone has the same bitmap.
+  auto copy = filter->clone();
+  for (auto i = 0; i < 1'000; ++i) {
+    EXPECT_TRUE(copy->testInt64(numbers[i * 97]));
+    EXPECT_EQ(filter->testInt64(misses[i]), copy->testInt64(misses[i]));
+  }
+}
+
 TEST(FilterTest, negatedBigintValuesUsingHashTableSimd) {
   std::vector<int64_t> numbers;
   // make a worst case filter where every item falls on the same slot.
@@ -455,6 +488,61 @@ TEST(FilterTest, bigintValuesUsingBitmask) {
   EXPECT_FALSE(filter->testInt64Range(1234, 2000, false));
 }
 
+namespace {
+std::unique_ptr<Filter> bigintValuesUsingBloomFilter(
+    const std::vector<int64_t>& values,
+    bool nullAllowed = false) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(values.size());
+  for (auto value : values) {
+    bloomFilter->insert(BigintValuesUsingBloomFilter::hash(value));
+  }
+  const auto [min, max] = std::minmax_element(values.begin(), values.end());
+  return std::make_unique<BigintValuesUsingBloomFilter>(
+      *min, *max, std::move(bloomFilter), nullAllowed);
+}
+} // namespace
+
+TEST(FilterTest, bigintValuesUsingBloomFilter) {
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 1'000; ++i) {
+    values.push_back(i * 1'000);
+  }
+  auto filter = bigintValuesUsingBloomFilter(values);
+  ASSERT_EQ(filter->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+
+  // No false negatives.
+  for (auto value : values) {
+    EXPECT_TRUE(filter->testInt64(value));
+  }
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testInt64(-1));
+  EXPECT_FALSE(filter->testInt64(999'001));
+  EXPECT_FALSE(filter->testInt64(INT64_MAX));
+
+  // Few false positives within [min, max].
+  int32_t numTested = 0;
+  int32_t numPassed = 0;
+  for (int64_t value = 1; value < values.back(); value += 7) {
+    if (value % 1'000 != 0) {
+      ++numTested;
+      numPassed += filter->testInt64(value);
+    }
+  }
+  EXPECT_LT(numPassed, numTested / 20);
+
+  EXPECT_TRUE(filter->testInt64Range(5, 5'000, false));
+  EXPECT_TRUE(filter->testInt64Range(0, 0, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -5, false));
+  EXPECT_FALSE(filter->testInt64Range(1'000'000, 2'000'000, false));
+  EXPECT_FALSE(filter->testInt64Range(1'000'000, 2'000'000, true));
+
+  auto nullAllowed = filter->clone(true);
+  EXPECT_TRUE(nullAllowed->testNull());
+  EXPECT_TRUE(nullAllowed->testInt64Range(1'000'000, 2'000'000, true));
+  EXPECT_TRUE(nullAllowed->testInt64(0));
+}
+
 TEST(FilterTest, negatedBigintValuesUsingBitmask) {
   auto filter = createNegatedBigintValues({1, 6, 1000, 8, 9, 100, 10}, false);
   auto castedFilter =
@@ -947,6 +1035,35 @@ TEST(FilterTest, bytesValues) {
   EXPECT_FALSE(filter->testBytesRange(std::nullopt, "Banana", false));
 }
 
+TEST(FilterTest, bytesValuesLarge) {
+  // Many values with a common prefix and lengths below and above 8 and 64
+  // bytes. Misses differ from a value only in the last byte or in length.
+  std::vector<std::string> values;
+  for (auto i = 0; i < 10'000; ++i) {
+    values.push_back(fmt::format("{}{}", std::string(i % 100, 'x'), i * 2));
+  }
+  values.push_back("");
+  auto filter = in(values);
+  for (const auto& value : values) {
+    EXPECT_TRUE(filter->testBytes(value.data(), value.size()));
+    EXPECT_TRUE(filter->testLength(value.size()));
+  }
+  std::string miss;
+  for (auto i = 0; i < 10'000; ++i) {
+    miss = fmt::format("{}{}", std::string(i % 100, 'x'), i * 2 + 1);
+    EXPECT_FALSE(filter->testBytes(miss.data(), miss.size()));
+    miss = fmt::format("{}{}", std::string(i % 100 + 1, 'x'), i * 2);
+    EXPECT_FALSE(filter->testBytes(miss.data(), miss.size()));
+  }
+  EXPECT_FALSE(filter->testLength(200));
+
+  auto copy = filter->clone();
+  for (size_t i = 0; i < values.size(); i += 7) {
+    EXPECT_TRUE(copy->testBytes(values[i].data(), values[i].size()));
+  }
+  EXPECT_FALSE(copy->testBytes("x1", 2));
+}
+
 TEST(FilterTest, negatedBytesValues) {
   // create a filter
   std::vector<std::string> values(
@@ -1400,6 +1517,12 @@ TEST(FilterTest, mergeWithBigint) {
   filters.push_back(notIn({empty - 5, empty, empty + 5}, true));
   filters.push_back(notIn({5, 498, 499, 500}, false));
 
+  // IN-list using Bloom filter.
+  filters.push_back(bigintValuesUsingBloomFilter({1, 2, 3, 134, 500, 777}));
+  filters.push_back(
+      bigintValuesUsingBloomFilter({1, 2, 3, 134, 500, 777}, true));
+  filters.push_back(bigintValuesUsingBloomFilter({-7, -5, 123, 210, 10'134}));
+
   for (const auto& left : filters) {
     for (const auto& right : filters) {
       testMergeWithBigint(left.get(), right.get());
@@ -631,6 +631,95 @@ std::shared_ptr<BaseVector> BaseVector::createNullConstant(
       newNullConstant, type->kind(), type, size, pool);
 }
 
+// static
+VectorPtr BaseVector::compactStringBuffers(
+    const VectorPtr& vector,
+    double minUsedRatio) {
+  if (minUsedRatio <= 0 || vector == nullptr) {
+    return vector;
+  }
+  const auto size = vector->size();
+  if (vector->encoding() == VectorEncoding::Simple::ROW) {
+    auto* rowVector = vector->asUnchecked<RowVector>();
+    std::vector<VectorPtr> children;
+    children.reserve(rowVector->childrenSize());
+    bool compacted = false;
+    for (const auto& child : rowVector->children()) {
+      children.push_back(compactStringBuffers(child, minUsedRatio));
+      compacted |= children.back() != child;
+    }
+    if (!compacted) {
+      return vector;
+    }
+    return std::make_shared<RowVector>(
+        vector->pool(),
+        vector->type(),
+        vector->nulls(),
+        size,
+        std::move(children));
+  }
+
+  if (vector->typeKind() != TypeKind::VARCHAR &&
+      vector->typeKind() != TypeKind::VARBINARY) {
+    return vector;
+  }
+  // Lazy and constant vectors, also under dictionaries, are left as is.
+  const BaseVector* base = vector.get();
+  while (base->encoding() == VectorEncoding::Simple::DICTIONARY) {
+    base = base->valueVector().get();
+  }
+  if (base->encoding() != VectorEncoding::Simple::FLAT) {
+    return vector;
+  }
+  auto* flatBase = base->asUnchecked<FlatVector<StringView>>();
+  uint64_t bufferBytes = 0;
+  for (const auto& buffer : flatBase->stringBuffers()) {
+    bufferBytes += buffer->capacity();
+  }
+  if (bufferBytes == 0) {
+    return vector;
+  }
+  uint64_t usedBytes = 0;
+  for (auto i = 0; i < size; ++i) {
+    if (vector->isNullAt(i)) {
+      continue;
+    }
+    const auto value = flatBase->valueAtFast(vector->wrappedIndex(i));
+    if (!value.isInline()) {
+      usedBytes += value.size();
+    }
+  }
+  if (usedBytes >= bufferBytes * minUsedRatio) {
+    return vector;
+  }
+
+  auto result = BaseVector::create<FlatVector<StringView>>(
+      vector->type(), size, vector->pool());
+  BufferPtr stringBuffer;
+  char* rawStrings = nullptr;
+  if (usedBytes > 0) {
+    stringBuffer = AlignedBuffer::allocate<char>(usedBytes, vector->pool());
+    rawStrings = stringBuffer->asMutable<char>();
+    result->addStringBuffer(stringBuffer);
+  }
+  uint64_t offset = 0;
+  for (auto i = 0; i < size; ++i) {
+    if (vector->isNullAt(i)) {
+      result->setNull(i, true);
+      continue;
+    }
+    const auto value = flatBase->valueAtFast(vector->wrappedIndex(i));
+    if (value.isInline()) {
+      result->setNoCopy(i, value);
+      continue;
+    }
+    ::memcpy(rawStrings + offset, value.data(), value.size());
+    result->setNoCopy(i, StringView(rawStrings + offset, value.size()));
+    offset += value.size();
+  }
+  return result;
+}
+
 // static
 VectorPtr BaseVector::loadedVectorShared(VectorPtr vector) {
   if (vector->encoding() != VectorEncoding::Simple::LAZY) {
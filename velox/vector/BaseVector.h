@@ -529,6 +529,18 @@ class BaseVector {
         vector);
   }
 
+  /// Returns a copy of 'vector' with its strings copied to a new string
+  /// buffer holding only the referenced strings if the non-inlined strings
+  /// referenced by 'vector' take less than 'minUsedRatio' of the string
+  /// buffers that 'vector' keeps alive, e.g. after a selective filter over
+  /// long strings. Returns 'vector' otherwise. Applies to flat and dictionary
+  /// encoded VARCHAR and VARBINARY vectors and recursively to the children of
+  /// ROW vectors. A compacted dictionary encoded vector is returned flat. A
+  /// non-positive 'minUsedRatio' disables the compaction.
+  static std::shared_ptr<BaseVector> compactStringBuffers(
+      const std::shared_ptr<BaseVector>& vector,
+      double minUsedRatio);
+
   template <typename T>
   static inline uint64_t byteSize(vector_size_t count) {
     return sizeof(T) * count;
@@ -285,6 +285,12 @@ void FlatVector<T>::copyValuesAndNulls(
       bits::fillBits(
           rawNulls, targetIndex, targetIndex + count, bits::kNotNull);
     }
+  } else if (
+      source->encoding() == VectorEncoding::Simple::DICTIONARY &&
+      source->typeKind() != TypeKind::UNKNOWN &&
+      source->valueVector()->isFlatEncoding() &&
+      source->valueVector()->values() != nullptr) {
+    copyFromDictionary(source, targetIndex, sourceIndex, count, rawNulls);
   } else {
     auto sourceVector = source->asUnchecked<SimpleVector<T>>();
     for (int32_t i = 0; i < count; ++i) {
@@ -300,6 +306,71 @@ void FlatVector<T>::copyValuesAndNulls(
   }
 }
 
+namespace detail {
+// Sets 'target[i]' to 'base[indices[i]]' for i < 'count'. Uses SIMD gather
+// for 32 and 64 bit numbers.
+template <typename T>
+void gatherValues(
+    const T* base,
+    const vector_size_t* indices,
+    vector_size_t count,
+    T* target) {
+  vector_size_t i = 0;
+  if constexpr (
+      std::is_arithmetic_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)) {
+    constexpr vector_size_t kBatchSize = xsimd::batch<T>::size;
+    for (; i + kBatchSize <= count; i += kBatchSize) {
+      simd::gather(base, indices + i).store_unaligned(target + i);
+    }
+  }
+  for (; i < count; ++i) {
+    target[i] = base[indices[i]];
+  }
+}
+} // namespace detail
+
+template <typename T>
+void FlatVector<T>::copyFromDictionary(
+    const BaseVector* source,
+    vector_size_t targetIndex,
+    vector_size_t sourceIndex,
+    vector_size_t count,
+    uint64_t* rawNulls) {
+  const auto* indices =
+      source->wrapInfo()->template as<vector_size_t>() + sourceIndex;
+  const auto* base = source->valueVector().get();
+  const T* baseValues = base->asUnchecked<FlatVector<T>>()->rawValues();
+  const uint64_t* baseNulls = base->rawNulls();
+  if (const uint64_t* wrapperNulls = source->rawNulls()) {
+    // The indices of the rows that are null in the dictionary may be
+    // arbitrary, so these rows must not be read from 'base'.
+    for (vector_size_t i = 0; i < count; ++i) {
+      const auto row = targetIndex + i;
+      if (bits::isBitNull(wrapperNulls, sourceIndex + i)) {
+        bits::setNull(rawNulls, row);
+        continue;
+      }
+      rawValues_[row] = baseValues[indices[i]];
+      bits::setNull(
+          rawNulls, row, baseNulls && bits::isBitNull(baseNulls, indices[i]));
+    }
+    return;
+  }
+
+  detail::gatherValues(baseValues, indices, count, rawValues_ + targetIndex);
+  if (!rawNulls) {
+    return;
+  }
+  if (!baseNulls) {
+    bits::fillBits(rawNulls, targetIndex, targetIndex + count, bits::kNotNull);
+    return;
+  }
+  for (vector_size_t i = 0; i < count; ++i) {
+    bits::setNull(
+        rawNulls, targetIndex + i, bits::isBitNull(baseNulls, indices[i]));
+  }
+}
+
 template <typename T>
 VectorPtr FlatVector<T>::slice(vector_size_t offset, vector_size_t length)
     const {
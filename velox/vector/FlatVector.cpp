@@ -394,9 +394,10 @@ void FlatVector<StringView>::copyRanges(
   auto leaf = source->wrappedVector()->asUnchecked<SimpleVector<StringView>>();
   if (pool_ == leaf->pool()) {
     // We copy referencing the storage of 'source'.
-    for (auto& r : ranges) {
-      copyValuesAndNulls(source, r.targetIndex, r.sourceIndex, r.count);
-    }
+    forEachCoalescedRange(
+        ranges, [&](auto targetIndex, auto sourceIndex, auto count) {
+          copyValuesAndNulls(source, targetIndex, sourceIndex, count);
+        });
     acquireSharedStringBuffers(source);
   } else {
     for (auto& r : ranges) {
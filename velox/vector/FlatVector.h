@@ -236,9 +236,10 @@ class FlatVector final : public SimpleVector<T> {
   void copyRanges(
       const BaseVector* source,
       const folly::Range<const BaseVector::CopyRange*>& ranges) override {
-    for (auto& range : ranges) {
-      copy(source, range.targetIndex, range.sourceIndex, range.count);
-    }
+    forEachCoalescedRange(
+        ranges, [&](auto targetIndex, auto sourceIndex, auto count) {
+          copy(source, targetIndex, sourceIndex, count);
+        });
   }
 
   void resize(vector_size_t newSize, bool setNotNull = true) override;
@@ -425,6 +426,39 @@ class FlatVector final : public SimpleVector<T> {
       vector_size_t sourceIndex,
       vector_size_t count);
 
+  // Copies 'count' rows starting at 'sourceIndex' of 'source', a dictionary
+  // over a flat vector. Reads the base values through the indices without
+  // virtual calls and gathers them with SIMD if the dictionary adds no nulls.
+  void copyFromDictionary(
+      const BaseVector* source,
+      vector_size_t targetIndex,
+      vector_size_t sourceIndex,
+      vector_size_t count,
+      uint64_t* rawNulls);
+
+  // Calls 'func(targetIndex, sourceIndex, count)' for each run of adjacent
+  // 'ranges' that are contiguous in both source and target, e.g. ranges of
+  // one row each produced by a merge or a join, so that each run is copied
+  // with a single memcpy.
+  template <typename Func>
+  static void forEachCoalescedRange(
+      const folly::Range<const BaseVector::CopyRange*>& ranges,
+      Func func) {
+    auto it = ranges.begin();
+    while (it != ranges.end()) {
+      const auto targetIndex = it->targetIndex;
+      const auto sourceIndex = it->sourceIndex;
+      auto count = it->count;
+      ++it;
+      while (it != ranges.end() && it->targetIndex == targetIndex + count &&
+             it->sourceIndex == sourceIndex + count) {
+        count += it->count;
+        ++it;
+      }
+      func(targetIndex, sourceIndex, count);
+    }
+  }
+
   // Ensures that the values buffer has space for 'newSize' elements and is
   // mutable. Sets elements between the old and new sizes to 'initialValue' if
   // the new size > old size.
@@ -38,6 +38,10 @@ namespace velox {
 // that where previously filtered by another filter / column
 class SelectivityVector {
  public:
+  /// A selection is sparse if fewer than one in 'kSparseRatio' rows between
+  /// begin() and end() are selected.
+  static constexpr vector_size_t kSparseRatio = 64;
+
   SelectivityVector() {}
 
   explicit SelectivityVector(vector_size_t length, bool allSelected = true) {
@@ -88,6 +92,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = value ? size_ : 0;
     allSelected_ = value;
+    sparse_.reset();
   }
 
   /**
@@ -99,6 +104,7 @@ class SelectivityVector {
     VELOX_DCHECK_LT(idx, bits_.size() * sizeof(bits_[0]) * 8);
     bits::setBit(bits_.data(), idx, valid);
     allSelected_.reset();
+    sparse_.reset();
   }
 
   /**
@@ -114,6 +120,7 @@ class SelectivityVector {
     VELOX_DCHECK_LE(end, bits_.size() * sizeof(bits_[0]) * 8);
     bits::fillBits(bits_.data(), begin, end, valid);
     allSelected_.reset();
+    sparse_.reset();
   }
 
   /**
@@ -131,6 +138,7 @@ class SelectivityVector {
    * updateBounds() need to be called explicitly if data is modified.
    */
   MutableRange<bool> asMutableRange() {
+    sparse_.reset();
     return MutableRange<bool>(bits_.data(), begin_, end_);
   }
 
@@ -157,6 +165,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = 0;
     allSelected_ = false;
+    sparse_.reset();
   }
 
   /**
@@ -167,6 +176,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = size_;
     allSelected_ = true;
+    sparse_.reset();
   }
 
   void setFromBits(const uint64_t* bits, int32_t size) {
@@ -280,10 +290,12 @@ class SelectivityVector {
       begin_ = 0;
       end_ = 0;
       allSelected_ = false;
+      sparse_.reset();
       return;
     }
     end_ = bits::findLastBit(bits_.data(), begin_, size_) + 1;
     allSelected_.reset();
+    sparse_.reset();
   }
 
   bool isAllSelected() const {
@@ -301,6 +313,9 @@ class SelectivityVector {
     if (allSelected_.has_value() && *allSelected_) {
       return size();
     }
+    if (sparse_.has_value() && *sparse_) {
+      return sparseRows_.size();
+    }
     auto count = bits::countBits(bits_.data(), begin_, end_);
     allSelected_ = count == size();
     return count;
@@ -327,7 +342,10 @@ class SelectivityVector {
   }
 
   /// Invokes a function on each selected row. The function must take a single
-  /// "row" argument of type vector_size_t and return void.
+  /// "row" argument of type vector_size_t and return void. If fewer than one
+  /// in 'kSparseRatio' rows between begin() and end() are selected, the first
+  /// call after a change records the selected rows and later calls loop over
+  /// these instead of the bits.
   template <typename Callable>
   void applyToSelected(Callable func) const;
 
@@ -363,6 +381,11 @@ class SelectivityVector {
   }
 
  private:
+  // Calls 'func' on each selected row and records the rows in 'sparseRows_'
+  // if there are few of them.
+  template <typename Callable>
+  void applyToSelectedAndCheckSparse(Callable func) const;
+
   // The vector of bits for what is selected vs not (1 is selected).
   std::vector<uint64_t> bits_;
 
@@ -377,6 +400,13 @@ class SelectivityVector {
 
   mutable std::optional<bool> allSelected_;
 
+  // True if 'sparseRows_' has the selected rows, false if the selection is
+  // known not to be sparse. Not set if not known. Reset on any change.
+  mutable std::optional<bool> sparse_;
+
+  // The selected rows if 'sparse_' is true.
+  mutable std::vector<vector_size_t> sparseRows_;
+
   friend class SelectivityIterator;
 };
 
@@ -428,11 +458,35 @@ inline void SelectivityVector::applyToSelected(Callable func) const {
     for (vector_size_t row = begin_; row < end_; ++row) {
       func(row);
     }
+  } else if (!sparse_.has_value()) {
+    applyToSelectedAndCheckSparse(func);
+  } else if (*sparse_) {
+    for (auto row : sparseRows_) {
+      func(row);
+    }
   } else {
     bits::forEachSetBit(bits_.data(), begin_, end_, func);
   }
 }
 
+template <typename Callable>
+void SelectivityVector::applyToSelectedAndCheckSparse(Callable func) const {
+  const size_t maxSparseRows = (end_ - begin_) / kSparseRatio;
+  bool sparse = maxSparseRows > 0;
+  sparseRows_.clear();
+  bits::forEachSetBit(bits_.data(), begin_, end_, [&](vector_size_t row) {
+    if (sparse) {
+      if (sparseRows_.size() < maxSparseRows) {
+        sparseRows_.push_back(row);
+      } else {
+        sparse = false;
+      }
+    }
+    func(row);
+  });
+  sparse_ = sparse;
+}
+
 template <typename Callable>
 inline bool SelectivityVector::testSelected(Callable func) const {
   if (isAllSelected()) {
@@ -443,6 +497,14 @@ inline bool SelectivityVector::testSelected(Callable func) const {
     }
     return true;
   }
+  if (sparse_.has_value() && *sparse_) {
+    for (auto row : sparseRows_) {
+      if (!func(row)) {
+        return false;
+      }
+    }
+    return true;
+  }
   return bits::testSetBits(bits_.data(), begin_, end_, func);
 }
 } // namespace velox
@@ -200,6 +200,37 @@ class SequenceVector : public SimpleVector<T> {
 template <typename T>
 using SequenceVectorPtr = std::shared_ptr<SequenceVector<T>>;
 
+/// Calls 'func(run, numRows)' for each run of the SEQUENCE encoded 'vector'
+/// that has rows selected in 'rows'. 'run' is the index of the run in the
+/// sequence values and 'numRows' is the number of selected rows in the run.
+/// Allows processing runs of equal values once per run instead of once per
+/// row.
+template <typename Func>
+void forEachSelectedRun(
+    const BaseVector& vector,
+    const SelectivityVector& rows,
+    Func func) {
+  VELOX_DCHECK_EQ(vector.encoding(), VectorEncoding::Simple::SEQUENCE);
+  const auto* lengths = vector.wrapInfo()->as<vector_size_t>();
+  const auto numRuns = vector.valueVector()->size();
+  const auto* selected = rows.asRange().bits();
+  vector_size_t runBegin = 0;
+  for (vector_size_t run = 0; run < numRuns && runBegin < rows.end(); ++run) {
+    const auto runEnd = runBegin + lengths[run];
+    const auto begin = std::max(runBegin, rows.begin());
+    const auto end = std::min(runEnd, rows.end());
+    if (begin < end) {
+      const auto numRows = rows.isAllSelected()
+          ? end - begin
+          : bits::countBits(selected, begin, end);
+      if (numRows > 0) {
+        func(run, numRows);
+      }
+    }
+    runBegin = runEnd;
+  }
+}
+
 } // namespace facebook::velox
 
 #include "velox/vector/SequenceVector-inl.h"
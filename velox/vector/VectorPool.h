@@ -20,24 +20,27 @@
 
 namespace facebook::velox {
 
-/// A thread-level cache of pre-allocated flat vectors of different types.
+/// A thread-level cache of pre-allocated vectors of different types.
 /// Keeps up to 10 recyclable vectors of each type. A vector is
-/// recyclable if it is flat and recursively singly-referenced.
-/// Only singleton built-in types are supported. Decimal types, fixed-size array
-/// type, complex and custom types are not supported. Calling 'get' for an
-/// unsupported type already returns a newly allocated vector. Calling 'release'
-/// for an unsupported type is a no-op.
+/// recyclable if it is flat, array, map or row and recursively
+/// singly-referenced. Flat string vectors keep their first string buffer and
+/// complex vectors keep their nested vectors, see prepareForReuse().
+/// Singleton built-in types and up to 8 different ARRAY, MAP or ROW types are
+/// supported. Decimal types and custom primitive types are not supported.
+/// Calling 'get' for an unsupported type already returns a newly allocated
+/// vector. Calling 'release' for an unsupported type is a no-op.
 class VectorPool {
  public:
   explicit VectorPool(memory::MemoryPool* pool) : pool_{pool} {}
 
   /// Gets a possibly recycled vector of 'type and 'size'. Allocates from
-  /// 'pool_' if no pre-allocated vector or type is a complex type.
+  /// 'pool_' if no pre-allocated vector or type is not supported.
   VectorPtr get(const TypePtr& type, vector_size_t size);
 
-  /// Moves vector into 'this' if it is flat, recursively singly referenced and
-  /// there is space. The function returns true if 'vector' is not null and has
-  /// been returned back to this pool, otherwise returns false.
+  /// Moves vector into 'this' if it is recyclable, recursively singly
+  /// referenced and there is space. The function returns true if 'vector' is
+  /// not null and has been returned back to this pool, otherwise returns
+  /// false.
   bool release(VectorPtr& vector);
 
   size_t release(std::vector<VectorPtr>& vectors);
@@ -47,6 +50,11 @@ class VectorPool {
   /// the batch the less the win from recycling.
   static constexpr vector_size_t kMaxRecycleSize = 64 * 1024;
   static constexpr int32_t kNumPerType = 10;
+  /// Max number of different complex types to recycle vectors for.
+  static constexpr int32_t kNumComplexTypes = 8;
+  /// Max retained bytes of a complex vector to be recyclable. Keeps large
+  /// nested vectors from holding on to memory between batches.
+  static constexpr uint64_t kMaxComplexRecycleBytes = 4 << 20;
 
   struct TypePool {
     int32_t size{0};
@@ -67,6 +75,17 @@ class VectorPool {
 
   /// Caches of pre-allocated vectors indexed by typeKind.
   std::array<TypePool, kNumCachedVectorTypes> vectors_;
+
+  /// Returns the cache of pre-allocated vectors of complex 'type'. Adds one if
+  /// not found and 'add' is true. Returns nullptr if not found and not added.
+  TypePool* complexTypePool(const TypePtr& type, bool add);
+
+  /// The complex types in 'complexVectors_'.
+  std::array<TypePtr, kNumComplexTypes> complexTypes_;
+  int32_t numComplexTypes_{0};
+
+  /// Caches of pre-allocated vectors of 'complexTypes_'.
+  std::array<TypePool, kNumComplexTypes> complexVectors_;
 };
 
 /// A simple vector ptr wrapper with an associated vector pool. It releases
@@ -42,6 +42,29 @@ bool isRegisteredVectorSerde() {
   return getVectorSerdeImpl() != nullptr;
 }
 
+void VectorSerde::scatter(
+    const RowVectorPtr& vector,
+    const uint32_t* partitions,
+    folly::Range<VectorSerializer* const*> serializers) {
+  std::vector<std::vector<IndexRange>> ranges(serializers.size());
+  for (vector_size_t row = 0; row < vector->size(); ++row) {
+    auto& partitionRanges = ranges[partitions[row]];
+    if (!partitionRanges.empty() &&
+        partitionRanges.back().begin + partitionRanges.back().size == row) {
+      ++partitionRanges.back().size;
+    } else {
+      partitionRanges.push_back(IndexRange{row, 1});
+    }
+  }
+  for (auto i = 0; i < serializers.size(); ++i) {
+    if (!ranges[i].empty()) {
+      VELOX_CHECK_NOT_NULL(serializers[i]);
+      serializers[i]->append(
+          vector, folly::Range(ranges[i].data(), ranges[i].size()));
+    }
+  }
+}
+
 void VectorStreamGroup::createStreamTree(
     RowTypePtr type,
     int32_t numRows,
@@ -56,6 +79,19 @@ void VectorStreamGroup::append(
   serializer_->append(vector, ranges);
 }
 
+// static
+void VectorStreamGroup::scatter(
+    const RowVectorPtr& vector,
+    const uint32_t* partitions,
+    folly::Range<VectorStreamGroup* const*> groups) {
+  std::vector<VectorSerializer*> serializers(groups.size());
+  for (auto i = 0; i < groups.size(); ++i) {
+    serializers[i] = groups[i] ? groups[i]->serializer_.get() : nullptr;
+  }
+  getVectorSerde()->scatter(
+      vector, partitions, folly::Range(serializers.data(), serializers.size()));
+}
+
 void VectorStreamGroup::flush(OutputStream* out) {
   serializer_->flush(out);
 }
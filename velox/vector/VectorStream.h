@@ -82,6 +82,16 @@ class VectorSerde {
       RowTypePtr type,
       RowVectorPtr* result,
       const Options* options = nullptr) = 0;
+
+  /// Appends each row of 'vector' to the serializer of its partition.
+  /// 'partitions[i]' is the index in 'serializers' for row 'i'. A serializer
+  /// may be null if no row goes to its partition. The result is the same as
+  /// appending the rows of each partition with VectorSerializer::append().
+  /// The default implementation does that.
+  virtual void scatter(
+      const RowVectorPtr& vector,
+      const uint32_t* partitions,
+      folly::Range<VectorSerializer* const*> serializers);
 };
 
 void registerVectorSerde(std::unique_ptr<VectorSerde> serdeToRegister);
@@ -109,6 +119,13 @@ class VectorStreamGroup : public StreamArena {
       RowVectorPtr vector,
       const folly::Range<const IndexRange*>& ranges);
 
+  /// Appends each row of 'vector' to the group of its partition, see
+  /// VectorSerde::scatter(). The groups must have a stream tree.
+  static void scatter(
+      const RowVectorPtr& vector,
+      const uint32_t* partitions,
+      folly::Range<VectorStreamGroup* const*> groups);
+
   // Writes the contents to 'stream' in wire format.
   void flush(OutputStream* stream);
 
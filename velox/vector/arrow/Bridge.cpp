@@ -611,6 +611,43 @@ void exportDictionary(
   exportBase(values, Selection(values.size()), *out.dictionary, pool);
 }
 
+// Returns the values of the Arrow dictionary that constant vector 'vec' is
+// exported as and sets 'index' to the position of the constant in them. This
+// is the value vector of a complex type constant and a single row copy of a
+// scalar or null constant.
+VectorPtr constantDictionaryValues(
+    const BaseVector& vec,
+    vector_size_t& index) {
+  VELOX_DCHECK_EQ(vec.encoding(), VectorEncoding::Simple::CONSTANT);
+  if (!vec.isNullAt(0) && vec.valueVector()) {
+    index = vec.wrappedIndex(0);
+    return vec.valueVector();
+  }
+  auto values = BaseVector::create(vec.type(), 1, vec.pool());
+  values->copy(&vec, 0, 0, 1);
+  index = 0;
+  return values;
+}
+
+// Exports a constant vector as a dictionary with all indices pointing to the
+// constant, so that the value is not repeated for each row.
+void exportConstant(
+    const BaseVector& vec,
+    ArrowArray& out,
+    memory::MemoryPool* pool,
+    VeloxToArrowBridgeHolder& holder) {
+  out.n_buffers = 2;
+  out.n_children = 0;
+  vector_size_t index;
+  auto values = constantDictionaryValues(vec, index);
+  holder.setBuffer(
+      1, AlignedBuffer::allocate<vector_size_t>(out.length, pool, index));
+  auto& loadedValues = *values->loadedVector();
+  out.dictionary = holder.allocateDictionary();
+  exportBase(
+      loadedValues, Selection(loadedValues.size()), *out.dictionary, pool);
+}
+
 void exportBase(
     const BaseVector& vec,
     const Selection& rows,
@@ -621,7 +658,12 @@ void exportBase(
   out.length = rows.count();
   out.offset = 0;
   out.dictionary = nullptr;
-  exportNulls(vec, rows, out, pool, *holder);
+  if (vec.encoding() == VectorEncoding::Simple::CONSTANT) {
+    // A null constant is a null in the dictionary.
+    out.null_count = 0;
+  } else {
+    exportNulls(vec, rows, out, pool, *holder);
+  }
   switch (vec.encoding()) {
     case VectorEncoding::Simple::FLAT:
       exportFlat(vec, rows, out, pool, *holder);
@@ -638,6 +680,9 @@ void exportBase(
     case VectorEncoding::Simple::DICTIONARY:
       exportDictionary(vec, rows, out, pool, *holder);
       break;
+    case VectorEncoding::Simple::CONSTANT:
+      exportConstant(vec, out, pool, *holder);
+      break;
     default:
       VELOX_NYI("{} cannot be exported to Arrow yet.", vec.encoding());
   }
@@ -655,6 +700,12 @@ void exportToArrow(
 }
 
 void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
+  if (vec->encoding() == VectorEncoding::Simple::LAZY) {
+    // The array is exported from the loaded vector, which has its own
+    // encoding.
+    exportToArrow(BaseVector::loadedVectorShared(vec), arrowSchema);
+    return;
+  }
   auto& type = vec->type();
 
   arrowSchema.name = nullptr;
@@ -676,6 +727,16 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
     arrowSchema.dictionary = bridgeHolder->dictionary.get();
     exportToArrow(vec->valueVector(), *arrowSchema.dictionary);
 
+  } else if (vec->encoding() == VectorEncoding::Simple::CONSTANT) {
+    arrowSchema.n_children = 0;
+    arrowSchema.children = nullptr;
+    arrowSchema.format = "i";
+    bridgeHolder->dictionary = std::make_unique<ArrowSchema>();
+    arrowSchema.dictionary = bridgeHolder->dictionary.get();
+    vector_size_t index;
+    exportToArrow(
+        constantDictionaryValues(*vec, index), *arrowSchema.dictionary);
+
   } else {
     arrowSchema.format = exportArrowFormatStr(type, bridgeHolder->formatBuffer);
     arrowSchema.dictionary = nullptr;
@@ -792,6 +853,16 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
     case 'Z':
       return VARBINARY();
 
+    // The string view layouts of utf-8 string and binary.
+    case 'v':
+      if (format[1] == 'u') {
+        return VARCHAR();
+      }
+      if (format[1] == 'z') {
+        return VARBINARY();
+      }
+      break;
+
     case 't': // temporal types.
       // Mapping it to ttn for now.
       if (format[1] == 't' && format[2] == 'n') {
@@ -982,6 +1053,78 @@ VectorPtr createStringFlatVector(
       optionalNullCount(nullCount));
 }
 
+// Creates a string vector from the Arrow string view layout ("vu" and "vz").
+// Each value is a 16 byte view starting with a 4 byte length. Values of up to
+// 12 bytes are inlined after the length. Longer ones are followed by a 4 byte
+// prefix, the index of their data buffer and their offset in it. The data
+// buffers are buffers[2] to buffers[n_buffers - 2] and are wrapped without
+// copying. The last buffer has the sizes of the data buffers.
+VectorPtr createStringViewFlatVector(
+    memory::MemoryPool* pool,
+    const TypePtr& type,
+    BufferPtr nulls,
+    const ArrowArray& arrowArray,
+    WrapInBufferViewFunc wrapInBufferView) {
+  static constexpr int32_t kViewSize = 16;
+  static constexpr int32_t kMaxInlineSize = 12;
+  VELOX_USER_CHECK_GE(
+      arrowArray.n_buffers,
+      3,
+      "Expecting at least three buffers as input for string view types.");
+  const auto numDataBuffers = arrowArray.n_buffers - 3;
+  const auto* dataBufferSizes =
+      static_cast<const int64_t*>(arrowArray.buffers[arrowArray.n_buffers - 1]);
+  const auto* views = static_cast<const char*>(arrowArray.buffers[1]);
+  const auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+
+  const auto length = arrowArray.length;
+  BufferPtr stringViews = AlignedBuffer::allocate<StringView>(length, pool);
+  auto rawStringViews = stringViews->asMutable<StringView>();
+  bool shouldAcquireStringBuffers = false;
+  for (size_t i = 0; i < length; ++i) {
+    if (rawNulls && bits::isBitNull(rawNulls, i)) {
+      rawStringViews[i] = StringView();
+      continue;
+    }
+    const char* view = views + i * kViewSize;
+    int32_t size;
+    memcpy(&size, view, sizeof(int32_t));
+    if (size <= kMaxInlineSize) {
+      rawStringViews[i] = StringView(view + sizeof(int32_t), size);
+      continue;
+    }
+    int32_t bufferIndex;
+    int32_t offset;
+    memcpy(&bufferIndex, view + 8, sizeof(int32_t));
+    memcpy(&offset, view + 12, sizeof(int32_t));
+    VELOX_USER_CHECK_LT(bufferIndex, numDataBuffers);
+    rawStringViews[i] = StringView(
+        static_cast<const char*>(arrowArray.buffers[2 + bufferIndex]) + offset,
+        size);
+    shouldAcquireStringBuffers = true;
+  }
+
+  std::vector<BufferPtr> stringViewBuffers;
+  if (shouldAcquireStringBuffers) {
+    stringViewBuffers.reserve(numDataBuffers);
+    for (auto i = 0; i < numDataBuffers; ++i) {
+      stringViewBuffers.emplace_back(
+          wrapInBufferView(arrowArray.buffers[2 + i], dataBufferSizes[i]));
+    }
+  }
+
+  return std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      nulls,
+      length,
+      stringViews,
+      std::move(stringViewBuffers),
+      SimpleVectorStats<StringView>{},
+      std::nullopt,
+      optionalNullCount(arrowArray.null_count));
+}
+
 VectorPtr importFromArrowImpl(
     ArrowSchema& arrowSchema,
     ArrowArray& arrowArray,
@@ -1212,7 +1355,11 @@ VectorPtr importFromArrowImpl(
   }
 
   // String data types (VARCHAR and VARBINARY).
-  if (type->isVarchar() || type->isVarbinary()) {
+  if ((type->isVarchar() || type->isVarbinary()) &&
+      arrowSchema.format[0] == 'v') {
+    return createStringViewFlatVector(
+        pool, type, nulls, arrowArray, wrapInBufferView);
+  } else if (type->isVarchar() || type->isVarbinary()) {
     VELOX_USER_CHECK_EQ(
         arrowArray.n_buffers,
         3,
@@ -44,6 +44,9 @@ namespace facebook::velox {
 /// where the conversion is not zero-copy, e.g. for strings) and throws in case
 /// the conversion is not implemented yet.
 ///
+/// Dictionary and constant vectors are exported as Arrow dictionary arrays,
+/// so their values are not flattened. A constant is a dictionary of one value.
+///
 /// Example usage:
 ///
 ///   ArrowArray arrowArray;
@@ -107,7 +110,9 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema);
 /// carry a pointer to it, but not really used in most cases - unless the
 /// conversion itself requires a new allocation. In most cases no new
 /// allocations are required, unless for arrays of varchars (or varbinaries) and
-/// complex types written out of order.
+/// complex types written out of order. The characters of strings are never
+/// copied. Both the offset based and the string view ("vu" and "vz") layouts
+/// of Arrow strings are supported.
 ///
 /// The new Velox vector returned contains only references to the underlying
 /// buffers, so it's the client's responsibility to ensure the buffer's
@@ -652,17 +652,53 @@ TEST_F(ArrowBridgeArrayExportTest, dictionaryNested) {
   EXPECT_EQ(values.Value(2), 3);
 }
 
-TEST_F(ArrowBridgeArrayExportTest, unsupported) {
-  ArrowArray arrowArray;
-  VectorPtr vector;
-
-  // Timestamps.
-  vector = vectorMaker_.flatVectorNullable<Timestamp>({});
-  exportToArrow(vector, arrowArray, pool_.get());
+TEST_F(ArrowBridgeArrayExportTest, constant) {
+  auto vec = BaseVector::createConstant(INTEGER(), variant(10), 5, pool_.get());
+  auto array = toArrow(vec, pool_.get());
+  ASSERT_OK(array->ValidateFull());
+  ASSERT_EQ(*array->type(), *arrow::dictionary(arrow::int32(), arrow::int32()));
+  auto& dict = static_cast<const arrow::DictionaryArray&>(*array);
+  auto& indices = static_cast<const arrow::Int32Array&>(*dict.indices());
+  ASSERT_EQ(indices.length(), 5);
+  for (int i = 0; i < indices.length(); ++i) {
+    EXPECT_EQ(indices.Value(i), 0);
+  }
+  auto& values = static_cast<const arrow::Int32Array&>(*dict.dictionary());
+  ASSERT_EQ(values.length(), 1);
+  EXPECT_EQ(values.Value(0), 10);
 
-  // Constant encoding.
-  vector = BaseVector::createConstant(INTEGER(), variant(10), 10, pool_.get());
-  EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
+  // A null constant is a null dictionary value.
+  vec = BaseVector::createNullConstant(VARCHAR(), 100, pool_.get());
+  array = toArrow(vec, pool_.get());
+  ASSERT_OK(array->ValidateFull());
+  ASSERT_EQ(*array->type(), *arrow::dictionary(arrow::int32(), arrow::utf8()));
+  EXPECT_EQ(array->length(), 100);
+  EXPECT_EQ(array->null_count(), 0);
+  EXPECT_TRUE(static_cast<const arrow::DictionaryArray&>(*array)
+                  .dictionary()
+                  ->IsNull(0));
+
+  // A complex type constant refers to its value vector.
+  auto elements = vectorMaker_.flatVector<int64_t>({1, 2, 3});
+  auto offsets = makeBuffer<vector_size_t>({0, 1});
+  auto sizes = makeBuffer<vector_size_t>({1, 2});
+  auto arrays = std::make_shared<ArrayVector>(
+      pool_.get(), ARRAY(BIGINT()), nullptr, 2, offsets, sizes, elements);
+  vec = BaseVector::wrapInConstant(3, 1, arrays);
+  array = toArrow(vec, pool_.get());
+  ASSERT_OK(array->ValidateFull());
+  ASSERT_EQ(
+      *array->type(),
+      *arrow::dictionary(arrow::int32(), arrow::list(arrow::int64())));
+  auto& listDict = static_cast<const arrow::DictionaryArray&>(*array);
+  auto& listIndices =
+      static_cast<const arrow::Int32Array&>(*listDict.indices());
+  ASSERT_EQ(listIndices.length(), 3);
+  for (int i = 0; i < listIndices.length(); ++i) {
+    EXPECT_EQ(listIndices.Value(i), 1);
+  }
+  auto& list = static_cast<const arrow::ListArray&>(*listDict.dictionary());
+  validateOffsets(list, {0, 1, 3});
 }
 
 class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
@@ -1058,6 +1094,80 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
     });
   }
 
+  // Imports 'inputValues' in the Arrow string view layout with the strings
+  // that are not inlined spread over two data buffers.
+  void testImportStringView(
+      const char* format,
+      const std::vector<std::optional<std::string>>& inputValues) {
+    const int64_t length = inputValues.size();
+    int64_t nullCount = 0;
+    auto nulls = AlignedBuffer::allocate<uint64_t>(length, pool_.get());
+    auto views = AlignedBuffer::allocate<char>(length * 16, pool_.get(), 0);
+    std::string data[2];
+    auto rawNulls = nulls->asMutable<uint64_t>();
+    auto rawViews = views->asMutable<char>();
+    for (int64_t i = 0; i < length; ++i) {
+      if (!inputValues[i].has_value()) {
+        bits::setNull(rawNulls, i);
+        ++nullCount;
+        continue;
+      }
+      bits::clearNull(rawNulls, i);
+      const auto& value = *inputValues[i];
+      char* view = rawViews + i * 16;
+      const int32_t size = value.size();
+      memcpy(view, &size, sizeof(int32_t));
+      if (size <= 12) {
+        memcpy(view + 4, value.data(), size);
+        continue;
+      }
+      const int32_t bufferIndex = i % 2;
+      const int32_t offset = data[bufferIndex].size();
+      memcpy(view + 4, value.data(), 4);
+      memcpy(view + 8, &bufferIndex, sizeof(int32_t));
+      memcpy(view + 12, &offset, sizeof(int32_t));
+      data[bufferIndex] += value;
+    }
+    const int64_t dataSizes[2] = {
+        static_cast<int64_t>(data[0].size()),
+        static_cast<int64_t>(data[1].size())};
+    const void* buffers[5] = {
+        rawNulls, rawViews, data[0].data(), data[1].data(), dataSizes};
+
+    auto arrowArray = makeArrowArray(buffers, 5, length, nullCount);
+    auto arrowSchema = makeArrowSchema(format);
+    auto output = importFromArrow(arrowSchema, arrowArray, pool_.get());
+    assertVectorContent(inputValues, output, nullCount);
+
+    // The strings that are not inlined point into the Arrow buffers.
+    auto* flat = output->asFlatVector<StringView>();
+    for (int64_t i = 0; i < length; ++i) {
+      if (!flat->isNullAt(i) && !flat->valueAt(i).isInline()) {
+        auto* begin = data[i % 2].data();
+        EXPECT_GE(flat->valueAt(i).data(), begin);
+        EXPECT_LT(flat->valueAt(i).data(), begin + data[i % 2].size());
+      }
+    }
+  }
+
+  void testImportStringViews() {
+    testImportStringView("vu", {});
+    testImportStringView(
+        "vu",
+        {
+            "hello world",
+            "larger string which should not be inlined...",
+            std::nullopt,
+            "another string over twelve bytes",
+            "the",
+            "a somewhat longer string",
+            std::nullopt,
+        });
+    testImportStringView(
+        "vz",
+        {std::nullopt, "testing", "varbinary view vector", std::nullopt});
+  }
+
   void testImportDictionary() {
     arrow::Dictionary32Builder<arrow::Int64Type> b;
     for (int i = 0; i < 60; ++i) {
@@ -1162,6 +1272,10 @@ TEST_F(ArrowBridgeArrayImportAsViewerTest, string) {
   testImportString();
 }
 
+TEST_F(ArrowBridgeArrayImportAsViewerTest, stringView) {
+  testImportStringViews();
+}
+
 TEST_F(ArrowBridgeArrayImportAsViewerTest, row) {
   testImportRow();
 }
@@ -1209,6 +1323,10 @@ TEST_F(ArrowBridgeArrayImportAsOwnerTest, string) {
   testImportString();
 }
 
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, stringView) {
+  testImportStringViews();
+}
+
 TEST_F(ArrowBridgeArrayImportAsOwnerTest, row) {
   testImportRow();
 }
@@ -347,6 +347,54 @@ BENCHMARK_MULTI(copyStructNonContiguous) {
   return kIter * kSize;
 }
 
+size_t runCopyRanges(
+    const VectorPtr& source,
+    const std::vector<BaseVector::CopyRange>& ranges,
+    memory::MemoryPool* pool) {
+  folly::BenchmarkSuspender suspender;
+  auto target = BaseVector::create(source->type(), source->size(), pool);
+  suspender.dismiss();
+  constexpr int kIter = 100;
+  for (int i = 0; i < kIter; ++i) {
+    target->copyRanges(source.get(), ranges);
+  }
+  return kIter * source->size();
+}
+
+// Ranges of one row each that are adjacent in source and target, as produced
+// by a merge of sorted runs.
+BENCHMARK_MULTI(copyFlatContiguousRanges) {
+  folly::BenchmarkSuspender suspender;
+  std::shared_ptr<memory::MemoryPool> pool{memory::addDefaultLeafMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+  constexpr vector_size_t kSize = 10'000;
+  auto source = vectorMaker.flatVector<int64_t>(kSize, folly::identity);
+  std::vector<BaseVector::CopyRange> ranges;
+  for (auto i = 0; i < kSize; ++i) {
+    ranges.push_back({i, i, 1});
+  }
+  suspender.dismiss();
+  return runCopyRanges(source, ranges, pool.get());
+}
+
+BENCHMARK_MULTI(copyDictionaryOfFlat) {
+  folly::BenchmarkSuspender suspender;
+  std::shared_ptr<memory::MemoryPool> pool{memory::addDefaultLeafMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+  constexpr vector_size_t kSize = 10'000;
+  auto base = vectorMaker.flatVector<int64_t>(kSize, folly::identity);
+  auto indices = makeIndices(
+      kSize, pool.get(), [](auto row) { return (row * 13) % kSize; });
+  auto source =
+      BaseVector::wrapInDictionary(BufferPtr(nullptr), indices, kSize, base);
+  std::vector<BaseVector::CopyRange> ranges;
+  for (auto i = 0; i < kSize; i += 100) {
+    ranges.push_back({i, i, 100});
+  }
+  suspender.dismiss();
+  return runCopyRanges(source, ranges, pool.get());
+}
+
 } // namespace
 } // namespace facebook::velox
 
@@ -581,6 +581,41 @@ TEST_F(DecodedVectorTest, dictionary) {
       1000, [](vector_size_t i) { return std::make_shared<int>(i % 5); });
 }
 
+TEST_F(DecodedVectorTest, sequence) {
+  // Runs of 1 to 20 equal values with a run of nulls every 7 runs.
+  std::vector<std::optional<int64_t>> data;
+  for (auto run = 0; data.size() < 10010; ++run) {
+    const auto length = std::min<size_t>(run % 20 + 1, 10010 - data.size());
+    for (size_t i = 0; i < length; ++i) {
+      data.push_back(run % 7 == 0 ? std::nullopt : std::optional<int64_t>(run));
+    }
+  }
+  auto sequence = vectorMaker_.sequenceVector(data);
+  assertDecodedVector(data, sequence.get(), false);
+}
+
+TEST_F(DecodedVectorTest, bias) {
+  // Ranges that fit 8, 16 and 32 bit deltas.
+  for (int64_t range : {200, 60'000, 4'000'000'000}) {
+    SCOPED_TRACE(range);
+    std::vector<std::optional<int64_t>> data;
+    for (auto i = 0; i < 10010; ++i) {
+      data.push_back(
+          i % 11 == 0 ? std::nullopt
+                      : std::optional<int64_t>(1'000'000 + i * 7 % range));
+    }
+    auto biased = vectorMaker_.biasVector(data);
+    assertDecodedVector(data, biased.get(), false);
+  }
+
+  std::vector<std::optional<int32_t>> data;
+  for (auto i = 0; i < 10010; ++i) {
+    data.push_back(-50'000 + i % 1'000);
+  }
+  auto biased = vectorMaker_.biasVector(data);
+  assertDecodedVector(data, biased.get(), false);
+}
+
 TEST_F(DecodedVectorTest, dictionaryOverLazy) {
   constexpr vector_size_t size = 1000;
   auto lazyVector = vectorMaker_.lazyFlatVector<int32_t>(
@@ -531,6 +531,57 @@ TEST(SelectivityVectorTest, toString) {
       "147 out of 1024 rows selected between 0 and 1023: 0, 7, 14, 21, 28, 35, 42, 49, 56, 63, 70, 77, 84, 91, 98, 105, 112, 119, 126, 133, 140, 147, 154, 161, 168, 175, 182, 189, 196, 203, 210, 217, 224, 231, 238, 245, 252, 259, 266, 273, 280, 287, 294, 301, 308, 315, 322, 329, 336, 343, 350, 357, 364, 371, 378, 385, 392, 399, 406, 413, 420, 427, 434, 441, 448, 455, 462, 469, 476, 483, 490, 497, 504, 511, 518, 525, 532, 539, 546, 553, 560, 567, 574, 581, 588, 595, 602, 609, 616, 623, 630, 637, 644, 651, 658, 665, 672, 679, 686, 693, 700, 707, 714, 721, 728, 735, 742, 749, 756, 763, 770, 777, 784, 791, 798, 805, 812, 819, 826, 833, 840, 847, 854, 861, 868, 875, 882, 889, 896, 903, 910, 917, 924, 931, 938, 945, 952, 959, 966, 973, 980, 987, 994, 1001, 1008, 1015, 1022");
 }
 
+TEST(SelectivityVectorTest, sparse) {
+  auto selectedRows = [](const SelectivityVector& rows) {
+    std::vector<vector_size_t> selected;
+    rows.applyToSelected([&](auto row) { selected.push_back(row); });
+    return selected;
+  };
+
+  SelectivityVector rows(10'000, false);
+  rows.setValid(10, true);
+  rows.setValid(5'000, true);
+  rows.setValid(9'999, true);
+  rows.updateBounds();
+
+  // The first pass records the rows and the second uses them.
+  std::vector<vector_size_t> expected{10, 5'000, 9'999};
+  ASSERT_EQ(selectedRows(rows), expected);
+  ASSERT_EQ(selectedRows(rows), expected);
+  ASSERT_EQ(rows.countSelected(), 3);
+  std::vector<vector_size_t> tested;
+  ASSERT_FALSE(rows.testSelected([&](auto row) {
+    tested.push_back(row);
+    return row < 5'000;
+  }));
+  ASSERT_EQ(tested, (std::vector<vector_size_t>{10, 5'000}));
+
+  // Changes are seen after updateBounds().
+  rows.setValid(5'000, false);
+  rows.setValid(7'000, true);
+  rows.updateBounds();
+  expected = {10, 7'000, 9'999};
+  ASSERT_EQ(selectedRows(rows), expected);
+  ASSERT_EQ(selectedRows(rows), expected);
+
+  bits::setBit(rows.asMutableRange().bits(), 8'000);
+  rows.updateBounds();
+  expected = {10, 7'000, 8'000, 9'999};
+  ASSERT_EQ(selectedRows(rows), expected);
+  ASSERT_EQ(rows.countSelected(), 4);
+
+  // A copy keeps the recorded rows.
+  SelectivityVector copy = rows;
+  ASSERT_EQ(selectedRows(copy), expected);
+
+  // A dense selection is not recorded.
+  rows.setValidRange(0, 1'000, true);
+  rows.updateBounds();
+  ASSERT_EQ(selectedRows(rows).size(), 1'003);
+  ASSERT_EQ(selectedRows(rows).size(), 1'003);
+  ASSERT_EQ(rows.countSelected(), 1'003);
+}
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
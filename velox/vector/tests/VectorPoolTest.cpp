@@ -146,4 +146,66 @@ TEST_F(VectorPoolTest, customTypes) {
   ASSERT_EQ(1'000, vector->size());
   ASSERT_TRUE(isJsonType(vector->type()));
 }
+
+TEST_F(VectorPoolTest, complexTypes) {
+  VectorPool vectorPool(pool());
+  auto rowType = ROW(
+      {"a", "b", "c"}, {ARRAY(BIGINT()), MAP(INTEGER(), VARCHAR()), VARCHAR()});
+
+  auto vector = vectorPool.get(rowType, 1'000);
+  ASSERT_EQ(1'000, vector->size());
+  auto* row = vector->as<RowVector>();
+  auto* array = row->childAt(0)->as<ArrayVector>();
+  array->elements()->resize(5'000);
+  for (auto i = 0; i < 1'000; ++i) {
+    array->setOffsetAndSize(i, i * 5, 5);
+  }
+  row->childAt(1)->setNull(7, true);
+  row->childAt(2)->asFlatVector<StringView>()->set(
+      3, StringView("a string which is not inlined"));
+  vector->setNull(5, true);
+
+  // The vector and its children come back empty without new allocations.
+  auto* vectorPtr = vector.get();
+  ASSERT_TRUE(vectorPool.release(vector));
+  const auto numAllocs = pool()->getMemoryUsageTracker()->numAllocs();
+  auto recycled = vectorPool.get(rowType, 500);
+  ASSERT_EQ(numAllocs, pool()->getMemoryUsageTracker()->numAllocs());
+  ASSERT_EQ(vectorPtr, recycled.get());
+  ASSERT_EQ(500, recycled->size());
+  ASSERT_FALSE(recycled->isNullAt(5));
+  row = recycled->as<RowVector>();
+  for (auto& child : row->children()) {
+    ASSERT_EQ(500, child->size());
+  }
+  array = row->childAt(0)->as<ArrayVector>();
+  ASSERT_EQ(0, array->elements()->size());
+  ASSERT_EQ(0, array->sizeAt(3));
+  ASSERT_FALSE(row->childAt(1)->isNullAt(7));
+  ASSERT_EQ(0, row->childAt(1)->as<MapVector>()->sizeAt(7));
+  ASSERT_EQ(
+      StringView(), row->childAt(2)->asFlatVector<StringView>()->valueAt(3));
+
+  // A vector of an equal but different type instance is recycled too.
+  ASSERT_TRUE(vectorPool.release(recycled));
+  auto sameType = ROW(
+      {"a", "b", "c"}, {ARRAY(BIGINT()), MAP(INTEGER(), VARCHAR()), VARCHAR()});
+  ASSERT_EQ(vectorPtr, vectorPool.get(sameType, 100).get());
+
+  // A vector with a shared child is not recycled.
+  vector = vectorPool.get(rowType, 100);
+  auto child = vector->as<RowVector>()->childAt(0);
+  ASSERT_FALSE(vectorPool.release(vector));
+  child.reset();
+  ASSERT_TRUE(vectorPool.release(vector));
+
+  // A dictionary child is not recycled.
+  vector = vectorPool.get(ARRAY(BIGINT()), 100);
+  vector->as<ArrayVector>()->elements() = BaseVector::wrapInDictionary(
+      nullptr,
+      makeIndices(10, [](auto row) { return row; }),
+      10,
+      makeFlatVector<int64_t>(10, [](auto row) { return row; }));
+  ASSERT_FALSE(vectorPool.release(vector));
+}
 } // namespace facebook::velox::test
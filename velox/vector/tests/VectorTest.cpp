@@ -2115,3 +2115,96 @@ TEST_F(VectorTest, testCopyWithZeroCount) {
   runTest(
       makeRowVector({makeFlatVector<int32_t>(1, [](auto i) { return i; })}));
 }
+
+TEST_F(VectorTest, copyRangesFromDictionary) {
+  auto test = [&](const VectorPtr& source) {
+    SCOPED_TRACE(source->toString());
+    // Ranges of one row that are coalesced, followed by longer ranges that
+    // are not adjacent in the source.
+    std::vector<BaseVector::CopyRange> ranges;
+    for (auto i = 0; i < 10; ++i) {
+      ranges.push_back({i, i, 1});
+    }
+    ranges.push_back({20, 10, 37});
+    ranges.push_back({100, 47, 50});
+    auto target = BaseVector::create(source->type(), 150, pool());
+    target->copyRanges(source.get(), ranges);
+    for (const auto& range : ranges) {
+      for (auto i = 0; i < range.count; ++i) {
+        ASSERT_TRUE(target->equalValueAt(
+            source.get(), range.targetIndex + i, range.sourceIndex + i))
+            << "at " << range.sourceIndex + i;
+      }
+    }
+  };
+
+  const vector_size_t size = 200;
+  auto indices = makeIndices(size, [](auto row) { return (row * 17) % 101; });
+  auto wrapperNulls = makeNulls(size, nullEvery(5));
+  auto testBase = [&](const VectorPtr& base) {
+    test(wrapInDictionary(indices, size, base));
+    test(BaseVector::wrapInDictionary(wrapperNulls, indices, size, base));
+  };
+
+  testBase(makeFlatVector<int64_t>(101, [](auto row) { return row * 3; }));
+  testBase(makeFlatVector<int64_t>(
+      101, [](auto row) { return row * 3; }, nullEvery(3)));
+  testBase(makeFlatVector<int32_t>(
+      101, [](auto row) { return row; }, nullEvery(7)));
+  testBase(makeFlatVector<double>(
+      101, [](auto row) { return row * 0.5; }, nullEvery(11)));
+  testBase(makeFlatVector<int16_t>(101, [](auto row) { return row; }));
+  testBase(makeFlatVector<StringView>(
+      101,
+      [](auto row) { return StringView::makeInline(std::to_string(row)); },
+      nullEvery(13)));
+}
+
+TEST_F(VectorTest, compactStringBuffers) {
+  auto strings = makeFlatVector<StringView>(
+      1'000,
+      [](auto row) {
+        return StringView(fmt::format("{} a string past the inline size", row));
+      },
+      nullEvery(7));
+  auto stringBufferBytes = [](const VectorPtr& vector) {
+    uint64_t bytes = 0;
+    for (const auto& buffer :
+         vector->asFlatVector<StringView>()->stringBuffers()) {
+      bytes += buffer->capacity();
+    }
+    return bytes;
+  };
+
+  // A dictionary over 1% of the rows is flattened into a compact copy.
+  auto indices = makeIndices(10, [](auto row) { return row * 100 + 1; });
+  auto filtered = wrapInDictionary(indices, 10, strings);
+  auto compacted = BaseVector::compactStringBuffers(filtered, 0.5);
+  ASSERT_NE(compacted, filtered);
+  ASSERT_EQ(compacted->encoding(), VectorEncoding::Simple::FLAT);
+  assertEqualVectors(filtered, compacted);
+  EXPECT_LT(stringBufferBytes(compacted), stringBufferBytes(strings) / 10);
+
+  // Compaction is disabled or not worth it.
+  EXPECT_EQ(BaseVector::compactStringBuffers(filtered, 0), filtered);
+  EXPECT_EQ(BaseVector::compactStringBuffers(strings, 0.5), strings);
+
+  // The string children of a row vector are compacted and the other children
+  // are kept.
+  auto ints = makeFlatVector<int32_t>(10, [](auto row) { return row; });
+  auto inlined = wrapInDictionary(
+      indices, 10, makeFlatVector<StringView>(1'000, [](auto row) {
+        return StringView(std::to_string(row));
+      }));
+  auto rows = makeRowVector({ints, filtered, inlined});
+  auto compactedRows = BaseVector::compactStringBuffers(rows, 0.5);
+  ASSERT_NE(compactedRows, rows);
+  assertEqualVectors(rows, compactedRows);
+  auto* compactedRowVector = compactedRows->as<RowVector>();
+  EXPECT_EQ(compactedRowVector->childAt(0), ints);
+  EXPECT_EQ(
+      compactedRowVector->childAt(1)->encoding(),
+      VectorEncoding::Simple::FLAT);
+  // Inlined strings do not need string buffers.
+  EXPECT_EQ(compactedRowVector->childAt(2), inlined);
+}